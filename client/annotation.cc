@@ -33,11 +33,18 @@ void Annotation::SetSize(ValueSizeType size) {
   size_ = size;
   // Use Register() instead of Get() in case the calling module has not
   // explicitly initialized the annotation list, to avoid crashing.
-  AnnotationList::Register()->Add(this);
+  AnnotationList* list = AnnotationList::Register();
+  generation_ = list->NextGeneration();
+  list->Add(this);
 }
 
 void Annotation::Clear() {
   size_ = 0;
+  // An annotation that has never been set isn’t in any list, so there’s
+  // nothing to record.
+  if (AnnotationList* list = AnnotationList::Get()) {
+    generation_ = list->NextGeneration();
+  }
 }
 
 }  // namespace crashpad
@@ -91,6 +91,19 @@ class Annotation {
     //! \brief A `NUL`-terminated C-string.
     kString = 1,
 
+    //! \brief A string value compressed as a zlib stream. The stream may end
+    //!     at a flush point instead of being finished, in which case it holds
+    //!     a prefix of the string.
+    //!
+    //! \sa CompressedStringAnnotation
+    kCompressedString = 2,
+
+    //! \brief A string value guarded by a sequence number, so that readers can
+    //!     tell whether it was being written while they read it.
+    //!
+    //! \sa SeqlockStringAnnotation
+    kSeqlockString = 3,
+
     //! \brief Clients may declare their own custom types by using values
     //!     greater than this.
     kUserDefinedStart = 0x8000,
@@ -182,6 +195,13 @@ class Annotation {
   //! \brief Tests whether the annotation has been set.
   bool is_set() const { return size_ > 0; }
 
+  //! \brief Returns the AnnotationList generation at which the annotation was
+  //!     last set or cleared, or `0` if it never has been.
+  //!
+  //! See AnnotationList::generation(). Changes made to the data referenced by
+  //! the annotation without calling SetSize() or Clear() are not recorded.
+  uint32_t generation() const { return generation_; }
+
   Type type() const { return type_; }
   ValueSizeType size() const { return size_; }
   const char* name() const { return name_; }
@@ -237,7 +257,8 @@ class Annotation {
         size_(0),
         type_(type),
         concurrent_access_guard_mode_(concurrent_access_guard_mode),
-        spin_guard_state_() {}
+        spin_guard_state_(),
+        generation_(0) {}
 
   friend class AnnotationList;
 #if BUILDFLAG(IS_IOS)
@@ -271,6 +292,12 @@ class Annotation {
   const ConcurrentAccessGuardMode concurrent_access_guard_mode_;
 
   SpinGuardState spin_guard_state_;
+
+  //! \brief The generation at which the annotation was last set or cleared.
+  //!
+  //! This follows the fields that the handler has always read, so that
+  //! handlers that don’t know of it still read annotations correctly.
+  uint32_t generation_;
 };
 
 //! \brief An \sa Annotation that stores a `NUL`-terminated C-string value.
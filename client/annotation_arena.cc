@@ -0,0 +1,95 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/annotation_arena.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+
+AnnotationArena::Entry::Entry(Annotation::Type type,
+                              uint16_t name_length,
+                              uint32_t value_capacity)
+    : entry_size_(0),
+      type_(type),
+      name_length_(name_length),
+      value_capacity_(value_capacity),
+      value_size_(0) {}
+
+void AnnotationArena::Entry::SetValue(const void* value, uint32_t size) {
+  size = std::min(size, value_capacity_);
+
+  // Clear the size first so that a reader never sees a size covering a value
+  // that is only partially written.
+  value_size_.store(0, std::memory_order_relaxed);
+  memcpy(ValueStorage(), value, size);
+  value_size_.store(size, std::memory_order_release);
+}
+
+void AnnotationArena::Entry::Clear() {
+  value_size_.store(0, std::memory_order_release);
+}
+
+uint8_t* AnnotationArena::Entry::ValueStorage() const {
+  return reinterpret_cast<uint8_t*>(const_cast<Entry*>(this) + 1) +
+         name_length_;
+}
+
+AnnotationArena::AnnotationArena(void* storage, uint32_t capacity)
+    : signature_(kSignature),
+      version_(kVersion),
+      capacity_(capacity),
+      used_(0),
+      storage_(static_cast<uint8_t*>(storage)) {
+  DCHECK_EQ(reinterpret_cast<uintptr_t>(storage) % alignof(Entry), 0u);
+}
+
+AnnotationArena::Entry* AnnotationArena::Add(Annotation::Type type,
+                                             const char* name,
+                                             uint32_t value_capacity) {
+  DCHECK(name);
+  const size_t name_length = strnlen(name, Annotation::kNameMaxLength);
+  DCHECK_LT(name_length, Annotation::kNameMaxLength);
+  DCHECK_LT(value_capacity, Annotation::kValueMaxSize);
+  if (name_length == 0 || name_length >= Annotation::kNameMaxLength ||
+      value_capacity >= Annotation::kValueMaxSize) {
+    return nullptr;
+  }
+
+  // Keep every entry aligned.
+  const uint32_t entry_size = static_cast<uint32_t>(
+      (sizeof(Entry) + name_length + value_capacity + alignof(Entry) - 1) &
+      ~(alignof(Entry) - 1));
+
+  uint32_t offset = used_.load(std::memory_order_relaxed);
+  do {
+    if (entry_size > capacity_ - offset) {
+      return nullptr;
+    }
+  } while (!used_.compare_exchange_weak(
+      offset, offset + entry_size, std::memory_order_relaxed));
+
+  Entry* entry = new (storage_ + offset)
+      Entry(type, static_cast<uint16_t>(name_length), value_capacity);
+  memcpy(reinterpret_cast<uint8_t*>(entry + 1), name, name_length);
+  entry->entry_size_.store(entry_size, std::memory_order_release);
+  return entry;
+}
+
+}  // namespace crashpad
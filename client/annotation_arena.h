@@ -0,0 +1,169 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_ANNOTATION_ARENA_H_
+#define CRASHPAD_CLIENT_ANNOTATION_ARENA_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "client/annotation.h"
+
+namespace crashpad {
+
+//! \brief A store for annotations whose names and values are all kept in one
+//!     contiguous block of memory.
+//!
+//! Annotation objects in an AnnotationList may be scattered throughout a
+//! module’s memory, so the handler must read each list node, name, and value
+//! separately. When the handler reads another process’ memory through ptrace
+//! or a broker, each of those reads is a round trip. By contrast, the handler
+//! reads an AnnotationArena with one read for this object and one read for
+//! all of its entries.
+//!
+//! Using an arena is optional, and an arena can be used alongside an
+//! AnnotationList. It must be registered with
+//! CrashpadInfo::set_annotation_arena() for its entries to be captured. The
+//! handler reports arena entries as module annotations, just like those in the
+//! AnnotationList.
+//!
+//! Entries are allocated from the arena with Add() and are never freed.
+//! Allocation is lock-free, but like Annotation, an individual entry’s value
+//! must not be modified concurrently from multiple threads without external
+//! synchronization.
+//!
+//! An example declaration and usage:
+//!
+//! \code
+//!   alignas(8) uint8_t g_arena_storage[64 * 1024];
+//!   crashpad::AnnotationArena g_arena(g_arena_storage,
+//!                                     sizeof(g_arena_storage));
+//!
+//!   void Initialize() {
+//!     crashpad::CrashpadInfo::GetCrashpadInfo()->set_annotation_arena(
+//!         &g_arena);
+//!   }
+//!
+//!   void OnRequest(const std::string& url) {
+//!     static crashpad::AnnotationArena::Entry* entry = g_arena.Add(
+//!         crashpad::Annotation::Type::kString, "request_url", 256);
+//!     if (entry) {
+//!       entry->SetValue(url.data(), url.size());
+//!     }
+//!   }
+//! \endcode
+class AnnotationArena {
+ public:
+  //! \brief A single annotation allocated in an AnnotationArena.
+  //!
+  //! An entry is followed in the arena by its name and then the storage for its
+  //! value.
+  class Entry {
+   public:
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    //! \brief Sets the entry’s value.
+    //!
+    //! \param[in] value The value to copy into the arena.
+    //! \param[in] size The size of \a value, in bytes. If this exceeds
+    //!     value_capacity(), the value is truncated.
+    void SetValue(const void* value, uint32_t size);
+
+    //! \brief Clears the entry’s value, so that it is no longer reported.
+    void Clear();
+
+    //! \return The number of bytes available for the entry’s value.
+    uint32_t value_capacity() const { return value_capacity_; }
+
+    //! \return The size of the entry’s value, or `0` if it is not set.
+    uint32_t value_size() const {
+      return value_size_.load(std::memory_order_relaxed);
+    }
+
+    //! \return The entry’s value, valid for value_size() bytes.
+    const void* value() const { return ValueStorage(); }
+
+   private:
+    friend class AnnotationArena;
+
+    Entry(Annotation::Type type, uint16_t name_length, uint32_t value_capacity);
+
+    uint8_t* ValueStorage() const;
+
+    // The size of this entry, including its name and value storage and any
+    // padding, in bytes. This is stored last when adding an entry, so an entry
+    // with a zero size has not been completely added.
+    std::atomic<uint32_t> entry_size_;
+
+    Annotation::Type type_;
+    uint16_t name_length_;
+    uint32_t value_capacity_;
+    std::atomic<uint32_t> value_size_;
+  };
+
+  //! \brief Constructs an arena over caller-provided storage.
+  //!
+  //! \param[in] storage The memory in which entries are allocated. It must be
+  //!     aligned to 4 bytes and must remain valid for as long as the arena may
+  //!     be read, which in practice means for the life of the process.
+  //! \param[in] capacity The size of \a storage, in bytes.
+  AnnotationArena(void* storage, uint32_t capacity);
+
+  AnnotationArena(const AnnotationArena&) = delete;
+  AnnotationArena& operator=(const AnnotationArena&) = delete;
+
+  //! \brief Allocates a new entry.
+  //!
+  //! This method is lock-free and may be called from multiple threads.
+  //!
+  //! \param[in] type The type of the entry’s value.
+  //! \param[in] name The entry’s name. It must be shorter than
+  //!     Annotation::kNameMaxLength, and is copied into the arena.
+  //! \param[in] value_capacity The maximum size of the entry’s value, in bytes.
+  //!     This must be less than Annotation::kValueMaxSize.
+  //!
+  //! \return The new entry, with no value set, or `nullptr` if the arena does
+  //!     not have room for it.
+  Entry* Add(Annotation::Type type, const char* name, uint32_t value_capacity);
+
+  //! \return The number of bytes of storage used by entries.
+  uint32_t used() const { return used_.load(std::memory_order_relaxed); }
+
+  //! \return The total size of the arena’s storage, in bytes.
+  uint32_t capacity() const { return capacity_; }
+
+  enum : uint32_t {
+    kSignature = 'CPAr',
+    kVersion = 1,
+  };
+
+ private:
+  // These fields are read by the handler, so their layout must not change.
+  // Adding fields? Consider snapshot/crashpad_types/image_annotation_reader.cc
+  // too.
+  uint32_t signature_;  // kSignature
+  uint32_t version_;  // kVersion
+  uint32_t capacity_;
+  std::atomic<uint32_t> used_;
+  uint8_t* storage_;
+};
+
+static_assert(sizeof(AnnotationArena::Entry) == 16,
+              "AnnotationArena::Entry size must not change");
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_ANNOTATION_ARENA_H_
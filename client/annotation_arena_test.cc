@@ -0,0 +1,80 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/annotation_arena.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(AnnotationArena, AddAndSet) {
+  alignas(8) uint8_t storage[128];
+  AnnotationArena arena(storage, sizeof(storage));
+  EXPECT_EQ(arena.capacity(), sizeof(storage));
+  EXPECT_EQ(arena.used(), 0u);
+
+  AnnotationArena::Entry* entry =
+      arena.Add(Annotation::Type::kString, "key", 8);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->value_capacity(), 8u);
+  EXPECT_EQ(entry->value_size(), 0u);
+
+  // The entry, its name, and its value are stored contiguously, padded to the
+  // entry alignment.
+  EXPECT_EQ(reinterpret_cast<uint8_t*>(entry), storage);
+  EXPECT_EQ(arena.used(), 28u);
+  EXPECT_EQ(memcmp(storage + sizeof(*entry), "key", 3), 0);
+
+  entry->SetValue("value", 5);
+  EXPECT_EQ(entry->value_size(), 5u);
+  EXPECT_EQ(std::string(static_cast<const char*>(entry->value()), 5), "value");
+  EXPECT_EQ(entry->value(), storage + sizeof(*entry) + 3);
+
+  // Values longer than the capacity are truncated.
+  entry->SetValue("a longer value", 14);
+  EXPECT_EQ(entry->value_size(), 8u);
+  EXPECT_EQ(std::string(static_cast<const char*>(entry->value()), 8),
+            "a longer");
+
+  entry->Clear();
+  EXPECT_EQ(entry->value_size(), 0u);
+
+  AnnotationArena::Entry* second =
+      arena.Add(Annotation::Type::kString, "second", 4);
+  ASSERT_TRUE(second);
+  EXPECT_EQ(reinterpret_cast<uint8_t*>(second), storage + 28);
+}
+
+TEST(AnnotationArena, OutOfSpace) {
+  alignas(8) uint8_t storage[64];
+  AnnotationArena arena(storage, sizeof(storage));
+
+  ASSERT_TRUE(arena.Add(Annotation::Type::kString, "a", 15));
+  ASSERT_TRUE(arena.Add(Annotation::Type::kString, "b", 15));
+  EXPECT_EQ(arena.used(), 64u);
+
+  // Running out of space shouldn't crash.
+  EXPECT_FALSE(arena.Add(Annotation::Type::kString, "c", 0));
+  EXPECT_EQ(arena.used(), 64u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
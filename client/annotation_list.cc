@@ -22,7 +22,8 @@ namespace crashpad {
 AnnotationList::AnnotationList()
     : tail_pointer_(&tail_),
       head_(Annotation::Type::kInvalid, nullptr, nullptr),
-      tail_(Annotation::Type::kInvalid, nullptr, nullptr) {
+      tail_(Annotation::Type::kInvalid, nullptr, nullptr),
+      generation_(0) {
   head_.link_node().store(&tail_);
 }
 
@@ -15,6 +15,10 @@
 #ifndef CRASHPAD_CLIENT_ANNOTATION_LIST_H_
 #define CRASHPAD_CLIENT_ANNOTATION_LIST_H_
 
+#include <stdint.h>
+
+#include <atomic>
+
 #include "build/build_config.h"
 #include "client/annotation.h"
 
@@ -60,6 +64,24 @@ class AnnotationList {
   //! and/or clearing the value.
   void Add(Annotation* annotation);
 
+  //! \brief Returns the list’s current generation.
+  //!
+  //! The generation starts at `0` and advances each time an annotation is set
+  //! or cleared, which records the new generation in Annotation::generation().
+  //! The annotations changed since an earlier call are those whose generation
+  //! is later than the value that call returned. The generation wraps around,
+  //! so generations should be compared by the sign of their difference.
+  uint32_t generation() const {
+    return generation_.load(std::memory_order_relaxed);
+  }
+
+  //! \brief Advances the list’s generation and returns the new value. This
+  //!     method does not need to be called by clients directly. The
+  //!     Annotation object will do so automatically.
+  uint32_t NextGeneration() {
+    return generation_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
   //! \brief An InputIterator for the AnnotationList.
   class Iterator {
    public:
@@ -131,6 +153,10 @@ class AnnotationList {
   // Dummy linked-list head and tail elements of \a Annotation::Type::kInvalid.
   Annotation head_;
   Annotation tail_;
+
+  // The generation most recently recorded in an annotation. Placed last so that
+  // the fields above stay where handlers have always read them.
+  std::atomic<uint32_t> generation_;
 };
 
 }  // namespace crashpad
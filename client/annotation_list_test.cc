@@ -110,6 +110,26 @@ TEST_F(AnnotationList, SetAndClear) {
   EXPECT_TRUE(ContainsNameValue(annotations, "Second", std::string(256, 'A')));
 }
 
+TEST_F(AnnotationList, Generation) {
+  EXPECT_EQ(annotations_.generation(), 0u);
+  EXPECT_EQ(one_.generation(), 0u);
+
+  one_.Set("1");
+  two_.Set("2");
+  EXPECT_EQ(one_.generation(), 1u);
+  EXPECT_EQ(two_.generation(), 2u);
+  EXPECT_EQ(annotations_.generation(), 2u);
+
+  // Only the annotations set or cleared since a generation are later than it.
+  const uint32_t since = annotations_.generation();
+  one_.Set("3");
+  three_.Clear();
+  EXPECT_GT(one_.generation(), since);
+  EXPECT_EQ(two_.generation(), since);
+  EXPECT_GT(three_.generation(), one_.generation());
+  EXPECT_EQ(annotations_.generation(), three_.generation());
+}
+
 TEST_F(AnnotationList, DuplicateKeys) {
   ASSERT_EQ(0u, CollectAnnotations().size());
 
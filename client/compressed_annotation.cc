@@ -0,0 +1,178 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/compressed_annotation.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+
+namespace crashpad {
+
+namespace {
+
+// The amount of the string compressed between flush points. Each flush costs
+// a few bytes of output, and is as fine as truncation can get.
+constexpr size_t kFlushInterval = 4096;
+
+}  // namespace
+
+namespace internal {
+
+size_t CompressAnnotationValue(base::StringPiece string,
+                               uint8_t* buffer,
+                               size_t buffer_size,
+                               bool* complete) {
+  *complete = false;
+  if (string.empty()) {
+    *complete = true;
+    return 0;
+  }
+  const size_t string_size = string.size();
+  string = string.substr(0, kCompressedAnnotationMaxStringSize);
+
+  z_stream zlib_stream = {};
+  int zr = deflateInit(&zlib_stream, Z_BEST_COMPRESSION);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "deflateInit: " << ZlibErrorString(zr);
+    return 0;
+  }
+
+  // Compress into a scratch buffer, which can grow past buffer_size by at most
+  // one piece, and copy the pieces that fit into buffer at the end.
+  std::vector<uint8_t> output(buffer_size + kFlushInterval);
+  size_t fitting_size = 0;
+  size_t offset = 0;
+  while (offset < string.size()) {
+    const size_t piece_size = std::min(kFlushInterval, string.size() - offset);
+    const bool last = offset + piece_size == string.size();
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    zlib_stream.next_in = reinterpret_cast<Bytef*>(
+        const_cast<char*>(string.data() + offset));
+    zlib_stream.avail_in = base::checked_cast<uInt>(piece_size);
+
+    for (;;) {
+      if (zlib_stream.total_out == output.size()) {
+        output.resize(output.size() + kFlushInterval);
+      }
+      zlib_stream.next_out = output.data() + zlib_stream.total_out;
+      zlib_stream.avail_out =
+          base::checked_cast<uInt>(output.size() - zlib_stream.total_out);
+      zr = deflate(&zlib_stream, flush);
+      if (zr == Z_STREAM_END) {
+        break;
+      }
+      if (zr != Z_OK && zr != Z_BUF_ERROR) {
+        LOG(ERROR) << "deflate: " << ZlibErrorString(zr);
+        deflateEnd(&zlib_stream);
+        return 0;
+      }
+      if (flush == Z_SYNC_FLUSH && zlib_stream.avail_out > 0) {
+        break;
+      }
+    }
+
+    if (zlib_stream.total_out > buffer_size) {
+      break;
+    }
+    fitting_size = zlib_stream.total_out;
+    offset += piece_size;
+  }
+  deflateEnd(&zlib_stream);
+
+  memcpy(buffer, output.data(), fitting_size);
+  *complete = offset == string_size;
+  return fitting_size;
+}
+
+}  // namespace internal
+
+bool DecompressAnnotationValue(const uint8_t* data,
+                               size_t size,
+                               std::string* string) {
+  if (size == 0) {
+    LOG(ERROR) << "empty compressed annotation";
+    return false;
+  }
+
+  z_stream zlib_stream = {};
+  int zr = inflateInit(&zlib_stream);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "inflateInit: " << ZlibErrorString(zr);
+    return false;
+  }
+  zlib_stream.next_in = const_cast<Bytef*>(data);
+  zlib_stream.avail_in = base::checked_cast<uInt>(size);
+
+  // One byte beyond the limit distinguishes a string that’s too large from one
+  // that exactly fills it.
+  constexpr size_t kOutputLimit = kCompressedAnnotationMaxStringSize + 1;
+  std::string output;
+  for (;;) {
+    if (zlib_stream.total_out == output.size()) {
+      if (output.size() == kOutputLimit) {
+        LOG(ERROR) << "compressed annotation too large";
+        inflateEnd(&zlib_stream);
+        return false;
+      }
+      output.resize(
+          std::min(kOutputLimit, std::max(size * 4, output.size() * 2)));
+    }
+    zlib_stream.next_out =
+        reinterpret_cast<Bytef*>(&output[0] + zlib_stream.total_out);
+    zlib_stream.avail_out =
+        base::checked_cast<uInt>(output.size() - zlib_stream.total_out);
+    zr = inflate(&zlib_stream, Z_NO_FLUSH);
+    if (zr == Z_STREAM_END) {
+      break;
+    }
+    if (zr != Z_OK && zr != Z_BUF_ERROR) {
+      LOG(ERROR) << "inflate: " << ZlibErrorString(zr);
+      inflateEnd(&zlib_stream);
+      return false;
+    }
+    if (zlib_stream.avail_in == 0 && zlib_stream.avail_out > 0) {
+      // The stream ended at a flush point, holding a prefix of the string.
+      break;
+    }
+  }
+
+  output.resize(zlib_stream.total_out);
+  inflateEnd(&zlib_stream);
+  string->swap(output);
+  return true;
+}
+
+bool ReadStringAnnotationValue(uint16_t type,
+                               const uint8_t* data,
+                               size_t size,
+                               std::string* string) {
+  switch (static_cast<Annotation::Type>(type)) {
+    case Annotation::Type::kString:
+      string->assign(reinterpret_cast<const char*>(data), size);
+      return true;
+    case Annotation::Type::kCompressedString:
+      return DecompressAnnotationValue(data, size, string);
+    default:
+      return false;
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,143 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_COMPRESSED_ANNOTATION_H_
+#define CRASHPAD_CLIENT_COMPRESSED_ANNOTATION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+#include "client/annotation.h"
+
+namespace crashpad {
+
+//! \brief The largest string that a CompressedStringAnnotation will hold, and
+//!     that DecompressAnnotationValue() will produce, in bytes.
+inline constexpr size_t kCompressedAnnotationMaxStringSize =
+    16 * Annotation::kValueMaxSize;
+
+namespace internal {
+
+//! \brief Compresses \a string into \a buffer as the value of an
+//!     Annotation::Type::kCompressedString annotation.
+//!
+//! The string is compressed in pieces, each ending at a zlib flush point. If
+//! the whole compressed string doesn’t fit in \a buffer, \a buffer receives the
+//! longest run of pieces that does, which still decompresses to a prefix of
+//! \a string.
+//!
+//! \param[in] string The string to compress. Only the first
+//!     kCompressedAnnotationMaxStringSize bytes are used.
+//! \param[out] buffer The buffer to receive the compressed value.
+//! \param[in] buffer_size The size of \a buffer.
+//! \param[out] complete Set to `true` if all of \a string was compressed into
+//!     \a buffer, and `false` otherwise.
+//!
+//! \return The number of bytes written to \a buffer, which is `0` on failure
+//!     or if not even the first piece fit.
+size_t CompressAnnotationValue(base::StringPiece string,
+                               uint8_t* buffer,
+                               size_t buffer_size,
+                               bool* complete);
+
+}  // namespace internal
+
+//! \brief Decompresses the value of an Annotation::Type::kCompressedString
+//!     annotation.
+//!
+//! A value that ends at a flush point instead of at the end of the zlib stream
+//! is accepted, and yields the prefix of the string that it holds.
+//!
+//! \param[in] data The compressed value.
+//! \param[in] size The size of \a data.
+//! \param[out] string The decompressed string.
+//!
+//! \return `true` on success, `false` on failure with a message logged.
+bool DecompressAnnotationValue(const uint8_t* data,
+                               size_t size,
+                               std::string* string);
+
+//! \brief Obtains the string held by the value of an annotation that’s either
+//!     an Annotation::Type::kString or an Annotation::Type::kCompressedString.
+//!
+//! \param[in] type The type of the annotation.
+//! \param[in] data The value of the annotation.
+//! \param[in] size The size of \a data.
+//! \param[out] string The string held by the annotation.
+//!
+//! \return `true` on success. `false` if \a type is neither string type, or
+//!     if a compressed value couldn’t be decompressed, with a message logged.
+bool ReadStringAnnotationValue(uint16_t type,
+                               const uint8_t* data,
+                               size_t size,
+                               std::string* string);
+
+//! \brief An \sa Annotation that stores a string value compressed with zlib.
+//!
+//! The storage for the compressed value is allocated by the annotation and the
+//! template parameter \a MaxSize controls its size. Large, redundant strings
+//! such as JSON state or log tails compress well, so much more of them fits in
+//! the same space than in a StringAnnotation.
+//!
+//! Compression happens in Set(), on the caller’s thread, so that nothing
+//! needs to be done when a crash is captured. Set() is therefore more
+//! expensive than StringAnnotation::Set(), and shouldn’t be called for every
+//! small change to the value.
+//!
+//! Readers of minidumps see this annotation as an Annotation::Type::kString
+//! annotation holding the decompressed string.
+template <Annotation::ValueSizeType MaxSize>
+class CompressedStringAnnotation : public Annotation {
+ public:
+  //! \brief Constructs a new CompressedStringAnnotation with the given
+  //!     \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  constexpr explicit CompressedStringAnnotation(const char name[])
+      : Annotation(Type::kCompressedString, name, value_), value_() {}
+
+  CompressedStringAnnotation(const CompressedStringAnnotation&) = delete;
+  CompressedStringAnnotation& operator=(const CompressedStringAnnotation&) =
+      delete;
+
+  //! \brief Compresses \a string and sets it as the Annotation's value.
+  //!
+  //! If the compressed string doesn’t fit, the value holds as much of the
+  //! start of the string as fits.
+  //!
+  //! \param[in] string The string value.
+  //!
+  //! \return `true` if all of \a string was stored, and `false` if it was
+  //!     truncated.
+  bool Set(base::StringPiece string) {
+    // The value is cleared first so that a crash while it’s being rewritten
+    // doesn’t capture a mix of old and new data.
+    Clear();
+    bool complete;
+    const size_t size =
+        internal::CompressAnnotationValue(string, value_, MaxSize, &complete);
+    SetSize(static_cast<ValueSizeType>(size));
+    return complete;
+  }
+
+ private:
+  uint8_t value_[MaxSize];
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_COMPRESSED_ANNOTATION_H_
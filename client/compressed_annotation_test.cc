@@ -0,0 +1,119 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/compressed_annotation.h"
+
+#include <string>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Returns a string that compresses well but not trivially, like a log.
+std::string LogText(size_t size) {
+  std::string text;
+  for (size_t line = 0; text.size() < size; ++line) {
+    text += "line " + std::to_string(line) + ": nothing to report\n";
+  }
+  text.resize(size);
+  return text;
+}
+
+std::string AnnotationString(const Annotation& annotation) {
+  std::string string;
+  EXPECT_TRUE(ReadStringAnnotationValue(
+      static_cast<uint16_t>(annotation.type()),
+      static_cast<const uint8_t*>(annotation.value()),
+      annotation.size(),
+      &string));
+  return string;
+}
+
+class CompressedStringAnnotationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+ private:
+  AnnotationList annotations_;
+};
+
+TEST_F(CompressedStringAnnotationTest, RoundTrip) {
+  CompressedStringAnnotation<4096> annotation("log");
+  EXPECT_EQ(annotation.type(), Annotation::Type::kCompressedString);
+  EXPECT_FALSE(annotation.is_set());
+
+  const std::string text = LogText(20000);
+  EXPECT_TRUE(annotation.Set(text));
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_LT(annotation.size(), 4096u);
+  EXPECT_EQ(AnnotationString(annotation), text);
+
+  EXPECT_TRUE(annotation.Set("short"));
+  EXPECT_EQ(AnnotationString(annotation), "short");
+
+  EXPECT_TRUE(annotation.Set(""));
+  EXPECT_FALSE(annotation.is_set());
+}
+
+TEST_F(CompressedStringAnnotationTest, Truncated) {
+  CompressedStringAnnotation<512> annotation("log");
+
+  // Too much to fit, even compressed. What’s stored is a prefix of the string
+  // that ends at a flush point.
+  const std::string text = LogText(100000);
+  EXPECT_FALSE(annotation.Set(text));
+  ASSERT_TRUE(annotation.is_set());
+  EXPECT_LE(annotation.size(), 512u);
+
+  const std::string prefix = AnnotationString(annotation);
+  EXPECT_GT(prefix.size(), 512u);
+  EXPECT_LT(prefix.size(), text.size());
+  EXPECT_EQ(prefix, text.substr(0, prefix.size()));
+}
+
+TEST(CompressedAnnotation, Decompress) {
+  std::string string;
+  EXPECT_FALSE(DecompressAnnotationValue(nullptr, 0, &string));
+
+  static constexpr uint8_t kNotZlib[] = {
+      'n', 'o', 't', ' ', 'z', 'l', 'i', 'b'};
+  EXPECT_FALSE(DecompressAnnotationValue(kNotZlib, sizeof(kNotZlib), &string));
+
+  EXPECT_TRUE(ReadStringAnnotationValue(
+      static_cast<uint16_t>(Annotation::Type::kString),
+      kNotZlib,
+      sizeof(kNotZlib),
+      &string));
+  EXPECT_EQ(string, "not zlib");
+
+  EXPECT_FALSE(ReadStringAnnotationValue(
+      static_cast<uint16_t>(Annotation::Type::kUserDefinedStart) + 1,
+      kNotZlib,
+      sizeof(kNotZlib),
+      &string));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
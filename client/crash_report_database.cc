@@ -14,13 +14,22 @@
 
 #include "client/crash_report_database.h"
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_helper.h"
 #include "util/file/filesystem.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/stream/file_writer_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
 
 namespace crashpad {
 
@@ -28,6 +37,62 @@ namespace {
 constexpr base::FilePath::CharType kAttachmentsDirectory[] =
     FILE_PATH_LITERAL("attachments");
 
+// The upload parameters are stored in the report's attachments directory under
+// a name that AttachmentNameIsOK() rejects, so that it can't collide with an
+// attachment.
+constexpr base::FilePath::CharType kUploadParametersFile[] =
+    FILE_PATH_LITERAL("#upload_parameters");
+
+// The state of a resumable upload is stored alongside the upload parameters,
+// and is likewise hidden from the attachments.
+constexpr base::FilePath::CharType kResumableUploadStateFile[] =
+    FILE_PATH_LITERAL("#resumable_upload_state");
+
+// The digest of a report file computed while it was written is likewise stored
+// alongside the upload parameters.
+constexpr base::FilePath::CharType kContentDigestFile[] =
+    FILE_PATH_LITERAL("#content_digest");
+
+// The summary stored by NewReport::SetSummary() is likewise stored alongside
+// the upload parameters.
+constexpr base::FilePath::CharType kSummaryFile[] =
+    FILE_PATH_LITERAL("#summary");
+
+// A body prepared by NewReport::AddUploadBody() is likewise stored alongside
+// the upload parameters. Its content headers are stored in a separate file
+// once it's complete, so that an incomplete body is never used.
+constexpr base::FilePath::CharType kUploadBodyFile[] =
+    FILE_PATH_LITERAL("#upload_body");
+constexpr base::FilePath::CharType kUploadBodyHeadersFile[] =
+    FILE_PATH_LITERAL("#upload_body_headers");
+
+// The upload parameters file begins with these values and the number of
+// parameters, followed by a length-prefixed key and value for each parameter.
+// Lengths are stored as native-endian uint32_t values, as the file is never
+// moved between machines. The resumable upload state, content digest, summary,
+// and upload body headers files have the same layout, each with its own magic
+// number.
+constexpr uint32_t kUploadParametersMagic = 0x43505550;  // 'CPUP'
+constexpr uint32_t kResumableUploadStateMagic = 0x43505255;  // 'CPRU'
+constexpr uint32_t kContentDigestMagic = 0x43504344;  // 'CPCD'
+constexpr uint32_t kSummaryMagic = 0x43505253;  // 'CPRS'
+constexpr uint32_t kUploadBodyHeadersMagic = 0x43505542;  // 'CPUB'
+constexpr uint32_t kUploadParametersVersion = 1;
+
+constexpr char kResumableUploadIDKey[] = "upload_id";
+constexpr char kResumableUploadBoundaryKey[] = "boundary";
+constexpr char kResumableUploadOffsetKey[] = "offset";
+
+constexpr char kContentDigestXXH64Key[] = "xxh64";
+constexpr char kContentDigestSizeKey[] = "size";
+
+constexpr char kSummaryExceptionCodeKey[] = "exception_code";
+constexpr char kSummaryCrashingModuleKey[] = "crashing_module";
+constexpr char kSummaryCrashingModuleOffsetKey[] = "crashing_module_offset";
+constexpr char kSummaryProcessNameKey[] = "process_name";
+constexpr char kSummaryThreadCountKey[] = "thread_count";
+constexpr char kSummaryReportSizeKey[] = "report_size";
+
 bool AttachmentNameIsOK(const std::string& name) {
   for (const char c : name) {
     if (c != '_' && c != '-' && c != '.' && !isalnum(c))
@@ -35,6 +100,83 @@ bool AttachmentNameIsOK(const std::string& name) {
   }
   return true;
 }
+
+void AppendUint32(uint32_t value, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool ConsumeUint32(const std::string& data, size_t* offset, uint32_t* value) {
+  if (data.size() - *offset < sizeof(*value)) {
+    return false;
+  }
+  memcpy(value, data.data() + *offset, sizeof(*value));
+  *offset += sizeof(*value);
+  return true;
+}
+
+bool ConsumeString(const std::string& data,
+                   size_t* offset,
+                   std::string* string) {
+  uint32_t size;
+  if (!ConsumeUint32(data, offset, &size) || data.size() - *offset < size) {
+    return false;
+  }
+  string->assign(data, *offset, size);
+  *offset += size;
+  return true;
+}
+
+std::string SerializeUploadParameters(
+    uint32_t magic,
+    const std::map<std::string, std::string>& parameters) {
+  std::string data;
+  AppendUint32(magic, &data);
+  AppendUint32(kUploadParametersVersion, &data);
+  AppendUint32(base::checked_cast<uint32_t>(parameters.size()), &data);
+  for (const auto& kv : parameters) {
+    AppendUint32(base::checked_cast<uint32_t>(kv.first.size()), &data);
+    data.append(kv.first);
+    AppendUint32(base::checked_cast<uint32_t>(kv.second.size()), &data);
+    data.append(kv.second);
+  }
+  return data;
+}
+
+bool DeserializeUploadParameters(
+    const std::string& data,
+    uint32_t expected_magic,
+    std::map<std::string, std::string>* parameters) {
+  size_t offset = 0;
+  uint32_t magic;
+  uint32_t version;
+  uint32_t count;
+  if (!ConsumeUint32(data, &offset, &magic) ||
+      !ConsumeUint32(data, &offset, &version) || magic != expected_magic ||
+      version != kUploadParametersVersion ||
+      !ConsumeUint32(data, &offset, &count)) {
+    LOG(ERROR) << "unrecognized upload parameters";
+    return false;
+  }
+
+  std::map<std::string, std::string> local_parameters;
+  for (uint32_t index = 0; index < count; ++index) {
+    std::string key;
+    std::string value;
+    if (!ConsumeString(data, &offset, &key) ||
+        !ConsumeString(data, &offset, &value)) {
+      LOG(ERROR) << "truncated upload parameters";
+      return false;
+    }
+    local_parameters[key] = value;
+  }
+  if (offset != data.size()) {
+    LOG(ERROR) << "unexpected data after upload parameters";
+    return false;
+  }
+
+  parameters->swap(local_parameters);
+  return true;
+}
 }  // namespace
 
 CrashReportDatabase::Report::Report()
@@ -50,19 +192,32 @@ CrashReportDatabase::Report::Report()
 
 CrashReportDatabase::NewReport::NewReport()
     : writer_(std::make_unique<FileWriter>()),
+      compressed_writer_(),
+      hashing_stream_(nullptr),
+      reader_(),
+      stored_reader_(),
+      decompressed_report_(),
       file_remover_(),
       attachment_writers_(),
       attachment_removers_(),
       uuid_(),
-      database_() {}
+      database_(),
+      compressed_(false),
+      compression_finished_(false),
+      compression_succeeded_(false) {}
 
-CrashReportDatabase::NewReport::~NewReport() = default;
+CrashReportDatabase::NewReport::~NewReport() {
+  // The streams behind compressed_writer_ expect to be flushed before they are
+  // destroyed, even if the report is being discarded.
+  FinishCompression();
+}
 
 bool CrashReportDatabase::NewReport::Initialize(
     CrashReportDatabase* database,
     const base::FilePath& directory,
     const base::FilePath::StringType& extension) {
   database_ = database;
+  compressed_ = database->compress_new_reports_;
 
   if (!uuid_.InitializeWithNew()) {
     return false;
@@ -83,32 +238,104 @@ bool CrashReportDatabase::NewReport::Initialize(
   return true;
 }
 
+bool CrashReportDatabase::NewReport::InitializeWithFile(
+    CrashReportDatabase* database,
+    const UUID& uuid,
+    const base::FilePath& path) {
+  database_ = database;
+  compressed_ = database->compress_new_reports_;
+  uuid_ = uuid;
+
+  // The file is removed even if it can’t be opened, as it would otherwise be
+  // left behind unclaimed.
+  file_remover_.reset(path);
+  return writer_->Open(
+      path, FileWriteMode::kReuseOrFail, FilePermissions::kOwnerOnly);
+}
+
+FileWriterInterface* CrashReportDatabase::NewReport::MinidumpWriter() {
+  if (!compressed_) {
+    return writer_.get();
+  }
+
+  if (!compressed_writer_) {
+    // The digest covers the compressed data, which is what the report file
+    // holds.
+    auto hashing_stream = std::make_unique<HashingOutputStream>(
+        std::make_unique<FileWriterOutputStream>(writer_.get()));
+    hashing_stream_ = hashing_stream.get();
+    compressed_writer_ = std::make_unique<OutputStreamFileWriter>(
+        std::make_unique<ZlibOutputStream>(ZlibOutputStream::Mode::kCompress,
+                                           ZlibOutputStream::Format::kGzip,
+                                           std::move(hashing_stream)));
+  }
+  return compressed_writer_.get();
+}
+
 FileReaderInterface* CrashReportDatabase::NewReport::Reader() {
+  if (!FinishCompression()) {
+    return nullptr;
+  }
+
   auto reader = std::make_unique<FileReader>();
   if (!reader->Open(file_remover_.get())) {
     return nullptr;
   }
+
+  if (compressed_writer_) {
+    auto decompressed_report = std::make_unique<ChunkedMemoryFile>();
+    if (!DecompressGzipFileContent(reader.get(), decompressed_report.get()) ||
+        !decompressed_report->SeekSet(0)) {
+      return nullptr;
+    }
+    decompressed_report_ = std::move(decompressed_report);
+    return decompressed_report_.get();
+  }
+
   reader_ = std::move(reader);
   return reader_.get();
 }
 
-FileWriter* CrashReportDatabase::NewReport::AddAttachment(
-    const std::string& name) {
+FileReader* CrashReportDatabase::NewReport::StoredReader() {
+  if (!FinishCompression()) {
+    return nullptr;
+  }
+
+  auto reader = std::make_unique<FileReader>();
+  if (!reader->Open(file_remover_.get())) {
+    return nullptr;
+  }
+  stored_reader_ = std::move(reader);
+  return stored_reader_.get();
+}
+
+bool CrashReportDatabase::NewReport::AttachmentPathForName(
+    const std::string& name,
+    base::FilePath* path) {
   if (!AttachmentNameIsOK(name)) {
     LOG(ERROR) << "invalid name for attachment " << name;
-    return nullptr;
+    return false;
   }
   base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
   if (!LoggingCreateDirectory(
           report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
-    return nullptr;
+    return false;
   }
 #if BUILDFLAG(IS_WIN)
   const std::wstring name_string = base::UTF8ToWide(name);
 #else
   const std::string name_string = name;
 #endif
-  base::FilePath attachment_path = report_attachments_dir.Append(name_string);
+  *path = report_attachments_dir.Append(name_string);
+  return true;
+}
+
+FileWriter* CrashReportDatabase::NewReport::AddAttachment(
+    const std::string& name) {
+  base::FilePath attachment_path;
+  if (!AttachmentPathForName(name, &attachment_path)) {
+    return nullptr;
+  }
   auto writer = std::make_unique<FileWriter>();
   if (!writer->Open(attachment_path,
                     FileWriteMode::kCreateOrFail,
@@ -120,6 +347,227 @@ FileWriter* CrashReportDatabase::NewReport::AddAttachment(
   return attachment_writers_.back().get();
 }
 
+bool CrashReportDatabase::NewReport::AddAttachmentFromFile(
+    const std::string& name,
+    const base::FilePath& source,
+    bool allow_hard_link) {
+  base::FilePath attachment_path;
+  if (!AttachmentPathForName(name, &attachment_path)) {
+    return false;
+  }
+  if (!CloneOrCopyFile(source,
+                       attachment_path,
+                       FilePermissions::kOwnerOnly,
+                       allow_hard_link)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(attachment_path));
+  return true;
+}
+
+bool CrashReportDatabase::NewReport::SetUploadParameters(
+    const std::map<std::string, std::string>& parameters) {
+  base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
+  if (!LoggingCreateDirectory(
+          report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+  base::FilePath parameters_path =
+      report_attachments_dir.Append(kUploadParametersFile);
+  FileWriter writer;
+  if (!writer.Open(parameters_path,
+                   FileWriteMode::kCreateOrFail,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(parameters_path));
+  const std::string data =
+      SerializeUploadParameters(kUploadParametersMagic, parameters);
+  return writer.Write(data.data(), data.size());
+}
+
+bool CrashReportDatabase::GetUploadParameters(
+    const UUID& uuid,
+    std::map<std::string, std::string>* parameters) {
+  const base::FilePath parameters_path =
+      AttachmentsPath(uuid).Append(kUploadParametersFile);
+  if (!IsRegularFile(parameters_path)) {
+    return false;
+  }
+  std::string data;
+  return LoggingReadEntireFile(parameters_path, &data) &&
+         DeserializeUploadParameters(data, kUploadParametersMagic, parameters);
+}
+
+bool CrashReportDatabase::NewReport::SetSummary(
+    const ReportSummary& summary) {
+  if (!FinishCompression()) {
+    return false;
+  }
+  const FileOffset report_size = writer_->Seek(0, SEEK_END);
+  if (report_size < 0) {
+    return false;
+  }
+
+  base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
+  if (!LoggingCreateDirectory(
+          report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+  const base::FilePath summary_path =
+      report_attachments_dir.Append(kSummaryFile);
+  FileWriter writer;
+  if (!writer.Open(summary_path,
+                   FileWriteMode::kCreateOrFail,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(summary_path));
+
+  const std::map<std::string, std::string> values = {
+      {kSummaryExceptionCodeKey,
+       base::StringPrintf("%" PRIu32, summary.exception_code)},
+      {kSummaryCrashingModuleKey, summary.crashing_module},
+      {kSummaryCrashingModuleOffsetKey,
+       base::StringPrintf("%" PRIu64, summary.crashing_module_offset)},
+      {kSummaryProcessNameKey, summary.process_name},
+      {kSummaryThreadCountKey,
+       base::StringPrintf("%" PRIu32, summary.thread_count)},
+      {kSummaryReportSizeKey,
+       base::StringPrintf("%" PRIu64, static_cast<uint64_t>(report_size))},
+  };
+  const std::string data = SerializeUploadParameters(kSummaryMagic, values);
+  return writer.Write(data.data(), data.size());
+}
+
+FileWriter* CrashReportDatabase::NewReport::AddUploadBody() {
+  base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
+  if (!LoggingCreateDirectory(
+          report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
+    return nullptr;
+  }
+  const base::FilePath body_path =
+      report_attachments_dir.Append(kUploadBodyFile);
+  auto writer = std::make_unique<FileWriter>();
+  if (!writer->Open(body_path,
+                    FileWriteMode::kCreateOrFail,
+                    FilePermissions::kOwnerOnly)) {
+    return nullptr;
+  }
+  attachment_writers_.emplace_back(std::move(writer));
+  attachment_removers_.emplace_back(ScopedRemoveFile(body_path));
+  return attachment_writers_.back().get();
+}
+
+bool CrashReportDatabase::NewReport::SetUploadBodyHeaders(
+    const std::map<std::string, std::string>& content_headers) {
+  // AddUploadBody() created the directory.
+  const base::FilePath headers_path =
+      database_->AttachmentsPath(uuid_).Append(kUploadBodyHeadersFile);
+  FileWriter writer;
+  if (!writer.Open(headers_path,
+                   FileWriteMode::kCreateOrFail,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(headers_path));
+  const std::string data =
+      SerializeUploadParameters(kUploadBodyHeadersMagic, content_headers);
+  return writer.Write(data.data(), data.size());
+}
+
+void CrashReportDatabase::DiscardUploadBody(const UUID& uuid) {
+  const base::FilePath report_attachments_dir = AttachmentsPath(uuid);
+  for (const base::FilePath::CharType* name :
+       {kUploadBodyFile, kUploadBodyHeadersFile}) {
+    const base::FilePath path = report_attachments_dir.Append(name);
+    if (IsRegularFile(path)) {
+      LoggingRemoveFile(path);
+    }
+  }
+}
+
+bool CrashReportDatabase::GetReportSummary(const UUID& uuid,
+                                           ReportSummary* summary) {
+  const base::FilePath summary_path =
+      AttachmentsPath(uuid).Append(kSummaryFile);
+  if (!IsRegularFile(summary_path)) {
+    return false;
+  }
+
+  std::string data;
+  std::map<std::string, std::string> values;
+  if (!LoggingReadEntireFile(summary_path, &data) ||
+      !DeserializeUploadParameters(data, kSummaryMagic, &values)) {
+    return false;
+  }
+
+  const auto exception_code = values.find(kSummaryExceptionCodeKey);
+  const auto crashing_module = values.find(kSummaryCrashingModuleKey);
+  const auto crashing_module_offset =
+      values.find(kSummaryCrashingModuleOffsetKey);
+  const auto process_name = values.find(kSummaryProcessNameKey);
+  const auto thread_count = values.find(kSummaryThreadCountKey);
+  const auto report_size = values.find(kSummaryReportSizeKey);
+  ReportSummary local_summary;
+  if (exception_code == values.end() || crashing_module == values.end() ||
+      crashing_module_offset == values.end() ||
+      process_name == values.end() || thread_count == values.end() ||
+      report_size == values.end() ||
+      !StringToNumber(exception_code->second, &local_summary.exception_code) ||
+      !StringToNumber(crashing_module_offset->second,
+                      &local_summary.crashing_module_offset) ||
+      !StringToNumber(thread_count->second, &local_summary.thread_count) ||
+      !StringToNumber(report_size->second, &local_summary.report_size)) {
+    LOG(ERROR) << "incomplete report summary";
+    return false;
+  }
+  local_summary.crashing_module = crashing_module->second;
+  local_summary.process_name = process_name->second;
+  *summary = local_summary;
+  return true;
+}
+
+bool CrashReportDatabase::NewReport::FinishCompression() {
+  if (!compressed_writer_) {
+    return true;
+  }
+
+  if (!compression_finished_) {
+    compression_finished_ = true;
+    compression_succeeded_ =
+        compressed_writer_->Flush() && WriteContentDigest();
+  }
+  return compression_succeeded_;
+}
+
+bool CrashReportDatabase::NewReport::WriteContentDigest() {
+  base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid_);
+  if (!LoggingCreateDirectory(
+          report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+  const base::FilePath digest_path =
+      report_attachments_dir.Append(kContentDigestFile);
+  FileWriter writer;
+  if (!writer.Open(digest_path,
+                   FileWriteMode::kCreateOrFail,
+                   FilePermissions::kOwnerOnly)) {
+    return false;
+  }
+  attachment_removers_.emplace_back(ScopedRemoveFile(digest_path));
+
+  const std::map<std::string, std::string> values = {
+      {kContentDigestXXH64Key,
+       base::StringPrintf("%" PRIu64, hashing_stream_->digest())},
+      {kContentDigestSizeKey,
+       base::StringPrintf("%" PRIu64, hashing_stream_->size())},
+  };
+  const std::string data =
+      SerializeUploadParameters(kContentDigestMagic, values);
+  return writer.Write(data.data(), data.size());
+}
+
 void CrashReportDatabase::UploadReport::InitializeAttachments() {
   base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid);
   DirectoryReader dir_reader;
@@ -132,6 +580,34 @@ void CrashReportDatabase::UploadReport::InitializeAttachments() {
   while ((dir_result = dir_reader.NextFile(&filename)) ==
          DirectoryReader::Result::kSuccess) {
     const base::FilePath filepath(report_attachments_dir.Append(filename));
+    if (filename.value() == kUploadParametersFile) {
+      std::string data;
+      has_upload_parameters_ =
+          LoggingReadEntireFile(filepath, &data) &&
+          DeserializeUploadParameters(
+              data, kUploadParametersMagic, &upload_parameters_);
+      continue;
+    }
+    if (filename.value() == kUploadBodyFile) {
+      auto body_reader = std::make_unique<FileReader>();
+      if (body_reader->Open(filepath)) {
+        upload_body_reader_ = std::move(body_reader);
+      }
+      continue;
+    }
+    if (filename.value() == kUploadBodyHeadersFile) {
+      std::string data;
+      has_upload_body_headers_ =
+          LoggingReadEntireFile(filepath, &data) &&
+          DeserializeUploadParameters(
+              data, kUploadBodyHeadersMagic, &upload_body_headers_);
+      continue;
+    }
+    if (filename.value() == kResumableUploadStateFile ||
+        filename.value() == kContentDigestFile ||
+        filename.value() == kSummaryFile) {
+      continue;
+    }
     std::unique_ptr<FileReader> file_reader(std::make_unique<FileReader>());
     if (!file_reader->Open(filepath)) {
       continue;
@@ -152,7 +628,13 @@ CrashReportDatabase::UploadReport::UploadReport()
       database_(nullptr),
       attachment_readers_(),
       attachment_map_(),
-      report_metrics_(false) {}
+      upload_parameters_(),
+      upload_body_reader_(),
+      upload_body_headers_(),
+      has_upload_parameters_(false),
+      has_upload_body_headers_(false),
+      report_metrics_(false),
+      compressed_(false) {}
 
 CrashReportDatabase::UploadReport::~UploadReport() {
   if (database_) {
@@ -160,11 +642,135 @@ CrashReportDatabase::UploadReport::~UploadReport() {
   }
 }
 
+bool CrashReportDatabase::UploadReport::GetUploadParameters(
+    std::map<std::string, std::string>* parameters) const {
+  if (!has_upload_parameters_) {
+    return false;
+  }
+  *parameters = upload_parameters_;
+  return true;
+}
+
+FileReader* CrashReportDatabase::UploadReport::GetUploadBody(
+    std::map<std::string, std::string>* content_headers) const {
+  if (!upload_body_reader_ || !has_upload_body_headers_ ||
+      !upload_body_reader_->SeekSet(0)) {
+    return nullptr;
+  }
+  *content_headers = upload_body_headers_;
+  return upload_body_reader_.get();
+}
+
+bool CrashReportDatabase::UploadReport::GetContentDigest(
+    uint64_t* digest,
+    uint64_t* size) const {
+  const base::FilePath digest_path =
+      database_->AttachmentsPath(uuid).Append(kContentDigestFile);
+  if (!IsRegularFile(digest_path)) {
+    return false;
+  }
+
+  std::string data;
+  std::map<std::string, std::string> values;
+  if (!LoggingReadEntireFile(digest_path, &data) ||
+      !DeserializeUploadParameters(data, kContentDigestMagic, &values)) {
+    return false;
+  }
+
+  const auto xxh64 = values.find(kContentDigestXXH64Key);
+  const auto file_size = values.find(kContentDigestSizeKey);
+  uint64_t local_digest;
+  uint64_t local_size;
+  if (xxh64 == values.end() || file_size == values.end() ||
+      !StringToNumber(xxh64->second, &local_digest) ||
+      !StringToNumber(file_size->second, &local_size)) {
+    LOG(ERROR) << "incomplete content digest";
+    return false;
+  }
+  *digest = local_digest;
+  *size = local_size;
+  return true;
+}
+
+bool CrashReportDatabase::UploadReport::GetResumableUploadState(
+    ResumableUploadState* state) const {
+  const base::FilePath state_path =
+      database_->AttachmentsPath(uuid).Append(kResumableUploadStateFile);
+  if (!IsRegularFile(state_path)) {
+    return false;
+  }
+
+  std::string data;
+  std::map<std::string, std::string> values;
+  if (!LoggingReadEntireFile(state_path, &data) ||
+      !DeserializeUploadParameters(data, kResumableUploadStateMagic, &values)) {
+    return false;
+  }
+
+  const auto upload_id = values.find(kResumableUploadIDKey);
+  const auto boundary = values.find(kResumableUploadBoundaryKey);
+  const auto offset = values.find(kResumableUploadOffsetKey);
+  ResumableUploadState local_state;
+  if (upload_id == values.end() || boundary == values.end() ||
+      offset == values.end() ||
+      !StringToNumber(offset->second, &local_state.offset)) {
+    LOG(ERROR) << "incomplete resumable upload state";
+    return false;
+  }
+  local_state.upload_id = upload_id->second;
+  local_state.boundary = boundary->second;
+  *state = local_state;
+  return true;
+}
+
+bool CrashReportDatabase::UploadReport::SetResumableUploadState(
+    const ResumableUploadState& state) const {
+  base::FilePath report_attachments_dir = database_->AttachmentsPath(uuid);
+  if (!LoggingCreateDirectory(
+          report_attachments_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+
+  const std::map<std::string, std::string> values = {
+      {kResumableUploadIDKey, state.upload_id},
+      {kResumableUploadBoundaryKey, state.boundary},
+      {kResumableUploadOffsetKey, base::StringPrintf("%" PRIu64, state.offset)},
+  };
+  const std::string data =
+      SerializeUploadParameters(kResumableUploadStateMagic, values);
+
+  FileWriter writer;
+  return writer.Open(report_attachments_dir.Append(kResumableUploadStateFile),
+                     FileWriteMode::kTruncateOrCreate,
+                     FilePermissions::kOwnerOnly) &&
+         writer.Write(data.data(), data.size());
+}
+
+void CrashReportDatabase::UploadReport::ClearResumableUploadState() const {
+  const base::FilePath state_path =
+      database_->AttachmentsPath(uuid).Append(kResumableUploadStateFile);
+  if (IsRegularFile(state_path)) {
+    LoggingRemoveFile(state_path);
+  }
+}
+
 bool CrashReportDatabase::UploadReport::Initialize(const base::FilePath& path,
                                                    CrashReportDatabase* db) {
   database_ = db;
   InitializeAttachments();
-  return reader_->Open(path);
+  if (!reader_->Open(path)) {
+    return false;
+  }
+
+  // Minidumps begin with MINIDUMP_SIGNATURE, so a report that begins with the
+  // gzip magic number (RFC 1952 §2.3.1) was compressed as it was written.
+  uint8_t magic[2];
+  FileOperationResult rv = reader_->Read(magic, sizeof(magic));
+  if (rv < 0) {
+    return false;
+  }
+  compressed_ = rv == sizeof(magic) && magic[0] == 0x1f && magic[1] == 0x8b;
+  return reader_->SeekSet(0);
 }
 
 CrashReportDatabase::OperationStatus CrashReportDatabase::RecordUploadComplete(
@@ -176,6 +782,31 @@ CrashReportDatabase::OperationStatus CrashReportDatabase::RecordUploadComplete(
   return RecordUploadAttempt(report, true, id);
 }
 
+CrashReportDatabase::OperationStatus CrashReportDatabase::GetTotalSize(
+    uint64_t* total_size) {
+  std::vector<Report> reports;
+  OperationStatus status = GetPendingReports(&reports);
+  if (status != kNoError) {
+    return status;
+  }
+
+  std::vector<Report> completed_reports;
+  status = GetCompletedReports(&completed_reports);
+  if (status != kNoError) {
+    return status;
+  }
+
+  uint64_t size = 0;
+  for (const auto& report : reports) {
+    size += report.total_size;
+  }
+  for (const auto& report : completed_reports) {
+    size += report.total_size;
+  }
+  *total_size = size;
+  return kNoError;
+}
+
 base::FilePath CrashReportDatabase::AttachmentsPath(const UUID& uuid) {
 #if BUILDFLAG(IS_WIN)
   const std::wstring uuid_string = uuid.ToWString();
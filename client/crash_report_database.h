@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_CLIENT_CRASH_REPORT_DATABASE_H_
 #define CRASHPAD_CLIENT_CRASH_REPORT_DATABASE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <time.h>
 
@@ -24,12 +25,15 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "util/file/chunked_memory_file.h"
 #include "util/file/file_io.h"
 #include "util/file/file_reader.h"
 #include "util/file/file_writer.h"
+#include "util/file/output_stream_file_writer.h"
 #include "util/file/scoped_remove_file.h"
 #include "util/misc/metrics.h"
 #include "util/misc/uuid.h"
+#include "util/stream/hashing_output_stream.h"
 
 namespace crashpad {
 
@@ -104,6 +108,33 @@ class CrashReportDatabase {
     uint64_t total_size;
   };
 
+  //! \brief A summary of a crash report, stored with the report when it is
+  //!     written so that reports can be listed without reading each
+  //!     minidump.
+  struct ReportSummary {
+    //! \brief The exception code, as in ExceptionSnapshot::Exception(), or
+    //!     `0` if the report has no exception.
+    uint32_t exception_code = 0;
+
+    //! \brief The name of the module containing the exception address, or
+    //!     empty if it wasn’t found.
+    std::string crashing_module;
+
+    //! \brief The offset of the exception address from the base address of
+    //!     #crashing_module.
+    uint64_t crashing_module_offset = 0;
+
+    //! \brief The name of the crashed process’ executable, without any
+    //!     directory.
+    std::string process_name;
+
+    //! \brief The number of threads in the crashed process.
+    uint32_t thread_count = 0;
+
+    //! \brief The size of the report file, in bytes.
+    uint64_t report_size = 0;
+  };
+
   //! \brief A crash report that is in the process of being written.
   //!
   //! An instance of this class should be created via PrepareNewCrashReport().
@@ -119,10 +150,46 @@ class CrashReportDatabase {
     //! \brief An open FileWriter with which to write the report.
     FileWriter* Writer() const { return writer_.get(); }
 
+    //! \brief An open FileWriterInterface with which to write the report’s
+    //!     minidump.
+    //!
+    //! If IsCompressed() is `true`, data written to the returned object is
+    //! `gzip`-compressed on its way to the report file, and the returned
+    //! object does not support seeking, so the minidump must be written with
+    //! seeking disallowed, for example by MinidumpFileWriter::WriteMinidump().
+    //! Otherwise, this returns Writer().
+    //!
+    //! Data must not be written to both this and Writer().
+    //!
+    //! When the report is compressed, the XXH64 digest and size of the report
+    //! file are computed as it is written, and stored with the report for
+    //! UploadReport::GetContentDigest(). An uncompressed minidump is written
+    //! with seeking, so no digest is computed for it.
+    FileWriterInterface* MinidumpWriter();
+
+    //! \brief Whether data written through MinidumpWriter() is stored
+    //!     compressed.
+    //!
+    //! \sa CrashReportDatabase::SetCompressNewReports()
+    bool IsCompressed() const { return compressed_; }
+
     //! \brief Returns a FileReaderInterface to the report, or `nullptr` with a
     //!     message logged.
+    //!
+    //! If the report was written compressed through MinidumpWriter(), the
+    //! reader provides the decompressed report, and nothing further may be
+    //! written to the report.
     FileReaderInterface* Reader();
 
+    //! \brief Returns a FileReader to the report file as it is stored, or
+    //!     `nullptr` with a message logged.
+    //!
+    //! Unlike Reader(), this doesn’t decompress the report, so if
+    //! IsCompressed() is `true`, it reads `gzip`-compressed data. As with
+    //! Reader(), nothing further may be written to the report through
+    //! MinidumpWriter().
+    FileReader* StoredReader();
+
     //! A unique identifier by which this report will always be known to the
     //! database.
     const UUID& ReportID() const { return uuid_; }
@@ -137,6 +204,73 @@ class CrashReportDatabase {
     //!     the attachment, or `nullptr` on failure with an error logged.
     FileWriter* AddAttachment(const std::string& name);
 
+    //! \brief Adds an attachment to the report with the contents of an
+    //!     existing file.
+    //!
+    //! This avoids copying the file’s contents where possible, by cloning the
+    //! file or, if \a allow_hard_link is `true`, by linking to it. See
+    //! CloneOrCopyFile().
+    //!
+    //! \param[in] name The key and name for the attachment, as for
+    //!     AddAttachment().
+    //! \param[in] source The path to the file to attach.
+    //! \param[in] allow_hard_link Whether the attachment may be a hard link to
+    //!     \a source. This should only be `true` if \a source will not be
+    //!     modified.
+    //! \return `true` on success. `false` on failure with an error logged.
+    bool AddAttachmentFromFile(const std::string& name,
+                               const base::FilePath& source,
+                               bool allow_hard_link);
+
+    //! \brief Stores the HTTP form parameters to upload with the report.
+    //!
+    //! The upload thread normally derives these parameters by reading the
+    //! report's minidump. Storing them when the report is written allows
+    //! them to be obtained by UploadReport::GetUploadParameters() instead.
+    //! The parameters are not uploaded as an attachment. This may be called
+    //! at most once for each report.
+    //!
+    //! \param[in] parameters The parameters to store.
+    //! \return `true` on success, `false` on failure with an error logged.
+    bool SetUploadParameters(
+        const std::map<std::string, std::string>& parameters);
+
+    //! \brief Stores a summary of the report, to be obtained by
+    //!     CrashReportDatabase::GetReportSummary().
+    //!
+    //! This must be called after the report has been written, as nothing more
+    //! may be written through MinidumpWriter() afterwards. The
+    //! ReportSummary::report_size field of \a summary is ignored, and the size
+    //! of the report file is stored instead. This may be called at most once
+    //! for each report.
+    //!
+    //! \param[in] summary The summary to store.
+    //! \return `true` on success, `false` on failure with an error logged.
+    bool SetSummary(const ReportSummary& summary);
+
+    //! \brief Adds a prepared HTTP body with which to upload the report.
+    //!
+    //! The body is stored with the report’s attachments, but is not uploaded
+    //! as an attachment. Once it has been written in full and
+    //! SetUploadBodyHeaders() has been called, UploadReport::GetUploadBody()
+    //! provides it to the uploader, which may send it in place of a body built
+    //! from the report and its attachments. It is discarded by
+    //! CrashReportDatabase::DiscardUploadBody() once the report has been
+    //! uploaded. Until then, it counts towards the report’s
+    //! Report::total_size. This may be called at most once for each report.
+    //!
+    //! \return A FileWriter that the caller should use to write the body, or
+    //!     `nullptr` on failure with an error logged.
+    FileWriter* AddUploadBody();
+
+    //! \brief Completes the body added by AddUploadBody().
+    //!
+    //! \param[in] content_headers The HTTP content headers that describe the
+    //!     body, such as `Content-Type` and `Content-Encoding`.
+    //! \return `true` on success, `false` on failure with an error logged.
+    bool SetUploadBodyHeaders(
+        const std::map<std::string, std::string>& content_headers);
+
    private:
     friend class CrashReportDatabaseGeneric;
     friend class CrashReportDatabaseMac;
@@ -146,13 +280,46 @@ class CrashReportDatabase {
                     const base::FilePath& directory,
                     const base::FilePath::StringType& extension);
 
+    //! \brief Initializes this object to write to the existing, empty file at
+    //!     \a path as the report identified by \a uuid.
+    bool InitializeWithFile(CrashReportDatabase* database,
+                            const UUID& uuid,
+                            const base::FilePath& path);
+
+    //! \brief Completes the compressed data written through MinidumpWriter(),
+    //!     if any, and stores its digest.
+    //!
+    //! This is called before the report file is read or moved. It may be
+    //! called more than once.
+    //!
+    //! \return `true` on success, `false` on failure with a message logged.
+    bool FinishCompression();
+
+    //! \brief Stores the digest computed by hashing_stream_ with the report.
+    //!
+    //! \return `true` on success, `false` on failure with a message logged.
+    bool WriteContentDigest();
+
+    //! \brief Returns the path for a new attachment named \a name in \a path,
+    //!     creating the report’s attachments directory if necessary.
+    //!
+    //! \return `true` on success, `false` on failure with a message logged.
+    bool AttachmentPathForName(const std::string& name, base::FilePath* path);
+
     std::unique_ptr<FileWriter> writer_;
+    std::unique_ptr<OutputStreamFileWriter> compressed_writer_;
+    HashingOutputStream* hashing_stream_;  // weak, owned by compressed_writer_
     std::unique_ptr<FileReader> reader_;
+    std::unique_ptr<FileReader> stored_reader_;
+    std::unique_ptr<ChunkedMemoryFile> decompressed_report_;
     ScopedRemoveFile file_remover_;
     std::vector<std::unique_ptr<FileWriter>> attachment_writers_;
     std::vector<ScopedRemoveFile> attachment_removers_;
     UUID uuid_;
     CrashReportDatabase* database_;
+    bool compressed_;
+    bool compression_finished_;
+    bool compression_succeeded_;
   };
 
   //! \brief A crash report that is in the process of being uploaded.
@@ -160,6 +327,21 @@ class CrashReportDatabase {
   //! An instance of this class should be created via GetReportForUploading().
   class UploadReport : public Report {
    public:
+    //! \brief The progress of a resumable upload of the report, which allows
+    //!     an interrupted upload to continue where it left off.
+    struct ResumableUploadState {
+      //! \brief The identifier that the server assigned to the upload.
+      std::string upload_id;
+
+      //! \brief The multipart boundary used in the upload body, which must be
+      //!     reused so that the body is identical when the upload resumes.
+      std::string boundary;
+
+      //! \brief The number of bytes of the upload body acknowledged by the
+      //!     server.
+      uint64_t offset = 0;
+    };
+
     UploadReport();
 
     UploadReport(const UploadReport&) = delete;
@@ -168,14 +350,76 @@ class CrashReportDatabase {
     virtual ~UploadReport();
 
     //! \brief An open FileReader with which to read the report.
+    //!
+    //! If IsCompressed() is `true`, this reads the `gzip`-compressed report.
     FileReader* Reader() const { return reader_.get(); }
 
+    //! \brief Whether the report is stored `gzip`-compressed.
+    //!
+    //! \sa CrashReportDatabase::SetCompressNewReports()
+    bool IsCompressed() const { return compressed_; }
+
     //! \brief Obtains a mapping of names to file readers for any attachments
     //!     for the report.
     std::map<std::string, FileReader*> GetAttachments() const {
       return attachment_map_;
     }
 
+    //! \brief Obtains the HTTP form parameters stored by
+    //!     NewReport::SetUploadParameters() when the report was written.
+    //!
+    //! \param[out] parameters The stored parameters.
+    //! \return `true` on success with \a parameters set. `false` if no
+    //!     parameters were stored or they couldn't be read, in which case the
+    //!     caller must derive them from the report itself.
+    bool GetUploadParameters(
+        std::map<std::string, std::string>* parameters) const;
+
+    //! \brief Obtains the digest of the report file computed while it was
+    //!     written.
+    //!
+    //! \param[out] digest The XXH64 digest of the report file, as read by
+    //!     Reader().
+    //! \param[out] size The size of the report file, in bytes.
+    //! \return `true` on success with \a digest and \a size set. `false` if
+    //!     no digest was stored, as for an uncompressed report, or it couldn't
+    //!     be read.
+    bool GetContentDigest(uint64_t* digest, uint64_t* size) const;
+
+    //! \brief Obtains the HTTP body stored by NewReport::AddUploadBody() when
+    //!     the report was written.
+    //!
+    //! \param[out] content_headers The HTTP content headers that describe the
+    //!     body.
+    //! \return A FileReader positioned at the start of the body, owned by this
+    //!     object, on success with \a content_headers set. `nullptr` if no
+    //!     body was stored or it couldn't be read, in which case the caller
+    //!     must build the body from the report and its attachments.
+    FileReader* GetUploadBody(
+        std::map<std::string, std::string>* content_headers) const;
+
+    //! \brief Obtains the state of a resumable upload of the report stored by
+    //!     SetResumableUploadState().
+    //!
+    //! \param[out] state The stored state.
+    //! \return `true` on success with \a state set. `false` if no state was
+    //!     stored or it couldn't be read, in which case the upload must start
+    //!     from the beginning.
+    bool GetResumableUploadState(ResumableUploadState* state) const;
+
+    //! \brief Stores the state of a resumable upload of the report, so that it
+    //!     may be continued by a later upload attempt.
+    //!
+    //! The state is kept with the report's attachments, but is not uploaded as
+    //! an attachment.
+    //!
+    //! \param[in] state The state to store, replacing any stored previously.
+    //! \return `true` on success, `false` on failure with an error logged.
+    bool SetResumableUploadState(const ResumableUploadState& state) const;
+
+    //! \brief Discards any state stored by SetResumableUploadState().
+    void ClearResumableUploadState() const;
+
    private:
     friend class CrashReportDatabase;
     friend class CrashReportDatabaseGeneric;
@@ -189,7 +433,13 @@ class CrashReportDatabase {
     CrashReportDatabase* database_;
     std::vector<std::unique_ptr<FileReader>> attachment_readers_;
     std::map<std::string, FileReader*> attachment_map_;
+    std::map<std::string, std::string> upload_parameters_;
+    std::unique_ptr<FileReader> upload_body_reader_;
+    std::map<std::string, std::string> upload_body_headers_;
+    bool has_upload_parameters_;
+    bool has_upload_body_headers_;
     bool report_metrics_;
+    bool compressed_;
   };
 
   //! \brief The result code for operations performed on a database.
@@ -266,6 +516,23 @@ class CrashReportDatabase {
   static std::unique_ptr<CrashReportDatabase> InitializeWithoutCreating(
       const base::FilePath& path);
 
+  //! \brief Sets whether the minidumps of new reports are stored compressed.
+  //!
+  //! When enabled, the minidump of each report subsequently obtained from
+  //! PrepareNewCrashReport() is `gzip`-compressed as it is written through
+  //! NewReport::MinidumpWriter(), reducing the disk space and I/O used by
+  //! reports held in the database. Compressed and uncompressed reports may
+  //! coexist in a database, and are distinguished by
+  //! UploadReport::IsCompressed(). A `gzip`-compressed upload can include a
+  //! compressed report without compressing it again.
+  //!
+  //! This is disabled by default.
+  //!
+  //! \param[in] compress_new_reports Whether to compress new reports.
+  void SetCompressNewReports(bool compress_new_reports) {
+    compress_new_reports_ = compress_new_reports;
+  }
+
   //! \brief Returns the Settings object for this database.
   //!
   //! \return A weak pointer to the Settings object, which is owned by the
@@ -327,6 +594,19 @@ class CrashReportDatabase {
   //! \return The operation status code.
   virtual OperationStatus GetCompletedReports(std::vector<Report>* reports) = 0;
 
+  //! \brief Returns the total size of all pending and completed reports.
+  //!
+  //! The total is the sum of Report::total_size over every report returned by
+  //! GetPendingReports() and GetCompletedReports(), including attachments.
+  //! Implementations that record each report’s size when it is written may
+  //! compute this without examining the report files.
+  //!
+  //! \param[out] total_size The total size of the database’s reports, in bytes.
+  //!     Only valid if this returns #kNoError.
+  //!
+  //! \return The operation status code.
+  virtual OperationStatus GetTotalSize(uint64_t* total_size);
+
   //! \brief Obtains and locks a report object for uploading to a collection
   //!     server. On iOS the file lock is released and mutual-exclusion is kept
   //!     via a file attribute.
@@ -415,8 +695,151 @@ class CrashReportDatabase {
   //! \return The number of reports cleaned.
   virtual int CleanDatabase(time_t lockfile_ttl) { return 0; }
 
+  //! \brief Stores pending and completed reports in subdirectories named for
+  //!     the first two characters of their UUIDs, rather than directly in one
+  //!     directory per state.
+  //!
+  //! This keeps directory operations fast in databases that retain very many
+  //! reports. The layout is recorded in the database, so it persists and is
+  //! used by every process that subsequently opens the database. Existing
+  //! reports are moved into the new layout. Reports that are in use and can’t
+  //! be moved remain accessible, and are moved by a later CleanDatabase().
+  //!
+  //! This is only supported by the generic database implementation, used on
+  //! platforms other than Apple platforms and Windows.
+  //!
+  //! \return `true` if the database now uses the sharded layout. `false` if
+  //!     the layout isn’t supported or couldn’t be enabled.
+  virtual bool EnableShardedLayout() { return false; }
+
+  //! \brief Creates report files in advance, for PrepareNewCrashReport() to
+  //!     claim instead of creating a file while a crash is being handled.
+  //!
+  //! Creating a file, and reserving storage for it, can take a noticeable
+  //! amount of time on slow storage. This should be called when the process is
+  //! otherwise idle. Each file is held open and locked by this object until it
+  //! is claimed, so files left behind by a process that exited without
+  //! claiming them are recognized and removed when the database is next
+  //! opened, and by CleanDatabase(). Unclaimed files are removed when this
+  //! object is destroyed.
+  //!
+  //! This is only supported by the generic database implementation, used on
+  //! platforms other than Apple platforms and Windows, and only where files
+  //! can be locked.
+  //!
+  //! \param[in] count The number of files to keep available.
+  //! \param[in] preallocate_size The number of bytes of storage to reserve in
+  //!     each new file, or `0` to reserve none. See LoggingPreallocateFile().
+  //!
+  //! \return The number of files available to be claimed.
+  virtual size_t FillReportFilePool(size_t count, FileOffset preallocate_size) {
+    return 0;
+  }
+
+  //! \brief Writes new reports in a staging directory, to be committed to the
+  //!     database later by CommitStagedReports().
+  //!
+  //! The staging directory is intended to be on fast storage, such as `tmpfs`,
+  //! so that writing a report isn’t slowed by the database’s storage. After
+  //! this is called, PrepareNewCrashReport() creates report files in \a path,
+  //! and FinishedWritingCrashReport() leaves them there, staged, rather than
+  //! adding them to the database. Report attachments and upload parameters
+  //! are still written to the database directly.
+  //!
+  //! Staged reports survive the process that staged them, and are committed
+  //! by the next call to CommitStagedReports() from any process. Reports left
+  //! incomplete in \a path by a process that exited while writing them are
+  //! removed by this method, so \a path must not be used by another process
+  //! that is writing reports at the same time.
+  //!
+  //! This is only supported by the generic database implementation, used on
+  //! platforms other than Apple platforms and Windows.
+  //!
+  //! \param[in] path The staging directory, which is created if it doesn’t
+  //!     exist.
+  //!
+  //! \return `true` on success. `false` if staging isn’t supported, or \a path
+  //!     can’t be created, with a message logged.
+  virtual bool SetStagingDirectory(const base::FilePath& path) { return false; }
+
+  //! \brief Adds the reports staged in the directory given to
+  //!     SetStagingDirectory() to the database as pending reports.
+  //!
+  //! \param[out] uuids The UUIDs of the reports committed, which callers may
+  //!     now upload.
+  //!
+  //! \return `true` if every staged report was committed. `false` if any
+  //!     weren’t, with a message logged. Those remain staged, to be committed
+  //!     by a later call.
+  virtual bool CommitStagedReports(std::vector<UUID>* uuids) { return true; }
+
+  //! \brief Defers updates to the report index, so that many report state
+  //!     changes made in succession, such as while a backlog of reports is
+  //!     uploaded, are written to it at once.
+  //!
+  //! Without deferral, every change to a report’s state opens, locks, and
+  //! appends a record to the index. With deferral, records are held by this
+  //! object, and written to the index together when FlushIndexUpdates() is
+  //! called, many have accumulated, a minute has passed since the first was
+  //! deferred, or this object is destroyed.
+  //!
+  //! Reports themselves are changed immediately, and this object’s own
+  //! queries reflect the deferred records. Other processes don’t observe the
+  //! changes in the index until they are flushed. If this process exits
+  //! before then, the index is missing those changes until CleanDatabase()
+  //! finds that it doesn’t match the reports, and rebuilds it.
+  //!
+  //! This is intended for long-lived users that change many reports, such as
+  //! the handler. It is only supported by the generic database
+  //! implementation, used on platforms other than Apple platforms and
+  //! Windows, and has no effect elsewhere.
+  //!
+  //! This method must be called before this object is used by more than one
+  //! thread.
+  virtual void EnableDeferredIndexUpdates() {}
+
+  //! \brief Writes any updates deferred by EnableDeferredIndexUpdates() to
+  //!     the report index.
+  virtual void FlushIndexUpdates() {}
+
+  //! \brief Obtains the HTTP form parameters stored by
+  //!     NewReport::SetUploadParameters() for a report, without obtaining the
+  //!     report for uploading.
+  //!
+  //! Unlike GetReportForUploading(), this neither locks the report nor counts
+  //! as an upload attempt, so it may be used to decide whether to upload a
+  //! report at all.
+  //!
+  //! \param[in] uuid The unique identifier for the crash report record.
+  //! \param[out] parameters The stored parameters.
+  //! \return `true` on success with \a parameters set. `false` if no
+  //!     parameters were stored or they couldn't be read.
+  bool GetUploadParameters(const UUID& uuid,
+                           std::map<std::string, std::string>* parameters);
+
+  //! \brief Obtains the summary stored by NewReport::SetSummary() for a
+  //!     report.
+  //!
+  //! Like GetUploadParameters(), this neither locks the report nor reads its
+  //! minidump, so it is suitable for listing many reports.
+  //!
+  //! \param[in] uuid The unique identifier for the crash report record.
+  //! \param[out] summary The stored summary.
+  //! \return `true` on success with \a summary set. `false` if no summary was
+  //!     stored or it couldn't be read.
+  bool GetReportSummary(const UUID& uuid, ReportSummary* summary);
+
+  //! \brief Discards the HTTP body stored by NewReport::AddUploadBody() for
+  //!     a report, if any.
+  //!
+  //! This is intended to be called once the report has been uploaded, when
+  //! the body is no longer needed.
+  //!
+  //! \param[in] uuid The unique identifier for the crash report record.
+  void DiscardUploadBody(const UUID& uuid);
+
  protected:
-  CrashReportDatabase() {}
+  CrashReportDatabase() : compress_new_reports_(false) {}
 
   //! \brief The path to the database passed to Initialize.
   //!
@@ -458,6 +881,8 @@ class CrashReportDatabase {
   virtual OperationStatus RecordUploadAttempt(UploadReport* report,
                                               bool successful,
                                               const std::string& id) = 0;
+
+  bool compress_new_reports_;
 };
 
 }  // namespace crashpad
@@ -0,0 +1,378 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/crash_report_database.h"
+#include "client/prune_crash_reports.h"
+#include "test/scoped_temp_dir.h"
+#include "tools/tool_support.h"
+#include "util/misc/clock.h"
+#include "util/misc/uuid.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+namespace {
+
+// The operations that are measured, in the order that they’re run and
+// reported.
+enum class Operation {
+  kPrepareNewCrashReport,
+  kFinishedWritingCrashReport,
+  kGetPendingReports,
+  kGetReportForUploading,
+  kRecordUploadComplete,
+  kGetCompletedReports,
+  kPruneCrashReportDatabase,
+  kCount,
+};
+
+constexpr const char* kOperationNames[] = {
+    "prepare_new_crash_report",
+    "finished_writing_crash_report",
+    "get_pending_reports",
+    "get_report_for_uploading",
+    "record_upload_complete",
+    "get_completed_reports",
+    "prune_crash_report_database",
+};
+static_assert(std::size(kOperationNames) ==
+                  static_cast<size_t>(Operation::kCount),
+              "kOperationNames must name every Operation");
+
+// The contents of each report.
+struct ReportShape {
+  size_t report_size;
+  size_t attachments;
+  size_t attachment_size;
+};
+
+// The accumulated cost of the calls made to one operation.
+struct OperationTiming {
+  uint64_t calls = 0;
+  uint64_t total_ns = 0;
+};
+
+// Accumulates the time spent in each operation.
+class OperationTimer {
+ public:
+  OperationTimer() : timings_() {}
+
+  OperationTimer(const OperationTimer&) = delete;
+  OperationTimer& operator=(const OperationTimer&) = delete;
+
+  ~OperationTimer() {}
+
+  //! \brief Runs \a function, counting its duration towards \a operation, and
+  //!     returns its result.
+  template <typename Function>
+  auto Time(Operation operation, Function function) {
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    auto result = function();
+    OperationTiming& timing = timings_[static_cast<size_t>(operation)];
+    ++timing.calls;
+    timing.total_ns += ClockMonotonicNanoseconds() - start_ns;
+    return result;
+  }
+
+  void Print(size_t reports) const {
+    for (size_t index = 0; index < std::size(timings_); ++index) {
+      const OperationTiming& timing = timings_[index];
+      printf("%zu,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+             reports,
+             kOperationNames[index],
+             timing.calls,
+             timing.total_ns,
+             timing.calls ? timing.total_ns / timing.calls : 0);
+    }
+  }
+
+ private:
+  OperationTiming timings_[static_cast<size_t>(Operation::kCount)];
+};
+
+bool AddReports(CrashReportDatabase* database,
+                size_t reports,
+                const ReportShape& shape,
+                OperationTimer* timer) {
+  const std::string report_data(shape.report_size, 'r');
+  const std::string attachment_data(shape.attachment_size, 'a');
+  for (size_t index = 0; index < reports; ++index) {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    if (timer->Time(Operation::kPrepareNewCrashReport, [&]() {
+          return database->PrepareNewCrashReport(&new_report);
+        }) != CrashReportDatabase::kNoError) {
+      fprintf(stderr, "PrepareNewCrashReport failed\n");
+      return false;
+    }
+
+    if (!new_report->Writer()->Write(report_data.data(), report_data.size())) {
+      return false;
+    }
+    for (size_t attachment = 0; attachment < shape.attachments; ++attachment) {
+      FileWriter* writer = new_report->AddAttachment(
+          base::StringPrintf("attachment_%zu", attachment));
+      if (!writer ||
+          !writer->Write(attachment_data.data(), attachment_data.size())) {
+        fprintf(stderr, "AddAttachment failed\n");
+        return false;
+      }
+    }
+
+    UUID uuid;
+    if (timer->Time(Operation::kFinishedWritingCrashReport, [&]() {
+          return database->FinishedWritingCrashReport(std::move(new_report),
+                                                      &uuid);
+        }) != CrashReportDatabase::kNoError) {
+      fprintf(stderr, "FinishedWritingCrashReport failed\n");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UploadReports(CrashReportDatabase* database,
+                   size_t reports,
+                   OperationTimer* timer) {
+  std::vector<CrashReportDatabase::Report> pending_reports;
+  if (timer->Time(Operation::kGetPendingReports, [&]() {
+        return database->GetPendingReports(&pending_reports);
+      }) != CrashReportDatabase::kNoError) {
+    fprintf(stderr, "GetPendingReports failed\n");
+    return false;
+  }
+  if (pending_reports.size() != reports) {
+    fprintf(stderr,
+            "found %zu of %zu pending reports\n",
+            pending_reports.size(),
+            reports);
+    return false;
+  }
+
+  for (const CrashReportDatabase::Report& report : pending_reports) {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    if (timer->Time(Operation::kGetReportForUploading, [&]() {
+          return database->GetReportForUploading(report.uuid, &upload_report);
+        }) != CrashReportDatabase::kNoError) {
+      fprintf(stderr, "GetReportForUploading failed\n");
+      return false;
+    }
+
+    if (timer->Time(Operation::kRecordUploadComplete, [&]() {
+          return database->RecordUploadComplete(std::move(upload_report),
+                                                report.uuid.ToString());
+        }) != CrashReportDatabase::kNoError) {
+      fprintf(stderr, "RecordUploadComplete failed\n");
+      return false;
+    }
+  }
+
+  std::vector<CrashReportDatabase::Report> completed_reports;
+  if (timer->Time(Operation::kGetCompletedReports, [&]() {
+        return database->GetCompletedReports(&completed_reports);
+      }) != CrashReportDatabase::kNoError) {
+    fprintf(stderr, "GetCompletedReports failed\n");
+    return false;
+  }
+  if (completed_reports.size() != reports) {
+    fprintf(stderr,
+            "found %zu of %zu completed reports\n",
+            completed_reports.size(),
+            reports);
+    return false;
+  }
+
+  return true;
+}
+
+bool PruneReports(CrashReportDatabase* database,
+                  size_t reports,
+                  OperationTimer* timer) {
+  // A size limit of 0 prunes every report, so that each one is evaluated and
+  // deleted.
+  DatabaseSizePruneCondition condition(0);
+  const size_t pruned_reports =
+      timer->Time(Operation::kPruneCrashReportDatabase, [&]() {
+        return PruneCrashReportDatabase(database, &condition);
+      });
+  if (pruned_reports != reports) {
+    fprintf(stderr, "pruned %zu of %zu reports\n", pruned_reports, reports);
+    return false;
+  }
+  return true;
+}
+
+bool RunBenchmark(size_t reports, const ReportShape& shape) {
+  test::ScopedTempDir temp_dir;
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(temp_dir.path());
+  if (!database) {
+    return false;
+  }
+
+  OperationTimer timer;
+  if (!AddReports(database.get(), reports, shape, &timer) ||
+      !UploadReports(database.get(), reports, &timer) ||
+      !PruneReports(database.get(), reports, &timer)) {
+    return false;
+  }
+
+  timer.Print(reports);
+  fflush(stdout);
+  return true;
+}
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the cost of crash report database operations.\n"
+"\n"
+"      --attachment-size=BYTES  write attachments of BYTES bytes,\n"
+"                               default 1024\n"
+"      --attachments=COUNT      add COUNT attachments to each report,\n"
+"                               default 1\n"
+"      --report-size=BYTES      write reports of BYTES bytes, default 16384\n"
+"      --reports=COUNT          measure a database of COUNT reports, may be\n"
+"                               given more than once\n"
+"      --help                   display this help and exit\n"
+"      --version                output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+int CrashReportDatabaseBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionAttachmentSize,
+    kOptionAttachments,
+    kOptionReportSize,
+    kOptionReports,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  ReportShape shape;
+  shape.report_size = 16 * 1024;
+  shape.attachments = 1;
+  shape.attachment_size = 1024;
+  std::vector<size_t> report_counts;
+
+  static constexpr option long_options[] = {
+      {"attachment-size", required_argument, nullptr, kOptionAttachmentSize},
+      {"attachments", required_argument, nullptr, kOptionAttachments},
+      {"report-size", required_argument, nullptr, kOptionReportSize},
+      {"reports", required_argument, nullptr, kOptionReports},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionAttachmentSize:
+        if (!StringToNumber(optarg, &shape.attachment_size)) {
+          ToolSupport::UsageHint(me, "--attachment-size requires BYTES");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionAttachments:
+        if (!StringToNumber(optarg, &shape.attachments)) {
+          ToolSupport::UsageHint(me, "--attachments requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionReportSize:
+        if (!StringToNumber(optarg, &shape.report_size)) {
+          ToolSupport::UsageHint(me, "--report-size requires BYTES");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionReports: {
+        size_t reports;
+        if (!StringToNumber(optarg, &reports) || reports == 0) {
+          ToolSupport::UsageHint(me, "--reports requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        report_counts.push_back(reports);
+        break;
+      }
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      case kOptionVersion:
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      default:
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  if (report_counts.empty()) {
+    report_counts = {10, 1000, 100000};
+  }
+
+  printf("reports,operation,calls,total_ns,mean_ns\n");
+  for (size_t reports : report_counts) {
+    if (!RunBenchmark(reports, shape)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::CrashReportDatabaseBenchmarkMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(
+      argc, argv, crashpad::CrashReportDatabaseBenchmarkMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
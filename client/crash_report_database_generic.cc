@@ -15,21 +15,29 @@
 #include "client/crash_report_database.h"
 
 #include <stdint.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <mutex>
+#include <set>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "build/build_config.h"
 #include "client/settings.h"
 #include "util/file/directory_reader.h"
 #include "util/file/filesystem.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/memory_sanitizer.h"
+#include "util/misc/trace_event.h"
 
 namespace crashpad {
 
@@ -51,6 +59,9 @@ using OperationStatus = CrashReportDatabase::OperationStatus;
 
 constexpr base::FilePath::CharType kSettings[] =
     FILE_PATH_LITERAL("settings.dat");
+constexpr base::FilePath::CharType kIndex[] = FILE_PATH_LITERAL("index.dat");
+constexpr base::FilePath::CharType kShardedLayoutMarker[] =
+    FILE_PATH_LITERAL("sharded");
 
 constexpr base::FilePath::CharType kCrashReportExtension[] =
     FILE_PATH_LITERAL(".dmp");
@@ -59,6 +70,25 @@ constexpr base::FilePath::CharType kMetadataExtension[] =
 constexpr base::FilePath::CharType kLockExtension[] =
     FILE_PATH_LITERAL(".lock");
 
+// Report files created in advance by FillReportFilePool() are kept in the new
+// directory with this extension until they are claimed.
+constexpr base::FilePath::CharType kPooledReportExtension[] =
+    FILE_PATH_LITERAL(".pool");
+
+// Reports finished in the staging directory are renamed to this extension
+// until they are committed to the database.
+constexpr base::FilePath::CharType kStagedReportExtension[] =
+    FILE_PATH_LITERAL(".staged");
+
+// Limits on the report index records held by EnableDeferredIndexUpdates()
+// before they’re written.
+constexpr size_t kMaxDeferredIndexRecords = 256;
+constexpr time_t kMaxIndexDeferralSeconds = 60;
+
+// The report index is compacted once it holds more than twice as many records
+// as reports, and at least this many records.
+constexpr size_t kMinIndexRecordsToCompact = 64;
+
 constexpr base::FilePath::CharType kNewDirectory[] = FILE_PATH_LITERAL("new");
 constexpr base::FilePath::CharType kPendingDirectory[] =
     FILE_PATH_LITERAL("pending");
@@ -71,6 +101,23 @@ constexpr const base::FilePath::CharType* kReportDirectories[] = {
     kCompletedDirectory,
 };
 
+// In the sharded layout, pending and completed reports are stored in a
+// subdirectory of their state’s directory, named for the first kShardNameLength
+// characters of the report’s UUID.
+constexpr size_t kShardNameLength = 2;
+
+bool IsShardName(const base::FilePath::StringType& name) {
+  if (name.size() != kShardNameLength) {
+    return false;
+  }
+  for (const auto c : name) {
+    if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 enum {
   //! \brief Corresponds to uploaded bit of the report state.
   kAttributeUploaded = 1 << 0,
@@ -89,6 +136,40 @@ struct ReportMetadata {
   uint8_t attributes = 0;
 };
 
+// The report index begins with this header, which is followed by any number of
+// IndexRecords.
+struct IndexHeader {
+  static constexpr uint32_t kMagic = 'CPix';
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+};
+
+// A report’s state and metadata as recorded in the report index. Each record is
+// immediately followed by id_size bytes of the report’s id. Records are
+// appended, so a report’s most recent record supersedes any earlier ones, until
+// the index is compacted.
+struct IndexRecord {
+  static constexpr uint32_t kMarker = 'CPir';
+
+  uint32_t marker = kMarker;
+  int32_t state = 0;
+  UUID uuid = {};
+  int32_t upload_attempts = 0;
+  uint32_t id_size = 0;
+  int64_t last_upload_attempt_time = 0;
+  int64_t creation_time = 0;
+  uint64_t total_size = 0;
+  uint8_t attributes = 0;
+  uint8_t padding[7] = {};
+};
+
+// The size that the report index must exceed before appending records to it
+// checks whether it should be compacted.
+constexpr FileOffset kMinIndexSizeToCompact =
+    kMinIndexRecordsToCompact * sizeof(IndexRecord);
+
 // A lock held while using database resources.
 class ScopedLockFile {
  public:
@@ -179,6 +260,7 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus LookUpCrashReport(const UUID& uuid, Report* report) override;
   OperationStatus GetPendingReports(std::vector<Report>* reports) override;
   OperationStatus GetCompletedReports(std::vector<Report>* reports) override;
+  OperationStatus GetTotalSize(uint64_t* total_size) override;
   OperationStatus GetReportForUploading(
       const UUID& uuid,
       std::unique_ptr<const UploadReport>* report,
@@ -188,6 +270,12 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   OperationStatus DeleteReport(const UUID& uuid) override;
   OperationStatus RequestUpload(const UUID& uuid) override;
   int CleanDatabase(time_t lockfile_ttl) override;
+  bool EnableShardedLayout() override;
+  size_t FillReportFilePool(size_t count, FileOffset preallocate_size) override;
+  bool SetStagingDirectory(const base::FilePath& path) override;
+  bool CommitStagedReports(std::vector<UUID>* uuids) override;
+  void EnableDeferredIndexUpdates() override;
+  void FlushIndexUpdates() override;
   base::FilePath DatabasePath() override;
 
  private:
@@ -209,16 +297,58 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
 
     // Specifies either kPending or kCompleted.
     kSearchable,
+
+    // Removed from the database. This only appears in the report index.
+    kRemoved,
+  };
+
+  // A report file created by FillReportFilePool(). handle keeps the file
+  // locked, marking it as in use, until it is claimed.
+  struct PooledReportFile {
+    UUID uuid;
+    ScopedFileHandle handle;
+  };
+
+  // A report and its state, as recorded in the report index.
+  struct IndexedReport {
+    ReportState state;
+    Report report;
   };
+  using IndexedReports = std::map<UUID, IndexedReport>;
 
   // CrashReportDatabase:
   OperationStatus RecordUploadAttempt(UploadReport* report,
                                       bool successful,
                                       const std::string& id) override;
 
-  // Builds a filepath for the report with the specified uuid and state.
+  // Builds a filepath for the report with the specified uuid and state, in the
+  // database’s current layout.
   base::FilePath ReportPath(const UUID& uuid, ReportState state);
 
+  // Builds a filepath for the report with the specified uuid and state, in the
+  // sharded layout if sharded is true and in the flat layout otherwise. kNew
+  // reports are never sharded.
+  base::FilePath ReportPathInLayout(const UUID& uuid,
+                                    ReportState state,
+                                    bool sharded);
+
+  // Returns ReportPath() for uuid and state in path, creating the report’s
+  // shard directory if necessary. Returns false if the directory can’t be
+  // created.
+  bool ReportPathForWriting(const UUID& uuid,
+                            ReportState state,
+                            base::FilePath* path);
+
+  // Returns the paths of all files in the directory for state in paths,
+  // including any in shard subdirectories. Returns false if the directory
+  // can’t be read.
+  bool ListReportFiles(ReportState state, std::vector<base::FilePath>* paths);
+
+  // Moves any pending and completed reports in the flat layout into the
+  // sharded layout, skipping reports that are in use. Returns the number of
+  // reports moved.
+  int MigrateToShardedLayout();
+
   // Locates the report with id uuid and returns its file path in path and a
   // lock for the report in lock_file. This method succeeds as long as the
   // report file exists and the lock can be acquired. No validation is done on
@@ -237,24 +367,123 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
                                  ScopedLockFile* lock_file,
                                  Report* report);
 
-  // Reads metadata for all reports in state and returns it in reports.
+  // Reads metadata for all reports in state and returns it in reports. The
+  // report index is used if possible, falling back to
+  // ReportsInStateFromDirectory().
   OperationStatus ReportsInState(ReportState state,
                                  std::vector<Report>* reports);
 
+  // Reads metadata for all reports in state from each report’s metadata file.
+  OperationStatus ReportsInStateFromDirectory(ReportState state,
+                                              std::vector<Report>* reports);
+
+  // The report index records the state and metadata of every pending and
+  // completed report in a single file, so that reports can be listed without
+  // opening each report’s metadata file. Every method that changes a report’s
+  // state or metadata appends a record to the index after changing the report
+  // itself, while still holding the report’s lock. An index that is missing or
+  // corrupt is rebuilt from the report directories when next read, and an
+  // index that disagrees with the report directories is rebuilt by
+  // CleanDatabase(). So that it doesn’t grow with every change, the index is
+  // rewritten to hold only each report’s most recent record once superseded
+  // records make up most of it, and whenever the database is cleaned. The
+  // index is only used where file locking is available, as it can’t otherwise
+  // be kept coherent between processes.
+
+  // Reads the report index into reports, rebuilding it if necessary. Returns
+  // false if the index can’t be used.
+  bool LoadIndex(IndexedReports* reports);
+
+  // Rebuilds the report index from the report directories, and returns its
+  // new contents in reports. Returns false if the index can’t be used.
+  bool RebuildIndex(IndexedReports* reports);
+
+  // Parses the contents of the report index into reports. If record_count is
+  // not nullptr, it is set to the number of records parsed.
+  bool ParseIndex(const std::string& contents,
+                  IndexedReports* reports,
+                  size_t* record_count);
+
+  // Returns true if an index holding record_count records for report_count
+  // reports should be compacted.
+  static bool IndexNeedsCompaction(size_t record_count, size_t report_count);
+
+  // Compacts the report index if IndexNeedsCompaction(), or if force is true
+  // and the index holds any superseded records.
+  void CompactIndex(bool force);
+
+  // Compacts the report index open at handle, as CompactIndex() does. handle
+  // must be locked exclusively. Returns false if the index couldn’t be read
+  // or rewritten, in which case it should be removed.
+  bool CompactIndexLocked(FileHandle handle, bool force);
+
+  // Returns true if the set of reports in the report directories matches the
+  // set of reports in reports.
+  bool IndexMatchesDirectories(const IndexedReports& reports);
+
+  // Appends a record for report in state to the report index, or defers it if
+  // EnableDeferredIndexUpdates() has been called. state may be kRemoved, in
+  // which case only report.uuid is significant. If the index can’t be updated,
+  // it is removed, to be rebuilt when next read.
+  void AppendToIndex(const Report& report, ReportState state);
+
+  // Appends serialized records to the report index, removing it if they can’t
+  // be appended.
+  void AppendRecordsToIndex(const std::string& records);
+
+  // Appends the deferred index records to the index. index_lock_ must be held.
+  void FlushIndexUpdatesLocked();
+
+  // Appends a record to the report index noting that the report with the
+  // specified uuid has been removed.
+  void RemoveFromIndex(const UUID& uuid);
+
+  // Returns an IndexRecord for report in state, followed by the report’s id.
+  static std::string SerializeIndexRecord(const Report& report,
+                                          ReportState state);
+
+  base::FilePath IndexPath() const { return base_dir_.Append(kIndex); }
+
   // Cleans lone metadata, reports, or expired locks in a particular state.
   int CleanReportsInState(ReportState state, time_t lockfile_ttl);
 
   // Cleans any attachments that have no associated report in any state.
   void CleanOrphanedAttachments();
 
+  // Returns the path of the pooled report file for uuid.
+  base::FilePath PooledReportPath(const UUID& uuid);
+
+  // Creates and locks a report file for the pool, reserving preallocate_size
+  // bytes of storage for it.
+  bool CreatePooledReportFile(FileOffset preallocate_size,
+                              PooledReportFile* file);
+
+  // Takes a file from the pool and returns it as a new report in report.
+  // Returns false if the pool is empty or the file can’t be claimed.
+  bool ClaimPooledReportFile(std::unique_ptr<NewReport>* report);
+
+  // Removes pooled report files that aren’t locked, which were left behind by
+  // a process that exited without claiming them. Returns the number removed.
+  int ReclaimReportFilePool();
+
+  // Completes a report written in the staging directory, leaving it there to
+  // be committed by CommitStagedReports().
+  OperationStatus StageReport(std::unique_ptr<NewReport> report, UUID* uuid);
+
+  // Adds the report staged at staged_path to the database as a pending report
+  // and removes it from the staging directory.
+  bool CommitStagedReport(const base::FilePath& staged_path, const UUID& uuid);
+
   // Reads the metadata for a report from path and returns it in report.
   bool ReadMetadata(const base::FilePath& path, Report* report);
 
   // Wraps ReadMetadata and removes the report from the database on failure.
   bool CleaningReadMetadata(const base::FilePath& path, Report* report);
 
-  // Writes metadata for a new report to the filesystem at path.
-  static bool WriteNewMetadata(const base::FilePath& path);
+  // Writes metadata for a new report created at creation_time to the
+  // filesystem at path.
+  static bool WriteNewMetadata(const base::FilePath& path,
+                               time_t creation_time);
 
   // Writes the metadata for report to the filesystem at path.
   static bool WriteMetadata(const base::FilePath& path, const Report& report);
@@ -269,15 +498,40 @@ class CrashReportDatabaseGeneric : public CrashReportDatabase {
   base::FilePath base_dir_;
   Settings settings_;
   std::once_flag settings_init_;
+  std::vector<PooledReportFile> report_file_pool_;  // guarded by pool_lock_
+  std::mutex pool_lock_;
+  base::FilePath staging_dir_;  // empty if reports aren’t staged
+
+  // The index records deferred by EnableDeferredIndexUpdates(), guarded by
+  // index_lock_. deferred_index_records_ holds deferred_index_record_count_
+  // serialized records, the first of which was deferred at
+  // deferred_index_since_.
+  std::mutex index_lock_;
+  std::string deferred_index_records_;
+  size_t deferred_index_record_count_ = 0;
+  time_t deferred_index_since_ = 0;
+  bool defer_index_updates_ = false;
+
+  // The size that the report index may grow to through appended records before
+  // it is checked for compaction.
+  std::atomic<FileOffset> index_compaction_size_{0};
+
+  bool sharded_ = false;
   InitializationStateDcheck initialized_;
 };
 
 CrashReportDatabaseGeneric::CrashReportDatabaseGeneric() = default;
 
-CrashReportDatabaseGeneric::~CrashReportDatabaseGeneric() = default;
+CrashReportDatabaseGeneric::~CrashReportDatabaseGeneric() {
+  FlushIndexUpdates();
+  for (const PooledReportFile& file : report_file_pool_) {
+    LoggingRemoveFile(PooledReportPath(file.uuid));
+  }
+}
 
 bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
                                             bool may_create) {
+  CRASHPAD_TRACE_EVENT("database", "CrashReportDatabaseGeneric::Initialize");
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   base_dir_ = path;
 
@@ -299,6 +553,10 @@ bool CrashReportDatabaseGeneric::Initialize(const base::FilePath& path,
     return false;
   }
 
+  sharded_ = IsRegularFile(base_dir_.Append(kShardedLayoutMarker));
+
+  ReclaimReportFilePool();
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -328,11 +586,21 @@ Settings* CrashReportDatabaseGeneric::GetSettings() {
 
 OperationStatus CrashReportDatabaseGeneric::PrepareNewCrashReport(
     std::unique_ptr<NewReport>* report) {
+  CRASHPAD_TRACE_EVENT("database",
+                       "CrashReportDatabaseGeneric::PrepareNewCrashReport");
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  // Pooled report files are in the database, not the staging directory.
+  if (staging_dir_.empty() && ClaimPooledReportFile(report)) {
+    return kNoError;
+  }
+
   auto new_report = std::make_unique<NewReport>();
-  if (!new_report->Initialize(
-          this, base_dir_.Append(kNewDirectory), kCrashReportExtension)) {
+  if (!new_report->Initialize(this,
+                              staging_dir_.empty()
+                                  ? base_dir_.Append(kNewDirectory)
+                                  : staging_dir_,
+                              kCrashReportExtension)) {
     return kFileSystemError;
   }
 
@@ -343,15 +611,30 @@ OperationStatus CrashReportDatabaseGeneric::PrepareNewCrashReport(
 OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
     std::unique_ptr<NewReport> report,
     UUID* uuid) {
+  CRASHPAD_TRACE_EVENT(
+      "database", "CrashReportDatabaseGeneric::FinishedWritingCrashReport");
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  base::FilePath path = ReportPath(report->ReportID(), kPending);
+  if (!report->FinishCompression()) {
+    return kFileSystemError;
+  }
+
+  if (!staging_dir_.empty()) {
+    return StageReport(std::move(report), uuid);
+  }
+
+  base::FilePath path;
+  if (!ReportPathForWriting(report->ReportID(), kPending, &path)) {
+    return kFileSystemError;
+  }
   ScopedLockFile lock_file;
   if (!lock_file.ResetAcquire(path)) {
     return kBusyError;
   }
 
-  if (!WriteNewMetadata(ReplaceFinalExtension(path, kMetadataExtension))) {
+  const time_t creation_time = time(nullptr);
+  if (!WriteNewMetadata(ReplaceFinalExtension(path, kMetadataExtension),
+                        creation_time)) {
     return kDatabaseError;
   }
 
@@ -374,6 +657,13 @@ OperationStatus CrashReportDatabaseGeneric::FinishedWritingCrashReport(
 
   *uuid = report->ReportID();
 
+  Report indexed_report;
+  indexed_report.uuid = *uuid;
+  indexed_report.creation_time = creation_time;
+  indexed_report.total_size =
+      static_cast<uint64_t>(size) + GetDirectorySize(AttachmentsPath(*uuid));
+  AppendToIndex(indexed_report, kPending);
+
   Metrics::CrashReportPending(Metrics::PendingReportReason::kNewlyCreated);
   Metrics::CrashReportSize(size);
 
@@ -391,6 +681,8 @@ OperationStatus CrashReportDatabaseGeneric::LookUpCrashReport(const UUID& uuid,
 
 OperationStatus CrashReportDatabaseGeneric::GetPendingReports(
     std::vector<Report>* reports) {
+  CRASHPAD_TRACE_EVENT("database",
+                       "CrashReportDatabaseGeneric::GetPendingReports");
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return ReportsInState(kPending, reports);
 }
@@ -401,10 +693,35 @@ OperationStatus CrashReportDatabaseGeneric::GetCompletedReports(
   return ReportsInState(kCompleted, reports);
 }
 
+OperationStatus CrashReportDatabaseGeneric::GetTotalSize(
+    uint64_t* total_size) {
+  CRASHPAD_TRACE_EVENT("database", "CrashReportDatabaseGeneric::GetTotalSize");
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // The index records each report’s size as of FinishedWritingCrashReport(),
+  // so the total can be computed without examining the report files.
+  IndexedReports indexed_reports;
+  if (!LoadIndex(&indexed_reports)) {
+    return CrashReportDatabase::GetTotalSize(total_size);
+  }
+
+  uint64_t size = 0;
+  for (const auto& [uuid, indexed_report] : indexed_reports) {
+    if (indexed_report.state == kPending ||
+        indexed_report.state == kCompleted) {
+      size += indexed_report.report.total_size;
+    }
+  }
+  *total_size = size;
+  return kNoError;
+}
+
 OperationStatus CrashReportDatabaseGeneric::GetReportForUploading(
     const UUID& uuid,
     std::unique_ptr<const UploadReport>* report,
     bool report_metrics) {
+  CRASHPAD_TRACE_EVENT("database",
+                       "CrashReportDatabaseGeneric::GetReportForUploading");
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   auto upload_report = std::make_unique<LockfileUploadReport>();
@@ -441,7 +758,10 @@ OperationStatus CrashReportDatabaseGeneric::SkipReportUpload(
     return os;
   }
 
-  base::FilePath completed_path(ReportPath(uuid, kCompleted));
+  base::FilePath completed_path;
+  if (!ReportPathForWriting(uuid, kCompleted, &completed_path)) {
+    return kFileSystemError;
+  }
   ScopedLockFile completed_lock_file;
   if (!completed_lock_file.ResetAcquire(completed_path)) {
     return kBusyError;
@@ -460,6 +780,8 @@ OperationStatus CrashReportDatabaseGeneric::SkipReportUpload(
     return kDatabaseError;
   }
 
+  AppendToIndex(report, kCompleted);
+
   return kNoError;
 }
 
@@ -478,6 +800,8 @@ OperationStatus CrashReportDatabaseGeneric::DeleteReport(const UUID& uuid) {
     return kFileSystemError;
   }
 
+  RemoveFromIndex(uuid);
+
   if (!LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension))) {
     return kDatabaseError;
   }
@@ -504,7 +828,10 @@ OperationStatus CrashReportDatabaseGeneric::RequestUpload(const UUID& uuid) {
   }
 
   report.upload_explicitly_requested = true;
-  base::FilePath pending_path = ReportPath(uuid, kPending);
+  base::FilePath pending_path;
+  if (!ReportPathForWriting(uuid, kPending, &pending_path)) {
+    return kFileSystemError;
+  }
   if (!MoveFileOrDirectory(path, pending_path)) {
     return kFileSystemError;
   }
@@ -519,11 +846,14 @@ OperationStatus CrashReportDatabaseGeneric::RequestUpload(const UUID& uuid) {
     }
   }
 
+  AppendToIndex(report, kPending);
+
   Metrics::CrashReportPending(Metrics::PendingReportReason::kUserInitiated);
   return kNoError;
 }
 
 int CrashReportDatabaseGeneric::CleanDatabase(time_t lockfile_ttl) {
+  CRASHPAD_TRACE_EVENT("database", "CrashReportDatabaseGeneric::CleanDatabase");
   int removed = 0;
   time_t now = time(nullptr);
 
@@ -534,6 +864,12 @@ int CrashReportDatabaseGeneric::CleanDatabase(time_t lockfile_ttl) {
     DirectoryReader::Result result;
     while ((result = reader.NextFile(&filename)) ==
            DirectoryReader::Result::kSuccess) {
+      // Pooled report files are in use for as long as they’re locked, however
+      // old they are, and are handled by ReclaimReportFilePool().
+      if (filename.FinalExtension() == kPooledReportExtension) {
+        continue;
+      }
+
       const base::FilePath filepath(new_dir.Append(filename));
       timespec filetime;
       if (!FileModificationTime(filepath, &filetime)) {
@@ -547,9 +883,28 @@ int CrashReportDatabaseGeneric::CleanDatabase(time_t lockfile_ttl) {
     }
   }
 
+  removed += ReclaimReportFilePool();
+
+  if (sharded_) {
+    MigrateToShardedLayout();
+  }
+
   removed += CleanReportsInState(kPending, lockfile_ttl);
   removed += CleanReportsInState(kCompleted, lockfile_ttl);
   CleanOrphanedAttachments();
+
+  // Reports may have been added, moved, or removed without the index being
+  // updated if a process was interrupted between changing a report and
+  // updating the index. Catch this by comparing the index to the report
+  // directories, which is far cheaper than reading every report’s metadata.
+  IndexedReports indexed_reports;
+  if (LoadIndex(&indexed_reports)) {
+    if (!IndexMatchesDirectories(indexed_reports)) {
+      RebuildIndex(&indexed_reports);
+    } else {
+      CompactIndex(true);
+    }
+  }
 #if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
   base::FilePath settings_path(kSettings);
   if (Settings::IsLockExpired(settings_path, lockfile_ttl)) {
@@ -567,6 +922,8 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
     UploadReport* report,
     bool successful,
     const std::string& id) {
+  CRASHPAD_TRACE_EVENT("database",
+                       "CrashReportDatabaseGeneric::RecordUploadAttempt");
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   if (report->report_metrics_) {
@@ -585,7 +942,11 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
   if (successful) {
     report->upload_explicitly_requested = false;
 
-    base::FilePath completed_report_path = ReportPath(report->uuid, kCompleted);
+    base::FilePath completed_report_path;
+    if (!ReportPathForWriting(
+            report->uuid, kCompleted, &completed_report_path)) {
+      return kFileSystemError;
+    }
 
     if (!lock_file.ResetAcquire(completed_report_path)) {
       return kBusyError;
@@ -604,6 +965,8 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
     return kDatabaseError;
   }
 
+  AppendToIndex(*report, successful ? kCompleted : kPending);
+
   if (!SettingsInternal().SetLastUploadAttemptTime(now)) {
     return kDatabaseError;
   }
@@ -611,8 +974,331 @@ OperationStatus CrashReportDatabaseGeneric::RecordUploadAttempt(
   return kNoError;
 }
 
+bool CrashReportDatabaseGeneric::EnableShardedLayout() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // The marker is written first, so that other processes opening the database
+  // place new reports in the sharded layout while existing ones are moved.
+  if (!sharded_) {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(base_dir_.Append(kShardedLayoutMarker),
+                                FileWriteMode::kReuseOrCreate,
+                                FilePermissions::kOwnerOnly));
+    if (!handle.is_valid()) {
+      return false;
+    }
+    sharded_ = true;
+  }
+
+  MigrateToShardedLayout();
+  return true;
+}
+
+size_t CrashReportDatabaseGeneric::FillReportFilePool(
+    size_t count,
+    FileOffset preallocate_size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  size_t needed;
+  {
+    std::lock_guard<std::mutex> lock(pool_lock_);
+    needed = count > report_file_pool_.size()
+                 ? count - report_file_pool_.size()
+                 : 0;
+  }
+
+  // Files are created without holding the lock, so that a crash being
+  // handled on another thread can claim one in the meantime.
+  for (; needed > 0; --needed) {
+    PooledReportFile file;
+    if (!CreatePooledReportFile(preallocate_size, &file)) {
+      break;
+    }
+    std::lock_guard<std::mutex> lock(pool_lock_);
+    report_file_pool_.push_back(std::move(file));
+  }
+
+  std::lock_guard<std::mutex> lock(pool_lock_);
+  return report_file_pool_.size();
+}
+
+base::FilePath CrashReportDatabaseGeneric::PooledReportPath(const UUID& uuid) {
+  return base_dir_.Append(kNewDirectory)
+      .Append(uuid.ToString() + kPooledReportExtension);
+}
+
+bool CrashReportDatabaseGeneric::CreatePooledReportFile(
+    FileOffset preallocate_size,
+    PooledReportFile* file) {
+#if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  // Without locking, pooled files in use can’t be told apart from those left
+  // behind.
+  return false;
+#else
+  if (!file->uuid.InitializeWithNew()) {
+    return false;
+  }
+
+  const base::FilePath path = PooledReportPath(file->uuid);
+  file->handle.reset(LoggingOpenFileForWrite(
+      path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  if (!file->handle.is_valid()) {
+    return false;
+  }
+  ScopedRemoveFile file_remover(path);
+
+  // The lock marks the file as in use. ReclaimReportFilePool() in another
+  // process may have removed the file between its creation and locking, in
+  // which case it can’t be used.
+  if (LoggingLockFile(file->handle.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kNonBlocking) !=
+          FileLockingResult::kSuccess ||
+      !IsRegularFile(path)) {
+    return false;
+  }
+
+  // Storage that can’t be reserved will be allocated as the report is
+  // written, as it would have been without the pool.
+  if (preallocate_size > 0) {
+    LoggingPreallocateFile(file->handle.get(), 0, preallocate_size);
+  }
+
+  std::ignore = file_remover.release();
+  return true;
+#endif  // !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+bool CrashReportDatabaseGeneric::ClaimPooledReportFile(
+    std::unique_ptr<NewReport>* report) {
+  PooledReportFile file;
+  {
+    std::lock_guard<std::mutex> lock(pool_lock_);
+    if (report_file_pool_.empty()) {
+      return false;
+    }
+    file = std::move(report_file_pool_.back());
+    report_file_pool_.pop_back();
+  }
+
+  // The file is renamed while still locked, so that it’s never seen unlocked
+  // with the pooled extension.
+  const base::FilePath pooled_path = PooledReportPath(file.uuid);
+  const base::FilePath path = base_dir_.Append(kNewDirectory)
+                                  .Append(file.uuid.ToString() +
+                                          kCrashReportExtension);
+  if (!MoveFileOrDirectory(pooled_path, path)) {
+    LoggingRemoveFile(pooled_path);
+    return false;
+  }
+
+  auto new_report = std::make_unique<NewReport>();
+  if (!new_report->InitializeWithFile(this, file.uuid, path)) {
+    return false;
+  }
+
+  report->reset(new_report.release());
+  return true;
+}
+
+int CrashReportDatabaseGeneric::ReclaimReportFilePool() {
+#if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  return 0;
+#else
+  DirectoryReader reader;
+  if (!reader.Open(base_dir_.Append(kNewDirectory))) {
+    return 0;
+  }
+
+  int removed = 0;
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    if (filename.FinalExtension() != kPooledReportExtension) {
+      continue;
+    }
+
+    // A file that can be locked isn’t held by any process. Files held by this
+    // process can’t be locked through a new descriptor either.
+    const base::FilePath filepath(base_dir_.Append(kNewDirectory)
+                                      .Append(filename));
+    ScopedFileHandle handle(OpenFileForWrite(
+        filepath, FileWriteMode::kReuseOrFail, FilePermissions::kOwnerOnly));
+    if (handle.is_valid() &&
+        LoggingLockFile(handle.get(),
+                        FileLocking::kExclusive,
+                        FileLockingBlocking::kNonBlocking) ==
+            FileLockingResult::kSuccess &&
+        LoggingRemoveFile(filepath)) {
+      ++removed;
+    }
+  }
+  return removed;
+#endif  // !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+bool CrashReportDatabaseGeneric::SetStagingDirectory(
+    const base::FilePath& path) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (!LoggingCreateDirectory(path, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+
+  // Reports that were still being written when their process exited can’t be
+  // completed.
+  DirectoryReader reader;
+  if (!reader.Open(path)) {
+    return false;
+  }
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    if (filename.FinalExtension() == kCrashReportExtension) {
+      LoggingRemoveFile(path.Append(filename));
+    }
+  }
+
+  staging_dir_ = path;
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::CommitStagedReports(std::vector<UUID>* uuids) {
+  CRASHPAD_TRACE_EVENT("database",
+                       "CrashReportDatabaseGeneric::CommitStagedReports");
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (staging_dir_.empty()) {
+    return true;
+  }
+
+  DirectoryReader reader;
+  if (!reader.Open(staging_dir_)) {
+    return false;
+  }
+
+  bool committed_all = true;
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    if (filename.FinalExtension() != kStagedReportExtension) {
+      continue;
+    }
+
+    const base::FilePath staged_path(staging_dir_.Append(filename));
+    const UUID uuid = UUIDFromReportPath(staged_path);
+    if (uuid == UUID()) {
+      LOG(ERROR) << "unexpected staged report " << staged_path.value();
+      continue;
+    }
+
+    if (CommitStagedReport(staged_path, uuid)) {
+      uuids->push_back(uuid);
+    } else {
+      committed_all = false;
+    }
+  }
+  return committed_all && result == DirectoryReader::Result::kNoMoreFiles;
+}
+
+OperationStatus CrashReportDatabaseGeneric::StageReport(
+    std::unique_ptr<NewReport> report,
+    UUID* uuid) {
+  // The rename marks the report as complete, so that it’s committed even if
+  // this process exits first.
+  report->Writer()->Close();
+  if (!MoveFileOrDirectory(report->file_remover_.get(),
+                           ReplaceFinalExtension(report->file_remover_.get(),
+                                                 kStagedReportExtension))) {
+    return kFileSystemError;
+  }
+  std::ignore = report->file_remover_.release();
+
+  for (auto& writer : report->attachment_writers_) {
+    writer->Close();
+  }
+  for (auto& remover : report->attachment_removers_) {
+    std::ignore = remover.release();
+  }
+
+  *uuid = report->ReportID();
+  return kNoError;
+}
+
+bool CrashReportDatabaseGeneric::CommitStagedReport(
+    const base::FilePath& staged_path,
+    const UUID& uuid) {
+  base::FilePath path;
+  if (!ReportPathForWriting(uuid, kPending, &path)) {
+    return false;
+  }
+  ScopedLockFile lock_file;
+  if (!lock_file.ResetAcquire(path)) {
+    return false;
+  }
+
+  // A previous commit may have been interrupted after adding the report to
+  // the database, in which case only the staged copy remains to be removed.
+  // CleanDatabase() adds any such report missing from the index.
+  if (!IsRegularFile(path)) {
+    timespec staged_time;
+    const time_t creation_time = FileModificationTime(staged_path, &staged_time)
+                                     ? staged_time.tv_sec
+                                     : time(nullptr);
+
+    // The report is copied into the new directory first, so that a copy that
+    // is interrupted is never seen as a pending report.
+    const base::FilePath new_path =
+        base_dir_.Append(kNewDirectory)
+            .Append(uuid.ToString() + kCrashReportExtension);
+    const base::FilePath metadata_path =
+        ReplaceFinalExtension(path, kMetadataExtension);
+    if (IsRegularFile(new_path)) {
+      LoggingRemoveFile(new_path);
+    }
+    if (IsRegularFile(metadata_path)) {
+      LoggingRemoveFile(metadata_path);
+    }
+    if (!CloneOrCopyFile(staged_path,
+                         new_path,
+                         FilePermissions::kOwnerOnly,
+                         /*allow_hard_link=*/false)) {
+      return false;
+    }
+    ScopedRemoveFile new_remover(new_path);
+
+    if (!WriteNewMetadata(metadata_path, creation_time) ||
+        !MoveFileOrDirectory(new_path, path)) {
+      return false;
+    }
+    std::ignore = new_remover.release();
+
+    const uint64_t size = GetFileSize(path);
+    Report indexed_report;
+    indexed_report.uuid = uuid;
+    indexed_report.creation_time = creation_time;
+    indexed_report.total_size = size + GetDirectorySize(AttachmentsPath(uuid));
+    AppendToIndex(indexed_report, kPending);
+
+    Metrics::CrashReportPending(Metrics::PendingReportReason::kNewlyCreated);
+    Metrics::CrashReportSize(static_cast<FileOffset>(size));
+  }
+
+  return LoggingRemoveFile(staged_path);
+}
+
 base::FilePath CrashReportDatabaseGeneric::ReportPath(const UUID& uuid,
                                                       ReportState state) {
+  return ReportPathInLayout(uuid, state, sharded_);
+}
+
+base::FilePath CrashReportDatabaseGeneric::ReportPathInLayout(
+    const UUID& uuid,
+    ReportState state,
+    bool sharded) {
   DCHECK_NE(state, kUninitialized);
   DCHECK_NE(state, kSearchable);
 
@@ -622,8 +1308,117 @@ base::FilePath CrashReportDatabaseGeneric::ReportPath(const UUID& uuid,
   const std::string uuid_string = uuid.ToString();
 #endif
 
-  return base_dir_.Append(kReportDirectories[state])
-      .Append(uuid_string + kCrashReportExtension);
+  base::FilePath dir_path = base_dir_.Append(kReportDirectories[state]);
+  if (sharded && state != kNew) {
+    dir_path = dir_path.Append(uuid_string.substr(0, kShardNameLength));
+  }
+  return dir_path.Append(uuid_string + kCrashReportExtension);
+}
+
+bool CrashReportDatabaseGeneric::ReportPathForWriting(const UUID& uuid,
+                                                      ReportState state,
+                                                      base::FilePath* path) {
+  *path = ReportPath(uuid, state);
+  if (!sharded_ || state == kNew) {
+    return true;
+  }
+  return LoggingCreateDirectory(
+      path->DirName(), FilePermissions::kOwnerOnly, true);
+}
+
+bool CrashReportDatabaseGeneric::ListReportFiles(
+    ReportState state,
+    std::vector<base::FilePath>* paths) {
+  std::vector<base::FilePath> dir_paths(
+      1, base_dir_.Append(kReportDirectories[state]));
+  for (size_t index = 0; index < dir_paths.size(); ++index) {
+    // Copy the path, as dir_paths may grow while it’s being read.
+    const base::FilePath dir_path(dir_paths[index]);
+    DirectoryReader reader;
+    if (!reader.Open(dir_path)) {
+      if (index == 0) {
+        return false;
+      }
+      continue;
+    }
+
+    base::FilePath filename;
+    DirectoryReader::FileType type;
+    DirectoryReader::Result result;
+    while ((result = reader.NextFile(&filename, &type)) ==
+           DirectoryReader::Result::kSuccess) {
+      const base::FilePath filepath(dir_path.Append(filename));
+      // Shards are only found at the top level. Only names that could be
+      // shards are checked, and IsDirectory() is only consulted when the
+      // reader couldn’t report the type, so report files cost nothing extra.
+      if (index == 0 && IsShardName(filename.value()) &&
+          (type == DirectoryReader::FileType::kDirectory ||
+           (type == DirectoryReader::FileType::kUnknown &&
+            IsDirectory(filepath, false)))) {
+        dir_paths.push_back(filepath);
+        continue;
+      }
+      paths->push_back(filepath);
+    }
+  }
+  return true;
+}
+
+int CrashReportDatabaseGeneric::MigrateToShardedLayout() {
+  DCHECK(sharded_);
+
+  int migrated = 0;
+  for (const ReportState state : {kPending, kCompleted}) {
+    const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
+    DirectoryReader reader;
+    if (!reader.Open(dir_path)) {
+      continue;
+    }
+
+    base::FilePath filename;
+    DirectoryReader::Result result;
+    while ((result = reader.NextFile(&filename)) ==
+           DirectoryReader::Result::kSuccess) {
+      UUID uuid;
+      if (filename.FinalExtension().compare(kCrashReportExtension) != 0 ||
+          !uuid.InitializeFromString(
+              filename.RemoveFinalExtension().value())) {
+        continue;
+      }
+
+      // Holding the locks for both paths ensures that no other process is
+      // using the report while its files are in transit.
+      const base::FilePath flat_path(dir_path.Append(filename));
+      ScopedLockFile flat_lock;
+      if (!flat_lock.ResetAcquire(flat_path)) {
+        continue;
+      }
+
+      base::FilePath sharded_path;
+      ScopedLockFile sharded_lock;
+      if (!ReportPathForWriting(uuid, state, &sharded_path) ||
+          !sharded_lock.ResetAcquire(sharded_path) ||
+          IsRegularFile(sharded_path)) {
+        continue;
+      }
+
+      // Reports without metadata are left for CleanReportsInState().
+      const base::FilePath flat_metadata_path(
+          ReplaceFinalExtension(flat_path, kMetadataExtension));
+      const base::FilePath sharded_metadata_path(
+          ReplaceFinalExtension(sharded_path, kMetadataExtension));
+      if (!IsRegularFile(flat_metadata_path) ||
+          !MoveFileOrDirectory(flat_metadata_path, sharded_metadata_path)) {
+        continue;
+      }
+      if (!MoveFileOrDirectory(flat_path, sharded_path)) {
+        MoveFileOrDirectory(sharded_metadata_path, flat_metadata_path);
+        continue;
+      }
+      ++migrated;
+    }
+  }
+  return migrated;
 }
 
 OperationStatus CrashReportDatabaseGeneric::LocateAndLockReport(
@@ -640,20 +1435,29 @@ OperationStatus CrashReportDatabaseGeneric::LocateAndLockReport(
     searchable_states.push_back(desired_state);
   }
 
+  // Reports may be found in either layout: the flat layout hasn’t necessarily
+  // been fully migrated after the sharded layout is enabled, and another
+  // process may have enabled it after this one last checked.
   for (const ReportState state : searchable_states) {
-    base::FilePath local_path(ReportPath(uuid, state));
-    ScopedLockFile local_lock;
-    if (!local_lock.ResetAcquire(local_path)) {
-      return kBusyError;
-    }
+    for (const bool sharded : {sharded_, !sharded_}) {
+      base::FilePath local_path(ReportPathInLayout(uuid, state, sharded));
+      if (sharded && !IsDirectory(local_path.DirName(), false)) {
+        continue;
+      }
 
-    if (!IsRegularFile(local_path)) {
-      continue;
-    }
+      ScopedLockFile local_lock;
+      if (!local_lock.ResetAcquire(local_path)) {
+        return kBusyError;
+      }
 
-    *path = local_path;
-    *lock_file = std::move(local_lock);
-    return kNoError;
+      if (!IsRegularFile(local_path)) {
+        continue;
+      }
+
+      *path = local_path;
+      *lock_file = std::move(local_lock);
+      return kNoError;
+    }
   }
 
   return kReportNotFound;
@@ -689,23 +1493,35 @@ OperationStatus CrashReportDatabaseGeneric::ReportsInState(
   DCHECK_NE(state, kUninitialized);
   DCHECK_NE(state, kSearchable);
   DCHECK_NE(state, kNew);
+  DCHECK_NE(state, kRemoved);
 
-  const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
-  DirectoryReader reader;
-  if (!reader.Open(dir_path)) {
+  IndexedReports indexed_reports;
+  if (!LoadIndex(&indexed_reports)) {
+    return ReportsInStateFromDirectory(state, reports);
+  }
+
+  for (const auto& [uuid, indexed_report] : indexed_reports) {
+    if (indexed_report.state == state) {
+      reports->push_back(indexed_report.report);
+    }
+  }
+  return kNoError;
+}
+
+OperationStatus CrashReportDatabaseGeneric::ReportsInStateFromDirectory(
+    ReportState state,
+    std::vector<Report>* reports) {
+  std::vector<base::FilePath> filepaths;
+  if (!ListReportFiles(state, &filepaths)) {
     return kDatabaseError;
   }
 
-  base::FilePath filename;
-  DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
-         DirectoryReader::Result::kSuccess) {
-    const base::FilePath::StringType extension(filename.FinalExtension());
+  for (const base::FilePath& filepath : filepaths) {
+    const base::FilePath::StringType extension(filepath.FinalExtension());
     if (extension.compare(kCrashReportExtension) != 0) {
       continue;
     }
 
-    const base::FilePath filepath(dir_path.Append(filename));
     ScopedLockFile lock_file;
     if (!lock_file.ResetAcquire(filepath)) {
       continue;
@@ -723,19 +1539,14 @@ OperationStatus CrashReportDatabaseGeneric::ReportsInState(
 
 int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
                                                     time_t lockfile_ttl) {
-  const base::FilePath dir_path(base_dir_.Append(kReportDirectories[state]));
-  DirectoryReader reader;
-  if (!reader.Open(dir_path)) {
+  std::vector<base::FilePath> filepaths;
+  if (!ListReportFiles(state, &filepaths)) {
     return 0;
   }
 
   int removed = 0;
-  base::FilePath filename;
-  DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
-         DirectoryReader::Result::kSuccess) {
-    const base::FilePath::StringType extension(filename.FinalExtension());
-    const base::FilePath filepath(dir_path.Append(filename));
+  for (const base::FilePath& filepath : filepaths) {
+    const base::FilePath::StringType extension(filepath.FinalExtension());
 
     // Remove any report files without metadata.
     if (extension.compare(kCrashReportExtension) == 0) {
@@ -745,6 +1556,7 @@ int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
       if (report_lock.ResetAcquire(filepath) && !IsRegularFile(metadata_path) &&
           LoggingRemoveFile(filepath)) {
         ++removed;
+        RemoveFromIndex(UUIDFromReportPath(filepath));
         RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
       }
       continue;
@@ -758,6 +1570,7 @@ int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
       if (report_lock.ResetAcquire(report_path) &&
           !IsRegularFile(report_path) && LoggingRemoveFile(filepath)) {
         ++removed;
+        RemoveFromIndex(UUIDFromReportPath(filepath));
         RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
       }
       continue;
@@ -776,6 +1589,7 @@ int CrashReportDatabaseGeneric::CleanReportsInState(ReportState state,
 
       if (LoggingRemoveFile(filepath)) {
         ++removed;
+        RemoveFromIndex(UUIDFromReportPath(filepath));
         RemoveAttachmentsByUUID(UUIDFromReportPath(filepath));
       }
       continue;
@@ -793,12 +1607,15 @@ void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
   }
 
   base::FilePath filename;
+  DirectoryReader::FileType type;
   DirectoryReader::Result result;
-  while ((result = reader.NextFile(&filename)) ==
+  while ((result = reader.NextFile(&filename, &type)) ==
          DirectoryReader::Result::kSuccess) {
     const base::FilePath report_attachment_dir(
         root_attachments_dir.Append(filename));
-    if (IsDirectory(report_attachment_dir, false)) {
+    if (type == DirectoryReader::FileType::kDirectory ||
+        (type == DirectoryReader::FileType::kUnknown &&
+         IsDirectory(report_attachment_dir, false))) {
       UUID uuid;
       if (!uuid.InitializeFromString(filename.value())) {
         LOG(ERROR) << "unexpected attachment dir name " << filename.value();
@@ -813,6 +1630,18 @@ void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
         continue;
       }
 
+      // Check to see if the report is being created or waiting to be
+      // committed in the staging directory.
+      if (!staging_dir_.empty()) {
+        const base::FilePath staged_path =
+            staging_dir_.Append(uuid.ToString() + kCrashReportExtension);
+        if (IsRegularFile(staged_path) ||
+            IsRegularFile(
+                ReplaceFinalExtension(staged_path, kStagedReportExtension))) {
+          continue;
+        }
+      }
+
       // Check to see if the report is in "pending" or "completed".
       ScopedLockFile local_lock;
       base::FilePath local_path;
@@ -828,6 +1657,394 @@ void CrashReportDatabaseGeneric::CleanOrphanedAttachments() {
   }
 }
 
+bool CrashReportDatabaseGeneric::LoadIndex(IndexedReports* reports) {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  reports->clear();
+
+  std::string contents;
+  ScopedFileHandle handle(OpenFileForRead(IndexPath()));
+  if (handle.is_valid()) {
+    if (LoggingLockFile(handle.get(),
+                        FileLocking::kShared,
+                        FileLockingBlocking::kBlocking) !=
+        FileLockingResult::kSuccess) {
+      return false;
+    }
+    const bool read = LoggingReadToEOF(handle.get(), &contents);
+    LoggingUnlockFile(handle.get());
+
+    // Deferred records follow those in the index, superseding them.
+    if (read && defer_index_updates_) {
+      std::lock_guard<std::mutex> lock(index_lock_);
+      contents.append(deferred_index_records_);
+    }
+
+    size_t record_count;
+    if (read && ParseIndex(contents, reports, &record_count)) {
+      if (IndexNeedsCompaction(record_count, reports->size())) {
+        CompactIndex(false);
+      }
+      return true;
+    }
+    LOG(WARNING) << "rebuilding report index";
+  }
+
+  return RebuildIndex(reports);
+#else
+  return false;
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+bool CrashReportDatabaseGeneric::RebuildIndex(IndexedReports* reports) {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  reports->clear();
+
+  ScopedFileHandle handle(
+      LoggingOpenFileForReadAndWrite(IndexPath(),
+                                     FileWriteMode::kReuseOrCreate,
+                                     FilePermissions::kOwnerOnly));
+  if (!handle.is_valid()) {
+    return false;
+  }
+
+  // Holding the lock while scanning the report directories ensures that any
+  // change made to a report during the scan is appended to the index after it
+  // has been rewritten, superseding whatever the scan found.
+  if (LoggingLockFile(handle.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kBlocking) !=
+      FileLockingResult::kSuccess) {
+    return false;
+  }
+
+  std::string contents;
+  const IndexHeader header;
+  contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (const ReportState state : {kPending, kCompleted}) {
+    std::vector<base::FilePath> filepaths;
+    if (!ListReportFiles(state, &filepaths)) {
+      continue;
+    }
+
+    for (const base::FilePath& filepath : filepaths) {
+      if (filepath.FinalExtension().compare(kCrashReportExtension) != 0) {
+        continue;
+      }
+
+      // Reports aren’t locked or cleaned here: a report being changed will
+      // have its new state appended once the index lock is released, and
+      // CleaningReadMetadata() would itself need to update the index.
+      Report report;
+      if (!ReadMetadata(filepath, &report)) {
+        continue;
+      }
+      (*reports)[report.uuid] = {state, report};
+    }
+  }
+
+  for (const auto& [uuid, indexed_report] : *reports) {
+    contents.append(
+        SerializeIndexRecord(indexed_report.report, indexed_report.state));
+  }
+
+  const bool written = LoggingSeekFile(handle.get(), 0, SEEK_SET) == 0 &&
+                       LoggingTruncateFile(handle.get()) &&
+                       LoggingWriteFile(handle.get(),
+                                        contents.data(),
+                                        contents.size());
+  LoggingUnlockFile(handle.get());
+  if (!written) {
+    LoggingRemoveFile(IndexPath());
+  }
+
+  // Even if the index couldn’t be written, reports holds what was found in the
+  // report directories.
+  return true;
+#else
+  return false;
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+bool CrashReportDatabaseGeneric::ParseIndex(const std::string& contents,
+                                            IndexedReports* reports,
+                                            size_t* record_count) {
+  IndexHeader header;
+  if (contents.size() < sizeof(header)) {
+    LOG(ERROR) << "report index too short";
+    return false;
+  }
+  memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != IndexHeader::kMagic ||
+      header.version != IndexHeader::kVersion) {
+    LOG(ERROR) << "report index header mismatch";
+    return false;
+  }
+
+  size_t records = 0;
+  size_t offset = sizeof(header);
+  while (offset < contents.size()) {
+    ++records;
+    IndexRecord record;
+    if (contents.size() - offset < sizeof(record)) {
+      LOG(ERROR) << "report index record truncated";
+      return false;
+    }
+    memcpy(&record, contents.data() + offset, sizeof(record));
+    offset += sizeof(record);
+
+    if (record.marker != IndexRecord::kMarker ||
+        (record.state != kPending && record.state != kCompleted &&
+         record.state != kRemoved) ||
+        contents.size() - offset < record.id_size) {
+      LOG(ERROR) << "report index record invalid";
+      return false;
+    }
+
+    if (record.state == kRemoved) {
+      reports->erase(record.uuid);
+      offset += record.id_size;
+      continue;
+    }
+
+    IndexedReport& indexed_report = (*reports)[record.uuid];
+    indexed_report.state = static_cast<ReportState>(record.state);
+    Report& report = indexed_report.report;
+    report = Report();
+    report.uuid = record.uuid;
+    report.file_path = ReportPath(record.uuid, indexed_report.state);
+    report.id.assign(contents, offset, record.id_size);
+    report.creation_time = record.creation_time;
+    report.uploaded = (record.attributes & kAttributeUploaded) != 0;
+    report.last_upload_attempt_time = record.last_upload_attempt_time;
+    report.upload_attempts = record.upload_attempts;
+    report.upload_explicitly_requested =
+        (record.attributes & kAttributeUploadExplicitlyRequested) != 0;
+    report.total_size = record.total_size;
+    offset += record.id_size;
+  }
+
+  if (record_count) {
+    *record_count = records;
+  }
+  return true;
+}
+
+// static
+bool CrashReportDatabaseGeneric::IndexNeedsCompaction(size_t record_count,
+                                                      size_t report_count) {
+  return record_count >= kMinIndexRecordsToCompact &&
+         record_count > 2 * report_count;
+}
+
+void CrashReportDatabaseGeneric::CompactIndex(bool force) {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  ScopedFileHandle handle(OpenFileForReadAndWrite(IndexPath(),
+                                                  FileWriteMode::kReuseOrFail,
+                                                  FilePermissions::kOwnerOnly));
+  if (!handle.is_valid()) {
+    return;
+  }
+  if (LoggingLockFile(handle.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kBlocking) !=
+      FileLockingResult::kSuccess) {
+    return;
+  }
+  const bool compacted = CompactIndexLocked(handle.get(), force);
+  LoggingUnlockFile(handle.get());
+  if (!compacted) {
+    LoggingRemoveFile(IndexPath());
+  }
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+bool CrashReportDatabaseGeneric::CompactIndexLocked(FileHandle handle,
+                                                    bool force) {
+  // The index is read again now that it’s locked exclusively, so that no
+  // record appended since it was last read is lost.
+  std::string contents;
+  IndexedReports reports;
+  size_t record_count;
+  if (LoggingSeekFile(handle, 0, SEEK_SET) != 0 ||
+      !LoggingReadToEOF(handle, &contents) ||
+      !ParseIndex(contents, &reports, &record_count)) {
+    return false;
+  }
+
+  if (force ? record_count > reports.size()
+            : IndexNeedsCompaction(record_count, reports.size())) {
+    contents.clear();
+    const IndexHeader header;
+    contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& [uuid, indexed_report] : reports) {
+      contents.append(
+          SerializeIndexRecord(indexed_report.report, indexed_report.state));
+    }
+    if (LoggingSeekFile(handle, 0, SEEK_SET) != 0 ||
+        !LoggingTruncateFile(handle) ||
+        !LoggingWriteFile(handle, contents.data(), contents.size())) {
+      return false;
+    }
+  }
+
+  // Appended records aren’t counted, so the index is next checked once it has
+  // grown well past its current size.
+  index_compaction_size_.store(
+      std::max(static_cast<FileOffset>(2 * contents.size()),
+               kMinIndexSizeToCompact),
+      std::memory_order_relaxed);
+  return true;
+}
+
+bool CrashReportDatabaseGeneric::IndexMatchesDirectories(
+    const IndexedReports& reports) {
+  std::set<std::pair<UUID, ReportState>> indexed;
+  for (const auto& [uuid, indexed_report] : reports) {
+    indexed.emplace(uuid, indexed_report.state);
+  }
+
+  std::set<std::pair<UUID, ReportState>> found;
+  for (const ReportState state : {kPending, kCompleted}) {
+    std::vector<base::FilePath> filepaths;
+    if (!ListReportFiles(state, &filepaths)) {
+      return false;
+    }
+
+    for (const base::FilePath& filepath : filepaths) {
+      UUID uuid;
+      if (filepath.FinalExtension().compare(kCrashReportExtension) == 0 &&
+          uuid.InitializeFromString(
+              filepath.BaseName().RemoveFinalExtension().value())) {
+        found.emplace(uuid, state);
+      }
+    }
+  }
+
+  return found == indexed;
+}
+
+void CrashReportDatabaseGeneric::AppendToIndex(const Report& report,
+                                               ReportState state) {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  DCHECK(state == kPending || state == kCompleted || state == kRemoved);
+
+  const std::string record(SerializeIndexRecord(report, state));
+  if (!defer_index_updates_) {
+    AppendRecordsToIndex(record);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(index_lock_);
+  const time_t now = time(nullptr);
+  if (deferred_index_records_.empty()) {
+    deferred_index_since_ = now;
+  }
+  deferred_index_records_.append(record);
+  ++deferred_index_record_count_;
+  if (deferred_index_record_count_ >= kMaxDeferredIndexRecords ||
+      now - deferred_index_since_ >= kMaxIndexDeferralSeconds) {
+    FlushIndexUpdatesLocked();
+  }
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+void CrashReportDatabaseGeneric::EnableDeferredIndexUpdates() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  defer_index_updates_ = true;
+}
+
+void CrashReportDatabaseGeneric::FlushIndexUpdates() {
+  std::lock_guard<std::mutex> lock(index_lock_);
+  FlushIndexUpdatesLocked();
+}
+
+void CrashReportDatabaseGeneric::FlushIndexUpdatesLocked() {
+  if (deferred_index_records_.empty()) {
+    return;
+  }
+  AppendRecordsToIndex(deferred_index_records_);
+  deferred_index_records_.clear();
+  deferred_index_record_count_ = 0;
+}
+
+void CrashReportDatabaseGeneric::AppendRecordsToIndex(
+    const std::string& records) {
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+  // If there’s no index, there’s nothing to keep up to date. It will be built
+  // when it’s next needed.
+  ScopedFileHandle handle(OpenFileForReadAndWrite(IndexPath(),
+                                                  FileWriteMode::kReuseOrFail,
+                                                  FilePermissions::kOwnerOnly));
+  if (!handle.is_valid()) {
+    return;
+  }
+
+  if (LoggingLockFile(handle.get(),
+                      FileLocking::kExclusive,
+                      FileLockingBlocking::kBlocking) ==
+      FileLockingResult::kSuccess) {
+    bool written =
+        LoggingSeekFile(handle.get(), 0, SEEK_END) >= 0 &&
+        LoggingWriteFile(handle.get(), records.data(), records.size());
+    if (written) {
+      const FileOffset size = LoggingSeekFile(handle.get(), 0, SEEK_CUR);
+      const FileOffset compaction_size =
+          index_compaction_size_.load(std::memory_order_relaxed);
+      if (size < 0 ||
+          (size > std::max(compaction_size, kMinIndexSizeToCompact) &&
+           !CompactIndexLocked(handle.get(), false))) {
+        written = false;
+      }
+    }
+    LoggingUnlockFile(handle.get());
+    if (written) {
+      return;
+    }
+  }
+
+  // An index that’s missing a change would be wrong, so get rid of it.
+  LoggingRemoveFile(IndexPath());
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+}
+
+void CrashReportDatabaseGeneric::RemoveFromIndex(const UUID& uuid) {
+  Report report;
+  report.uuid = uuid;
+  AppendToIndex(report, kRemoved);
+}
+
+// static
+std::string CrashReportDatabaseGeneric::SerializeIndexRecord(
+    const Report& report,
+    ReportState state) {
+  IndexRecord record;
+#if defined(MEMORY_SANITIZER)
+  // memset() + re-initialization is required to zero padding bytes for MSan.
+  memset(&record, 0, sizeof(record));
+#endif  // defined(MEMORY_SANITIZER)
+  record = {};
+  record.state = state;
+  record.uuid = report.uuid;
+  if (state != kRemoved) {
+    record.upload_attempts = report.upload_attempts;
+    record.id_size = base::checked_cast<uint32_t>(report.id.size());
+    record.last_upload_attempt_time = report.last_upload_attempt_time;
+    record.creation_time = report.creation_time;
+    record.total_size = report.total_size;
+    record.attributes =
+        (report.uploaded ? kAttributeUploaded : 0) |
+        (report.upload_explicitly_requested
+             ? kAttributeUploadExplicitlyRequested
+             : 0);
+  }
+
+  std::string serialized(reinterpret_cast<const char*>(&record),
+                         sizeof(record));
+  serialized.append(report.id, 0, record.id_size);
+  return serialized;
+}
+
 bool CrashReportDatabaseGeneric::ReadMetadata(const base::FilePath& path,
                                               Report* report) {
   const base::FilePath metadata_path(
@@ -885,12 +2102,14 @@ bool CrashReportDatabaseGeneric::CleaningReadMetadata(
 
   LoggingRemoveFile(path);
   LoggingRemoveFile(ReplaceFinalExtension(path, kMetadataExtension));
+  RemoveFromIndex(UUIDFromReportPath(path));
   RemoveAttachmentsByUUID(report->uuid);
   return false;
 }
 
 // static
-bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path) {
+bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path,
+                                                  time_t creation_time) {
   const base::FilePath metadata_path(
       ReplaceFinalExtension(path, kMetadataExtension));
 
@@ -907,7 +2126,7 @@ bool CrashReportDatabaseGeneric::WriteNewMetadata(const base::FilePath& path) {
   memset(&metadata, 0, sizeof(metadata));
 #endif  // defined(MEMORY_SANITIZER)
   metadata = {};
-  metadata.creation_time = time(nullptr);
+  metadata.creation_time = creation_time;
 
   return LoggingWriteFile(handle.get(), &metadata, sizeof(metadata));
 }
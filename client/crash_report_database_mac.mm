@@ -375,6 +375,10 @@ CrashReportDatabaseMac::FinishedWritingCrashReport(
     UUID* uuid) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  if (!report->FinishCompression()) {
+    return kFileSystemError;
+  }
+
   const base::FilePath& path = report->file_remover_.get();
 
   // Get the report's UUID to return.
@@ -14,6 +14,11 @@
 
 #include "client/crash_report_database.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+
 #include "build/build_config.h"
 #include "client/settings.h"
 #include "gtest/gtest.h"
@@ -21,8 +26,12 @@
 #include "test/file.h"
 #include "test/filesystem.h"
 #include "test/scoped_temp_dir.h"
+#include "util/file/file_helper.h"
+#include "util/file/directory_reader.h"
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
+#include "util/file/string_file.h"
+#include "util/misc/xxhash64.h"
 
 #if BUILDFLAG(IS_IOS)
 #include "util/mac/xattr.h"
@@ -249,6 +258,72 @@ TEST_F(CrashReportDatabaseTest, NewCrashReport) {
   EXPECT_TRUE(reports.empty());
 }
 
+TEST_F(CrashReportDatabaseTest, CompressedCrashReport) {
+  static constexpr char kTest[] = "compressed test";
+
+  db()->SetCompressNewReports(true);
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(new_report->IsCompressed());
+  ASSERT_TRUE(new_report->MinidumpWriter()->Write(kTest, sizeof(kTest)));
+
+  char contents[sizeof(kTest)];
+  FileReaderInterface* reader = new_report->Reader();
+  ASSERT_TRUE(reader);
+  ASSERT_TRUE(reader->ReadExactly(contents, sizeof(contents)));
+  EXPECT_EQ(memcmp(contents, kTest, sizeof(contents)), 0);
+  EXPECT_EQ(reader->ReadExactly(contents, 1), 0);
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  // Reports written after compression is disabled again are not compressed,
+  // and coexist with the compressed report.
+  db()->SetCompressNewReports(false);
+  CrashReportDatabase::Report uncompressed_report;
+  CreateCrashReport(&uncompressed_report);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(upload_report->IsCompressed());
+
+  // The digest computed while the report was written matches its contents.
+  std::string compressed;
+  char buffer[4096];
+  FileOperationResult bytes_read;
+  while ((bytes_read =
+              upload_report->Reader()->Read(buffer, sizeof(buffer))) > 0) {
+    compressed.append(buffer, bytes_read);
+  }
+  ASSERT_EQ(bytes_read, 0);
+  ASSERT_TRUE(upload_report->Reader()->SeekSet(0));
+  XXHash64 expect_digest;
+  expect_digest.Update(compressed.data(), compressed.size());
+  uint64_t digest;
+  uint64_t size;
+  ASSERT_TRUE(upload_report->GetContentDigest(&digest, &size));
+  EXPECT_EQ(digest, expect_digest.Digest());
+  EXPECT_EQ(size, compressed.size());
+
+  // The digest isn't an attachment.
+  EXPECT_TRUE(upload_report->GetAttachments().empty());
+
+  StringFile decompressed;
+  ASSERT_TRUE(
+      DecompressGzipFileContent(upload_report->Reader(), &decompressed));
+  EXPECT_EQ(decompressed.string(), std::string(kTest, sizeof(kTest)));
+
+  ASSERT_EQ(
+      db()->GetReportForUploading(uncompressed_report.uuid, &upload_report),
+      CrashReportDatabase::kNoError);
+  EXPECT_FALSE(upload_report->IsCompressed());
+  EXPECT_FALSE(upload_report->GetContentDigest(&digest, &size));
+}
+
 TEST_F(CrashReportDatabaseTest, LookUpCrashReport) {
   UUID uuid;
 
@@ -587,6 +662,55 @@ TEST_F(CrashReportDatabaseTest, MoveDatabase) {
   ExpectPreparedCrashReport(report);
 }
 
+TEST_F(CrashReportDatabaseTest, ManyStateTransitions) {
+  // Enough operations that databases which journal their metadata must compact
+  // it at least once.
+  constexpr size_t kNumReports = 100;
+  std::vector<UUID> uuids;
+  for (size_t index = 0; index < kNumReports; ++index) {
+    CrashReportDatabase::Report report;
+    ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+    uuids.push_back(report.uuid);
+  }
+
+  std::set<UUID> expected_pending;
+  std::set<UUID> expected_completed;
+  for (size_t index = 0; index < kNumReports; ++index) {
+    const UUID& uuid = uuids[index];
+    if (index % 3 == 0) {
+      ASSERT_EQ(db()->DeleteReport(uuid), CrashReportDatabase::kNoError);
+    } else if (index % 3 == 1) {
+      ASSERT_NO_FATAL_FAILURE(UploadReport(uuid, true, uuid.ToString()));
+      expected_completed.insert(uuid);
+    } else {
+      expected_pending.insert(uuid);
+    }
+  }
+
+  ResetDatabase();
+  ASSERT_NO_FATAL_FAILURE(SetUp());
+
+  std::vector<CrashReportDatabase::Report> pending;
+  ASSERT_EQ(db()->GetPendingReports(&pending), CrashReportDatabase::kNoError);
+  std::set<UUID> pending_uuids;
+  for (const auto& report : pending) {
+    pending_uuids.insert(report.uuid);
+  }
+  EXPECT_EQ(pending_uuids, expected_pending);
+
+  std::vector<CrashReportDatabase::Report> completed;
+  ASSERT_EQ(db()->GetCompletedReports(&completed),
+            CrashReportDatabase::kNoError);
+  std::set<UUID> completed_uuids;
+  for (const auto& report : completed) {
+    completed_uuids.insert(report.uuid);
+    EXPECT_TRUE(report.uploaded);
+    EXPECT_EQ(report.id, report.uuid.ToString());
+    EXPECT_EQ(report.upload_attempts, 1);
+  }
+  EXPECT_EQ(completed_uuids, expected_completed);
+}
+
 TEST_F(CrashReportDatabaseTest, ReportRemoved) {
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
   EXPECT_EQ(db()->PrepareNewCrashReport(&new_report),
@@ -794,6 +918,240 @@ TEST_F(CrashReportDatabaseTest, Attachments) {
   EXPECT_EQ(memcmp(test_data, result_buffer, sizeof(test_data)), 0);
 }
 
+TEST_F(CrashReportDatabaseTest, AttachmentFromFile) {
+  ScopedTempDir temp_dir;
+  const base::FilePath source(
+      temp_dir.path().Append(FILE_PATH_LITERAL("source")));
+  static constexpr char test_data[] = "attachment data";
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write(test_data, sizeof(test_data)));
+  }
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(new_report->AddAttachmentFromFile("some_file", source, false));
+  EXPECT_FALSE(
+      new_report->AddAttachmentFromFile("not/a valid fi!e", source, false));
+  EXPECT_FALSE(new_report->AddAttachmentFromFile(
+      "missing",
+      temp_dir.path().Append(FILE_PATH_LITERAL("missing")),
+      false));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  std::map<std::string, FileReader*> result_attachments =
+      upload_report->GetAttachments();
+  ASSERT_EQ(result_attachments.size(), 1u);
+  ASSERT_NE(result_attachments.find("some_file"), result_attachments.end());
+  char result_buffer[sizeof(test_data)];
+  ASSERT_TRUE(result_attachments["some_file"]->ReadExactly(
+      result_buffer, sizeof(result_buffer)));
+  EXPECT_EQ(memcmp(test_data, result_buffer, sizeof(test_data)), 0);
+}
+
+TEST_F(CrashReportDatabaseTest, UploadParameters) {
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+
+  FileWriter* attach_some_file = new_report->AddAttachment("some_file");
+  ASSERT_NE(attach_some_file, nullptr);
+
+  const std::map<std::string, std::string> parameters = {
+      {"prod", "crashpad_test"},
+      {"ver", "1.0"},
+      {"empty", ""},
+      {"list_annotations", std::string("with\0nul\nand newline", 20)},
+  };
+  ASSERT_TRUE(new_report->SetUploadParameters(parameters));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  // The parameters can be read without obtaining the report for uploading,
+  // which doesn't count as an upload attempt.
+  std::map<std::string, std::string> pending_parameters;
+  ASSERT_TRUE(db()->GetUploadParameters(uuid, &pending_parameters));
+  EXPECT_EQ(pending_parameters, parameters);
+  CrashReportDatabase::Report pending_report;
+  ASSERT_EQ(db()->LookUpCrashReport(uuid, &pending_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(pending_report.upload_attempts, 0);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+
+  // The parameters aren't presented as an attachment.
+  std::map<std::string, FileReader*> result_attachments =
+      upload_report->GetAttachments();
+  EXPECT_EQ(result_attachments.size(), 1u);
+  EXPECT_NE(result_attachments.find("some_file"), result_attachments.end());
+
+  std::map<std::string, std::string> result_parameters;
+  ASSERT_TRUE(upload_report->GetUploadParameters(&result_parameters));
+  EXPECT_EQ(result_parameters, parameters);
+}
+
+TEST_F(CrashReportDatabaseTest, NoUploadParameters) {
+  CrashReportDatabase::Report report;
+  CreateCrashReport(&report);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(report.uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+
+  std::map<std::string, std::string> parameters;
+  EXPECT_FALSE(upload_report->GetUploadParameters(&parameters));
+  EXPECT_FALSE(db()->GetUploadParameters(report.uuid, &parameters));
+}
+
+TEST_F(CrashReportDatabaseTest, ReportSummary) {
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+
+  static constexpr char kReportData[] = "minidump";
+  ASSERT_TRUE(new_report->Writer()->Write(kReportData, strlen(kReportData)));
+
+  CrashReportDatabase::ReportSummary summary;
+  summary.exception_code = 0xc0000005;
+  summary.crashing_module = "/usr/lib/libcrash.so";
+  summary.crashing_module_offset = 0x123456789;
+  summary.process_name = "crasher";
+  summary.thread_count = 12;
+  summary.report_size = 1;
+  ASSERT_TRUE(new_report->SetSummary(summary));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  CrashReportDatabase::ReportSummary result;
+  ASSERT_TRUE(db()->GetReportSummary(uuid, &result));
+  EXPECT_EQ(result.exception_code, summary.exception_code);
+  EXPECT_EQ(result.crashing_module, summary.crashing_module);
+  EXPECT_EQ(result.crashing_module_offset, summary.crashing_module_offset);
+  EXPECT_EQ(result.process_name, summary.process_name);
+  EXPECT_EQ(result.thread_count, summary.thread_count);
+
+  // The stored size is that of the report file, not the caller’s.
+  EXPECT_EQ(result.report_size, strlen(kReportData));
+
+  // The summary isn’t presented as an attachment.
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(upload_report->GetAttachments().empty());
+}
+
+TEST_F(CrashReportDatabaseTest, NoReportSummary) {
+  CrashReportDatabase::Report report;
+  CreateCrashReport(&report);
+
+  CrashReportDatabase::ReportSummary summary;
+  EXPECT_FALSE(db()->GetReportSummary(report.uuid, &summary));
+}
+
+TEST_F(CrashReportDatabaseTest, UploadBody) {
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+
+  static constexpr char kBody[] = "prepared body";
+  const std::map<std::string, std::string> content_headers = {
+      {"Content-Type", "multipart/form-data; boundary=abc"},
+      {"Content-Encoding", "gzip"},
+  };
+  FileWriter* body_writer = new_report->AddUploadBody();
+  ASSERT_TRUE(body_writer);
+  ASSERT_TRUE(body_writer->Write(kBody, strlen(kBody)));
+  ASSERT_TRUE(new_report->SetUploadBodyHeaders(content_headers));
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+              CrashReportDatabase::kNoError);
+
+    // The body isn’t presented as an attachment.
+    EXPECT_TRUE(upload_report->GetAttachments().empty());
+
+    std::map<std::string, std::string> result_headers;
+    FileReader* body_reader = upload_report->GetUploadBody(&result_headers);
+    ASSERT_TRUE(body_reader);
+    EXPECT_EQ(result_headers, content_headers);
+    std::string body;
+    ASSERT_TRUE(LoggingReadToEOF(body_reader->file_handle(), &body));
+    EXPECT_EQ(body, kBody);
+  }
+
+  db()->DiscardUploadBody(uuid);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  std::map<std::string, std::string> result_headers;
+  EXPECT_FALSE(upload_report->GetUploadBody(&result_headers));
+}
+
+TEST_F(CrashReportDatabaseTest, ResumableUploadState) {
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  FileWriter* attach_some_file = new_report->AddAttachment("some_file");
+  ASSERT_NE(attach_some_file, nullptr);
+
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  CrashReportDatabase::UploadReport::ResumableUploadState state;
+  {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+              CrashReportDatabase::kNoError);
+    EXPECT_FALSE(upload_report->GetResumableUploadState(&state));
+
+    state.upload_id = "upload-id";
+    state.boundary = "---boundary---";
+    state.offset = 0x100000000;
+    ASSERT_TRUE(upload_report->SetResumableUploadState(state));
+  }
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(db()->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+
+  // The state isn't presented as an attachment.
+  std::map<std::string, FileReader*> result_attachments =
+      upload_report->GetAttachments();
+  EXPECT_EQ(result_attachments.size(), 1u);
+  EXPECT_NE(result_attachments.find("some_file"), result_attachments.end());
+
+  CrashReportDatabase::UploadReport::ResumableUploadState result_state;
+  ASSERT_TRUE(upload_report->GetResumableUploadState(&result_state));
+  EXPECT_EQ(result_state.upload_id, state.upload_id);
+  EXPECT_EQ(result_state.boundary, state.boundary);
+  EXPECT_EQ(result_state.offset, state.offset);
+
+  upload_report->ClearResumableUploadState();
+  EXPECT_FALSE(upload_report->GetResumableUploadState(&result_state));
+}
+
 TEST_F(CrashReportDatabaseTest, OrphanedAttachments) {
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
   ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
@@ -922,6 +1280,363 @@ TEST_F(CrashReportDatabaseTest, CleanBrokenDatabase) {
   EXPECT_FALSE(PathExists(report.file_path));
   EXPECT_FALSE(PathExists(metadata3));
 }
+
+TEST_F(CrashReportDatabaseTest, CorruptIndex) {
+  CrashReportDatabase::Report pending;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending));
+  CrashReportDatabase::Report completed;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed));
+  UploadReport(completed.uuid, true, "completed");
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+
+  // Leave a partial record at the end of the index, as an interrupted write
+  // might. The index is rebuilt from the report directories.
+  const base::FilePath index_path(
+      path().Append(FILE_PATH_LITERAL("index.dat")));
+  ScopedFileHandle handle(LoggingOpenFileForWrite(
+      index_path, FileWriteMode::kReuseOrCreate, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  ASSERT_GE(LoggingSeekFile(handle.get(), 0, SEEK_END), 0);
+  static constexpr char kGarbage[] = "garbage";
+  ASSERT_TRUE(LoggingWriteFile(handle.get(), kGarbage, sizeof(kGarbage)));
+  handle.reset();
+
+  reports.clear();
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, pending.uuid);
+  EXPECT_EQ(reports[0].file_path, pending.file_path);
+  EXPECT_FALSE(reports[0].uploaded);
+
+  reports.clear();
+  ASSERT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, completed.uuid);
+  EXPECT_EQ(reports[0].id, "completed");
+  EXPECT_TRUE(reports[0].uploaded);
+  EXPECT_EQ(reports[0].upload_attempts, 1);
+
+  // Removing the index entirely works the same way.
+  ASSERT_TRUE(LoggingRemoveFile(index_path));
+  reports.clear();
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, pending.uuid);
+}
+
+TEST_F(CrashReportDatabaseTest, StaleIndex) {
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+
+  // Move the report to completed without the database’s involvement, as an
+  // old version or an interrupted process might. CleanDatabase() notices that
+  // the index no longer matches the report directories.
+  const base::FilePath completed_dir(
+      path().Append(FILE_PATH_LITERAL("completed")));
+  const base::FilePath metadata(
+      report.file_path.RemoveFinalExtension().value() +
+      FILE_PATH_LITERAL(".meta"));
+  ASSERT_TRUE(MoveFileOrDirectory(
+      report.file_path, completed_dir.Append(report.file_path.BaseName())));
+  ASSERT_TRUE(MoveFileOrDirectory(
+      metadata, completed_dir.Append(metadata.BaseName())));
+
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+
+  reports.clear();
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_TRUE(reports.empty());
+
+  reports.clear();
+  ASSERT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, report.uuid);
+}
+
+TEST_F(CrashReportDatabaseTest, ShardedLayout) {
+  CrashReportDatabase::Report pending;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&pending));
+  CrashReportDatabase::Report completed;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&completed));
+  UploadReport(completed.uuid, true, "completed");
+
+  // Existing reports are moved into their shards.
+  ASSERT_TRUE(db()->EnableShardedLayout());
+  const auto shard_path = [this](const char* state, const UUID& uuid) {
+    const std::string uuid_string = uuid.ToString();
+    return path()
+        .Append(state)
+        .Append(uuid_string.substr(0, 2))
+        .Append(uuid_string + ".dmp");
+  };
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(db()->LookUpCrashReport(pending.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.file_path, shard_path("pending", pending.uuid));
+  EXPECT_TRUE(FileExists(report.file_path));
+  EXPECT_FALSE(FileExists(pending.file_path));
+
+  ASSERT_EQ(db()->LookUpCrashReport(completed.uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(report.file_path, shard_path("completed", completed.uuid));
+  EXPECT_EQ(report.id, "completed");
+  EXPECT_TRUE(report.uploaded);
+
+  // New reports are created in their shards, and the layout persists.
+  CrashReportDatabase::Report added;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&added));
+  EXPECT_EQ(added.file_path, shard_path("pending", added.uuid));
+
+  ResetDatabase();
+  ASSERT_NO_FATAL_FAILURE(SetUp());
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+
+  UploadReport(added.uuid, true, "added");
+  reports.clear();
+  ASSERT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 2u);
+  for (const auto& completed_report : reports) {
+    EXPECT_EQ(completed_report.file_path,
+              shard_path("completed", completed_report.uuid));
+  }
+
+  // The index is rebuilt from the shards.
+  ASSERT_TRUE(LoggingRemoveFile(path().Append("index.dat")));
+  reports.clear();
+  ASSERT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+
+  EXPECT_EQ(db()->DeleteReport(pending.uuid), CrashReportDatabase::kNoError);
+  EXPECT_FALSE(FileExists(shard_path("pending", pending.uuid)));
+}
+
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+TEST_F(CrashReportDatabaseTest, ReportFilePool) {
+  const base::FilePath new_dir = path().Append("new");
+  const auto pooled_files = [&new_dir]() {
+    DirectoryReader reader;
+    EXPECT_TRUE(reader.Open(new_dir));
+    size_t count = 0;
+    base::FilePath filename;
+    while (reader.NextFile(&filename) == DirectoryReader::Result::kSuccess) {
+      if (filename.FinalExtension() == FILE_PATH_LITERAL(".pool")) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  EXPECT_EQ(db()->FillReportFilePool(2, 4096), 2u);
+  EXPECT_EQ(pooled_files(), 2u);
+  EXPECT_EQ(db()->FillReportFilePool(1, 0), 2u);
+
+  // Reports are written to files claimed from the pool.
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  EXPECT_EQ(pooled_files(), 1u);
+
+  // Files in use aren’t removed by this or another database object, but one
+  // left behind is.
+  UUID abandoned_uuid;
+  abandoned_uuid.InitializeWithNew();
+  const base::FilePath abandoned_path =
+      new_dir.Append(abandoned_uuid.ToString() + ".pool");
+  ASSERT_TRUE(CreateFile(abandoned_path));
+  EXPECT_EQ(pooled_files(), 2u);
+  std::unique_ptr<CrashReportDatabase> other_db =
+      CrashReportDatabase::Initialize(path());
+  ASSERT_TRUE(other_db);
+  EXPECT_FALSE(FileExists(abandoned_path));
+  EXPECT_EQ(pooled_files(), 1u);
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+  EXPECT_EQ(pooled_files(), 1u);
+
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  EXPECT_EQ(pooled_files(), 0u);
+
+  // Unclaimed files are removed when the database is destroyed.
+  EXPECT_EQ(db()->FillReportFilePool(1, 0), 1u);
+  EXPECT_EQ(pooled_files(), 1u);
+  ResetDatabase();
+  EXPECT_EQ(pooled_files(), 0u);
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(other_db->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 2u);
+}
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+
+TEST_F(CrashReportDatabaseTest, StagedReports) {
+  // A report left incomplete by an earlier process is removed.
+  const base::FilePath staging_dir = path().DirName().Append("staging");
+  ASSERT_TRUE(LoggingCreateDirectory(
+      staging_dir, FilePermissions::kOwnerOnly, false));
+  UUID incomplete_uuid;
+  incomplete_uuid.InitializeWithNew();
+  const base::FilePath incomplete_path =
+      staging_dir.Append(incomplete_uuid.ToString() + ".dmp");
+  ASSERT_TRUE(CreateFile(incomplete_path));
+  ASSERT_TRUE(db()->SetStagingDirectory(staging_dir));
+  EXPECT_FALSE(FileExists(incomplete_path));
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  static constexpr char kTest[] = "test";
+  ASSERT_TRUE(new_report->Writer()->Write(kTest, sizeof(kTest) - 1));
+  FileWriter* attachment = new_report->AddAttachment("attachment");
+  ASSERT_TRUE(attachment);
+  ASSERT_TRUE(attachment->Write(kTest, sizeof(kTest) - 1));
+  UUID uuid;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  // The report isn’t in the database until it’s committed, and cleaning the
+  // database leaves its attachments alone.
+  const base::FilePath staged_path =
+      staging_dir.Append(uuid.ToString() + ".staged");
+  EXPECT_TRUE(FileExists(staged_path));
+  CrashReportDatabase::Report report;
+  EXPECT_EQ(db()->LookUpCrashReport(uuid, &report),
+            CrashReportDatabase::kReportNotFound);
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+
+  // Staged reports are committed by a later process.
+  ResetDatabase();
+  ASSERT_NO_FATAL_FAILURE(SetUp());
+  ASSERT_TRUE(db()->SetStagingDirectory(staging_dir));
+  std::vector<UUID> uuids;
+  EXPECT_TRUE(db()->CommitStagedReports(&uuids));
+  EXPECT_EQ(uuids, std::vector<UUID>{uuid});
+  EXPECT_FALSE(FileExists(staged_path));
+
+  ASSERT_EQ(db()->LookUpCrashReport(uuid, &report),
+            CrashReportDatabase::kNoError);
+  ExpectPreparedCrashReport(report);
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(report.file_path, &contents));
+  EXPECT_EQ(contents, kTest);
+  EXPECT_EQ(report.total_size, 2 * (sizeof(kTest) - 1));
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 1u);
+
+  uuids.clear();
+  EXPECT_TRUE(db()->CommitStagedReports(&uuids));
+  EXPECT_TRUE(uuids.empty());
+}
+
+#if CRASHPAD_FLOCK_ALWAYS_SUPPORTED
+TEST_F(CrashReportDatabaseTest, DeferredIndexUpdates) {
+  db()->EnableDeferredIndexUpdates();
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_TRUE(reports.empty());
+
+  std::unique_ptr<CrashReportDatabase> other_db =
+      CrashReportDatabase::Initialize(path());
+  ASSERT_TRUE(other_db);
+
+  // Deferred changes are reflected by the database that made them, but not by
+  // others.
+  CrashReportDatabase::Report report;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 1u);
+  reports.clear();
+  ASSERT_EQ(other_db->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(reports.empty());
+
+  UploadReport(report.uuid, true, "upload");
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  EXPECT_TRUE(reports.empty());
+  ASSERT_EQ(db()->GetCompletedReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].id, "upload");
+  reports.clear();
+
+  // Flushing makes the changes visible to others.
+  db()->FlushIndexUpdates();
+  ASSERT_EQ(other_db->GetCompletedReports(&reports),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, report.uuid);
+  EXPECT_EQ(reports[0].id, "upload");
+  reports.clear();
+
+  // Changes that are never flushed, as when a process exits first, are found
+  // when the database is cleaned.
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+  ASSERT_EQ(other_db->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(reports.empty());
+  EXPECT_EQ(other_db->CleanDatabase(0), 0);
+  ASSERT_EQ(other_db->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, report.uuid);
+}
+
+TEST_F(CrashReportDatabaseTest, IndexCompaction) {
+  CrashReportDatabase::Report kept;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&kept));
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+
+  // Each change appends a record to the index, but it’s compacted as it grows,
+  // rather than growing with every change made over the database’s lifetime.
+  const base::FilePath index_path(
+      path().Append(FILE_PATH_LITERAL("index.dat")));
+  uint64_t max_index_size = 0;
+  for (int iteration = 0; iteration < 500; ++iteration) {
+    CrashReportDatabase::Report report;
+    ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&report));
+    ASSERT_EQ(db()->RequestUpload(report.uuid), CrashReportDatabase::kNoError);
+    ASSERT_EQ(db()->DeleteReport(report.uuid), CrashReportDatabase::kNoError);
+    max_index_size = std::max(max_index_size, GetFileSize(index_path));
+  }
+  EXPECT_GT(max_index_size, 0u);
+  EXPECT_LT(max_index_size, 16u * 1024);
+
+  reports.clear();
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, kept.uuid);
+
+  // Cleaning the database leaves just one record for the remaining report.
+  const uint64_t one_record_size = GetFileSize(index_path);
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+  const uint64_t cleaned_size = GetFileSize(index_path);
+  EXPECT_LE(cleaned_size, one_record_size);
+  CrashReportDatabase::Report other;
+  ASSERT_NO_FATAL_FAILURE(CreateCrashReport(&other));
+  ASSERT_EQ(db()->DeleteReport(other.uuid), CrashReportDatabase::kNoError);
+  EXPECT_GT(GetFileSize(index_path), cleaned_size);
+  EXPECT_EQ(db()->CleanDatabase(0), 0);
+  EXPECT_EQ(GetFileSize(index_path), cleaned_size);
+
+  reports.clear();
+  ASSERT_EQ(db()->GetPendingReports(&reports), CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+  EXPECT_EQ(reports[0].uuid, kept.uuid);
+}
+#endif  // CRASHPAD_FLOCK_ALWAYS_SUPPORTED
 #endif  // !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_WIN)
 
 TEST_F(CrashReportDatabaseTest, TotalSize_MainReportOnly) {
@@ -979,6 +1694,50 @@ TEST_F(CrashReportDatabaseTest, GetReportSize_RightSizeWithAttachments) {
                 sizeof(attachment_2_data));
 }
 
+TEST_F(CrashReportDatabaseTest, GetTotalSize) {
+  uint64_t total_size;
+  ASSERT_EQ(db()->GetTotalSize(&total_size), CrashReportDatabase::kNoError);
+  EXPECT_EQ(total_size, 0u);
+
+  static constexpr char report_1_data[] = "kfjdhgjsl";
+  static constexpr char report_2_data[] = "ciuerbgylaiwcnmzqtlsygf";
+  static constexpr char attachment_data[] = "xmvneirhs";
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  ASSERT_TRUE(
+      new_report->Writer()->Write(report_1_data, sizeof(report_1_data)));
+  UUID uuid_1;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid_1),
+            CrashReportDatabase::kNoError);
+
+  ASSERT_EQ(db()->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  ASSERT_TRUE(
+      new_report->Writer()->Write(report_2_data, sizeof(report_2_data)));
+  FileWriter* attachment = new_report->AddAttachment("attachment");
+  ASSERT_NE(attachment, nullptr);
+  ASSERT_TRUE(attachment->Write(attachment_data, sizeof(attachment_data)));
+  UUID uuid_2;
+  ASSERT_EQ(db()->FinishedWritingCrashReport(std::move(new_report), &uuid_2),
+            CrashReportDatabase::kNoError);
+
+  // Completed reports count toward the total as well as pending ones.
+  ASSERT_EQ(db()->SkipReportUpload(
+                uuid_2, Metrics::CrashSkippedReason::kUploadsDisabled),
+            CrashReportDatabase::kNoError);
+
+  ASSERT_EQ(db()->GetTotalSize(&total_size), CrashReportDatabase::kNoError);
+  EXPECT_EQ(total_size,
+            sizeof(report_1_data) + sizeof(report_2_data) +
+                sizeof(attachment_data));
+
+  ASSERT_EQ(db()->DeleteReport(uuid_1), CrashReportDatabase::kNoError);
+  ASSERT_EQ(db()->GetTotalSize(&total_size), CrashReportDatabase::kNoError);
+  EXPECT_EQ(total_size, sizeof(report_2_data) + sizeof(attachment_data));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
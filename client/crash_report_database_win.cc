@@ -21,7 +21,9 @@
 #include <time.h>
 #include <wchar.h>
 
+#include <algorithm>
 #include <mutex>
+#include <set>
 #include <tuple>
 #include <utility>
 
@@ -48,7 +50,14 @@ constexpr wchar_t kSettings[] = L"settings.dat";
 constexpr wchar_t kCrashReportFileExtension[] = L"dmp";
 
 constexpr uint32_t kMetadataFileHeaderMagic = 'CPAD';
-constexpr uint32_t kMetadataFileVersion = 1;
+constexpr uint32_t kMetadataFileVersion = 2;
+constexpr uint32_t kMetadataFileVersionWithoutJournal = 1;
+
+constexpr uint32_t kMetadataJournalEntryMagic = 'CPJE';
+
+// The journal is compacted into a new snapshot once it holds more entries than
+// this, or than the number of reports, whichever is greater.
+constexpr size_t kMinJournalEntriesBeforeCompaction = 64;
 
 using OperationStatus = CrashReportDatabase::OperationStatus;
 
@@ -93,11 +102,35 @@ bool UUIDFromReportPath(const base::FilePath& path, UUID* uuid) {
 
 // The format of the on disk metadata file is a MetadataFileHeader, followed by
 // a number of fixed size records of MetadataFileReportRecord, followed by a
-// string table in UTF8 format, where each string is \0 terminated.
+// string table in UTF8 format, where each string is \0 terminated. This
+// snapshot is followed by a journal of MetadataJournalEntryHeader entries,
+// which are applied in order on top of the snapshot. Changes are appended to
+// the journal, and the journal is periodically compacted into a new snapshot.
+//
+// Version 1 files have no journal, and their string table extends to the end
+// of the file.
 struct MetadataFileHeader {
   uint32_t magic;
   uint32_t version;
   uint32_t num_records;
+  uint32_t string_table_size;  // Unused in version 1.
+};
+
+enum JournalEntryType : uint32_t {
+  //! \brief Adds a report, or replaces the report with the same UUID. The
+  //!     entry is followed by a MetadataFileReportRecord and a string table
+  //!     of MetadataJournalEntryHeader::string_table_size bytes, which the
+  //!     record’s indices refer to.
+  kJournalEntryUpsert = 1,
+
+  //! \brief Removes a report. The entry is followed by the report’s UUID.
+  kJournalEntryDelete = 2,
+};
+
+struct MetadataJournalEntryHeader {
+  uint32_t magic;
+  uint32_t type;  // A JournalEntryType.
+  uint32_t string_table_size;
   uint32_t padding;
 };
 
@@ -214,6 +247,9 @@ class Metadata {
 
   //! \brief Writes any changes if necessary, unlocks and closes the file
   //!     handle.
+  //!
+  //! Changes are appended to the journal with AppendJournalEntries(), unless
+  //! the journal has grown large enough that Write() is used to compact it.
   ~Metadata();
 
   static std::unique_ptr<Metadata> Create(
@@ -251,8 +287,8 @@ class Metadata {
   //! \brief Finds a single report matching the given UUID and in the desired
   //!     state, and returns a mutable ReportDisk* if found.
   //!
-  //! This marks the metadata as dirty, and on destruction, changes will be
-  //! written to disk via Write().
+  //! This marks the report as dirty, and on destruction, changes will be
+  //! written to disk.
   //!
   //! \return #kNoError on success. #kReportNotFound if there was no report with
   //!     the specified UUID, or if the report was not in the specified state
@@ -266,7 +302,7 @@ class Metadata {
   //!     on-disk file.
   //!
   //! The returned report is only valid if CrashReportDatabase::kNoError is
-  //! returned. This will mark the database as dirty. Future metadata
+  //! returned. This will mark the report as dirty. Future metadata
   //! operations for this report will not succeed.
   //!
   //! \param[in] uuid The report identifier to remove.
@@ -289,8 +325,23 @@ class Metadata {
   bool Rewind();
 
   void Read();
+
+  //! \brief Parses the journal entry at \a offset in \a journal and applies
+  //!     it to \a reports.
+  //!
+  //! \return `true` on success, with \a offset advanced past the entry.
+  //!     `false` if the entry is truncated or otherwise invalid.
+  bool ApplyJournalEntry(const std::string& journal,
+                         size_t* offset,
+                         std::vector<ReportDisk>* reports) const;
+
+  //! \brief Replaces the file’s contents with a snapshot of #reports_ and an
+  //!     empty journal.
   void Write();
 
+  //! \brief Appends a journal entry for each report in #dirty_uuids_.
+  void AppendJournalEntries();
+
   //! \brief Confirms that the corresponding report actually exists on disk
   //!     (that is, the dump file has not been removed), and that the report is
   //!     in the given state.
@@ -303,13 +354,24 @@ class Metadata {
   ScopedFileHandle handle_;
   const base::FilePath report_dir_;
   const base::FilePath attachments_dir_;
-  bool dirty_;  //! \brief `true` when a Write() is required on destruction.
+  //! \brief Reports that have changed, and must be written on destruction.
+  std::set<UUID> dirty_uuids_;
   std::vector<ReportDisk> reports_;
+  size_t journal_entries_;
+  //! \brief `true` when the file must be rewritten rather than appended to.
+  bool needs_compaction_;
 };
 
 Metadata::~Metadata() {
-  if (dirty_)
-    Write();
+  if (!dirty_uuids_.empty()) {
+    if (needs_compaction_ ||
+        journal_entries_ + dirty_uuids_.size() >
+            std::max(kMinJournalEntriesBeforeCompaction, reports_.size())) {
+      Write();
+    } else {
+      AppendJournalEntries();
+    }
+  }
   // Not actually async, UnlockFileEx requires the Offset fields.
   OVERLAPPED overlapped = {0};
   if (!UnlockFileEx(handle_.get(), 0, MAXDWORD, MAXDWORD, &overlapped))
@@ -358,7 +420,7 @@ std::unique_ptr<Metadata> Metadata::Create(
 void Metadata::AddNewRecord(const ReportDisk& new_report_disk) {
   DCHECK(new_report_disk.state == ReportState::kPending);
   reports_.push_back(new_report_disk);
-  dirty_ = true;
+  dirty_uuids_.insert(new_report_disk.uuid);
 }
 
 OperationStatus Metadata::FindReports(
@@ -401,7 +463,7 @@ OperationStatus Metadata::FindSingleReportAndMarkDirty(
     return CrashReportDatabase::kReportNotFound;
   OperationStatus os = VerifyReport(*report_iter, desired_state);
   if (os == CrashReportDatabase::kNoError) {
-    dirty_ = true;
+    dirty_uuids_.insert(uuid);
     *report_disk = &*report_iter;
   }
   return os;
@@ -417,7 +479,7 @@ OperationStatus Metadata::DeleteReport(const UUID& uuid,
     return CrashReportDatabase::kReportNotFound;
   *report_path = report_iter->file_path;
   reports_.erase(report_iter);
-  dirty_ = true;
+  dirty_uuids_.insert(uuid);
   return CrashReportDatabase::kNoError;
 }
 
@@ -425,9 +487,9 @@ int Metadata::CleanDatabase() {
   int removed = 0;
   for (auto report_iter = reports_.begin(); report_iter != reports_.end();) {
     if (!IsRegularFile(report_iter->file_path)) {
+      dirty_uuids_.insert(report_iter->uuid);
       report_iter = reports_.erase(report_iter);
       ++removed;
-      dirty_ = true;
     } else {
       ++report_iter;
     }
@@ -441,8 +503,10 @@ Metadata::Metadata(FileHandle handle,
     : handle_(handle),
       report_dir_(report_dir),
       attachments_dir_(attachments_dir),
-      dirty_(false),
-      reports_() {}
+      dirty_uuids_(),
+      reports_(),
+      journal_entries_(0),
+      needs_compaction_(true) {}
 
 bool Metadata::Rewind() {
   FileOffset result = LoggingSeekFile(handle_.get(), 0, SEEK_SET);
@@ -465,7 +529,8 @@ void Metadata::Read() {
     return;
   }
   if (header.magic != kMetadataFileHeaderMagic ||
-      header.version != kMetadataFileVersion) {
+      (header.version != kMetadataFileVersion &&
+       header.version != kMetadataFileVersionWithoutJournal)) {
     LOG(ERROR) << "unexpected header";
     return;
   }
@@ -478,40 +543,165 @@ void Metadata::Read() {
     return;
   }
 
+  std::vector<MetadataFileReportRecord> records(header.num_records);
+  if (header.num_records > 0 &&
+      !LoggingReadFileExactly(
+          handle_.get(), &records[0], records_size.ValueOrDie())) {
+    LOG(ERROR) << "failed to read records";
+    return;
+  }
+
+  std::string string_table;
+  std::string journal;
+  if (header.version == kMetadataFileVersionWithoutJournal) {
+    if (header.num_records > 0) {
+      string_table = ReadRestOfFileAsString(handle_.get());
+    }
+  } else {
+    if (header.string_table_size > 0) {
+      string_table.resize(header.string_table_size);
+      if (!LoggingReadFileExactly(
+              handle_.get(), &string_table[0], string_table.size())) {
+        LOG(ERROR) << "failed to read string table";
+        return;
+      }
+    }
+    journal = ReadRestOfFileAsString(handle_.get());
+  }
+
+  if (header.num_records > 0 &&
+      (string_table.empty() || string_table.back() != '\0')) {
+    LOG(ERROR) << "bad string table";
+    return;
+  }
+
   std::vector<ReportDisk> reports;
-  if (header.num_records > 0) {
-    std::vector<MetadataFileReportRecord> records(header.num_records);
-    if (!LoggingReadFileExactly(
-            handle_.get(), &records[0], records_size.ValueOrDie())) {
-      LOG(ERROR) << "failed to read records";
+  reports.reserve(records.size());
+  for (const auto& record : records) {
+    if (record.file_path_index >= string_table.size() ||
+        record.id_index >= string_table.size()) {
+      LOG(ERROR) << "invalid string table index";
       return;
     }
+    reports.push_back(ReportDisk(record, report_dir_, string_table));
+  }
 
-    std::string string_table = ReadRestOfFileAsString(handle_.get());
-    if (string_table.empty() || string_table.back() != '\0') {
-      LOG(ERROR) << "bad string table";
-      return;
+  // An invalid entry is most likely the result of an append that was
+  // interrupted. The entries before it are kept, and the file is compacted the
+  // next time it is written so that later entries are not appended after it.
+  bool journal_valid = true;
+  size_t journal_entries = 0;
+  size_t offset = 0;
+  while (offset < journal.size()) {
+    if (!ApplyJournalEntry(journal, &offset, &reports)) {
+      LOG(ERROR) << "invalid journal entry";
+      journal_valid = false;
+      break;
     }
+    ++journal_entries;
+  }
+
+  for (auto& report_disk : reports) {
+    report_disk.total_size = GetFileSize(report_disk.file_path);
+    base::FilePath report_attachment_dir =
+        attachments_dir_.Append(report_disk.uuid.ToWString());
+    report_disk.total_size += GetDirectorySize(report_attachment_dir);
+  }
+
+  reports_.swap(reports);
+  journal_entries_ = journal_entries;
+  needs_compaction_ = header.version != kMetadataFileVersion || !journal_valid;
+}
 
-    for (const auto& record : records) {
-      if (record.file_path_index >= string_table.size() ||
+bool Metadata::ApplyJournalEntry(const std::string& journal,
+                                 size_t* offset,
+                                 std::vector<ReportDisk>* reports) const {
+  MetadataJournalEntryHeader entry;
+  if (journal.size() - *offset < sizeof(entry)) {
+    return false;
+  }
+  memcpy(&entry, &journal[*offset], sizeof(entry));
+  if (entry.magic != kMetadataJournalEntryMagic) {
+    return false;
+  }
+
+  size_t position = *offset + sizeof(entry);
+  const size_t remaining = journal.size() - position;
+  switch (entry.type) {
+    case kJournalEntryUpsert: {
+      MetadataFileReportRecord record;
+      if (remaining < sizeof(record) ||
+          remaining - sizeof(record) < entry.string_table_size) {
+        return false;
+      }
+      memcpy(&record, &journal[position], sizeof(record));
+      position += sizeof(record);
+
+      const std::string string_table =
+          journal.substr(position, entry.string_table_size);
+      if (string_table.empty() || string_table.back() != '\0' ||
+          record.file_path_index >= string_table.size() ||
           record.id_index >= string_table.size()) {
-        LOG(ERROR) << "invalid string table index";
-        return;
+        return false;
       }
+      position += string_table.size();
+
       ReportDisk report_disk(record, report_dir_, string_table);
+      auto report_iter = std::find_if(
+          reports->begin(),
+          reports->end(),
+          [&report_disk](const ReportDisk& report) {
+            return report.uuid == report_disk.uuid;
+          });
+      if (report_iter == reports->end()) {
+        reports->push_back(report_disk);
+      } else {
+        *report_iter = report_disk;
+      }
+      break;
+    }
 
-      report_disk.total_size = GetFileSize(report_disk.file_path);
-      base::FilePath report_attachment_dir =
-          attachments_dir_.Append(report_disk.uuid.ToWString());
-      report_disk.total_size += GetDirectorySize(report_attachment_dir);
-      reports.push_back(report_disk);
+    case kJournalEntryDelete: {
+      UUID uuid;
+      if (remaining < sizeof(uuid)) {
+        return false;
+      }
+      memcpy(&uuid, &journal[position], sizeof(uuid));
+      position += sizeof(uuid);
+
+      auto report_iter = std::find_if(
+          reports->begin(), reports->end(), [uuid](const ReportDisk& report) {
+            return report.uuid == uuid;
+          });
+      if (report_iter != reports->end()) {
+        reports->erase(report_iter);
+      }
+      break;
     }
+
+    default:
+      return false;
   }
-  reports_.swap(reports);
+
+  *offset = position;
+  return true;
 }
 
 void Metadata::Write() {
+  // Build the records and string table before touching the file, so that an
+  // invalid report doesn’t leave a truncated file behind.
+  std::string string_table;
+  std::vector<MetadataFileReportRecord> records;
+  records.reserve(reports_.size());
+  for (const auto& report : reports_) {
+    const base::FilePath& path = report.file_path;
+    if (path.DirName() != report_dir_) {
+      LOG(ERROR) << path << " expected to start with " << report_dir_;
+      return;
+    }
+    records.push_back(MetadataFileReportRecord(report, &string_table));
+  }
+
   if (!Rewind()) {
     LOG(ERROR) << "failed to rewind to write";
     return;
@@ -524,34 +714,20 @@ void Metadata::Write() {
     return;
   }
 
-  size_t num_records = reports_.size();
-
   // Fill and write out the header.
   MetadataFileHeader header = {0};
   header.magic = kMetadataFileHeaderMagic;
   header.version = kMetadataFileVersion;
-  header.num_records = base::checked_cast<uint32_t>(num_records);
+  header.num_records = base::checked_cast<uint32_t>(records.size());
+  header.string_table_size = base::checked_cast<uint32_t>(string_table.size());
   if (!LoggingWriteFile(handle_.get(), &header, sizeof(header))) {
     LOG(ERROR) << "failed to write header";
     return;
   }
 
-  if (num_records == 0)
+  if (records.empty())
     return;
 
-  // Build the records and string table we're going to write.
-  std::string string_table;
-  std::vector<MetadataFileReportRecord> records;
-  records.reserve(num_records);
-  for (const auto& report : reports_) {
-    const base::FilePath& path = report.file_path;
-    if (path.DirName() != report_dir_) {
-      LOG(ERROR) << path << " expected to start with " << report_dir_;
-      return;
-    }
-    records.push_back(MetadataFileReportRecord(report, &string_table));
-  }
-
   if (!LoggingWriteFile(handle_.get(),
                         &records[0],
                         records.size() * sizeof(MetadataFileReportRecord))) {
@@ -565,6 +741,51 @@ void Metadata::Write() {
   }
 }
 
+void Metadata::AppendJournalEntries() {
+  // All entries are written with a single write, so that they are more likely
+  // to be applied together.
+  std::string entries;
+  for (const UUID& uuid : dirty_uuids_) {
+    MetadataJournalEntryHeader entry = {0};
+    entry.magic = kMetadataJournalEntryMagic;
+
+    auto report_iter = std::find_if(
+        reports_.begin(), reports_.end(), [uuid](const ReportDisk& report) {
+          return report.uuid == uuid;
+        });
+    if (report_iter == reports_.end()) {
+      entry.type = kJournalEntryDelete;
+      entries.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+      entries.append(reinterpret_cast<const char*>(&uuid), sizeof(uuid));
+      continue;
+    }
+
+    const base::FilePath& path = report_iter->file_path;
+    if (path.DirName() != report_dir_) {
+      LOG(ERROR) << path << " expected to start with " << report_dir_;
+      return;
+    }
+
+    std::string string_table;
+    MetadataFileReportRecord record(*report_iter, &string_table);
+    entry.type = kJournalEntryUpsert;
+    entry.string_table_size =
+        base::checked_cast<uint32_t>(string_table.size());
+    entries.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    entries.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    entries.append(string_table);
+  }
+
+  if (LoggingSeekFile(handle_.get(), 0, SEEK_END) < 0) {
+    LOG(ERROR) << "failed to seek to append";
+    return;
+  }
+  if (!LoggingWriteFile(handle_.get(), entries.data(), entries.size())) {
+    LOG(ERROR) << "failed to write journal";
+    return;
+  }
+}
+
 // static
 OperationStatus Metadata::VerifyReportAnyState(const ReportDisk& report_disk) {
   DWORD fileattr = GetFileAttributes(report_disk.file_path.value().c_str());
@@ -736,6 +957,10 @@ OperationStatus CrashReportDatabaseWin::FinishedWritingCrashReport(
     UUID* uuid) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  if (!report->FinishCompression()) {
+    return kFileSystemError;
+  }
+
   std::unique_ptr<Metadata> metadata(AcquireMetadata());
   if (!metadata)
     return kDatabaseError;
@@ -43,6 +43,8 @@
 #endif
 
 #if BUILDFLAG(IS_IOS)
+#include <sys/qos.h>
+
 #include "client/upload_behavior_ios.h"
 #endif
 
@@ -349,6 +351,54 @@ class CrashpadClient {
       const std::map<std::string, std::string>& annotations,
       const std::vector<std::string>& arguments,
       int socket);
+
+  //! \brief Starts an idle handler process by loading it with
+  //!     `/system/bin/linker`, to be woken in response to a crash.
+  //!
+  //! This is an alternative to StartHandlerWithLinkerAtCrash() for devices
+  //! where loading and relocating \a handler_library after a crash takes too
+  //! long. The library is loaded immediately instead, and the handler waits
+  //! as described for StartStandbyHandler().
+  //!
+  //! This method is only supported by Android Q+.
+  //!
+  //! \param[in] handler_trampoline The path to a Crashpad handler trampoline
+  //!     executable, possibly located within an apk, e.g.
+  //!     "/data/app/myapk.apk!/myabi/libcrashpad_handler_trampoline.so".
+  //! \param[in] handler_library The name of a library exporting the symbol
+  //!     `CrashpadHandlerMain()`. The path to this library must be present in
+  //!     `LD_LIBRARY_PATH`.
+  //! \param[in] is_64_bit `true` if \a handler_trampoline and \a
+  //!     handler_library are 64-bit objects. They must have the same bitness.
+  //! \param[in] env A vector of environment variables of the form `var=value`
+  //!     defining the environment in which to execute `linker`. If this value
+  //!     is `nullptr`, the application's current environment will be used.
+  //! \param[in] database The path to a Crashpad database. The handler will be
+  //!     started with this path as its `--database` argument.
+  //! \param[in] metrics_dir The path to an already existing directory where
+  //!     metrics files can be stored. The handler will be started with this
+  //!     path as its `--metrics-dir` argument.
+  //! \param[in] url The URL of an upload server. The handler will be started
+  //!     with this URL as its `--url` argument.
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //!     The handler will be started with an `--annotation` argument for each
+  //!     element in this map.
+  //! \param[in] arguments Additional arguments to pass to the Crashpad handler.
+  //!     Arguments passed in other parameters and arguments required to perform
+  //!     the handshake are the responsibility of this method, and must not be
+  //!     specified in this parameter.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool StartStandbyHandlerWithLinker(
+      const std::string& handler_trampoline,
+      const std::string& handler_library,
+      bool is_64_bit,
+      const std::vector<std::string>* env,
+      const base::FilePath& database,
+      const base::FilePath& metrics_dir,
+      const std::string& url,
+      const std::map<std::string, std::string>& annotations,
+      const std::vector<std::string>& arguments);
 #endif  // BUILDFLAG(IS_ANDROID) || DOXYGEN
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_CHROMEOS) || \
@@ -384,6 +434,94 @@ class CrashpadClient {
       const std::vector<std::string>& arguments,
       const std::vector<base::FilePath>& attachments = {});
 
+  //! \brief Starts an idle handler process to be woken in response to a crash.
+  //!
+  //! This is an alternative to StartHandlerAtCrash() for processes where the
+  //! time to start a handler after a crash is too long, but a handler that
+  //! performs the periodic tasks of StartHandler() is too expensive. The
+  //! handler is started immediately with a private connection to this process
+  //! and periodic tasks disabled, and waits on that connection. On a crash, the
+  //! signal handler requests a dump over the connection instead of launching a
+  //! handler, so capture begins as soon as the request is received. The handler
+  //! exits when this process does, after writing the crash dump, if any.
+  //!
+  //! The connection serves one process at a time. Processes forked from this
+  //! one inherit it, and a crash in one of them is only handled once any dump
+  //! already requested over the connection is complete.
+  //!
+  //! \param[in] handler The path to a Crashpad handler executable.
+  //! \param[in] database The path to a Crashpad database. The handler will be
+  //!     started with this path as its `--database` argument.
+  //! \param[in] metrics_dir The path to an already existing directory where
+  //!     metrics files can be stored. The handler will be started with this
+  //!     path as its `--metrics-dir` argument.
+  //! \param[in] url The URL of an upload server. The handler will be started
+  //!     with this URL as its `--url` argument.
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //!     The handler will be started with an `--annotation` argument for each
+  //!     element in this map.
+  //! \param[in] arguments Additional arguments to pass to the Crashpad handler.
+  //!     Arguments passed in other parameters and arguments required to perform
+  //!     the handshake are the responsibility of this method, and must not be
+  //!     specified in this parameter.
+  //! \param[in] attachments Vector that stores file paths that should be
+  //!     captured with each report at the time of the crash.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool StartStandbyHandler(
+      const base::FilePath& handler,
+      const base::FilePath& database,
+      const base::FilePath& metrics_dir,
+      const std::string& url,
+      const std::map<std::string, std::string>& annotations,
+      const std::vector<std::string>& arguments,
+      const std::vector<base::FilePath>& attachments = {});
+
+  //! \brief Installs a signal handler that writes a limited crash dump from
+  //!     within this process, without any handler process.
+  //!
+  //! This is an alternative to starting a handler for processes, such as
+  //! short-lived command-line tools, that can’t afford to keep one running and
+  //! can accept dumps of lower fidelity. On a crash, the signal handler
+  //! captures the crashing thread’s registers and the top of its stack, the
+  //! ELF modules loaded from files, and the string annotations, into an arena
+  //! allocated by this call. The dump is written in an intermediate format
+  //! beneath \a database, and is converted to a crash report in \a database
+  //! by a later call to ConvertInProcessDumps(), which is in the
+  //! `client:in_process_dump_converter` library. Reports aren’t uploaded until
+  //! a handler is run with \a database.
+  //!
+  //! This is only supported on x86_64 and ARM64.
+  //!
+  //! \param[in] database The path to a Crashpad database.
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool StartInProcessHandler(
+      const base::FilePath& database,
+      const std::map<std::string, std::string>& annotations);
+
+  //! \brief Arranges for the installed signal handler to write a dump from
+  //!     within this process when its handler can’t be reached.
+  //!
+  //! The dump is the same as that written by StartInProcessHandler(), and is
+  //! written if a handler launched at crash fails, or if a handler that this
+  //! process requests dumps from over a socket doesn’t respond, for example
+  //! because it hasn’t been started yet, has exited, or is blocked by a
+  //! sandbox. As with StartInProcessHandler(), the dumps are converted to
+  //! crash reports by ConvertInProcessDumps().
+  //!
+  //! This may be called before or after a handler is installed, and takes
+  //! effect for any handler.
+  //!
+  //! \param[in] database The path to a Crashpad database.
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  static bool EnableInProcessFallback(
+      const base::FilePath& database,
+      const std::map<std::string, std::string>& annotations);
+
   //! \brief Starts a handler process with an initial client.
   //!
   //! This method allows a process to launch the handler process on behalf of
@@ -429,6 +567,112 @@ class CrashpadClient {
   //!     CaptureContext() or similar.
   static void DumpWithoutCrash(NativeCPUContext* context);
 
+  //! \brief Requests that the handler capture a lightweight dump, holding only
+  //!     the calling thread and the annotations that have changed since the
+  //!     last lightweight dump.
+  //!
+  //! This is meant for dumps taken in bursts, such as by a hang detector, in
+  //! which little changes from one dump to the next. The dump holds the
+  //! calling thread’s context and stack, the list of modules, and the
+  //! annotations in this module’s AnnotationList that have been set since the
+  //! last successful call, or all of them on the first. Other threads,
+  //! annotations, and memory are left out, as are the handler’s attachments and
+  //! user minidump streams. The report has the `"crashpad_report_type"` process
+  //! annotation set to `"lightweight"`. See Annotation::generation().
+  //!
+  //! A handler must have already been installed before calling this method.
+  //!
+  //! \param[in] context A NativeCPUContext, generally captured by
+  //!     CaptureContext() or similar.
+  static void DumpWithoutCrashLightweight(NativeCPUContext* context);
+
+  //! \brief Requests that the handler capture a dump even though there hasn't
+  //!     been a crash, without waiting for the dump to complete.
+  //!
+  //! \a context is copied and the request is made on a dedicated thread,
+  //! started by the first call, so that this method returns immediately. The
+  //! dump records \a context as the calling thread’s exception context. The
+  //! rest of the process, including the calling thread, is captured as it is
+  //! when the handler suspends it, which may be after this method returns. No
+  //! dump is written if the calling thread has exited by then.
+  //!
+  //! At most one request is outstanding at a time. Requests made while one is
+  //! outstanding, or within the interval set by
+  //! SetDumpWithoutCrashAsyncInterval() of the last accepted request, are
+  //! dropped.
+  //!
+  //! A handler must have already been installed before calling this method.
+  //!
+  //! \param[in] context A NativeCPUContext, generally captured by
+  //!     CaptureContext() or similar.
+  //!
+  //! \return `true` if the request was accepted. `false` if it was dropped or
+  //!     no handler is installed.
+  static bool DumpWithoutCrashAsync(NativeCPUContext* context);
+
+  //! \brief Sets the minimum interval between dumps requested by
+  //!     DumpWithoutCrashAsync().
+  //!
+  //! \param[in] seconds The minimum number of seconds between the starts of
+  //!     accepted requests. The default, `0`, only drops requests made while
+  //!     another is outstanding.
+  static void SetDumpWithoutCrashAsyncInterval(double seconds);
+
+  //! \brief Sets whether dumps requested by DumpWithoutCrash() and
+  //!     DumpWithoutCrashAsync() capture this process from a copy of itself.
+  //!
+  //! When enabled, the handler stops this process’s threads only while it
+  //! collects their registers and the requesting thread makes a copy of the
+  //! process with a `clone()` system call. The rest of the dump, including all
+  //! memory, is captured from the copy while the process continues to run. The
+  //! requesting thread still waits for the dump to complete, so this is best
+  //! combined with DumpWithoutCrashAsync(). If the copy can’t be made, this
+  //! process is captured directly.
+  //!
+  //! The copy is reaped by the requesting thread, and this process’s `SIGCHLD`
+  //! handler is replaced by the default action until it has been.
+  //!
+  //! This only takes effect with a handler started by StartStandbyHandler(),
+  //! which has a private connection to this process. Other handlers capture
+  //! this process directly. Crashes are always captured directly.
+  //!
+  //! \param[in] enabled Whether to capture dumps without crashes from a copy.
+  static void SetDumpWithoutCrashUsesForkSnapshot(bool enabled);
+
+  //! \brief Sets the tenant of the handler that this process’s reports belong
+  //!     to.
+  //!
+  //! A handler started with `--tenant` hosts several crash report databases,
+  //! each with its own upload URL, and writes a client’s reports to the
+  //! database of the client’s tenant. Tenant `0`, the default, is the
+  //! handler’s `--database`, and each `--tenant` is numbered after it, in
+  //! order, from `1`. A handler without the tenant uses its `--database`.
+  //!
+  //! This only takes effect with handlers that this process requests dumps
+  //! from over a socket, such as those started by StartHandler() or
+  //! StartStandbyHandler(), or set by SetHandlerSocket().
+  //!
+  //! \param[in] tenant The tenant.
+  static void SetHandlerTenant(uint32_t tenant);
+
+  //! \brief Enables copying the memory that describes a crash into a region
+  //!     shared with the handler before requesting a dump.
+  //!
+  //! When enabled, the signal handler copies the crash’s `siginfo_t` and
+  //! `ucontext_t` into the region and sends it along with its request. The
+  //! handler then reads them with a single read instead of from this process,
+  //! saving several accesses to this process’s memory. The region is created
+  //! by this call, so nothing is allocated at crash time. Each region is
+  //! sealed when it’s sent, and a new one is created after each dump taken
+  //! without a crash. This fails where memory files can’t be sealed.
+  //!
+  //! This only takes effect with handlers that this process requests dumps
+  //! from over a socket, such as those started by StartHandler() or
+  //! StartStandbyHandler(), or set by SetHandlerSocket().
+  //!
+  //! \return `true` on success. `false` on failure with a message logged.
+  static bool EnableSharedCrashContext();
+
   //! \brief Disables any installed crash handler, not including any
   //!     FirstChanceHandler and crashes the current process.
   //!
@@ -532,6 +776,25 @@ class CrashpadClient {
   static void ProcessIntermediateDumps(
       const std::map<std::string, std::string>& annotations = {});
 
+  //! \brief Requests that the handler convert intermediate dumps into
+  //!     minidumps, converting several at once, and trigger an upload if
+  //!     possible.
+  //!
+  //! This behaves like ProcessIntermediateDumps(), but converts up to \a
+  //! max_concurrency dumps at a time on a global dispatch queue of \a
+  //! qos_class. This shortens the time needed to recover from a crash loop
+  //! that has left many intermediate dumps pending. Processing will block
+  //! until all dumps are converted, so this should not be called on the main UI
+  //! thread.
+  //!
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //! \param[in] max_concurrency The maximum number of dumps to convert at once.
+  //! \param[in] qos_class The quality of service class of the conversions.
+  static void ProcessIntermediateDumpsConcurrently(
+      const std::map<std::string, std::string>& annotations,
+      size_t max_concurrency,
+      qos_class_t qos_class = QOS_CLASS_UTILITY);
+
   //! \brief Requests that the handler convert a single intermediate dump at \a
   //!     file generated by DumpWithoutCrashAndDeferProcessingAtPath into a
   //!     minidump and trigger an upload if possible.
@@ -123,6 +123,14 @@ class CrashHandler : public Thread,
     in_process_handler_.ProcessIntermediateDumps(annotations);
   }
 
+  void ProcessIntermediateDumpsConcurrently(
+      const std::map<std::string, std::string>& annotations,
+      size_t max_concurrency,
+      qos_class_t qos_class) {
+    in_process_handler_.ProcessIntermediateDumpsConcurrently(
+        annotations, max_concurrency, qos_class);
+  }
+
   void ProcessIntermediateDump(
       const base::FilePath& file,
       const std::map<std::string, std::string>& annotations) {
@@ -429,6 +437,17 @@ void CrashpadClient::ProcessIntermediateDumps(
   crash_handler->ProcessIntermediateDumps(annotations);
 }
 
+// static
+void CrashpadClient::ProcessIntermediateDumpsConcurrently(
+    const std::map<std::string, std::string>& annotations,
+    size_t max_concurrency,
+    qos_class_t qos_class) {
+  CrashHandler* crash_handler = CrashHandler::Get();
+  DCHECK(crash_handler);
+  crash_handler->ProcessIntermediateDumpsConcurrently(
+      annotations, max_concurrency, qos_class);
+}
+
 // static
 void CrashpadClient::ProcessIntermediateDump(
     const base::FilePath& file,
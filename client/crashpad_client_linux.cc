@@ -20,7 +20,6 @@
 #include <linux/futex.h>
 #include <pthread.h>
 #include <stdlib.h>
-#include <sys/mman.h>
 #include <sys/prctl.h>
 #include <sys/socket.h>
 #include <sys/syscall.h>
@@ -29,13 +28,19 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <memory>
 
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
+#include "client/annotation_list.h"
 #include "client/client_argv_handling.h"
+#include "client/crash_report_database.h"
+#include "client/in_process_dump_writer_linux.h"
+#include "client/signal_stack_pool_linux.h"
 #include "third_party/lss/lss.h"
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
@@ -43,12 +48,14 @@
 #include "util/linux/exception_information.h"
 #include "util/linux/scoped_pr_set_dumpable.h"
 #include "util/linux/scoped_pr_set_ptracer.h"
+#include "util/linux/shared_crash_context.h"
 #include "util/linux/socket.h"
-#include "util/misc/address_sanitizer.h"
+#include "util/misc/clock.h"
 #include "util/misc/from_pointer_cast.h"
-#include "util/posix/scoped_mmap.h"
 #include "util/posix/signals.h"
 #include "util/posix/spawn_subprocess.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -134,6 +141,30 @@ std::vector<std::string> BuildArgsToLaunchWithLinker(
 
 using LastChanceHandler = bool (*)(int, siginfo_t*, ucontext_t*);
 
+// The siginfo_t::si_code of a simulated crash requested by
+// CrashpadClient::DumpWithoutCrashLightweight().
+constexpr int kLightweightDumpCode = 1;
+
+// Prepares a writer for this process’s in-process dumps beneath database. They
+// are converted to crash reports by ConvertInProcessDumps(), which is in a
+// separate library.
+bool InitializeInProcessDumps(
+    const base::FilePath& database,
+    const std::map<std::string, std::string>& annotations,
+    internal::InProcessDumpWriter* writer) {
+  // Create the database, if it doesn’t exist already, to hold the dump
+  // directory.
+  if (!CrashReportDatabase::Initialize(database)) {
+    return false;
+  }
+  const base::FilePath dump_dir =
+      database.Append(internal::kInProcessDumpDirectory);
+  if (!LoggingCreateDirectory(dump_dir, FilePermissions::kOwnerOnly, true)) {
+    return false;
+  }
+  return writer->Initialize(dump_dir, annotations);
+}
+
 // A base class for Crashpad signal handler implementations.
 class SignalHandler {
  public:
@@ -161,19 +192,37 @@ class SignalHandler {
     last_chance_handler_ = handler;
   }
 
+  // Sets the writer used when the handler can’t be reached. This applies to
+  // any signal handler, including those installed later.
+  static void SetInProcessFallback(internal::InProcessDumpWriter* writer) {
+    in_process_fallback_ = writer;
+  }
+
   // The base implementation for all signal handlers, suitable for calling
   // directly to simulate signal delivery.
   void HandleCrash(int signo, siginfo_t* siginfo, void* context) {
+    HandleCrashForThread(signo, siginfo, context, sys_gettid());
+  }
+
+  // Like HandleCrash(), but reports the exception as having occurred on the
+  // thread thread_id, which need not be the calling thread.
+  void HandleCrashForThread(int signo,
+                            siginfo_t* siginfo,
+                            void* context,
+                            pid_t thread_id) {
     exception_information_.siginfo_address =
         FromPointerCast<decltype(exception_information_.siginfo_address)>(
             siginfo);
     exception_information_.context_address =
         FromPointerCast<decltype(exception_information_.context_address)>(
             context);
-    exception_information_.thread_id = sys_gettid();
+    exception_information_.thread_id = thread_id;
 
     ScopedPrSetDumpable set_dumpable(false);
-    HandleCrashImpl();
+    if (!HandleCrashImpl() && in_process_fallback_) {
+      in_process_fallback_->WriteDump(
+          siginfo, static_cast<const ucontext_t*>(context), thread_id);
+    }
   }
 
  protected:
@@ -197,7 +246,8 @@ class SignalHandler {
     return exception_information_;
   }
 
-  virtual void HandleCrashImpl() = 0;
+  // Returns false if the handler couldn’t be reached to write a dump.
+  virtual bool HandleCrashImpl() = 0;
 
  private:
   static constexpr int32_t kDumpNotDone = 0;
@@ -276,8 +326,10 @@ class SignalHandler {
 #endif
 
   static SignalHandler* handler_;
+  static internal::InProcessDumpWriter* in_process_fallback_;
 };
 SignalHandler* SignalHandler::handler_ = nullptr;
+internal::InProcessDumpWriter* SignalHandler::in_process_fallback_ = nullptr;
 
 // Launches a single use handler to snapshot this process.
 class LaunchAtCrashHandler : public SignalHandler {
@@ -308,12 +360,12 @@ class LaunchAtCrashHandler : public SignalHandler {
     return Install(unhandled_signals);
   }
 
-  void HandleCrashImpl() override {
+  bool HandleCrashImpl() override {
     ScopedPrSetPtracer set_ptracer(sys_getpid(), /* may_log= */ false);
 
     pid_t pid = fork();
     if (pid < 0) {
-      return;
+      return false;
     }
     if (pid == 0) {
       if (set_envp_) {
@@ -327,7 +379,8 @@ class LaunchAtCrashHandler : public SignalHandler {
     }
 
     int status;
-    waitpid(pid, &status, 0);
+    return waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+           WEXITSTATUS(status) == EXIT_SUCCESS;
   }
 
  private:
@@ -360,10 +413,13 @@ class RequestCrashDumpHandler : public SignalHandler {
   // created the namespace.
   // pid > 0 directly indicates what the handler's pid is expected to be, so
   // retrieving this information from the handler is not necessary.
+  // multiple_clients indicates whether sock is a shared connection, as for
+  // ExceptionHandlerServer::InitializeWithClient().
   bool Initialize(ScopedFileHandle sock,
                   pid_t pid,
+                  bool multiple_clients,
                   const std::set<int>* unhandled_signals) {
-    ExceptionHandlerClient client(sock.get(), true);
+    ExceptionHandlerClient client(sock.get(), multiple_clients);
     if (pid < 0) {
       ucred creds;
       if (!client.GetHandlerCredentials(&creds)) {
@@ -379,6 +435,7 @@ class RequestCrashDumpHandler : public SignalHandler {
     }
     sock_to_handler_.reset(sock.release());
     handler_pid_ = pid;
+    multiple_clients_ = multiple_clients;
     return Install(unhandled_signals);
   }
 
@@ -395,7 +452,7 @@ class RequestCrashDumpHandler : public SignalHandler {
     return true;
   }
 
-  void HandleCrashImpl() override {
+  bool HandleCrashImpl() override {
     // Attempt to set the ptracer again, in case a crash occurs after a fork,
     // before SetPtracerAtFork() has been called. Ignore errors because the
     // system call may be disallowed if the sandbox is engaged.
@@ -406,12 +463,59 @@ class RequestCrashDumpHandler : public SignalHandler {
     ExceptionHandlerProtocol::ClientInformation info = {};
     info.exception_information_address =
         FromPointerCast<VMAddress>(&GetExceptionInfo());
+    const siginfo_t* siginfo = reinterpret_cast<const siginfo_t*>(
+        static_cast<uintptr_t>(GetExceptionInfo().siginfo_address));
+    const bool simulated = siginfo->si_signo == Signals::kSimulatedSigno;
+
+    // A lightweight dump asks for the annotations changed since the last one
+    // that was written. It’s cheap to capture directly, so it’s never taken
+    // from a copy of the process.
+    const AnnotationList* annotation_list = nullptr;
+    uint32_t annotation_generation = 0;
+    if (simulated && siginfo->si_code == kLightweightDumpCode) {
+      info.lightweight = ExceptionHandlerProtocol::kBoolTrue;
+      annotation_list = AnnotationList::Get();
+      if (annotation_list) {
+        annotation_generation = annotation_list->generation();
+        info.annotation_list_address =
+            FromPointerCast<VMAddress>(annotation_list);
+        info.annotation_generation =
+            lightweight_annotation_generation_.load(std::memory_order_relaxed);
+      }
+    } else if (simulated && fork_snapshot_simulated_crashes_) {
+      info.fork_snapshot = ExceptionHandlerProtocol::kBoolTrue;
+    }
 #if BUILDFLAG(IS_CHROMEOS_ASH)
     info.crash_loop_before_time = crash_loop_before_time_;
 #endif
+    info.tenant = tenant_;
+
+    ExceptionHandlerClient client(sock_to_handler_.get(), multiple_clients_);
+    const bool replace_shared_context = shared_context_ && simulated;
+    if (shared_context_ && CopyCrashContext()) {
+      client.SetSharedCrashContext(shared_context_.get());
+    }
+    const int result = client.RequestCrashDump(info);
+
+    // The region was sealed to be sent, so the next dump needs a new one. A
+    // simulated crash isn’t handled in a signal handler, so one can be made
+    // now. If that fails, later dumps are requested without one.
+    if (replace_shared_context) {
+      shared_context_.reset();
+      EnableSharedCrashContext();
+    }
 
-    ExceptionHandlerClient client(sock_to_handler_.get(), true);
-    client.RequestCrashDump(info);
+    if (result != 0) {
+      return false;
+    }
+
+    // Annotations changed while the dump was being taken may already be in it,
+    // and are captured again by the next lightweight dump.
+    if (annotation_list) {
+      lightweight_annotation_generation_.store(annotation_generation,
+                                               std::memory_order_relaxed);
+    }
+    return true;
   }
 
 #if BUILDFLAG(IS_CHROMEOS_ASH)
@@ -420,11 +524,55 @@ class RequestCrashDumpHandler : public SignalHandler {
   }
 #endif
 
+  void SetForkSnapshotSimulatedCrashes(bool enabled) {
+    fork_snapshot_simulated_crashes_ = enabled;
+  }
+
+  void SetTenant(uint32_t tenant) { tenant_ = tenant; }
+
+  bool EnableSharedCrashContext() {
+    if (shared_context_) {
+      return true;
+    }
+    auto shared_context = std::make_unique<SharedCrashContext>();
+    if (!shared_context->Initialize()) {
+      return false;
+    }
+    shared_context_ = std::move(shared_context);
+    return true;
+  }
+
  private:
   RequestCrashDumpHandler() = default;
 
   ~RequestCrashDumpHandler() = delete;
 
+  // Copies the memory the handler reads to describe the crash into
+  // shared_context_, and seals it to be sent to the handler.
+  bool CopyCrashContext() {
+    const ExceptionInformation& exception_info = GetExceptionInfo();
+    const auto* siginfo = reinterpret_cast<const siginfo_t*>(
+        static_cast<uintptr_t>(exception_info.siginfo_address));
+    const auto* context = reinterpret_cast<const ucontext_t*>(
+        static_cast<uintptr_t>(exception_info.context_address));
+
+    shared_context_->Reset();
+    if (!shared_context_->AddRange(&exception_info, sizeof(exception_info)) ||
+        !shared_context_->AddRange(siginfo, sizeof(*siginfo)) ||
+        !shared_context_->AddRange(context, sizeof(*context))) {
+      return false;
+    }
+#if defined(ARCH_CPU_X86_FAMILY)
+    // The floating point state is stored outside of the ucontext_t.
+    if (context->uc_mcontext.fpregs &&
+        !shared_context_->AddRange(context->uc_mcontext.fpregs,
+                                   sizeof(*context->uc_mcontext.fpregs))) {
+      return false;
+    }
+#endif  // ARCH_CPU_X86_FAMILY
+    return shared_context_->Seal();
+  }
+
   static void SetPtracerAtFork() {
     auto handler = RequestCrashDumpHandler::Get();
     if (handler->handler_pid_ > 0 &&
@@ -435,6 +583,13 @@ class RequestCrashDumpHandler : public SignalHandler {
 
   ScopedFileHandle sock_to_handler_;
   pid_t handler_pid_ = -1;
+  bool multiple_clients_ = true;
+  bool fork_snapshot_simulated_crashes_ = false;
+  uint32_t tenant_ = 0;
+
+  // The AnnotationList generation at the last lightweight dump.
+  std::atomic<uint32_t> lightweight_annotation_generation_{0};
+  std::unique_ptr<SharedCrashContext> shared_context_;
 
 #if BUILDFLAG(IS_CHROMEOS_ASH)
   // An optional UNIX timestamp passed to us from Chrome.
@@ -445,6 +600,159 @@ class RequestCrashDumpHandler : public SignalHandler {
 #endif
 };
 
+// Writes dumps from within this process, for processes without a handler.
+class InProcessHandler : public SignalHandler {
+ public:
+  InProcessHandler(const InProcessHandler&) = delete;
+  InProcessHandler& operator=(const InProcessHandler&) = delete;
+
+  static InProcessHandler* Get() {
+    static InProcessHandler* instance = new InProcessHandler();
+    return instance;
+  }
+
+  bool Initialize(const base::FilePath& database,
+                  const std::map<std::string, std::string>& annotations,
+                  const std::set<int>* unhandled_signals) {
+    return InitializeInProcessDumps(database, annotations, &writer_) &&
+           Install(unhandled_signals);
+  }
+
+  bool HandleCrashImpl() override {
+    const ExceptionInformation& exception_info = GetExceptionInfo();
+    writer_.WriteDump(
+        reinterpret_cast<const siginfo_t*>(
+            static_cast<uintptr_t>(exception_info.siginfo_address)),
+        reinterpret_cast<const ucontext_t*>(
+            static_cast<uintptr_t>(exception_info.context_address)),
+        exception_info.thread_id);
+
+    // There’s nothing further to fall back to.
+    return true;
+  }
+
+ private:
+  InProcessHandler() = default;
+
+  ~InProcessHandler() = delete;
+
+  internal::InProcessDumpWriter writer_;
+};
+
+void DumpWithoutCrashForThread(NativeCPUContext* context,
+                               pid_t thread_id,
+                               bool lightweight) {
+#if defined(ARCH_CPU_ARMEL)
+  memset(context->uc_regspace, 0, sizeof(context->uc_regspace));
+#elif defined(ARCH_CPU_ARM64)
+  memset(context->uc_mcontext.__reserved,
+         0,
+         sizeof(context->uc_mcontext.__reserved));
+#endif
+
+  siginfo_t siginfo;
+  siginfo.si_signo = Signals::kSimulatedSigno;
+  siginfo.si_errno = 0;
+  siginfo.si_code = lightweight ? kLightweightDumpCode : 0;
+  SignalHandler::Get()->HandleCrashForThread(siginfo.si_signo,
+                                             &siginfo,
+                                             reinterpret_cast<void*>(context),
+                                             thread_id);
+}
+
+// Makes the requests for CrashpadClient::DumpWithoutCrashAsync() on its own
+// thread, so that requesting threads don't wait for the handler.
+class AsyncDumpWithoutCrashThread final : public Thread {
+ public:
+  AsyncDumpWithoutCrashThread(const AsyncDumpWithoutCrashThread&) = delete;
+  AsyncDumpWithoutCrashThread& operator=(const AsyncDumpWithoutCrashThread&) =
+      delete;
+
+  static AsyncDumpWithoutCrashThread* Get() {
+    static AsyncDumpWithoutCrashThread* instance =
+        new AsyncDumpWithoutCrashThread();
+    return instance;
+  }
+
+  void SetInterval(double seconds) {
+    base::AutoLock auto_lock(lock_);
+    interval_ns_ = static_cast<uint64_t>(seconds * 1E9);
+  }
+
+  bool Request(const NativeCPUContext& context) {
+    base::AutoLock auto_lock(lock_);
+    if (busy_) {
+      return false;
+    }
+
+    const uint64_t now_ns = ClockMonotonicNanoseconds();
+    if (last_request_ns_ != 0 && now_ns - last_request_ns_ < interval_ns_) {
+      return false;
+    }
+    last_request_ns_ = now_ns;
+
+    // context_ and thread_id_ belong to the dump thread until it clears busy_.
+    busy_ = true;
+    context_ = context;
+    thread_id_ = sys_gettid();
+
+    if (!started_) {
+      Start();
+      started_ = true;
+    }
+    semaphore_.Signal();
+    return true;
+  }
+
+ private:
+  AsyncDumpWithoutCrashThread()
+      : Thread(),
+        lock_(),
+        semaphore_(0),
+        context_(),
+        interval_ns_(0),
+        last_request_ns_(0),
+        thread_id_(0),
+        busy_(false),
+        started_(false) {}
+
+  ~AsyncDumpWithoutCrashThread() override = default;
+
+  // Thread:
+  void ThreadMain() override {
+    while (true) {
+      semaphore_.Wait();
+      DumpWithoutCrashForThread(&context_, thread_id_, false);
+
+      base::AutoLock auto_lock(lock_);
+      busy_ = false;
+    }
+  }
+
+  base::Lock lock_;
+  Semaphore semaphore_;
+  NativeCPUContext context_;
+  uint64_t interval_ns_;
+  uint64_t last_request_ns_;
+  pid_t thread_id_;
+  bool busy_;
+  bool started_;
+};
+
+// Installs a signal handler to request dumps from a standby handler started
+// with the other end of client_sock.
+bool InstallStandbyHandler(ScopedFileHandle client_sock,
+                           const std::set<int>* unhandled_signals) {
+  pid_t handler_pid = -1;
+  if (!IsRegularFile(base::FilePath("/proc/sys/kernel/yama/ptrace_scope"))) {
+    handler_pid = 0;
+  }
+
+  auto signal_handler = RequestCrashDumpHandler::Get();
+  return signal_handler->Initialize(
+      std::move(client_sock), handler_pid, false, unhandled_signals);
+}
+
 }  // namespace
 
 CrashpadClient::CrashpadClient() {}
@@ -486,7 +794,7 @@ bool CrashpadClient::StartHandler(
 
   auto signal_handler = RequestCrashDumpHandler::Get();
   return signal_handler->Initialize(
-      std::move(client_sock), handler_pid, &unhandled_signals_);
+      std::move(client_sock), handler_pid, true, &unhandled_signals_);
 }
 
 #if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
@@ -498,7 +806,8 @@ bool CrashpadClient::GetHandlerSocket(int* sock, pid_t* pid) {
 
 bool CrashpadClient::SetHandlerSocket(ScopedFileHandle sock, pid_t pid) {
   auto signal_handler = RequestCrashDumpHandler::Get();
-  return signal_handler->Initialize(std::move(sock), pid, &unhandled_signals_);
+  return signal_handler->Initialize(
+      std::move(sock), pid, true, &unhandled_signals_);
 }
 
 // static
@@ -511,39 +820,24 @@ bool CrashpadClient::InitializeSignalStackForThread() {
 
   DCHECK_EQ(stack.ss_flags & SS_ONSTACK, 0);
 
-  const size_t page_size = getpagesize();
-#if defined(ADDRESS_SANITIZER)
-  const size_t kStackSize = 2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
-#else
-  const size_t kStackSize = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
-#endif  // ADDRESS_SANITIZER
+  // Stacks come from a pool so that threads that come and go quickly don't
+  // each map and unmap one.
+  SignalStackPool* const pool = SignalStackPool::Get();
+  const size_t kStackSize = pool->stack_size();
   if (stack.ss_flags & SS_DISABLE || stack.ss_size < kStackSize) {
-    const size_t kGuardPageSize = page_size;
-    const size_t kStackAllocSize = kStackSize + 2 * kGuardPageSize;
-
     static void (*stack_destructor)(void*) = [](void* stack_mem) {
-      const size_t page_size = getpagesize();
-      const size_t kGuardPageSize = page_size;
-#if defined(ADDRESS_SANITIZER)
-      const size_t kStackSize =
-          2 * ((SIGSTKSZ + page_size - 1) & ~(page_size - 1));
-#else
-      const size_t kStackSize = (SIGSTKSZ + page_size - 1) & ~(page_size - 1);
-#endif  // ADDRESS_SANITIZER
-      const size_t kStackAllocSize = kStackSize + 2 * kGuardPageSize;
-
       stack_t stack;
       stack.ss_flags = SS_DISABLE;
       if (sigaltstack(&stack, &stack) != 0) {
         PLOG(ERROR) << "sigaltstack";
-      } else if (stack.ss_sp !=
-                 static_cast<char*>(stack_mem) + kGuardPageSize) {
+        // The stack may still be installed, so it can't be reused.
+        return;
+      }
+      if (stack.ss_sp != stack_mem) {
         PLOG_IF(ERROR, sigaltstack(&stack, nullptr) != 0) << "sigaltstack";
       }
 
-      if (munmap(stack_mem, kStackAllocSize) != 0) {
-        PLOG(ERROR) << "munmap";
-      }
+      SignalStackPool::Get()->Free(stack_mem);
     };
 
     static pthread_key_t stack_key;
@@ -556,30 +850,16 @@ bool CrashpadClient::InitializeSignalStackForThread() {
       return false;
     }
 
-    auto old_stack = static_cast<char*>(pthread_getspecific(stack_key));
+    auto old_stack = pthread_getspecific(stack_key);
     if (old_stack) {
-      stack.ss_sp = old_stack + kGuardPageSize;
+      stack.ss_sp = old_stack;
     } else {
-      ScopedMmap stack_mem;
-      if (!stack_mem.ResetMmap(nullptr,
-                               kStackAllocSize,
-                               PROT_NONE,
-                               MAP_PRIVATE | MAP_ANONYMOUS,
-                               -1,
-                               0)) {
-        return false;
-      }
-
-      if (mprotect(stack_mem.addr_as<char*>() + kGuardPageSize,
-                   kStackSize,
-                   PROT_READ | PROT_WRITE) != 0) {
-        PLOG(ERROR) << "mprotect";
+      stack.ss_sp = pool->Allocate();
+      if (!stack.ss_sp) {
         return false;
       }
 
-      stack.ss_sp = stack_mem.addr_as<char*>() + kGuardPageSize;
-
-      errno = pthread_setspecific(stack_key, stack_mem.release());
+      errno = pthread_setspecific(stack_key, stack.ss_sp);
       PCHECK(errno == 0) << "pthread_setspecific";
     }
 
@@ -682,6 +962,44 @@ bool CrashpadClient::StartHandlerWithLinkerForClient(
   return SpawnSubprocess(argv, env, socket, false, nullptr);
 }
 
+bool CrashpadClient::StartStandbyHandlerWithLinker(
+    const std::string& handler_trampoline,
+    const std::string& handler_library,
+    bool is_64_bit,
+    const std::vector<std::string>* env,
+    const base::FilePath& database,
+    const base::FilePath& metrics_dir,
+    const std::string& url,
+    const std::map<std::string, std::string>& annotations,
+    const std::vector<std::string>& arguments) {
+  ScopedFileHandle client_sock, handler_sock;
+  if (!UnixCredentialSocket::CreateCredentialSocketpair(&client_sock,
+                                                        &handler_sock)) {
+    return false;
+  }
+
+  // The trampoline loads handler_library and enters the handler right away.
+  // The Android linker binds all symbols at load time, so nothing is left to
+  // resolve when the handler is woken by a crash.
+  std::vector<std::string> argv =
+      BuildArgsToLaunchWithLinker(handler_trampoline,
+                                  handler_library,
+                                  is_64_bit,
+                                  database,
+                                  metrics_dir,
+                                  url,
+                                  annotations,
+                                  arguments,
+                                  handler_sock.get());
+  argv.push_back("--no-periodic-tasks");
+  if (!SpawnSubprocess(argv, env, handler_sock.get(), false, nullptr)) {
+    return false;
+  }
+  handler_sock.reset();
+
+  return InstallStandbyHandler(std::move(client_sock), &unhandled_signals_);
+}
+
 #endif
 
 bool CrashpadClient::StartHandlerAtCrash(
@@ -699,6 +1017,55 @@ bool CrashpadClient::StartHandlerAtCrash(
   return signal_handler->Initialize(&argv, nullptr, &unhandled_signals_);
 }
 
+bool CrashpadClient::StartStandbyHandler(
+    const base::FilePath& handler,
+    const base::FilePath& database,
+    const base::FilePath& metrics_dir,
+    const std::string& url,
+    const std::map<std::string, std::string>& annotations,
+    const std::vector<std::string>& arguments,
+    const std::vector<base::FilePath>& attachments) {
+  ScopedFileHandle client_sock, handler_sock;
+  if (!UnixCredentialSocket::CreateCredentialSocketpair(&client_sock,
+                                                        &handler_sock)) {
+    return false;
+  }
+
+  std::vector<std::string> argv = BuildHandlerArgvStrings(
+      handler, database, metrics_dir, url, annotations, arguments, attachments);
+
+  // Without a shared connection, the handler exits once this process has
+  // closed its end of the socket, like a handler started at crash time. Like
+  // one, it also has no need to watch or prune the database in the meantime.
+  argv.push_back(FormatArgumentInt("initial-client-fd", handler_sock.get()));
+  argv.push_back("--no-periodic-tasks");
+  if (!SpawnSubprocess(argv, nullptr, handler_sock.get(), false, nullptr)) {
+    return false;
+  }
+  handler_sock.reset();
+
+  return InstallStandbyHandler(std::move(client_sock), &unhandled_signals_);
+}
+
+bool CrashpadClient::StartInProcessHandler(
+    const base::FilePath& database,
+    const std::map<std::string, std::string>& annotations) {
+  return InProcessHandler::Get()->Initialize(
+      database, annotations, &unhandled_signals_);
+}
+
+// static
+bool CrashpadClient::EnableInProcessFallback(
+    const base::FilePath& database,
+    const std::map<std::string, std::string>& annotations) {
+  auto writer = std::make_unique<internal::InProcessDumpWriter>();
+  if (!InitializeInProcessDumps(database, annotations, writer.get())) {
+    return false;
+  }
+  SignalHandler::SetInProcessFallback(writer.release());
+  return true;
+}
+
 // static
 bool CrashpadClient::StartHandlerForClient(
     const base::FilePath& handler,
@@ -723,20 +1090,48 @@ void CrashpadClient::DumpWithoutCrash(NativeCPUContext* context) {
     return;
   }
 
-#if defined(ARCH_CPU_ARMEL)
-  memset(context->uc_regspace, 0, sizeof(context->uc_regspace));
-#elif defined(ARCH_CPU_ARM64)
-  memset(context->uc_mcontext.__reserved,
-         0,
-         sizeof(context->uc_mcontext.__reserved));
-#endif
+  DumpWithoutCrashForThread(context, sys_gettid(), false);
+}
 
-  siginfo_t siginfo;
-  siginfo.si_signo = Signals::kSimulatedSigno;
-  siginfo.si_errno = 0;
-  siginfo.si_code = 0;
-  SignalHandler::Get()->HandleCrash(
-      siginfo.si_signo, &siginfo, reinterpret_cast<void*>(context));
+// static
+void CrashpadClient::DumpWithoutCrashLightweight(NativeCPUContext* context) {
+  if (!SignalHandler::Get()) {
+    DLOG(ERROR) << "Crashpad isn't enabled";
+    return;
+  }
+
+  DumpWithoutCrashForThread(context, sys_gettid(), true);
+}
+
+// static
+bool CrashpadClient::DumpWithoutCrashAsync(NativeCPUContext* context) {
+  if (!SignalHandler::Get()) {
+    DLOG(ERROR) << "Crashpad isn't enabled";
+    return false;
+  }
+
+  return AsyncDumpWithoutCrashThread::Get()->Request(*context);
+}
+
+// static
+void CrashpadClient::SetDumpWithoutCrashAsyncInterval(double seconds) {
+  DCHECK_GE(seconds, 0);
+  AsyncDumpWithoutCrashThread::Get()->SetInterval(seconds);
+}
+
+// static
+void CrashpadClient::SetDumpWithoutCrashUsesForkSnapshot(bool enabled) {
+  RequestCrashDumpHandler::Get()->SetForkSnapshotSimulatedCrashes(enabled);
+}
+
+// static
+void CrashpadClient::SetHandlerTenant(uint32_t tenant) {
+  RequestCrashDumpHandler::Get()->SetTenant(tenant);
+}
+
+// static
+bool CrashpadClient::EnableSharedCrashContext() {
+  return RequestCrashDumpHandler::Get()->EnableSharedCrashContext();
 }
 
 // static
@@ -47,6 +47,8 @@
 #include "util/linux/socket.h"
 #include "util/misc/address_sanitizer.h"
 #include "util/misc/address_types.h"
+#include "util/misc/capture_context.h"
+#include "util/misc/clock.h"
 #include "util/misc/from_pointer_cast.h"
 #include "util/misc/memory_sanitizer.h"
 #include "util/posix/scoped_mmap.h"
@@ -68,6 +70,7 @@ namespace {
 
 enum class CrashType : uint32_t {
   kSimulated,
+  kSimulatedAsync,
   kBuiltinTrap,
   kInfiniteRecursion,
   kSegvWithTagBits,
@@ -75,8 +78,19 @@ enum class CrashType : uint32_t {
   kFakeSegv,
 };
 
+enum class HandlerStartType : uint32_t {
+  // Start a persistent handler with StartHandler().
+  kPersistent,
+
+  // Launch a handler at crash time with StartHandlerAtCrash().
+  kAtCrash,
+
+  // Start an idle handler with StartStandbyHandler().
+  kStandby,
+};
+
 struct StartHandlerForSelfTestOptions {
-  bool start_handler_at_crash;
+  HandlerStartType start_type;
   bool set_first_chance_handler;
   bool set_last_chance_handler;
   bool crash_non_main_thread;
@@ -87,7 +101,13 @@ struct StartHandlerForSelfTestOptions {
 
 class StartHandlerForSelfTest
     : public testing::TestWithParam<
-          std::tuple<bool, bool, bool, bool, bool, bool, CrashType>> {
+          std::tuple<HandlerStartType,
+                     bool,
+                     bool,
+                     bool,
+                     bool,
+                     bool,
+                     CrashType>> {
  public:
   StartHandlerForSelfTest() = default;
 
@@ -100,7 +120,7 @@ class StartHandlerForSelfTest
     // MSAN requires that padding bytes have been initialized for structs that
     // are written to files.
     memset(&options_, 0, sizeof(options_));
-    std::tie(options_.start_handler_at_crash,
+    std::tie(options_.start_type,
              options_.set_first_chance_handler,
              options_.set_last_chance_handler,
              options_.crash_non_main_thread,
@@ -116,27 +136,39 @@ class StartHandlerForSelfTest
 };
 
 bool InstallHandler(CrashpadClient* client,
-                    bool start_at_crash,
+                    HandlerStartType start_type,
                     const base::FilePath& handler_path,
                     const base::FilePath& database_path,
                     const std::vector<base::FilePath>& attachments) {
-  return start_at_crash
-             ? client->StartHandlerAtCrash(handler_path,
-                                           database_path,
-                                           base::FilePath(),
-                                           "",
-                                           std::map<std::string, std::string>(),
-                                           std::vector<std::string>(),
-                                           attachments)
-             : client->StartHandler(handler_path,
-                                    database_path,
-                                    base::FilePath(),
-                                    "",
-                                    std::map<std::string, std::string>(),
-                                    std::vector<std::string>(),
-                                    false,
-                                    false,
-                                    attachments);
+  switch (start_type) {
+    case HandlerStartType::kPersistent:
+      return client->StartHandler(handler_path,
+                                  database_path,
+                                  base::FilePath(),
+                                  "",
+                                  std::map<std::string, std::string>(),
+                                  std::vector<std::string>(),
+                                  false,
+                                  false,
+                                  attachments);
+    case HandlerStartType::kAtCrash:
+      return client->StartHandlerAtCrash(handler_path,
+                                         database_path,
+                                         base::FilePath(),
+                                         "",
+                                         std::map<std::string, std::string>(),
+                                         std::vector<std::string>(),
+                                         attachments);
+    case HandlerStartType::kStandby:
+      return client->StartStandbyHandler(handler_path,
+                                         database_path,
+                                         base::FilePath(),
+                                         "",
+                                         std::map<std::string, std::string>(),
+                                         std::vector<std::string>(),
+                                         attachments);
+  }
+  NOTREACHED();
 }
 
 constexpr char kTestAnnotationName[] = "name_of_annotation";
@@ -252,8 +284,24 @@ bool HandleCrashSuccessfullyAfterReporting(int, siginfo_t*, ucontext_t*) {
   return true;
 }
 
+// Waits for a report to become pending in the database at database_path.
+void WaitForPendingReport(const base::FilePath& database_path) {
+  auto database = CrashReportDatabase::InitializeWithoutCreating(database_path);
+  CHECK(database);
+  for (int attempt = 0; attempt < 500; ++attempt) {
+    std::vector<CrashReportDatabase::Report> reports;
+    CHECK_EQ(database->GetPendingReports(&reports),
+             CrashReportDatabase::kNoError);
+    if (!reports.empty()) {
+      return;
+    }
+    SleepNanoseconds(10000000);
+  }
+}
+
 void DoCrash(const StartHandlerForSelfTestOptions& options,
-             CrashpadClient* client) {
+             CrashpadClient* client,
+             const base::FilePath& database_path) {
   if (sigsetjmp(do_crash_sigjmp_env, 1) != 0) {
     return;
   }
@@ -264,6 +312,21 @@ void DoCrash(const StartHandlerForSelfTestOptions& options,
       break;
     }
 
+    case CrashType::kSimulatedAsync: {
+      // A long interval ensures that the second request is dropped, whether or
+      // not the first has completed.
+      CrashpadClient::SetDumpWithoutCrashAsyncInterval(60);
+      NativeCPUContext context;
+      CaptureContext(&context);
+      CHECK(CrashpadClient::DumpWithoutCrashAsync(&context));
+      CHECK(!CrashpadClient::DumpWithoutCrashAsync(&context));
+
+      // The requesting thread must remain alive until the dump is complete,
+      // for the dump to include it.
+      WaitForPendingReport(database_path);
+      break;
+    }
+
     case CrashType::kBuiltinTrap: {
       __builtin_trap();
     }
@@ -335,8 +398,12 @@ class ScopedAltSignalStack {
 class CrashThread : public Thread {
  public:
   CrashThread(const StartHandlerForSelfTestOptions& options,
-              CrashpadClient* client)
-      : client_signal_stack_(), options_(options), client_(client) {}
+              CrashpadClient* client,
+              const base::FilePath& database_path)
+      : client_signal_stack_(),
+        options_(options),
+        client_(client),
+        database_path_(database_path) {}
 
   CrashThread(const CrashThread&) = delete;
   CrashThread& operator=(const CrashThread&) = delete;
@@ -352,12 +419,13 @@ class CrashThread : public Thread {
     }
     CrashpadClient::InitializeSignalStackForThread();
 
-    DoCrash(options_, client_);
+    DoCrash(options_, client_, database_path_);
   }
 
   ScopedAltSignalStack client_signal_stack_;
   const StartHandlerForSelfTestOptions& options_;
   CrashpadClient* client_;
+  base::FilePath database_path_;
 };
 
 CRASHPAD_CHILD_TEST_MAIN(StartHandlerForSelfTestChild) {
@@ -409,7 +477,7 @@ CRASHPAD_CHILD_TEST_MAIN(StartHandlerForSelfTestChild) {
 
   crashpad::CrashpadClient client;
   if (!InstallHandler(&client,
-                      options.start_handler_at_crash,
+                      options.start_type,
                       handler_path,
                       base::FilePath(temp_dir),
                       attachments)) {
@@ -431,11 +499,11 @@ CRASHPAD_CHILD_TEST_MAIN(StartHandlerForSelfTestChild) {
 #endif
 
   if (options.crash_non_main_thread) {
-    CrashThread thread(options, &client);
+    CrashThread thread(options, &client, base::FilePath(temp_dir));
     thread.Start();
     thread.Join();
   } else {
-    DoCrash(options, &client);
+    DoCrash(options, &client, base::FilePath(temp_dir));
   }
 
   return EXIT_SUCCESS;
@@ -449,6 +517,7 @@ class StartHandlerForSelfInChildTest : public MultiprocessExec {
     if (!options.set_first_chance_handler) {
       switch (options.crash_type) {
         case CrashType::kSimulated:
+        case CrashType::kSimulatedAsync:
           // kTerminationNormal, EXIT_SUCCESS
           break;
         case CrashType::kBuiltinTrap:
@@ -503,6 +572,7 @@ class StartHandlerForSelfInChildTest : public MultiprocessExec {
 
     if (options_.client_uses_signals && !options_.set_first_chance_handler &&
         options_.crash_type != CrashType::kSimulated &&
+        options_.crash_type != CrashType::kSimulatedAsync &&
         // The last chance handler will prevent the client handler from being
         // called if crash type is kFakeSegv.
         (!options_.set_last_chance_handler ||
@@ -527,8 +597,10 @@ class StartHandlerForSelfInChildTest : public MultiprocessExec {
     ASSERT_EQ(database->GetPendingReports(&reports),
               CrashReportDatabase::kNoError);
 
-    bool report_expected = !options_.set_first_chance_handler ||
-                           options_.crash_type == CrashType::kSimulated;
+    bool report_expected =
+        !options_.set_first_chance_handler ||
+        options_.crash_type == CrashType::kSimulated ||
+        options_.crash_type == CrashType::kSimulatedAsync;
     ASSERT_EQ(reports.size(), report_expected ? 1u : 0u);
 
     if (!report_expected) {
@@ -588,13 +660,16 @@ TEST_P(StartHandlerForSelfTest, StartHandlerInChild) {
 INSTANTIATE_TEST_SUITE_P(
     StartHandlerForSelfTestSuite,
     StartHandlerForSelfTest,
-    testing::Combine(testing::Bool(),
+    testing::Combine(testing::Values(HandlerStartType::kPersistent,
+                                     HandlerStartType::kAtCrash,
+                                     HandlerStartType::kStandby),
                      testing::Bool(),
                      testing::Bool(),
                      testing::Bool(),
                      testing::Bool(),
                      testing::Bool(),
                      testing::Values(CrashType::kSimulated,
+                                     CrashType::kSimulatedAsync,
                                      CrashType::kBuiltinTrap,
                                      CrashType::kInfiniteRecursion,
                                      CrashType::kSegvWithTagBits,
@@ -121,7 +121,11 @@ CrashpadInfo::CrashpadInfo()
       extra_memory_ranges_(nullptr),
       simple_annotations_(nullptr),
       user_data_minidump_stream_head_(nullptr),
-      annotations_list_(nullptr) {}
+      annotations_list_(nullptr),
+      annotation_arena_(nullptr),
+      extra_memory_range_table_(nullptr),
+      extra_memory_range_table_size_(0),
+      padding_2_(0) {}
 
 void CrashpadInfo::AddUserDataMinidumpStream(uint32_t stream_type,
                                              const void* data,
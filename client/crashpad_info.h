@@ -15,10 +15,13 @@
 #ifndef CRASHPAD_CLIENT_CRASHPAD_INFO_H_
 #define CRASHPAD_CLIENT_CRASHPAD_INFO_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "build/build_config.h"
+#include "client/annotation_arena.h"
 #include "client/annotation_list.h"
+#include "client/hashed_address_range_bag.h"
 #include "client/simple_address_range_bag.h"
 #include "client/simple_string_dictionary.h"
 #include "util/misc/tri_state.h"
@@ -79,7 +82,7 @@ struct CrashpadInfo {
   //! this method is called, or they may be added, removed, or modified in \a
   //! address_range_bag after this method is called.
   //!
-  //! TODO(scottmg) This is currently only supported on Windows.
+  //! This is currently supported on Windows, Linux, ChromeOS, and Android.
   //!
   //! \param[in] address_range_bag A bag of address ranges. The CrashpadInfo
   //!     object does not take ownership of the SimpleAddressRangeBag object.
@@ -89,6 +92,29 @@ struct CrashpadInfo {
     extra_memory_ranges_ = address_range_bag;
   }
 
+  //! \brief Sets a larger table of extra memory ranges to be included in the
+  //!     snapshot.
+  //!
+  //! This may be used alongside set_extra_memory_ranges(), for clients that
+  //! register more ranges, or insert and remove them more often, than a
+  //! SimpleAddressRangeBag suits. The handler copies the whole table in a
+  //! single read.
+  //!
+  //! This is currently supported on Windows, Linux, ChromeOS, and Android.
+  //!
+  //! \param[in] address_range_bag A bag of address ranges, or `nullptr`. The
+  //!     CrashpadInfo object does not take ownership of the
+  //!     THashedAddressRangeBag object. It is the caller’s responsibility to
+  //!     ensure that this pointer remains valid while it is in effect for a
+  //!     CrashpadInfo object.
+  template <size_t NumEntries>
+  void set_extra_memory_range_table(
+      THashedAddressRangeBag<NumEntries>* address_range_bag) {
+    extra_memory_range_table_ =
+        address_range_bag ? address_range_bag->entries() : nullptr;
+    extra_memory_range_table_size_ = address_range_bag ? NumEntries : 0;
+  }
+
   //! \brief Sets the simple annotations dictionary.
   //!
   //! Simple annotations set on a CrashpadInfo structure are interpreted by
@@ -143,6 +169,28 @@ struct CrashpadInfo {
   //! \sa AnnotationList::Register()
   AnnotationList* annotations_list() const { return annotations_list_; }
 
+  //! \brief Sets the annotation arena.
+  //!
+  //! Entries in \a arena are interpreted by Crashpad as module-level
+  //! annotations, in addition to those in annotations_list(). The handler reads
+  //! the arena with a constant number of reads, regardless of how many entries
+  //! it holds.
+  //!
+  //! \param[in] arena The arena to read. The CrashpadInfo object does not take
+  //!     ownership of the AnnotationArena object. It is the caller’s
+  //!     responsibility to ensure that this pointer remains valid while it is
+  //!     in effect for a CrashpadInfo object.
+  //!
+  //! \sa annotation_arena()
+  void set_annotation_arena(AnnotationArena* arena) {
+    annotation_arena_ = arena;
+  }
+
+  //! \return The annotation arena.
+  //!
+  //! \sa set_annotation_arena()
+  AnnotationArena* annotation_arena() const { return annotation_arena_; }
+
   //! \brief Enables or disables Crashpad handler processing.
   //!
   //! When handling an exception, the Crashpad handler will scan all modules in
@@ -262,6 +310,10 @@ struct CrashpadInfo {
   SimpleStringDictionary* simple_annotations_;  // weak
   internal::UserDataMinidumpStreamListEntry* user_data_minidump_stream_head_;
   AnnotationList* annotations_list_;  // weak
+  AnnotationArena* annotation_arena_;  // weak
+  const SimpleAddressRangeBag::Entry* extra_memory_range_table_;  // weak
+  uint32_t extra_memory_range_table_size_;
+  uint32_t padding_2_;
 
   // It’s generally safe to add new fields without changing
   // kCrashpadInfoVersion, because readers should check size_ and ignore fields
@@ -0,0 +1,226 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_HASHED_ADDRESS_RANGE_BAG_H_
+#define CRASHPAD_CLIENT_HASHED_ADDRESS_RANGE_BAG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "client/simple_address_range_bag.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+//! \brief A bag of address ranges using a fixed amount of storage, with
+//!     constant-time insertion and removal.
+//!
+//! Like TSimpleAddressRangeBag, this performs no dynamic allocations, and its
+//! storage is a flat array of SimpleAddressRangeBag::Entry in which inactive
+//! entries are zero, so that a crash handler can copy it in a single read.
+//! Rather than scanning the array for a free or matching entry, each range is
+//! placed by a hash of its base and size, using linear probing. Removal shifts
+//! later entries of the same probe sequence back into the vacated slot, so no
+//! tombstones are left behind. This suits registering thousands of ranges and
+//! inserting and removing them frequently.
+//!
+//! Insertion slows as the bag fills. Keep it no more than about half full.
+//!
+//! A bag is registered for capture with
+//! CrashpadInfo::set_extra_memory_range_table().
+//!
+//! \tparam NumEntries The capacity of the bag. This must be a power of 2.
+template <size_t NumEntries = 4096>
+class THashedAddressRangeBag {
+ public:
+  static_assert(NumEntries > 0 && (NumEntries & (NumEntries - 1)) == 0,
+                "NumEntries must be a power of 2");
+
+  //! Constant and publicly accessible version of the template parameter.
+  static constexpr size_t num_entries = NumEntries;
+
+  //! \brief A single entry in the bag, laid out as in SimpleAddressRangeBag.
+  using Entry = SimpleAddressRangeBag::Entry;
+
+  //! \brief An iterator to traverse all of the active entries in a
+  //!     THashedAddressRangeBag.
+  class Iterator {
+   public:
+    explicit Iterator(const THashedAddressRangeBag& bag)
+        : bag_(bag), current_(0) {}
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    //! \brief Returns the next entry in the bag, or `nullptr` if at the end of
+    //!     the collection.
+    const Entry* Next() {
+      while (current_ < bag_.num_entries) {
+        const Entry* entry = &bag_.entries_[current_++];
+        if (entry->is_active()) {
+          return entry;
+        }
+      }
+      return nullptr;
+    }
+
+   private:
+    const THashedAddressRangeBag& bag_;
+    size_t current_;
+  };
+
+  THashedAddressRangeBag() : entries_(), count_(0) {}
+
+  THashedAddressRangeBag(const THashedAddressRangeBag&) = delete;
+  THashedAddressRangeBag& operator=(const THashedAddressRangeBag&) = delete;
+
+  //! \brief Returns the number of active entries. The upper limit for this is
+  //!     \a NumEntries.
+  size_t GetCount() const { return count_; }
+
+  //! \brief Returns the bag’s storage, an array of \a NumEntries entries.
+  const Entry* entries() const { return entries_; }
+
+  //! \brief Inserts the given range into the bag. Duplicates and overlapping
+  //! ranges are supported and allowed, but not coalesced.
+  //!
+  //! \param[in] range The range to be inserted. The range must have either a
+  //!     non-zero base address or size.
+  //!
+  //! \return `true` if there was space to insert the range into the bag,
+  //!     otherwise `false` with an error logged.
+  bool Insert(CheckedRange<uint64_t> range) {
+    DCHECK(range.base() != 0 || range.size() != 0);
+
+    if (count_ == num_entries) {
+      LOG(ERROR) << "no space available to insert range";
+      return false;
+    }
+
+    size_t index = Index(range.base(), range.size());
+    while (entries_[index].is_active()) {
+      index = (index + 1) & kIndexMask;
+    }
+
+    entries_[index].base = range.base();
+    entries_[index].size = range.size();
+    ++count_;
+    return true;
+  }
+
+  //! \brief Inserts the given range into the bag. Duplicates and overlapping
+  //! ranges are supported and allowed, but not coalesced.
+  //!
+  //! \param[in] base The base of the range to be inserted. May not be null.
+  //! \param[in] size The size of the range to be inserted. May not be zero.
+  //!
+  //! \return `true` if there was space to insert the range into the bag,
+  //!     otherwise `false` with an error logged.
+  bool Insert(void* base, size_t size) {
+    DCHECK(base != nullptr);
+    DCHECK_NE(0u, size);
+    return Insert(CheckedRange<uint64_t>(FromPointerCast<uint64_t>(base),
+                                         base::checked_cast<uint64_t>(size)));
+  }
+
+  //! \brief Removes the given range from the bag.
+  //!
+  //! \param[in] range The range to be removed. The range must have either a
+  //!     non-zero base address or size.
+  //!
+  //! \return `true` if the range was found and removed, otherwise `false` with
+  //!     an error logged.
+  bool Remove(CheckedRange<uint64_t> range) {
+    DCHECK(range.base() != 0 || range.size() != 0);
+
+    size_t index = Index(range.base(), range.size());
+    for (size_t probes = 0;
+         probes < num_entries && entries_[index].is_active();
+         ++probes) {
+      if (entries_[index].base == range.base() &&
+          entries_[index].size == range.size()) {
+        RemoveAt(index);
+        return true;
+      }
+      index = (index + 1) & kIndexMask;
+    }
+
+    LOG(ERROR) << "did not find range to remove";
+    return false;
+  }
+
+  //! \brief Removes the given range from the bag.
+  //!
+  //! \param[in] base The base of the range to be removed. May not be null.
+  //! \param[in] size The size of the range to be removed. May not be zero.
+  //!
+  //! \return `true` if the range was found and removed, otherwise `false` with
+  //! an error logged.
+  bool Remove(void* base, size_t size) {
+    DCHECK(base != nullptr);
+    DCHECK_NE(0u, size);
+    return Remove(CheckedRange<uint64_t>(FromPointerCast<uint64_t>(base),
+                                         base::checked_cast<uint64_t>(size)));
+  }
+
+ private:
+  static constexpr size_t kIndexMask = NumEntries - 1;
+
+  // Returns the slot at which the probe sequence for a range begins.
+  static size_t Index(uint64_t base, uint64_t size) {
+    uint64_t hash = (base ^ (size * 0xff51afd7ed558ccdull)) *
+                    0x9e3779b97f4a7c15ull;
+    hash ^= hash >> 32;
+    return static_cast<size_t>(hash) & kIndexMask;
+  }
+
+  // Empties the slot at index, moving later entries of its probe sequence back
+  // so that every entry stays reachable from its own starting slot. An entry
+  // being moved is copied before its old slot is cleared, so a crash partway
+  // through may capture it twice, but won’t miss it.
+  void RemoveAt(size_t index) {
+    size_t hole = index;
+    entries_[hole].base = entries_[hole].size = 0;
+    size_t next = (hole + 1) & kIndexMask;
+    while (entries_[next].is_active()) {
+      const size_t home = Index(entries_[next].base, entries_[next].size);
+      if (((next - home) & kIndexMask) >= ((next - hole) & kIndexMask)) {
+        entries_[hole] = entries_[next];
+        entries_[next].base = entries_[next].size = 0;
+        hole = next;
+      }
+      next = (next + 1) & kIndexMask;
+    }
+    --count_;
+  }
+
+  Entry entries_[NumEntries];
+  size_t count_;
+};
+
+//! \brief A THashedAddressRangeBag with default template parameters.
+using HashedAddressRangeBag = THashedAddressRangeBag<4096>;
+
+static_assert(std::is_standard_layout<HashedAddressRangeBag>::value,
+              "HashedAddressRangeBag must be standard layout");
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_HASHED_ADDRESS_RANGE_BAG_H_
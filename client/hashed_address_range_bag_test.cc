@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/hashed_address_range_bag.h"
+
+#include <map>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(HashedAddressRangeBag, Entry) {
+  using TestBag = THashedAddressRangeBag<16>;
+  TestBag bag;
+
+  const TestBag::Entry* entry = TestBag::Iterator(bag).Next();
+  EXPECT_FALSE(entry);
+
+  bag.Insert(reinterpret_cast<void*>(0x1000), 200);
+  entry = TestBag::Iterator(bag).Next();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(0x1000u, entry->base);
+  EXPECT_EQ(200u, entry->size);
+
+  bag.Remove(reinterpret_cast<void*>(0x1000), 200);
+  EXPECT_FALSE(entry->is_active());
+  EXPECT_EQ(0u, entry->base);
+  EXPECT_EQ(0u, entry->size);
+  EXPECT_FALSE(TestBag::Iterator(bag).Next());
+}
+
+TEST(HashedAddressRangeBag, HashedAddressRangeBag) {
+  HashedAddressRangeBag bag;
+
+  EXPECT_TRUE(bag.Insert(reinterpret_cast<void*>(0x1000), 10));
+  EXPECT_TRUE(bag.Insert(reinterpret_cast<void*>(0x2000), 20));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+
+  EXPECT_EQ(3u, bag.GetCount());
+
+  // Duplicates added too.
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(5u, bag.GetCount());
+
+  // Can be removed 3 times, but not the 4th time.
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(2u, bag.GetCount());
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x3000, 30)));
+  EXPECT_EQ(2u, bag.GetCount());
+
+  EXPECT_TRUE(bag.Remove(reinterpret_cast<void*>(0x1000), 10));
+  EXPECT_TRUE(bag.Remove(reinterpret_cast<void*>(0x2000), 20));
+  EXPECT_EQ(0u, bag.GetCount());
+}
+
+TEST(HashedAddressRangeBag, Full) {
+  using TestBag = THashedAddressRangeBag<16>;
+  TestBag bag;
+
+  for (uint64_t index = 0; index < TestBag::num_entries; ++index) {
+    EXPECT_TRUE(bag.Insert(CheckedRange<uint64_t>(0x1000 * (index + 1), 8)));
+  }
+  EXPECT_EQ(bag.GetCount(), TestBag::num_entries);
+  EXPECT_FALSE(bag.Insert(CheckedRange<uint64_t>(0x100000, 8)));
+  EXPECT_FALSE(bag.Remove(CheckedRange<uint64_t>(0x100000, 8)));
+
+  // Every range is still found when the bag is full, and removing them in any
+  // order leaves the rest reachable.
+  for (uint64_t index = TestBag::num_entries; index > 0; index -= 2) {
+    EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x1000 * index, 8)));
+  }
+  for (uint64_t index = 1; index < TestBag::num_entries; index += 2) {
+    EXPECT_TRUE(bag.Remove(CheckedRange<uint64_t>(0x1000 * index, 8)));
+  }
+  EXPECT_EQ(bag.GetCount(), 0u);
+  EXPECT_FALSE(TestBag::Iterator(bag).Next());
+}
+
+TEST(HashedAddressRangeBag, Churn) {
+  // Insert and remove many ranges, some of them duplicates, checking the bag’s
+  // contents against a model after each step.
+  using TestBag = THashedAddressRangeBag<64>;
+  TestBag bag;
+  std::map<std::pair<uint64_t, uint64_t>, size_t> model;
+  size_t model_count = 0;
+
+  uint64_t state = 1;
+  for (size_t step = 0; step < 10000; ++step) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    const uint64_t base = ((state >> 33) % 40) * 0x40;
+    const uint64_t size = ((state >> 20) % 3) + 1;
+    auto key = std::make_pair(base, size);
+    auto it = model.find(key);
+
+    if (model_count < 48 && (it == model.end() || ((state >> 60) & 1))) {
+      ASSERT_TRUE(bag.Insert(CheckedRange<uint64_t>(base, size)));
+      ++model[key];
+      ++model_count;
+    } else {
+      if (it == model.end()) {
+        it = model.begin();
+        key = it->first;
+      }
+      ASSERT_TRUE(bag.Remove(CheckedRange<uint64_t>(key.first, key.second)));
+      if (--it->second == 0) {
+        model.erase(it);
+      }
+      --model_count;
+    }
+    ASSERT_EQ(bag.GetCount(), model_count);
+
+    std::map<std::pair<uint64_t, uint64_t>, size_t> contents;
+    TestBag::Iterator iterator(bag);
+    while (const TestBag::Entry* entry = iterator.Next()) {
+      ++contents[std::make_pair(entry->base, entry->size)];
+    }
+    ASSERT_EQ(contents, model);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,478 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/in_process_dump_converter_linux.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/in_process_dump_format_linux.h"
+#include "client/in_process_dump_writer_linux.h"
+#include "client/settings.h"
+#include "minidump/minidump_context_writer.h"
+#include "minidump/minidump_crashpad_info_writer.h"
+#include "minidump/minidump_exception_writer.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/minidump_memory_writer.h"
+#include "minidump/minidump_misc_info_writer.h"
+#include "minidump/minidump_module_writer.h"
+#include "minidump/minidump_simple_string_dictionary_writer.h"
+#include "minidump/minidump_system_info_writer.h"
+#include "minidump/minidump_thread_writer.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/linux/cpu_context_linux.h"
+#include "snapshot/memory_snapshot.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// Temporary files older than this were left by processes that didn’t finish
+// writing or converting a dump.
+constexpr time_t kStaleTemporaryFileAge = 24 * 60 * 60;
+
+struct InProcessDumpContents {
+  struct Module {
+    uint64_t address;
+    uint64_t size;
+    std::vector<uint8_t> build_id;
+    std::string name;
+  };
+
+  InProcessDumpException exception;
+  InProcessDumpContext context;
+  uint64_t stack_address;
+  const char* stack;
+  size_t stack_size;
+  std::vector<Module> modules;
+  std::map<std::string, std::string> annotations;
+};
+
+bool ParseInProcessDump(const std::string& dump,
+                        InProcessDumpContents* contents) {
+  InProcessDumpHeader header;
+  if (dump.size() < sizeof(header)) {
+    LOG(ERROR) << "dump too small";
+    return false;
+  }
+  memcpy(&header, dump.data(), sizeof(header));
+  if (header.magic != InProcessDumpHeader::kMagic ||
+      header.version != InProcessDumpHeader::kVersion) {
+    LOG(ERROR) << "unexpected dump format";
+    return false;
+  }
+  if (header.architecture !=
+      static_cast<uint32_t>(kInProcessDumpNativeArchitecture)) {
+    LOG(ERROR) << "unexpected dump architecture " << header.architecture;
+    return false;
+  }
+  if (header.size != dump.size()) {
+    LOG(ERROR) << "dump size mismatch";
+    return false;
+  }
+
+  contents->stack_address = 0;
+  contents->stack = nullptr;
+  contents->stack_size = 0;
+  bool have_exception = false;
+  bool have_context = false;
+  size_t offset = sizeof(header);
+  while (offset < dump.size()) {
+    InProcessDumpRecordHeader record;
+    if (dump.size() - offset < sizeof(record)) {
+      LOG(ERROR) << "truncated record header";
+      return false;
+    }
+    memcpy(&record, dump.data() + offset, sizeof(record));
+    offset += sizeof(record);
+    if (record.size > dump.size() - offset) {
+      LOG(ERROR) << "truncated record";
+      return false;
+    }
+    const char* const payload = dump.data() + offset;
+    const size_t size = record.size;
+    offset = std::min(
+        (offset + size + kInProcessDumpAlignment - 1) &
+            ~size_t{kInProcessDumpAlignment - 1},
+        dump.size());
+
+    switch (static_cast<InProcessDumpRecordType>(record.type)) {
+      case InProcessDumpRecordType::kException:
+        if (size < sizeof(contents->exception)) {
+          LOG(ERROR) << "exception record too small";
+          return false;
+        }
+        memcpy(&contents->exception, payload, sizeof(contents->exception));
+        have_exception = true;
+        break;
+
+      case InProcessDumpRecordType::kContext:
+        if (size < sizeof(contents->context)) {
+          LOG(ERROR) << "context record too small";
+          return false;
+        }
+        memcpy(&contents->context, payload, sizeof(contents->context));
+        have_context = true;
+        break;
+
+      case InProcessDumpRecordType::kStack: {
+        InProcessDumpMemory memory;
+        if (size < sizeof(memory)) {
+          LOG(ERROR) << "stack record too small";
+          return false;
+        }
+        memcpy(&memory, payload, sizeof(memory));
+        contents->stack_address = memory.address;
+        contents->stack = payload + sizeof(memory);
+        contents->stack_size = size - sizeof(memory);
+        break;
+      }
+
+      case InProcessDumpRecordType::kModule: {
+        InProcessDumpModule module;
+        if (size < sizeof(module)) {
+          LOG(ERROR) << "module record too small";
+          return false;
+        }
+        memcpy(&module, payload, sizeof(module));
+        if (module.build_id_size > size - sizeof(module) ||
+            module.name_size >
+                size - sizeof(module) - module.build_id_size) {
+          LOG(ERROR) << "module record too small";
+          return false;
+        }
+        const char* const build_id = payload + sizeof(module);
+        const char* const name = build_id + module.build_id_size;
+        InProcessDumpContents::Module& parsed =
+            contents->modules.emplace_back();
+        parsed.address = module.address;
+        parsed.size = module.size;
+        parsed.build_id.assign(build_id, build_id + module.build_id_size);
+        parsed.name.assign(name, module.name_size);
+        break;
+      }
+
+      case InProcessDumpRecordType::kAnnotation: {
+        InProcessDumpAnnotation annotation;
+        if (size < sizeof(annotation)) {
+          LOG(ERROR) << "annotation record too small";
+          return false;
+        }
+        memcpy(&annotation, payload, sizeof(annotation));
+        if (annotation.name_size > size - sizeof(annotation) ||
+            annotation.value_size >
+                size - sizeof(annotation) - annotation.name_size) {
+          LOG(ERROR) << "annotation record too small";
+          return false;
+        }
+        const char* const name = payload + sizeof(annotation);
+        contents->annotations[std::string(name, annotation.name_size)] =
+            std::string(name + annotation.name_size, annotation.value_size);
+        break;
+      }
+
+      default:
+        // Records of types that this code doesn’t know about are skipped.
+        break;
+    }
+  }
+
+  if (!have_exception || !have_context) {
+    LOG(ERROR) << "missing exception or context";
+    return false;
+  }
+  return true;
+}
+
+// The stack memory held in an in-process dump.
+class InProcessDumpMemorySnapshot final : public MemorySnapshot {
+ public:
+  InProcessDumpMemorySnapshot(uint64_t address, const char* data, size_t size)
+      : MemorySnapshot(), address_(address), data_(data), size_(size) {}
+
+  InProcessDumpMemorySnapshot(const InProcessDumpMemorySnapshot&) = delete;
+  InProcessDumpMemorySnapshot& operator=(const InProcessDumpMemorySnapshot&) =
+      delete;
+
+  ~InProcessDumpMemorySnapshot() override = default;
+
+  // MemorySnapshot:
+  uint64_t Address() const override { return address_; }
+  size_t Size() const override { return size_; }
+  bool Read(Delegate* delegate) const override {
+    return delegate->MemorySnapshotDelegateRead(const_cast<char*>(data_),
+                                                size_);
+  }
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    // A dump holds a single range of memory, so there’s never another to
+    // merge with.
+    LOG(ERROR) << "unexpected merge";
+    return nullptr;
+  }
+
+ private:
+  uint64_t address_;
+  const char* data_;
+  size_t size_;
+};
+
+// Describes the system that the dump is being converted on, which is the one
+// that it was written on.
+std::unique_ptr<MinidumpSystemInfoWriter> SystemInfoWriter() {
+  auto system_info = std::make_unique<MinidumpSystemInfoWriter>();
+#if defined(ARCH_CPU_X86_64)
+  system_info->SetCPUArchitecture(kMinidumpCPUArchitectureAMD64);
+#elif defined(ARCH_CPU_ARM64)
+  system_info->SetCPUArchitecture(kMinidumpCPUArchitectureARM64);
+#endif
+  system_info->SetOS(kMinidumpOSLinux);
+
+  std::string build;
+  utsname uts;
+  if (uname(&uts) == 0) {
+    build = base::StringPrintf("%s %s", uts.version, uts.machine);
+  }
+  system_info->SetCSDVersion(build);
+  return system_info;
+}
+
+bool ConvertInProcessDump(const base::FilePath& path,
+                          CrashReportDatabase* database) {
+  // Renaming the dump claims it, so that no other process converts it too.
+  const base::FilePath claimed_path(
+      path.value() + InProcessDumpWriter::kTemporaryExtension);
+  if (rename(path.value().c_str(), claimed_path.value().c_str()) != 0) {
+    if (errno != ENOENT) {
+      PLOG(ERROR) << "rename " << path.value();
+    }
+    return false;
+  }
+  std::string dump;
+  const bool read = LoggingReadEntireFile(claimed_path, &dump);
+  LoggingRemoveFile(claimed_path);
+  if (!read) {
+    return false;
+  }
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  if (database->PrepareNewCrashReport(&new_report) !=
+      CrashReportDatabase::kNoError) {
+    return false;
+  }
+
+  UUID client_id;
+  Settings* const settings = database->GetSettings();
+  const bool have_client_id = settings && settings->GetClientID(&client_id);
+  if (!WriteMinidumpFromInProcessDump(dump,
+                                      new_report->ReportID(),
+                                      have_client_id ? &client_id : nullptr,
+                                      new_report->MinidumpWriter(),
+                                      !new_report->IsCompressed())) {
+    return false;
+  }
+
+  UUID uuid;
+  return database->FinishedWritingCrashReport(std::move(new_report), &uuid) ==
+         CrashReportDatabase::kNoError;
+}
+
+}  // namespace
+
+bool WriteMinidumpFromInProcessDump(const std::string& dump,
+                                    const UUID& report_id,
+                                    const UUID* client_id,
+                                    FileWriterInterface* file_writer,
+                                    bool allow_seek) {
+  InProcessDumpContents contents;
+  if (!ParseInProcessDump(dump, &contents)) {
+    return false;
+  }
+
+  CPUContext cpu_context;
+#if defined(ARCH_CPU_X86_64)
+  CPUContextX86_64 cpu_context_x86_64;
+  if (contents.context.has_float_context) {
+    InitializeCPUContextX86_64(contents.context.thread_context,
+                               contents.context.float_context,
+                               &cpu_context_x86_64);
+  } else {
+    InitializeCPUContextX86_64_NoFloatingPoint(contents.context.thread_context,
+                                               &cpu_context_x86_64);
+  }
+  cpu_context.architecture = kCPUArchitectureX86_64;
+  cpu_context.x86_64 = &cpu_context_x86_64;
+#elif defined(ARCH_CPU_ARM64)
+  CPUContextARM64 cpu_context_arm64;
+  InitializeCPUContextARM64_NoFloatingPoint(contents.context.thread_context,
+                                            &cpu_context_arm64);
+  if (contents.context.has_float_context) {
+    InitializeCPUContextARM64_OnlyFPSIMD(contents.context.float_context,
+                                         &cpu_context_arm64);
+  }
+  cpu_context.architecture = kCPUArchitectureARM64;
+  cpu_context.arm64 = &cpu_context_arm64;
+#else
+  // The architecture was checked by ParseInProcessDump().
+  NOTREACHED();
+#endif
+
+  MinidumpFileWriter minidump;
+  minidump.SetTimestamp(contents.exception.time);
+
+  if (!minidump.AddStream(SystemInfoWriter())) {
+    return false;
+  }
+
+  auto misc_info = std::make_unique<MinidumpMiscInfoWriter>();
+  misc_info->SetProcessID(contents.exception.pid);
+  if (!minidump.AddStream(std::move(misc_info))) {
+    return false;
+  }
+
+  // The memory list holds the stack, and is added last, following the order
+  // of MinidumpFileWriter::InitializeFromSnapshot().
+  auto memory_list = std::make_unique<MinidumpMemoryListWriter>();
+  InProcessDumpMemorySnapshot stack(
+      contents.stack_address, contents.stack, contents.stack_size);
+
+  auto thread = std::make_unique<MinidumpThreadWriter>();
+  thread->SetThreadID(contents.exception.thread_id);
+  thread->SetContext(MinidumpContextWriter::CreateFromSnapshot(&cpu_context));
+  if (contents.stack_size > 0) {
+    thread->SetStack(std::make_unique<SnapshotMinidumpMemoryWriter>(&stack));
+  }
+  auto thread_list = std::make_unique<MinidumpThreadListWriter>();
+  thread_list->SetMemoryListWriter(memory_list.get());
+  thread_list->AddThread(std::move(thread));
+  if (!minidump.AddStream(std::move(thread_list))) {
+    return false;
+  }
+
+  auto exception = std::make_unique<MinidumpExceptionWriter>();
+  exception->SetThreadID(contents.exception.thread_id);
+  exception->SetExceptionCode(contents.exception.signo);
+  exception->SetExceptionFlags(contents.exception.code);
+  exception->SetExceptionAddress(contents.exception.address);
+  exception->SetContext(
+      MinidumpContextWriter::CreateFromSnapshot(&cpu_context));
+  if (!minidump.AddStream(std::move(exception))) {
+    return false;
+  }
+
+  auto module_list = std::make_unique<MinidumpModuleListWriter>();
+  for (const InProcessDumpContents::Module& module : contents.modules) {
+    auto module_writer = std::make_unique<MinidumpModuleWriter>();
+    module_writer->SetName(module.name);
+    module_writer->SetImageBaseAddress(module.address);
+    module_writer->SetImageSize(base::saturated_cast<uint32_t>(module.size));
+    if (!module.build_id.empty()) {
+      auto codeview_record =
+          std::make_unique<MinidumpModuleCodeViewRecordBuildIDWriter>();
+      codeview_record->SetBuildID(module.build_id);
+      module_writer->SetCodeViewRecord(std::move(codeview_record));
+    }
+    module_list->AddModule(std::move(module_writer));
+  }
+  if (!minidump.AddStream(std::move(module_list))) {
+    return false;
+  }
+
+  auto crashpad_info = std::make_unique<MinidumpCrashpadInfoWriter>();
+  crashpad_info->SetReportID(report_id);
+  if (client_id) {
+    crashpad_info->SetClientID(*client_id);
+  }
+  auto simple_annotations =
+      std::make_unique<MinidumpSimpleStringDictionaryWriter>();
+  simple_annotations->InitializeFromMap(contents.annotations);
+  if (simple_annotations->IsUseful()) {
+    crashpad_info->SetSimpleAnnotations(std::move(simple_annotations));
+  }
+  if (!minidump.AddStream(std::move(crashpad_info)) ||
+      !minidump.AddStream(std::move(memory_list))) {
+    return false;
+  }
+
+  return minidump.WriteMinidump(file_writer, allow_seek);
+}
+
+size_t ConvertInProcessDumps(const base::FilePath& dump_dir,
+                             CrashReportDatabase* database) {
+  DirectoryReader reader;
+  if (!reader.Open(dump_dir)) {
+    return 0;
+  }
+
+  timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  std::vector<base::FilePath> dumps;
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    const base::FilePath path = dump_dir.Append(filename);
+    const base::FilePath::StringType extension = filename.FinalExtension();
+    if (extension == InProcessDumpWriter::kExtension) {
+      dumps.push_back(path);
+    } else if (extension == InProcessDumpWriter::kTemporaryExtension) {
+      timespec mtime;
+      if (FileModificationTime(path, &mtime) &&
+          now.tv_sec - mtime.tv_sec > kStaleTemporaryFileAge) {
+        LoggingRemoveFile(path);
+      }
+    }
+  }
+
+  size_t converted = 0;
+  for (const base::FilePath& path : dumps) {
+    if (ConvertInProcessDump(path, database)) {
+      ++converted;
+    }
+  }
+  return converted;
+}
+
+}  // namespace internal
+
+size_t ConvertInProcessDumps(const base::FilePath& database) {
+  std::unique_ptr<CrashReportDatabase> report_database =
+      CrashReportDatabase::Initialize(database);
+  if (!report_database) {
+    return 0;
+  }
+  return internal::ConvertInProcessDumps(
+      database.Append(internal::kInProcessDumpDirectory),
+      report_database.get());
+}
+
+}  // namespace crashpad
@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IN_PROCESS_DUMP_CONVERTER_LINUX_H_
+#define CRASHPAD_CLIENT_IN_PROCESS_DUMP_CONVERTER_LINUX_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "client/crash_report_database.h"
+#include "util/file/file_writer.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Writes a minidump from an in-process dump written by
+//!     InProcessDumpWriter.
+//!
+//! The minidump holds system information, the crashing thread and its stack,
+//! the exception, the modules, and the annotations, which are all stored as
+//! process-level simple annotations.
+//!
+//! \param[in] dump The contents of the in-process dump.
+//! \param[in] report_id The report ID to record in the minidump.
+//! \param[in] client_id The client ID to record in the minidump, or `nullptr`
+//!     if there isn’t one.
+//! \param[in] file_writer The file writer to write the minidump to.
+//! \param[in] allow_seek Whether \a file_writer may seek, as for
+//!     MinidumpFileWriter::WriteMinidump().
+//!
+//! \return `true` on success, `false` on failure with a message logged.
+bool WriteMinidumpFromInProcessDump(const std::string& dump,
+                                    const UUID& report_id,
+                                    const UUID* client_id,
+                                    FileWriterInterface* file_writer,
+                                    bool allow_seek);
+
+//! \brief Converts each in-process dump in \a dump_dir to a crash report in \a
+//!     database.
+//!
+//! Each dump is removed before it’s converted, so one that can’t be converted,
+//! or that crashes the converter, isn’t tried again. Dumps being written or
+//! converted by other processes are left alone.
+//!
+//! \param[in] dump_dir The directory that InProcessDumpWriter writes dumps to.
+//! \param[in] database The database to create crash reports in.
+//!
+//! \return The number of crash reports created.
+size_t ConvertInProcessDumps(const base::FilePath& dump_dir,
+                             CrashReportDatabase* database);
+
+}  // namespace internal
+
+//! \brief Converts the dumps left beneath \a database by
+//!     CrashpadClient::StartInProcessHandler() and
+//!     CrashpadClient::EnableInProcessFallback() to crash reports in \a
+//!     database.
+//!
+//! This is in the `client:in_process_dump_converter` library, which embedders
+//! that write in-process dumps link and call this from, for example at startup
+//! or before running a handler with \a database. It may be called by several
+//! processes at once, and each dump is converted by only one of them.
+//!
+//! \param[in] database The path to a Crashpad database.
+//!
+//! \return The number of crash reports created.
+size_t ConvertInProcessDumps(const base::FilePath& database);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IN_PROCESS_DUMP_CONVERTER_LINUX_H_
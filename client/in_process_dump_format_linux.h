@@ -0,0 +1,171 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IN_PROCESS_DUMP_FORMAT_LINUX_H_
+#define CRASHPAD_CLIENT_IN_PROCESS_DUMP_FORMAT_LINUX_H_
+
+#include <stdint.h>
+
+#include "base/files/file_path.h"
+#include "build/build_config.h"
+
+// The client doesn’t depend on the snapshot library, and only uses the
+// structure definitions in these headers.
+#include "snapshot/cpu_context.h"  // nogncheck
+#include "snapshot/linux/signal_context.h"  // nogncheck
+
+namespace crashpad {
+namespace internal {
+
+// An in-process dump is an InProcessDumpHeader followed by a sequence of
+// records. Each record is an InProcessDumpRecordHeader followed by its payload,
+// padded with zeroes to a multiple of kInProcessDumpAlignment bytes. Values are
+// stored in the byte order and structure layout of the process that wrote the
+// dump, and a dump is only converted by a process of the same architecture.
+
+//! \brief The directory beneath a Crashpad database that in-process dumps are
+//!     written to.
+constexpr base::FilePath::CharType kInProcessDumpDirectory[] =
+    FILE_PATH_LITERAL("in_process");
+
+//! \brief The alignment of each record in an in-process dump.
+constexpr uint32_t kInProcessDumpAlignment = 8;
+
+//! \brief The architecture that an in-process dump was written for.
+enum class InProcessDumpArchitecture : uint32_t {
+  kUnknown = 0,
+  kX86_64 = 1,
+  kARM64 = 2,
+};
+
+//! \brief The architecture that in-process dumps written by this process are
+//!     for, or InProcessDumpArchitecture::kUnknown if they’re not supported.
+constexpr InProcessDumpArchitecture kInProcessDumpNativeArchitecture =
+#if defined(ARCH_CPU_X86_64)
+    InProcessDumpArchitecture::kX86_64;
+#elif defined(ARCH_CPU_ARM64)
+    InProcessDumpArchitecture::kARM64;
+#else
+    InProcessDumpArchitecture::kUnknown;
+#endif
+
+//! \brief The header at the start of an in-process dump.
+struct InProcessDumpHeader {
+  //! \brief The expected value of #magic, `'CPIP'`.
+  static constexpr uint32_t kMagic = 0x50495043;
+
+  //! \brief The current value of #version.
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+
+  //! \brief An InProcessDumpArchitecture value.
+  uint32_t architecture;
+
+  uint32_t reserved;
+
+  //! \brief The size of the dump, including this header.
+  uint64_t size;
+};
+static_assert(sizeof(InProcessDumpHeader) == 24, "header size");
+
+//! \brief The type of a record in an in-process dump.
+enum class InProcessDumpRecordType : uint32_t {
+  //! \brief An InProcessDumpException.
+  kException = 1,
+
+  //! \brief An InProcessDumpContext for the thread named by the exception.
+  kContext = 2,
+
+  //! \brief An InProcessDumpMemory holding the top of the stack of the thread
+  //!     named by the exception.
+  kStack = 3,
+
+  //! \brief An InProcessDumpModule.
+  kModule = 4,
+
+  //! \brief An InProcessDumpAnnotation.
+  kAnnotation = 5,
+};
+
+//! \brief The header that begins each record in an in-process dump.
+struct InProcessDumpRecordHeader {
+  //! \brief An InProcessDumpRecordType value.
+  uint32_t type;
+
+  //! \brief The size of the record’s payload, not including this header or
+  //!     padding.
+  uint32_t size;
+};
+static_assert(sizeof(InProcessDumpRecordHeader) == kInProcessDumpAlignment,
+              "record header size");
+
+//! \brief Describes the signal that caused an in-process dump to be written.
+struct InProcessDumpException {
+  //! \brief The time of the dump, in seconds since the POSIX epoch.
+  int64_t time;
+
+  uint32_t pid;
+  uint32_t thread_id;
+  int32_t signo;
+  int32_t code;
+
+  //! \brief The signal’s fault address, `si_addr`.
+  uint64_t address;
+};
+
+//! \brief The CPU context of the thread named by the exception.
+struct InProcessDumpContext {
+#if defined(ARCH_CPU_X86_64) || defined(ARCH_CPU_ARM64) || DOXYGEN
+  SignalThreadContext64 thread_context;
+#endif
+#if defined(ARCH_CPU_X86_64) || DOXYGEN
+  SignalFloatContext64 float_context;
+#elif defined(ARCH_CPU_ARM64)
+  SignalFPSIMDContext float_context;
+#endif
+
+  //! \brief Whether #float_context was captured.
+  uint32_t has_float_context;
+
+  uint32_t reserved;
+};
+
+//! \brief A range of memory, followed in its record by the memory’s contents.
+struct InProcessDumpMemory {
+  uint64_t address;
+};
+
+//! \brief A loaded ELF module, followed in its record by #build_id_size bytes
+//!     of build ID, and then #name_size bytes of path, without a `NUL`
+//!     terminator.
+struct InProcessDumpModule {
+  uint64_t address;
+  uint64_t size;
+  uint32_t build_id_size;
+  uint32_t name_size;
+};
+
+//! \brief A string annotation, followed in its record by #name_size bytes of
+//!     name, and then #value_size bytes of value, neither `NUL`-terminated.
+struct InProcessDumpAnnotation {
+  uint32_t name_size;
+  uint32_t value_size;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IN_PROCESS_DUMP_FORMAT_LINUX_H_
@@ -0,0 +1,643 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/in_process_dump_writer_linux.h"
+
+#include <elf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "build/build_config.h"
+#include "client/annotation.h"
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "client/simple_string_dictionary.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// The scratch space at the start of the arena holds lines read from
+// /proc/self/maps, then the program headers and notes of one module at a time,
+// and finally the paths that the dump is written to.
+constexpr size_t kMapsBufferSize = 4096;
+constexpr size_t kMaxProgramHeaders = 32;
+constexpr size_t kNotesBufferSize = 2048;
+constexpr size_t kMaxPathSize = 4096;
+constexpr size_t kScratchSize =
+    std::max(kMapsBufferSize + kMaxProgramHeaders * sizeof(Elf64_Phdr) +
+                 kNotesBufferSize,
+             2 * kMaxPathSize);
+
+// Room for the dump counter and the extensions.
+constexpr size_t kMaxPathSuffixSize = 32;
+
+// The records that a dump can’t do without.
+constexpr size_t kMinimumDynamicSize =
+    2 * sizeof(InProcessDumpRecordHeader) + sizeof(InProcessDumpException) +
+    sizeof(InProcessDumpContext);
+
+#if defined(ARCH_CPU_X86_64)
+// Leaf functions may use memory below the stack pointer.
+constexpr uint64_t kRedZoneSize = 128;
+#else
+constexpr uint64_t kRedZoneSize = 0;
+#endif
+
+constexpr size_t AlignRecordSize(size_t size) {
+  return (size + kInProcessDumpAlignment - 1) &
+         ~size_t{kInProcessDumpAlignment - 1};
+}
+
+struct Mapping {
+  uint64_t start;
+  uint64_t end;
+  uint64_t offset;
+  const char* path;
+  size_t path_size;
+  bool readable;
+};
+
+const char* ParseHex(const char* p, const char* end, uint64_t* value) {
+  const char* const begin = p;
+  uint64_t result = 0;
+  for (; p < end; ++p) {
+    int digit;
+    if (*p >= '0' && *p <= '9') {
+      digit = *p - '0';
+    } else if (*p >= 'a' && *p <= 'f') {
+      digit = *p - 'a' + 10;
+    } else {
+      break;
+    }
+    result = result * 16 + digit;
+  }
+  if (p == begin) {
+    return nullptr;
+  }
+  *value = result;
+  return p;
+}
+
+// Parses a line of /proc/self/maps, such as
+// “7f0123456000-7f0123458000 r-xp 00001000 fd:01 1234   /lib/libc.so.6”.
+bool ParseMapping(const char* line, const char* end, Mapping* mapping) {
+  const char* p = ParseHex(line, end, &mapping->start);
+  if (!p || p == end || *p++ != '-') {
+    return false;
+  }
+  p = ParseHex(p, end, &mapping->end);
+  if (!p || end - p < 6 || p[0] != ' ' || p[5] != ' ') {
+    return false;
+  }
+  mapping->readable = p[1] == 'r';
+  p = ParseHex(p + 6, end, &mapping->offset);
+  if (!p) {
+    return false;
+  }
+
+  // Skip the device and inode fields.
+  for (int field = 0; field < 2; ++field) {
+    while (p < end && *p == ' ') {
+      ++p;
+    }
+    while (p < end && *p != ' ') {
+      ++p;
+    }
+  }
+  while (p < end && *p == ' ') {
+    ++p;
+  }
+  mapping->path = p;
+  mapping->path_size = end - p;
+  return true;
+}
+
+// Calls visit() for each mapping in /proc/self/maps, reading it through
+// buffer. Lines too long to fit in buffer are skipped.
+template <typename Visitor>
+void ForEachMapping(char* buffer, size_t buffer_size, Visitor visit) {
+  const int fd = HANDLE_EINTR(open("/proc/self/maps", O_RDONLY | O_CLOEXEC));
+  if (fd < 0) {
+    return;
+  }
+
+  size_t buffered = 0;
+  bool skipping = false;
+  while (true) {
+    const ssize_t rv =
+        HANDLE_EINTR(read(fd, buffer + buffered, buffer_size - buffered));
+    if (rv <= 0) {
+      break;
+    }
+    buffered += rv;
+
+    const char* line = buffer;
+    const char* const end = buffer + buffered;
+    const char* newline;
+    while ((newline = static_cast<const char*>(
+                memchr(line, '\n', end - line))) != nullptr) {
+      Mapping mapping;
+      if (!skipping && ParseMapping(line, newline, &mapping)) {
+        visit(mapping);
+      }
+      skipping = false;
+      line = newline + 1;
+    }
+
+    buffered = end - line;
+    if (buffered == buffer_size) {
+      skipping = true;
+      buffered = 0;
+    } else {
+      memmove(buffer, line, buffered);
+    }
+  }
+  close(fd);
+}
+
+// Finds the GNU build ID note among size bytes of notes.
+bool FindBuildID(const char* notes,
+                 size_t size,
+                 const char** build_id,
+                 size_t* build_id_size) {
+  size_t offset = 0;
+  while (size - offset >= sizeof(Elf64_Nhdr)) {
+    Elf64_Nhdr note;
+    memcpy(&note, notes + offset, sizeof(note));
+    offset += sizeof(note);
+
+    const size_t name_size = (size_t{note.n_namesz} + 3) & ~size_t{3};
+    const size_t desc_size = (size_t{note.n_descsz} + 3) & ~size_t{3};
+    if (name_size > size - offset || desc_size > size - offset - name_size) {
+      return false;
+    }
+    if (note.n_type == NT_GNU_BUILD_ID &&
+        note.n_namesz == sizeof(ELF_NOTE_GNU) &&
+        memcmp(notes + offset, ELF_NOTE_GNU, sizeof(ELF_NOTE_GNU)) == 0) {
+      *build_id = notes + offset + name_size;
+      *build_id_size = note.n_descsz;
+      return true;
+    }
+    offset += name_size + desc_size;
+  }
+  return false;
+}
+
+char* AppendDecimal(char* p, uint32_t value) {
+  char digits[10];
+  size_t count = 0;
+  do {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  while (count > 0) {
+    *p++ = digits[--count];
+  }
+  return p;
+}
+
+}  // namespace
+
+InProcessDumpWriter::InProcessDumpWriter()
+    : arena_(),
+      path_prefix_(),
+      scratch_(nullptr),
+      dump_(nullptr),
+      dump_capacity_(0),
+      dump_size_(0),
+      static_size_(0),
+      page_size_(0),
+      pid_(0),
+      dump_count_(0),
+      busy_(false) {}
+
+InProcessDumpWriter::~InProcessDumpWriter() = default;
+
+bool InProcessDumpWriter::Initialize(
+    const base::FilePath& dump_dir,
+    const std::map<std::string, std::string>& annotations,
+    size_t arena_size) {
+  DCHECK(!dump_);
+  DCHECK_LE(arena_size, std::numeric_limits<uint32_t>::max());
+
+  if (kInProcessDumpNativeArchitecture == InProcessDumpArchitecture::kUnknown) {
+    LOG(ERROR) << "in-process dumps are not supported on this architecture";
+    return false;
+  }
+
+  UUID uuid;
+  if (!uuid.InitializeWithNew()) {
+    return false;
+  }
+  path_prefix_ = dump_dir.Append(uuid.ToString()).value() + ".";
+  if (path_prefix_.size() + kMaxPathSuffixSize > kMaxPathSize) {
+    LOG(ERROR) << "dump directory path too long";
+    return false;
+  }
+
+  // Fault the arena in now, so that writing a dump doesn’t need to allocate
+  // memory.
+  page_size_ = getpagesize();
+  const size_t arena_mapping_size =
+      (kScratchSize + arena_size + page_size_ - 1) & ~(page_size_ - 1);
+  if (!arena_.ResetMmap(nullptr,
+                        arena_mapping_size,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+                        -1,
+                        0)) {
+    return false;
+  }
+  scratch_ = arena_.addr_as<char*>();
+  dump_ = scratch_ + kScratchSize;
+  dump_capacity_ = arena_size;
+
+  // Process annotations don’t change, so they’re recorded once, right after
+  // the header.
+  dump_size_ = sizeof(InProcessDumpHeader);
+  bool fits = true;
+  for (const auto& [name, value] : annotations) {
+    if (!AddAnnotation(name.data(), name.size(), value.data(), value.size())) {
+      fits = false;
+      break;
+    }
+  }
+  static_size_ = dump_size_;
+  if (!fits || dump_capacity_ < kMinimumDynamicSize ||
+      dump_capacity_ - kMinimumDynamicSize < static_size_) {
+    LOG(ERROR) << "arena too small";
+    arena_.Reset();
+    dump_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool InProcessDumpWriter::WriteDump(const siginfo_t* siginfo,
+                                    const ucontext_t* context,
+                                    pid_t thread_id) {
+  if (!dump_ || busy_.exchange(true)) {
+    return false;
+  }
+
+  const int saved_errno = errno;
+  dump_size_ = static_size_;
+  pid_ = getpid();
+
+  timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  InProcessDumpException exception = {};
+  exception.time = now.tv_sec;
+  exception.pid = pid_;
+  exception.thread_id = thread_id;
+  exception.signo = siginfo->si_signo;
+  exception.code = siginfo->si_code;
+  exception.address = FromPointerCast<uint64_t>(siginfo->si_addr);
+  char* payload = BeginRecord(sizeof(exception));
+  memcpy(payload, &exception, sizeof(exception));
+  EndRecord(InProcessDumpRecordType::kException, sizeof(exception));
+
+  uint64_t stack_pointer;
+  bool rv = AddContext(context, &stack_pointer);
+  if (rv) {
+    AddStack(stack_pointer);
+    AddModules();
+    AddAnnotations();
+    rv = WriteFile();
+  }
+
+  errno = saved_errno;
+  busy_.store(false);
+  return rv;
+}
+
+char* InProcessDumpWriter::BeginRecord(size_t size) {
+  DCHECK_LE(dump_size_, dump_capacity_);
+  const size_t padded_size = AlignRecordSize(size);
+  if (padded_size < size ||
+      dump_capacity_ - dump_size_ <
+          sizeof(InProcessDumpRecordHeader) + padded_size) {
+    return nullptr;
+  }
+  char* payload = dump_ + dump_size_ + sizeof(InProcessDumpRecordHeader);
+  memset(payload, 0, padded_size);
+  return payload;
+}
+
+void InProcessDumpWriter::EndRecord(InProcessDumpRecordType type,
+                                    size_t size) {
+  InProcessDumpRecordHeader header;
+  header.type = static_cast<uint32_t>(type);
+  header.size = static_cast<uint32_t>(size);
+  memcpy(dump_ + dump_size_, &header, sizeof(header));
+  dump_size_ += sizeof(header) + AlignRecordSize(size);
+}
+
+size_t InProcessDumpWriter::ReadMemory(uint64_t address,
+                                       void* buffer,
+                                       size_t size) {
+  // process_vm_readv() fails instead of faulting on addresses that can’t be
+  // read, such as those of files mapped beyond their ends.
+  iovec local_iov;
+  local_iov.iov_base = buffer;
+  local_iov.iov_len = size;
+  iovec remote_iov;
+  remote_iov.iov_base = reinterpret_cast<void*>(address);
+  remote_iov.iov_len = size;
+  const ssize_t rv =
+      syscall(SYS_process_vm_readv, pid_, &local_iov, 1, &remote_iov, 1, 0);
+  return rv > 0 ? rv : 0;
+}
+
+bool InProcessDumpWriter::AddContext(const ucontext_t* context,
+                                     uint64_t* stack_pointer) {
+  InProcessDumpContext* record = reinterpret_cast<InProcessDumpContext*>(
+      BeginRecord(sizeof(InProcessDumpContext)));
+  if (!record) {
+    return false;
+  }
+
+#if defined(ARCH_CPU_X86_64)
+  const auto* ucontext =
+      reinterpret_cast<const UContext<ContextTraits64>*>(context);
+  record->thread_context = ucontext->mcontext.gprs;
+  if (ucontext->mcontext.fpptr) {
+    memcpy(&record->float_context,
+           reinterpret_cast<const void*>(ucontext->mcontext.fpptr),
+           sizeof(record->float_context));
+    record->has_float_context = 1;
+  }
+  *stack_pointer = record->thread_context.rsp;
+#elif defined(ARCH_CPU_ARM64)
+  const auto* ucontext =
+      reinterpret_cast<const UContext<ContextTraits64>*>(context);
+  record->thread_context = ucontext->mcontext64.gprs;
+
+  // The FPSIMD registers are in one of the records that follow.
+  constexpr size_t kMaxContextSpace = sizeof(context->uc_mcontext.__reserved);
+  size_t offset = 0;
+  while (kMaxContextSpace - offset >= sizeof(CoprocessorContextHead)) {
+    CoprocessorContextHead head;
+    memcpy(&head, ucontext->reserved + offset, sizeof(head));
+    if (head.magic == 0 || head.size < sizeof(head) ||
+        head.size > kMaxContextSpace - offset) {
+      break;
+    }
+    if (head.magic == FPSIMD_MAGIC &&
+        head.size >= sizeof(head) + sizeof(record->float_context)) {
+      memcpy(&record->float_context,
+             ucontext->reserved + offset + sizeof(head),
+             sizeof(record->float_context));
+      record->has_float_context = 1;
+      break;
+    }
+    offset += head.size;
+  }
+  *stack_pointer = record->thread_context.sp;
+#else
+  return false;
+#endif
+
+  EndRecord(InProcessDumpRecordType::kContext, sizeof(InProcessDumpContext));
+  return true;
+}
+
+void InProcessDumpWriter::AddStack(uint64_t stack_pointer) {
+  uint64_t start = stack_pointer >= kRedZoneSize ? stack_pointer - kRedZoneSize
+                                                 : 0;
+  uint64_t end = 0;
+  ForEachMapping(scratch_, kMapsBufferSize, [&](const Mapping& mapping) {
+    if (mapping.start <= stack_pointer && stack_pointer < mapping.end) {
+      start = std::max(start, mapping.start);
+      end = mapping.end;
+    }
+  });
+  if (end == 0) {
+    // Without the stack’s mapping, rely on ReadMemory() to stop at its end.
+    end = start + kMaxStackSize;
+  }
+
+  size_t size = std::min<uint64_t>(end - start, kMaxStackSize);
+  char* payload = nullptr;
+  while (size > 0 &&
+         !(payload = BeginRecord(sizeof(InProcessDumpMemory) + size))) {
+    size /= 2;
+  }
+  if (!payload) {
+    return;
+  }
+
+  InProcessDumpMemory memory;
+  memory.address = start;
+  memcpy(payload, &memory, sizeof(memory));
+  size = ReadMemory(start, payload + sizeof(memory), size);
+  if (size > 0) {
+    EndRecord(InProcessDumpRecordType::kStack, sizeof(memory) + size);
+  }
+}
+
+void InProcessDumpWriter::AddModules() {
+  ForEachMapping(scratch_, kMapsBufferSize, [this](const Mapping& mapping) {
+    // Each module is identified by its mapping of the start of its file.
+    if (mapping.offset == 0 && mapping.readable && mapping.path_size > 0 &&
+        mapping.path[0] == '/') {
+      AddModule(mapping.start, mapping.path, mapping.path_size);
+    }
+  });
+}
+
+void InProcessDumpWriter::AddModule(uint64_t start,
+                                    const char* path,
+                                    size_t path_size) {
+  Elf64_Ehdr ehdr;
+  if (ReadMemory(start, &ehdr, sizeof(ehdr)) != sizeof(ehdr) ||
+      memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 ||
+      ehdr.e_ident[EI_CLASS] != ELFCLASS64 ||
+      ehdr.e_phentsize != sizeof(Elf64_Phdr)) {
+    return;
+  }
+
+  Elf64_Phdr* phdrs = reinterpret_cast<Elf64_Phdr*>(scratch_ + kMapsBufferSize);
+  const size_t phdr_count = std::min<size_t>(ehdr.e_phnum, kMaxProgramHeaders);
+  const size_t phdrs_size = phdr_count * sizeof(Elf64_Phdr);
+  if (ReadMemory(start + ehdr.e_phoff, phdrs, phdrs_size) != phdrs_size) {
+    return;
+  }
+
+  // The module spans its loadable segments, the first of which is mapped at
+  // start.
+  uint64_t min_vaddr = std::numeric_limits<uint64_t>::max();
+  uint64_t max_vaddr = 0;
+  for (size_t index = 0; index < phdr_count; ++index) {
+    if (phdrs[index].p_type == PT_LOAD) {
+      min_vaddr = std::min(min_vaddr, phdrs[index].p_vaddr);
+      max_vaddr =
+          std::max(max_vaddr, phdrs[index].p_vaddr + phdrs[index].p_memsz);
+    }
+  }
+  min_vaddr &= ~(uint64_t{page_size_} - 1);
+  if (min_vaddr >= max_vaddr) {
+    return;
+  }
+  const uint64_t load_bias = start - min_vaddr;
+
+  char* notes = reinterpret_cast<char*>(phdrs + kMaxProgramHeaders);
+  const char* build_id = nullptr;
+  size_t build_id_size = 0;
+  for (size_t index = 0; index < phdr_count && !build_id; ++index) {
+    if (phdrs[index].p_type == PT_NOTE) {
+      const size_t notes_size = ReadMemory(
+          load_bias + phdrs[index].p_vaddr,
+          notes,
+          std::min<uint64_t>(phdrs[index].p_memsz, kNotesBufferSize));
+      FindBuildID(notes, notes_size, &build_id, &build_id_size);
+    }
+  }
+
+  const size_t size = sizeof(InProcessDumpModule) + build_id_size + path_size;
+  char* payload = BeginRecord(size);
+  if (!payload) {
+    return;
+  }
+  InProcessDumpModule module;
+  module.address = start;
+  module.size = max_vaddr - min_vaddr;
+  module.build_id_size = static_cast<uint32_t>(build_id_size);
+  module.name_size = static_cast<uint32_t>(path_size);
+  memcpy(payload, &module, sizeof(module));
+  if (build_id_size) {
+    memcpy(payload + sizeof(module), build_id, build_id_size);
+  }
+  memcpy(payload + sizeof(module) + build_id_size, path, path_size);
+  EndRecord(InProcessDumpRecordType::kModule, size);
+}
+
+bool InProcessDumpWriter::AddAnnotation(const char* name,
+                                        size_t name_size,
+                                        const char* value,
+                                        size_t value_size) {
+  const size_t size = sizeof(InProcessDumpAnnotation) + name_size + value_size;
+  char* payload = BeginRecord(size);
+  if (!payload) {
+    return false;
+  }
+  InProcessDumpAnnotation annotation;
+  annotation.name_size = static_cast<uint32_t>(name_size);
+  annotation.value_size = static_cast<uint32_t>(value_size);
+  memcpy(payload, &annotation, sizeof(annotation));
+  memcpy(payload + sizeof(annotation), name, name_size);
+  memcpy(payload + sizeof(annotation) + name_size, value, value_size);
+  EndRecord(InProcessDumpRecordType::kAnnotation, size);
+  return true;
+}
+
+void InProcessDumpWriter::AddAnnotations() {
+  const CrashpadInfo* crashpad_info = CrashpadInfo::GetCrashpadInfo();
+
+  const SimpleStringDictionary* simple_annotations =
+      crashpad_info->simple_annotations();
+  if (simple_annotations) {
+    SimpleStringDictionary::Iterator iterator(*simple_annotations);
+    const SimpleStringDictionary::Entry* entry;
+    while ((entry = iterator.Next()) != nullptr) {
+      AddAnnotation(entry->key,
+                    strnlen(entry->key, SimpleStringDictionary::key_size),
+                    entry->value,
+                    strnlen(entry->value, SimpleStringDictionary::value_size));
+    }
+  }
+
+  // Only string annotations are recorded, because other types aren’t
+  // meaningful without their producers’ help.
+  const AnnotationList* annotations_list = crashpad_info->annotations_list();
+  if (annotations_list) {
+    for (const Annotation* annotation : *annotations_list) {
+      if (annotation->type() != Annotation::Type::kString ||
+          !annotation->is_set()) {
+        continue;
+      }
+      AddAnnotation(annotation->name(),
+                    strnlen(annotation->name(), Annotation::kNameMaxLength),
+                    static_cast<const char*>(annotation->value()),
+                    annotation->size());
+    }
+  }
+}
+
+bool InProcessDumpWriter::WriteFile() {
+  InProcessDumpHeader header = {};
+  header.magic = InProcessDumpHeader::kMagic;
+  header.version = InProcessDumpHeader::kVersion;
+  header.architecture =
+      static_cast<uint32_t>(kInProcessDumpNativeArchitecture);
+  header.size = dump_size_;
+  memcpy(dump_, &header, sizeof(header));
+
+  // The dump is written under a temporary name and then renamed, so that a
+  // process converting dumps never sees one that’s incomplete.
+  char* const path = scratch_;
+  char* p = path;
+  memcpy(p, path_prefix_.data(), path_prefix_.size());
+  p = AppendDecimal(p + path_prefix_.size(), dump_count_++);
+  memcpy(p, kExtension, sizeof(kExtension));
+  p += strlen(kExtension);
+
+  char* const temporary_path = scratch_ + kMaxPathSize;
+  memcpy(temporary_path, path, p - path);
+  memcpy(temporary_path + (p - path), kTemporaryExtension,
+         sizeof(kTemporaryExtension));
+
+  const int fd = HANDLE_EINTR(open(temporary_path,
+                                   O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                                   0600));
+  if (fd < 0) {
+    return false;
+  }
+  size_t written = 0;
+  while (written < dump_size_) {
+    const ssize_t rv =
+        HANDLE_EINTR(write(fd, dump_ + written, dump_size_ - written));
+    if (rv <= 0) {
+      break;
+    }
+    written += rv;
+  }
+  close(fd);
+
+  if (written != dump_size_ || rename(temporary_path, path) != 0) {
+    unlink(temporary_path);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,141 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IN_PROCESS_DUMP_WRITER_LINUX_H_
+#define CRASHPAD_CLIENT_IN_PROCESS_DUMP_WRITER_LINUX_H_
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/ucontext.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "client/in_process_dump_format_linux.h"
+#include "util/posix/scoped_mmap.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Writes in-process dumps from a signal handler, without the help of a
+//!     handler process.
+//!
+//! A dump holds the signal, the CPU context and the top of the stack of the
+//! crashing thread, the ELF modules loaded from files, and the string
+//! annotations registered with CrashpadInfo, in the format described in
+//! in_process_dump_format_linux.h. All of the memory that a dump needs is
+//! allocated by Initialize(), so WriteDump() is async-signal-safe. A dump that
+//! doesn’t fit in the arena drops the records that didn’t fit: modules and
+//! annotations are written last.
+//!
+//! Dumps are written to a directory, to be converted to minidumps by
+//! ConvertInProcessDumps() in a later process.
+class InProcessDumpWriter {
+ public:
+  //! \brief The default size of the arena that each dump is assembled in.
+  static constexpr size_t kDefaultArenaSize = 256 * 1024;
+
+  //! \brief The most stack memory that a dump will hold.
+  static constexpr size_t kMaxStackSize = 64 * 1024;
+
+  //! \brief The extension given to each dump written.
+  static constexpr char kExtension[] = ".inprocess";
+
+  //! \brief The extension appended to a dump’s name while it’s being written
+  //!     or converted.
+  static constexpr char kTemporaryExtension[] = ".tmp";
+
+  InProcessDumpWriter();
+
+  InProcessDumpWriter(const InProcessDumpWriter&) = delete;
+  InProcessDumpWriter& operator=(const InProcessDumpWriter&) = delete;
+
+  ~InProcessDumpWriter();
+
+  //! \brief Allocates the arena and prepares to write dumps.
+  //!
+  //! \param[in] dump_dir The directory to write dumps to, which must exist.
+  //! \param[in] annotations Process annotations to include in every dump.
+  //! \param[in] arena_size The size of the arena to allocate. This bounds the
+  //!     size of any dump.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged. This
+  //!     fails on architectures that in-process dumps don’t support.
+  bool Initialize(const base::FilePath& dump_dir,
+                  const std::map<std::string, std::string>& annotations,
+                  size_t arena_size = kDefaultArenaSize);
+
+  //! \brief Writes a dump.
+  //!
+  //! This method is async-signal-safe. If it’s called while another dump is
+  //! being written, it returns `false` without writing anything.
+  //!
+  //! \param[in] siginfo The signal being reported.
+  //! \param[in] context The CPU context of the thread \a thread_id at the time
+  //!     of the signal.
+  //! \param[in] thread_id The thread being reported.
+  //!
+  //! \return `true` if a dump was written, `false` otherwise. Nothing is
+  //!     logged.
+  bool WriteDump(const siginfo_t* siginfo,
+                 const ucontext_t* context,
+                 pid_t thread_id);
+
+ private:
+  // Reserves room for a record with a payload of up to size bytes, returning
+  // where the zeroed payload begins, or nullptr if the record doesn’t fit in
+  // what remains of the arena. EndRecord() adds the record to the dump.
+  char* BeginRecord(size_t size);
+  void EndRecord(InProcessDumpRecordType type, size_t size);
+
+  // Reads memory from this process, returning the number of bytes read before
+  // an inaccessible address was reached.
+  size_t ReadMemory(uint64_t address, void* buffer, size_t size);
+
+  bool AddContext(const ucontext_t* context, uint64_t* stack_pointer);
+  void AddStack(uint64_t stack_pointer);
+  void AddModules();
+  void AddModule(uint64_t start, const char* path, size_t path_size);
+  bool AddAnnotation(const char* name,
+                     size_t name_size,
+                     const char* value,
+                     size_t value_size);
+  void AddAnnotations();
+  bool WriteFile();
+
+  ScopedMmap arena_;
+  std::string path_prefix_;
+  char* scratch_;
+  char* dump_;
+  size_t dump_capacity_;
+  size_t dump_size_;
+
+  // The size of the header and the process annotation records, which begin
+  // every dump and are written once by Initialize().
+  size_t static_size_;
+
+  size_t page_size_;
+  pid_t pid_;
+  uint32_t dump_count_;
+  std::atomic<bool> busy_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IN_PROCESS_DUMP_WRITER_LINUX_H_
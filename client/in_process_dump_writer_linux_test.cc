@@ -0,0 +1,216 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/in_process_dump_writer_linux.h"
+
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "client/crash_report_database.h"
+#include "client/crashpad_info.h"
+#include "client/in_process_dump_converter_linux.h"
+#include "client/simple_string_dictionary.h"
+#include "gtest/gtest.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/filesystem.h"
+#include "util/file/string_file.h"
+#include "util/misc/capture_context.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<base::FilePath> DumpsInDirectory(const base::FilePath& dump_dir) {
+  std::vector<base::FilePath> dumps;
+  DirectoryReader reader;
+  EXPECT_TRUE(reader.Open(dump_dir));
+  base::FilePath filename;
+  while (reader.NextFile(&filename) == DirectoryReader::Result::kSuccess) {
+    dumps.push_back(dump_dir.Append(filename));
+  }
+  return dumps;
+}
+
+TEST(InProcessDumpWriter, WriteAndConvert) {
+  if (internal::kInProcessDumpNativeArchitecture ==
+      internal::InProcessDumpArchitecture::kUnknown) {
+    GTEST_SKIP();
+  }
+
+  ScopedTempDir temp_dir;
+  const base::FilePath dump_dir = temp_dir.path();
+
+  CrashpadInfo* crashpad_info = CrashpadInfo::GetCrashpadInfo();
+  SimpleStringDictionary* const old_simple_annotations =
+      crashpad_info->simple_annotations();
+  SimpleStringDictionary simple_annotations;
+  simple_annotations.SetKeyValue("simple", "value");
+  crashpad_info->set_simple_annotations(&simple_annotations);
+
+  internal::InProcessDumpWriter writer;
+  ASSERT_TRUE(writer.Initialize(dump_dir, {{"process", "annotation"}}));
+
+  NativeCPUContext context;
+  CaptureContext(&context);
+  siginfo_t siginfo = {};
+  siginfo.si_signo = SIGSEGV;
+  siginfo.si_code = SEGV_MAPERR;
+  siginfo.si_addr = reinterpret_cast<void*>(0x1234);
+  const pid_t thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+  const bool written = writer.WriteDump(&siginfo, &context, thread_id);
+  crashpad_info->set_simple_annotations(old_simple_annotations);
+  ASSERT_TRUE(written);
+
+  std::vector<base::FilePath> dumps = DumpsInDirectory(dump_dir);
+  ASSERT_EQ(dumps.size(), 1u);
+  EXPECT_EQ(dumps[0].FinalExtension(),
+            internal::InProcessDumpWriter::kExtension);
+
+  // Truncated dumps aren’t converted.
+  std::string dump;
+  ASSERT_TRUE(LoggingReadEntireFile(dumps[0], &dump));
+  for (size_t size : {size_t{0}, size_t{16}, dump.size() - 1}) {
+    StringFile minidump;
+    EXPECT_FALSE(internal::WriteMinidumpFromInProcessDump(
+        dump.substr(0, size), UUID(), nullptr, &minidump, true));
+  }
+
+  ScopedTempDir database_dir;
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(database_dir.path());
+  ASSERT_TRUE(database);
+  EXPECT_EQ(internal::ConvertInProcessDumps(dump_dir, database.get()), 1u);
+  EXPECT_TRUE(DumpsInDirectory(dump_dir).empty());
+
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(database->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  ASSERT_EQ(reports.size(), 1u);
+
+  FileReader minidump_reader;
+  ASSERT_TRUE(minidump_reader.Open(reports[0].file_path));
+  ProcessSnapshotMinidump snapshot;
+  ASSERT_TRUE(snapshot.Initialize(&minidump_reader));
+
+  UUID report_id;
+  snapshot.ReportID(&report_id);
+  EXPECT_EQ(report_id, reports[0].uuid);
+  EXPECT_EQ(snapshot.ProcessID(), getpid());
+
+  const ExceptionSnapshot* exception = snapshot.Exception();
+  ASSERT_TRUE(exception);
+  EXPECT_EQ(exception->ThreadID(), static_cast<uint64_t>(thread_id));
+  EXPECT_EQ(exception->Exception(), static_cast<uint32_t>(SIGSEGV));
+  EXPECT_EQ(exception->ExceptionInfo(), static_cast<uint32_t>(SEGV_MAPERR));
+  EXPECT_EQ(exception->ExceptionAddress(), 0x1234u);
+
+  const std::vector<const ThreadSnapshot*> threads = snapshot.Threads();
+  ASSERT_EQ(threads.size(), 1u);
+  EXPECT_EQ(threads[0]->ThreadID(), static_cast<uint64_t>(thread_id));
+  const uint64_t stack_pointer = threads[0]->Context()->StackPointer();
+  const MemorySnapshot* stack = threads[0]->Stack();
+  ASSERT_TRUE(stack);
+  EXPECT_LE(stack->Address(), stack_pointer);
+  EXPECT_GT(stack->Address() + stack->Size(), stack_pointer);
+
+  // The module holding this code is one of those recorded.
+  const uint64_t code_address = FromPointerCast<uint64_t>(&DumpsInDirectory);
+  bool found_module = false;
+  for (const ModuleSnapshot* module : snapshot.Modules()) {
+    EXPECT_FALSE(module->Name().empty());
+    if (module->Address() <= code_address &&
+        code_address - module->Address() < module->Size()) {
+      found_module = true;
+    }
+  }
+  EXPECT_TRUE(found_module);
+
+  const std::map<std::string, std::string>& annotations =
+      snapshot.AnnotationsSimpleMap();
+  EXPECT_EQ(annotations.at("process"), "annotation");
+  EXPECT_EQ(annotations.at("simple"), "value");
+}
+
+TEST(InProcessDumpWriter, ConvertInDatabase) {
+  if (internal::kInProcessDumpNativeArchitecture ==
+      internal::InProcessDumpArchitecture::kUnknown) {
+    GTEST_SKIP();
+  }
+
+  ScopedTempDir database_dir;
+  const base::FilePath dump_dir =
+      database_dir.path().Append(internal::kInProcessDumpDirectory);
+  ASSERT_TRUE(
+      LoggingCreateDirectory(dump_dir, FilePermissions::kOwnerOnly, false));
+
+  internal::InProcessDumpWriter writer;
+  ASSERT_TRUE(writer.Initialize(dump_dir, {}));
+  NativeCPUContext context;
+  CaptureContext(&context);
+  siginfo_t siginfo = {};
+  siginfo.si_signo = SIGABRT;
+  ASSERT_TRUE(writer.WriteDump(
+      &siginfo, &context, static_cast<pid_t>(syscall(SYS_gettid))));
+
+  EXPECT_EQ(ConvertInProcessDumps(database_dir.path()), 1u);
+  EXPECT_TRUE(DumpsInDirectory(dump_dir).empty());
+  EXPECT_EQ(ConvertInProcessDumps(database_dir.path()), 0u);
+
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(database_dir.path());
+  ASSERT_TRUE(database);
+  std::vector<CrashReportDatabase::Report> reports;
+  ASSERT_EQ(database->GetPendingReports(&reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_EQ(reports.size(), 1u);
+}
+
+TEST(InProcessDumpWriter, ArenaTooSmall) {
+  if (internal::kInProcessDumpNativeArchitecture ==
+      internal::InProcessDumpArchitecture::kUnknown) {
+    GTEST_SKIP();
+  }
+
+  // The arena must leave room for the crashing thread once the process
+  // annotations are recorded.
+  ScopedTempDir temp_dir;
+  internal::InProcessDumpWriter writer;
+  EXPECT_FALSE(writer.Initialize(
+      temp_dir.path(), {{"process", std::string(4096, 'a')}}, 4096));
+
+  siginfo_t siginfo = {};
+  NativeCPUContext context;
+  CaptureContext(&context);
+  EXPECT_FALSE(writer.WriteDump(&siginfo, &context, 0));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
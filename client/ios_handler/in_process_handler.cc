@@ -14,6 +14,7 @@
 
 #include "client/ios_handler/in_process_handler.h"
 
+#include <dispatch/dispatch.h>
 #include <stdio.h>
 #include <sys/stat.h>
 
@@ -21,6 +22,7 @@
 
 #include "base/logging.h"
 #include "client/ios_handler/in_process_intermediate_dump_handler.h"
+#include "client/ios_handler/in_process_module_cache.h"
 #include "client/prune_crash_reports.h"
 #include "client/settings.h"
 #include "minidump/minidump_file_writer.h"
@@ -123,6 +125,10 @@ bool InProcessHandler::Initialize(
     });
   }
 
+  // Cache module records as images are loaded, so that they don't need to be
+  // read from each image's load commands during a crash.
+  InProcessModuleCache::Install();
+
   base::FilePath cached_writer_path = NewLockedFilePath();
   cached_writer_ = CreateWriterWithPath(cached_writer_path);
   if (!cached_writer_.get())
@@ -261,6 +267,41 @@ void InProcessHandler::ProcessIntermediateDumps(
     ProcessIntermediateDump(file, annotations);
 }
 
+void InProcessHandler::ProcessIntermediateDumpsConcurrently(
+    const std::map<std::string, std::string>& annotations,
+    size_t max_concurrency,
+    qos_class_t qos_class) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::vector<base::FilePath> files = PendingFiles();
+  if (max_concurrency <= 1 || files.size() <= 1) {
+    for (auto& file : files)
+      ProcessIntermediateDump(file, annotations);
+    return;
+  }
+
+  // Each conversion reads its own intermediate dump and writes its own report,
+  // so they only share the database and upload thread, which are safe to use
+  // from multiple threads. The semaphore caps the number of conversions in
+  // flight, and the group lets this method wait for all of them, which keeps
+  // |files| and |annotations| alive for the blocks' use.
+  dispatch_queue_t queue = dispatch_get_global_queue(qos_class, 0);
+  dispatch_group_t group = dispatch_group_create();
+  dispatch_semaphore_t slots = dispatch_semaphore_create(max_concurrency);
+  const std::map<std::string, std::string>* annotations_ptr = &annotations;
+  for (const base::FilePath& file : files) {
+    dispatch_semaphore_wait(slots, DISPATCH_TIME_FOREVER);
+    const base::FilePath* file_ptr = &file;
+    dispatch_group_async(group, queue, ^{
+      ProcessIntermediateDump(*file_ptr, *annotations_ptr);
+      dispatch_semaphore_signal(slots);
+    });
+  }
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+  dispatch_release(slots);
+  dispatch_release(group);
+}
+
 void InProcessHandler::ProcessIntermediateDump(
     const base::FilePath& file,
     const std::map<std::string, std::string>& annotations) {
@@ -359,8 +400,24 @@ void InProcessHandler::SaveSnapshot(
 }
 
 std::vector<base::FilePath> InProcessHandler::PendingFiles() {
-  DirectoryReader reader;
   std::vector<base::FilePath> files;
+
+  // Every file that could be pending is created in or renamed into base_dir_,
+  // which updates its modification time. The time is taken before the scan,
+  // so that a file that arrives during the scan causes another one. Only scans
+  // that found nothing are remembered, because processing any file found
+  // changes the directory anyway.
+  base::AutoLock lock(pending_files_lock_);
+  timespec mtime;
+  const bool have_mtime = FileModificationTime(base_dir_, &mtime);
+  if (have_mtime && empty_scan_valid_ &&
+      mtime.tv_sec == empty_scan_mtime_.tv_sec &&
+      mtime.tv_nsec == empty_scan_mtime_.tv_nsec) {
+    return files;
+  }
+  empty_scan_valid_ = false;
+
+  DirectoryReader reader;
   if (!reader.Open(base_dir_)) {
     return files;
   }
@@ -407,6 +464,16 @@ std::vector<base::FilePath> InProcessHandler::PendingFiles() {
       other_files.begin() +
       std::min(kMaxPendingFiles - files.size(), other_files.size());
   files.insert(files.end(), other_files.begin(), end_iterator);
+
+  // Only trust a modification time that’s at least a couple of seconds old, in
+  // case the file system records it with coarse granularity. A change made in
+  // the same tick as the one this scan saw would otherwise go unnoticed.
+  if (files.empty() && have_mtime &&
+      result == DirectoryReader::Result::kNoMoreFiles &&
+      mtime.tv_sec < time(nullptr) - 1) {
+    empty_scan_mtime_ = mtime;
+    empty_scan_valid_ = true;
+  }
   return files;
 }
 
@@ -466,6 +533,7 @@ InProcessHandler::ScopedReport::ScopedReport(
     : writer_(writer),
       frames_(frames),
       num_frames_(num_frames),
+      vm_read_batch_(),
       rootMap_(writer) {
   DCHECK(writer);
   InProcessIntermediateDumpHandler::WriteHeader(writer);
@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include <mach/mach.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <sys/qos.h>
+#include <time.h>
 
 #include <atomic>
 #include <functional>
@@ -29,6 +32,7 @@
 #include "snapshot/ios/process_snapshot_ios_intermediate_dump.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/ios_system_data_collector.h"
+#include "util/ios/scoped_vm_read.h"
 #include "util/misc/capture_context.h"
 #include "util/misc/initialization_state_dcheck.h"
 
@@ -162,6 +166,23 @@ class InProcessHandler {
   void ProcessIntermediateDumps(
       const std::map<std::string, std::string>& annotations);
 
+  //! \brief Requests that the handler convert all intermediate dumps into
+  //!     minidumps, converting up to \a max_concurrency dumps at a time, and
+  //!     trigger an upload if possible.
+  //!
+  //! Conversions run on a global dispatch queue of \a qos_class. This method
+  //! blocks until every pending dump has been processed.
+  //!
+  //! \param[in] annotations Process annotations to set in each crash report.
+  //! \param[in] max_concurrency The maximum number of dumps to convert at once.
+  //!     A value of `0` or `1` converts dumps one at a time on the calling
+  //!     thread, like ProcessIntermediateDumps().
+  //! \param[in] qos_class The quality of service class of the conversions.
+  void ProcessIntermediateDumpsConcurrently(
+      const std::map<std::string, std::string>& annotations,
+      size_t max_concurrency,
+      qos_class_t qos_class);
+
   //! \brief Requests that the handler convert a specific intermediate dump into
   //!     a minidump and trigger an upload if possible.
   //!
@@ -203,6 +224,7 @@ class InProcessHandler {
     IOSIntermediateDumpWriter* writer_;
     const uint64_t* frames_;
     const size_t num_frames_;
+    ScopedVMReadBatch vm_read_batch_;
     IOSIntermediateDumpWriter::ScopedRootMap rootMap_;
   };
 
@@ -243,6 +265,9 @@ class InProcessHandler {
 
   //! \brief Process a maximum of 20 pending intermediate dumps. Dumps named
   //!     with our bundle id get first priority to prevent spamming.
+  //!
+  //! If the directory hasn’t changed since a scan that found nothing, this
+  //! returns an empty list without reading the directory again.
   std::vector<base::FilePath> PendingFiles();
 
   //! \brief Lock access to the cached intermediate dump writer from
@@ -279,6 +304,13 @@ class InProcessHandler {
   std::unique_ptr<CrashReportDatabase> database_;
   std::string bundle_identifier_and_seperator_;
   IOSSystemDataCollector system_data_;
+
+  // The modification time of base_dir_ when a scan by PendingFiles() last
+  // found nothing to process, valid if empty_scan_valid_ is set.
+  base::Lock pending_files_lock_;
+  timespec empty_scan_mtime_ = {};
+  bool empty_scan_valid_ = false;
+
   InitializationStateDcheck initialized_;
 };
 
@@ -143,6 +143,28 @@ TEST_F(InProcessHandlerTest, TestPendingFileLimit) {
   ClearFiles();
 }
 
+TEST_F(InProcessHandlerTest, TestProcessConcurrently) {
+  // Clear this first to blow away the pending file held by InProcessHandler.
+  ClearFiles();
+
+  // Concurrent processing honors the same pending file limit.
+  CreateFiles(30, 10);
+  handler().ProcessIntermediateDumpsConcurrently({}, 4, QOS_CLASS_UTILITY);
+  VerifyRemainingFileCount(10, 10);
+  ClearFiles();
+
+  CreateFiles(10, 0);
+  handler().ProcessIntermediateDumpsConcurrently({}, 4, QOS_CLASS_UTILITY);
+  VerifyRemainingFileCount(0, 0);
+  ClearFiles();
+
+  // A concurrency of 1 processes dumps serially.
+  CreateFiles(10, 0);
+  handler().ProcessIntermediateDumpsConcurrently({}, 1, QOS_CLASS_BACKGROUND);
+  VerifyRemainingFileCount(0, 0);
+  ClearFiles();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
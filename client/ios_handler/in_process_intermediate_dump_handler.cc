@@ -26,6 +26,7 @@
 
 #include "base/check_op.h"
 #include "build/build_config.h"
+#include "client/ios_handler/in_process_module_cache.h"
 #include "snapshot/snapshot_constants.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/raw_logging.h"
@@ -915,6 +916,30 @@ void InProcessIntermediateDumpHandler::WriteModuleInfo(
     return;
   }
 
+  const InProcessModuleCache* module_cache = InProcessModuleCache::Get();
+  if (module_cache && module_cache->complete()) {
+    WriteModuleInfoFromCache(writer, module_cache);
+  } else {
+    WriteModuleInfoFromDyld(writer, image_infos.get());
+  }
+
+  {
+    IOSIntermediateDumpWriter::ScopedArrayMap modules(writer);
+    if (image_infos->dyldPath) {
+      WritePropertyCString(
+          writer, IntermediateDumpKey::kName, PATH_MAX, image_infos->dyldPath);
+    }
+    uint64_t address =
+        FromPointerCast<uint64_t>(image_infos->dyldImageLoadAddress);
+    WriteProperty(writer, IntermediateDumpKey::kAddress, &address);
+    WriteModuleInfoAtAddress(writer, address, true /*is_dyld=true*/);
+  }
+}
+
+// static
+void InProcessIntermediateDumpHandler::WriteModuleInfoFromDyld(
+    IOSIntermediateDumpWriter* writer,
+    const dyld_all_image_infos* image_infos) {
   uint32_t image_count = image_infos->infoArrayCount;
   const dyld_image_info* image_array = image_infos->infoArray;
   for (uint32_t image_index = 0; image_index < image_count; ++image_index) {
@@ -935,17 +960,51 @@ void InProcessIntermediateDumpHandler::WriteModuleInfo(
         writer, IntermediateDumpKey::kTimestamp, &image->imageFileModDate);
     WriteModuleInfoAtAddress(writer, address, false /*is_dyld=false*/);
   }
+}
+
+// static
+void InProcessIntermediateDumpHandler::WriteModuleInfoFromCache(
+    IOSIntermediateDumpWriter* writer,
+    const InProcessModuleCache* module_cache) {
+  size_t slot_count = module_cache->slot_count();
+  for (size_t index = 0; index < slot_count; ++index) {
+    const InProcessModuleCache::Module* module = module_cache->ModuleAt(index);
+    if (!module)
+      continue;
 
-  {
     IOSIntermediateDumpWriter::ScopedArrayMap modules(writer);
-    if (image_infos->dyldPath) {
+    if (module->name) {
       WritePropertyCString(
-          writer, IntermediateDumpKey::kName, PATH_MAX, image_infos->dyldPath);
+          writer, IntermediateDumpKey::kName, PATH_MAX, module->name);
     }
-    uint64_t address =
-        FromPointerCast<uint64_t>(image_infos->dyldImageLoadAddress);
-    WriteProperty(writer, IntermediateDumpKey::kAddress, &address);
-    WriteModuleInfoAtAddress(writer, address, true /*is_dyld=true*/);
+    WriteProperty(writer, IntermediateDumpKey::kAddress, &module->address);
+    if (module->has_timestamp) {
+      WriteProperty(
+          writer, IntermediateDumpKey::kTimestamp, &module->timestamp);
+    }
+    if (module->has_text_size) {
+      WriteProperty(writer, IntermediateDumpKey::kSize, &module->text_size);
+    }
+    if (module->has_dylib_current_version) {
+      WriteProperty(writer,
+                    IntermediateDumpKey::kDylibCurrentVersion,
+                    &module->dylib_current_version);
+    }
+    if (module->has_source_version) {
+      WriteProperty(writer,
+                    IntermediateDumpKey::kSourceVersion,
+                    &module->source_version);
+    }
+    if (module->has_uuid) {
+      WriteProperty(writer, IntermediateDumpKey::kUUID, &module->uuid);
+    }
+    if (module->crashpad_info_address) {
+      WriteCrashpadInfoAnnotations(writer, module->crashpad_info_address);
+    }
+    if (module->crash_info_address) {
+      WriteCrashInfoAnnotations(writer, module->crash_info_address);
+    }
+    WriteProperty(writer, IntermediateDumpKey::kFileType, &module->file_type);
   }
 }
 
@@ -1131,27 +1190,39 @@ void InProcessIntermediateDumpHandler::WriteDataSegmentAnnotations(
   for (uint32_t sect_index = 0; sect_index <= segment_vm_read_ptr->nsects;
        ++sect_index) {
     if (strcmp(section_vm_read_ptr->sectname, "crashpad_info") == 0) {
-      ScopedVMRead<CrashpadInfo> crashpad_info;
-      if (crashpad_info.Read(section_vm_read_ptr->addr + slide) &&
-          crashpad_info->size() == sizeof(CrashpadInfo) &&
-          crashpad_info->signature() == CrashpadInfo::kSignature &&
-          crashpad_info->version() == 1) {
-        WriteCrashpadAnnotationsList(writer, crashpad_info.get());
-        WriteCrashpadSimpleAnnotationsDictionary(writer, crashpad_info.get());
-      }
+      WriteCrashpadInfoAnnotations(writer, section_vm_read_ptr->addr + slide);
     } else if (strcmp(section_vm_read_ptr->sectname, "__crash_info") == 0) {
-      ScopedVMRead<crashreporter_annotations_t> crash_info;
-      if (!crash_info.Read(section_vm_read_ptr->addr + slide) ||
-          (crash_info->version != 4 && crash_info->version != 5)) {
-        continue;
-      }
-      WriteAppleCrashReporterAnnotations(writer, crash_info.get());
+      WriteCrashInfoAnnotations(writer, section_vm_read_ptr->addr + slide);
     }
     section_vm_read_ptr = reinterpret_cast<const section_64*>(
         reinterpret_cast<uint64_t>(section_vm_read_ptr) + sizeof(section_64));
   }
 }
 
+void InProcessIntermediateDumpHandler::WriteCrashpadInfoAnnotations(
+    IOSIntermediateDumpWriter* writer,
+    uint64_t address) {
+  ScopedVMRead<CrashpadInfo> crashpad_info;
+  if (crashpad_info.Read(address) &&
+      crashpad_info->size() == sizeof(CrashpadInfo) &&
+      crashpad_info->signature() == CrashpadInfo::kSignature &&
+      crashpad_info->version() == 1) {
+    WriteCrashpadAnnotationsList(writer, crashpad_info.get());
+    WriteCrashpadSimpleAnnotationsDictionary(writer, crashpad_info.get());
+  }
+}
+
+void InProcessIntermediateDumpHandler::WriteCrashInfoAnnotations(
+    IOSIntermediateDumpWriter* writer,
+    uint64_t address) {
+  ScopedVMRead<crashreporter_annotations_t> crash_info;
+  if (!crash_info.Read(address) ||
+      (crash_info->version != 4 && crash_info->version != 5)) {
+    return;
+  }
+  WriteAppleCrashReporterAnnotations(writer, crash_info.get());
+}
+
 void InProcessIntermediateDumpHandler::WriteCrashpadAnnotationsList(
     IOSIntermediateDumpWriter* writer,
     CrashpadInfo* crashpad_info) {
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_CLIENT_IOS_HANDLER_IN_PROCESS_INTERMEDIATE_DUMP_HANDLER_H_
 #define CRASHPAD_CLIENT_IOS_HANDLER_IN_PROCESS_INTERMEDIATE_DUMP_HANDLER_H_
 
+#include <mach-o/dyld_images.h>
 #include <mach-o/loader.h>
 #include <mach/mach.h>
 #include <signal.h>
@@ -23,6 +24,7 @@
 #include <map>
 
 #include "client/crashpad_info.h"
+#include "client/ios_handler/in_process_module_cache.h"
 #include "util/ios/ios_intermediate_dump_writer.h"
 #include "util/ios/ios_system_data_collector.h"
 #include "util/mach/mach_extensions.h"
@@ -74,7 +76,10 @@ class InProcessIntermediateDumpHandler final {
 
   //! \brief Write ModuleSnapshot data to the intermediate dump.
   //!
-  //! This includes both modules and annotations.
+  //! This includes both modules and annotations. If
+  //! InProcessModuleCache::Install() has been called, module records are
+  //! written from the cache rather than by parsing each module's load
+  //! commands.
   //!
   //! \param[in] writer The dump writer
   static void WriteModuleInfo(IOSIntermediateDumpWriter* writer);
@@ -133,6 +138,16 @@ class InProcessIntermediateDumpHandler final {
   static void WriteExceptionFromNSException(IOSIntermediateDumpWriter* writer);
 
  private:
+  //! \brief Write a module record for each image in dyld's image list, parsing
+  //!     each image's header and load commands.
+  static void WriteModuleInfoFromDyld(IOSIntermediateDumpWriter* writer,
+                                      const dyld_all_image_infos* image_infos);
+
+  //! \brief Write a module record for each module in \a module_cache.
+  static void WriteModuleInfoFromCache(
+      IOSIntermediateDumpWriter* writer,
+      const InProcessModuleCache* module_cache);
+
   //! \brief Parse and extract module and annotation information from header.
   static void WriteModuleInfoAtAddress(IOSIntermediateDumpWriter* writer,
                                        uint64_t address,
@@ -146,6 +161,16 @@ class InProcessIntermediateDumpHandler final {
       const segment_command_64* segment_vm_read_ptr,
       vm_size_t slide);
 
+  //! \brief Write the annotations of the CrashpadInfo at \a address, if it is
+  //!     valid.
+  static void WriteCrashpadInfoAnnotations(IOSIntermediateDumpWriter* writer,
+                                           uint64_t address);
+
+  //! \brief Write the Apple crashreporter_annotations_t at \a address, if it
+  //!     is a supported version.
+  static void WriteCrashInfoAnnotations(IOSIntermediateDumpWriter* writer,
+                                        uint64_t address);
+
   //! \brief Write Crashpad annotations list.
   static void WriteCrashpadAnnotationsList(IOSIntermediateDumpWriter* writer,
                                            CrashpadInfo* crashpad_info);
@@ -14,6 +14,7 @@
 
 #include "client/ios_handler/in_process_intermediate_dump_handler.h"
 
+#include <mach-o/dyld.h>
 #include <sys/utsname.h>
 
 #include <iterator>
@@ -23,6 +24,7 @@
 #include "client/annotation.h"
 #include "client/annotation_list.h"
 #include "client/crashpad_info.h"
+#include "client/ios_handler/in_process_module_cache.h"
 #include "client/simple_string_dictionary.h"
 #include "gtest/gtest.h"
 #include "snapshot/ios/process_snapshot_ios_intermediate_dump.h"
@@ -31,6 +33,8 @@
 #include "test/test_paths.h"
 #include "util/file/filesystem.h"
 #include "util/misc/capture_context.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/misc/uuid.h"
 
 namespace crashpad {
 namespace test {
@@ -209,6 +213,44 @@ TEST_F(InProcessIntermediateDumpHandlerTest, TestAnnotations) {
   }
 }
 
+TEST_F(InProcessIntermediateDumpHandlerTest, TestModulesFromCache) {
+  internal::InProcessModuleCache::Install();
+  const internal::InProcessModuleCache* module_cache =
+      internal::InProcessModuleCache::Get();
+  ASSERT_TRUE(module_cache);
+  ASSERT_TRUE(module_cache->complete());
+
+  size_t cached_module_count = 0;
+  for (size_t index = 0; index < module_cache->slot_count(); ++index) {
+    if (module_cache->ModuleAt(index))
+      ++cached_module_count;
+  }
+
+  WriteReportAndCloseWriter();
+  internal::ProcessSnapshotIOSIntermediateDump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeWithFilePath(path(), {}));
+
+  // Every cached module is written, followed by dyld.
+  const auto modules = process_snapshot.Modules();
+  EXPECT_EQ(modules.size(), cached_module_count + 1);
+
+  const uint64_t executable_address =
+      FromPointerCast<uint64_t>(_dyld_get_image_header(0));
+  bool saw_executable = false;
+  for (const auto* module : modules) {
+    if (module->Address() != executable_address)
+      continue;
+    saw_executable = true;
+    EXPECT_FALSE(module->Name().empty());
+    EXPECT_GT(module->Size(), 0u);
+    UUID uuid;
+    uint32_t age;
+    module->UUIDAndAge(&uuid, &age);
+    EXPECT_NE(uuid, UUID());
+  }
+  EXPECT_TRUE(saw_executable);
+}
+
 TEST_F(InProcessIntermediateDumpHandlerTest, TestThreads) {
   const ScopedSetThreadName scoped_set_thread_name("TestThreads");
 
@@ -0,0 +1,220 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/ios_handler/in_process_module_cache.h"
+
+#include <dlfcn.h>
+#include <mach-o/dyld.h>
+#include <mach-o/dyld_images.h>
+#include <mach/mach.h>
+#include <string.h>
+
+#include "base/check.h"
+#include "build/build_config.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+std::atomic<InProcessModuleCache*> g_module_cache;
+
+// Looks up the path and modification date dyld recorded for the image loaded
+// at |header|. Returns false if the image isn't in dyld's image list.
+bool FindDyldImageInfo(const mach_header_64* header,
+                       const char** name,
+                       uint64_t* timestamp) {
+  task_dyld_info_data_t dyld_info;
+  mach_msg_type_number_t count = TASK_DYLD_INFO_COUNT;
+  if (task_info(mach_task_self(),
+                TASK_DYLD_INFO,
+                reinterpret_cast<task_info_t>(&dyld_info),
+                &count) != KERN_SUCCESS) {
+    return false;
+  }
+
+  const dyld_all_image_infos* image_infos =
+      reinterpret_cast<const dyld_all_image_infos*>(
+          dyld_info.all_image_info_addr);
+  const dyld_image_info* image_array = image_infos->infoArray;
+  if (!image_array) {
+    // dyld clears infoArray while it is being updated.
+    return false;
+  }
+  for (uint32_t index = 0; index < image_infos->infoArrayCount; ++index) {
+    if (image_array[index].imageLoadAddress ==
+        reinterpret_cast<const mach_header*>(header)) {
+      *name = image_array[index].imageFilePath;
+      *timestamp = image_array[index].imageFileModDate;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+InProcessModuleCache::InProcessModuleCache()
+    : modules_(new Module[kModuleCapacity]()),
+      slot_count_(0),
+      overflowed_(false) {}
+
+InProcessModuleCache::~InProcessModuleCache() = default;
+
+// static
+void InProcessModuleCache::Install() {
+  static InProcessModuleCache* cache = [] {
+    InProcessModuleCache* cache = new InProcessModuleCache();
+    g_module_cache.store(cache, std::memory_order_release);
+    _dyld_register_func_for_add_image(AddImage);
+    _dyld_register_func_for_remove_image(RemoveImage);
+    return cache;
+  }();
+  DCHECK(cache);
+}
+
+// static
+const InProcessModuleCache* InProcessModuleCache::Get() {
+  return g_module_cache.load(std::memory_order_acquire);
+}
+
+const InProcessModuleCache::Module* InProcessModuleCache::ModuleAt(
+    size_t index) const {
+  if (index >= slot_count())
+    return nullptr;
+  const Module* module = &modules_[index];
+  return module->valid.load(std::memory_order_acquire) ? module : nullptr;
+}
+
+// static
+void InProcessModuleCache::AddImage(const mach_header* header,
+                                    intptr_t slide) {
+  g_module_cache.load(std::memory_order_acquire)
+      ->Add(reinterpret_cast<const mach_header_64*>(header));
+}
+
+// static
+void InProcessModuleCache::RemoveImage(const mach_header* header,
+                                       intptr_t slide) {
+  g_module_cache.load(std::memory_order_acquire)
+      ->Remove(reinterpret_cast<const mach_header_64*>(header));
+}
+
+void InProcessModuleCache::Add(const mach_header_64* header) {
+#ifndef ARCH_CPU_64_BITS
+#error Only 64-bit Mach-O is supported
+#endif
+
+  // dyld serializes its image callbacks, so only readers of the cache, which
+  // run during a crash, can be concurrent with this.
+  if (!header || header->magic != MH_MAGIC_64)
+    return;
+
+  size_t count = slot_count_.load(std::memory_order_relaxed);
+  size_t index = 0;
+  while (index < count && modules_[index].valid.load(std::memory_order_relaxed))
+    ++index;
+  if (index == kModuleCapacity) {
+    overflowed_.store(true, std::memory_order_release);
+    return;
+  }
+
+  Module* module = &modules_[index];
+  module->address = FromPointerCast<uint64_t>(header);
+  module->name = nullptr;
+  module->has_timestamp =
+      FindDyldImageInfo(header, &module->name, &module->timestamp);
+  if (!module->name) {
+    Dl_info info;
+    if (dladdr(header, &info) && info.dli_fbase == header)
+      module->name = info.dli_fname;
+  }
+  module->has_text_size = false;
+  module->has_dylib_current_version = false;
+  module->has_source_version = false;
+  module->has_uuid = false;
+  module->file_type = header->filetype;
+  module->crashpad_info_address = 0;
+  module->crash_info_address = 0;
+
+  // The header belongs to a module that is being loaded in this process, so
+  // its load commands can be read directly.
+  const load_command* command =
+      reinterpret_cast<const load_command*>(header + 1);
+  uint64_t slide = 0;
+  for (uint32_t cmd_index = 0, cumulative_cmd_size = 0;
+       cmd_index < header->ncmds && cumulative_cmd_size < header->sizeofcmds;
+       ++cmd_index) {
+    if (command->cmd == LC_SEGMENT_64) {
+      const segment_command_64* segment =
+          reinterpret_cast<const segment_command_64*>(command);
+      if (strcmp(segment->segname, SEG_TEXT) == 0) {
+        module->has_text_size = true;
+        module->text_size = segment->vmsize;
+        slide = module->address - segment->vmaddr;
+      } else if (strcmp(segment->segname, SEG_DATA) == 0) {
+        const section_64* section =
+            reinterpret_cast<const section_64*>(segment + 1);
+        for (uint32_t sect_index = 0; sect_index < segment->nsects;
+             ++sect_index, ++section) {
+          if (strcmp(section->sectname, "crashpad_info") == 0) {
+            module->crashpad_info_address = section->addr + slide;
+          } else if (strcmp(section->sectname, "__crash_info") == 0) {
+            module->crash_info_address = section->addr + slide;
+          }
+        }
+      }
+    } else if (command->cmd == LC_ID_DYLIB) {
+      module->has_dylib_current_version = true;
+      module->dylib_current_version =
+          reinterpret_cast<const dylib_command*>(command)
+              ->dylib.current_version;
+    } else if (command->cmd == LC_SOURCE_VERSION) {
+      module->has_source_version = true;
+      module->source_version =
+          reinterpret_cast<const source_version_command*>(command)->version;
+    } else if (command->cmd == LC_UUID) {
+      module->has_uuid = true;
+      memcpy(module->uuid,
+             reinterpret_cast<const uuid_command*>(command)->uuid,
+             sizeof(module->uuid));
+    }
+
+    cumulative_cmd_size += command->cmdsize;
+    command = reinterpret_cast<const load_command*>(
+        reinterpret_cast<const uint8_t*>(command) + command->cmdsize);
+  }
+
+  // Publish the record only once it is complete.
+  module->valid.store(true, std::memory_order_release);
+  if (index == count)
+    slot_count_.store(count + 1, std::memory_order_release);
+}
+
+void InProcessModuleCache::Remove(const mach_header_64* header) {
+  const uint64_t address = FromPointerCast<uint64_t>(header);
+  size_t count = slot_count_.load(std::memory_order_relaxed);
+  for (size_t index = 0; index < count; ++index) {
+    Module* module = &modules_[index];
+    if (module->valid.load(std::memory_order_relaxed) &&
+        module->address == address) {
+      module->valid.store(false, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,141 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_IOS_HANDLER_IN_PROCESS_MODULE_CACHE_H_
+#define CRASHPAD_CLIENT_IOS_HANDLER_IN_PROCESS_MODULE_CACHE_H_
+
+#include <mach-o/loader.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief A cache of the parts of each loaded module's Mach-O header and load
+//!     commands that do not change while the module is loaded.
+//!
+//! The cache is maintained by dyld add-image and remove-image callbacks, so
+//! that InProcessIntermediateDumpHandler::WriteModuleInfo() can write module
+//! records without walking dyld's image list or parsing load commands at crash
+//! time. Only module annotations, which can change at any time, are still read
+//! during a crash.
+//!
+//! dyld does not support unregistering image callbacks, so once installed, the
+//! cache lives for the remainder of the process.
+class InProcessModuleCache final {
+ public:
+  //! \brief The cached record for a single module.
+  struct Module {
+    //! \brief `true` when this slot holds a loaded module.
+    std::atomic<bool> valid;
+
+    //! \brief The module's load address.
+    uint64_t address;
+
+    //! \brief The module's path, owned by dyld, or `nullptr` if unknown.
+    const char* name;
+
+    //! \brief `true` if #timestamp was found in dyld's image list.
+    bool has_timestamp;
+    uint64_t timestamp;
+
+    //! \brief `true` if the module has a `__TEXT` segment, whose size is
+    //!     #text_size.
+    bool has_text_size;
+    uint64_t text_size;
+
+    bool has_dylib_current_version;
+    uint32_t dylib_current_version;
+
+    bool has_source_version;
+    uint64_t source_version;
+
+    bool has_uuid;
+    uint8_t uuid[16];
+
+    uint32_t file_type;
+
+    //! \brief The address of the module's `crashpad_info` section, or `0`.
+    uint64_t crashpad_info_address;
+
+    //! \brief The address of the module's `__crash_info` section, or `0`.
+    uint64_t crash_info_address;
+  };
+
+  InProcessModuleCache(const InProcessModuleCache&) = delete;
+  InProcessModuleCache& operator=(const InProcessModuleCache&) = delete;
+
+  //! \brief Creates the cache and registers its dyld callbacks, if that has
+  //!     not already been done. dyld immediately invokes the add-image callback
+  //!     for every image that is already loaded.
+  //!
+  //! This is not `RUNS-DURING-CRASH`.
+  static void Install();
+
+  //! \brief Returns the cache if Install() has been called, otherwise
+  //!     `nullptr`.
+  //!
+  //! Note: `RUNS-DURING-CRASH`.
+  static const InProcessModuleCache* Get();
+
+  //! \brief Returns `false` if more modules were loaded than the cache has room
+  //!     for, in which case callers must enumerate modules themselves.
+  //!
+  //! Note: `RUNS-DURING-CRASH`.
+  bool complete() const {
+    return !overflowed_.load(std::memory_order_acquire);
+  }
+
+  //! \brief Returns the number of slots that may be passed to ModuleAt().
+  //!
+  //! Note: `RUNS-DURING-CRASH`.
+  size_t slot_count() const {
+    return slot_count_.load(std::memory_order_acquire);
+  }
+
+  //! \brief Returns the module in slot \a index, or `nullptr` if the slot is
+  //!     not currently in use.
+  //!
+  //! A module may be unloaded and its slot reused while a crash is being
+  //! handled, so pointers in the returned record must only be read with
+  //! `vm_read()`.
+  //!
+  //! Note: `RUNS-DURING-CRASH`.
+  const Module* ModuleAt(size_t index) const;
+
+ private:
+  InProcessModuleCache();
+  ~InProcessModuleCache();
+
+  static void AddImage(const mach_header* header, intptr_t slide);
+  static void RemoveImage(const mach_header* header, intptr_t slide);
+
+  void Add(const mach_header_64* header);
+  void Remove(const mach_header_64* header);
+
+  //! \brief The maximum number of modules that may be cached.
+  static constexpr size_t kModuleCapacity = 2048;
+
+  std::unique_ptr<Module[]> modules_;
+  std::atomic<size_t> slot_count_;
+  std::atomic<bool> overflowed_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_IOS_HANDLER_IN_PROCESS_MODULE_CACHE_H_
@@ -18,6 +18,7 @@
 
 #include "client/prune_crash_reports.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
 #include "util/file/filesystem.h"
 #include "util/ios/scoped_background_task.h"
 
@@ -31,6 +32,11 @@ constexpr char kLockedExtension[] = ".locked";
 // Prune onces a day.
 constexpr time_t prune_interval = 60 * 60 * 24;
 
+// A file beside the intermediate dump directory whose modification time
+// records when pruning last completed, so that it runs once a day across
+// launches, not once per launch.
+constexpr char kLastPruneFile[] = "last-prune";
+
 // If the client finds a locked file matching it's own bundle id, unlock it
 // after 24 hours.
 constexpr time_t matching_bundle_locked_ttl = 60 * 60 * 24;
@@ -102,7 +108,9 @@ PruneIntermediateDumpsAndCrashReportsThread::
     : thread_(prune_interval, this),
       condition_(std::move(condition)),
       pending_path_(pending_path),
+      last_prune_path_(pending_path.DirName().Append(kLastPruneFile)),
       bundle_identifier_and_seperator_(bundle_identifier_and_seperator),
+      clean_old_intermediate_dumps_(false),
       initial_work_delay_(is_extension ? extension_delay : app_delay),
       last_start_time_(0),
       database_(database) {}
@@ -127,6 +135,17 @@ void PruneIntermediateDumpsAndCrashReportsThread::DoWork(
   time_t now = time(nullptr);
   if (now - last_start_time_ < prune_interval)
     return;
+
+  // A prune by an earlier launch of this client, or by another process sharing
+  // the database, counts too.
+  timespec last_prune_time;
+  if (last_start_time_ == 0 && IsRegularFile(last_prune_path_) &&
+      FileModificationTime(last_prune_path_, &last_prune_time) &&
+      last_prune_time.tv_sec <= now &&
+      now - last_prune_time.tv_sec < prune_interval) {
+    last_start_time_ = last_prune_time.tv_sec;
+    return;
+  }
   last_start_time_ = now;
 
   internal::ScopedBackgroundTask scoper("PruneThread");
@@ -143,6 +162,12 @@ void PruneIntermediateDumpsAndCrashReportsThread::DoWork(
     clean_old_intermediate_dumps_ = true;
     UnlockOldIntermediateDumps(pending_path_, bundle_identifier_and_seperator_);
   }
+
+  // Opening with truncation updates the modification time.
+  ScopedFileHandle last_prune(
+      LoggingOpenFileForWrite(last_prune_path_,
+                              FileWriteMode::kTruncateOrCreate,
+                              FilePermissions::kOwnerOnly));
 }
 
 }  // namespace crashpad
@@ -32,9 +32,12 @@ class PruneCondition;
 //!
 //! After the thread is started, the database is pruned using the condition
 //! every 24 hours. Upon calling Start(), the thread waits 5 seconds before
-//! performing the initial prune operation.
+//! performing the initial prune operation. That operation is skipped if the
+//! database was pruned less than 24 hours earlier, such as by a previous
+//! launch, as recorded in a `last-prune` file beside \a pending_path.
 //!
-//! Locked intermediate dump files are unlocked only once, not periodically.
+//! Locked intermediate dump files are unlocked only once, not periodically,
+//! and only by a launch that prunes.
 //! Locked dumps that match this bundle id can be unlocked if they are over a
 //! day old. Otherwise, unlock dumps that are over 60 days old.
 class PruneIntermediateDumpsAndCrashReportsThread
@@ -94,6 +97,7 @@ class PruneIntermediateDumpsAndCrashReportsThread
   WorkerThread thread_;
   std::unique_ptr<PruneCondition> condition_;
   base::FilePath pending_path_;
+  base::FilePath last_prune_path_;
   std::string bundle_identifier_and_seperator_;
   bool clean_old_intermediate_dumps_;
   double initial_work_delay_;
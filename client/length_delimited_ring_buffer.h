@@ -32,6 +32,16 @@ namespace crashpad {
 //! \brief Capacity of a `RingBufferData`, in bytes.
 using RingBufferCapacity = uint32_t;
 
+//! \brief One of several buffers written together by
+//!     `LengthDelimitedRingBufferWriter::PushBatch()`.
+struct RingBufferItem {
+  //! \brief The data to be written.
+  const void* buffer;
+
+  //! \brief The length of `buffer`, in bytes.
+  RingBufferCapacity length;
+};
+
 namespace internal {
 
 //! \brief Default capacity of `RingBufferData`, in bytes.
@@ -87,6 +97,13 @@ constexpr Range::Length Base128VarintEncodedLength(IntegerType value) {
   return size;
 }
 
+//! \brief The largest number of bytes that a value of `IntegerType` occupies
+//!     in Base 128 varint encoding.
+template <typename IntegerType>
+inline constexpr Range::Length kBase128VarintMaxLength =
+    (std::numeric_limits<IntegerType>::digits + kBase128ByteValueBits - 1) /
+    kBase128ByteValueBits;
+
 // Note that std::array capacity is a size_t, not a RingBufferCapacity.
 template <size_t ArrayCapacity>
 using RingBufferArray = std::array<uint8_t, ArrayCapacity>;
@@ -168,17 +185,30 @@ std::optional<Range::Length> ReadBase128VarintFromRingBuffer(
     IntegerType& result) {
   static_assert(std::is_unsigned<IntegerType>::value);
 
+  // Copy out as many bytes as the longest valid varint could need with a
+  // single wrapped read, and decode them locally.
+  constexpr Range::Length kMaxLength = kBase128VarintMaxLength<IntegerType>;
+  uint8_t varint_bytes[kMaxLength];
+  const Range::Length bytes_to_read =
+      std::min(kMaxLength, ring_buffer_read_range.length);
+  internal::Range peek_range = ring_buffer_read_range;
+  if (!ReadBytesFromRingBuffer(
+          ring_buffer_data, peek_range, varint_bytes, bytes_to_read)) {
+    return std::nullopt;
+  }
+
   result = 0;
   uint8_t cur_varint_byte = 0;
   constexpr uint8_t kValueMask = 0x7f;
   constexpr uint8_t kContinuationMask = 0x80;
   Range::Length length = 0;
   do {
-    if (!ReadBytesFromRingBuffer(
-            ring_buffer_data, ring_buffer_read_range, &cur_varint_byte, 1)) {
-      // No capacity remaining in `ring_buffer_read_range` to read the varint.
+    if (length == bytes_to_read) {
+      // No capacity remaining in `ring_buffer_read_range` to read the varint,
+      // or too many bytes with kContinuationMask set.
       return std::nullopt;
     }
+    cur_varint_byte = varint_bytes[length];
     IntegerType cur_varint_value =
         static_cast<IntegerType>(cur_varint_byte & kValueMask);
 
@@ -186,13 +216,10 @@ std::optional<Range::Length> ReadBase128VarintFromRingBuffer(
     //
     // result |= (cur_varint_value << (length * kBase128ByteValueBits));
     //
-    // but checks the result at each step for overflow, which handles two types
-    // of invalid input:
-    //
-    // 1) Too many bytes with kContinuationMask set (e.g., trying to encode 6
-    //    bytes worth of data in a 32-bit value)
-    // 2) Too many bits in the final byte (e.g., the 5th byte for a 32-bit value
-    //    has bits 33 and 34 set)
+    // but checks the result at each step for overflow, which catches too many
+    // bits in the final byte (e.g., the 5th byte for a 32-bit value has bits
+    // 33 and 34 set). Too many bytes with kContinuationMask set are caught
+    // above.
     IntegerType next_result_bits;
     if (!base::CheckLsh(cur_varint_value, length * kBase128ByteValueBits)
              .AssignIfValid(&next_result_bits)) {
@@ -201,6 +228,10 @@ std::optional<Range::Length> ReadBase128VarintFromRingBuffer(
     result |= next_result_bits;
     ++length;
   } while ((cur_varint_byte & kContinuationMask) == kContinuationMask);
+
+  ring_buffer_read_range.offset = (ring_buffer_read_range.offset + length) %
+                                  RingBufferArraySize(ring_buffer_data);
+  ring_buffer_read_range.length -= length;
   return length;
 }
 
@@ -224,9 +255,7 @@ bool WriteBytesToRingBuffer(const uint8_t* const source_buffer,
                             Range::Length source_buffer_length,
                             RingBufferArrayType& ring_buffer_data,
                             internal::Range& ring_buffer_write_range) {
-  const Range::Length ring_buffer_bytes_remaining =
-      RingBufferArraySize(ring_buffer_data) - ring_buffer_write_range.length;
-  if (source_buffer_length > ring_buffer_bytes_remaining) {
+  if (source_buffer_length > ring_buffer_write_range.length) {
     return false;
   }
   const Range::Length initial_write_length = std::min(
@@ -271,26 +300,23 @@ std::optional<int> WriteBase128VarintToRingBuffer(
     internal::Range& ring_buffer_write_range) {
   static_assert(std::is_unsigned<IntegerType>::value);
 
-  uint8_t cur_varint_byte;
+  // Encode locally, then write all of the bytes with a single wrapped write.
+  uint8_t varint_bytes[kBase128VarintMaxLength<IntegerType>];
   constexpr uint8_t kValueMask = 0x7f;
   constexpr uint8_t kContinuationMask = 0x80;
 
-  // Every varint encodes to at least 1 byte of data.
-  int length = 1;
-
+  int length = 0;
   while (value > kValueMask) {
-    cur_varint_byte =
+    varint_bytes[length++] =
         (static_cast<uint8_t>(value) & kValueMask) | kContinuationMask;
-    if (!WriteBytesToRingBuffer(
-            &cur_varint_byte, 1, ring_buffer_data, ring_buffer_write_range)) {
-      return std::nullopt;
-    }
     value >>= kBase128ByteValueBits;
-    ++length;
   }
-  cur_varint_byte = static_cast<uint8_t>(value);
-  if (!WriteBytesToRingBuffer(
-          &cur_varint_byte, 1, ring_buffer_data, ring_buffer_write_range)) {
+  varint_bytes[length++] = static_cast<uint8_t>(value);
+
+  if (!WriteBytesToRingBuffer(varint_bytes,
+                              static_cast<Range::Length>(length),
+                              ring_buffer_data,
+                              ring_buffer_write_range)) {
     return std::nullopt;
   }
   return length;
@@ -488,7 +514,7 @@ LengthDelimitedRingBufferReader(RingBufferDataType&)
 //! `RingBufferDataType::size()` bytes of variable-length buffers each
 //! preceded by its length (encoded as a Base128 length varint).
 //!
-//! Provides writing capabilities via `Push()`.
+//! Provides writing capabilities via `Push()` and `PushBatch()`.
 template <typename RingBufferDataType>
 class LengthDelimitedRingBufferWriter final {
  public:
@@ -518,21 +544,42 @@ class LengthDelimitedRingBufferWriter final {
   //!     Otherwise, returns `false`.
   bool Push(const void* const buffer,
             typename RingBufferDataType::SizeType buffer_length) {
-    if (buffer_length == 0) {
-      // Pushing a zero-length buffer is not allowed
-      // (`LengthDelimitedRingBufferWriter` reserves that to represent a
-      // temporarily truncated item below).
-      return false;
+    const RingBufferItem item = {buffer, buffer_length};
+    return PushBatch(&item, 1);
+  }
+
+  //! \brief Writes several buffers to the ring buffer in one operation.
+  //!
+  //! This is equivalent to calling `Push()` for each item in turn, but makes
+  //! room for all of them at once and updates `ring_buffer.data_range` only
+  //! once. Either all of the items are written, or none are.
+  //!
+  //! \param[in] items The buffers to be written, in order.
+  //! \param[in] item_count The number of elements in `items`.
+  //! \return `true` on success. `false` if any item has a length of `0`, or
+  //!     if the items together don’t fit in the ring buffer.
+  bool PushBatch(const RingBufferItem* items, size_t item_count) {
+    internal::Range::Length bytes_needed = 0;
+    for (size_t index = 0; index < item_count; ++index) {
+      if (items[index].length == 0) {
+        // Pushing a zero-length buffer is not allowed
+        // (`LengthDelimitedRingBufferWriter` reserves that to represent a
+        // temporarily truncated item below).
+        return false;
+      }
+      const internal::Range::Length item_bytes_needed =
+          internal::Base128VarintEncodedLength(items[index].length) +
+          items[index].length;
+      if (item_bytes_needed > ring_buffer_.data.size() - bytes_needed) {
+        return false;
+      }
+      bytes_needed += item_bytes_needed;
     }
-    const internal::Range::Length buffer_varint_encoded_length =
-        internal::Base128VarintEncodedLength(buffer_length);
-    const internal::Range::Length bytes_needed =
-        buffer_varint_encoded_length + buffer_length;
-    if (bytes_needed > ring_buffer_.data.size()) {
+    if (bytes_needed == 0) {
       return false;
     }
     // If needed, move the readable region forward one buffer at a time to make
-    // room for `buffer_length` bytes of new data.
+    // room for `bytes_needed` bytes of new data.
     auto readable_data_range = ring_buffer_.header.data_range;
     internal::Range::Length bytes_available =
         internal::RingBufferArraySize(ring_buffer_.data) -
@@ -551,24 +598,24 @@ class LengthDelimitedRingBufferWriter final {
       readable_data_range.length -= bytes_to_skip;
       bytes_available += varint_length.value() + bytes_to_skip;
     }
-    // Write the varint containing `buffer_length` to the current write
-    // position.
+    // Write each varint containing an item’s length, followed by the item’s
+    // bytes, starting at the current write position.
     internal::Range write_range = {
         ring_buffer_write_offset_,
         bytes_needed,
     };
-
-    internal::WriteBase128VarintToRingBuffer(
-        buffer_length, ring_buffer_.data, write_range);
-    // Next, write the bytes from `buffer`.
-    internal::WriteBytesToRingBuffer(
-        reinterpret_cast<const uint8_t* const>(buffer),
-        buffer_length,
-        ring_buffer_.data,
-        write_range);
+    for (size_t index = 0; index < item_count; ++index) {
+      internal::WriteBase128VarintToRingBuffer(
+          items[index].length, ring_buffer_.data, write_range);
+      internal::WriteBytesToRingBuffer(
+          reinterpret_cast<const uint8_t*>(items[index].buffer),
+          items[index].length,
+          ring_buffer_.data,
+          write_range);
+    }
     // Finally, update the write position and read data range taking into
-    // account any items skipped to make room plus the new buffer's varint
-    // length and the new buffer's length.
+    // account any items skipped to make room plus the new items’ varint
+    // lengths and the new items’ lengths.
     ring_buffer_write_offset_ = write_range.offset;
     const internal::Range final_data_range = {
         readable_data_range.offset,
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <array>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -255,6 +256,117 @@ TEST(LengthDelimitedRingBufferDataTest, PushThenPopWithLengthVarintTwoBytes) {
   EXPECT_THAT(result, Eq(s));
 }
 
+TEST(LengthDelimitedRingBufferDataTest,
+     PushThenPopWithLengthVarintWrappingAroundEnd) {
+  RingBufferData<200> ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  const std::string first(197, 'A');
+  ASSERT_THAT(writer.Push(first.data(), first.size()),
+              IsTrue());  // Writes 199 bytes (2 for length)
+  const std::string second(150, 'B');
+  ASSERT_THAT(writer.Push(second.data(), second.size()),
+              IsTrue());  // Overwrites "A", with its length split at the end
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<uint8_t> result;
+  EXPECT_THAT(reader.Pop(result), IsTrue());
+  EXPECT_THAT(std::string(result.begin(), result.end()), Eq(second));
+
+  std::vector<uint8_t> empty;
+  EXPECT_THAT(reader.Pop(empty), IsFalse());
+}
+
+TEST(LengthDelimitedRingBufferDataTest, PushExactlyFillingBufferThenPop) {
+  RingBufferData<sizeof(kHello) + 1> ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  ASSERT_THAT(writer.Push(kHello, sizeof(kHello)), IsTrue());
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<uint8_t> result;
+  EXPECT_THAT(reader.Pop(result), IsTrue());
+  const std::vector<uint8_t> expected = {0x68, 0x65, 0x6c, 0x6c, 0x6f};
+  EXPECT_THAT(result, Eq(expected));
+}
+
+TEST(LengthDelimitedRingBufferDataTest, PushBatchThenPop) {
+  RingBufferData ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  constexpr uint8_t a = 0x41;
+  const std::string long_item(150, 'X');
+  const RingBufferItem items[] = {
+      {&a, sizeof(a)},
+      {kHello, sizeof(kHello)},
+      {long_item.data(), static_cast<RingBufferCapacity>(long_item.size())},
+  };
+  ASSERT_THAT(writer.PushBatch(items, std::size(items)), IsTrue());
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<uint8_t> first;
+  EXPECT_THAT(reader.Pop(first), IsTrue());
+  EXPECT_THAT(first, Eq(std::vector<uint8_t>{0x41}));
+  std::vector<uint8_t> second;
+  EXPECT_THAT(reader.Pop(second), IsTrue());
+  EXPECT_THAT(second, Eq(std::vector<uint8_t>{0x68, 0x65, 0x6c, 0x6c, 0x6f}));
+  std::vector<uint8_t> third;
+  EXPECT_THAT(reader.Pop(third), IsTrue());
+  EXPECT_THAT(std::string(third.begin(), third.end()), Eq(long_item));
+
+  std::vector<uint8_t> empty;
+  EXPECT_THAT(reader.Pop(empty), IsFalse());
+}
+
+TEST(LengthDelimitedRingBufferDataTest,
+     PushBatchOnFullBufferShouldOverwriteOldest) {
+  RingBufferData<8> ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  constexpr uint8_t a = 0x41;
+  constexpr uint8_t b = 0x42;
+  EXPECT_THAT(writer.Push(&a, sizeof(a)), IsTrue());
+  EXPECT_THAT(writer.Push(&b, sizeof(b)), IsTrue());
+
+  // Needs 5 bytes; should overwrite "A" only.
+  constexpr uint8_t c = 0x43;
+  constexpr uint8_t de[] = {0x44, 0x45};
+  const RingBufferItem items[] = {{&c, sizeof(c)}, {de, sizeof(de)}};
+  EXPECT_THAT(writer.PushBatch(items, std::size(items)), IsTrue());
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<uint8_t> first;
+  EXPECT_THAT(reader.Pop(first), IsTrue());
+  EXPECT_THAT(first, Eq(std::vector<uint8_t>{0x42}));
+  std::vector<uint8_t> second;
+  EXPECT_THAT(reader.Pop(second), IsTrue());
+  EXPECT_THAT(second, Eq(std::vector<uint8_t>{0x43}));
+  std::vector<uint8_t> third;
+  EXPECT_THAT(reader.Pop(third), IsTrue());
+  EXPECT_THAT(third, Eq(std::vector<uint8_t>{0x44, 0x45}));
+}
+
+TEST(LengthDelimitedRingBufferDataTest, PushBatchShouldWriteAllOrNothing) {
+  RingBufferData<8> ring_buffer;
+  LengthDelimitedRingBufferWriter writer(ring_buffer);
+  constexpr uint8_t a = 0x41;
+  EXPECT_THAT(writer.Push(&a, sizeof(a)), IsTrue());
+
+  EXPECT_THAT(writer.PushBatch(nullptr, 0), IsFalse());
+
+  const RingBufferItem with_empty_item[] = {{kHello, 1}, {kHello, 0}};
+  EXPECT_THAT(writer.PushBatch(with_empty_item, std::size(with_empty_item)),
+              IsFalse());
+
+  // Each fits on its own, but not together.
+  const RingBufferItem too_large[] = {{kHello, sizeof(kHello)},
+                                      {kHello, sizeof(kHello)}};
+  EXPECT_THAT(writer.PushBatch(too_large, std::size(too_large)), IsFalse());
+
+  LengthDelimitedRingBufferReader reader(ring_buffer);
+  std::vector<uint8_t> first;
+  EXPECT_THAT(reader.Pop(first), IsTrue());
+  EXPECT_THAT(first, Eq(std::vector<uint8_t>{0x41}));
+  std::vector<uint8_t> empty;
+  EXPECT_THAT(reader.Pop(empty), IsFalse());
+}
+
 TEST(LengthDelimitedRingBufferDataTest, DeserializeFromTooShortShouldFail) {
   RingBufferData<1> ring_buffer;
   EXPECT_THAT(ring_buffer.DeserializeFromBuffer(nullptr, 0), IsFalse());
@@ -0,0 +1,149 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CRASHPAD_CLIENT_MAPPED_BREADCRUMB_LOG_H_
+#define CRASHPAD_CLIENT_MAPPED_BREADCRUMB_LOG_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include <new>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "client/multi_producer_ring_buffer.h"
+#include "util/file/file_io.h"
+#include "util/posix/scoped_mmap.h"
+
+namespace crashpad {
+
+//! \brief A ring buffer of breadcrumbs kept in a shared mapping of a file, so
+//!     that the handler can collect it from the file instead of from the
+//!     client’s memory.
+//!
+//! A `RingBufferAnnotation` lives in the client’s heap, so the handler reads it
+//! from the client’s memory while the client is suspended, which costs remote
+//! reads in proportion to its size and fails if that memory can’t be read.
+//! This log instead places a `MultiProducerRingBufferData` in a `MAP_SHARED`
+//! mapping of a file. Pushes land in the file’s pages as they’re made, and
+//! remain there after the client crashes or exits.
+//!
+//! To have the handler collect the log, pass path() among the `attachments`
+//! given to CrashpadClient::StartHandler(). The handler copies each attachment
+//! into every crash report it writes, so a log of several megabytes is
+//! collected without reading the client’s memory at all. A server reads the
+//! attachment’s items with `MultiProducerRingBufferReader`, as it would the
+//! value of an annotation holding a `MultiProducerRingBufferData`.
+//!
+//! The file should be on a file system that isn’t shared with other machines,
+//! and preferably in memory such as `tmpfs`, because every push dirties a page
+//! that the kernel will eventually write back.
+//!
+//! \tparam SlotCount The number of items that the log holds.
+//! \tparam SlotSize The capacity of each item, in bytes. This must be a
+//!     non-zero multiple of 8.
+template <uint32_t SlotCount, uint32_t SlotSize>
+class MappedBreadcrumbLog final {
+ public:
+  //! \brief The ring buffer stored at the start of the file.
+  using Data = MultiProducerRingBufferData<SlotCount, SlotSize>;
+
+  MappedBreadcrumbLog() : path_(), mapping_(), data_(nullptr) {}
+
+  MappedBreadcrumbLog(const MappedBreadcrumbLog&) = delete;
+  MappedBreadcrumbLog& operator=(const MappedBreadcrumbLog&) = delete;
+
+  //! \brief Unmaps the file, leaving its contents in place.
+  ~MappedBreadcrumbLog() = default;
+
+  //! \brief Creates or replaces the file at \a path with an empty log and maps
+  //!     it.
+  //!
+  //! Anything the file held before, such as the log of an earlier run, is
+  //! discarded. This method must be called once, before Push().
+  //!
+  //! \param[in] path The path of the file to hold the log.
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Initialize(const base::FilePath& path) {
+    DCHECK(!data_);
+
+    // Truncating the file discards what it held, so that all of its pages
+    // read as zero once it has been extended.
+    ScopedFileHandle file(
+        LoggingOpenFileForReadAndWrite(path,
+                                       FileWriteMode::kTruncateOrCreate,
+                                       FilePermissions::kOwnerOnly));
+    if (!file.is_valid()) {
+      return false;
+    }
+
+    // The file is extended with its storage reserved, rather than left sparse,
+    // so that the first write to each page through the mapping can’t raise
+    // SIGBUS when the disk is full.
+    int result;
+    do {
+      result = posix_fallocate(file.get(), 0, sizeof(Data));
+    } while (result == EINTR);
+    if (result != 0) {
+      errno = result;
+      PLOG(ERROR) << "posix_fallocate";
+      return false;
+    }
+
+    // The mapping remains valid once the file is closed.
+    if (!mapping_.ResetMmap(nullptr,
+                            sizeof(Data),
+                            PROT_READ | PROT_WRITE,
+                            MAP_SHARED,
+                            file.get(),
+                            0)) {
+      return false;
+    }
+    data_ = new (mapping_.addr()) Data();
+    path_ = path;
+    return true;
+  }
+
+  //! \brief Pushes an item into the log, replacing the oldest once it’s full.
+  //!
+  //! Like `MultiProducerRingBufferWriter::Push()`, this method is lock-free,
+  //! may be called concurrently from any number of threads, and is safe to
+  //! call from a signal handler.
+  //!
+  //! \param[in] buffer The item’s bytes.
+  //! \param[in] buffer_length The length of \a buffer, in bytes.
+  //! \return `true` on success. `false` if Initialize() didn’t succeed, or for
+  //!     any of the reasons that `MultiProducerRingBufferWriter::Push()` fails.
+  bool Push(const void* buffer, uint32_t buffer_length) {
+    if (!data_) {
+      return false;
+    }
+    MultiProducerRingBufferWriter writer(*data_);
+    return writer.Push(buffer, buffer_length);
+  }
+
+  //! \return The path of the file holding the log, valid once Initialize() has
+  //!     succeeded.
+  const base::FilePath& path() const { return path_; }
+
+ private:
+  base::FilePath path_;
+  ScopedMmap mapping_;
+  Data* data_;  // weak, in mapping_
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_MAPPED_BREADCRUMB_LOG_H_
@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "client/mapped_breadcrumb_log.h"
+
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using TestLog = MappedBreadcrumbLog<4, 16>;
+
+std::vector<std::string> ReadAllFromFile(const base::FilePath& path) {
+  std::string contents;
+  EXPECT_TRUE(LoggingReadEntireFile(path, &contents));
+  MultiProducerRingBufferReader reader(contents.data(), contents.size());
+  EXPECT_TRUE(reader.IsValid());
+  std::vector<std::string> items;
+  std::vector<uint8_t> item;
+  while (reader.Pop(item)) {
+    items.emplace_back(item.begin(), item.end());
+    item.clear();
+  }
+  return items;
+}
+
+TEST(MappedBreadcrumbLog, PushAndReadFromFile) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path = temp_dir.path().Append("breadcrumbs");
+
+  TestLog log;
+  EXPECT_FALSE(log.Push("early", 5));
+  ASSERT_TRUE(log.Initialize(path));
+  EXPECT_EQ(log.path(), path);
+  EXPECT_EQ(ReadAllFromFile(path), std::vector<std::string>());
+
+  // Pushes are visible in the file at once, without anything being flushed.
+  ASSERT_TRUE(log.Push("one", 3));
+  ASSERT_TRUE(log.Push("two", 3));
+  EXPECT_EQ(ReadAllFromFile(path), (std::vector<std::string>{"one", "two"}));
+
+  EXPECT_FALSE(log.Push("", 0));
+  EXPECT_FALSE(log.Push("seventeen bytes!!", 17));
+
+  // Once full, the oldest items are replaced.
+  for (const char* item : {"three", "four", "five", "six"}) {
+    ASSERT_TRUE(log.Push(item, strlen(item)));
+  }
+  EXPECT_EQ(ReadAllFromFile(path),
+            (std::vector<std::string>{"three", "four", "five", "six"}));
+}
+
+TEST(MappedBreadcrumbLog, OutlivesMapping) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path = temp_dir.path().Append("breadcrumbs");
+
+  {
+    TestLog log;
+    ASSERT_TRUE(log.Initialize(path));
+    ASSERT_TRUE(log.Push("kept", 4));
+  }
+  EXPECT_EQ(ReadAllFromFile(path), std::vector<std::string>{"kept"});
+
+  // A new log replaces the old one.
+  TestLog log;
+  ASSERT_TRUE(log.Initialize(path));
+  EXPECT_EQ(ReadAllFromFile(path), std::vector<std::string>());
+}
+
+TEST(MappedBreadcrumbLog, InitializeFailure) {
+  ScopedTempDir temp_dir;
+  TestLog log;
+  EXPECT_FALSE(log.Initialize(temp_dir.path().Append("missing/breadcrumbs")));
+  EXPECT_FALSE(log.Push("item", 4));
+}
+
+TEST(MappedBreadcrumbLog, InitializeFailsWithoutSpace) {
+  // The file’s storage is reserved when it’s created, so a log without room
+  // fails to initialize instead of crashing on a later write. Limiting the
+  // size of files this process may write leaves no room.
+  ScopedTempDir temp_dir;
+  rlimit old_limit;
+  ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &old_limit), 0)
+      << ErrnoMessage("getrlimit");
+  struct sigaction ignore_action = {};
+  ignore_action.sa_handler = SIG_IGN;
+  struct sigaction old_action;
+  ASSERT_EQ(sigaction(SIGXFSZ, &ignore_action, &old_action), 0)
+      << ErrnoMessage("sigaction");
+  rlimit limit = old_limit;
+  limit.rlim_cur = sizeof(TestLog::Data) / 2;
+  ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0) << ErrnoMessage("setrlimit");
+
+  TestLog log;
+  const bool initialized =
+      log.Initialize(temp_dir.path().Append("breadcrumbs"));
+
+  EXPECT_EQ(setrlimit(RLIMIT_FSIZE, &old_limit), 0)
+      << ErrnoMessage("setrlimit");
+  EXPECT_EQ(sigaction(SIGXFSZ, &old_action, nullptr), 0)
+      << ErrnoMessage("sigaction");
+  EXPECT_FALSE(initialized);
+  EXPECT_FALSE(log.Push("item", 4));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,358 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_MULTI_PRODUCER_RING_BUFFER_H_
+#define CRASHPAD_CLIENT_MULTI_PRODUCER_RING_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <vector>
+
+#include "base/numerics/safe_math.h"
+
+namespace crashpad {
+
+namespace internal {
+
+//! \brief The magic signature of a `MultiProducerRingBufferData`.
+inline constexpr uint32_t kMultiProducerRingBufferMagic = 0xcab00d1f;
+
+//! \brief The version of a `MultiProducerRingBufferData`.
+inline constexpr uint32_t kMultiProducerRingBufferVersion = 1;
+
+//! \brief Computes the checksum stored alongside each item in a
+//!     `MultiProducerRingBufferData` slot.
+//!
+//! The checksum covers the item’s sequence number as well as its bytes, so a
+//! slot whose bytes were copied while it was being rewritten for a later item
+//! fails validation.
+inline uint32_t MultiProducerRingBufferChecksum(uint64_t sequence,
+                                                const uint8_t* data,
+                                                uint32_t length) {
+  // 32-bit FNV-1a.
+  uint32_t hash = 2166136261u;
+  auto add_bytes = [&hash](const uint8_t* bytes, size_t size) {
+    for (size_t index = 0; index < size; ++index) {
+      hash = (hash ^ bytes[index]) * 16777619u;
+    }
+  };
+  add_bytes(reinterpret_cast<const uint8_t*>(&sequence), sizeof(sequence));
+  add_bytes(reinterpret_cast<const uint8_t*>(&length), sizeof(length));
+  add_bytes(data, length);
+  return hash;
+}
+
+}  // namespace internal
+
+//! \brief Storage for a ring buffer of `SlotCount` fixed-size slots, each
+//!     holding one variable-length item of up to `SlotSize` bytes, which many
+//!     threads can push to without a lock.
+//!
+//! Each push reserves the next sequence number by atomically advancing
+//! `header.next_sequence`, and stores its item in the slot selected by that
+//! sequence number. A slot’s `state` records which sequence number it holds
+//! and whether the write has completed, and its checksum lets a reader reject
+//! a slot whose bytes were copied while they were being written.
+//!
+//! The structure of this object is:
+//!
+//! `|magic|version|slot_count|slot_size|next_sequence|slots...|`
+//!
+//! where each slot is:
+//!
+//! `|state|length|checksum|data|`
+//!
+//! To write data to this object, see `MultiProducerRingBufferWriter`. To read
+//! data from a copy of this object’s bytes, see
+//! `MultiProducerRingBufferReader`.
+//!
+//! The bytes of this structure are suitable for direct serialization from
+//! memory to disk, e.g. as a crashpad::Annotation.
+template <uint32_t SlotCount, uint32_t SlotSize>
+struct MultiProducerRingBufferData final {
+  static_assert(SlotCount > 0);
+  static_assert(SlotSize > 0 && SlotSize % 8 == 0,
+                "SlotSize must be a non-zero multiple of 8 to keep slots "
+                "aligned");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  constexpr MultiProducerRingBufferData() = default;
+  MultiProducerRingBufferData(const MultiProducerRingBufferData&) = delete;
+  MultiProducerRingBufferData& operator=(const MultiProducerRingBufferData&) =
+      delete;
+
+  //! \brief Resets the state of the ring buffer (e.g., for testing).
+  //! This method is not thread-safe.
+  void ResetForTesting() {
+    header.next_sequence.store(0, std::memory_order_relaxed);
+    for (Slot& slot : slots) {
+      slot.state.store(kStateUnused, std::memory_order_relaxed);
+    }
+  }
+
+  //! \brief The magic signature of the ring buffer.
+  static constexpr uint32_t kMagic = internal::kMultiProducerRingBufferMagic;
+  //! \brief The version of the ring buffer.
+  static constexpr uint32_t kVersion =
+      internal::kMultiProducerRingBufferVersion;
+
+  //! \brief The value of Slot::state for a slot that has never been written.
+  //!
+  //! Otherwise, a slot holding the item with sequence number `n` has state
+  //! `2 * n + 1` while the item is being written, and `2 * n + 2` once it has
+  //! been completely written.
+  static constexpr uint64_t kStateUnused = 0;
+
+  //! \brief A header containing metadata preceding the slots.
+  struct Header final {
+    constexpr Header()
+        : magic(kMagic),
+          version(kVersion),
+          slot_count(SlotCount),
+          slot_size(SlotSize),
+          next_sequence(0) {}
+
+    //! \brief The fixed magic value identifying this as a ring buffer.
+    const uint32_t magic;
+
+    //! \brief The version of this ring buffer data.
+    const uint32_t version;
+
+    //! \brief The number of slots following the header.
+    const uint32_t slot_count;
+
+    //! \brief The capacity in bytes of each slot’s data.
+    const uint32_t slot_size;
+
+    //! \brief The sequence number that the next push will use.
+    std::atomic<uint64_t> next_sequence;
+  };
+
+  //! \brief A single item in the ring buffer.
+  struct Slot final {
+    constexpr Slot() : state(kStateUnused), length(0), checksum(0), data() {}
+
+    //! \brief The sequence number of the item in this slot, and whether it has
+    //!     been completely written. See #kStateUnused.
+    std::atomic<uint64_t> state;
+
+    //! \brief The length in bytes of the item in #data.
+    uint32_t length;
+
+    //! \brief The internal::MultiProducerRingBufferChecksum() of the item.
+    uint32_t checksum;
+
+    //! \brief The bytes of the item.
+    uint8_t data[SlotSize];
+  };
+
+  //! \brief The header containing ring buffer metadata.
+  Header header;
+
+  //! \brief The slots holding the items.
+  Slot slots[SlotCount];
+
+  // The reader relies on this layout, so it must not change.
+  static_assert(sizeof(Header) == 24);
+  static_assert(sizeof(Slot) == 16 + SlotSize);
+};
+
+//! \brief Pushes variable-length items into a `MultiProducerRingBufferData`
+//!     from any number of threads without a lock.
+//!
+//! When the ring buffer is full, each push replaces the oldest item.
+template <typename RingBufferDataType>
+class MultiProducerRingBufferWriter final {
+ public:
+  //! \brief Constructs a writer which holds a reference to `ring_buffer`.
+  //! \param[in] ring_buffer The ring buffer into which data will be written.
+  //!     This object must outlive the lifetime of `ring_buffer`.
+  constexpr explicit MultiProducerRingBufferWriter(
+      RingBufferDataType& ring_buffer)
+      : ring_buffer_(ring_buffer) {}
+
+  MultiProducerRingBufferWriter(const MultiProducerRingBufferWriter&) = delete;
+  MultiProducerRingBufferWriter& operator=(
+      const MultiProducerRingBufferWriter&) = delete;
+
+  //! \brief Writes an item to the ring buffer.
+  //!
+  //! This method is lock-free and may be called concurrently from any number
+  //! of threads. The steps it takes do not depend on other writers, so it is
+  //! also safe to call from a signal handler.
+  //!
+  //! \param[in] buffer The data to be written.
+  //! \param[in] buffer_length The lengh of `buffer`, in bytes.
+  //! \return `true` on success. `false` if `buffer_length` is 0 or larger than
+  //!     a slot, or if the slot for this item was still being written by a
+  //!     push that started a full lap of the ring buffer earlier, in which case
+  //!     the item is dropped.
+  bool Push(const void* const buffer, uint32_t buffer_length) {
+    if (buffer_length == 0 || buffer_length > sizeof(Slot::data)) {
+      return false;
+    }
+
+    const uint64_t sequence =
+        ring_buffer_.header.next_sequence.fetch_add(1,
+                                                    std::memory_order_relaxed);
+    Slot& slot = ring_buffer_.slots[sequence % std::size(ring_buffer_.slots)];
+
+    // Claim the slot, unless a stalled writer still owns it. Claiming it with
+    // a compare-and-swap ensures that only one writer touches its bytes.
+    uint64_t state = slot.state.load(std::memory_order_relaxed);
+    const uint64_t writing_state = sequence * 2 + 1;
+    if (state % 2 == 1 || state >= writing_state ||
+        !slot.state.compare_exchange_strong(
+            state, writing_state, std::memory_order_acquire)) {
+      return false;
+    }
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
+    memcpy(slot.data, bytes, buffer_length);
+    slot.length = buffer_length;
+    slot.checksum = internal::MultiProducerRingBufferChecksum(
+        sequence, bytes, buffer_length);
+    slot.state.store(writing_state + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  using Slot = typename RingBufferDataType::Slot;
+
+  //! \brief Reference to the ring buffer to which data is written.
+  RingBufferDataType& ring_buffer_;
+};
+
+// Allow just `MultiProducerRingBufferWriter writer(foo);` to be declared
+// without template arguments using C++17 class template argument deduction.
+template <typename RingBufferDataType>
+MultiProducerRingBufferWriter(RingBufferDataType&)
+    -> MultiProducerRingBufferWriter<RingBufferDataType>;
+
+//! \brief Reads the items from a copy of the bytes of a
+//!     `MultiProducerRingBufferData`, such as an annotation’s value captured
+//!     from a crashed process.
+//!
+//! Slots which were never written, were being written when the bytes were
+//! copied, or fail validation are skipped. The remaining items are returned
+//! oldest first.
+class MultiProducerRingBufferReader final {
+ public:
+  //! \brief Constructs a reader for the `length` bytes at `buffer`.
+  //!
+  //! The bytes are read during construction and need not outlive this object.
+  MultiProducerRingBufferReader(const void* buffer, size_t length)
+      : items_(), next_item_(0), valid_(false) {
+    constexpr size_t kHeaderSize = 24;
+    constexpr size_t kSlotHeaderSize = 16;
+    if (length < kHeaderSize) {
+      return;
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
+
+    uint32_t magic, version, slot_count, slot_size;
+    uint64_t next_sequence;
+    memcpy(&magic, bytes, sizeof(magic));
+    memcpy(&version, bytes + 4, sizeof(version));
+    memcpy(&slot_count, bytes + 8, sizeof(slot_count));
+    memcpy(&slot_size, bytes + 12, sizeof(slot_size));
+    memcpy(&next_sequence, bytes + 16, sizeof(next_sequence));
+    if (magic != internal::kMultiProducerRingBufferMagic ||
+        version != internal::kMultiProducerRingBufferVersion) {
+      return;
+    }
+
+    const size_t slot_stride = size_t{kSlotHeaderSize} + slot_size;
+    size_t required_length;
+    if (!base::CheckAdd(kHeaderSize, base::CheckMul(slot_stride, slot_count))
+             .AssignIfValid(&required_length) ||
+        length < required_length) {
+      return;
+    }
+
+    // Only the last slot_count sequence numbers can still be held by a slot.
+    const uint64_t oldest_sequence =
+        next_sequence > slot_count ? next_sequence - slot_count : 0;
+    for (uint32_t index = 0; index < slot_count; ++index) {
+      const uint8_t* slot = bytes + kHeaderSize + slot_stride * index;
+      uint64_t state;
+      uint32_t item_length, checksum;
+      memcpy(&state, slot, sizeof(state));
+      memcpy(&item_length, slot + 8, sizeof(item_length));
+      memcpy(&checksum, slot + 12, sizeof(checksum));
+      if (state == 0 || state % 2 == 1) {
+        continue;
+      }
+      const uint64_t sequence = state / 2 - 1;
+      if (sequence < oldest_sequence || sequence >= next_sequence ||
+          sequence % slot_count != index || item_length == 0 ||
+          item_length > slot_size) {
+        continue;
+      }
+      const uint8_t* data = slot + kSlotHeaderSize;
+      if (internal::MultiProducerRingBufferChecksum(
+              sequence, data, item_length) != checksum) {
+        continue;
+      }
+      items_.push_back(
+          {sequence, std::vector<uint8_t>(data, data + item_length)});
+    }
+
+    std::sort(items_.begin(), items_.end(), [](const Item& a, const Item& b) {
+      return a.sequence < b.sequence;
+    });
+    valid_ = true;
+  }
+
+  MultiProducerRingBufferReader(const MultiProducerRingBufferReader&) = delete;
+  MultiProducerRingBufferReader& operator=(
+      const MultiProducerRingBufferReader&) = delete;
+
+  //! \return `true` if the bytes held a `MultiProducerRingBufferData` header
+  //!     and enough bytes for all of its slots.
+  bool IsValid() const { return valid_; }
+
+  //! \brief Pops off the oldest remaining item.
+  //!
+  //! \param[in] target_buffer On success, the buffer to which the item’s bytes
+  //!     will be appended.
+  //! \return `true` on success, or `false` if no items remain.
+  bool Pop(std::vector<uint8_t>& target_buffer) {
+    if (next_item_ == items_.size()) {
+      return false;
+    }
+    const std::vector<uint8_t>& bytes = items_[next_item_++].bytes;
+    target_buffer.insert(target_buffer.end(), bytes.begin(), bytes.end());
+    return true;
+  }
+
+ private:
+  struct Item {
+    uint64_t sequence;
+    std::vector<uint8_t> bytes;
+  };
+
+  std::vector<Item> items_;
+  size_t next_item_;
+  bool valid_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_MULTI_PRODUCER_RING_BUFFER_H_
@@ -0,0 +1,181 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/multi_producer_ring_buffer.h"
+
+#include <stdio.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using TestRingBufferData = MultiProducerRingBufferData<4, 16>;
+
+std::vector<std::string> ReadAll(const TestRingBufferData& data) {
+  MultiProducerRingBufferReader reader(&data, sizeof(data));
+  EXPECT_TRUE(reader.IsValid());
+  std::vector<std::string> items;
+  std::vector<uint8_t> item;
+  while (reader.Pop(item)) {
+    items.emplace_back(item.begin(), item.end());
+    item.clear();
+  }
+  return items;
+}
+
+TEST(MultiProducerRingBuffer, Empty) {
+  TestRingBufferData data;
+  EXPECT_TRUE(ReadAll(data).empty());
+}
+
+TEST(MultiProducerRingBuffer, PushAndRead) {
+  TestRingBufferData data;
+  MultiProducerRingBufferWriter writer(data);
+  EXPECT_TRUE(writer.Push("0123456789", 10));
+  EXPECT_TRUE(writer.Push("ABCDEF", 6));
+
+  const std::vector<std::string> expected = {"0123456789", "ABCDEF"};
+  EXPECT_EQ(ReadAll(data), expected);
+}
+
+TEST(MultiProducerRingBuffer, InvalidLengths) {
+  TestRingBufferData data;
+  MultiProducerRingBufferWriter writer(data);
+  EXPECT_FALSE(writer.Push("", 0));
+  EXPECT_FALSE(writer.Push("0123456789ABCDEFG", 17));
+  EXPECT_TRUE(writer.Push("0123456789ABCDEF", 16));
+  EXPECT_EQ(ReadAll(data).size(), 1u);
+}
+
+TEST(MultiProducerRingBuffer, Wrap) {
+  TestRingBufferData data;
+  MultiProducerRingBufferWriter writer(data);
+  for (int i = 0; i < 6; ++i) {
+    char item[16];
+    int length = snprintf(item, sizeof(item), "item%d", i);
+    EXPECT_TRUE(writer.Push(item, length));
+  }
+
+  // The two oldest items were replaced, and the rest are returned in order.
+  const std::vector<std::string> expected = {"item2", "item3", "item4",
+                                             "item5"};
+  EXPECT_EQ(ReadAll(data), expected);
+}
+
+TEST(MultiProducerRingBuffer, SkipsIncompleteAndCorruptSlots) {
+  TestRingBufferData data;
+  MultiProducerRingBufferWriter writer(data);
+  EXPECT_TRUE(writer.Push("first", 5));
+  EXPECT_TRUE(writer.Push("second", 6));
+  EXPECT_TRUE(writer.Push("third", 5));
+
+  // Simulate a crash in the middle of writing the second item.
+  data.slots[1].state.store(data.slots[1].state.load() - 1);
+
+  // Simulate a slot copied while it was being rewritten.
+  data.slots[2].data[0] = 'T';
+
+  const std::vector<std::string> expected = {"first"};
+  EXPECT_EQ(ReadAll(data), expected);
+}
+
+TEST(MultiProducerRingBuffer, SkipsStalledWriter) {
+  TestRingBufferData data;
+  MultiProducerRingBufferWriter writer(data);
+
+  // Simulate a writer that claimed slot 0 for item 0 and never finished.
+  data.header.next_sequence.store(1);
+  data.slots[0].state.store(1);
+
+  // Items 1 through 3 are stored, but item 4 maps to the slot that is still
+  // owned by the stalled writer and is dropped.
+  EXPECT_TRUE(writer.Push("item1", 5));
+  EXPECT_TRUE(writer.Push("item2", 5));
+  EXPECT_TRUE(writer.Push("item3", 5));
+  EXPECT_FALSE(writer.Push("item4", 5));
+
+  const std::vector<std::string> expected = {"item1", "item2", "item3"};
+  EXPECT_EQ(ReadAll(data), expected);
+}
+
+TEST(MultiProducerRingBuffer, InvalidBuffers) {
+  TestRingBufferData data;
+  MultiProducerRingBufferWriter writer(data);
+  EXPECT_TRUE(writer.Push("item", 4));
+
+  std::vector<uint8_t> item;
+  MultiProducerRingBufferReader truncated(&data, sizeof(data) - 1);
+  EXPECT_FALSE(truncated.IsValid());
+  EXPECT_FALSE(truncated.Pop(item));
+
+  std::vector<uint8_t> bytes(reinterpret_cast<const uint8_t*>(&data),
+                             reinterpret_cast<const uint8_t*>(&data + 1));
+  bytes[0] ^= 0xff;
+  MultiProducerRingBufferReader bad_magic(bytes.data(), bytes.size());
+  EXPECT_FALSE(bad_magic.IsValid());
+  EXPECT_FALSE(bad_magic.Pop(item));
+}
+
+TEST(MultiProducerRingBuffer, ConcurrentPushes) {
+  constexpr int kThreads = 8;
+  constexpr int kPushesPerThread = 1000;
+  MultiProducerRingBufferData<64, 16> data;
+  MultiProducerRingBufferWriter writer(data);
+
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kThreads; ++thread) {
+    threads.emplace_back([&writer, thread] {
+      for (int push = 0; push < kPushesPerThread; ++push) {
+        char item[16];
+        int length = snprintf(item, sizeof(item), "%d:%d", thread, push);
+        writer.Push(item, length);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(data.header.next_sequence.load(),
+            static_cast<uint64_t>(kThreads * kPushesPerThread));
+
+  MultiProducerRingBufferReader reader(&data, sizeof(data));
+  ASSERT_TRUE(reader.IsValid());
+  std::set<std::string> items;
+  std::vector<uint8_t> item;
+  while (reader.Pop(item)) {
+    int thread, push;
+    std::string string(item.begin(), item.end());
+    ASSERT_EQ(sscanf(string.c_str(), "%d:%d", &thread, &push), 2) << string;
+    EXPECT_GE(thread, 0);
+    EXPECT_LT(thread, kThreads);
+    EXPECT_GE(push, 0);
+    EXPECT_LT(push, kPushesPerThread);
+    EXPECT_TRUE(items.insert(string).second) << string;
+    item.clear();
+  }
+  EXPECT_LE(items.size(), 64u);
+  EXPECT_FALSE(items.empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -78,7 +78,7 @@ std::unique_ptr<PruneCondition> PruneCondition::GetDefault() {
   // due to the short-circuting behavior of BinaryPruneCondition.
   return std::make_unique<BinaryPruneCondition>(
       BinaryPruneCondition::OR,
-      new DatabaseSizePruneCondition(1024 * 128),
+      new DatabaseSizePruneCondition(kDefaultMaxDatabaseSizeInKB),
       new AgePruneCondition(365));
 }
 
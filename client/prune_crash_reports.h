@@ -51,6 +51,9 @@ std::unique_ptr<PruneCondition> GetDefaultDatabasePruneCondition();
 //! CrashReportDatabase::Report::creation_time.
 class PruneCondition {
  public:
+  //! \brief The maximum database size, in kilobytes, used by GetDefault().
+  static constexpr size_t kDefaultMaxDatabaseSizeInKB = 1024 * 128;
+
   //! \brief Returns a sensible default condition for removing obsolete crash
   //!     reports.
   //!
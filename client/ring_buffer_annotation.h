@@ -17,8 +17,11 @@
 
 #include <stdio.h>
 
+#include <atomic>
+
 #include "client/annotation.h"
 #include "client/length_delimited_ring_buffer.h"
+#include "client/multi_producer_ring_buffer.h"
 
 namespace crashpad {
 
@@ -31,6 +34,15 @@ namespace internal {
 inline constexpr RingBufferAnnotationCapacity
     kDefaultRingBufferAnnotationCapacity = 8192;
 
+//! \brief Default number of slots in a `MultiProducerRingBufferAnnotation`.
+inline constexpr uint32_t kDefaultMultiProducerRingBufferAnnotationSlotCount =
+    128;
+
+//! \brief Default capacity of each slot in a
+//!     `MultiProducerRingBufferAnnotation`, in bytes.
+inline constexpr uint32_t kDefaultMultiProducerRingBufferAnnotationSlotSize =
+    48;
+
 }  // namespace internal
 
 //! \brief An `Annotation` which wraps a `LengthDelimitedRingBuffer`
@@ -64,6 +76,10 @@ inline constexpr RingBufferAnnotationCapacity
 //!
 //! To deserialize the items stored in this annotation, use
 //! `LengthDelimitedRingBufferReader`.
+//!
+//! Writers are serialized with the reader through the spin guard, so a push
+//! from one thread fails while another thread is pushing. For many concurrent
+//! writers, use `MultiProducerRingBufferAnnotation` instead.
 template <RingBufferAnnotationCapacity Capacity =
               internal::kDefaultRingBufferAnnotationCapacity>
 class RingBufferAnnotation final : public Annotation {
@@ -106,6 +122,27 @@ class RingBufferAnnotation final : public Annotation {
     return success;
   }
 
+  //! \brief Pushes several items onto this annotation's ring buffer in one
+  //!     operation, under a single spin guard.
+  //!
+  //! Either all of the items are pushed, or none are. Old data items are
+  //! dropped in FIFO order as needed to make room for all of them.
+  //!
+  //! \sa LengthDelimitedRingBufferWriter::PushBatch()
+  bool PushBatch(const RingBufferItem* items, size_t item_count) {
+    constexpr uint64_t kSpinGuardTimeoutNanoseconds = 0;
+
+    auto spin_guard = TryCreateScopedSpinGuard(kSpinGuardTimeoutNanoseconds);
+    if (!spin_guard) {
+      return false;
+    }
+    bool success = ring_buffer_writer_.PushBatch(items, item_count);
+    if (success) {
+      SetSize(ring_buffer_data_.GetRingBufferLength());
+    }
+    return success;
+  }
+
   //! \brief Reset the annotation (e.g., for testing).
   //! This method is not thread-safe.
   void ResetForTesting() {
@@ -131,6 +168,93 @@ template <RingBufferAnnotationCapacity Capacity =
 RingBufferAnnotation(Annotation::Type type, const char name[])
     -> RingBufferAnnotation<Capacity>;
 
+//! \brief An `Annotation` which wraps a `MultiProducerRingBufferData` of
+//!     `SlotCount` slots, each holding an item of up to `SlotSize` bytes.
+//!
+//! Unlike `RingBufferAnnotation`, `Push()` does not take a lock or a spin
+//! guard, so any number of threads can push concurrently without contending
+//! on anything but the ring buffer’s sequence counter. When the ring buffer is
+//! full, each push replaces the oldest item.
+//!
+//! The handler captures this annotation’s bytes without coordinating with
+//! writers. Each slot records whether its last write completed, along with a
+//! checksum, so items that were being written at the time are discarded when
+//! reading.
+//!
+//! To deserialize the items stored in this annotation, use
+//! `MultiProducerRingBufferReader`.
+template <uint32_t SlotCount =
+              internal::kDefaultMultiProducerRingBufferAnnotationSlotCount,
+          uint32_t SlotSize =
+              internal::kDefaultMultiProducerRingBufferAnnotationSlotSize>
+class MultiProducerRingBufferAnnotation final : public Annotation {
+ public:
+  //! \brief Constructs a `MultiProducerRingBufferAnnotation`.
+  //! \param[in] type A unique identifier for the type of data in the ring
+  //!     buffer.
+  //! \param[in] name The name of the annotation.
+  constexpr MultiProducerRingBufferAnnotation(Annotation::Type type,
+                                              const char name[])
+      : Annotation(type,
+                   name,
+                   reinterpret_cast<void* const>(&ring_buffer_data_),
+                   ConcurrentAccessGuardMode::kUnguarded),
+        ring_buffer_data_(),
+        ring_buffer_writer_(ring_buffer_data_),
+        size_set_(false) {}
+  MultiProducerRingBufferAnnotation(const MultiProducerRingBufferAnnotation&) =
+      delete;
+  MultiProducerRingBufferAnnotation& operator=(
+      const MultiProducerRingBufferAnnotation&) = delete;
+
+  //! \brief Pushes data onto this annotation's ring buffer.
+  //!
+  //! This method is lock-free and may be called from any number of threads
+  //! concurrently.
+  //!
+  //! The first successful push makes this annotation visible in crash reports.
+  //! If the annotation is later cleared with `Clear()`, it is not made visible
+  //! again by subsequent pushes.
+  //!
+  //! \return `true` on success. `false` if `buffer_length` is 0 or larger than
+  //!     `SlotSize`, or in the rare case that the item’s slot was still being
+  //!     written by a push that started a full lap of the ring buffer earlier.
+  bool Push(const void* const buffer, uint32_t buffer_length) {
+    if (!ring_buffer_writer_.Push(buffer, buffer_length)) {
+      return false;
+    }
+    // The size never changes, so it only needs to be set once. Check before
+    // exchanging to avoid contending on the flag after the first push.
+    if (!size_set_.load(std::memory_order_relaxed) &&
+        !size_set_.exchange(true, std::memory_order_acq_rel)) {
+      SetSize(sizeof(ring_buffer_data_));
+    }
+    return true;
+  }
+
+  //! \brief Reset the annotation (e.g., for testing).
+  //! This method is not thread-safe.
+  void ResetForTesting() {
+    ring_buffer_data_.ResetForTesting();
+    size_set_.store(false, std::memory_order_relaxed);
+  }
+
+ private:
+  using RingBufferData = MultiProducerRingBufferData<SlotCount, SlotSize>;
+  using RingBufferWriter = MultiProducerRingBufferWriter<RingBufferData>;
+
+  static_assert(sizeof(RingBufferData) < Annotation::kValueMaxSize);
+
+  //! \brief The ring buffer data stored in this Anotation.
+  RingBufferData ring_buffer_data_;
+
+  //! \brief The writer which wraps `ring_buffer_data_`.
+  RingBufferWriter ring_buffer_writer_;
+
+  //! \brief Whether `SetSize()` has been called.
+  std::atomic<bool> size_set_;
+};
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_CLIENT_RING_BUFFER_ANNOTATION_H_
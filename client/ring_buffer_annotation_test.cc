@@ -16,6 +16,7 @@
 #include "client/length_delimited_ring_buffer.h"
 
 #include <array>
+#include <iterator>
 #include <string>
 
 #include "client/annotation_list.h"
@@ -137,6 +138,42 @@ TEST_F(RingBufferAnnotationTest, MultiplePushesWithoutWrapping) {
   EXPECT_EQ(expected2, popped_value);
 }
 
+TEST_F(RingBufferAnnotationTest, PushBatch) {
+  constexpr Annotation::Type kType = Annotation::UserDefinedType(1);
+
+  constexpr char kName[] = "annotation 1";
+  RingBufferAnnotation annotation(kType, kName);
+
+  const RingBufferItem items[] = {{"0123456789", 10}, {"ABCDEF", 6}};
+  EXPECT_TRUE(annotation.PushBatch(items, std::size(items)));
+
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(1u, AnnotationsCount());
+
+  constexpr Annotation::ValueSizeType kExpectedSize =
+      kRingBufferHeaderSize + kLengthDelimiter1ByteSize + 10u +
+      kLengthDelimiter1ByteSize + 6u;
+  EXPECT_EQ(kExpectedSize, annotation.size());
+
+  RingBufferData data;
+  EXPECT_TRUE(
+      data.DeserializeFromBuffer(annotation.value(), annotation.size()));
+
+  std::vector<uint8_t> popped_value;
+  LengthDelimitedRingBufferReader reader(data);
+  EXPECT_TRUE(reader.Pop(popped_value));
+
+  const std::vector<uint8_t> expected1 = {
+      '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(expected1, popped_value);
+
+  popped_value.clear();
+  EXPECT_TRUE(reader.Pop(popped_value));
+
+  const std::vector<uint8_t> expected2 = {'A', 'B', 'C', 'D', 'E', 'F'};
+  EXPECT_EQ(expected2, popped_value);
+}
+
 TEST_F(RingBufferAnnotationTest,
        MultiplePushCallsWithWrappingShouldOverwriteInFIFOOrder) {
   constexpr Annotation::Type kType = Annotation::UserDefinedType(1);
@@ -183,6 +220,45 @@ TEST_F(RingBufferAnnotationTest,
   EXPECT_EQ(expected_c, popped_value);
 }
 
+TEST_F(RingBufferAnnotationTest, MultiProducer) {
+  constexpr Annotation::Type kType = Annotation::UserDefinedType(1);
+
+  constexpr char kName[] = "annotation 1";
+  MultiProducerRingBufferAnnotation<4, 16> annotation(kType, kName);
+
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(0u, AnnotationsCount());
+
+  EXPECT_TRUE(annotation.Push("0123456789", 10));
+  EXPECT_TRUE(annotation.Push("ABCDEF", 6));
+
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(1u, AnnotationsCount());
+  EXPECT_EQ(sizeof(MultiProducerRingBufferData<4, 16>), annotation.size());
+  EXPECT_EQ(&annotation, *annotations_.begin());
+
+  MultiProducerRingBufferReader reader(annotation.value(), annotation.size());
+  ASSERT_TRUE(reader.IsValid());
+
+  std::vector<uint8_t> popped_value;
+  ASSERT_TRUE(reader.Pop(popped_value));
+  const std::vector<uint8_t> expected1 = {
+      '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(expected1, popped_value);
+
+  popped_value.clear();
+  ASSERT_TRUE(reader.Pop(popped_value));
+  const std::vector<uint8_t> expected2 = {'A', 'B', 'C', 'D', 'E', 'F'};
+  EXPECT_EQ(expected2, popped_value);
+
+  popped_value.clear();
+  EXPECT_FALSE(reader.Pop(popped_value));
+
+  annotation.Clear();
+  EXPECT_FALSE(annotation.is_set());
+  EXPECT_EQ(0u, AnnotationsCount());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,46 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/seqlock_annotation.h"
+
+namespace crashpad {
+
+bool ReadSeqlockAnnotationValue(const uint8_t* data,
+                                size_t size,
+                                uint32_t* sequence,
+                                std::vector<uint8_t>* string) {
+  uint32_t header[2];
+  static_assert(sizeof(header) == sizeof(SeqlockAnnotationHeader),
+                "header size mismatch");
+  if (size < sizeof(header)) {
+    return false;
+  }
+  memcpy(header, data, sizeof(header));
+
+  // An odd sequence number means that the copy was taken mid-write.
+  if (header[0] & 1) {
+    return false;
+  }
+  if (header[1] > size - sizeof(header)) {
+    return false;
+  }
+
+  if (sequence) {
+    *sequence = header[0];
+  }
+  string->assign(data + sizeof(header), data + sizeof(header) + header[1]);
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,137 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_SEQLOCK_ANNOTATION_H_
+#define CRASHPAD_CLIENT_SEQLOCK_ANNOTATION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/string_piece.h"
+#include "client/annotation.h"
+
+namespace crashpad {
+
+//! \brief The header at the start of the value of an
+//!     Annotation::Type::kSeqlockString annotation, followed by the string’s
+//!     bytes.
+struct SeqlockAnnotationHeader {
+  //! \brief Incremented before and after each write, so that it’s odd while
+  //!     the value is being written.
+  std::atomic<uint32_t> sequence;
+
+  //! \brief The size of the string that follows, in bytes.
+  uint32_t size;
+};
+static_assert(sizeof(SeqlockAnnotationHeader) == 8,
+              "SeqlockAnnotationHeader must not have padding");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "std::atomic<uint32_t> may not be signal-safe");
+
+//! \brief Obtains the string held by a copy of the value of an
+//!     Annotation::Type::kSeqlockString annotation.
+//!
+//! A reader running alongside the writer should read the value’s
+//! SeqlockAnnotationHeader::sequence again once the copy is complete, and
+//! discard the copy if it no longer matches the sequence in the copy.
+//!
+//! \param[in] data The copy of the value.
+//! \param[in] size The size of \a data.
+//! \param[out] sequence The sequence number held by the copy. May be `nullptr`.
+//! \param[out] string The string held by the copy.
+//!
+//! \return `true` on success. `false` if the copy was taken while the value
+//!     was being written, or is malformed.
+bool ReadSeqlockAnnotationValue(const uint8_t* data,
+                                size_t size,
+                                uint32_t* sequence,
+                                std::vector<uint8_t>* string);
+
+//! \brief An \sa Annotation that stores a string value which can be updated
+//!     often, from a hot path, without locks.
+//!
+//! StringAnnotation::Set() changes the value in place, so a crash or a
+//! concurrent read during an update may capture a mix of the old and new
+//! values. ScopedSpinGuard prevents this, but costs writers an atomic
+//! exchange, and fails writes while a reader holds it. Instead, Set() here
+//! makes SeqlockAnnotationHeader::sequence odd for the duration of the
+//! update, as a seqlock does. Readers retry, or discard, a value whose
+//! sequence was odd or changed while they read it. Writers never wait.
+//!
+//! Set() is a few stores and a copy of the string, with no function calls or
+//! read-modify-write operations, so it’s suitable for annotations that change
+//! on every request. Only one thread may call Set() at a time. Concurrent
+//! writers must be serialized externally.
+//!
+//! Readers of minidumps see this annotation as an Annotation::Type::kString
+//! annotation holding the string.
+template <Annotation::ValueSizeType MaxSize>
+class SeqlockStringAnnotation : public Annotation {
+ public:
+  //! \brief Constructs a new SeqlockStringAnnotation with the given \a name.
+  //!
+  //! \param[in] name The Annotation name.
+  constexpr explicit SeqlockStringAnnotation(const char name[])
+      : Annotation(Type::kSeqlockString, name, &value_), value_() {}
+
+  SeqlockStringAnnotation(const SeqlockStringAnnotation&) = delete;
+  SeqlockStringAnnotation& operator=(const SeqlockStringAnnotation&) = delete;
+
+  //! \brief Sets the Annotation's string value.
+  //!
+  //! \param[in] string The string value. Only the first \a MaxSize bytes are
+  //!     stored.
+  void Set(base::StringPiece string) {
+    const ValueSizeType size =
+        std::min(MaxSize, base::saturated_cast<ValueSizeType>(string.size()));
+    const uint32_t sequence =
+        value_.header.sequence.load(std::memory_order_relaxed);
+    value_.header.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(value_.data, string.data(), size);
+    value_.header.size = size;
+    value_.header.sequence.store(sequence + 2, std::memory_order_release);
+
+    // The whole value is always captured, so the size only needs to be set,
+    // and the annotation registered, once.
+    if (!is_set()) {
+      SetSize(sizeof(value_));
+    }
+  }
+
+  //! \brief Returns the Annotation's string value. Only valid on the thread
+  //!     that calls Set().
+  const base::StringPiece value() const {
+    return base::StringPiece(value_.data, value_.header.size);
+  }
+
+ private:
+  struct Value {
+    SeqlockAnnotationHeader header;
+    char data[MaxSize];
+  };
+  static_assert(sizeof(Value) < kValueMaxSize, "MaxSize is too large");
+
+  Value value_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_SEQLOCK_ANNOTATION_H_
@@ -0,0 +1,180 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/seqlock_annotation.h"
+
+#include <string.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "gtest/gtest.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class SeqlockStringAnnotationTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+ private:
+  AnnotationList annotations_;
+};
+
+std::string ValueString(const Annotation& annotation) {
+  std::vector<uint8_t> string;
+  EXPECT_TRUE(ReadSeqlockAnnotationValue(
+      static_cast<const uint8_t*>(annotation.value()),
+      annotation.size(),
+      nullptr,
+      &string));
+  return std::string(string.begin(), string.end());
+}
+
+TEST_F(SeqlockStringAnnotationTest, Set) {
+  SeqlockStringAnnotation<8> annotation("seqlock");
+  EXPECT_EQ(annotation.type(), Annotation::Type::kSeqlockString);
+  EXPECT_FALSE(annotation.is_set());
+
+  annotation.Set("value");
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(annotation.size(), sizeof(SeqlockAnnotationHeader) + 8);
+  EXPECT_EQ(annotation.value(), "value");
+  EXPECT_EQ(ValueString(annotation), "value");
+
+  // Values are truncated to fit.
+  annotation.Set("a much longer value");
+  EXPECT_EQ(annotation.value(), "a much l");
+  EXPECT_EQ(ValueString(annotation), "a much l");
+
+  annotation.Set("");
+  EXPECT_TRUE(annotation.is_set());
+  EXPECT_EQ(ValueString(annotation), "");
+
+  const Annotation& base = annotation;
+  uint32_t sequence;
+  std::vector<uint8_t> string;
+  ASSERT_TRUE(
+      ReadSeqlockAnnotationValue(static_cast<const uint8_t*>(base.value()),
+                                 base.size(),
+                                 &sequence,
+                                 &string));
+  EXPECT_EQ(sequence, 6u);
+}
+
+TEST(SeqlockAnnotation, ReadValue) {
+  struct {
+    uint32_t sequence;
+    uint32_t size;
+    char data[4];
+  } value = {2, 3, {'a', 'b', 'c', 'd'}};
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(&value);
+
+  std::vector<uint8_t> string;
+  ASSERT_TRUE(
+      ReadSeqlockAnnotationValue(data, sizeof(value), nullptr, &string));
+  EXPECT_EQ(std::string(string.begin(), string.end()), "abc");
+
+  // A value being written to isn’t accepted.
+  value.sequence = 3;
+  EXPECT_FALSE(
+      ReadSeqlockAnnotationValue(data, sizeof(value), nullptr, &string));
+
+  // Nor is a value whose size runs past its end.
+  value.sequence = 4;
+  value.size = 5;
+  EXPECT_FALSE(
+      ReadSeqlockAnnotationValue(data, sizeof(value), nullptr, &string));
+  EXPECT_FALSE(ReadSeqlockAnnotationValue(data, 4, nullptr, &string));
+}
+
+template <Annotation::ValueSizeType MaxSize>
+class SeqlockWriterThread : public Thread {
+ public:
+  explicit SeqlockWriterThread(SeqlockStringAnnotation<MaxSize>* annotation)
+      : annotation_(annotation), stop_(false) {}
+
+  void Stop() {
+    stop_.store(true, std::memory_order_relaxed);
+    Join();
+  }
+
+ private:
+  void ThreadMain() override {
+    const std::string values[] = {std::string(MaxSize, 'a'),
+                                  std::string(MaxSize / 2, 'b')};
+    for (size_t index = 0; !stop_.load(std::memory_order_relaxed); ++index) {
+      annotation_->Set(values[index % 2]);
+    }
+  }
+
+  SeqlockStringAnnotation<MaxSize>* annotation_;
+  std::atomic<bool> stop_;
+};
+
+TEST_F(SeqlockStringAnnotationTest, ConcurrentReads) {
+  static constexpr Annotation::ValueSizeType kMaxSize = 512;
+  SeqlockStringAnnotation<kMaxSize> annotation("seqlock");
+  annotation.Set(std::string(kMaxSize, 'a'));
+
+  SeqlockWriterThread<kMaxSize> writer(&annotation);
+  writer.Start();
+
+  // Copies are taken the way a reader in another process takes them: the
+  // value, then its sequence number again. Every copy that’s accepted must
+  // hold one of the values written, never a mix of the two.
+  const Annotation& base = annotation;
+  const volatile uint8_t* value =
+      static_cast<const volatile uint8_t*>(base.value());
+  const auto* sequence_after =
+      static_cast<const std::atomic<uint32_t>*>(base.value());
+  for (int read = 0; read < 10000; ++read) {
+    std::vector<uint8_t> copy(annotation.size());
+    for (size_t index = 0; index < copy.size(); ++index) {
+      copy[index] = value[index];
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    uint32_t sequence;
+    std::vector<uint8_t> string;
+    if (!ReadSeqlockAnnotationValue(
+            copy.data(), copy.size(), &sequence, &string) ||
+        sequence_after->load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+
+    const std::string read_string(string.begin(), string.end());
+    EXPECT_TRUE(read_string == std::string(kMaxSize, 'a') ||
+                read_string == std::string(kMaxSize / 2, 'b'))
+        << read_string;
+  }
+
+  writer.Stop();
+  EXPECT_EQ(ValueString(annotation), std::string(annotation.value()));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
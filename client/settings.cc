@@ -27,6 +27,20 @@
 
 namespace crashpad {
 
+namespace {
+
+// Some filesystems record modification times to the nearest two seconds, so a
+// write made shortly after the settings were cached may not change the settings
+// file's modification time. Cached settings are only used if they were read at
+// least this long after the modification time recorded with them.
+constexpr time_t kModificationTimeResolutionSeconds = 2;
+
+// Writes deferred by caching are flushed once they have been deferred for this
+// long.
+constexpr time_t kMaxWriteDelaySeconds = 60;
+
+}  // namespace
+
 #if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
 
 Settings::ScopedLockedFileHandle::ScopedLockedFileHandle()
@@ -138,9 +152,24 @@ struct Settings::Data {
   UUID client_id;
 };
 
-Settings::Settings() = default;
-
-Settings::~Settings() = default;
+Settings::Settings()
+    : file_path_(),
+      cache_lock_(),
+      cached_data_(),
+      cached_mtime_(),
+      cached_time_(0),
+      deferred_since_(0),
+      deferred_last_upload_attempt_time_(0),
+      has_deferred_last_upload_attempt_time_(false),
+      caching_enabled_(false),
+      initialized_() {}
+
+Settings::~Settings() {
+  if (initialized_.is_valid()) {
+    base::AutoLock lock(cache_lock_);
+    FlushLocked();
+  }
+}
 
 bool Settings::Initialize(const base::FilePath& file_path) {
   DCHECK(initialized_.is_uninitialized());
@@ -155,11 +184,25 @@ bool Settings::Initialize(const base::FilePath& file_path) {
   return true;
 }
 
+void Settings::EnableCaching() {
+  DCHECK(initialized_.is_valid());
+
+  base::AutoLock lock(cache_lock_);
+  caching_enabled_ = true;
+}
+
+bool Settings::Flush() {
+  DCHECK(initialized_.is_valid());
+
+  base::AutoLock lock(cache_lock_);
+  return FlushLocked();
+}
+
 bool Settings::GetClientID(UUID* client_id) {
   DCHECK(initialized_.is_valid());
 
   Data settings;
-  if (!OpenAndReadSettings(&settings))
+  if (!ReadSettingsCachedIfPossible(&settings))
     return false;
 
   *client_id = settings.client_id;
@@ -170,7 +213,7 @@ bool Settings::GetUploadsEnabled(bool* enabled) {
   DCHECK(initialized_.is_valid());
 
   Data settings;
-  if (!OpenAndReadSettings(&settings))
+  if (!ReadSettingsCachedIfPossible(&settings))
     return false;
 
   *enabled = (settings.options & Data::Options::kUploadsEnabled) != 0;
@@ -180,6 +223,7 @@ bool Settings::GetUploadsEnabled(bool* enabled) {
 bool Settings::SetUploadsEnabled(bool enabled) {
   DCHECK(initialized_.is_valid());
 
+  base::AutoLock lock(cache_lock_);
   Data settings;
   ScopedLockedFileHandle handle = OpenForWritingAndReadSettings(&settings);
   if (!handle.is_valid())
@@ -190,14 +234,14 @@ bool Settings::SetUploadsEnabled(bool enabled) {
   else
     settings.options &= ~Data::Options::kUploadsEnabled;
 
-  return WriteSettings(handle.get(), settings);
+  return WriteSettingsAndClearCache(handle.get(), &settings);
 }
 
 bool Settings::GetLastUploadAttemptTime(time_t* time) {
   DCHECK(initialized_.is_valid());
 
   Data settings;
-  if (!OpenAndReadSettings(&settings))
+  if (!ReadSettingsCachedIfPossible(&settings))
     return false;
 
   *time = InRangeCast<time_t>(settings.last_upload_attempt_time,
@@ -208,6 +252,21 @@ bool Settings::GetLastUploadAttemptTime(time_t* time) {
 bool Settings::SetLastUploadAttemptTime(time_t time) {
   DCHECK(initialized_.is_valid());
 
+  base::AutoLock lock(cache_lock_);
+  if (caching_enabled_) {
+    const time_t now = ::time(nullptr);
+    if (!has_deferred_last_upload_attempt_time_) {
+      deferred_since_ = now;
+    }
+    deferred_last_upload_attempt_time_ = InRangeCast<int64_t>(time, 0);
+    has_deferred_last_upload_attempt_time_ = true;
+    if (now >= deferred_since_ &&
+        now - deferred_since_ < kMaxWriteDelaySeconds) {
+      return true;
+    }
+    return FlushLocked();
+  }
+
   Data settings;
   ScopedLockedFileHandle handle = OpenForWritingAndReadSettings(&settings);
   if (!handle.is_valid())
@@ -215,7 +274,7 @@ bool Settings::SetLastUploadAttemptTime(time_t time) {
 
   settings.last_upload_attempt_time = InRangeCast<int64_t>(time, 0);
 
-  return WriteSettings(handle.get(), settings);
+  return WriteSettingsAndClearCache(handle.get(), &settings);
 }
 
 #if !CRASHPAD_FLOCK_ALWAYS_SUPPORTED
@@ -387,6 +446,69 @@ Settings::ScopedLockedFileHandle Settings::OpenForWritingAndReadSettings(
   return handle;
 }
 
+bool Settings::ReadSettingsCachedIfPossible(Data* out_data) {
+  base::AutoLock lock(cache_lock_);
+  if (!caching_enabled_) {
+    return OpenAndReadSettings(out_data);
+  }
+
+  // Sample the time before the modification time, so that any write made
+  // after the settings are read has a modification time no earlier than this.
+  const time_t now = time(nullptr);
+  timespec mtime;
+  const bool have_mtime = FileModificationTime(file_path(), &mtime);
+  if (cached_data_ && have_mtime && mtime.tv_sec == cached_mtime_.tv_sec &&
+      mtime.tv_nsec == cached_mtime_.tv_nsec &&
+      cached_mtime_.tv_sec + kModificationTimeResolutionSeconds <=
+          cached_time_) {
+    *out_data = *cached_data_;
+  } else {
+    cached_data_.reset();
+    if (!OpenAndReadSettings(out_data)) {
+      return false;
+    }
+
+    // If the file is written between reading its modification time and its
+    // contents, the cached modification time is older than the contents, and
+    // they'll be read again next time.
+    if (have_mtime) {
+      cached_data_ = std::make_unique<Data>(*out_data);
+      cached_mtime_ = mtime;
+      cached_time_ = now;
+    }
+  }
+
+  if (has_deferred_last_upload_attempt_time_) {
+    out_data->last_upload_attempt_time = deferred_last_upload_attempt_time_;
+  }
+  return true;
+}
+
+bool Settings::WriteSettingsAndClearCache(FileHandle handle, Data* data) {
+  if (has_deferred_last_upload_attempt_time_) {
+    data->last_upload_attempt_time = deferred_last_upload_attempt_time_;
+  }
+  cached_data_.reset();
+  if (!WriteSettings(handle, *data)) {
+    return false;
+  }
+  has_deferred_last_upload_attempt_time_ = false;
+  return true;
+}
+
+bool Settings::FlushLocked() {
+  if (!has_deferred_last_upload_attempt_time_) {
+    return true;
+  }
+
+  Data settings;
+  ScopedLockedFileHandle handle = OpenForWritingAndReadSettings(&settings);
+  if (!handle.is_valid()) {
+    return false;
+  }
+  return WriteSettingsAndClearCache(handle.get(), &settings);
+}
+
 bool Settings::ReadSettings(FileHandle handle,
                             Data* out_data,
                             bool log_read_error) {
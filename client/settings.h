@@ -15,10 +15,14 @@
 #ifndef CRASHPAD_CLIENT_SETTINGS_H_
 #define CRASHPAD_CLIENT_SETTINGS_H_
 
+#include <stdint.h>
 #include <time.h>
 
+#include <memory>
+
 #include "base/files/file_path.h"
 #include "base/scoped_generic.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "util/file/file_io.h"
 #include "util/misc/initialization_state.h"
@@ -85,6 +89,30 @@ class Settings {
   //!     `false` with an error logged.
   bool Initialize(const base::FilePath& path);
 
+  //! \brief Enables caching of the settings in memory.
+  //!
+  //! Without caching, every method opens, locks, and reads the settings file.
+  //! With caching, the settings are only read again when the file's
+  //! modification time changes, and SetLastUploadAttemptTime() defers writing
+  //! the file until Flush() is called, another setting is changed, a minute
+  //! has passed since the first deferred write, or this object is destroyed.
+  //!
+  //! This is intended for long-lived users that read the settings frequently,
+  //! such as the upload thread of the handler. Changes made by other processes
+  //! are still observed, but deferred writes are not visible to them until
+  //! they are flushed.
+  //!
+  //! This method must be called after Initialize() succeeds and before any
+  //! other method is called.
+  void EnableCaching();
+
+  //! \brief Writes any settings changes deferred by caching to the settings
+  //!     file.
+  //!
+  //! \return On success, returns `true`, otherwise returns `false` with an
+  //!     error logged. This always succeeds if there are no deferred changes.
+  bool Flush();
+
   //! \brief Retrieves the immutable identifier for this client, which is used
   //!     on a server to locate all crash reports from a specific Crashpad
   //!     database.
@@ -282,10 +310,36 @@ class Settings {
   // |handle| must be the result of OpenForReadingAndWriting().
   bool InitializeSettings(FileHandle handle);
 
+  // Reads the settings into |out_data|, from memory if caching is enabled and
+  // the settings file hasn't changed since it was last read. Any deferred
+  // changes are applied to the result.
+  bool ReadSettingsCachedIfPossible(Data* out_data);
+
+  // Applies any deferred changes to |data| and writes it to |handle|, which
+  // must be the result of OpenForWritingAndReadSettings(). Clears the cache,
+  // because the file's new modification time isn't known until the handle is
+  // closed. cache_lock_ must be held.
+  bool WriteSettingsAndClearCache(FileHandle handle, Data* data);
+
+  // Writes deferred changes to the settings file. cache_lock_ must be held.
+  bool FlushLocked();
+
   const base::FilePath& file_path() const { return file_path_; }
 
   base::FilePath file_path_;
 
+  // The state used when caching is enabled, guarded by cache_lock_.
+  // cached_data_ holds the settings file's contents as of its modification
+  // time cached_mtime_, read at cached_time_, or nullptr if nothing is cached.
+  base::Lock cache_lock_;
+  std::unique_ptr<Data> cached_data_;
+  timespec cached_mtime_;
+  time_t cached_time_;
+  time_t deferred_since_;
+  int64_t deferred_last_upload_attempt_time_;
+  bool has_deferred_last_upload_attempt_time_;
+  bool caching_enabled_;
+
   InitializationState initialized_;
 };
 
@@ -17,8 +17,10 @@
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/errors.h"
+#include "test/filesystem.h"
 #include "test/scoped_temp_dir.h"
 #include "util/file/file_io.h"
+#include "util/file/filesystem.h"
 
 namespace crashpad {
 namespace test {
@@ -115,6 +117,93 @@ TEST_F(SettingsTest, LastUploadAttemptTime) {
   EXPECT_EQ(actual, expected);
 }
 
+TEST_F(SettingsTest, CachedReads) {
+  settings()->EnableCaching();
+
+  bool enabled = true;
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_FALSE(enabled);
+
+  // Changes made through another object are observed.
+  Settings local_settings;
+  ASSERT_TRUE(local_settings.Initialize(settings_path()));
+  ASSERT_TRUE(local_settings.SetUploadsEnabled(true));
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_TRUE(enabled);
+
+  // Once the settings file is old enough that its modification time reliably
+  // changes when it's written, it's only read again if it's modified.
+  timespec mtime;
+  ASSERT_TRUE(FileModificationTime(settings_path(), &mtime));
+  mtime.tv_sec -= 60;
+  ASSERT_TRUE(SetFileModificationTime(settings_path(), mtime));
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_TRUE(enabled);
+
+  InitializeBadFile();
+  ASSERT_TRUE(SetFileModificationTime(settings_path(), mtime));
+  enabled = false;
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_TRUE(enabled);
+
+  // Modifying the file causes it to be read again, recovering it.
+  mtime.tv_sec += 30;
+  ASSERT_TRUE(SetFileModificationTime(settings_path(), mtime));
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_FALSE(enabled);
+}
+
+TEST_F(SettingsTest, DeferredLastUploadAttemptTime) {
+  settings()->EnableCaching();
+
+  const time_t expected = time(nullptr);
+  EXPECT_TRUE(settings()->SetLastUploadAttemptTime(expected));
+
+  time_t actual = -1;
+  EXPECT_TRUE(settings()->GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, expected);
+
+  // The write is deferred, so it isn't visible to other objects yet.
+  Settings local_settings;
+  ASSERT_TRUE(local_settings.Initialize(settings_path()));
+  actual = -1;
+  EXPECT_TRUE(local_settings.GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, 0);
+
+  // Changing another setting writes the deferred change too.
+  EXPECT_TRUE(settings()->SetUploadsEnabled(true));
+  actual = -1;
+  EXPECT_TRUE(local_settings.GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, expected);
+
+  EXPECT_TRUE(settings()->SetLastUploadAttemptTime(expected + 1));
+  EXPECT_TRUE(settings()->Flush());
+  actual = -1;
+  EXPECT_TRUE(local_settings.GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, expected + 1);
+
+  // A deferred change is written when its object is destroyed.
+  {
+    Settings cached_settings;
+    ASSERT_TRUE(cached_settings.Initialize(settings_path()));
+    cached_settings.EnableCaching();
+    EXPECT_TRUE(cached_settings.SetLastUploadAttemptTime(expected + 2));
+  }
+  actual = -1;
+  EXPECT_TRUE(local_settings.GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, expected + 2);
+
+  // Enabling uploads from another object doesn't lose the deferred change.
+  EXPECT_TRUE(settings()->SetLastUploadAttemptTime(expected + 3));
+  EXPECT_TRUE(local_settings.SetUploadsEnabled(false));
+  bool enabled = true;
+  EXPECT_TRUE(settings()->GetUploadsEnabled(&enabled));
+  EXPECT_FALSE(enabled);
+  actual = -1;
+  EXPECT_TRUE(settings()->GetLastUploadAttemptTime(&actual));
+  EXPECT_EQ(actual, expected + 3);
+}
+
 // The following tests write a corrupt settings file and test the recovery
 // operation.
 
@@ -0,0 +1,109 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "client/signal_stack_pool_linux.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "util/misc/address_sanitizer.h"
+
+namespace crashpad {
+
+namespace {
+
+// Enough stacks for a burst of threads at the cost of one mmap().
+constexpr size_t kStacksPerRegion = 64;
+
+size_t RoundUpToPage(size_t size, size_t page_size) {
+  return (size + page_size - 1) & ~(page_size - 1);
+}
+
+}  // namespace
+
+SignalStackPool::SignalStackPool(size_t stack_size, size_t stacks_per_region)
+    : lock_(),
+      free_stacks_(nullptr),
+      next_stack_(nullptr),
+      stacks_left_in_region_(0),
+      page_size_(getpagesize()),
+      stack_size_(RoundUpToPage(stack_size, page_size_)),
+      stacks_per_region_(stacks_per_region) {
+  DCHECK_GT(stacks_per_region_, 0u);
+}
+
+SignalStackPool::~SignalStackPool() = default;
+
+// static
+SignalStackPool* SignalStackPool::Get() {
+  const size_t page_size = getpagesize();
+#if defined(ADDRESS_SANITIZER)
+  const size_t stack_size = 2 * RoundUpToPage(SIGSTKSZ, page_size);
+#else
+  const size_t stack_size = RoundUpToPage(SIGSTKSZ, page_size);
+#endif  // ADDRESS_SANITIZER
+  static SignalStackPool* const pool =
+      new SignalStackPool(stack_size, kStacksPerRegion);
+  return pool;
+}
+
+void* SignalStackPool::Allocate() {
+  base::AutoLock auto_lock(lock_);
+  if (free_stacks_) {
+    FreeStack* stack = free_stacks_;
+    free_stacks_ = stack->next;
+    return stack;
+  }
+
+  // Each stack is preceded by a guard page, and the region ends with one, so
+  // that every stack has a guard page on both sides.
+  const size_t stride = page_size_ + stack_size_;
+  if (!stacks_left_in_region_) {
+    const size_t region_size = stride * stacks_per_region_ + page_size_;
+    void* region = mmap(nullptr,
+                        region_size,
+                        PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1,
+                        0);
+    if (region == MAP_FAILED) {
+      PLOG(ERROR) << "mmap";
+      return nullptr;
+    }
+    next_stack_ = static_cast<char*>(region) + page_size_;
+    stacks_left_in_region_ = stacks_per_region_;
+  }
+
+  if (mprotect(next_stack_, stack_size_, PROT_READ | PROT_WRITE) != 0) {
+    PLOG(ERROR) << "mprotect";
+    return nullptr;
+  }
+
+  void* stack = next_stack_;
+  next_stack_ += stride;
+  --stacks_left_in_region_;
+  return stack;
+}
+
+void SignalStackPool::Free(void* stack) {
+  DCHECK(stack);
+  base::AutoLock auto_lock(lock_);
+  FreeStack* free_stack = static_cast<FreeStack*>(stack);
+  free_stack->next = free_stacks_;
+  free_stacks_ = free_stack;
+}
+
+}  // namespace crashpad
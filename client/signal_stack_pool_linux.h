@@ -0,0 +1,82 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CRASHPAD_CLIENT_SIGNAL_STACK_POOL_LINUX_H_
+#define CRASHPAD_CLIENT_SIGNAL_STACK_POOL_LINUX_H_
+
+#include <stddef.h>
+
+#include "base/synchronization/lock.h"
+
+namespace crashpad {
+
+//! \brief Hands out alternate signal stacks carved from larger reserved
+//!     regions, and reuses them once their threads exit.
+//!
+//! Each stack is bounded on both sides by an inaccessible guard page. A region
+//! holding many stacks is reserved with a single `mmap()`, and each stack is
+//! made accessible with `mprotect()` the first time that it is handed out.
+//! Stacks that are returned are kept on a free list and handed out again
+//! without any system call, so processes that create and destroy many
+//! short-lived threads don't repeatedly map and unmap signal stacks. Memory is
+//! never returned to the system.
+class SignalStackPool {
+ public:
+  //! \brief Constructs the object.
+  //!
+  //! \param[in] stack_size The usable size of each stack. This is rounded up
+  //!     to a multiple of the page size.
+  //! \param[in] stacks_per_region The number of stacks reserved at a time.
+  SignalStackPool(size_t stack_size, size_t stacks_per_region);
+
+  SignalStackPool(const SignalStackPool&) = delete;
+  SignalStackPool& operator=(const SignalStackPool&) = delete;
+
+  //! \brief Destroys the object, leaving all of its stacks mapped, because
+  //!     they may still be installed.
+  ~SignalStackPool();
+
+  //! \brief Returns the process-wide pool used by
+  //!     CrashpadClient::InitializeSignalStackForThread().
+  static SignalStackPool* Get();
+
+  //! \brief Returns the usable size of each stack.
+  size_t stack_size() const { return stack_size_; }
+
+  //! \brief Returns the lowest address of an accessible stack of
+  //!     stack_size() bytes, or `nullptr` on failure with a message logged.
+  void* Allocate();
+
+  //! \brief Returns a stack obtained from Allocate() to the pool.
+  //!
+  //! The stack must no longer be installed as any thread's signal stack.
+  void Free(void* stack);
+
+ private:
+  // Freed stacks are linked through their first word.
+  struct FreeStack {
+    FreeStack* next;
+  };
+
+  base::Lock lock_;
+  FreeStack* free_stacks_;
+  char* next_stack_;
+  size_t stacks_left_in_region_;
+  const size_t page_size_;
+  const size_t stack_size_;
+  const size_t stacks_per_region_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_SIGNAL_STACK_POOL_LINUX_H_
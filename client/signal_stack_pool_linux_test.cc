@@ -0,0 +1,80 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "client/signal_stack_pool_linux.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(SignalStackPool, StackSizeIsPageAligned) {
+  const size_t page_size = getpagesize();
+  SignalStackPool pool(page_size + 1, 4);
+  EXPECT_EQ(pool.stack_size(), 2 * page_size);
+}
+
+TEST(SignalStackPool, AllocateAcrossRegions) {
+  const size_t page_size = getpagesize();
+  SignalStackPool pool(page_size, 3);
+
+  std::set<char*> stacks;
+  for (size_t index = 0; index < 7; ++index) {
+    char* stack = static_cast<char*>(pool.Allocate());
+    ASSERT_TRUE(stack);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(stack) % page_size, 0u);
+
+    // The whole stack must be writable.
+    memset(stack, 0xa5, pool.stack_size());
+
+    // Stacks must not overlap, and must be separated by a guard page.
+    for (char* other : stacks) {
+      if (other < stack) {
+        EXPECT_GE(stack, other + pool.stack_size() + page_size);
+      } else {
+        EXPECT_GE(other, stack + pool.stack_size() + page_size);
+      }
+    }
+    stacks.insert(stack);
+  }
+}
+
+TEST(SignalStackPool, Reuse) {
+  SignalStackPool pool(getpagesize(), 2);
+
+  void* first = pool.Allocate();
+  void* second = pool.Allocate();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+
+  pool.Free(first);
+  pool.Free(second);
+  EXPECT_EQ(pool.Allocate(), second);
+  EXPECT_EQ(pool.Allocate(), first);
+
+  void* third = pool.Allocate();
+  ASSERT_TRUE(third);
+  EXPECT_NE(third, first);
+  EXPECT_NE(third, second);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_CLIENT_SIMPLE_STRING_DICTIONARY_H_
 #define CRASHPAD_CLIENT_SIMPLE_STRING_DICTIONARY_H_
 
+#include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -27,6 +28,28 @@
 
 namespace crashpad {
 
+//! \brief The strategy that a TSimpleStringDictionary uses to place and find
+//!     entries.
+//!
+//! Both strategies use the same TSimpleStringDictionary::Entry layout, and a
+//! reader that visits every active entry, such as the handler reading a crashed
+//! process’ annotations, does not need to know which one was used.
+enum class SimpleStringDictionaryLookup {
+  //! \brief Entries are stored in the first free slot, and found by comparing
+  //!     against every slot.
+  kLinearScan,
+
+  //! \brief Entries are stored in a slot chosen by hashing the key, probing
+  //!     linearly from there on collisions.
+  //!
+  //! Lookups and insertions examine only the slots between the key’s hash
+  //! position and the first slot that has never been used, which is much
+  //! cheaper than a full scan when the dictionary is not nearly full. Removed
+  //! entries leave a marker in the second byte of their key so that probing
+  //! continues past them, so \a KeySize must be at least 2.
+  kOpenAddressed,
+};
+
 //! \brief A map/dictionary collection implementation using a fixed amount of
 //!     storage, so that it does not perform any dynamic allocations for its
 //!     operations.
@@ -38,16 +61,22 @@ namespace crashpad {
 //! value, and map. The \a KeySize and \a ValueSize are measured in bytes, not
 //! glyphs, and include space for a trailing `NUL` byte. This gives space for
 //! `KeySize - 1` and `ValueSize - 1` characters in an entry. \a NumEntries is
-//! the total number of entries that will fit in the map.
-template <size_t KeySize = 256, size_t ValueSize = 256, size_t NumEntries = 64>
+//! the total number of entries that will fit in the map. \a Lookup selects how
+//! entries are placed within that storage.
+template <size_t KeySize = 256,
+          size_t ValueSize = 256,
+          size_t NumEntries = 64,
+          SimpleStringDictionaryLookup Lookup =
+              SimpleStringDictionaryLookup::kLinearScan>
 class TSimpleStringDictionary {
  public:
   //! \brief Constant and publicly accessible versions of the template
   //!     parameters.
   //! \{
-  static const size_t key_size = KeySize;
-  static const size_t value_size = ValueSize;
-  static const size_t num_entries = NumEntries;
+  static constexpr size_t key_size = KeySize;
+  static constexpr size_t value_size = ValueSize;
+  static constexpr size_t num_entries = NumEntries;
+  static constexpr SimpleStringDictionaryLookup lookup = Lookup;
   //! \}
 
   //! \brief A single entry in the map.
@@ -185,12 +214,9 @@ class TSimpleStringDictionary {
 
     // If it does not yet exist, attempt to insert it.
     if (!entry) {
-      for (size_t i = 0; i < num_entries; ++i) {
-        if (!entries_[i].is_active()) {
-          entry = &entries_[i];
-          SetFromStringPiece(key, entry->key, key_size);
-          break;
-        }
+      entry = GetFreeEntryForKey(key);
+      if (entry) {
+        SetFromStringPiece(key, entry->key, key_size);
       }
     }
 
@@ -231,12 +257,39 @@ class TSimpleStringDictionary {
     if (entry) {
       entry->key[0] = '\0';
       entry->value[0] = '\0';
+      if constexpr (kOpenAddressed) {
+        entry->key[1] = kRemovedMarker;
+      }
     }
 
     DCHECK_EQ(GetEntryForKey(key), implicit_cast<Entry*>(nullptr));
   }
 
  private:
+  static constexpr bool kOpenAddressed =
+      Lookup == SimpleStringDictionaryLookup::kOpenAddressed;
+  static_assert(!kOpenAddressed || KeySize >= 2,
+                "open addressing requires room for the removed marker");
+
+  // Stored in the second byte of the key of a removed entry when open
+  // addressing is used. Unlike a slot that has never been used, a removed
+  // entry may lie between a key’s hash position and its actual position.
+  static constexpr char kRemovedMarker = '\1';
+
+  // Returns the slot at which probing for key begins.
+  static size_t HashPosition(base::StringPiece key) {
+    // 32-bit FNV-1a.
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash % NumEntries;
+  }
+
+  static bool EntryNeverUsed(const Entry& entry) {
+    return entry.key[0] == '\0' && entry.key[1] != kRemovedMarker;
+  }
+
   static void SetFromStringPiece(base::StringPiece src,
                                  char* dst,
                                  size_t dst_size) {
@@ -259,6 +312,21 @@ class TSimpleStringDictionary {
   }
 
   const Entry* GetConstEntryForKey(base::StringPiece key) const {
+    if constexpr (kOpenAddressed) {
+      size_t index = HashPosition(key);
+      for (size_t probe = 0; probe < num_entries; ++probe) {
+        const Entry& entry = entries_[index];
+        if (EntryNeverUsed(entry)) {
+          return nullptr;
+        }
+        if (EntryKeyEquals(key, entry)) {
+          return &entry;
+        }
+        index = (index + 1) % num_entries;
+      }
+      return nullptr;
+    }
+
     for (size_t i = 0; i < num_entries; ++i) {
       if (EntryKeyEquals(key, entries_[i])) {
         return &entries_[i];
@@ -267,6 +335,22 @@ class TSimpleStringDictionary {
     return nullptr;
   }
 
+  // Returns the inactive entry that key should be stored in, given that key is
+  // not already present, or nullptr if the map is full.
+  Entry* GetFreeEntryForKey(base::StringPiece key) {
+    // With open addressing, the first inactive slot along the probe sequence is
+    // reached by every later lookup for key before it can stop at a slot that
+    // has never been used.
+    size_t index = kOpenAddressed ? HashPosition(key) : 0;
+    for (size_t probe = 0; probe < num_entries; ++probe) {
+      if (!entries_[index].is_active()) {
+        return &entries_[index];
+      }
+      index = (index + 1) % num_entries;
+    }
+    return nullptr;
+  }
+
   Entry* GetEntryForKey(base::StringPiece key) {
     return const_cast<Entry*>(GetConstEntryForKey(key));
   }
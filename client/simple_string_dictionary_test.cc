@@ -254,6 +254,69 @@ TEST(SimpleStringDictionary, OutOfSpace) {
   EXPECT_FALSE(map.GetValueForKey("c"));
 }
 
+TEST(SimpleStringDictionary, OpenAddressed) {
+  using TestMap =
+      TSimpleStringDictionary<8, 8, 8,
+                              SimpleStringDictionaryLookup::kOpenAddressed>;
+  static_assert(sizeof(TestMap) == sizeof(TSimpleStringDictionary<8, 8, 8>),
+                "open addressing must not change the layout");
+
+  TestMap map;
+  char key[TestMap::key_size];
+  char value[TestMap::value_size];
+
+  // Fill the map completely, so that some keys must have been placed away from
+  // their hash positions.
+  for (size_t i = 0; i < TestMap::num_entries; ++i) {
+    snprintf(key, sizeof(key), "key%zu", i);
+    snprintf(value, sizeof(value), "value%zu", i);
+    map.SetKeyValue(key, value);
+  }
+  EXPECT_EQ(map.GetCount(), TestMap::num_entries);
+  map.SetKeyValue("extra", "value");
+  EXPECT_EQ(map.GetCount(), TestMap::num_entries);
+  EXPECT_FALSE(map.GetValueForKey("extra"));
+
+  for (size_t i = 0; i < TestMap::num_entries; ++i) {
+    snprintf(key, sizeof(key), "key%zu", i);
+    snprintf(value, sizeof(value), "value%zu", i);
+    EXPECT_STREQ(map.GetValueForKey(key), value);
+  }
+
+  // Removing entries must not hide keys that were probed past them.
+  for (size_t i = 0; i < TestMap::num_entries; i += 2) {
+    snprintf(key, sizeof(key), "key%zu", i);
+    map.RemoveKey(key);
+    EXPECT_FALSE(map.GetValueForKey(key));
+  }
+  EXPECT_EQ(map.GetCount(), TestMap::num_entries / 2);
+  for (size_t i = 1; i < TestMap::num_entries; i += 2) {
+    snprintf(key, sizeof(key), "key%zu", i);
+    snprintf(value, sizeof(value), "value%zu", i);
+    EXPECT_STREQ(map.GetValueForKey(key), value);
+  }
+
+  // Removed slots are reused, and updating a key doesn't duplicate it.
+  map.SetKeyValue("a", "1");
+  map.SetKeyValue("b", "2");
+  map.SetKeyValue("a", "3");
+  EXPECT_EQ(map.GetCount(), TestMap::num_entries / 2 + 2);
+  EXPECT_STREQ(map.GetValueForKey("a"), "3");
+  EXPECT_STREQ(map.GetValueForKey("b"), "2");
+
+  size_t iterated = 0;
+  TestMap::Iterator iter(map);
+  while (iter.Next()) {
+    ++iterated;
+  }
+  EXPECT_EQ(iterated, map.GetCount());
+
+  TestMap map_copy(map);
+  EXPECT_STREQ(map_copy.GetValueForKey("a"), "3");
+  snprintf(key, sizeof(key), "key%zu", TestMap::num_entries - 1);
+  EXPECT_TRUE(map_copy.GetValueForKey(key));
+}
+
 #if DCHECK_IS_ON()
 
 TEST(SimpleStringDictionaryDeathTest, SetKeyValueWithNullKey) {
@@ -0,0 +1,435 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/stack_sampler_linux.h"
+
+#include <errno.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "build/build_config.h"
+#include "util/linux/proc_task_reader.h"
+#include "util/posix/signals.h"
+
+namespace crashpad {
+
+namespace {
+
+// How long to wait for a thread to handle the sampling signal. Threads that
+// have the signal blocked, or that are stopped, don’t handle it in time and
+// are left out of the round.
+constexpr long kSampleTimeoutNanoseconds = 10 * 1000 * 1000;
+
+// Frame records more than this far above the stack pointer are assumed not to
+// be frame records at all.
+constexpr uintptr_t kMaxFrameRecordDistance = 8 * 1024 * 1024;
+
+// A round isn’t allowed to take more than this much of the ring buffer, so
+// that the ring buffer always holds several rounds.
+constexpr size_t kMaxRoundSize = StackSampler::kCapacity / 4;
+
+// The largest encoded size of a varint holding a uint64_t.
+constexpr size_t kMaxVarintSize = 10;
+
+// The state of the outstanding sample request. While a thread is being asked
+// to record its frames, the state is its thread ID.
+constexpr int kRequestIdle = 0;
+constexpr int kRequestCapturing = -1;
+constexpr int kRequestCaptured = -2;
+
+// The request is shared between StackSampler::SampleThread() and the signal
+// handler. Only one StackSampler runs at a time, and it samples one thread at a
+// time, so there’s only ever one request outstanding.
+std::atomic<int> g_request_state(kRequestIdle);
+size_t g_request_max_frames;
+size_t g_request_frame_count;
+uint64_t g_request_frames[StackSampler::kMaxFrames];
+sem_t g_request_done;
+
+// These are protected by g_sampler_lock. g_signal is 0 until the signal
+// handler has been installed, and never changes again afterwards.
+std::mutex g_sampler_lock;
+StackSampler* g_running_sampler;
+int g_signal;
+struct sigaction g_previous_action;
+
+// Records the program counter and the return addresses found by following the
+// chain of frame records. This runs in a signal handler, so it reads the frame
+// records with process_vm_readv(), which fails instead of faulting on bad
+// addresses.
+size_t CaptureFrames(const ucontext_t* context,
+                     uint64_t* frames,
+                     size_t max_frames) {
+  uintptr_t pc;
+  uintptr_t stack_pointer = 0;
+  uintptr_t frame_pointer = 0;
+  bool record_below_frame_pointer = false;
+#if defined(ARCH_CPU_X86)
+  pc = context->uc_mcontext.gregs[REG_EIP];
+  stack_pointer = context->uc_mcontext.gregs[REG_ESP];
+  frame_pointer = context->uc_mcontext.gregs[REG_EBP];
+#elif defined(ARCH_CPU_X86_64)
+  pc = context->uc_mcontext.gregs[REG_RIP];
+  stack_pointer = context->uc_mcontext.gregs[REG_RSP];
+  frame_pointer = context->uc_mcontext.gregs[REG_RBP];
+#elif defined(ARCH_CPU_ARMEL)
+  // 32-bit ARM code has no single frame record layout.
+  pc = context->uc_mcontext.arm_pc;
+#elif defined(ARCH_CPU_ARM64)
+  pc = context->uc_mcontext.pc;
+  stack_pointer = context->uc_mcontext.sp;
+  frame_pointer = context->uc_mcontext.regs[29];
+#elif defined(ARCH_CPU_MIPS_FAMILY)
+  // Frame records aren't used consistently enough to be followed.
+  pc = context->uc_mcontext.pc;
+#elif defined(ARCH_CPU_RISCV64)
+  // __gregs[0] is the program counter, [2] is sp, and [8] is s0, the frame
+  // pointer.
+  pc = context->uc_mcontext.__gregs[0];
+  stack_pointer = context->uc_mcontext.__gregs[2];
+  frame_pointer = context->uc_mcontext.__gregs[8];
+  record_below_frame_pointer = true;
+#else
+#error Port.
+#endif
+
+  frames[0] = pc;
+  size_t frame_count = 1;
+
+  struct FrameRecord {
+    uintptr_t frame_pointer;
+    uintptr_t return_address;
+  };
+
+  const pid_t pid = getpid();
+  uintptr_t stack_start = stack_pointer;
+  while (frame_pointer && frame_count < max_frames) {
+    if (record_below_frame_pointer && frame_pointer < sizeof(FrameRecord)) {
+      break;
+    }
+    const uintptr_t record_address =
+        record_below_frame_pointer ? frame_pointer - sizeof(FrameRecord)
+                                   : frame_pointer;
+    if (record_address % sizeof(uintptr_t) != 0 ||
+        record_address < stack_start ||
+        record_address - stack_pointer > kMaxFrameRecordDistance) {
+      break;
+    }
+
+    FrameRecord record;
+    iovec local_iov = {&record, sizeof(record)};
+    iovec remote_iov = {reinterpret_cast<void*>(record_address),
+                        sizeof(record)};
+    if (syscall(SYS_process_vm_readv, pid, &local_iov, 1, &remote_iov, 1, 0) !=
+            static_cast<ssize_t>(sizeof(record)) ||
+        !record.return_address) {
+      break;
+    }
+
+    frames[frame_count++] = record.return_address;
+    stack_start = record_address + sizeof(record);
+    frame_pointer = record.frame_pointer;
+  }
+  return frame_count;
+}
+
+// Passes signals that the sampler didn’t send to the handler that was
+// installed before it. A previous default action is not taken, because it was
+// replaced by the sampler.
+void ForwardSignal(int signo, siginfo_t* siginfo, void* context) {
+  const struct sigaction& previous = g_previous_action;
+  if (previous.sa_flags & SA_SIGINFO) {
+    if (previous.sa_sigaction) {
+      previous.sa_sigaction(signo, siginfo, context);
+    }
+  } else if (previous.sa_handler != SIG_DFL &&
+             previous.sa_handler != SIG_IGN) {
+    previous.sa_handler(signo);
+  }
+}
+
+void HandleSampleSignal(int signo, siginfo_t* siginfo, void* context) {
+  if (siginfo->si_code != SI_TKILL || siginfo->si_pid != getpid()) {
+    ForwardSignal(signo, siginfo, context);
+    return;
+  }
+
+  const int saved_errno = errno;
+
+  // A signal for a request that has since been withdrawn is ignored.
+  int expected = static_cast<int>(syscall(SYS_gettid));
+  if (g_request_state.compare_exchange_strong(
+          expected, kRequestCapturing, std::memory_order_acquire)) {
+    g_request_frame_count =
+        CaptureFrames(static_cast<const ucontext_t*>(context),
+                      g_request_frames,
+                      g_request_max_frames);
+    g_request_state.store(kRequestCaptured, std::memory_order_release);
+    sem_post(&g_request_done);
+  }
+
+  errno = saved_errno;
+}
+
+void AppendVarint(std::vector<uint8_t>* buffer, uint64_t value) {
+  while (value >= 0x80) {
+    buffer->push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  buffer->push_back(static_cast<uint8_t>(value));
+}
+
+bool ReadVarint(const uint8_t** data, const uint8_t* end, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; *data != end && shift < 64; shift += 7) {
+    const uint8_t byte = *(*data)++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t ZigzagEncode(uint64_t difference) {
+  return (difference << 1) ^ (0 - (difference >> 63));
+}
+
+uint64_t ZigzagDecode(uint64_t value) {
+  return (value >> 1) ^ (0 - (value & 1));
+}
+
+// Sends signal to tid and waits for its handler to finish capturing. Returns
+// false if the signal couldn’t be sent or the wait timed out.
+bool SignalThreadAndWait(pid_t tid, int signal) {
+  if (syscall(SYS_tgkill, getpid(), tid, signal) != 0) {
+    return false;
+  }
+
+  timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_nsec += kSampleTimeoutNanoseconds;
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_nsec -= 1000000000;
+    ++deadline.tv_sec;
+  }
+
+  if (HANDLE_EINTR(sem_timedwait(&g_request_done, &deadline)) != 0) {
+    PLOG_IF(ERROR, errno != ETIMEDOUT) << "sem_timedwait";
+    return false;
+  }
+  return true;
+}
+
+uint64_t NowMilliseconds() {
+  timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+}  // namespace
+
+StackSampler::StackSampler(Annotation::Type type, const char name[])
+    : annotation_(type, name),
+      sample_lock_(),
+      tids_(),
+      thread_data_(),
+      item_(),
+      thread_(),
+      signal_(0),
+      max_frames_(0) {}
+
+StackSampler::~StackSampler() {
+  Stop();
+}
+
+bool StackSampler::Start(int signal, double interval, size_t max_frames) {
+  DCHECK(!thread_);
+  if (max_frames == 0 || max_frames > kMaxFrames) {
+    LOG(ERROR) << "invalid max_frames " << max_frames;
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(g_sampler_lock);
+    if (g_running_sampler) {
+      LOG(ERROR) << "another StackSampler is running";
+      return false;
+    }
+
+    if (!g_signal) {
+      if (sem_init(&g_request_done, 0, 0) != 0) {
+        PLOG(ERROR) << "sem_init";
+        return false;
+      }
+      if (!Signals::InstallHandler(
+              signal, HandleSampleSignal, SA_RESTART, &g_previous_action)) {
+        return false;
+      }
+      g_signal = signal;
+    } else if (signal != g_signal) {
+      LOG(ERROR) << "signal " << signal << " differs from the installed signal "
+                 << g_signal;
+      return false;
+    }
+
+    g_running_sampler = this;
+  }
+
+  signal_ = signal;
+  max_frames_ = max_frames;
+  thread_ = std::make_unique<WorkerThread>(interval, this);
+  thread_->Start(0);
+  return true;
+}
+
+void StackSampler::Stop() {
+  if (!thread_) {
+    return;
+  }
+  thread_->Stop();
+  thread_.reset();
+
+  std::lock_guard<std::mutex> lock(g_sampler_lock);
+  DCHECK_EQ(g_running_sampler, this);
+  g_running_sampler = nullptr;
+}
+
+bool StackSampler::SampleNow() {
+  DCHECK(thread_);
+  std::lock_guard<std::mutex> lock(sample_lock_);
+
+  const uint64_t time_ms = NowMilliseconds();
+  tids_.clear();
+  if (!ReadThreadIDs(getpid(), &tids_)) {
+    return false;
+  }
+
+  // The threads are encoded first, because the item begins with their count.
+  const pid_t self = static_cast<pid_t>(syscall(SYS_gettid));
+  const size_t max_thread_size = (2 + max_frames_) * kMaxVarintSize;
+  thread_data_.clear();
+  size_t thread_count = 0;
+  uint64_t frames[kMaxFrames];
+  for (pid_t tid : tids_) {
+    if (thread_data_.size() + max_thread_size > kMaxRoundSize) {
+      break;
+    }
+    if (tid == self) {
+      continue;
+    }
+
+    const size_t frame_count = SampleThread(tid, frames);
+    if (!frame_count) {
+      continue;
+    }
+
+    AppendVarint(&thread_data_, tid);
+    AppendVarint(&thread_data_, frame_count);
+    AppendVarint(&thread_data_, frames[0]);
+    for (size_t index = 1; index < frame_count; ++index) {
+      AppendVarint(&thread_data_,
+                   ZigzagEncode(frames[index] - frames[index - 1]));
+    }
+    ++thread_count;
+  }
+
+  item_.clear();
+  AppendVarint(&item_, time_ms);
+  AppendVarint(&item_, thread_count);
+  item_.insert(item_.end(), thread_data_.begin(), thread_data_.end());
+  return annotation_.Push(item_.data(),
+                          static_cast<RingBufferAnnotationCapacity>(
+                              item_.size()));
+}
+
+// static
+bool StackSampler::DecodeSample(const std::vector<uint8_t>& item,
+                                Sample* sample) {
+  const uint8_t* data = item.data();
+  const uint8_t* const end = data + item.size();
+
+  uint64_t thread_count;
+  if (!ReadVarint(&data, end, &sample->time_ms) ||
+      !ReadVarint(&data, end, &thread_count) ||
+      thread_count > item.size()) {
+    return false;
+  }
+
+  sample->threads.resize(thread_count);
+  for (ThreadSample& thread : sample->threads) {
+    uint64_t tid;
+    uint64_t frame_count;
+    if (!ReadVarint(&data, end, &tid) ||
+        !ReadVarint(&data, end, &frame_count) || frame_count == 0 ||
+        frame_count > kMaxFrames) {
+      return false;
+    }
+    thread.tid = static_cast<pid_t>(tid);
+
+    thread.frames.resize(frame_count);
+    if (!ReadVarint(&data, end, &thread.frames[0])) {
+      return false;
+    }
+    for (size_t index = 1; index < frame_count; ++index) {
+      uint64_t difference;
+      if (!ReadVarint(&data, end, &difference)) {
+        return false;
+      }
+      thread.frames[index] =
+          thread.frames[index - 1] + ZigzagDecode(difference);
+    }
+  }
+  return data == end;
+}
+
+void StackSampler::DoWork(const WorkerThread* thread) {
+  SampleNow();
+}
+
+size_t StackSampler::SampleThread(pid_t tid, uint64_t* frames) {
+  g_request_max_frames = max_frames_;
+  g_request_state.store(tid, std::memory_order_release);
+
+  if (!SignalThreadAndWait(tid, signal_)) {
+    // Withdraw the request. The thread may have exited since it was
+    // enumerated, or it may not have handled the signal yet. If its handler has
+    // already claimed the request, wait for it to finish.
+    int expected = tid;
+    if (g_request_state.compare_exchange_strong(expected, kRequestIdle)) {
+      return 0;
+    }
+    HANDLE_EINTR(sem_wait(&g_request_done));
+  }
+
+  DCHECK_EQ(g_request_state.load(std::memory_order_acquire), kRequestCaptured);
+  const size_t frame_count = g_request_frame_count;
+  std::copy(g_request_frames, g_request_frames + frame_count, frames);
+  g_request_state.store(kRequestIdle, std::memory_order_relaxed);
+  return frame_count;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,173 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_CLIENT_STACK_SAMPLER_LINUX_H_
+#define CRASHPAD_CLIENT_STACK_SAMPLER_LINUX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "client/annotation.h"
+#include "client/ring_buffer_annotation.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+//! \brief Periodically samples the stacks of every thread in this process into
+//!     a ring buffer annotation.
+//!
+//! Each round of sampling sends a signal to each of the process’ threads in
+//! turn. The signal handler records the thread’s program counter and follows
+//! its chain of frame records for the return addresses of a small number of
+//! callers, then returns. The round is pushed onto a `RingBufferAnnotation` as
+//! a single item, dropping the oldest rounds once the ring buffer is full, so
+//! that the annotation holds what the process was doing for the last several
+//! seconds. Like any other annotation, it’s captured in every crash report and
+//! dump taken without a crash, such as for a hang.
+//!
+//! Frame records are read with `process_vm_readv()` on this process, so that a
+//! corrupt chain ends the walk rather than crashing. If that system call isn’t
+//! permitted, only each thread’s program counter is recorded. Code built
+//! without frame pointers also yields only its program counter. 32-bit ARM and
+//! MIPS code has no frame record layout that can be followed, so only the
+//! program counter is recorded there, too.
+//!
+//! Sampling signals interrupt system calls. The handler is installed with
+//! `SA_RESTART`, but some system calls, such as `nanosleep()` and
+//! `epoll_wait()`, return `EINTR` regardless, and the process must already be
+//! prepared for that. Signals not sent by the sampler go to the handler that
+//! was installed before it. The sampler’s handler stays installed after
+//! Stop(), because signals sent to blocked threads may still be pending.
+//!
+//! Only one StackSampler may be running in a process at a time. Because its
+//! annotation is never removed from the process’ annotation list, a
+//! StackSampler should have static storage duration.
+//!
+//! Each item in the ring buffer encodes one round. Every field is an unsigned
+//! little-endian Base 128 varint:
+//!  - the time that the round began, in milliseconds since the POSIX epoch
+//!  - the number of threads sampled
+//!  - for each thread, its thread ID, the number of frames recorded, and its
+//!    frames, innermost first. The first frame is the thread’s program counter,
+//!    and the rest are return addresses. Each frame after the first is stored
+//!    as the zigzag-encoded difference from the frame before it.
+//!
+//! Use DecodeSample() to decode an item read with
+//! `LengthDelimitedRingBufferReader`.
+class StackSampler final : public WorkerThread::Delegate {
+ public:
+  //! \brief The capacity of the ring buffer, in bytes. This is close to the
+  //!     largest annotation that will be captured.
+  static constexpr RingBufferAnnotationCapacity kCapacity = 16 * 1024;
+
+  //! \brief The maximum number of frames recorded for each thread.
+  static constexpr size_t kMaxFrames = 32;
+
+  //! \brief The stack of one thread, sampled in one round.
+  struct ThreadSample {
+    //! \brief The thread’s ID.
+    pid_t tid;
+
+    //! \brief The thread’s program counter, followed by the return addresses
+    //!     of its callers.
+    std::vector<uint64_t> frames;
+  };
+
+  //! \brief One round of sampling, as decoded by DecodeSample().
+  struct Sample {
+    //! \brief The time that the round began, in milliseconds since the POSIX
+    //!     epoch.
+    uint64_t time_ms;
+
+    //! \brief The threads sampled.
+    std::vector<ThreadSample> threads;
+  };
+
+  //! \brief Constructs the object.
+  //!
+  //! \param[in] type The type of the annotation holding the samples.
+  //! \param[in] name The name of the annotation holding the samples.
+  StackSampler(Annotation::Type type, const char name[]);
+
+  StackSampler(const StackSampler&) = delete;
+  StackSampler& operator=(const StackSampler&) = delete;
+
+  ~StackSampler() override;
+
+  //! \brief Installs the signal handler and begins sampling on a thread of
+  //!     its own.
+  //!
+  //! \param[in] signal The signal used to interrupt threads. It shouldn’t be
+  //!     blocked by any thread that should be sampled. Every StackSampler in
+  //!     the process must use the same signal.
+  //! \param[in] interval The time between rounds, in seconds.
+  //! \param[in] max_frames The maximum number of frames to record for each
+  //!     thread, up to #kMaxFrames.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool Start(int signal, double interval, size_t max_frames);
+
+  //! \brief Stops sampling, waiting for a round in progress to finish.
+  void Stop();
+
+  //! \brief Samples every thread other than the calling thread once, and
+  //!     pushes the round onto the ring buffer.
+  //!
+  //! This is called periodically after Start(), and may also be called
+  //! directly after Start() to record a round at a particular time.
+  //!
+  //! \return `true` if the round was recorded. `false` if the threads couldn’t
+  //!     be enumerated, or if the ring buffer was being read.
+  bool SampleNow();
+
+  //! \brief Decodes one item of the ring buffer.
+  //!
+  //! \param[in] item An item read from the ring buffer.
+  //! \param[out] sample The decoded round.
+  //!
+  //! \return `true` on success. `false` if \a item is malformed.
+  static bool DecodeSample(const std::vector<uint8_t>& item, Sample* sample);
+
+  //! \brief The annotation holding the samples.
+  const RingBufferAnnotation<kCapacity>& annotation() const {
+    return annotation_;
+  }
+
+ private:
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  // Signals tid and waits for its handler to record its frames into the
+  // request. Returns the number of frames recorded, or 0 if the thread didn’t
+  // handle the signal in time.
+  size_t SampleThread(pid_t tid, uint64_t* frames);
+
+  RingBufferAnnotation<kCapacity> annotation_;
+  std::mutex sample_lock_;
+  std::vector<pid_t> tids_;
+  std::vector<uint8_t> thread_data_;
+  std::vector<uint8_t> item_;
+  std::unique_ptr<WorkerThread> thread_;
+  int signal_;
+  size_t max_frames_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_CLIENT_STACK_SAMPLER_LINUX_H_
@@ -0,0 +1,196 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/stack_sampler_linux.h"
+
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <vector>
+
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "client/length_delimited_ring_buffer.h"
+#include "gtest/gtest.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr Annotation::Type kType = Annotation::UserDefinedType(1);
+constexpr char kName[] = "stack samples";
+
+// A sampler that is never started automatically, so that each round is taken
+// by the test.
+constexpr double kLongInterval = 1000;
+
+class SpinningThread : public Thread {
+ public:
+  SpinningThread() : tid_(0), stop_(false) {}
+
+  SpinningThread(const SpinningThread&) = delete;
+  SpinningThread& operator=(const SpinningThread&) = delete;
+
+  ~SpinningThread() override {}
+
+  pid_t WaitForTid() {
+    pid_t tid;
+    while (!(tid = tid_.load())) {
+      sched_yield();
+    }
+    return tid;
+  }
+
+  void Stop() { stop_ = true; }
+
+ private:
+  void ThreadMain() override {
+    tid_ = static_cast<pid_t>(syscall(SYS_gettid));
+    while (!stop_) {
+    }
+  }
+
+  std::atomic<pid_t> tid_;
+  std::atomic<bool> stop_;
+};
+
+class StackSamplerTest : public testing::Test {
+ public:
+  void SetUp() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(&annotations_);
+  }
+
+  void TearDown() override {
+    CrashpadInfo::GetCrashpadInfo()->set_annotations_list(nullptr);
+  }
+
+  // Returns every round in the sampler’s annotation, oldest first.
+  std::vector<StackSampler::Sample> ReadSamples(const StackSampler& sampler) {
+    const Annotation& annotation = sampler.annotation();
+    RingBufferData<StackSampler::kCapacity> data;
+    EXPECT_TRUE(
+        data.DeserializeFromBuffer(annotation.value(), annotation.size()));
+
+    std::vector<StackSampler::Sample> samples;
+    LengthDelimitedRingBufferReader reader(data);
+    std::vector<uint8_t> item;
+    while (reader.Pop(item)) {
+      StackSampler::Sample sample;
+      EXPECT_TRUE(StackSampler::DecodeSample(item, &sample));
+      samples.push_back(sample);
+      item.clear();
+    }
+    return samples;
+  }
+
+ private:
+  AnnotationList annotations_;
+};
+
+TEST_F(StackSamplerTest, SamplesThreads) {
+  SpinningThread thread;
+  thread.Start();
+  const pid_t tid = thread.WaitForTid();
+
+  timespec now;
+  ASSERT_EQ(clock_gettime(CLOCK_REALTIME, &now), 0);
+  const uint64_t now_ms =
+      static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+
+  StackSampler sampler(kType, kName);
+  ASSERT_TRUE(sampler.Start(SIGPROF, kLongInterval, 8));
+
+  ASSERT_TRUE(sampler.SampleNow());
+  sampler.Stop();
+  thread.Stop();
+  thread.Join();
+
+  // The sampler takes one round on its own thread when it starts, and this
+  // thread took another, which left this thread out.
+  const std::vector<StackSampler::Sample> samples = ReadSamples(sampler);
+  ASSERT_EQ(samples.size(), 2u);
+
+  const pid_t self = static_cast<pid_t>(syscall(SYS_gettid));
+  size_t samples_with_self = 0;
+  for (const StackSampler::Sample& sample : samples) {
+    EXPECT_GE(sample.time_ms, now_ms);
+    EXPECT_LT(sample.time_ms, now_ms + 60 * 1000);
+
+    bool found_thread = false;
+    for (const StackSampler::ThreadSample& thread_sample : sample.threads) {
+      EXPECT_GE(thread_sample.frames.size(), 1u);
+      EXPECT_LE(thread_sample.frames.size(), 8u);
+      EXPECT_NE(thread_sample.frames[0], 0u);
+      if (thread_sample.tid == tid) {
+        found_thread = true;
+      } else if (thread_sample.tid == self) {
+        ++samples_with_self;
+      }
+    }
+    EXPECT_TRUE(found_thread);
+  }
+  EXPECT_LE(samples_with_self, 1u);
+}
+
+TEST_F(StackSamplerTest, OneAtATime) {
+  StackSampler sampler(kType, kName);
+  EXPECT_FALSE(sampler.Start(SIGPROF, kLongInterval, 0));
+  EXPECT_FALSE(
+      sampler.Start(SIGPROF, kLongInterval, StackSampler::kMaxFrames + 1));
+  ASSERT_TRUE(sampler.Start(SIGPROF, kLongInterval, 1));
+
+  StackSampler other(kType, kName);
+  EXPECT_FALSE(other.Start(SIGPROF, kLongInterval, 1));
+  sampler.Stop();
+
+  // The handler stays installed for the first signal used.
+  EXPECT_FALSE(other.Start(SIGVTALRM, kLongInterval, 1));
+  ASSERT_TRUE(other.Start(SIGPROF, kLongInterval, 1));
+  other.Stop();
+}
+
+TEST(StackSampler, DecodeSampleRejectsMalformedItems) {
+  StackSampler::Sample sample;
+  EXPECT_FALSE(StackSampler::DecodeSample({}, &sample));
+
+  // time, thread count
+  EXPECT_TRUE(StackSampler::DecodeSample({0x01, 0x00}, &sample));
+  EXPECT_EQ(sample.time_ms, 1u);
+  EXPECT_TRUE(sample.threads.empty());
+
+  // time, thread count, tid, frame count, frame, zigzag difference of -2
+  EXPECT_TRUE(StackSampler::DecodeSample(
+      {0x01, 0x01, 0x07, 0x02, 0x90, 0x01, 0x03}, &sample));
+  ASSERT_EQ(sample.threads.size(), 1u);
+  EXPECT_EQ(sample.threads[0].tid, 7);
+  EXPECT_EQ(sample.threads[0].frames, (std::vector<uint64_t>{144, 142}));
+
+  // Truncated.
+  EXPECT_FALSE(StackSampler::DecodeSample({0x01, 0x01, 0x07, 0x02, 0x90, 0x01},
+                                          &sample));
+
+  // Trailing data.
+  EXPECT_FALSE(StackSampler::DecodeSample({0x01, 0x00, 0x00}, &sample));
+
+  // No frames.
+  EXPECT_FALSE(StackSampler::DecodeSample({0x01, 0x01, 0x07, 0x00}, &sample));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
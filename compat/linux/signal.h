@@ -34,6 +34,10 @@
 #if !defined(X86_FXSR_MAGIC)
 #define X86_FXSR_MAGIC 0x0000
 #endif
+
+#if !defined(FP_XSTATE_MAGIC1)
+#define FP_XSTATE_MAGIC1 0x46505853
+#endif
 #endif  // __x86_64__ || __i386__
 
 #if defined(__aarch64__) || defined(__arm__)
@@ -50,6 +54,10 @@
 #define EXTRA_MAGIC 0x45585401
 #endif
 
+#if !defined(SVE_MAGIC)
+#define SVE_MAGIC 0x53564501
+#endif
+
 #if !defined(VFP_MAGIC)
 #define VFP_MAGIC 0x56465001
 #endif
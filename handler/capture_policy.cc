@@ -0,0 +1,155 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/capture_policy.h"
+
+#include <limits>
+
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
+
+namespace crashpad {
+
+namespace {
+
+template <typename T>
+bool ParseSetting(const std::string& string, std::optional<T>* setting) {
+  unsigned long long value;
+  if (!StringToNumber(string, &value) ||
+      value > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  *setting = static_cast<T>(value);
+  return true;
+}
+
+}  // namespace
+
+CapturePolicy::CapturePolicy()
+    : description(),
+      process_name(),
+      annotation_key(),
+      annotation_value(),
+      max_thread_stacks(),
+      max_indirect_bytes(),
+      indirect_memory_depth(),
+      capture_timeout_ms(),
+      max_other_threads(),
+      thread_name_patterns(),
+      trim_stacks(false) {}
+
+CapturePolicy::CapturePolicy(const CapturePolicy& other) = default;
+
+CapturePolicy& CapturePolicy::operator=(const CapturePolicy& other) = default;
+
+CapturePolicy::~CapturePolicy() = default;
+
+CapturePolicyTable::CapturePolicyTable() : policies_() {}
+
+CapturePolicyTable::~CapturePolicyTable() = default;
+
+bool CapturePolicyTable::AddPolicy(const std::string& string) {
+  const std::vector<std::string> parts = SplitString(string, ',');
+  if (parts.empty()) {
+    return false;
+  }
+
+  CapturePolicy policy;
+  policy.description = string;
+
+  std::string selector_type;
+  std::string selector;
+  if (!SplitStringFirst(parts[0], ':', &selector_type, &selector) ||
+      selector.empty()) {
+    return false;
+  }
+  if (selector_type == "process") {
+    policy.process_name = selector;
+  } else if (selector_type == "annotation") {
+    if (!SplitStringFirst(
+            selector, '=', &policy.annotation_key, &policy.annotation_value)) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+
+  for (size_t index = 1; index < parts.size(); ++index) {
+    const std::string& part = parts[index];
+    if (part == "trim-stacks") {
+      policy.trim_stacks = true;
+      continue;
+    }
+
+    std::string key;
+    std::string value;
+    if (!SplitStringFirst(part, '=', &key, &value)) {
+      return false;
+    }
+    bool parsed;
+    if (key == "max-thread-stacks") {
+      parsed = ParseSetting(value, &policy.max_thread_stacks);
+    } else if (key == "max-indirect-bytes") {
+      parsed = ParseSetting(value, &policy.max_indirect_bytes);
+    } else if (key == "indirect-memory-depth") {
+      parsed = ParseSetting(value, &policy.indirect_memory_depth);
+    } else if (key == "capture-timeout") {
+      parsed = ParseSetting(value, &policy.capture_timeout_ms);
+    } else if (key == "max-other-threads") {
+      parsed = ParseSetting(value, &policy.max_other_threads);
+    } else if (key == "thread-name") {
+      policy.thread_name_patterns.push_back(value);
+      parsed = !value.empty();
+    } else {
+      parsed = false;
+    }
+    if (!parsed) {
+      return false;
+    }
+  }
+
+  policies_.push_back(policy);
+  return true;
+}
+
+const CapturePolicy* CapturePolicyTable::Find(
+    const std::string& process_name,
+    const std::map<std::string, std::string>& annotations) const {
+  for (const CapturePolicy& policy : policies_) {
+    if (!policy.process_name.empty()) {
+      if (policy.process_name == process_name) {
+        return &policy;
+      }
+      continue;
+    }
+
+    const auto annotation = annotations.find(policy.annotation_key);
+    if (annotation != annotations.end() &&
+        annotation->second == policy.annotation_value) {
+      return &policy;
+    }
+  }
+  return nullptr;
+}
+
+bool CapturePolicyTable::HasAnnotationSelectors() const {
+  for (const CapturePolicy& policy : policies_) {
+    if (policy.process_name.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace crashpad
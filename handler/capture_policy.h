@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_CAPTURE_POLICY_H_
+#define CRASHPAD_HANDLER_CAPTURE_POLICY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief Capture settings that apply to the clients matching a selector.
+//!
+//! A policy is selected either by the name of the client’s executable or by
+//! an annotation that the client has set. Each setting that is present limits
+//! what is captured for a matching client. A policy can only reduce a capture
+//! relative to the handler-wide settings, never extend it.
+struct CapturePolicy {
+  CapturePolicy();
+  CapturePolicy(const CapturePolicy& other);
+  CapturePolicy& operator=(const CapturePolicy& other);
+  ~CapturePolicy();
+
+  //! \brief The policy as it was given to CapturePolicyTable::AddPolicy().
+  std::string description;
+
+  //! \brief The base name of the executable to match, or empty to select by
+  //!     annotation instead.
+  std::string process_name;
+
+  //! \brief The key of the annotation to match, used when #process_name is
+  //!     empty.
+  std::string annotation_key;
+
+  //! \brief The value that the annotation named by #annotation_key must have.
+  std::string annotation_value;
+
+  //! \brief The maximum number of thread stacks to capture. See
+  //!     ProcessSnapshotLinux::SetMaxThreadStacks().
+  std::optional<size_t> max_thread_stacks;
+
+  //! \brief The maximum number of bytes of indirectly referenced memory to
+  //!     capture. See ProcessSnapshotLinux::SetIndirectMemoryLimit().
+  std::optional<uint32_t> max_indirect_bytes;
+
+  //! \brief The maximum number of levels of pointers to follow when capturing
+  //!     indirectly referenced memory. See
+  //!     ProcessSnapshotLinux::SetIndirectMemoryDepth().
+  std::optional<size_t> indirect_memory_depth;
+
+  //! \brief The maximum time to spend capturing, in milliseconds. See
+  //!     ProcessSnapshotLinux::SetCaptureDeadline().
+  std::optional<uint64_t> capture_timeout_ms;
+
+  //! \brief The number of threads to capture besides the exception thread and
+  //!     those selected by name or ID. See ThreadFilter::max_other_threads.
+  std::optional<size_t> max_other_threads;
+
+  //! \brief Patterns for the names of threads to capture. See
+  //!     ThreadFilter::name_patterns.
+  std::vector<std::string> thread_name_patterns;
+
+  //! \brief Whether thread stacks should be trimmed to their live frames. See
+  //!     ProcessSnapshotLinux::SetStackTrimming().
+  bool trim_stacks;
+
+  //! \brief Whether this policy limits which threads are captured, so that a
+  //!     ThreadFilter should be applied.
+  bool SelectsThreads() const {
+    return max_other_threads || !thread_name_patterns.empty();
+  }
+};
+
+//! \brief An ordered list of CapturePolicy objects, of which the first that
+//!     matches a client applies to it.
+class CapturePolicyTable {
+ public:
+  CapturePolicyTable();
+
+  CapturePolicyTable(const CapturePolicyTable&) = delete;
+  CapturePolicyTable& operator=(const CapturePolicyTable&) = delete;
+
+  ~CapturePolicyTable();
+
+  //! \brief Parses a policy and adds it to the end of the table.
+  //!
+  //! A policy is a selector followed by comma-separated settings. The selector
+  //! is either `process:NAME`, matching clients whose executable’s base name
+  //! is `NAME`, or `annotation:KEY=VALUE`, matching clients with a simple or
+  //! string annotation `KEY` set to `VALUE`. The settings are
+  //! `max-thread-stacks=N`, `max-indirect-bytes=N`, `indirect-memory-depth=N`,
+  //! `capture-timeout=MILLISECONDS`, `max-other-threads=N`,
+  //! `thread-name=PATTERN`, which may be repeated, and `trim-stacks`. For
+  //! example: `process:renderer,max-thread-stacks=8,trim-stacks` or
+  //! `process:java,max-other-threads=1,thread-name=GC*`.
+  //!
+  //! \param[in] string The policy to parse.
+  //! \return `true` on success. `false` if \a string couldn’t be parsed, in
+  //!     which case the table is unchanged.
+  bool AddPolicy(const std::string& string);
+
+  //! \brief Returns the first policy that matches a client.
+  //!
+  //! \param[in] process_name The base name of the client’s executable.
+  //! \param[in] annotations The client’s annotations.
+  //! \return The matching policy, or `nullptr` if none matches.
+  const CapturePolicy* Find(
+      const std::string& process_name,
+      const std::map<std::string, std::string>& annotations) const;
+
+  //! \brief Whether the table has no policies.
+  bool empty() const { return policies_.empty(); }
+
+  //! \brief Whether any policy is selected by annotation, so that the
+  //!     client’s annotations must be read to find a match.
+  bool HasAnnotationSelectors() const;
+
+ private:
+  std::vector<CapturePolicy> policies_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_CAPTURE_POLICY_H_
@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/capture_policy.h"
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(CapturePolicy, Parse) {
+  CapturePolicyTable table;
+  EXPECT_TRUE(table.empty());
+
+  ASSERT_TRUE(table.AddPolicy(
+      "process:renderer,max-thread-stacks=8,max-indirect-bytes=4096,"
+      "indirect-memory-depth=2,capture-timeout=500,trim-stacks"));
+  EXPECT_FALSE(table.empty());
+  EXPECT_FALSE(table.HasAnnotationSelectors());
+
+  const CapturePolicy* policy = table.Find("renderer", {});
+  ASSERT_TRUE(policy);
+  EXPECT_EQ(policy->process_name, "renderer");
+  EXPECT_EQ(policy->description,
+            "process:renderer,max-thread-stacks=8,max-indirect-bytes=4096,"
+            "indirect-memory-depth=2,capture-timeout=500,trim-stacks");
+  ASSERT_TRUE(policy->max_thread_stacks);
+  EXPECT_EQ(*policy->max_thread_stacks, 8u);
+  ASSERT_TRUE(policy->max_indirect_bytes);
+  EXPECT_EQ(*policy->max_indirect_bytes, 4096u);
+  ASSERT_TRUE(policy->indirect_memory_depth);
+  EXPECT_EQ(*policy->indirect_memory_depth, 2u);
+  ASSERT_TRUE(policy->capture_timeout_ms);
+  EXPECT_EQ(*policy->capture_timeout_ms, 500u);
+  EXPECT_TRUE(policy->trim_stacks);
+  EXPECT_FALSE(policy->SelectsThreads());
+
+  ASSERT_TRUE(table.AddPolicy(
+      "process:java,max-other-threads=1,thread-name=main,thread-name=GC*"));
+  policy = table.Find("java", {});
+  ASSERT_TRUE(policy);
+  EXPECT_TRUE(policy->SelectsThreads());
+  ASSERT_TRUE(policy->max_other_threads);
+  EXPECT_EQ(*policy->max_other_threads, 1u);
+  EXPECT_EQ(policy->thread_name_patterns,
+            std::vector<std::string>({"main", "GC*"}));
+
+  ASSERT_TRUE(table.AddPolicy("annotation:ptype=gpu-process"));
+  EXPECT_TRUE(table.HasAnnotationSelectors());
+  policy = table.Find("chrome", {{"ptype", "gpu-process"}});
+  ASSERT_TRUE(policy);
+  EXPECT_EQ(policy->annotation_key, "ptype");
+  EXPECT_EQ(policy->annotation_value, "gpu-process");
+  EXPECT_FALSE(policy->max_thread_stacks);
+  EXPECT_FALSE(policy->max_indirect_bytes);
+  EXPECT_FALSE(policy->indirect_memory_depth);
+  EXPECT_FALSE(policy->capture_timeout_ms);
+  EXPECT_FALSE(policy->trim_stacks);
+}
+
+TEST(CapturePolicy, ParseFailures) {
+  CapturePolicyTable table;
+  EXPECT_FALSE(table.AddPolicy(""));
+  EXPECT_FALSE(table.AddPolicy("renderer"));
+  EXPECT_FALSE(table.AddPolicy("process:"));
+  EXPECT_FALSE(table.AddPolicy("executable:renderer"));
+  EXPECT_FALSE(table.AddPolicy("annotation:ptype"));
+  EXPECT_FALSE(table.AddPolicy("process:renderer,max-thread-stacks"));
+  EXPECT_FALSE(table.AddPolicy("process:renderer,max-thread-stacks=x"));
+  EXPECT_FALSE(table.AddPolicy("process:renderer,max-indirect-bytes=-1"));
+  EXPECT_FALSE(
+      table.AddPolicy("process:renderer,max-indirect-bytes=4294967296"));
+  EXPECT_FALSE(table.AddPolicy("process:renderer,max-memory=1"));
+  EXPECT_FALSE(table.AddPolicy("process:renderer,,trim-stacks"));
+  EXPECT_FALSE(table.AddPolicy("process:renderer,thread-name="));
+  EXPECT_TRUE(table.empty());
+}
+
+TEST(CapturePolicy, FirstMatchWins) {
+  CapturePolicyTable table;
+  ASSERT_TRUE(table.AddPolicy("annotation:ptype=renderer,max-thread-stacks=1"));
+  ASSERT_TRUE(table.AddPolicy("process:chrome,max-thread-stacks=2"));
+  ASSERT_TRUE(table.AddPolicy("process:chrome,max-thread-stacks=3"));
+
+  const std::map<std::string, std::string> renderer = {{"ptype", "renderer"}};
+  const CapturePolicy* policy = table.Find("chrome", renderer);
+  ASSERT_TRUE(policy);
+  EXPECT_EQ(*policy->max_thread_stacks, 1u);
+
+  policy = table.Find("chrome", {{"ptype", "browser"}});
+  ASSERT_TRUE(policy);
+  EXPECT_EQ(*policy->max_thread_stacks, 2u);
+
+  EXPECT_FALSE(table.Find("content_shell", {{"ptype", "browser"}}));
+  EXPECT_FALSE(table.Find("content_shell", {}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
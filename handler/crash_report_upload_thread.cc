@@ -15,30 +15,55 @@
 #include "handler/crash_report_upload_thread.h"
 
 #include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <time.h>
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/notreached.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "client/settings.h"
+#include "handler/crash_signature.h"
 #include "handler/minidump_to_upload_parameters.h"
+#include "handler/upload_rate_limiter.h"
+#include "minidump/minidump_repacker.h"
 #include "snapshot/minidump/process_snapshot_minidump.h"
 #include "snapshot/module_snapshot.h"
+#include "util/file/buffered_file_reader.h"
+#include "util/file/chunked_memory_file.h"
+#include "util/file/file_helper.h"
 #include "util/file/file_reader.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_event.h"
 #include "util/misc/uuid.h"
 #include "util/net/http_body.h"
+#include "util/net/http_body_rate_limited.h"
+#include "util/net/http_headers.h"
 #include "util/net/http_multipart_builder.h"
 #include "util/net/http_transport.h"
 #include "util/net/url.h"
 #include "util/stdlib/map_insert.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "util/linux/cpu_affinity.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
 #if BUILDFLAG(IS_APPLE)
 #include "handler/mac/file_limit_annotation.h"
@@ -55,6 +80,11 @@ namespace {
 // The number of seconds to wait between checking for pending reports.
 const int kRetryWorkIntervalSeconds = 15 * 60;
 
+// With Options::adaptive_scheduling, the shortest and longest number of seconds
+// to wait between checking for pending reports.
+constexpr double kAdaptiveMinimumWorkIntervalSeconds = 60;
+constexpr double kAdaptiveMaximumWorkIntervalSeconds = 4 * 60 * 60;
+
 #if BUILDFLAG(IS_IOS)
 // The number of times to attempt to upload a pending report, repeated on
 // failure. Attempts will happen once per launch, once per call to
@@ -63,6 +93,12 @@ const int kRetryWorkIntervalSeconds = 15 * 60;
 const int kRetryAttempts = 5;
 #endif
 
+// The number of times to attempt to upload each attachment uploaded
+// separately from its report, in immediate succession. The report has already
+// reached the server, so a failed attachment is retried on its own rather than
+// by uploading the report again.
+constexpr int kAttachmentUploadAttempts = 3;
+
 // Wraps a reference to a no-args function (which can be empty). When this
 // object goes out of scope, invokes the function if it is non-empty.
 //
@@ -84,6 +120,173 @@ class ScopedFunctionInvoker final {
   const std::function<void()>& function_;
 };
 
+// Runs a function on its own thread.
+//
+// The lifetime of the function must outlive the lifetime of this object.
+class FunctionThread final : public Thread {
+ public:
+  explicit FunctionThread(const std::function<void()>& function)
+      : Thread(), function_(function) {}
+
+  FunctionThread(const FunctionThread&) = delete;
+  FunctionThread& operator=(const FunctionThread&) = delete;
+
+  ~FunctionThread() override = default;
+
+ private:
+  // Thread:
+  void ThreadMain() override { function_(); }
+
+  const std::function<void()>& function_;
+};
+
+// The number of seconds to wait for a slot in Options::upload_pool before
+// checking whether the thread has been stopped.
+constexpr double kUploadPoolPollSeconds = 1;
+
+// Holds one of the slots of Options::upload_pool, if there is a pool, while
+// it’s in scope. Waiting for a slot is abandoned if |thread| is stopped.
+class ScopedUploadPoolSlot final {
+ public:
+  ScopedUploadPoolSlot(Semaphore* pool, const WorkerThread& thread)
+      : pool_(pool), acquired_(!pool) {
+    while (!acquired_ && thread.is_running()) {
+      acquired_ = pool_->TimedWait(kUploadPoolPollSeconds);
+    }
+  }
+
+  ScopedUploadPoolSlot(const ScopedUploadPoolSlot&) = delete;
+  ScopedUploadPoolSlot& operator=(const ScopedUploadPoolSlot&) = delete;
+
+  ~ScopedUploadPoolSlot() {
+    if (pool_ && acquired_) {
+      pool_->Signal();
+    }
+  }
+
+  bool acquired() const { return acquired_; }
+
+ private:
+  Semaphore* pool_;  // weak
+  bool acquired_;
+};
+
+// The methods, headers, and values used by the resumable upload protocol. See
+// CrashReportUploadThread::Options::resumable_upload.
+constexpr char kResumableUploadStartMethod[] = "POST";
+constexpr char kResumableUploadChunkMethod[] = "PUT";
+constexpr char kResumableUploadProtocolHeader[] = "X-Crashpad-Upload-Protocol";
+constexpr char kResumableUploadProtocol[] = "resumable";
+constexpr char kResumableUploadIDHeader[] = "X-Crashpad-Upload-ID";
+
+// The header that marks a request as carrying a batch of reports, giving their
+// number, and the separator between the position of a report in the batch and
+// the names of its parts. See CrashReportUploadThread::Options::
+// max_reports_per_upload.
+constexpr char kBatchedUploadSizeHeader[] = "X-Crashpad-Batch-Size";
+constexpr char kBatchedUploadKeySeparator[] = ":";
+
+// The form parameter on a minidump’s upload that names the attachments to
+// follow, and the one on each attachment’s upload that holds the ID the server
+// assigned to the report. See CrashReportUploadThread::Options::
+// separate_attachment_uploads.
+constexpr char kSeparateAttachmentsKey[] = "upload_attachments";
+constexpr char kSeparateAttachmentReportIDKey[] = "upload_report_id";
+
+// The upload parameter naming a report’s product.
+constexpr char kProductKey[] = "prod";
+
+// Returns whether |upload_id| can be sent back to the server as a header value.
+bool IsValidUploadID(const std::string& upload_id) {
+  if (upload_id.empty()) {
+    return false;
+  }
+  for (char c : upload_id) {
+    if (c <= ' ' || c > '~') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Appends at most |size| bytes read from |stream| to |data|, setting
+// |end_of_stream| if the stream ends before they've all been read.
+bool ReadBodyStream(HTTPBodyStream* stream,
+                    size_t size,
+                    std::string* data,
+                    bool* end_of_stream) {
+  *end_of_stream = false;
+  const size_t initial_size = data->size();
+  data->resize(initial_size + size);
+  size_t size_read = 0;
+  while (size_read < size) {
+    FileOperationResult rv = stream->GetBytesBuffer(
+        reinterpret_cast<uint8_t*>(&(*data)[initial_size + size_read]),
+        size - size_read);
+    if (rv < 0) {
+      LOG(ERROR) << "error reading upload body";
+      data->resize(initial_size);
+      return false;
+    }
+    if (rv == 0) {
+      *end_of_stream = true;
+      break;
+    }
+    size_read += rv;
+  }
+  data->resize(initial_size + size_read);
+  return true;
+}
+
+// Returns the number of bytes remaining to be read from |reader|, leaving its
+// position unchanged, or -1 on failure.
+FileOffset RemainingSize(FileReaderInterface* reader) {
+  const FileOffset position = reader->SeekGet();
+  if (position < 0) {
+    return -1;
+  }
+  const FileOffset end = reader->Seek(0, SEEK_END);
+  if (end < 0 || !reader->SeekSet(position)) {
+    return -1;
+  }
+  return end - position;
+}
+
+// Sorts |reports| into the order in which they should be uploaded.
+void OrderReportsForUpload(CrashReportUploadThread::UploadOrder order,
+                           std::vector<CrashReportDatabase::Report>* reports) {
+  using UploadOrder = CrashReportUploadThread::UploadOrder;
+  if (order == UploadOrder::kDatabaseOrder) {
+    return;
+  }
+
+  // Returns whether |lhs| should be uploaded before |rhs|, ignoring whether
+  // either upload was explicitly requested.
+  const auto precedes = [order](const CrashReportDatabase::Report& lhs,
+                                const CrashReportDatabase::Report& rhs) {
+    switch (order) {
+      case UploadOrder::kDatabaseOrder:
+        break;
+      case UploadOrder::kNewestFirst:
+        return lhs.creation_time > rhs.creation_time;
+      case UploadOrder::kSmallestFirst:
+        return lhs.total_size < rhs.total_size;
+    }
+    return false;
+  };
+
+  std::stable_sort(reports->begin(),
+                   reports->end(),
+                   [&precedes](const CrashReportDatabase::Report& lhs,
+                               const CrashReportDatabase::Report& rhs) {
+                     if (lhs.upload_explicitly_requested !=
+                         rhs.upload_explicitly_requested) {
+                       return lhs.upload_explicitly_requested;
+                     }
+                     return precedes(lhs, rhs);
+                   });
+}
+
 }  // namespace
 
 CrashReportUploadThread::CrashReportUploadThread(
@@ -102,17 +305,52 @@ CrashReportUploadThread::CrashReportUploadThread(
                                             : WorkerThread::kIndefiniteWait,
               this),
       known_pending_report_uuids_(),
+      completed_uploads_(0),
+      retried_uploads_(0),
+      rate_limit_lock_(),
+      rate_limited_upload_in_progress_(false),
+      signature_uploads_(),
+      signature_rate_limiter_(),
+#if BUILDFLAG(IS_IOS)
+      retry_uuid_time_map_(),
+#endif  // BUILDFLAG(IS_IOS)
+      upload_rate_limiter_(),
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      cpu_affinity_set_(false),
+#endif
+      transport_pool_lock_(),
+      transport_pool_(),
+      prewarm_thread_(),
+      prewarm_function_([this]() { Prewarm(); }),
       database_(database) {
   DCHECK(!url_.empty());
+  if (options_.watch_pending_reports && options_.adaptive_scheduling) {
+    thread_.SetAdaptiveInterval(kAdaptiveMinimumWorkIntervalSeconds,
+                                kAdaptiveMaximumWorkIntervalSeconds);
+    thread_.SetWakeupAlignment(WorkerThread::kDefaultWakeupAlignment);
+  }
+  if (options_.max_upload_bytes_per_second) {
+    upload_rate_limiter_ = std::make_unique<ByteRateLimiter>(
+        options_.max_upload_bytes_per_second);
+  }
+  if (options_.rate_limit && options_.signature_upload_burst) {
+    signature_rate_limiter_ = std::make_unique<UploadRateLimiter>(
+        options_.signature_upload_limits_path,
+        options_.signature_upload_burst,
+        std::max(options_.signature_upload_interval, uint32_t{1}));
+  }
 }
 
 CrashReportUploadThread::~CrashReportUploadThread() {
+  FinishPrewarm();
 }
 
 void CrashReportUploadThread::ReportPending(const UUID& report_uuid) {
   known_pending_report_uuids_.PushBack(report_uuid);
-  if (thread_.is_running())
+  if (thread_.is_running()) {
+    StartPrewarm();
     thread_.DoWorkNow();
+  }
 }
 
 void CrashReportUploadThread::Start() {
@@ -122,9 +360,12 @@ void CrashReportUploadThread::Start() {
 
 void CrashReportUploadThread::Stop() {
   thread_.Stop();
+  FinishPrewarm();
 }
 
 void CrashReportUploadThread::ProcessPendingReports() {
+  CRASHPAD_TRACE_EVENT("upload",
+                       "CrashReportUploadThread::ProcessPendingReports");
 #if BUILDFLAG(IS_IOS)
   internal::ScopedBackgroundTask scoper("CrashReportUploadThread");
 #endif  // BUILDFLAG(IS_IOS)
@@ -133,7 +374,25 @@ void CrashReportUploadThread::ProcessPendingReports() {
   // uploads complete (regardless of whether or not that succeeded).
   ScopedFunctionInvoker scoped_function_invoker(callback_);
 
+  // Write any settings and report index changes that were deferred while
+  // processing reports, such as the last upload attempt time, before going
+  // idle.
+  const std::function<void()> flush_settings = [this]() {
+    database_->GetSettings()->Flush();
+    database_->FlushIndexUpdates();
+  };
+  ScopedFunctionInvoker scoped_settings_flusher(flush_settings);
+
+  if (options_.resource_budget &&
+      options_.resource_budget->CurrentLevel() ==
+          ResourceBudget::Level::kExhausted) {
+    // Known pending reports stay queued for the next pass.
+    LOG(WARNING) << "resource budget exhausted, deferring uploads";
+    return;
+  }
+
   std::vector<UUID> known_report_uuids = known_pending_report_uuids_.Drain();
+  std::vector<CrashReportDatabase::Report> known_reports;
   for (const UUID& report_uuid : known_report_uuids) {
     CrashReportDatabase::Report report;
     if (database_->LookUpCrashReport(report_uuid, &report) !=
@@ -141,13 +400,11 @@ void CrashReportUploadThread::ProcessPendingReports() {
       continue;
     }
 
-    ProcessPendingReport(report);
+    known_reports.push_back(report);
+  }
 
-    // Respect Stop() being called after at least one attempt to process a
-    // report.
-    if (!thread_.is_running()) {
-      return;
-    }
+  if (!ProcessReports(known_reports)) {
+    return;
   }
 
   // Known pending reports are always processed (above). The rest of this
@@ -166,6 +423,7 @@ void CrashReportUploadThread::ProcessPendingReports() {
     return;
   }
 
+  std::vector<CrashReportDatabase::Report> unknown_reports;
   for (const CrashReportDatabase::Report& report : reports) {
     if (std::find(known_report_uuids.begin(),
                   known_report_uuids.end(),
@@ -176,22 +434,275 @@ void CrashReportUploadThread::ProcessPendingReports() {
       continue;
     }
 
-    ProcessPendingReport(report);
+    unknown_reports.push_back(report);
+  }
 
-    // Respect Stop() being called after at least one attempt to process a
-    // report.
-    if (!thread_.is_running()) {
-      return;
-    }
+  ProcessReports(unknown_reports);
+}
+
+bool CrashReportUploadThread::ProcessReports(
+    const std::vector<CrashReportDatabase::Report>& unordered_reports) {
+  std::vector<CrashReportDatabase::Report> reports(unordered_reports);
+  OrderReportsForUpload(options_.upload_order, &reports);
+
+  // Threads processing reports wait for this connection only once they have
+  // prepared their first upload.
+  if (!reports.empty()) {
+    StartPrewarm();
   }
+
+  // Resumable uploads are made one report at a time.
+  const size_t batch_size =
+      options_.resumable_upload
+          ? 1
+          : std::max(options_.max_reports_per_upload, static_cast<size_t>(1));
+
+  std::atomic<size_t> next_index(0);
+  const std::function<void()> process_reports =
+      [this, &reports, &next_index, batch_size]() {
+        std::unique_ptr<HTTPTransport> http_transport;
+        size_t index;
+        while ((index = next_index.fetch_add(batch_size)) < reports.size()) {
+          if (batch_size == 1) {
+            ProcessPendingReport(reports[index], &http_transport);
+          } else {
+            const std::vector<CrashReportDatabase::Report> batch(
+                reports.begin() + index,
+                reports.begin() + std::min(index + batch_size, reports.size()));
+            ProcessPendingReportBatch(batch, &http_transport);
+          }
+
+          // Respect Stop() being called after at least one attempt to process
+          // a report.
+          if (!thread_.is_running()) {
+            break;
+          }
+        }
+        ReturnHTTPTransport(std::move(http_transport));
+      };
+
+  // The upload thread itself processes reports alongside any additional
+  // threads. A tight resource budget allows only the upload thread.
+  const bool reduced = options_.resource_budget &&
+                       options_.resource_budget->CurrentLevel() !=
+                           ResourceBudget::Level::kNormal;
+  const size_t thread_count =
+      std::min(reduced ? 1 : options_.max_concurrent_uploads,
+               (reports.size() + batch_size - 1) / batch_size);
+  std::vector<std::unique_ptr<FunctionThread>> threads;
+  for (size_t index = 1; index < thread_count; ++index) {
+    threads.push_back(std::make_unique<FunctionThread>(process_reports));
+    threads.back()->Start();
+  }
+
+  process_reports();
+
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+
+  return thread_.is_running();
 }
 
 void CrashReportUploadThread::ProcessPendingReport(
-    const CrashReportDatabase::Report& report) {
+    const CrashReportDatabase::Report& report,
+    std::unique_ptr<HTTPTransport>* http_transport) {
+  CRASHPAD_TRACE_EVENT("upload",
+                       "CrashReportUploadThread::ProcessPendingReport");
 #if BUILDFLAG(IS_APPLE)
   RecordFileLimitAnnotation();
 #endif  // BUILDFLAG(IS_APPLE)
 
+  if (!ShouldUploadReport(report)) {
+    return;
+  }
+
+  if (ShouldRateLimitUpload(report))
+    return;
+
+  // This is declared before upload_report so that it runs after upload_report
+  // has recorded the upload attempt in the database.
+  const std::function<void()> finished_rate_limited_upload =
+      [this, &report]() { FinishedRateLimitedUpload(report); };
+  ScopedFunctionInvoker scoped_finished_rate_limited_upload(
+      finished_rate_limited_upload);
+
+#if BUILDFLAG(IS_IOS)
+  if (ShouldRateLimitRetry(report))
+    return;
+#endif  // BUILDFLAG(IS_IOS)
+
+  // This is checked after rate limiting so that a report throttled by
+  // ShouldRateLimitUpload() doesn't start an interval for its signature.
+  if (ShouldSkipDuplicateUpload(report))
+    return;
+
+  ScopedUploadPoolSlot upload_pool_slot(options_.upload_pool, thread_);
+  if (!upload_pool_slot.acquired()) {
+    return;
+  }
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  if (!OpenReportForUploading(report, &upload_report)) {
+    return;
+  }
+
+  std::string response_body;
+  const uint64_t upload_start_ns = ClockMonotonicNanoseconds();
+  UploadResult upload_result =
+      UploadReport(upload_report.get(), http_transport, &response_body);
+  if (upload_result == UploadResult::kSuccess) {
+    Metrics::CrashUploadCompleted(
+        ClockMonotonicNanoseconds() - upload_start_ns, report.total_size);
+  }
+  RecordUploadResult(
+      report, std::move(upload_report), upload_result, response_body);
+}
+
+void CrashReportUploadThread::ProcessPendingReportBatch(
+    const std::vector<CrashReportDatabase::Report>& batch,
+    std::unique_ptr<HTTPTransport>* http_transport) {
+  CRASHPAD_TRACE_EVENT("upload",
+                       "CrashReportUploadThread::ProcessPendingReportBatch");
+#if BUILDFLAG(IS_APPLE)
+  RecordFileLimitAnnotation();
+#endif  // BUILDFLAG(IS_APPLE)
+
+  std::vector<const CrashReportDatabase::Report*> reports;
+  for (const CrashReportDatabase::Report& report : batch) {
+    if (!ShouldUploadReport(report)) {
+      continue;
+    }
+#if BUILDFLAG(IS_IOS)
+    if (ShouldRateLimitRetry(report))
+      continue;
+#endif  // BUILDFLAG(IS_IOS)
+    reports.push_back(&report);
+  }
+
+  // Limiting by signature applies to each report in the batch on its own.
+  if (signature_rate_limiter_) {
+    reports.erase(
+        std::remove_if(reports.begin(),
+                       reports.end(),
+                       [this](const CrashReportDatabase::Report* report) {
+                         return ShouldRateLimitUpload(*report);
+                       }),
+        reports.end());
+  }
+
+  // Otherwise, the batch is a single upload for the purposes of rate limiting.
+  // The first report subject to rate limiting stands for all of them: if it's
+  // throttled, so are the others, and if not, they're all uploaded along with
+  // it.
+  const auto rate_limited_report =
+      signature_rate_limiter_
+          ? reports.end()
+          : std::find_if(reports.begin(),
+                         reports.end(),
+                         [](const CrashReportDatabase::Report* report) {
+                           return !report->upload_explicitly_requested;
+                         });
+  const CrashReportDatabase::Report* rate_limited_upload = nullptr;
+  if (rate_limited_report != reports.end()) {
+    if (ShouldRateLimitUpload(**rate_limited_report)) {
+      // ShouldRateLimitUpload() skipped the first report subject to rate
+      // limiting. Skip the rest of them too.
+      std::vector<const CrashReportDatabase::Report*> unthrottled_reports;
+      for (auto it = reports.begin(); it != reports.end(); ++it) {
+        if ((*it)->upload_explicitly_requested) {
+          unthrottled_reports.push_back(*it);
+        } else if (it != rate_limited_report) {
+          database_->SkipReportUpload(
+              (*it)->uuid, Metrics::CrashSkippedReason::kUploadThrottled);
+        }
+      }
+      reports.swap(unthrottled_reports);
+    } else {
+      rate_limited_upload = *rate_limited_report;
+    }
+  }
+
+  // This is declared before upload_reports so that it runs after they have
+  // recorded their upload attempts in the database.
+  const std::function<void()> finished_rate_limited_upload =
+      [this, rate_limited_upload]() {
+        if (rate_limited_upload) {
+          FinishedRateLimitedUpload(*rate_limited_upload);
+        }
+      };
+  ScopedFunctionInvoker scoped_finished_rate_limited_upload(
+      finished_rate_limited_upload);
+
+  // This is done after rate limiting, as ProcessPendingReport() does.
+  reports.erase(
+      std::remove_if(reports.begin(),
+                     reports.end(),
+                     [this](const CrashReportDatabase::Report* report) {
+                       return ShouldSkipDuplicateUpload(*report);
+                     }),
+      reports.end());
+
+  ScopedUploadPoolSlot upload_pool_slot(options_.upload_pool, thread_);
+  if (!upload_pool_slot.acquired()) {
+    return;
+  }
+
+  std::vector<const CrashReportDatabase::Report*> opened_reports;
+  std::vector<std::unique_ptr<const CrashReportDatabase::UploadReport>>
+      upload_reports;
+  for (const CrashReportDatabase::Report* report : reports) {
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    if (OpenReportForUploading(*report, &upload_report)) {
+      opened_reports.push_back(report);
+      upload_reports.push_back(std::move(upload_report));
+    }
+  }
+  if (upload_reports.empty()) {
+    return;
+  }
+
+  std::vector<UploadResult> upload_results;
+  std::vector<std::string> response_bodies;
+  const uint64_t upload_start_ns = ClockMonotonicNanoseconds();
+  if (upload_reports.size() == 1) {
+    upload_results.resize(1);
+    response_bodies.resize(1);
+    upload_results[0] = UploadReport(
+        upload_reports[0].get(), http_transport, &response_bodies[0]);
+  } else {
+    std::vector<const CrashReportDatabase::UploadReport*> batched_reports;
+    for (const auto& upload_report : upload_reports) {
+      batched_reports.push_back(upload_report.get());
+    }
+    UploadReportBatch(
+        batched_reports, http_transport, &upload_results, &response_bodies);
+  }
+  const uint64_t upload_duration_ns =
+      ClockMonotonicNanoseconds() - upload_start_ns;
+
+  uint64_t uploaded_bytes = 0;
+  bool uploaded = false;
+  for (size_t index = 0; index < upload_results.size(); ++index) {
+    if (upload_results[index] == UploadResult::kSuccess) {
+      uploaded_bytes += opened_reports[index]->total_size;
+      uploaded = true;
+    }
+  }
+  if (uploaded) {
+    Metrics::CrashUploadCompleted(upload_duration_ns, uploaded_bytes);
+  }
+
+  for (size_t index = 0; index < upload_reports.size(); ++index) {
+    RecordUploadResult(*opened_reports[index],
+                       std::move(upload_reports[index]),
+                       upload_results[index],
+                       response_bodies[index]);
+  }
+}
+
+bool CrashReportUploadThread::ShouldUploadReport(
+    const CrashReportDatabase::Report& report) {
   Settings* const settings = database_->GetSettings();
 
   bool uploads_enabled;
@@ -202,30 +713,27 @@ void CrashReportUploadThread::ProcessPendingReport(
     // upload-enabled state stored in the database’s settings.
     database_->SkipReportUpload(report.uuid,
                                 Metrics::CrashSkippedReason::kUploadsDisabled);
-    return;
+    return false;
   }
 
-  if (ShouldRateLimitUpload(report))
-    return;
-
-#if BUILDFLAG(IS_IOS)
-  if (ShouldRateLimitRetry(report))
-    return;
-#endif  // BUILDFLAG(IS_IOS)
+  return true;
+}
 
-  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+bool CrashReportUploadThread::OpenReportForUploading(
+    const CrashReportDatabase::Report& report,
+    std::unique_ptr<const CrashReportDatabase::UploadReport>* upload_report) {
   CrashReportDatabase::OperationStatus status =
-      database_->GetReportForUploading(report.uuid, &upload_report);
+      database_->GetReportForUploading(report.uuid, upload_report);
   switch (status) {
     case CrashReportDatabase::kNoError:
-      break;
+      return true;
 
     case CrashReportDatabase::kBusyError:
     case CrashReportDatabase::kReportNotFound:
       // Someone else may have gotten to it first. If they’re working on it now,
       // this will be kBusyError. If they’ve already finished with it, it’ll be
       // kReportNotFound.
-      return;
+      return false;
 
     case CrashReportDatabase::kFileSystemError:
     case CrashReportDatabase::kDatabaseError:
@@ -233,20 +741,36 @@ void CrashReportUploadThread::ProcessPendingReport(
       // to at least try to get the report out of the way.
       database_->SkipReportUpload(report.uuid,
                                   Metrics::CrashSkippedReason::kDatabaseError);
-      return;
+      return false;
 
     case CrashReportDatabase::kCannotRequestUpload:
       NOTREACHED();
-      return;
+      return false;
+  }
+
+  return false;
+}
+
+void CrashReportUploadThread::RecordUploadResult(
+    const CrashReportDatabase::Report& report,
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report,
+    UploadResult upload_result,
+    const std::string& response_body) {
+  if (upload_result == UploadResult::kRetry) {
+    ++retried_uploads_;
+  } else {
+    ++completed_uploads_;
   }
 
-  std::string response_body;
-  UploadResult upload_result =
-      UploadReport(upload_report.get(), &response_body);
   switch (upload_result) {
-    case UploadResult::kSuccess:
+    case UploadResult::kSuccess: {
+      const time_t now = time(nullptr);
+      if (now >= report.creation_time) {
+        Metrics::CrashUploadLatency(now - report.creation_time);
+      }
       database_->RecordUploadComplete(std::move(upload_report), response_body);
       break;
+    }
     case UploadResult::kPermanentFailure:
       upload_report.reset();
       database_->SkipReportUpload(
@@ -261,6 +785,7 @@ void CrashReportUploadThread::ProcessPendingReport(
       } else {
         Metrics::CrashUploadSkipped(
             Metrics::CrashSkippedReason::kUploadFailedButCanRetry);
+        base::AutoLock lock(rate_limit_lock_);
         retry_uuid_time_map_[report.uuid] =
             time(nullptr) +
             (1 << upload_report->upload_attempts) * kRetryWorkIntervalSeconds;
@@ -276,12 +801,28 @@ void CrashReportUploadThread::ProcessPendingReport(
 #endif
       break;
   }
+
+  // Once the report is no longer pending, any body prepared for its upload
+  // won’t be used.
+  if (!upload_report) {
+    database_->DiscardUploadBody(report.uuid);
+  }
 }
 
-CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
+CrashReportUploadThread::UploadResult
+CrashReportUploadThread::AddReportToUpload(
     const CrashReportDatabase::UploadReport* report,
-    std::string* response_body) {
-  std::map<std::string, std::string> parameters;
+    const std::string& key_prefix,
+    HTTPMultipartBuilder* http_multipart_builder,
+    ChunkedMemoryFile* decompressed_report,
+    ChunkedMemoryFile* trimmed_report,
+    bool separate_attachments,
+    std::map<std::string, std::string>* parameters) {
+  CRASHPAD_TRACE_EVENT("upload", "CrashReportUploadThread::AddReportToUpload");
+  static constexpr char kMinidumpKey[] = "upload_file_minidump";
+  static constexpr char kMinidumpDigestKey[] = "upload_file_minidump_xxh64";
+  static constexpr char kMinidumpSizeKey[] = "upload_file_minidump_size";
+  static constexpr char kTrimmedKey[] = "upload_trimmed";
 
   FileReader* reader = report->Reader();
   FileOffset start_offset = reader->SeekGet();
@@ -289,58 +830,210 @@ CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
     return UploadResult::kPermanentFailure;
   }
 
-  // Ignore any errors that might occur when attempting to interpret the
-  // minidump file. This may result in its being uploaded with few or no
-  // parameters, but as long as there’s a dump file, the server can decide what
-  // to do with it.
-  ProcessSnapshotMinidump minidump_process_snapshot;
-  if (minidump_process_snapshot.Initialize(reader)) {
-    parameters =
-        BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+  // The parameters are normally stored with the report when it's written.
+  // Otherwise, they must be obtained by interpreting the minidump.
+  const bool have_stored_parameters = report->GetUploadParameters(parameters);
+
+  // A compressed report must be decompressed to be interpreted. If the upload
+  // is also gzip-compressed, the compressed report is included in it as-is, and
+  // the decompressed copy is only used to obtain the parameters.
+  FileReaderInterface* minidump_reader = reader;
+  if (report->IsCompressed() &&
+      !(have_stored_parameters && options_.upload_gzip)) {
+    if (!DecompressGzipFileContent(reader, decompressed_report) ||
+        !decompressed_report->SeekSet(0)) {
+      return UploadResult::kPermanentFailure;
+    }
+    minidump_reader = decompressed_report;
   }
 
-  if (!reader->SeekSet(start_offset)) {
-    return UploadResult::kPermanentFailure;
+  if (!have_stored_parameters) {
+    // Ignore any errors that might occur when attempting to interpret the
+    // minidump file. This may result in its being uploaded with few or no
+    // parameters, but as long as there’s a dump file, the server can decide
+    // what to do with it. Interpreting the minidump makes many small reads,
+    // which are buffered.
+    BufferedFileReader buffered_reader(minidump_reader);
+    ProcessSnapshotMinidump minidump_process_snapshot;
+    if (minidump_process_snapshot.Initialize(&buffered_reader)) {
+      *parameters =
+          BreakpadHTTPFormParametersFromMinidump(&minidump_process_snapshot);
+    }
+
+    if (!reader->SeekSet(start_offset) ||
+        (minidump_reader != reader && !minidump_reader->SeekSet(0))) {
+      return UploadResult::kPermanentFailure;
+    }
   }
 
-  HTTPMultipartBuilder http_multipart_builder;
-  http_multipart_builder.SetGzipEnabled(options_.upload_gzip);
+  // A report too large for the server to accept is trimmed to fit, by
+  // rewriting its minidump without progressively more of its lower-priority
+  // data, and finally by leaving out its attachments.
+  std::string trimmed;
+  bool include_attachments = !separate_attachments;
+  if (options_.max_upload_size &&
+      report->total_size > options_.max_upload_size) {
+    CRASHPAD_TRACE_EVENT("upload", "TrimReport");
+    if (minidump_reader == reader && report->IsCompressed()) {
+      if (!DecompressGzipFileContent(reader, decompressed_report) ||
+          !decompressed_report->SeekSet(0)) {
+        return UploadResult::kPermanentFailure;
+      }
+      minidump_reader = decompressed_report;
+    }
 
-  static constexpr char kMinidumpKey[] = "upload_file_minidump";
+    // Attachments uploaded separately don’t count toward the limit.
+    uint64_t attachments_size = 0;
+    for (const auto& it : report->GetAttachments()) {
+      if (separate_attachments) {
+        break;
+      }
+      const FileOffset attachment_size = RemainingSize(it.second);
+      if (attachment_size < 0) {
+        return UploadResult::kPermanentFailure;
+      }
+      attachments_size += attachment_size;
+    }
+
+    // If the attachments alone don’t fit, they must be left out regardless,
+    // and the minidump may take up the entire limit.
+    const bool attachments_fit = attachments_size < options_.max_upload_size;
+    const uint64_t max_minidump_size =
+        options_.max_upload_size - (attachments_fit ? attachments_size : 0);
+    size_t trim_steps;
+    if (!TrimMinidump(minidump_reader,
+                      base::saturated_cast<FileOffset>(max_minidump_size),
+                      trimmed_report,
+                      &trim_steps) ||
+        !trimmed_report->SeekSet(0)) {
+      return UploadResult::kPermanentFailure;
+    }
+    minidump_reader = trimmed_report;
+
+    // The server is told what was left out, as a comma-separated list.
+    static constexpr const char* kTrimmedData[] = {
+        "extra_memory", "thread_stacks", "memory_info"};
+    static_assert(std::size(kTrimmedData) == kMinidumpTrimSteps,
+                  "kTrimmedData must name each step of TrimMinidump()");
+    for (size_t step = 0; step < trim_steps; ++step) {
+      trimmed.append(trimmed.empty() ? "" : ",").append(kTrimmedData[step]);
+    }
+
+    if (include_attachments &&
+        (!attachments_fit || trimmed_report->size() + attachments_size >
+                                 options_.max_upload_size)) {
+      include_attachments = false;
+      trimmed.append(",attachments");
+    }
+    LOG_IF(WARNING, trimmed_report->size() > options_.max_upload_size)
+        << "report " << report->uuid.ToString()
+        << " exceeds the upload size limit after trimming";
+  }
 
-  for (const auto& kv : parameters) {
-    if (kv.first == kMinidumpKey) {
+  for (const auto& kv : *parameters) {
+    if (kv.first == kMinidumpKey || kv.first == kMinidumpDigestKey ||
+        kv.first == kMinidumpSizeKey || kv.first == kTrimmedKey ||
+        kv.first == kSeparateAttachmentsKey) {
       LOG(WARNING) << "reserved key " << kv.first << ", discarding value "
                    << kv.second;
     } else {
-      http_multipart_builder.SetFormData(kv.first, kv.second);
+      http_multipart_builder->SetFormData(key_prefix + kv.first, kv.second);
     }
   }
 
-  for (const auto& it : report->GetAttachments()) {
-    http_multipart_builder.SetFileAttachment(
-        it.first, it.first, it.second, "application/octet-stream");
+  if (!trimmed.empty()) {
+    http_multipart_builder->SetFormData(key_prefix + kTrimmedKey, trimmed);
   }
 
-  http_multipart_builder.SetFileAttachment(kMinidumpKey,
-                                           report->uuid.ToString() + ".dmp",
-                                           reader,
-                                           "application/octet-stream");
+  if (separate_attachments) {
+    // The server is told which attachments will follow the minidump.
+    std::string attachment_names;
+    for (const auto& it : report->GetAttachments()) {
+      attachment_names.append(attachment_names.empty() ? "" : ",")
+          .append(it.first);
+    }
+    http_multipart_builder->SetFormData(key_prefix + kSeparateAttachmentsKey,
+                                        attachment_names);
+  }
 
-  std::unique_ptr<HTTPTransport> http_transport(HTTPTransport::Create());
-  if (!http_transport) {
-    return UploadResult::kPermanentFailure;
+  if (include_attachments) {
+    for (const auto& it : report->GetAttachments()) {
+      http_multipart_builder->SetFileAttachment(key_prefix + it.first,
+                                                it.first,
+                                                it.second,
+                                                "application/octet-stream");
+    }
   }
 
-  HTTPHeaders content_headers;
-  http_multipart_builder.PopulateContentHeaders(&content_headers);
-  for (const auto& content_header : content_headers) {
-    http_transport->SetHeader(content_header.first, content_header.second);
+  if (minidump_reader != trimmed_report && report->IsCompressed() &&
+      options_.upload_gzip) {
+    // The report file is uploaded as-is, so the digest computed while it was
+    // written identifies the uploaded content and lets the server check it.
+    uint64_t digest;
+    uint64_t size;
+    if (report->GetContentDigest(&digest, &size)) {
+      http_multipart_builder->SetFormData(
+          key_prefix + kMinidumpDigestKey,
+          base::StringPrintf("%016" PRIx64, digest));
+      http_multipart_builder->SetFormData(key_prefix + kMinidumpSizeKey,
+                                          base::StringPrintf("%" PRIu64, size));
+    }
+    http_multipart_builder->SetGzipFileAttachment(
+        key_prefix + kMinidumpKey,
+        report->uuid.ToString() + ".dmp",
+        reader,
+        "application/octet-stream");
+  } else if (minidump_reader == reader) {
+    // Passing the FileReader allows the transport to send the report directly
+    // from its file.
+    http_multipart_builder->SetFileAttachment(key_prefix + kMinidumpKey,
+                                              report->uuid.ToString() + ".dmp",
+                                              reader,
+                                              "application/octet-stream");
+  } else {
+    http_multipart_builder->SetFileAttachment(key_prefix + kMinidumpKey,
+                                              report->uuid.ToString() + ".dmp",
+                                              minidump_reader,
+                                              "application/octet-stream");
   }
-  http_transport->SetBodyStream(http_multipart_builder.GetBodyStream());
-  // TODO(mark): The timeout should be configurable by the client.
-  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
 
+  return UploadResult::kSuccess;
+}
+
+std::unique_ptr<HTTPBodyStream> CrashReportUploadThread::PreparedUploadBody(
+    const CrashReportDatabase::UploadReport* report,
+    std::map<std::string, std::string>* parameters,
+    std::map<std::string, std::string>* content_headers) {
+  if (!options_.upload_gzip || options_.resumable_upload) {
+    return nullptr;
+  }
+
+  // The stored body carries the attachments inline.
+  if (options_.separate_attachment_uploads &&
+      !report->GetAttachments().empty()) {
+    return nullptr;
+  }
+
+  FileReader* body_reader = report->GetUploadBody(content_headers);
+  if (!body_reader || !report->GetUploadParameters(parameters)) {
+    return nullptr;
+  }
+
+  // A body too large for the server is left for AddReportToUpload() to trim.
+  if (options_.max_upload_size) {
+    const FileOffset body_size = RemainingSize(body_reader);
+    if (body_size < 0 ||
+        static_cast<uint64_t>(body_size) > options_.max_upload_size) {
+      return nullptr;
+    }
+  }
+
+  return std::make_unique<FileReaderHTTPBodyStream>(
+      body_reader, body_reader->file_handle());
+}
+
+std::string CrashReportUploadThread::UploadURL(
+    const std::map<std::string, std::string>& parameters) const {
   std::string url = url_;
   if (options_.identify_client_via_url) {
     // Add parameters to the URL which identify the client to the server.
@@ -348,7 +1041,7 @@ CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
       const char* key;
       const char* url_field_name;
     } kURLParameterMappings[] = {
-        {"prod", "product"},
+        {kProductKey, "product"},
         {"ver", "version"},
         {"guid", "guid"},
     };
@@ -364,17 +1057,552 @@ CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
       }
     }
   }
+
+  return url;
+}
+
+CrashReportUploadThread::UploadResult CrashReportUploadThread::UploadReport(
+    const CrashReportDatabase::UploadReport* report,
+    std::unique_ptr<HTTPTransport>* http_transport_storage,
+    std::string* response_body) {
+  CRASHPAD_TRACE_EVENT("upload", "CrashReportUploadThread::UploadReport");
+  HTTPMultipartBuilder http_multipart_builder;
+  http_multipart_builder.SetGzipEnabled(options_.upload_gzip);
+  http_multipart_builder.SetGzipThreads(options_.upload_gzip_threads);
+
+  // A body prepared when the report was written is sent as-is, sparing the
+  // report and its attachments from being read back and compressed again.
+  ChunkedMemoryFile decompressed_report;
+  ChunkedMemoryFile trimmed_report;
+  std::map<std::string, std::string> parameters;
+  HTTPHeaders content_headers;
+  const bool separate_attachments = options_.separate_attachment_uploads &&
+                                    !report->GetAttachments().empty();
+  std::unique_ptr<HTTPBodyStream> body_stream =
+      PreparedUploadBody(report, &parameters, &content_headers);
+  if (!body_stream) {
+    UploadResult result = AddReportToUpload(report,
+                                            std::string(),
+                                            &http_multipart_builder,
+                                            &decompressed_report,
+                                            &trimmed_report,
+                                            separate_attachments,
+                                            &parameters);
+    if (result != UploadResult::kSuccess) {
+      return result;
+    }
+  }
+
+  const std::string url = UploadURL(parameters);
+
+  HTTPTransport* http_transport = ResetHTTPTransport(http_transport_storage);
+  if (!http_transport) {
+    return UploadResult::kPermanentFailure;
+  }
+
+  if (!body_stream && options_.resumable_upload) {
+    UploadResult result = UploadReportResumable(
+        report, http_transport, &http_multipart_builder, url, response_body);
+    if (result == UploadResult::kSuccess && separate_attachments) {
+      UploadAttachments(report, http_transport_storage, url, *response_body);
+    }
+    return result;
+  }
+
+  if (!body_stream) {
+    http_multipart_builder.PopulateContentHeaders(&content_headers);
+    body_stream = http_multipart_builder.GetBodyStream();
+  }
+
+  for (const auto& content_header : content_headers) {
+    http_transport->SetHeader(content_header.first, content_header.second);
+  }
+  http_transport->SetBodyStream(LimitUploadRate(std::move(body_stream)));
+  // TODO(mark): The timeout should be configurable by the client.
+  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
   http_transport->SetURL(url);
 
   if (!http_transport->ExecuteSynchronously(response_body)) {
     return UploadResult::kRetry;
   }
 
+  if (separate_attachments) {
+    UploadAttachments(report, http_transport_storage, url, *response_body);
+  }
   return UploadResult::kSuccess;
 }
 
+void CrashReportUploadThread::UploadAttachments(
+    const CrashReportDatabase::UploadReport* report,
+    std::unique_ptr<HTTPTransport>* http_transport_storage,
+    const std::string& url,
+    const std::string& report_id) {
+  CRASHPAD_TRACE_EVENT("upload", "CrashReportUploadThread::UploadAttachments");
+  if (report_id.empty()) {
+    LOG(WARNING) << "no ID for report " << report->uuid.ToString()
+                 << ", not uploading its attachments";
+    return;
+  }
+
+  const std::map<std::string, FileReader*> attachment_map =
+      report->GetAttachments();
+  const std::vector<std::pair<std::string, FileReader*>> attachments(
+      attachment_map.begin(), attachment_map.end());
+
+  // Each thread uploads whichever attachment is next, so that one large
+  // attachment doesn’t hold up the others.
+  std::atomic<size_t> next_index(0);
+  const auto upload_attachments =
+      [this, &attachments, &next_index, &url, &report_id](
+          std::unique_ptr<HTTPTransport>* http_transport_storage) {
+        size_t index;
+        while ((index = next_index.fetch_add(1)) < attachments.size()) {
+          const std::string& name = attachments[index].first;
+          FileReader* reader = attachments[index].second;
+          for (int attempt = 1; attempt <= kAttachmentUploadAttempts;
+               ++attempt) {
+            // A failed attempt may have read some of the attachment.
+            if (!reader->SeekSet(0)) {
+              break;
+            }
+
+            HTTPMultipartBuilder http_multipart_builder;
+            http_multipart_builder.SetGzipEnabled(options_.upload_gzip);
+            http_multipart_builder.SetFormData(kSeparateAttachmentReportIDKey,
+                                               report_id);
+            http_multipart_builder.SetFileAttachment(
+                name, name, reader, "application/octet-stream");
+
+            HTTPTransport* http_transport =
+                ResetHTTPTransport(http_transport_storage);
+            if (!http_transport) {
+              return;
+            }
+            HTTPHeaders content_headers;
+            http_multipart_builder.PopulateContentHeaders(&content_headers);
+            for (const auto& content_header : content_headers) {
+              http_transport->SetHeader(content_header.first,
+                                        content_header.second);
+            }
+            http_transport->SetBodyStream(
+                LimitUploadRate(http_multipart_builder.GetBodyStream()));
+            http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+            http_transport->SetURL(url);
+
+            std::string response_body;
+            if (http_transport->ExecuteSynchronously(&response_body)) {
+              break;
+            }
+            LOG(WARNING) << "attachment " << name << " of report "
+                         << report_id << " failed to upload, attempt "
+                         << attempt << " of " << kAttachmentUploadAttempts;
+          }
+        }
+      };
+
+  // As with reports, a tight resource budget allows only this thread.
+  const bool reduced = options_.resource_budget &&
+                       options_.resource_budget->CurrentLevel() !=
+                           ResourceBudget::Level::kNormal;
+  const size_t thread_count = std::min(
+      reduced ? 1 : options_.max_concurrent_uploads, attachments.size());
+  const std::function<void()> upload_attachments_on_new_transport =
+      [this, &upload_attachments]() {
+        std::unique_ptr<HTTPTransport> http_transport;
+        upload_attachments(&http_transport);
+        ReturnHTTPTransport(std::move(http_transport));
+      };
+  std::vector<std::unique_ptr<FunctionThread>> threads;
+  for (size_t index = 1; index < thread_count; ++index) {
+    threads.push_back(
+        std::make_unique<FunctionThread>(upload_attachments_on_new_transport));
+    threads.back()->Start();
+  }
+
+  upload_attachments(http_transport_storage);
+
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+void CrashReportUploadThread::UploadReportBatch(
+    const std::vector<const CrashReportDatabase::UploadReport*>& reports,
+    std::unique_ptr<HTTPTransport>* http_transport_storage,
+    std::vector<UploadResult>* upload_results,
+    std::vector<std::string>* response_bodies) {
+  CRASHPAD_TRACE_EVENT("upload", "CrashReportUploadThread::UploadReportBatch");
+  upload_results->assign(reports.size(), UploadResult::kRetry);
+  response_bodies->assign(reports.size(), std::string());
+
+  HTTPMultipartBuilder http_multipart_builder;
+  http_multipart_builder.SetGzipEnabled(options_.upload_gzip);
+  http_multipart_builder.SetGzipThreads(options_.upload_gzip_threads);
+
+  // Each report’s parts are named with its position in the batch as a prefix,
+  // counting only the reports that could be added.
+  std::vector<std::unique_ptr<ChunkedMemoryFile>> decompressed_reports;
+  std::vector<std::unique_ptr<ChunkedMemoryFile>> trimmed_reports;
+  std::vector<size_t> batched_indices;
+  std::map<std::string, std::string> url_parameters;
+  for (size_t index = 0; index < reports.size(); ++index) {
+    decompressed_reports.push_back(std::make_unique<ChunkedMemoryFile>());
+    trimmed_reports.push_back(std::make_unique<ChunkedMemoryFile>());
+    std::map<std::string, std::string> parameters;
+    UploadResult result = AddReportToUpload(
+        reports[index],
+        base::StringPrintf("%" PRIuS "%s",
+                           batched_indices.size(),
+                           kBatchedUploadKeySeparator),
+        &http_multipart_builder,
+        decompressed_reports.back().get(),
+        trimmed_reports.back().get(),
+        /* separate_attachments= */ false,
+        &parameters);
+    if (result != UploadResult::kSuccess) {
+      (*upload_results)[index] = result;
+      continue;
+    }
+    if (batched_indices.empty()) {
+      url_parameters = parameters;
+    }
+    batched_indices.push_back(index);
+  }
+  if (batched_indices.empty()) {
+    return;
+  }
+
+  HTTPTransport* http_transport = ResetHTTPTransport(http_transport_storage);
+  if (!http_transport) {
+    for (size_t index : batched_indices) {
+      (*upload_results)[index] = UploadResult::kPermanentFailure;
+    }
+    return;
+  }
+
+  HTTPHeaders content_headers;
+  http_multipart_builder.PopulateContentHeaders(&content_headers);
+  for (const auto& content_header : content_headers) {
+    http_transport->SetHeader(content_header.first, content_header.second);
+  }
+  http_transport->SetHeader(
+      kBatchedUploadSizeHeader,
+      base::StringPrintf("%" PRIuS, batched_indices.size()));
+  http_transport->SetBodyStream(
+      LimitUploadRate(http_multipart_builder.GetBodyStream()));
+  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+  http_transport->SetURL(UploadURL(url_parameters));
+
+  std::string response_body;
+  if (!http_transport->ExecuteSynchronously(&response_body)) {
+    return;
+  }
+
+  // The response has a line for each report in the batch, holding the ID that
+  // the server assigned to it, or nothing if the server didn’t accept it.
+  std::vector<std::string> lines;
+  size_t line_start = 0;
+  while (line_start < response_body.size()) {
+    size_t line_end = response_body.find('\n', line_start);
+    if (line_end == std::string::npos) {
+      line_end = response_body.size();
+    }
+    std::string line = response_body.substr(line_start, line_end - line_start);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    lines.push_back(line);
+    line_start = line_end + 1;
+  }
+  if (lines.size() > batched_indices.size()) {
+    LOG(ERROR) << "unexpected batched upload response";
+    return;
+  }
+
+  for (size_t line_index = 0; line_index < lines.size(); ++line_index) {
+    if (!lines[line_index].empty()) {
+      const size_t index = batched_indices[line_index];
+      (*upload_results)[index] = UploadResult::kSuccess;
+      (*response_bodies)[index] = lines[line_index];
+    }
+  }
+}
+
+CrashReportUploadThread::UploadResult
+CrashReportUploadThread::UploadReportResumable(
+    const CrashReportDatabase::UploadReport* report,
+    HTTPTransport* http_transport,
+    HTTPMultipartBuilder* http_multipart_builder,
+    const std::string& url,
+    std::string* response_body) {
+  CRASHPAD_TRACE_EVENT("upload",
+                       "CrashReportUploadThread::UploadReportResumable");
+  // Prepares |http_transport| for a request belonging to the upload, with the
+  // timeout for a whole upload applying to each request.
+  const auto prepare_request = [this, http_transport, &url](
+                                   const std::string& method,
+                                   const std::string& body) {
+    http_transport->ResetRequest();
+    http_transport->SetMethod(method);
+    http_transport->SetURL(url);
+    http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+    http_transport->SetHeader(kContentLength,
+                              base::StringPrintf("%" PRIuS, body.size()));
+    http_transport->SetBodyStream(
+        LimitUploadRate(std::make_unique<StringHTTPBodyStream>(body)));
+  };
+
+  // If an earlier attempt was interrupted, ask the server how much of the body
+  // it received. The body must be rebuilt with the same boundary to continue.
+  CrashReportDatabase::UploadReport::ResumableUploadState state;
+  uint64_t offset = 0;
+  bool resuming = false;
+  if (report->GetResumableUploadState(&state) &&
+      http_multipart_builder->SetBoundary(state.boundary)) {
+    prepare_request(kResumableUploadChunkMethod, std::string());
+    http_transport->SetHeader(kResumableUploadIDHeader, state.upload_id);
+    http_transport->SetHeader(kContentRange, "bytes */*");
+    std::string received;
+    resuming = http_transport->ExecuteSynchronously(&received) &&
+               StringToNumber(received, &offset);
+  }
+
+  if (!resuming) {
+    // Either there was no upload to resume, or the server no longer recognizes
+    // it. The stored state is kept until it's replaced, in case the server
+    // couldn't be reached at all.
+    prepare_request(kResumableUploadStartMethod, std::string());
+    HTTPHeaders content_headers;
+    http_multipart_builder->PopulateContentHeaders(&content_headers);
+    for (const auto& content_header : content_headers) {
+      http_transport->SetHeader(content_header.first, content_header.second);
+    }
+    http_transport->SetHeader(kResumableUploadProtocolHeader,
+                              kResumableUploadProtocol);
+
+    std::string upload_id;
+    if (!http_transport->ExecuteSynchronously(&upload_id)) {
+      return UploadResult::kRetry;
+    }
+    if (!IsValidUploadID(upload_id)) {
+      LOG(ERROR) << "invalid upload ID";
+      return UploadResult::kRetry;
+    }
+
+    state.upload_id = upload_id;
+    state.boundary = http_multipart_builder->boundary();
+    state.offset = 0;
+    offset = 0;
+    report->SetResumableUploadState(state);
+  }
+
+  // Skip the part of the body that the server already has.
+  std::unique_ptr<HTTPBodyStream> body_stream =
+      http_multipart_builder->GetBodyStream();
+  const size_t chunk_size = options_.resumable_upload_chunk_size;
+  std::string pending;
+  bool end_of_body = false;
+  for (uint64_t skipped = 0; skipped < offset; skipped += pending.size()) {
+    pending.clear();
+    if (!ReadBodyStream(
+            body_stream.get(),
+            static_cast<size_t>(std::min<uint64_t>(offset - skipped,
+                                                   chunk_size)),
+            &pending,
+            &end_of_body)) {
+      report->ClearResumableUploadState();
+      return UploadResult::kPermanentFailure;
+    }
+    if (pending.empty()) {
+      // The body is shorter than the server believes it to be, so it isn't
+      // the body that the server has been receiving.
+      LOG(ERROR) << "resumable upload offset exceeds body size";
+      report->ClearResumableUploadState();
+      return UploadResult::kRetry;
+    }
+  }
+  pending.clear();
+  end_of_body = false;
+
+  while (true) {
+    // |pending| holds the unacknowledged body beginning at |offset|. Reading a
+    // byte beyond the chunk reveals whether the chunk ends the body.
+    if (!end_of_body && pending.size() <= chunk_size &&
+        !ReadBodyStream(body_stream.get(),
+                        chunk_size + 1 - pending.size(),
+                        &pending,
+                        &end_of_body)) {
+      report->ClearResumableUploadState();
+      return UploadResult::kPermanentFailure;
+    }
+
+    const bool final_chunk = end_of_body && pending.size() <= chunk_size;
+    const std::string chunk = pending.substr(0, chunk_size);
+    std::string content_range;
+    if (chunk.empty()) {
+      content_range = base::StringPrintf("bytes */%" PRIu64, offset);
+    } else {
+      content_range =
+          base::StringPrintf("bytes %" PRIu64 "-%" PRIu64 "/",
+                             offset,
+                             offset + chunk.size() - 1) +
+          (final_chunk ? base::StringPrintf("%" PRIu64, offset + chunk.size())
+                       : std::string("*"));
+    }
+
+    prepare_request(kResumableUploadChunkMethod, chunk);
+    http_transport->SetHeader(kResumableUploadIDHeader, state.upload_id);
+    http_transport->SetHeader(kContentRange, content_range);
+
+    std::string chunk_response;
+    if (!http_transport->ExecuteSynchronously(&chunk_response)) {
+      return UploadResult::kRetry;
+    }
+
+    if (final_chunk) {
+      report->ClearResumableUploadState();
+      response_body->swap(chunk_response);
+      return UploadResult::kSuccess;
+    }
+
+    uint64_t received;
+    if (!StringToNumber(chunk_response, &received) || received <= offset ||
+        received > offset + chunk.size()) {
+      LOG(ERROR) << "unexpected resumable upload response";
+      return UploadResult::kRetry;
+    }
+
+    pending.erase(0, static_cast<size_t>(received - offset));
+    offset = received;
+    state.offset = offset;
+    report->SetResumableUploadState(state);
+  }
+}
+
+HTTPTransport* CrashReportUploadThread::ResetHTTPTransport(
+    std::unique_ptr<HTTPTransport>* http_transport_storage) {
+  if (*http_transport_storage) {
+    (*http_transport_storage)->ResetRequest();
+  } else {
+    *http_transport_storage = TakeHTTPTransport();
+  }
+  return http_transport_storage->get();
+}
+
+void CrashReportUploadThread::StartPrewarm() {
+  if (!options_.prewarm_connection) {
+    return;
+  }
+
+  // Don’t reveal anything to the server, even that a crash occurred, unless
+  // the user has agreed to uploads.
+  bool uploads_enabled;
+  if (!database_->GetSettings()->GetUploadsEnabled(&uploads_enabled) ||
+      !uploads_enabled) {
+    return;
+  }
+
+  base::AutoLock lock(transport_pool_lock_);
+  if (prewarm_thread_ || !transport_pool_.empty()) {
+    return;
+  }
+
+  prewarm_thread_ = std::make_unique<FunctionThread>(prewarm_function_);
+  prewarm_thread_->Start();
+}
+
+void CrashReportUploadThread::Prewarm() {
+  CRASHPAD_TRACE_EVENT("upload", "CrashReportUploadThread::Prewarm");
+  std::unique_ptr<HTTPTransport> http_transport = HTTPTransport::Create();
+  if (!http_transport) {
+    return;
+  }
+  http_transport->SetTimeout(internal::kUploadReportTimeoutSeconds);
+  http_transport->SetURL(url_);
+  http_transport->Prewarm();
+
+  base::AutoLock lock(transport_pool_lock_);
+  transport_pool_.push_back(std::move(http_transport));
+}
+
+void CrashReportUploadThread::FinishPrewarm() {
+  std::unique_ptr<Thread> prewarm_thread;
+  {
+    base::AutoLock lock(transport_pool_lock_);
+    prewarm_thread = std::move(prewarm_thread_);
+  }
+
+  // The prewarm thread takes transport_pool_lock_ when it finishes, so it must
+  // be joined without holding the lock.
+  if (prewarm_thread) {
+    prewarm_thread->Join();
+  }
+}
+
+std::unique_ptr<HTTPTransport> CrashReportUploadThread::TakeHTTPTransport() {
+  if (options_.prewarm_connection) {
+    FinishPrewarm();
+
+    base::AutoLock lock(transport_pool_lock_);
+    if (!transport_pool_.empty()) {
+      std::unique_ptr<HTTPTransport> http_transport =
+          std::move(transport_pool_.back());
+      transport_pool_.pop_back();
+      http_transport->ResetRequest();
+      return http_transport;
+    }
+  }
+  return HTTPTransport::Create();
+}
+
+void CrashReportUploadThread::ReturnHTTPTransport(
+    std::unique_ptr<HTTPTransport> http_transport) {
+  if (!options_.prewarm_connection || !http_transport) {
+    return;
+  }
+
+  base::AutoLock lock(transport_pool_lock_);
+  if (transport_pool_.size() <
+      std::max(options_.max_concurrent_uploads, static_cast<size_t>(1))) {
+    transport_pool_.push_back(std::move(http_transport));
+  }
+}
+
+std::unique_ptr<HTTPBodyStream> CrashReportUploadThread::LimitUploadRate(
+    std::unique_ptr<HTTPBodyStream> body_stream) {
+  if (!upload_rate_limiter_) {
+    return body_stream;
+  }
+  return std::make_unique<RateLimitedHTTPBodyStream>(
+      std::move(body_stream), upload_rate_limiter_.get());
+}
+
 void CrashReportUploadThread::DoWork(const WorkerThread* thread) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // This is the first point at which code runs on thread_ itself. Threads
+  // started from here on inherit the affinity.
+  if (!options_.cpus.empty() && !cpu_affinity_set_) {
+    SetCurrentThreadCPUAffinity(options_.cpus);
+    cpu_affinity_set_ = true;
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  completed_uploads_ = 0;
+  retried_uploads_ = 0;
+
   ProcessPendingReports();
+
+  // Uploads that completed suggest a backlog that may not be finished, so
+  // check again soon. Uploads that only failed or found nothing to do back
+  // off.
+  if (completed_uploads_) {
+    thread_.SetWorkResult(WorkerThread::WorkResult::kDidWork);
+  } else if (retried_uploads_) {
+    thread_.SetWorkResult(WorkerThread::WorkResult::kFailed);
+  } else {
+    thread_.SetWorkResult(WorkerThread::WorkResult::kIdle);
+  }
 }
 
 bool CrashReportUploadThread::ShouldRateLimitUpload(
@@ -382,6 +1610,36 @@ bool CrashReportUploadThread::ShouldRateLimitUpload(
   if (report.upload_explicitly_requested || !options_.rate_limit)
     return false;
 
+  if (signature_rate_limiter_) {
+    // The report is throttled only by uploads of the same crash in the same
+    // product. Without stored parameters, both are empty.
+    std::map<std::string, std::string> parameters;
+    database_->GetUploadParameters(report.uuid, &parameters);
+    const auto product = parameters.find(kProductKey);
+    const auto signature = parameters.find(kCrashSignatureAnnotationKey);
+
+    base::AutoLock lock(rate_limit_lock_);
+    if (!signature_rate_limiter_->TakeToken(
+            product != parameters.end() ? product->second : std::string(),
+            signature != parameters.end() ? signature->second : std::string(),
+            time(nullptr))) {
+      database_->SkipReportUpload(
+          report.uuid, Metrics::CrashSkippedReason::kUploadThrottled);
+      return true;
+    }
+    return false;
+  }
+
+  base::AutoLock lock(rate_limit_lock_);
+  if (rate_limited_upload_in_progress_) {
+    // Another thread is attempting an upload that will become the most recent
+    // upload attempt, so this report’s upload would be throttled as it would
+    // be had the uploads occurred one after the other.
+    database_->SkipReportUpload(report.uuid,
+                                Metrics::CrashSkippedReason::kUploadThrottled);
+    return true;
+  }
+
   Settings* const settings = database_->GetSettings();
   time_t last_upload_attempt_time;
   if (settings->GetLastUploadAttemptTime(&last_upload_attempt_time)) {
@@ -410,12 +1668,72 @@ bool CrashReportUploadThread::ShouldRateLimitUpload(
       }
     }
   }
+
+  rate_limited_upload_in_progress_ = true;
+  return false;
+}
+
+bool CrashReportUploadThread::ShouldSkipDuplicateUpload(
+    const CrashReportDatabase::Report& report) {
+  if (report.upload_explicitly_requested ||
+      !options_.duplicate_signature_interval) {
+    return false;
+  }
+
+  std::map<std::string, std::string> parameters;
+  if (!database_->GetUploadParameters(report.uuid, &parameters)) {
+    return false;
+  }
+  const auto signature = parameters.find(kCrashSignatureAnnotationKey);
+  if (signature == parameters.end() || signature->second.empty()) {
+    return false;
+  }
+
+  const time_t now = time(nullptr);
+  const auto interval_ended = [this, now](const SignatureUploads& uploads) {
+    // An interval that purportedly started in the future is taken to have
+    // ended, as the clock must have moved backwards.
+    return now < uploads.interval_start ||
+           now - uploads.interval_start >=
+               static_cast<time_t>(options_.duplicate_signature_interval);
+  };
+
+  base::AutoLock lock(rate_limit_lock_);
+  auto uploads = signature_uploads_.find(signature->second);
+  if (uploads != signature_uploads_.end() && !interval_ended(uploads->second)) {
+    ++uploads->second.duplicates;
+    if (options_.duplicate_signature_sample_rate &&
+        uploads->second.duplicates % options_.duplicate_signature_sample_rate ==
+            0) {
+      return false;
+    }
+    database_->SkipReportUpload(
+        report.uuid, Metrics::CrashSkippedReason::kDuplicateSignature);
+    return true;
+  }
+
+  // Forget signatures whose intervals have ended, so that a process that
+  // crashes in many different ways doesn't accumulate them indefinitely.
+  for (auto it = signature_uploads_.begin(); it != signature_uploads_.end();) {
+    it = interval_ended(it->second) ? signature_uploads_.erase(it) : ++it;
+  }
+  signature_uploads_[signature->second] = {now, 0};
   return false;
 }
 
+void CrashReportUploadThread::FinishedRateLimitedUpload(
+    const CrashReportDatabase::Report& report) {
+  if (report.upload_explicitly_requested || !options_.rate_limit)
+    return;
+
+  base::AutoLock lock(rate_limit_lock_);
+  rate_limited_upload_in_progress_ = false;
+}
+
 #if BUILDFLAG(IS_IOS)
 bool CrashReportUploadThread::ShouldRateLimitRetry(
     const CrashReportDatabase::Report& report) {
+  base::AutoLock lock(rate_limit_lock_);
   if (retry_uuid_time_map_.find(report.uuid) != retry_uuid_time_map_.end()) {
     time_t now = time(nullptr);
     if (now < retry_uuid_time_map_[report.uuid]) {
@@ -15,13 +15,24 @@
 #ifndef CRASHPAD_HANDLER_CRASH_REPORT_UPLOAD_THREAD_H_
 #define CRASHPAD_HANDLER_CRASH_REPORT_UPLOAD_THREAD_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "client/crash_report_database.h"
+#include "handler/resource_budget.h"
+#include "util/file/chunked_memory_file.h"
 #include "util/misc/uuid.h"
 #include "util/stdlib/thread_safe_vector.h"
 #include "util/thread/stoppable.h"
@@ -29,6 +40,14 @@
 
 namespace crashpad {
 
+class ByteRateLimiter;
+class HTTPBodyStream;
+class HTTPMultipartBuilder;
+class HTTPTransport;
+class Semaphore;
+class Thread;
+class UploadRateLimiter;
+
 //! \brief A thread that processes pending crash reports in a
 //!     CrashReportDatabase by uploading them or marking them as completed
 //!     without upload, as desired.
@@ -45,23 +64,202 @@ namespace crashpad {
 class CrashReportUploadThread : public WorkerThread::Delegate,
                                 public Stoppable {
  public:
+  //! \brief The order in which pending reports are uploaded.
+  //!
+  //! Under a backlog, reports that are uploaded first are the most likely to
+  //! reach the server, as later ones may be throttled by Options::rate_limit.
+  //! With any order other than #kDatabaseOrder, reports whose upload was
+  //! explicitly requested are uploaded before all others.
+  enum class UploadOrder {
+    //! \brief Reports are uploaded in the order that the database lists them.
+    kDatabaseOrder,
+
+    //! \brief More recently created reports are uploaded first.
+    kNewestFirst,
+
+    //! \brief Reports taking less space, including attachments, are uploaded
+    //!     first.
+    kSmallestFirst,
+  };
+
    //! \brief Options to be passed to the CrashReportUploadThread constructor.
    struct Options {
     //! Whether client identifying parameters like product name or version
     //! should be added to the URL.
     bool identify_client_via_url;
 
-    //! Whether uploads should be throttled to a (currently hardcoded) rate.
+    //! Whether uploads should be throttled to a (currently hardcoded) rate,
+    //! or per #signature_upload_burst.
     bool rate_limit;
 
+    //! With #rate_limit, the number of reports with the same crash signature
+    //! and product that may be uploaded in quick succession, or `0` to limit
+    //! all uploads together to one an hour.
+    //!
+    //! When nonzero, each combination of the signature stored with a report’s
+    //! upload parameters at kCrashSignatureAnnotationKey and the product in its
+    //! `prod` parameter has a token bucket holding this many uploads, which
+    //! regains one every #signature_upload_interval seconds. A crash loop
+    //! empties its own bucket and is throttled without delaying other reports.
+    //! Reports without a stored signature share their product’s bucket. See
+    //! UploadRateLimiter.
+    uint32_t signature_upload_burst = 0;
+
+    //! The number of seconds in which a bucket regains an upload, with
+    //! #signature_upload_burst.
+    uint32_t signature_upload_interval = 60 * 60;
+
+    //! The file to keep the buckets of #signature_upload_burst in, so that they
+    //! outlast this object, or empty to keep them only in memory.
+    base::FilePath signature_upload_limits_path;
+
     //! Whether uploads should use `gzip` compression.
     bool upload_gzip;
 
+    //! The number of threads used to `gzip`-compress each upload when
+    //! #upload_gzip is `true`. See HTTPMultipartBuilder::SetGzipThreads().
+    size_t upload_gzip_threads = 1;
+
     //! Whether to periodically check for new pending reports not already known
     //! to exist. When `false`, only an initial upload attempt will be made for
     //! reports known to exist by having been added by the ReportPending()
     //! method. No scans for new pending reports will be conducted.
     bool watch_pending_reports;
+
+    //! With #watch_pending_reports, whether to check for pending reports at an
+    //! adaptive interval rather than a fixed one. The interval is short while
+    //! reports are being uploaded, and backs off while none are pending or
+    //! while uploads fail. Checks are aligned with those of other worker
+    //! threads so that their wakeups coalesce. See
+    //! WorkerThread::SetAdaptiveInterval().
+    bool adaptive_scheduling = false;
+
+    //! The maximum number of reports to upload at once. When greater than `1`,
+    //! pending reports are processed by up to this many threads in parallel.
+    //! Each report is still only uploaded by the thread that holds its upload
+    //! lock in the database, and #rate_limit is still respected.
+    size_t max_concurrent_uploads = 1;
+
+    //! Whether reports should be uploaded with Crashpad’s resumable upload
+    //! protocol, which allows an interrupted upload to continue from the last
+    //! offset acknowledged by the server instead of starting over.
+    //!
+    //! The upload begins with a `POST` to the upload URL carrying the
+    //! `X-Crashpad-Upload-Protocol: resumable` header and the content headers
+    //! of the multipart body, but no body. The server responds with an upload
+    //! ID in the response body. The body is then sent in `PUT` requests of up
+    //! to #resumable_upload_chunk_size bytes, each carrying the upload ID in
+    //! the `X-Crashpad-Upload-ID` header and its position in a `Content-Range`
+    //! header, which gives the total length as `*` until the final chunk. The
+    //! server responds to each chunk but the last with the number of bytes of
+    //! the body that it has received, and to the last with the response that
+    //! it would give to an ordinary upload. A later attempt asks the server
+    //! how much of the body it has received with a `PUT` of
+    //! `Content-Range: bytes */*` and an empty body, and starts over if the
+    //! server no longer recognizes the upload ID.
+    bool resumable_upload = false;
+
+    //! The largest chunk of the body to send in a single request when
+    //! #resumable_upload is `true`.
+    size_t resumable_upload_chunk_size = 1024 * 1024;
+
+    //! Whether a report’s attachments should be uploaded in separate requests
+    //! after its minidump, so that large attachments don’t delay or endanger
+    //! the minidump.
+    //!
+    //! The minidump’s request lists the names of the attachments to follow in
+    //! the `upload_attachments` form parameter, separated by commas. Once the
+    //! server has responded to it with the ID assigned to the report, each
+    //! attachment is uploaded in its own `POST` to the same URL, as the only
+    //! file in a multipart body, with the report ID in the `upload_report_id`
+    //! form parameter. Attachments are uploaded in parallel by up to
+    //! #max_concurrent_uploads threads. An attachment that fails to upload is
+    //! retried on its own a few times in immediate succession, without
+    //! uploading the report again, as it has already reached the server. An
+    //! attachment that still fails is given up on. Reports uploaded in batches
+    //! per #max_reports_per_upload carry their attachments inline.
+    bool separate_attachment_uploads = false;
+
+    //! Whether to open a connection to the upload server in the background
+    //! when ReportPending() is called or uploads are about to begin, so that
+    //! the first upload finds it ready. See HTTPTransport::Prewarm(). The
+    //! transports used for uploads are also kept between passes, along with
+    //! any connections they keep alive, rather than being discarded after
+    //! each. No connection is opened while uploads are disabled in the
+    //! database’s settings.
+    bool prewarm_connection = false;
+
+    //! The order in which to upload pending reports.
+    UploadOrder upload_order = UploadOrder::kDatabaseOrder;
+
+    //! The most bytes per second to send in the bodies of upload requests,
+    //! shared among all concurrent uploads, or `0` for no limit. Unlike
+    //! #rate_limit, which limits the number of uploads, this paces each upload
+    //! so that it doesn’t saturate the network link.
+    uint64_t max_upload_bytes_per_second = 0;
+
+    //! The largest report, including its attachments, that the server
+    //! accepts, or `0` for no limit. A larger report is trimmed to fit before
+    //! it is uploaded by rewriting its minidump without progressively more of
+    //! its lower-priority data, as TrimMinidump() does: memory other than
+    //! thread stacks first, then the stacks of threads other than the crashing
+    //! thread, then the memory info list. If the minidump and attachments
+    //! still don’t fit, the attachments are left out. The report stored in the
+    //! database is left intact. What was left out is listed in the
+    //! `upload_trimmed` form parameter, separated by commas.
+    uint64_t max_upload_size = 0;
+
+    //! The maximum number of reports to send in a single upload request. When
+    //! greater than `1`, pending reports are uploaded in batches of up to this
+    //! many, unless #resumable_upload is `true`.
+    //!
+    //! A batched request carries an `X-Crashpad-Batch-Size` header giving the
+    //! number of reports in it. The multipart parts of each report are named
+    //! as they would be in an upload of that report alone, prefixed with the
+    //! report’s position in the batch, starting at `0`, and a `:`. The server
+    //! responds with a line for each report, in order, holding the ID assigned
+    //! to the report, or nothing if it didn’t accept the report. A batch counts
+    //! as a single upload for the purposes of #rate_limit.
+    size_t max_reports_per_upload = 1;
+
+    //! The number of seconds after a report with a given crash signature is
+    //! chosen for upload during which other reports with the same signature
+    //! are considered duplicates, or `0` to consider no report a duplicate.
+    //! The signature is the one stored with the report’s upload parameters at
+    //! kCrashSignatureAnnotationKey; see CrashSignatureFromSnapshot(). Reports
+    //! without a stored signature and reports whose upload was explicitly
+    //! requested are never duplicates. Duplicates are marked as “completed”
+    //! without being uploaded, unless sampled by
+    //! #duplicate_signature_sample_rate. Signatures are only remembered for the
+    //! lifetime of this object.
+    uint32_t duplicate_signature_interval = 0;
+
+    //! When #duplicate_signature_interval is nonzero, one of every this many
+    //! duplicates of a signature is uploaded anyway, so that the server can
+    //! still gauge how often the crash recurs. `0` uploads no duplicates.
+    uint32_t duplicate_signature_sample_rate = 0;
+
+    //! The budget shared with captures, or `nullptr` for none. Weak. While the
+    //! budget is tight, reports are uploaded one at a time regardless of
+    //! #max_concurrent_uploads. While it is exhausted, uploads are deferred to
+    //! a later pass, leaving the budget to captures, which can’t wait.
+    ResourceBudget* resource_budget = nullptr;
+
+    //! A pool of upload slots shared with other upload threads, or `nullptr`
+    //! for none. Weak. Each upload request holds one of the semaphore’s slots
+    //! while it’s being made, so that the uploads of every thread sharing the
+    //! pool, each to its own URL, are bounded together, in addition to
+    //! #max_concurrent_uploads bounding this thread’s.
+    Semaphore* upload_pool = nullptr;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    //! The CPUs to run uploads on, or empty to run them wherever the thread
+    //! that called Start() may run. The upload thread, the threads it starts
+    //! for #max_concurrent_uploads and #upload_gzip_threads, and the memory
+    //! they allocate are kept to these CPUs and their NUMA nodes. See
+    //! SetCurrentThreadCPUAffinity().
+    std::vector<int> cpus;
+#endif
   };
 
   //! \brief Observation callback invoked each time the in-process handler
@@ -158,9 +356,26 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! well.
   void ProcessPendingReports();
 
+  //! \brief Calls ProcessPendingReport() on each of \a reports, using up to
+  //!     Options::max_concurrent_uploads threads.
+  //!
+  //! The reports are processed in the order selected by Options::upload_order.
+  //!
+  //! Each thread uses its own HTTPTransport for all of the reports that it
+  //! uploads, so that a connection to the server can be reused.
+  //!
+  //! \param[in] unordered_reports The crash reports to process.
+  //!
+  //! \return `false` if Stop() was called while processing reports, in which
+  //!     case some reports may not have been processed. `true` otherwise.
+  bool ProcessReports(
+      const std::vector<CrashReportDatabase::Report>& unordered_reports);
+
   //! \brief Processes a single pending report from the database.
   //!
   //! \param[in] report The crash report to process.
+  //! \param[in,out] http_transport The transport to upload \a report with,
+  //!     passed to UploadReport().
   //!
   //! If report upload is enabled, this method attempts to upload \a report by
   //! calling UplaodReport(). If the upload is successful, the report will be
@@ -170,7 +385,102 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! remain in the “pending” state. If the upload fails and no more retries are
   //! desired, or report upload is disabled, it will be marked as “completed” in
   //! the database without ever having been uploaded.
-  void ProcessPendingReport(const CrashReportDatabase::Report& report);
+  void ProcessPendingReport(const CrashReportDatabase::Report& report,
+                            std::unique_ptr<HTTPTransport>* http_transport);
+
+  //! \brief Processes a batch of pending reports from the database, uploading
+  //!     them in a single request.
+  //!
+  //! This behaves as ProcessPendingReport() does for each report in \a batch,
+  //! except that the reports are uploaded together by UploadReportBatch().
+  //!
+  //! \param[in] batch The crash reports to process.
+  //! \param[in,out] http_transport The transport to upload \a batch with,
+  //!     passed to UploadReportBatch().
+  void ProcessPendingReportBatch(
+      const std::vector<CrashReportDatabase::Report>& batch,
+      std::unique_ptr<HTTPTransport>* http_transport);
+
+  //! \brief Determines whether \a report may be uploaded, given the state of
+  //!     the database’s settings.
+  //!
+  //! \return `true` if \a report may be uploaded. Otherwise, `false`, with the
+  //!     report marked as “completed” in the database.
+  bool ShouldUploadReport(const CrashReportDatabase::Report& report);
+
+  //! \brief Calls CrashReportDatabase::GetReportForUploading() for \a report.
+  //!
+  //! \return `true` on success with \a upload_report set. `false` if the report
+  //!     can’t be uploaded now, in which case the report may have been marked
+  //!     as “completed” in the database.
+  bool OpenReportForUploading(
+      const CrashReportDatabase::Report& report,
+      std::unique_ptr<const CrashReportDatabase::UploadReport>* upload_report);
+
+  //! \brief Records the result of an attempt to upload \a report in the
+  //!     database.
+  //!
+  //! \param[in] report The crash report that was processed.
+  //! \param[in] upload_report The report as returned by
+  //!     OpenReportForUploading().
+  //! \param[in] upload_result The result of the upload attempt.
+  //! \param[in] response_body The response body for a successful upload.
+  void RecordUploadResult(
+      const CrashReportDatabase::Report& report,
+      std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report,
+      UploadResult upload_result,
+      const std::string& response_body);
+
+  //! \brief Adds the parts of a crash report’s upload to \a
+  //!     http_multipart_builder.
+  //!
+  //! \param[in] report The report to add.
+  //! \param[in] key_prefix A prefix for the names of the report’s parts.
+  //! \param[in] http_multipart_builder The builder to add the parts to.
+  //! \param[in] decompressed_report Storage for a decompressed copy of the
+  //!     report, if needed. This must outlive the use of \a
+  //!     http_multipart_builder.
+  //! \param[in] trimmed_report Storage for a copy of the report trimmed per
+  //!     Options::max_upload_size, if needed. This must outlive the use of \a
+  //!     http_multipart_builder.
+  //! \param[in] separate_attachments Whether to leave the report’s
+  //!     attachments out, to be uploaded by UploadAttachments().
+  //! \param[out] parameters The HTTP form parameters for the report.
+  //!
+  //! \return UploadResult::kSuccess on success, or another member of
+  //!     UploadResult indicating why the report can’t be uploaded.
+  UploadResult AddReportToUpload(
+      const CrashReportDatabase::UploadReport* report,
+      const std::string& key_prefix,
+      HTTPMultipartBuilder* http_multipart_builder,
+      ChunkedMemoryFile* decompressed_report,
+      ChunkedMemoryFile* trimmed_report,
+      bool separate_attachments,
+      std::map<std::string, std::string>* parameters);
+
+  //! \brief Returns a stream of the body stored with \a report by
+  //!     AddUploadBodyToReport(), if it may be uploaded as-is.
+  //!
+  //! The stored body is only used with Options::upload_gzip and without
+  //! Options::resumable_upload, if the report’s HTTP form parameters were
+  //! stored along with it, and if it fits within Options::max_upload_size.
+  //!
+  //! \param[in] report The report to upload.
+  //! \param[out] parameters The HTTP form parameters for the report.
+  //! \param[out] content_headers The content headers describing the body.
+  //!
+  //! \return The body stream, which reads from \a report, or `nullptr` if
+  //!     the body must be built from the report and its attachments.
+  std::unique_ptr<HTTPBodyStream> PreparedUploadBody(
+      const CrashReportDatabase::UploadReport* report,
+      std::map<std::string, std::string>* parameters,
+      std::map<std::string, std::string>* content_headers);
+
+  //! \brief Returns the URL to upload a report with the HTTP form \a
+  //!     parameters to, which may identify the client per
+  //!     Options::identify_client_via_url.
+  std::string UploadURL(
+      const std::map<std::string, std::string>& parameters) const;
 
   //! \brief Attempts to upload a crash report.
   //!
@@ -178,6 +488,11 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //!     calling CrashReportDatabase::GetReportForUploading() before calling
   //!     this method, and for calling
   //!     CrashReportDatabase::RecordUploadComplete() after calling this method.
+  //! \param[in,out] http_transport The transport to upload \a report with. If
+  //!     this is empty, a new transport will be created and stored here, so
+  //!     that it may be reused for subsequent uploads. Otherwise, the existing
+  //!     transport will be reset and reused, along with any connection that it
+  //!     kept alive.
   //! \param[out] response_body If the upload attempt is successful, this will
   //!     be set to the response body sent by the server. Breakpad-type servers
   //!     provide the crash ID assigned by the server in the response body.
@@ -185,8 +500,106 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! \return A member of UploadResult indicating the result of the upload
   //!    attempt.
   UploadResult UploadReport(const CrashReportDatabase::UploadReport* report,
+                            std::unique_ptr<HTTPTransport>* http_transport,
                             std::string* response_body);
 
+  //! \brief Attempts to upload several crash reports in a single request.
+  //!
+  //! See Options::max_reports_per_upload.
+  //!
+  //! \param[in] reports The reports to upload, as for UploadReport().
+  //! \param[in,out] http_transport The transport to upload \a reports with, as
+  //!     for UploadReport().
+  //! \param[out] upload_results The result of the upload attempt for each
+  //!     member of \a reports.
+  //! \param[out] response_bodies The ID assigned by the server to each member
+  //!     of \a reports that was uploaded successfully.
+  void UploadReportBatch(
+      const std::vector<const CrashReportDatabase::UploadReport*>& reports,
+      std::unique_ptr<HTTPTransport>* http_transport,
+      std::vector<UploadResult>* upload_results,
+      std::vector<std::string>* response_bodies);
+
+  //! \brief Uploads a crash report with the resumable upload protocol.
+  //!
+  //! This is called by UploadReport() when Options::resumable_upload is
+  //! `true`, once the upload body has been described to \a
+  //! http_multipart_builder, but before its body stream has been obtained.
+  //!
+  //! \param[in] report The report to upload.
+  //! \param[in] http_transport The transport to upload \a report with.
+  //! \param[in] http_multipart_builder The builder for the upload body. Its
+  //!     boundary will be replaced with that of an upload being resumed.
+  //! \param[in] url The URL to upload \a report to.
+  //! \param[out] response_body If the upload is successful, this will be set
+  //!     to the response body sent by the server for the final chunk.
+  //!
+  //! \return A member of UploadResult indicating the result of the upload
+  //!    attempt.
+  UploadResult UploadReportResumable(
+      const CrashReportDatabase::UploadReport* report,
+      HTTPTransport* http_transport,
+      HTTPMultipartBuilder* http_multipart_builder,
+      const std::string& url,
+      std::string* response_body);
+
+  //! \brief Uploads the attachments of a report whose minidump has been
+  //!     uploaded, per Options::separate_attachment_uploads.
+  //!
+  //! \param[in] report The report whose attachments to upload.
+  //! \param[in,out] http_transport_storage The transport that uploaded the
+  //!     minidump, used for one of the attachments. Threads uploading other
+  //!     attachments in parallel use transports from TakeHTTPTransport().
+  //! \param[in] url The URL to upload the attachments to.
+  //! \param[in] report_id The ID that the server assigned to the report.
+  void UploadAttachments(
+      const CrashReportDatabase::UploadReport* report,
+      std::unique_ptr<HTTPTransport>* http_transport_storage,
+      const std::string& url,
+      const std::string& report_id);
+
+  //! \brief Prepares the transport in \a http_transport_storage for a new
+  //!     request.
+  //!
+  //! If \a http_transport_storage is empty, it is given a transport from
+  //! TakeHTTPTransport(). Otherwise, the existing transport is reset.
+  //!
+  //! \return The transport, or `nullptr` on failure.
+  HTTPTransport* ResetHTTPTransport(
+      std::unique_ptr<HTTPTransport>* http_transport_storage);
+
+  //! \brief Starts opening a connection to the upload server in the
+  //!     background, per Options::prewarm_connection.
+  //!
+  //! Nothing is done if a connection is already being opened or an idle
+  //! transport is available in transport_pool_.
+  void StartPrewarm();
+
+  //! \brief Opens a connection to the upload server and adds the transport
+  //!     holding it to transport_pool_. This runs on the thread started by
+  //!     StartPrewarm().
+  void Prewarm();
+
+  //! \brief Waits for a connection being opened by StartPrewarm(), if any.
+  void FinishPrewarm();
+
+  //! \brief Returns a transport for a thread processing reports to upload
+  //!     with.
+  //!
+  //! With Options::prewarm_connection, this waits for a connection being opened
+  //! by StartPrewarm(), and returns an idle transport from transport_pool_ if
+  //! one is available. Otherwise, a new transport is returned.
+  std::unique_ptr<HTTPTransport> TakeHTTPTransport();
+
+  //! \brief Keeps \a http_transport in transport_pool_ for later uploads, per
+  //!     Options::prewarm_connection.
+  void ReturnHTTPTransport(std::unique_ptr<HTTPTransport> http_transport);
+
+  //! \brief Wraps \a body_stream to respect
+  //!     Options::max_upload_bytes_per_second, if it is set.
+  std::unique_ptr<HTTPBodyStream> LimitUploadRate(
+      std::unique_ptr<HTTPBodyStream> body_stream);
+
   // WorkerThread::Delegate:
   //! \brief Calls ProcessPendingReports() in response to ReportPending() having
   //!     been called on any thread, as well as periodically on a timer.
@@ -203,10 +616,34 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   //! If upload was requested explicitly (i.e. by user action), do not throttle
   //! the upload.
   //!
+  //! When reports are uploaded concurrently, an upload attempt that is subject
+  //! to rate-limiting and is still in progress counts as the most recent
+  //! upload attempt. The caller must call FinishedRateLimitedUpload() once
+  //! the upload attempt for \a report has been recorded in the database if
+  //! this returns `false`.
+  //!
   //! TODO(mark): Provide a proper rate-limiting strategy and allow for failed
   //! upload attempts to be retried.
   bool ShouldRateLimitUpload(const CrashReportDatabase::Report& report);
 
+  //! \brief Skips the upload of \a report if it duplicates a recently
+  //!     uploaded report.
+  //!
+  //! See Options::duplicate_signature_interval. A report that isn't skipped
+  //! starts a new interval for its signature if the previous one has ended.
+  //!
+  //! \param[in] report The crash report to process.
+  //!
+  //! \return `true` if \a report duplicates a recent upload and was marked as
+  //!     “completed” in the database. `false` if it should be uploaded.
+  bool ShouldSkipDuplicateUpload(const CrashReportDatabase::Report& report);
+
+  //! \brief Ends the upload attempt begun after ShouldRateLimitUpload()
+  //!     returned `false`.
+  //!
+  //! \param[in] report The crash report that was processed.
+  void FinishedRateLimitedUpload(const CrashReportDatabase::Report& report);
+
 #if BUILDFLAG(IS_IOS)
   //! \brief Rate-limit report retries.
   //!
@@ -228,10 +665,46 @@ class CrashReportUploadThread : public WorkerThread::Delegate,
   const std::string url_;
   WorkerThread thread_;
   ThreadSafeVector<UUID> known_pending_report_uuids_;
+
+  // The number of reports whose upload attempts during the current call to
+  // DoWork() completed them or left them to be retried, respectively. These
+  // determine the result reported to thread_ with adaptive scheduling.
+  std::atomic<size_t> completed_uploads_;
+  std::atomic<size_t> retried_uploads_;
+
+  // The uploads of each crash signature within the current
+  // Options::duplicate_signature_interval.
+  struct SignatureUploads {
+    time_t interval_start;
+    uint32_t duplicates;
+  };
+
+  // Protects rate_limited_upload_in_progress_, signature_uploads_,
+  // signature_rate_limiter_, and, on iOS, retry_uuid_time_map_, which are used
+  // by all threads processing reports.
+  base::Lock rate_limit_lock_;
+  bool rate_limited_upload_in_progress_;
+  std::map<std::string, SignatureUploads> signature_uploads_;
+  std::unique_ptr<UploadRateLimiter> signature_rate_limiter_;
 #if BUILDFLAG(IS_IOS)
-  // This is not thread-safe, and only used by the worker thread.
   std::map<UUID, time_t> retry_uuid_time_map_;
 #endif
+  std::unique_ptr<ByteRateLimiter> upload_rate_limiter_;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Whether Options::cpus has been applied to thread_. Only used on thread_.
+  bool cpu_affinity_set_;
+#endif
+
+  // Protects transport_pool_ and prewarm_thread_. With
+  // Options::prewarm_connection, transport_pool_ holds idle transports, which
+  // may have a connection open, and prewarm_thread_ is the thread started by
+  // StartPrewarm(), until a thread processing reports waits for it.
+  base::Lock transport_pool_lock_;
+  std::vector<std::unique_ptr<HTTPTransport>> transport_pool_;
+  std::unique_ptr<Thread> prewarm_thread_;
+  const std::function<void()> prewarm_function_;  // runs on prewarm_thread_
+
   CrashReportDatabase* database_;  // weak
 };
 
@@ -0,0 +1,469 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_report_upload_thread.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "client/crash_report_database.h"
+#include "client/settings.h"
+#include "gtest/gtest.h"
+#include "test/multiprocess_exec.h"
+#include "test/scoped_temp_dir.h"
+#include "test/test_paths.h"
+#include "util/file/file_io.h"
+#include "util/misc/random_string.h"
+#include "util/misc/uuid.h"
+#include "util/net/http_headers.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr char kBatchSizeHeader[] = "X-Crashpad-Batch-Size";
+
+// Writes reports to a new database and uploads them with a
+// CrashReportUploadThread to http_transport_test_server, which responds to one
+// request, or to one for each response code given to SetResponseCodes(). The
+// requests and the database are kept for the test to examine once Run()
+// returns.
+class CrashReportUploadThreadTest : public MultiprocessExec {
+ public:
+  CrashReportUploadThreadTest(const CrashReportUploadThread::Options& options,
+                              size_t report_count)
+      : MultiprocessExec(),
+        options_(options),
+        report_count_(report_count),
+        response_codes_(1, 200),
+        attachment_names_(),
+        temp_dir_(),
+        database_(),
+        report_uuids_(),
+        responses_(),
+        requests_() {
+    SetServerCommand();
+  }
+
+  CrashReportUploadThreadTest(const CrashReportUploadThreadTest&) = delete;
+  CrashReportUploadThreadTest& operator=(const CrashReportUploadThreadTest&) =
+      delete;
+
+  ~CrashReportUploadThreadTest() = default;
+
+  // The server responds to each request in turn with the next of
+  // response_codes, which must not be empty.
+  void SetResponseCodes(const std::vector<uint16_t>& response_codes) {
+    response_codes_ = response_codes;
+    SetServerCommand();
+  }
+
+  // Each report is written with an attachment named with each of
+  // attachment_names.
+  void SetAttachmentNames(const std::vector<std::string>& attachment_names) {
+    attachment_names_ = attachment_names;
+  }
+
+  // The minidump written for the report with ID uuid.
+  static std::string MinidumpContents(const UUID& uuid) {
+    return "minidump " + uuid.ToString();
+  }
+
+  // The attachment named name written for the report with ID uuid.
+  static std::string AttachmentContents(const UUID& uuid,
+                                        const std::string& name) {
+    return "attachment " + name + " " + uuid.ToString();
+  }
+
+  CrashReportDatabase* database() const { return database_.get(); }
+
+  // The reports, in the order that they were written.
+  const std::vector<UUID>& report_uuids() const { return report_uuids_; }
+
+  // The 16 characters that the server sent in its first response, which it
+  // follows with "\r\n".
+  const std::string& response() const { return responses_[0]; }
+
+  // The first request that the server received, as its headers followed by its
+  // body.
+  const std::string& request() const { return requests_[0]; }
+
+  // Every request that the server received, in order.
+  const std::vector<std::string>& requests() const { return requests_; }
+
+ private:
+  void SetServerCommand() {
+    std::vector<std::string> arguments;
+    if (response_codes_.size() != 1) {
+      arguments.push_back(
+          base::StringPrintf("--requests=%" PRIuS, response_codes_.size()));
+    }
+    SetChildCommand(TestPaths::Executable().DirName().Append(
+                        FILE_PATH_LITERAL("http_transport_test_server")
+#if BUILDFLAG(IS_WIN)
+                            FILE_PATH_LITERAL(".exe")
+#endif
+                            ),
+                    &arguments);
+  }
+
+  void MultiprocessParent() override {
+    // The child writes the port that it’s listening on, then reads the code
+    // and body to respond to each request with.
+    uint16_t port;
+    ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &port, sizeof(port)));
+    for (uint16_t response_code : response_codes_) {
+      ASSERT_TRUE(LoggingWriteFile(
+          WritePipeHandle(), &response_code, sizeof(response_code)));
+      responses_.push_back(RandomString());
+      ASSERT_TRUE(LoggingWriteFile(WritePipeHandle(),
+                                   responses_.back().data(),
+                                   responses_.back().size()));
+    }
+
+    database_ = CrashReportDatabase::Initialize(temp_dir_.path());
+    ASSERT_TRUE(database_);
+    ASSERT_TRUE(database_->GetSettings()->SetUploadsEnabled(true));
+    for (size_t index = 0; index < report_count_; ++index) {
+      std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+      ASSERT_EQ(database_->PrepareNewCrashReport(&new_report),
+                CrashReportDatabase::kNoError);
+      const std::string contents = MinidumpContents(new_report->ReportID());
+      ASSERT_TRUE(
+          new_report->Writer()->Write(contents.data(), contents.size()));
+      for (const std::string& name : attachment_names_) {
+        FileWriter* writer = new_report->AddAttachment(name);
+        ASSERT_TRUE(writer);
+        const std::string attachment =
+            AttachmentContents(new_report->ReportID(), name);
+        ASSERT_TRUE(writer->Write(attachment.data(), attachment.size()));
+      }
+      UUID uuid;
+      ASSERT_EQ(database_->FinishedWritingCrashReport(std::move(new_report),
+                                                      &uuid),
+                CrashReportDatabase::kNoError);
+      report_uuids_.push_back(uuid);
+    }
+
+    // With Options::watch_pending_reports, the thread looks for pending reports
+    // as soon as it starts, and not again until long after the test is over.
+    Semaphore processed(0);
+    CrashReportUploadThread upload_thread(
+        database_.get(),
+        base::StringPrintf("http://localhost:%d/upload", port),
+        options_,
+        [&processed]() { processed.Signal(); });
+    upload_thread.Start();
+    processed.Wait();
+    upload_thread.Stop();
+
+    // Stops a server still waiting for requests that weren’t made.
+    CloseWritePipe();
+
+    // Read until the child’s stdout closes, then split the requests apart.
+    std::string output;
+    char buf[4096];
+    FileOperationResult bytes_read;
+    while ((bytes_read = ReadFile(ReadPipeHandle(), buf, sizeof(buf))) != 0) {
+      ASSERT_GE(bytes_read, 0);
+      output.append(buf, bytes_read);
+    }
+    static constexpr char kRequestLine[] = "POST /upload HTTP/1.0\r\n";
+    size_t start = output.find(kRequestLine);
+    while (start != std::string::npos) {
+      const size_t next = output.find(kRequestLine, start + 1);
+      requests_.push_back(output.substr(start, next - start));
+      start = next;
+    }
+    ASSERT_EQ(requests_.size(), response_codes_.size());
+  }
+
+  const CrashReportUploadThread::Options options_;
+  const size_t report_count_;
+  std::vector<uint16_t> response_codes_;
+  std::vector<std::string> attachment_names_;
+  ScopedTempDir temp_dir_;
+  std::unique_ptr<CrashReportDatabase> database_;
+  std::vector<UUID> report_uuids_;
+  std::vector<std::string> responses_;
+  std::vector<std::string> requests_;
+};
+
+CrashReportUploadThread::Options TestOptions() {
+  CrashReportUploadThread::Options options;
+  options.identify_client_via_url = false;
+  options.rate_limit = false;
+  options.upload_gzip = false;
+  options.watch_pending_reports = true;
+  return options;
+}
+
+// Sets value to the value of the header in request, and returns whether it was
+// present.
+bool GetHeader(const std::string& request,
+               const std::string& header,
+               std::string* value) {
+  const std::string field = "\r\n" + header + ": ";
+  const size_t headers_end = request.find("\r\n\r\n");
+  const size_t start = request.find(field);
+  if (start == std::string::npos || start >= headers_end) {
+    return false;
+  }
+  const size_t value_start = start + field.size();
+  *value = request.substr(value_start, request.find("\r\n", value_start) -
+                                           value_start);
+  return true;
+}
+
+// Returns the body of request, or an empty string if it has none.
+std::string GetBody(const std::string& request) {
+  const size_t headers_end = request.find("\r\n\r\n");
+  return headers_end == std::string::npos ? std::string()
+                                          : request.substr(headers_end + 4);
+}
+
+// Returns the multipart body that uploads the minidump of the report with ID
+// each of uuids, its part named with key_prefixes at the same index.
+std::string ExpectedBody(const std::string& request,
+                         const std::vector<std::string>& key_prefixes,
+                         const std::vector<UUID>& uuids) {
+  std::string content_type;
+  if (!GetHeader(request, kContentType, &content_type)) {
+    return std::string();
+  }
+  static constexpr char kBoundaryEq[] = "boundary=";
+  const size_t boundary_start = content_type.find(kBoundaryEq);
+  if (boundary_start == std::string::npos) {
+    return std::string();
+  }
+  const std::string boundary =
+      content_type.substr(boundary_start + strlen(kBoundaryEq));
+
+  std::string body;
+  for (size_t index = 0; index < uuids.size(); ++index) {
+    body += base::StringPrintf(
+        "--%s\r\n"
+        "Content-Disposition: form-data; name=\"%supload_file_minidump\"; "
+        "filename=\"%s.dmp\"\r\n"
+        "Content-Type: application/octet-stream\r\n\r\n",
+        boundary.c_str(),
+        key_prefixes[index].c_str(),
+        uuids[index].ToString().c_str());
+    body += CrashReportUploadThreadTest::MinidumpContents(uuids[index]);
+    body += "\r\n";
+  }
+  body += "--" + boundary + "--\r\n";
+  return body;
+}
+
+TEST(CrashReportUploadThread, Batch) {
+  CrashReportUploadThread::Options options = TestOptions();
+  options.max_reports_per_upload = 2;
+  CrashReportUploadThreadTest test(options, 2);
+  test.Run();
+  ASSERT_EQ(test.report_uuids().size(), 2u);
+
+  const std::string& request = test.request();
+  std::string batch_size;
+  ASSERT_TRUE(GetHeader(request, kBatchSizeHeader, &batch_size));
+  EXPECT_EQ(batch_size, "2");
+
+  // The database decides the order of the reports in the batch.
+  std::vector<UUID> batch_uuids = test.report_uuids();
+  const std::string first_part = base::StringPrintf(
+      "name=\"0:upload_file_minidump\"; filename=\"%s.dmp\"",
+      batch_uuids[0].ToString().c_str());
+  if (request.find(first_part) == std::string::npos) {
+    std::swap(batch_uuids[0], batch_uuids[1]);
+  }
+  EXPECT_EQ(GetBody(request), ExpectedBody(request, {"0:", "1:"}, batch_uuids));
+
+  // The response has a line holding the ID that the server assigned to the
+  // first report, and none for the second, which it didn’t accept.
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(test.database()->LookUpCrashReport(batch_uuids[0], &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, test.response());
+
+  ASSERT_EQ(test.database()->LookUpCrashReport(batch_uuids[1], &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_FALSE(report.uploaded);
+#if !BUILDFLAG(IS_IOS)
+  // Elsewhere, a report whose upload failed is not retried.
+  std::vector<CrashReportDatabase::Report> pending_reports;
+  ASSERT_EQ(test.database()->GetPendingReports(&pending_reports),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(pending_reports.empty());
+#endif  // !BUILDFLAG(IS_IOS)
+}
+
+TEST(CrashReportUploadThread, BatchOfOneIsUploadedAlone) {
+  // A single pending report is uploaded as it would be without batching.
+  CrashReportUploadThread::Options options = TestOptions();
+  options.max_reports_per_upload = 2;
+  CrashReportUploadThreadTest test(options, 1);
+  test.Run();
+  ASSERT_EQ(test.report_uuids().size(), 1u);
+
+  const std::string& request = test.request();
+  std::string batch_size;
+  EXPECT_FALSE(GetHeader(request, kBatchSizeHeader, &batch_size));
+  EXPECT_EQ(GetBody(request), ExpectedBody(request, {""}, test.report_uuids()));
+
+  // The whole response body is the report’s ID.
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(
+      test.database()->LookUpCrashReport(test.report_uuids()[0], &report),
+      CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, test.response() + "\r\n");
+}
+
+// Returns the multipart part holding the form field named name with value.
+std::string FormDataPart(const std::string& name, const std::string& value) {
+  return base::StringPrintf(
+      "Content-Disposition: form-data; name=\"%s\"\r\n\r\n%s\r\n",
+      name.c_str(),
+      value.c_str());
+}
+
+// Returns the multipart part holding the attachment named name of the report
+// with ID uuid.
+std::string AttachmentPart(const UUID& uuid, const std::string& name) {
+  return base::StringPrintf(
+             "Content-Disposition: form-data; name=\"%s\"; "
+             "filename=\"%s\"\r\n"
+             "Content-Type: application/octet-stream\r\n\r\n",
+             name.c_str(),
+             name.c_str()) +
+         CrashReportUploadThreadTest::AttachmentContents(uuid, name) + "\r\n";
+}
+
+bool Contains(const std::string& string, const std::string& substring) {
+  return string.find(substring) != std::string::npos;
+}
+
+TEST(CrashReportUploadThread, SeparateAttachments) {
+  CrashReportUploadThread::Options options = TestOptions();
+  options.separate_attachment_uploads = true;
+  CrashReportUploadThreadTest test(options, 1);
+  test.SetResponseCodes({200, 200, 200});
+  test.SetAttachmentNames({"first", "second"});
+  test.Run();
+  ASSERT_EQ(test.report_uuids().size(), 1u);
+  const UUID& uuid = test.report_uuids()[0];
+
+  // The minidump goes first, naming the attachments to follow but without
+  // them.
+  const std::vector<std::string>& requests = test.requests();
+  ASSERT_EQ(requests.size(), 3u);
+  const std::string minidump_body = GetBody(requests[0]);
+  EXPECT_TRUE(Contains(minidump_body,
+                       FormDataPart("upload_attachments", "first,second")));
+  EXPECT_TRUE(Contains(minidump_body,
+                       CrashReportUploadThreadTest::MinidumpContents(uuid)));
+  EXPECT_FALSE(Contains(minidump_body, "filename=\"first\""));
+  EXPECT_FALSE(Contains(minidump_body, "filename=\"second\""));
+
+  // Each attachment follows on its own, with the ID that the server responded
+  // to the minidump with, and without the minidump.
+  const std::string report_id = test.response() + "\r\n";
+  const std::string names[] = {"first", "second"};
+  for (size_t index = 0; index < std::size(names); ++index) {
+    SCOPED_TRACE(names[index]);
+    const std::string body = GetBody(requests[index + 1]);
+    EXPECT_TRUE(Contains(body, FormDataPart("upload_report_id", report_id)));
+    EXPECT_TRUE(Contains(body, AttachmentPart(uuid, names[index])));
+    EXPECT_FALSE(Contains(body, "upload_file_minidump"));
+  }
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(test.database()->LookUpCrashReport(uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, report_id);
+}
+
+TEST(CrashReportUploadThread, SeparateAttachmentRetried) {
+  CrashReportUploadThread::Options options = TestOptions();
+  options.separate_attachment_uploads = true;
+  CrashReportUploadThreadTest test(options, 1);
+  test.SetResponseCodes({200, 500, 200});
+  test.SetAttachmentNames({"attachment"});
+  test.Run();
+  ASSERT_EQ(test.report_uuids().size(), 1u);
+  const UUID& uuid = test.report_uuids()[0];
+
+  // The attachment is uploaded again in full after its first attempt fails,
+  // while the minidump is uploaded only once.
+  const std::vector<std::string>& requests = test.requests();
+  ASSERT_EQ(requests.size(), 3u);
+  EXPECT_TRUE(Contains(GetBody(requests[0]), "upload_file_minidump"));
+  const std::string report_id = test.response() + "\r\n";
+  for (size_t index = 1; index < requests.size(); ++index) {
+    SCOPED_TRACE(base::StringPrintf("request %" PRIuS, index));
+    const std::string body = GetBody(requests[index]);
+    EXPECT_TRUE(Contains(body, FormDataPart("upload_report_id", report_id)));
+    EXPECT_TRUE(Contains(body, AttachmentPart(uuid, "attachment")));
+    EXPECT_FALSE(Contains(body, "upload_file_minidump"));
+  }
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(test.database()->LookUpCrashReport(uuid, &report),
+            CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, report_id);
+}
+
+TEST(CrashReportUploadThread, SeparateAttachmentGivenUp) {
+  // An attachment that keeps failing doesn’t affect its report.
+  CrashReportUploadThread::Options options = TestOptions();
+  options.separate_attachment_uploads = true;
+  CrashReportUploadThreadTest test(options, 1);
+  test.SetResponseCodes({200, 500, 500, 500});
+  test.SetAttachmentNames({"attachment"});
+  test.Run();
+  ASSERT_EQ(test.report_uuids().size(), 1u);
+
+  const std::vector<std::string>& requests = test.requests();
+  ASSERT_EQ(requests.size(), 4u);
+  for (size_t index = 1; index < requests.size(); ++index) {
+    SCOPED_TRACE(base::StringPrintf("request %" PRIuS, index));
+    EXPECT_TRUE(Contains(GetBody(requests[index]),
+                         AttachmentPart(test.report_uuids()[0], "attachment")));
+  }
+
+  CrashReportDatabase::Report report;
+  ASSERT_EQ(
+      test.database()->LookUpCrashReport(test.report_uuids()[0], &report),
+      CrashReportDatabase::kNoError);
+  EXPECT_TRUE(report.uploaded);
+  EXPECT_EQ(report.id, test.response() + "\r\n");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,223 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_signature.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/memory_snapshot.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/process_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+const char kCrashSignatureAnnotationKey[] = "crashpad_signature";
+
+namespace {
+
+// A 64-bit FNV-1a hash. Values are added a byte at a time in a fixed order so
+// that the hash doesn’t depend on the handler’s byte order.
+class SignatureHash {
+ public:
+  SignatureHash() : hash_(0xcbf29ce484222325) {}
+
+  SignatureHash(const SignatureHash&) = delete;
+  SignatureHash& operator=(const SignatureHash&) = delete;
+
+  void AddBytes(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t index = 0; index < size; ++index) {
+      AddByte(bytes[index]);
+    }
+  }
+
+  void AddValue(uint64_t value) {
+    for (size_t index = 0; index < sizeof(value); ++index) {
+      AddByte(static_cast<uint8_t>(value >> (index * 8)));
+    }
+  }
+
+  // Adds the size of |data| before |data| itself, so that adjacent variable
+  // length fields can’t be confused with one another.
+  void AddSizedBytes(const void* data, size_t size) {
+    AddValue(size);
+    AddBytes(data, size);
+  }
+
+  uint64_t Value() const { return hash_; }
+
+ private:
+  void AddByte(uint8_t byte) {
+    hash_ ^= byte;
+    hash_ *= 0x100000001b3;
+  }
+
+  uint64_t hash_;
+};
+
+// Copies the contents of a MemorySnapshot.
+class MemoryCopier final : public MemorySnapshot::Delegate {
+ public:
+  explicit MemoryCopier(std::vector<uint8_t>* data) : data_(data) {}
+
+  MemoryCopier(const MemoryCopier&) = delete;
+  MemoryCopier& operator=(const MemoryCopier&) = delete;
+
+  ~MemoryCopier() override = default;
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    data_->assign(bytes, bytes + size);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t>* data_;  // weak
+};
+
+// Finds the modules containing addresses.
+class ModuleFinder {
+ public:
+  explicit ModuleFinder(const std::vector<const ModuleSnapshot*>& modules)
+      : modules_(modules) {
+    std::sort(modules_.begin(),
+              modules_.end(),
+              [](const ModuleSnapshot* lhs, const ModuleSnapshot* rhs) {
+                return lhs->Address() < rhs->Address();
+              });
+  }
+
+  ModuleFinder(const ModuleFinder&) = delete;
+  ModuleFinder& operator=(const ModuleFinder&) = delete;
+
+  // Returns the module containing |address|, or nullptr if there is none.
+  const ModuleSnapshot* ModuleContaining(uint64_t address) const {
+    auto module = std::upper_bound(
+        modules_.begin(),
+        modules_.end(),
+        address,
+        [](uint64_t address, const ModuleSnapshot* module) {
+          return address < module->Address();
+        });
+    if (module == modules_.begin()) {
+      return nullptr;
+    }
+    --module;
+    return address - (*module)->Address() < (*module)->Size() ? *module
+                                                               : nullptr;
+  }
+
+ private:
+  std::vector<const ModuleSnapshot*> modules_;
+};
+
+// Adds the identity of |module| and |address|’s offset within it to |hash|.
+void AddModuleOffset(const ModuleSnapshot* module,
+                     uint64_t address,
+                     SignatureHash* hash) {
+  const std::vector<uint8_t> build_id = module->BuildID();
+  UUID uuid;
+  uint32_t age;
+  module->UUIDAndAge(&uuid, &age);
+  if (!build_id.empty()) {
+    hash->AddSizedBytes(build_id.data(), build_id.size());
+  } else if (uuid != UUID()) {
+    const std::string uuid_string = uuid.ToString();
+    hash->AddSizedBytes(uuid_string.data(), uuid_string.size());
+    hash->AddValue(age);
+  } else {
+    const std::string name = module->Name();
+    hash->AddSizedBytes(name.data(), name.size());
+  }
+  hash->AddValue(address - module->Address());
+}
+
+}  // namespace
+
+std::string CrashSignatureFromSnapshot(const ProcessSnapshot& process_snapshot,
+                                       size_t max_frames) {
+  const ExceptionSnapshot* exception = process_snapshot.Exception();
+  if (!exception || !exception->Context()) {
+    return std::string();
+  }
+
+  const ModuleFinder module_finder(process_snapshot.Modules());
+  const CPUContext* context = exception->Context();
+  const ModuleSnapshot* crashing_module =
+      module_finder.ModuleContaining(context->InstructionPointer());
+  if (!crashing_module) {
+    return std::string();
+  }
+
+  SignatureHash hash;
+  hash.AddValue(exception->Exception());
+  AddModuleOffset(crashing_module, context->InstructionPointer(), &hash);
+
+  const MemorySnapshot* stack = nullptr;
+  for (const ThreadSnapshot* thread : process_snapshot.Threads()) {
+    if (thread->ThreadID() == exception->ThreadID()) {
+      stack = thread->Stack();
+      break;
+    }
+  }
+
+  std::vector<uint8_t> stack_data;
+  MemoryCopier stack_copier(&stack_data);
+  if (max_frames > 0 && stack && stack->Read(&stack_copier)) {
+    const size_t pointer_size = context->Is64Bit() ? 8 : 4;
+    const uint64_t stack_pointer = context->StackPointer();
+    size_t offset = 0;
+    if (stack_pointer > stack->Address()) {
+      const uint64_t sp_offset = stack_pointer - stack->Address();
+      offset = sp_offset >= stack_data.size()
+                   ? stack_data.size()
+                   : static_cast<size_t>(sp_offset);
+    }
+    offset = (offset + pointer_size - 1) / pointer_size * pointer_size;
+
+    size_t frames = 0;
+    for (; offset + pointer_size <= stack_data.size() && frames < max_frames;
+         offset += pointer_size) {
+      uint64_t value;
+      if (pointer_size == 8) {
+        memcpy(&value, &stack_data[offset], sizeof(value));
+      } else {
+        uint32_t value_32;
+        memcpy(&value_32, &stack_data[offset], sizeof(value_32));
+        value = value_32;
+      }
+
+      const ModuleSnapshot* module = module_finder.ModuleContaining(value);
+      if (module) {
+        AddModuleOffset(module, value, &hash);
+        ++frames;
+      }
+    }
+  }
+
+  return base::StringPrintf("%016" PRIx64, hash.Value());
+}
+
+}  // namespace crashpad
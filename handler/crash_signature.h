@@ -0,0 +1,63 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_CRASH_SIGNATURE_H_
+#define CRASHPAD_HANDLER_CRASH_SIGNATURE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+namespace crashpad {
+
+class ProcessSnapshot;
+
+//! \brief The name of the process annotation, and so of the HTTP form
+//!     parameter, that carries a report’s crash signature.
+extern const char kCrashSignatureAnnotationKey[];
+
+//! \brief The number of stack frames that CrashSignatureFromSnapshot()
+//!     considers by default.
+constexpr size_t kCrashSignatureDefaultFrames = 8;
+
+//! \brief Computes a signature identifying the crash in \a process_snapshot.
+//!
+//! The signature is a hash of the exception code, the identity of the module
+//! containing the crashing instruction and the instruction’s offset within it,
+//! and the module identity and offset of up to \a max_frames values found on
+//! the crashing thread’s stack, above its stack pointer, that point into a
+//! module. A module is identified by its build ID, or by its UUID and age, or
+//! failing those, by its name. Offsets are used in place of addresses so that
+//! the signature doesn’t depend on where modules were loaded.
+//!
+//! The stack is scanned rather than unwound, so the values considered may
+//! include stale return addresses and pointers to module data. They are
+//! nonetheless the same from one occurrence of a crash to the next, which is
+//! what matters for recognizing repeated crashes, such as those of a crash
+//! loop, before they are uploaded.
+//!
+//! \param[in] process_snapshot The snapshot to compute the signature of.
+//! \param[in] max_frames The maximum number of values from the stack to
+//!     include in the signature.
+//!
+//! \return The signature as a string of hexadecimal digits, or an empty string
+//!     if \a process_snapshot has no exception, or the crashing instruction
+//!     isn’t in a module.
+std::string CrashSignatureFromSnapshot(
+    const ProcessSnapshot& process_snapshot,
+    size_t max_frames = kCrashSignatureDefaultFrames);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_CRASH_SIGNATURE_H_
@@ -0,0 +1,157 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/crash_signature.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kThreadID = 7;
+constexpr uint64_t kStackAddress = 0x7fff00000000;
+constexpr size_t kStackSize = 256;
+
+// Every pointer-sized value on the test stack is made of this byte, so it
+// points into the module loaded at kStackModuleAddress.
+constexpr char kStackValue = 0x41;
+constexpr uint64_t kStackModuleAddress = 0x4141414141410000;
+
+struct CrashParameters {
+  uint64_t crashing_module_address = 0x10000000;
+  uint64_t crashing_offset = 0x100;
+  uint64_t stack_module_address = kStackModuleAddress;
+  uint32_t exception = 11;
+  uint64_t thread_id = kThreadID;
+};
+
+std::unique_ptr<TestProcessSnapshot> MakeSnapshot(
+    const CrashParameters& parameters) {
+  auto process_snapshot = std::make_unique<TestProcessSnapshot>();
+
+  auto crashing_module = std::make_unique<TestModuleSnapshot>();
+  crashing_module->SetName("crashing_module");
+  crashing_module->SetAddressAndSize(parameters.crashing_module_address,
+                                     0x10000);
+  crashing_module->SetBuildID({0x01, 0x02, 0x03, 0x04});
+  process_snapshot->AddModule(std::move(crashing_module));
+
+  auto stack_module = std::make_unique<TestModuleSnapshot>();
+  stack_module->SetName("stack_module");
+  stack_module->SetAddressAndSize(parameters.stack_module_address, 0x20000);
+  stack_module->SetBuildID({0x05, 0x06, 0x07, 0x08});
+  process_snapshot->AddModule(std::move(stack_module));
+
+  auto stack = std::make_unique<TestMemorySnapshot>();
+  stack->SetAddress(kStackAddress);
+  stack->SetSize(kStackSize);
+  stack->SetValue(kStackValue);
+  auto thread = std::make_unique<TestThreadSnapshot>();
+  thread->SetThreadID(kThreadID);
+  thread->SetStack(std::move(stack));
+  process_snapshot->AddThread(std::move(thread));
+
+  auto exception = std::make_unique<TestExceptionSnapshot>();
+  exception->SetThreadID(parameters.thread_id);
+  exception->SetException(parameters.exception);
+  CPUContext* context = exception->MutableContext();
+  context->architecture = kCPUArchitectureX86_64;
+  context->x86_64->rip =
+      parameters.crashing_module_address + parameters.crashing_offset;
+  context->x86_64->rsp = kStackAddress;
+  process_snapshot->SetException(std::move(exception));
+
+  return process_snapshot;
+}
+
+TEST(CrashSignature, RepeatedCrashesMatch) {
+  const CrashParameters parameters;
+  const std::string signature =
+      CrashSignatureFromSnapshot(*MakeSnapshot(parameters));
+  ASSERT_EQ(signature.size(), 16u);
+  EXPECT_EQ(CrashSignatureFromSnapshot(*MakeSnapshot(parameters)), signature);
+}
+
+TEST(CrashSignature, IndependentOfLoadAddresses) {
+  const CrashParameters parameters;
+  const std::string signature =
+      CrashSignatureFromSnapshot(*MakeSnapshot(parameters));
+
+  CrashParameters relocated;
+  relocated.crashing_module_address = 0x20000000;
+  EXPECT_EQ(CrashSignatureFromSnapshot(*MakeSnapshot(relocated)), signature);
+}
+
+TEST(CrashSignature, DifferentCrashesDiffer) {
+  const CrashParameters parameters;
+  const std::string signature =
+      CrashSignatureFromSnapshot(*MakeSnapshot(parameters));
+
+  CrashParameters other_offset;
+  other_offset.crashing_offset = 0x200;
+  EXPECT_NE(CrashSignatureFromSnapshot(*MakeSnapshot(other_offset)),
+            signature);
+
+  CrashParameters other_exception;
+  other_exception.exception = 6;
+  EXPECT_NE(CrashSignatureFromSnapshot(*MakeSnapshot(other_exception)),
+            signature);
+
+  // Moving the module that the stack points into changes the offsets of the
+  // values found on the stack.
+  CrashParameters other_frames;
+  other_frames.stack_module_address = kStackModuleAddress + 0x1000;
+  EXPECT_NE(CrashSignatureFromSnapshot(*MakeSnapshot(other_frames)),
+            signature);
+}
+
+TEST(CrashSignature, FramesAreOptional) {
+  const CrashParameters parameters;
+  const std::string signature =
+      CrashSignatureFromSnapshot(*MakeSnapshot(parameters));
+
+  // Without the stack, only the crashing instruction contributes.
+  CrashParameters no_stack;
+  no_stack.thread_id = kThreadID + 1;
+  const std::string no_stack_signature =
+      CrashSignatureFromSnapshot(*MakeSnapshot(no_stack));
+  ASSERT_FALSE(no_stack_signature.empty());
+  EXPECT_NE(no_stack_signature, signature);
+  EXPECT_EQ(CrashSignatureFromSnapshot(*MakeSnapshot(parameters), 0),
+            no_stack_signature);
+}
+
+TEST(CrashSignature, NoSignature) {
+  TestProcessSnapshot no_exception;
+  EXPECT_EQ(CrashSignatureFromSnapshot(no_exception), std::string());
+
+  CrashParameters outside_module;
+  outside_module.crashing_offset = 0x10000;
+  EXPECT_EQ(CrashSignatureFromSnapshot(*MakeSnapshot(outside_module)),
+            std::string());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
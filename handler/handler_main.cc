@@ -18,12 +18,15 @@
 #include <getopt.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include <algorithm>
 #include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,6 +36,7 @@
 #include "base/files/scoped_file.h"
 #include "base/logging.h"
 #include "base/metrics/persistent_histogram_allocator.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/scoped_generic.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
@@ -43,14 +47,21 @@
 #include "client/crashpad_client.h"
 #include "client/crashpad_info.h"
 #include "client/prune_crash_reports.h"
+#include "client/settings.h"
 #include "client/simple_string_dictionary.h"
+#include "handler/capture_policy.h"
 #include "handler/crash_report_upload_thread.h"
 #include "handler/prune_crash_reports_thread.h"
+#include "handler/staged_report_commit_thread.h"
+#include "handler/resource_budget.h"
+#include "handler/statistics_writer_thread.h"
 #include "tools/tool_support.h"
 #include "util/file/file_io.h"
 #include "util/misc/address_types.h"
 #include "util/misc/metrics.h"
 #include "util/misc/paths.h"
+#include "util/misc/time.h"
+#include "util/misc/trace_event.h"
 #include "util/numeric/in_range_cast.h"
 #include "util/stdlib/map_insert.h"
 #include "util/stdlib/string_number_conversion.h"
@@ -66,6 +77,8 @@
 
 #include "handler/linux/crash_report_exception_handler.h"
 #include "handler/linux/exception_handler_server.h"
+#include "handler/linux/tenant_exception_handler.h"
+#include "util/linux/cpu_affinity.h"
 #include "util/posix/signals.h"
 #elif BUILDFLAG(IS_APPLE)
 #include <libgen.h>
@@ -82,7 +95,11 @@
 #elif BUILDFLAG(IS_WIN)
 #include <windows.h>
 
+#include <functional>
+
 #include "handler/win/crash_report_exception_handler.h"
+#include "handler/win/deferred_exception_handler.h"
+#include "util/thread/thread.h"
 #include "util/win/exception_handler_server.h"
 #include "util/win/handle.h"
 #include "util/win/initial_client_data.h"
@@ -105,17 +122,69 @@ void Usage(const base::FilePath& me) {
 "Usage: %" PRFilePath " [OPTION]...\n"
 "Crashpad's exception handler server.\n"
 "\n"
+"      --adaptive-scheduling   back off periodic database scans while idle\n"
 "      --annotation=KEY=VALUE  set a process annotation in each crash report\n"
   // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --async-acknowledgement release each client once it has been read,\n"
+"                              finishing its report in the background\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if defined(ATTACHMENTS_SUPPORTED)
       // clang-format off
 "      --attachment=FILE_PATH  attach specified file to each crash report\n"
 "                              at the time of the crash\n"
   // clang-format on
 #endif  // ATTACHMENTS_SUPPORTED
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --capture-from-va-clone\n"
+"                              read crash report memory from a clone of the\n"
+"                              client, resuming the client sooner\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --capture-policy=POLICY limit what is captured for clients matching\n"
+"                              POLICY, such as\n"
+"                              process:NAME,max-thread-stacks=COUNT\n"
+"      --capture-timeout=MILLISECONDS\n"
+"                              drop optional data from crash reports as\n"
+"                              needed to finish capture within MILLISECONDS\n"
+"      --compress-reports      store reports in the database compressed\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --database=PATH         store the crash report database at PATH\n"
   // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --delta-dumps=COUNT     write up to COUNT non-crash dumps of a process\n"
+"                              as deltas against each full dump\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --duplicate-signature-interval=SECONDS\n"
+"                              skip repeat crash uploads within SECONDS\n"
+"      --duplicate-signature-sample-rate=COUNT\n"
+"                              upload one of every COUNT skipped duplicates\n"
+  // clang-format on
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --fast-start            accept clients before opening the database\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --handler-cpus=LIST     run the handler on the CPUs in LIST, such as\n"
+"                              0-3,8, with memory from their NUMA nodes\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --handshake-fd=FD       establish communication with the client over FD\n"
@@ -146,7 +215,44 @@ void Usage(const base::FilePath& me) {
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
       // clang-format off
+"      --max-concurrent-dumps=COUNT\n"
+"                              capture up to COUNT crash reports at once\n"
+  // clang-format on
+      // clang-format off
+"      --max-concurrent-uploads=COUNT\n"
+"                              upload up to COUNT crash reports at once\n"
+  // clang-format on
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --max-handles=COUNT     record at most COUNT of the client's handles\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --max-memory=MB         reduce captures and defer uploads as the\n"
+"                              handler's resident memory nears MB\n"
+"      --max-open-files=COUNT  reduce captures and defer uploads as the\n"
+"                              handler's open files near COUNT\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --max-reports-per-upload=COUNT\n"
+"                              upload up to COUNT crash reports per request\n"
+"      --max-upload-rate=BYTES_PER_SECOND\n"
+"                              limit crash report uploads to BYTES_PER_SECOND\n"
+"      --max-upload-size=BYTES trim crash reports larger than BYTES to fit\n"
+"                              before uploading them\n"
 "      --metrics-dir=DIR       store metrics files in DIR (only in Chromium)\n"
+  // clang-format on
+#if BUILDFLAG(IS_WIN)
+      // clang-format off
+"      --minimal-capture-exception-code=CODE\n"
+"                              capture only the crashing thread, modules,\n"
+"                              and exception memory for exception CODE\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_WIN)
+      // clang-format off
 "      --monitor-self          run a second handler to catch crashes in the first\n"
 "      --monitor-self-annotation=KEY=VALUE\n"
 "                              set a module annotation in the handler\n"
@@ -170,12 +276,54 @@ void Usage(const base::FilePath& me) {
 "      --pipe-name=PIPE        communicate with the client over PIPE\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --prepare-upload-body   store each crash report's gzip upload body\n"
+"                              with it as it's written\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --prewarm-upload-connection\n"
+"                              connect to the upload server as soon as a\n"
+"                              crash report is pending\n"
+  // clang-format on
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --profile-captures      log the resources used by each phase of\n"
+"                              capturing each crash report\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --report-file-pool=COUNT\n"
+"                              keep COUNT report files created in advance\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       // clang-format off
 "      --reset-own-crash-exception-port-to-system-default\n"
 "                              reset the server's exception handler to default\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_APPLE)
+      // clang-format off
+"      --resumable-upload      upload crash reports in resumable chunks\n"
+"      --separate-attachment-uploads\n"
+"                              upload attachments after the minidump, in\n"
+"                              separate requests\n"
+"      --signature-upload-burst=COUNT\n"
+"                              rate limit uploads of each crash signature,\n"
+"                              allowing COUNT in quick succession\n"
+"      --signature-upload-interval=SECONDS\n"
+"                              allow another upload of a signature every\n"
+"                              SECONDS (default 3600)\n"
+"      --statistics-file=PATH  periodically write handler statistics to PATH\n"
+"      --statistics-interval=SECONDS\n"
+"                              rewrite the statistics file every SECONDS\n"
+"                              (default 60)\n"
+  // clang-format on
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       // clang-format off
 "      --sanitization-information=SANITIZATION_INFORMATION_ADDRESS\n"
@@ -183,12 +331,33 @@ void Usage(const base::FilePath& me) {
 "      --shared-client-connection the file descriptor provided by\n"
 "                              --initial-client-fd is shared among multiple\n"
 "                              clients\n"
+"      --staging-dir=PATH      write reports in PATH and commit them to the\n"
+"                              database in the background\n"
+"      --tenant=PATH=URL       also host the database at PATH, sending its crash\n"
+"                              reports to URL, for clients that choose it\n"
 "      --trace-parent-with-exception=EXCEPTION_INFORMATION_ADDRESS\n"
 "                              request a dump for the handler's parent process\n"
   // clang-format on
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
       // clang-format off
+"      --trace-events-file=PATH\n"
+"                              write a Chrome JSON trace of the handler's\n"
+"                              work to PATH when it exits\n"
+  // clang-format on
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-cpus=LIST      upload crash reports on the CPUs in LIST\n"
+  // clang-format on
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      // clang-format off
+"      --upload-gzip-threads=COUNT\n"
+"                              compress uploads with COUNT threads\n"
+"      --upload-order=ORDER    upload pending crash reports in ORDER: database,\n"
+"                              newest-first, or smallest-first\n"
 "      --url=URL               send crash reports to this Breakpad server URL,\n"
 "                              only if uploads are enabled for the database\n"
   // clang-format on
@@ -219,6 +388,15 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// A database hosted for clients that choose it, per --tenant.
+struct TenantOptions {
+  base::FilePath database;
+  std::string url;
+};
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 struct Options {
   std::map<std::string, std::string> annotations;
   std::map<std::string, std::string> monitor_self_annotations;
@@ -226,6 +404,17 @@ struct Options {
   base::FilePath database;
   base::FilePath metrics_dir;
   std::vector<std::string> monitor_self_arguments;
+  size_t max_concurrent_uploads;
+  size_t max_reports_per_upload;
+  uint64_t max_upload_bytes_per_second;
+  uint64_t max_upload_size;
+  uint32_t duplicate_signature_interval;
+  uint32_t duplicate_signature_sample_rate;
+  uint32_t signature_upload_burst;
+  uint32_t signature_upload_interval;
+  CrashReportUploadThread::UploadOrder upload_order;
+  size_t upload_gzip_threads;
+  size_t max_concurrent_dumps;
 #if BUILDFLAG(IS_APPLE)
   std::string mach_service;
   int handshake_fd;
@@ -234,7 +423,21 @@ struct Options {
   VMAddress exception_information_address;
   VMAddress sanitization_information_address;
   int initial_client_fd;
+  CapturePolicyTable capture_policies;
+  uint64_t capture_timeout_ns;
+  size_t delta_dumps;
+  uint64_t max_resident_bytes;
+  size_t max_open_files;
+  base::FilePath staging_dir;
+  std::vector<TenantOptions> tenants;
+  size_t report_file_pool_size;
+  bool async_acknowledgement;
+  bool compress_reports;
+  bool prepare_upload_body;
+  bool profile_captures;
   bool shared_client_connection;
+  std::vector<int> handler_cpus;
+  std::vector<int> upload_cpus;
 #if BUILDFLAG(IS_ANDROID)
   bool write_minidump_to_log;
   bool write_minidump_to_database;
@@ -242,11 +445,24 @@ struct Options {
 #elif BUILDFLAG(IS_WIN)
   std::string pipe_name;
   InitialClientData initial_client_data;
+  size_t max_handles;
+  std::set<uint32_t> minimal_capture_exception_codes;
+  bool capture_from_va_clone;
+  bool fast_start;
 #endif  // BUILDFLAG(IS_APPLE)
+  bool adaptive_scheduling;
   bool identify_client_via_url;
   bool monitor_self;
   bool periodic_tasks;
+  bool prewarm_upload_connection;
   bool rate_limit;
+  bool resumable_upload;
+  bool separate_attachment_uploads;
+  base::FilePath statistics_file;
+  unsigned int statistics_interval;
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+  base::FilePath trace_events_file;
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
   bool upload_gzip;
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
   bool use_cros_crash_reporter = false;
@@ -319,6 +535,34 @@ class CallMetricsRecordNormalExit {
   }
 };
 
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+
+// Records trace events for the lifetime of this object, and writes them to a
+// file when it is destroyed.
+class ScopedTraceLog {
+ public:
+  explicit ScopedTraceLog(const base::FilePath& path)
+      : enabled_(!path.empty()) {
+    if (enabled_) {
+      TraceLog::Get()->Start(path);
+    }
+  }
+
+  ScopedTraceLog(const ScopedTraceLog&) = delete;
+  ScopedTraceLog& operator=(const ScopedTraceLog&) = delete;
+
+  ~ScopedTraceLog() {
+    if (enabled_) {
+      TraceLog::Get()->Stop();
+    }
+  }
+
+ private:
+  bool enabled_;
+};
+
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+
 #if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
     BUILDFLAG(IS_ANDROID)
 
@@ -445,6 +689,24 @@ class TerminateHandler final : public SessionEndWatcher {
   }
 };
 
+// Runs a function on its own thread.
+class FunctionThread final : public Thread {
+ public:
+  explicit FunctionThread(std::function<void()> function)
+      : Thread(), function_(std::move(function)) {}
+
+  FunctionThread(const FunctionThread&) = delete;
+  FunctionThread& operator=(const FunctionThread&) = delete;
+
+  ~FunctionThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override { function_(); }
+
+  std::function<void()> function_;
+};
+
 void ReinstallCrashHandler() {
   // This is used to re-enable the metrics-recording crash handler after
   // MonitorSelf() sets up a Crashpad exception handler. The Crashpad handler
@@ -487,6 +749,12 @@ void MonitorSelf(const Options& options) {
   if (!options.rate_limit) {
     extra_arguments.push_back("--no-rate-limit");
   }
+  if (options.resumable_upload) {
+    extra_arguments.push_back("--resumable-upload");
+  }
+  if (options.separate_attachment_uploads) {
+    extra_arguments.push_back("--separate-attachment-uploads");
+  }
   if (!options.upload_gzip) {
     extra_arguments.push_back("--no-upload-gzip");
   }
@@ -549,6 +817,18 @@ class ScopedStoppable {
   std::unique_ptr<Stoppable> stoppable_;
 };
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// The parts of the handler that serve a tenant other than the default, per
+// --tenant. They’re stopped and destroyed in the reverse of their order here.
+struct Tenant {
+  std::unique_ptr<CrashReportDatabase> database;
+  ScopedStoppable upload_thread;
+  std::unique_ptr<CrashReportExceptionHandler> exception_handler;
+  ScopedStoppable prune_thread;
+};
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 void InitCrashpadLogging() {
   logging::LoggingSettings settings;
 #if BUILDFLAG(IS_CHROMEOS_ASH)
@@ -580,12 +860,39 @@ int HandlerMain(int argc,
   enum OptionFlags {
     // Long options without short equivalents.
     kOptionLastChar = 255,
+    kOptionAdaptiveScheduling,
     kOptionAnnotation,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionAsyncAcknowledgement,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
     BUILDFLAG(IS_ANDROID)
     kOptionAttachment,
 #endif  // BUILDFLAG(IS_WIN) || BUILDFLAG(IS_LINUX)
+#if BUILDFLAG(IS_WIN)
+    kOptionCaptureFromVaClone,
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionCapturePolicy,
+    kOptionCaptureTimeout,
+    kOptionCompressReports,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     kOptionDatabase,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionDeltaDumps,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionDuplicateSignatureInterval,
+    kOptionDuplicateSignatureSampleRate,
+#if BUILDFLAG(IS_WIN)
+    kOptionFastStart,
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionHandlerCPUs,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     kOptionHandshakeFD,
 #endif  // BUILDFLAG(IS_APPLE)
@@ -599,7 +906,23 @@ int HandlerMain(int argc,
 #if BUILDFLAG(IS_APPLE)
     kOptionMachService,
 #endif  // BUILDFLAG(IS_APPLE)
+    kOptionMaxConcurrentDumps,
+    kOptionMaxConcurrentUploads,
+#if BUILDFLAG(IS_WIN)
+    kOptionMaxHandles,
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionMaxMemory,
+    kOptionMaxOpenFiles,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionMaxReportsPerUpload,
+    kOptionMaxUploadRate,
+    kOptionMaxUploadSize,
     kOptionMetrics,
+#if BUILDFLAG(IS_WIN)
+    kOptionMinimalCaptureExceptionCode,
+#endif  // BUILDFLAG(IS_WIN)
     kOptionMonitorSelf,
     kOptionMonitorSelfAnnotation,
     kOptionMonitorSelfArgument,
@@ -613,14 +936,41 @@ int HandlerMain(int argc,
 #if BUILDFLAG(IS_WIN)
     kOptionPipeName,
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionPrepareUploadBody,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionPrewarmUploadConnection,
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionProfileCaptures,
+    kOptionReportFilePool,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     kOptionResetOwnCrashExceptionPortToSystemDefault,
 #endif  // BUILDFLAG(IS_APPLE)
+    kOptionResumableUpload,
+    kOptionSeparateAttachmentUploads,
+    kOptionSignatureUploadBurst,
+    kOptionSignatureUploadInterval,
+    kOptionStatisticsFile,
+    kOptionStatisticsInterval,
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     kOptionSanitizationInformation,
     kOptionSharedClientConnection,
+    kOptionStagingDir,
+    kOptionTenant,
     kOptionTraceParentWithException,
 #endif
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+    kOptionTraceEventsFile,
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    kOptionUploadCPUs,
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    kOptionUploadGzipThreads,
+    kOptionUploadOrder,
     kOptionURL,
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
     kOptionUseCrosCrashReporter,
@@ -637,11 +987,50 @@ int HandlerMain(int argc,
   };
 
   static constexpr option long_options[] = {
+    {"adaptive-scheduling", no_argument, nullptr, kOptionAdaptiveScheduling},
     {"annotation", required_argument, nullptr, kOptionAnnotation},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"async-acknowledgement",
+     no_argument,
+     nullptr,
+     kOptionAsyncAcknowledgement},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if defined(ATTACHMENTS_SUPPORTED)
     {"attachment", required_argument, nullptr, kOptionAttachment},
 #endif  // ATTACHMENTS_SUPPORTED
+#if BUILDFLAG(IS_WIN)
+    {"capture-from-va-clone",
+     no_argument,
+     nullptr,
+     kOptionCaptureFromVaClone},
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"capture-policy", required_argument, nullptr, kOptionCapturePolicy},
+    {"capture-timeout", required_argument, nullptr, kOptionCaptureTimeout},
+    {"compress-reports", no_argument, nullptr, kOptionCompressReports},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
     {"database", required_argument, nullptr, kOptionDatabase},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"delta-dumps", required_argument, nullptr, kOptionDeltaDumps},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"duplicate-signature-interval",
+     required_argument,
+     nullptr,
+     kOptionDuplicateSignatureInterval},
+    {"duplicate-signature-sample-rate",
+     required_argument,
+     nullptr,
+     kOptionDuplicateSignatureSampleRate},
+#if BUILDFLAG(IS_WIN)
+    {"fast-start", no_argument, nullptr, kOptionFastStart},
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"handler-cpus", required_argument, nullptr, kOptionHandlerCPUs},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     {"handshake-fd", required_argument, nullptr, kOptionHandshakeFD},
 #endif  // BUILDFLAG(IS_APPLE)
@@ -658,7 +1047,35 @@ int HandlerMain(int argc,
 #if BUILDFLAG(IS_APPLE)
     {"mach-service", required_argument, nullptr, kOptionMachService},
 #endif  // BUILDFLAG(IS_APPLE)
+    {"max-concurrent-dumps",
+     required_argument,
+     nullptr,
+     kOptionMaxConcurrentDumps},
+    {"max-concurrent-uploads",
+     required_argument,
+     nullptr,
+     kOptionMaxConcurrentUploads},
+#if BUILDFLAG(IS_WIN)
+    {"max-handles", required_argument, nullptr, kOptionMaxHandles},
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"max-memory", required_argument, nullptr, kOptionMaxMemory},
+    {"max-open-files", required_argument, nullptr, kOptionMaxOpenFiles},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"max-reports-per-upload",
+     required_argument,
+     nullptr,
+     kOptionMaxReportsPerUpload},
+    {"max-upload-rate", required_argument, nullptr, kOptionMaxUploadRate},
+    {"max-upload-size", required_argument, nullptr, kOptionMaxUploadSize},
     {"metrics-dir", required_argument, nullptr, kOptionMetrics},
+#if BUILDFLAG(IS_WIN)
+    {"minimal-capture-exception-code",
+     required_argument,
+     nullptr,
+     kOptionMinimalCaptureExceptionCode},
+#endif  // BUILDFLAG(IS_WIN)
     {"monitor-self", no_argument, nullptr, kOptionMonitorSelf},
     {"monitor-self-annotation",
      required_argument,
@@ -684,12 +1101,43 @@ int HandlerMain(int argc,
 #if BUILDFLAG(IS_WIN)
     {"pipe-name", required_argument, nullptr, kOptionPipeName},
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"prepare-upload-body", no_argument, nullptr, kOptionPrepareUploadBody},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"prewarm-upload-connection",
+     no_argument,
+     nullptr,
+     kOptionPrewarmUploadConnection},
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"profile-captures", no_argument, nullptr, kOptionProfileCaptures},
+    {"report-file-pool", required_argument, nullptr, kOptionReportFilePool},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
     {"reset-own-crash-exception-port-to-system-default",
      no_argument,
      nullptr,
      kOptionResetOwnCrashExceptionPortToSystemDefault},
 #endif  // BUILDFLAG(IS_APPLE)
+    {"resumable-upload", no_argument, nullptr, kOptionResumableUpload},
+    {"separate-attachment-uploads",
+     no_argument,
+     nullptr,
+     kOptionSeparateAttachmentUploads},
+    {"signature-upload-burst",
+     required_argument,
+     nullptr,
+     kOptionSignatureUploadBurst},
+    {"signature-upload-interval",
+     required_argument,
+     nullptr,
+     kOptionSignatureUploadInterval},
+    {"statistics-file", required_argument, nullptr, kOptionStatisticsFile},
+    {"statistics-interval",
+     required_argument,
+     nullptr,
+     kOptionStatisticsInterval},
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
     {"sanitization-information",
      required_argument,
@@ -699,12 +1147,26 @@ int HandlerMain(int argc,
      no_argument,
      nullptr,
      kOptionSharedClientConnection},
+    {"staging-dir", required_argument, nullptr, kOptionStagingDir},
+    {"tenant", required_argument, nullptr, kOptionTenant},
     {"trace-parent-with-exception",
      required_argument,
      nullptr,
      kOptionTraceParentWithException},
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+    {"trace-events-file", required_argument, nullptr, kOptionTraceEventsFile},
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    {"upload-cpus", required_argument, nullptr, kOptionUploadCPUs},
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    {"upload-gzip-threads",
+     required_argument,
+     nullptr,
+     kOptionUploadGzipThreads},
+    {"upload-order", required_argument, nullptr, kOptionUploadOrder},
     {"url", required_argument, nullptr, kOptionURL},
 #if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
     {"use-cros-crash-reporter",
@@ -730,12 +1192,32 @@ int HandlerMain(int argc,
   options.handshake_fd = -1;
 #endif
   options.identify_client_via_url = true;
+  options.max_concurrent_uploads = 1;
+  options.max_reports_per_upload = 1;
+  options.max_upload_bytes_per_second = 0;
+  options.max_upload_size = 0;
+  options.duplicate_signature_interval = 0;
+  options.duplicate_signature_sample_rate = 0;
+  options.signature_upload_burst = 0;
+  options.signature_upload_interval = 60 * 60;
+  options.upload_order = CrashReportUploadThread::UploadOrder::kDatabaseOrder;
+#if BUILDFLAG(IS_WIN)
+  options.max_concurrent_dumps = 0;
+  options.max_handles = std::numeric_limits<size_t>::max();
+#else
+  options.max_concurrent_dumps = 1;
+#endif  // BUILDFLAG(IS_WIN)
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   options.initial_client_fd = kInvalidFileHandle;
 #endif
   options.periodic_tasks = true;
+  options.prewarm_upload_connection = false;
   options.rate_limit = true;
+  options.resumable_upload = false;
+  options.separate_attachment_uploads = false;
+  options.statistics_interval = 60;
   options.upload_gzip = true;
+  options.upload_gzip_threads = 1;
 #if BUILDFLAG(IS_ANDROID)
   options.write_minidump_to_database = true;
 #endif
@@ -743,12 +1225,23 @@ int HandlerMain(int argc,
   int opt;
   while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
     switch (opt) {
+      case kOptionAdaptiveScheduling: {
+        options.adaptive_scheduling = true;
+        break;
+      }
       case kOptionAnnotation: {
         if (!AddKeyValueToMap(&options.annotations, optarg, "--annotation")) {
           return ExitFailure();
         }
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionAsyncAcknowledgement: {
+        options.async_acknowledgement = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if defined(ATTACHMENTS_SUPPORTED)
       case kOptionAttachment: {
         options.attachments.push_back(base::FilePath(
@@ -756,11 +1249,83 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // ATTACHMENTS_SUPPORTED
+#if BUILDFLAG(IS_WIN)
+      case kOptionCaptureFromVaClone: {
+        options.capture_from_va_clone = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionCapturePolicy: {
+        if (!options.capture_policies.AddPolicy(optarg)) {
+          ToolSupport::UsageHint(me, "failed to parse --capture-policy");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionCaptureTimeout: {
+        unsigned int capture_timeout_ms;
+        if (!StringToNumber(optarg, &capture_timeout_ms)) {
+          ToolSupport::UsageHint(me, "failed to parse --capture-timeout");
+          return ExitFailure();
+        }
+        options.capture_timeout_ns =
+            uint64_t{capture_timeout_ms} * kNanosecondsPerSecond / 1000;
+        break;
+      }
+      case kOptionCompressReports: {
+        options.compress_reports = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
       case kOptionDatabase: {
         options.database = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
         break;
       }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionDeltaDumps: {
+        if (!StringToNumber(optarg, &options.delta_dumps)) {
+          ToolSupport::UsageHint(me, "failed to parse --delta-dumps");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionDuplicateSignatureInterval: {
+        if (!StringToNumber(optarg, &options.duplicate_signature_interval)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --duplicate-signature-interval");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionDuplicateSignatureSampleRate: {
+        if (!StringToNumber(optarg, &options.duplicate_signature_sample_rate)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --duplicate-signature-sample-rate");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_WIN)
+      case kOptionFastStart: {
+        options.fast_start = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionHandlerCPUs: {
+        if (!ParseCPUList(optarg, &options.handler_cpus)) {
+          ToolSupport::UsageHint(me, "failed to parse --handler-cpus");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       case kOptionHandshakeFD: {
         if (!StringToNumber(optarg, &options.handshake_fd) ||
@@ -796,11 +1361,92 @@ int HandlerMain(int argc,
       }
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
         // BUILDFLAG(IS_CHROMEOS)
+      case kOptionMaxConcurrentDumps: {
+        if (!StringToNumber(optarg, &options.max_concurrent_dumps) ||
+            options.max_concurrent_dumps == 0) {
+          ToolSupport::UsageHint(me, "failed to parse --max-concurrent-dumps");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMaxConcurrentUploads: {
+        if (!StringToNumber(optarg, &options.max_concurrent_uploads) ||
+            options.max_concurrent_uploads == 0) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --max-concurrent-uploads");
+          return ExitFailure();
+        }
+        break;
+      }
+#if BUILDFLAG(IS_WIN)
+      case kOptionMaxHandles: {
+        if (!StringToNumber(optarg, &options.max_handles)) {
+          ToolSupport::UsageHint(me, "failed to parse --max-handles");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionMaxMemory: {
+        uint64_t max_memory_mb;
+        if (!StringToNumber(optarg, &max_memory_mb) ||
+            max_memory_mb > std::numeric_limits<uint64_t>::max() >> 20) {
+          ToolSupport::UsageHint(me, "failed to parse --max-memory");
+          return ExitFailure();
+        }
+        options.max_resident_bytes = max_memory_mb << 20;
+        break;
+      }
+      case kOptionMaxOpenFiles: {
+        if (!StringToNumber(optarg, &options.max_open_files)) {
+          ToolSupport::UsageHint(me, "failed to parse --max-open-files");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionMaxReportsPerUpload: {
+        if (!StringToNumber(optarg, &options.max_reports_per_upload) ||
+            options.max_reports_per_upload == 0) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --max-reports-per-upload");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMaxUploadRate: {
+        if (!StringToNumber(optarg, &options.max_upload_bytes_per_second)) {
+          ToolSupport::UsageHint(me, "failed to parse --max-upload-rate");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionMaxUploadSize: {
+        if (!StringToNumber(optarg, &options.max_upload_size)) {
+          ToolSupport::UsageHint(me, "failed to parse --max-upload-size");
+          return ExitFailure();
+        }
+        break;
+      }
       case kOptionMetrics: {
         options.metrics_dir = base::FilePath(
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
         break;
       }
+#if BUILDFLAG(IS_WIN)
+      case kOptionMinimalCaptureExceptionCode: {
+        uint32_t exception_code;
+        if (!StringToNumber(optarg, &exception_code)) {
+          ToolSupport::UsageHint(
+              me, "failed to parse --minimal-capture-exception-code");
+          return ExitFailure();
+        }
+        options.minimal_capture_exception_codes.insert(exception_code);
+        break;
+      }
+#endif  // BUILDFLAG(IS_WIN)
       case kOptionMonitorSelf: {
         options.monitor_self = true;
         break;
@@ -845,12 +1491,75 @@ int HandlerMain(int argc,
         break;
       }
 #endif  // BUILDFLAG(IS_WIN)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionPrepareUploadBody: {
+        options.prepare_upload_body = true;
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionPrewarmUploadConnection: {
+        options.prewarm_upload_connection = true;
+        break;
+      }
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionProfileCaptures: {
+        options.profile_captures = true;
+        break;
+      }
+      case kOptionReportFilePool: {
+        if (!StringToNumber(optarg, &options.report_file_pool_size)) {
+          ToolSupport::UsageHint(me, "failed to parse --report-file-pool");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_APPLE)
       case kOptionResetOwnCrashExceptionPortToSystemDefault: {
         options.reset_own_crash_exception_port_to_system_default = true;
         break;
       }
 #endif  // BUILDFLAG(IS_APPLE)
+      case kOptionResumableUpload: {
+        options.resumable_upload = true;
+        break;
+      }
+      case kOptionSeparateAttachmentUploads: {
+        options.separate_attachment_uploads = true;
+        break;
+      }
+      case kOptionSignatureUploadBurst: {
+        if (!StringToNumber(optarg, &options.signature_upload_burst)) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --signature-upload-burst");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionSignatureUploadInterval: {
+        if (!StringToNumber(optarg, &options.signature_upload_interval) ||
+            options.signature_upload_interval == 0) {
+          ToolSupport::UsageHint(me,
+                                 "failed to parse --signature-upload-interval");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionStatisticsFile: {
+        options.statistics_file = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionStatisticsInterval: {
+        if (!StringToNumber(optarg, &options.statistics_interval) ||
+            options.statistics_interval == 0) {
+          ToolSupport::UsageHint(me, "failed to parse --statistics-interval");
+          return ExitFailure();
+        }
+        break;
+      }
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
       case kOptionSanitizationInformation: {
         if (!StringToNumber(optarg,
@@ -865,6 +1574,23 @@ int HandlerMain(int argc,
         options.shared_client_connection = true;
         break;
       }
+      case kOptionStagingDir: {
+        options.staging_dir = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+      case kOptionTenant: {
+        std::string database;
+        TenantOptions tenant;
+        if (!SplitStringFirst(optarg, '=', &database, &tenant.url)) {
+          ToolSupport::UsageHint(me, "--tenant requires PATH=URL");
+          return ExitFailure();
+        }
+        tenant.database = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(database));
+        options.tenants.push_back(tenant);
+        break;
+      }
       case kOptionTraceParentWithException: {
         if (!StringToNumber(optarg, &options.exception_information_address)) {
           ToolSupport::UsageHint(
@@ -875,6 +1601,56 @@ int HandlerMain(int argc,
       }
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+      case kOptionTraceEventsFile: {
+        options.trace_events_file = base::FilePath(
+            ToolSupport::CommandLineArgumentToFilePathStringType(optarg));
+        break;
+      }
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      case kOptionUploadCPUs: {
+        if (!ParseCPUList(optarg, &options.upload_cpus)) {
+          ToolSupport::UsageHint(me, "failed to parse --upload-cpus");
+          return ExitFailure();
+        }
+        break;
+      }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      case kOptionUploadGzipThreads: {
+        if (!StringToNumber(optarg, &options.upload_gzip_threads) ||
+            options.upload_gzip_threads == 0) {
+          ToolSupport::UsageHint(me, "failed to parse --upload-gzip-threads");
+          return ExitFailure();
+        }
+        break;
+      }
+      case kOptionUploadOrder: {
+        static constexpr struct {
+          const char* name;
+          CrashReportUploadThread::UploadOrder order;
+        } kUploadOrders[] = {
+            {"database", CrashReportUploadThread::UploadOrder::kDatabaseOrder},
+            {"newest-first",
+             CrashReportUploadThread::UploadOrder::kNewestFirst},
+            {"smallest-first",
+             CrashReportUploadThread::UploadOrder::kSmallestFirst},
+        };
+        bool found = false;
+        for (const auto& upload_order : kUploadOrders) {
+          if (strcmp(optarg, upload_order.name) == 0) {
+            options.upload_order = upload_order.order;
+            found = true;
+            break;
+          }
+        }
+        if (!found) {
+          ToolSupport::UsageHint(me, "failed to parse --upload-order");
+          return ExitFailure();
+        }
+        break;
+      }
       case kOptionURL: {
         options.url = optarg;
         break;
@@ -960,6 +1736,11 @@ int HandlerMain(int argc,
         me, "--shared-client-connection requires --initial-client-fd");
     return ExitFailure();
   }
+  if (options.report_file_pool_size && !options.staging_dir.empty()) {
+    ToolSupport::UsageHint(
+        me, "--report-file-pool and --staging-dir are incompatible");
+    return ExitFailure();
+  }
 #if BUILDFLAG(IS_ANDROID)
   if (!options.write_minidump_to_log && !options.write_minidump_to_database) {
     ToolSupport::UsageHint(me,
@@ -980,6 +1761,16 @@ int HandlerMain(int argc,
     return ExitFailure();
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Every thread that the handler starts inherits this, so this must be done
+  // before any are started.
+  if (!options.handler_cpus.empty() &&
+      !SetCurrentThreadCPUAffinity(options.handler_cpus)) {
+    return ExitFailure();
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 #if BUILDFLAG(IS_APPLE)
   if (options.reset_own_crash_exception_port_to_system_default) {
     CrashpadClient::UseSystemDefaultHandler();
@@ -1010,82 +1801,321 @@ int HandlerMain(int argc,
     }
   }
 
-  std::unique_ptr<CrashReportDatabase> database(
-      CrashReportDatabase::Initialize(options.database));
-  if (!database) {
-    return ExitFailure();
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+  // Declared before the threads that record events, so that the trace is
+  // written after they have stopped.
+  ScopedTraceLog trace_log(options.trace_events_file);
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+
+  // Shared by captures and uploads, and so declared to outlive both.
+  std::unique_ptr<ResourceBudget> resource_budget;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (options.max_resident_bytes || options.max_open_files) {
+    resource_budget = std::make_unique<ResourceBudget>(
+        options.max_resident_bytes, options.max_open_files);
   }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
-  ScopedStoppable upload_thread;
-  if (!options.url.empty()) {
-    // TODO(scottmg): options.rate_limit should be removed when we have a
-    // configurable database setting to control upload limiting.
-    // See https://crashpad.chromium.org/bug/23.
-    CrashReportUploadThread::Options upload_thread_options;
-    upload_thread_options.identify_client_via_url =
-        options.identify_client_via_url;
-    upload_thread_options.rate_limit = options.rate_limit;
-    upload_thread_options.upload_gzip = options.upload_gzip;
-    upload_thread_options.watch_pending_reports = options.periodic_tasks;
-
-    upload_thread.Reset(new CrashReportUploadThread(
-        database.get(),
-        options.url,
-        upload_thread_options,
-        CrashReportUploadThread::ProcessPendingReportsObservationCallback()));
-    upload_thread.Get()->Start();
+  // Uploads for every tenant share a pool of --max-concurrent-uploads slots.
+  std::unique_ptr<Semaphore> upload_pool;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (!options.tenants.empty()) {
+    upload_pool = std::make_unique<Semaphore>(
+        base::checked_cast<int>(options.max_concurrent_uploads));
   }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
+  // Every tenant’s upload thread is configured alike, apart from its URL.
+  //
+  // TODO(scottmg): options.rate_limit should be removed when we have a
+  // configurable database setting to control upload limiting.
+  // See https://crashpad.chromium.org/bug/23.
+  CrashReportUploadThread::Options upload_thread_options;
+  upload_thread_options.identify_client_via_url =
+      options.identify_client_via_url;
+  upload_thread_options.rate_limit = options.rate_limit;
+  upload_thread_options.upload_gzip = options.upload_gzip;
+  upload_thread_options.upload_gzip_threads = options.upload_gzip_threads;
+  upload_thread_options.resumable_upload = options.resumable_upload;
+  upload_thread_options.separate_attachment_uploads =
+      options.separate_attachment_uploads;
+  upload_thread_options.prewarm_connection = options.prewarm_upload_connection;
+  upload_thread_options.upload_order = options.upload_order;
+  upload_thread_options.max_upload_bytes_per_second =
+      options.max_upload_bytes_per_second;
+  upload_thread_options.max_upload_size = options.max_upload_size;
+  upload_thread_options.max_reports_per_upload = options.max_reports_per_upload;
+  upload_thread_options.duplicate_signature_interval =
+      options.duplicate_signature_interval;
+  upload_thread_options.duplicate_signature_sample_rate =
+      options.duplicate_signature_sample_rate;
+  upload_thread_options.signature_upload_burst = options.signature_upload_burst;
+  upload_thread_options.signature_upload_interval =
+      options.signature_upload_interval;
+  upload_thread_options.signature_upload_limits_path =
+      options.database.Append(FILE_PATH_LITERAL("upload_rate_limits.dat"));
+  upload_thread_options.watch_pending_reports = options.periodic_tasks;
+  upload_thread_options.adaptive_scheduling = options.adaptive_scheduling;
+  upload_thread_options.max_concurrent_uploads = options.max_concurrent_uploads;
+  upload_thread_options.resource_budget = resource_budget.get();
+  upload_thread_options.upload_pool = upload_pool.get();
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  upload_thread_options.cpus = options.upload_cpus;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  std::unique_ptr<CrashReportDatabase> database;
+  ScopedStoppable upload_thread;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  ScopedStoppable staged_report_commit_thread;
   std::unique_ptr<ExceptionHandlerServer::Delegate> exception_handler;
 #else
   std::unique_ptr<CrashReportExceptionHandler> exception_handler;
 #endif
 
-#if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
-  if (options.use_cros_crash_reporter) {
-    auto cros_handler = std::make_unique<CrosCrashReportExceptionHandler>(
-        database.get(),
-        &options.annotations,
-        user_stream_sources);
+  ScopedStoppable prune_thread;
+  ScopedStoppable statistics_thread;
+
+  // Opens the database and creates the exception handler and the upload thread
+  // that use it. With --fast-start, this runs on a background thread while the
+  // exception handler server is already accepting clients.
+  const auto initialize_database = [&]() -> bool {
+    database = CrashReportDatabase::Initialize(options.database);
+    if (!database) {
+      return false;
+    }
 
-    if (!options.minidump_dir_for_tests.empty()) {
-      cros_handler->SetDumpDir(options.minidump_dir_for_tests);
+    // The handler consults the settings for every report it writes or uploads.
+    // Cache them rather than reading the settings file each time. Likewise,
+    // the upload thread changes the state of every report it uploads, so
+    // write those changes to the report index together.
+    database->GetSettings()->EnableCaching();
+    database->EnableDeferredIndexUpdates();
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    database->SetCompressNewReports(options.compress_reports);
+    if (options.report_file_pool_size) {
+      database->FillReportFilePool(options.report_file_pool_size, 0);
     }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
-    if (options.always_allow_feedback) {
-      cros_handler->SetAlwaysAllowFeedback();
+    if (!options.url.empty()) {
+      upload_thread.Reset(new CrashReportUploadThread(
+          database.get(),
+          options.url,
+          upload_thread_options,
+          CrashReportUploadThread::ProcessPendingReportsObservationCallback()));
+      upload_thread.Get()->Start();
     }
 
-    exception_handler = std::move(cros_handler);
-  } else {
-    exception_handler = std::make_unique<CrashReportExceptionHandler>(
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    // Staging is only an optimization, so reports are written to the database
+    // directly if the staging directory can’t be used. Otherwise, starting the
+    // commit thread commits any reports left staged by an earlier handler.
+    if (!options.staging_dir.empty()) {
+      if (database->SetStagingDirectory(options.staging_dir)) {
+        staged_report_commit_thread.Reset(new StagedReportCommitThread(
+            database.get(),
+            static_cast<CrashReportUploadThread*>(upload_thread.Get())));
+        staged_report_commit_thread.Get()->Start();
+      } else {
+        LOG(WARNING) << "staging directory unavailable, writing to database";
+      }
+    }
+    auto* const commit_thread = static_cast<StagedReportCommitThread*>(
+        staged_report_commit_thread.Get());
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+    if (options.use_cros_crash_reporter) {
+      auto cros_handler = std::make_unique<CrosCrashReportExceptionHandler>(
+          database.get(),
+          &options.annotations,
+          user_stream_sources);
+
+      if (!options.minidump_dir_for_tests.empty()) {
+        cros_handler->SetDumpDir(options.minidump_dir_for_tests);
+      }
+
+      if (options.always_allow_feedback) {
+        cros_handler->SetAlwaysAllowFeedback();
+      }
+
+      cros_handler->SetCaptureTimeout(options.capture_timeout_ns);
+      cros_handler->SetCapturePolicies(&options.capture_policies);
+      cros_handler->SetResourceBudget(resource_budget.get());
+
+      exception_handler = std::move(cros_handler);
+    } else {
+      auto crash_handler = std::make_unique<CrashReportExceptionHandler>(
+          database.get(),
+          static_cast<CrashReportUploadThread*>(upload_thread.Get()),
+          &options.annotations,
+          &options.attachments,
+          true,
+          false,
+          user_stream_sources);
+      crash_handler->SetCaptureTimeout(options.capture_timeout_ns);
+      crash_handler->SetCapturePolicies(&options.capture_policies);
+      crash_handler->SetResourceBudget(resource_budget.get());
+      crash_handler->SetReportFilePoolSize(options.report_file_pool_size);
+      crash_handler->SetStagedReportCommitThread(commit_thread);
+      crash_handler->SetDeltaDumps(options.delta_dumps);
+      crash_handler->SetPrepareUploadBody(options.prepare_upload_body);
+      crash_handler->SetCaptureProfiling(options.profile_captures);
+      crash_handler->SetAsyncAcknowledgement(options.async_acknowledgement);
+      exception_handler = std::move(crash_handler);
+    }
+#else
+    auto crash_handler = std::make_unique<CrashReportExceptionHandler>(
         database.get(),
         static_cast<CrashReportUploadThread*>(upload_thread.Get()),
         &options.annotations,
-        &options.attachments,
-        true,
-        false,
-        user_stream_sources);
-  }
-#else
-  exception_handler = std::make_unique<CrashReportExceptionHandler>(
-      database.get(),
-      static_cast<CrashReportUploadThread*>(upload_thread.Get()),
-      &options.annotations,
 #if defined(ATTACHMENTS_SUPPORTED)
-      &options.attachments,
+        &options.attachments,
 #endif  // ATTACHMENTS_SUPPORTED
 #if BUILDFLAG(IS_ANDROID)
-      options.write_minidump_to_database,
-      options.write_minidump_to_log,
+        options.write_minidump_to_database,
+        options.write_minidump_to_log,
 #endif  // BUILDFLAG(IS_ANDROID)
 #if BUILDFLAG(IS_LINUX)
-      true,
-      false,
+        true,
+        false,
 #endif  // BUILDFLAG(IS_LINUX)
-      user_stream_sources);
+        user_stream_sources);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    crash_handler->SetCaptureTimeout(options.capture_timeout_ns);
+    crash_handler->SetCapturePolicies(&options.capture_policies);
+    crash_handler->SetResourceBudget(resource_budget.get());
+    crash_handler->SetReportFilePoolSize(options.report_file_pool_size);
+    crash_handler->SetStagedReportCommitThread(commit_thread);
+    crash_handler->SetDeltaDumps(options.delta_dumps);
+    crash_handler->SetPrepareUploadBody(options.prepare_upload_body);
+    crash_handler->SetCaptureProfiling(options.profile_captures);
+    crash_handler->SetAsyncAcknowledgement(options.async_acknowledgement);
+#elif BUILDFLAG(IS_WIN)
+    crash_handler->SetCaptureFromVaClone(options.capture_from_va_clone);
+    crash_handler->SetMaxHandles(options.max_handles);
+    crash_handler->SetMinimalCaptureExceptionCodes(
+        options.minimal_capture_exception_codes);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+    exception_handler = std::move(crash_handler);
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH) || BUILDFLAG(IS_CHROMEOS_LACROS)
+    return true;
+  };
+
+  // Starts the threads that prune the database and write the statistics file.
+  // This must follow a successful call to initialize_database().
+  const auto start_database_threads = [&]() {
+    if (options.periodic_tasks) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+      // The generic database tracks report sizes in its index, so the size
+      // can be checked often enough to prune as soon as the default limit is
+      // passed.
+      prune_thread.Reset(new PruneCrashReportThread(
+          database.get(),
+          PruneCondition::GetDefault(),
+          uint64_t{PruneCondition::kDefaultMaxDatabaseSizeInKB} * 1024,
+          options.adaptive_scheduling));
+#else
+      prune_thread.Reset(new PruneCrashReportThread(
+          database.get(), PruneCondition::GetDefault()));
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+      prune_thread.Get()->Start();
+    }
+    if (!options.statistics_file.empty()) {
+      statistics_thread.Reset(
+          new StatisticsWriterThread(database.get(),
+                                     options.statistics_file,
+                                     options.statistics_interval));
+      statistics_thread.Get()->Start();
+    }
+  };
+
+#if BUILDFLAG(IS_WIN)
+  const bool initialize_in_background = options.fast_start;
+#else
+  constexpr bool initialize_in_background = false;
+#endif  // BUILDFLAG(IS_WIN)
+  if (!initialize_in_background && !initialize_database()) {
+    return ExitFailure();
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Each additional tenant has its own database, upload thread, and exception
+  // handler. The exception handler server, and so its dump threads, the
+  // resource budget, and the upload pool are shared with the default tenant.
+  std::vector<std::unique_ptr<Tenant>> tenants;
+  TenantExceptionHandler tenant_exception_handler;
+  if (!options.tenants.empty()) {
+    tenant_exception_handler.AddTenant(exception_handler.get());
+  }
+  for (const TenantOptions& tenant_options : options.tenants) {
+    auto tenant = std::make_unique<Tenant>();
+    tenant->database = CrashReportDatabase::Initialize(tenant_options.database);
+    if (!tenant->database) {
+      return ExitFailure();
+    }
+    tenant->database->GetSettings()->EnableCaching();
+    tenant->database->EnableDeferredIndexUpdates();
+    tenant->database->SetCompressNewReports(options.compress_reports);
+    if (options.report_file_pool_size) {
+      tenant->database->FillReportFilePool(options.report_file_pool_size, 0);
+    }
+
+    if (!tenant_options.url.empty()) {
+      tenant->upload_thread.Reset(new CrashReportUploadThread(
+          tenant->database.get(),
+          tenant_options.url,
+          upload_thread_options,
+          CrashReportUploadThread::ProcessPendingReportsObservationCallback()));
+      tenant->upload_thread.Get()->Start();
+    }
+
+    tenant->exception_handler = std::make_unique<CrashReportExceptionHandler>(
+        tenant->database.get(),
+        static_cast<CrashReportUploadThread*>(tenant->upload_thread.Get()),
+        &options.annotations,
+        &options.attachments,
+#if BUILDFLAG(IS_ANDROID)
+        options.write_minidump_to_database,
+        options.write_minidump_to_log,
+#else
+        true,
+        false,
+#endif  // BUILDFLAG(IS_ANDROID)
+        user_stream_sources);
+    tenant->exception_handler->SetCaptureTimeout(options.capture_timeout_ns);
+    tenant->exception_handler->SetCapturePolicies(&options.capture_policies);
+    tenant->exception_handler->SetResourceBudget(resource_budget.get());
+    tenant->exception_handler->SetReportFilePoolSize(
+        options.report_file_pool_size);
+    tenant->exception_handler->SetDeltaDumps(options.delta_dumps);
+    tenant->exception_handler->SetPrepareUploadBody(
+        options.prepare_upload_body);
+    tenant->exception_handler->SetCaptureProfiling(options.profile_captures);
+    tenant->exception_handler->SetAsyncAcknowledgement(
+        options.async_acknowledgement);
+    tenant_exception_handler.AddTenant(tenant->exception_handler.get());
+
+    if (options.periodic_tasks) {
+      tenant->prune_thread.Reset(new PruneCrashReportThread(
+          tenant->database.get(),
+          PruneCondition::GetDefault(),
+          uint64_t{PruneCondition::kDefaultMaxDatabaseSizeInKB} * 1024,
+          options.adaptive_scheduling));
+      tenant->prune_thread.Get()->Start();
+    }
+
+    tenants.push_back(std::move(tenant));
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   if (options.exception_information_address) {
@@ -1100,11 +2130,8 @@ int HandlerMain(int argc,
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
 
-  ScopedStoppable prune_thread;
-  if (options.periodic_tasks) {
-    prune_thread.Reset(new PruneCrashReportThread(
-        database.get(), PruneCondition::GetDefault()));
-    prune_thread.Get()->Start();
+  if (!initialize_in_background) {
+    start_database_threads();
   }
 
 #if BUILDFLAG(IS_APPLE)
@@ -1130,6 +2157,7 @@ int HandlerMain(int argc,
 
   ExceptionHandlerServer exception_handler_server(
       std::move(receive_right), !options.mach_service.empty());
+  exception_handler_server.SetMaxConcurrentDumps(options.max_concurrent_dumps);
   base::AutoReset<ExceptionHandlerServer*> reset_g_exception_handler_server(
       &g_exception_handler_server, &exception_handler_server);
 
@@ -1160,8 +2188,10 @@ int HandlerMain(int argc,
   if (!options.pipe_name.empty()) {
     exception_handler_server.SetPipeName(base::UTF8ToWide(options.pipe_name));
   }
+  exception_handler_server.SetMaxConcurrentDumps(options.max_concurrent_dumps);
 #elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   ExceptionHandlerServer exception_handler_server;
+  exception_handler_server.SetMaxConcurrentDumps(options.max_concurrent_dumps);
 #endif  // BUILDFLAG(IS_APPLE)
 
   base::GlobalHistogramAllocator* histogram_allocator = nullptr;
@@ -1178,20 +2208,63 @@ int HandlerMain(int argc,
   Metrics::HandlerLifetimeMilestone(Metrics::LifetimeMilestone::kStarted);
 
 #if BUILDFLAG(IS_WIN)
+  // With --fast-start, clients are accepted right away and their exceptions
+  // wait in deferred_exception_handler until the database has been opened on
+  // initialization_thread. If that fails, the server is stopped, and the
+  // handler exits as it would have without --fast-start.
+  ExceptionHandlerServer::Delegate* delegate = exception_handler.get();
+  DeferredExceptionHandler deferred_exception_handler;
+  std::unique_ptr<FunctionThread> initialization_thread;
+  std::atomic<bool> initialization_failed(false);
+  if (initialize_in_background) {
+    delegate = &deferred_exception_handler;
+    initialization_thread = std::make_unique<FunctionThread>([&]() {
+      if (!initialize_database()) {
+        initialization_failed = true;
+        deferred_exception_handler.SetDelegate(nullptr);
+        exception_handler_server.Stop();
+        return;
+      }
+      start_database_threads();
+      deferred_exception_handler.SetDelegate(exception_handler.get());
+    });
+    initialization_thread->Start();
+  }
+
   if (options.initial_client_data.IsValid()) {
     exception_handler_server.InitializeWithInheritedDataForInitialClient(
-        options.initial_client_data, exception_handler.get());
+        options.initial_client_data, delegate);
   }
-#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+  exception_handler_server.Run(delegate);
+
+  if (initialization_thread) {
+    initialization_thread->Join();
+    if (initialization_failed) {
+      return ExitFailure();
+    }
+  }
+#else
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   if (options.initial_client_fd == kInvalidFileHandle ||
       !exception_handler_server.InitializeWithClient(
           ScopedFileHandle(options.initial_client_fd),
           options.shared_client_connection)) {
     return ExitFailure();
   }
-#endif  // BUILDFLAG(IS_WIN)
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (!tenants.empty()) {
+    exception_handler_server.Run(&tenant_exception_handler);
+    return EXIT_SUCCESS;
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
 
   exception_handler_server.Run(exception_handler.get());
+#endif  // BUILDFLAG(IS_WIN)
 
   return EXIT_SUCCESS;
 }
@@ -14,30 +14,222 @@
 
 #include "handler/linux/capture_snapshot.h"
 
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "client/compressed_annotation.h"
+#include "handler/crash_signature.h"
+#include "minidump/minidump_capture_timing_writer.h"
 #include "snapshot/crashpad_info_client_options.h"
 #include "snapshot/sanitized/sanitization_information.h"
+#include "snapshot/thread_filter.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
+#include "util/misc/time.h"
 #include "util/misc/tri_state.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
 
 namespace crashpad {
 
+namespace {
+
+constexpr char kCapturePolicyAnnotationKey[] = "crashpad_capture_policy";
+
+// Set to kLightweightReportType in lightweight reports, so that they can be
+// told apart from full ones.
+constexpr char kReportTypeAnnotationKey[] = "crashpad_report_type";
+constexpr char kLightweightReportType[] = "lightweight";
+
+// A client annotation listing the IDs of threads, separated by commas, to keep
+// when a capture policy selects threads.
+constexpr char kCaptureThreadIDsAnnotationKey[] = "crashpad_capture_thread_ids";
+
+// When stacks are sanitized and the client’s memory can be read concurrently,
+// the number of threads that sanitize stacks ahead of the minidump writer, and
+// the most bytes of sanitized stacks that they may hold for it.
+constexpr size_t kSanitizationPipelineThreads = 2;
+constexpr size_t kSanitizationPipelineBufferBytes = 8 * 1024 * 1024;
+
+// Returns the simple and string annotations of the modules in modules.
+std::map<std::string, std::string> ReadStringAnnotations(
+    const std::vector<const ModuleSnapshot*>& modules) {
+  std::map<std::string, std::string> annotations;
+  for (const ModuleSnapshot* module : modules) {
+    for (const auto& kv : module->AnnotationsSimpleMap()) {
+      annotations.insert(kv);
+    }
+    for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
+      std::string value;
+      if (!ReadStringAnnotationValue(annotation.type,
+                                     annotation.value.data(),
+                                     annotation.value.size(),
+                                     &value)) {
+        continue;
+      }
+      annotations.emplace(annotation.name, value);
+    }
+  }
+  return annotations;
+}
+
+// Returns the first policy in table that matches the client whose modules are
+// listed in modules. If the modules' annotations had to be read to decide,
+// they're stored in annotations.
+const CapturePolicy* FindCapturePolicy(
+    const CapturePolicyTable& table,
+    const std::vector<const ModuleSnapshot*>& modules,
+    std::optional<std::map<std::string, std::string>>* annotations) {
+  std::string process_name;
+  for (const ModuleSnapshot* module : modules) {
+    if (module->GetModuleType() == ModuleSnapshot::kModuleTypeExecutable) {
+      process_name = base::FilePath(module->Name()).BaseName().value();
+      break;
+    }
+  }
+
+  // Reading annotations costs a pass over every module, so it's only done if a
+  // policy needs them.
+  if (table.HasAnnotationSelectors()) {
+    *annotations = ReadStringAnnotations(modules);
+    return table.Find(process_name, **annotations);
+  }
+  return table.Find(process_name, {});
+}
+
+// Builds the thread filter for policy, adding the thread IDs that the client
+// listed in its kCaptureThreadIDsAnnotationKey annotation.
+ThreadFilter BuildThreadFilter(
+    const CapturePolicy& policy,
+    const std::map<std::string, std::string>& annotations) {
+  ThreadFilter filter;
+  filter.max_other_threads = policy.max_other_threads.value_or(0);
+  filter.name_patterns = policy.thread_name_patterns;
+
+  const auto thread_ids = annotations.find(kCaptureThreadIDsAnnotationKey);
+  if (thread_ids != annotations.end()) {
+    for (const std::string& thread_id : SplitString(thread_ids->second, ',')) {
+      uint64_t value;
+      if (StringToNumber(thread_id, &value)) {
+        filter.thread_ids.insert(value);
+      } else {
+        LOG(WARNING) << "invalid thread ID " << thread_id;
+      }
+    }
+  }
+  return filter;
+}
+
+// Applies policy to snapshot, only ever narrowing the handler-wide settings
+// that were already set on it.
+void ApplyCapturePolicy(
+    const CapturePolicy& policy,
+    const std::vector<const ModuleSnapshot*>& modules,
+    const std::optional<std::map<std::string, std::string>>& annotations,
+    uint64_t capture_start_ns,
+                        uint64_t capture_deadline,
+                        size_t indirect_memory_depth,
+                        ProcessSnapshotLinux* snapshot) {
+  if (policy.max_thread_stacks) {
+    snapshot->SetMaxThreadStacks(*policy.max_thread_stacks);
+  }
+  if (policy.max_indirect_bytes) {
+    snapshot->SetIndirectMemoryLimit(*policy.max_indirect_bytes);
+  }
+  if (policy.indirect_memory_depth) {
+    snapshot->SetIndirectMemoryDepth(
+        std::min(indirect_memory_depth, *policy.indirect_memory_depth));
+  }
+  if (policy.capture_timeout_ms) {
+    const uint64_t policy_deadline =
+        capture_start_ns +
+        *policy.capture_timeout_ms * kNanosecondsPerSecond / 1000;
+    snapshot->SetCaptureDeadline(
+        capture_deadline ? std::min(capture_deadline, policy_deadline)
+                         : policy_deadline);
+  }
+  if (policy.trim_stacks) {
+    snapshot->SetStackTrimming(true);
+  }
+  if (policy.SelectsThreads()) {
+    snapshot->SetThreadFilter(BuildThreadFilter(
+        policy, annotations ? *annotations : ReadStringAnnotations(modules)));
+  }
+}
+
+}  // namespace
+
 bool CaptureSnapshot(
     PtraceConnection* connection,
     const ExceptionHandlerProtocol::ClientInformation& info,
+    bool capture_exception,
     const std::map<std::string, std::string>& process_annotations,
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
+    const SharedCrashContext* shared_context,
+    uint64_t capture_deadline,
+    ElfImageCache* elf_image_cache,
+    ModuleListCache* module_list_cache,
+    bool trim_stacks,
+    size_t indirect_memory_depth,
+    bool elide_module_code,
+    bool skip_unpopulated_memory,
+    bool profile,
+    const CapturePolicyTable* capture_policies,
     std::unique_ptr<ProcessSnapshotLinux>* snapshot,
     std::unique_ptr<ProcessSnapshotSanitized>* sanitized_snapshot) {
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot(
       new ProcessSnapshotLinux());
+  process_snapshot->Timings()->SetProfiling(profile);
+  process_snapshot->SetCaptureDeadline(capture_deadline);
+  process_snapshot->SetElfImageCache(elf_image_cache);
+  process_snapshot->SetModuleListCache(module_list_cache);
+  process_snapshot->SetStackTrimming(trim_stacks);
+  process_snapshot->SetIndirectMemoryDepth(indirect_memory_depth);
+  process_snapshot->SetModuleCodeElision(elide_module_code);
+  if (info.lightweight == ExceptionHandlerProtocol::kBoolTrue) {
+    process_snapshot->SetLightweightCapture(info.annotation_list_address,
+                                            info.annotation_generation);
+  }
+  const CapturePolicy* capture_policy = nullptr;
+  if (capture_policies && !capture_policies->empty()) {
+    const uint64_t capture_start_ns = ClockMonotonicNanoseconds();
+    process_snapshot->SetModulesReadyCallback(
+        [capture_policies,
+         capture_start_ns,
+         capture_deadline,
+         indirect_memory_depth,
+         &capture_policy](ProcessSnapshotLinux* snapshot,
+                          const std::vector<const ModuleSnapshot*>& modules) {
+          std::optional<std::map<std::string, std::string>> annotations;
+          capture_policy =
+              FindCapturePolicy(*capture_policies, modules, &annotations);
+          if (capture_policy) {
+            ApplyCapturePolicy(*capture_policy,
+                               modules,
+                               annotations,
+                               capture_start_ns,
+                               capture_deadline,
+                               indirect_memory_depth,
+                               snapshot);
+          }
+        });
+  }
   if (!process_snapshot->Initialize(connection)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return false;
   }
+  if (skip_unpopulated_memory) {
+    process_snapshot->SetSkipUnpopulatedMemory(true);
+  }
 
   pid_t local_requesting_thread_id = -1;
   if (requesting_thread_stack_address) {
@@ -49,14 +241,18 @@ bool CaptureSnapshot(
     *requesting_thread_id = local_requesting_thread_id;
   }
 
-  if (!process_snapshot->InitializeException(info.exception_information_address,
-                                             local_requesting_thread_id)) {
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kExceptionInitializationFailed);
-    return false;
-  }
+  if (capture_exception) {
+    if (!process_snapshot->InitializeException(
+            info.exception_information_address,
+            local_requesting_thread_id,
+            shared_context)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kExceptionInitializationFailed);
+      return false;
+    }
 
-  Metrics::ExceptionCode(process_snapshot->Exception()->Exception());
+    Metrics::ExceptionCode(process_snapshot->Exception()->Exception());
+  }
 
   CrashpadInfoClientOptions client_options;
   process_snapshot->GetCrashpadOptions(&client_options);
@@ -67,8 +263,26 @@ bool CaptureSnapshot(
   for (auto& p : process_annotations) {
     process_snapshot->AddAnnotation(p.first, p.second);
   }
+  if (capture_policy) {
+    process_snapshot->AddAnnotation(kCapturePolicyAnnotationKey,
+                                    capture_policy->description);
+  }
+  if (process_snapshot->IsLightweightCapture()) {
+    process_snapshot->AddAnnotation(kReportTypeAnnotationKey,
+                                    kLightweightReportType);
+  }
+  if (process_annotations.find(kCrashSignatureAnnotationKey) ==
+      process_annotations.end()) {
+    const std::string signature = CrashSignatureFromSnapshot(*process_snapshot);
+    if (!signature.empty()) {
+      process_snapshot->AddAnnotation(kCrashSignatureAnnotationKey, signature);
+    }
+  }
 
   if (info.sanitization_information_address) {
+    ScopedCapturePhase capture_phase(process_snapshot->Timings(),
+                                     CapturePhase::kSanitization,
+                                     connection->Memory());
     SanitizationInformation sanitization_info;
     ProcessMemoryRange range;
     if (!range.Initialize(connection->Memory(), connection->Is64Bit()) ||
@@ -97,6 +311,10 @@ bool CaptureSnapshot(
 
     std::unique_ptr<ProcessSnapshotSanitized> sanitized(
         new ProcessSnapshotSanitized());
+    if (connection->Memory()->SupportsConcurrentReads()) {
+      sanitized->SetSanitizationPipelining(kSanitizationPipelineThreads,
+                                           kSanitizationPipelineBufferBytes);
+    }
     if (!sanitized->Initialize(process_snapshot.get(),
                                sanitization_info.allowed_annotations_address
                                    ? std::move(allowed_annotations)
@@ -115,4 +333,26 @@ bool CaptureSnapshot(
   return true;
 }
 
+void InitializeMinidumpFromSnapshot(
+    ProcessSnapshotLinux* process_snapshot,
+    ProcessSnapshot* snapshot,
+    const UserStreamDataSources* user_stream_data_sources,
+    MinidumpFileWriter* minidump) {
+  {
+    ScopedCapturePhase capture_phase(process_snapshot->Timings(),
+                                     CapturePhase::kWrite,
+                                     process_snapshot->Memory());
+    minidump->SetElideUnpopulatedMemory(
+        process_snapshot->SkipsUnpopulatedMemory());
+    minidump->InitializeFromSnapshot(snapshot);
+    AddUserExtensionStreams(user_stream_data_sources, snapshot, minidump);
+  }
+
+  auto capture_timing_list =
+      std::make_unique<MinidumpCaptureTimingListWriter>();
+  capture_timing_list->InitializeFromCaptureTimings(
+      *process_snapshot->Timings());
+  minidump->AddStream(std::move(capture_timing_list));
+}
+
 }  // namespace crashpad
@@ -15,16 +15,24 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CAPTURE_SNAPSHOT_H_
 #define CRASHPAD_HANDLER_LINUX_CAPTURE_SNAPSHOT_H_
 
+#include <stddef.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <map>
 #include <memory>
 #include <string>
 
+#include "handler/capture_policy.h"
+#include "handler/user_stream_data_source.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/elf/elf_image_cache.h"
+#include "snapshot/linux/module_list_cache.h"
 #include "snapshot/linux/process_snapshot_linux.h"
 #include "snapshot/sanitized/process_snapshot_sanitized.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
+#include "util/linux/shared_crash_context.h"
 #include "util/misc/address_types.h"
 
 namespace crashpad {
@@ -32,7 +40,13 @@ namespace crashpad {
 //! \brief Captures a snapshot of a client over \a connection.
 //!
 //! \param[in] connection A PtraceConnection to the client to snapshot.
-//! \param[in] info Information about the client configuring the snapshot.
+//! \param[in] info Information about the client configuring the snapshot. If
+//!     \a info requests a lightweight snapshot, see
+//!     ProcessSnapshotLinux::SetLightweightCapture(), the snapshot has the
+//!     `"crashpad_report_type"` process annotation set to `"lightweight"`.
+//! \param[in] capture_exception Whether to capture the exception at \a info’s
+//!     exception address. If `false`, the snapshot has no exception, as for a
+//!     process captured alongside a crashing client.
 //! \param[in] process_annotations A map of annotations to insert as
 //!     process-level annotations into the snapshot.
 //! \param[in] client_uid The client's user ID.
@@ -44,6 +58,34 @@ namespace crashpad {
 //! \param[out] requesting_thread_id The thread ID of the thread corresponding
 //!     to \a requesting_thread_stack_address. Set to -1 if the thread ID could
 //!     not be determined. Optional.
+//! \param[in] shared_context Memory describing the crash that the client
+//!     copied out ahead of time, to be read instead of the client's memory
+//!     where possible. Optional.
+//! \param[in] capture_deadline A ClockMonotonicNanoseconds() value by which
+//!     the snapshot should be fully written, or `0` for no deadline. See
+//!     ProcessSnapshotLinux::SetCaptureDeadline().
+//! \param[in] elf_image_cache A cache of ELF image information shared across
+//!     snapshots, or `nullptr`. See ProcessSnapshotLinux::SetElfImageCache().
+//! \param[in] module_list_cache A cache of module lists shared across
+//!     snapshots of the same client, or `nullptr`. See
+//!     ProcessSnapshotLinux::SetModuleListCache().
+//! \param[in] trim_stacks Whether thread stacks should be trimmed to their live
+//!     frames. See ProcessSnapshotLinux::SetStackTrimming().
+//! \param[in] indirect_memory_depth The number of levels of pointers to follow
+//!     when capturing indirectly referenced memory. See
+//!     ProcessSnapshotLinux::SetIndirectMemoryDepth().
+//! \param[in] elide_module_code Whether unmodified module code should be left
+//!     out of indirectly referenced memory. See
+//!     ProcessSnapshotLinux::SetModuleCodeElision().
+//! \param[in] skip_unpopulated_memory Whether pages of the client that have
+//!     never been populated should be left unread and out of the minidump.
+//!     See ProcessSnapshotLinux::SetSkipUnpopulatedMemory().
+//! \param[in] profile Whether the snapshot's CaptureTimings should record the
+//!     resources used in each phase. See CaptureTimings::SetProfiling().
+//! \param[in] capture_policies Policies that may further limit the capture
+//!     for the client, matched against its executable and annotations once
+//!     its modules have been read. The matching policy, if any, is recorded
+//!     in the `"crashpad_capture_policy"` process annotation. Optional.
 //! \param[out] process_snapshot A snapshot of the client process, valid if this
 //!     function returns `true`.
 //! \param[out] sanitized_snapshot A sanitized snapshot of the client process,
@@ -55,13 +97,46 @@ namespace crashpad {
 bool CaptureSnapshot(
     PtraceConnection* connection,
     const ExceptionHandlerProtocol::ClientInformation& info,
+    bool capture_exception,
     const std::map<std::string, std::string>& process_annotations,
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
+    const SharedCrashContext* shared_context,
+    uint64_t capture_deadline,
+    ElfImageCache* elf_image_cache,
+    ModuleListCache* module_list_cache,
+    bool trim_stacks,
+    size_t indirect_memory_depth,
+    bool elide_module_code,
+    bool skip_unpopulated_memory,
+    bool profile,
+    const CapturePolicyTable* capture_policies,
     std::unique_ptr<ProcessSnapshotLinux>* process_snapshot,
     std::unique_ptr<ProcessSnapshotSanitized>* sanitized_snapshot);
 
+//! \brief Initializes \a minidump to write \a snapshot.
+//!
+//! In addition to the streams added by
+//! MinidumpFileWriter::InitializeFromSnapshot() and AddUserExtensionStreams(),
+//! a MinidumpCaptureTimingList stream is added recording the cost of capturing
+//! \a process_snapshot. If \a process_snapshot skips unpopulated memory, that
+//! memory is recorded in a MinidumpZeroMemoryList stream instead of being
+//! written. See MinidumpFileWriter::SetElideUnpopulatedMemory(). The time
+//! spent here is charged to CapturePhase::kWrite.
+//!
+//! \param[in] process_snapshot The snapshot returned by CaptureSnapshot().
+//! \param[in] snapshot The snapshot to write, either \a process_snapshot or
+//!     the sanitized snapshot returned by CaptureSnapshot().
+//! \param[in] user_stream_data_sources Data sources that may contribute
+//!     additional minidump streams. May be `nullptr`.
+//! \param[out] minidump The minidump to initialize.
+void InitializeMinidumpFromSnapshot(
+    ProcessSnapshotLinux* process_snapshot,
+    ProcessSnapshot* snapshot,
+    const UserStreamDataSources* user_stream_data_sources,
+    MinidumpFileWriter* minidump);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_HANDLER_LINUX_CAPTURE_SNAPSHOT_H_
@@ -21,17 +21,28 @@
 #include "build/build_config.h"
 #include "client/settings.h"
 #include "handler/linux/capture_snapshot.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_summary.h"
+#include "handler/upload_body.h"
+#include "minidump/minidump_delta_base.h"
 #include "minidump/minidump_file_writer.h"
+#include "snapshot/exception_snapshot.h"
 #include "snapshot/linux/process_snapshot_linux.h"
 #include "snapshot/sanitized/process_snapshot_sanitized.h"
-#include "util/file/file_helper.h"
+#include "third_party/zlib/zlib_crashpad.h"
 #include "util/file/file_reader.h"
 #include "util/file/output_stream_file_writer.h"
 #include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/fork_snapshot_connection.h"
+#include "util/linux/io_uring_file_writer.h"
 #include "util/linux/ptrace_client.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/clock.h"
 #include "util/misc/implicit_cast.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_event.h"
 #include "util/misc/uuid.h"
+#include "util/posix/signals.h"
 #include "util/stream/base94_output_stream.h"
 #include "util/stream/log_output_stream.h"
 #include "util/stream/zlib_output_stream.h"
@@ -78,9 +89,22 @@ class Logger final : public LogOutputStream::Delegate {
 #endif
 };
 
+// Minidumps written to the log are emitted while the crashing process waits,
+// and logging is slow enough on Android that compressing at
+// Z_BEST_COMPRESSION dominates the time taken. Z_BEST_SPEED costs little in
+// size for minidump data.
+constexpr int kLogCompressionLevel = Z_BEST_SPEED;
+
+// The most memory snapshot data held at once while writing a minidump when the
+// resource budget is tight.
+constexpr size_t kReducedMemoryBufferLimit = 64 * 1024;
+
 bool WriteMinidumpLogFromFile(FileReaderInterface* file_reader) {
   ZlibOutputStream stream(
       ZlibOutputStream::Mode::kCompress,
+      ZlibOutputStream::Format::kZlib,
+      kLogCompressionLevel,
+      ZlibOutputStream::Strategy::kDefault,
       std::make_unique<Base94OutputStream>(
           Base94OutputStream::Mode::kEncode,
           std::make_unique<LogOutputStream>(std::make_unique<Logger>())));
@@ -113,21 +137,55 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
       attachments_(attachments),
       write_minidump_to_database_(write_minidump_to_database),
       write_minidump_to_log_(write_minidump_to_log),
-      user_stream_data_sources_(user_stream_data_sources) {
+      user_stream_data_sources_(user_stream_data_sources),
+      capture_timeout_ns_(0),
+      stack_trimming_(false),
+      indirect_memory_depth_(1),
+      module_code_elision_(false),
+      skip_unpopulated_memory_(false),
+      capture_policies_(nullptr),
+      resource_budget_(nullptr),
+      report_file_pool_size_(0),
+      staged_report_commit_thread_(nullptr),
+      delta_dump_base_cache_(),
+      prepare_upload_body_(false),
+      profile_captures_(false),
+      elf_image_cache_(),
+      module_list_cache_(),
+      finish_pool_(),
+      finish_tasks_() {
   DCHECK(write_minidump_to_database_ | write_minidump_to_log_);
 }
 
 CrashReportExceptionHandler::~CrashReportExceptionHandler() = default;
 
+void CrashReportExceptionHandler::SetAsyncAcknowledgement(bool enabled) {
+  finish_tasks_.reset();
+  finish_pool_.reset();
+  if (enabled) {
+    // A single thread finishes reports in the order that they were written.
+    finish_pool_ = std::make_unique<ThreadPool>(1);
+    finish_tasks_ = std::make_unique<ThreadPool::TaskGroup>(finish_pool_.get());
+  }
+}
+
+void CrashReportExceptionHandler::SetDeltaDumps(size_t max_deltas_per_base) {
+  delta_dump_base_cache_.reset(
+      max_deltas_per_base ? new DeltaDumpBaseCache(max_deltas_per_base)
+                          : nullptr);
+}
+
 bool CrashReportExceptionHandler::HandleException(
     pid_t client_process_id,
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
   Metrics::ExceptionEncountered();
 
+  ResourceBudget::ScopedCapture capture(resource_budget_);
   DirectPtraceConnection connection;
   if (!connection.Initialize(client_process_id)) {
     Metrics::ExceptionCaptureResult(
@@ -136,11 +194,13 @@ bool CrashReportExceptionHandler::HandleException(
   }
 
   return HandleExceptionWithConnection(&connection,
+                                       capture.level(),
                                        info,
                                        client_uid,
                                        requesting_thread_stack_address,
                                        requesting_thread_id,
-                                       local_report_id);
+                                       local_report_id,
+                                       shared_context);
 }
 
 bool CrashReportExceptionHandler::HandleExceptionWithBroker(
@@ -148,9 +208,11 @@ bool CrashReportExceptionHandler::HandleExceptionWithBroker(
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     int broker_sock,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
   Metrics::ExceptionEncountered();
 
+  ResourceBudget::ScopedCapture capture(resource_budget_);
   PtraceClient client;
   if (!client.Initialize(broker_sock, client_process_id)) {
     Metrics::ExceptionCaptureResult(
@@ -158,25 +220,184 @@ bool CrashReportExceptionHandler::HandleExceptionWithBroker(
     return false;
   }
 
-  return HandleExceptionWithConnection(
-      &client, info, client_uid, 0, nullptr, local_report_id);
+  return HandleExceptionWithConnection(&client,
+                                       capture.level(),
+                                       info,
+                                       client_uid,
+                                       0,
+                                       nullptr,
+                                       local_report_id,
+                                       shared_context);
+}
+
+bool CrashReportExceptionHandler::HandleExceptionWithForkSnapshot(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    int client_sock,
+    UUID* local_report_id) {
+  Metrics::ExceptionEncountered();
+
+  ResourceBudget::ScopedCapture capture(resource_budget_);
+  ForkSnapshotConnection fork_connection;
+  DirectPtraceConnection direct_connection;
+  PtraceConnection* connection = &fork_connection;
+  if (!fork_connection.Initialize(client_sock, client_process_id)) {
+    // The client is still waiting for its crash dump, so capture it directly.
+    LOG(WARNING) << "capturing without a fork snapshot";
+    if (!direct_connection.Initialize(client_process_id)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kForkSnapshotFailed);
+      return false;
+    }
+    connection = &direct_connection;
+  }
+
+  return HandleExceptionWithConnection(connection,
+                                       capture.level(),
+                                       info,
+                                       client_uid,
+                                       0,
+                                       nullptr,
+                                       local_report_id);
+}
+
+bool CrashReportExceptionHandler::HandleProcessGroupException(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    const std::vector<pid_t>& group_process_ids,
+    VMAddress requesting_thread_stack_address,
+    pid_t* requesting_thread_id,
+    const SharedCrashContext* shared_context) {
+  Metrics::ExceptionEncountered();
+  CRASHPAD_TRACE_EVENT(
+      "handler", "CrashReportExceptionHandler::HandleProcessGroupException");
+
+  // One reservation covers the whole group, which is captured as one.
+  ResourceBudget::ScopedCapture capture(resource_budget_);
+  DirectPtraceConnection client_connection;
+  if (!client_connection.Initialize(client_process_id)) {
+    Metrics::ExceptionCaptureResult(
+        Metrics::CaptureResult::kDirectPtraceFailed);
+    return false;
+  }
+
+  // Stop every thread of the client and of every member before capturing any,
+  // so that their state can't drift while the others are captured. The
+  // connections keep them stopped until they go out of scope.
+  if (!client_connection.AttachAllThreads()) {
+    LOG(WARNING) << "couldn't attach to every thread of the client";
+  }
+  std::vector<std::unique_ptr<DirectPtraceConnection>> member_connections;
+  if (info.sanitization_information_address) {
+    LOG(WARNING) << "sanitization requested, capturing client only";
+  } else {
+    if (group_process_ids.size() > kMaxProcessGroupMembers) {
+      LOG(WARNING) << "capturing " << kMaxProcessGroupMembers << " of "
+                   << group_process_ids.size() << " process group members";
+    }
+    for (pid_t member : group_process_ids) {
+      if (member_connections.size() == kMaxProcessGroupMembers) {
+        break;
+      }
+      auto connection = std::make_unique<DirectPtraceConnection>();
+      if (!connection->Initialize(member)) {
+        LOG(WARNING) << "couldn't attach to process group member " << member;
+        continue;
+      }
+      if (!connection->AttachAllThreads()) {
+        LOG(WARNING) << "couldn't attach to every thread of process group "
+                     << "member " << member;
+      }
+      member_connections.push_back(std::move(connection));
+    }
+  }
+
+  UUID group_id;
+  if (!group_id.InitializeWithNew()) {
+    return false;
+  }
+  std::map<std::string, std::string> process_annotations(
+      *process_annotations_);
+  process_annotations["crashpad_process_group"] = group_id.ToString();
+
+  const bool result =
+      HandleExceptionWithConnection(&client_connection,
+                                    capture.level(),
+                                    info,
+                                    client_uid,
+                                    requesting_thread_stack_address,
+                                    requesting_thread_id,
+                                    nullptr,
+                                    shared_context,
+                                    &process_annotations);
+
+  // The members didn't crash, and are captured as DumpWithoutCrash() would
+  // capture them.
+  const ExceptionHandlerProtocol::ClientInformation member_info;
+  for (const auto& connection : member_connections) {
+    Metrics::ExceptionEncountered();
+    HandleExceptionWithConnection(connection.get(),
+                                  capture.level(),
+                                  member_info,
+                                  client_uid,
+                                  0,
+                                  nullptr,
+                                  nullptr,
+                                  nullptr,
+                                  &process_annotations,
+                                  /*capture_exception=*/false);
+  }
+
+  return result;
 }
 
 bool CrashReportExceptionHandler::HandleExceptionWithConnection(
     PtraceConnection* connection,
+    ResourceBudget::Level budget_level,
     const ExceptionHandlerProtocol::ClientInformation& info,
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context,
+    const std::map<std::string, std::string>* process_annotations,
+    bool capture_exception) {
+  CRASHPAD_TRACE_EVENT(
+      "handler", "CrashReportExceptionHandler::HandleExceptionWithConnection");
+  Metrics::ExceptionCaptureStarted();
+  const uint64_t capture_deadline =
+      capture_timeout_ns_ ? ClockMonotonicNanoseconds() + capture_timeout_ns_
+                          : 0;
+
+  // A tight budget leaves optional data out of the snapshot, and limits how
+  // much memory is held at once while writing it.
+  const bool reduced = budget_level != ResourceBudget::Level::kNormal;
+  if (reduced) {
+    LOG(WARNING) << "resource budget is tight, reducing capture";
+  }
+
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
   std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
   if (!CaptureSnapshot(connection,
                        info,
-                       *process_annotations_,
+                       capture_exception,
+                       process_annotations ? *process_annotations
+                                           : *process_annotations_,
                        client_uid,
                        requesting_thread_stack_address,
                        requesting_thread_id,
+                       shared_context,
+                       capture_deadline,
+                       &elf_image_cache_,
+                       &module_list_cache_,
+                       stack_trimming_ || reduced,
+                       reduced ? 0 : indirect_memory_depth_,
+                       module_code_elision_ || reduced,
+                       skip_unpopulated_memory_,
+                       profile_captures_,
+                       capture_policies_,
                        &process_snapshot,
                        &sanitized_snapshot)) {
     return false;
@@ -188,28 +409,39 @@ bool CrashReportExceptionHandler::HandleExceptionWithConnection(
     process_snapshot->SetClientID(client_id);
   }
 
+  const size_t memory_buffer_limit =
+      reduced ? kReducedMemoryBufferLimit : 0;
   return write_minidump_to_database_
              ? WriteMinidumpToDatabase(process_snapshot.get(),
                                        sanitized_snapshot.get(),
                                        write_minidump_to_log_,
+                                       memory_buffer_limit,
                                        local_report_id)
              : WriteMinidumpToLog(process_snapshot.get(),
-                                  sanitized_snapshot.get());
+                                  sanitized_snapshot.get(),
+                                  memory_buffer_limit);
 }
 
 bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
     ProcessSnapshotLinux* process_snapshot,
     ProcessSnapshotSanitized* sanitized_snapshot,
     bool write_minidump_to_log,
+    size_t memory_buffer_limit,
     UUID* local_report_id) {
+  CRASHPAD_TRACE_EVENT("handler",
+                       "CrashReportExceptionHandler::WriteMinidumpToDatabase");
   std::unique_ptr<CrashReportDatabase::NewReport> new_report;
-  CrashReportDatabase::OperationStatus database_status =
-      database_->PrepareNewCrashReport(&new_report);
-  if (database_status != CrashReportDatabase::kNoError) {
-    LOG(ERROR) << "PrepareNewCrashReport failed";
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kPrepareNewCrashReportFailed);
-    return false;
+  {
+    ScopedCapturePhase capture_phase(
+        process_snapshot->Timings(), CapturePhase::kDatabase, nullptr);
+    CrashReportDatabase::OperationStatus database_status =
+        database_->PrepareNewCrashReport(&new_report);
+    if (database_status != CrashReportDatabase::kNoError) {
+      LOG(ERROR) << "PrepareNewCrashReport failed";
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kPrepareNewCrashReportFailed);
+      return false;
+    }
   }
 
   process_snapshot->SetReportID(new_report->ReportID());
@@ -218,17 +450,163 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
       sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
                          : implicit_cast<ProcessSnapshot*>(process_snapshot);
 
+  // A lightweight report holds only what its client asked for, so it gets no
+  // user streams or attachments, and isn’t written as a delta.
+  const bool lightweight = process_snapshot->IsLightweightCapture();
+
+  // A dump taken without a crash, such as one of a series sampling a hang, may
+  // be written as a delta against the last full dump of the process. Crash
+  // dumps are always written in full, as they may be the only ones kept.
+  std::shared_ptr<const MinidumpDeltaBase> delta_base;
+  std::shared_ptr<MinidumpDeltaBase> recorded_delta_base;
+  int64_t start_time_us = 0;
+  const ExceptionSnapshot* exception = process_snapshot->Exception();
+  if (delta_dump_base_cache_ && !sanitized_snapshot && !lightweight &&
+      (!exception || exception->Exception() ==
+                         static_cast<uint32_t>(Signals::kSimulatedSigno))) {
+    timeval start_time;
+    process_snapshot->ProcessStartTime(&start_time);
+    start_time_us = int64_t{start_time.tv_sec} * 1000000 + start_time.tv_usec;
+    delta_base = delta_dump_base_cache_->Lookup(process_snapshot->ProcessID(),
+                                                start_time_us);
+    if (!delta_base) {
+      recorded_delta_base = std::make_shared<MinidumpDeltaBase>();
+    }
+  }
+
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  minidump.SetDeltaBase(delta_base.get());
+  minidump.SetRecordDeltaBase(recorded_delta_base.get());
+  InitializeMinidumpFromSnapshot(process_snapshot,
+                                 snapshot,
+                                 lightweight ? nullptr
+                                             : user_stream_data_sources_,
+                                 &minidump);
+  minidump.SetMemoryBufferLimit(memory_buffer_limit);
+
+  {
+    ScopedCapturePhase capture_phase(process_snapshot->Timings(),
+                                     CapturePhase::kWrite,
+                                     process_snapshot->Memory());
+    // An uncompressed minidump is written straight to the report file. Where
+    // io_uring is available, those writes are queued without waiting for
+    // them, so that the kernel writes each part of the minidump while the
+    // client’s memory for the next is read.
+    FileWriterInterface* minidump_writer = new_report->MinidumpWriter();
+    std::unique_ptr<IoUringFileWriter> io_uring_writer;
+    if (!new_report->IsCompressed()) {
+      io_uring_writer =
+          std::make_unique<IoUringFileWriter>(new_report->Writer()->fd());
+      if (io_uring_writer->Initialize()) {
+        minidump_writer = io_uring_writer.get();
+      } else {
+        io_uring_writer.reset();
+      }
+    }
 
-  if (!minidump.WriteEverything(new_report->Writer())) {
-    LOG(ERROR) << "WriteEverything failed";
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kMinidumpWriteFailed);
-    return false;
+    // A compressed minidump writer can’t seek, so the minidump must be written
+    // sequentially.
+    bool written = minidump.WriteMinidump(minidump_writer,
+                                          !new_report->IsCompressed());
+    if (io_uring_writer && !io_uring_writer->Flush()) {
+      written = false;
+    }
+    if (!written) {
+      LOG(ERROR) << "WriteMinidump failed";
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kMinidumpWriteFailed);
+      return false;
+    }
+  }
+
+  // Storing the upload parameters now spares the upload thread from having to
+  // read them back out of the minidump.
+  const std::map<std::string, std::string> upload_parameters =
+      BreakpadHTTPFormParametersFromMinidump(snapshot);
+  {
+    ScopedCapturePhase capture_phase(
+        process_snapshot->Timings(), CapturePhase::kDatabase, nullptr);
+    if (!new_report->SetUploadParameters(upload_parameters)) {
+      LOG(WARNING) << "SetUploadParameters failed";
+    }
+
+    // The summary lets reports be listed without reading their minidumps.
+    if (!new_report->SetSummary(ReportSummaryFromSnapshot(*snapshot))) {
+      LOG(WARNING) << "SetSummary failed";
+    }
+  }
+
+  process_snapshot->Timings()->ReportMetrics();
+  Metrics::MinidumpWriteCompleted(
+      process_snapshot->Timings()->Get(CapturePhase::kWrite).duration_ns);
+  process_snapshot->MemoryCache()->ReportMetrics();
+
+  // The rest of the report's cost is added to a copy of its timings, which
+  // outlives the snapshot if the report is finished in the background.
+  std::shared_ptr<CaptureTimings> profile;
+  if (profile_captures_) {
+    profile = std::make_shared<CaptureTimings>();
+    profile->SetProfiling(true);
+    profile->Add(*process_snapshot->Timings());
+  }
+
+  const pid_t process_id = process_snapshot->ProcessID();
+
+  // Nothing after this point reads the client, so it can be released while the
+  // report is finished.
+  if (finish_tasks_ && !local_report_id) {
+    // ThreadPool tasks must be copyable.
+    auto report =
+        std::make_shared<std::unique_ptr<CrashReportDatabase::NewReport>>(
+            std::move(new_report));
+    finish_tasks_->Post([this,
+                         report,
+                         upload_parameters,
+                         write_minidump_to_log,
+                         lightweight,
+                         process_id,
+                         start_time_us,
+                         recorded_delta_base,
+                         profile]() {
+      FinishReport(std::move(*report),
+                   upload_parameters,
+                   write_minidump_to_log,
+                   !lightweight,
+                   process_id,
+                   start_time_us,
+                   recorded_delta_base,
+                   profile.get(),
+                   nullptr);
+    });
+    return true;
   }
 
+  return FinishReport(std::move(new_report),
+                      upload_parameters,
+                      write_minidump_to_log,
+                      !lightweight,
+                      process_id,
+                      start_time_us,
+                      std::move(recorded_delta_base),
+                      profile.get(),
+                      local_report_id);
+}
+
+bool CrashReportExceptionHandler::FinishReport(
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+    const std::map<std::string, std::string>& upload_parameters,
+    bool write_minidump_to_log,
+    bool add_attachments,
+    pid_t process_id,
+    int64_t start_time_us,
+    std::shared_ptr<MinidumpDeltaBase> recorded_delta_base,
+    CaptureTimings* profile,
+    UUID* local_report_id) {
+  CRASHPAD_TRACE_EVENT("handler", "CrashReportExceptionHandler::FinishReport");
+  const std::vector<base::FilePath> no_attachments;
+  const std::vector<base::FilePath>& attachments =
+      add_attachments ? *attachments_ : no_attachments;
+
   bool write_minidump_to_log_succeed = false;
   if (write_minidump_to_log) {
     if (auto* file_reader = new_report->Reader()) {
@@ -239,39 +617,69 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
     }
   }
 
-  for (const auto& attachment : (*attachments_)) {
-    FileReader file_reader;
-    if (!file_reader.Open(attachment)) {
-      LOG(ERROR) << "attachment " << attachment.value().c_str()
-                 << " couldn't be opened, skipping";
-      continue;
+  UUID uuid;
+  {
+    ScopedCapturePhase capture_phase(
+        profile, CapturePhase::kDatabase, nullptr);
+
+    // Attachments may still be written to by the client, so they're cloned or
+    // copied, never linked.
+    for (const auto& attachment : attachments) {
+      base::FilePath filename = attachment.BaseName();
+      if (!new_report->AddAttachmentFromFile(
+              filename.value(), attachment, /*allow_hard_link=*/false)) {
+        LOG(ERROR) << "attachment " << attachment.value().c_str()
+                   << " couldn't be added, skipping";
+      }
     }
 
-    base::FilePath filename = attachment.BaseName();
-    FileWriter* file_writer = new_report->AddAttachment(filename.value());
-    if (file_writer == nullptr) {
-      LOG(ERROR) << "attachment " << filename.value().c_str()
-                 << " couldn't be created, skipping";
-      continue;
+    // The body is prepared here, while the report is fresh in the page cache,
+    // so that the upload needn’t read it back and compress it.
+    if (prepare_upload_body_ && upload_thread_) {
+      std::map<std::string, base::FilePath> body_attachments;
+      for (const auto& attachment : attachments) {
+        body_attachments[attachment.BaseName().value()] = attachment;
+      }
+      if (!AddUploadBodyToReport(
+              new_report.get(), upload_parameters, body_attachments)) {
+        LOG(WARNING) << "AddUploadBodyToReport failed";
+      }
     }
 
-    CopyFileContent(&file_reader, file_writer);
+    const CrashReportDatabase::OperationStatus database_status =
+        database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
+    if (database_status != CrashReportDatabase::kNoError) {
+      LOG(ERROR) << "FinishedWritingCrashReport failed";
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kFinishedWritingCrashReportFailed);
+      return false;
+    }
   }
 
-  UUID uuid;
-  database_status =
-      database_->FinishedWritingCrashReport(std::move(new_report), &uuid);
-  if (database_status != CrashReportDatabase::kNoError) {
-    LOG(ERROR) << "FinishedWritingCrashReport failed";
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kFinishedWritingCrashReportFailed);
-    return false;
+  if (profile) {
+    LOG(INFO) << "capture profile for report " << uuid.ToString() << ": "
+              << profile->ToJSON();
   }
 
-  if (upload_thread_) {
+  if (recorded_delta_base) {
+    delta_dump_base_cache_->Insert(process_id,
+                                   start_time_us,
+                                   std::move(recorded_delta_base));
+  }
+
+  // A staged report is only pending once it has been committed.
+  if (staged_report_commit_thread_) {
+    staged_report_commit_thread_->ReportStaged();
+  } else if (upload_thread_) {
     upload_thread_->ReportPending(uuid);
   }
 
+  // Replace the file this report claimed. Nothing is preallocated, as the
+  // minidump writer reserves what each report needs once its size is known.
+  if (report_file_pool_size_) {
+    database_->FillReportFilePool(report_file_pool_size_, 0);
+  }
+
   if (local_report_id != nullptr) {
     *local_report_id = uuid;
   }
@@ -283,16 +691,25 @@ bool CrashReportExceptionHandler::WriteMinidumpToDatabase(
 
 bool CrashReportExceptionHandler::WriteMinidumpToLog(
     ProcessSnapshotLinux* process_snapshot,
-    ProcessSnapshotSanitized* sanitized_snapshot) {
+    ProcessSnapshotSanitized* sanitized_snapshot,
+    size_t memory_buffer_limit) {
   ProcessSnapshot* snapshot =
       sanitized_snapshot ? implicit_cast<ProcessSnapshot*>(sanitized_snapshot)
                          : implicit_cast<ProcessSnapshot*>(process_snapshot);
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  InitializeMinidumpFromSnapshot(process_snapshot,
+                                 snapshot,
+                                 process_snapshot->IsLightweightCapture()
+                                     ? nullptr
+                                     : user_stream_data_sources_,
+                                 &minidump);
+  minidump.SetMemoryBufferLimit(memory_buffer_limit);
 
   OutputStreamFileWriter writer(std::make_unique<ZlibOutputStream>(
       ZlibOutputStream::Mode::kCompress,
+      ZlibOutputStream::Format::kZlib,
+      kLogCompressionLevel,
+      ZlibOutputStream::Strategy::kDefault,
       std::make_unique<Base94OutputStream>(
           Base94OutputStream::Mode::kEncode,
           std::make_unique<LogOutputStream>(std::make_unique<Logger>()))));
@@ -15,20 +15,34 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CRASH_REPORT_EXCEPTION_HANDLER_H_
 #define CRASHPAD_HANDLER_LINUX_CRASH_REPORT_EXCEPTION_HANDLER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "client/crash_report_database.h"
+#include "handler/capture_policy.h"
 #include "handler/crash_report_upload_thread.h"
+#include "handler/linux/delta_dump_base_cache.h"
 #include "handler/linux/exception_handler_server.h"
+#include "handler/resource_budget.h"
+#include "handler/staged_report_commit_thread.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/elf/elf_image_cache.h"
+#include "snapshot/linux/module_list_cache.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
+#include "util/misc/capture_timings.h"
 #include "util/misc/uuid.h"
+#include "util/thread/thread_pool.h"
 
 namespace crashpad {
 
+class MinidumpDeltaBase;
 class ProcessSnapshotLinux;
 class ProcessSnapshotSanitized;
 
@@ -77,6 +91,132 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
 
   ~CrashReportExceptionHandler() override;
 
+  //! \brief Limits how long capturing a snapshot of a crashing client may
+  //!     take.
+  //!
+  //! Optional data is dropped from the snapshot as needed to finish within
+  //! \a timeout_ns nanoseconds of starting to handle an exception. See
+  //! ProcessSnapshotLinux::SetCaptureDeadline(). A value of `0`, the default,
+  //! imposes no limit.
+  void SetCaptureTimeout(uint64_t timeout_ns) {
+    capture_timeout_ns_ = timeout_ns;
+  }
+
+  //! \brief Trims the stacks of threads other than the crashing thread to
+  //!     their live frames, reducing the size of reports for processes that
+  //!     are built with frame pointers. See
+  //!     ProcessSnapshotLinux::SetStackTrimming(). Disabled by default.
+  void SetStackTrimming(bool enabled) { stack_trimming_ = enabled; }
+
+  //! \brief Sets the number of levels of pointers followed when capturing
+  //!     indirectly referenced memory, within the budget that clients set in
+  //!     their CrashpadInfo. The default is 1. See
+  //!     ProcessSnapshotLinux::SetIndirectMemoryDepth().
+  void SetIndirectMemoryDepth(size_t depth) { indirect_memory_depth_ = depth; }
+
+  //! \brief Leaves unmodified module code out of indirectly referenced memory,
+  //!     such as the code around each thread's program counter. The module
+  //!     list is enough to recover it from symbol storage. See
+  //!     ProcessSnapshotLinux::SetModuleCodeElision(). Disabled by default.
+  void SetModuleCodeElision(bool enabled) { module_code_elision_ = enabled; }
+
+  //! \brief Leaves pages of the client that have never been populated, and so
+  //!     read as zeroes, unread and out of the memory the minidump holds,
+  //!     recording their ranges instead. See
+  //!     ProcessSnapshotLinux::SetSkipUnpopulatedMemory(). Disabled by
+  //!     default.
+  void SetSkipUnpopulatedMemory(bool enabled) {
+    skip_unpopulated_memory_ = enabled;
+  }
+
+  //! \brief Sets policies that further limit the capture for particular
+  //!     clients, selected by their executable or annotations. See
+  //!     CapturePolicyTable. By default, no policies apply.
+  //!
+  //! \param[in] policies The policies, or `nullptr`. Weak.
+  void SetCapturePolicies(const CapturePolicyTable* policies) {
+    capture_policies_ = policies;
+  }
+
+  //! \brief Sets the budget that captures reserve from.
+  //!
+  //! While the budget is tight, captures trim stacks, leave out indirectly
+  //! referenced memory and module code, and write minidumps holding less
+  //! memory at once. While it is exhausted, captures also wait for others in
+  //! progress to finish. See ResourceBudget::ScopedCapture. By default, no
+  //! budget is used.
+  //!
+  //! \param[in] budget The budget, or `nullptr`. Weak.
+  void SetResourceBudget(ResourceBudget* budget) { resource_budget_ = budget; }
+
+  //! \brief Sets the number of report files to keep available in the
+  //!     database’s pool. See CrashReportDatabase::FillReportFilePool().
+  //!
+  //! The pool is refilled after each report is written, so that the next
+  //! crash needn’t create its report file. By default, no pool is kept.
+  void SetReportFilePoolSize(size_t size) { report_file_pool_size_ = size; }
+
+  //! \brief Sets the thread that commits reports staged by the database.
+  //!
+  //! When the database stages new reports, see
+  //! CrashReportDatabase::SetStagingDirectory(), \a thread is informed of each
+  //! report written, and informs the upload thread once the report has been
+  //! committed. By default, reports aren’t staged.
+  //!
+  //! \param[in] thread The commit thread, or `nullptr`. Weak.
+  void SetStagedReportCommitThread(StagedReportCommitThread* thread) {
+    staged_report_commit_thread_ = thread;
+  }
+
+  //! \brief Writes repeated dumps of a process taken without a crash as
+  //!     deltas against an earlier full dump of it.
+  //!
+  //! When enabled, a dump taken without a crash, such as by DumpWithoutCrash(),
+  //! is written with MinidumpFileWriter::SetDeltaBase() against the last full
+  //! dump of the same process written by this handler, omitting the modules,
+  //! memory map, and pages of memory that are unchanged since. Up to \a
+  //! max_deltas_per_base deltas are written against each full dump before the
+  //! next dump is written in full. Crash dumps, and dumps that are sanitized,
+  //! are always written in full and never serve as bases. See
+  //! DeltaDumpBaseCache. Disabled by default.
+  //!
+  //! \param[in] max_deltas_per_base The number of deltas to write against each
+  //!     full dump, or `0` to disable.
+  void SetDeltaDumps(size_t max_deltas_per_base);
+
+  //! \brief Stores the HTTP body with which each report will be uploaded
+  //!     along with the report, so that the upload thread can send it without
+  //!     reading the report back and compressing it. See
+  //!     AddUploadBodyToReport(). This only has an effect for reports that are
+  //!     given to an upload thread, and the body is only used when uploads are
+  //!     `gzip`-compressed. Disabled by default.
+  void SetPrepareUploadBody(bool enabled) { prepare_upload_body_ = enabled; }
+
+  //! \brief Logs the cost of each report written to the database once it has
+  //!     been committed, as a JSON object from CaptureTimings::ToJSON().
+  //!
+  //! Each capture is profiled, see CaptureTimings::SetProfiling(), so that
+  //! the CPU time, system calls, bytes written, and heap growth of each
+  //! CapturePhase are recorded along with its wall time and the bytes read
+  //! from the client. The CapturePhase::kDatabase cost logged includes adding
+  //! attachments to the report and committing it. Disabled by default.
+  void SetCaptureProfiling(bool enabled) { profile_captures_ = enabled; }
+
+  //! \brief Releases each client as soon as it has been read for the last
+  //!     time, finishing its report in the background.
+  //!
+  //! By default, a client waiting for its crash dump is released once its
+  //! report has been committed to the database. When enabled, it’s released
+  //! as soon as its minidump has been written, which is the last time the
+  //! client is read, and the rest of the work on its report, such as writing
+  //! it to the log, copying attachments, preparing its upload body, and
+  //! committing it, is done on a background thread in the order that reports
+  //! were written. This lets a supervisor restart a crashed service sooner. A
+  //! caller that asks for the report’s ID through \a local_report_id still
+  //! waits for the report to be committed. Reports not yet finished when this
+  //! object is destroyed are finished first. Disabled by default.
+  void SetAsyncAcknowledgement(bool enabled);
+
   // ExceptionHandlerServer::Delegate:
 
   bool HandleException(pid_t client_process_id,
@@ -84,30 +224,80 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address = 0,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override;
+                       UUID* local_report_id = nullptr,
+                       const SharedCrashContext* shared_context =
+                           nullptr) override;
 
   bool HandleExceptionWithBroker(
       pid_t client_process_id,
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
+      UUID* local_report_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override;
+
+  bool HandleExceptionWithForkSnapshot(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int client_sock,
       UUID* local_report_id = nullptr) override;
 
+  //! \copydoc ExceptionHandlerServer::Delegate::HandleProcessGroupException()
+  //!
+  //! The client and every other member of its group are stopped before any is
+  //! captured, and stay stopped until all have been captured, so that the
+  //! reports describe a single moment. Each process gets its own report, and
+  //! the reports share a `"crashpad_process_group"` process annotation holding
+  //! a new UUID, so they can be found together. The other members are
+  //! captured without an exception, as DumpWithoutCrash() would capture them.
+  //! Members that can't be attached to are left out, and at most
+  //! kMaxProcessGroupMembers are captured. If the client requested
+  //! sanitization, which can't be applied to the other members, only the
+  //! client is captured.
+  bool HandleProcessGroupException(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      const std::vector<pid_t>& group_process_ids,
+      VMAddress requesting_thread_stack_address = 0,
+      pid_t* requesting_thread_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override;
+
+  //! \brief The most processes, besides the client, that
+  //!     HandleProcessGroupException() captures.
+  static constexpr size_t kMaxProcessGroupMembers = 32;
+
  private:
   bool HandleExceptionWithConnection(
       PtraceConnection* connection,
+      ResourceBudget::Level budget_level,
       const ExceptionHandlerProtocol::ClientInformation& info,
       uid_t client_uid,
       VMAddress requesting_thread_stack_address,
       pid_t* requesting_thread_id,
-      UUID* local_report_id = nullptr);
+      UUID* local_report_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr,
+      const std::map<std::string, std::string>* process_annotations = nullptr,
+      bool capture_exception = true);
 
   bool WriteMinidumpToDatabase(ProcessSnapshotLinux* process_snapshot,
                                ProcessSnapshotSanitized* sanitized_snapshot,
                                bool write_minidump_to_log,
+                               size_t memory_buffer_limit,
                                UUID* local_report_id);
+  bool FinishReport(std::unique_ptr<CrashReportDatabase::NewReport> new_report,
+                    const std::map<std::string, std::string>& upload_parameters,
+                    bool write_minidump_to_log,
+                    bool add_attachments,
+                    pid_t process_id,
+                    int64_t start_time_us,
+                    std::shared_ptr<MinidumpDeltaBase> recorded_delta_base,
+                    CaptureTimings* profile,
+                    UUID* local_report_id);
   bool WriteMinidumpToLog(ProcessSnapshotLinux* process_snapshot,
-                          ProcessSnapshotSanitized* sanitized_snapshot);
+                          ProcessSnapshotSanitized* sanitized_snapshot,
+                          size_t memory_buffer_limit);
 
   CrashReportDatabase* database_;  // weak
   CrashReportUploadThread* upload_thread_;  // weak
@@ -116,6 +306,32 @@ class CrashReportExceptionHandler : public ExceptionHandlerServer::Delegate {
   bool write_minidump_to_database_;
   bool write_minidump_to_log_;
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  uint64_t capture_timeout_ns_;
+  bool stack_trimming_;
+  size_t indirect_memory_depth_;
+  bool module_code_elision_;
+  bool skip_unpopulated_memory_;
+  const CapturePolicyTable* capture_policies_;  // weak
+  ResourceBudget* resource_budget_;  // weak
+  size_t report_file_pool_size_;
+  StagedReportCommitThread* staged_report_commit_thread_;  // weak
+  std::unique_ptr<DeltaDumpBaseCache> delta_dump_base_cache_;
+  bool prepare_upload_body_;
+  bool profile_captures_;
+
+  // Shared by every snapshot taken over this handler's lifetime, so that images
+  // loaded by many clients are only fully parsed once.
+  ElfImageCache elf_image_cache_;
+
+  // Lets repeated dumps of a client whose modules haven't changed, such as
+  // periodic DumpWithoutCrash() calls, skip locating them again.
+  ModuleListCache module_list_cache_;
+
+  // Finish reports in the background when SetAsyncAcknowledgement() is
+  // enabled. These are declared last so that unfinished reports are finished
+  // while everything they use still exists.
+  std::unique_ptr<ThreadPool> finish_pool_;
+  std::unique_ptr<ThreadPool::TaskGroup> finish_tasks_;
 };
 
 }  // namespace crashpad
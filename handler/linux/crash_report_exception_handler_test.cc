@@ -0,0 +1,247 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/crash_report_exception_handler.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/posix/eintr_wrapper.h"
+#include "client/crash_report_database.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/multiprocess.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/linux/exception_information.h"
+#include "util/misc/capture_context.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/posix/signals.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr char kAttachmentContents[] = "attachment";
+
+// Releases the writing end of a FIFO if it’s still held after a timeout, so
+// that a handler blocked copying the FIFO doesn’t hang the test.
+class FIFOReleaseThread final : public Thread {
+ public:
+  FIFOReleaseThread(ScopedFileHandle* writer, Semaphore* done)
+      : writer_(writer), done_(done) {}
+
+  FIFOReleaseThread(const FIFOReleaseThread&) = delete;
+  FIFOReleaseThread& operator=(const FIFOReleaseThread&) = delete;
+
+  ~FIFOReleaseThread() override = default;
+
+ private:
+  void ThreadMain() override {
+    if (!done_->TimedWait(10)) {
+      writer_->reset();
+    }
+  }
+
+  ScopedFileHandle* writer_;
+  Semaphore* done_;
+};
+
+// Has a CrashReportExceptionHandler capture a child, as though it had called
+// DumpWithoutCrash(), with an attachment added to its report. When the report
+// is expected to be finished after HandleException() returns, the attachment is
+// a FIFO, so that copying it, which happens while the report is finished,
+// blocks until the test writes to and closes the FIFO.
+class CrashReportExceptionHandlerTest : public Multiprocess {
+ public:
+  CrashReportExceptionHandlerTest(bool async_acknowledgement,
+                                  bool request_report_id)
+      : Multiprocess(),
+        async_acknowledgement_(async_acknowledgement),
+        request_report_id_(request_report_id) {}
+
+  CrashReportExceptionHandlerTest(const CrashReportExceptionHandlerTest&) =
+      delete;
+  CrashReportExceptionHandlerTest& operator=(
+      const CrashReportExceptionHandlerTest&) = delete;
+
+  ~CrashReportExceptionHandlerTest() = default;
+
+ private:
+  void MultiprocessParent() override {
+    VMAddress exception_information_address;
+    ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(),
+                                       &exception_information_address,
+                                       sizeof(exception_information_address)));
+
+    ScopedTempDir temp_dir;
+    std::unique_ptr<CrashReportDatabase> database =
+        CrashReportDatabase::Initialize(temp_dir.path().Append("database"));
+    ASSERT_TRUE(database);
+
+    const bool finished_later = async_acknowledgement_ && !request_report_id_;
+    const base::FilePath attachment_path = temp_dir.path().Append("attachment");
+    ScopedFileHandle fifo_writer;
+    if (finished_later) {
+      // Opening the FIFO for reading and writing doesn’t wait for a reader,
+      // and copying it doesn’t reach its end until this writer is closed.
+      ASSERT_EQ(mkfifo(attachment_path.value().c_str(), 0600), 0)
+          << ErrnoMessage("mkfifo");
+      fifo_writer.reset(HANDLE_EINTR(
+          open(attachment_path.value().c_str(), O_RDWR | O_CLOEXEC)));
+      ASSERT_TRUE(fifo_writer.is_valid()) << ErrnoMessage("open");
+    } else {
+      FileWriter writer;
+      ASSERT_TRUE(writer.Open(attachment_path,
+                              FileWriteMode::kCreateOrFail,
+                              FilePermissions::kOwnerOnly));
+      ASSERT_TRUE(
+          writer.Write(kAttachmentContents, strlen(kAttachmentContents)));
+    }
+
+    const std::map<std::string, std::string> process_annotations;
+    const std::vector<base::FilePath> attachments(1, attachment_path);
+    auto handler = std::make_unique<CrashReportExceptionHandler>(
+        database.get(),
+        nullptr,
+        &process_annotations,
+        &attachments,
+        true,
+        false,
+        nullptr);
+    handler->SetAsyncAcknowledgement(async_acknowledgement_);
+
+    ExceptionHandlerProtocol::ClientInformation info;
+    info.exception_information_address = exception_information_address;
+    UUID report_id;
+    Semaphore handled(0);
+    FIFOReleaseThread release_thread(&fifo_writer, &handled);
+    release_thread.Start();
+    const bool result =
+        handler->HandleException(ChildPID(),
+                                 getuid(),
+                                 info,
+                                 0,
+                                 nullptr,
+                                 request_report_id_ ? &report_id : nullptr);
+    handled.Signal();
+    release_thread.Join();
+    ASSERT_TRUE(result);
+
+    std::vector<CrashReportDatabase::Report> reports;
+    ASSERT_EQ(database->GetPendingReports(&reports),
+              CrashReportDatabase::kNoError);
+    if (finished_later) {
+      // The client was released before its report was finished, which is
+      // waiting on the attachment. Nothing is committed until it’s done.
+      ASSERT_TRUE(fifo_writer.is_valid())
+          << "HandleException() didn’t return before its report was finished";
+      EXPECT_TRUE(reports.empty());
+      ASSERT_TRUE(LoggingWriteFile(fifo_writer.get(),
+                                   kAttachmentContents,
+                                   strlen(kAttachmentContents)));
+      fifo_writer.reset();
+
+      // Destroying the handler finishes its unfinished reports.
+      handler.reset();
+      ASSERT_EQ(database->GetPendingReports(&reports),
+                CrashReportDatabase::kNoError);
+      ASSERT_EQ(reports.size(), 1u);
+    } else {
+      // The report was committed before HandleException() returned.
+      ASSERT_EQ(reports.size(), 1u);
+      if (request_report_id_) {
+        EXPECT_EQ(reports[0].uuid, report_id);
+      }
+    }
+
+    std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+    ASSERT_EQ(database->GetReportForUploading(reports[0].uuid, &upload_report),
+              CrashReportDatabase::kNoError);
+    std::map<std::string, FileReader*> report_attachments =
+        upload_report->GetAttachments();
+    ASSERT_EQ(report_attachments.size(), 1u);
+    ASSERT_EQ(report_attachments.begin()->first, "attachment");
+    std::string contents;
+    char buf[64];
+    FileOperationResult bytes_read;
+    while ((bytes_read = report_attachments.begin()->second->Read(
+                buf, sizeof(buf))) > 0) {
+      contents.append(buf, bytes_read);
+    }
+    EXPECT_EQ(contents, kAttachmentContents);
+  }
+
+  void MultiprocessChild() override {
+    // The exception is simulated, as it is by DumpWithoutCrash().
+    siginfo_t siginfo = {};
+    siginfo.si_signo = Signals::kSimulatedSigno;
+    NativeCPUContext context;
+    CaptureContext(&context);
+
+    ExceptionInformation exception_information;
+    exception_information.siginfo_address =
+        FromPointerCast<VMAddress>(&siginfo);
+    exception_information.context_address =
+        FromPointerCast<VMAddress>(&context);
+    exception_information.thread_id = syscall(SYS_gettid);
+    const VMAddress exception_information_address =
+        FromPointerCast<VMAddress>(&exception_information);
+    CheckedWriteFile(WritePipeHandle(),
+                     &exception_information_address,
+                     sizeof(exception_information_address));
+
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+
+  const bool async_acknowledgement_;
+  const bool request_report_id_;
+};
+
+TEST(CrashReportExceptionHandler, AsyncAcknowledgement) {
+  CrashReportExceptionHandlerTest test(/*async_acknowledgement=*/true,
+                                       /*request_report_id=*/false);
+  test.Run();
+}
+
+TEST(CrashReportExceptionHandler, AsyncAcknowledgementWithReportID) {
+  // A caller asking for the report’s ID waits for the report to be committed.
+  CrashReportExceptionHandlerTest test(/*async_acknowledgement=*/true,
+                                       /*request_report_id=*/true);
+  test.Run();
+}
+
+TEST(CrashReportExceptionHandler, SyncAcknowledgement) {
+  CrashReportExceptionHandlerTest test(/*async_acknowledgement=*/false,
+                                       /*request_report_id=*/false);
+  test.Run();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -28,10 +28,15 @@
 #include "snapshot/linux/process_snapshot_linux.h"
 #include "snapshot/minidump/process_snapshot_minidump.h"
 #include "snapshot/sanitized/process_snapshot_sanitized.h"
+#include "util/file/file_io.h"
 #include "util/file/file_writer.h"
 #include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/fork_snapshot_connection.h"
 #include "util/linux/ptrace_client.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_event.h"
 #include "util/misc/uuid.h"
 #include "util/posix/spawn_subprocess.h"
 
@@ -39,6 +44,10 @@ namespace crashpad {
 
 namespace {
 
+// The most memory snapshot data held at once while writing a minidump when the
+// resource budget is tight.
+constexpr size_t kReducedMemoryBufferLimit = 64 * 1024;
+
 // Returns the process name for a pid.
 const std::string GetProcessNameFromPid(pid_t pid) {
   // Symlink to process binary is at /proc/###/exe.
@@ -138,7 +147,16 @@ CrosCrashReportExceptionHandler::CrosCrashReportExceptionHandler(
     : database_(database),
       process_annotations_(process_annotations),
       user_stream_data_sources_(user_stream_data_sources),
-      always_allow_feedback_(false) {}
+      always_allow_feedback_(false),
+      capture_timeout_ns_(0),
+      stack_trimming_(false),
+      indirect_memory_depth_(1),
+      module_code_elision_(false),
+      skip_unpopulated_memory_(false),
+      capture_policies_(nullptr),
+      resource_budget_(nullptr),
+      elf_image_cache_(),
+      module_list_cache_() {}
 
 CrosCrashReportExceptionHandler::~CrosCrashReportExceptionHandler() = default;
 
@@ -148,9 +166,11 @@ bool CrosCrashReportExceptionHandler::HandleException(
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
   Metrics::ExceptionEncountered();
 
+  ResourceBudget::ScopedCapture capture(resource_budget_);
   DirectPtraceConnection connection;
   if (!connection.Initialize(client_process_id)) {
     Metrics::ExceptionCaptureResult(
@@ -159,11 +179,13 @@ bool CrosCrashReportExceptionHandler::HandleException(
   }
 
   return HandleExceptionWithConnection(&connection,
+                                       capture.level(),
                                        info,
                                        client_uid,
                                        requesting_thread_stack_address,
                                        requesting_thread_id,
-                                       local_report_id);
+                                       local_report_id,
+                                       shared_context);
 }
 
 bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
@@ -171,9 +193,11 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
     uid_t client_uid,
     const ExceptionHandlerProtocol::ClientInformation& info,
     int broker_sock,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
   Metrics::ExceptionEncountered();
 
+  ResourceBudget::ScopedCapture capture(resource_budget_);
   PtraceClient client;
   if (!client.Initialize(broker_sock, client_process_id)) {
     Metrics::ExceptionCaptureResult(
@@ -181,25 +205,91 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithBroker(
     return false;
   }
 
-  return HandleExceptionWithConnection(
-      &client, info, client_uid, 0, nullptr, local_report_id);
+  return HandleExceptionWithConnection(&client,
+                                       capture.level(),
+                                       info,
+                                       client_uid,
+                                       0,
+                                       nullptr,
+                                       local_report_id,
+                                       shared_context);
+}
+
+bool CrosCrashReportExceptionHandler::HandleExceptionWithForkSnapshot(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    int client_sock,
+    UUID* local_report_id) {
+  Metrics::ExceptionEncountered();
+
+  ResourceBudget::ScopedCapture capture(resource_budget_);
+  ForkSnapshotConnection fork_connection;
+  DirectPtraceConnection direct_connection;
+  PtraceConnection* connection = &fork_connection;
+  if (!fork_connection.Initialize(client_sock, client_process_id)) {
+    // The client is still waiting for its crash dump, so capture it directly.
+    LOG(WARNING) << "capturing without a fork snapshot";
+    if (!direct_connection.Initialize(client_process_id)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kForkSnapshotFailed);
+      return false;
+    }
+    connection = &direct_connection;
+  }
+
+  return HandleExceptionWithConnection(connection,
+                                       capture.level(),
+                                       info,
+                                       client_uid,
+                                       0,
+                                       nullptr,
+                                       local_report_id);
 }
 
 bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
     PtraceConnection* connection,
+    ResourceBudget::Level budget_level,
     const ExceptionHandlerProtocol::ClientInformation& info,
     uid_t client_uid,
     VMAddress requesting_thread_stack_address,
     pid_t* requesting_thread_id,
-    UUID* local_report_id) {
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
+  CRASHPAD_TRACE_EVENT(
+      "handler",
+      "CrosCrashReportExceptionHandler::HandleExceptionWithConnection");
+  Metrics::ExceptionCaptureStarted();
+  const uint64_t capture_deadline =
+      capture_timeout_ns_ ? ClockMonotonicNanoseconds() + capture_timeout_ns_
+                          : 0;
+
+  // A tight budget leaves optional data out of the snapshot, and limits how
+  // much memory is held at once while writing it.
+  const bool reduced = budget_level != ResourceBudget::Level::kNormal;
+  if (reduced) {
+    LOG(WARNING) << "resource budget is tight, reducing capture";
+  }
+
   std::unique_ptr<ProcessSnapshotLinux> process_snapshot;
   std::unique_ptr<ProcessSnapshotSanitized> sanitized_snapshot;
   if (!CaptureSnapshot(connection,
                        info,
+                       /*capture_exception=*/true,
                        *process_annotations_,
                        client_uid,
                        requesting_thread_stack_address,
                        requesting_thread_id,
+                       shared_context,
+                       capture_deadline,
+                       &elf_image_cache_,
+                       &module_list_cache_,
+                       stack_trimming_ || reduced,
+                       reduced ? 0 : indirect_memory_depth_,
+                       module_code_elision_ || reduced,
+                       skip_unpopulated_memory_,
+                       /*profile=*/false,
+                       capture_policies_,
                        &process_snapshot,
                        &sanitized_snapshot)) {
     return false;
@@ -225,8 +315,13 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
           : implicit_cast<ProcessSnapshot*>(process_snapshot.get());
 
   MinidumpFileWriter minidump;
-  minidump.InitializeFromSnapshot(snapshot);
-  AddUserExtensionStreams(user_stream_data_sources_, snapshot, &minidump);
+  InitializeMinidumpFromSnapshot(process_snapshot.get(),
+                                 snapshot,
+                                 user_stream_data_sources_,
+                                 &minidump);
+  if (reduced) {
+    minidump.SetMemoryBufferLimit(kReducedMemoryBufferLimit);
+  }
 
   FileWriter file_writer;
   if (!file_writer.OpenMemfd(base::FilePath("minidump"))) {
@@ -240,11 +335,26 @@ bool CrosCrashReportExceptionHandler::HandleExceptionWithConnection(
   // ramping up.
   parameters.emplace("crash_library", "crashpad");
 
-  if (!WriteAnnotationsAndMinidump(parameters, minidump, file_writer)) {
-    Metrics::ExceptionCaptureResult(
-        Metrics::CaptureResult::kMinidumpWriteFailed);
-    return false;
+  {
+    ScopedCapturePhase capture_phase(process_snapshot->Timings(),
+                                     CapturePhase::kWrite,
+                                     process_snapshot->Memory());
+    if (!WriteAnnotationsAndMinidump(parameters, minidump, file_writer)) {
+      Metrics::ExceptionCaptureResult(
+          Metrics::CaptureResult::kMinidumpWriteFailed);
+      return false;
+    }
   }
+  process_snapshot->Timings()->ReportMetrics();
+  Metrics::MinidumpWriteCompleted(
+      process_snapshot->Timings()->Get(CapturePhase::kWrite).duration_ns);
+  process_snapshot->MemoryCache()->ReportMetrics();
+
+  // The report is complete, so seal it before handing it off. crash_reporter
+  // can then read the sealed file in place, without first copying it to guard
+  // against modification. Kernels and fallback files that don't support
+  // sealing still hand off the unsealed file as before.
+  LoggingSealMemoryFile(file_writer.fd());
 
   // CrOS uses crash_reporter instead of Crashpad to report crashes.
   // crash_reporter needs to know the pid and uid of the crashing process.
@@ -15,12 +15,19 @@
 #ifndef CRASHPAD_HANDLER_LINUX_CROS_CRASH_REPORT_EXCEPTION_HANDLER_H_
 #define CRASHPAD_HANDLER_LINUX_CROS_CRASH_REPORT_EXCEPTION_HANDLER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <map>
 #include <string>
 
 #include "client/crash_report_database.h"
+#include "handler/capture_policy.h"
 #include "handler/linux/exception_handler_server.h"
+#include "handler/resource_budget.h"
 #include "handler/user_stream_data_source.h"
+#include "snapshot/elf/elf_image_cache.h"
+#include "snapshot/linux/module_list_cache.h"
 #include "util/linux/exception_handler_protocol.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
@@ -71,31 +78,72 @@ class CrosCrashReportExceptionHandler
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address = 0,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override;
+                       UUID* local_report_id = nullptr,
+                       const SharedCrashContext* shared_context =
+                           nullptr) override;
 
   bool HandleExceptionWithBroker(
       pid_t client_process_id,
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
+      UUID* local_report_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override;
+
+  bool HandleExceptionWithForkSnapshot(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int client_sock,
       UUID* local_report_id = nullptr) override;
 
   void SetDumpDir(const base::FilePath& dump_dir) { dump_dir_ = dump_dir; }
   void SetAlwaysAllowFeedback() { always_allow_feedback_ = true; }
+  void SetCaptureTimeout(uint64_t timeout_ns) {
+    capture_timeout_ns_ = timeout_ns;
+  }
+  void SetStackTrimming(bool enabled) { stack_trimming_ = enabled; }
+  void SetIndirectMemoryDepth(size_t depth) { indirect_memory_depth_ = depth; }
+  void SetModuleCodeElision(bool enabled) { module_code_elision_ = enabled; }
+  void SetSkipUnpopulatedMemory(bool enabled) {
+    skip_unpopulated_memory_ = enabled;
+  }
+  void SetCapturePolicies(const CapturePolicyTable* policies) {
+    capture_policies_ = policies;
+  }
+  void SetResourceBudget(ResourceBudget* budget) { resource_budget_ = budget; }
+
  private:
   bool HandleExceptionWithConnection(
       PtraceConnection* connection,
+      ResourceBudget::Level budget_level,
       const ExceptionHandlerProtocol::ClientInformation& info,
       uid_t client_uid,
       VMAddress requesting_thread_stack_address,
       pid_t* requesting_thread_id,
-      UUID* local_report_id = nullptr);
+      UUID* local_report_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr);
 
   CrashReportDatabase* database_;  // weak
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
   base::FilePath dump_dir_;
   bool always_allow_feedback_;
+  uint64_t capture_timeout_ns_;
+  bool stack_trimming_;
+  size_t indirect_memory_depth_;
+  bool module_code_elision_;
+  bool skip_unpopulated_memory_;
+  const CapturePolicyTable* capture_policies_;  // weak
+  ResourceBudget* resource_budget_;  // weak
+
+  // Shared by every snapshot taken over this handler's lifetime, so that images
+  // loaded by many clients are only fully parsed once.
+  ElfImageCache elf_image_cache_;
+
+  // Lets repeated dumps of a client whose modules haven't changed, such as
+  // periodic DumpWithoutCrash() calls, skip locating them again.
+  ModuleListCache module_list_cache_;
 };
 
 }  // namespace crashpad
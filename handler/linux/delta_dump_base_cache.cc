@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/delta_dump_base_cache.h"
+
+#include <utility>
+
+namespace crashpad {
+
+DeltaDumpBaseCache::DeltaDumpBaseCache(size_t max_deltas_per_base,
+                                       size_t max_entries)
+    : lock_(),
+      entries_(),
+      max_deltas_per_base_(max_deltas_per_base),
+      max_entries_(max_entries),
+      next_sequence_(0) {}
+
+DeltaDumpBaseCache::~DeltaDumpBaseCache() = default;
+
+std::shared_ptr<const MinidumpDeltaBase> DeltaDumpBaseCache::Lookup(
+    pid_t pid,
+    int64_t start_time_us) {
+  base::AutoLock lock(lock_);
+  auto iter = entries_.find(pid);
+  if (iter == entries_.end()) {
+    return nullptr;
+  }
+
+  Entry& entry = iter->second;
+  if (entry.start_time_us != start_time_us) {
+    // The process ID was reused, so the entry is of no further use.
+    entries_.erase(iter);
+    return nullptr;
+  }
+  if (entry.deltas >= max_deltas_per_base_) {
+    return nullptr;
+  }
+  ++entry.deltas;
+  return entry.base;
+}
+
+void DeltaDumpBaseCache::Insert(pid_t pid,
+                                int64_t start_time_us,
+                                std::shared_ptr<const MinidumpDeltaBase> base) {
+  base::AutoLock lock(lock_);
+  if (max_entries_ == 0) {
+    return;
+  }
+
+  auto iter = entries_.find(pid);
+  if (iter == entries_.end() && entries_.size() >= max_entries_) {
+    auto oldest = entries_.begin();
+    for (auto candidate = entries_.begin(); candidate != entries_.end();
+         ++candidate) {
+      if (candidate->second.sequence < oldest->second.sequence) {
+        oldest = candidate;
+      }
+    }
+    entries_.erase(oldest);
+  }
+
+  Entry& entry = entries_[pid];
+  entry.base = std::move(base);
+  entry.start_time_us = start_time_us;
+  entry.deltas = 0;
+  entry.sequence = next_sequence_++;
+}
+
+size_t DeltaDumpBaseCache::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_DELTA_DUMP_BASE_CACHE_H_
+#define CRASHPAD_HANDLER_LINUX_DELTA_DUMP_BASE_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+
+#include "base/synchronization/lock.h"
+#include "minidump/minidump_delta_base.h"
+
+namespace crashpad {
+
+//! \brief Retains the MinidumpDeltaBase of the last full minidump file written
+//!     for each process, so that later minidump files of the same process may
+//!     be written as deltas against it.
+//!
+//! Entries are keyed by process ID and validated by the process’ start time,
+//! so that a base is never used for a different process that reused the ID.
+//! Each base is handed out for a limited number of deltas, after which the
+//! next minidump file of the process must be written in full, so that readers
+//! needn’t keep a process’ base reports indefinitely.
+//!
+//! This class is thread-safe.
+class DeltaDumpBaseCache {
+ public:
+  //! \brief The default value for \a max_entries in the constructor.
+  static constexpr size_t kDefaultMaxEntries = 16;
+
+  //! \param[in] max_deltas_per_base The number of deltas that may be written
+  //!     against each base.
+  //! \param[in] max_entries The maximum number of processes to retain. Once
+  //!     full, adding a new process evicts the one that was added least
+  //!     recently.
+  explicit DeltaDumpBaseCache(size_t max_deltas_per_base,
+                              size_t max_entries = kDefaultMaxEntries);
+
+  DeltaDumpBaseCache(const DeltaDumpBaseCache&) = delete;
+  DeltaDumpBaseCache& operator=(const DeltaDumpBaseCache&) = delete;
+
+  ~DeltaDumpBaseCache();
+
+  //! \brief Looks up the base to write a delta of a process against, counting
+  //!     it as used for another delta.
+  //!
+  //! \param[in] pid The process ID.
+  //! \param[in] start_time_us The process’ start time, in microseconds since
+  //!     the epoch.
+  //! \return The base, or `nullptr` if there is none for the process, or if
+  //!     it has been used for as many deltas as allowed. In that case, a full
+  //!     minidump file should be written, and its base recorded with Insert().
+  std::shared_ptr<const MinidumpDeltaBase> Lookup(pid_t pid,
+                                                  int64_t start_time_us);
+
+  //! \brief Adds the base of a full minidump file of a process to the cache,
+  //!     replacing any existing entry for it.
+  //!
+  //! \param[in] pid The process ID.
+  //! \param[in] start_time_us The process’ start time, in microseconds since
+  //!     the epoch.
+  //! \param[in] base The base recorded while writing the minidump file.
+  void Insert(pid_t pid,
+              int64_t start_time_us,
+              std::shared_ptr<const MinidumpDeltaBase> base);
+
+  //! \brief Returns the number of processes in the cache.
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const MinidumpDeltaBase> base;
+    int64_t start_time_us;
+    size_t deltas;
+    uint64_t sequence;
+  };
+
+  mutable base::Lock lock_;
+  std::map<pid_t, Entry> entries_;
+  size_t max_deltas_per_base_;
+  size_t max_entries_;
+  uint64_t next_sequence_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_DELTA_DUMP_BASE_CACHE_H_
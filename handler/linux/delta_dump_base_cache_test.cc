@@ -0,0 +1,72 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/delta_dump_base_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(DeltaDumpBaseCache, LimitsDeltasPerBase) {
+  DeltaDumpBaseCache cache(2);
+  EXPECT_FALSE(cache.Lookup(1, 100));
+
+  auto base = std::make_shared<MinidumpDeltaBase>();
+  cache.Insert(1, 100, base);
+  EXPECT_EQ(cache.size(), 1u);
+
+  EXPECT_EQ(cache.Lookup(1, 100), base);
+  EXPECT_EQ(cache.Lookup(1, 100), base);
+  EXPECT_FALSE(cache.Lookup(1, 100));
+
+  // A new base for the process starts a new series of deltas.
+  auto new_base = std::make_shared<MinidumpDeltaBase>();
+  cache.Insert(1, 100, new_base);
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.Lookup(1, 100), new_base);
+}
+
+TEST(DeltaDumpBaseCache, ReusedProcessID) {
+  DeltaDumpBaseCache cache(4);
+  cache.Insert(1, 100, std::make_shared<MinidumpDeltaBase>());
+
+  // A process with the same ID that started at a different time is a different
+  // process, and its predecessor’s entry is dropped.
+  EXPECT_FALSE(cache.Lookup(1, 200));
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_FALSE(cache.Lookup(1, 100));
+}
+
+TEST(DeltaDumpBaseCache, EvictsOldest) {
+  DeltaDumpBaseCache cache(4, 2);
+  auto base_1 = std::make_shared<MinidumpDeltaBase>();
+  auto base_2 = std::make_shared<MinidumpDeltaBase>();
+  auto base_3 = std::make_shared<MinidumpDeltaBase>();
+  cache.Insert(1, 100, base_1);
+  cache.Insert(2, 100, base_2);
+  cache.Insert(3, 100, base_3);
+  EXPECT_EQ(cache.size(), 2u);
+
+  EXPECT_FALSE(cache.Lookup(1, 100));
+  EXPECT_EQ(cache.Lookup(2, 100), base_2);
+  EXPECT_EQ(cache.Lookup(3, 100), base_3);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
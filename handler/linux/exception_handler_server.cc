@@ -23,6 +23,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <deque>
 #include <utility>
 
 #include "base/check_op.h"
@@ -30,12 +31,16 @@
 #include "base/logging.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "util/file/file_io.h"
 #include "util/file/filesystem.h"
 #include "util/linux/proc_task_reader.h"
+#include "util/linux/process_group.h"
 #include "util/linux/socket.h"
 #include "util/misc/as_underlying_type.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
@@ -237,12 +242,153 @@ class PtraceStrategyDeciderImpl : public PtraceStrategyDecider {
 
 }  // namespace
 
+// Handles crash dump requests on a fixed number of threads. Completed requests
+// are collected here and the server is woken through its dump complete event,
+// so that client sockets are only ever installed and uninstalled on the thread
+// running ExceptionHandlerServer::Run().
+class ExceptionHandlerServer::DumpDispatcher {
+ public:
+  DumpDispatcher(ExceptionHandlerServer* server,
+                 int complete_fd,
+                 size_t thread_count)
+      : pending_(),
+        completed_(),
+        threads_(),
+        lock_(),
+        pending_semaphore_(0),
+        server_(server),
+        complete_fd_(complete_fd) {
+    for (size_t index = 0; index < thread_count; ++index) {
+      threads_.push_back(std::make_unique<DumpThread>(this));
+    }
+  }
+
+  DumpDispatcher(const DumpDispatcher&) = delete;
+  DumpDispatcher& operator=(const DumpDispatcher&) = delete;
+
+  ~DumpDispatcher() = default;
+
+  void Start() {
+    for (const auto& thread : threads_) {
+      thread->Start();
+    }
+  }
+
+  // Queues request to be handled on the next free thread.
+  void Post(std::unique_ptr<DumpRequest> request) {
+    DCHECK(request);
+    {
+      base::AutoLock lock(lock_);
+      pending_.push_back(std::move(request));
+    }
+    pending_semaphore_.Signal();
+  }
+
+  // Moves the requests that have been handled since the last call into
+  // completed, which must be empty.
+  void TakeCompleted(std::vector<std::unique_ptr<DumpRequest>>* completed) {
+    DCHECK(completed->empty());
+    base::AutoLock lock(lock_);
+    completed->swap(completed_);
+  }
+
+  // Waits for every queued request to be handled, then joins the threads.
+  void Stop() {
+    {
+      base::AutoLock lock(lock_);
+      for (size_t index = 0; index < threads_.size(); ++index) {
+        pending_.push_back(nullptr);
+      }
+    }
+    for (size_t index = 0; index < threads_.size(); ++index) {
+      pending_semaphore_.Signal();
+    }
+    for (const auto& thread : threads_) {
+      thread->Join();
+    }
+  }
+
+ private:
+  class DumpThread final : public Thread {
+   public:
+    explicit DumpThread(DumpDispatcher* dispatcher)
+        : Thread(), dispatcher_(dispatcher) {}
+
+    DumpThread(const DumpThread&) = delete;
+    DumpThread& operator=(const DumpThread&) = delete;
+
+    ~DumpThread() override = default;
+
+   private:
+    // Thread:
+    void ThreadMain() override { dispatcher_->ThreadMain(); }
+
+    DumpDispatcher* dispatcher_;  // weak
+  };
+
+  void ThreadMain() {
+    while (true) {
+      pending_semaphore_.Wait();
+
+      std::unique_ptr<DumpRequest> request;
+      {
+        base::AutoLock lock(lock_);
+        DCHECK(!pending_.empty());
+        request = std::move(pending_.front());
+        pending_.pop_front();
+      }
+
+      // A nullptr request, queued by Stop(), follows every real request.
+      if (!request) {
+        return;
+      }
+
+      server_->RunDumpRequest(request.get());
+
+      {
+        base::AutoLock lock(lock_);
+        completed_.push_back(std::move(request));
+      }
+      uint64_t value = 1;
+      LoggingWriteFile(complete_fd_, &value, sizeof(value));
+    }
+  }
+
+  std::deque<std::unique_ptr<DumpRequest>> pending_;
+  std::vector<std::unique_ptr<DumpRequest>> completed_;
+  std::vector<std::unique_ptr<DumpThread>> threads_;
+  base::Lock lock_;
+  Semaphore pending_semaphore_;
+  ExceptionHandlerServer* server_;  // weak
+  int complete_fd_;
+};
+
+bool ExceptionHandlerServer::Delegate::HandleProcessGroupException(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    const std::vector<pid_t>& group_process_ids,
+    VMAddress requesting_thread_stack_address,
+    pid_t* requesting_thread_id,
+    const SharedCrashContext* shared_context) {
+  return HandleException(client_process_id,
+                         client_uid,
+                         info,
+                         requesting_thread_stack_address,
+                         requesting_thread_id,
+                         nullptr,
+                         shared_context);
+}
+
 ExceptionHandlerServer::ExceptionHandlerServer()
     : clients_(),
       shutdown_event_(),
+      dump_complete_event_(),
       strategy_decider_(new PtraceStrategyDeciderImpl()),
+      dispatcher_(),
       delegate_(nullptr),
       pollfd_(),
+      max_concurrent_dumps_(1),
       keep_running_(true) {}
 
 ExceptionHandlerServer::~ExceptionHandlerServer() = default;
@@ -252,6 +398,13 @@ void ExceptionHandlerServer::SetPtraceStrategyDecider(
   strategy_decider_ = std::move(decider);
 }
 
+void ExceptionHandlerServer::SetMaxConcurrentDumps(
+    size_t max_concurrent_dumps) {
+  DCHECK(!delegate_);
+  DCHECK_GT(max_concurrent_dumps, 0u);
+  max_concurrent_dumps_ = max_concurrent_dumps;
+}
+
 bool ExceptionHandlerServer::InitializeWithClient(ScopedFileHandle sock,
                                                   bool multiple_clients) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
@@ -295,12 +448,37 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   delegate_ = delegate;
 
+  if (max_concurrent_dumps_ > 1) {
+    dump_complete_event_ = std::make_unique<Event>();
+    dump_complete_event_->type = Event::Type::kDumpComplete;
+    dump_complete_event_->fd.reset(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+    if (!dump_complete_event_->fd.is_valid()) {
+      PLOG(ERROR) << "eventfd";
+      return;
+    }
+
+    epoll_event poll_event;
+    poll_event.events = EPOLLIN;
+    poll_event.data.ptr = dump_complete_event_.get();
+    if (epoll_ctl(pollfd_.get(),
+                  EPOLL_CTL_ADD,
+                  dump_complete_event_->fd.get(),
+                  &poll_event) != 0) {
+      PLOG(ERROR) << "epoll_ctl";
+      return;
+    }
+
+    dispatcher_ = std::make_unique<DumpDispatcher>(
+        this, dump_complete_event_->fd.get(), max_concurrent_dumps_);
+    dispatcher_->Start();
+  }
+
   while (keep_running_ && clients_.size() > 0) {
     epoll_event poll_event;
     int res = HANDLE_EINTR(epoll_wait(pollfd_.get(), &poll_event, 1, -1));
     if (res < 0) {
       PLOG(ERROR) << "epoll_wait";
-      return;
+      break;
     }
     DCHECK_EQ(res, 1);
 
@@ -310,10 +488,18 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
         LogSocketError(eventp->fd.get());
       }
       keep_running_ = false;
+    } else if (eventp->type == Event::Type::kDumpComplete) {
+      HandleCompletedDumps();
     } else {
       HandleEvent(eventp, poll_event.events);
     }
   }
+
+  if (dispatcher_) {
+    // Finish the requests that have already been received, rather than leaving
+    // their clients waiting for a response that will never come.
+    dispatcher_->Stop();
+  }
 }
 
 void ExceptionHandlerServer::Stop() {
@@ -335,7 +521,8 @@ void ExceptionHandlerServer::HandleEvent(Event* event, uint32_t event_type) {
   }
 
   if (event_type & EPOLLIN) {
-    if (!ReceiveClientMessage(event)) {
+    if (!ReceiveClientMessage(event) ||
+        (event->dumps_in_flight == 0 && !RearmClientSocket(event))) {
       UninstallClientSocket(event);
     }
     return;
@@ -375,6 +562,8 @@ bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
   auto event = std::make_unique<Event>();
   event->type = type;
   event->fd.reset(socket.release());
+  event->dumps_in_flight = 0;
+  event->uninstall_pending = false;
 
   Event* eventp = event.get();
 
@@ -384,8 +573,15 @@ bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
     return false;
   }
 
+  // A private connection is disabled after each event until its message has
+  // been handled, because handling a crash dump request, possibly on a dump
+  // thread, involves further communication on the socket. A shared connection
+  // carries independent messages from many clients, and stays enabled.
   epoll_event poll_event;
   poll_event.events = EPOLLIN | EPOLLRDHUP;
+  if (type == Event::Type::kClientMessage) {
+    poll_event.events |= EPOLLONESHOT;
+  }
   poll_event.data.ptr = eventp;
 
   if (epoll_ctl(pollfd_.get(), EPOLL_CTL_ADD, eventp->fd.get(), &poll_event) !=
@@ -398,12 +594,35 @@ bool ExceptionHandlerServer::InstallClientSocket(ScopedFileHandle socket,
   return true;
 }
 
+bool ExceptionHandlerServer::RearmClientSocket(Event* event) {
+  if (event->type != Event::Type::kClientMessage) {
+    return true;
+  }
+
+  epoll_event poll_event;
+  poll_event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  poll_event.data.ptr = event;
+  if (epoll_ctl(pollfd_.get(), EPOLL_CTL_MOD, event->fd.get(), &poll_event) !=
+      0) {
+    PLOG(ERROR) << "epoll_ctl";
+    return false;
+  }
+  return true;
+}
+
 bool ExceptionHandlerServer::UninstallClientSocket(Event* event) {
   if (epoll_ctl(pollfd_.get(), EPOLL_CTL_DEL, event->fd.get(), nullptr) != 0) {
     PLOG(ERROR) << "epoll_ctl";
     return false;
   }
 
+  // Dump threads are still using the socket, so it is closed once they are
+  // done with it, in HandleCompletedDumps().
+  if (event->dumps_in_flight > 0) {
+    event->uninstall_pending = true;
+    return true;
+  }
+
   if (clients_.erase(event->fd.get()) != 1) {
     LOG(ERROR) << "event not found";
     return false;
@@ -415,8 +634,9 @@ bool ExceptionHandlerServer::UninstallClientSocket(Event* event) {
 bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
   ExceptionHandlerProtocol::ClientToServerMessage message;
   ucred creds;
+  std::vector<ScopedFileHandle> fds;
   if (!UnixCredentialSocket::RecvMsg(
-          event->fd.get(), &message, sizeof(message), &creds)) {
+          event->fd.get(), &message, sizeof(message), &creds, &fds)) {
     return false;
   }
 
@@ -424,13 +644,39 @@ bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
     case ExceptionHandlerProtocol::ClientToServerMessage::kTypeCheckCredentials:
       return SendCredentials(event->fd.get());
 
-    case ExceptionHandlerProtocol::ClientToServerMessage::kTypeCrashDumpRequest:
+    case ExceptionHandlerProtocol::ClientToServerMessage::
+        kTypeCrashDumpRequest: {
+      // A client may send a SharedCrashContext along with its request. If it
+      // can't be read, the crash is still captured from the client directly.
+      std::unique_ptr<SharedCrashContext> shared_context;
+      if (!fds.empty()) {
+        shared_context = std::make_unique<SharedCrashContext>();
+        if (!shared_context->InitializeFromHandle(fds[0].get())) {
+          shared_context.reset();
+        }
+      }
+
+      if (dispatcher_) {
+        auto request = std::make_unique<DumpRequest>();
+        request->creds = creds;
+        request->client_info = message.client_info;
+        request->requesting_thread_stack_address =
+            message.requesting_thread_stack_address;
+        request->shared_context = std::move(shared_context);
+        request->event = event;
+        request->result = false;
+        ++event->dumps_in_flight;
+        dispatcher_->Post(std::move(request));
+        return true;
+      }
       return HandleCrashDumpRequest(
           creds,
           message.client_info,
           message.requesting_thread_stack_address,
+          shared_context.get(),
           event->fd.get(),
           event->type == Event::Type::kSharedSocketMessage);
+    }
   }
 
   DCHECK(false);
@@ -438,10 +684,51 @@ bool ExceptionHandlerServer::ReceiveClientMessage(Event* event) {
   return false;
 }
 
+void ExceptionHandlerServer::HandleCompletedDumps() {
+  // The event's count only serves to wake this thread. TakeCompleted()
+  // returns every request handled so far, however many writes that reflects.
+  uint64_t value;
+  if (HANDLE_EINTR(read(
+          dump_complete_event_->fd.get(), &value, sizeof(value))) < 0 &&
+      errno != EAGAIN) {
+    PLOG(ERROR) << "read";
+  }
+
+  std::vector<std::unique_ptr<DumpRequest>> completed;
+  dispatcher_->TakeCompleted(&completed);
+  for (const auto& request : completed) {
+    Event* event = request->event;
+    DCHECK_GT(event->dumps_in_flight, 0u);
+    --event->dumps_in_flight;
+
+    if (event->uninstall_pending) {
+      if (event->dumps_in_flight == 0) {
+        clients_.erase(event->fd.get());
+      }
+      continue;
+    }
+
+    if (!request->result || !RearmClientSocket(event)) {
+      UninstallClientSocket(event);
+    }
+  }
+}
+
+void ExceptionHandlerServer::RunDumpRequest(DumpRequest* request) {
+  request->result = HandleCrashDumpRequest(
+      request->creds,
+      request->client_info,
+      request->requesting_thread_stack_address,
+      request->shared_context.get(),
+      request->event->fd.get(),
+      request->event->type == Event::Type::kSharedSocketMessage);
+}
+
 bool ExceptionHandlerServer::HandleCrashDumpRequest(
     const ucred& creds,
     const ExceptionHandlerProtocol::ClientInformation& client_info,
     VMAddress requesting_thread_stack_address,
+    const SharedCrashContext* shared_context,
     int client_sock,
     bool multiple_clients) {
   pid_t client_process_id = creds.pid;
@@ -467,11 +754,38 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
               kTypeCrashDumpFailed);
 
     case PtraceStrategyDecider::Strategy::kDirectPtrace: {
-      delegate_->HandleException(client_process_id,
-                                 client_uid,
-                                 client_info,
-                                 requesting_thread_stack_address,
-                                 &requesting_thread_id);
+      if (client_info.capture_process_group ==
+          ExceptionHandlerProtocol::kBoolTrue) {
+        // If the group can't be read, the client is still captured alone.
+        std::vector<pid_t> group_process_ids;
+        if (!ReadProcessGroupMembers(
+                client_process_id, client_uid, &group_process_ids)) {
+          group_process_ids.clear();
+        }
+        delegate_->HandleProcessGroupException(client_process_id,
+                                               client_uid,
+                                               client_info,
+                                               group_process_ids,
+                                               requesting_thread_stack_address,
+                                               &requesting_thread_id,
+                                               shared_context);
+      } else if (client_info.fork_snapshot ==
+                     ExceptionHandlerProtocol::kBoolTrue &&
+                 !multiple_clients) {
+        // Making the copy requires exchanging messages with the requesting
+        // thread, which clients on a shared connection don't do.
+        delegate_->HandleExceptionWithForkSnapshot(
+            client_process_id, client_uid, client_info, client_sock);
+        break;
+      } else {
+        delegate_->HandleException(client_process_id,
+                                   client_uid,
+                                   client_info,
+                                   requesting_thread_stack_address,
+                                   &requesting_thread_id,
+                                   nullptr,
+                                   shared_context);
+      }
       if (multiple_clients) {
         SendSIGCONT(client_process_id, requesting_thread_id);
         return true;
@@ -481,8 +795,12 @@ bool ExceptionHandlerServer::HandleCrashDumpRequest(
 
     case PtraceStrategyDecider::Strategy::kUseBroker:
       DCHECK(!multiple_clients);
-      delegate_->HandleExceptionWithBroker(
-          client_process_id, client_uid, client_info, client_sock);
+      delegate_->HandleExceptionWithBroker(client_process_id,
+                                           client_uid,
+                                           client_info,
+                                           client_sock,
+                                           nullptr,
+                                           shared_context);
       break;
   }
 
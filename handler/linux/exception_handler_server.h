@@ -21,9 +21,11 @@
 #include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "util/file/file_io.h"
 #include "util/linux/exception_handler_protocol.h"
+#include "util/linux/shared_crash_context.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
@@ -85,6 +87,8 @@ class ExceptionHandlerServer {
     //!     ID could not be determined. Optional.
     //! \param[out] local_report_id The unique identifier for the report created
     //!     in the local report database. Optional.
+    //! \param[in] shared_context Memory describing the crash that the client
+    //!     copied out ahead of time. Optional.
     //! \return `true` on success. `false` on failure with a message logged.
     virtual bool HandleException(
         pid_t client_process_id,
@@ -92,7 +96,8 @@ class ExceptionHandlerServer {
         const ExceptionHandlerProtocol::ClientInformation& info,
         VMAddress requesting_thread_stack_address = 0,
         pid_t* requesting_thread_id = nullptr,
-        UUID* local_report_id = nullptr) = 0;
+        UUID* local_report_id = nullptr,
+        const SharedCrashContext* shared_context = nullptr) = 0;
 
     //! \brief Called on the receipt of a crash dump request from a client for a
     //!     crash that should be mediated by a PtraceBroker.
@@ -103,14 +108,67 @@ class ExceptionHandlerServer {
     //! \param[in] broker_sock A socket connected to the PtraceBroker.
     //! \param[out] local_report_id The unique identifier for the report created
     //!     in the local report database. Optional.
+    //! \param[in] shared_context Memory describing the crash that the client
+    //!     copied out ahead of time. Optional.
     //! \return `true` on success. `false` on failure with a message logged.
     virtual bool HandleExceptionWithBroker(
         pid_t client_process_id,
         uid_t client_uid,
         const ExceptionHandlerProtocol::ClientInformation& info,
         int broker_sock,
+        UUID* local_report_id = nullptr,
+        const SharedCrashContext* shared_context = nullptr) = 0;
+
+    //! \brief Called on the receipt of a crash dump request from a client that
+    //!     asked to be captured from a copy of itself made by `fork()`.
+    //!
+    //! \param[in] client_process_id The process ID of the client.
+    //! \param[in] client_uid The uid of the client.
+    //! \param[in] info Information on the client.
+    //! \param[in] client_sock The client's private socket connection, to be
+    //!     used to initialize a ForkSnapshotConnection.
+    //! \param[out] local_report_id The unique identifier for the report created
+    //!     in the local report database. Optional.
+    //! \return `true` on success. `false` on failure with a message logged.
+    virtual bool HandleExceptionWithForkSnapshot(
+        pid_t client_process_id,
+        uid_t client_uid,
+        const ExceptionHandlerProtocol::ClientInformation& info,
+        int client_sock,
         UUID* local_report_id = nullptr) = 0;
 
+    //! \brief Called on receipt of a crash dump request from a client that
+    //!     asked for the other processes in its process group to be captured
+    //!     along with it.
+    //!
+    //! The default implementation captures only the client, with
+    //! HandleException().
+    //!
+    //! \param[in] client_process_id The process ID of the client.
+    //! \param[in] client_uid The user ID of the client, which every member of
+    //!     \a group_process_ids also runs as.
+    //! \param[in] info Information on the client.
+    //! \param[in] group_process_ids The process IDs of the other processes in
+    //!     the client's process group.
+    //! \param[in] requesting_thread_stack_address Any address within the stack
+    //!     range for the the thread that sent the crash dump request. Optional.
+    //!     If unspecified or 0, \a requesting_thread_id will be -1.
+    //! \param[out] requesting_thread_id The thread ID of the thread which
+    //!     requested the crash dump if not `nullptr`. Set to -1 if the thread
+    //!     ID could not be determined. Optional.
+    //! \param[in] shared_context Memory describing the crash that the client
+    //!     copied out ahead of time. Optional.
+    //! \return `true` if the client was captured. `false` on failure with a
+    //!     message logged.
+    virtual bool HandleProcessGroupException(
+        pid_t client_process_id,
+        uid_t client_uid,
+        const ExceptionHandlerProtocol::ClientInformation& info,
+        const std::vector<pid_t>& group_process_ids,
+        VMAddress requesting_thread_stack_address = 0,
+        pid_t* requesting_thread_id = nullptr,
+        const SharedCrashContext* shared_context = nullptr);
+
     virtual ~Delegate() {}
   };
 
@@ -127,6 +185,25 @@ class ExceptionHandlerServer {
   //! used.
   void SetPtraceStrategyDecider(std::unique_ptr<PtraceStrategyDecider> decider);
 
+  //! \brief Sets the maximum number of crash dump requests handled at once.
+  //!
+  //! By default, each crash dump request is handled to completion before any
+  //! other client message is received, so a slow dump delays every other
+  //! client that crashes at the same time. When \a max_concurrent_dumps is
+  //! greater than `1`, requests are instead handled on that many threads, so
+  //! that dumps of independent clients proceed in parallel. Requests received
+  //! while every thread is busy wait in order for one to become free. Each dump
+  //! holds a ptrace attachment to its client and that client’s snapshot for its
+  //! duration, so this also bounds the number of ptrace attachments and the
+  //! memory used for dumps at any time.
+  //!
+  //! Messages on a single private client connection are still handled one at a
+  //! time. When this is greater than `1`, the Delegate passed to Run() must be
+  //! safe to call from several threads at once.
+  //!
+  //! This method must be called before Run().
+  void SetMaxConcurrentDumps(size_t max_concurrent_dumps);
+
   //! \brief Initializes this object.
   //!
   //! This method must be successfully called before Run().
@@ -165,29 +242,60 @@ class ExceptionHandlerServer {
       kClientMessage,
 
       // A message from a client on a shared socket connection.
-      kSharedSocketMessage
+      kSharedSocketMessage,
+
+      // Used by the dump threads to report completed crash dump requests.
+      kDumpComplete,
     };
 
     Type type;
     ScopedFileHandle fd;
+
+    // The number of crash dump requests received on fd that are being handled
+    // on dump threads. While this is non-zero, the event is kept installed so
+    // that fd remains valid for those requests.
+    size_t dumps_in_flight;
+
+    // Set when the event should be uninstalled as soon as dumps_in_flight
+    // reaches zero.
+    bool uninstall_pending;
+  };
+
+  // A crash dump request to be handled on a dump thread.
+  struct DumpRequest {
+    ucred creds;
+    ExceptionHandlerProtocol::ClientInformation client_info;
+    VMAddress requesting_thread_stack_address;
+    std::unique_ptr<SharedCrashContext> shared_context;
+    Event* event;  // weak
+    bool result;
   };
 
+  class DumpDispatcher;
+
   void HandleEvent(Event* event, uint32_t event_type);
   bool InstallClientSocket(ScopedFileHandle socket, Event::Type type);
+  bool RearmClientSocket(Event* event);
   bool UninstallClientSocket(Event* event);
   bool ReceiveClientMessage(Event* event);
+  void HandleCompletedDumps();
+  void RunDumpRequest(DumpRequest* request);
   bool HandleCrashDumpRequest(
       const ucred& creds,
       const ExceptionHandlerProtocol::ClientInformation& client_info,
       VMAddress requesting_thread_stack_address,
+      const SharedCrashContext* shared_context,
       int client_sock,
       bool multiple_clients);
 
   std::unordered_map<int, std::unique_ptr<Event>> clients_;
   std::unique_ptr<Event> shutdown_event_;
+  std::unique_ptr<Event> dump_complete_event_;
   std::unique_ptr<PtraceStrategyDecider> strategy_decider_;
+  std::unique_ptr<DumpDispatcher> dispatcher_;
   Delegate* delegate_;
   ScopedFileHandle pollfd_;
+  size_t max_concurrent_dumps_;
   std::atomic<bool> keep_running_;
   InitializationStateDcheck initialized_;
 };
@@ -17,6 +17,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "snapshot/linux/process_snapshot_linux.h"
@@ -24,8 +27,12 @@
 #include "test/multiprocess.h"
 #include "util/linux/direct_ptrace_connection.h"
 #include "util/linux/exception_handler_client.h"
+#include "util/linux/exception_information.h"
+#include "util/linux/fork_snapshot_connection.h"
 #include "util/linux/ptrace_client.h"
 #include "util/linux/scoped_pr_set_ptracer.h"
+#include "util/linux/shared_crash_context.h"
+#include "util/misc/from_pointer_cast.h"
 #include "util/misc/uuid.h"
 #include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
@@ -93,7 +100,14 @@ class ScopedStopServerAndJoinThread {
 class TestDelegate : public ExceptionHandlerServer::Delegate {
  public:
   TestDelegate()
-      : Delegate(), last_exception_address_(0), last_client_(-1), sem_(0) {}
+      : Delegate(),
+        last_exception_address_(0),
+        last_client_(-1),
+        fork_snapshots_(0),
+        process_group_requests_(0),
+        last_group_process_ids_(),
+        shared_context_thread_id_(-1),
+        sem_(0) {}
 
   TestDelegate(const TestDelegate&) = delete;
   TestDelegate& operator=(const TestDelegate&) = delete;
@@ -112,16 +126,39 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
     return false;
   }
 
+  int ForkSnapshots() const { return fork_snapshots_; }
+
+  int ProcessGroupRequests() const { return process_group_requests_; }
+
+  const std::vector<pid_t>& LastGroupProcessIDs() const {
+    return last_group_process_ids_;
+  }
+
+  pid_t SharedContextThreadID() const { return shared_context_thread_id_; }
+
   bool HandleException(pid_t client_process_id,
                        uid_t client_uid,
                        const ExceptionHandlerProtocol::ClientInformation& info,
                        VMAddress requesting_thread_stack_address,
                        pid_t* requesting_thread_id = nullptr,
-                       UUID* local_report_id = nullptr) override {
+                       UUID* local_report_id = nullptr,
+                       const SharedCrashContext* shared_context =
+                           nullptr) override {
     DirectPtraceConnection connection;
     bool connected = connection.Initialize(client_process_id);
     EXPECT_TRUE(connected);
 
+    if (connected && shared_context) {
+      SharedCrashContextMemory memory;
+      ExceptionInformation exception_info;
+      if (memory.Initialize(connection.Memory(), shared_context) &&
+          memory.Read(info.exception_information_address,
+                      sizeof(exception_info),
+                      &exception_info)) {
+        shared_context_thread_id_ = exception_info.thread_id;
+      }
+    }
+
     last_exception_address_ = info.exception_information_address;
     last_client_ = client_process_id;
     sem_.Signal();
@@ -150,7 +187,8 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
       uid_t client_uid,
       const ExceptionHandlerProtocol::ClientInformation& info,
       int broker_sock,
-      UUID* local_report_id = nullptr) override {
+      UUID* local_report_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override {
     PtraceClient client;
     bool connected = client.Initialize(broker_sock, client_process_id);
     EXPECT_TRUE(connected);
@@ -161,9 +199,58 @@ class TestDelegate : public ExceptionHandlerServer::Delegate {
     return connected;
   }
 
+  bool HandleExceptionWithForkSnapshot(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int client_sock,
+      UUID* local_report_id = nullptr) override {
+    ForkSnapshotConnection connection;
+    bool connected = connection.Initialize(client_sock, client_process_id);
+    EXPECT_TRUE(connected);
+    if (connected) {
+      EXPECT_EQ(connection.GetProcessID(), client_process_id);
+      EXPECT_NE(connection.SnapshotProcessID(), client_process_id);
+
+      std::vector<pid_t> threads;
+      EXPECT_TRUE(connection.Threads(&threads));
+      EXPECT_NE(std::find(threads.begin(), threads.end(), client_process_id),
+                threads.end());
+    }
+
+    ++fork_snapshots_;
+    last_exception_address_ = info.exception_information_address,
+    last_client_ = client_process_id;
+    sem_.Signal();
+    return connected;
+  }
+
+  bool HandleProcessGroupException(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      const std::vector<pid_t>& group_process_ids,
+      VMAddress requesting_thread_stack_address,
+      pid_t* requesting_thread_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override {
+    ++process_group_requests_;
+    last_group_process_ids_ = group_process_ids;
+    return HandleException(client_process_id,
+                           client_uid,
+                           info,
+                           requesting_thread_stack_address,
+                           requesting_thread_id,
+                           nullptr,
+                           shared_context);
+  }
+
  private:
   VMAddress last_exception_address_;
   pid_t last_client_;
+  int fork_snapshots_;
+  int process_group_requests_;
+  std::vector<pid_t> last_group_process_ids_;
+  pid_t shared_context_thread_id_;
   Semaphore sem_;
 };
 
@@ -215,7 +302,10 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
         delegate_(),
         server_thread_(&server_, &delegate_),
         sock_to_handler_(),
-        use_multi_client_socket_(GetParam()) {}
+        use_multi_client_socket_(GetParam()),
+        fork_snapshot_(false),
+        capture_process_group_(false),
+        shared_context_(false) {}
 
   ExceptionHandlerServerTest(const ExceptionHandlerServerTest&) = delete;
   ExceptionHandlerServerTest& operator=(const ExceptionHandlerServerTest&) =
@@ -268,6 +358,27 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
 
       ExceptionHandlerProtocol::ClientInformation info;
       info.exception_information_address = 42;
+      if (server_test_->fork_snapshot_) {
+        info.fork_snapshot = ExceptionHandlerProtocol::kBoolTrue;
+      }
+      if (server_test_->capture_process_group_) {
+        info.capture_process_group = ExceptionHandlerProtocol::kBoolTrue;
+      }
+
+      // The handler should see the copy made in the shared context, not the
+      // value this process changes it to afterwards.
+      ExceptionInformation exception_info = {};
+      exception_info.thread_id = kSharedContextThreadID;
+      SharedCrashContext shared_context;
+      if (server_test_->shared_context_) {
+        ASSERT_TRUE(shared_context.Initialize());
+        ASSERT_TRUE(
+            shared_context.AddRange(&exception_info, sizeof(exception_info)));
+        ASSERT_TRUE(shared_context.Seal());
+        exception_info.thread_id = 0;
+        info.exception_information_address =
+            FromPointerCast<VMAddress>(&exception_info);
+      }
       ASSERT_TRUE(LoggingWriteFile(WritePipeHandle(), &info, sizeof(info)));
 
       // If the current ptrace_scope is restricted, the broker needs to be set
@@ -277,6 +388,9 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
 
       ExceptionHandlerClient client(server_test_->SockToHandler(),
                                     server_test_->use_multi_client_socket_);
+      if (server_test_->shared_context_) {
+        client.SetSharedCrashContext(&shared_context);
+      }
       ASSERT_EQ(client.RequestCrashDump(info), 0);
     }
 
@@ -299,6 +413,18 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
 
   bool UsingMultiClientSocket() const { return use_multi_client_socket_; }
 
+  void SetForkSnapshot(bool fork_snapshot) { fork_snapshot_ = fork_snapshot; }
+
+  void SetCaptureProcessGroup(bool capture_process_group) {
+    capture_process_group_ = capture_process_group;
+  }
+
+  void SetSharedContext(bool shared_context) {
+    shared_context_ = shared_context;
+  }
+
+  static constexpr pid_t kSharedContextThreadID = 1234;
+
  protected:
   void SetUp() override {
     int socks[2];
@@ -317,6 +443,9 @@ class ExceptionHandlerServerTest : public testing::TestWithParam<bool> {
   ScopedFileHandle sock_to_handler_;
   int sock_to_client_;
   bool use_multi_client_socket_;
+  bool fork_snapshot_;
+  bool capture_process_group_;
+  bool shared_context_;
 };
 
 TEST_P(ExceptionHandlerServerTest, ShutdownWithNoClients) {
@@ -376,6 +505,52 @@ TEST_P(ExceptionHandlerServerTest, RequestCrashDumpError) {
   ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kError, false);
 }
 
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpForkSnapshot) {
+  SetForkSnapshot(true);
+  ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kDirectPtrace,
+                               true);
+
+  // Clients on a shared connection are captured directly.
+  EXPECT_EQ(Delegate()->ForkSnapshots(), UsingMultiClientSocket() ? 0 : 1);
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpProcessGroup) {
+  SetCaptureProcessGroup(true);
+  ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kDirectPtrace,
+                               true);
+  EXPECT_EQ(Delegate()->ProcessGroupRequests(), 1);
+
+  // The handler shares the client's process group here, but never captures
+  // itself.
+  const std::vector<pid_t>& group = Delegate()->LastGroupProcessIDs();
+  EXPECT_EQ(std::find(group.begin(), group.end(), getpid()), group.end());
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpSharedContext) {
+  SetSharedContext(true);
+  ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kDirectPtrace,
+                               true);
+  EXPECT_EQ(Delegate()->SharedContextThreadID(), kSharedContextThreadID);
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpConcurrent) {
+  Server()->SetMaxConcurrentDumps(2);
+  ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kDirectPtrace,
+                               true);
+}
+
+TEST_P(ExceptionHandlerServerTest, RequestCrashDumpConcurrentError) {
+  Server()->SetMaxConcurrentDumps(2);
+  ExpectCrashDumpUsingStrategy(PtraceStrategyDecider::Strategy::kError, false);
+}
+
+TEST_P(ExceptionHandlerServerTest, StopWithConcurrentDumps) {
+  Server()->SetMaxConcurrentDumps(2);
+  ServerThread()->Start();
+  Server()->Stop();
+  ASSERT_TRUE(ServerThread()->JoinWithTimeout(5.0));
+}
+
 INSTANTIATE_TEST_SUITE_P(ExceptionHandlerServerTestSuite,
                          ExceptionHandlerServerTest,
                          testing::Bool()
@@ -0,0 +1,107 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/tenant_exception_handler.h"
+
+#include "base/check.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+TenantExceptionHandler::TenantExceptionHandler() : tenants_() {}
+
+TenantExceptionHandler::~TenantExceptionHandler() = default;
+
+void TenantExceptionHandler::AddTenant(
+    ExceptionHandlerServer::Delegate* delegate) {
+  DCHECK(delegate);
+  tenants_.push_back(delegate);
+}
+
+bool TenantExceptionHandler::HandleException(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    VMAddress requesting_thread_stack_address,
+    pid_t* requesting_thread_id,
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
+  return TenantDelegate(info, client_process_id)
+      ->HandleException(client_process_id,
+                        client_uid,
+                        info,
+                        requesting_thread_stack_address,
+                        requesting_thread_id,
+                        local_report_id,
+                        shared_context);
+}
+
+bool TenantExceptionHandler::HandleExceptionWithBroker(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    int broker_sock,
+    UUID* local_report_id,
+    const SharedCrashContext* shared_context) {
+  return TenantDelegate(info, client_process_id)
+      ->HandleExceptionWithBroker(client_process_id,
+                                  client_uid,
+                                  info,
+                                  broker_sock,
+                                  local_report_id,
+                                  shared_context);
+}
+
+bool TenantExceptionHandler::HandleExceptionWithForkSnapshot(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    int client_sock,
+    UUID* local_report_id) {
+  return TenantDelegate(info, client_process_id)
+      ->HandleExceptionWithForkSnapshot(
+          client_process_id, client_uid, info, client_sock, local_report_id);
+}
+
+bool TenantExceptionHandler::HandleProcessGroupException(
+    pid_t client_process_id,
+    uid_t client_uid,
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    const std::vector<pid_t>& group_process_ids,
+    VMAddress requesting_thread_stack_address,
+    pid_t* requesting_thread_id,
+    const SharedCrashContext* shared_context) {
+  return TenantDelegate(info, client_process_id)
+      ->HandleProcessGroupException(client_process_id,
+                                    client_uid,
+                                    info,
+                                    group_process_ids,
+                                    requesting_thread_stack_address,
+                                    requesting_thread_id,
+                                    shared_context);
+}
+
+ExceptionHandlerServer::Delegate* TenantExceptionHandler::TenantDelegate(
+    const ExceptionHandlerProtocol::ClientInformation& info,
+    pid_t client_process_id) const {
+  DCHECK(!tenants_.empty());
+  if (info.tenant >= tenants_.size()) {
+    LOG(WARNING) << "client " << client_process_id << " has unknown tenant "
+                 << info.tenant << ", using the default";
+    return tenants_[0];
+  }
+  return tenants_[info.tenant];
+}
+
+}  // namespace crashpad
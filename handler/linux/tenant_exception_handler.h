@@ -0,0 +1,104 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_LINUX_TENANT_EXCEPTION_HANDLER_H_
+#define CRASHPAD_HANDLER_LINUX_TENANT_EXCEPTION_HANDLER_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <vector>
+
+#include "handler/linux/exception_handler_server.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/misc/address_types.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+//! \brief An ExceptionHandlerServer::Delegate that passes each crash dump
+//!     request to the delegate of the requesting client’s tenant.
+//!
+//! This lets a single handler host several crash report databases, each with
+//! its own delegate, while the handler’s ExceptionHandlerServer and its dump
+//! threads are shared among them. A client chooses its tenant with
+//! ExceptionHandlerProtocol::ClientInformation::tenant. Requests for a tenant
+//! that doesn’t exist are passed to the default tenant, `0`.
+class TenantExceptionHandler final : public ExceptionHandlerServer::Delegate {
+ public:
+  TenantExceptionHandler();
+
+  TenantExceptionHandler(const TenantExceptionHandler&) = delete;
+  TenantExceptionHandler& operator=(const TenantExceptionHandler&) = delete;
+
+  ~TenantExceptionHandler() override;
+
+  //! \brief Adds a tenant, numbered after those already added, starting from
+  //!     `0`.
+  //!
+  //! \param[in] delegate The delegate that handles the tenant’s requests. This
+  //!     object does not take ownership of it, and it must outlive this
+  //!     object.
+  void AddTenant(ExceptionHandlerServer::Delegate* delegate);
+
+  //! \brief Returns the number of tenants added by AddTenant().
+  size_t TenantCount() const { return tenants_.size(); }
+
+  // ExceptionHandlerServer::Delegate:
+
+  bool HandleException(pid_t client_process_id,
+                       uid_t client_uid,
+                       const ExceptionHandlerProtocol::ClientInformation& info,
+                       VMAddress requesting_thread_stack_address = 0,
+                       pid_t* requesting_thread_id = nullptr,
+                       UUID* local_report_id = nullptr,
+                       const SharedCrashContext* shared_context =
+                           nullptr) override;
+
+  bool HandleExceptionWithBroker(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int broker_sock,
+      UUID* local_report_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override;
+
+  bool HandleExceptionWithForkSnapshot(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int client_sock,
+      UUID* local_report_id = nullptr) override;
+
+  bool HandleProcessGroupException(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      const std::vector<pid_t>& group_process_ids,
+      VMAddress requesting_thread_stack_address = 0,
+      pid_t* requesting_thread_id = nullptr,
+      const SharedCrashContext* shared_context = nullptr) override;
+
+ private:
+  // Returns the delegate for the tenant that |info| asks for.
+  ExceptionHandlerServer::Delegate* TenantDelegate(
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      pid_t client_process_id) const;
+
+  std::vector<ExceptionHandlerServer::Delegate*> tenants_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_LINUX_TENANT_EXCEPTION_HANDLER_H_
@@ -0,0 +1,107 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/linux/tenant_exception_handler.h"
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Counts the requests passed to it.
+class CountingDelegate : public ExceptionHandlerServer::Delegate {
+ public:
+  CountingDelegate() = default;
+
+  CountingDelegate(const CountingDelegate&) = delete;
+  CountingDelegate& operator=(const CountingDelegate&) = delete;
+
+  ~CountingDelegate() override = default;
+
+  int count() const { return count_; }
+
+  // ExceptionHandlerServer::Delegate:
+
+  bool HandleException(pid_t client_process_id,
+                       uid_t client_uid,
+                       const ExceptionHandlerProtocol::ClientInformation& info,
+                       VMAddress requesting_thread_stack_address,
+                       pid_t* requesting_thread_id,
+                       UUID* local_report_id,
+                       const SharedCrashContext* shared_context) override {
+    ++count_;
+    return true;
+  }
+
+  bool HandleExceptionWithBroker(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int broker_sock,
+      UUID* local_report_id,
+      const SharedCrashContext* shared_context) override {
+    ++count_;
+    return true;
+  }
+
+  bool HandleExceptionWithForkSnapshot(
+      pid_t client_process_id,
+      uid_t client_uid,
+      const ExceptionHandlerProtocol::ClientInformation& info,
+      int client_sock,
+      UUID* local_report_id) override {
+    ++count_;
+    return true;
+  }
+
+ private:
+  int count_ = 0;
+};
+
+TEST(TenantExceptionHandler, RoutesByTenant) {
+  CountingDelegate default_tenant;
+  CountingDelegate other_tenant;
+  TenantExceptionHandler handler;
+  handler.AddTenant(&default_tenant);
+  handler.AddTenant(&other_tenant);
+  EXPECT_EQ(handler.TenantCount(), 2u);
+
+  ExceptionHandlerProtocol::ClientInformation info;
+  EXPECT_TRUE(handler.HandleException(getpid(), geteuid(), info));
+  EXPECT_EQ(default_tenant.count(), 1);
+  EXPECT_EQ(other_tenant.count(), 0);
+
+  info.tenant = 1;
+  EXPECT_TRUE(handler.HandleException(getpid(), geteuid(), info));
+  EXPECT_TRUE(handler.HandleExceptionWithBroker(getpid(), geteuid(), info, -1));
+  EXPECT_TRUE(
+      handler.HandleExceptionWithForkSnapshot(getpid(), geteuid(), info, -1));
+  EXPECT_TRUE(
+      handler.HandleProcessGroupException(getpid(), geteuid(), info, {}));
+  EXPECT_EQ(default_tenant.count(), 1);
+  EXPECT_EQ(other_tenant.count(), 4);
+
+  // A tenant that doesn’t exist gets the default.
+  info.tenant = 2;
+  EXPECT_TRUE(handler.HandleException(getpid(), geteuid(), info));
+  EXPECT_EQ(default_tenant.count(), 2);
+  EXPECT_EQ(other_tenant.count(), 4);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
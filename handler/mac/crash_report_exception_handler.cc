@@ -14,6 +14,8 @@
 
 #include "handler/mac/crash_report_exception_handler.h"
 
+#include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -22,7 +24,10 @@
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "client/settings.h"
+#include "handler/crash_signature.h"
 #include "handler/mac/file_limit_annotation.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_summary.h"
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/crashpad_info_client_options.h"
@@ -36,6 +41,7 @@
 #include "util/mach/mach_message.h"
 #include "util/mach/scoped_task_suspend.h"
 #include "util/mach/symbolic_constants_mach.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
 #include "util/misc/tri_state.h"
 #include "util/misc/uuid.h"
@@ -102,8 +108,13 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
 
   ScopedTaskSuspend suspend(task);
 
+  // The task remains suspended while the snapshot exists, so its memory can be
+  // read through a cache of mappings, which saves remapping the pages shared
+  // by the many module structures read for the snapshot.
+  constexpr size_t kMappingCacheSize = 64;
+  Metrics::ExceptionCaptureStarted();
   ProcessSnapshotMac process_snapshot;
-  if (!process_snapshot.Initialize(task)) {
+  if (!process_snapshot.Initialize(task, kMappingCacheSize)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return KERN_FAILURE;
   }
@@ -150,7 +161,14 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
     if (settings && settings->GetClientID(&client_id)) {
       process_snapshot.SetClientID(client_id);
     }
-    process_snapshot.SetAnnotationsSimpleMap(*process_annotations_);
+    // The crash signature is stored with the other process annotations so
+    // that it's among the report's upload parameters.
+    std::map<std::string, std::string> annotations(*process_annotations_);
+    const std::string signature = CrashSignatureFromSnapshot(process_snapshot);
+    if (!signature.empty()) {
+      annotations.emplace(kCrashSignatureAnnotationKey, signature);
+    }
+    process_snapshot.SetAnnotationsSimpleMap(annotations);
 
     std::unique_ptr<CrashReportDatabase::NewReport> new_report;
     CrashReportDatabase::OperationStatus database_status =
@@ -168,11 +186,26 @@ kern_return_t CrashReportExceptionHandler::CatchMachException(
     AddUserExtensionStreams(
         user_stream_data_sources_, &process_snapshot, &minidump);
 
+    const uint64_t write_start_ns = ClockMonotonicNanoseconds();
     if (!minidump.WriteEverything(new_report->Writer())) {
       Metrics::ExceptionCaptureResult(
           Metrics::CaptureResult::kMinidumpWriteFailed);
       return KERN_FAILURE;
     }
+    Metrics::MinidumpWriteCompleted(ClockMonotonicNanoseconds() -
+                                    write_start_ns);
+
+    // Storing the upload parameters now spares the upload thread from having
+    // to read them back out of the minidump.
+    if (!new_report->SetUploadParameters(
+            BreakpadHTTPFormParametersFromMinidump(&process_snapshot))) {
+      LOG(WARNING) << "SetUploadParameters failed";
+    }
+
+    // The summary lets reports be listed without reading their minidumps.
+    if (!new_report->SetSummary(ReportSummaryFromSnapshot(process_snapshot))) {
+      LOG(WARNING) << "SetSummary failed";
+    }
 
     UUID uuid;
     database_status =
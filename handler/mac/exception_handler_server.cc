@@ -14,21 +14,129 @@
 
 #include "handler/mac/exception_handler_server.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/apple/mach_logging.h"
 #include "base/check.h"
 #include "base/logging.h"
+#include "base/synchronization/lock.h"
 #include "util/mach/composite_mach_message_server.h"
 #include "util/mach/mach_extensions.h"
 #include "util/mach/mach_message.h"
 #include "util/mach/mach_message_server.h"
 #include "util/mach/notify_server.h"
+#include "util/thread/thread.h"
 
 namespace crashpad {
 
 namespace {
 
+// Sends a synthesized no-senders notification to notify_port, which causes a
+// thread running the exception handler server to stop.
+//
+// mach_no_senders_notification_t defines the receive side of this structure,
+// with a trailer element that’s undesirable for the send side.
+mach_msg_return_t SendNoSendersNotification(mach_port_t notify_port,
+                                            mach_msg_option_t options) {
+  struct {
+    mach_msg_header_t header;
+    NDR_record_t ndr;
+    mach_msg_type_number_t mscount;
+  } no_senders_notification = {};
+  no_senders_notification.header.msgh_bits =
+      MACH_MSGH_BITS(MACH_MSG_TYPE_MAKE_SEND_ONCE, 0);
+  no_senders_notification.header.msgh_size = sizeof(no_senders_notification);
+  no_senders_notification.header.msgh_remote_port = notify_port;
+  no_senders_notification.header.msgh_local_port = MACH_PORT_NULL;
+  no_senders_notification.header.msgh_id = MACH_NOTIFY_NO_SENDERS;
+  no_senders_notification.ndr = NDR_record;
+  no_senders_notification.mscount = 0;
+
+  return mach_msg(&no_senders_notification.header,
+                  MACH_SEND_MSG | options,
+                  sizeof(no_senders_notification),
+                  0,
+                  MACH_PORT_NULL,
+                  MACH_MSG_TIMEOUT_NONE,
+                  MACH_PORT_NULL);
+}
+
+// Serializes the handling of exceptions from each client task, so that when
+// several threads of one task raise exceptions at once, they are captured one
+// at a time even when other tasks’ exceptions are handled concurrently.
+class ClientSerializer {
+ private:
+  struct Client;
+
+ public:
+  // Holds the lock for a task for the lifetime of this object.
+  class ScopedClient {
+   public:
+    ScopedClient(ClientSerializer* serializer, task_t task)
+        : serializer_(serializer),
+          task_(task),
+          client_(serializer_->Acquire(task_)) {}
+
+    ScopedClient(const ScopedClient&) = delete;
+    ScopedClient& operator=(const ScopedClient&) = delete;
+
+    ~ScopedClient() { serializer_->Release(task_, client_); }
+
+   private:
+    ClientSerializer* serializer_;  // weak
+    task_t task_;  // weak
+    Client* client_;  // weak
+  };
+
+  ClientSerializer() : lock_(), clients_() {}
+
+  ClientSerializer(const ClientSerializer&) = delete;
+  ClientSerializer& operator=(const ClientSerializer&) = delete;
+
+  ~ClientSerializer() { DCHECK(clients_.empty()); }
+
+ private:
+  struct Client {
+    Client() : lock(), users(0) {}
+
+    base::Lock lock;
+    size_t users;  // Guarded by ClientSerializer::lock_.
+  };
+
+  // Every right to a task has the same name in this task, so the name
+  // identifies the client while any of its exceptions is being handled.
+  Client* Acquire(task_t task) {
+    Client* client;
+    {
+      base::AutoLock lock(lock_);
+      std::unique_ptr<Client>& entry = clients_[task];
+      if (!entry) {
+        entry = std::make_unique<Client>();
+      }
+      client = entry.get();
+      ++client->users;
+    }
+    client->lock.Acquire();
+    return client;
+  }
+
+  void Release(task_t task, Client* client) {
+    client->lock.Release();
+    base::AutoLock lock(lock_);
+    if (--client->users == 0) {
+      clients_.erase(task);
+    }
+  }
+
+  base::Lock lock_;
+  std::map<task_t, std::unique_ptr<Client>> clients_;
+};
+
 class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
                                   public NotifyServer::DefaultInterface {
  public:
@@ -36,15 +144,18 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
       mach_port_t exception_port,
       mach_port_t notify_port,
       bool launchd,
+      size_t thread_count,
       UniversalMachExcServer::Interface* exception_interface)
       : UniversalMachExcServer::Interface(),
         NotifyServer::DefaultInterface(),
         mach_exc_server_(this),
         notify_server_(this),
         composite_mach_message_server_(),
+        client_serializer_(),
         exception_interface_(exception_interface),
         exception_port_(exception_port),
         notify_port_(notify_port),
+        thread_count_(thread_count),
         running_(true),
         launchd_(launchd) {
     composite_mach_message_server_.AddHandler(&mach_exc_server_);
@@ -97,27 +208,19 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
         mach_task_self(), notify_port_, server_port_set.get());
     MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_port_insert_member";
 
-    // Run the server in kOneShot mode so that running_ can be reevaluated after
-    // each message. Receipt of a valid no-senders notification causes it to be
-    // set to false.
-    while (running_) {
-      // This will result in a call to CatchMachException() or
-      // DoMachNotifyNoSenders() as appropriate.
-      mach_msg_return_t mr =
-          MachMessageServer::Run(&composite_mach_message_server_,
-                                 server_port_set.get(),
-                                 kMachMessageReceiveAuditTrailer,
-                                 MachMessageServer::kOneShot,
-                                 MachMessageServer::kReceiveLargeIgnore,
-                                 kMachMessageTimeoutWaitIndefinitely);
+    // Each additional thread receives from the same port set, so that the
+    // kernel hands each message to whichever thread is free to take it.
+    std::vector<std::unique_ptr<ServerThread>> threads;
+    for (size_t index = 1; index < thread_count_; ++index) {
+      threads.push_back(
+          std::make_unique<ServerThread>(this, server_port_set.get()));
+      threads.back()->Start();
+    }
 
-      // MACH_SEND_INVALID_DEST occurs when attempting to reply to a dead name.
-      // This can happen if a mach_exc or exc client disappears before a reply
-      // can be sent to it. That’s unusal for kernel-generated requests, but can
-      // easily happen if a task sends its own exception request (as
-      // SimulateCrash() does) and dies before the reply is sent.
-      MACH_CHECK(mr == MACH_MSG_SUCCESS || mr == MACH_SEND_INVALID_DEST, mr)
-          << "MachMessageServer::Run";
+    ServeMessages(server_port_set.get());
+
+    for (const auto& thread : threads) {
+      thread->Join();
     }
   }
 
@@ -142,6 +245,7 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
       return KERN_FAILURE;
     }
 
+    ClientSerializer::ScopedClient client(&client_serializer_, task);
     return exception_interface_->CatchMachException(behavior,
                                                     exception_port,
                                                     thread,
@@ -180,13 +284,72 @@ class ExceptionHandlerServerRun : public UniversalMachExcServer::Interface,
   }
 
  private:
+  class ServerThread final : public Thread {
+   public:
+    ServerThread(ExceptionHandlerServerRun* run, mach_port_t server_port_set)
+        : Thread(), run_(run), server_port_set_(server_port_set) {}
+
+    ServerThread(const ServerThread&) = delete;
+    ServerThread& operator=(const ServerThread&) = delete;
+
+    ~ServerThread() override = default;
+
+   private:
+    // Thread:
+    void ThreadMain() override { run_->ServeMessages(server_port_set_); }
+
+    ExceptionHandlerServerRun* run_;  // weak
+    mach_port_t server_port_set_;  // weak
+  };
+
+  // Receives and handles messages on server_port_set until a no-senders
+  // notification is received.
+  void ServeMessages(mach_port_t server_port_set) {
+    // Run the server in kDrain mode so that running_ can be reevaluated after
+    // each burst of messages. Receipt of a valid no-senders notification causes
+    // it to be set to false.
+    while (running_) {
+      // This will result in a call to CatchMachException() or
+      // DoMachNotifyNoSenders() as appropriate.
+      mach_msg_return_t mr =
+          MachMessageServer::Run(&composite_mach_message_server_,
+                                 server_port_set,
+                                 kMachMessageReceiveAuditTrailer,
+                                 MachMessageServer::kDrain,
+                                 MachMessageServer::kReceiveLargeIgnore,
+                                 kMachMessageTimeoutWaitIndefinitely);
+
+      // MACH_SEND_INVALID_DEST occurs when attempting to reply to a dead name.
+      // This can happen if a mach_exc or exc client disappears before a reply
+      // can be sent to it. That’s unusal for kernel-generated requests, but can
+      // easily happen if a task sends its own exception request (as
+      // SimulateCrash() does) and dies before the reply is sent.
+      MACH_CHECK(mr == MACH_MSG_SUCCESS || mr == MACH_SEND_INVALID_DEST, mr)
+          << "MachMessageServer::Run";
+    }
+
+    if (thread_count_ > 1) {
+      // Only one thread received the no-senders notification. Pass it along so
+      // that another thread waiting in mach_msg() stops too. If the queue is
+      // full, enough notifications are already pending.
+      mach_msg_return_t mr =
+          SendNoSendersNotification(notify_port_, MACH_SEND_TIMEOUT);
+      MACH_LOG_IF(ERROR,
+                  mr != MACH_MSG_SUCCESS && mr != MACH_SEND_TIMED_OUT,
+                  mr)
+          << "mach_msg";
+    }
+  }
+
   UniversalMachExcServer mach_exc_server_;
   NotifyServer notify_server_;
   CompositeMachMessageServer composite_mach_message_server_;
+  ClientSerializer client_serializer_;
   UniversalMachExcServer::Interface* exception_interface_;  // weak
   mach_port_t exception_port_;  // weak
   mach_port_t notify_port_;  // weak
-  bool running_;
+  size_t thread_count_;
+  std::atomic<bool> running_;
   bool launchd_;
 };
 
@@ -197,6 +360,7 @@ ExceptionHandlerServer::ExceptionHandlerServer(
     bool launchd)
     : receive_port_(std::move(receive_port)),
       notify_port_(NewMachPort(MACH_PORT_RIGHT_RECEIVE)),
+      max_concurrent_dumps_(1),
       launchd_(launchd) {
   CHECK(receive_port_.is_valid());
   CHECK(notify_port_.is_valid());
@@ -205,40 +369,25 @@ ExceptionHandlerServer::ExceptionHandlerServer(
 ExceptionHandlerServer::~ExceptionHandlerServer() {
 }
 
+void ExceptionHandlerServer::SetMaxConcurrentDumps(
+    size_t max_concurrent_dumps) {
+  max_concurrent_dumps_ = std::max(max_concurrent_dumps, size_t{1});
+}
+
 void ExceptionHandlerServer::Run(
     UniversalMachExcServer::Interface* exception_interface) {
-  ExceptionHandlerServerRun run(
-      receive_port_.get(), notify_port_.get(), launchd_, exception_interface);
+  ExceptionHandlerServerRun run(receive_port_.get(),
+                                notify_port_.get(),
+                                launchd_,
+                                max_concurrent_dumps_,
+                                exception_interface);
   run.Run();
 }
 
 void ExceptionHandlerServer::Stop() {
   // Cause the exception handler server to stop running by sending it a
   // synthesized no-senders notification.
-  //
-  // mach_no_senders_notification_t defines the receive side of this structure,
-  // with a trailer element that’s undesirable for the send side.
-  struct {
-    mach_msg_header_t header;
-    NDR_record_t ndr;
-    mach_msg_type_number_t mscount;
-  } no_senders_notification = {};
-  no_senders_notification.header.msgh_bits =
-      MACH_MSGH_BITS(MACH_MSG_TYPE_MAKE_SEND_ONCE, 0);
-  no_senders_notification.header.msgh_size = sizeof(no_senders_notification);
-  no_senders_notification.header.msgh_remote_port = notify_port_.get();
-  no_senders_notification.header.msgh_local_port = MACH_PORT_NULL;
-  no_senders_notification.header.msgh_id = MACH_NOTIFY_NO_SENDERS;
-  no_senders_notification.ndr = NDR_record;
-  no_senders_notification.mscount = 0;
-
-  kern_return_t kr = mach_msg(&no_senders_notification.header,
-                              MACH_SEND_MSG,
-                              sizeof(no_senders_notification),
-                              0,
-                              MACH_PORT_NULL,
-                              MACH_MSG_TIMEOUT_NONE,
-                              MACH_PORT_NULL);
+  kern_return_t kr = SendNoSendersNotification(notify_port_.get(), 0);
   MACH_CHECK(kr == KERN_SUCCESS, kr) << "mach_msg";
 }
 
@@ -16,6 +16,7 @@
 #define CRASHPAD_HANDLER_MAC_EXCEPTION_HANDLER_SERVER_H_
 
 #include <mach/mach.h>
+#include <stddef.h>
 
 #include "base/apple/scoped_mach_port.h"
 #include "util/mach/exc_server_variants.h"
@@ -42,6 +43,24 @@ class ExceptionHandlerServer {
 
   ~ExceptionHandlerServer();
 
+  //! \brief Sets the maximum number of exception messages handled at once.
+  //!
+  //! By default, each exception message is handled to completion before the
+  //! next message is received, so a slow capture of one client delays every
+  //! other client that crashes at the same time. When \a max_concurrent_dumps
+  //! is greater than `1`, that many threads receive and handle messages from
+  //! the receive port, so that independent clients are captured in parallel.
+  //! Each capture keeps its client suspended and holds that client’s snapshot
+  //! for its duration, so this also bounds the number of task ports being
+  //! captured and the memory used for captures at any time.
+  //!
+  //! Exception messages for a single client task are still handled one at a
+  //! time. When this is greater than `1`, the interface passed to Run() must
+  //! be safe to call from several threads at once.
+  //!
+  //! This method must be called before Run().
+  void SetMaxConcurrentDumps(size_t max_concurrent_dumps);
+
   //! \brief Runs the exception-handling server.
   //!
   //! \param[in] exception_interface An object to send exception messages to.
@@ -75,6 +94,7 @@ class ExceptionHandlerServer {
  private:
   base::apple::ScopedMachReceiveRight receive_port_;
   base::apple::ScopedMachReceiveRight notify_port_;
+  size_t max_concurrent_dumps_;
   bool launchd_;
 };
 
@@ -16,16 +16,34 @@
 
 #include <utility>
 
+#include "client/crash_report_database.h"
 #include "client/prune_crash_reports.h"
+#include "util/misc/metrics.h"
 
 namespace crashpad {
 
+namespace {
+
+constexpr time_t kPruneInterval = 60 * 60 * 24;
+constexpr time_t kSizeCheckInterval = 60 * 10;
+
+}  // namespace
+
 PruneCrashReportThread::PruneCrashReportThread(
     CrashReportDatabase* database,
-    std::unique_ptr<PruneCondition> condition)
-    : thread_(60 * 60 * 24, this),
+    std::unique_ptr<PruneCondition> condition,
+    uint64_t size_threshold,
+    bool adaptive_scheduling)
+    : thread_(size_threshold ? kSizeCheckInterval : kPruneInterval, this),
       condition_(std::move(condition)),
-      database_(database) {}
+      database_(database),
+      size_threshold_(size_threshold),
+      last_prune_time_(0) {
+  if (size_threshold && adaptive_scheduling) {
+    thread_.SetAdaptiveInterval(kSizeCheckInterval, kPruneInterval);
+    thread_.SetWakeupAlignment(WorkerThread::kDefaultWakeupAlignment);
+  }
+}
 
 PruneCrashReportThread::~PruneCrashReportThread() {}
 
@@ -38,8 +56,23 @@ void PruneCrashReportThread::Stop() {
 }
 
 void PruneCrashReportThread::DoWork(const WorkerThread* thread) {
+  const time_t now = time(nullptr);
+  if (last_prune_time_ != 0 && now - last_prune_time_ < kPruneInterval) {
+    // Not yet time for the daily prune. This is only reached when a size
+    // threshold is set, so prune early only if the database has outgrown it.
+    uint64_t total_size;
+    if (database_->GetTotalSize(&total_size) !=
+            CrashReportDatabase::kNoError ||
+        total_size <= size_threshold_) {
+      thread_.SetWorkResult(WorkerThread::WorkResult::kIdle);
+      return;
+    }
+  }
+
+  last_prune_time_ = now;
   database_->CleanDatabase(60 * 60 * 24 * 3);
-  PruneCrashReportDatabase(database_, condition_.get());
+  Metrics::CrashReportsPruned(
+      PruneCrashReportDatabase(database_, condition_.get()));
 }
 
 }  // namespace crashpad
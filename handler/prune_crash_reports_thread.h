@@ -15,6 +15,9 @@
 #ifndef CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 #define CRASHPAD_HANDLER_PRUNE_CRASH_REPORTS_THREAD_H_
 
+#include <stdint.h>
+#include <time.h>
+
 #include <memory>
 
 #include "util/thread/stoppable.h"
@@ -31,6 +34,12 @@ class PruneCondition;
 //! After the thread is started, the database is pruned using the condition
 //! every 24 hours. Upon calling Start(), the thread waits 10 minutes before
 //! performing the initial prune operation.
+//!
+//! If a size threshold is specified, the thread additionally checks the
+//! database’s total size every 10 minutes, and prunes as soon as the total
+//! exceeds the threshold rather than waiting for the next daily prune. This
+//! check uses CrashReportDatabase::GetTotalSize(), which is inexpensive for
+//! databases that maintain a report index.
 class PruneCrashReportThread : public WorkerThread::Delegate, public Stoppable {
  public:
   //! \brief Constructs a new object.
@@ -38,8 +47,19 @@ class PruneCrashReportThread : public WorkerThread::Delegate, public Stoppable {
   //! \param[in] database The database to prune crash reports from.
   //! \param[in] condition The condition used to evaluate crash reports for
   //!     pruning.
+  //! \param[in] size_threshold The total database size, in bytes, above which
+  //!     to prune without waiting for the daily interval to elapse. If `0`, the
+  //!     database is only pruned daily.
+  //! \param[in] adaptive_scheduling With a \a size_threshold, whether to check
+  //!     the database size at an adaptive interval rather than a fixed one. The
+  //!     interval backs off while the database stays below \a size_threshold,
+  //!     up to the daily interval, and checks are aligned with those of other
+  //!     worker threads so that their wakeups coalesce. See
+  //!     WorkerThread::SetAdaptiveInterval().
   PruneCrashReportThread(CrashReportDatabase* database,
-                         std::unique_ptr<PruneCondition> condition);
+                         std::unique_ptr<PruneCondition> condition,
+                         uint64_t size_threshold = 0,
+                         bool adaptive_scheduling = false);
 
   PruneCrashReportThread(const PruneCrashReportThread&) = delete;
   PruneCrashReportThread& operator=(const PruneCrashReportThread&) = delete;
@@ -73,6 +93,8 @@ class PruneCrashReportThread : public WorkerThread::Delegate, public Stoppable {
   WorkerThread thread_;
   std::unique_ptr<PruneCondition> condition_;
   CrashReportDatabase* database_;  // weak
+  uint64_t size_threshold_;
+  time_t last_prune_time_;
 };
 
 }  // namespace crashpad
@@ -0,0 +1,79 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "handler/report_summary.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "build/build_config.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/process_snapshot.h"
+
+namespace crashpad {
+
+namespace {
+
+std::string BaseName(const std::string& path) {
+#if BUILDFLAG(IS_WIN)
+  const size_t separator = path.find_last_of("\\/");
+#else
+  const size_t separator = path.rfind('/');
+#endif
+  return separator == std::string::npos ? path : path.substr(separator + 1);
+}
+
+}  // namespace
+
+CrashReportDatabase::ReportSummary ReportSummaryFromSnapshot(
+    const ProcessSnapshot& process_snapshot) {
+  CrashReportDatabase::ReportSummary summary;
+  summary.thread_count =
+      static_cast<uint32_t>(process_snapshot.Threads().size());
+
+  const std::vector<const ModuleSnapshot*> modules =
+      process_snapshot.Modules();
+  for (const ModuleSnapshot* module : modules) {
+    if (module->GetModuleType() == ModuleSnapshot::kModuleTypeExecutable) {
+      summary.process_name = BaseName(module->Name());
+      break;
+    }
+  }
+
+  const ExceptionSnapshot* exception = process_snapshot.Exception();
+  if (!exception) {
+    return summary;
+  }
+  summary.exception_code = exception->Exception();
+
+  const CPUContext* context = exception->Context();
+  if (!context) {
+    return summary;
+  }
+  const uint64_t address = context->InstructionPointer();
+  for (const ModuleSnapshot* module : modules) {
+    if (address >= module->Address() &&
+        address - module->Address() < module->Size()) {
+      summary.crashing_module = module->Name();
+      summary.crashing_module_offset = address - module->Address();
+      break;
+    }
+  }
+  return summary;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,41 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CRASHPAD_HANDLER_REPORT_SUMMARY_H_
+#define CRASHPAD_HANDLER_REPORT_SUMMARY_H_
+
+#include "client/crash_report_database.h"
+
+namespace crashpad {
+
+class ProcessSnapshot;
+
+//! \brief Summarizes the crash in \a process_snapshot, for
+//!     CrashReportDatabase::NewReport::SetSummary().
+//!
+//! The crashing module is the module containing the exception’s instruction
+//! pointer, and the process name is the final path component of the
+//! executable module’s name. Fields that can’t be determined, such as those
+//! describing the exception of a dump requested without one, are left with
+//! their default values. CrashReportDatabase::ReportSummary::report_size is
+//! not set, as it is determined when the summary is stored.
+//!
+//! \param[in] process_snapshot The snapshot to summarize.
+//!
+//! \return The summary.
+CrashReportDatabase::ReportSummary ReportSummaryFromSnapshot(
+    const ProcessSnapshot& process_snapshot);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_REPORT_SUMMARY_H_
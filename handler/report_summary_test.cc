@@ -0,0 +1,101 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "handler/report_summary.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "snapshot/cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kLibraryAddress = 0x10000000;
+
+std::unique_ptr<TestProcessSnapshot> MakeSnapshot() {
+  auto process_snapshot = std::make_unique<TestProcessSnapshot>();
+
+  auto library = std::make_unique<TestModuleSnapshot>();
+  library->SetName("/usr/lib/libcrash.so");
+  library->SetModuleType(ModuleSnapshot::kModuleTypeSharedLibrary);
+  library->SetAddressAndSize(kLibraryAddress, 0x10000);
+  process_snapshot->AddModule(std::move(library));
+
+  auto executable = std::make_unique<TestModuleSnapshot>();
+  executable->SetName("/usr/bin/crasher");
+  executable->SetModuleType(ModuleSnapshot::kModuleTypeExecutable);
+  executable->SetAddressAndSize(0x40000000, 0x10000);
+  process_snapshot->AddModule(std::move(executable));
+
+  process_snapshot->AddThread(std::make_unique<TestThreadSnapshot>());
+  process_snapshot->AddThread(std::make_unique<TestThreadSnapshot>());
+  process_snapshot->AddThread(std::make_unique<TestThreadSnapshot>());
+
+  return process_snapshot;
+}
+
+TEST(ReportSummary, Exception) {
+  std::unique_ptr<TestProcessSnapshot> process_snapshot = MakeSnapshot();
+
+  auto exception = std::make_unique<TestExceptionSnapshot>();
+  exception->SetException(11);
+  CPUContext* context = exception->MutableContext();
+  context->architecture = kCPUArchitectureX86_64;
+  context->x86_64->rip = kLibraryAddress + 0x1234;
+  process_snapshot->SetException(std::move(exception));
+
+  const CrashReportDatabase::ReportSummary summary =
+      ReportSummaryFromSnapshot(*process_snapshot);
+  EXPECT_EQ(summary.exception_code, 11u);
+  EXPECT_EQ(summary.crashing_module, "/usr/lib/libcrash.so");
+  EXPECT_EQ(summary.crashing_module_offset, 0x1234u);
+  EXPECT_EQ(summary.process_name, "crasher");
+  EXPECT_EQ(summary.thread_count, 3u);
+}
+
+TEST(ReportSummary, NotInModule) {
+  std::unique_ptr<TestProcessSnapshot> process_snapshot = MakeSnapshot();
+
+  auto exception = std::make_unique<TestExceptionSnapshot>();
+  exception->SetException(4);
+  CPUContext* context = exception->MutableContext();
+  context->architecture = kCPUArchitectureX86_64;
+  context->x86_64->rip = kLibraryAddress - 1;
+  process_snapshot->SetException(std::move(exception));
+
+  const CrashReportDatabase::ReportSummary summary =
+      ReportSummaryFromSnapshot(*process_snapshot);
+  EXPECT_EQ(summary.exception_code, 4u);
+  EXPECT_TRUE(summary.crashing_module.empty());
+  EXPECT_EQ(summary.crashing_module_offset, 0u);
+  EXPECT_EQ(summary.process_name, "crasher");
+}
+
+TEST(ReportSummary, NoException) {
+  const CrashReportDatabase::ReportSummary summary =
+      ReportSummaryFromSnapshot(*MakeSnapshot());
+  EXPECT_EQ(summary.exception_code, 0u);
+  EXPECT_TRUE(summary.crashing_module.empty());
+  EXPECT_EQ(summary.process_name, "crasher");
+  EXPECT_EQ(summary.thread_count, 3u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
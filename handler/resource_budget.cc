@@ -0,0 +1,194 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/resource_budget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "base/logging.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <dirent.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "util/file/file_io.h"
+#include "util/posix/scoped_dir.h"
+#include "util/stdlib/string_number_conversion.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+namespace crashpad {
+
+namespace {
+
+// How long a capture waiting for an exhausted budget waits before measuring
+// usage again, in case it was freed by something other than a capture, such as
+// an upload.
+constexpr std::chrono::seconds kExhaustedRecheckInterval(1);
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+class ProcSelfUsageSource final : public ResourceBudget::UsageSource {
+ public:
+  ProcSelfUsageSource() = default;
+
+  ProcSelfUsageSource(const ProcSelfUsageSource&) = delete;
+  ProcSelfUsageSource& operator=(const ProcSelfUsageSource&) = delete;
+
+  ~ProcSelfUsageSource() override = default;
+
+  bool GetUsage(ResourceBudget::Usage* usage) override {
+    // The second field of statm is the resident set size, in pages.
+    std::string statm;
+    if (!LoggingReadEntireFile(base::FilePath("/proc/self/statm"), &statm)) {
+      return false;
+    }
+    const size_t start = statm.find(' ');
+    const size_t end = statm.find(' ', start + 1);
+    uint64_t resident_pages;
+    if (start == std::string::npos || end == std::string::npos ||
+        !StringToNumber(statm.substr(start + 1, end - start - 1),
+                        &resident_pages)) {
+      LOG(ERROR) << "format error in /proc/self/statm";
+      return false;
+    }
+
+    ScopedDIR dir(opendir("/proc/self/fd"));
+    if (!dir.is_valid()) {
+      PLOG(ERROR) << "opendir";
+      return false;
+    }
+    size_t open_files = 0;
+    dirent* entry;
+    while ((entry = readdir(dir.get())) != nullptr) {
+      if (entry->d_name[0] != '.') {
+        ++open_files;
+      }
+    }
+
+    usage->resident_bytes = resident_pages * getpagesize();
+    // Don’t count the descriptor used to read the directory.
+    usage->open_files = open_files > 0 ? open_files - 1 : 0;
+    return true;
+  }
+};
+
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+std::unique_ptr<ResourceBudget::UsageSource> DefaultUsageSource() {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  return std::make_unique<ProcSelfUsageSource>();
+#else
+  return nullptr;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+}
+
+// Returns the level for usage of |used| against |limit|.
+ResourceBudget::Level LevelForUsage(uint64_t used, uint64_t limit) {
+  if (limit == 0) {
+    return ResourceBudget::Level::kNormal;
+  }
+  if (used >= limit) {
+    return ResourceBudget::Level::kExhausted;
+  }
+  if (used >= limit * ResourceBudget::kReducedFraction) {
+    return ResourceBudget::Level::kReduced;
+  }
+  return ResourceBudget::Level::kNormal;
+}
+
+}  // namespace
+
+ResourceBudget::ScopedCapture::ScopedCapture(ResourceBudget* budget)
+    : budget_(budget),
+      level_(budget ? budget->BeginCapture() : Level::kNormal) {}
+
+ResourceBudget::ScopedCapture::~ScopedCapture() {
+  if (budget_) {
+    budget_->EndCapture();
+  }
+}
+
+ResourceBudget::ResourceBudget(uint64_t max_resident_bytes,
+                               size_t max_open_files)
+    : ResourceBudget(max_resident_bytes, max_open_files, DefaultUsageSource()) {
+}
+
+ResourceBudget::ResourceBudget(uint64_t max_resident_bytes,
+                               size_t max_open_files,
+                               std::unique_ptr<UsageSource> usage_source)
+    : lock_(),
+      capture_ended_(),
+      usage_source_(std::move(usage_source)),
+      max_resident_bytes_(max_resident_bytes),
+      max_open_files_(max_open_files),
+      active_captures_(0) {}
+
+ResourceBudget::~ResourceBudget() {
+  DCHECK_EQ(active_captures_, 0u);
+}
+
+ResourceBudget::Level ResourceBudget::CurrentLevel() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return MeasureLevel();
+}
+
+size_t ResourceBudget::active_captures() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return active_captures_;
+}
+
+ResourceBudget::Level ResourceBudget::MeasureLevel() {
+  if (!usage_source_ || (max_resident_bytes_ == 0 && max_open_files_ == 0)) {
+    return Level::kNormal;
+  }
+
+  Usage usage;
+  if (!usage_source_->GetUsage(&usage)) {
+    return Level::kNormal;
+  }
+
+  return std::max(LevelForUsage(usage.resident_bytes, max_resident_bytes_),
+                  LevelForUsage(usage.open_files, max_open_files_));
+}
+
+ResourceBudget::Level ResourceBudget::BeginCapture() {
+  std::unique_lock<std::mutex> guard(lock_);
+  Level level;
+  while ((level = MeasureLevel()) == Level::kExhausted &&
+         active_captures_ > 0) {
+    capture_ended_.wait_for(guard, kExhaustedRecheckInterval);
+  }
+  ++active_captures_;
+  return level;
+}
+
+void ResourceBudget::EndCapture() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    DCHECK_GT(active_captures_, 0u);
+    --active_captures_;
+  }
+  capture_ended_.notify_all();
+}
+
+}  // namespace crashpad
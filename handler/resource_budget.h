@@ -0,0 +1,151 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_RESOURCE_BUDGET_H_
+#define CRASHPAD_HANDLER_RESOURCE_BUDGET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace crashpad {
+
+//! \brief Bounds the memory and file descriptors that the handler uses while
+//!     capturing and uploading crash reports.
+//!
+//! Captures and uploads consult a budget shared by the whole handler before
+//! they start. The budget compares the handler’s current resident memory and
+//! number of open file descriptors to their limits, and reports a Level that
+//! tells them how much they may take. Captures made while the budget is tight
+//! leave out optional data, and when it is exhausted, wait for other captures
+//! to finish before starting. Uploads, which can wait, are deferred instead.
+//! The number of captures, and so of ptrace attachments, that may be in
+//! progress at once is bounded separately, by
+//! ExceptionHandlerServer::SetMaxConcurrentDumps().
+//!
+//! This object may be used from several threads at once.
+class ResourceBudget {
+ public:
+  //! \brief How much of the budget is in use.
+  enum class Level {
+    //! \brief Usage is below kReducedFraction of every limit.
+    kNormal,
+
+    //! \brief Usage is at least kReducedFraction of a limit. Captures should
+    //!     leave out optional data, and uploads should be made one at a time.
+    kReduced,
+
+    //! \brief Usage is at or above a limit. Captures should leave out optional
+    //!     data and be made one at a time, and uploads should be deferred.
+    kExhausted,
+  };
+
+  //! \brief The fraction of a limit at which the budget becomes
+  //!     Level::kReduced.
+  static constexpr double kReducedFraction = 0.75;
+
+  //! \brief A measurement of the handler’s resource usage.
+  struct Usage {
+    //! \brief The size of the handler’s resident memory, in bytes.
+    uint64_t resident_bytes = 0;
+
+    //! \brief The number of file descriptors that the handler has open.
+    size_t open_files = 0;
+  };
+
+  //! \brief Measures the handler’s resource usage.
+  class UsageSource {
+   public:
+    virtual ~UsageSource() {}
+
+    //! \brief Measures the current resource usage.
+    //!
+    //! \param[out] usage The current usage.
+    //! \return `true` on success. `false` on failure, with a message logged.
+    virtual bool GetUsage(Usage* usage) = 0;
+  };
+
+  //! \brief Reserves the budget for a single capture for its duration.
+  class ScopedCapture {
+   public:
+    //! \brief Waits until a capture may begin within \a budget.
+    //!
+    //! \param[in] budget The budget to reserve from. If `nullptr`, the capture
+    //!     begins immediately at Level::kNormal.
+    explicit ScopedCapture(ResourceBudget* budget);
+
+    ScopedCapture(const ScopedCapture&) = delete;
+    ScopedCapture& operator=(const ScopedCapture&) = delete;
+
+    ~ScopedCapture();
+
+    //! \brief The budget level at the time the capture began.
+    Level level() const { return level_; }
+
+   private:
+    ResourceBudget* budget_;  // weak
+    Level level_;
+  };
+
+  //! \brief Creates a budget that measures the handler’s own usage.
+  //!
+  //! Usage can only be measured on Linux, ChromeOS, and Android. Elsewhere, the
+  //! budget is always at Level::kNormal.
+  //!
+  //! \param[in] max_resident_bytes The resident memory limit, in bytes, or `0`
+  //!     for no limit.
+  //! \param[in] max_open_files The open file descriptor limit, or `0` for no
+  //!     limit.
+  ResourceBudget(uint64_t max_resident_bytes, size_t max_open_files);
+
+  //! \brief Creates a budget that measures usage with \a usage_source.
+  ResourceBudget(uint64_t max_resident_bytes,
+                 size_t max_open_files,
+                 std::unique_ptr<UsageSource> usage_source);
+
+  ResourceBudget(const ResourceBudget&) = delete;
+  ResourceBudget& operator=(const ResourceBudget&) = delete;
+
+  ~ResourceBudget();
+
+  //! \brief Measures usage and returns the current budget level.
+  //!
+  //! If usage can’t be measured, this returns Level::kNormal so that an
+  //! unavailable measurement doesn’t stop captures and uploads.
+  Level CurrentLevel();
+
+  //! \brief Returns the number of captures in progress.
+  size_t active_captures();
+
+ private:
+  // Measures usage and returns the budget level. lock_ must be held.
+  Level MeasureLevel();
+
+  Level BeginCapture();
+  void EndCapture();
+
+  std::mutex lock_;
+  std::condition_variable capture_ended_;
+  std::unique_ptr<UsageSource> usage_source_;
+  uint64_t max_resident_bytes_;
+  size_t max_open_files_;
+  size_t active_captures_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_RESOURCE_BUDGET_H_
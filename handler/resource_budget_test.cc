@@ -0,0 +1,246 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/resource_budget.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/synchronization/semaphore.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class FakeUsageSource final : public ResourceBudget::UsageSource {
+ public:
+  FakeUsageSource(std::mutex* lock, ResourceBudget::Usage* usage, bool* valid)
+      : lock_(lock), usage_(usage), valid_(valid) {}
+
+  FakeUsageSource(const FakeUsageSource&) = delete;
+  FakeUsageSource& operator=(const FakeUsageSource&) = delete;
+
+  ~FakeUsageSource() override = default;
+
+  bool GetUsage(ResourceBudget::Usage* usage) override {
+    std::lock_guard<std::mutex> guard(*lock_);
+    *usage = *usage_;
+    return *valid_;
+  }
+
+ private:
+  std::mutex* lock_;  // weak
+  ResourceBudget::Usage* usage_;  // weak
+  bool* valid_;  // weak
+};
+
+class ResourceBudgetTest : public testing::Test {
+ public:
+  ResourceBudgetTest() : lock_(), usage_(), valid_(true) {}
+
+  ResourceBudgetTest(const ResourceBudgetTest&) = delete;
+  ResourceBudgetTest& operator=(const ResourceBudgetTest&) = delete;
+
+  std::unique_ptr<ResourceBudget> MakeBudget(uint64_t max_resident_bytes,
+                                             size_t max_open_files) {
+    return std::make_unique<ResourceBudget>(
+        max_resident_bytes,
+        max_open_files,
+        std::make_unique<FakeUsageSource>(&lock_, &usage_, &valid_));
+  }
+
+  void SetUsage(uint64_t resident_bytes, size_t open_files) {
+    std::lock_guard<std::mutex> guard(lock_);
+    usage_.resident_bytes = resident_bytes;
+    usage_.open_files = open_files;
+  }
+
+  void SetValid(bool valid) {
+    std::lock_guard<std::mutex> guard(lock_);
+    valid_ = valid;
+  }
+
+ private:
+  std::mutex lock_;
+  ResourceBudget::Usage usage_;
+  bool valid_;
+};
+
+TEST_F(ResourceBudgetTest, Unlimited) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(0, 0);
+  SetUsage(1 << 30, 1000);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kNormal);
+}
+
+TEST_F(ResourceBudgetTest, ResidentMemory) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(1000, 0);
+
+  SetUsage(749, 1000);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kNormal);
+
+  SetUsage(750, 0);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kReduced);
+
+  SetUsage(1000, 0);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kExhausted);
+
+  SetUsage(100, 0);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kNormal);
+}
+
+TEST_F(ResourceBudgetTest, OpenFiles) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(1000, 100);
+
+  SetUsage(0, 74);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kNormal);
+
+  SetUsage(0, 75);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kReduced);
+
+  // The most constrained resource determines the level.
+  SetUsage(1000, 75);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kExhausted);
+
+  SetUsage(750, 100);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kExhausted);
+}
+
+TEST_F(ResourceBudgetTest, UsageUnavailable) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(1000, 100);
+  SetUsage(1000, 100);
+  SetValid(false);
+  EXPECT_EQ(budget->CurrentLevel(), ResourceBudget::Level::kNormal);
+}
+
+TEST_F(ResourceBudgetTest, NoBudget) {
+  ResourceBudget::ScopedCapture capture(nullptr);
+  EXPECT_EQ(capture.level(), ResourceBudget::Level::kNormal);
+}
+
+TEST_F(ResourceBudgetTest, CaptureLevel) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(1000, 0);
+
+  SetUsage(800, 0);
+  {
+    ResourceBudget::ScopedCapture first(budget.get());
+    EXPECT_EQ(first.level(), ResourceBudget::Level::kReduced);
+    EXPECT_EQ(budget->active_captures(), 1u);
+
+    // A reduced budget doesn’t hold up other captures.
+    ResourceBudget::ScopedCapture second(budget.get());
+    EXPECT_EQ(second.level(), ResourceBudget::Level::kReduced);
+    EXPECT_EQ(budget->active_captures(), 2u);
+  }
+  EXPECT_EQ(budget->active_captures(), 0u);
+
+  // The first capture made with an exhausted budget proceeds.
+  SetUsage(1000, 0);
+  ResourceBudget::ScopedCapture capture(budget.get());
+  EXPECT_EQ(capture.level(), ResourceBudget::Level::kExhausted);
+}
+
+class CaptureThread : public Thread {
+ public:
+  CaptureThread(ResourceBudget* budget, Semaphore* started)
+      : budget_(budget), started_(started), level_(), begun_(false) {}
+
+  CaptureThread(const CaptureThread&) = delete;
+  CaptureThread& operator=(const CaptureThread&) = delete;
+
+  ~CaptureThread() override = default;
+
+  bool begun() const { return begun_; }
+  ResourceBudget::Level level() const { return level_; }
+
+ private:
+  void ThreadMain() override {
+    started_->Signal();
+    ResourceBudget::ScopedCapture capture(budget_);
+    level_ = capture.level();
+    begun_ = true;
+  }
+
+  ResourceBudget* budget_;  // weak
+  Semaphore* started_;  // weak
+  ResourceBudget::Level level_;
+  std::atomic_bool begun_;
+};
+
+TEST_F(ResourceBudgetTest, ExhaustedCapturesWait) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(1000, 0);
+
+  SetUsage(1000, 0);
+  auto first = std::make_unique<ResourceBudget::ScopedCapture>(budget.get());
+  EXPECT_EQ(first->level(), ResourceBudget::Level::kExhausted);
+
+  Semaphore started(0);
+  CaptureThread thread(budget.get(), &started);
+  thread.Start();
+  started.Wait();
+
+  // The second capture waits for the first to end.
+  SleepNanoseconds(100 * 1000 * 1000);
+  EXPECT_FALSE(thread.begun());
+  EXPECT_EQ(budget->active_captures(), 1u);
+
+  first.reset();
+  thread.Join();
+  EXPECT_TRUE(thread.begun());
+  EXPECT_EQ(thread.level(), ResourceBudget::Level::kExhausted);
+  EXPECT_EQ(budget->active_captures(), 0u);
+}
+
+TEST_F(ResourceBudgetTest, ExhaustedCapturesRecheck) {
+  std::unique_ptr<ResourceBudget> budget = MakeBudget(1000, 0);
+
+  SetUsage(1000, 0);
+  ResourceBudget::ScopedCapture first(budget.get());
+
+  Semaphore started(0);
+  CaptureThread thread(budget.get(), &started);
+  thread.Start();
+  started.Wait();
+
+  // Usage freed by something other than a capture is noticed without waiting
+  // for the first capture to end.
+  SleepNanoseconds(100 * 1000 * 1000);
+  EXPECT_FALSE(thread.begun());
+  SetUsage(100, 0);
+  thread.Join();
+  EXPECT_TRUE(thread.begun());
+  EXPECT_EQ(thread.level(), ResourceBudget::Level::kNormal);
+  EXPECT_EQ(budget->active_captures(), 1u);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST(ResourceBudget, OwnUsage) {
+  // This process has at least one resident byte and a standard stream open.
+  EXPECT_EQ(ResourceBudget(1, 0).CurrentLevel(),
+            ResourceBudget::Level::kExhausted);
+  EXPECT_EQ(ResourceBudget(0, 1).CurrentLevel(),
+            ResourceBudget::Level::kExhausted);
+  EXPECT_EQ(ResourceBudget(uint64_t{1} << 62, 1 << 30).CurrentLevel(),
+            ResourceBudget::Level::kNormal);
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,64 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/staged_report_commit_thread.h"
+
+#include <vector>
+
+#include "client/crash_report_database.h"
+#include "handler/crash_report_upload_thread.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr double kCommitRetryInterval = 60;
+
+}  // namespace
+
+StagedReportCommitThread::StagedReportCommitThread(
+    CrashReportDatabase* database,
+    CrashReportUploadThread* upload_thread)
+    : thread_(kCommitRetryInterval, this),
+      database_(database),
+      upload_thread_(upload_thread) {}
+
+StagedReportCommitThread::~StagedReportCommitThread() {}
+
+void StagedReportCommitThread::ReportStaged() {
+  thread_.DoWorkNow();
+}
+
+void StagedReportCommitThread::Start() {
+  thread_.Start(0);
+}
+
+void StagedReportCommitThread::Stop() {
+  thread_.Stop();
+}
+
+void StagedReportCommitThread::DoWork(const WorkerThread* thread) {
+  // Reports that can’t be committed now remain staged and are retried at the
+  // next interval.
+  std::vector<UUID> uuids;
+  database_->CommitStagedReports(&uuids);
+  if (upload_thread_) {
+    for (const UUID& uuid : uuids) {
+      upload_thread_->ReportPending(uuid);
+    }
+  }
+}
+
+}  // namespace crashpad
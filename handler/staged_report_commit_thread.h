@@ -0,0 +1,83 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_STAGED_REPORT_COMMIT_THREAD_H_
+#define CRASHPAD_HANDLER_STAGED_REPORT_COMMIT_THREAD_H_
+
+#include "util/thread/stoppable.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+class CrashReportDatabase;
+class CrashReportUploadThread;
+
+//! \brief A thread that commits reports staged by the database to the
+//!     database, and informs the upload thread of them.
+//!
+//! Reports are committed as soon as the thread is started, which commits any
+//! left staged by an earlier process, whenever ReportStaged() is called, and
+//! every minute, which retries those that couldn’t be committed earlier. See
+//! CrashReportDatabase::SetStagingDirectory().
+class StagedReportCommitThread : public WorkerThread::Delegate,
+                                 public Stoppable {
+ public:
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] database The database to commit staged reports in.
+  //! \param[in] upload_thread The upload thread to inform of committed
+  //!     reports, or `nullptr`.
+  StagedReportCommitThread(CrashReportDatabase* database,
+                           CrashReportUploadThread* upload_thread);
+
+  StagedReportCommitThread(const StagedReportCommitThread&) = delete;
+  StagedReportCommitThread& operator=(const StagedReportCommitThread&) =
+      delete;
+
+  ~StagedReportCommitThread();
+
+  //! \brief Informs the thread that a report has been staged, so that it’s
+  //!     committed without waiting for the next periodic commit.
+  //!
+  //! This method may be called from any thread.
+  void ReportStaged();
+
+  // Stoppable:
+
+  //! \brief Starts a dedicated thread to commit staged reports.
+  //!
+  //! This method may only be be called on a newly-constructed object or after
+  //! a call to Stop().
+  void Start() override;
+
+  //! \brief Stops the thread.
+  //!
+  //! This method must only be called after Start(). If Start() has been called,
+  //! this method must be called before destroying an object of this class.
+  //!
+  //! This method may be called from any thread other than the commit thread.
+  void Stop() override;
+
+ private:
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  WorkerThread thread_;
+  CrashReportDatabase* database_;  // weak
+  CrashReportUploadThread* upload_thread_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_STAGED_REPORT_COMMIT_THREAD_H_
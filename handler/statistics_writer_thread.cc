@@ -0,0 +1,97 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/statistics_writer_thread.h"
+
+#include <inttypes.h>
+#include <time.h>
+
+#include <vector>
+
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
+#include "client/crash_report_database.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/misc/statistics.h"
+
+namespace crashpad {
+
+StatisticsWriterThread::StatisticsWriterThread(CrashReportDatabase* database,
+                                               const base::FilePath& path,
+                                               double interval)
+    : thread_(interval, this), path_(path), database_(database) {}
+
+StatisticsWriterThread::~StatisticsWriterThread() {}
+
+std::string StatisticsWriterThread::StatisticsJSON() {
+  std::string json =
+      base::StringPrintf("{\"time\":%" PRId64 ",\"database\":{",
+                         static_cast<int64_t>(time(nullptr)));
+
+  bool first = true;
+  std::vector<CrashReportDatabase::Report> pending_reports;
+  if (database_->GetPendingReports(&pending_reports) ==
+      CrashReportDatabase::kNoError) {
+    base::StringAppendF(
+        &json, "\"pending_reports\":%" PRIuS, pending_reports.size());
+    first = false;
+  }
+  uint64_t total_size;
+  if (database_->GetTotalSize(&total_size) == CrashReportDatabase::kNoError) {
+    base::StringAppendF(&json,
+                        "%s\"total_size\":%" PRIu64,
+                        first ? "" : ",",
+                        total_size);
+  }
+
+  json.append("},\"statistics\":");
+  json.append(Statistics::Get()->ToJSON());
+  json.append("}\n");
+  return json;
+}
+
+bool StatisticsWriterThread::WriteStatistics() {
+  const std::string json = StatisticsJSON();
+
+  // Write a temporary file beside the destination and move it into place, so
+  // that readers only ever see a complete file.
+  const base::FilePath temp_path(path_.value() + FILE_PATH_LITERAL(".tmp"));
+  {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(temp_path,
+                                FileWriteMode::kTruncateOrCreate,
+                                FilePermissions::kWorldReadable));
+    if (!handle.is_valid() ||
+        !LoggingWriteFile(handle.get(), json.data(), json.size())) {
+      return false;
+    }
+  }
+  return MoveFileOrDirectory(temp_path, path_);
+}
+
+void StatisticsWriterThread::Start() {
+  thread_.Start(0);
+}
+
+void StatisticsWriterThread::Stop() {
+  thread_.Stop();
+  WriteStatistics();
+}
+
+void StatisticsWriterThread::DoWork(const WorkerThread* thread) {
+  WriteStatistics();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,97 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_STATISTICS_WRITER_THREAD_H_
+#define CRASHPAD_HANDLER_STATISTICS_WRITER_THREAD_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "util/thread/stoppable.h"
+#include "util/thread/worker_thread.h"
+
+namespace crashpad {
+
+class CrashReportDatabase;
+
+//! \brief A thread that periodically writes the handler’s statistics to a
+//!     file.
+//!
+//! The file holds a single JSON object with these members:
+//!  - `"time"`: The time the file was written, in seconds since the POSIX
+//!    epoch.
+//!  - `"database"`: An object giving the number of `"pending_reports"` in the
+//!    database, which is the depth of the upload queue, and the database’s
+//!    `"total_size"` in bytes. Either is left out if the database can’t
+//!    report it.
+//!  - `"statistics"`: The process-wide counters and histograms described by
+//!    Statistics::ToJSON(), covering capture results, the duration of each
+//!    capture phase, report sizes, upload results, durations, and bytes,
+//!    skipped and rate-limited uploads, and pruning.
+//!
+//! The file is replaced rather than rewritten in place, so a reader never
+//! observes a partially written file.
+class StatisticsWriterThread : public WorkerThread::Delegate,
+                               public Stoppable {
+ public:
+  //! \brief Constructs a new object.
+  //!
+  //! \param[in] database The database to report on. Weak.
+  //! \param[in] path The path of the file to write.
+  //! \param[in] interval The interval between writes, in seconds.
+  StatisticsWriterThread(CrashReportDatabase* database,
+                         const base::FilePath& path,
+                         double interval);
+
+  StatisticsWriterThread(const StatisticsWriterThread&) = delete;
+  StatisticsWriterThread& operator=(const StatisticsWriterThread&) = delete;
+
+  ~StatisticsWriterThread();
+
+  //! \brief Returns the statistics as the JSON object written to the file.
+  std::string StatisticsJSON();
+
+  //! \brief Writes the statistics file now.
+  //!
+  //! \return `true` on success, `false` on failure, with a message logged.
+  bool WriteStatistics();
+
+  // Stoppable:
+
+  //! \brief Starts a dedicated thread that writes the statistics file
+  //!     immediately and then at the interval given to the constructor.
+  //!
+  //! This method may only be be called on a newly-constructed object or after
+  //! a call to Stop().
+  void Start() override;
+
+  //! \brief Stops the thread, after writing the statistics file a final
+  //!     time.
+  //!
+  //! This method must only be called after Start(). If Start() has been called,
+  //! this method must be called before destroying an object of this class.
+  void Stop() override;
+
+ private:
+  // WorkerThread::Delegate:
+  void DoWork(const WorkerThread* thread) override;
+
+  WorkerThread thread_;
+  base::FilePath path_;
+  CrashReportDatabase* database_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_STATISTICS_WRITER_THREAD_H_
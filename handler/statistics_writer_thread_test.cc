@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/statistics_writer_thread.h"
+
+#include <memory>
+#include <string>
+
+#include "client/crash_report_database.h"
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/misc/metrics.h"
+#include "util/misc/statistics.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(StatisticsWriterThread, WriteStatistics) {
+  ScopedTempDir temp_dir;
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(
+          temp_dir.path().Append(FILE_PATH_LITERAL("database")));
+  ASSERT_TRUE(database);
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(database->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  static constexpr char kReport[] = "report";
+  ASSERT_TRUE(new_report->Writer()->Write(kReport, sizeof(kReport)));
+  UUID uuid;
+  ASSERT_EQ(database->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  Statistics::Get()->Reset();
+  Metrics::CrashReportsPruned(2);
+
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("statistics.json"));
+  StatisticsWriterThread writer(database.get(), path, 60);
+  ASSERT_TRUE(writer.WriteStatistics());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path, &contents));
+  EXPECT_EQ(contents.compare(0, 8, "{\"time\":"), 0);
+  EXPECT_EQ(contents.back(), '\n');
+  EXPECT_NE(contents.find("\"database\":{\"pending_reports\":1"),
+            std::string::npos);
+  EXPECT_NE(contents.find("\"total_size\":"), std::string::npos);
+  EXPECT_NE(contents.find("\"statistics\":{\"exceptions\":"),
+            std::string::npos);
+  EXPECT_NE(contents.find("\"pruning\":{\"runs\":1,\"reports_pruned\":2}"),
+            std::string::npos);
+
+  // The temporary file is moved into place, not left behind.
+  EXPECT_FALSE(IsRegularFile(
+      temp_dir.path().Append(FILE_PATH_LITERAL("statistics.json.tmp"))));
+
+  // Writing again replaces the file.
+  Metrics::CrashReportsPruned(1);
+  ASSERT_TRUE(writer.WriteStatistics());
+  ASSERT_TRUE(LoggingReadEntireFile(path, &contents));
+  EXPECT_NE(contents.find("\"pruning\":{\"runs\":2,\"reports_pruned\":3}"),
+            std::string::npos);
+
+  Statistics::Get()->Reset();
+}
+
+TEST(StatisticsWriterThread, StartStop) {
+  ScopedTempDir temp_dir;
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(
+          temp_dir.path().Append(FILE_PATH_LITERAL("database")));
+  ASSERT_TRUE(database);
+
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("statistics.json"));
+  StatisticsWriterThread writer(database.get(), path, 60);
+  writer.Start();
+  writer.Stop();
+
+  // Stop() writes the file a final time, so it exists whether or not the
+  // thread got to write it first.
+  EXPECT_TRUE(IsRegularFile(path));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
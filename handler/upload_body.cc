@@ -0,0 +1,125 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "handler/upload_body.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/logging.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/net/http_body.h"
+#include "util/net/http_headers.h"
+#include "util/net/http_multipart_builder.h"
+
+namespace crashpad {
+
+namespace {
+
+// The parts named as CrashReportUploadThread::AddReportToUpload() names them,
+// which form parameters may not replace.
+constexpr char kMinidumpKey[] = "upload_file_minidump";
+constexpr const char* kReservedKeys[] = {
+    kMinidumpKey,
+    "upload_file_minidump_xxh64",
+    "upload_file_minidump_size",
+    "upload_trimmed",
+};
+
+bool IsReservedKey(const std::string& key) {
+  for (const char* reserved_key : kReservedKeys) {
+    if (key == reserved_key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool AddUploadBodyToReport(
+    CrashReportDatabase::NewReport* new_report,
+    const std::map<std::string, std::string>& parameters,
+    const std::map<std::string, base::FilePath>& attachments) {
+  FileReader* minidump_reader = new_report->StoredReader();
+  if (!minidump_reader) {
+    return false;
+  }
+
+  HTTPMultipartBuilder http_multipart_builder;
+  http_multipart_builder.SetGzipEnabled(true);
+
+  for (const auto& kv : parameters) {
+    if (IsReservedKey(kv.first)) {
+      LOG(WARNING) << "reserved key " << kv.first << ", discarding value "
+                   << kv.second;
+    } else {
+      http_multipart_builder.SetFormData(kv.first, kv.second);
+    }
+  }
+
+  std::vector<std::unique_ptr<FileReader>> attachment_readers;
+  for (const auto& attachment : attachments) {
+    auto attachment_reader = std::make_unique<FileReader>();
+    if (!attachment_reader->Open(attachment.second)) {
+      return false;
+    }
+    http_multipart_builder.SetFileAttachment(attachment.first,
+                                             attachment.first,
+                                             attachment_reader.get(),
+                                             "application/octet-stream");
+    attachment_readers.push_back(std::move(attachment_reader));
+  }
+
+  const std::string minidump_file_name =
+      new_report->ReportID().ToString() + ".dmp";
+  if (new_report->IsCompressed()) {
+    http_multipart_builder.SetGzipFileAttachment(kMinidumpKey,
+                                                 minidump_file_name,
+                                                 minidump_reader,
+                                                 "application/octet-stream");
+  } else {
+    http_multipart_builder.SetFileAttachment(kMinidumpKey,
+                                             minidump_file_name,
+                                             minidump_reader,
+                                             "application/octet-stream");
+  }
+
+  FileWriter* body_writer = new_report->AddUploadBody();
+  if (!body_writer) {
+    return false;
+  }
+
+  const std::unique_ptr<HTTPBodyStream> body_stream =
+      http_multipart_builder.GetBodyStream();
+  uint8_t buffer[32 * 1024];
+  FileOperationResult rv;
+  while ((rv = body_stream->GetBytesBuffer(buffer, sizeof(buffer))) > 0) {
+    if (!body_writer->Write(buffer, rv)) {
+      return false;
+    }
+  }
+  if (rv < 0) {
+    LOG(ERROR) << "error reading upload body";
+    return false;
+  }
+
+  HTTPHeaders content_headers;
+  http_multipart_builder.PopulateContentHeaders(&content_headers);
+  return new_report->SetUploadBodyHeaders(content_headers);
+}
+
+}  // namespace crashpad
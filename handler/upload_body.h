@@ -0,0 +1,55 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CRASHPAD_HANDLER_UPLOAD_BODY_H_
+#define CRASHPAD_HANDLER_UPLOAD_BODY_H_
+
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "client/crash_report_database.h"
+
+namespace crashpad {
+
+//! \brief Stores the HTTP body with which \a new_report will be uploaded, so
+//!     that CrashReportUploadThread can send it as-is. See
+//!     CrashReportDatabase::NewReport::AddUploadBody().
+//!
+//! The body is the `gzip`-compressed multipart message that
+//! CrashReportUploadThread builds when
+//! CrashReportUploadThread::Options::upload_gzip is `true`, holding \a
+//! parameters, \a attachments, and the minidump. It is compressed once, as it
+//! is stored, and the minidump of a compressed report is placed into it
+//! without being compressed again. An upload of the stored body needn’t read
+//! the report and its attachments back and compress them. The body doesn’t
+//! carry the report’s content digest, nor anything that trimming the report
+//! to fit CrashReportUploadThread::Options::max_upload_size would add.
+//!
+//! This must be called once the report’s minidump has been written.
+//!
+//! \param[in] new_report The report to store the body with.
+//! \param[in] parameters The HTTP form parameters for the report, as passed
+//!     to CrashReportDatabase::NewReport::SetUploadParameters().
+//! \param[in] attachments The files to attach to the report, keyed by the
+//!     names to give them.
+//!
+//! \return `true` on success, `false` on failure with a message logged.
+bool AddUploadBodyToReport(
+    CrashReportDatabase::NewReport* new_report,
+    const std::map<std::string, std::string>& parameters,
+    const std::map<std::string, base::FilePath>& attachments);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_UPLOAD_BODY_H_
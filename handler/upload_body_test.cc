@@ -0,0 +1,104 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "handler/upload_body.h"
+
+#include <string.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_helper.h"
+#include "util/file/file_io.h"
+#include "util/file/file_writer.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class UploadBodyTest : public testing::TestWithParam<bool> {};
+
+TEST_P(UploadBodyTest, AddUploadBodyToReport) {
+  ScopedTempDir temp_dir;
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(temp_dir.path().Append("database"));
+  ASSERT_TRUE(database);
+  database->SetCompressNewReports(GetParam());
+
+  std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+  ASSERT_EQ(database->PrepareNewCrashReport(&new_report),
+            CrashReportDatabase::kNoError);
+  static constexpr char kMinidump[] = "minidump contents";
+  ASSERT_TRUE(
+      new_report->MinidumpWriter()->Write(kMinidump, strlen(kMinidump)));
+
+  static constexpr char kAttachment[] = "attachment contents";
+  const base::FilePath attachment_path = temp_dir.path().Append("attachment");
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(attachment_path,
+                            FileWriteMode::kCreateOrFail,
+                            FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write(kAttachment, strlen(kAttachment)));
+  }
+
+  const std::map<std::string, std::string> parameters = {
+      {"prod", "crashpad_test"},
+      {"upload_file_minidump", "reserved"},
+  };
+  ASSERT_TRUE(AddUploadBodyToReport(
+      new_report.get(), parameters, {{"some_file", attachment_path}}));
+  const std::string minidump_file_name =
+      new_report->ReportID().ToString() + ".dmp";
+
+  UUID uuid;
+  ASSERT_EQ(database->FinishedWritingCrashReport(std::move(new_report), &uuid),
+            CrashReportDatabase::kNoError);
+
+  std::unique_ptr<const CrashReportDatabase::UploadReport> upload_report;
+  ASSERT_EQ(database->GetReportForUploading(uuid, &upload_report),
+            CrashReportDatabase::kNoError);
+  std::map<std::string, std::string> content_headers;
+  FileReader* body_reader = upload_report->GetUploadBody(&content_headers);
+  ASSERT_TRUE(body_reader);
+  EXPECT_EQ(content_headers["Content-Encoding"], "gzip");
+  EXPECT_EQ(content_headers["Content-Type"].find("multipart/form-data"), 0u);
+
+  // The body decompresses to a message holding the parameters, the
+  // attachment, and the minidump.
+  StringFile body;
+  ASSERT_TRUE(DecompressGzipFileContent(body_reader, &body));
+  const std::string& body_string = body.string();
+  EXPECT_NE(body_string.find("name=\"prod\"\r\n\r\ncrashpad_test\r\n"),
+            std::string::npos);
+  EXPECT_EQ(body_string.find("reserved"), std::string::npos);
+  EXPECT_NE(body_string.find("name=\"some_file\"; filename=\"some_file\""),
+            std::string::npos);
+  EXPECT_NE(body_string.find(kAttachment), std::string::npos);
+  EXPECT_NE(body_string.find("name=\"upload_file_minidump\"; filename=\"" +
+                             minidump_file_name + "\""),
+            std::string::npos);
+  EXPECT_NE(body_string.find(kMinidump), std::string::npos);
+}
+
+INSTANTIATE_TEST_SUITE_P(CompressedReport,
+                         UploadBodyTest,
+                         testing::Bool());
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
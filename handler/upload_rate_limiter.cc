@@ -0,0 +1,189 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/upload_rate_limiter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "util/file/file_io.h"
+#include "util/file/filesystem.h"
+#include "util/misc/xxhash64.h"
+
+namespace crashpad {
+
+namespace {
+
+struct FileHeader {
+  static constexpr uint32_t kMagic = 'CPrl';
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t bucket_count;
+  uint32_t padding;
+};
+
+}  // namespace
+
+UploadRateLimiter::UploadRateLimiter(const base::FilePath& path,
+                                     uint32_t burst,
+                                     uint32_t refill_interval)
+    : path_(path),
+      buckets_(),
+      burst_(burst),
+      refill_interval_(refill_interval),
+      read_(false) {
+  DCHECK_GT(burst_, 0u);
+  DCHECK_GT(refill_interval_, 0u);
+}
+
+UploadRateLimiter::~UploadRateLimiter() {}
+
+bool UploadRateLimiter::TakeToken(const std::string& product,
+                                  const std::string& signature,
+                                  time_t now) {
+  if (!read_) {
+    Read();
+    read_ = true;
+  }
+
+  // The product and signature are separated by a NUL, which neither contains,
+  // so that no two combinations are hashed from the same bytes.
+  XXHash64 hash;
+  hash.Update(product.data(), product.size());
+  hash.Update("", 1);
+  hash.Update(signature.data(), signature.size());
+  const uint64_t key = hash.Digest();
+
+  auto bucket = std::find_if(
+      buckets_.begin(), buckets_.end(), [key](const Bucket& bucket) {
+        return bucket.key == key;
+      });
+  if (bucket == buckets_.end()) {
+    if (buckets_.size() >= kMaxBuckets) {
+      auto oldest = std::min_element(
+          buckets_.begin(),
+          buckets_.end(),
+          [](const Bucket& lhs, const Bucket& rhs) {
+            return lhs.refill_time < rhs.refill_time;
+          });
+      *oldest = buckets_.back();
+      buckets_.pop_back();
+    }
+    buckets_.push_back({key, now, burst_, 0});
+    bucket = buckets_.end() - 1;
+  } else if (now < bucket->refill_time) {
+    // The clock has moved backwards. Refilling starts over from now, without
+    // adding any tokens.
+    bucket->refill_time = now;
+  } else {
+    // Whole intervals since the last refill each add a token. The remainder
+    // counts toward the next one, unless the bucket is full.
+    const uint64_t tokens_gained =
+        static_cast<uint64_t>(now - bucket->refill_time) / refill_interval_;
+    if (tokens_gained >= burst_ - std::min(bucket->tokens, burst_)) {
+      bucket->tokens = burst_;
+      bucket->refill_time = now;
+    } else {
+      bucket->tokens += static_cast<uint32_t>(tokens_gained);
+      bucket->refill_time +=
+          static_cast<int64_t>(tokens_gained * refill_interval_);
+    }
+  }
+
+  const bool took_token = bucket->tokens > 0;
+  if (took_token) {
+    --bucket->tokens;
+  }
+  Write();
+  return took_token;
+}
+
+void UploadRateLimiter::Read() {
+  buckets_.clear();
+  if (path_.empty()) {
+    return;
+  }
+
+  // A missing file is expected the first time, and isn't logged.
+  ScopedFileHandle handle(OpenFileForRead(path_));
+  if (!handle.is_valid()) {
+    return;
+  }
+
+  std::string contents;
+  if (!LoggingReadToEOF(handle.get(), &contents)) {
+    return;
+  }
+
+  FileHeader header;
+  if (contents.size() < sizeof(header)) {
+    LOG(ERROR) << "upload rate limits file too short";
+    return;
+  }
+  memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != FileHeader::kMagic ||
+      header.version != FileHeader::kVersion ||
+      header.bucket_count > kMaxBuckets ||
+      contents.size() !=
+          sizeof(header) + header.bucket_count * sizeof(Bucket)) {
+    LOG(ERROR) << "invalid upload rate limits file";
+    return;
+  }
+
+  buckets_.resize(header.bucket_count);
+  memcpy(buckets_.data(),
+         contents.data() + sizeof(header),
+         header.bucket_count * sizeof(Bucket));
+
+  // A burst lowered since the file was written takes effect immediately.
+  for (Bucket& bucket : buckets_) {
+    bucket.tokens = std::min(bucket.tokens, burst_);
+  }
+}
+
+bool UploadRateLimiter::Write() {
+  if (path_.empty()) {
+    return true;
+  }
+
+  FileHeader header;
+  header.magic = FileHeader::kMagic;
+  header.version = FileHeader::kVersion;
+  header.bucket_count = static_cast<uint32_t>(buckets_.size());
+  header.padding = 0;
+
+  // Write a temporary file beside the destination and move it into place, so
+  // that a reader never sees a partly written file.
+  const base::FilePath temp_path(path_.value() + FILE_PATH_LITERAL(".tmp"));
+  {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(temp_path,
+                                FileWriteMode::kTruncateOrCreate,
+                                FilePermissions::kOwnerOnly));
+    if (!handle.is_valid() ||
+        !LoggingWriteFile(handle.get(), &header, sizeof(header)) ||
+        !LoggingWriteFile(handle.get(),
+                          buckets_.data(),
+                          buckets_.size() * sizeof(Bucket))) {
+      return false;
+    }
+  }
+  return MoveFileOrDirectory(temp_path, path_);
+}
+
+}  // namespace crashpad
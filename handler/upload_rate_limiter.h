@@ -0,0 +1,105 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_UPLOAD_RATE_LIMITER_H_
+#define CRASHPAD_HANDLER_UPLOAD_RATE_LIMITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+namespace crashpad {
+
+//! \brief Limits the uploads of crash reports with each crash signature and
+//!     product, with a token bucket for each combination.
+//!
+//! A bucket holds up to a burst of tokens, and gains one token each refill
+//! interval. A report may be uploaded if its bucket holds a token, which the
+//! upload takes. A component that crashes repeatedly in the same way soon
+//! empties its bucket, and its later reports are throttled, while reports of
+//! other crashes and of other products are unaffected.
+//!
+//! Buckets are identified by a hash of the product and signature, and are
+//! kept in a table of at most kMaxBuckets entries, which may be stored in a
+//! file so that they outlast the handler. When the table is full, the least recently
+//! refilled bucket gives way to a new one. That bucket would have refilled
+//! the most by now, so forgetting it loses the least.
+//!
+//! This object is not thread-safe. Objects in several processes sharing a
+//! file don’t corrupt it, but may overwrite each other’s changes.
+class UploadRateLimiter {
+ public:
+  //! \brief The largest number of buckets kept.
+  static constexpr size_t kMaxBuckets = 64;
+
+  //! \param[in] path The file to keep the buckets in, which is created if it
+  //!     doesn’t exist, or empty to keep them only in memory.
+  //! \param[in] burst The number of tokens that a bucket holds when full, and
+  //!     so the number of reports with a signature that may be uploaded in
+  //!     quick succession. Must be greater than `0`.
+  //! \param[in] refill_interval The number of seconds in which a bucket gains
+  //!     a token. Must be greater than `0`.
+  UploadRateLimiter(const base::FilePath& path,
+                    uint32_t burst,
+                    uint32_t refill_interval);
+
+  UploadRateLimiter(const UploadRateLimiter&) = delete;
+  UploadRateLimiter& operator=(const UploadRateLimiter&) = delete;
+
+  ~UploadRateLimiter();
+
+  //! \brief Takes a token from the bucket for \a product and \a signature, if
+  //!     it has one.
+  //!
+  //! \param[in] product The product of the report being uploaded.
+  //! \param[in] signature The crash signature of the report being uploaded.
+  //!     Reports without a signature share their product’s bucket.
+  //! \param[in] now The current time.
+  //!
+  //! \return `true` if a token was taken and the report may be uploaded.
+  //!     `false` if the report should be throttled.
+  bool TakeToken(const std::string& product,
+                 const std::string& signature,
+                 time_t now);
+
+ private:
+  struct Bucket {
+    uint64_t key;
+    int64_t refill_time;  // time_t
+    uint32_t tokens;
+    uint32_t padding;
+  };
+
+  // Reads buckets_ from path_, leaving it empty if the file doesn't exist or
+  // isn't valid.
+  void Read();
+
+  // Writes buckets_ to path_. Returns false with a message logged on failure.
+  bool Write();
+
+  base::FilePath path_;
+  std::vector<Bucket> buckets_;
+  uint32_t burst_;
+  uint32_t refill_interval_;
+  bool read_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_UPLOAD_RATE_LIMITER_H_
@@ -0,0 +1,128 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/upload_rate_limiter.h"
+
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class UploadRateLimiterTest : public testing::Test {
+ protected:
+  base::FilePath path() const {
+    return temp_dir_.path().Append(FILE_PATH_LITERAL("limits"));
+  }
+
+ private:
+  ScopedTempDir temp_dir_;
+};
+
+TEST_F(UploadRateLimiterTest, Burst) {
+  UploadRateLimiter limiter(path(), 3, 60);
+  constexpr time_t kStart = 100000;
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart));
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart));
+
+  // Other signatures and products have their own buckets.
+  EXPECT_TRUE(limiter.TakeToken("product", "other signature", kStart));
+  EXPECT_TRUE(limiter.TakeToken("other product", "signature", kStart));
+  EXPECT_TRUE(limiter.TakeToken("product", std::string(), kStart));
+
+  // A token is added each interval.
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart + 59));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart + 60));
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart + 61));
+
+  // The part of an interval that has passed counts toward the next token.
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart + 120));
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart + 120));
+
+  // The bucket holds no more than the burst.
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart + 100000));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart + 100000));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart + 100000));
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart + 100000));
+}
+
+TEST_F(UploadRateLimiterTest, ClockMovesBackwards) {
+  UploadRateLimiter limiter(path(), 1, 60);
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", 100000));
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", 50000));
+
+  // Refilling starts over from the earlier time.
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", 50059));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", 50060));
+}
+
+TEST_F(UploadRateLimiterTest, Persistence) {
+  constexpr time_t kStart = 100000;
+  {
+    UploadRateLimiter limiter(path(), 2, 60);
+    EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart));
+    EXPECT_TRUE(limiter.TakeToken("product", "signature", kStart));
+    EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart));
+  }
+
+  UploadRateLimiter limiter(path(), 2, 60);
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", kStart));
+  EXPECT_TRUE(limiter.TakeToken("product", "other signature", kStart));
+
+  // A file that isn't valid is replaced.
+  ScopedFileHandle handle(LoggingOpenFileForWrite(
+      path(), FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  ASSERT_TRUE(LoggingWriteFile(handle.get(), "garbage", 7));
+  handle.reset();
+  UploadRateLimiter new_limiter(path(), 2, 60);
+  EXPECT_TRUE(new_limiter.TakeToken("product", "signature", kStart));
+}
+
+TEST_F(UploadRateLimiterTest, InMemory) {
+  UploadRateLimiter limiter(base::FilePath(), 1, 60);
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", 100000));
+  EXPECT_FALSE(limiter.TakeToken("product", "signature", 100000));
+  EXPECT_TRUE(limiter.TakeToken("product", "signature", 100060));
+}
+
+TEST_F(UploadRateLimiterTest, Eviction) {
+  UploadRateLimiter limiter(path(), 1, 60);
+  constexpr time_t kStart = 100000;
+  EXPECT_TRUE(limiter.TakeToken("product", "first", kStart));
+
+  // Filling the table evicts the least recently refilled bucket, and then
+  // its signature starts with a full bucket again.
+  for (size_t index = 0; index < UploadRateLimiter::kMaxBuckets; ++index) {
+    EXPECT_TRUE(limiter.TakeToken(
+        "product", base::StringPrintf("signature %" PRIuS, index), kStart + 1));
+  }
+  EXPECT_TRUE(limiter.TakeToken("product", "first", kStart + 1));
+
+  // The most recent buckets were kept.
+  EXPECT_FALSE(limiter.TakeToken(
+      "product",
+      base::StringPrintf("signature %" PRIuS, UploadRateLimiter::kMaxBuckets - 1),
+      kStart + 1));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
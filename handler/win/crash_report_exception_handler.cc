@@ -14,6 +14,10 @@
 
 #include "handler/win/crash_report_exception_handler.h"
 
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -21,18 +25,31 @@
 #include "client/crash_report_database.h"
 #include "client/settings.h"
 #include "handler/crash_report_upload_thread.h"
+#include "handler/crash_signature.h"
+#include "handler/minidump_to_upload_parameters.h"
+#include "handler/report_summary.h"
 #include "minidump/minidump_file_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "snapshot/win/process_snapshot_win.h"
-#include "util/file/file_helper.h"
 #include "util/file/file_writer.h"
+#include "util/misc/clock.h"
 #include "util/misc/metrics.h"
 #include "util/win/registration_protocol_win.h"
 #include "util/win/scoped_process_suspend.h"
+#include "util/win/scoped_process_va_clone.h"
 #include "util/win/termination_codes.h"
 
 namespace crashpad {
 
+namespace {
+
+// The process annotation recording that a report was captured minimally. The
+// key is shared with the capture policies of the Linux handler.
+constexpr char kCapturePolicyAnnotationKey[] = "crashpad_capture_policy";
+constexpr char kMinimalCapturePolicy[] = "minimal";
+
+}  // namespace
+
 CrashReportExceptionHandler::CrashReportExceptionHandler(
     CrashReportDatabase* database,
     CrashReportUploadThread* upload_thread,
@@ -43,7 +60,11 @@ CrashReportExceptionHandler::CrashReportExceptionHandler(
       upload_thread_(upload_thread),
       process_annotations_(process_annotations),
       attachments_(attachments),
-      user_stream_data_sources_(user_stream_data_sources) {}
+      user_stream_data_sources_(user_stream_data_sources),
+      module_list_cache_(),
+      minimal_capture_exception_codes_(),
+      max_handles_(std::numeric_limits<size_t>::max()),
+      capture_from_va_clone_(false) {}
 
 CrashReportExceptionHandler::~CrashReportExceptionHandler() {}
 
@@ -55,16 +76,35 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
     WinVMAddress debug_critical_section_address) {
   Metrics::ExceptionEncountered();
 
-  ScopedProcessSuspend suspend(process);
+  std::unique_ptr<ScopedProcessSuspend> suspend(
+      new ScopedProcessSuspend(process));
+
+  ScopedProcessVaClone va_clone;
+  HANDLE memory_process = nullptr;
+  if (capture_from_va_clone_ && va_clone.Initialize(process)) {
+    memory_process = va_clone.handle();
+  }
 
+  Metrics::ExceptionCaptureStarted();
   ProcessSnapshotWin process_snapshot;
+  process_snapshot.SetModuleListCache(&module_list_cache_);
+  process_snapshot.SetMinimalCaptureExceptionCodes(
+      minimal_capture_exception_codes_);
   if (!process_snapshot.Initialize(process,
                                    ProcessSuspensionState::kSuspended,
                                    exception_information_address,
-                                   debug_critical_section_address)) {
+                                   debug_critical_section_address,
+                                   memory_process)) {
     Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
     return kTerminationCodeSnapshotFailed;
   }
+  process_snapshot.SetMaxHandles(max_handles_);
+
+  // The threads have been captured, and the memory that the minidump refers to
+  // will be read from the clone, so the client no longer needs to be held.
+  if (memory_process) {
+    suspend.reset();
+  }
 
   // Now that we have the exception information, even if something else fails we
   // can terminate the process with the correct exit code.
@@ -86,7 +126,17 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
       process_snapshot.SetClientID(client_id);
     }
 
-    process_snapshot.SetAnnotationsSimpleMap(*process_annotations_);
+    // The crash signature is stored with the other process annotations so
+    // that it's among the report's upload parameters.
+    std::map<std::string, std::string> annotations(*process_annotations_);
+    const std::string signature = CrashSignatureFromSnapshot(process_snapshot);
+    if (!signature.empty()) {
+      annotations.emplace(kCrashSignatureAnnotationKey, signature);
+    }
+    if (process_snapshot.IsMinimalCapture()) {
+      annotations[kCapturePolicyAnnotationKey] = kMinimalCapturePolicy;
+    }
+    process_snapshot.SetAnnotationsSimpleMap(annotations);
 
     std::unique_ptr<CrashReportDatabase::NewReport> new_report;
     CrashReportDatabase::OperationStatus database_status =
@@ -105,31 +155,39 @@ unsigned int CrashReportExceptionHandler::ExceptionHandlerServerException(
     AddUserExtensionStreams(
         user_stream_data_sources_, &process_snapshot, &minidump);
 
+    const uint64_t write_start_ns = ClockMonotonicNanoseconds();
     if (!minidump.WriteEverything(new_report->Writer())) {
       LOG(ERROR) << "WriteEverything failed";
       Metrics::ExceptionCaptureResult(
           Metrics::CaptureResult::kMinidumpWriteFailed);
       return termination_code;
     }
+    Metrics::MinidumpWriteCompleted(ClockMonotonicNanoseconds() -
+                                    write_start_ns);
+
+    // Storing the upload parameters now spares the upload thread from having
+    // to read them back out of the minidump.
+    if (!new_report->SetUploadParameters(
+            BreakpadHTTPFormParametersFromMinidump(&process_snapshot))) {
+      LOG(WARNING) << "SetUploadParameters failed";
+    }
 
-    for (const auto& attachment : (*attachments_)) {
-      FileReader file_reader;
-      if (!file_reader.Open(attachment)) {
-        LOG(ERROR) << "attachment " << attachment
-                   << " couldn't be opened, skipping";
-        continue;
-      }
+    // The summary lets reports be listed without reading their minidumps.
+    if (!new_report->SetSummary(ReportSummaryFromSnapshot(process_snapshot))) {
+      LOG(WARNING) << "SetSummary failed";
+    }
 
+    // Attachments may still be written to by the client, so they're copied,
+    // never linked.
+    for (const auto& attachment : (*attachments_)) {
       base::FilePath filename = attachment.BaseName();
-      FileWriter* file_writer =
-          new_report->AddAttachment(base::WideToUTF8(filename.value()));
-      if (file_writer == nullptr) {
-        LOG(ERROR) << "attachment " << filename
-                   << " couldn't be created, skipping";
-        continue;
+      if (!new_report->AddAttachmentFromFile(
+              base::WideToUTF8(filename.value()),
+              attachment,
+              /*allow_hard_link=*/false)) {
+        LOG(ERROR) << "attachment " << attachment
+                   << " couldn't be added, skipping";
       }
-
-      CopyFileContent(&file_reader, file_writer);
     }
 
     UUID uuid;
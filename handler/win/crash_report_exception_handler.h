@@ -17,11 +17,15 @@
 
 #include <windows.h>
 
+#include <stdint.h>
+
 #include <map>
+#include <set>
 #include <string>
 
 #include "handler/user_stream_data_source.h"
 #include "util/win/exception_handler_server.h"
+#include "util/win/module_list_cache_win.h"
 
 namespace crashpad {
 
@@ -68,6 +72,46 @@ class CrashReportExceptionHandler final
 
   ~CrashReportExceptionHandler();
 
+  //! \brief Sets whether memory is captured from a virtual address clone of
+  //!     the client.
+  //!
+  //! By default, the client remains suspended until its crash report has been
+  //! written. When \a capture_from_va_clone is `true`, a clone of the client’s
+  //! address space is taken with `PssCaptureSnapshot()` while it is
+  //! suspended, and the client is resumed as soon as its threads and modules
+  //! have been captured. The rest of its memory is read from the clone. This
+  //! shortens the time that a client with a large address space is held
+  //! suspended for a dump without a crash. If a clone can’t be taken, the
+  //! client remains suspended as usual.
+  void SetCaptureFromVaClone(bool capture_from_va_clone) {
+    capture_from_va_clone_ = capture_from_va_clone;
+  }
+
+  //! \brief Limits the number of the client’s handles recorded in a crash
+  //!     report.
+  //!
+  //! By default, every handle is recorded. A client holding very many handles
+  //! can take a long time to examine, so when it holds more than
+  //! \a max_handles, an evenly spaced sample of them is recorded instead. A
+  //! value of `0` records no handles.
+  void SetMaxHandles(size_t max_handles) { max_handles_ = max_handles; }
+
+  //! \brief Sets the exception codes for which only a minimal crash report is
+  //!     captured.
+  //!
+  //! Crashes forwarded by the Windows Error Reporting module, such as
+  //! fail-fast and heap corruption exceptions, must be captured before WER’s
+  //! timeout expires, which a full capture of a large client may not manage.
+  //! For an exception whose code is in \a exception_codes, only the crashing
+  //! thread, the modules, and the memory referenced by the exception’s context
+  //! are captured. See ProcessSnapshotWin::SetMinimalCaptureExceptionCodes().
+  //! Such a report has the process annotation `"crashpad_capture_policy"` set
+  //! to `"minimal"`. By default, every exception is captured in full.
+  void SetMinimalCaptureExceptionCodes(
+      const std::set<uint32_t>& exception_codes) {
+    minimal_capture_exception_codes_ = exception_codes;
+  }
+
   // ExceptionHandlerServer::Delegate:
 
   //! \brief Processes an exception message by writing a crash report to this
@@ -84,6 +128,10 @@ class CrashReportExceptionHandler final
   const std::map<std::string, std::string>* process_annotations_;  // weak
   const std::vector<base::FilePath>* attachments_;  // weak
   const UserStreamDataSources* user_stream_data_sources_;  // weak
+  ModuleListCacheWin module_list_cache_;
+  std::set<uint32_t> minimal_capture_exception_codes_;
+  size_t max_handles_;
+  bool capture_from_va_clone_;
 };
 
 }  // namespace crashpad
@@ -0,0 +1,93 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/win/deferred_exception_handler.h"
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "util/win/termination_codes.h"
+
+namespace crashpad {
+
+DeferredExceptionHandler::DeferredExceptionHandler()
+    : lock_(),
+      delegate_set_event_(CreateEvent(nullptr, true, false, nullptr)),
+      delegate_(nullptr),
+      delegate_set_(false),
+      server_started_(false) {
+  PCHECK(delegate_set_event_.is_valid()) << "CreateEvent";
+}
+
+DeferredExceptionHandler::~DeferredExceptionHandler() {}
+
+void DeferredExceptionHandler::SetDelegate(
+    ExceptionHandlerServer::Delegate* delegate) {
+  bool server_started;
+  {
+    base::AutoLock lock(lock_);
+    DCHECK(!delegate_set_);
+    delegate_ = delegate;
+    delegate_set_ = true;
+    server_started = server_started_;
+  }
+
+  // If the server has already started, the new delegate missed the
+  // notification, so deliver it now.
+  if (delegate && server_started) {
+    delegate->ExceptionHandlerServerStarted();
+  }
+
+  PCHECK(SetEvent(delegate_set_event_.get())) << "SetEvent";
+}
+
+void DeferredExceptionHandler::ExceptionHandlerServerStarted() {
+  ExceptionHandlerServer::Delegate* delegate;
+  {
+    base::AutoLock lock(lock_);
+    server_started_ = true;
+    if (!delegate_set_) {
+      // SetDelegate() will notify the delegate when it is called.
+      return;
+    }
+    delegate = delegate_;
+  }
+
+  if (delegate) {
+    delegate->ExceptionHandlerServerStarted();
+  }
+}
+
+unsigned int DeferredExceptionHandler::ExceptionHandlerServerException(
+    HANDLE process,
+    WinVMAddress exception_information_address,
+    WinVMAddress debug_critical_section_address) {
+  DWORD result = WaitForSingleObject(delegate_set_event_.get(), INFINITE);
+  PCHECK(result == WAIT_OBJECT_0) << "WaitForSingleObject";
+
+  ExceptionHandlerServer::Delegate* delegate;
+  {
+    base::AutoLock lock(lock_);
+    delegate = delegate_;
+  }
+
+  if (!delegate) {
+    LOG(ERROR) << "no exception handler, not capturing";
+    return kTerminationCodeSnapshotFailed;
+  }
+
+  return delegate->ExceptionHandlerServerException(
+      process, exception_information_address, debug_critical_section_address);
+}
+
+}  // namespace crashpad
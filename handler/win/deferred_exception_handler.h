@@ -0,0 +1,74 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_HANDLER_WIN_DEFERRED_EXCEPTION_HANDLER_H_
+#define CRASHPAD_HANDLER_WIN_DEFERRED_EXCEPTION_HANDLER_H_
+
+#include <windows.h>
+
+#include "base/synchronization/lock.h"
+#include "util/win/address_types.h"
+#include "util/win/exception_handler_server.h"
+#include "util/win/scoped_handle.h"
+
+namespace crashpad {
+
+//! \brief An exception handler that holds exceptions until the exception
+//!     handler that will process them has been created.
+//!
+//! This allows ExceptionHandlerServer to begin accepting client registrations
+//! before the crash report database has been opened. Exceptions that arrive
+//! before SetDelegate() is called wait for it, and are then forwarded.
+class DeferredExceptionHandler final
+    : public ExceptionHandlerServer::Delegate {
+ public:
+  DeferredExceptionHandler();
+
+  DeferredExceptionHandler(const DeferredExceptionHandler&) = delete;
+  DeferredExceptionHandler& operator=(const DeferredExceptionHandler&) =
+      delete;
+
+  ~DeferredExceptionHandler();
+
+  //! \brief Sets the exception handler that exceptions are forwarded to, and
+  //!     releases any exceptions that are waiting for it.
+  //!
+  //! This method must be called exactly once. It may be called from any
+  //! thread.
+  //!
+  //! \param[in] delegate The exception handler to forward to. Ownership is not
+  //!     transferred. If this is `nullptr`, because the exception handler could
+  //!     not be created, exceptions are not handled, and their clients are
+  //!     terminated with ::kTerminationCodeSnapshotFailed.
+  void SetDelegate(ExceptionHandlerServer::Delegate* delegate);
+
+  // ExceptionHandlerServer::Delegate:
+
+  void ExceptionHandlerServerStarted() override;
+  unsigned int ExceptionHandlerServerException(
+      HANDLE process,
+      WinVMAddress exception_information_address,
+      WinVMAddress debug_critical_section_address) override;
+
+ private:
+  base::Lock lock_;
+  ScopedKernelHANDLE delegate_set_event_;
+  ExceptionHandlerServer::Delegate* delegate_;  // weak, guarded by lock_
+  bool delegate_set_;  // guarded by lock_
+  bool server_started_;  // guarded by lock_
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_HANDLER_WIN_DEFERRED_EXCEPTION_HANDLER_H_
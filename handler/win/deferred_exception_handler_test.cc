@@ -0,0 +1,125 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/win/deferred_exception_handler.h"
+
+#include "gtest/gtest.h"
+#include "util/thread/thread.h"
+#include "util/win/termination_codes.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class RecordingDelegate final : public ExceptionHandlerServer::Delegate {
+ public:
+  RecordingDelegate() : started_(0), exceptions_(0), last_address_(0) {}
+
+  RecordingDelegate(const RecordingDelegate&) = delete;
+  RecordingDelegate& operator=(const RecordingDelegate&) = delete;
+
+  ~RecordingDelegate() {}
+
+  int started() const { return started_; }
+  int exceptions() const { return exceptions_; }
+  WinVMAddress last_address() const { return last_address_; }
+
+  // ExceptionHandlerServer::Delegate:
+
+  void ExceptionHandlerServerStarted() override { ++started_; }
+
+  unsigned int ExceptionHandlerServerException(
+      HANDLE process,
+      WinVMAddress exception_information_address,
+      WinVMAddress debug_critical_section_address) override {
+    ++exceptions_;
+    last_address_ = exception_information_address;
+    return 42;
+  }
+
+ private:
+  int started_;
+  int exceptions_;
+  WinVMAddress last_address_;
+};
+
+class ExceptionThread final : public Thread {
+ public:
+  ExceptionThread(DeferredExceptionHandler* handler, WinVMAddress address)
+      : Thread(), handler_(handler), address_(address), exit_code_(0) {}
+
+  ExceptionThread(const ExceptionThread&) = delete;
+  ExceptionThread& operator=(const ExceptionThread&) = delete;
+
+  ~ExceptionThread() override {}
+
+  unsigned int exit_code() const { return exit_code_; }
+
+ private:
+  void ThreadMain() override {
+    exit_code_ = handler_->ExceptionHandlerServerException(
+        GetCurrentProcess(), address_, 0);
+  }
+
+  DeferredExceptionHandler* handler_;
+  WinVMAddress address_;
+  unsigned int exit_code_;
+};
+
+TEST(DeferredExceptionHandler, ForwardsWhenDelegateSetLater) {
+  DeferredExceptionHandler deferred;
+  deferred.ExceptionHandlerServerStarted();
+
+  ExceptionThread thread(&deferred, 0x1234);
+  thread.Start();
+
+  RecordingDelegate delegate;
+  deferred.SetDelegate(&delegate);
+  thread.Join();
+
+  EXPECT_EQ(delegate.started(), 1);
+  EXPECT_EQ(delegate.exceptions(), 1);
+  EXPECT_EQ(delegate.last_address(), 0x1234u);
+  EXPECT_EQ(thread.exit_code(), 42u);
+
+  EXPECT_EQ(deferred.ExceptionHandlerServerException(
+                GetCurrentProcess(), 0x5678, 0),
+            42u);
+  EXPECT_EQ(delegate.exceptions(), 2);
+  EXPECT_EQ(delegate.last_address(), 0x5678u);
+}
+
+TEST(DeferredExceptionHandler, StartedAfterDelegateSet) {
+  DeferredExceptionHandler deferred;
+  RecordingDelegate delegate;
+  deferred.SetDelegate(&delegate);
+  EXPECT_EQ(delegate.started(), 0);
+
+  deferred.ExceptionHandlerServerStarted();
+  EXPECT_EQ(delegate.started(), 1);
+}
+
+TEST(DeferredExceptionHandler, NoDelegate) {
+  DeferredExceptionHandler deferred;
+  deferred.ExceptionHandlerServerStarted();
+  deferred.SetDelegate(nullptr);
+
+  EXPECT_EQ(deferred.ExceptionHandlerServerException(
+                GetCurrentProcess(), 0x1234, 0),
+            static_cast<unsigned int>(kTerminationCodeSnapshotFailed));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
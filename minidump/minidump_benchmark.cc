@@ -0,0 +1,433 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/cpu_architecture.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_system_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "tools/tool_support.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
+#include "util/misc/uuid.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace {
+
+// Every allocation made through operator new is counted, and its size is kept
+// in a header so that the number of live bytes can be tracked.
+constexpr size_t kAllocationHeaderSize = alignof(std::max_align_t);
+
+std::atomic<uint64_t> g_allocations;
+std::atomic<uint64_t> g_live_bytes;
+std::atomic<uint64_t> g_peak_bytes;
+
+void* CountedAllocate(size_t size) {
+  void* block = malloc(kAllocationHeaderSize + size);
+  if (!block) {
+    return nullptr;
+  }
+  memcpy(block, &size, sizeof(size));
+
+  ++g_allocations;
+  const uint64_t live_bytes = g_live_bytes += size;
+  uint64_t peak_bytes = g_peak_bytes;
+  while (live_bytes > peak_bytes &&
+         !g_peak_bytes.compare_exchange_weak(peak_bytes, live_bytes)) {
+  }
+  return static_cast<char*>(block) + kAllocationHeaderSize;
+}
+
+void CountedFree(void* pointer) {
+  if (!pointer) {
+    return;
+  }
+  void* block = static_cast<char*>(pointer) - kAllocationHeaderSize;
+  size_t size;
+  memcpy(&size, block, sizeof(size));
+  g_live_bytes -= size;
+  free(block);
+}
+
+void* CountedAllocateOrThrow(size_t size) {
+  void* pointer = CountedAllocate(size);
+  if (!pointer) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  return CountedAllocateOrThrow(size);
+}
+
+void* operator new[](size_t size) {
+  return CountedAllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  CountedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  CountedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  CountedFree(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  CountedFree(pointer);
+}
+
+namespace crashpad {
+namespace {
+
+// The shape of a synthetic process snapshot.
+struct BenchmarkCase {
+  const char* name;
+  size_t threads;
+  size_t stack_size;
+  size_t memory_ranges;
+  size_t memory_range_size;
+  size_t modules;
+  size_t annotations_per_module;
+  size_t annotation_value_size;
+};
+
+constexpr BenchmarkCase kBenchmarkCases[] = {
+    {"small", 4, 16 * 1024, 16, 4096, 16, 4, 32},
+    {"threads", 1024, 16 * 1024, 0, 0, 16, 0, 0},
+    {"memory_ranges", 4, 16 * 1024, 8192, 4096, 16, 0, 0},
+    {"annotations", 4, 4096, 0, 0, 256, 256, 256},
+    {"large", 256, 64 * 1024, 2048, 16 * 1024, 512, 32, 128},
+};
+
+// The cost of a single measured operation.
+struct Measurement {
+  uint64_t duration_ns;
+  uint64_t allocations;
+  uint64_t peak_bytes;
+};
+
+// Measures the time, allocations, and memory high-water mark above the
+// starting level between construction and Finish().
+class ScopedMeasurement {
+ public:
+  ScopedMeasurement()
+      : start_allocations_(g_allocations),
+        start_live_bytes_(g_live_bytes),
+        start_ns_(ClockMonotonicNanoseconds()) {
+    g_peak_bytes = start_live_bytes_;
+  }
+
+  ScopedMeasurement(const ScopedMeasurement&) = delete;
+  ScopedMeasurement& operator=(const ScopedMeasurement&) = delete;
+
+  ~ScopedMeasurement() {}
+
+  Measurement Finish() const {
+    Measurement measurement;
+    measurement.duration_ns = ClockMonotonicNanoseconds() - start_ns_;
+    measurement.allocations = g_allocations - start_allocations_;
+    measurement.peak_bytes = g_peak_bytes - start_live_bytes_;
+    return measurement;
+  }
+
+ private:
+  uint64_t start_allocations_;
+  uint64_t start_live_bytes_;
+  uint64_t start_ns_;
+};
+
+std::map<std::string, std::string> MakeAnnotations(size_t count,
+                                                   size_t value_size,
+                                                   const char* prefix) {
+  std::map<std::string, std::string> annotations;
+  for (size_t index = 0; index < count; ++index) {
+    annotations[base::StringPrintf("%s-annotation-%zu", prefix, index)] =
+        std::string(value_size, 'a' + index % 26);
+  }
+  return annotations;
+}
+
+std::unique_ptr<test::TestProcessSnapshot> MakeProcessSnapshot(
+    const BenchmarkCase& benchmark_case) {
+  auto process_snapshot = std::make_unique<test::TestProcessSnapshot>();
+  process_snapshot->SetProcessID(1234);
+
+  // Snapshots taken by the handler always carry these, and they ensure that a
+  // Crashpad info stream is written even when there are no annotations.
+  UUID report_id;
+  report_id.InitializeWithNew();
+  process_snapshot->SetReportID(report_id);
+  UUID client_id;
+  client_id.InitializeWithNew();
+  process_snapshot->SetClientID(client_id);
+
+  auto system_snapshot = std::make_unique<test::TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot->SetSystem(std::move(system_snapshot));
+
+  process_snapshot->SetAnnotationsSimpleMap(
+      MakeAnnotations(benchmark_case.annotations_per_module,
+                      benchmark_case.annotation_value_size,
+                      "process"));
+
+  constexpr uint64_t kStackBase = 0x7f0000000000;
+  for (size_t index = 0; index < benchmark_case.threads; ++index) {
+    auto thread_snapshot = std::make_unique<test::TestThreadSnapshot>();
+    test::InitializeCPUContextX86_64(thread_snapshot->MutableContext(),
+                               static_cast<uint32_t>(index));
+    thread_snapshot->SetThreadID(index + 1);
+    auto stack = std::make_unique<test::TestMemorySnapshot>();
+    stack->SetAddress(kStackBase + index * benchmark_case.stack_size * 2);
+    stack->SetSize(benchmark_case.stack_size);
+    stack->SetValue('s');
+    thread_snapshot->SetStack(std::move(stack));
+    process_snapshot->AddThread(std::move(thread_snapshot));
+  }
+
+  constexpr uint64_t kModuleBase = 0x7e0000000000;
+  constexpr uint64_t kModuleSize = 0x100000;
+  for (size_t index = 0; index < benchmark_case.modules; ++index) {
+    auto module_snapshot = std::make_unique<test::TestModuleSnapshot>();
+    module_snapshot->SetName(
+        base::StringPrintf("/usr/lib/libbenchmark_%zu.so", index));
+    module_snapshot->SetAddressAndSize(kModuleBase + index * kModuleSize * 2,
+                                       kModuleSize);
+    module_snapshot->SetAnnotationsSimpleMap(
+        MakeAnnotations(benchmark_case.annotations_per_module,
+                        benchmark_case.annotation_value_size,
+                        "module"));
+    process_snapshot->AddModule(std::move(module_snapshot));
+  }
+
+  constexpr uint64_t kMemoryBase = 0x500000000000;
+  for (size_t index = 0; index < benchmark_case.memory_ranges; ++index) {
+    auto memory_snapshot = std::make_unique<test::TestMemorySnapshot>();
+    memory_snapshot->SetAddress(kMemoryBase +
+                                index * benchmark_case.memory_range_size * 2);
+    memory_snapshot->SetSize(benchmark_case.memory_range_size);
+    memory_snapshot->SetValue('m');
+    process_snapshot->AddExtraMemory(std::move(memory_snapshot));
+  }
+
+  return process_snapshot;
+}
+
+void PrintMeasurement(const BenchmarkCase& benchmark_case,
+                      size_t iteration,
+                      const char* operation,
+                      uint64_t bytes,
+                      const Measurement& measurement) {
+  printf("%s,%zu,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+         benchmark_case.name,
+         iteration,
+         operation,
+         measurement.duration_ns,
+         bytes,
+         measurement.allocations,
+         measurement.peak_bytes);
+}
+
+bool RunBenchmarkCase(const BenchmarkCase& benchmark_case, size_t iteration) {
+  std::unique_ptr<test::TestProcessSnapshot> process_snapshot =
+      MakeProcessSnapshot(benchmark_case);
+
+  StringFile minidump_file;
+  {
+    ScopedMeasurement measurement;
+    MinidumpFileWriter minidump;
+    minidump.InitializeFromSnapshot(process_snapshot.get());
+    if (!minidump.WriteEverything(&minidump_file)) {
+      fprintf(stderr, "%s: WriteEverything failed\n", benchmark_case.name);
+      return false;
+    }
+    PrintMeasurement(benchmark_case,
+                     iteration,
+                     "write",
+                     minidump_file.string().size(),
+                     measurement.Finish());
+  }
+
+  if (!minidump_file.SeekSet(0)) {
+    return false;
+  }
+  {
+    ScopedMeasurement measurement;
+    ProcessSnapshotMinidump minidump_snapshot;
+    if (!minidump_snapshot.Initialize(&minidump_file)) {
+      fprintf(stderr, "%s: Initialize failed\n", benchmark_case.name);
+      return false;
+    }
+    PrintMeasurement(benchmark_case,
+                     iteration,
+                     "read",
+                     minidump_file.string().size(),
+                     measurement.Finish());
+  }
+
+  return true;
+}
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure writing and reading minidumps of synthetic process snapshots.\n"
+"\n"
+"      --case=NAME         run only the case named NAME\n"
+"      --iterations=COUNT  run each case COUNT times, default 5\n"
+"      --help              display this help and exit\n"
+"      --version           output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+int MinidumpBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionCase,
+    kOptionIterations,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  std::string case_name;
+  size_t iterations = 5;
+
+  static constexpr option long_options[] = {
+      {"case", required_argument, nullptr, kOptionCase},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionCase:
+        case_name = optarg;
+        break;
+      case kOptionIterations:
+        if (!StringToNumber(optarg, &iterations) || iterations == 0) {
+          ToolSupport::UsageHint(me, "--iterations requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      case kOptionVersion:
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      default:
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  bool found = case_name.empty();
+  printf("case,iteration,operation,duration_ns,bytes,allocations,peak_bytes\n");
+  for (const BenchmarkCase& benchmark_case : kBenchmarkCases) {
+    if (!case_name.empty() && case_name != benchmark_case.name) {
+      continue;
+    }
+    found = true;
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+      if (!RunBenchmarkCase(benchmark_case, iteration)) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  if (!found) {
+    ToolSupport::UsageHint(me, "unknown --case");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::MinidumpBenchmarkMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(
+      argc, argv, crashpad::MinidumpBenchmarkMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
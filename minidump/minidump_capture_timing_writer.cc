@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_capture_timing_writer.h"
+
+#include "base/check_op.h"
+#include "util/file/file_writer.h"
+#include "util/misc/capture_timings.h"
+
+namespace crashpad {
+
+MinidumpCaptureTimingListWriter::MinidumpCaptureTimingListWriter()
+    : capture_timing_list_base_(), items_() {}
+
+MinidumpCaptureTimingListWriter::~MinidumpCaptureTimingListWriter() = default;
+
+void MinidumpCaptureTimingListWriter::InitializeFromCaptureTimings(
+    const CaptureTimings& timings) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  DCHECK(items_.empty());
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CapturePhase::kMaxValue);
+       ++index) {
+    const CaptureTimings::Phase& phase =
+        timings.Get(static_cast<CapturePhase>(index));
+    MinidumpCaptureTiming item = {};
+    item.phase = index;
+    item.duration_ns = phase.duration_ns;
+    item.bytes_read = phase.bytes_read;
+    items_.push_back(item);
+  }
+}
+
+bool MinidumpCaptureTimingListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  capture_timing_list_base_.count = static_cast<uint32_t>(items_.size());
+
+  return true;
+}
+
+size_t MinidumpCaptureTimingListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+  return sizeof(capture_timing_list_base_) +
+         sizeof(MinidumpCaptureTiming) * items_.size();
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpCaptureTimingListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+  return std::vector<internal::MinidumpWritable*>();
+}
+
+bool MinidumpCaptureTimingListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &capture_timing_list_base_;
+  iov.iov_len = sizeof(capture_timing_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!items_.empty()) {
+    iov.iov_base = items_.data();
+    iov.iov_len = sizeof(MinidumpCaptureTiming) * items_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpCaptureTimingListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadCaptureTimings;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,69 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_CAPTURE_TIMING_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_CAPTURE_TIMING_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class CaptureTimings;
+
+//! \brief The writer for a MinidumpCaptureTimingList stream in a minidump file,
+//!     containing a MinidumpCaptureTiming for each CapturePhase.
+class MinidumpCaptureTimingListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpCaptureTimingListWriter();
+
+  MinidumpCaptureTimingListWriter(const MinidumpCaptureTimingListWriter&) =
+      delete;
+  MinidumpCaptureTimingListWriter& operator=(
+      const MinidumpCaptureTimingListWriter&) = delete;
+
+  ~MinidumpCaptureTimingListWriter() override;
+
+  //! \brief Initializes the MinidumpCaptureTimingList based on \a timings.
+  //!
+  //! \param[in] timings The cost of each phase of capturing the crash report.
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromCaptureTimings(const CaptureTimings& timings);
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpCaptureTimingList capture_timing_list_base_;
+  std::vector<MinidumpCaptureTiming> items_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_CAPTURE_TIMING_WRITER_H_
@@ -0,0 +1,126 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_capture_timing_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "util/file/string_file.h"
+#include "util/misc/capture_timings.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The capture timing list is expected to be the only stream.
+void GetCaptureTimingListStream(
+    const std::string& file_contents,
+    const MinidumpCaptureTimingList** capture_timing_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kCaptureTimingListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadCaptureTimings);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kCaptureTimingListStreamOffset);
+
+  *capture_timing_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpCaptureTimingList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*capture_timing_list);
+}
+
+TEST(MinidumpCaptureTimingWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto capture_timing_list_writer =
+      std::make_unique<MinidumpCaptureTimingListWriter>();
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(capture_timing_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpCaptureTimingList));
+
+  const MinidumpCaptureTimingList* capture_timing_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetCaptureTimingListStream(string_file.string(), &capture_timing_list));
+
+  EXPECT_EQ(capture_timing_list->count, 0u);
+}
+
+TEST(MinidumpCaptureTimingWriter, AllPhases) {
+  CaptureTimings timings;
+  timings.Add(CapturePhase::kThreads, 1000, 4096);
+  timings.Add(CapturePhase::kModules, 2000, 8192);
+  timings.Add(CapturePhase::kSanitization, 3000, 0);
+
+  MinidumpFileWriter minidump_file_writer;
+  auto capture_timing_list_writer =
+      std::make_unique<MinidumpCaptureTimingListWriter>();
+  capture_timing_list_writer->InitializeFromCaptureTimings(timings);
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(capture_timing_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  constexpr size_t kPhaseCount =
+      static_cast<size_t>(CapturePhase::kMaxValue);
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpCaptureTimingList) +
+                kPhaseCount * sizeof(MinidumpCaptureTiming));
+
+  const MinidumpCaptureTimingList* capture_timing_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetCaptureTimingListStream(string_file.string(), &capture_timing_list));
+
+  ASSERT_EQ(capture_timing_list->count, kPhaseCount);
+  for (size_t index = 0; index < kPhaseCount; ++index) {
+    SCOPED_TRACE(index);
+    MinidumpCaptureTiming timing;
+    memcpy(&timing, &capture_timing_list->timings[index], sizeof(timing));
+    const CaptureTimings::Phase& expected =
+        timings.Get(static_cast<CapturePhase>(index));
+    EXPECT_EQ(timing.phase, index);
+    EXPECT_EQ(timing.reserved, 0u);
+    EXPECT_EQ(timing.duration_ns, expected.duration_ns);
+    EXPECT_EQ(timing.bytes_read, expected.bytes_read);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,325 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_compressed_memory_list_writer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "snapshot/memory_snapshot.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/file/file_writer.h"
+#include "util/misc/zlib.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+namespace internal {
+
+// Gathers a memory snapshot’s data into blocks of a fixed size and compresses
+// each block as soon as it is complete, so that no more than one block’s worth
+// of uncompressed data is held at once.
+class MinidumpCompressedMemoryRangeWriter::Compressor final
+    : public MemorySnapshot::Delegate {
+ public:
+  Compressor(MinidumpCompressedMemoryRangeWriter* writer, uint32_t block_size)
+      : pending_(), writer_(writer), block_size_(block_size), size_(0) {
+    pending_.reserve(block_size_);
+  }
+
+  Compressor(const Compressor&) = delete;
+  Compressor& operator=(const Compressor&) = delete;
+
+  ~Compressor() override = default;
+
+  // Compresses any data remaining after the last complete block.
+  bool Finish() { return pending_.empty() || CompressPending(); }
+
+  uint64_t size() const { return size_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const char* data_c = static_cast<const char*>(data);
+    size_ += size;
+    while (size > 0) {
+      size_t length = std::min(size, block_size_ - pending_.size());
+      pending_.append(data_c, length);
+      data_c += length;
+      size -= length;
+      if (pending_.size() == block_size_ && !CompressPending()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  bool CompressPending() {
+    std::string compressed(compressBound(pending_.size()), '\0');
+    uLongf compressed_size = compressed.size();
+    int zr = compress2(reinterpret_cast<Bytef*>(&compressed[0]),
+                       &compressed_size,
+                       reinterpret_cast<const Bytef*>(pending_.data()),
+                       pending_.size(),
+                       Z_DEFAULT_COMPRESSION);
+    if (zr != Z_OK) {
+      LOG(ERROR) << "compress2: " << ZlibErrorString(zr);
+      return false;
+    }
+
+    MinidumpCompressedMemoryBlock block = {};
+    if (compressed_size < pending_.size()) {
+      block.compression = kMinidumpCompressedMemoryCompressionZlib;
+      compressed.resize(compressed_size);
+    } else {
+      block.compression = kMinidumpCompressedMemoryCompressionNone;
+      compressed.swap(pending_);
+    }
+    if (!AssignIfInRange(&block.data.DataSize, compressed.size())) {
+      LOG(ERROR) << "block size " << compressed.size() << " out of range";
+      return false;
+    }
+
+    writer_->blocks_.push_back(block);
+    writer_->block_data_.push_back(std::move(compressed));
+    pending_.clear();
+    return true;
+  }
+
+  std::string pending_;
+  MinidumpCompressedMemoryRangeWriter* writer_;  // weak
+  size_t block_size_;
+  uint64_t size_;
+};
+
+MinidumpCompressedMemoryRangeWriter::MinidumpCompressedMemoryRangeWriter()
+    : MinidumpWritable(),
+      blocks_(),
+      block_data_(),
+      address_(0),
+      size_(0),
+      block_size_(0) {}
+
+MinidumpCompressedMemoryRangeWriter::~MinidumpCompressedMemoryRangeWriter() =
+    default;
+
+bool MinidumpCompressedMemoryRangeWriter::InitializeFromSnapshot(
+    const MemorySnapshot* memory_snapshot,
+    uint32_t block_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(blocks_.empty());
+  DCHECK_GT(block_size, 0u);
+
+  address_ = memory_snapshot->Address();
+  size_ = memory_snapshot->Size();
+  block_size_ = block_size;
+
+  Compressor compressor(this, block_size_);
+  if (!memory_snapshot->ReadInChunks(&compressor, block_size_) ||
+      !compressor.Finish()) {
+    blocks_.clear();
+    block_data_.clear();
+    return false;
+  }
+
+  if (compressor.size() != size_) {
+    LOG(ERROR) << "memory snapshot at 0x" << std::hex << address_
+               << " provided " << std::dec << compressor.size()
+               << " bytes, expected " << size_;
+    blocks_.clear();
+    block_data_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+void MinidumpCompressedMemoryRangeWriter::RegisterRange(
+    MinidumpCompressedMemoryRange* range) {
+  DCHECK_EQ(state(), kStateFrozen);
+
+  range->start_of_memory_range = address_;
+  range->data_size = size_;
+  range->block_size = block_size_;
+  range->block_count = static_cast<uint32_t>(blocks_.size());
+  RegisterRVA(&range->blocks);
+}
+
+bool MinidumpCompressedMemoryRangeWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpWritable::Freeze()) {
+    return false;
+  }
+
+  if (blocks_.size() > std::numeric_limits<uint32_t>::max()) {
+    LOG(ERROR) << "block count " << blocks_.size() << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpCompressedMemoryRangeWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  size_t size = sizeof(MinidumpCompressedMemoryBlock) * blocks_.size();
+  for (const MinidumpCompressedMemoryBlock& block : blocks_) {
+    size += block.data.DataSize;
+  }
+  return size;
+}
+
+bool MinidumpCompressedMemoryRangeWriter::WillWriteAtOffsetImpl(
+    FileOffset offset) {
+  DCHECK_EQ(state(), kStateFrozen);
+
+  FileOffset data_offset =
+      offset + sizeof(MinidumpCompressedMemoryBlock) * blocks_.size();
+  for (MinidumpCompressedMemoryBlock& block : blocks_) {
+    if (!AssignIfInRange(&block.data.Rva, data_offset)) {
+      LOG(ERROR) << "offset " << data_offset << " out of range";
+      return false;
+    }
+    data_offset += block.data.DataSize;
+  }
+
+  return MinidumpWritable::WillWriteAtOffsetImpl(offset);
+}
+
+bool MinidumpCompressedMemoryRangeWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  if (blocks_.empty()) {
+    return true;
+  }
+
+  WritableIoVec iov;
+  iov.iov_base = blocks_.data();
+  iov.iov_len = sizeof(MinidumpCompressedMemoryBlock) * blocks_.size();
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  for (const std::string& data : block_data_) {
+    iov.iov_base = data.data();
+    iov.iov_len = data.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+}  // namespace internal
+
+MinidumpCompressedMemoryListWriter::MinidumpCompressedMemoryListWriter()
+    : MinidumpStreamWriter(),
+      compressed_memory_list_base_(),
+      children_(),
+      ranges_(),
+      block_size_(kDefaultBlockSize) {}
+
+MinidumpCompressedMemoryListWriter::~MinidumpCompressedMemoryListWriter() =
+    default;
+
+void MinidumpCompressedMemoryListWriter::SetBlockSize(uint32_t block_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(children_.empty());
+  DCHECK_GT(block_size, 0u);
+  DCHECK_LE(block_size, MinidumpCompressedMemoryRange::kMaxBlockSize);
+
+  block_size_ = block_size;
+}
+
+bool MinidumpCompressedMemoryListWriter::AddFromSnapshot(
+    const MemorySnapshot* memory_snapshot) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  auto child =
+      std::make_unique<internal::MinidumpCompressedMemoryRangeWriter>();
+  if (!child->InitializeFromSnapshot(memory_snapshot, block_size_)) {
+    return false;
+  }
+  children_.push_back(std::move(child));
+  return true;
+}
+
+bool MinidumpCompressedMemoryListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  std::sort(children_.begin(),
+            children_.end(),
+            [](const auto& a, const auto& b) {
+              return a->Address() < b->Address();
+            });
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&compressed_memory_list_base_.count,
+                       children_.size())) {
+    LOG(ERROR) << "range count " << children_.size() << " out of range";
+    return false;
+  }
+
+  ranges_.resize(children_.size());
+  for (size_t index = 0; index < children_.size(); ++index) {
+    children_[index]->RegisterRange(&ranges_[index]);
+  }
+
+  return true;
+}
+
+size_t MinidumpCompressedMemoryListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+  return sizeof(compressed_memory_list_base_) +
+         sizeof(MinidumpCompressedMemoryRange) * ranges_.size();
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpCompressedMemoryListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  std::vector<MinidumpWritable*> children;
+  for (const auto& child : children_) {
+    children.push_back(child.get());
+  }
+
+  return children;
+}
+
+bool MinidumpCompressedMemoryListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &compressed_memory_list_base_;
+  iov.iov_len = sizeof(compressed_memory_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!ranges_.empty()) {
+    iov.iov_base = ranges_.data();
+    iov.iov_len = sizeof(MinidumpCompressedMemoryRange) * ranges_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpCompressedMemoryListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadCompressedMemoryList;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,171 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_COMPRESSED_MEMORY_LIST_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_COMPRESSED_MEMORY_LIST_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class MemorySnapshot;
+
+namespace internal {
+
+//! \brief The writer for the block index and block data of a single
+//!     MinidumpCompressedMemoryRange.
+//!
+//! The MinidumpCompressedMemoryBlock array is written first, immediately
+//! followed by the data of each block in order.
+class MinidumpCompressedMemoryRangeWriter final : public MinidumpWritable {
+ public:
+  MinidumpCompressedMemoryRangeWriter();
+
+  MinidumpCompressedMemoryRangeWriter(
+      const MinidumpCompressedMemoryRangeWriter&) = delete;
+  MinidumpCompressedMemoryRangeWriter& operator=(
+      const MinidumpCompressedMemoryRangeWriter&) = delete;
+
+  ~MinidumpCompressedMemoryRangeWriter() override;
+
+  //! \brief Reads the contents of \a memory_snapshot and compresses them into
+  //!     blocks of \a block_size bytes.
+  //!
+  //! \a memory_snapshot is not referenced after this method returns.
+  //!
+  //! \return `true` on success. `false` if \a memory_snapshot could not be
+  //!     read or compression failed, with an error logged.
+  //!
+  //! \note Valid in #kStateMutable.
+  bool InitializeFromSnapshot(const MemorySnapshot* memory_snapshot,
+                              uint32_t block_size);
+
+  //! \brief Populates \a range to describe this object.
+  //!
+  //! \a range’s MinidumpCompressedMemoryRange::blocks field is registered to
+  //! receive this object’s RVA, so \a range must remain valid until this object
+  //! is written.
+  //!
+  //! \note Valid in #kStateFrozen.
+  void RegisterRange(MinidumpCompressedMemoryRange* range);
+
+  //! \brief Returns the base address of the range.
+  uint64_t Address() const { return address_; }
+
+  //! \brief Returns the size of the range when decompressed, in bytes.
+  uint64_t Size() const { return size_; }
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  bool WillWriteAtOffsetImpl(FileOffset offset) override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+ private:
+  class Compressor;
+
+  std::vector<MinidumpCompressedMemoryBlock> blocks_;
+  std::vector<std::string> block_data_;
+  uint64_t address_;
+  uint64_t size_;
+  uint32_t block_size_;
+};
+
+}  // namespace internal
+
+//! \brief The writer for a MinidumpCompressedMemoryList stream in a minidump
+//!     file, containing a MinidumpCompressedMemoryRange for each range of
+//!     memory stored in compressed form.
+//!
+//! Each range is divided into blocks that are compressed independently, so that
+//! a reader can access any part of a range without decompressing all of it.
+//! Ranges are compressed as they are added, so that only their compressed form
+//! is retained in memory.
+//!
+//! Ranges are normally added by a MinidumpMemoryListWriter that this object has
+//! been given to with
+//! MinidumpMemoryListWriter::SetCompressedMemoryListWriter(), as that object
+//! freezes. This object must therefore be frozen after it, which is the case
+//! when this stream is added to a MinidumpFileWriter after the memory list
+//! stream is.
+class MinidumpCompressedMemoryListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  //! \brief The default value for SetBlockSize().
+  static constexpr uint32_t kDefaultBlockSize = 64 * 1024;
+
+  MinidumpCompressedMemoryListWriter();
+
+  MinidumpCompressedMemoryListWriter(
+      const MinidumpCompressedMemoryListWriter&) = delete;
+  MinidumpCompressedMemoryListWriter& operator=(
+      const MinidumpCompressedMemoryListWriter&) = delete;
+
+  ~MinidumpCompressedMemoryListWriter() override;
+
+  //! \brief Sets the size of each block that ranges are divided into before
+  //!     compression, in bytes.
+  //!
+  //! Smaller blocks make random access cheaper for a reader at the expense of
+  //! compression ratio. If this method is not called, #kDefaultBlockSize is
+  //! used. \a block_size must not exceed
+  //! MinidumpCompressedMemoryRange::kMaxBlockSize.
+  //!
+  //! \note Valid in #kStateMutable, before any ranges are added.
+  void SetBlockSize(uint32_t block_size);
+
+  //! \brief Compresses the contents of \a memory_snapshot and adds it as a
+  //!     range.
+  //!
+  //! Ranges may be added in any order, but must not overlap. \a memory_snapshot
+  //! is not referenced after this method returns.
+  //!
+  //! \return `true` on success. `false` if \a memory_snapshot could not be
+  //!     read or compressed, with an error logged. In that case, no range is
+  //!     added.
+  //!
+  //! \note Valid in #kStateMutable.
+  bool AddFromSnapshot(const MemorySnapshot* memory_snapshot);
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpCompressedMemoryList compressed_memory_list_base_;
+  std::vector<std::unique_ptr<internal::MinidumpCompressedMemoryRangeWriter>>
+      children_;
+  std::vector<MinidumpCompressedMemoryRange> ranges_;
+  uint32_t block_size_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_COMPRESSED_MEMORY_LIST_WRITER_H_
@@ -0,0 +1,241 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_compressed_memory_list_writer.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The compressed memory list is expected to be the only stream.
+void GetCompressedMemoryListStream(
+    const std::string& file_contents,
+    const MinidumpCompressedMemoryList** compressed_memory_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kCompressedMemoryListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadCompressedMemoryList);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kCompressedMemoryListStreamOffset);
+
+  *compressed_memory_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpCompressedMemoryList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*compressed_memory_list);
+}
+
+// Decompresses every block of range, checking each against the index.
+void ExpandRange(const std::string& file_contents,
+                 const MinidumpCompressedMemoryRange& range,
+                 std::string* contents) {
+  contents->clear();
+
+  ASSERT_GT(range.block_size, 0u);
+  ASSERT_EQ(range.block_count,
+            (range.data_size + range.block_size - 1) / range.block_size);
+  ASSERT_LE(range.blocks +
+                sizeof(MinidumpCompressedMemoryBlock) * range.block_count,
+            file_contents.size());
+
+  for (size_t index = 0; index < range.block_count; ++index) {
+    SCOPED_TRACE(index);
+    MinidumpCompressedMemoryBlock block;
+    memcpy(&block,
+           &file_contents[range.blocks +
+                          sizeof(MinidumpCompressedMemoryBlock) * index],
+           sizeof(block));
+    ASSERT_LE(block.data.Rva + block.data.DataSize, file_contents.size());
+    const std::string data =
+        file_contents.substr(block.data.Rva, block.data.DataSize);
+
+    const size_t expected_size = static_cast<size_t>(
+        std::min<uint64_t>(range.block_size,
+                           range.data_size - index * range.block_size));
+    if (block.compression == kMinidumpCompressedMemoryCompressionNone) {
+      ASSERT_EQ(data.size(), expected_size);
+      contents->append(data);
+      continue;
+    }
+
+    ASSERT_EQ(block.compression, kMinidumpCompressedMemoryCompressionZlib);
+    EXPECT_LT(data.size(), expected_size);
+    std::string decompressed(expected_size, '\0');
+    uLongf decompressed_size = decompressed.size();
+    ASSERT_EQ(uncompress(reinterpret_cast<Bytef*>(&decompressed[0]),
+                         &decompressed_size,
+                         reinterpret_cast<const Bytef*>(data.data()),
+                         data.size()),
+              Z_OK);
+    ASSERT_EQ(decompressed_size, expected_size);
+    contents->append(decompressed);
+  }
+}
+
+// A MemorySnapshot with arbitrary contents.
+class StringMemorySnapshot final : public MemorySnapshot {
+ public:
+  StringMemorySnapshot(uint64_t address, const std::string& contents)
+      : MemorySnapshot(), address_(address), contents_(contents) {}
+
+  StringMemorySnapshot(const StringMemorySnapshot&) = delete;
+  StringMemorySnapshot& operator=(const StringMemorySnapshot&) = delete;
+
+  ~StringMemorySnapshot() override {}
+
+  // MemorySnapshot:
+  uint64_t Address() const override { return address_; }
+  size_t Size() const override { return contents_.size(); }
+  bool Read(Delegate* delegate) const override {
+    std::string buffer(contents_);
+    return delegate->MemorySnapshotDelegateRead(buffer.data(), buffer.size());
+  }
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    return nullptr;
+  }
+
+ private:
+  uint64_t address_;
+  std::string contents_;
+};
+
+TEST(MinidumpCompressedMemoryListWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto compressed_memory_list_writer =
+      std::make_unique<MinidumpCompressedMemoryListWriter>();
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(compressed_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpCompressedMemoryList));
+
+  const MinidumpCompressedMemoryList* compressed_memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetCompressedMemoryListStream(
+      string_file.string(), &compressed_memory_list));
+
+  EXPECT_EQ(compressed_memory_list->count, 0u);
+}
+
+TEST(MinidumpCompressedMemoryListWriter, Ranges) {
+  constexpr uint32_t kBlockSize = 0x1000;
+
+  // Repetitive contents compress well. Their last block is partial.
+  constexpr uint64_t kRepetitiveAddress = 0x20000;
+  std::string repetitive;
+  while (repetitive.size() < 3 * kBlockSize + 0x123) {
+    repetitive.append("crashpad ");
+  }
+  repetitive.resize(3 * kBlockSize + 0x123);
+  StringMemorySnapshot repetitive_snapshot(kRepetitiveAddress, repetitive);
+
+  // Contents with no redundancy don’t compress, and are stored as-is.
+  constexpr uint64_t kNoisyAddress = 0x10000;
+  std::string noisy(kBlockSize, '\0');
+  uint32_t state = 1;
+  for (char& c : noisy) {
+    state = state * 1103515245 + 12345;
+    c = static_cast<char>(state >> 24);
+  }
+  StringMemorySnapshot noisy_snapshot(kNoisyAddress, noisy);
+
+  MinidumpFileWriter minidump_file_writer;
+  auto compressed_memory_list_writer =
+      std::make_unique<MinidumpCompressedMemoryListWriter>();
+  compressed_memory_list_writer->SetBlockSize(kBlockSize);
+  ASSERT_TRUE(
+      compressed_memory_list_writer->AddFromSnapshot(&repetitive_snapshot));
+  ASSERT_TRUE(compressed_memory_list_writer->AddFromSnapshot(&noisy_snapshot));
+
+  // A snapshot that can’t be read isn’t added.
+  TestMemorySnapshot unreadable_snapshot;
+  unreadable_snapshot.SetAddress(0x30000);
+  unreadable_snapshot.SetSize(kBlockSize);
+  unreadable_snapshot.SetShouldFailRead(true);
+  EXPECT_FALSE(
+      compressed_memory_list_writer->AddFromSnapshot(&unreadable_snapshot));
+
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(compressed_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpCompressedMemoryList* compressed_memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetCompressedMemoryListStream(
+      string_file.string(), &compressed_memory_list));
+
+  ASSERT_EQ(compressed_memory_list->count, 2u);
+  MinidumpCompressedMemoryRange ranges[2];
+  memcpy(ranges, compressed_memory_list->ranges, sizeof(ranges));
+
+  // Ranges are sorted by address.
+  EXPECT_EQ(ranges[0].start_of_memory_range, kNoisyAddress);
+  EXPECT_EQ(ranges[0].data_size, noisy.size());
+  EXPECT_EQ(ranges[0].block_size, kBlockSize);
+  EXPECT_EQ(ranges[0].block_count, 1u);
+  MinidumpCompressedMemoryBlock noisy_block;
+  memcpy(&noisy_block,
+         &string_file.string()[ranges[0].blocks],
+         sizeof(noisy_block));
+  EXPECT_EQ(noisy_block.compression, kMinidumpCompressedMemoryCompressionNone);
+  std::string contents;
+  ASSERT_NO_FATAL_FAILURE(
+      ExpandRange(string_file.string(), ranges[0], &contents));
+  EXPECT_EQ(contents, noisy);
+
+  EXPECT_EQ(ranges[1].start_of_memory_range, kRepetitiveAddress);
+  EXPECT_EQ(ranges[1].data_size, repetitive.size());
+  EXPECT_EQ(ranges[1].block_size, kBlockSize);
+  EXPECT_EQ(ranges[1].block_count, 4u);
+  ASSERT_NO_FATAL_FAILURE(
+      ExpandRange(string_file.string(), ranges[1], &contents));
+  EXPECT_EQ(contents, repetitive);
+
+  // The repetitive range takes much less space than it would uncompressed.
+  EXPECT_LT(string_file.string().size(), noisy.size() + repetitive.size() / 2);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
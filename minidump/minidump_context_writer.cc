@@ -49,6 +49,17 @@ static_assert(sizeof(MinidumpContextAMD64) == sizeof(CONTEXT), "CONTEXT size");
 #endif  // ARCH_CPU_X86_FAMILY
 #endif  // BUILDFLAG(IS_WIN)
 
+// Creates a ContextWriter and initializes it from the architecture-specific
+// |context_snapshot|. ContextWriter::operator new is used, so writers that
+// require extra alignment get it.
+template <typename ContextWriter, typename ContextSnapshot>
+std::unique_ptr<MinidumpContextWriter> CreateWriterFromSnapshot(
+    const ContextSnapshot* context_snapshot) {
+  std::unique_ptr<ContextWriter> context(new ContextWriter());
+  context->InitializeFromSnapshot(context_snapshot);
+  return context;
+}
+
 }  // namespace
 
 MinidumpContextWriter::~MinidumpContextWriter() {
@@ -57,67 +68,40 @@ MinidumpContextWriter::~MinidumpContextWriter() {
 // static
 std::unique_ptr<MinidumpContextWriter>
 MinidumpContextWriter::CreateFromSnapshot(const CPUContext* context_snapshot) {
-  std::unique_ptr<MinidumpContextWriter> context;
-
   switch (context_snapshot->architecture) {
-    case kCPUArchitectureX86: {
-      MinidumpContextX86Writer* context_x86 = new MinidumpContextX86Writer();
-      context.reset(context_x86);
-      context_x86->InitializeFromSnapshot(context_snapshot->x86);
-      break;
-    }
+    case kCPUArchitectureX86:
+      return CreateWriterFromSnapshot<MinidumpContextX86Writer>(
+          context_snapshot->x86);
 
-    case kCPUArchitectureX86_64: {
-      MinidumpContextAMD64Writer* context_amd64 =
-          new MinidumpContextAMD64Writer();
-      context.reset(context_amd64);
-      context_amd64->InitializeFromSnapshot(context_snapshot->x86_64);
-      break;
-    }
+    case kCPUArchitectureX86_64:
+      return CreateWriterFromSnapshot<MinidumpContextAMD64Writer>(
+          context_snapshot->x86_64);
 
-    case kCPUArchitectureARM: {
-      context = std::make_unique<MinidumpContextARMWriter>();
-      reinterpret_cast<MinidumpContextARMWriter*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->arm);
-      break;
-    }
+    case kCPUArchitectureARM:
+      return CreateWriterFromSnapshot<MinidumpContextARMWriter>(
+          context_snapshot->arm);
 
-    case kCPUArchitectureARM64: {
-      context = std::make_unique<MinidumpContextARM64Writer>();
-      reinterpret_cast<MinidumpContextARM64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->arm64);
-      break;
-    }
+    case kCPUArchitectureARM64:
+      return CreateWriterFromSnapshot<MinidumpContextARM64Writer>(
+          context_snapshot->arm64);
 
-    case kCPUArchitectureMIPSEL: {
-      context = std::make_unique<MinidumpContextMIPSWriter>();
-      reinterpret_cast<MinidumpContextMIPSWriter*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->mipsel);
-      break;
-    }
+    case kCPUArchitectureMIPSEL:
+      return CreateWriterFromSnapshot<MinidumpContextMIPSWriter>(
+          context_snapshot->mipsel);
 
-    case kCPUArchitectureMIPS64EL: {
-      context = std::make_unique<MinidumpContextMIPS64Writer>();
-      reinterpret_cast<MinidumpContextMIPS64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->mips64);
-      break;
-    }
+    case kCPUArchitectureMIPS64EL:
+      return CreateWriterFromSnapshot<MinidumpContextMIPS64Writer>(
+          context_snapshot->mips64);
 
-    case kCPUArchitectureRISCV64: {
-      context = std::make_unique<MinidumpContextRISCV64Writer>();
-      reinterpret_cast<MinidumpContextRISCV64Writer*>(context.get())
-          ->InitializeFromSnapshot(context_snapshot->riscv64);
-      break;
-    }
+    case kCPUArchitectureRISCV64:
+      return CreateWriterFromSnapshot<MinidumpContextRISCV64Writer>(
+          context_snapshot->riscv64);
 
-    default: {
+    default:
       LOG(ERROR) << "unknown context architecture "
                  << context_snapshot->architecture;
-      break;
-    }
+      return nullptr;
   }
-
-  return context;
 }
 
 size_t MinidumpContextWriter::SizeOfObject() {
@@ -497,10 +481,11 @@ void MinidumpContextMIPSWriter::InitializeFromSnapshot(
   context_.fpcsr = context_snapshot->fpcsr;
   context_.fir = context_snapshot->fir;
 
-  for (size_t index = 0; index < 3; ++index) {
-    context_.hi[index] = context_snapshot->hi[index];
-    context_.lo[index] = context_snapshot->lo[index];
-  }
+  static_assert(sizeof(context_.hi) == sizeof(context_snapshot->hi) &&
+                    sizeof(context_.lo) == sizeof(context_snapshot->lo),
+                "DSP accumulator size mismatch");
+  memcpy(context_.hi, context_snapshot->hi, sizeof(context_.hi));
+  memcpy(context_.lo, context_snapshot->lo, sizeof(context_.lo));
   context_.dsp_control = context_snapshot->dsp_control;
 }
 
@@ -546,10 +531,11 @@ void MinidumpContextMIPS64Writer::InitializeFromSnapshot(
   context_.fpcsr = context_snapshot->fpcsr;
   context_.fir = context_snapshot->fir;
 
-  for (size_t index = 0; index < 3; ++index) {
-    context_.hi[index] = context_snapshot->hi[index];
-    context_.lo[index] = context_snapshot->lo[index];
-  }
+  static_assert(sizeof(context_.hi) == sizeof(context_snapshot->hi) &&
+                    sizeof(context_.lo) == sizeof(context_snapshot->lo),
+                "DSP accumulator size mismatch");
+  memcpy(context_.hi, context_snapshot->hi, sizeof(context_.hi));
+  memcpy(context_.lo, context_snapshot->lo, sizeof(context_.lo));
   context_.dsp_control = context_snapshot->dsp_control;
 }
 
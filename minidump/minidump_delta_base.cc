@@ -0,0 +1,125 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_delta_base.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/check_op.h"
+#include "snapshot/memory_map_region_snapshot.h"
+#include "snapshot/module_snapshot.h"
+#include "util/misc/xxhash64.h"
+
+namespace crashpad {
+
+namespace {
+
+void UpdateWithString(XXHash64* hash, const std::string& string) {
+  const uint64_t size = string.size();
+  hash->Update(&size, sizeof(size));
+  hash->Update(string.data(), string.size());
+}
+
+}  // namespace
+
+MinidumpDeltaBase::MinidumpDeltaBase()
+    : page_hashes_(),
+      report_id_(),
+      module_list_digest_(0),
+      memory_info_digest_(0) {}
+
+MinidumpDeltaBase::~MinidumpDeltaBase() = default;
+
+void MinidumpDeltaBase::AddPageHash(uint64_t address, uint64_t hash) {
+  DCHECK_EQ(address % kPageSize, 0u);
+  DCHECK(page_hashes_.empty() || page_hashes_.back().address < address);
+  page_hashes_.push_back({address, hash});
+}
+
+bool MinidumpDeltaBase::PageMatches(uint64_t address, uint64_t hash) const {
+  auto page = std::lower_bound(
+      page_hashes_.begin(),
+      page_hashes_.end(),
+      address,
+      [](const PageHash& page_hash, uint64_t address) {
+        return page_hash.address < address;
+      });
+  return page != page_hashes_.end() && page->address == address &&
+         page->hash == hash;
+}
+
+void MinidumpDeltaBase::ClearPageHashes() {
+  page_hashes_.clear();
+}
+
+// static
+uint64_t MinidumpDeltaBase::HashPage(const void* data) {
+  XXHash64 hash;
+  hash.Update(data, kPageSize);
+  return hash.Digest();
+}
+
+// static
+uint64_t MinidumpDeltaBase::ModuleListDigest(
+    const std::vector<const ModuleSnapshot*>& modules) {
+  XXHash64 hash;
+  for (const ModuleSnapshot* module : modules) {
+    UpdateWithString(&hash, module->Name());
+    UpdateWithString(&hash, module->DebugFileName());
+
+    const uint64_t address = module->Address();
+    const uint64_t size = module->Size();
+    const int64_t timestamp = module->Timestamp();
+    const uint32_t type = module->GetModuleType();
+    hash.Update(&address, sizeof(address));
+    hash.Update(&size, sizeof(size));
+    hash.Update(&timestamp, sizeof(timestamp));
+    hash.Update(&type, sizeof(type));
+
+    uint16_t versions[8];
+    module->FileVersion(
+        &versions[0], &versions[1], &versions[2], &versions[3]);
+    module->SourceVersion(
+        &versions[4], &versions[5], &versions[6], &versions[7]);
+    hash.Update(versions, sizeof(versions));
+
+    UUID uuid;
+    uint32_t age;
+    module->UUIDAndAge(&uuid, &age);
+    hash.Update(&uuid, sizeof(uuid));
+    hash.Update(&age, sizeof(age));
+
+    const std::vector<uint8_t> build_id = module->BuildID();
+    const uint64_t build_id_size = build_id.size();
+    hash.Update(&build_id_size, sizeof(build_id_size));
+    if (!build_id.empty()) {
+      hash.Update(build_id.data(), build_id.size());
+    }
+  }
+  return hash.Digest();
+}
+
+// static
+uint64_t MinidumpDeltaBase::MemoryInfoDigest(
+    const std::vector<const MemoryMapRegionSnapshot*>& memory_map) {
+  XXHash64 hash;
+  for (const MemoryMapRegionSnapshot* region : memory_map) {
+    const MINIDUMP_MEMORY_INFO& memory_info = region->AsMinidumpMemoryInfo();
+    hash.Update(&memory_info, sizeof(memory_info));
+  }
+  return hash.Digest();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,111 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_DELTA_BASE_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_DELTA_BASE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+
+class MemoryMapRegionSnapshot;
+class ModuleSnapshot;
+
+//! \brief What a full minidump file of a process held, so that later minidump
+//!     files of the same process can be written as deltas against it.
+//!
+//! An object of this class is filled in while a minidump file is written by a
+//! MinidumpFileWriter that it has been given to with
+//! MinidumpFileWriter::SetRecordDeltaBase(). It may then be given to the
+//! MinidumpFileWriter of a later minidump file with
+//! MinidumpFileWriter::SetDeltaBase(), to omit what hasn’t changed. See
+//! MinidumpDelta.
+//!
+//! Memory is recorded as a 64-bit XXH64 hash of each whole, aligned page.
+class MinidumpDeltaBase {
+ public:
+  //! \brief The granularity at which memory is compared, in bytes.
+  static constexpr uint64_t kPageSize = 4096;
+
+  MinidumpDeltaBase();
+
+  MinidumpDeltaBase(const MinidumpDeltaBase&) = delete;
+  MinidumpDeltaBase& operator=(const MinidumpDeltaBase&) = delete;
+
+  ~MinidumpDeltaBase();
+
+  //! \brief The report that the base minidump file belongs to.
+  const UUID& report_id() const { return report_id_; }
+  void set_report_id(const UUID& report_id) { report_id_ = report_id; }
+
+  //! \brief The ModuleListDigest() of the base’s modules.
+  uint64_t module_list_digest() const { return module_list_digest_; }
+  void set_module_list_digest(uint64_t digest) { module_list_digest_ = digest; }
+
+  //! \brief The MemoryInfoDigest() of the base’s memory map.
+  uint64_t memory_info_digest() const { return memory_info_digest_; }
+  void set_memory_info_digest(uint64_t digest) { memory_info_digest_ = digest; }
+
+  //! \brief Records the hash of a page of memory that the base holds.
+  //!
+  //! \param[in] address The address of the page, a multiple of #kPageSize.
+  //!     Pages must be added in increasing order of address.
+  //! \param[in] hash The page’s hash, from HashPage().
+  void AddPageHash(uint64_t address, uint64_t hash);
+
+  //! \brief Returns `true` if the base holds the page at \a address, and its
+  //!     hash was \a hash.
+  bool PageMatches(uint64_t address, uint64_t hash) const;
+
+  //! \brief The number of pages recorded with AddPageHash().
+  size_t page_count() const { return page_hashes_.size(); }
+
+  //! \brief Forgets all recorded pages.
+  void ClearPageHashes();
+
+  //! \brief Computes the hash of a page of memory.
+  //!
+  //! \param[in] data The #kPageSize bytes of the page.
+  static uint64_t HashPage(const void* data);
+
+  //! \brief Computes a digest of everything that a MINIDUMP_MODULE_LIST
+  //!     stream records about \a modules.
+  static uint64_t ModuleListDigest(
+      const std::vector<const ModuleSnapshot*>& modules);
+
+  //! \brief Computes a digest of everything that a MINIDUMP_MEMORY_INFO_LIST
+  //!     stream records about \a memory_map.
+  static uint64_t MemoryInfoDigest(
+      const std::vector<const MemoryMapRegionSnapshot*>& memory_map);
+
+ private:
+  struct PageHash {
+    uint64_t address;
+    uint64_t hash;
+  };
+
+  std::vector<PageHash> page_hashes_;
+  UUID report_id_;
+  uint64_t module_list_digest_;
+  uint64_t memory_info_digest_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_DELTA_BASE_H_
@@ -0,0 +1,91 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_delta_base.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_memory_map_region_snapshot.h"
+#include "snapshot/test/test_module_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(MinidumpDeltaBase, PageMatches) {
+  const std::string page_a(MinidumpDeltaBase::kPageSize, 'a');
+  const std::string page_b(MinidumpDeltaBase::kPageSize, 'b');
+  const uint64_t hash_a = MinidumpDeltaBase::HashPage(page_a.data());
+  const uint64_t hash_b = MinidumpDeltaBase::HashPage(page_b.data());
+  EXPECT_NE(hash_a, hash_b);
+
+  MinidumpDeltaBase base;
+  base.AddPageHash(0x1000, hash_a);
+  base.AddPageHash(0x3000, hash_b);
+  base.AddPageHash(0x4000, hash_a);
+  EXPECT_EQ(base.page_count(), 3u);
+
+  EXPECT_TRUE(base.PageMatches(0x1000, hash_a));
+  EXPECT_FALSE(base.PageMatches(0x1000, hash_b));
+  EXPECT_FALSE(base.PageMatches(0x2000, hash_a));
+  EXPECT_TRUE(base.PageMatches(0x3000, hash_b));
+  EXPECT_TRUE(base.PageMatches(0x4000, hash_a));
+  EXPECT_FALSE(base.PageMatches(0x5000, hash_a));
+
+  base.ClearPageHashes();
+  EXPECT_EQ(base.page_count(), 0u);
+  EXPECT_FALSE(base.PageMatches(0x1000, hash_a));
+}
+
+TEST(MinidumpDeltaBase, ModuleListDigest) {
+  TestModuleSnapshot module_0;
+  module_0.SetName("module_0");
+  module_0.SetAddressAndSize(0x10000, 0x2000);
+  TestModuleSnapshot module_1;
+  module_1.SetName("module_1");
+  module_1.SetAddressAndSize(0x20000, 0x3000);
+
+  const uint64_t digest =
+      MinidumpDeltaBase::ModuleListDigest({&module_0, &module_1});
+  EXPECT_EQ(MinidumpDeltaBase::ModuleListDigest({&module_0, &module_1}),
+            digest);
+  EXPECT_NE(MinidumpDeltaBase::ModuleListDigest({&module_0}), digest);
+  EXPECT_NE(MinidumpDeltaBase::ModuleListDigest({&module_1, &module_0}),
+            digest);
+
+  module_1.SetBuildID({1, 2, 3});
+  EXPECT_NE(MinidumpDeltaBase::ModuleListDigest({&module_0, &module_1}),
+            digest);
+}
+
+TEST(MinidumpDeltaBase, MemoryInfoDigest) {
+  MINIDUMP_MEMORY_INFO memory_info = {};
+  memory_info.BaseAddress = 0x10000;
+  memory_info.RegionSize = 0x1000;
+  memory_info.Protect = PAGE_READWRITE;
+  TestMemoryMapRegionSnapshot region;
+  region.SetMindumpMemoryInfo(memory_info);
+
+  const uint64_t digest = MinidumpDeltaBase::MemoryInfoDigest({&region});
+  EXPECT_EQ(MinidumpDeltaBase::MemoryInfoDigest({&region}), digest);
+
+  memory_info.Protect = PAGE_READONLY;
+  region.SetMindumpMemoryInfo(memory_info);
+  EXPECT_NE(MinidumpDeltaBase::MemoryInfoDigest({&region}), digest);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
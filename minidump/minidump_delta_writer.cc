@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_delta_writer.h"
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_writer.h"
+#include "util/misc/uuid.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpDeltaWriter::MinidumpDeltaWriter() : delta_(), ranges_() {
+  delta_.version = MinidumpDelta::kVersion;
+}
+
+MinidumpDeltaWriter::~MinidumpDeltaWriter() = default;
+
+void MinidumpDeltaWriter::SetBaseReportID(const UUID& base_report_id) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  delta_.base_report_id = base_report_id;
+}
+
+void MinidumpDeltaWriter::AddFlags(uint32_t flags) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  delta_.flags |= flags;
+}
+
+void MinidumpDeltaWriter::AddRange(uint64_t address, uint64_t size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_GT(size, 0u);
+
+  if (!ranges_.empty()) {
+    MinidumpDeltaRange& last = ranges_.back();
+    if (last.start_of_memory_range + last.data_size == address) {
+      last.data_size += size;
+      return;
+    }
+  }
+
+  MinidumpDeltaRange range = {};
+  range.start_of_memory_range = address;
+  range.data_size = size;
+  ranges_.push_back(range);
+}
+
+bool MinidumpDeltaWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  std::sort(ranges_.begin(),
+            ranges_.end(),
+            [](const MinidumpDeltaRange& a, const MinidumpDeltaRange& b) {
+              return a.start_of_memory_range < b.start_of_memory_range;
+            });
+
+  if (!AssignIfInRange(&delta_.count, ranges_.size())) {
+    LOG(ERROR) << "range count " << ranges_.size() << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpDeltaWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+  return sizeof(delta_) + sizeof(MinidumpDeltaRange) * ranges_.size();
+}
+
+std::vector<internal::MinidumpWritable*> MinidumpDeltaWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+  return std::vector<internal::MinidumpWritable*>();
+}
+
+bool MinidumpDeltaWriter::WriteObject(FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &delta_;
+  iov.iov_len = sizeof(delta_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!ranges_.empty()) {
+    iov.iov_base = ranges_.data();
+    iov.iov_len = sizeof(MinidumpDeltaRange) * ranges_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpDeltaWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadDelta;
+}
+
+}  // namespace crashpad
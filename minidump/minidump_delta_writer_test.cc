@@ -0,0 +1,134 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_delta_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "util/file/string_file.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The delta is expected to be the only stream.
+void GetDeltaStream(const std::string& file_contents,
+                    const MinidumpDelta** delta) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kDeltaStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadDelta);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva, kDeltaStreamOffset);
+
+  *delta = MinidumpWritableAtLocationDescriptor<MinidumpDelta>(
+      file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*delta);
+}
+
+TEST(MinidumpDeltaWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto delta_writer = std::make_unique<MinidumpDeltaWriter>();
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(delta_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpDelta));
+
+  const MinidumpDelta* delta = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetDeltaStream(string_file.string(), &delta));
+
+  EXPECT_EQ(delta->version, MinidumpDelta::kVersion);
+  EXPECT_EQ(delta->base_report_id, UUID());
+  EXPECT_EQ(delta->flags, 0u);
+  EXPECT_EQ(delta->count, 0u);
+}
+
+TEST(MinidumpDeltaWriter, Ranges) {
+  UUID base_report_id;
+  ASSERT_TRUE(base_report_id.InitializeFromString(
+      "00112233-4455-6677-8899-aabbccddeeff"));
+
+  MinidumpFileWriter minidump_file_writer;
+  auto delta_writer = std::make_unique<MinidumpDeltaWriter>();
+  delta_writer->SetBaseReportID(base_report_id);
+  delta_writer->AddFlags(kMinidumpDeltaModuleListOmitted);
+  delta_writer->AddFlags(kMinidumpDeltaMemoryInfoListOmitted);
+
+  // Ranges are sorted, and a range that abuts the one added before it is
+  // merged with it.
+  delta_writer->AddRange(0x30000, 0x1000);
+  delta_writer->AddRange(0x10000, 0x1000);
+  delta_writer->AddRange(0x11000, 0x3000);
+  delta_writer->AddRange(0x20000, 0x2000);
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(delta_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  constexpr size_t kRangeCount = 3;
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpDelta) +
+                kRangeCount * sizeof(MinidumpDeltaRange));
+
+  const MinidumpDelta* delta = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetDeltaStream(string_file.string(), &delta));
+
+  EXPECT_EQ(delta->version, MinidumpDelta::kVersion);
+  EXPECT_EQ(delta->base_report_id, base_report_id);
+  EXPECT_EQ(delta->flags,
+            kMinidumpDeltaModuleListOmitted |
+                kMinidumpDeltaMemoryInfoListOmitted);
+  ASSERT_EQ(delta->count, kRangeCount);
+  static constexpr MinidumpDeltaRange kExpected[kRangeCount] = {
+      {0x10000, 0x4000},
+      {0x20000, 0x2000},
+      {0x30000, 0x1000},
+  };
+  for (size_t index = 0; index < kRangeCount; ++index) {
+    SCOPED_TRACE(index);
+    MinidumpDeltaRange range;
+    memcpy(&range, &delta->ranges[index], sizeof(range));
+    EXPECT_EQ(range.start_of_memory_range,
+              kExpected[index].start_of_memory_range);
+    EXPECT_EQ(range.data_size, kExpected[index].data_size);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
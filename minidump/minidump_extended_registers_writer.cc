@@ -0,0 +1,155 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_extended_registers_writer.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "minidump/minidump_byte_array_writer.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/misc/extended_register_state.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpExtendedRegistersListWriter::MinidumpExtendedRegistersListWriter()
+    : MinidumpStreamWriter(),
+      extended_registers_list_base_(),
+      entries_(),
+      data_() {}
+
+MinidumpExtendedRegistersListWriter::~MinidumpExtendedRegistersListWriter() =
+    default;
+
+void MinidumpExtendedRegistersListWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const ExceptionSnapshot* exception_snapshot,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(entries_.empty());
+
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    const ExtendedRegisterState* registers =
+        thread_snapshot->ExtendedRegisters();
+    if (registers) {
+      const auto it = thread_id_map.find(thread_snapshot->ThreadID());
+      DCHECK(it != thread_id_map.end());
+      AddExtendedRegisters(it->second, 0, *registers);
+    }
+  }
+
+  if (exception_snapshot) {
+    const ExtendedRegisterState* registers =
+        exception_snapshot->ExtendedRegisters();
+    if (registers) {
+      const auto it = thread_id_map.find(exception_snapshot->ThreadID());
+      DCHECK(it != thread_id_map.end());
+      AddExtendedRegisters(
+          it->second, kMinidumpExtendedRegistersFromException, *registers);
+    }
+  }
+}
+
+void MinidumpExtendedRegistersListWriter::AddExtendedRegisters(
+    uint32_t thread_id,
+    uint32_t flags,
+    const ExtendedRegisterState& registers) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (registers.empty()) {
+    return;
+  }
+
+  MinidumpExtendedRegisters entry = {};
+  entry.thread_id = thread_id;
+  entry.flags = flags;
+  entry.format = static_cast<uint32_t>(registers.format());
+  entry.vector_length = registers.vector_length();
+  entries_.push_back(entry);
+
+  auto data = std::make_unique<MinidumpByteArrayWriter>();
+  data->set_data(registers.data());
+  data_.push_back(std::move(data));
+}
+
+bool MinidumpExtendedRegistersListWriter::IsUseful() const {
+  return !entries_.empty();
+}
+
+bool MinidumpExtendedRegistersListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&extended_registers_list_base_.count,
+                       entries_.size())) {
+    LOG(ERROR) << "entry count " << entries_.size() << " out of range";
+    return false;
+  }
+
+  DCHECK_EQ(entries_.size(), data_.size());
+  for (size_t index = 0; index < entries_.size(); ++index) {
+    data_[index]->RegisterRVA(&entries_[index].data);
+  }
+
+  return true;
+}
+
+size_t MinidumpExtendedRegistersListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+  return sizeof(extended_registers_list_base_) +
+         sizeof(MinidumpExtendedRegisters) * entries_.size();
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpExtendedRegistersListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+
+  std::vector<MinidumpWritable*> children;
+  children.reserve(data_.size());
+  for (const auto& data : data_) {
+    children.push_back(data.get());
+  }
+  return children;
+}
+
+bool MinidumpExtendedRegistersListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &extended_registers_list_base_;
+  iov.iov_len = sizeof(extended_registers_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!entries_.empty()) {
+    iov.iov_base = entries_.data();
+    iov.iov_len = sizeof(MinidumpExtendedRegisters) * entries_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpExtendedRegistersListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadExtendedRegisters;
+}
+
+}  // namespace crashpad
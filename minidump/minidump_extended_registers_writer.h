@@ -0,0 +1,104 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_EXTENDED_REGISTERS_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_EXTENDED_REGISTERS_WRITER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class ExceptionSnapshot;
+class ExtendedRegisterState;
+class MinidumpByteArrayWriter;
+class ThreadSnapshot;
+
+//! \brief The writer for a MinidumpExtendedRegistersList stream in a minidump
+//!     file, containing the extended register state of each thread that has
+//!     any.
+class MinidumpExtendedRegistersListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpExtendedRegistersListWriter();
+
+  MinidumpExtendedRegistersListWriter(
+      const MinidumpExtendedRegistersListWriter&) = delete;
+  MinidumpExtendedRegistersListWriter& operator=(
+      const MinidumpExtendedRegistersListWriter&) = delete;
+
+  ~MinidumpExtendedRegistersListWriter() override;
+
+  //! \brief Adds an entry for each thread in \a thread_snapshots, and for
+  //!     \a exception_snapshot, that has extended register registers.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] exception_snapshot The exception snapshot to use as source
+  //!     data. This may be `nullptr`.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const ExceptionSnapshot* exception_snapshot,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds an entry for \a registers, unless it’s empty.
+  //!
+  //! \param[in] thread_id The minidump thread ID of the thread that
+  //!     \a registers belongs to.
+  //! \param[in] flags A bitwise OR of MinidumpExtendedRegistersFlags values.
+  //! \param[in] registers The register state to add. Its data is copied.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddExtendedRegisters(uint32_t thread_id,
+                            uint32_t flags,
+                            const ExtendedRegisterState& registers);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying no entries is not
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpExtendedRegistersList extended_registers_list_base_;
+  std::vector<MinidumpExtendedRegisters> entries_;
+  std::vector<std::unique_ptr<MinidumpByteArrayWriter>> data_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_EXTENDED_REGISTERS_WRITER_H_
@@ -0,0 +1,166 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_extended_registers_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_byte_array_writer_test_util.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+#include "util/misc/extended_register_state.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The extended registers list is expected to be the only stream.
+void GetExtendedRegistersListStream(
+    const std::string& file_contents,
+    const MinidumpExtendedRegistersList** extended_registers_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kExtendedRegistersListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadExtendedRegisters);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kExtendedRegistersListStreamOffset);
+
+  *extended_registers_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpExtendedRegistersList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*extended_registers_list);
+}
+
+std::unique_ptr<ExtendedRegisterState> MakeState(uint8_t value) {
+  auto state = std::make_unique<ExtendedRegisterState>();
+  state->Reset(ExtendedRegisterState::Format::kX86XSave, 0);
+  const std::vector<uint8_t> data(16, value);
+  state->AddComponent(2, data.data(), data.size());
+  return state;
+}
+
+TEST(MinidumpExtendedRegistersListWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto extended_registers_list_writer =
+      std::make_unique<MinidumpExtendedRegistersListWriter>();
+  EXPECT_FALSE(extended_registers_list_writer->IsUseful());
+
+  // Empty state isn’t added.
+  ExtendedRegisterState state;
+  extended_registers_list_writer->AddExtendedRegisters(1, 0, state);
+  EXPECT_FALSE(extended_registers_list_writer->IsUseful());
+
+  ASSERT_TRUE(minidump_file_writer.AddStream(
+      std::move(extended_registers_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpExtendedRegistersList));
+
+  const MinidumpExtendedRegistersList* extended_registers_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetExtendedRegistersListStream(
+      string_file.string(), &extended_registers_list));
+
+  EXPECT_EQ(extended_registers_list->count, 0u);
+}
+
+TEST(MinidumpExtendedRegistersListWriter, InitializeFromSnapshot) {
+  TestThreadSnapshot thread_0;
+  thread_0.SetThreadID(0x1000);
+  thread_0.SetExtendedRegisters(MakeState(1));
+  TestThreadSnapshot thread_1;
+  thread_1.SetThreadID(0x1001);
+  TestThreadSnapshot thread_2;
+  thread_2.SetThreadID(0x1002);
+  thread_2.SetExtendedRegisters(MakeState(2));
+  const std::vector<const ThreadSnapshot*> thread_snapshots = {
+      &thread_0, &thread_1, &thread_2};
+
+  TestExceptionSnapshot exception;
+  exception.SetThreadID(0x1002);
+  exception.SetExtendedRegisters(MakeState(3));
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[0x1000] = 0;
+  thread_id_map[0x1001] = 1;
+  thread_id_map[0x1002] = 2;
+
+  MinidumpFileWriter minidump_file_writer;
+  auto extended_registers_list_writer =
+      std::make_unique<MinidumpExtendedRegistersListWriter>();
+  extended_registers_list_writer->InitializeFromSnapshot(
+      thread_snapshots, &exception, thread_id_map);
+  EXPECT_TRUE(extended_registers_list_writer->IsUseful());
+  ASSERT_TRUE(minidump_file_writer.AddStream(
+      std::move(extended_registers_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpExtendedRegistersList* extended_registers_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(GetExtendedRegistersListStream(
+      string_file.string(), &extended_registers_list));
+
+  constexpr size_t kEntryCount = 3;
+  ASSERT_EQ(extended_registers_list->count, kEntryCount);
+  static constexpr struct {
+    uint32_t thread_id;
+    uint32_t flags;
+    uint8_t value;
+  } kExpected[kEntryCount] = {
+      {0, 0, 1},
+      {2, 0, 2},
+      {2, kMinidumpExtendedRegistersFromException, 3},
+  };
+  for (size_t index = 0; index < kEntryCount; ++index) {
+    SCOPED_TRACE(index);
+    MinidumpExtendedRegisters entry;
+    memcpy(&entry, &extended_registers_list->entries[index], sizeof(entry));
+    EXPECT_EQ(entry.thread_id, kExpected[index].thread_id);
+    EXPECT_EQ(entry.flags, kExpected[index].flags);
+    EXPECT_EQ(entry.format,
+              static_cast<uint32_t>(ExtendedRegisterState::Format::kX86XSave));
+    EXPECT_EQ(entry.vector_length, 0u);
+    EXPECT_EQ(MinidumpByteArrayAtRVA(string_file.string(), entry.data),
+              MakeState(kExpected[index].value)->data());
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
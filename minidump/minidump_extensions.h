@@ -108,6 +108,24 @@ enum MinidumpStreamType : uint32_t {
   //! \brief The stream type for MinidumpCrashpadInfo.
   kMinidumpStreamTypeCrashpadInfo = 0x43500001,
 
+  //! \brief The stream type for MinidumpCaptureTimingList.
+  kMinidumpStreamTypeCrashpadCaptureTimings = 0x43500002,
+
+  //! \brief The stream type for MinidumpZeroMemoryList.
+  kMinidumpStreamTypeCrashpadZeroMemoryList = 0x43500003,
+
+  //! \brief The stream type for MinidumpCompressedMemoryList.
+  kMinidumpStreamTypeCrashpadCompressedMemoryList = 0x43500004,
+
+  //! \brief The stream type for MinidumpDelta.
+  kMinidumpStreamTypeCrashpadDelta = 0x43500005,
+
+  //! \brief The stream type for MinidumpExtendedRegistersList.
+  kMinidumpStreamTypeCrashpadExtendedRegisters = 0x43500006,
+
+  //! \brief The stream type for MinidumpThreadStatsList.
+  kMinidumpStreamTypeCrashpadThreadStats = 0x43500007,
+
   //! \brief The last reserved crashpad stream.
   kMinidumpStreamTypeCrashpadLastReservedStream = 0x4350ffff,
 };
@@ -527,6 +545,289 @@ struct ALIGNAS(4) PACKED MinidumpCrashpadInfo {
   uint64_t address_mask;
 };
 
+//! \brief The cost of one phase of capturing the crash report carried within a
+//!     minidump file.
+struct ALIGNAS(4) PACKED MinidumpCaptureTiming {
+  //! \brief The phase that this structure describes, a CapturePhase value.
+  uint32_t phase;
+
+  //! \brief This field is always `0`.
+  uint32_t reserved;
+
+  //! \brief The wall time spent in the phase, in nanoseconds.
+  uint64_t duration_ns;
+
+  //! \brief The number of bytes read from the target process during the
+  //!     phase.
+  uint64_t bytes_read;
+};
+
+//! \brief The cost of each phase of capturing the crash report carried within
+//!     a minidump file.
+//!
+//! Because this stream is written as part of the minidump, its
+//! CapturePhase::kWrite entry covers only the time spent before the minidump
+//! began to be written to its destination, and its CapturePhase::kDatabase
+//! entry covers only the creation of the report that holds it.
+struct ALIGNAS(4) PACKED MinidumpCaptureTimingList {
+  //! \brief The number of children present in the #timings array.
+  uint32_t count;
+
+  //! \brief The cost of each phase.
+  MinidumpCaptureTiming timings[0];
+};
+
+//! \brief A range of memory in the target process that contained only zeroes,
+//!     and whose contents were omitted from a minidump file.
+struct ALIGNAS(4) PACKED MinidumpZeroMemoryRange {
+  //! \brief The base address of the range.
+  uint64_t start_of_memory_range;
+
+  //! \brief The size of the range, in bytes.
+  uint64_t data_size;
+};
+
+//! \brief Ranges of memory in the target process that were captured, but whose
+//!     contents were omitted from a minidump file because they contained only
+//!     zeroes.
+//!
+//! Each range was removed from a MINIDUMP_MEMORY_DESCRIPTOR in the
+//! MINIDUMP_MEMORY_LIST stream, which may have been split into several
+//! descriptors as a result. A reader can reconstruct the captured memory by
+//! treating each range here as present and filled with zeroes.
+struct ALIGNAS(4) PACKED MinidumpZeroMemoryList {
+  //! \brief The number of children present in the #ranges array.
+  uint32_t count;
+
+  //! \brief The omitted ranges, sorted by address and not overlapping.
+  MinidumpZeroMemoryRange ranges[0];
+};
+
+//! \brief The compression applied to a MinidumpCompressedMemoryBlock.
+enum MinidumpCompressedMemoryCompression : uint32_t {
+  //! \brief The block’s data is stored as-is.
+  //!
+  //! This is used when compression would not reduce the block’s size.
+  kMinidumpCompressedMemoryCompressionNone = 0,
+
+  //! \brief The block’s data is a zlib stream (RFC 1950).
+  kMinidumpCompressedMemoryCompressionZlib = 1,
+};
+
+//! \brief A block of a MinidumpCompressedMemoryRange, compressed independently
+//!     of the other blocks.
+struct ALIGNAS(4) PACKED MinidumpCompressedMemoryBlock {
+  //! \brief The compression applied to the block’s data, a value of
+  //!     MinidumpCompressedMemoryCompression.
+  uint32_t compression;
+
+  //! \brief The block’s data as stored in the minidump file.
+  MINIDUMP_LOCATION_DESCRIPTOR data;
+};
+
+//! \brief A range of memory in the target process whose contents are stored in
+//!     a minidump file as a sequence of independently compressed blocks.
+//!
+//! Block \a n holds the \a block_size bytes at offset `n * block_size` in the
+//! range, except for the last block, which holds whatever remains. Any part of
+//! the range can be read by decompressing only the blocks that cover it.
+struct ALIGNAS(4) PACKED MinidumpCompressedMemoryRange {
+  //! \brief The largest valid #block_size.
+  static constexpr uint32_t kMaxBlockSize = 16 * 1024 * 1024;
+
+  //! \brief The base address of the range.
+  uint64_t start_of_memory_range;
+
+  //! \brief The size of the range when decompressed, in bytes.
+  uint64_t data_size;
+
+  //! \brief The size of each block when decompressed, in bytes. This must not
+  //!     exceed #kMaxBlockSize.
+  uint32_t block_size;
+
+  //! \brief The number of MinidumpCompressedMemoryBlock structures in the
+  //!     array at #blocks.
+  uint32_t block_count;
+
+  //! \brief A pointer to an array of MinidumpCompressedMemoryBlock structures,
+  //!     one for each block of the range, in order.
+  RVA blocks;
+};
+
+//! \brief Ranges of memory in the target process that were captured and stored
+//!     in a minidump file in compressed form.
+//!
+//! Ranges here do not appear in the MINIDUMP_MEMORY_LIST stream.
+struct ALIGNAS(4) PACKED MinidumpCompressedMemoryList {
+  //! \brief The number of children present in the #ranges array.
+  uint32_t count;
+
+  //! \brief The compressed ranges, sorted by address and not overlapping.
+  MinidumpCompressedMemoryRange ranges[0];
+};
+
+//! \brief Streams of a base minidump file that a delta minidump file omits,
+//!     because they would have been identical.
+enum MinidumpDeltaFlags : uint32_t {
+  //! \brief The delta has no MINIDUMP_MODULE_LIST stream. The base’s module
+  //!     list stream describes the same modules.
+  kMinidumpDeltaModuleListOmitted = 1 << 0,
+
+  //! \brief The delta has no MINIDUMP_MEMORY_INFO_LIST stream. The base’s
+  //!     memory info list stream describes the same regions.
+  kMinidumpDeltaMemoryInfoListOmitted = 1 << 1,
+};
+
+//! \brief A range of memory in the target process whose contents were
+//!     unchanged since a base minidump file was written, and were omitted from
+//!     a delta minidump file.
+struct ALIGNAS(4) PACKED MinidumpDeltaRange {
+  //! \brief The base address of the range.
+  uint64_t start_of_memory_range;
+
+  //! \brief The size of the range, in bytes.
+  uint64_t data_size;
+};
+
+//! \brief Identifies a minidump file as a delta against an earlier, full
+//!     minidump file of the same process, and lists what it omits.
+//!
+//! A process dumped repeatedly without crashing, such as to monitor a hang,
+//! mostly holds the same memory and modules each time. A delta minidump file
+//! still has every thread, with its context and stack, and every stream that
+//! describes the state of the process, but leaves out:
+//!  - Each whole, aligned 4 KiB page of memory outside of thread stacks whose
+//!    contents match what the base captured at the same address. Pages are
+//!    compared by hash. Each range of such pages was removed from a
+//!    MINIDUMP_MEMORY_DESCRIPTOR in the MINIDUMP_MEMORY_LIST stream, which may
+//!    have been split into several descriptors as a result.
+//!  - The streams named by #flags.
+//!
+//! A reader reconstructs the full minidump file by taking each range here, and
+//! each omitted stream, from the base.
+struct ALIGNAS(4) PACKED MinidumpDelta {
+  // UUID has a constructor, which makes it non-POD, which makes this structure
+  // non-POD. In order for the default constructor to zero-initialize other
+  // members, an explicit constructor must be provided.
+  MinidumpDelta() : version(), base_report_id(), flags(), count() {}
+
+  //! \brief The structure’s currently-defined version number.
+  static constexpr uint32_t kVersion = 1;
+
+  //! \brief The structure’s version number, #kVersion.
+  uint32_t version;
+
+  //! \brief The value of MinidumpCrashpadInfo::report_id in the base minidump
+  //!     file, identifying the report that it belongs to.
+  UUID base_report_id;
+
+  //! \brief The streams omitted because they matched the base, a bitwise OR
+  //!     of MinidumpDeltaFlags values.
+  uint32_t flags;
+
+  //! \brief The number of children present in the #ranges array.
+  uint32_t count;
+
+  //! \brief The memory omitted because it matched the base, sorted by address
+  //!     and not overlapping.
+  MinidumpDeltaRange ranges[0];
+};
+
+//! \brief Flags for MinidumpExtendedRegisters::flags.
+enum MinidumpExtendedRegistersFlags : uint32_t {
+  //! \brief The registers were captured at the time of the exception, and
+  //!     belong with the MINIDUMP_EXCEPTION_STREAM::ThreadContext rather than
+  //!     with the thread’s MINIDUMP_THREAD::ThreadContext.
+  kMinidumpExtendedRegistersFromException = 1 << 0,
+};
+
+//! \brief The extended register state of one thread, beyond what its
+//!     MINIDUMP_CONTEXT holds.
+struct ALIGNAS(4) PACKED MinidumpExtendedRegisters {
+  //! \brief The thread’s ID, matching MINIDUMP_THREAD::ThreadId.
+  uint32_t thread_id;
+
+  //! \brief A bitwise OR of MinidumpExtendedRegistersFlags values.
+  uint32_t flags;
+
+  //! \brief The layout of the registers, an ExtendedRegisterState::Format
+  //!     value.
+  uint32_t format;
+
+  //! \brief The vector length in bytes, for formats that have one.
+  uint32_t vector_length;
+
+  //! \brief A MinidumpByteArray holding the components present.
+  //!
+  //! Each component is a pair of `uint32_t` values, its ID and size, followed
+  //! by that many bytes of data and padding to an 8-byte boundary. For
+  //! ExtendedRegisterState::Format::kX86XSave, the IDs are XSAVE state
+  //! component numbers and the data is laid out as XSAVE stores it. Components
+  //! in their initial state are omitted.
+  RVA data;
+};
+
+//! \brief The extended register state of the threads in a minidump file that
+//!     have any.
+struct ALIGNAS(4) PACKED MinidumpExtendedRegistersList {
+  //! \brief The number of children present in the #entries array.
+  uint32_t count;
+
+  //! \brief The state of each thread.
+  MinidumpExtendedRegisters entries[0];
+};
+
+//! \brief Flags for MinidumpThreadStats::flags.
+enum MinidumpThreadStatsFlags : uint32_t {
+  //! \brief MinidumpThreadStats::voluntary_context_switches and
+  //!     MinidumpThreadStats::involuntary_context_switches are valid.
+  kMinidumpThreadStatsHaveContextSwitches = 1 << 0,
+};
+
+//! \brief The CPU usage and scheduling state of one thread.
+struct ALIGNAS(4) PACKED MinidumpThreadStats {
+  //! \brief The thread’s ID, matching MINIDUMP_THREAD::ThreadId.
+  uint32_t thread_id;
+
+  //! \brief A bitwise OR of MinidumpThreadStatsFlags values.
+  uint32_t flags;
+
+  //! \brief The thread’s scheduling state, as a single character such as
+  //!     `'R'` for running or `'S'` for sleeping. See
+  //!     ThreadSchedulingStats::state.
+  uint8_t state;
+
+  //! \brief Unused, set to `0`.
+  uint8_t reserved[3];
+
+  //! \brief The CPU that the thread last ran on, or `-1` if unknown.
+  int32_t last_cpu;
+
+  //! \brief The time the thread has spent executing in user mode, in
+  //!     microseconds.
+  uint64_t user_time_us;
+
+  //! \brief The time the thread has spent executing in system mode, in
+  //!     microseconds.
+  uint64_t system_time_us;
+
+  //! \brief The number of times the thread gave up its CPU voluntarily.
+  uint64_t voluntary_context_switches;
+
+  //! \brief The number of times the thread was preempted.
+  uint64_t involuntary_context_switches;
+};
+
+//! \brief The CPU usage and scheduling state of the threads in a minidump
+//!     file that have it.
+struct ALIGNAS(4) PACKED MinidumpThreadStatsList {
+  //! \brief The number of children present in the #entries array.
+  uint32_t count;
+
+  //! \brief The statistics of each thread.
+  MinidumpThreadStats entries[0];
+};
+
 #if defined(COMPILER_MSVC)
 #pragma pack(pop)
 #pragma warning(pop)  // C4200
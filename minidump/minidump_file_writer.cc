@@ -18,8 +18,12 @@
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "minidump/minidump_compressed_memory_list_writer.h"
 #include "minidump/minidump_crashpad_info_writer.h"
+#include "minidump/minidump_delta_base.h"
+#include "minidump/minidump_delta_writer.h"
 #include "minidump/minidump_exception_writer.h"
+#include "minidump/minidump_extended_registers_writer.h"
 #include "minidump/minidump_handle_writer.h"
 #include "minidump/minidump_memory_info_writer.h"
 #include "minidump/minidump_memory_writer.h"
@@ -28,22 +32,96 @@
 #include "minidump/minidump_system_info_writer.h"
 #include "minidump/minidump_thread_id_map.h"
 #include "minidump/minidump_thread_name_list_writer.h"
+#include "minidump/minidump_thread_stats_writer.h"
 #include "minidump/minidump_thread_writer.h"
 #include "minidump/minidump_unloaded_module_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "minidump/minidump_user_stream_writer.h"
 #include "minidump/minidump_writer_util.h"
+#include "minidump/minidump_zero_memory_list_writer.h"
+#include "snapshot/cpu_context.h"
 #include "snapshot/exception_snapshot.h"
+#include "snapshot/memory_snapshot.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "snapshot/thread_snapshot.h"
 #include "util/file/file_writer.h"
+#include "util/misc/trace_event.h"
+#include "util/numeric/checked_range.h"
 #include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
 
+namespace {
+
+void AddMemoryRanges(const std::vector<const MemorySnapshot*>& memory,
+                     std::vector<CheckedRange<uint64_t>>* ranges) {
+  for (const MemorySnapshot* snapshot : memory) {
+    ranges->emplace_back(snapshot->Address(), snapshot->Size());
+  }
+}
+
+void AddContextAddresses(const CPUContext* context,
+                         std::vector<CheckedRange<uint64_t>>* ranges) {
+  if (!context) {
+    return;
+  }
+  ranges->emplace_back(context->InstructionPointer(), 0);
+  ranges->emplace_back(context->StackPointer(), 0);
+}
+
+// Returns the address ranges that a memory info list stream limited by
+// MinidumpFileWriter::SetCompactMemoryInfo() should describe.
+std::vector<CheckedRange<uint64_t>> CollectRangesOfInterest(
+    const ProcessSnapshot* process_snapshot) {
+  std::vector<CheckedRange<uint64_t>> ranges;
+
+  for (const ThreadSnapshot* thread : process_snapshot->Threads()) {
+    AddContextAddresses(thread->Context(), &ranges);
+    const MemorySnapshot* stack = thread->Stack();
+    if (stack) {
+      ranges.emplace_back(stack->Address(), stack->Size());
+    }
+    AddMemoryRanges(thread->ExtraMemory(), &ranges);
+  }
+
+  for (const ModuleSnapshot* module : process_snapshot->Modules()) {
+    ranges.emplace_back(module->Address(), module->Size());
+  }
+
+  const ExceptionSnapshot* exception = process_snapshot->Exception();
+  if (exception) {
+    AddContextAddresses(exception->Context(), &ranges);
+    ranges.emplace_back(exception->ExceptionAddress(), 0);
+    AddMemoryRanges(exception->ExtraMemory(), &ranges);
+  }
+
+  AddMemoryRanges(process_snapshot->ExtraMemory(), &ranges);
+
+  return ranges;
+}
+
+}  // namespace
+
 MinidumpFileWriter::MinidumpFileWriter()
-    : MinidumpWritable(), header_(), streams_(), stream_types_() {
+    : MinidumpWritable(),
+      header_(),
+      arena_(),
+      streams_(),
+      stream_types_(),
+      memory_buffer_limit_(0),
+      concurrent_write_threads_(0),
+      concurrent_write_min_size_(0),
+      deduplicate_strings_(false),
+      compressed_memory_minimum_size_(0),
+      compressed_memory_block_size_(
+          MinidumpCompressedMemoryListWriter::kDefaultBlockSize),
+      compact_memory_info_neighborhood_size_(0),
+      record_delta_base_(nullptr),
+      delta_base_(nullptr),
+      elide_zero_memory_(false),
+      elide_unpopulated_memory_(false),
+      compact_memory_info_(false) {
   // Don’t set the signature field right away. Leave it set to 0, so that a
   // partially-written minidump file isn’t confused for a complete and valid
   // one. The header will be rewritten in WriteToFile().
@@ -59,12 +137,18 @@ MinidumpFileWriter::~MinidumpFileWriter() {
 
 void MinidumpFileWriter::InitializeFromSnapshot(
     const ProcessSnapshot* process_snapshot) {
+  CRASHPAD_TRACE_EVENT("minidump",
+                       "MinidumpFileWriter::InitializeFromSnapshot");
   DCHECK_EQ(state(), kStateMutable);
   DCHECK_EQ(header_.Signature, 0u);
   DCHECK_EQ(header_.TimeDateStamp, 0u);
   DCHECK_EQ(static_cast<MINIDUMP_TYPE>(header_.Flags), MiniDumpNormal);
   DCHECK(streams_.empty());
 
+  // Allocate the entire tree of objects created here from a single arena, so
+  // that it can be freed all at once instead of object by object.
+  internal::MinidumpWritableArena::ScopedCurrent scoped_arena(&arena_);
+
   // This time is truncated to an integer number of seconds, not rounded, for
   // compatibility with the truncation of process_snapshot->ProcessStartTime()
   // done by MinidumpMiscInfoWriter::InitializeFromSnapshot(). Handling both
@@ -89,6 +173,60 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   DCHECK(add_stream_result);
 
   auto memory_list = std::make_unique<MinidumpMemoryListWriter>();
+  std::unique_ptr<MinidumpZeroMemoryListWriter> zero_memory_list;
+  if (elide_zero_memory_ || elide_unpopulated_memory_) {
+    zero_memory_list = std::make_unique<MinidumpZeroMemoryListWriter>();
+    if (elide_zero_memory_) {
+      memory_list->SetZeroMemoryListWriter(zero_memory_list.get());
+    } else {
+      memory_list->SetUnpopulatedMemoryListWriter(zero_memory_list.get());
+    }
+  }
+  std::unique_ptr<MinidumpCompressedMemoryListWriter> compressed_memory_list;
+  if (compressed_memory_minimum_size_) {
+    compressed_memory_list =
+        std::make_unique<MinidumpCompressedMemoryListWriter>();
+    compressed_memory_list->SetBlockSize(compressed_memory_block_size_);
+    memory_list->SetCompressedMemoryListWriter(
+        compressed_memory_list.get(), compressed_memory_minimum_size_);
+  }
+  std::vector<const MemoryMapRegionSnapshot*> memory_map_snapshot =
+      process_snapshot->MemoryMap();
+  bool omit_module_list = false;
+  bool omit_memory_info_list = false;
+  std::unique_ptr<MinidumpDeltaWriter> delta;
+  if (record_delta_base_) {
+    UUID report_id;
+    process_snapshot->ReportID(&report_id);
+    record_delta_base_->set_report_id(report_id);
+    record_delta_base_->set_module_list_digest(
+        MinidumpDeltaBase::ModuleListDigest(process_snapshot->Modules()));
+    record_delta_base_->set_memory_info_digest(
+        MinidumpDeltaBase::MemoryInfoDigest(memory_map_snapshot));
+    record_delta_base_->ClearPageHashes();
+    memory_list->SetPageHashRecorder(record_delta_base_);
+  } else if (delta_base_) {
+    delta = std::make_unique<MinidumpDeltaWriter>();
+    delta->SetBaseReportID(delta_base_->report_id());
+    omit_module_list =
+        MinidumpDeltaBase::ModuleListDigest(process_snapshot->Modules()) ==
+        delta_base_->module_list_digest();
+    if (omit_module_list) {
+      delta->AddFlags(kMinidumpDeltaModuleListOmitted);
+    }
+
+    // What a compacted memory info list holds depends on more than the memory
+    // map, so it’s always written.
+    omit_memory_info_list =
+        !memory_map_snapshot.empty() && !compact_memory_info_ &&
+        MinidumpDeltaBase::MemoryInfoDigest(memory_map_snapshot) ==
+            delta_base_->memory_info_digest();
+    if (omit_memory_info_list) {
+      delta->AddFlags(kMinidumpDeltaMemoryInfoListOmitted);
+    }
+    memory_list->SetDeltaBase(delta_base_, delta.get());
+  }
+
   auto thread_list = std::make_unique<MinidumpThreadListWriter>();
   thread_list->SetMemoryListWriter(memory_list.get());
   MinidumpThreadIDMap thread_id_map;
@@ -120,10 +258,29 @@ void MinidumpFileWriter::InitializeFromSnapshot(
     DCHECK(add_stream_result);
   }
 
-  auto module_list = std::make_unique<MinidumpModuleListWriter>();
-  module_list->InitializeFromSnapshot(process_snapshot->Modules());
-  add_stream_result = AddStream(std::move(module_list));
-  DCHECK(add_stream_result);
+  auto extended_registers_list =
+      std::make_unique<MinidumpExtendedRegistersListWriter>();
+  extended_registers_list->InitializeFromSnapshot(
+      process_snapshot->Threads(), exception_snapshot, thread_id_map);
+  if (extended_registers_list->IsUseful()) {
+    add_stream_result = AddStream(std::move(extended_registers_list));
+    DCHECK(add_stream_result);
+  }
+
+  auto thread_stats_list = std::make_unique<MinidumpThreadStatsListWriter>();
+  thread_stats_list->InitializeFromSnapshot(process_snapshot->Threads(),
+                                            thread_id_map);
+  if (thread_stats_list->IsUseful()) {
+    add_stream_result = AddStream(std::move(thread_stats_list));
+    DCHECK(add_stream_result);
+  }
+
+  if (!omit_module_list) {
+    auto module_list = std::make_unique<MinidumpModuleListWriter>();
+    module_list->InitializeFromSnapshot(process_snapshot->Modules());
+    add_stream_result = AddStream(std::move(module_list));
+    DCHECK(add_stream_result);
+  }
 
   auto unloaded_modules = process_snapshot->UnloadedModules();
   if (!unloaded_modules.empty()) {
@@ -144,10 +301,14 @@ void MinidumpFileWriter::InitializeFromSnapshot(
     DCHECK(add_stream_result);
   }
 
-  std::vector<const MemoryMapRegionSnapshot*> memory_map_snapshot =
-      process_snapshot->MemoryMap();
-  if (!memory_map_snapshot.empty()) {
+  if (!memory_map_snapshot.empty() && !omit_memory_info_list) {
     auto memory_info_list = std::make_unique<MinidumpMemoryInfoListWriter>();
+    if (compact_memory_info_) {
+      memory_info_list->SetRangesOfInterest(
+          CollectRangesOfInterest(process_snapshot),
+          compact_memory_info_neighborhood_size_);
+      memory_info_list->SetMergeAdjacentRegions(true);
+    }
     memory_info_list->InitializeFromSnapshot(memory_map_snapshot);
     add_stream_result = AddStream(std::move(memory_info_list));
     DCHECK(add_stream_result);
@@ -193,6 +354,71 @@ void MinidumpFileWriter::InitializeFromSnapshot(
   // file, despite also being mentioned by the memory list stream.
   add_stream_result = AddStream(std::move(memory_list));
   DCHECK(add_stream_result);
+
+  // The memory list stream adds to these streams as it freezes, so they must
+  // follow it.
+  if (zero_memory_list) {
+    add_stream_result = AddStream(std::move(zero_memory_list));
+    DCHECK(add_stream_result);
+  }
+  if (compressed_memory_list) {
+    add_stream_result = AddStream(std::move(compressed_memory_list));
+    DCHECK(add_stream_result);
+  }
+  if (delta) {
+    add_stream_result = AddStream(std::move(delta));
+    DCHECK(add_stream_result);
+  }
+}
+
+void MinidumpFileWriter::SetElideZeroMemory(bool elide_zero_memory) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+
+  elide_zero_memory_ = elide_zero_memory;
+}
+
+void MinidumpFileWriter::SetElideUnpopulatedMemory(
+    bool elide_unpopulated_memory) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+
+  elide_unpopulated_memory_ = elide_unpopulated_memory;
+}
+
+void MinidumpFileWriter::SetCompressMemory(size_t minimum_size,
+                                           uint32_t block_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+  DCHECK_GT(block_size, 0u);
+
+  compressed_memory_minimum_size_ = minimum_size;
+  compressed_memory_block_size_ = block_size;
+}
+
+void MinidumpFileWriter::SetCompactMemoryInfo(bool compact_memory_info,
+                                              uint64_t neighborhood_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+
+  compact_memory_info_ = compact_memory_info;
+  compact_memory_info_neighborhood_size_ = neighborhood_size;
+}
+
+void MinidumpFileWriter::SetRecordDeltaBase(MinidumpDeltaBase* delta_base) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+  DCHECK(!delta_base || !delta_base_);
+
+  record_delta_base_ = delta_base;
+}
+
+void MinidumpFileWriter::SetDeltaBase(const MinidumpDeltaBase* delta_base) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(streams_.empty());
+  DCHECK(!delta_base || !record_delta_base_);
+
+  delta_base_ = delta_base;
 }
 
 void MinidumpFileWriter::SetTimestamp(time_t timestamp) {
@@ -201,6 +427,26 @@ void MinidumpFileWriter::SetTimestamp(time_t timestamp) {
   internal::MinidumpWriterUtil::AssignTimeT(&header_.TimeDateStamp, timestamp);
 }
 
+void MinidumpFileWriter::SetMemoryBufferLimit(size_t memory_buffer_limit) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  memory_buffer_limit_ = memory_buffer_limit;
+}
+
+void MinidumpFileWriter::SetConcurrentMemoryWrites(size_t thread_count,
+                                                   size_t min_size) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  concurrent_write_threads_ = thread_count;
+  concurrent_write_min_size_ = min_size;
+}
+
+void MinidumpFileWriter::SetDeduplicateStrings(bool deduplicate_strings) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  deduplicate_strings_ = deduplicate_strings;
+}
+
 bool MinidumpFileWriter::AddStream(
     std::unique_ptr<internal::MinidumpStreamWriter> stream) {
   DCHECK_EQ(state(), kStateMutable);
@@ -237,6 +483,7 @@ bool MinidumpFileWriter::WriteEverything(FileWriterInterface* file_writer) {
 
 bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
                                        bool allow_seek) {
+  CRASHPAD_TRACE_EVENT("minidump", "MinidumpFileWriter::WriteMinidump");
   DCHECK_EQ(state(), kStateMutable);
 
   FileOffset start_offset = -1;
@@ -249,7 +496,16 @@ bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
     header_.Signature = MINIDUMP_SIGNATURE;
   }
 
-  if (!MinidumpWritable::WriteEverything(file_writer)) {
+  WriteOptions options;
+  options.memory_buffer_limit = memory_buffer_limit_;
+  options.deduplicate_strings = deduplicate_strings_;
+  if (allow_seek) {
+    // Concurrent writes leave room for objects and fill it in later, which
+    // requires seeking.
+    options.concurrent_write_threads = concurrent_write_threads_;
+    options.concurrent_write_min_size = concurrent_write_min_size_;
+  }
+  if (!WriteEverythingWithOptions(file_writer, options)) {
     return false;
   }
 
@@ -280,6 +536,7 @@ bool MinidumpFileWriter::WriteMinidump(FileWriterInterface* file_writer,
 }
 
 bool MinidumpFileWriter::Freeze() {
+  CRASHPAD_TRACE_EVENT("minidump", "MinidumpFileWriter::Freeze");
   DCHECK_EQ(state(), kStateMutable);
 
   if (!MinidumpWritable::Freeze()) {
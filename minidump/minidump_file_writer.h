@@ -17,6 +17,7 @@
 
 #include <windows.h>
 #include <dbghelp.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <memory>
@@ -26,10 +27,12 @@
 #include "minidump/minidump_extensions.h"
 #include "minidump/minidump_stream_writer.h"
 #include "minidump/minidump_writable.h"
+#include "minidump/minidump_writable_arena.h"
 #include "util/file/file_io.h"
 
 namespace crashpad {
 
+class MinidumpDeltaBase;
 class ProcessSnapshot;
 class MinidumpUserExtensionStreamDataSource;
 
@@ -63,13 +66,28 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!  - kMinidumpStreamTypeMiscInfo
   //!  - kMinidumpStreamTypeThreadList
   //!  - kMinidumpStreamTypeException (if present)
-  //!  - kMinidumpStreamTypeModuleList
+  //!  - kMinidumpStreamTypeCrashpadExtendedRegisters (if any thread has
+  //!    extended register state)
+  //!  - kMinidumpStreamTypeCrashpadThreadStats (if any thread has scheduling
+  //!    statistics)
+  //!  - kMinidumpStreamTypeModuleList (unless unchanged since the base set by
+  //!    SetDeltaBase())
   //!  - kMinidumpStreamTypeUnloadedModuleList (if present)
   //!  - kMinidumpStreamTypeCrashpadInfo (if present)
-  //!  - kMinidumpStreamTypeMemoryInfoList (if present)
+  //!  - kMinidumpStreamTypeMemoryInfoList (if present, and unless unchanged
+  //!    since the base set by SetDeltaBase())
   //!  - kMinidumpStreamTypeHandleData (if present)
   //!  - User streams (if present)
   //!  - kMinidumpStreamTypeMemoryList
+  //!  - kMinidumpStreamTypeCrashpadZeroMemoryList (if enabled by
+  //!    SetElideZeroMemory() or SetElideUnpopulatedMemory())
+  //!  - kMinidumpStreamTypeCrashpadCompressedMemoryList (if enabled by
+  //!    SetCompressMemory())
+  //!  - kMinidumpStreamTypeCrashpadDelta (if enabled by SetDeltaBase())
+  //!
+  //! The objects created by this method are allocated from an arena owned by
+  //! this object, and their storage is freed all at once when this object is
+  //! destroyed.
   //!
   //! \param[in] process_snapshot The process snapshot to use as source data.
   //!
@@ -78,11 +96,165 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
   //!     methods after this method.
   void InitializeFromSnapshot(const ProcessSnapshot* process_snapshot);
 
+  //! \brief Omits memory containing only zeroes from the minidump file.
+  //!
+  //! When enabled, InitializeFromSnapshot() arranges for runs of whole pages
+  //! containing only zeroes to be removed from the memory list stream’s
+  //! regions, and for the removed ranges to be recorded in a
+  //! MinidumpZeroMemoryList stream. See
+  //! MinidumpMemoryListWriter::SetZeroMemoryListWriter(). Thread stacks are
+  //! written in their entirety.
+  //!
+  //! \param[in] elide_zero_memory Whether to omit memory containing only
+  //!     zeroes.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  void SetElideZeroMemory(bool elide_zero_memory);
+
+  //! \brief Omits memory that was never populated from the minidump file.
+  //!
+  //! When enabled, InitializeFromSnapshot() arranges for pages that memory
+  //! snapshots report through MemorySnapshot::UnpopulatedRanges() to be
+  //! removed from the memory list stream’s regions, and for the removed ranges
+  //! to be recorded in a MinidumpZeroMemoryList stream. Unlike
+  //! SetElideZeroMemory(), this does not read memory an additional time. See
+  //! MinidumpMemoryListWriter::SetUnpopulatedMemoryListWriter().
+  //!
+  //! \param[in] elide_unpopulated_memory Whether to omit memory that was never
+  //!     populated.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  void SetElideUnpopulatedMemory(bool elide_unpopulated_memory);
+
+  //! \brief Stores large memory regions in the minidump file in compressed
+  //!     form.
+  //!
+  //! When enabled, InitializeFromSnapshot() arranges for memory regions of at
+  //! least \a minimum_size bytes to be moved from the memory list stream to a
+  //! MinidumpCompressedMemoryList stream, in which each region is divided into
+  //! independently compressed blocks of \a block_size bytes. See
+  //! MinidumpMemoryListWriter::SetCompressedMemoryListWriter(). Thread stacks
+  //! are never compressed.
+  //!
+  //! \param[in] minimum_size The size of the smallest region to compress, in
+  //!     bytes, or `0` to disable compression.
+  //! \param[in] block_size The size of each block before compression, in
+  //!     bytes. Must be greater than `0`, and no greater than
+  //!     MinidumpCompressedMemoryRange::kMaxBlockSize.
+  //!     MinidumpCompressedMemoryListWriter::kDefaultBlockSize is a reasonable
+  //!     choice.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  void SetCompressMemory(size_t minimum_size, uint32_t block_size);
+
+  //! \brief Limits the memory info list stream to the regions needed for
+  //!     triage.
+  //!
+  //! When enabled, InitializeFromSnapshot() omits memory map regions farther
+  //! than \a neighborhood_size bytes from every thread stack, stack pointer,
+  //! instruction pointer, module, exception address, and extra memory range
+  //! in the snapshot, and combines adjacent regions with identical attributes.
+  //! See MinidumpMemoryInfoListWriter::SetRangesOfInterest() and
+  //! MinidumpMemoryInfoListWriter::SetMergeAdjacentRegions().
+  //!
+  //! \param[in] compact_memory_info Whether to filter and combine memory map
+  //!     regions.
+  //! \param[in] neighborhood_size The distance, in bytes, from an address of
+  //!     interest within which a region is retained.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  void SetCompactMemoryInfo(bool compact_memory_info,
+                            uint64_t neighborhood_size);
+
+  //! \brief Records what the minidump file holds in \a delta_base, so that
+  //!     later minidump files of the same process may be written as deltas
+  //!     against it.
+  //!
+  //! When set, InitializeFromSnapshot() sets \a delta_base’s report ID and
+  //! digests from the process snapshot, and arranges for the hashes of the
+  //! memory list stream’s pages to replace any already recorded in it as the
+  //! minidump file is written. See
+  //! MinidumpMemoryListWriter::SetPageHashRecorder(). \a delta_base is
+  //! complete once the minidump file has been written successfully.
+  //!
+  //! \param[in] delta_base The object to record in, or `nullptr`. This object
+  //!     does not take ownership of it, and it must outlive this object.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  //!     This may not be used together with SetDeltaBase().
+  void SetRecordDeltaBase(MinidumpDeltaBase* delta_base);
+
+  //! \brief Writes the minidump file as a delta against the earlier minidump
+  //!     file of the same process that \a delta_base was recorded from.
+  //!
+  //! When set, InitializeFromSnapshot() omits the module list stream if the
+  //! process’ modules are unchanged, omits the memory info list stream if its
+  //! memory map is unchanged, and arranges for whole pages of memory whose
+  //! contents are unchanged to be removed from the memory list stream’s
+  //! regions. What was omitted is recorded in a MinidumpDelta stream, which
+  //! refers to the base by its report ID. See
+  //! MinidumpMemoryListWriter::SetDeltaBase(). Thread stacks are written in
+  //! their entirety.
+  //!
+  //! \param[in] delta_base The base, recorded by SetRecordDeltaBase(), or
+  //!     `nullptr`. This object does not take ownership of it, and it must
+  //!     outlive this object.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  //!     This may not be used together with SetRecordDeltaBase().
+  void SetDeltaBase(const MinidumpDeltaBase* delta_base);
+
   //! \brief Sets MINIDUMP_HEADER::Timestamp.
   //!
   //! \note Valid in #kStateMutable.
   void SetTimestamp(time_t timestamp);
 
+  //! \brief Limits the amount of memory snapshot data held at once while the
+  //!     minidump file is written.
+  //!
+  //! By default, each memory snapshot is read in its entirety before it is
+  //! written, so the size of the largest memory region determines the peak
+  //! memory usage while writing. When a limit is set, memory snapshots larger
+  //! than the limit are read and written in pieces no larger than it. The
+  //! contents of the minidump file are unaffected.
+  //!
+  //! \param[in] memory_buffer_limit The maximum size, in bytes, of memory
+  //!     snapshot data to hold at once, or `0` for no limit.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetMemoryBufferLimit(size_t memory_buffer_limit);
+
+  //! \brief Writes the contents of large memory snapshots concurrently.
+  //!
+  //! By default, the minidump file is written serially. When a thread count is
+  //! set and the file writer supports FileWriterInterface::WriteAtOffset(),
+  //! memory snapshots of at least \a min_size bytes are instead read and
+  //! written at their offsets from a pool of threads, after everything else
+  //! has been written. The contents of the minidump file are unaffected.
+  //!
+  //! This must only be used when MemorySnapshot::Read() is safe to call from
+  //! multiple threads at once for every memory snapshot in the minidump.
+  //!
+  //! \param[in] thread_count The number of threads to write with, or `0` to
+  //!     write serially.
+  //! \param[in] min_size The minimum size, in bytes, of a memory snapshot to
+  //!     write concurrently.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetConcurrentMemoryWrites(size_t thread_count, size_t min_size);
+
+  //! \brief Writes identical strings to the minidump file once.
+  //!
+  //! By default, each string, such as a module name or annotation name, is
+  //! written separately wherever it appears. When enabled, identical strings
+  //! are written once, and every structure referring to one of them points to
+  //! the same copy.
+  //!
+  //! \param[in] deduplicate_strings Whether to write identical strings once.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetDeduplicateStrings(bool deduplicate_strings);
+
   //! \brief Adds a stream to the minidump file and arranges for a
   //!     MINIDUMP_DIRECTORY entry to point to it.
   //!
@@ -162,10 +334,29 @@ class MinidumpFileWriter final : public internal::MinidumpWritable {
 
  private:
   MINIDUMP_HEADER header_;
+
+  // Provides storage for the objects created by InitializeFromSnapshot(). This
+  // must be declared before any member that owns those objects, so that it is
+  // destroyed after them.
+  internal::MinidumpWritableArena arena_;
+
   std::vector<std::unique_ptr<internal::MinidumpStreamWriter>> streams_;
 
   // Protects against multiple streams with the same ID being added.
   std::set<MinidumpStreamType> stream_types_;
+
+  size_t memory_buffer_limit_;
+  size_t concurrent_write_threads_;
+  size_t concurrent_write_min_size_;
+  bool deduplicate_strings_;
+  size_t compressed_memory_minimum_size_;
+  uint32_t compressed_memory_block_size_;
+  uint64_t compact_memory_info_neighborhood_size_;
+  MinidumpDeltaBase* record_delta_base_;  // weak
+  const MinidumpDeltaBase* delta_base_;  // weak
+  bool elide_zero_memory_;
+  bool elide_unpopulated_memory_;
+  bool compact_memory_info_;
 };
 
 }  // namespace crashpad
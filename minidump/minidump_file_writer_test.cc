@@ -21,8 +21,10 @@
 #include <string>
 #include <utility>
 
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "gtest/gtest.h"
+#include "minidump/minidump_delta_base.h"
 #include "minidump/minidump_stream_writer.h"
 #include "minidump/minidump_user_extension_stream_data_source.h"
 #include "minidump/test/minidump_file_writer_test_util.h"
@@ -30,6 +32,7 @@
 #include "minidump/test/minidump_writable_test_util.h"
 #include "snapshot/test/test_cpu_context.h"
 #include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_map_region_snapshot.h"
 #include "snapshot/test/test_memory_snapshot.h"
 #include "snapshot/test/test_module_snapshot.h"
 #include "snapshot/test/test_process_snapshot.h"
@@ -413,6 +416,266 @@ TEST(MinidumpFileWriter, InitializeFromSnapshot_Basic) {
   EXPECT_EQ(memory_list->MemoryRanges[0].Memory.DataSize, kPebSize);
 }
 
+TEST(MinidumpFileWriter, InitializeFromSnapshot_MemoryBufferLimit) {
+  constexpr uint32_t kSnapshotTime = 0x4976043c;
+  constexpr timeval kSnapshotTimeval = {static_cast<time_t>(kSnapshotTime), 0};
+  constexpr uint64_t kPebAddress = 0x07f90000;
+  constexpr size_t kPebSize = 0x280;
+
+  std::string minidumps[2];
+  for (size_t index = 0; index < std::size(minidumps); ++index) {
+    SCOPED_TRACE(index);
+
+    TestProcessSnapshot process_snapshot;
+    process_snapshot.SetSnapshotTime(kSnapshotTimeval);
+
+    auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+    system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+    system_snapshot->SetOperatingSystem(
+        SystemSnapshot::kOperatingSystemMacOSX);
+    process_snapshot.SetSystem(std::move(system_snapshot));
+
+    auto peb_snapshot = std::make_unique<TestMemorySnapshot>();
+    peb_snapshot->SetAddress(kPebAddress);
+    peb_snapshot->SetSize(kPebSize);
+    peb_snapshot->SetValue('p');
+    process_snapshot.AddExtraMemory(std::move(peb_snapshot));
+
+    MinidumpFileWriter minidump_file_writer;
+    minidump_file_writer.InitializeFromSnapshot(&process_snapshot);
+
+    // The second minidump is written with a limit smaller than the memory
+    // snapshot, and must not differ from the first.
+    if (index == 1) {
+      minidump_file_writer.SetMemoryBufferLimit(0x100);
+    }
+
+    StringFile string_file;
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+    minidumps[index] = string_file.string();
+  }
+
+  EXPECT_EQ(minidumps[1], minidumps[0]);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(minidumps[1], &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 5, kSnapshotTime));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[4].StreamType, kMinidumpStreamTypeMemoryList);
+  const MINIDUMP_MEMORY_LIST* memory_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+          minidumps[1], directory[4].Location);
+  ASSERT_TRUE(memory_list);
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1u);
+  EXPECT_EQ(memory_list->MemoryRanges[0].Memory.DataSize, kPebSize);
+  EXPECT_EQ(minidumps[1].substr(memory_list->MemoryRanges[0].Memory.Rva,
+                                kPebSize),
+            std::string(kPebSize, 'p'));
+}
+
+// A StringFile that supports FileWriterInterface::WriteAtOffset().
+class StringFileWithWriteAtOffset final : public StringFile {
+ public:
+  StringFileWithWriteAtOffset() : StringFile(), lock_(), writes_at_offset_(0) {}
+
+  StringFileWithWriteAtOffset(const StringFileWithWriteAtOffset&) = delete;
+  StringFileWithWriteAtOffset& operator=(const StringFileWithWriteAtOffset&) =
+      delete;
+
+  ~StringFileWithWriteAtOffset() override = default;
+
+  size_t writes_at_offset() const { return writes_at_offset_; }
+
+  // FileWriterInterface:
+
+  bool SupportsWriteAtOffset() const override { return true; }
+
+  bool WriteAtOffset(FileOffset offset,
+                     const void* data,
+                     size_t size) override {
+    base::AutoLock lock(lock_);
+    ++writes_at_offset_;
+    return SeekSet(offset) && Write(data, size);
+  }
+
+ private:
+  base::Lock lock_;
+  size_t writes_at_offset_;
+};
+
+TEST(MinidumpFileWriter, InitializeFromSnapshot_ConcurrentMemoryWrites) {
+  constexpr uint32_t kSnapshotTime = 0x4976043c;
+  constexpr timeval kSnapshotTimeval = {static_cast<time_t>(kSnapshotTime), 0};
+  constexpr struct {
+    uint64_t address;
+    size_t size;
+    char value;
+  } kRanges[] = {
+      {0x07f90000, 0x280, 'p'},
+      {0x10000000, 0x80, 's'},
+      {0x20000000, 0x3000, 'q'},
+      {0x30000000, 0x1001, 'r'},
+  };
+
+  std::string minidumps[2];
+  for (size_t index = 0; index < std::size(minidumps); ++index) {
+    SCOPED_TRACE(index);
+
+    TestProcessSnapshot process_snapshot;
+    process_snapshot.SetSnapshotTime(kSnapshotTimeval);
+
+    auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+    system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+    system_snapshot->SetOperatingSystem(
+        SystemSnapshot::kOperatingSystemMacOSX);
+    process_snapshot.SetSystem(std::move(system_snapshot));
+
+    for (const auto& range : kRanges) {
+      auto memory_snapshot = std::make_unique<TestMemorySnapshot>();
+      memory_snapshot->SetAddress(range.address);
+      memory_snapshot->SetSize(range.size);
+      memory_snapshot->SetValue(range.value);
+      process_snapshot.AddExtraMemory(std::move(memory_snapshot));
+    }
+
+    MinidumpFileWriter minidump_file_writer;
+    minidump_file_writer.InitializeFromSnapshot(&process_snapshot);
+
+    // The second minidump writes the three larger ranges concurrently, and
+    // must not differ from the first.
+    if (index == 1) {
+      minidump_file_writer.SetConcurrentMemoryWrites(2, 0x100);
+    }
+
+    StringFileWithWriteAtOffset string_file;
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+    EXPECT_EQ(string_file.writes_at_offset(), index == 1 ? 3u : 0u);
+    EXPECT_EQ(string_file.Seek(0, SEEK_CUR),
+              static_cast<FileOffset>(string_file.string().size()));
+    minidumps[index] = string_file.string();
+  }
+
+  EXPECT_EQ(minidumps[1], minidumps[0]);
+}
+
+TEST(MinidumpFileWriter, InitializeFromSnapshot_Delta) {
+  constexpr uint64_t kUnchangedAddress = 0x10000;
+  constexpr size_t kUnchangedSize = 0x2000;
+  constexpr uint64_t kChangedAddress = 0x20000;
+  constexpr size_t kChangedSize = 0x1000;
+
+  UUID base_report_id;
+  ASSERT_TRUE(base_report_id.InitializeWithNew());
+
+  // The same process is snapshotted twice. Only the contents of the memory at
+  // kChangedAddress differ.
+  auto snapshot_process = [&](char changed_value,
+                              TestProcessSnapshot* process_snapshot) {
+    process_snapshot->SetReportID(base_report_id);
+
+    auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+    system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+    system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+    process_snapshot->SetSystem(std::move(system_snapshot));
+
+    auto module_snapshot = std::make_unique<TestModuleSnapshot>();
+    module_snapshot->SetName("module");
+    module_snapshot->SetAddressAndSize(0x40000, 0x1000);
+    process_snapshot->AddModule(std::move(module_snapshot));
+
+    MINIDUMP_MEMORY_INFO memory_info = {};
+    memory_info.BaseAddress = kUnchangedAddress;
+    memory_info.RegionSize = kChangedAddress + kChangedSize - kUnchangedAddress;
+    auto region_snapshot = std::make_unique<TestMemoryMapRegionSnapshot>();
+    region_snapshot->SetMindumpMemoryInfo(memory_info);
+    process_snapshot->AddMemoryMapRegion(std::move(region_snapshot));
+
+    auto unchanged_snapshot = std::make_unique<TestMemorySnapshot>();
+    unchanged_snapshot->SetAddress(kUnchangedAddress);
+    unchanged_snapshot->SetSize(kUnchangedSize);
+    unchanged_snapshot->SetValue('u');
+    process_snapshot->AddExtraMemory(std::move(unchanged_snapshot));
+
+    auto changed_snapshot = std::make_unique<TestMemorySnapshot>();
+    changed_snapshot->SetAddress(kChangedAddress);
+    changed_snapshot->SetSize(kChangedSize);
+    changed_snapshot->SetValue(changed_value);
+    process_snapshot->AddExtraMemory(std::move(changed_snapshot));
+  };
+
+  MinidumpDeltaBase base;
+  {
+    TestProcessSnapshot process_snapshot;
+    snapshot_process('a', &process_snapshot);
+
+    MinidumpFileWriter minidump_file_writer;
+    minidump_file_writer.SetRecordDeltaBase(&base);
+    minidump_file_writer.InitializeFromSnapshot(&process_snapshot);
+
+    StringFile string_file;
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+    const MINIDUMP_DIRECTORY* directory;
+    const MINIDUMP_HEADER* header =
+        MinidumpHeaderAtStart(string_file.string(), &directory);
+    ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 7, 0));
+    ASSERT_TRUE(directory);
+    EXPECT_EQ(directory[3].StreamType, kMinidumpStreamTypeModuleList);
+    EXPECT_EQ(directory[4].StreamType, kMinidumpStreamTypeCrashpadInfo);
+    EXPECT_EQ(directory[5].StreamType, kMinidumpStreamTypeMemoryInfoList);
+    EXPECT_EQ(directory[6].StreamType, kMinidumpStreamTypeMemoryList);
+  }
+  EXPECT_EQ(base.report_id(), base_report_id);
+  EXPECT_EQ(base.page_count(), 3u);
+
+  TestProcessSnapshot process_snapshot;
+  snapshot_process('b', &process_snapshot);
+
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.SetDeltaBase(&base);
+  minidump_file_writer.InitializeFromSnapshot(&process_snapshot);
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 6, 0));
+  ASSERT_TRUE(directory);
+
+  // The module list and memory info list streams are omitted.
+  EXPECT_EQ(directory[0].StreamType, kMinidumpStreamTypeSystemInfo);
+  EXPECT_EQ(directory[1].StreamType, kMinidumpStreamTypeMiscInfo);
+  EXPECT_EQ(directory[2].StreamType, kMinidumpStreamTypeThreadList);
+  EXPECT_EQ(directory[3].StreamType, kMinidumpStreamTypeCrashpadInfo);
+
+  ASSERT_EQ(directory[4].StreamType, kMinidumpStreamTypeMemoryList);
+  const MINIDUMP_MEMORY_LIST* memory_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+          string_file.string(), directory[4].Location);
+  ASSERT_TRUE(memory_list);
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1u);
+  EXPECT_EQ(memory_list->MemoryRanges[0].StartOfMemoryRange, kChangedAddress);
+  EXPECT_EQ(memory_list->MemoryRanges[0].Memory.DataSize, kChangedSize);
+
+  ASSERT_EQ(directory[5].StreamType, kMinidumpStreamTypeCrashpadDelta);
+  const MinidumpDelta* delta =
+      MinidumpWritableAtLocationDescriptor<MinidumpDelta>(
+          string_file.string(), directory[5].Location);
+  ASSERT_TRUE(delta);
+  EXPECT_EQ(delta->version, MinidumpDelta::kVersion);
+  EXPECT_EQ(delta->base_report_id, base_report_id);
+  EXPECT_EQ(delta->flags,
+            kMinidumpDeltaModuleListOmitted |
+                kMinidumpDeltaMemoryInfoListOmitted);
+  ASSERT_EQ(delta->count, 1u);
+  EXPECT_EQ(delta->ranges[0].start_of_memory_range, kUnchangedAddress);
+  EXPECT_EQ(delta->ranges[0].data_size, kUnchangedSize);
+}
+
 TEST(MinidumpFileWriter, InitializeFromSnapshot_Exception) {
   // In a 32-bit environment, this will give a “timestamp out of range” warning,
   // but the test should complete without failure.
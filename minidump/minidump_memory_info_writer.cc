@@ -14,26 +14,117 @@
 
 #include "minidump/minidump_memory_info_writer.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "base/check_op.h"
 #include "snapshot/memory_map_region_snapshot.h"
 #include "util/file/file_writer.h"
 
 namespace crashpad {
 
+namespace {
+
+uint64_t SaturatingAdd(uint64_t a, uint64_t b) {
+  return b > std::numeric_limits<uint64_t>::max() - a
+             ? std::numeric_limits<uint64_t>::max()
+             : a + b;
+}
+
+bool CanMerge(const MINIDUMP_MEMORY_INFO& previous,
+              const MINIDUMP_MEMORY_INFO& next) {
+  return previous.BaseAddress + previous.RegionSize == next.BaseAddress &&
+         previous.AllocationBase == next.AllocationBase &&
+         previous.AllocationProtect == next.AllocationProtect &&
+         previous.State == next.State && previous.Protect == next.Protect &&
+         previous.Type == next.Type;
+}
+
+}  // namespace
+
 MinidumpMemoryInfoListWriter::MinidumpMemoryInfoListWriter()
-    : memory_info_list_base_(), items_() {
+    : memory_info_list_base_(),
+      items_(),
+      intervals_of_interest_(),
+      merge_adjacent_regions_(false) {
 }
 
 MinidumpMemoryInfoListWriter::~MinidumpMemoryInfoListWriter() {
 }
 
+void MinidumpMemoryInfoListWriter::SetMergeAdjacentRegions(
+    bool merge_adjacent_regions) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(items_.empty());
+
+  merge_adjacent_regions_ = merge_adjacent_regions;
+}
+
+void MinidumpMemoryInfoListWriter::SetRangesOfInterest(
+    const std::vector<CheckedRange<uint64_t>>& ranges,
+    uint64_t neighborhood_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(items_.empty());
+
+  std::vector<std::pair<uint64_t, uint64_t>> intervals;
+  intervals.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    // An empty range denotes a single address of interest.
+    uint64_t size = std::max<uint64_t>(range.size(), 1);
+    uint64_t begin =
+        range.base() > neighborhood_size ? range.base() - neighborhood_size : 0;
+    uint64_t end = SaturatingAdd(SaturatingAdd(range.base(), size),
+                                 neighborhood_size);
+    intervals.emplace_back(begin, end);
+  }
+  std::sort(intervals.begin(), intervals.end());
+
+  intervals_of_interest_.clear();
+  for (const auto& interval : intervals) {
+    if (!intervals_of_interest_.empty() &&
+        interval.first <= intervals_of_interest_.back().second) {
+      intervals_of_interest_.back().second =
+          std::max(intervals_of_interest_.back().second, interval.second);
+    } else {
+      intervals_of_interest_.push_back(interval);
+    }
+  }
+}
+
 void MinidumpMemoryInfoListWriter::InitializeFromSnapshot(
     const std::vector<const MemoryMapRegionSnapshot*>& memory_map) {
   DCHECK_EQ(state(), kStateMutable);
 
   DCHECK(items_.empty());
-  for (const auto& region : memory_map)
-    items_.push_back(region->AsMinidumpMemoryInfo());
+  for (const auto& region : memory_map) {
+    MINIDUMP_MEMORY_INFO memory_info = region->AsMinidumpMemoryInfo();
+
+    if (!intervals_of_interest_.empty()) {
+      // Find the first interval that ends after the region begins, and retain
+      // the region only if that interval also begins before the region ends.
+      uint64_t region_end =
+          SaturatingAdd(memory_info.BaseAddress, memory_info.RegionSize);
+      auto interval = std::upper_bound(
+          intervals_of_interest_.begin(),
+          intervals_of_interest_.end(),
+          memory_info.BaseAddress,
+          [](uint64_t address, const std::pair<uint64_t, uint64_t>& interval) {
+            return address < interval.second;
+          });
+      if (interval == intervals_of_interest_.end() ||
+          interval->first >= region_end) {
+        continue;
+      }
+    }
+
+    if (merge_adjacent_regions_ && !items_.empty() &&
+        CanMerge(items_.back(), memory_info)) {
+      items_.back().RegionSize += memory_info.RegionSize;
+      continue;
+    }
+
+    items_.push_back(memory_info);
+  }
 }
 
 bool MinidumpMemoryInfoListWriter::Freeze() {
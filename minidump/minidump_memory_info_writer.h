@@ -20,10 +20,12 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <utility>
 #include <vector>
 
 #include "minidump/minidump_stream_writer.h"
 #include "minidump/minidump_writable.h"
+#include "util/numeric/checked_range.h"
 
 namespace crashpad {
 
@@ -45,6 +47,33 @@ class MinidumpMemoryInfoListWriter final
 
   ~MinidumpMemoryInfoListWriter() override;
 
+  //! \brief Combines adjacent regions with identical attributes into a single
+  //!     MINIDUMP_MEMORY_INFO entry.
+  //!
+  //! Regions are combined when one begins where the previous one ends and
+  //! their allocation base, allocation protection, state, protection, and type
+  //! are all equal.
+  //!
+  //! \param[in] merge_adjacent_regions Whether to combine adjacent regions.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  void SetMergeAdjacentRegions(bool merge_adjacent_regions);
+
+  //! \brief Restricts the list to regions near ranges of interest.
+  //!
+  //! When set, InitializeFromSnapshot() omits every region that is farther
+  //! than \a neighborhood_size bytes from all of \a ranges. Regions are
+  //! filtered before they are combined by SetMergeAdjacentRegions().
+  //!
+  //! \param[in] ranges The address ranges of interest, in any order. If empty,
+  //!     no regions are omitted.
+  //! \param[in] neighborhood_size The distance, in bytes, from a range of
+  //!     interest within which a region is retained.
+  //!
+  //! \note Valid in #kStateMutable, before InitializeFromSnapshot() is called.
+  void SetRangesOfInterest(const std::vector<CheckedRange<uint64_t>>& ranges,
+                           uint64_t neighborhood_size);
+
   //! \brief Initializes a MINIDUMP_MEMORY_INFO_LIST based on \a memory_map.
   //!
   //! \param[in] memory_map The vector of memory map region snapshots to use as
@@ -67,6 +96,11 @@ class MinidumpMemoryInfoListWriter final
  private:
   MINIDUMP_MEMORY_INFO_LIST memory_info_list_base_;
   std::vector<MINIDUMP_MEMORY_INFO> items_;
+
+  // Sorted, disjoint [begin, end) intervals covering the ranges of interest
+  // and their neighborhoods. Empty when no filtering is requested.
+  std::vector<std::pair<uint64_t, uint64_t>> intervals_of_interest_;
+  bool merge_adjacent_regions_;
 };
 
 }  // namespace crashpad
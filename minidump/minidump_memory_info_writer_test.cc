@@ -136,6 +136,117 @@ TEST(MinidumpMemoryInfoWriter, OneRegion) {
   EXPECT_EQ(memory_info.Type, mmi.Type);
 }
 
+MINIDUMP_MEMORY_INFO MakeMemoryInfo(uint64_t base,
+                                    uint64_t size,
+                                    uint32_t protect) {
+  MINIDUMP_MEMORY_INFO mmi = {};
+  mmi.BaseAddress = base;
+  mmi.AllocationBase = 0x10000000;
+  mmi.AllocationProtect = PAGE_READWRITE;
+  mmi.RegionSize = size;
+  mmi.State = MEM_COMMIT;
+  mmi.Protect = protect;
+  mmi.Type = MEM_PRIVATE;
+  return mmi;
+}
+
+// Writes the regions described by |infos| through |memory_info_list_writer|
+// and returns the entries that were written.
+void WriteAndReadBack(
+    std::unique_ptr<MinidumpMemoryInfoListWriter> memory_info_list_writer,
+    const std::vector<MINIDUMP_MEMORY_INFO>& infos,
+    std::vector<MINIDUMP_MEMORY_INFO>* written) {
+  std::vector<std::unique_ptr<TestMemoryMapRegionSnapshot>> regions;
+  std::vector<const MemoryMapRegionSnapshot*> memory_map;
+  for (const auto& info : infos) {
+    regions.push_back(std::make_unique<TestMemoryMapRegionSnapshot>());
+    regions.back()->SetMindumpMemoryInfo(info);
+    memory_map.push_back(regions.back().get());
+  }
+  memory_info_list_writer->InitializeFromSnapshot(memory_map);
+
+  MinidumpFileWriter minidump_file_writer;
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(memory_info_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_INFO_LIST* memory_info_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryInfoListStream(string_file.string(), &memory_info_list));
+
+  uint64_t number_of_entries;
+  memcpy(&number_of_entries,
+         &memory_info_list->NumberOfEntries,
+         sizeof(number_of_entries));
+  written->resize(number_of_entries);
+  if (number_of_entries) {
+    memcpy(written->data(),
+           &memory_info_list[1],
+           sizeof(MINIDUMP_MEMORY_INFO) * number_of_entries);
+  }
+}
+
+TEST(MinidumpMemoryInfoWriter, MergeAdjacentRegions) {
+  auto memory_info_list_writer =
+      std::make_unique<MinidumpMemoryInfoListWriter>();
+  memory_info_list_writer->SetMergeAdjacentRegions(true);
+
+  std::vector<MINIDUMP_MEMORY_INFO> infos;
+  infos.push_back(MakeMemoryInfo(0x10000000, 0x1000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x10001000, 0x2000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x10003000, 0x1000, PAGE_READWRITE));
+  // Different protection.
+  infos.push_back(MakeMemoryInfo(0x10004000, 0x1000, PAGE_READONLY));
+  // Not adjacent.
+  infos.push_back(MakeMemoryInfo(0x10006000, 0x1000, PAGE_READONLY));
+
+  std::vector<MINIDUMP_MEMORY_INFO> written;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteAndReadBack(std::move(memory_info_list_writer), infos, &written));
+
+  ASSERT_EQ(written.size(), 3u);
+  EXPECT_EQ(written[0].BaseAddress, 0x10000000u);
+  EXPECT_EQ(written[0].RegionSize, 0x4000u);
+  EXPECT_EQ(written[0].Protect, static_cast<uint32_t>(PAGE_READWRITE));
+  EXPECT_EQ(written[1].BaseAddress, 0x10004000u);
+  EXPECT_EQ(written[1].RegionSize, 0x1000u);
+  EXPECT_EQ(written[2].BaseAddress, 0x10006000u);
+  EXPECT_EQ(written[2].RegionSize, 0x1000u);
+}
+
+TEST(MinidumpMemoryInfoWriter, RangesOfInterest) {
+  auto memory_info_list_writer =
+      std::make_unique<MinidumpMemoryInfoListWriter>();
+
+  std::vector<CheckedRange<uint64_t>> ranges;
+  // A single address inside the second region.
+  ranges.emplace_back(0x20001800, 0);
+  // A range that ends 0x80 bytes before the fifth region.
+  ranges.emplace_back(0x20008000, 0x1f80);
+  memory_info_list_writer->SetRangesOfInterest(ranges, 0x100);
+  memory_info_list_writer->SetMergeAdjacentRegions(true);
+
+  std::vector<MINIDUMP_MEMORY_INFO> infos;
+  infos.push_back(MakeMemoryInfo(0x20000000, 0x1000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x20001000, 0x1000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x20002000, 0x1000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x20004000, 0x1000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x2000a000, 0x1000, PAGE_READWRITE));
+  infos.push_back(MakeMemoryInfo(0x2000c000, 0x1000, PAGE_READWRITE));
+
+  std::vector<MINIDUMP_MEMORY_INFO> written;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteAndReadBack(std::move(memory_info_list_writer), infos, &written));
+
+  ASSERT_EQ(written.size(), 2u);
+  EXPECT_EQ(written[0].BaseAddress, 0x20001000u);
+  EXPECT_EQ(written[0].RegionSize, 0x1000u);
+  EXPECT_EQ(written[1].BaseAddress, 0x2000a000u);
+  EXPECT_EQ(written[1].RegionSize, 0x1000u);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -14,18 +14,308 @@
 
 #include "minidump/minidump_memory_writer.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <iterator>
+#include <optional>
 #include <utility>
 
 #include "base/auto_reset.h"
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "minidump/minidump_compressed_memory_list_writer.h"
+#include "minidump/minidump_delta_base.h"
+#include "minidump/minidump_delta_writer.h"
+#include "minidump/minidump_zero_memory_list_writer.h"
 #include "util/file/file_writer.h"
+#include "util/misc/xxhash64.h"
 #include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
 
+namespace {
+
+// Passes on the part of the data it receives that falls within a window.
+// Successive calls must provide consecutive pieces of a snapshot's data, as
+// MemorySnapshot::Read() and MemorySnapshot::ReadInChunks() do.
+class WindowDelegate final : public MemorySnapshot::Delegate {
+ public:
+  WindowDelegate(MemorySnapshot::Delegate* delegate,
+                 size_t offset,
+                 size_t size)
+      : delegate_(delegate), offset_(offset), size_(size), position_(0) {}
+
+  WindowDelegate(const WindowDelegate&) = delete;
+  WindowDelegate& operator=(const WindowDelegate&) = delete;
+
+  ~WindowDelegate() override {}
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const size_t data_begin = position_;
+    position_ += size;
+    const size_t begin = std::max(data_begin, offset_);
+    const size_t end = std::min(position_, offset_ + size_);
+    if (begin >= end) {
+      return true;
+    }
+    return delegate_->MemorySnapshotDelegateRead(
+        static_cast<uint8_t*>(data) + (begin - data_begin), end - begin);
+  }
+
+ private:
+  MemorySnapshot::Delegate* delegate_;  // weak
+  size_t offset_;
+  size_t size_;
+  size_t position_;
+};
+
+// A MemorySnapshot for part of another MemorySnapshot.
+class MemorySnapshotSlice final : public MemorySnapshot {
+ public:
+  MemorySnapshotSlice(const MemorySnapshot* snapshot,
+                      uint64_t address,
+                      size_t size)
+      : MemorySnapshot(), snapshot_(snapshot), address_(address), size_(size) {
+    DCHECK_GE(address_, snapshot_->Address());
+    DCHECK_LE(address_ - snapshot_->Address() + size_, snapshot_->Size());
+  }
+
+  MemorySnapshotSlice(const MemorySnapshotSlice&) = delete;
+  MemorySnapshotSlice& operator=(const MemorySnapshotSlice&) = delete;
+
+  ~MemorySnapshotSlice() override {}
+
+  // MemorySnapshot:
+  uint64_t Address() const override { return address_; }
+  size_t Size() const override { return size_; }
+
+  bool Read(Delegate* delegate) const override {
+    WindowDelegate window(
+        delegate, static_cast<size_t>(address_ - snapshot_->Address()), size_);
+    return snapshot_->Read(&window);
+  }
+
+  bool ReadInChunks(Delegate* delegate, size_t chunk_size) const override {
+    WindowDelegate window(
+        delegate, static_cast<size_t>(address_ - snapshot_->Address()), size_);
+    return snapshot_->ReadInChunks(&window, chunk_size);
+  }
+
+  std::vector<CheckedRange<uint64_t, size_t>> UnpopulatedRanges()
+      const override {
+    std::vector<CheckedRange<uint64_t, size_t>> ranges;
+    const uint64_t end = address_ + size_;
+    for (const auto& range : snapshot_->UnpopulatedRanges()) {
+      const uint64_t begin = std::max(range.base(), address_);
+      const uint64_t range_end = std::min(range.end(), end);
+      if (begin < range_end) {
+        ranges.emplace_back(begin, static_cast<size_t>(range_end - begin));
+      }
+    }
+    return ranges;
+  }
+
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    LOG(ERROR) << "slices can't be merged";
+    return nullptr;
+  }
+
+ private:
+  const MemorySnapshot* snapshot_;  // weak
+  uint64_t address_;
+  size_t size_;
+};
+
+// The granularity at which memory containing only zeroes is omitted.
+constexpr uint64_t kZeroPageSize = 4096;
+
+// Returns whether the size bytes at data are all zero. Blocks of words are
+// combined with bitwise OR, without branching, so that this can be vectorized.
+bool IsAllZero(const uint8_t* data, size_t size) {
+  constexpr size_t kBlockWords = 32;
+  while (size >= kBlockWords * sizeof(uint64_t)) {
+    uint64_t words[kBlockWords];
+    memcpy(words, data, sizeof(words));
+    uint64_t accumulated = 0;
+    for (uint64_t word : words) {
+      accumulated |= word;
+    }
+    if (accumulated != 0) {
+      return false;
+    }
+    data += sizeof(words);
+    size -= sizeof(words);
+  }
+
+  uint8_t accumulated = 0;
+  for (size_t index = 0; index < size; ++index) {
+    accumulated |= data[index];
+  }
+  return accumulated == 0;
+}
+
+// Finds the runs of whole, aligned pages of a snapshot that contain only
+// zeroes. Successive calls must provide consecutive pieces of the snapshot's
+// data, as MemorySnapshot::Read() and MemorySnapshot::ReadInChunks() do.
+class ZeroPageScanner final : public MemorySnapshot::Delegate {
+ public:
+  struct Range {
+    uint64_t begin;
+    uint64_t end;
+  };
+
+  explicit ZeroPageScanner(uint64_t address)
+      : runs_(), begin_(address), position_(address), page_is_zero_(true) {}
+
+  ZeroPageScanner(const ZeroPageScanner&) = delete;
+  ZeroPageScanner& operator=(const ZeroPageScanner&) = delete;
+
+  ~ZeroPageScanner() override {}
+
+  const std::vector<Range>& runs() const { return runs_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+      const size_t piece = static_cast<size_t>(std::min<uint64_t>(
+          size, kZeroPageSize - position_ % kZeroPageSize));
+      page_is_zero_ = page_is_zero_ && IsAllZero(bytes, piece);
+      bytes += piece;
+      size -= piece;
+      position_ += piece;
+
+      // A page that begins before the snapshot, or that extends beyond its
+      // end and is therefore never completed, is not whole.
+      if (position_ % kZeroPageSize == 0) {
+        const uint64_t page_begin = position_ - kZeroPageSize;
+        if (page_is_zero_ && page_begin >= begin_) {
+          if (!runs_.empty() && runs_.back().end == page_begin) {
+            runs_.back().end = position_;
+          } else {
+            runs_.push_back({page_begin, position_});
+          }
+        }
+        page_is_zero_ = true;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::vector<Range> runs_;
+  uint64_t begin_;
+  uint64_t position_;
+  bool page_is_zero_;
+};
+
+// Returns the runs of whole, aligned pages of a snapshot that it reports as
+// never populated.
+std::vector<ZeroPageScanner::Range> UnpopulatedPages(
+    const MemorySnapshot* snapshot) {
+  std::vector<ZeroPageScanner::Range> runs;
+  for (const auto& range : snapshot->UnpopulatedRanges()) {
+    const uint64_t begin =
+        (range.base() + kZeroPageSize - 1) & ~(kZeroPageSize - 1);
+    const uint64_t end = range.end() & ~(kZeroPageSize - 1);
+    if (begin < end) {
+      runs.push_back({begin, end});
+    }
+  }
+  return runs;
+}
+
+// Computes the MinidumpDeltaBase::HashPage() of each whole, aligned page of a
+// snapshot. Successive calls must provide consecutive pieces of the snapshot's
+// data, as MemorySnapshot::Read() and MemorySnapshot::ReadInChunks() do.
+class PageHashScanner final : public MemorySnapshot::Delegate {
+ public:
+  struct Page {
+    uint64_t address;
+    uint64_t hash;
+  };
+
+  explicit PageHashScanner(uint64_t address)
+      : pages_(), hash_(), position_(address) {}
+
+  PageHashScanner(const PageHashScanner&) = delete;
+  PageHashScanner& operator=(const PageHashScanner&) = delete;
+
+  ~PageHashScanner() override {}
+
+  const std::vector<Page>& pages() const { return pages_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    constexpr uint64_t kPageSize = MinidumpDeltaBase::kPageSize;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+      const size_t piece = static_cast<size_t>(
+          std::min<uint64_t>(size, kPageSize - position_ % kPageSize));
+
+      // A page that begins before the snapshot is never hashed, and one that
+      // extends beyond its end is never completed.
+      if (piece == kPageSize) {
+        pages_.push_back({position_, MinidumpDeltaBase::HashPage(bytes)});
+      } else {
+        if (position_ % kPageSize == 0) {
+          hash_.emplace();
+        }
+        if (hash_) {
+          hash_->Update(bytes, piece);
+          if ((position_ + piece) % kPageSize == 0) {
+            pages_.push_back({position_ + piece - kPageSize, hash_->Digest()});
+            hash_.reset();
+          }
+        }
+      }
+      bytes += piece;
+      size -= piece;
+      position_ += piece;
+    }
+    return true;
+  }
+
+ private:
+  std::vector<Page> pages_;
+  std::optional<XXHash64> hash_;
+  uint64_t position_;
+};
+
+// Adds writers to pieces for the slices of snapshot that exclude runs, which
+// must be sorted, must not overlap, and must lie within the snapshot. The
+// slices are added to slices, which must outlive the pieces.
+void SplitAroundRuns(
+    const MemorySnapshot* snapshot,
+    const std::vector<ZeroPageScanner::Range>& runs,
+    std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>>* pieces,
+    std::vector<std::unique_ptr<const MemorySnapshot>>* slices) {
+  const uint64_t snapshot_end = snapshot->Address() + snapshot->Size();
+  uint64_t piece_begin = snapshot->Address();
+  for (const ZeroPageScanner::Range& run : runs) {
+    if (run.begin > piece_begin) {
+      auto slice = std::make_unique<MemorySnapshotSlice>(
+          snapshot, piece_begin, static_cast<size_t>(run.begin - piece_begin));
+      pieces->push_back(
+          std::make_unique<SnapshotMinidumpMemoryWriter>(slice.get()));
+      slices->push_back(std::move(slice));
+    }
+    piece_begin = run.end;
+  }
+  if (piece_begin < snapshot_end) {
+    auto slice = std::make_unique<MemorySnapshotSlice>(
+        snapshot, piece_begin, static_cast<size_t>(snapshot_end - piece_begin));
+    pieces->push_back(
+        std::make_unique<SnapshotMinidumpMemoryWriter>(slice.get()));
+    slices->push_back(std::move(slice));
+  }
+}
+
+}  // namespace
+
 SnapshotMinidumpMemoryWriter::SnapshotMinidumpMemoryWriter(
     const MemorySnapshot* memory_snapshot)
     : internal::MinidumpWritable(),
@@ -33,15 +323,21 @@ SnapshotMinidumpMemoryWriter::SnapshotMinidumpMemoryWriter(
       memory_descriptor_(),
       registered_memory_descriptors_(),
       memory_snapshot_(memory_snapshot),
-      file_writer_(nullptr) {}
+      file_writer_(nullptr),
+      memory_buffer_limit_(kDefaultMemoryChunkSize),
+      bytes_written_(0) {}
 
 SnapshotMinidumpMemoryWriter::~SnapshotMinidumpMemoryWriter() {}
 
 bool SnapshotMinidumpMemoryWriter::MemorySnapshotDelegateRead(void* data,
                                                               size_t size) {
   DCHECK_EQ(state(), kStateWritable);
-  DCHECK_EQ(size, UnderlyingSnapshot()->Size());
-  return file_writer_->Write(data, size);
+  DCHECK_LE(size, UnderlyingSnapshot()->Size() - bytes_written_);
+  if (!file_writer_->Write(data, size)) {
+    return false;
+  }
+  bytes_written_ += size;
+  return true;
 }
 
 bool SnapshotMinidumpMemoryWriter::WriteObject(
@@ -51,16 +347,28 @@ bool SnapshotMinidumpMemoryWriter::WriteObject(
 
   base::AutoReset<FileWriterInterface*> file_writer_reset(&file_writer_,
                                                           file_writer);
+  bytes_written_ = 0;
 
-  // This will result in MemorySnapshotDelegateRead() being called.
-  if (!memory_snapshot_->Read(this)) {
+  // This will result in MemorySnapshotDelegateRead() being called for each
+  // piece of the snapshot, so that a large range never needs to be held in
+  // memory all at once.
+  if (!memory_snapshot_->ReadInChunks(this, memory_buffer_limit_)) {
     // If the Read() fails (perhaps because the process' memory map has changed
     // since it the range was captured), write an empty block of memory. It
     // would be nice to instead not include this memory, but at this point in
     // the writing process, it would be difficult to amend the minidump's
-    // structure. See https://crashpad.chromium.org/234 for background.
-    std::vector<uint8_t> empty(memory_snapshot_->Size(), 0xfe);
-    MemorySnapshotDelegateRead(empty.data(), empty.size());
+    // structure. See https://crashpad.chromium.org/234 for background. Only
+    // the remainder that was not already written is filled.
+    const size_t remaining = memory_snapshot_->Size() - bytes_written_;
+    std::vector<uint8_t> empty(std::min(remaining, memory_buffer_limit_),
+                               0xfe);
+    while (bytes_written_ < memory_snapshot_->Size()) {
+      const size_t size =
+          std::min(empty.size(), memory_snapshot_->Size() - bytes_written_);
+      if (!MemorySnapshotDelegateRead(empty.data(), size)) {
+        break;
+      }
+    }
   }
 
   return true;
@@ -127,6 +435,21 @@ bool SnapshotMinidumpMemoryWriter::WillWriteAtOffsetImpl(FileOffset offset) {
   return MinidumpWritable::WillWriteAtOffsetImpl(offset);
 }
 
+void SnapshotMinidumpMemoryWriter::WillWriteWithMemoryBufferLimit(
+    size_t memory_buffer_limit) {
+  DCHECK_EQ(state(), kStateWritable);
+  DCHECK_GT(memory_buffer_limit, 0u);
+
+  memory_buffer_limit_ = memory_buffer_limit;
+}
+
+bool SnapshotMinidumpMemoryWriter::CanWriteObjectConcurrently() {
+  DCHECK_EQ(state(), kStateWritable);
+
+  // The contents of a memory snapshot don’t depend on any other object.
+  return true;
+}
+
 internal::MinidumpWritable::Phase SnapshotMinidumpMemoryWriter::WritePhase() {
   // Memory dumps are large and are unlikely to be consumed in their entirety.
   // Data accesses are expected to be sparse and sporadic, and are expected to
@@ -141,7 +464,15 @@ MinidumpMemoryListWriter::MinidumpMemoryListWriter()
       non_owned_memory_writers_(),
       children_(),
       snapshots_created_during_merge_(),
+      trimmed_writers_(),
       all_memory_writers_(),
+      zero_memory_list_writer_(nullptr),
+      scan_zero_pages_(false),
+      compressed_memory_list_writer_(nullptr),
+      compressed_memory_minimum_size_(0),
+      page_hash_recorder_(nullptr),
+      delta_base_(nullptr),
+      delta_writer_(nullptr),
       memory_list_base_() {}
 
 MinidumpMemoryListWriter::~MinidumpMemoryListWriter() {
@@ -172,8 +503,59 @@ void MinidumpMemoryListWriter::AddNonOwnedMemory(
   non_owned_memory_writers_.push_back(memory_writer);
 }
 
+void MinidumpMemoryListWriter::SetZeroMemoryListWriter(
+    MinidumpZeroMemoryListWriter* zero_memory_list_writer) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  zero_memory_list_writer_ = zero_memory_list_writer;
+  scan_zero_pages_ = zero_memory_list_writer != nullptr;
+}
+
+void MinidumpMemoryListWriter::SetUnpopulatedMemoryListWriter(
+    MinidumpZeroMemoryListWriter* zero_memory_list_writer) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  // Scanning contents, if already arranged, also elides unpopulated memory.
+  if (!scan_zero_pages_) {
+    zero_memory_list_writer_ = zero_memory_list_writer;
+  }
+}
+
+void MinidumpMemoryListWriter::SetCompressedMemoryListWriter(
+    MinidumpCompressedMemoryListWriter* compressed_memory_list_writer,
+    size_t minimum_size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_GT(minimum_size, 0u);
+
+  compressed_memory_list_writer_ = compressed_memory_list_writer;
+  compressed_memory_minimum_size_ = minimum_size;
+}
+
+void MinidumpMemoryListWriter::SetPageHashRecorder(
+    MinidumpDeltaBase* page_hash_recorder) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  page_hash_recorder_ = page_hash_recorder;
+}
+
+void MinidumpMemoryListWriter::SetDeltaBase(const MinidumpDeltaBase* delta_base,
+                                            MinidumpDeltaWriter* delta_writer) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_EQ(!delta_base, !delta_writer);
+
+  delta_base_ = delta_base;
+  delta_writer_ = delta_writer;
+}
+
 void MinidumpMemoryListWriter::CoalesceOwnedMemory() {
-  DropRangesThatOverlapNonOwned();
+  // Remove any empty ranges.
+  children_.erase(
+      std::remove_if(children_.begin(),
+                     children_.end(),
+                     [](const auto& snapshot) {
+                       return snapshot->UnderlyingSnapshot()->Size() == 0;
+                     }),
+      children_.end());
 
   if (children_.empty())
     return;
@@ -190,15 +572,6 @@ void MinidumpMemoryListWriter::CoalesceOwnedMemory() {
               return a->Address() < b->Address();
             });
 
-  // Remove any empty ranges.
-  children_.erase(
-      std::remove_if(children_.begin(),
-                     children_.end(),
-                     [](const auto& snapshot) {
-                       return snapshot->UnderlyingSnapshot()->Size() == 0;
-                     }),
-      children_.end());
-
   std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> all_merged;
   all_merged.push_back(std::move(children_.front()));
   for (size_t i = 1; i < children_.size(); ++i) {
@@ -218,12 +591,25 @@ void MinidumpMemoryListWriter::CoalesceOwnedMemory() {
     }
   }
   std::swap(children_, all_merged);
+
+  // Merging happens first because slices of snapshots, created when trimming,
+  // can't be merged.
+  TrimRangesThatOverlapNonOwned();
 }
 
 bool MinidumpMemoryListWriter::Freeze() {
   DCHECK_EQ(state(), kStateMutable);
 
   CoalesceOwnedMemory();
+  if (zero_memory_list_writer_) {
+    ElideZeroPages();
+  }
+  if (page_hash_recorder_ || delta_base_) {
+    ElideUnchangedPages();
+  }
+  if (compressed_memory_list_writer_) {
+    CompressLargeRanges();
+  }
 
   std::copy(non_owned_memory_writers_.begin(),
             non_owned_memory_writers_.end(),
@@ -290,23 +676,216 @@ MinidumpStreamType MinidumpMemoryListWriter::StreamType() const {
   return kMinidumpStreamTypeMemoryList;
 }
 
-void MinidumpMemoryListWriter::DropRangesThatOverlapNonOwned() {
-  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> non_overlapping;
-  non_overlapping.reserve(children_.size());
-  for (auto& child_ptr : children_) {
+void MinidumpMemoryListWriter::TrimRangesThatOverlapNonOwned() {
+  struct Range {
+    uint64_t begin;
+    uint64_t end;
+  };
+  std::vector<Range> non_owned;
+  non_owned.reserve(non_owned_memory_writers_.size());
+  for (const auto* non_owned_writer : non_owned_memory_writers_) {
+    const MemorySnapshot* snapshot = non_owned_writer->UnderlyingSnapshot();
+    if (snapshot->Size()) {
+      non_owned.push_back(
+          {snapshot->Address(), snapshot->Address() + snapshot->Size()});
+    }
+  }
+  if (non_owned.empty())
+    return;
+  std::sort(non_owned.begin(),
+            non_owned.end(),
+            [](const Range& a, const Range& b) { return a.begin < b.begin; });
+
+  // Both lists are sorted, so a single sweep finds every overlap. Non-owned
+  // ranges may overlap one another, so any that end before the part of the
+  // owned range not yet accounted for are skipped.
+  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> trimmed;
+  trimmed.reserve(children_.size());
+  size_t first_non_owned = 0;
+  for (auto& child : children_) {
+    const MemorySnapshot* snapshot = child->UnderlyingSnapshot();
+    const uint64_t child_begin = snapshot->Address();
+    const uint64_t child_end = child_begin + snapshot->Size();
+
+    while (first_non_owned < non_owned.size() &&
+           non_owned[first_non_owned].end <= child_begin) {
+      ++first_non_owned;
+    }
+
+    uint64_t uncovered_begin = child_begin;
     bool overlaps = false;
-    for (const auto* non_owned : non_owned_memory_writers_) {
-      if (DetermineMergedRange(child_ptr->UnderlyingSnapshot(),
-                               non_owned->UnderlyingSnapshot(),
-                               nullptr)) {
-        overlaps = true;
-        break;
+    std::vector<Range> pieces;
+    for (size_t index = first_non_owned;
+         index < non_owned.size() && non_owned[index].begin < child_end;
+         ++index) {
+      if (non_owned[index].end <= uncovered_begin) {
+        continue;
+      }
+      overlaps = true;
+      if (non_owned[index].begin > uncovered_begin) {
+        pieces.push_back({uncovered_begin, non_owned[index].begin});
+      }
+      uncovered_begin = std::min(non_owned[index].end, child_end);
+    }
+
+    if (!overlaps) {
+      trimmed.push_back(std::move(child));
+      continue;
+    }
+    if (uncovered_begin < child_end) {
+      pieces.push_back({uncovered_begin, child_end});
+    }
+
+    for (const Range& piece : pieces) {
+      auto slice = std::make_unique<MemorySnapshotSlice>(
+          snapshot,
+          piece.begin,
+          static_cast<size_t>(piece.end - piece.begin));
+      trimmed.push_back(
+          std::make_unique<SnapshotMinidumpMemoryWriter>(slice.get()));
+      snapshots_created_during_merge_.push_back(std::move(slice));
+    }
+    trimmed_writers_.push_back(std::move(child));
+  }
+  std::swap(children_, trimmed);
+}
+
+void MinidumpMemoryListWriter::ElideZeroPages() {
+  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> elided;
+  elided.reserve(children_.size());
+  for (auto& child : children_) {
+    const MemorySnapshot* snapshot = child->UnderlyingSnapshot();
+    const uint64_t child_end = snapshot->Address() + snapshot->Size();
+
+    // Pages that were never populated are known to be zero without reading
+    // them, so only the rest of the snapshot is scanned.
+    std::vector<ZeroPageScanner::Range> runs = UnpopulatedPages(snapshot);
+    if (scan_zero_pages_) {
+      std::vector<ZeroPageScanner::Range> populated;
+      uint64_t populated_begin = snapshot->Address();
+      for (const ZeroPageScanner::Range& run : runs) {
+        if (run.begin > populated_begin) {
+          populated.push_back({populated_begin, run.begin});
+        }
+        populated_begin = run.end;
+      }
+      if (populated_begin < child_end) {
+        populated.push_back({populated_begin, child_end});
+      }
+
+      std::vector<ZeroPageScanner::Range> scanned_runs;
+      bool read = true;
+      for (const ZeroPageScanner::Range& piece : populated) {
+        const MemorySnapshotSlice slice(
+            snapshot,
+            piece.begin,
+            static_cast<size_t>(piece.end - piece.begin));
+        ZeroPageScanner scanner(piece.begin);
+        if (!slice.Read(&scanner)) {
+          read = false;
+          break;
+        }
+        scanned_runs.insert(
+            scanned_runs.end(), scanner.runs().begin(), scanner.runs().end());
+      }
+      if (!read) {
+        // If the contents can’t be read now, they probably won’t be readable
+        // when they’re written either, and will be written as filler. Keep the
+        // whole range.
+        elided.push_back(std::move(child));
+        continue;
+      }
+
+      std::vector<ZeroPageScanner::Range> merged;
+      merged.reserve(runs.size() + scanned_runs.size());
+      std::merge(runs.begin(),
+                 runs.end(),
+                 scanned_runs.begin(),
+                 scanned_runs.end(),
+                 std::back_inserter(merged),
+                 [](const ZeroPageScanner::Range& a,
+                    const ZeroPageScanner::Range& b) {
+                   return a.begin < b.begin;
+                 });
+      runs.clear();
+      for (const ZeroPageScanner::Range& run : merged) {
+        if (!runs.empty() && runs.back().end == run.begin) {
+          runs.back().end = run.end;
+        } else {
+          runs.push_back(run);
+        }
+      }
+    }
+
+    if (runs.empty()) {
+      elided.push_back(std::move(child));
+      continue;
+    }
+
+    for (const ZeroPageScanner::Range& run : runs) {
+      zero_memory_list_writer_->AddRange(run.begin, run.end - run.begin);
+    }
+    SplitAroundRuns(snapshot, runs, &elided, &snapshots_created_during_merge_);
+    trimmed_writers_.push_back(std::move(child));
+  }
+  std::swap(children_, elided);
+}
+
+void MinidumpMemoryListWriter::ElideUnchangedPages() {
+  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> elided;
+  elided.reserve(children_.size());
+  for (auto& child : children_) {
+    const MemorySnapshot* snapshot = child->UnderlyingSnapshot();
+    PageHashScanner scanner(snapshot->Address());
+    if (!snapshot->Read(&scanner)) {
+      // Memory that can’t be read now will be written as filler, so it isn’t
+      // recorded in a base, and is kept whole in a delta.
+      elided.push_back(std::move(child));
+      continue;
+    }
+
+    std::vector<ZeroPageScanner::Range> runs;
+    for (const PageHashScanner::Page& page : scanner.pages()) {
+      if (page_hash_recorder_) {
+        page_hash_recorder_->AddPageHash(page.address, page.hash);
+      }
+      if (delta_base_ && delta_base_->PageMatches(page.address, page.hash)) {
+        const uint64_t page_end = page.address + MinidumpDeltaBase::kPageSize;
+        if (!runs.empty() && runs.back().end == page.address) {
+          runs.back().end = page_end;
+        } else {
+          runs.push_back({page.address, page_end});
+        }
       }
     }
-    if (!overlaps)
-      non_overlapping.push_back(std::move(child_ptr));
+
+    if (runs.empty()) {
+      elided.push_back(std::move(child));
+      continue;
+    }
+
+    for (const ZeroPageScanner::Range& run : runs) {
+      delta_writer_->AddRange(run.begin, run.end - run.begin);
+    }
+    SplitAroundRuns(snapshot, runs, &elided, &snapshots_created_during_merge_);
+    trimmed_writers_.push_back(std::move(child));
+  }
+  std::swap(children_, elided);
+}
+
+void MinidumpMemoryListWriter::CompressLargeRanges() {
+  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> kept;
+  kept.reserve(children_.size());
+  for (auto& child : children_) {
+    const MemorySnapshot* snapshot = child->UnderlyingSnapshot();
+    if (snapshot->Size() >= compressed_memory_minimum_size_ &&
+        compressed_memory_list_writer_->AddFromSnapshot(snapshot)) {
+      trimmed_writers_.push_back(std::move(child));
+    } else {
+      kept.push_back(std::move(child));
+    }
   }
-  std::swap(children_, non_overlapping);
+  std::swap(children_, kept);
 }
 
 }  // namespace crashpad
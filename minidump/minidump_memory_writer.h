@@ -30,11 +30,24 @@
 
 namespace crashpad {
 
+class MinidumpCompressedMemoryListWriter;
+class MinidumpDeltaBase;
+class MinidumpDeltaWriter;
+class MinidumpZeroMemoryListWriter;
+
 //! \brief The base class for writers of memory ranges pointed to by
 //!     MINIDUMP_MEMORY_DESCRIPTOR objects in a minidump file.
 class SnapshotMinidumpMemoryWriter : public internal::MinidumpWritable,
                                      public MemorySnapshot::Delegate {
  public:
+  //! \brief The size, in bytes, of the pieces that memory is read and written
+  //!     in when no memory buffer limit is set by
+  //!     WillWriteWithMemoryBufferLimit().
+  //!
+  //! Reading in pieces keeps memory use from growing with the size of the
+  //! largest memory range being written.
+  static constexpr size_t kDefaultMemoryChunkSize = 1024 * 1024;
+
   explicit SnapshotMinidumpMemoryWriter(const MemorySnapshot* memory_snapshot);
 
   SnapshotMinidumpMemoryWriter(const SnapshotMinidumpMemoryWriter&) = delete;
@@ -93,6 +106,8 @@ class SnapshotMinidumpMemoryWriter : public internal::MinidumpWritable,
   size_t Alignment() override;
 
   bool WillWriteAtOffsetImpl(FileOffset offset) override;
+  void WillWriteWithMemoryBufferLimit(size_t memory_buffer_limit) override;
+  bool CanWriteObjectConcurrently() override;
 
   //! \brief Returns the object’s desired write phase.
   //!
@@ -115,6 +130,8 @@ class SnapshotMinidumpMemoryWriter : public internal::MinidumpWritable,
   std::vector<MINIDUMP_MEMORY_DESCRIPTOR*> registered_memory_descriptors_;
   const MemorySnapshot* memory_snapshot_;
   FileWriterInterface* file_writer_;
+  size_t memory_buffer_limit_;
+  size_t bytes_written_;
 };
 
 //! \brief The writer for a MINIDUMP_MEMORY_LIST stream in a minidump file,
@@ -163,6 +180,110 @@ class MinidumpMemoryListWriter final : public internal::MinidumpStreamWriter {
   //! \note Valid in #kStateMutable.
   void AddNonOwnedMemory(SnapshotMinidumpMemoryWriter* memory_writer);
 
+  //! \brief Omits pages of memory that contain only zeroes from the minidump
+  //!     file, recording them in \a zero_memory_list_writer instead.
+  //!
+  //! When set, the contents of each memory region added with AddFromSnapshot()
+  //! or AddMemory() are examined as this object is frozen, which reads them an
+  //! additional time. Pages that the region’s MemorySnapshot reports as never
+  //! populated are known to contain only zeroes, and are not read. Runs of
+  //! whole pages that contain only zeroes are removed from the region,
+  //! splitting it into several regions if necessary, and are added to \a
+  //! zero_memory_list_writer. Memory added with
+  //! AddNonOwnedMemory(), such as thread stacks, is written in its entirety,
+  //! because other structures refer to it as a single region.
+  //!
+  //! \param[in] zero_memory_list_writer The writer to receive the omitted
+  //!     ranges. It must be frozen after this object. This object does not
+  //!     take ownership of it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetZeroMemoryListWriter(
+      MinidumpZeroMemoryListWriter* zero_memory_list_writer);
+
+  //! \brief Omits pages of memory that were never populated from the minidump
+  //!     file, recording them in \a zero_memory_list_writer instead.
+  //!
+  //! This is like SetZeroMemoryListWriter(), but only the pages that each
+  //! region’s MemorySnapshot reports through
+  //! MemorySnapshot::UnpopulatedRanges() are omitted, and region contents are
+  //! not read an additional time. If SetZeroMemoryListWriter() has been
+  //! called, unpopulated pages are already omitted and this has no effect.
+  //!
+  //! \param[in] zero_memory_list_writer The writer to receive the omitted
+  //!     ranges. It must be frozen after this object. This object does not
+  //!     take ownership of it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetUnpopulatedMemoryListWriter(
+      MinidumpZeroMemoryListWriter* zero_memory_list_writer);
+
+  //! \brief Stores large memory regions in \a compressed_memory_list_writer
+  //!     in compressed form instead of in this stream.
+  //!
+  //! When set, each memory region added with AddFromSnapshot() or AddMemory()
+  //! that is at least \a minimum_size bytes is read and compressed as this
+  //! object is frozen, and is moved to \a compressed_memory_list_writer. This
+  //! happens after any zero pages are omitted as arranged by
+  //! SetZeroMemoryListWriter(). A region that can’t be read at that time is
+  //! kept in this stream. Memory added with AddNonOwnedMemory() is never
+  //! moved.
+  //!
+  //! \param[in] compressed_memory_list_writer The writer to receive large
+  //!     regions. It must be frozen after this object. This object does not
+  //!     take ownership of it.
+  //! \param[in] minimum_size The size of the smallest region to move, in
+  //!     bytes. Must be greater than `0`.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetCompressedMemoryListWriter(
+      MinidumpCompressedMemoryListWriter* compressed_memory_list_writer,
+      size_t minimum_size);
+
+  //! \brief Records the hash of each page of memory written into \a
+  //!     page_hash_recorder, so that a later minidump file may be written as
+  //!     a delta against this one.
+  //!
+  //! When set, the contents of each memory region added with AddFromSnapshot()
+  //! or AddMemory() are read an additional time as this object is frozen, and
+  //! MinidumpDeltaBase::AddPageHash() is called for each whole, aligned page.
+  //! This happens after any zero pages are omitted as arranged by
+  //! SetZeroMemoryListWriter(), so those pages are not recorded. Memory added
+  //! with AddNonOwnedMemory() is not recorded, and a region that can’t be read
+  //! at that time is not recorded.
+  //!
+  //! \param[in] page_hash_recorder The object to record page hashes in. This
+  //!     object does not take ownership of it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetPageHashRecorder(MinidumpDeltaBase* page_hash_recorder);
+
+  //! \brief Omits pages of memory that are unchanged since \a delta_base was
+  //!     recorded from the minidump file, recording them in \a delta_writer
+  //!     instead.
+  //!
+  //! When set, the contents of each memory region added with AddFromSnapshot()
+  //! or AddMemory() are read an additional time as this object is frozen. Runs
+  //! of whole, aligned pages whose hashes match those recorded in \a
+  //! delta_base are removed from the region, splitting it into several regions
+  //! if necessary, and are added to \a delta_writer. This happens after any
+  //! zero pages are omitted as arranged by SetZeroMemoryListWriter(), and
+  //! before large regions are moved as arranged by
+  //! SetCompressedMemoryListWriter(). Memory added with AddNonOwnedMemory(),
+  //! such as thread stacks, is written in its entirety, because other
+  //! structures refer to it as a single region.
+  //!
+  //! \param[in] delta_base The base to compare pages against, recorded by
+  //!     SetPageHashRecorder() while writing an earlier minidump file of the
+  //!     same process. This object does not take ownership of it.
+  //! \param[in] delta_writer The writer to receive the omitted ranges. It must
+  //!     be frozen after this object. This object does not take ownership of
+  //!     it.
+  //!
+  //! \note Valid in #kStateMutable.
+  void SetDeltaBase(const MinidumpDeltaBase* delta_base,
+                    MinidumpDeltaWriter* delta_writer);
+
  protected:
   // MinidumpWritable:
   bool Freeze() override;
@@ -179,9 +300,11 @@ class MinidumpMemoryListWriter final : public internal::MinidumpStreamWriter {
   //! This is expected to be called once just before writing, generally from
   //! Freeze().
   //!
-  //! This function has the side-effect of merging owned ranges, dropping any
-  //! owned ranges that overlap with non-owned ranges, removing empty ranges,
-  //! and sorting all ranges by address.
+  //! This function has the side-effect of merging owned ranges, trimming the
+  //! parts of owned ranges that overlap non-owned ranges, removing empty
+  //! ranges, and sorting all ranges by address. As a result, every byte of
+  //! owned memory is written once, and none of it duplicates a non-owned
+  //! range.
   //!
   //! Per its name, this coalesces owned memory, however, this is not a complete
   //! solution for ensuring that no overlapping memory ranges are emitted in the
@@ -194,14 +317,31 @@ class MinidumpMemoryListWriter final : public internal::MinidumpStreamWriter {
   void CoalesceOwnedMemory();
 
  private:
-  //! \brief Drops children_ ranges that overlap non_owned_memory_writers_.
-  void DropRangesThatOverlapNonOwned();
+  //! \brief Replaces children_ ranges that overlap non_owned_memory_writers_
+  //!     with the parts of them that don't. children_ must be sorted and must
+  //!     not overlap one another.
+  void TrimRangesThatOverlapNonOwned();
+  void ElideZeroPages();
+  void ElideUnchangedPages();
+  void CompressLargeRanges();
 
   std::vector<SnapshotMinidumpMemoryWriter*> non_owned_memory_writers_;  // weak
   std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> children_;
   std::vector<std::unique_ptr<const MemorySnapshot>>
       snapshots_created_during_merge_;
+
+  // Writers replaced by slices of their snapshots when trimming or eliding zero
+  // pages, or moved to compressed_memory_list_writer_. They may own the
+  // snapshots that the slices refer to, so they're kept alive.
+  std::vector<std::unique_ptr<SnapshotMinidumpMemoryWriter>> trimmed_writers_;
   std::vector<SnapshotMinidumpMemoryWriter*> all_memory_writers_;  // weak
+  MinidumpZeroMemoryListWriter* zero_memory_list_writer_;  // weak
+  bool scan_zero_pages_;
+  MinidumpCompressedMemoryListWriter* compressed_memory_list_writer_;  // weak
+  size_t compressed_memory_minimum_size_;
+  MinidumpDeltaBase* page_hash_recorder_;  // weak
+  const MinidumpDeltaBase* delta_base_;  // weak
+  MinidumpDeltaWriter* delta_writer_;  // weak
   MINIDUMP_MEMORY_LIST memory_list_base_;
 };
 
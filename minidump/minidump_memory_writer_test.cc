@@ -15,13 +15,18 @@
 #include "minidump/minidump_memory_writer.h"
 
 #include <iterator>
+#include <string>
 #include <utility>
 
 #include "base/format_macros.h"
 #include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
+#include "minidump/minidump_compressed_memory_list_writer.h"
+#include "minidump/minidump_delta_base.h"
+#include "minidump/minidump_delta_writer.h"
 #include "minidump/minidump_extensions.h"
 #include "minidump/minidump_file_writer.h"
+#include "minidump/minidump_zero_memory_list_writer.h"
 #include "minidump/test/minidump_file_writer_test_util.h"
 #include "minidump/test/minidump_memory_writer_test_util.h"
 #include "minidump/test/minidump_writable_test_util.h"
@@ -340,6 +345,480 @@ TEST(MinidumpMemoryWriter, ExtraMemory) {
   }
 }
 
+void TrimOwnedMemoryTest(size_t memory_buffer_limit) {
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.SetMemoryBufferLimit(memory_buffer_limit);
+
+  // The non-owned range, as a thread stack would be.
+  constexpr uint64_t kStackAddress = 0x1000;
+  constexpr size_t kStackSize = 0x400;
+  constexpr uint8_t kStackValue = 's';
+  auto test_memory_stream = std::make_unique<TestMemoryStream>(
+      kStackAddress, kStackSize, kStackValue);
+
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  memory_list_writer->AddNonOwnedMemory(test_memory_stream->memory());
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(test_memory_stream)));
+
+  struct {
+    uint64_t base;
+    size_t size;
+    uint8_t value;
+  } owned[] = {
+      // Overlaps the start of the stack.
+      {0x0e00, 0x300, 'a'},
+      // Entirely within the stack.
+      {0x1180, 0x80, 'b'},
+      // Overlaps the end of the stack.
+      {0x1300, 0x300, 'c'},
+      // Doesn't overlap the stack.
+      {0x2000, 0x100, 'd'},
+  };
+  for (const auto& range : owned) {
+    memory_list_writer->AddMemory(std::make_unique<TestMinidumpMemoryWriter>(
+        range.base, range.size, range.value));
+  }
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 2));
+
+  // Only the parts of the owned ranges outside the stack remain, and the range
+  // entirely within the stack is gone.
+  struct {
+    uint64_t base;
+    size_t size;
+    uint8_t value;
+  } expected_ranges[] = {
+      {kStackAddress, kStackSize, kStackValue},
+      {0x0e00, 0x200, 'a'},
+      {0x1400, 0x200, 'c'},
+      {0x2000, 0x100, 'd'},
+  };
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, std::size(expected_ranges));
+
+  for (size_t index = 0; index < std::size(expected_ranges); ++index) {
+    SCOPED_TRACE(base::StringPrintf("index %" PRIuS, index));
+    MINIDUMP_MEMORY_DESCRIPTOR expected = {};
+    expected.StartOfMemoryRange = expected_ranges[index].base;
+    expected.Memory.DataSize =
+        static_cast<uint32_t>(expected_ranges[index].size);
+    ExpectMinidumpMemoryDescriptorAndContents(
+        &expected,
+        &memory_list->MemoryRanges[index],
+        string_file.string(),
+        expected_ranges[index].value,
+        index == std::size(expected_ranges) - 1);
+  }
+}
+
+TEST(MinidumpMemoryWriter, TrimOwnedMemoryOverlappingNonOwned) {
+  TrimOwnedMemoryTest(0);
+}
+
+TEST(MinidumpMemoryWriter, TrimOwnedMemoryOverlappingNonOwnedInChunks) {
+  // A limit that doesn't divide the ranges evenly, so that pieces of the
+  // trimmed ranges are read in chunks that straddle their ends.
+  TrimOwnedMemoryTest(0x70);
+}
+
+// A MemorySnapshot with arbitrary contents.
+class StringMemorySnapshot final : public MemorySnapshot {
+ public:
+  StringMemorySnapshot(uint64_t address, const std::string& contents)
+      : MemorySnapshot(), address_(address), contents_(contents) {}
+
+  StringMemorySnapshot(const StringMemorySnapshot&) = delete;
+  StringMemorySnapshot& operator=(const StringMemorySnapshot&) = delete;
+
+  ~StringMemorySnapshot() override {}
+
+  void AddUnpopulatedRange(uint64_t address, size_t size) {
+    unpopulated_.emplace_back(address, size);
+  }
+
+  size_t read_count() const { return read_count_; }
+  size_t chunk_size() const { return chunk_size_; }
+
+  // MemorySnapshot:
+  uint64_t Address() const override { return address_; }
+  size_t Size() const override { return contents_.size(); }
+  bool Read(Delegate* delegate) const override {
+    ++read_count_;
+    std::string buffer(contents_);
+    return delegate->MemorySnapshotDelegateRead(buffer.data(), buffer.size());
+  }
+  bool ReadInChunks(Delegate* delegate, size_t chunk_size) const override {
+    chunk_size_ = chunk_size;
+    return MemorySnapshot::ReadInChunks(delegate, chunk_size);
+  }
+  std::vector<CheckedRange<uint64_t, size_t>> UnpopulatedRanges()
+      const override {
+    return unpopulated_;
+  }
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    return nullptr;
+  }
+
+ private:
+  uint64_t address_;
+  std::string contents_;
+  std::vector<CheckedRange<uint64_t, size_t>> unpopulated_;
+  mutable size_t read_count_ = 0;
+  mutable size_t chunk_size_ = 0;
+};
+
+TEST(MinidumpMemoryWriter, DefaultChunkSize) {
+  // Without a memory buffer limit, a range larger than the default chunk size
+  // is still read and written in pieces of that size.
+  constexpr uint64_t kAddress = 0x100000;
+  std::string contents(
+      SnapshotMinidumpMemoryWriter::kDefaultMemoryChunkSize * 2 + 0x10, 'm');
+  contents.back() = 'n';
+  StringMemorySnapshot snapshot(kAddress, contents);
+
+  MinidumpFileWriter minidump_file_writer;
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  memory_list_writer->AddFromSnapshot({&snapshot});
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+  EXPECT_EQ(snapshot.chunk_size(),
+            SnapshotMinidumpMemoryWriter::kDefaultMemoryChunkSize);
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 1));
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 1u);
+  const MINIDUMP_MEMORY_DESCRIPTOR& descriptor = memory_list->MemoryRanges[0];
+  EXPECT_EQ(descriptor.StartOfMemoryRange, kAddress);
+  ASSERT_EQ(descriptor.Memory.DataSize, contents.size());
+  ASSERT_LE(descriptor.Memory.Rva + descriptor.Memory.DataSize,
+            string_file.string().size());
+  EXPECT_EQ(
+      string_file.string().substr(descriptor.Memory.Rva, contents.size()),
+      contents);
+}
+
+TEST(MinidumpMemoryWriter, ElideZeroPages) {
+  MinidumpFileWriter minidump_file_writer;
+
+  // Zero-filled memory that isn’t owned by the memory list, as a thread stack
+  // would be, is written in its entirety.
+  constexpr uint64_t kStackAddress = 0x30000;
+  constexpr size_t kStackSize = 0x2000;
+  auto test_memory_stream =
+      std::make_unique<TestMemoryStream>(kStackAddress, kStackSize, 0);
+
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  auto zero_memory_list_writer =
+      std::make_unique<MinidumpZeroMemoryListWriter>();
+  memory_list_writer->SetZeroMemoryListWriter(zero_memory_list_writer.get());
+  memory_list_writer->AddNonOwnedMemory(test_memory_stream->memory());
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(test_memory_stream)));
+
+  // A region that doesn’t begin or end on a page boundary. Only the pages at
+  // 0x12000 and 0x13000 are whole and contain only zeroes. The partial pages
+  // at either end are kept even though they contain only zeroes.
+  constexpr uint64_t kMixedAddress = 0x10800;
+  std::string mixed_contents(0x5000, '\0');
+  mixed_contents[0x11010 - kMixedAddress] = 'x';
+  mixed_contents[0x14fff - kMixedAddress] = 'y';
+  StringMemorySnapshot mixed_snapshot(kMixedAddress, mixed_contents);
+
+  // A region containing only zeroes, which is omitted entirely.
+  constexpr uint64_t kZeroAddress = 0x20000;
+  StringMemorySnapshot zero_snapshot(kZeroAddress, std::string(0x2000, '\0'));
+
+  memory_list_writer->AddFromSnapshot({&mixed_snapshot, &zero_snapshot});
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(zero_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 3));
+
+  struct {
+    uint64_t base;
+    uint64_t end;
+  } expected_ranges[] = {
+      {kStackAddress, kStackAddress + kStackSize},
+      {kMixedAddress, 0x12000},
+      {0x14000, kMixedAddress + mixed_contents.size()},
+  };
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, std::size(expected_ranges));
+  for (size_t index = 0; index < std::size(expected_ranges); ++index) {
+    SCOPED_TRACE(base::StringPrintf("index %" PRIuS, index));
+    const MINIDUMP_MEMORY_DESCRIPTOR& descriptor =
+        memory_list->MemoryRanges[index];
+    EXPECT_EQ(descriptor.StartOfMemoryRange, expected_ranges[index].base);
+    ASSERT_EQ(descriptor.Memory.DataSize,
+              expected_ranges[index].end - expected_ranges[index].base);
+    if (index > 0) {
+      ASSERT_LE(descriptor.Memory.Rva + descriptor.Memory.DataSize,
+                string_file.string().size());
+      EXPECT_EQ(string_file.string().substr(descriptor.Memory.Rva,
+                                            descriptor.Memory.DataSize),
+                mixed_contents.substr(descriptor.StartOfMemoryRange -
+                                          kMixedAddress,
+                                      descriptor.Memory.DataSize));
+    }
+  }
+
+  const MINIDUMP_DIRECTORY* directory;
+  MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_TRUE(directory);
+  ASSERT_EQ(directory[2].StreamType, kMinidumpStreamTypeCrashpadZeroMemoryList);
+  const MinidumpZeroMemoryList* zero_memory_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpZeroMemoryList>(
+          string_file.string(), directory[2].Location);
+  ASSERT_TRUE(zero_memory_list);
+  ASSERT_EQ(zero_memory_list->count, 2u);
+  EXPECT_EQ(zero_memory_list->ranges[0].start_of_memory_range, 0x12000u);
+  EXPECT_EQ(zero_memory_list->ranges[0].data_size, 0x2000u);
+  EXPECT_EQ(zero_memory_list->ranges[1].start_of_memory_range, kZeroAddress);
+  EXPECT_EQ(zero_memory_list->ranges[1].data_size, 0x2000u);
+}
+
+TEST(MinidumpMemoryWriter, ElideUnpopulatedPages) {
+  MinidumpFileWriter minidump_file_writer;
+
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  auto zero_memory_list_writer =
+      std::make_unique<MinidumpZeroMemoryListWriter>();
+  memory_list_writer->SetUnpopulatedMemoryListWriter(
+      zero_memory_list_writer.get());
+
+  // Only the pages that the snapshot reports as unpopulated are omitted, and
+  // only whole ones: the report covers part of the pages at 0x11000 and
+  // 0x13000, which are kept. Although the contents returned here aren’t zero,
+  // they aren’t examined.
+  constexpr uint64_t kAddress = 0x10800;
+  const std::string contents(0x5000, 'x');
+  StringMemorySnapshot snapshot(kAddress, contents);
+  snapshot.AddUnpopulatedRange(0x11800, 0x2000);
+
+  memory_list_writer->AddFromSnapshot({&snapshot});
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(zero_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  // The two pieces are each read once, when they’re written.
+  EXPECT_EQ(snapshot.read_count(), 2u);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 2, 0));
+  ASSERT_TRUE(directory);
+
+  ASSERT_EQ(directory[0].StreamType, kMinidumpStreamTypeMemoryList);
+  const MINIDUMP_MEMORY_LIST* memory_list =
+      MinidumpWritableAtLocationDescriptor<MINIDUMP_MEMORY_LIST>(
+          string_file.string(), directory[0].Location);
+  ASSERT_TRUE(memory_list);
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 2u);
+  EXPECT_EQ(memory_list->MemoryRanges[0].StartOfMemoryRange, kAddress);
+  EXPECT_EQ(memory_list->MemoryRanges[0].Memory.DataSize, 0x12000 - kAddress);
+  EXPECT_EQ(memory_list->MemoryRanges[1].StartOfMemoryRange, 0x13000u);
+  EXPECT_EQ(memory_list->MemoryRanges[1].Memory.DataSize,
+            kAddress + contents.size() - 0x13000);
+
+  ASSERT_EQ(directory[1].StreamType, kMinidumpStreamTypeCrashpadZeroMemoryList);
+  const MinidumpZeroMemoryList* zero_memory_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpZeroMemoryList>(
+          string_file.string(), directory[1].Location);
+  ASSERT_TRUE(zero_memory_list);
+  ASSERT_EQ(zero_memory_list->count, 1u);
+  EXPECT_EQ(zero_memory_list->ranges[0].start_of_memory_range, 0x12000u);
+  EXPECT_EQ(zero_memory_list->ranges[0].data_size, 0x1000u);
+}
+
+TEST(MinidumpMemoryWriter, CompressLargeRanges) {
+  MinidumpFileWriter minidump_file_writer;
+
+  // Memory that isn’t owned by the memory list, as a thread stack would be, is
+  // never compressed, regardless of its size.
+  constexpr uint64_t kStackAddress = 0x30000;
+  constexpr size_t kStackSize = 0x2000;
+  auto test_memory_stream =
+      std::make_unique<TestMemoryStream>(kStackAddress, kStackSize, 's');
+
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  auto compressed_memory_list_writer =
+      std::make_unique<MinidumpCompressedMemoryListWriter>();
+  memory_list_writer->SetCompressedMemoryListWriter(
+      compressed_memory_list_writer.get(), 0x1000);
+  memory_list_writer->AddNonOwnedMemory(test_memory_stream->memory());
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(test_memory_stream)));
+
+  // A region smaller than the minimum is kept in the memory list.
+  constexpr uint64_t kSmallAddress = 0x10000;
+  const std::string small_contents(0x800, 'a');
+  StringMemorySnapshot small_snapshot(kSmallAddress, small_contents);
+
+  // A region at least as large as the minimum is moved.
+  constexpr uint64_t kLargeAddress = 0x20000;
+  const std::string large_contents(0x1000, 'b');
+  StringMemorySnapshot large_snapshot(kLargeAddress, large_contents);
+
+  memory_list_writer->AddFromSnapshot({&small_snapshot, &large_snapshot});
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+  ASSERT_TRUE(minidump_file_writer.AddStream(
+      std::move(compressed_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 3));
+
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, 2u);
+  EXPECT_EQ(memory_list->MemoryRanges[0].StartOfMemoryRange, kStackAddress);
+  EXPECT_EQ(memory_list->MemoryRanges[0].Memory.DataSize, kStackSize);
+  EXPECT_EQ(memory_list->MemoryRanges[1].StartOfMemoryRange, kSmallAddress);
+  EXPECT_EQ(memory_list->MemoryRanges[1].Memory.DataSize,
+            small_contents.size());
+
+  const MINIDUMP_DIRECTORY* directory;
+  MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_TRUE(directory);
+  ASSERT_EQ(directory[2].StreamType,
+            kMinidumpStreamTypeCrashpadCompressedMemoryList);
+  const MinidumpCompressedMemoryList* compressed_memory_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpCompressedMemoryList>(
+          string_file.string(), directory[2].Location);
+  ASSERT_TRUE(compressed_memory_list);
+  ASSERT_EQ(compressed_memory_list->count, 1u);
+  EXPECT_EQ(compressed_memory_list->ranges[0].start_of_memory_range,
+            kLargeAddress);
+  EXPECT_EQ(compressed_memory_list->ranges[0].data_size,
+            large_contents.size());
+}
+
+TEST(MinidumpMemoryWriter, ElideUnchangedPages) {
+  // Memory that isn’t owned by the memory list, as a thread stack would be, is
+  // neither recorded nor omitted.
+  constexpr uint64_t kStackAddress = 0x30000;
+  constexpr size_t kStackSize = 0x2000;
+
+  // A region that doesn’t begin or end on a page boundary, with different
+  // contents in each page. Only the pages from 0x11000 to 0x15000 are whole.
+  constexpr uint64_t kAddress = 0x10800;
+  std::string contents;
+  for (char c = 'a'; c < 'g'; ++c) {
+    contents.append(0x1000, c);
+  }
+  contents.resize(0x5000);
+
+  MinidumpDeltaBase base;
+  {
+    MinidumpFileWriter minidump_file_writer;
+    auto test_memory_stream =
+        std::make_unique<TestMemoryStream>(kStackAddress, kStackSize, 's');
+    auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+    memory_list_writer->SetPageHashRecorder(&base);
+    memory_list_writer->AddNonOwnedMemory(test_memory_stream->memory());
+    ASSERT_TRUE(minidump_file_writer.AddStream(std::move(test_memory_stream)));
+
+    StringMemorySnapshot snapshot(kAddress, contents);
+    memory_list_writer->AddFromSnapshot({&snapshot});
+    ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+
+    StringFile string_file;
+    ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+    // Recording doesn’t alter what’s written.
+    const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+    ASSERT_NO_FATAL_FAILURE(
+        GetMemoryListStream(string_file.string(), &memory_list, 2));
+    ASSERT_EQ(memory_list->NumberOfMemoryRanges, 2u);
+    EXPECT_EQ(memory_list->MemoryRanges[1].StartOfMemoryRange, kAddress);
+    EXPECT_EQ(memory_list->MemoryRanges[1].Memory.DataSize, contents.size());
+  }
+  EXPECT_EQ(base.page_count(), 4u);
+
+  // Change the page at 0x13000, which splits the unchanged pages into two runs.
+  contents[0x13010 - kAddress] = 'x';
+
+  MinidumpFileWriter minidump_file_writer;
+  auto test_memory_stream =
+      std::make_unique<TestMemoryStream>(kStackAddress, kStackSize, 's');
+  auto memory_list_writer = std::make_unique<MinidumpMemoryListWriter>();
+  auto delta_writer = std::make_unique<MinidumpDeltaWriter>();
+  memory_list_writer->SetDeltaBase(&base, delta_writer.get());
+  memory_list_writer->AddNonOwnedMemory(test_memory_stream->memory());
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(test_memory_stream)));
+
+  StringMemorySnapshot snapshot(kAddress, contents);
+  memory_list_writer->AddFromSnapshot({&snapshot});
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(memory_list_writer)));
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(delta_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MINIDUMP_MEMORY_LIST* memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetMemoryListStream(string_file.string(), &memory_list, 3));
+
+  struct {
+    uint64_t base;
+    uint64_t end;
+  } expected_ranges[] = {
+      {kStackAddress, kStackAddress + kStackSize},
+      {kAddress, 0x11000},
+      {0x13000, 0x14000},
+      {0x15000, kAddress + contents.size()},
+  };
+  ASSERT_EQ(memory_list->NumberOfMemoryRanges, std::size(expected_ranges));
+  for (size_t index = 0; index < std::size(expected_ranges); ++index) {
+    SCOPED_TRACE(base::StringPrintf("index %" PRIuS, index));
+    const MINIDUMP_MEMORY_DESCRIPTOR& descriptor =
+        memory_list->MemoryRanges[index];
+    EXPECT_EQ(descriptor.StartOfMemoryRange, expected_ranges[index].base);
+    ASSERT_EQ(descriptor.Memory.DataSize,
+              expected_ranges[index].end - expected_ranges[index].base);
+    if (index > 0) {
+      ASSERT_LE(descriptor.Memory.Rva + descriptor.Memory.DataSize,
+                string_file.string().size());
+      EXPECT_EQ(
+          string_file.string().substr(descriptor.Memory.Rva,
+                                      descriptor.Memory.DataSize),
+          contents.substr(descriptor.StartOfMemoryRange - kAddress,
+                          descriptor.Memory.DataSize));
+    }
+  }
+
+  const MINIDUMP_DIRECTORY* directory;
+  MinidumpHeaderAtStart(string_file.string(), &directory);
+  ASSERT_TRUE(directory);
+  ASSERT_EQ(directory[2].StreamType, kMinidumpStreamTypeCrashpadDelta);
+  const MinidumpDelta* delta =
+      MinidumpWritableAtLocationDescriptor<MinidumpDelta>(
+          string_file.string(), directory[2].Location);
+  ASSERT_TRUE(delta);
+  ASSERT_EQ(delta->count, 2u);
+  EXPECT_EQ(delta->ranges[0].start_of_memory_range, 0x11000u);
+  EXPECT_EQ(delta->ranges[0].data_size, 0x2000u);
+  EXPECT_EQ(delta->ranges[1].start_of_memory_range, 0x14000u);
+  EXPECT_EQ(delta->ranges[1].data_size, 0x1000u);
+}
+
 TEST(MinidumpMemoryWriter, AddFromSnapshot) {
   MINIDUMP_MEMORY_DESCRIPTOR expect_memory_descriptors[3] = {};
   uint8_t values[std::size(expect_memory_descriptors)] = {};
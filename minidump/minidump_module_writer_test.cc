@@ -18,7 +18,9 @@
 #include <string.h>
 
 #include <iterator>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/format_macros.h"
 #include "base/strings/stringprintf.h"
@@ -930,6 +932,67 @@ TEST(MinidumpModuleWriter, InitializeFromSnapshot) {
   }
 }
 
+void WriteModulesWithNames(const std::vector<std::string>& module_names,
+                           bool deduplicate_strings,
+                           StringFile* string_file) {
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.SetDeduplicateStrings(deduplicate_strings);
+  auto module_list_writer = std::make_unique<MinidumpModuleListWriter>();
+  for (const std::string& module_name : module_names) {
+    auto module_writer = std::make_unique<MinidumpModuleWriter>();
+    module_writer->SetName(module_name);
+    module_list_writer->AddModule(std::move(module_writer));
+  }
+  ASSERT_TRUE(minidump_file_writer.AddStream(std::move(module_list_writer)));
+
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(string_file));
+}
+
+TEST(MinidumpModuleWriter, DeduplicateStrings) {
+  const std::vector<std::string> module_names = {
+      "libshared.so", "libother.so", "libshared.so", "libshared.so"};
+
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteModulesWithNames(module_names, false, &string_file));
+
+  StringFile deduplicated_string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteModulesWithNames(module_names, true, &deduplicated_string_file));
+
+  // Two of the four names are written only once.
+  const size_t string_size =
+      sizeof(MINIDUMP_STRING) + (module_names[0].size() + 1) * sizeof(char16_t);
+  EXPECT_GE(string_file.string().size(),
+            deduplicated_string_file.string().size() + 2 * string_size);
+
+  const MINIDUMP_MODULE_LIST* module_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetModuleListStream(string_file.string(), &module_list));
+  ASSERT_EQ(module_list->NumberOfModules, module_names.size());
+  EXPECT_NE(module_list->Modules[0].ModuleNameRva,
+            module_list->Modules[2].ModuleNameRva);
+
+  ASSERT_NO_FATAL_FAILURE(
+      GetModuleListStream(deduplicated_string_file.string(), &module_list));
+  ASSERT_EQ(module_list->NumberOfModules, module_names.size());
+  EXPECT_NE(module_list->Modules[0].ModuleNameRva,
+            module_list->Modules[1].ModuleNameRva);
+  EXPECT_EQ(module_list->Modules[0].ModuleNameRva,
+            module_list->Modules[2].ModuleNameRva);
+  EXPECT_EQ(module_list->Modules[0].ModuleNameRva,
+            module_list->Modules[3].ModuleNameRva);
+
+  for (size_t index = 0; index < module_names.size(); ++index) {
+    SCOPED_TRACE(base::StringPrintf("index %" PRIuS, index));
+    EXPECT_EQ(
+        base::UTF16ToUTF8(MinidumpStringAtRVAAsString(
+            deduplicated_string_file.string(),
+            module_list->Modules[index].ModuleNameRva)),
+        module_names[index]);
+  }
+}
+
 TEST(MinidumpModuleWriterDeathTest, NoModuleName) {
   MinidumpFileWriter minidump_file_writer;
   auto module_list_writer = std::make_unique<MinidumpModuleListWriter>();
@@ -0,0 +1,450 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_repacker.h"
+
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/minidump_user_extension_stream_data_source.h"
+#include "snapshot/exception_snapshot.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/module_snapshot.h"
+#include "snapshot/process_snapshot.h"
+#include "snapshot/system_snapshot.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/buffered_file_reader.h"
+
+namespace crashpad {
+
+namespace {
+
+// The largest piece of a memory region read from the input at once. The input
+// is streamed to the output in pieces of this size rather than being read in
+// its entirety.
+constexpr size_t kMemoryBufferLimit = 1024 * 1024;
+
+// A SystemSnapshot that forwards to a SystemSnapshotMinidump, and provides
+// neutral values for the information that it does not interpret
+// (https://crashpad.chromium.org/bug/10), so that it can be written back out.
+class RepackSystemSnapshot final : public SystemSnapshot {
+ public:
+  explicit RepackSystemSnapshot(const SystemSnapshot* system)
+      : system_(system) {}
+
+  RepackSystemSnapshot(const RepackSystemSnapshot&) = delete;
+  RepackSystemSnapshot& operator=(const RepackSystemSnapshot&) = delete;
+
+  ~RepackSystemSnapshot() override {}
+
+  // SystemSnapshot:
+  CPUArchitecture GetCPUArchitecture() const override {
+    return system_->GetCPUArchitecture();
+  }
+  uint32_t CPURevision() const override { return system_->CPURevision(); }
+  uint8_t CPUCount() const override { return system_->CPUCount(); }
+  std::string CPUVendor() const override { return system_->CPUVendor(); }
+  void CPUFrequency(uint64_t* current_hz, uint64_t* max_hz) const override {
+    *current_hz = 0;
+    *max_hz = 0;
+  }
+  uint32_t CPUX86Signature() const override { return 0; }
+  uint64_t CPUX86Features() const override { return 0; }
+  uint64_t CPUX86ExtendedFeatures() const override { return 0; }
+  uint32_t CPUX86Leaf7Features() const override { return 0; }
+  bool CPUX86SupportsDAZ() const override { return false; }
+  OperatingSystem GetOperatingSystem() const override {
+    return system_->GetOperatingSystem();
+  }
+  bool OSServer() const override { return system_->OSServer(); }
+  void OSVersion(int* major,
+                 int* minor,
+                 int* bugfix,
+                 std::string* build) const override {
+    system_->OSVersion(major, minor, bugfix, build);
+  }
+  std::string OSVersionFull() const override {
+    return system_->OSVersionFull();
+  }
+  std::string MachineDescription() const override { return std::string(); }
+  bool NXEnabled() const override { return false; }
+  void TimeZone(DaylightSavingTimeStatus* dst_status,
+                int* standard_offset_seconds,
+                int* daylight_offset_seconds,
+                std::string* standard_name,
+                std::string* daylight_name) const override {
+    *dst_status = kDoesNotObserveDaylightSavingTime;
+    *standard_offset_seconds = 0;
+    *daylight_offset_seconds = 0;
+    standard_name->clear();
+    daylight_name->clear();
+  }
+  uint64_t AddressMask() const override { return 0; }
+
+ private:
+  const SystemSnapshot* system_;  // weak
+};
+
+// A ModuleSnapshot that forwards to a ModuleSnapshotMinidump. Streams that
+// modules contributed to the original minidump can’t be attributed to them
+// when it is read, so the module reports none, and they are carried over by
+// RepackMinidump() instead.
+class RepackModuleSnapshot final : public ModuleSnapshot {
+ public:
+  explicit RepackModuleSnapshot(const ModuleSnapshot* module)
+      : module_(module) {}
+
+  RepackModuleSnapshot(const RepackModuleSnapshot&) = delete;
+  RepackModuleSnapshot& operator=(const RepackModuleSnapshot&) = delete;
+
+  ~RepackModuleSnapshot() override {}
+
+  // ModuleSnapshot:
+  std::string Name() const override { return module_->Name(); }
+  uint64_t Address() const override { return module_->Address(); }
+  uint64_t Size() const override { return module_->Size(); }
+  time_t Timestamp() const override { return module_->Timestamp(); }
+  void FileVersion(uint16_t* version_0,
+                   uint16_t* version_1,
+                   uint16_t* version_2,
+                   uint16_t* version_3) const override {
+    module_->FileVersion(version_0, version_1, version_2, version_3);
+  }
+  void SourceVersion(uint16_t* version_0,
+                     uint16_t* version_1,
+                     uint16_t* version_2,
+                     uint16_t* version_3) const override {
+    module_->SourceVersion(version_0, version_1, version_2, version_3);
+  }
+  ModuleType GetModuleType() const override {
+    return module_->GetModuleType();
+  }
+  void UUIDAndAge(crashpad::UUID* uuid, uint32_t* age) const override {
+    module_->UUIDAndAge(uuid, age);
+  }
+  std::string DebugFileName() const override {
+    return module_->DebugFileName();
+  }
+  std::vector<uint8_t> BuildID() const override { return module_->BuildID(); }
+  std::vector<std::string> AnnotationsVector() const override {
+    return module_->AnnotationsVector();
+  }
+  std::map<std::string, std::string> AnnotationsSimpleMap() const override {
+    return module_->AnnotationsSimpleMap();
+  }
+  std::vector<AnnotationSnapshot> AnnotationObjects() const override {
+    return module_->AnnotationObjects();
+  }
+  std::set<CheckedRange<uint64_t>> ExtraMemoryRanges() const override {
+    return std::set<CheckedRange<uint64_t>>();
+  }
+  std::vector<const UserMinidumpStream*> CustomMinidumpStreams()
+      const override {
+    return std::vector<const UserMinidumpStream*>();
+  }
+
+ private:
+  const ModuleSnapshot* module_;  // weak
+};
+
+// A ThreadSnapshot that forwards to another, optionally without its stack or
+// name.
+class RepackThreadSnapshot final : public ThreadSnapshot {
+ public:
+  RepackThreadSnapshot(const ThreadSnapshot* thread,
+                       bool keep_stack,
+                       bool keep_name)
+      : thread_(thread), keep_stack_(keep_stack), keep_name_(keep_name) {}
+
+  RepackThreadSnapshot(const RepackThreadSnapshot&) = delete;
+  RepackThreadSnapshot& operator=(const RepackThreadSnapshot&) = delete;
+
+  ~RepackThreadSnapshot() override {}
+
+  // ThreadSnapshot:
+  const CPUContext* Context() const override { return thread_->Context(); }
+  const MemorySnapshot* Stack() const override {
+    return keep_stack_ ? thread_->Stack() : nullptr;
+  }
+  uint64_t ThreadID() const override { return thread_->ThreadID(); }
+  std::string ThreadName() const override {
+    return keep_name_ ? thread_->ThreadName() : std::string();
+  }
+  int SuspendCount() const override { return thread_->SuspendCount(); }
+  int Priority() const override { return thread_->Priority(); }
+  uint64_t ThreadSpecificDataAddress() const override {
+    return thread_->ThreadSpecificDataAddress();
+  }
+  std::vector<const MemorySnapshot*> ExtraMemory() const override {
+    return std::vector<const MemorySnapshot*>();
+  }
+  const ExtendedRegisterState* ExtendedRegisters() const override {
+    return thread_->ExtendedRegisters();
+  }
+  const ThreadSchedulingStats* SchedulingStats() const override {
+    return thread_->SchedulingStats();
+  }
+
+ private:
+  const ThreadSnapshot* thread_;  // weak
+  bool keep_stack_;
+  bool keep_name_;
+};
+
+// A ProcessSnapshot that forwards to a ProcessSnapshotMinidump, leaving out
+// whatever |options| asks to strip.
+class RepackProcessSnapshot final : public ProcessSnapshot {
+ public:
+  RepackProcessSnapshot(const ProcessSnapshotMinidump* process,
+                        const MinidumpRepackOptions& options)
+      : process_(process),
+        system_(process->System()),
+        modules_(),
+        threads_(),
+        stripped_stacks_(),
+        options_(options) {
+    for (const ModuleSnapshot* module : process->Modules()) {
+      modules_.push_back(std::make_unique<RepackModuleSnapshot>(module));
+    }
+
+    // Without an exception, there is no crashing thread to single out, so
+    // every stack is kept.
+    const ExceptionSnapshot* exception = process->Exception();
+    for (const ThreadSnapshot* thread : process->Threads()) {
+      const bool keep_stack = !options.crashing_thread_stack_only ||
+                              !exception ||
+                              thread->ThreadID() == exception->ThreadID();
+      if (!keep_stack && thread->Stack()) {
+        stripped_stacks_.push_back(thread->Stack());
+      }
+      threads_.push_back(std::make_unique<RepackThreadSnapshot>(
+          thread, keep_stack, !options.strip_thread_names));
+    }
+  }
+
+  RepackProcessSnapshot(const RepackProcessSnapshot&) = delete;
+  RepackProcessSnapshot& operator=(const RepackProcessSnapshot&) = delete;
+
+  ~RepackProcessSnapshot() override {}
+
+  // ProcessSnapshot:
+  crashpad::ProcessID ProcessID() const override {
+    return process_->ProcessID();
+  }
+  crashpad::ProcessID ParentProcessID() const override { return 0; }
+  void SnapshotTime(timeval* snapshot_time) const override {
+    process_->SnapshotTime(snapshot_time);
+  }
+  void ProcessStartTime(timeval* start_time) const override {
+    process_->ProcessStartTime(start_time);
+  }
+  void ProcessCPUTimes(timeval* user_time,
+                       timeval* system_time) const override {
+    process_->ProcessCPUTimes(user_time, system_time);
+  }
+  void ReportID(UUID* report_id) const override {
+    process_->ReportID(report_id);
+  }
+  void ClientID(UUID* client_id) const override {
+    process_->ClientID(client_id);
+  }
+  const std::map<std::string, std::string>& AnnotationsSimpleMap()
+      const override {
+    return process_->AnnotationsSimpleMap();
+  }
+  const SystemSnapshot* System() const override { return &system_; }
+  std::vector<const ThreadSnapshot*> Threads() const override {
+    std::vector<const ThreadSnapshot*> threads;
+    for (const auto& thread : threads_) {
+      threads.push_back(thread.get());
+    }
+    return threads;
+  }
+  std::vector<const ModuleSnapshot*> Modules() const override {
+    std::vector<const ModuleSnapshot*> modules;
+    for (const auto& module : modules_) {
+      modules.push_back(module.get());
+    }
+    return modules;
+  }
+  std::vector<UnloadedModuleSnapshot> UnloadedModules() const override {
+    return std::vector<UnloadedModuleSnapshot>();
+  }
+  const ExceptionSnapshot* Exception() const override {
+    return process_->Exception();
+  }
+  std::vector<const MemoryMapRegionSnapshot*> MemoryMap() const override {
+    if (options_.strip_memory_info) {
+      return std::vector<const MemoryMapRegionSnapshot*>();
+    }
+    return process_->MemoryMap();
+  }
+  std::vector<HandleSnapshot> Handles() const override {
+    return std::vector<HandleSnapshot>();
+  }
+  std::vector<const MemorySnapshot*> ExtraMemory() const override {
+    std::vector<const MemorySnapshot*> extra_memory;
+    if (options_.strip_extra_memory) {
+      return extra_memory;
+    }
+
+    // The memory list stream also lists each thread’s stack, so the copies of
+    // stacks that were stripped from their threads must be left out here too.
+    for (const MemorySnapshot* memory : process_->ExtraMemory()) {
+      bool within_stripped_stack = false;
+      for (const MemorySnapshot* stack : stripped_stacks_) {
+        if (memory->Address() >= stack->Address() &&
+            memory->Address() + memory->Size() <=
+                stack->Address() + stack->Size()) {
+          within_stripped_stack = true;
+          break;
+        }
+      }
+      if (!within_stripped_stack) {
+        extra_memory.push_back(memory);
+      }
+    }
+    return extra_memory;
+  }
+  const ProcessMemory* Memory() const override { return process_->Memory(); }
+
+ private:
+  const ProcessSnapshotMinidump* process_;  // weak
+  RepackSystemSnapshot system_;
+  std::vector<std::unique_ptr<RepackModuleSnapshot>> modules_;
+  std::vector<std::unique_ptr<RepackThreadSnapshot>> threads_;
+  std::vector<const MemorySnapshot*> stripped_stacks_;
+  MinidumpRepackOptions options_;
+};
+
+// Carries a stream that ProcessSnapshotMinidump does not interpret over to the
+// output unchanged.
+class CustomStreamDataSource final
+    : public MinidumpUserExtensionStreamDataSource {
+ public:
+  explicit CustomStreamDataSource(const MinidumpStream* stream)
+      : MinidumpUserExtensionStreamDataSource(stream->stream_type()),
+        stream_(stream) {}
+
+  CustomStreamDataSource(const CustomStreamDataSource&) = delete;
+  CustomStreamDataSource& operator=(const CustomStreamDataSource&) = delete;
+
+  ~CustomStreamDataSource() override {}
+
+  // MinidumpUserExtensionStreamDataSource:
+  size_t StreamDataSize() override { return stream_->data().size(); }
+  bool ReadStreamData(Delegate* delegate) override {
+    return delegate->ExtensionStreamDataSourceRead(stream_->data().data(),
+                                                   stream_->data().size());
+  }
+
+ private:
+  const MinidumpStream* stream_;  // weak
+};
+
+bool WriteRepackedMinidump(const ProcessSnapshotMinidump* process_snapshot,
+                           FileWriterInterface* output,
+                           const MinidumpRepackOptions& options) {
+  RepackProcessSnapshot repack_snapshot(process_snapshot, options);
+
+  MinidumpFileWriter minidump;
+  minidump.SetElideZeroMemory(options.elide_zero_memory);
+  if (options.compress_memory) {
+    minidump.SetCompressMemory(options.compress_memory,
+                               options.compress_block_size);
+  }
+  if (options.compact_memory_info) {
+    minidump.SetCompactMemoryInfo(true,
+                                  options.compact_memory_info_neighborhood);
+  }
+  minidump.SetMemoryBufferLimit(kMemoryBufferLimit);
+  minidump.SetDeduplicateStrings(true);
+  minidump.InitializeFromSnapshot(&repack_snapshot);
+
+  if (!options.strip_user_streams) {
+    for (const MinidumpStream* stream :
+         process_snapshot->CustomMinidumpStreams()) {
+      if (!minidump.AddUserExtensionStream(
+              std::make_unique<CustomStreamDataSource>(stream))) {
+        LOG(WARNING) << "discarding duplicate stream of type "
+                     << stream->stream_type();
+      }
+    }
+  }
+
+  return minidump.WriteEverything(output);
+}
+
+}  // namespace
+
+bool RepackMinidump(FileReaderInterface* input,
+                    FileWriterInterface* output,
+                    const MinidumpRepackOptions& options) {
+  BufferedFileReader buffered_reader(input);
+  ProcessSnapshotMinidump process_snapshot;
+  if (!process_snapshot.Initialize(&buffered_reader)) {
+    return false;
+  }
+
+  return WriteRepackedMinidump(&process_snapshot, output, options);
+}
+
+bool TrimMinidump(FileReaderInterface* input,
+                  FileOffset max_size,
+                  ChunkedMemoryFile* output,
+                  size_t* steps) {
+  // The input is interpreted once, and its memory is read again for each step.
+  BufferedFileReader buffered_reader(input);
+  ProcessSnapshotMinidump process_snapshot;
+  if (!process_snapshot.Initialize(&buffered_reader)) {
+    return false;
+  }
+
+  MinidumpRepackOptions options;
+  for (size_t step = 1; step <= kMinidumpTrimSteps; ++step) {
+    switch (step) {
+      case 1:
+        options.strip_extra_memory = true;
+        break;
+      case 2:
+        options.crashing_thread_stack_only = true;
+        break;
+      case 3:
+        options.strip_memory_info = true;
+        break;
+    }
+
+    output->Reset();
+    if (!WriteRepackedMinidump(&process_snapshot, output, options)) {
+      return false;
+    }
+
+    *steps = step;
+    if (base::checked_cast<FileOffset>(output->size()) <= max_size) {
+      break;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace crashpad
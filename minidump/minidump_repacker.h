@@ -0,0 +1,121 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_REPACKER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_REPACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "minidump/minidump_compressed_memory_list_writer.h"
+#include "util/file/chunked_memory_file.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief Options controlling what RepackMinidump() leaves out of, or
+//!     compacts in, the minidump that it writes.
+struct MinidumpRepackOptions {
+  //! \brief With #compact_memory_info, the distance from captured memory
+  //!     within which memory info is kept. See
+  //!     MinidumpFileWriter::SetCompactMemoryInfo().
+  uint64_t compact_memory_info_neighborhood = 0;
+
+  //! \brief The size at which memory regions are compressed, or `0` to
+  //!     compress none. See MinidumpFileWriter::SetCompressMemory().
+  size_t compress_memory = 0;
+
+  //! \brief The size of the blocks that memory is compressed in.
+  uint32_t compress_block_size =
+      MinidumpCompressedMemoryListWriter::kDefaultBlockSize;
+
+  //! \brief Whether to keep memory info only near captured memory, merging
+  //!     adjacent regions.
+  bool compact_memory_info = false;
+
+  //! \brief Whether to keep the stack of the crashing thread only. Without an
+  //!     exception, every stack is kept.
+  bool crashing_thread_stack_only = false;
+
+  //! \brief Whether to omit memory pages containing only zeroes.
+  bool elide_zero_memory = false;
+
+  //! \brief Whether to omit memory other than thread stacks, such as memory
+  //!     indirectly referenced from stacks.
+  bool strip_extra_memory = false;
+
+  //! \brief Whether to omit the memory info list stream.
+  bool strip_memory_info = false;
+
+  //! \brief Whether to omit the thread name list stream.
+  bool strip_thread_names = false;
+
+  //! \brief Whether to omit streams not defined by minidump or Crashpad.
+  bool strip_user_streams = false;
+};
+
+//! \brief Rewrites a minidump, leaving out whatever \a options asks to strip.
+//!
+//! The minidump is interpreted by ProcessSnapshotMinidump and written back out
+//! by MinidumpFileWriter. Streams that ProcessSnapshotMinidump doesn’t
+//! interpret are carried over unchanged, unless
+//! MinidumpRepackOptions::strip_user_streams is set. Information that
+//! ProcessSnapshotMinidump doesn’t interpret within the streams that it does,
+//! such as CPU features, is lost.
+//!
+//! \param[in] input The minidump to rewrite, read from its current position.
+//!     Memory is read from it while the output is written, in pieces rather
+//!     than in its entirety.
+//! \param[in] output The writer to write the rewritten minidump to.
+//! \param[in] options What to leave out of the rewritten minidump.
+//!
+//! \return `true` on success. `false` on failure, with a message logged.
+bool RepackMinidump(FileReaderInterface* input,
+                    FileWriterInterface* output,
+                    const MinidumpRepackOptions& options);
+
+//! \brief Rewrites a minidump, leaving out progressively more of its data
+//!     until it is no larger than a size limit.
+//!
+//! Data is left out in order of increasing importance, each step keeping what
+//! the steps before it left out:
+//!  1. Memory other than thread stacks, such as memory indirectly referenced
+//!     from stacks (MinidumpRepackOptions::strip_extra_memory).
+//!  2. The stacks of threads other than the crashing thread
+//!     (MinidumpRepackOptions::crashing_thread_stack_only).
+//!  3. The memory info list (MinidumpRepackOptions::strip_memory_info).
+//!
+//! \param[in] input The minidump to trim, read from its current position.
+//! \param[in] max_size The size that the trimmed minidump must not exceed.
+//! \param[out] output The trimmed minidump. This is reset before each step. If
+//!     no step fits within \a max_size, this holds the result of the last
+//!     one.
+//! \param[out] steps The number of steps taken, which is kMinidumpTrimSteps if
+//!     the result doesn’t fit within \a max_size.
+//!
+//! \return `true` if the minidump was rewritten, whether or not it fits within
+//!     \a max_size. `false` on failure, with a message logged.
+bool TrimMinidump(FileReaderInterface* input,
+                  FileOffset max_size,
+                  ChunkedMemoryFile* output,
+                  size_t* steps);
+
+//! \brief The number of steps that TrimMinidump() may take.
+constexpr size_t kMinidumpTrimSteps = 3;
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_REPACKER_H_
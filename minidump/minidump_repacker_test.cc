@@ -0,0 +1,200 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_repacker.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/minidump/process_snapshot_minidump.h"
+#include "snapshot/test/test_cpu_context.h"
+#include "snapshot/test/test_exception_snapshot.h"
+#include "snapshot/test/test_memory_map_region_snapshot.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "snapshot/test/test_process_snapshot.h"
+#include "snapshot/test/test_system_snapshot.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+#include "util/misc/uuid.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kCrashingThreadID = 1;
+constexpr uint64_t kOtherThreadID = 2;
+constexpr uint64_t kCrashingStackAddress = 0x10000;
+constexpr uint64_t kOtherStackAddress = 0x20000;
+constexpr size_t kStackSize = 0x4000;
+constexpr uint64_t kExtraMemoryAddress = 0x40000;
+constexpr size_t kExtraMemorySize = 0x10000;
+
+// Writes a minidump of a process with two threads, one of which crashed, extra
+// memory, and memory info to |string_file|.
+void WriteTestMinidump(StringFile* string_file) {
+  // ProcessSnapshotMinidump requires the Crashpad info stream, which is only
+  // written when there’s something to put in it.
+  UUID report_id;
+  ASSERT_TRUE(report_id.InitializeWithNew());
+  TestProcessSnapshot process_snapshot;
+  process_snapshot.SetReportID(report_id);
+
+  auto system_snapshot = std::make_unique<TestSystemSnapshot>();
+  system_snapshot->SetCPUArchitecture(kCPUArchitectureX86_64);
+  system_snapshot->SetOperatingSystem(SystemSnapshot::kOperatingSystemLinux);
+  process_snapshot.SetSystem(std::move(system_snapshot));
+
+  for (uint64_t thread_id : {kCrashingThreadID, kOtherThreadID}) {
+    auto thread_snapshot = std::make_unique<TestThreadSnapshot>();
+    InitializeCPUContextX86_64(thread_snapshot->MutableContext(), 5);
+    thread_snapshot->SetThreadID(thread_id);
+    auto stack = std::make_unique<TestMemorySnapshot>();
+    stack->SetAddress(thread_id == kCrashingThreadID ? kCrashingStackAddress
+                                                     : kOtherStackAddress);
+    stack->SetSize(kStackSize);
+    stack->SetValue('s');
+    thread_snapshot->SetStack(std::move(stack));
+    process_snapshot.AddThread(std::move(thread_snapshot));
+  }
+
+  auto exception_snapshot = std::make_unique<TestExceptionSnapshot>();
+  InitializeCPUContextX86_64(exception_snapshot->MutableContext(), 11);
+  exception_snapshot->SetThreadID(kCrashingThreadID);
+  process_snapshot.SetException(std::move(exception_snapshot));
+
+  auto extra_memory = std::make_unique<TestMemorySnapshot>();
+  extra_memory->SetAddress(kExtraMemoryAddress);
+  extra_memory->SetSize(kExtraMemorySize);
+  extra_memory->SetValue('e');
+  process_snapshot.AddExtraMemory(std::move(extra_memory));
+
+  MINIDUMP_MEMORY_INFO memory_info = {};
+  memory_info.BaseAddress = kCrashingStackAddress;
+  memory_info.RegionSize = kStackSize;
+  auto region_snapshot = std::make_unique<TestMemoryMapRegionSnapshot>();
+  region_snapshot->SetMindumpMemoryInfo(memory_info);
+  process_snapshot.AddMemoryMapRegion(std::move(region_snapshot));
+
+  MinidumpFileWriter minidump_file_writer;
+  minidump_file_writer.InitializeFromSnapshot(&process_snapshot);
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(string_file));
+  ASSERT_TRUE(string_file->SeekSet(0));
+}
+
+bool HasMemoryAt(const std::vector<const MemorySnapshot*>& memory,
+                 uint64_t address) {
+  for (const MemorySnapshot* snapshot : memory) {
+    if (snapshot->Address() == address) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(MinidumpRepacker, RepackMinidump) {
+  StringFile input;
+  ASSERT_NO_FATAL_FAILURE(WriteTestMinidump(&input));
+
+  MinidumpRepackOptions options;
+  options.crashing_thread_stack_only = true;
+  StringFile output;
+  ASSERT_TRUE(RepackMinidump(&input, &output, options));
+  EXPECT_LT(output.string().size(), input.string().size());
+
+  ASSERT_TRUE(output.SeekSet(0));
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&output));
+
+  const std::vector<const ThreadSnapshot*> threads = process_snapshot.Threads();
+  ASSERT_EQ(threads.size(), 2u);
+  EXPECT_EQ(threads[0]->ThreadID(), kCrashingThreadID);
+  EXPECT_EQ(threads[0]->Stack()->Address(), kCrashingStackAddress);
+  EXPECT_EQ(threads[0]->Stack()->Size(), kStackSize);
+  EXPECT_EQ(threads[1]->ThreadID(), kOtherThreadID);
+  EXPECT_EQ(threads[1]->Stack()->Size(), 0u);
+
+  const std::vector<const MemorySnapshot*> memory =
+      process_snapshot.ExtraMemory();
+  EXPECT_TRUE(HasMemoryAt(memory, kExtraMemoryAddress));
+  EXPECT_FALSE(HasMemoryAt(memory, kOtherStackAddress));
+  EXPECT_EQ(process_snapshot.MemoryMap().size(), 1u);
+}
+
+TEST(MinidumpRepacker, TrimMinidump) {
+  StringFile input;
+  ASSERT_NO_FATAL_FAILURE(WriteTestMinidump(&input));
+  const FileOffset input_size = input.string().size();
+
+  // The first step leaves out the extra memory, which is enough to fit.
+  ChunkedMemoryFile output;
+  size_t steps;
+  ASSERT_TRUE(TrimMinidump(&input, input_size - kExtraMemorySize / 2, &output,
+                           &steps));
+  EXPECT_EQ(steps, 1u);
+  const FileOffset step_1_size = output.size();
+  {
+    ASSERT_TRUE(output.SeekSet(0));
+    ProcessSnapshotMinidump process_snapshot;
+    ASSERT_TRUE(process_snapshot.Initialize(&output));
+    EXPECT_FALSE(
+        HasMemoryAt(process_snapshot.ExtraMemory(), kExtraMemoryAddress));
+    for (const ThreadSnapshot* thread : process_snapshot.Threads()) {
+      EXPECT_EQ(thread->Stack()->Size(), kStackSize);
+    }
+    EXPECT_EQ(process_snapshot.MemoryMap().size(), 1u);
+  }
+
+  // The second step also leaves out the stack of the thread that didn’t
+  // crash.
+  ASSERT_TRUE(input.SeekSet(0));
+  ASSERT_TRUE(TrimMinidump(&input, step_1_size - 1, &output, &steps));
+  EXPECT_EQ(steps, 2u);
+  EXPECT_LE(FileOffset(output.size()), step_1_size - FileOffset{kStackSize});
+  const FileOffset step_2_size = output.size();
+  {
+    ASSERT_TRUE(output.SeekSet(0));
+    ProcessSnapshotMinidump process_snapshot;
+    ASSERT_TRUE(process_snapshot.Initialize(&output));
+    const std::vector<const ThreadSnapshot*> threads =
+        process_snapshot.Threads();
+    ASSERT_EQ(threads.size(), 2u);
+    EXPECT_EQ(threads[0]->Stack()->Size(), kStackSize);
+    EXPECT_EQ(threads[1]->Stack()->Size(), 0u);
+    EXPECT_EQ(process_snapshot.MemoryMap().size(), 1u);
+  }
+
+  // The last step also leaves out the memory info. If that still doesn’t fit,
+  // the result of the last step is returned anyway.
+  ASSERT_TRUE(input.SeekSet(0));
+  ASSERT_TRUE(TrimMinidump(&input, 1, &output, &steps));
+  EXPECT_EQ(steps, kMinidumpTrimSteps);
+  EXPECT_LT(FileOffset(output.size()), step_2_size);
+  {
+    ASSERT_TRUE(output.SeekSet(0));
+    ProcessSnapshotMinidump process_snapshot;
+    ASSERT_TRUE(process_snapshot.Initialize(&output));
+    EXPECT_EQ(process_snapshot.Threads().size(), 2u);
+    EXPECT_TRUE(process_snapshot.MemoryMap().empty());
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -27,7 +27,10 @@ namespace internal {
 
 template <typename Traits>
 MinidumpStringWriter<Traits>::MinidumpStringWriter()
-    : MinidumpWritable(), string_base_(new MinidumpStringType()), string_() {
+    : MinidumpWritable(),
+      string_base_(new MinidumpStringType()),
+      string_(),
+      duplicate_(false) {
 }
 
 template <typename Traits>
@@ -55,15 +58,35 @@ template <typename Traits>
 size_t MinidumpStringWriter<Traits>::SizeOfObject() {
   DCHECK_GE(state(), kStateFrozen);
 
+  if (duplicate_) {
+    return 0;
+  }
+
   // Include the NUL terminator.
   return sizeof(*string_base_) + (string_.size() + 1) * sizeof(string_[0]);
 }
 
+template <typename Traits>
+void MinidumpStringWriter<Traits>::InternStrings(
+    MinidumpStringTable* string_table) {
+  DCHECK_EQ(state(), kStateFrozen);
+
+  MinidumpStringWriter* canonical = string_table->Intern(string_, this);
+  if (canonical != this) {
+    TransferRegisteredPointers(canonical);
+    duplicate_ = true;
+  }
+}
+
 template <typename Traits>
 bool MinidumpStringWriter<Traits>::WriteObject(
     FileWriterInterface* file_writer) {
   DCHECK_EQ(state(), kStateWritable);
 
+  if (duplicate_) {
+    return true;
+  }
+
   // The string’s length is stored in string_base_, and its data is stored in
   // string_. Write them both.
   WritableIoVec iov;
@@ -84,6 +107,27 @@ bool MinidumpStringWriter<Traits>::WriteObject(
 template class MinidumpStringWriter<MinidumpStringWriterUTF16Traits>;
 template class MinidumpStringWriter<MinidumpStringWriterUTF8Traits>;
 
+MinidumpStringTable::MinidumpStringTable()
+    : utf16_strings_(), utf8_strings_() {
+}
+
+MinidumpStringTable::~MinidumpStringTable() {
+}
+
+MinidumpStringWriter<MinidumpStringWriterUTF16Traits>*
+MinidumpStringTable::Intern(
+    const std::u16string& string,
+    MinidumpStringWriter<MinidumpStringWriterUTF16Traits>* writer) {
+  return utf16_strings_.emplace(string, writer).first->second;
+}
+
+MinidumpStringWriter<MinidumpStringWriterUTF8Traits>*
+MinidumpStringTable::Intern(
+    const std::string& string,
+    MinidumpStringWriter<MinidumpStringWriterUTF8Traits>* writer) {
+  return utf8_strings_.emplace(string, writer).first->second;
+}
+
 MinidumpUTF16StringWriter::~MinidumpUTF16StringWriter() {
 }
 
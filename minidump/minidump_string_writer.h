@@ -19,8 +19,10 @@
 #include <dbghelp.h>
 #include <sys/types.h>
 
+#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "minidump/minidump_extensions.h"
@@ -44,6 +46,8 @@ struct MinidumpStringWriterUTF8Traits {
 
 //! \endcond
 
+class MinidumpStringTable;
+
 //! \brief Writes a variable-length string to a minidump file in accordance with
 //!     the string type’s characteristics.
 //!
@@ -66,6 +70,7 @@ class MinidumpStringWriter : public MinidumpWritable {
 
   bool Freeze() override;
   size_t SizeOfObject() override;
+  void InternStrings(MinidumpStringTable* string_table) override;
   bool WriteObject(FileWriterInterface* file_writer) override;
 
   //! \brief Sets the string to be written.
@@ -81,6 +86,43 @@ class MinidumpStringWriter : public MinidumpWritable {
  private:
   std::unique_ptr<MinidumpStringType> string_base_;
   StringType string_;
+
+  // Set by InternStrings() when an identical string will be written in this
+  // object’s place.
+  bool duplicate_;
+};
+
+//! \brief Tracks the strings to be written to a minidump file, so that
+//!     identical strings can be written once.
+//!
+//! \sa MinidumpWritable::InternStrings()
+class MinidumpStringTable {
+ public:
+  MinidumpStringTable();
+
+  MinidumpStringTable(const MinidumpStringTable&) = delete;
+  MinidumpStringTable& operator=(const MinidumpStringTable&) = delete;
+
+  ~MinidumpStringTable();
+
+  //! \brief Returns the first writer interned with the same \a string, or \a
+  //!     writer if this is the first time \a string has been interned.
+  //!
+  //! \a string must remain valid for the lifetime of this object.
+  MinidumpStringWriter<MinidumpStringWriterUTF16Traits>* Intern(
+      const std::u16string& string,
+      MinidumpStringWriter<MinidumpStringWriterUTF16Traits>* writer);
+  MinidumpStringWriter<MinidumpStringWriterUTF8Traits>* Intern(
+      const std::string& string,
+      MinidumpStringWriter<MinidumpStringWriterUTF8Traits>* writer);
+
+ private:
+  std::map<std::u16string_view,
+           MinidumpStringWriter<MinidumpStringWriterUTF16Traits>*>
+      utf16_strings_;  // weak
+  std::map<std::string_view,
+           MinidumpStringWriter<MinidumpStringWriterUTF8Traits>*>
+      utf8_strings_;  // weak
 };
 
 //! \brief Writes a variable-length UTF-16-encoded MINIDUMP_STRING to a minidump
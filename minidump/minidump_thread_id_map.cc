@@ -14,53 +14,102 @@
 
 #include "minidump/minidump_thread_id_map.h"
 
+#include <algorithm>
 #include <limits>
-#include <set>
 #include <utility>
 
 #include "base/check_op.h"
-#include "base/numerics/safe_conversions.h"
 #include "snapshot/thread_snapshot.h"
 
 namespace crashpad {
 
+namespace {
+
+bool KeyLess(const MinidumpThreadIDMap::value_type& entry,
+             uint64_t thread_id_64) {
+  return entry.first < thread_id_64;
+}
+
+}  // namespace
+
+MinidumpThreadIDMap::MinidumpThreadIDMap() : entries_() {}
+
+MinidumpThreadIDMap::~MinidumpThreadIDMap() {}
+
+MinidumpThreadIDMap::const_iterator MinidumpThreadIDMap::find(
+    uint64_t thread_id_64) const {
+  const auto it =
+      std::lower_bound(entries_.begin(), entries_.end(), thread_id_64, KeyLess);
+  if (it == entries_.end() || it->first != thread_id_64) {
+    return entries_.end();
+  }
+  return it;
+}
+
+std::pair<MinidumpThreadIDMap::iterator, bool> MinidumpThreadIDMap::insert(
+    const value_type& value) {
+  const auto it =
+      std::lower_bound(entries_.begin(), entries_.end(), value.first, KeyLess);
+  if (it != entries_.end() && it->first == value.first) {
+    return std::make_pair(it, false);
+  }
+  return std::make_pair(entries_.insert(it, value), true);
+}
+
+uint32_t& MinidumpThreadIDMap::operator[](uint64_t thread_id_64) {
+  return insert(std::make_pair(thread_id_64, 0u)).first->second;
+}
+
 void BuildMinidumpThreadIDMap(
     const std::vector<const ThreadSnapshot*>& thread_snapshots,
     MinidumpThreadIDMap* thread_id_map) {
   DCHECK(thread_id_map->empty());
 
+  // Gather the unique 64-bit thread IDs in sorted order, which is the order
+  // the map keeps them in.
+  std::vector<MinidumpThreadIDMap::value_type>& entries =
+      thread_id_map->entries_;
+  entries.reserve(thread_snapshots.size());
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    entries.emplace_back(thread_snapshot->ThreadID(), 0);
+  }
+  std::sort(entries.begin(), entries.end());
+  entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
   // First, try truncating each 64-bit thread ID to 32 bits. If that’s possible
   // for each unique 64-bit thread ID, then this will be used as the mapping.
   // This preserves as much of the original thread ID as possible when feasible.
-  bool collision = false;
-  std::set<uint32_t> thread_ids_32;
-  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
-    uint64_t thread_id_64 = thread_snapshot->ThreadID();
-    if (thread_id_map->find(thread_id_64) == thread_id_map->end()) {
-      uint32_t thread_id_32 = static_cast<uint32_t>(thread_id_64);
-      if (!thread_ids_32.insert(thread_id_32).second) {
-        collision = true;
-        break;
-      }
-      thread_id_map->insert(std::make_pair(thread_id_64, thread_id_32));
-    }
+  std::vector<uint32_t> thread_ids_32;
+  thread_ids_32.reserve(entries.size());
+  for (auto& entry : entries) {
+    entry.second = static_cast<uint32_t>(entry.first);
+    thread_ids_32.push_back(entry.second);
   }
+  std::sort(thread_ids_32.begin(), thread_ids_32.end());
+  const bool collision =
+      std::adjacent_find(thread_ids_32.begin(), thread_ids_32.end()) !=
+      thread_ids_32.end();
 
   if (collision) {
     // Since there was a collision, go back and assign each unique 64-bit thread
-    // ID its own sequential 32-bit equivalent. The 32-bit thread IDs will not
-    // bear any resemblance to the original 64-bit thread IDs.
-    thread_id_map->clear();
+    // ID its own sequential 32-bit equivalent, in the order that the thread IDs
+    // first appear. The 32-bit thread IDs will not bear any resemblance to the
+    // original 64-bit thread IDs.
+    DCHECK_LE(entries.size(), std::numeric_limits<uint32_t>::max());
+    std::vector<bool> assigned(entries.size(), false);
+    uint32_t next_thread_id_32 = 0;
     for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
-      uint64_t thread_id_64 = thread_snapshot->ThreadID();
-      if (thread_id_map->find(thread_id_64) == thread_id_map->end()) {
-        uint32_t thread_id_32 =
-            base::checked_cast<uint32_t>(thread_id_map->size());
-        thread_id_map->insert(std::make_pair(thread_id_64, thread_id_32));
+      const auto it = std::lower_bound(entries.begin(),
+                                       entries.end(),
+                                       thread_snapshot->ThreadID(),
+                                       KeyLess);
+      DCHECK(it != entries.end());
+      const size_t index = it - entries.begin();
+      if (!assigned[index]) {
+        assigned[index] = true;
+        it->second = next_thread_id_32++;
       }
     }
-
-    DCHECK_LE(thread_id_map->size(), std::numeric_limits<uint32_t>::max());
   }
 }
 
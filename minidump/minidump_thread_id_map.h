@@ -15,9 +15,10 @@
 #ifndef CRASHPAD_MINIDUMP_MINIDUMP_THREAD_ID_MAP_H_
 #define CRASHPAD_MINIDUMP_MINIDUMP_THREAD_ID_MAP_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
-#include <map>
+#include <utility>
 #include <vector>
 
 namespace crashpad {
@@ -32,7 +33,51 @@ class ThreadSnapshot;
 //!
 //! A ThreadIDMap ensures that there are no collisions among the set of 32-bit
 //! minidump thread IDs.
-using MinidumpThreadIDMap = std::map<uint64_t, uint32_t>;
+//!
+//! The entries are kept in a single vector sorted by 64-bit thread ID, rather
+//! than in a node per thread, so that building the map for a process with many
+//! threads makes few allocations and each lookup is a binary search over
+//! contiguous memory. The interface is the subset of `std::map` used by the
+//! minidump writers.
+class MinidumpThreadIDMap {
+ public:
+  using value_type = std::pair<uint64_t, uint32_t>;
+  using iterator = std::vector<value_type>::iterator;
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  MinidumpThreadIDMap();
+  ~MinidumpThreadIDMap();
+
+  //! \brief Reserves storage for \a count entries.
+  void reserve(size_t count) { entries_.reserve(count); }
+
+  bool empty() const { return entries_.empty(); }
+  size_t size() const { return entries_.size(); }
+  void clear() { entries_.clear(); }
+
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  //! \brief Returns the entry for \a thread_id_64, or end() if there is none.
+  const_iterator find(uint64_t thread_id_64) const;
+
+  //! \brief Inserts \a value if no entry has its key.
+  //!
+  //! \return The entry with the key of \a value, and `true` if it was
+  //!     inserted or `false` if it was already present.
+  std::pair<iterator, bool> insert(const value_type& value);
+
+  //! \brief Returns the 32-bit thread ID for \a thread_id_64, inserting an
+  //!     entry mapping it to `0` if there is none.
+  uint32_t& operator[](uint64_t thread_id_64);
+
+ private:
+  friend void BuildMinidumpThreadIDMap(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      MinidumpThreadIDMap* thread_id_map);
+
+  std::vector<value_type> entries_;  // Sorted by first.
+};
 
 //! \brief Builds a MinidumpThreadIDMap for a group of ThreadSnapshot objects.
 //!
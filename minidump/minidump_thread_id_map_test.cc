@@ -17,6 +17,7 @@
 #include <sys/types.h>
 
 #include <iterator>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -188,6 +189,30 @@ TEST_F(MinidumpThreadIDMapTest, AllDuplicates) {
   EXPECT_PRED3(MapHasKeyValue, &thread_id_map, 6, 6);
 }
 
+TEST(MinidumpThreadIDMap, Insert) {
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map.reserve(3);
+
+  EXPECT_TRUE(thread_id_map.insert(std::make_pair(30, 3)).second);
+  EXPECT_TRUE(thread_id_map.insert(std::make_pair(10, 1)).second);
+  thread_id_map[20] = 2;
+  EXPECT_FALSE(thread_id_map.insert(std::make_pair(10, 4)).second);
+  thread_id_map[30] = 5;
+
+  ASSERT_EQ(thread_id_map.size(), 3u);
+  auto it = thread_id_map.begin();
+  EXPECT_EQ(*it++, std::make_pair(uint64_t{10}, uint32_t{1}));
+  EXPECT_EQ(*it++, std::make_pair(uint64_t{20}, uint32_t{2}));
+  EXPECT_EQ(*it++, std::make_pair(uint64_t{30}, uint32_t{5}));
+  EXPECT_EQ(it, thread_id_map.end());
+
+  EXPECT_EQ(thread_id_map.find(15), thread_id_map.end());
+  EXPECT_EQ(thread_id_map.find(40), thread_id_map.end());
+
+  thread_id_map.clear();
+  EXPECT_TRUE(thread_id_map.empty());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
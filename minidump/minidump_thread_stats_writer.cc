@@ -0,0 +1,112 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_thread_stats_writer.h"
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "snapshot/thread_snapshot.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpThreadStatsListWriter::MinidumpThreadStatsListWriter()
+    : MinidumpStreamWriter(), thread_stats_list_base_(), entries_() {}
+
+MinidumpThreadStatsListWriter::~MinidumpThreadStatsListWriter() = default;
+
+void MinidumpThreadStatsListWriter::InitializeFromSnapshot(
+    const std::vector<const ThreadSnapshot*>& thread_snapshots,
+    const MinidumpThreadIDMap& thread_id_map) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK(entries_.empty());
+
+  for (const ThreadSnapshot* thread_snapshot : thread_snapshots) {
+    const ThreadSchedulingStats* stats = thread_snapshot->SchedulingStats();
+    if (stats) {
+      const auto it = thread_id_map.find(thread_snapshot->ThreadID());
+      DCHECK(it != thread_id_map.end());
+      AddThreadStats(it->second, *stats);
+    }
+  }
+}
+
+void MinidumpThreadStatsListWriter::AddThreadStats(
+    uint32_t thread_id,
+    const ThreadSchedulingStats& stats) {
+  DCHECK_EQ(state(), kStateMutable);
+
+  MinidumpThreadStats entry = {};
+  entry.thread_id = thread_id;
+  entry.state = static_cast<uint8_t>(stats.state);
+  entry.last_cpu = stats.last_cpu;
+  entry.user_time_us = stats.user_time_us;
+  entry.system_time_us = stats.system_time_us;
+  if (stats.have_context_switches) {
+    entry.flags |= kMinidumpThreadStatsHaveContextSwitches;
+    entry.voluntary_context_switches = stats.voluntary_context_switches;
+    entry.involuntary_context_switches = stats.involuntary_context_switches;
+  }
+  entries_.push_back(entry);
+}
+
+bool MinidumpThreadStatsListWriter::IsUseful() const {
+  return !entries_.empty();
+}
+
+bool MinidumpThreadStatsListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  if (!AssignIfInRange(&thread_stats_list_base_.count, entries_.size())) {
+    LOG(ERROR) << "entry count " << entries_.size() << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpThreadStatsListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+  return sizeof(thread_stats_list_base_) +
+         sizeof(MinidumpThreadStats) * entries_.size();
+}
+
+bool MinidumpThreadStatsListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &thread_stats_list_base_;
+  iov.iov_len = sizeof(thread_stats_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!entries_.empty()) {
+    iov.iov_base = entries_.data();
+    iov.iov_len = sizeof(MinidumpThreadStats) * entries_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpThreadStatsListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadThreadStats;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_THREAD_STATS_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_THREAD_STATS_WRITER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_thread_id_map.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+class ThreadSnapshot;
+struct ThreadSchedulingStats;
+
+//! \brief The writer for a MinidumpThreadStatsList stream in a minidump file,
+//!     containing the CPU usage and scheduling state of each thread that has
+//!     it.
+class MinidumpThreadStatsListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpThreadStatsListWriter();
+
+  MinidumpThreadStatsListWriter(const MinidumpThreadStatsListWriter&) = delete;
+  MinidumpThreadStatsListWriter& operator=(
+      const MinidumpThreadStatsListWriter&) = delete;
+
+  ~MinidumpThreadStatsListWriter() override;
+
+  //! \brief Adds an entry for each thread in \a thread_snapshots that has
+  //!     scheduling statistics.
+  //!
+  //! \param[in] thread_snapshots The thread snapshots to use as source data.
+  //! \param[in] thread_id_map A MinidumpThreadIDMap previously built by
+  //!     MinidumpThreadListWriter::InitializeFromSnapshot().
+  //!
+  //! \note Valid in #kStateMutable.
+  void InitializeFromSnapshot(
+      const std::vector<const ThreadSnapshot*>& thread_snapshots,
+      const MinidumpThreadIDMap& thread_id_map);
+
+  //! \brief Adds an entry for \a stats.
+  //!
+  //! \param[in] thread_id The minidump thread ID of the thread that \a stats
+  //!     belongs to.
+  //! \param[in] stats The statistics to add.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddThreadStats(uint32_t thread_id, const ThreadSchedulingStats& stats);
+
+  //! \brief Determines whether the object is useful.
+  //!
+  //! A useful object is one that carries data that makes a meaningful
+  //! contribution to a minidump file. An object carrying no entries is not
+  //! considered useful.
+  //!
+  //! \return `true` if the object is useful, `false` otherwise.
+  bool IsUseful() const;
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpThreadStatsList thread_stats_list_base_;
+  std::vector<MinidumpThreadStats> entries_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_THREAD_STATS_WRITER_H_
@@ -0,0 +1,162 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_thread_stats_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "snapshot/test/test_thread_snapshot.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The thread stats list is expected to be the only stream.
+void GetThreadStatsListStream(
+    const std::string& file_contents,
+    const MinidumpThreadStatsList** thread_stats_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kThreadStatsListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadThreadStats);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kThreadStatsListStreamOffset);
+
+  *thread_stats_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpThreadStatsList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*thread_stats_list);
+}
+
+TEST(MinidumpThreadStatsListWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto thread_stats_list_writer =
+      std::make_unique<MinidumpThreadStatsListWriter>();
+  EXPECT_FALSE(thread_stats_list_writer->IsUseful());
+
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(thread_stats_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpThreadStatsList));
+
+  const MinidumpThreadStatsList* thread_stats_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetThreadStatsListStream(string_file.string(), &thread_stats_list));
+
+  EXPECT_EQ(thread_stats_list->count, 0u);
+}
+
+TEST(MinidumpThreadStatsListWriter, InitializeFromSnapshot) {
+  ThreadSchedulingStats stats_0 = {};
+  stats_0.user_time_us = 1500000;
+  stats_0.system_time_us = 250000;
+  stats_0.voluntary_context_switches = 12;
+  stats_0.involuntary_context_switches = 3;
+  stats_0.last_cpu = 2;
+  stats_0.state = 'R';
+  stats_0.have_context_switches = true;
+
+  // Context switch counts that weren’t read aren’t written.
+  ThreadSchedulingStats stats_2 = {};
+  stats_2.user_time_us = 10;
+  stats_2.voluntary_context_switches = 7;
+  stats_2.last_cpu = -1;
+  stats_2.state = 'S';
+
+  TestThreadSnapshot thread_0;
+  thread_0.SetThreadID(0x1000);
+  thread_0.SetSchedulingStats(stats_0);
+  TestThreadSnapshot thread_1;
+  thread_1.SetThreadID(0x1001);
+  TestThreadSnapshot thread_2;
+  thread_2.SetThreadID(0x1002);
+  thread_2.SetSchedulingStats(stats_2);
+  const std::vector<const ThreadSnapshot*> thread_snapshots = {
+      &thread_0, &thread_1, &thread_2};
+
+  MinidumpThreadIDMap thread_id_map;
+  thread_id_map[0x1000] = 0;
+  thread_id_map[0x1001] = 1;
+  thread_id_map[0x1002] = 2;
+
+  MinidumpFileWriter minidump_file_writer;
+  auto thread_stats_list_writer =
+      std::make_unique<MinidumpThreadStatsListWriter>();
+  thread_stats_list_writer->InitializeFromSnapshot(thread_snapshots,
+                                                   thread_id_map);
+  EXPECT_TRUE(thread_stats_list_writer->IsUseful());
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(thread_stats_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  const MinidumpThreadStatsList* thread_stats_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetThreadStatsListStream(string_file.string(), &thread_stats_list));
+
+  ASSERT_EQ(thread_stats_list->count, 2u);
+
+  MinidumpThreadStats entry;
+  memcpy(&entry, &thread_stats_list->entries[0], sizeof(entry));
+  EXPECT_EQ(entry.thread_id, 0u);
+  EXPECT_EQ(entry.flags,
+            static_cast<uint32_t>(kMinidumpThreadStatsHaveContextSwitches));
+  EXPECT_EQ(entry.state, 'R');
+  EXPECT_EQ(entry.last_cpu, 2);
+  EXPECT_EQ(entry.user_time_us, 1500000u);
+  EXPECT_EQ(entry.system_time_us, 250000u);
+  EXPECT_EQ(entry.voluntary_context_switches, 12u);
+  EXPECT_EQ(entry.involuntary_context_switches, 3u);
+
+  memcpy(&entry, &thread_stats_list->entries[1], sizeof(entry));
+  EXPECT_EQ(entry.thread_id, 2u);
+  EXPECT_EQ(entry.flags, 0u);
+  EXPECT_EQ(entry.state, 'S');
+  EXPECT_EQ(entry.last_cpu, -1);
+  EXPECT_EQ(entry.user_time_us, 10u);
+  EXPECT_EQ(entry.system_time_us, 0u);
+  EXPECT_EQ(entry.voluntary_context_switches, 0u);
+  EXPECT_EQ(entry.involuntary_context_switches, 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -15,27 +15,151 @@
 #include "minidump/minidump_writable.h"
 
 #include <stdint.h>
+#include <stdio.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <new>
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "base/notreached.h"
+#include "minidump/minidump_string_writer.h"
+#include "minidump/minidump_writable_arena.h"
 #include "util/file/file_writer.h"
+#include "util/file/write_combining_file_writer.h"
 #include "util/numeric/safe_assignment.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace internal {
 
 namespace {
 
 constexpr size_t kMaximumAlignment = 16;
 
-}  // namespace
+// Each allocation made by MinidumpWritable::operator new() is preceded by a
+// header recording the arena that it was obtained from, or nullptr if it was
+// obtained from the heap. The header’s size preserves the alignment of the
+// allocation that follows it.
+constexpr size_t kAllocationHeaderSize = alignof(std::max_align_t);
+static_assert(kAllocationHeaderSize >= sizeof(MinidumpWritableArena*),
+              "allocation header too small");
 
-namespace crashpad {
-namespace internal {
+// Writes to consecutive offsets of another file writer with WriteAtOffset(),
+// beginning at a fixed offset.
+class OffsetFileWriter final : public FileWriterInterface {
+ public:
+  OffsetFileWriter(FileWriterInterface* file_writer, FileOffset offset)
+      : file_writer_(file_writer), offset_(offset) {}
+
+  OffsetFileWriter(const OffsetFileWriter&) = delete;
+  OffsetFileWriter& operator=(const OffsetFileWriter&) = delete;
+
+  ~OffsetFileWriter() override = default;
+
+  // FileWriterInterface:
+
+  bool Write(const void* data, size_t size) override {
+    if (!file_writer_->WriteAtOffset(offset_, data, size)) {
+      return false;
+    }
+    offset_ += size;
+    return true;
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    if (iovecs->empty()) {
+      LOG(ERROR) << "WriteIoVec(): no iovecs";
+      return false;
+    }
+    for (const WritableIoVec& iov : *iovecs) {
+      if (!Write(iov.iov_base, iov.iov_len)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // FileSeekerInterface:
+
+  FileOffset Seek(FileOffset offset, int whence) override {
+    NOTREACHED();
+    return -1;
+  }
+
+ private:
+  FileWriterInterface* file_writer_;  // weak
+  FileOffset offset_;
+};
+
+// Runs a function on a thread of its own.
+class FunctionThread final : public Thread {
+ public:
+  explicit FunctionThread(const std::function<void()>& function)
+      : Thread(), function_(function) {}
+
+  FunctionThread(const FunctionThread&) = delete;
+  FunctionThread& operator=(const FunctionThread&) = delete;
+
+  ~FunctionThread() override = default;
+
+ private:
+  // Thread:
+  void ThreadMain() override { function_(); }
+
+  std::function<void()> function_;
+};
+
+}  // namespace
 
 MinidumpWritable::~MinidumpWritable() {
 }
 
+// static
+void* MinidumpWritable::operator new(size_t size) {
+  MinidumpWritableArena* arena = MinidumpWritableArena::Current();
+  const size_t allocation_size = kAllocationHeaderSize + size;
+  void* header = arena ? arena->Allocate(allocation_size)
+                       : ::operator new(allocation_size);
+  *static_cast<MinidumpWritableArena**>(header) = arena;
+  return static_cast<char*>(header) + kAllocationHeaderSize;
+}
+
+// static
+void MinidumpWritable::operator delete(void* pointer) {
+  if (!pointer) {
+    return;
+  }
+
+  void* header = static_cast<char*>(pointer) - kAllocationHeaderSize;
+  MinidumpWritableArena* arena = *static_cast<MinidumpWritableArena**>(header);
+  if (arena) {
+    arena->Release(header);
+  } else {
+    ::operator delete(header);
+  }
+}
+
 bool MinidumpWritable::WriteEverything(FileWriterInterface* file_writer) {
+  return WriteEverythingWithMemoryBufferLimit(file_writer, 0);
+}
+
+bool MinidumpWritable::WriteEverythingWithMemoryBufferLimit(
+    FileWriterInterface* file_writer,
+    size_t memory_buffer_limit) {
+  WriteOptions options;
+  options.memory_buffer_limit = memory_buffer_limit;
+  return WriteEverythingWithOptions(file_writer, options);
+}
+
+bool MinidumpWritable::WriteEverythingWithOptions(
+    FileWriterInterface* file_writer,
+    const WriteOptions& options) {
   DCHECK_EQ(state_, kStateMutable);
 
   if (!Freeze()) {
@@ -44,6 +168,11 @@ bool MinidumpWritable::WriteEverything(FileWriterInterface* file_writer) {
 
   DCHECK_EQ(state_, kStateFrozen);
 
+  if (options.deduplicate_strings) {
+    MinidumpStringTable string_table;
+    InternStrings(&string_table);
+  }
+
   FileOffset offset = 0;
   std::vector<MinidumpWritable*> write_sequence;
   size_t size = WillWriteAtOffset(kPhaseEarly, &offset, &write_sequence);
@@ -52,15 +181,68 @@ bool MinidumpWritable::WriteEverything(FileWriterInterface* file_writer) {
   }
 
   offset += size;
-  if (WillWriteAtOffset(kPhaseLate, &offset, &write_sequence) == kInvalidSize) {
+  size = WillWriteAtOffset(kPhaseLate, &offset, &write_sequence);
+  if (size == kInvalidSize) {
     return false;
   }
 
   DCHECK_EQ(state_, kStateWritable);
   DCHECK_EQ(write_sequence.front(), this);
 
+  if (options.memory_buffer_limit) {
+    for (MinidumpWritable* writable : write_sequence) {
+      writable->WillWriteWithMemoryBufferLimit(options.memory_buffer_limit);
+    }
+  }
+
+  // The size of everything to be written is now known. Reserving storage for
+  // it up front avoids fragmenting the file as it grows. This is only an
+  // optimization, so failure is not fatal.
+  file_writer->Preallocate(offset + size);
+
+  // Objects to be written concurrently need to know where the minidump
+  // begins, because they are written at absolute offsets.
+  FileOffset start_offset = -1;
+  if (options.concurrent_write_threads > 0 &&
+      file_writer->SupportsWriteAtOffset()) {
+    start_offset = file_writer->Seek(0, SEEK_CUR);
+    if (start_offset < 0) {
+      return false;
+    }
+  }
+
+  // Most objects and all padding are small, so combine them into fewer writes
+  // to file_writer. Room is left for objects to be written concurrently.
+  std::vector<MinidumpWritable*> concurrent_writables;
+  WriteCombiningFileWriter combining_file_writer(file_writer);
   for (MinidumpWritable* writable : write_sequence) {
-    if (!writable->WritePaddingAndObject(file_writer)) {
+    bool rv;
+    if (start_offset >= 0 && writable->CanWriteObjectConcurrently() &&
+        writable->SizeOfObject() >= options.concurrent_write_min_size) {
+      concurrent_writables.push_back(writable);
+      rv = writable->WritePadding(&combining_file_writer) &&
+           combining_file_writer.Seek(writable->SizeOfObject(), SEEK_CUR) >= 0;
+    } else {
+      rv = writable->WritePaddingAndObject(&combining_file_writer);
+    }
+    if (!rv) {
+      combining_file_writer.Flush();
+      return false;
+    }
+  }
+
+  if (!combining_file_writer.Flush()) {
+    return false;
+  }
+
+  if (!concurrent_writables.empty()) {
+    const FileOffset end_offset = file_writer->Seek(0, SEEK_CUR);
+    if (end_offset < 0 ||
+        !WriteObjectsConcurrently(file_writer,
+                                  start_offset,
+                                  concurrent_writables,
+                                  options.concurrent_write_threads) ||
+        file_writer->Seek(end_offset, SEEK_SET) < 0) {
       return false;
     }
   }
@@ -101,6 +283,7 @@ MinidumpWritable::MinidumpWritable()
       registered_rva64s_(),
       registered_location_descriptors_(),
       registered_location_descriptor64s_(),
+      offset_(0),
       leading_pad_bytes_(0),
       state_(kStateMutable) {}
 
@@ -171,6 +354,7 @@ size_t MinidumpWritable::WillWriteAtOffset(
 
     // Now that the file offset that this object will be written at is known,
     // let the subclass implementation know in case it’s interested.
+    offset_ = local_offset;
     if (!WillWriteAtOffsetImpl(local_offset)) {
       return kInvalidSize;
     }
@@ -288,9 +472,111 @@ bool MinidumpWritable::WillWriteAtOffsetImpl(FileOffset offset) {
   return true;
 }
 
+void MinidumpWritable::WillWriteWithMemoryBufferLimit(
+    size_t memory_buffer_limit) {
+  DCHECK_EQ(state_, kStateWritable);
+}
+
+void MinidumpWritable::InternStrings(MinidumpStringTable* string_table) {
+  DCHECK_EQ(state_, kStateFrozen);
+
+  for (MinidumpWritable* child : Children()) {
+    child->InternStrings(string_table);
+  }
+}
+
+void MinidumpWritable::TransferRegisteredPointers(MinidumpWritable* other) {
+  DCHECK_LE(state_, kStateFrozen);
+  DCHECK_LE(other->state_, kStateFrozen);
+  DCHECK_NE(other, this);
+
+  other->registered_rvas_.insert(other->registered_rvas_.end(),
+                                 registered_rvas_.begin(),
+                                 registered_rvas_.end());
+  registered_rvas_.clear();
+
+  other->registered_rva64s_.insert(other->registered_rva64s_.end(),
+                                   registered_rva64s_.begin(),
+                                   registered_rva64s_.end());
+  registered_rva64s_.clear();
+
+  other->registered_location_descriptors_.insert(
+      other->registered_location_descriptors_.end(),
+      registered_location_descriptors_.begin(),
+      registered_location_descriptors_.end());
+  registered_location_descriptors_.clear();
+
+  other->registered_location_descriptor64s_.insert(
+      other->registered_location_descriptor64s_.end(),
+      registered_location_descriptor64s_.begin(),
+      registered_location_descriptor64s_.end());
+  registered_location_descriptor64s_.clear();
+}
+
+bool MinidumpWritable::CanWriteObjectConcurrently() {
+  return false;
+}
+
 bool MinidumpWritable::WritePaddingAndObject(FileWriterInterface* file_writer) {
   DCHECK_EQ(state_, kStateWritable);
 
+  if (!WritePadding(file_writer)) {
+    return false;
+  }
+
+  if (!WriteObject(file_writer)) {
+    return false;
+  }
+
+  state_ = kStateWritten;
+  return true;
+}
+
+// static
+bool MinidumpWritable::WriteObjectsConcurrently(
+    FileWriterInterface* file_writer,
+    FileOffset start_offset,
+    const std::vector<MinidumpWritable*>& writables,
+    size_t thread_count) {
+  std::atomic<size_t> next_index(0);
+  std::atomic<bool> success(true);
+  auto write_objects = [&]() {
+    size_t index;
+    while ((index = next_index.fetch_add(1)) < writables.size()) {
+      MinidumpWritable* writable = writables[index];
+      DCHECK_EQ(writable->state_, kStateWritable);
+      OffsetFileWriter offset_file_writer(file_writer,
+                                          start_offset + writable->offset_);
+      if (!writable->WriteObject(&offset_file_writer)) {
+        success = false;
+      }
+    }
+  };
+
+  // The calling thread is one of the thread_count threads.
+  std::vector<std::unique_ptr<FunctionThread>> threads;
+  const size_t other_threads =
+      std::min(thread_count, writables.size()) - 1;
+  for (size_t index = 0; index < other_threads; ++index) {
+    threads.push_back(std::make_unique<FunctionThread>(write_objects));
+    threads.back()->Start();
+  }
+  write_objects();
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+
+  if (!success) {
+    return false;
+  }
+
+  for (MinidumpWritable* writable : writables) {
+    writable->state_ = kStateWritten;
+  }
+  return true;
+}
+
+bool MinidumpWritable::WritePadding(FileWriterInterface* file_writer) {
   // The number of elements in kZeroes must be at least one less than the
   // maximum Alignment() ever encountered.
   static constexpr uint8_t kZeroes[kMaximumAlignment - 1] = {};
@@ -302,11 +588,6 @@ bool MinidumpWritable::WritePaddingAndObject(FileWriterInterface* file_writer) {
     }
   }
 
-  if (!WriteObject(file_writer)) {
-    return false;
-  }
-
-  state_ = kStateWritten;
   return true;
 }
 
@@ -30,6 +30,8 @@ class FileWriterInterface;
 
 namespace internal {
 
+class MinidumpStringTable;
+
 //! \brief The base class for all content that might be written to a minidump
 //!     file.
 class MinidumpWritable {
@@ -39,6 +41,12 @@ class MinidumpWritable {
 
   virtual ~MinidumpWritable();
 
+  //! \brief Allocates storage for an object from the
+  //!     MinidumpWritableArena::Current() arena, or from the heap if no arena
+  //!     is current.
+  static void* operator new(size_t size);
+  static void operator delete(void* pointer);
+
   //! \brief Writes an object and all of its children to a minidump file.
   //!
   //! Use this on the root object of a tree of MinidumpWritable objects,
@@ -144,6 +152,76 @@ class MinidumpWritable {
 
   MinidumpWritable();
 
+  //! \brief Writes an object and all of its children to a minidump file,
+  //!     limiting the size of the buffers used to write memory snapshots.
+  //!
+  //! This behaves identically to the default implementation of
+  //! WriteEverything(), but first calls WillWriteWithMemoryBufferLimit() with
+  //! \a memory_buffer_limit on every object in the tree.
+  //!
+  //! \param[in] file_writer The file writer to receive the minidump file’s
+  //!     content.
+  //! \param[in] memory_buffer_limit The maximum size, in bytes, of memory
+  //!     snapshot data to be held at once while writing, or `0` for no limit.
+  //!
+  //! \return `true` on success. `false` on failure, with an appropriate message
+  //!     logged.
+  //!
+  //! \note Valid in #kStateMutable, and transitions the object and the entire
+  //!     tree beneath it through all states to #kStateWritten.
+  bool WriteEverythingWithMemoryBufferLimit(FileWriterInterface* file_writer,
+                                            size_t memory_buffer_limit);
+
+  //! \brief Options for WriteEverythingWithOptions().
+  struct WriteOptions {
+    //! \brief The maximum size, in bytes, of memory snapshot data to be held
+    //!     at once while writing, or `0` for no limit.
+    //!
+    //! \sa WillWriteWithMemoryBufferLimit()
+    size_t memory_buffer_limit = 0;
+
+    //! \brief The number of threads with which to write objects for which
+    //!     CanWriteObjectConcurrently() returns `true`, or `0` to write every
+    //!     object serially.
+    //!
+    //! This has no effect unless the file writer supports
+    //! FileWriterInterface::WriteAtOffset(). For memory snapshot objects,
+    //! MemorySnapshot::Read() must be safe to call from multiple threads at
+    //! once.
+    size_t concurrent_write_threads = 0;
+
+    //! \brief The minimum size, in bytes, of an object to write concurrently.
+    //!     Smaller objects are written serially.
+    size_t concurrent_write_min_size = 1024 * 1024;
+
+    //! \brief Whether to write identical strings once, with every reference
+    //!     to them pointing to the same copy.
+    //!
+    //! \sa InternStrings()
+    bool deduplicate_strings = false;
+  };
+
+  //! \brief Writes an object and all of its children to a minidump file,
+  //!     according to \a options.
+  //!
+  //! This behaves identically to WriteEverythingWithMemoryBufferLimit(), but
+  //! can also write large, independent objects concurrently. Every other
+  //! object is written serially first, leaving room for them, and then these
+  //! objects are written at their offsets from a pool of threads. The file
+  //! writer is positioned at the end of the minidump afterwards.
+  //!
+  //! \param[in] file_writer The file writer to receive the minidump file’s
+  //!     content.
+  //! \param[in] options Options controlling how the content is written.
+  //!
+  //! \return `true` on success. `false` on failure, with an appropriate message
+  //!     logged.
+  //!
+  //! \note Valid in #kStateMutable, and transitions the object and the entire
+  //!     tree beneath it through all states to #kStateWritten.
+  bool WriteEverythingWithOptions(FileWriterInterface* file_writer,
+                                  const WriteOptions& options);
+
   //! \brief The state of the object.
   State state() const { return state_; }
 
@@ -241,6 +319,51 @@ class MinidumpWritable {
   //!     #kStateWritable after this method returns.
   virtual bool WillWriteAtOffsetImpl(FileOffset offset);
 
+  //! \brief Limits the amount of memory snapshot data that the object may hold
+  //!     at once while it is written.
+  //!
+  //! Objects that write large amounts of data sourced from memory snapshots
+  //! can override this method so that the data is read and written in pieces
+  //! no larger than \a memory_buffer_limit. The default implementation does
+  //! nothing.
+  //!
+  //! \param[in] memory_buffer_limit The maximum size, in bytes, of data to hold
+  //!     at once, or `0` for no limit.
+  //!
+  //! \note Valid in #kStateWritable, before WritePaddingAndObject() is called.
+  virtual void WillWriteWithMemoryBufferLimit(size_t memory_buffer_limit);
+
+  //! \brief Offers the strings in an object and its children to a table so that
+  //!     identical strings can be written once.
+  //!
+  //! This is called after Freeze() when WriteOptions::deduplicate_strings is
+  //! set. The default implementation calls this method on each of the
+  //! object’s Children(). String objects override it to look themselves up
+  //! in \a string_table, and if an identical string is already present, to
+  //! move their registered pointers to it and write nothing themselves.
+  //!
+  //! \note Valid in #kStateFrozen.
+  virtual void InternStrings(MinidumpStringTable* string_table);
+
+  //! \brief Moves every pointer registered with RegisterRVA() and
+  //!     RegisterLocationDescriptor() on this object to \a other, which must
+  //!     have the same size as this object.
+  //!
+  //! \note Valid in #kStateFrozen or any preceding state.
+  void TransferRegisteredPointers(MinidumpWritable* other);
+
+  //! \brief Returns whether the object’s content may be written concurrently
+  //!     with other objects.
+  //!
+  //! If this returns `true`, WriteObject() may be called on a thread other than
+  //! the one writing the rest of the minidump, with a file writer that begins
+  //! at the object’s offset and cannot seek. Objects whose content is
+  //! self-contained, such as memory snapshot contents, may override this. The
+  //! default implementation returns `false`.
+  //!
+  //! \note Valid in #kStateWritable.
+  virtual bool CanWriteObjectConcurrently();
+
   //! \brief Writes the object, transitioning it from #kStateWritable to
   //!     #kStateWritten.
   //!
@@ -279,6 +402,22 @@ class MinidumpWritable {
   std::vector<MINIDUMP_LOCATION_DESCRIPTOR64*>
       registered_location_descriptor64s_;
 
+  // Writes the objects in writables concurrently on as many as thread_count
+  // threads, each at its offset_ relative to start_offset. Each object must be
+  // in #kStateWritable, and its padding must already have been written.
+  static bool WriteObjectsConcurrently(
+      FileWriterInterface* file_writer,
+      FileOffset start_offset,
+      const std::vector<MinidumpWritable*>& writables,
+      size_t thread_count);
+
+  // Writes the padding that precedes the object.
+  bool WritePadding(FileWriterInterface* file_writer);
+
+  // The offset at which the object is written, relative to the start of the
+  // minidump. Valid in #kStateWritable.
+  FileOffset offset_;
+
   size_t leading_pad_bytes_;
   State state_;
 };
@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_writable_arena.h"
+
+#include <cstddef>
+#include <new>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+thread_local MinidumpWritableArena* current_arena;
+
+constexpr size_t kAlignment = alignof(std::max_align_t);
+
+size_t RoundUp(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+}  // namespace
+
+MinidumpWritableArena::ScopedCurrent::ScopedCurrent(
+    MinidumpWritableArena* arena)
+    : previous_(current_arena) {
+  current_arena = arena;
+}
+
+MinidumpWritableArena::ScopedCurrent::~ScopedCurrent() {
+  current_arena = previous_;
+}
+
+MinidumpWritableArena::MinidumpWritableArena(size_t block_size)
+    : blocks_(),
+      block_size_(RoundUp(block_size)),
+      next_(nullptr),
+      remaining_(0),
+      allocation_count_(0),
+      live_allocation_count_(0) {
+  DCHECK_GT(block_size_, 0u);
+}
+
+MinidumpWritableArena::~MinidumpWritableArena() {
+  DCHECK_EQ(live_allocation_count_, 0u);
+  DCHECK_NE(current_arena, this);
+  for (void* block : blocks_) {
+    ::operator delete(block);
+  }
+}
+
+// static
+MinidumpWritableArena* MinidumpWritableArena::Current() {
+  return current_arena;
+}
+
+void* MinidumpWritableArena::Allocate(size_t size) {
+  size = RoundUp(size);
+
+  void* pointer;
+  if (size > block_size_) {
+    // Give oversized allocations their own block, leaving the current block
+    // available for subsequent small allocations.
+    pointer = ::operator new(size);
+    blocks_.push_back(pointer);
+  } else {
+    if (size > remaining_) {
+      next_ = static_cast<char*>(::operator new(block_size_));
+      remaining_ = block_size_;
+      blocks_.push_back(next_);
+    }
+    pointer = next_;
+    next_ += size;
+    remaining_ -= size;
+  }
+
+  ++allocation_count_;
+  ++live_allocation_count_;
+  return pointer;
+}
+
+void MinidumpWritableArena::Release(void* pointer) {
+  DCHECK(pointer);
+  DCHECK_GT(live_allocation_count_, 0u);
+  --live_allocation_count_;
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,97 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_WRITABLE_ARENA_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_WRITABLE_ARENA_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief A bump allocator providing storage for the MinidumpWritable objects
+//!     that make up a single minidump file.
+//!
+//! While a MinidumpWritableArena is current on a thread (see ScopedCurrent),
+//! MinidumpWritable objects allocated with `new` on that thread obtain their
+//! storage from the arena instead of from the heap. Their destructors still
+//! run normally when their owners release them, but their storage is only
+//! returned when the arena itself is destroyed, all at once.
+//!
+//! The arena must outlive every object allocated from it. This object is not
+//! thread-safe.
+class MinidumpWritableArena {
+ public:
+  //! \brief The default size of each block obtained from the heap.
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  //! \brief Makes an arena current on the calling thread for the lifetime of
+  //!     this object, restoring the previously-current arena when destroyed.
+  class ScopedCurrent {
+   public:
+    explicit ScopedCurrent(MinidumpWritableArena* arena);
+
+    ScopedCurrent(const ScopedCurrent&) = delete;
+    ScopedCurrent& operator=(const ScopedCurrent&) = delete;
+
+    ~ScopedCurrent();
+
+   private:
+    MinidumpWritableArena* previous_;  // weak
+  };
+
+  //! \param[in] block_size The size of each block to obtain from the heap.
+  //!     Allocations that do not fit in a block of this size are given their
+  //!     own block.
+  explicit MinidumpWritableArena(size_t block_size = kDefaultBlockSize);
+
+  MinidumpWritableArena(const MinidumpWritableArena&) = delete;
+  MinidumpWritableArena& operator=(const MinidumpWritableArena&) = delete;
+
+  ~MinidumpWritableArena();
+
+  //! \brief Returns the arena current on the calling thread, or `nullptr` if
+  //!     there is none.
+  static MinidumpWritableArena* Current();
+
+  //! \brief Allocates \a size bytes, aligned suitably for any fundamental
+  //!     type.
+  void* Allocate(size_t size);
+
+  //! \brief Records that an allocation made by Allocate() is no longer in use.
+  //!
+  //! Storage is not reused. It is freed when the arena is destroyed.
+  void Release(void* pointer);
+
+  //! \brief Returns the total number of allocations made from this arena.
+  size_t allocation_count() const { return allocation_count_; }
+
+  //! \brief Returns the number of blocks obtained from the heap.
+  size_t block_count() const { return blocks_.size(); }
+
+ private:
+  std::vector<void*> blocks_;
+  size_t block_size_;
+  char* next_;  // weak
+  size_t remaining_;
+  size_t allocation_count_;
+  size_t live_allocation_count_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_WRITABLE_ARENA_H_
@@ -0,0 +1,121 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_writable_arena.h"
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_string_writer.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using internal::MinidumpWritableArena;
+
+bool IsAligned(const void* pointer) {
+  return reinterpret_cast<uintptr_t>(pointer) % alignof(std::max_align_t) == 0;
+}
+
+TEST(MinidumpWritableArena, Allocate) {
+  MinidumpWritableArena arena(256);
+  EXPECT_EQ(arena.allocation_count(), 0u);
+  EXPECT_EQ(arena.block_count(), 0u);
+
+  void* first = arena.Allocate(1);
+  EXPECT_TRUE(IsAligned(first));
+  void* second = arena.Allocate(100);
+  EXPECT_TRUE(IsAligned(second));
+  EXPECT_NE(first, second);
+  EXPECT_EQ(arena.allocation_count(), 2u);
+  EXPECT_EQ(arena.block_count(), 1u);
+
+  // This doesn’t fit in the remainder of the first block.
+  void* third = arena.Allocate(200);
+  EXPECT_TRUE(IsAligned(third));
+  EXPECT_EQ(arena.allocation_count(), 3u);
+  EXPECT_EQ(arena.block_count(), 2u);
+
+  // An oversized allocation gets a block of its own.
+  void* fourth = arena.Allocate(1000);
+  EXPECT_TRUE(IsAligned(fourth));
+  EXPECT_EQ(arena.allocation_count(), 4u);
+  EXPECT_EQ(arena.block_count(), 3u);
+
+  arena.Release(first);
+  arena.Release(second);
+  arena.Release(third);
+  arena.Release(fourth);
+  EXPECT_EQ(arena.allocation_count(), 4u);
+}
+
+TEST(MinidumpWritableArena, ScopedCurrent) {
+  EXPECT_FALSE(MinidumpWritableArena::Current());
+
+  MinidumpWritableArena outer_arena;
+  {
+    MinidumpWritableArena::ScopedCurrent scoped_outer(&outer_arena);
+    EXPECT_EQ(MinidumpWritableArena::Current(), &outer_arena);
+
+    MinidumpWritableArena inner_arena;
+    {
+      MinidumpWritableArena::ScopedCurrent scoped_inner(&inner_arena);
+      EXPECT_EQ(MinidumpWritableArena::Current(), &inner_arena);
+    }
+
+    EXPECT_EQ(MinidumpWritableArena::Current(), &outer_arena);
+  }
+
+  EXPECT_FALSE(MinidumpWritableArena::Current());
+}
+
+TEST(MinidumpWritableArena, Writables) {
+  const std::vector<std::string> strings = {"one", "two", "three", "four"};
+
+  MinidumpWritableArena arena;
+  std::unique_ptr<MinidumpUTF8StringListWriter> arena_list_writer;
+  {
+    MinidumpWritableArena::ScopedCurrent scoped_arena(&arena);
+    arena_list_writer = std::make_unique<MinidumpUTF8StringListWriter>();
+    arena_list_writer->InitializeFromVector(strings);
+  }
+
+  // The list writer and one string writer per string.
+  EXPECT_EQ(arena.allocation_count(), strings.size() + 1);
+  EXPECT_EQ(arena.block_count(), 1u);
+
+  // Objects allocated with no arena current come from the heap.
+  MinidumpUTF8StringListWriter heap_list_writer;
+  heap_list_writer.InitializeFromVector(strings);
+  EXPECT_EQ(arena.allocation_count(), strings.size() + 1);
+
+  StringFile arena_string_file;
+  ASSERT_TRUE(arena_list_writer->WriteEverything(&arena_string_file));
+  StringFile heap_string_file;
+  ASSERT_TRUE(heap_list_writer.WriteEverything(&heap_string_file));
+  EXPECT_EQ(arena_string_file.string(), heap_string_file.string());
+
+  arena_list_writer.reset();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
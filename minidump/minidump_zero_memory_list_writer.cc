@@ -0,0 +1,97 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_zero_memory_list_writer.h"
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/file/file_writer.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+MinidumpZeroMemoryListWriter::MinidumpZeroMemoryListWriter()
+    : zero_memory_list_base_(), ranges_() {}
+
+MinidumpZeroMemoryListWriter::~MinidumpZeroMemoryListWriter() = default;
+
+void MinidumpZeroMemoryListWriter::AddRange(uint64_t address, uint64_t size) {
+  DCHECK_EQ(state(), kStateMutable);
+  DCHECK_GT(size, 0u);
+
+  MinidumpZeroMemoryRange range = {};
+  range.start_of_memory_range = address;
+  range.data_size = size;
+  ranges_.push_back(range);
+}
+
+bool MinidumpZeroMemoryListWriter::Freeze() {
+  DCHECK_EQ(state(), kStateMutable);
+
+  if (!MinidumpStreamWriter::Freeze()) {
+    return false;
+  }
+
+  std::sort(ranges_.begin(),
+            ranges_.end(),
+            [](const MinidumpZeroMemoryRange& a,
+               const MinidumpZeroMemoryRange& b) {
+              return a.start_of_memory_range < b.start_of_memory_range;
+            });
+
+  if (!AssignIfInRange(&zero_memory_list_base_.count, ranges_.size())) {
+    LOG(ERROR) << "range count " << ranges_.size() << " out of range";
+    return false;
+  }
+
+  return true;
+}
+
+size_t MinidumpZeroMemoryListWriter::SizeOfObject() {
+  DCHECK_GE(state(), kStateFrozen);
+  return sizeof(zero_memory_list_base_) +
+         sizeof(MinidumpZeroMemoryRange) * ranges_.size();
+}
+
+std::vector<internal::MinidumpWritable*>
+MinidumpZeroMemoryListWriter::Children() {
+  DCHECK_GE(state(), kStateFrozen);
+  return std::vector<internal::MinidumpWritable*>();
+}
+
+bool MinidumpZeroMemoryListWriter::WriteObject(
+    FileWriterInterface* file_writer) {
+  DCHECK_EQ(state(), kStateWritable);
+
+  WritableIoVec iov;
+  iov.iov_base = &zero_memory_list_base_;
+  iov.iov_len = sizeof(zero_memory_list_base_);
+  std::vector<WritableIoVec> iovecs(1, iov);
+
+  if (!ranges_.empty()) {
+    iov.iov_base = ranges_.data();
+    iov.iov_len = sizeof(MinidumpZeroMemoryRange) * ranges_.size();
+    iovecs.push_back(iov);
+  }
+
+  return file_writer->WriteIoVec(&iovecs);
+}
+
+MinidumpStreamType MinidumpZeroMemoryListWriter::StreamType() const {
+  return kMinidumpStreamTypeCrashpadZeroMemoryList;
+}
+
+}  // namespace crashpad
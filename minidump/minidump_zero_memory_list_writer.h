@@ -0,0 +1,76 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_MINIDUMP_MINIDUMP_ZERO_MEMORY_LIST_WRITER_H_
+#define CRASHPAD_MINIDUMP_MINIDUMP_ZERO_MEMORY_LIST_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_stream_writer.h"
+#include "minidump/minidump_writable.h"
+
+namespace crashpad {
+
+//! \brief The writer for a MinidumpZeroMemoryList stream in a minidump file,
+//!     containing a MinidumpZeroMemoryRange for each range of memory omitted
+//!     from the minidump file because it contained only zeroes.
+//!
+//! Ranges are normally added by a MinidumpMemoryListWriter that this object has
+//! been given to with MinidumpMemoryListWriter::SetZeroMemoryListWriter(), as
+//! that object freezes. This object must therefore be frozen after it, which is
+//! the case when this stream is added to a MinidumpFileWriter after the memory
+//! list stream is.
+class MinidumpZeroMemoryListWriter final
+    : public internal::MinidumpStreamWriter {
+ public:
+  MinidumpZeroMemoryListWriter();
+
+  MinidumpZeroMemoryListWriter(const MinidumpZeroMemoryListWriter&) = delete;
+  MinidumpZeroMemoryListWriter& operator=(const MinidumpZeroMemoryListWriter&) =
+      delete;
+
+  ~MinidumpZeroMemoryListWriter() override;
+
+  //! \brief Adds a range of memory that contained only zeroes.
+  //!
+  //! Ranges may be added in any order, but must not overlap.
+  //!
+  //! \param[in] address The base address of the range.
+  //! \param[in] size The size of the range, in bytes.
+  //!
+  //! \note Valid in #kStateMutable.
+  void AddRange(uint64_t address, uint64_t size);
+
+ protected:
+  // MinidumpWritable:
+  bool Freeze() override;
+  size_t SizeOfObject() override;
+  std::vector<internal::MinidumpWritable*> Children() override;
+  bool WriteObject(FileWriterInterface* file_writer) override;
+
+  // MinidumpStreamWriter:
+  MinidumpStreamType StreamType() const override;
+
+ private:
+  MinidumpZeroMemoryList zero_memory_list_base_;
+  std::vector<MinidumpZeroMemoryRange> ranges_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_MINIDUMP_MINIDUMP_ZERO_MEMORY_LIST_WRITER_H_
@@ -0,0 +1,122 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "minidump/minidump_zero_memory_list_writer.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_file_writer.h"
+#include "minidump/test/minidump_file_writer_test_util.h"
+#include "minidump/test/minidump_writable_test_util.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// The zero memory list is expected to be the only stream.
+void GetZeroMemoryListStream(const std::string& file_contents,
+                             const MinidumpZeroMemoryList** zero_memory_list) {
+  constexpr size_t kDirectoryOffset = sizeof(MINIDUMP_HEADER);
+  constexpr size_t kZeroMemoryListStreamOffset =
+      kDirectoryOffset + sizeof(MINIDUMP_DIRECTORY);
+
+  const MINIDUMP_DIRECTORY* directory;
+  const MINIDUMP_HEADER* header =
+      MinidumpHeaderAtStart(file_contents, &directory);
+  ASSERT_NO_FATAL_FAILURE(VerifyMinidumpHeader(header, 1, 0));
+  ASSERT_TRUE(directory);
+
+  constexpr size_t kDirectoryIndex = 0;
+
+  ASSERT_EQ(directory[kDirectoryIndex].StreamType,
+            kMinidumpStreamTypeCrashpadZeroMemoryList);
+  EXPECT_EQ(directory[kDirectoryIndex].Location.Rva,
+            kZeroMemoryListStreamOffset);
+
+  *zero_memory_list =
+      MinidumpWritableAtLocationDescriptor<MinidumpZeroMemoryList>(
+          file_contents, directory[kDirectoryIndex].Location);
+  ASSERT_TRUE(*zero_memory_list);
+}
+
+TEST(MinidumpZeroMemoryListWriter, Empty) {
+  MinidumpFileWriter minidump_file_writer;
+  auto zero_memory_list_writer =
+      std::make_unique<MinidumpZeroMemoryListWriter>();
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(zero_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpZeroMemoryList));
+
+  const MinidumpZeroMemoryList* zero_memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetZeroMemoryListStream(string_file.string(), &zero_memory_list));
+
+  EXPECT_EQ(zero_memory_list->count, 0u);
+}
+
+TEST(MinidumpZeroMemoryListWriter, Sorted) {
+  MinidumpFileWriter minidump_file_writer;
+  auto zero_memory_list_writer =
+      std::make_unique<MinidumpZeroMemoryListWriter>();
+  zero_memory_list_writer->AddRange(0x30000, 0x1000);
+  zero_memory_list_writer->AddRange(0x10000, 0x4000);
+  zero_memory_list_writer->AddRange(0x20000, 0x2000);
+  ASSERT_TRUE(
+      minidump_file_writer.AddStream(std::move(zero_memory_list_writer)));
+
+  StringFile string_file;
+  ASSERT_TRUE(minidump_file_writer.WriteEverything(&string_file));
+
+  constexpr size_t kRangeCount = 3;
+  ASSERT_EQ(string_file.string().size(),
+            sizeof(MINIDUMP_HEADER) + sizeof(MINIDUMP_DIRECTORY) +
+                sizeof(MinidumpZeroMemoryList) +
+                kRangeCount * sizeof(MinidumpZeroMemoryRange));
+
+  const MinidumpZeroMemoryList* zero_memory_list = nullptr;
+  ASSERT_NO_FATAL_FAILURE(
+      GetZeroMemoryListStream(string_file.string(), &zero_memory_list));
+
+  ASSERT_EQ(zero_memory_list->count, kRangeCount);
+  static constexpr MinidumpZeroMemoryRange kExpected[kRangeCount] = {
+      {0x10000, 0x4000},
+      {0x20000, 0x2000},
+      {0x30000, 0x1000},
+  };
+  for (size_t index = 0; index < kRangeCount; ++index) {
+    SCOPED_TRACE(index);
+    MinidumpZeroMemoryRange range;
+    memcpy(&range, &zero_memory_list->ranges[index], sizeof(range));
+    EXPECT_EQ(range.start_of_memory_range,
+              kExpected[index].start_of_memory_range);
+    EXPECT_EQ(range.data_size, kExpected[index].data_size);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
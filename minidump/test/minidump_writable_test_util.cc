@@ -258,6 +258,42 @@ struct MinidumpAnnotationListObjectsTraits {
   static size_t ElementCount(const ListType* list) { return list->count; }
 };
 
+struct MinidumpCaptureTimingListTraits {
+  using ListType = MinidumpCaptureTimingList;
+  enum : size_t { kElementSize = sizeof(MinidumpCaptureTiming) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
+struct MinidumpZeroMemoryListTraits {
+  using ListType = MinidumpZeroMemoryList;
+  enum : size_t { kElementSize = sizeof(MinidumpZeroMemoryRange) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
+struct MinidumpCompressedMemoryListTraits {
+  using ListType = MinidumpCompressedMemoryList;
+  enum : size_t { kElementSize = sizeof(MinidumpCompressedMemoryRange) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
+struct MinidumpDeltaTraits {
+  using ListType = MinidumpDelta;
+  enum : size_t { kElementSize = sizeof(MinidumpDeltaRange) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
+struct MinidumpExtendedRegistersListTraits {
+  using ListType = MinidumpExtendedRegistersList;
+  enum : size_t { kElementSize = sizeof(MinidumpExtendedRegisters) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
+struct MinidumpThreadStatsListTraits {
+  using ListType = MinidumpThreadStatsList;
+  enum : size_t { kElementSize = sizeof(MinidumpThreadStats) };
+  static size_t ElementCount(const ListType* list) { return list->count; }
+};
+
 template <typename T>
 const typename T::ListType* MinidumpListAtLocationDescriptor(
     const std::string& file_contents,
@@ -371,6 +407,59 @@ MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
       file_contents, location);
 }
 
+template <>
+const MinidumpCaptureTimingList*
+MinidumpWritableAtLocationDescriptor<MinidumpCaptureTimingList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpCaptureTimingListTraits>(
+      file_contents, location);
+}
+
+template <>
+const MinidumpZeroMemoryList*
+MinidumpWritableAtLocationDescriptor<MinidumpZeroMemoryList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpZeroMemoryListTraits>(
+      file_contents, location);
+}
+
+template <>
+const MinidumpCompressedMemoryList*
+MinidumpWritableAtLocationDescriptor<MinidumpCompressedMemoryList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpCompressedMemoryListTraits>(
+      file_contents, location);
+}
+
+template <>
+const MinidumpDelta* MinidumpWritableAtLocationDescriptor<MinidumpDelta>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpDeltaTraits>(file_contents,
+                                                               location);
+}
+
+template <>
+const MinidumpExtendedRegistersList*
+MinidumpWritableAtLocationDescriptor<MinidumpExtendedRegistersList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpExtendedRegistersListTraits>(
+      file_contents, location);
+}
+
+template <>
+const MinidumpThreadStatsList*
+MinidumpWritableAtLocationDescriptor<MinidumpThreadStatsList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location) {
+  return MinidumpListAtLocationDescriptor<MinidumpThreadStatsListTraits>(
+      file_contents, location);
+}
+
 namespace {
 
 template <typename T>
@@ -108,6 +108,12 @@ MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpModuleCrashpadInfoList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpRVAList);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpSimpleStringDictionary);
 MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpAnnotationList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpCaptureTimingList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpZeroMemoryList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpCompressedMemoryList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpDelta);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpExtendedRegistersList);
+MINIDUMP_ALLOW_OVERSIZED_DATA(MinidumpThreadStatsList);
 
 // These types have final fields carrying variable-sized data (typically string
 // data).
@@ -293,6 +299,41 @@ MinidumpWritableAtLocationDescriptor<MinidumpAnnotationList>(
     const std::string& file_contents,
     const MINIDUMP_LOCATION_DESCRIPTOR& location);
 
+template <>
+const MinidumpCaptureTimingList*
+MinidumpWritableAtLocationDescriptor<MinidumpCaptureTimingList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpZeroMemoryList*
+MinidumpWritableAtLocationDescriptor<MinidumpZeroMemoryList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpCompressedMemoryList*
+MinidumpWritableAtLocationDescriptor<MinidumpCompressedMemoryList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpDelta* MinidumpWritableAtLocationDescriptor<MinidumpDelta>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpExtendedRegistersList*
+MinidumpWritableAtLocationDescriptor<MinidumpExtendedRegistersList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
+template <>
+const MinidumpThreadStatsList*
+MinidumpWritableAtLocationDescriptor<MinidumpThreadStatsList>(
+    const std::string& file_contents,
+    const MINIDUMP_LOCATION_DESCRIPTOR& location);
+
 //! \brief Returns a typed minidump object located within a minidump file’s
 //!     contents, where the offset of the object is known.
 //!
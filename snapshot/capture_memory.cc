@@ -23,17 +23,22 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "base/logging.h"
 #include "snapshot/memory_snapshot.h"
+#include "util/misc/range_set.h"
+#include "util/misc/trace_event.h"
 
 namespace crashpad {
 namespace internal {
 
 namespace {
 
+// Ranges added by the delegate are appended to captured, if it is not nullptr.
 void MaybeCaptureMemoryAround(CaptureMemory::Delegate* delegate,
-                              uint64_t address) {
+                              uint64_t address,
+                              std::vector<CheckedRange<uint64_t>>* captured) {
   constexpr uint64_t non_address_offset = 0x10000;
   if (address < non_address_offset)
     return;
@@ -52,84 +57,286 @@ void MaybeCaptureMemoryAround(CaptureMemory::Delegate* delegate,
   auto ranges =
       delegate->GetReadableRanges(CheckedRange<uint64_t>(target, size));
   for (const auto& range : ranges) {
-    delegate->AddNewMemorySnapshot(range);
+    if (delegate->AddNewMemorySnapshot(range) && captured) {
+      captured->push_back(range);
+    }
   }
 }
 
 template <class T>
 void CaptureAtPointersInRange(uint8_t* buffer,
                               uint64_t buffer_size,
-                              CaptureMemory::Delegate* delegate) {
+                              CaptureMemory::Delegate* delegate,
+                              std::vector<CheckedRange<uint64_t>>* captured) {
   for (uint64_t address_offset = 0; address_offset < buffer_size;
        address_offset += sizeof(T)) {
     uint64_t target_address = *reinterpret_cast<T*>(&buffer[address_offset]);
-    MaybeCaptureMemoryAround(delegate, target_address);
+    MaybeCaptureMemoryAround(delegate, target_address, captured);
   }
 }
 
-}  // namespace
-
-// static
-void CaptureMemory::PointedToByContext(const CPUContext& context,
-                                       Delegate* delegate) {
+void CaptureAroundContext(const CPUContext& context,
+                          CaptureMemory::Delegate* delegate,
+                          std::vector<CheckedRange<uint64_t>>* captured) {
 #if defined(ARCH_CPU_X86_FAMILY)
   if (context.architecture == kCPUArchitectureX86_64) {
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rip);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rax);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rbx);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rcx);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rdx);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rdi);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rsi);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->rbp);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r8);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r9);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r10);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r11);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r12);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r13);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r14);
-    MaybeCaptureMemoryAround(delegate, context.x86_64->r15);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rip, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rax, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rbx, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rcx, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rdx, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rdi, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rsi, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->rbp, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r8, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r9, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r10, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r11, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r12, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r13, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r14, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86_64->r15, captured);
     // Note: Shadow stack region is directly captured.
   } else {
-    MaybeCaptureMemoryAround(delegate, context.x86->eip);
-    MaybeCaptureMemoryAround(delegate, context.x86->eax);
-    MaybeCaptureMemoryAround(delegate, context.x86->ebx);
-    MaybeCaptureMemoryAround(delegate, context.x86->ecx);
-    MaybeCaptureMemoryAround(delegate, context.x86->edx);
-    MaybeCaptureMemoryAround(delegate, context.x86->edi);
-    MaybeCaptureMemoryAround(delegate, context.x86->esi);
-    MaybeCaptureMemoryAround(delegate, context.x86->ebp);
+    MaybeCaptureMemoryAround(delegate, context.x86->eip, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->eax, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->ebx, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->ecx, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->edx, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->edi, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->esi, captured);
+    MaybeCaptureMemoryAround(delegate, context.x86->ebp, captured);
   }
 #elif defined(ARCH_CPU_ARM_FAMILY)
   if (context.architecture == kCPUArchitectureARM64) {
-    MaybeCaptureMemoryAround(delegate, context.arm64->pc);
+    MaybeCaptureMemoryAround(delegate, context.arm64->pc, captured);
     for (size_t i = 0; i < std::size(context.arm64->regs); ++i) {
-      MaybeCaptureMemoryAround(delegate, context.arm64->regs[i]);
+      MaybeCaptureMemoryAround(delegate, context.arm64->regs[i], captured);
     }
   } else {
-    MaybeCaptureMemoryAround(delegate, context.arm->pc);
+    MaybeCaptureMemoryAround(delegate, context.arm->pc, captured);
     for (size_t i = 0; i < std::size(context.arm->regs); ++i) {
-      MaybeCaptureMemoryAround(delegate, context.arm->regs[i]);
+      MaybeCaptureMemoryAround(delegate, context.arm->regs[i], captured);
     }
   }
 #elif defined(ARCH_CPU_MIPS_FAMILY)
   for (size_t i = 0; i < std::size(context.mipsel->regs); ++i) {
-    MaybeCaptureMemoryAround(delegate, context.mipsel->regs[i]);
+    MaybeCaptureMemoryAround(delegate, context.mipsel->regs[i], captured);
   }
 #elif defined(ARCH_CPU_RISCV64)
-  MaybeCaptureMemoryAround(delegate, context.riscv64->pc);
+  MaybeCaptureMemoryAround(delegate, context.riscv64->pc, captured);
   for (size_t i = 0; i < std::size(context.riscv64->regs); ++i) {
-    MaybeCaptureMemoryAround(delegate, context.riscv64->regs[i]);
+    MaybeCaptureMemoryAround(delegate, context.riscv64->regs[i], captured);
   }
 #else
 #error Port.
 #endif
 }
 
+// The window of code captured around a program counter in JIT code.
+constexpr uint64_t kJitPCBytesBefore = 1024;
+constexpr uint64_t kJitPCBytesAfter = 1024;
+
+// The window of code captured around a return address in JIT code, which
+// includes the call that it follows.
+constexpr uint64_t kJitReturnBytesBefore = 256;
+constexpr uint64_t kJitReturnBytesAfter = 64;
+
+// The number of frame records followed looking for return addresses.
+constexpr size_t kJitMaxFrames = 16;
+
+// Finds the program counter, the frame pointer, and the link register (the
+// return address of a leaf function) in context. frame_pointer and link are
+// set to 0 if the architecture's frame records aren't understood.
+void GetFrameRegisters(const CPUContext& context,
+                       uint64_t* pc,
+                       uint64_t* frame_pointer,
+                       uint64_t* link) {
+  *frame_pointer = 0;
+  *link = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (context.architecture == kCPUArchitectureX86_64) {
+    *pc = context.x86_64->rip;
+    *frame_pointer = context.x86_64->rbp;
+  } else {
+    *pc = context.x86->eip;
+    *frame_pointer = context.x86->ebp;
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY)
+  if (context.architecture == kCPUArchitectureARM64) {
+    *pc = context.arm64->pc;
+    *frame_pointer = context.arm64->regs[29];
+    *link = context.arm64->regs[30];
+  } else {
+    *pc = context.arm->pc;
+    *link = context.arm->lr;
+  }
+#elif defined(ARCH_CPU_MIPS_FAMILY)
+  *pc = context.mipsel->cp0_epc;
+#elif defined(ARCH_CPU_RISCV64)
+  *pc = context.riscv64->pc;
+  // regs[0] is x1, the return address register.
+  *link = context.riscv64->regs[0];
+#else
+#error Port.
+#endif
+}
+
+// Windows are kept in the order they're found, with the parts already covered
+// by an earlier window removed, so that the code nearest the crash is
+// captured first if the budget runs out.
+class JitWindows {
+ public:
+  explicit JitWindows(CaptureMemory::Delegate* delegate)
+      : delegate_(delegate), windows_(), ranges_() {}
+
+  JitWindows(const JitWindows&) = delete;
+  JitWindows& operator=(const JitWindows&) = delete;
+
+  void AddAround(uint64_t address, uint64_t before, uint64_t after) {
+    if (!delegate_->IsAnonymousExecutable(address)) {
+      return;
+    }
+    const uint64_t base = address > before ? address - before : 0;
+    const uint64_t end =
+        address < std::numeric_limits<uint64_t>::max() - after
+            ? address + after
+            : std::numeric_limits<uint64_t>::max();
+
+    uint64_t next = base;
+    for (const auto& covered : windows_.Intersect(base, end - base)) {
+      if (covered.base > next) {
+        ranges_.emplace_back(next, covered.base - next);
+      }
+      next = covered.base + covered.size;
+    }
+    if (end > next) {
+      ranges_.emplace_back(next, end - next);
+    }
+    windows_.Insert(base, end - base);
+  }
+
+  void Capture() {
+    for (const auto& range : ranges_) {
+      for (const auto& readable : delegate_->GetReadableRanges(range)) {
+        delegate_->AddNewMemorySnapshot(readable);
+      }
+    }
+  }
+
+ private:
+  CaptureMemory::Delegate* delegate_;  // weak
+  RangeSet windows_;
+  std::vector<CheckedRange<uint64_t>> ranges_;
+};
+
+}  // namespace
+
+// static
+void CaptureMemory::PointedToByContext(const CPUContext& context,
+                                       Delegate* delegate) {
+  CRASHPAD_TRACE_EVENT("capture", "CaptureMemory::PointedToByContext");
+  CaptureAroundContext(context, delegate, nullptr);
+}
+
+// static
+void CaptureMemory::PointedToByContextRecursively(const CPUContext& context,
+                                                  size_t max_depth,
+                                                  Delegate* delegate) {
+  if (max_depth == 0)
+    return;
+
+  std::vector<CheckedRange<uint64_t>> level;
+  CaptureAroundContext(context, delegate, max_depth > 1 ? &level : nullptr);
+
+  const uint64_t alignment =
+      delegate->Is64Bit() ? sizeof(uint64_t) : sizeof(uint32_t);
+  std::vector<uint8_t> buffer;
+  for (size_t depth = 1; depth < max_depth && !level.empty(); ++depth) {
+    // The last level's ranges are captured but not scanned.
+    std::vector<CheckedRange<uint64_t>> next_level;
+    std::vector<CheckedRange<uint64_t>>* next_captured =
+        depth + 1 < max_depth ? &next_level : nullptr;
+    for (const auto& range : level) {
+      // Only aligned pointers are followed.
+      const uint64_t base = (range.base() + alignment - 1) & ~(alignment - 1);
+      const uint64_t end = range.end() & ~(alignment - 1);
+      if (end <= base)
+        continue;
+
+      buffer.resize(end - base);
+      if (!delegate->ReadMemory(base, end - base, buffer.data()))
+        continue;
+
+      if (delegate->Is64Bit()) {
+        CaptureAtPointersInRange<uint64_t>(
+            buffer.data(), end - base, delegate, next_captured);
+      } else {
+        CaptureAtPointersInRange<uint32_t>(
+            buffer.data(), end - base, delegate, next_captured);
+      }
+    }
+    level.swap(next_level);
+  }
+}
+
+// static
+void CaptureMemory::JitCodeAroundContext(const CPUContext& context,
+                                         Delegate* delegate) {
+  CRASHPAD_TRACE_EVENT("capture", "CaptureMemory::JitCodeAroundContext");
+  uint64_t pc;
+  uint64_t frame_pointer;
+  uint64_t link;
+  GetFrameRegisters(context, &pc, &frame_pointer, &link);
+
+  JitWindows windows(delegate);
+  windows.AddAround(pc, kJitPCBytesBefore, kJitPCBytesAfter);
+  if (link) {
+    windows.AddAround(link, kJitReturnBytesBefore, kJitReturnBytesAfter);
+  }
+
+  // Each frame record holds the caller's frame pointer followed by the return
+  // address. Records are followed only toward higher addresses, which also
+  // keeps a corrupt chain from looping.
+  const uint64_t pointer_size =
+      delegate->Is64Bit() ? sizeof(uint64_t) : sizeof(uint32_t);
+  for (size_t frame = 0;
+       frame < kJitMaxFrames && frame_pointer != 0 &&
+       frame_pointer % pointer_size == 0;
+       ++frame) {
+    uint64_t next_frame_pointer;
+    uint64_t return_address;
+    if (delegate->Is64Bit()) {
+      uint64_t record[2];
+      if (!delegate->ReadMemory(frame_pointer, sizeof(record), record)) {
+        break;
+      }
+      next_frame_pointer = record[0];
+      return_address = record[1];
+    } else {
+      uint32_t record[2];
+      if (!delegate->ReadMemory(frame_pointer, sizeof(record), record)) {
+        break;
+      }
+      next_frame_pointer = record[0];
+      return_address = record[1];
+    }
+
+    windows.AddAround(
+        return_address, kJitReturnBytesBefore, kJitReturnBytesAfter);
+    if (next_frame_pointer <= frame_pointer) {
+      break;
+    }
+    frame_pointer = next_frame_pointer;
+  }
+
+  windows.Capture();
+}
+
 // static
 void CaptureMemory::PointedToByMemoryRange(const MemorySnapshot& memory,
                                            Delegate* delegate) {
+  CRASHPAD_TRACE_EVENT("capture", "CaptureMemory::PointedToByMemoryRange");
   if (memory.Size() == 0)
     return;
 
@@ -147,9 +354,11 @@ void CaptureMemory::PointedToByMemoryRange(const MemorySnapshot& memory,
   }
 
   if (delegate->Is64Bit())
-    CaptureAtPointersInRange<uint64_t>(buffer.get(), memory.Size(), delegate);
+    CaptureAtPointersInRange<uint64_t>(
+        buffer.get(), memory.Size(), delegate, nullptr);
   else
-    CaptureAtPointersInRange<uint32_t>(buffer.get(), memory.Size(), delegate);
+    CaptureAtPointersInRange<uint32_t>(
+        buffer.get(), memory.Size(), delegate, nullptr);
 }
 
 }  // namespace internal
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_SNAPSHOT_CAPTURE_MEMORY_H_
 #define CRASHPAD_SNAPSHOT_CAPTURE_MEMORY_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <vector>
@@ -51,6 +52,9 @@ class CaptureMemory {
     //! vector
     //!     of ranges, representing the readable portions of the original range.
     //!
+    //! Implementations may also leave out portions that the target process
+    //! excluded from core dumps.
+    //!
     //! \param[in] range The range being identified.
     //!
     //! \return A vector of ranges corresponding to the portion of \a range that
@@ -60,8 +64,18 @@ class CaptureMemory {
 
     //! \brief Adds the given range representing a memory snapshot in the target
     //!     process to the result.
-    virtual void AddNewMemorySnapshot(
+    //!
+    //! \return `true` if the range was added, or `false` if it was skipped,
+    //!     for example because it had already been captured or because the
+    //!     capture budget was exhausted.
+    virtual bool AddNewMemorySnapshot(
         const CheckedRange<uint64_t, uint64_t>& range) = 0;
+
+    //! \brief Determines whether \a address lies in executable memory that
+    //!     isn't backed by a file, such as code generated by a JIT compiler.
+    //!
+    //! \return `true` if \a address is in anonymous executable memory.
+    virtual bool IsAnonymousExecutable(uint64_t address) const = 0;
   };
 
   CaptureMemory() = delete;
@@ -79,6 +93,42 @@ class CaptureMemory {
   //!     process and adding new ranges.
   static void PointedToByContext(const CPUContext& context, Delegate* delegate);
 
+  //! \brief Captures memory as PointedToByContext() does, and then follows
+  //!     pointer-like values in the captured memory, breadth-first, up to \a
+  //!     max_depth levels of indirection.
+  //!
+  //! Each level is captured completely before the next one is started, so
+  //! that when the delegate's budget runs out, memory closer to \a context has
+  //! been preferred. Ranges that the delegate declines to add, because they
+  //! were already captured or because no budget remains, are not followed.
+  //!
+  //! \param[in] context The context to inspect.
+  //! \param[in] max_depth The number of levels of indirection to follow. `1`
+  //!     is equivalent to PointedToByContext(), and `0` captures nothing.
+  //! \param[in] delegate A Delegate that handles reading from the target
+  //!     process and adding new ranges.
+  static void PointedToByContextRecursively(const CPUContext& context,
+                                            size_t max_depth,
+                                            Delegate* delegate);
+
+  //! \brief Captures bounded windows of code around the program counter and
+  //!     the return addresses of the innermost frames of \a context, where
+  //!     they lie in anonymous executable memory.
+  //!
+  //! Code generated at run time can't be recovered from any module, so without
+  //! this a crash in it leaves little to examine. Return addresses are found by
+  //! following frame pointers, which JIT compilers generally maintain, for up
+  //! to a fixed number of frames. Windows are added in order from the
+  //! innermost frame outward, and parts that overlap a window already added
+  //! are left out, so that the result depends only on the target's state and
+  //! never exceeds a fixed size.
+  //!
+  //! \param[in] context The context to inspect.
+  //! \param[in] delegate A Delegate that handles reading from the target
+  //!     process and adding new ranges.
+  static void JitCodeAroundContext(const CPUContext& context,
+                                   Delegate* delegate);
+
   //! \brief For all pointer-like values in a memory range of the target
   //! process,
   //!     captures a small amount of memory near the pointed to location.
@@ -0,0 +1,324 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/capture_memory.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "snapshot/cpu_context.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/misc/range_set.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Serves reads from a buffer in this process and records the ranges that
+// CaptureMemory adds, with the same deduplication and budget as the
+// platform delegates.
+class TestDelegate : public internal::CaptureMemory::Delegate {
+ public:
+  TestDelegate(const void* memory, size_t size, uint32_t budget)
+      : memory_(FromPointerCast<uint64_t>(memory), size),
+        anonymous_executable_(0, 0),
+        budget_remaining_(budget),
+        captured_(),
+        added_() {}
+
+  TestDelegate(const TestDelegate&) = delete;
+  TestDelegate& operator=(const TestDelegate&) = delete;
+
+  ~TestDelegate() override {}
+
+  const std::vector<CheckedRange<uint64_t>>& added() const { return added_; }
+
+  void set_anonymous_executable(const void* memory, size_t size) {
+    anonymous_executable_.SetRange(FromPointerCast<uint64_t>(memory), size);
+  }
+
+  bool AddedContaining(uint64_t address) const {
+    for (const auto& range : added_) {
+      if (range.ContainsValue(address)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // CaptureMemory::Delegate:
+  bool Is64Bit() const override { return sizeof(void*) == 8; }
+
+  bool ReadMemory(uint64_t at, uint64_t num_bytes, void* into) const override {
+    if (!memory_.ContainsRange(CheckedRange<uint64_t>(at, num_bytes))) {
+      ADD_FAILURE() << "read outside of memory";
+      return false;
+    }
+    memcpy(into, reinterpret_cast<const void*>(at), num_bytes);
+    return true;
+  }
+
+  std::vector<CheckedRange<uint64_t>> GetReadableRanges(
+      const CheckedRange<uint64_t, uint64_t>& range) const override {
+    std::vector<CheckedRange<uint64_t>> ranges;
+    const uint64_t base = std::max(range.base(), memory_.base());
+    const uint64_t end = std::min(range.end(), memory_.end());
+    if (base < end) {
+      ranges.emplace_back(base, end - base);
+    }
+    return ranges;
+  }
+
+  bool AddNewMemorySnapshot(
+      const CheckedRange<uint64_t, uint64_t>& range) override {
+    if (range.size() == 0 || budget_remaining_ == 0) {
+      return false;
+    }
+    std::vector<RangeSet::Range> captured =
+        captured_.Intersect(range.base(), range.size());
+    if (captured.size() == 1 && captured[0].size == range.size()) {
+      return false;
+    }
+    captured_.Insert(range.base(), range.size());
+    added_.push_back(range);
+    budget_remaining_ = range.size() < budget_remaining_
+                            ? budget_remaining_ - range.size()
+                            : 0;
+    return true;
+  }
+
+  bool IsAnonymousExecutable(uint64_t address) const override {
+    return anonymous_executable_.ContainsValue(address);
+  }
+
+ private:
+  CheckedRange<uint64_t> memory_;
+  CheckedRange<uint64_t> anonymous_executable_;
+  uint32_t budget_remaining_;
+  RangeSet captured_;
+  std::vector<CheckedRange<uint64_t>> added_;
+};
+
+// A chain of nodes, each holding a pointer to the next, spaced far enough
+// apart that the memory captured around one doesn't include another.
+class NodeChain {
+ public:
+  static constexpr size_t kNodeCount = 4;
+  static constexpr size_t kNodeSpacing = 1024;
+
+  NodeChain() : words_(kNodeCount * kNodeSpacing + kNodeSpacing) {
+    for (size_t index = 0; index + 1 < kNodeCount; ++index) {
+      *Node(index) = FromPointerCast<uintptr_t>(Node(index + 1));
+    }
+  }
+
+  NodeChain(const NodeChain&) = delete;
+  NodeChain& operator=(const NodeChain&) = delete;
+
+  uintptr_t* Node(size_t index) {
+    return &words_[kNodeSpacing / 2 + index * kNodeSpacing];
+  }
+
+  uint64_t NodeAddress(size_t index) {
+    return FromPointerCast<uint64_t>(Node(index));
+  }
+
+  const void* data() const { return words_.data(); }
+  size_t size() const { return words_.size() * sizeof(words_[0]); }
+
+ private:
+  std::vector<uintptr_t> words_;
+};
+
+// TestContext only knows how to build contexts for these architectures.
+#if defined(ARCH_CPU_X86_64) || defined(ARCH_CPU_ARM64) || \
+    defined(ARCH_CPU_RISCV64)
+
+class TestContext {
+ public:
+  // Initializes a context whose only pointer-like register value is \a value.
+  explicit TestContext(uint64_t value) : context_(), union_() {
+#if defined(ARCH_CPU_X86_64)
+    context_.architecture = kCPUArchitectureX86_64;
+    context_.x86_64 = &union_.x86_64;
+    union_.x86_64.rax = value;
+#elif defined(ARCH_CPU_ARM64)
+    context_.architecture = kCPUArchitectureARM64;
+    context_.arm64 = &union_.arm64;
+    union_.arm64.regs[0] = value;
+#elif defined(ARCH_CPU_RISCV64)
+    context_.architecture = kCPUArchitectureRISCV64;
+    context_.riscv64 = &union_.riscv64;
+    union_.riscv64.regs[0] = value;
+#endif
+  }
+
+  TestContext(const TestContext&) = delete;
+  TestContext& operator=(const TestContext&) = delete;
+
+  // Sets the program counter and frame pointer.
+  void SetFrame(uint64_t pc, uint64_t frame_pointer) {
+#if defined(ARCH_CPU_X86_64)
+    union_.x86_64.rip = pc;
+    union_.x86_64.rbp = frame_pointer;
+#elif defined(ARCH_CPU_ARM64)
+    union_.arm64.pc = pc;
+    union_.arm64.regs[29] = frame_pointer;
+#elif defined(ARCH_CPU_RISCV64)
+    union_.riscv64.pc = pc;
+#endif
+  }
+
+  const CPUContext& context() const { return context_; }
+
+ private:
+  CPUContext context_;
+  union {
+#if defined(ARCH_CPU_X86_64)
+    CPUContextX86_64 x86_64;
+#elif defined(ARCH_CPU_ARM64)
+    CPUContextARM64 arm64;
+#elif defined(ARCH_CPU_RISCV64)
+    CPUContextRISCV64 riscv64;
+#endif
+  } union_;
+};
+
+void ExpectNodesCaptured(size_t depth,
+                         uint32_t budget,
+                         size_t expected_nodes,
+                         NodeChain* chain) {
+  TestDelegate delegate(chain->data(), chain->size(), budget);
+  TestContext context(chain->NodeAddress(0));
+  internal::CaptureMemory::PointedToByContextRecursively(
+      context.context(), depth, &delegate);
+
+  EXPECT_EQ(delegate.added().size(), expected_nodes);
+  for (size_t index = 0; index < NodeChain::kNodeCount; ++index) {
+    EXPECT_EQ(delegate.AddedContaining(chain->NodeAddress(index)),
+              index < expected_nodes)
+        << "node " << index;
+  }
+}
+
+TEST(CaptureMemory, Depth) {
+  NodeChain chain;
+  constexpr uint32_t kBudget = 1024 * 1024;
+  ExpectNodesCaptured(/* depth= */ 0, kBudget, 0, &chain);
+  ExpectNodesCaptured(/* depth= */ 1, kBudget, 1, &chain);
+  ExpectNodesCaptured(/* depth= */ 3, kBudget, 3, &chain);
+  ExpectNodesCaptured(/* depth= */ 8, kBudget, NodeChain::kNodeCount, &chain);
+}
+
+TEST(CaptureMemory, Budget) {
+  NodeChain chain;
+
+  // Each node's range is 512 bytes. Once the budget is exhausted, nothing
+  // deeper is followed.
+  ExpectNodesCaptured(/* depth= */ 8, /* budget= */ 1000, 2, &chain);
+  ExpectNodesCaptured(/* depth= */ 8, /* budget= */ 0, 0, &chain);
+}
+
+TEST(CaptureMemory, Cycle) {
+  NodeChain chain;
+  *chain.Node(NodeChain::kNodeCount - 1) =
+      FromPointerCast<uintptr_t>(chain.Node(0));
+
+  // Memory that was already captured isn't captured or scanned again.
+  ExpectNodesCaptured(/* depth= */ 100,
+                      /* budget= */ 1024 * 1024,
+                      NodeChain::kNodeCount,
+                      &chain);
+}
+
+TEST(CaptureMemory, MatchesPointedToByContext) {
+  NodeChain chain;
+  TestContext context(chain.NodeAddress(0));
+
+  TestDelegate delegate(chain.data(), chain.size(), 1024 * 1024);
+  internal::CaptureMemory::PointedToByContext(context.context(), &delegate);
+
+  TestDelegate recursive_delegate(chain.data(), chain.size(), 1024 * 1024);
+  internal::CaptureMemory::PointedToByContextRecursively(
+      context.context(), 1, &recursive_delegate);
+
+  ASSERT_EQ(recursive_delegate.added().size(), delegate.added().size());
+  for (size_t index = 0; index < delegate.added().size(); ++index) {
+    EXPECT_EQ(recursive_delegate.added()[index].base(),
+              delegate.added()[index].base());
+    EXPECT_EQ(recursive_delegate.added()[index].size(),
+              delegate.added()[index].size());
+  }
+}
+
+TEST(CaptureMemory, JitCode) {
+  // Code and frame records share one buffer so that the delegate can read
+  // both. The first half is treated as anonymous executable memory.
+  constexpr size_t kCodeSize = 16 * 1024;
+  std::vector<uintptr_t> words((kCodeSize + 1024) / sizeof(uintptr_t));
+  uint8_t* code = reinterpret_cast<uint8_t*>(words.data());
+  const uint64_t code_address = FromPointerCast<uint64_t>(code);
+  uintptr_t* frames = &words[kCodeSize / sizeof(uintptr_t)];
+
+  // Two frames return into the code half, one of them near the PC, with a
+  // frame returning outside of it in between.
+  const uint64_t pc = code_address + 4096;
+  frames[0] = FromPointerCast<uintptr_t>(&frames[2]);
+  frames[1] = static_cast<uintptr_t>(pc + 1000);
+  frames[2] = FromPointerCast<uintptr_t>(&frames[4]);
+  frames[3] = FromPointerCast<uintptr_t>(&frames[8]);
+  frames[4] = 0;
+  frames[5] = static_cast<uintptr_t>(code_address + 12 * 1024);
+
+  TestDelegate delegate(
+      words.data(), words.size() * sizeof(words[0]), 64 * 1024);
+  delegate.set_anonymous_executable(code, kCodeSize);
+  TestContext context(0);
+  context.SetFrame(pc, FromPointerCast<uint64_t>(frames));
+  internal::CaptureMemory::JitCodeAroundContext(context.context(), &delegate);
+
+#if defined(ARCH_CPU_RISCV64)
+  // Frame records aren't followed, so only the PC's window is captured.
+  ASSERT_EQ(delegate.added().size(), 1u);
+#else
+  // The window around the first return address overlaps the PC's, so only
+  // the part past it is added.
+  ASSERT_EQ(delegate.added().size(), 3u);
+  EXPECT_EQ(delegate.added()[1].base(), pc + 1024);
+  EXPECT_EQ(delegate.added()[1].size(), 40u);
+  EXPECT_EQ(delegate.added()[2].base(), code_address + 12 * 1024 - 256);
+  EXPECT_EQ(delegate.added()[2].size(), 256u + 64);
+#endif
+  EXPECT_EQ(delegate.added()[0].base(), pc - 1024);
+  EXPECT_EQ(delegate.added()[0].size(), 2048u);
+
+  // Nothing is captured outside of anonymous executable memory.
+  TestDelegate other_delegate(
+      words.data(), words.size() * sizeof(words[0]), 64 * 1024);
+  other_delegate.set_anonymous_executable(code, 1024);
+  internal::CaptureMemory::JitCodeAroundContext(context.context(),
+                                                &other_delegate);
+  EXPECT_TRUE(other_delegate.added().empty());
+}
+
+#endif  // ARCH_CPU_X86_64 || ARCH_CPU_ARM64 || ARCH_CPU_RISCV64
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
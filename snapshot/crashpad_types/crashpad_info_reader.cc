@@ -14,10 +14,13 @@
 
 #include "snapshot/crashpad_types/crashpad_info_reader.h"
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include "build/build_config.h"
 #include "client/crashpad_info.h"
+#include "base/logging.h"
 #include "util/misc/as_underlying_type.h"
 
 #if BUILDFLAG(IS_WIN)
@@ -32,6 +35,9 @@ namespace crashpad {
 
 namespace {
 
+// A larger table than this is taken to be corrupt rather than read.
+constexpr uint32_t kMaxExtraMemoryRangeTableSize = 64 * 1024;
+
 void UnsetIfNotValidTriState(TriState* value) {
   switch (AsUnderlyingType(*value)) {
     case AsUnderlyingType(TriState::kUnset):
@@ -114,6 +120,10 @@ class CrashpadInfoReader::InfoContainerSpecific : public InfoContainer {
     typename Traits::Address simple_annotations;
     typename Traits::Address user_data_minidump_stream_head;
     typename Traits::Address annotations_list;
+    typename Traits::Address annotation_arena;
+    typename Traits::Address extra_memory_range_table;
+    uint32_t extra_memory_range_table_size;
+    uint32_t padding_2;
   } info;
 
 #if defined(ARCH_CPU_64_BITS)
@@ -187,11 +197,55 @@ DEFINE_GETTER(VMAddress, SimpleAnnotations, simple_annotations)
 
 DEFINE_GETTER(VMAddress, AnnotationsList, annotations_list)
 
+DEFINE_GETTER(VMAddress, AnnotationArena, annotation_arena)
+
 DEFINE_GETTER(VMAddress,
               UserDataMinidumpStreamHead,
               user_data_minidump_stream_head)
 
+DEFINE_GETTER(VMAddress, ExtraMemoryRangeTable, extra_memory_range_table)
+
+DEFINE_GETTER(uint32_t,
+              ExtraMemoryRangeTableSize,
+              extra_memory_range_table_size)
+
 #undef DEFINE_GETTER
 #undef GET_MEMBER
 
+void CrashpadInfoReader::ReadExtraMemoryRanges(
+    const ProcessMemory* memory,
+    const std::string& module_name,
+    std::set<CheckedRange<uint64_t>>* ranges) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const auto read_entries = [memory, &module_name, ranges](VMAddress address,
+                                                           size_t count) {
+    std::vector<SimpleAddressRangeBag::Entry> entries(count);
+    if (!memory->Read(address, count * sizeof(entries[0]), entries.data())) {
+      LOG(WARNING) << "could not read extra memory ranges from "
+                   << module_name;
+      return;
+    }
+    for (const auto& entry : entries) {
+      if (entry.is_active()) {
+        ranges->insert(CheckedRange<uint64_t>(entry.base, entry.size));
+      }
+    }
+  };
+
+  if (ExtraMemoryRanges()) {
+    read_entries(ExtraMemoryRanges(), SimpleAddressRangeBag::num_entries);
+  }
+
+  const uint32_t table_size = ExtraMemoryRangeTableSize();
+  if (ExtraMemoryRangeTable() && table_size) {
+    if (table_size > kMaxExtraMemoryRangeTableSize) {
+      LOG(WARNING) << "extra memory range table size " << table_size
+                   << " too large in " << module_name;
+      return;
+    }
+    read_entries(ExtraMemoryRangeTable(), table_size);
+  }
+}
+
 }  // namespace crashpad
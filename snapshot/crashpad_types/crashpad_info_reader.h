@@ -18,10 +18,14 @@
 #include <stdint.h>
 
 #include <memory>
+#include <set>
+#include <string>
 
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/tri_state.h"
+#include "util/numeric/checked_range.h"
+#include "util/process/process_memory.h"
 #include "util/process/process_memory_range.h"
 
 namespace crashpad {
@@ -57,9 +61,27 @@ class CrashpadInfoReader {
   VMAddress ExtraMemoryRanges();
   VMAddress SimpleAnnotations();
   VMAddress AnnotationsList();
+  VMAddress AnnotationArena();
   VMAddress UserDataMinidumpStreamHead();
+  VMAddress ExtraMemoryRangeTable();
+  uint32_t ExtraMemoryRangeTableSize();
   //! \}
 
+  //! \brief Reads the extra memory ranges registered with the CrashpadInfo
+  //!     struct, from both its SimpleAddressRangeBag and its extra memory
+  //!     range table.
+  //!
+  //! Each is copied out of the remote process in a single read. Inactive
+  //! entries are skipped, and duplicate ranges are merged.
+  //!
+  //! \param[in] memory The memory of the remote process.
+  //! \param[in] module_name The name of the module containing the CrashpadInfo
+  //!     struct, for logging.
+  //! \param[out] ranges The ranges read are added to this set.
+  void ReadExtraMemoryRanges(const ProcessMemory* memory,
+                             const std::string& module_name,
+                             std::set<CheckedRange<uint64_t>>* ranges);
+
  private:
   class InfoContainer;
 
@@ -60,6 +60,7 @@ class ScopedUnsetCrashpadInfo {
     crashpad_info_->set_extra_memory_ranges(nullptr);
     crashpad_info_->set_simple_annotations(nullptr);
     crashpad_info_->set_annotations_list(nullptr);
+    crashpad_info_->set_annotation_arena(nullptr);
   }
 
  private:
@@ -133,6 +134,7 @@ void ExpectCrashpadInfo(ProcessType process,
   EXPECT_EQ(reader.ExtraMemoryRanges(), extra_memory_address);
   EXPECT_EQ(reader.SimpleAnnotations(), simple_annotations_address);
   EXPECT_EQ(reader.AnnotationsList(), annotations_list_address);
+  EXPECT_EQ(reader.AnnotationArena(), 0u);
 }
 
 TEST(CrashpadInfoReader, ReadFromSelf) {
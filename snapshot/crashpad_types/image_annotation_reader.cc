@@ -14,6 +14,7 @@
 
 #include "snapshot/crashpad_types/image_annotation_reader.h"
 
+#include <stddef.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -23,9 +24,12 @@
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "client/annotation.h"
+#include "client/annotation_arena.h"
 #include "client/annotation_list.h"
+#include "client/seqlock_annotation.h"
 #include "client/simple_string_dictionary.h"
 #include "snapshot/snapshot_constants.h"
+#include "util/misc/as_underlying_type.h"
 #if BUILDFLAG(IS_FUCHSIA)
 #include "util/fuchsia/traits.h"
 #else
@@ -34,6 +38,49 @@
 
 namespace crashpad {
 
+namespace {
+
+// The most name and value bytes that will be buffered for a single batched
+// read of AnnotationList payloads.
+constexpr size_t kMaxAnnotationPayloadBatchSize = 1024 * 1024;
+
+// The most times that a kSeqlockString value will be read while it’s being
+// written to before it’s discarded.
+constexpr int kSeqlockReadAttempts = 4;
+
+// Replaces the copy of a kSeqlockString value in snapshot with the string that
+// it holds, as a kString. If the value was being written while it was copied,
+// it’s read again. Returns false if no consistent copy could be read.
+bool ResolveSeqlockValue(const ProcessMemoryRange* memory,
+                         VMAddress address,
+                         AnnotationSnapshot* snapshot) {
+  for (int attempt = 1;; ++attempt) {
+    // The sequence number is read again after the copy. If it still matches
+    // the one in the copy, nothing was written while the copy was taken.
+    uint32_t sequence;
+    uint32_t sequence_after;
+    std::vector<uint8_t> string;
+    if (ReadSeqlockAnnotationValue(snapshot->value.data(),
+                                   snapshot->value.size(),
+                                   &sequence,
+                                   &string) &&
+        memory->Read(address, sizeof(sequence_after), &sequence_after) &&
+        sequence_after == sequence) {
+      snapshot->type = AsUnderlyingType(Annotation::Type::kString);
+      snapshot->value.swap(string);
+      return true;
+    }
+
+    if (attempt == kSeqlockReadAttempts ||
+        !memory->Read(
+            address, snapshot->value.size(), snapshot->value.data())) {
+      return false;
+    }
+  }
+}
+
+}  // namespace
+
 namespace process_types {
 
 template <class Traits>
@@ -47,11 +94,37 @@ struct Annotation {
   bool spin_guard_state;
 };
 
+// An Annotation along with the field that follows those that handlers have
+// always read, which clients built before it was added don’t have.
+template <class Traits>
+struct GenerationAnnotation {
+  Annotation<Traits> annotation;
+  uint32_t generation;
+};
+
 template <class Traits>
 struct AnnotationList {
   typename Traits::Address tail_pointer;
-  Annotation<Traits> head;
-  Annotation<Traits> tail;
+  GenerationAnnotation<Traits> head;
+  GenerationAnnotation<Traits> tail;
+  uint32_t generation;
+};
+
+template <class Traits>
+struct AnnotationArena {
+  uint32_t signature;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t used;
+  typename Traits::Address storage;
+};
+
+struct AnnotationArenaEntry {
+  uint32_t entry_size;
+  uint16_t type;
+  uint16_t name_length;
+  uint32_t value_capacity;
+  uint32_t value_size;
 };
 
 }  // namespace process_types
@@ -62,7 +135,7 @@ struct AnnotationList {
 #define NATIVE_TRAITS Traits32
 #endif  // ARCH_CPU_64_BITS
 
-static_assert(sizeof(process_types::Annotation<NATIVE_TRAITS>) ==
+static_assert(sizeof(process_types::GenerationAnnotation<NATIVE_TRAITS>) ==
                   sizeof(Annotation),
               "Annotation size mismatch");
 
@@ -70,6 +143,14 @@ static_assert(sizeof(process_types::AnnotationList<NATIVE_TRAITS>) ==
                   sizeof(AnnotationList),
               "AnnotationList size mismatch");
 
+static_assert(sizeof(process_types::AnnotationArena<NATIVE_TRAITS>) ==
+                  sizeof(AnnotationArena),
+              "AnnotationArena size mismatch");
+
+static_assert(sizeof(process_types::AnnotationArenaEntry) ==
+                  sizeof(AnnotationArena::Entry),
+              "AnnotationArena::Entry size mismatch");
+
 #undef NATIVE_TRAITS
 
 ImageAnnotationReader::ImageAnnotationReader(const ProcessMemoryRange* memory)
@@ -106,51 +187,217 @@ bool ImageAnnotationReader::AnnotationsList(
     VMAddress address,
     std::vector<AnnotationSnapshot>* annotations) const {
   return memory_->Is64Bit()
-             ? ReadAnnotationList<Traits64>(address, annotations)
-             : ReadAnnotationList<Traits32>(address, annotations);
+             ? ReadAnnotationList<Traits64>(address, nullptr, annotations)
+             : ReadAnnotationList<Traits32>(address, nullptr, annotations);
+}
+
+bool ImageAnnotationReader::ChangedAnnotationsList(
+    VMAddress address,
+    uint32_t since_generation,
+    std::vector<AnnotationSnapshot>* annotations) const {
+  return memory_->Is64Bit() ? ReadAnnotationList<Traits64>(
+                                  address, &since_generation, annotations)
+                            : ReadAnnotationList<Traits32>(
+                                  address, &since_generation, annotations);
+}
+
+bool ImageAnnotationReader::AnnotationArena(
+    VMAddress address,
+    std::vector<AnnotationSnapshot>* annotations) const {
+  return memory_->Is64Bit()
+             ? ReadAnnotationArena<Traits64>(address, annotations)
+             : ReadAnnotationArena<Traits32>(address, annotations);
 }
 
 template <class Traits>
 bool ImageAnnotationReader::ReadAnnotationList(
     VMAddress address,
+    const uint32_t* since_generation,
     std::vector<AnnotationSnapshot>* annotations) const {
+  // Only the fields up to the head are needed, and only those are read, as
+  // they’re all that clients built before the generation was added have.
   process_types::AnnotationList<Traits> annotation_list;
-  if (!memory_->Read(address, sizeof(annotation_list), &annotation_list)) {
+  if (!memory_->Read(address,
+                     offsetof(process_types::AnnotationList<Traits>, tail),
+                     &annotation_list)) {
     LOG(ERROR) << "could not read annotation list";
     return false;
   }
 
-  process_types::Annotation<Traits> current = annotation_list.head;
-  for (size_t index = 0; current.link_node != annotation_list.tail_pointer &&
-                         index < kMaxNumberOfAnnotations;
+  // Each Annotation header must be read to find the next one, but names and
+  // values are gathered and read together afterwards. Generations are only
+  // read when they’re needed to filter the annotations.
+  std::vector<process_types::Annotation<Traits>> nodes;
+  process_types::GenerationAnnotation<Traits> current = annotation_list.head;
+  const size_t node_size =
+      since_generation ? sizeof(current) : sizeof(current.annotation);
+  for (size_t index = 0;
+       current.annotation.link_node != annotation_list.tail_pointer &&
+       index < kMaxNumberOfAnnotations;
        ++index) {
-    if (!memory_->Read(current.link_node, sizeof(current), &current)) {
+    if (!memory_->Read(current.annotation.link_node, node_size, &current)) {
       LOG(ERROR) << "could not read annotation at index " << index;
       return false;
     }
 
-    if (current.size == 0) {
+    if (current.annotation.size == 0) {
       continue;
     }
 
-    AnnotationSnapshot snapshot;
-    snapshot.type = current.type;
-
-    if (!memory_->ReadCStringSizeLimited(
-            current.name, Annotation::kNameMaxLength, &snapshot.name)) {
-      LOG(WARNING) << "could not read annotation name at index " << index;
+    // A kSeqlockString value is updated without Annotation::SetSize(), so its
+    // generation doesn’t say whether it has changed, and it’s always kept.
+    if (since_generation &&
+        current.annotation.type !=
+            AsUnderlyingType(Annotation::Type::kSeqlockString) &&
+        static_cast<int32_t>(current.generation - *since_generation) <= 0) {
       continue;
     }
+    nodes.push_back(current.annotation);
+  }
 
-    size_t value_length =
-        std::min(static_cast<size_t>(current.size), Annotation::kValueMaxSize);
-    snapshot.value.resize(value_length);
-    if (!memory_->Read(current.value, value_length, snapshot.value.data())) {
-      LOG(WARNING) << "could not read annotation value at index " << index;
-      continue;
+  const VMAddress range_end = memory_->Base() + memory_->Size();
+  size_t batch_begin = 0;
+  while (batch_begin < nodes.size()) {
+    std::vector<AnnotationSnapshot> snapshots;
+    std::vector<std::vector<char>> names;
+    std::vector<ProcessMemory::ReadRange> ranges;
+    size_t batch_size = 0;
+    size_t batch_end = batch_begin;
+    for (; batch_end < nodes.size(); ++batch_end) {
+      const process_types::Annotation<Traits>& node = nodes[batch_end];
+
+      // A name is read at its maximum length, clamped to the end of the
+      // range, and then searched for its terminator.
+      size_t name_length = 0;
+      if (node.name >= memory_->Base() && node.name < range_end) {
+        name_length = static_cast<size_t>(std::min(
+            VMSize{Annotation::kNameMaxLength}, range_end - node.name));
+      }
+      size_t value_length =
+          std::min(static_cast<size_t>(node.size), Annotation::kValueMaxSize);
+      if (batch_end != batch_begin &&
+          batch_size + name_length + value_length >
+              kMaxAnnotationPayloadBatchSize) {
+        break;
+      }
+      batch_size += name_length + value_length;
+
+      snapshots.emplace_back();
+      snapshots.back().type = node.type;
+      snapshots.back().value.resize(value_length);
+      names.emplace_back(name_length);
+    }
+
+    for (size_t index = 0; index < snapshots.size(); ++index) {
+      const process_types::Annotation<Traits>& node =
+          nodes[batch_begin + index];
+      ranges.push_back({node.name, names[index].size(), names[index].data()});
+      ranges.push_back({node.value,
+                        snapshots[index].value.size(),
+                        snapshots[index].value.data()});
+    }
+
+    std::vector<bool> results;
+    memory_->ReadBatch(ranges, &results);
+
+    for (size_t index = 0; index < snapshots.size(); ++index) {
+      const size_t node_index = batch_begin + index;
+      AnnotationSnapshot& snapshot = snapshots[index];
+      const std::vector<char>& name = names[index];
+
+      // The fixed-length name read may have run past the end of the name's
+      // mapping, in which case the name is read again on its own.
+      size_t length = strnlen(name.data(), name.size());
+      if (results[index * 2] && length < name.size()) {
+        snapshot.name.assign(name.data(), length);
+      } else if (!memory_->ReadCStringSizeLimited(nodes[node_index].name,
+                                                  Annotation::kNameMaxLength,
+                                                  &snapshot.name)) {
+        LOG(WARNING) << "could not read annotation name at index "
+                     << node_index;
+        continue;
+      }
+
+      if (!results[index * 2 + 1]) {
+        LOG(WARNING) << "could not read annotation value at index "
+                     << node_index;
+        continue;
+      }
+
+      if (snapshot.type == AsUnderlyingType(Annotation::Type::kSeqlockString) &&
+          !ResolveSeqlockValue(memory_, nodes[node_index].value, &snapshot)) {
+        LOG(WARNING) << "discarding annotation value being written at index "
+                     << node_index;
+        continue;
+      }
+
+      annotations->push_back(std::move(snapshot));
+    }
+
+    batch_begin = batch_end;
+  }
+
+  return true;
+}
+
+template <class Traits>
+bool ImageAnnotationReader::ReadAnnotationArena(
+    VMAddress address,
+    std::vector<AnnotationSnapshot>* annotations) const {
+  process_types::AnnotationArena<Traits> arena;
+  if (!memory_->Read(address, sizeof(arena), &arena)) {
+    LOG(ERROR) << "could not read annotation arena";
+    return false;
+  }
+  if (arena.signature != crashpad::AnnotationArena::kSignature ||
+      arena.version != crashpad::AnnotationArena::kVersion ||
+      arena.used > arena.capacity) {
+    LOG(ERROR) << "invalid annotation arena";
+    return false;
+  }
+
+  size_t used = arena.used;
+  if (used > kMaxAnnotationArenaSize) {
+    LOG(WARNING) << "annotation arena truncated from " << used << " bytes";
+    used = kMaxAnnotationArenaSize;
+  }
+
+  // Read every entry at once, rather than one read per name and value.
+  std::vector<uint8_t> storage(used);
+  if (used && !memory_->Read(arena.storage, used, storage.data())) {
+    LOG(ERROR) << "could not read annotation arena storage";
+    return false;
+  }
+
+  size_t offset = 0;
+  while (used - offset >= sizeof(process_types::AnnotationArenaEntry)) {
+    process_types::AnnotationArenaEntry entry;
+    memcpy(&entry, &storage[offset], sizeof(entry));
+
+    // A zero size means that the process crashed while adding this entry.
+    if (entry.entry_size == 0) {
+      break;
+    }
+    if (entry.entry_size > used - offset ||
+        entry.entry_size < sizeof(entry) + size_t{entry.name_length} +
+                               entry.value_capacity) {
+      LOG(WARNING) << "invalid annotation arena entry at offset " << offset;
+      break;
+    }
+
+    if (entry.value_size != 0 && entry.value_size <= entry.value_capacity) {
+      const uint8_t* name = &storage[offset + sizeof(entry)];
+      const uint8_t* value = name + entry.name_length;
+
+      AnnotationSnapshot snapshot;
+      snapshot.type = entry.type;
+      snapshot.name.assign(reinterpret_cast<const char*>(name),
+                           entry.name_length);
+      snapshot.value.assign(value, value + entry.value_size);
+      annotations->push_back(std::move(snapshot));
     }
 
-    annotations->push_back(std::move(snapshot));
+    offset += entry.entry_size;
   }
 
   return true;
@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_SNAPSHOT_CRASHPAD_TYPES_IMAGE_ANNOTATION_READER_H_
 #define CRASHPAD_SNAPSHOT_CRASHPAD_TYPES_IMAGE_ANNOTATION_READER_H_
 
+#include <stdint.h>
+
 #include <map>
 #include <string>
 #include <vector>
@@ -63,11 +65,47 @@ class ImageAnnotationReader {
   bool AnnotationsList(VMAddress,
                        std::vector<AnnotationSnapshot>* annotations) const;
 
+  //! \brief Reads the annotations in an AnnotationList that have been set
+  //!     since a generation of the list.
+  //!
+  //! Annotations whose Annotation::generation() is no later than \a
+  //! since_generation are left out, except for those of type
+  //! Annotation::Type::kSeqlockString, which change without their generation
+  //! being updated. Only clients that record generations may be read this way.
+  //!
+  //! \param[in] address The address in the target process' address space of an
+  //!     AnnotationList.
+  //! \param[in] since_generation A value returned by
+  //!     AnnotationList::generation().
+  //! \param[out] annotations The annotations read, valid if this method returns
+  //!     `true`.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool ChangedAnnotationsList(
+      VMAddress address,
+      uint32_t since_generation,
+      std::vector<AnnotationSnapshot>* annotations) const;
+
+  //! \brief Reads the module's annotations that are stored in an
+  //!     AnnotationArena.
+  //!
+  //! \param[in] address The address in the target process' address space of an
+  //!     AnnotationArena.
+  //! \param[out] annotations The annotations read are appended to this vector,
+  //!     valid if this method returns `true`.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool AnnotationArena(VMAddress address,
+                       std::vector<AnnotationSnapshot>* annotations) const;
+
  private:
   template <class Traits>
   bool ReadAnnotationList(VMAddress address,
+                          const uint32_t* since_generation,
                           std::vector<AnnotationSnapshot>* annotations) const;
 
+  template <class Traits>
+  bool ReadAnnotationArena(VMAddress address,
+                           std::vector<AnnotationSnapshot>* annotations) const;
+
   const ProcessMemoryRange* memory_;  // weak
 };
 
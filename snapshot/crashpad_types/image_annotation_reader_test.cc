@@ -20,13 +20,17 @@
 
 #include <algorithm>
 
+#include "base/memory/page_size.h"
 #include "build/build_config.h"
 #include "client/annotation.h"
+#include "client/annotation_arena.h"
 #include "client/annotation_list.h"
+#include "client/seqlock_annotation.h"
 #include "client/simple_string_dictionary.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
 #include "test/process_type.h"
+#include "test/scoped_guarded_page.h"
 #include "util/file/file_io.h"
 #include "util/misc/as_underlying_type.h"
 #include "util/misc/from_pointer_cast.h"
@@ -141,6 +145,247 @@ TEST(ImageAnnotationReader, ReadFromSelf) {
                     FromPointerCast<VMAddress>(&annotations));
 }
 
+TEST(ImageAnnotationReader, ReadArenaFromSelf) {
+  alignas(8) uint8_t arena_storage[256];
+  AnnotationArena arena(arena_storage, sizeof(arena_storage));
+
+  AnnotationArena::Entry* first =
+      arena.Add(Annotation::Type::kString, "first", 16);
+  ASSERT_TRUE(first);
+  static constexpr char kFirstValue[] = "first value";
+  first->SetValue(kFirstValue, sizeof(kFirstValue));
+
+  // Entries without a value aren't reported.
+  ASSERT_TRUE(arena.Add(Annotation::Type::kString, "unset", 16));
+
+  AnnotationArena::Entry* second =
+      arena.Add(Annotation::UserDefinedType(1), "second", 4);
+  ASSERT_TRUE(second);
+  static constexpr uint8_t kSecondValue[] = {1, 2, 3, 4, 5};
+  second->SetValue(kSecondValue, sizeof(kSecondValue));
+  EXPECT_EQ(second->value_size(), 4u);
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ImageAnnotationReader reader(&range);
+  std::vector<AnnotationSnapshot> annotations;
+  ASSERT_TRUE(
+      reader.AnnotationArena(FromPointerCast<VMAddress>(&arena), &annotations));
+  ASSERT_EQ(annotations.size(), 2u);
+
+  EXPECT_EQ(annotations[0].name, "first");
+  EXPECT_EQ(annotations[0].type, AsUnderlyingType(Annotation::Type::kString));
+  EXPECT_EQ(annotations[0].value,
+            std::vector<uint8_t>(kFirstValue,
+                                 kFirstValue + sizeof(kFirstValue)));
+
+  EXPECT_EQ(annotations[1].name, "second");
+  EXPECT_EQ(annotations[1].type,
+            AsUnderlyingType(Annotation::UserDefinedType(1)));
+  EXPECT_EQ(annotations[1].value,
+            std::vector<uint8_t>(kSecondValue, kSecondValue + 4));
+
+  second->Clear();
+  annotations.clear();
+  ASSERT_TRUE(
+      reader.AnnotationArena(FromPointerCast<VMAddress>(&arena), &annotations));
+  ASSERT_EQ(annotations.size(), 1u);
+  EXPECT_EQ(annotations[0].name, "first");
+}
+
+TEST(ImageAnnotationReader, ReadNameAtEndOfMapping) {
+  // Names are read with a fixed-length batched read, which can't succeed when
+  // the name ends just before an inaccessible page.
+  ScopedGuardedPage page;
+  static constexpr char kAnnotationName[] = "guarded name";
+  char* name = reinterpret_cast<char*>(page.Pointer()) + base::GetPageSize() -
+               sizeof(kAnnotationName);
+  memcpy(name, kAnnotationName, sizeof(kAnnotationName));
+
+  static constexpr char kAnnotationValue[] = "guarded value";
+  Annotation annotation(
+      Annotation::Type::kString,
+      name,
+      reinterpret_cast<void*>(const_cast<char*>(kAnnotationValue)));
+
+  static constexpr char kOtherName[] = "other name";
+  static constexpr char kOtherValue[] = "other value";
+  Annotation other(Annotation::Type::kString,
+                   kOtherName,
+                   reinterpret_cast<void*>(const_cast<char*>(kOtherValue)));
+
+  // The annotations are added to the list before their sizes are set, so that
+  // SetSize() doesn't add them to the process' global list instead.
+  AnnotationList list;
+  list.Add(&annotation);
+  list.Add(&other);
+  annotation.SetSize(sizeof(kAnnotationValue));
+  other.SetSize(sizeof(kOtherValue));
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ImageAnnotationReader reader(&range);
+  std::vector<AnnotationSnapshot> annotations;
+  ASSERT_TRUE(
+      reader.AnnotationsList(FromPointerCast<VMAddress>(&list), &annotations));
+  ASSERT_EQ(annotations.size(), 2u);
+  ExpectAnnotationList(annotations, list);
+}
+
+TEST(ImageAnnotationReader, ReadSeqlockFromSelf) {
+  SeqlockStringAnnotation<16> annotation("seqlock");
+
+  // A value seen mid-write, with an odd sequence number, is discarded.
+  struct {
+    uint32_t sequence;
+    uint32_t size;
+    char data[4];
+  } writing_value = {3, 4, {'t', 'o', 'r', 'n'}};
+  Annotation writing(Annotation::Type::kSeqlockString,
+                     "writing",
+                     reinterpret_cast<void*>(&writing_value));
+
+  AnnotationList list;
+  list.Add(&annotation);
+  list.Add(&writing);
+  annotation.Set("seqlock value");
+  writing.SetSize(sizeof(writing_value));
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  // The value is read as the string it holds.
+  ImageAnnotationReader reader(&range);
+  std::vector<AnnotationSnapshot> annotations;
+  ASSERT_TRUE(
+      reader.AnnotationsList(FromPointerCast<VMAddress>(&list), &annotations));
+  ASSERT_EQ(annotations.size(), 1u);
+  EXPECT_EQ(annotations[0].name, "seqlock");
+  EXPECT_EQ(annotations[0].type, AsUnderlyingType(Annotation::Type::kString));
+  EXPECT_EQ(std::string(annotations[0].value.begin(),
+                        annotations[0].value.end()),
+            "seqlock value");
+
+  // Once the write is complete, the value is read.
+  writing_value.sequence = 4;
+  annotations.clear();
+  ASSERT_TRUE(
+      reader.AnnotationsList(FromPointerCast<VMAddress>(&list), &annotations));
+  ASSERT_EQ(annotations.size(), 2u);
+  EXPECT_EQ(annotations[0].name, "writing");
+  EXPECT_EQ(std::string(annotations[0].value.begin(),
+                        annotations[0].value.end()),
+            "torn");
+}
+
+TEST(ImageAnnotationReader, ReadChangedFromSelf) {
+  StringAnnotation<8> unchanged("unchanged");
+  StringAnnotation<8> changed("changed");
+  SeqlockStringAnnotation<8> seqlock("seqlock");
+
+  // Annotations record the generations of the list registered in
+  // CrashpadInfo, while this test reads them from its own list.
+  AnnotationList list;
+  list.Add(&unchanged);
+  list.Add(&changed);
+  list.Add(&seqlock);
+  unchanged.Set("old");
+  changed.Set("old");
+  seqlock.Set("old");
+  const uint32_t since_generation = AnnotationList::Register()->generation();
+  changed.Set("new");
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ImageAnnotationReader reader(&range);
+  std::vector<AnnotationSnapshot> annotations;
+  ASSERT_TRUE(
+      reader.AnnotationsList(FromPointerCast<VMAddress>(&list), &annotations));
+  EXPECT_EQ(annotations.size(), 3u);
+
+  // The seqlock annotation is kept, as its updates aren’t recorded.
+  annotations.clear();
+  ASSERT_TRUE(reader.ChangedAnnotationsList(
+      FromPointerCast<VMAddress>(&list), since_generation, &annotations));
+  ASSERT_EQ(annotations.size(), 2u);
+  EXPECT_EQ(annotations[0].name, "seqlock");
+  EXPECT_EQ(annotations[1].name, "changed");
+  EXPECT_EQ(std::string(annotations[1].value.begin(),
+                        annotations[1].value.end()),
+            "new");
+
+  annotations.clear();
+  ASSERT_TRUE(reader.ChangedAnnotationsList(
+      FromPointerCast<VMAddress>(&list),
+      AnnotationList::Register()->generation(),
+      &annotations));
+  ASSERT_EQ(annotations.size(), 1u);
+  EXPECT_EQ(annotations[0].name, "seqlock");
+}
+
 CRASHPAD_CHILD_TEST_MAIN(ReadAnnotationsFromChildTestMain) {
   SimpleStringDictionary map;
   std::vector<std::unique_ptr<Annotation>> storage;
@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_image_cache.h"
+
+#include <tuple>
+#include <utility>
+
+#include "base/check.h"
+
+namespace crashpad {
+
+ElfImageCache::Entry::Entry()
+    : soname(), crashpad_info_address(0), has_soname(false) {}
+
+ElfImageCache::Entry::~Entry() = default;
+
+bool ElfImageCache::Key::operator<(const Key& other) const {
+  return std::tie(build_id, load_bias, is_64_bit) <
+         std::tie(other.build_id, other.load_bias, other.is_64_bit);
+}
+
+ElfImageCache::ElfImageCache(size_t max_entries)
+    : lock_(), entries_(), max_entries_(max_entries) {}
+
+ElfImageCache::~ElfImageCache() = default;
+
+bool ElfImageCache::Lookup(const std::string& build_id,
+                           VMOffset load_bias,
+                           bool is_64_bit,
+                           Entry* entry) const {
+  DCHECK(!build_id.empty());
+  base::AutoLock lock(lock_);
+  auto iter = entries_.find(Key{build_id, load_bias, is_64_bit});
+  if (iter == entries_.end()) {
+    return false;
+  }
+  *entry = iter->second;
+  return true;
+}
+
+void ElfImageCache::Insert(const std::string& build_id,
+                           VMOffset load_bias,
+                           bool is_64_bit,
+                           const Entry& entry) {
+  DCHECK(!build_id.empty());
+  base::AutoLock lock(lock_);
+  Key key{build_id, load_bias, is_64_bit};
+  auto iter = entries_.find(key);
+  if (iter != entries_.end()) {
+    iter->second = entry;
+    return;
+  }
+  if (entries_.size() < max_entries_) {
+    entries_.emplace(std::move(key), entry);
+  }
+}
+
+size_t ElfImageCache::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,116 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_ELF_ELF_IMAGE_CACHE_H_
+#define CRASHPAD_SNAPSHOT_ELF_ELF_IMAGE_CACHE_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+
+namespace crashpad {
+
+//! \brief Retains information parsed from ELF images across snapshots.
+//!
+//! A handler serving many clients sees the same images, loaded at the same
+//! addresses, over and over. This cache records the parts of an
+//! ElfImageReader's work that are fixed by the image's contents and load bias
+//! so that later readers of an identical image can skip re-reading them from
+//! the target.
+//!
+//! Entries are keyed by build ID, load bias, and bitness. Images without a
+//! build ID are never cached. Values taken from writable memory, such as `DT_DEBUG`,
+//! must not be stored here.
+//!
+//! This class is thread-safe.
+class ElfImageCache {
+ public:
+  //! \brief The information cached for an image.
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    //! \brief The image's `DT_SONAME`, valid if #has_soname is `true`.
+    std::string soname;
+
+    //! \brief The address of the image's CrashpadInfo structure, or `0` if the
+    //!     image has no `CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO` note.
+    VMAddress crashpad_info_address;
+
+    //! \brief Whether the image has a `DT_SONAME`.
+    bool has_soname;
+  };
+
+  //! \brief The default value for \a max_entries in the constructor.
+  static constexpr size_t kDefaultMaxEntries = 1024;
+
+  //! \param[in] max_entries The maximum number of images to retain. Once full,
+  //!     new images are no longer added.
+  explicit ElfImageCache(size_t max_entries = kDefaultMaxEntries);
+
+  ElfImageCache(const ElfImageCache&) = delete;
+  ElfImageCache& operator=(const ElfImageCache&) = delete;
+
+  ~ElfImageCache();
+
+  //! \brief Looks up an image.
+  //!
+  //! \param[in] build_id The image's `NT_GNU_BUILD_ID` note descriptor. Must
+  //!     not be empty.
+  //! \param[in] load_bias The image's load bias.
+  //! \param[in] is_64_bit Whether the image is a 64-bit image.
+  //! \param[out] entry The cached information, valid if this method returns
+  //!     `true`.
+  //! \return `true` if the image was found in the cache.
+  bool Lookup(const std::string& build_id,
+              VMOffset load_bias,
+              bool is_64_bit,
+              Entry* entry) const;
+
+  //! \brief Adds an image to the cache, replacing any existing entry for it.
+  //!
+  //! \param[in] build_id The image's `NT_GNU_BUILD_ID` note descriptor. Must
+  //!     not be empty.
+  //! \param[in] load_bias The image's load bias.
+  //! \param[in] is_64_bit Whether the image is a 64-bit image.
+  //! \param[in] entry The information to cache.
+  void Insert(const std::string& build_id,
+              VMOffset load_bias,
+              bool is_64_bit,
+              const Entry& entry);
+
+  //! \brief Returns the number of images in the cache.
+  size_t size() const;
+
+ private:
+  struct Key {
+    bool operator<(const Key& other) const;
+
+    std::string build_id;
+    VMOffset load_bias;
+    bool is_64_bit;
+  };
+
+  mutable base::Lock lock_;
+  std::map<Key, Entry> entries_;
+  size_t max_entries_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_ELF_ELF_IMAGE_CACHE_H_
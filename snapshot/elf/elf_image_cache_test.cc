@@ -0,0 +1,75 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/elf/elf_image_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ElfImageCache, LookupAndInsert) {
+  ElfImageCache cache;
+  ElfImageCache::Entry entry;
+  EXPECT_FALSE(cache.Lookup("build_id", 0x1000, true, &entry));
+
+  ElfImageCache::Entry inserted;
+  inserted.soname = "libfoo.so";
+  inserted.has_soname = true;
+  inserted.crashpad_info_address = 0x2000;
+  cache.Insert("build_id", 0x1000, true, inserted);
+  EXPECT_EQ(cache.size(), 1u);
+
+  ASSERT_TRUE(cache.Lookup("build_id", 0x1000, true, &entry));
+  EXPECT_EQ(entry.soname, inserted.soname);
+  EXPECT_TRUE(entry.has_soname);
+  EXPECT_EQ(entry.crashpad_info_address, inserted.crashpad_info_address);
+
+  // Every part of the key must match.
+  EXPECT_FALSE(cache.Lookup("other_id", 0x1000, true, &entry));
+  EXPECT_FALSE(cache.Lookup("build_id", 0x2000, true, &entry));
+  EXPECT_FALSE(cache.Lookup("build_id", 0x1000, false, &entry));
+
+  // Inserting an existing key replaces its entry.
+  inserted.has_soname = false;
+  inserted.soname.clear();
+  cache.Insert("build_id", 0x1000, true, inserted);
+  EXPECT_EQ(cache.size(), 1u);
+  ASSERT_TRUE(cache.Lookup("build_id", 0x1000, true, &entry));
+  EXPECT_FALSE(entry.has_soname);
+}
+
+TEST(ElfImageCache, MaxEntries) {
+  ElfImageCache cache(2);
+  ElfImageCache::Entry entry;
+  cache.Insert("a", 0, true, entry);
+  cache.Insert("b", 0, true, entry);
+  cache.Insert("c", 0, true, entry);
+  EXPECT_EQ(cache.size(), 2u);
+
+  EXPECT_TRUE(cache.Lookup("a", 0, true, &entry));
+  EXPECT_TRUE(cache.Lookup("b", 0, true, &entry));
+  EXPECT_FALSE(cache.Lookup("c", 0, true, &entry));
+
+  // Existing entries may still be replaced once the cache is full.
+  entry.crashpad_info_address = 0x1234;
+  cache.Insert("a", 0, true, entry);
+  ASSERT_TRUE(cache.Lookup("a", 0, true, &entry));
+  EXPECT_EQ(entry.crashpad_info_address, 0x1234u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
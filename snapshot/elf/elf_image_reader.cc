@@ -15,6 +15,7 @@
 #include "snapshot/elf/elf_image_reader.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include <algorithm>
 #include <limits>
@@ -25,6 +26,7 @@
 #include "base/logging.h"
 #include "base/numerics/safe_math.h"
 #include "build/build_config.h"
+#include "util/misc/elf_note_types.h"
 #include "util/numeric/checked_vm_address_range.h"
 
 namespace crashpad {
@@ -192,6 +194,18 @@ class ElfImageReader::ProgramHeaderTableSpecific
   InitializationStateDcheck initialized_;
 };
 
+namespace {
+
+// The maximum size the user can specify for maximum note size. Clamping this
+// ensures that buffer allocations cannot be wildly large. It is not expected
+// that a note would be larger than ~1k in normal usage.
+constexpr size_t kMaxMaxNoteSize = 16384;
+
+// The largest note segment that NoteReader reads in a single operation.
+constexpr VMSize kMaxBufferedNoteSegmentSize = 64 * 1024;
+
+}  // namespace
+
 ElfImageReader::NoteReader::~NoteReader() = default;
 
 ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::NextNote(
@@ -213,12 +227,35 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::NextNote(
         return Result::kNoMoreNotes;
       }
       current_address_ += elf_reader_->GetLoadBias();
+      segment_address_ = current_address_;
       segment_end_address_ = current_address_ + segment_size;
       segment_range_ = std::make_unique<ProcessMemoryRange>();
       if (!segment_range_->Initialize(*range_) ||
           !segment_range_->RestrictRange(current_address_, segment_size)) {
         return Result::kError;
       }
+
+      // Note segments are small, so read each in its entirety rather than
+      // issuing several reads for every note in it. The ElfImageReader keeps
+      // what was read, so that later NoteReaders for the same image, such as
+      // those for the build ID and the CrashpadInfo note, don't read it again.
+      // If the read fails, fall back to reading notes individually so that
+      // those before an unreadable part of the segment can still be found.
+      segment_data_ = nullptr;
+      if (segment_size <= kMaxBufferedNoteSegmentSize) {
+        auto it = segment_cache_->find(current_address_);
+        if (it == segment_cache_->end()) {
+          it = segment_cache_->emplace(current_address_, std::string()).first;
+          it->second.resize(segment_size);
+          if (!segment_range_->Read(
+                  current_address_, segment_size, &it->second[0])) {
+            it->second.clear();
+          }
+        }
+        if (!it->second.empty() && it->second.size() == segment_size) {
+          segment_data_ = &it->second;
+        }
+      }
     }
 
     retry_ = false;
@@ -234,28 +271,24 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::NextNote(
   return Result::kError;
 }
 
-namespace {
-
-// The maximum size the user can specify for maximum note size. Clamping this
-// ensures that buffer allocations cannot be wildly large. It is not expected
-// that a note would be larger than ~1k in normal usage.
-constexpr size_t kMaxMaxNoteSize = 16384;
-
-}  // namespace
-
-ElfImageReader::NoteReader::NoteReader(const ElfImageReader* elf_reader,
-                                       const ProcessMemoryRange* range,
-                                       const ProgramHeaderTable* phdr_table,
-                                       size_t max_note_size,
-                                       const std::string& name_filter,
-                                       NoteType type_filter,
-                                       bool use_filter)
+ElfImageReader::NoteReader::NoteReader(
+    const ElfImageReader* elf_reader,
+    const ProcessMemoryRange* range,
+    const ProgramHeaderTable* phdr_table,
+    std::map<VMAddress, std::string>* segment_cache,
+    size_t max_note_size,
+    const std::string& name_filter,
+    NoteType type_filter,
+    bool use_filter)
     : current_address_(0),
+      segment_address_(0),
       segment_end_address_(0),
       elf_reader_(elf_reader),
       range_(range),
       phdr_table_(phdr_table),
       segment_range_(),
+      segment_cache_(segment_cache),
+      segment_data_(nullptr),
       phdr_index_(0),
       max_note_size_(std::min(kMaxMaxNoteSize, max_note_size)),
       name_filter_(name_filter),
@@ -277,7 +310,7 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
   DCHECK_LT(current_address_, segment_end_address_);
 
   NhdrType note_info;
-  if (!segment_range_->Read(current_address_, sizeof(note_info), &note_info)) {
+  if (!ReadFromSegment(current_address_, sizeof(note_info), &note_info)) {
     return Result::kError;
   }
   current_address_ += sizeof(note_info);
@@ -336,8 +369,7 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
   }
 
   std::string local_name(note_info.n_namesz, '\0');
-  if (!segment_range_->Read(
-          current_address_, note_info.n_namesz, &local_name[0])) {
+  if (!ReadFromSegment(current_address_, note_info.n_namesz, &local_name[0])) {
     return Result::kError;
   }
   if (!local_name.empty()) {
@@ -357,8 +389,7 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
   current_address_ += padded_namesz;
 
   std::string local_desc(note_info.n_descsz, '\0');
-  if (!segment_range_->Read(
-          current_address_, note_info.n_descsz, &local_desc[0])) {
+  if (!ReadFromSegment(current_address_, note_info.n_descsz, &local_desc[0])) {
     return Result::kError;
   }
   *desc_address = current_address_;
@@ -375,6 +406,23 @@ ElfImageReader::NoteReader::Result ElfImageReader::NoteReader::ReadNote(
   return Result::kSuccess;
 }
 
+bool ElfImageReader::NoteReader::ReadFromSegment(VMAddress address,
+                                                 size_t size,
+                                                 void* buffer) const {
+  if (!segment_data_) {
+    return segment_range_->Read(address, size, buffer);
+  }
+
+  if (address < segment_address_ ||
+      address - segment_address_ > segment_data_->size() ||
+      size > segment_data_->size() - (address - segment_address_)) {
+    LOG(ERROR) << "read out of range";
+    return false;
+  }
+  memcpy(buffer, &(*segment_data_)[address - segment_address_], size);
+  return true;
+}
+
 ElfImageReader::ElfImageReader()
     : header_64_(),
       ehdr_address_(0),
@@ -383,9 +431,15 @@ ElfImageReader::ElfImageReader()
       program_headers_(),
       dynamic_array_(),
       symbol_table_(),
+      note_segments_(),
+      build_id_(),
+      cache_entry_(),
+      cache_(nullptr),
       initialized_(),
       dynamic_array_initialized_(),
-      symbol_table_initialized_() {}
+      symbol_table_initialized_(),
+      build_id_initialized_(),
+      cache_entry_initialized_() {}
 
 ElfImageReader::~ElfImageReader() {}
 
@@ -514,16 +568,52 @@ uint16_t ElfImageReader::FileType() const {
 
 bool ElfImageReader::SoName(std::string* name) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  if (!InitializeDynamicArray()) {
-    return false;
+  const ElfImageCache::Entry* entry = GetCacheEntry();
+  if (entry) {
+    if (!entry->has_soname) {
+      return false;
+    }
+    *name = entry->soname;
+    return true;
   }
+  return ReadSoName(true, name);
+}
 
-  VMSize offset;
-  if (!dynamic_array_->GetValue(DT_SONAME, true, &offset)) {
+bool ElfImageReader::GetBuildID(std::string* build_id) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (build_id_initialized_.is_uninitialized()) {
+    build_id_initialized_.set_invalid();
+
+    std::unique_ptr<NoteReader> notes =
+        NotesWithNameAndType(ELF_NOTE_GNU, NT_GNU_BUILD_ID, 64);
+    VMAddress desc_addr;
+    if (notes->NextNote(nullptr, nullptr, &build_id_, &desc_addr) ==
+            NoteReader::Result::kSuccess &&
+        !build_id_.empty()) {
+      build_id_initialized_.set_valid();
+    } else {
+      build_id_.clear();
+    }
+  }
+
+  if (!build_id_initialized_.is_valid()) {
     return false;
   }
+  *build_id = build_id_;
+  return true;
+}
 
-  return ReadDynamicStringTableAtOffset(offset, name);
+bool ElfImageReader::GetCrashpadInfoAddress(VMAddress* address) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  const ElfImageCache::Entry* entry = GetCacheEntry();
+  if (entry) {
+    if (!entry->crashpad_info_address) {
+      return false;
+    }
+    *address = entry->crashpad_info_address;
+    return true;
+  }
+  return ReadCrashpadInfoAddress(address);
 }
 
 bool ElfImageReader::GetDynamicSymbol(const std::string& name,
@@ -662,6 +752,83 @@ bool ElfImageReader::InitializeProgramHeaders(bool verbose) {
   return true;
 }
 
+bool ElfImageReader::ReadSoName(bool log, std::string* name) {
+  if (!InitializeDynamicArray()) {
+    return false;
+  }
+
+  VMSize offset;
+  if (!dynamic_array_->GetValue(DT_SONAME, log, &offset)) {
+    return false;
+  }
+
+  return ReadDynamicStringTableAtOffset(offset, name);
+}
+
+bool ElfImageReader::ReadCrashpadInfoAddress(VMAddress* address) {
+  // The data payload is only sizeof(VMAddress) in the note, but add a bit to
+  // account for the name, header, and padding.
+  constexpr ssize_t kMaxNoteSize = 256;
+  std::unique_ptr<NoteReader> notes =
+      NotesWithNameAndType(CRASHPAD_ELF_NOTE_NAME,
+                           CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO,
+                           kMaxNoteSize);
+  std::string desc;
+  VMAddress desc_address;
+  if (notes->NextNote(nullptr, nullptr, &desc, &desc_address) !=
+      NoteReader::Result::kSuccess) {
+    return false;
+  }
+
+  VMOffset offset;
+  if (memory_.Is64Bit()) {
+    if (desc.size() < sizeof(VMOffset)) {
+      LOG(ERROR) << "crashpad info note too small";
+      return false;
+    }
+    offset = *reinterpret_cast<VMOffset*>(&desc[0]);
+  } else {
+    if (desc.size() < sizeof(int32_t)) {
+      LOG(ERROR) << "crashpad info note too small";
+      return false;
+    }
+    int32_t offset32 = *reinterpret_cast<int32_t*>(&desc[0]);
+    offset = offset32;
+  }
+  *address = desc_address + offset;
+  return true;
+}
+
+const ElfImageCache::Entry* ElfImageReader::GetCacheEntry() {
+  if (cache_entry_initialized_.is_valid()) {
+    return &cache_entry_;
+  }
+  if (!cache_ || !cache_entry_initialized_.is_uninitialized()) {
+    return nullptr;
+  }
+  cache_entry_initialized_.set_invalid();
+
+  std::string build_id;
+  if (!GetBuildID(&build_id)) {
+    return nullptr;
+  }
+
+  if (!cache_->Lookup(
+          build_id, GetLoadBias(), memory_.Is64Bit(), &cache_entry_)) {
+    // Neither value depends on data the loader or program writes at run time,
+    // such as DT_DEBUG, so both are the same for every process that maps this
+    // image at this load bias.
+    cache_entry_.has_soname = ReadSoName(false, &cache_entry_.soname);
+    if (!ReadCrashpadInfoAddress(&cache_entry_.crashpad_info_address)) {
+      cache_entry_.crashpad_info_address = 0;
+    }
+    cache_->Insert(build_id, GetLoadBias(), memory_.Is64Bit(), cache_entry_);
+  }
+
+  cache_entry_initialized_.set_valid();
+  return &cache_entry_;
+}
+
 bool ElfImageReader::InitializeDynamicArray() {
   if (dynamic_array_initialized_.is_valid()) {
     return true;
@@ -722,8 +889,21 @@ bool ElfImageReader::InitializeDynamicSymbolTable() {
     return false;
   }
 
-  symbol_table_.reset(new ElfSymbolTableReader(
-      &memory_, this, symbol_table_address, number_of_symbol_table_entries));
+  VMAddress gnu_hash_address;
+  if (!GetAddressFromDynamicArray(DT_GNU_HASH, false, &gnu_hash_address)) {
+    gnu_hash_address = 0;
+  }
+  VMAddress hash_address;
+  if (!GetAddressFromDynamicArray(DT_HASH, false, &hash_address)) {
+    hash_address = 0;
+  }
+
+  symbol_table_.reset(new ElfSymbolTableReader(&memory_,
+                                               this,
+                                               symbol_table_address,
+                                               number_of_symbol_table_entries,
+                                               gnu_hash_address,
+                                               hash_address));
   symbol_table_initialized_.set_valid();
   return true;
 }
@@ -843,16 +1023,25 @@ bool ElfImageReader::GetNumberOfSymbolEntriesFromDtGnuHash(
 
 std::unique_ptr<ElfImageReader::NoteReader> ElfImageReader::Notes(
     size_t max_note_size) {
-  return std::make_unique<NoteReader>(
-      this, &memory_, program_headers_.get(), max_note_size);
+  return std::make_unique<NoteReader>(this,
+                                      &memory_,
+                                      program_headers_.get(),
+                                      &note_segments_,
+                                      max_note_size);
 }
 
 std::unique_ptr<ElfImageReader::NoteReader>
 ElfImageReader::NotesWithNameAndType(const std::string& name,
                                      NoteReader::NoteType type,
                                      size_t max_note_size) {
-  return std::make_unique<NoteReader>(
-      this, &memory_, program_headers_.get(), max_note_size, name, type, true);
+  return std::make_unique<NoteReader>(this,
+                                      &memory_,
+                                      program_headers_.get(),
+                                      &note_segments_,
+                                      max_note_size,
+                                      name,
+                                      type,
+                                      true);
 }
 
 const ProcessMemoryRange* ElfImageReader::Memory() const {
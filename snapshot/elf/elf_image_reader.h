@@ -19,10 +19,12 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "snapshot/elf/elf_dynamic_array_reader.h"
+#include "snapshot/elf/elf_image_cache.h"
 #include "snapshot/elf/elf_symbol_table_reader.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state.h"
@@ -85,6 +87,7 @@ class ElfImageReader {
     NoteReader(const ElfImageReader* elf_reader_,
                const ProcessMemoryRange* range,
                const ProgramHeaderTable* phdr_table,
+               std::map<VMAddress, std::string>* segment_cache,
                size_t max_note_size,
                const std::string& name_filter = std::string(),
                NoteType type_filter = 0,
@@ -100,12 +103,19 @@ class ElfImageReader {
                     std::string* desc,
                     VMAddress* desc_addr);
 
+    // Reads from the current segment, using segment_data_ if the whole segment
+    // was read, by this or an earlier NoteReader.
+    bool ReadFromSegment(VMAddress address, size_t size, void* buffer) const;
+
     VMAddress current_address_;
+    VMAddress segment_address_;
     VMAddress segment_end_address_;
     const ElfImageReader* elf_reader_;  // weak
     const ProcessMemoryRange* range_;  // weak
     const ProgramHeaderTable* phdr_table_;  // weak
     std::unique_ptr<ProcessMemoryRange> segment_range_;
+    std::map<VMAddress, std::string>* segment_cache_;  // weak
+    const std::string* segment_data_;  // weak
     size_t phdr_index_;
     size_t max_note_size_;
     std::string name_filter_;
@@ -161,6 +171,20 @@ class ElfImageReader {
   //! The load bias is the actual load address minus the preferred load address.
   VMOffset GetLoadBias() const { return load_bias_; }
 
+  //! \brief Sets a cache to consult for information that depends only on this
+  //!     image's contents and load bias.
+  //!
+  //! When a cache is set, SoName() and GetCrashpadInfoAddress() are answered
+  //! from \a cache if it holds an entry for this image's build ID and load
+  //! bias. Otherwise, both are read from the image at once and added to
+  //! \a cache.
+  //!
+  //! This must be called after Initialize() and before SoName() or
+  //! GetCrashpadInfoAddress() to have any effect.
+  //!
+  //! \param[in] cache The cache to use, which must outlive this object.
+  void SetCache(ElfImageCache* cache) { cache_ = cache; }
+
   //! \brief Determines the name of this object using `DT_SONAME`, if present.
   //!
   //! \param[out] name The name of this object, only valid if this method
@@ -168,6 +192,23 @@ class ElfImageReader {
   //! \return `true` if a name was found for this object.
   bool SoName(std::string* name);
 
+  //! \brief Reads this image's `NT_GNU_BUILD_ID` note.
+  //!
+  //! The note is only read from the image once.
+  //!
+  //! \param[out] build_id The note descriptor, only valid if this method
+  //!     returns `true`.
+  //! \return `true` if the image has a non-empty build ID.
+  bool GetBuildID(std::string* build_id);
+
+  //! \brief Determines the address of the image's CrashpadInfo structure using
+  //!     its `CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO` note, if present.
+  //!
+  //! \param[out] address The address of the structure in the remote process'
+  //!     address space, only valid if this method returns `true`.
+  //! \return `true` if the image has a CrashpadInfo note.
+  bool GetCrashpadInfoAddress(VMAddress* address);
+
   //! \brief Reads information from the dynamic symbol table about the symbol
   //!     identified by \a name.
   //!
@@ -275,6 +316,12 @@ class ElfImageReader {
   bool InitializeDynamicArray();
   bool InitializeDynamicSymbolTable();
   bool GetAddressFromDynamicArray(uint64_t tag, bool log, VMAddress* address);
+  bool ReadSoName(bool log, std::string* name);
+  bool ReadCrashpadInfoAddress(VMAddress* address);
+
+  // Returns the cache_ entry for this image, adding one if necessary, or
+  // nullptr if cache_ is not set or the image has no build ID.
+  const ElfImageCache::Entry* GetCacheEntry();
 
   union {
     Elf32_Ehdr header_32_;
@@ -286,9 +333,19 @@ class ElfImageReader {
   std::unique_ptr<ProgramHeaderTable> program_headers_;
   std::unique_ptr<ElfDynamicArrayReader> dynamic_array_;
   std::unique_ptr<ElfSymbolTableReader> symbol_table_;
+
+  // The contents of note segments read by NoteReaders, keyed by address. A
+  // segment that couldn't be read is recorded as empty.
+  std::map<VMAddress, std::string> note_segments_;
+
+  std::string build_id_;
+  ElfImageCache::Entry cache_entry_;
+  ElfImageCache* cache_;  // weak
   InitializationStateDcheck initialized_;
   InitializationState dynamic_array_initialized_;
   InitializationState symbol_table_initialized_;
+  InitializationState build_id_initialized_;
+  InitializationState cache_entry_initialized_;
 };
 
 }  // namespace crashpad
@@ -18,6 +18,9 @@
 #include <link.h>
 #include <unistd.h>
 
+#include <string>
+#include <vector>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
@@ -154,13 +157,26 @@ void ReadThisExecutableInTarget(ProcessType process,
   ElfImageReader::NoteReader::NoteType note_type;
   VMAddress desc_addr;
 
+  std::vector<std::string> note_descs;
   std::unique_ptr<ElfImageReader::NoteReader> notes = reader.Notes(10000);
   while ((result = notes->NextNote(
               &note_name, &note_type, &note_desc, &desc_addr)) ==
          ElfImageReader::NoteReader::Result::kSuccess) {
+    note_descs.push_back(note_desc);
   }
   EXPECT_EQ(result, ElfImageReader::NoteReader::Result::kNoMoreNotes);
 
+  // A later NoteReader uses the segments kept from the first, and finds the
+  // same notes.
+  notes = reader.Notes(10000);
+  for (const std::string& expected_desc : note_descs) {
+    ASSERT_EQ(notes->NextNote(&note_name, &note_type, &note_desc, &desc_addr),
+              ElfImageReader::NoteReader::Result::kSuccess);
+    EXPECT_EQ(note_desc, expected_desc);
+  }
+  EXPECT_EQ(notes->NextNote(&note_name, &note_type, &note_desc, &desc_addr),
+            ElfImageReader::NoteReader::Result::kNoMoreNotes);
+
   notes = reader.Notes(0);
   EXPECT_EQ(notes->NextNote(&note_name, &note_type, &note_desc, &desc_addr),
             ElfImageReader::NoteReader::Result::kNoMoreNotes);
@@ -300,6 +316,110 @@ TEST(ElfImageReader, OneModuleChild) {
   test.Run();
 }
 
+TEST(ElfImageReader, HashedSymbolLookupSelf) {
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+  Dl_info info;
+  ASSERT_TRUE(dladdr(reinterpret_cast<void*>(getpid), &info)) << "dladdr:"
+                                                              << dlerror();
+  VMAddress elf_address = FromPointerCast<VMAddress>(info.dli_fbase);
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ElfImageReader reader;
+  ASSERT_TRUE(reader.Initialize(range, elf_address));
+
+  // Look up several symbols so that more than one hash bucket and chain is
+  // exercised.
+  ExpectSymbol(&reader, "getpid", FromPointerCast<VMAddress>(getpid));
+  ExpectSymbol(&reader, "getppid", FromPointerCast<VMAddress>(getppid));
+  ExpectSymbol(&reader, "getuid", FromPointerCast<VMAddress>(getuid));
+  ExpectSymbol(&reader, "close", FromPointerCast<VMAddress>(close));
+  ExpectSymbol(&reader, "dup", FromPointerCast<VMAddress>(dup));
+}
+
+TEST(ElfImageReader, CacheSelf) {
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool am_64_bit = true;
+#else
+  constexpr bool am_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+  Dl_info info;
+  ASSERT_TRUE(dladdr(reinterpret_cast<void*>(getpid), &info)) << "dladdr:"
+                                                              << dlerror();
+  VMAddress elf_address = FromPointerCast<VMAddress>(info.dli_fbase);
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, am_64_bit));
+
+  ElfImageReader uncached;
+  ASSERT_TRUE(uncached.Initialize(range, elf_address));
+  std::string build_id;
+  if (!uncached.GetBuildID(&build_id)) {
+    // Images without a build ID are never cached.
+    GTEST_SKIP();
+  }
+  std::string expected_soname;
+  bool expected_has_soname = uncached.SoName(&expected_soname);
+  VMAddress expected_info_address = 0;
+  bool expected_has_info =
+      uncached.GetCrashpadInfoAddress(&expected_info_address);
+
+  ElfImageCache cache;
+  for (size_t index = 0; index < 2; ++index) {
+    SCOPED_TRACE(index);
+
+    ElfImageReader reader;
+    ASSERT_TRUE(reader.Initialize(range, elf_address));
+    reader.SetCache(&cache);
+
+    std::string soname;
+    ASSERT_EQ(reader.SoName(&soname), expected_has_soname);
+    if (expected_has_soname) {
+      EXPECT_EQ(soname, expected_soname);
+    }
+
+    VMAddress info_address;
+    ASSERT_EQ(reader.GetCrashpadInfoAddress(&info_address), expected_has_info);
+    if (expected_has_info) {
+      EXPECT_EQ(info_address, expected_info_address);
+    }
+
+    EXPECT_EQ(cache.size(), 1u);
+  }
+
+  ElfImageCache::Entry entry;
+  ASSERT_TRUE(
+      cache.Lookup(build_id, uncached.GetLoadBias(), am_64_bit, &entry));
+  EXPECT_EQ(entry.has_soname, expected_has_soname);
+  EXPECT_EQ(entry.crashpad_info_address,
+            expected_has_info ? expected_info_address : 0);
+}
+
 #if BUILDFLAG(IS_FUCHSIA)
 
 // crashpad_snapshot_test_both_dt_hash_styles is specially built and forced to
@@ -16,6 +16,9 @@
 
 #include <elf.h>
 
+#include <type_traits>
+
+#include "base/logging.h"
 #include "snapshot/elf/elf_image_reader.h"
 
 namespace crashpad {
@@ -46,23 +49,229 @@ uint8_t GetVisibility(const Elf64_Sym& sym) {
   return ELF64_ST_VISIBILITY(sym.st_other);
 }
 
+uint32_t GnuHash(const std::string& name) {
+  uint32_t hash = 5381;
+  for (unsigned char c : name) {
+    hash = hash * 33 + c;
+  }
+  return hash;
+}
+
+uint32_t SysVHash(const std::string& name) {
+  uint32_t hash = 0;
+  for (unsigned char c : name) {
+    hash = (hash << 4) + c;
+    uint32_t high = hash & 0xf0000000;
+    if (high) {
+      hash ^= high >> 24;
+    }
+    hash &= ~high;
+  }
+  return hash;
+}
+
 }  // namespace
 
 ElfSymbolTableReader::ElfSymbolTableReader(const ProcessMemoryRange* memory,
                                            ElfImageReader* elf_reader,
                                            VMAddress address,
-                                           VMSize num_entries)
+                                           VMSize num_entries,
+                                           VMAddress gnu_hash_address,
+                                           VMAddress hash_address)
     : memory_(memory),
       elf_reader_(elf_reader),
       base_address_(address),
-      num_entries_(num_entries) {}
+      num_entries_(num_entries),
+      gnu_hash_address_(gnu_hash_address),
+      hash_address_(hash_address) {}
 
 ElfSymbolTableReader::~ElfSymbolTableReader() {}
 
 bool ElfSymbolTableReader::GetSymbol(const std::string& name,
                                      SymbolInformation* info) {
-  return memory_->Is64Bit() ? ScanSymbolTable<Elf64_Sym>(name, info)
-                            : ScanSymbolTable<Elf32_Sym>(name, info);
+  return memory_->Is64Bit() ? GetSymbolInternal<Elf64_Sym>(name, info)
+                            : GetSymbolInternal<Elf32_Sym>(name, info);
+}
+
+template <typename SymEnt>
+bool ElfSymbolTableReader::GetSymbolInternal(const std::string& name,
+                                             SymbolInformation* info) {
+  using BloomWord = std::conditional_t<std::is_same_v<SymEnt, Elf64_Sym>,
+                                       uint64_t,
+                                       uint32_t>;
+  LookupResult result = LookupResult::kError;
+  if (gnu_hash_address_) {
+    result = LookupGnuHash<SymEnt, BloomWord>(name, info);
+  }
+  if (result == LookupResult::kError && hash_address_) {
+    result = LookupHash<SymEnt>(name, info);
+  }
+  if (result != LookupResult::kError) {
+    return result == LookupResult::kFound;
+  }
+  return ScanSymbolTable<SymEnt>(name, info);
+}
+
+template <typename SymEnt>
+bool ElfSymbolTableReader::MatchSymbol(size_t index,
+                                       const std::string& name,
+                                       SymbolInformation* info_out) {
+  if (index >= num_entries_) {
+    return false;
+  }
+
+  SymEnt entry;
+  std::string string;
+  if (!memory_->Read(
+          base_address_ + index * sizeof(entry), sizeof(entry), &entry) ||
+      !elf_reader_->ReadDynamicStringTableAtOffset(entry.st_name, &string) ||
+      string != name) {
+    return false;
+  }
+
+  info_out->address = entry.st_value;
+  info_out->size = entry.st_size;
+  info_out->shndx = entry.st_shndx;
+  info_out->binding = GetBinding(entry);
+  info_out->type = GetType(entry);
+  info_out->visibility = GetVisibility(entry);
+  return true;
+}
+
+template <typename SymEnt, typename BloomWord>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::LookupGnuHash(
+    const std::string& name,
+    SymbolInformation* info) {
+  // See https://flapenguin.me/2017/05/10/elf-lookup-dt-gnu-hash/ and
+  // https://sourceware.org/ml/binutils/2006-10/msg00377.html.
+  struct {
+    uint32_t nbuckets;
+    uint32_t symoffset;
+    uint32_t bloom_size;
+    uint32_t bloom_shift;
+  } header;
+  if (!memory_->Read(gnu_hash_address_, sizeof(header), &header)) {
+    LOG(ERROR) << "failed to read DT_GNU_HASH header";
+    return LookupResult::kError;
+  }
+  if (header.nbuckets == 0 || header.bloom_size == 0) {
+    LOG(ERROR) << "invalid DT_GNU_HASH header";
+    return LookupResult::kError;
+  }
+
+  const uint32_t hash = GnuHash(name);
+
+  // The bloom filter rejects most names not in the table with a single read.
+  constexpr uint32_t kBloomWordBits = sizeof(BloomWord) * 8;
+  const VMAddress bloom_address = gnu_hash_address_ + sizeof(header);
+  BloomWord bloom_word;
+  const uint32_t bloom_index = (hash / kBloomWordBits) % header.bloom_size;
+  if (!memory_->Read(bloom_address + bloom_index * sizeof(bloom_word),
+                     sizeof(bloom_word),
+                     &bloom_word)) {
+    LOG(ERROR) << "read bloom filter";
+    return LookupResult::kError;
+  }
+  const BloomWord bloom_mask =
+      (BloomWord{1} << (hash % kBloomWordBits)) |
+      (BloomWord{1} << ((hash >> header.bloom_shift) % kBloomWordBits));
+  if ((bloom_word & bloom_mask) != bloom_mask) {
+    return LookupResult::kNotFound;
+  }
+
+  const VMAddress buckets_address =
+      bloom_address + VMAddress{header.bloom_size} * sizeof(bloom_word);
+  uint32_t symbol_index;
+  if (!memory_->Read(buckets_address + (hash % header.nbuckets) *
+                                           sizeof(symbol_index),
+                     sizeof(symbol_index),
+                     &symbol_index)) {
+    LOG(ERROR) << "read bucket";
+    return LookupResult::kError;
+  }
+  if (symbol_index < header.symoffset) {
+    return LookupResult::kNotFound;
+  }
+
+  // Each chain entry holds the hash of the corresponding symbol, with the low
+  // bit replaced by a flag marking the end of the chain.
+  const VMAddress chains_address =
+      buckets_address + VMAddress{header.nbuckets} * sizeof(uint32_t);
+  for (; symbol_index < num_entries_; ++symbol_index) {
+    uint32_t chain_entry;
+    if (!memory_->Read(
+            chains_address +
+                (symbol_index - header.symoffset) * sizeof(chain_entry),
+            sizeof(chain_entry),
+            &chain_entry)) {
+      LOG(ERROR) << "read chain entry";
+      return LookupResult::kError;
+    }
+    if ((chain_entry | 1) == (hash | 1) &&
+        MatchSymbol<SymEnt>(symbol_index, name, info)) {
+      return LookupResult::kFound;
+    }
+    if (chain_entry & 1) {
+      return LookupResult::kNotFound;
+    }
+  }
+
+  LOG(ERROR) << "DT_GNU_HASH chain out of bounds";
+  return LookupResult::kError;
+}
+
+template <typename SymEnt>
+ElfSymbolTableReader::LookupResult ElfSymbolTableReader::LookupHash(
+    const std::string& name,
+    SymbolInformation* info) {
+  struct {
+    uint32_t nbucket;
+    uint32_t nchain;
+  } header;
+  if (!memory_->Read(hash_address_, sizeof(header), &header)) {
+    LOG(ERROR) << "failed to read DT_HASH header";
+    return LookupResult::kError;
+  }
+  if (header.nbucket == 0) {
+    LOG(ERROR) << "invalid DT_HASH header";
+    return LookupResult::kError;
+  }
+
+  const VMAddress buckets_address = hash_address_ + sizeof(header);
+  const VMAddress chains_address =
+      buckets_address + VMAddress{header.nbucket} * sizeof(uint32_t);
+  uint32_t symbol_index;
+  if (!memory_->Read(buckets_address + (SysVHash(name) % header.nbucket) *
+                                           sizeof(symbol_index),
+                     sizeof(symbol_index),
+                     &symbol_index)) {
+    LOG(ERROR) << "read bucket";
+    return LookupResult::kError;
+  }
+
+  // A well-formed chain visits each symbol at most once, so a longer walk
+  // indicates a cycle.
+  for (uint32_t steps = 0; steps < header.nchain; ++steps) {
+    if (symbol_index == STN_UNDEF) {
+      return LookupResult::kNotFound;
+    }
+    if (symbol_index >= header.nchain) {
+      LOG(ERROR) << "DT_HASH chain out of bounds";
+      return LookupResult::kError;
+    }
+    if (MatchSymbol<SymEnt>(symbol_index, name, info)) {
+      return LookupResult::kFound;
+    }
+    if (!memory_->Read(chains_address + symbol_index * sizeof(symbol_index),
+                       sizeof(symbol_index),
+                       &symbol_index)) {
+      LOG(ERROR) << "read chain entry";
+      return LookupResult::kError;
+    }
+  }
+
+  LOG(ERROR) << "DT_HASH chain too long";
+  return LookupResult::kError;
 }
 
 template <typename SymEnt>
@@ -56,12 +56,23 @@ class ElfSymbolTableReader {
     uint8_t visibility;
   };
 
-  // TODO(jperaza): Support using .hash and .gnu.hash sections to improve symbol
-  // lookup.
+  //! \brief Constructs the reader.
+  //!
+  //! \param[in] memory A memory reader for the remote process.
+  //! \param[in] elf_reader The image containing the symbol table, used to read
+  //!     symbol names from its dynamic string table.
+  //! \param[in] address The address of the symbol table, `DT_SYMTAB`.
+  //! \param[in] num_entries The number of entries in the symbol table.
+  //! \param[in] gnu_hash_address The address of the image's `DT_GNU_HASH`
+  //!     table, or `0` if it has none.
+  //! \param[in] hash_address The address of the image's `DT_HASH` table, or
+  //!     `0` if it has none.
   ElfSymbolTableReader(const ProcessMemoryRange* memory,
                        ElfImageReader* elf_reader,
                        VMAddress address,
-                       VMSize num_entries);
+                       VMSize num_entries,
+                       VMAddress gnu_hash_address = 0,
+                       VMAddress hash_address = 0);
 
   ElfSymbolTableReader(const ElfSymbolTableReader&) = delete;
   ElfSymbolTableReader& operator=(const ElfSymbolTableReader&) = delete;
@@ -70,12 +81,43 @@ class ElfSymbolTableReader {
 
   //! \brief Lookup information about a symbol.
   //!
+  //! The image's `DT_GNU_HASH` table is used to find the symbol if present,
+  //! followed by its `DT_HASH` table. The symbol table is only scanned in full
+  //! if the image has neither or they can't be read. Because `DT_GNU_HASH`
+  //! only indexes defined symbols, undefined symbols may not be found in
+  //! images that have one.
+  //!
   //! \param[in] name The name of the symbol to search for.
   //! \param[out] info The symbol information, if found.
   //! \return `true` if the symbol is found.
   bool GetSymbol(const std::string& name, SymbolInformation* info);
 
  private:
+  // The result of a hash table lookup.
+  enum class LookupResult {
+    kFound,
+    kNotFound,
+
+    // The hash table couldn't be used, so the symbol table must be scanned.
+    kError,
+  };
+
+  template <typename SymEnt>
+  bool GetSymbolInternal(const std::string& name, SymbolInformation* info);
+
+  // Reads the symbol table entry at index and sets info if its name is name.
+  // Returns false if the entry couldn't be read or doesn't match.
+  template <typename SymEnt>
+  bool MatchSymbol(size_t index,
+                   const std::string& name,
+                   SymbolInformation* info);
+
+  template <typename SymEnt, typename BloomWord>
+  LookupResult LookupGnuHash(const std::string& name, SymbolInformation* info);
+
+  template <typename SymEnt>
+  LookupResult LookupHash(const std::string& name, SymbolInformation* info);
+
   template <typename SymEnt>
   bool ScanSymbolTable(const std::string& name, SymbolInformation* info);
 
@@ -83,6 +125,8 @@ class ElfSymbolTableReader {
   ElfImageReader* const elf_reader_;  // weak
   const VMAddress base_address_;
   const VMSize num_entries_;
+  const VMAddress gnu_hash_address_;
+  const VMAddress hash_address_;
 };
 
 }  // namespace crashpad
@@ -21,7 +21,6 @@
 #include "base/files/file_path.h"
 #include "snapshot/crashpad_types/image_annotation_reader.h"
 #include "snapshot/memory_snapshot_generic.h"
-#include "util/misc/elf_note_types.h"
 
 namespace crashpad {
 namespace internal {
@@ -38,6 +37,10 @@ ModuleSnapshotElf::ModuleSnapshotElf(const std::string& name,
       process_memory_(process_memory),
       crashpad_info_(),
       type_(type),
+      annotations_disabled_(false),
+      changed_annotations_only_(false),
+      changed_annotation_list_address_(0),
+      changed_since_generation_(0),
       initialized_(),
       streams_() {}
 
@@ -51,27 +54,8 @@ bool ModuleSnapshotElf::Initialize() {
     return false;
   }
 
-  // The data payload is only sizeof(VMAddress) in the note, but add a bit to
-  // account for the name, header, and padding.
-  constexpr ssize_t kMaxNoteSize = 256;
-  std::unique_ptr<ElfImageReader::NoteReader> notes =
-      elf_reader_->NotesWithNameAndType(CRASHPAD_ELF_NOTE_NAME,
-                                        CRASHPAD_ELF_NOTE_TYPE_CRASHPAD_INFO,
-                                        kMaxNoteSize);
-  std::string desc;
   VMAddress info_address;
-  VMAddress desc_address;
-  if (notes->NextNote(nullptr, nullptr, &desc, &desc_address) ==
-      ElfImageReader::NoteReader::Result::kSuccess) {
-    VMOffset offset;
-    if (elf_reader_->Memory()->Is64Bit()) {
-      offset = *reinterpret_cast<VMOffset*>(&desc[0]);
-    } else {
-      int32_t offset32 = *reinterpret_cast<int32_t*>(&desc[0]);
-      offset = offset32;
-    }
-    info_address = desc_address + offset;
-
+  if (elf_reader_->GetCrashpadInfoAddress(&info_address)) {
     ProcessMemoryRange range;
     if (range.Initialize(*elf_reader_->Memory())) {
       auto info = std::make_unique<CrashpadInfoReader>();
@@ -85,6 +69,18 @@ bool ModuleSnapshotElf::Initialize() {
   return true;
 }
 
+bool ModuleSnapshotElf::InitializeIdentity() {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!elf_reader_) {
+    LOG(ERROR) << "no elf reader";
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
 bool ModuleSnapshotElf::GetCrashpadOptions(CrashpadInfoClientOptions* options) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
@@ -175,11 +171,8 @@ std::string ModuleSnapshotElf::DebugFileName() const {
 std::vector<uint8_t> ModuleSnapshotElf::BuildID() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  std::unique_ptr<ElfImageReader::NoteReader> notes =
-      elf_reader_->NotesWithNameAndType(ELF_NOTE_GNU, NT_GNU_BUILD_ID, 64);
   std::string desc;
-  VMAddress desc_addr;
-  notes->NextNote(nullptr, nullptr, &desc, &desc_addr);
+  elf_reader_->GetBuildID(&desc);
 
   std::vector<uint8_t> build_id;
   build_id.reserve(desc.size());
@@ -196,7 +189,8 @@ std::map<std::string, std::string> ModuleSnapshotElf::AnnotationsSimpleMap()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   std::map<std::string, std::string> annotations;
-  if (crashpad_info_ && crashpad_info_->SimpleAnnotations()) {
+  if (!annotations_disabled_ && !changed_annotations_only_ && crashpad_info_ &&
+      crashpad_info_->SimpleAnnotations()) {
     ImageAnnotationReader reader(process_memory_range_);
     reader.SimpleMap(crashpad_info_->SimpleAnnotations(), &annotations);
   }
@@ -206,16 +200,36 @@ std::map<std::string, std::string> ModuleSnapshotElf::AnnotationsSimpleMap()
 std::vector<AnnotationSnapshot> ModuleSnapshotElf::AnnotationObjects() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   std::vector<AnnotationSnapshot> annotations;
-  if (crashpad_info_ && crashpad_info_->AnnotationsList()) {
-    ImageAnnotationReader reader(process_memory_range_);
+  if (annotations_disabled_ || !crashpad_info_) {
+    return annotations;
+  }
+
+  ImageAnnotationReader reader(process_memory_range_);
+  if (changed_annotations_only_) {
+    if (crashpad_info_->AnnotationsList() &&
+        crashpad_info_->AnnotationsList() == changed_annotation_list_address_) {
+      reader.ChangedAnnotationsList(crashpad_info_->AnnotationsList(),
+                                    changed_since_generation_,
+                                    &annotations);
+    }
+    return annotations;
+  }
+  if (crashpad_info_->AnnotationsList()) {
     reader.AnnotationsList(crashpad_info_->AnnotationsList(), &annotations);
   }
+  if (crashpad_info_->AnnotationArena()) {
+    reader.AnnotationArena(crashpad_info_->AnnotationArena(), &annotations);
+  }
   return annotations;
 }
 
 std::set<CheckedRange<uint64_t>> ModuleSnapshotElf::ExtraMemoryRanges() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return std::set<CheckedRange<uint64_t>>();
+  std::set<CheckedRange<uint64_t>> ranges;
+  if (crashpad_info_) {
+    crashpad_info_->ReadExtraMemoryRanges(process_memory_, name_, &ranges);
+  }
+  return ranges;
 }
 
 std::vector<const UserMinidumpStream*>
@@ -224,7 +238,7 @@ ModuleSnapshotElf::CustomMinidumpStreams() const {
   streams_.clear();
 
   std::vector<const UserMinidumpStream*> result;
-  if (!crashpad_info_)
+  if (!crashpad_info_ || changed_annotations_only_)
     return result;
 
   for (uint64_t cur = crashpad_info_->UserDataMinidumpStreamHead(); cur;) {
@@ -61,12 +61,46 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   //!     an appropriate message logged.
   bool Initialize();
 
+  //! \brief Initializes the object with only the module’s identity.
+  //!
+  //! This is an alternative to Initialize() for when only the module list is
+  //! needed. The module’s name, address, size, type, and build ID are reported
+  //! as usual, but its CrashpadInfo structure isn’t located, so it reports no
+  //! options, annotations, extra memory ranges, or minidump streams.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeIdentity();
+
   //! \brief Returns options from the module’s CrashpadInfo structure.
   //!
   //! \param[out] options Options set in the module’s CrashpadInfo structure.
   //! \return `true` if there were options returned. Otherwise `false`.
   bool GetCrashpadOptions(CrashpadInfoClientOptions* options);
 
+  //! \brief Causes the module's annotations to be reported as empty instead of
+  //!     being read from the target process.
+  void DisableAnnotations() { annotations_disabled_ = true; }
+
+  //! \brief Causes the module to report only the annotation objects in its
+  //!     AnnotationList that have been set since \a since_generation, and only
+  //!     if that list is the one at \a annotation_list_address.
+  //!
+  //! The module’s simple annotations, the annotations in its AnnotationArena,
+  //! and the minidump streams it registers are reported as empty. See
+  //! ImageAnnotationReader::ChangedAnnotationsList().
+  //!
+  //! \param[in] annotation_list_address The address of the AnnotationList whose
+  //!     generations \a since_generation refers to.
+  //! \param[in] since_generation A value returned by
+  //!     AnnotationList::generation().
+  void SetChangedAnnotationsOnly(VMAddress annotation_list_address,
+                                 uint32_t since_generation) {
+    changed_annotations_only_ = true;
+    changed_annotation_list_address_ = annotation_list_address;
+    changed_since_generation_ = since_generation;
+  }
+
   // ModuleSnapshot:
 
   std::string Name() const override;
@@ -98,6 +132,10 @@ class ModuleSnapshotElf final : public ModuleSnapshot {
   const ProcessMemory* process_memory_;
   std::unique_ptr<CrashpadInfoReader> crashpad_info_;
   ModuleType type_;
+  bool annotations_disabled_;
+  bool changed_annotations_only_;
+  VMAddress changed_annotation_list_address_;
+  uint32_t changed_since_generation_;
   InitializationStateDcheck initialized_;
   // Too const-y: https://crashpad.chromium.org/bug/9.
   mutable std::vector<std::unique_ptr<const UserMinidumpStream>> streams_;
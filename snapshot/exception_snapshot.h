@@ -24,6 +24,7 @@
 namespace crashpad {
 
 struct CPUContext;
+class ExtendedRegisterState;
 
 //! \brief An abstract interface to a snapshot representing an exception that a
 //!     snapshot process sustained and triggered the snapshot being taken.
@@ -114,6 +115,17 @@ class ExceptionSnapshot {
   //!     are scoped to the lifetime of the ThreadSnapshot object that they
   //!     were obtained from.
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const = 0;
+
+  //! \brief Returns the register state beyond what Context() holds, such as
+  //!     AVX or SVE registers, at the time of the exception, or `nullptr` if
+  //!     none was captured.
+  //!
+  //! Components of the state that were in their initial state are omitted, so
+  //! the returned object may be empty.
+  //!
+  //! The caller does not take ownership of this object, it is scoped to the
+  //! lifetime of the ExceptionSnapshot object that it was obtained from.
+  virtual const ExtendedRegisterState* ExtendedRegisters() const = 0;
 };
 
 }  // namespace crashpad
@@ -148,5 +148,11 @@ std::vector<const MemorySnapshot*> ExceptionSnapshotFuchsia::ExtraMemory()
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState*
+ExceptionSnapshotFuchsia::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
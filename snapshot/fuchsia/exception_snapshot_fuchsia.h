@@ -63,6 +63,7 @@ class ExceptionSnapshotFuchsia final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
 
  private:
 #if defined(ARCH_CPU_X86_64)
@@ -22,6 +22,7 @@
 #include "base/fuchsia/fuchsia_logging.h"
 #include "base/logging.h"
 #include "util/fuchsia/koid_utilities.h"
+#include "util/thread/run_concurrently.h"
 
 namespace crashpad {
 
@@ -121,6 +122,7 @@ bool ProcessReaderFuchsia::Initialize(const zx::process& process) {
 
   process_memory_.reset(new ProcessMemoryFuchsia());
   process_memory_->Initialize(*process_);
+  memory_.Initialize(process_memory_.get());
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -182,8 +184,7 @@ void ProcessReaderFuchsia::InitializeModules() {
 
   constexpr auto k_r_debug_map_offset = offsetof(r_debug, r_map);
   uintptr_t map;
-  if (!process_memory_->Read(
-          debug_address + k_r_debug_map_offset, sizeof(map), &map)) {
+  if (!memory_.Read(debug_address + k_r_debug_map_offset, sizeof(map), &map)) {
     LOG(ERROR) << "read link_map";
     return;
   }
@@ -198,8 +199,7 @@ void ProcessReaderFuchsia::InitializeModules() {
 
     constexpr auto k_link_map_addr_offset = offsetof(link_map, l_addr);
     zx_vaddr_t base;
-    if (!process_memory_->Read(
-            map + k_link_map_addr_offset, sizeof(base), &base)) {
+    if (!memory_.Read(map + k_link_map_addr_offset, sizeof(base), &base)) {
       LOG(ERROR) << "Read base";
       // Could theoretically continue here, but realistically if any part of
       // link_map fails to read, things are looking bad, so just abort.
@@ -208,23 +208,22 @@ void ProcessReaderFuchsia::InitializeModules() {
 
     constexpr auto k_link_map_next_offset = offsetof(link_map, l_next);
     zx_vaddr_t next;
-    if (!process_memory_->Read(
-            map + k_link_map_next_offset, sizeof(next), &next)) {
+    if (!memory_.Read(map + k_link_map_next_offset, sizeof(next), &next)) {
       LOG(ERROR) << "Read next";
       break;
     }
 
     constexpr auto k_link_map_name_offset = offsetof(link_map, l_name);
     zx_vaddr_t name_address;
-    if (!process_memory_->Read(map + k_link_map_name_offset,
-                               sizeof(name_address),
-                               &name_address)) {
+    if (!memory_.Read(map + k_link_map_name_offset,
+                      sizeof(name_address),
+                      &name_address)) {
       LOG(ERROR) << "Read name address";
       break;
     }
 
     std::string dsoname;
-    if (!process_memory_->ReadCString(name_address, &dsoname)) {
+    if (!memory_.ReadCString(name_address, &dsoname)) {
       // In this case, it could be reasonable to continue on to the next module
       // as this data isn't strictly in the link_map.
       LOG(ERROR) << "ReadCString name";
@@ -279,7 +278,7 @@ void ProcessReaderFuchsia::InitializeModules() {
     std::unique_ptr<ProcessMemoryRange> process_memory_range(
         new ProcessMemoryRange());
     // TODO(scottmg): Could this be limited range?
-    if (process_memory_range->Initialize(process_memory_.get(), true)) {
+    if (process_memory_range->Initialize(&memory_, true)) {
       process_memory_ranges_.push_back(std::move(process_memory_range));
 
       if (reader->Initialize(*process_memory_ranges_.back(), base)) {
@@ -305,73 +304,86 @@ void ProcessReaderFuchsia::InitializeThreads() {
       GetHandlesForThreadKoids(*process_, thread_koids);
   DCHECK_EQ(thread_koids.size(), thread_handles.size());
 
-  for (size_t i = 0; i < thread_handles.size(); ++i) {
-    Thread thread;
-    thread.id = thread_koids[i];
-
-    if (thread_handles[i].is_valid()) {
-      char name[ZX_MAX_NAME_LEN] = {0};
-      zx_status_t status =
-          thread_handles[i].get_property(ZX_PROP_NAME, &name, sizeof(name));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status) << "zx_object_get_property ZX_PROP_NAME";
-      } else {
-        thread.name.assign(name);
-      }
+  // The memory map is initialized lazily, so retrieve it before threads are
+  // examined concurrently. It may be null when operating on the current
+  // process, where the memory map can't be retrieved.
+  const MemoryMapFuchsia* memory_map = MemoryMap();
+
+  // Results are written in place, so the order of threads is unaffected.
+  std::vector<Thread> threads(thread_handles.size());
+  RunConcurrently(
+      thread_handles.size(),
+      thread_initialization_concurrency_,
+      [&threads, &thread_koids, &thread_handles, memory_map](size_t i) {
+        Thread& thread = threads[i];
+        thread.id = thread_koids[i];
+
+        if (!thread_handles[i].is_valid()) {
+          return;
+        }
 
-      zx_info_thread_t thread_info;
-      status = thread_handles[i].get_info(
-          ZX_INFO_THREAD, &thread_info, sizeof(thread_info), nullptr, nullptr);
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status) << "zx_object_get_info ZX_INFO_THREAD";
-      } else {
-        thread.state = thread_info.state;
-      }
+        char name[ZX_MAX_NAME_LEN] = {0};
+        zx_status_t status =
+            thread_handles[i].get_property(ZX_PROP_NAME, &name, sizeof(name));
+        if (status != ZX_OK) {
+          ZX_LOG(WARNING, status) << "zx_object_get_property ZX_PROP_NAME";
+        } else {
+          thread.name.assign(name);
+        }
 
-      zx_thread_state_general_regs_t general_regs;
-      status = thread_handles[i].read_state(
-          ZX_THREAD_STATE_GENERAL_REGS, &general_regs, sizeof(general_regs));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status)
-            << "zx_thread_read_state(ZX_THREAD_STATE_GENERAL_REGS)";
-      } else {
-        thread.general_registers = general_regs;
-
-        const MemoryMapFuchsia* memory_map = MemoryMap();
-        if (memory_map) {
-          // Attempt to retrive stack regions if a memory map was retrieved. In
-          // particular, this may be null when operating on the current process
-          // where the memory map will not be able to be retrieved.
-          GetStackRegions(general_regs, *memory_map, &thread.stack_regions);
+        zx_info_thread_t thread_info;
+        status = thread_handles[i].get_info(ZX_INFO_THREAD,
+                                            &thread_info,
+                                            sizeof(thread_info),
+                                            nullptr,
+                                            nullptr);
+        if (status != ZX_OK) {
+          ZX_LOG(WARNING, status) << "zx_object_get_info ZX_INFO_THREAD";
+        } else {
+          thread.state = thread_info.state;
+        }
+
+        zx_thread_state_general_regs_t general_regs;
+        status = thread_handles[i].read_state(ZX_THREAD_STATE_GENERAL_REGS,
+                                              &general_regs,
+                                              sizeof(general_regs));
+        if (status != ZX_OK) {
+          ZX_LOG(WARNING, status)
+              << "zx_thread_read_state(ZX_THREAD_STATE_GENERAL_REGS)";
+        } else {
+          thread.general_registers = general_regs;
+
+          if (memory_map) {
+            // Attempt to retrive stack regions if a memory map was retrieved.
+            GetStackRegions(general_regs, *memory_map, &thread.stack_regions);
+          }
         }
-      }
 
 // Floating point registers are in the vector context for ARM.
 #if !defined(ARCH_CPU_ARM64)
-      zx_thread_state_fp_regs_t fp_regs;
-      status = thread_handles[i].read_state(
-          ZX_THREAD_STATE_FP_REGS, &fp_regs, sizeof(fp_regs));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status)
-            << "zx_thread_read_state(ZX_THREAD_STATE_FP_REGS)";
-      } else {
-        thread.fp_registers = fp_regs;
-      }
+        zx_thread_state_fp_regs_t fp_regs;
+        status = thread_handles[i].read_state(
+            ZX_THREAD_STATE_FP_REGS, &fp_regs, sizeof(fp_regs));
+        if (status != ZX_OK) {
+          ZX_LOG(WARNING, status)
+              << "zx_thread_read_state(ZX_THREAD_STATE_FP_REGS)";
+        } else {
+          thread.fp_registers = fp_regs;
+        }
 #endif
 
-      zx_thread_state_vector_regs_t vector_regs;
-      status = thread_handles[i].read_state(
-          ZX_THREAD_STATE_VECTOR_REGS, &vector_regs, sizeof(vector_regs));
-      if (status != ZX_OK) {
-        ZX_LOG(WARNING, status)
-            << "zx_thread_read_state(ZX_THREAD_STATE_VECTOR_REGS)";
-      } else {
-        thread.vector_registers = vector_regs;
-      }
-    }
+        zx_thread_state_vector_regs_t vector_regs;
+        status = thread_handles[i].read_state(
+            ZX_THREAD_STATE_VECTOR_REGS, &vector_regs, sizeof(vector_regs));
+        if (status != ZX_OK) {
+          ZX_LOG(WARNING, status)
+              << "zx_thread_read_state(ZX_THREAD_STATE_VECTOR_REGS)";
+        } else {
+          thread.vector_registers = vector_regs;
+        }
+      });
 
-    threads_.push_back(thread);
-  }
+  threads_ = std::move(threads);
 }
 
 void ProcessReaderFuchsia::InitializeMemoryMap() {
@@ -18,6 +18,8 @@
 #include <lib/zx/process.h>
 #include <zircon/syscalls/debug.h>
 
+#include <stddef.h>
+
 #include <memory>
 #include <vector>
 
@@ -27,6 +29,7 @@
 #include "snapshot/module_snapshot.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/numeric/checked_range.h"
+#include "util/process/process_memory_cached.h"
 #include "util/process/process_memory_fuchsia.h"
 #include "util/process/process_memory_range.h"
 
@@ -115,8 +118,28 @@ class ProcessReaderFuchsia {
   //! \return The threads that are in the process.
   const std::vector<Thread>& Threads();
 
+  //! \brief Sets the maximum number of threads that may be used to gather
+  //!     information about the target process' threads.
+  //!
+  //! Each thread's name, state, and registers are read, and its stack located,
+  //! on one of as many as \a concurrency threads, including the calling thread.
+  //! Threads() returns threads in the same order regardless of the concurrency
+  //! used.
+  //!
+  //! The default concurrency is 1, which performs all work on the calling
+  //! thread. This method has no effect once Threads() has been called.
+  //!
+  //! \param[in] concurrency The maximum number of threads to use. Values less
+  //!     than 1 are treated as 1.
+  void SetThreadInitializationConcurrency(size_t concurrency) {
+    thread_initialization_concurrency_ = concurrency;
+  }
+
   //! \brief Return a memory reader for the target process.
-  const ProcessMemory* Memory() const { return process_memory_.get(); }
+  //!
+  //! Reads are cached for the lifetime of this object. See
+  //! ProcessMemoryCached.
+  const ProcessMemory* Memory() const { return &memory_; }
 
   //! \brief Return a memory map for the target process.
   const MemoryMapFuchsia* MemoryMap();
@@ -139,11 +162,13 @@ class ProcessReaderFuchsia {
   std::vector<std::unique_ptr<ElfImageReader>> module_readers_;
   std::vector<std::unique_ptr<ProcessMemoryRange>> process_memory_ranges_;
   std::unique_ptr<ProcessMemoryFuchsia> process_memory_;
+  ProcessMemoryCached memory_;
   std::unique_ptr<MemoryMapFuchsia> memory_map_;
   zx::unowned_process process_;
   bool initialized_modules_ = false;
   bool initialized_threads_ = false;
   bool initialized_memory_map_ = false;
+  size_t thread_initialization_concurrency_ = 1;
   InitializationStateDcheck initialized_;
 };
 
@@ -82,6 +82,29 @@ TEST(ProcessReaderFuchsia, SelfBasic) {
   EXPECT_EQ(threads[0].name, "SelfBasic");
 }
 
+TEST(ProcessReaderFuchsia, SelfThreadsConcurrent) {
+  const ScopedSetThreadName scoped_set_thread_name("SelfConcurrent");
+
+  ProcessReaderFuchsia process_reader;
+  process_reader.SetThreadInitializationConcurrency(4);
+  ASSERT_TRUE(process_reader.Initialize(*zx::process::self()));
+
+  zx_info_handle_basic_t info;
+  ASSERT_EQ(zx_object_get_info(zx_thread_self(),
+                               ZX_INFO_HANDLE_BASIC,
+                               &info,
+                               sizeof(info),
+                               nullptr,
+                               nullptr),
+            ZX_OK);
+
+  // Threads must still be reported in the order the kernel returned them.
+  const auto& threads = process_reader.Threads();
+  ASSERT_GT(threads.size(), 0u);
+  EXPECT_EQ(threads[0].id, info.koid);
+  EXPECT_EQ(threads[0].name, "SelfConcurrent");
+}
+
 constexpr char kTestMemory[] = "Read me from another process";
 
 CRASHPAD_CHILD_TEST_MAIN(ProcessReaderBasicChildTestMain) {
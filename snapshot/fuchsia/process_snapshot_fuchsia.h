@@ -16,6 +16,7 @@
 #define CRASHPAD_SNAPSHOT_FUCHSIA_PROCESS_SNAPSHOT_FUCHSIA_H_
 
 #include <lib/zx/process.h>
+#include <stddef.h>
 #include <sys/time.h>
 #include <zircon/syscalls/exception.h>
 #include <zircon/types.h>
@@ -50,6 +51,15 @@ class ProcessSnapshotFuchsia : public ProcessSnapshot {
 
   ~ProcessSnapshotFuchsia() override;
 
+  //! \brief Sets the maximum number of threads that may be used to gather
+  //!     information about the target process' threads.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessReaderFuchsia::SetThreadInitializationConcurrency().
+  void SetThreadInitializationConcurrency(size_t concurrency) {
+    process_reader_.SetThreadInitializationConcurrency(concurrency);
+  }
+
   //! \brief Initializes the object.
   //!
   //! \param[in] process The process handle to create a snapshot from.
@@ -114,5 +114,13 @@ std::vector<const MemorySnapshot*> ThreadSnapshotFuchsia::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState* ThreadSnapshotFuchsia::ExtendedRegisters() const {
+  return nullptr;
+}
+
+const ThreadSchedulingStats* ThreadSnapshotFuchsia::SchedulingStats() const {
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
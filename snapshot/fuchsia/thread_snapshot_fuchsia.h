@@ -63,6 +63,8 @@ class ThreadSnapshotFuchsia final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
+  const ThreadSchedulingStats* SchedulingStats() const override;
 
  private:
 #if defined(ARCH_CPU_X86_64)
@@ -14,6 +14,8 @@
 
 #include "snapshot/ios/exception_snapshot_ios_intermediate_dump.h"
 
+#include <string.h>
+
 #include "base/apple/mach_logging.h"
 #include "base/check_op.h"
 #include "base/logging.h"
@@ -173,23 +175,27 @@ bool ExceptionSnapshotIOSIntermediateDump::InitializeFromMachException(
   const IOSIntermediateDumpData* code_dump =
       GetDataFromMap(exception_data, Key::kCodes);
   if (code_dump) {
-    const std::vector<uint8_t>& bytes = code_dump->bytes();
-    const mach_exception_data_type_t* code =
-        reinterpret_cast<const mach_exception_data_type_t*>(bytes.data());
-    if (bytes.size() == 0 ||
-        bytes.size() % sizeof(mach_exception_data_type_t) != 0 || !code) {
+    const uint8_t* code = code_dump->data();
+    if (code_dump->size() == 0 ||
+        code_dump->size() % sizeof(mach_exception_data_type_t) != 0 ||
+        !code) {
       LOG(ERROR) << "Invalid mach exception code.";
     } else {
       mach_msg_type_number_t code_count =
-          bytes.size() / sizeof(mach_exception_data_type_t);
+          code_dump->size() / sizeof(mach_exception_data_type_t);
+      // The dump data is not necessarily aligned, so copy each code out.
       for (mach_msg_type_number_t code_index = 0; code_index < code_count;
            ++code_index) {
-        codes_.push_back(code[code_index]);
+        mach_exception_data_type_t value;
+        memcpy(&value,
+               code + code_index * sizeof(mach_exception_data_type_t),
+               sizeof(value));
+        codes_.push_back(value);
       }
       DCHECK_GE(code_count, 1u);
-      exception_info_ = code[0];
+      exception_info_ = codes_[0];
       if (code_count >= 2) {
-        exception_address_ = code[1];
+        exception_address_ = codes_[1];
       }
     }
   }
@@ -285,6 +291,12 @@ ExceptionSnapshotIOSIntermediateDump::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState*
+ExceptionSnapshotIOSIntermediateDump::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
 void ExceptionSnapshotIOSIntermediateDump::LoadContextFromThread(
     const IOSIntermediateDumpMap* exception_data,
     const IOSIntermediateDumpMap* other_thread) {
@@ -310,7 +322,8 @@ void ExceptionSnapshotIOSIntermediateDump::LoadContextFromThread(
     const IOSIntermediateDumpData* state_dump =
         GetDataFromMap(exception_data, Key::kState);
     if (state_dump) {
-      std::vector<uint8_t> bytes = state_dump->bytes();
+      std::vector<uint8_t> bytes(state_dump->data(),
+                                 state_dump->data() + state_dump->size());
       size_t actual_length = bytes.size();
       size_t expected_length = ThreadStateLengthForFlavor(flavor);
       if (actual_length < expected_length) {
@@ -382,13 +395,15 @@ void ExceptionSnapshotIOSIntermediateDump::
     LoadContextFromUncaughtNSExceptionFrames(
         const IOSIntermediateDumpData* frames_dump,
         const IOSIntermediateDumpMap* other_thread) {
-  const std::vector<uint8_t>& bytes = frames_dump->bytes();
-  const uint64_t* frames = reinterpret_cast<const uint64_t*>(bytes.data());
-  size_t num_frames = bytes.size() / sizeof(uint64_t);
+  size_t num_frames = frames_dump->size() / sizeof(uint64_t);
   if (num_frames < 2) {
     return;
   }
 
+  // The dump data is not necessarily aligned, so copy the frames out.
+  uint64_t frames[2];
+  memcpy(frames, frames_dump->data(), sizeof(frames));
+
 #if defined(ARCH_CPU_X86_64)
   context_x86_64_.rip = frames[0];  // instruction pointer
   context_x86_64_.rsp = frames[1];
@@ -86,6 +86,7 @@ class ExceptionSnapshotIOSIntermediateDump final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  virtual const ExtendedRegisterState* ExtendedRegisters() const override;
 
  private:
   void LoadContextFromUncaughtNSExceptionFrames(
@@ -70,11 +70,10 @@ bool ModuleSnapshotIOSIntermediateDump::Initialize(
   const IOSIntermediateDumpData* uuid_dump =
       GetDataFromMap(image_data, IntermediateDumpKey::kUUID);
   if (uuid_dump) {
-    const std::vector<uint8_t>& bytes = uuid_dump->bytes();
-    if (!bytes.data() || bytes.size() != 16) {
+    if (!uuid_dump->data() || uuid_dump->size() != 16) {
       LOG(ERROR) << "Invalid module uuid.";
     } else {
-      uuid_.InitializeFromBytes(bytes.data());
+      uuid_.InitializeFromBytes(uuid_dump->data());
     }
   }
 
@@ -99,14 +98,15 @@ bool ModuleSnapshotIOSIntermediateDump::Initialize(
       const IOSIntermediateDumpData* value_dump =
           annotation->GetAsData(IntermediateDumpKey::kAnnotationValue);
       if (type_dump && value_dump && type_dump->GetValue<uint16_t>(&type)) {
-        const std::vector<uint8_t>& bytes = value_dump->bytes();
-        uint64_t length = bytes.size();
-        if (!bytes.data() || length > Annotation::kValueMaxSize) {
+        uint64_t length = value_dump->size();
+        if (!value_dump->data() || length > Annotation::kValueMaxSize) {
           LOG(ERROR) << "Invalid annotation value, size=" << length
                      << ", max size=" << Annotation::kValueMaxSize
                      << ", discarding annotation.";
           continue;
         }
+        std::vector<uint8_t> bytes(value_dump->data(),
+                                   value_dump->data() + length);
         annotation_objects_.push_back(AnnotationSnapshot(name, type, bytes));
       }
     }
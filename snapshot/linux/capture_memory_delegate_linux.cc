@@ -14,6 +14,8 @@
 
 #include "snapshot/linux/capture_memory_delegate_linux.h"
 
+#include <string.h>
+
 #include <utility>
 
 #include "base/numerics/safe_conversions.h"
@@ -31,7 +33,8 @@ CaptureMemoryDelegateLinux::CaptureMemoryDelegateLinux(
              thread_opt ? thread_opt->stack_region_size : 0),
       process_reader_(process_reader),
       snapshots_(snapshots),
-      budget_remaining_(budget_remaining) {}
+      budget_remaining_(budget_remaining),
+      captured_() {}
 
 bool CaptureMemoryDelegateLinux::Is64Bit() const {
   return process_reader_->Is64Bit();
@@ -47,18 +50,37 @@ bool CaptureMemoryDelegateLinux::ReadMemory(uint64_t at,
 std::vector<CheckedRange<uint64_t>>
 CaptureMemoryDelegateLinux::GetReadableRanges(
     const CheckedRange<uint64_t, uint64_t>& range) const {
-  return process_reader_->GetMemoryMap()->GetReadableRanges(range);
+  // Many pointers refer to the same objects. What this delegate has already
+  // captured was readable, and AddNewMemorySnapshot() would skip it anyway,
+  // so report nothing for it without searching the memory map or building a
+  // result.
+  if (captured_.Covers(range.base(), range.size())) {
+    return std::vector<CheckedRange<uint64_t>>();
+  }
+
+  // Mappings that the target excluded from core dumps, such as large caches,
+  // are left out of the snapshot too.
+  return process_reader_->GetMemoryMap()->GetDumpableRanges(range);
 }
 
-void CaptureMemoryDelegateLinux::AddNewMemorySnapshot(
+bool CaptureMemoryDelegateLinux::AddNewMemorySnapshot(
     const CheckedRange<uint64_t, uint64_t>& range) {
   // Don't bother storing this memory if it points back into the stack.
   if (stack_.ContainsRange(range))
-    return;
+    return false;
   if (range.size() == 0)
-    return;
+    return false;
+  // Unmodified module code can be recovered from the module's file, so don't
+  // spend budget capturing it when elision is enabled.
+  if (process_reader_->IsElidableModuleRange(range))
+    return false;
   if (!budget_remaining_ || *budget_remaining_ == 0)
-    return;
+    return false;
+  // Many pointers refer to the same objects, so don't spend budget capturing
+  // memory that this delegate has already captured.
+  if (captured_.Covers(range.base(), range.size()))
+    return false;
+  captured_.Insert(range.base(), range.size());
   snapshots_->push_back(std::make_unique<internal::MemorySnapshotGeneric>());
   internal::MemorySnapshotGeneric* snapshot = snapshots_->back().get();
   snapshot->Initialize(process_reader_->Memory(), range.base(), range.size());
@@ -69,6 +91,21 @@ void CaptureMemoryDelegateLinux::AddNewMemorySnapshot(
     temp -= range.size();
     *budget_remaining_ = base::saturated_cast<uint32_t>(temp);
   }
+  return true;
+}
+
+bool CaptureMemoryDelegateLinux::IsAnonymousExecutable(
+    uint64_t address) const {
+  const MemoryMap::Mapping* mapping =
+      process_reader_->GetMemoryMap()->FindMapping(address);
+  if (!mapping || !mapping->executable || mapping->inode != 0) {
+    return false;
+  }
+  // Anonymous mappings have no name, or one given by the process on Android.
+  // Pseudo-files such as [vdso] come from the kernel and aren't JIT code.
+  static constexpr char kAnonPrefix[] = "[anon:";
+  return mapping->name.empty() ||
+         mapping->name.compare(0, strlen(kAnonPrefix), kAnonPrefix) == 0;
 }
 
 }  // namespace internal
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "snapshot/linux/process_reader_linux.h"
+#include "util/misc/range_set.h"
 #include "util/numeric/checked_range.h"
 
 namespace crashpad {
@@ -54,14 +55,16 @@ class CaptureMemoryDelegateLinux : public CaptureMemory::Delegate {
   bool ReadMemory(uint64_t at, uint64_t num_bytes, void* into) const override;
   std::vector<CheckedRange<uint64_t>> GetReadableRanges(
       const CheckedRange<uint64_t, uint64_t>& range) const override;
-  void AddNewMemorySnapshot(
+  bool AddNewMemorySnapshot(
       const CheckedRange<uint64_t, uint64_t>& range) override;
+  bool IsAnonymousExecutable(uint64_t address) const override;
 
  private:
   CheckedRange<uint64_t, uint64_t> stack_;
   ProcessReaderLinux* process_reader_;  // weak
   std::vector<std::unique_ptr<MemorySnapshotGeneric>>* snapshots_;  // weak
   uint32_t* budget_remaining_;
+  RangeSet captured_;
 };
 
 }  // namespace internal
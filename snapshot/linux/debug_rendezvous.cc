@@ -15,10 +15,14 @@
 #include "snapshot/linux/debug_rendezvous.h"
 
 #include <stdint.h>
+#include <string.h>
 
+#include <algorithm>
 #include <set>
 
+#include "base/check_op.h"
 #include "base/logging.h"
+#include "base/memory/page_size.h"
 #include "build/build_config.h"
 
 #if BUILDFLAG(IS_ANDROID)
@@ -60,25 +64,78 @@ struct LinkEntrySpecific {
 template <typename Traits>
 bool ReadLinkEntry(const ProcessMemoryRange& memory,
                    LinuxVMAddress* address,
-                   DebugRendezvous::LinkEntry* entry_out) {
+                   DebugRendezvous::LinkEntry* entry_out,
+                   LinuxVMAddress* name_address) {
   LinkEntrySpecific<Traits> entry;
   if (!memory.Read(*address, sizeof(entry), &entry)) {
     return false;
   }
 
-  std::string name;
-  if (!memory.ReadCStringSizeLimited(entry.l_name, 4096, &name)) {
-    name.clear();
-  }
-
   entry_out->load_bias = entry.l_addr;
   entry_out->dynamic_array = entry.l_ld;
-  entry_out->name.swap(name);
+  *name_address = entry.l_name;
 
   *address = entry.l_next;
   return true;
 }
 
+// The number of bytes read speculatively for each module name. Names which
+// don't fit are read again individually.
+constexpr size_t kNamePrefetchSize = 256;
+
+// The maximum length of a module name.
+constexpr size_t kMaxNameSize = 4096;
+
+// Reads the names of every link entry. Each link entry must be read before the
+// next can be found, but the names can then all be read at once with a single
+// batched read, rather than with a read per name. Each name is read up to
+// kNamePrefetchSize bytes, but never past the end of the page containing its
+// start, so that the prefetch doesn't fail for names which end just before an
+// unmapped page.
+void ReadLinkEntryNames(
+    const ProcessMemoryRange& memory,
+    const std::vector<LinuxVMAddress>& name_addresses,
+    const std::vector<DebugRendezvous::LinkEntry*>& entries) {
+  DCHECK_EQ(name_addresses.size(), entries.size());
+
+  const LinuxVMSize page_size = base::GetPageSize();
+  std::vector<char> buffer(name_addresses.size() * kNamePrefetchSize);
+  std::vector<ProcessMemory::ReadRange> ranges;
+  std::vector<size_t> indices;
+  ranges.reserve(name_addresses.size());
+  indices.reserve(name_addresses.size());
+  for (size_t index = 0; index < name_addresses.size(); ++index) {
+    const LinuxVMAddress address = name_addresses[index];
+    if (!address) {
+      continue;
+    }
+    const LinuxVMSize page_remaining = page_size - address % page_size;
+    ranges.push_back(
+        {address,
+         std::min(LinuxVMSize{kNamePrefetchSize}, page_remaining),
+         &buffer[index * kNamePrefetchSize]});
+    indices.push_back(index);
+  }
+
+  std::vector<bool> results;
+  memory.ReadBatch(ranges, &results);
+
+  for (size_t range_index = 0; range_index < ranges.size(); ++range_index) {
+    const size_t index = indices[range_index];
+    const ProcessMemory::ReadRange& range = ranges[range_index];
+    std::string& name = entries[index]->name;
+
+    const char* prefetched = static_cast<const char*>(range.buffer);
+    const size_t length = strnlen(prefetched, range.size);
+    if (results[range_index] && length < range.size) {
+      name.assign(prefetched, length);
+    } else if (!memory.ReadCStringSizeLimited(
+                   range.address, kMaxNameSize, &name)) {
+      name.clear();
+    }
+  }
+}
+
 }  // namespace
 
 DebugRendezvous::LinkEntry::LinkEntry()
@@ -124,7 +181,9 @@ bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
   }
 
   LinuxVMAddress link_entry_address = debug.r_map;
-  if (!ReadLinkEntry<Traits>(memory, &link_entry_address, &executable_)) {
+  std::vector<LinuxVMAddress> name_addresses(1);
+  if (!ReadLinkEntry<Traits>(
+          memory, &link_entry_address, &executable_, &name_addresses[0])) {
     return false;
   }
 
@@ -136,11 +195,22 @@ bool DebugRendezvous::InitializeSpecific(const ProcessMemoryRange& memory,
     }
 
     LinkEntry entry;
-    if (!ReadLinkEntry<Traits>(memory, &link_entry_address, &entry)) {
+    LinuxVMAddress name_address;
+    if (!ReadLinkEntry<Traits>(
+            memory, &link_entry_address, &entry, &name_address)) {
       return false;
     }
     modules_.push_back(entry);
+    name_addresses.push_back(name_address);
+  }
+
+  std::vector<LinkEntry*> entries;
+  entries.reserve(name_addresses.size());
+  entries.push_back(&executable_);
+  for (LinkEntry& module : modules_) {
+    entries.push_back(&module);
   }
+  ReadLinkEntryNames(memory, name_addresses, entries);
 
 #if BUILDFLAG(IS_ANDROID)
   // Android P (API 28) mistakenly places the vdso in the first entry in the
@@ -15,6 +15,9 @@
 #include "snapshot/linux/exception_snapshot_linux.h"
 
 #include <signal.h>
+#include <string.h>
+
+#include <vector>
 
 #include "base/logging.h"
 #include "snapshot/linux/capture_memory_delegate_linux.h"
@@ -22,6 +25,7 @@
 #include "snapshot/linux/process_reader_linux.h"
 #include "snapshot/linux/signal_context.h"
 #include "util/linux/traits.h"
+#include "util/misc/extended_register_state.h"
 #include "util/misc/reinterpret_bytes.h"
 #include "util/numeric/safe_assignment.h"
 #include "util/posix/signals.h"
@@ -34,6 +38,8 @@ ExceptionSnapshotLinux::ExceptionSnapshotLinux()
       context_union_(),
       context_(),
       codes_(),
+      extra_memory_(),
+      extended_registers_(),
       thread_id_(0),
       exception_address_(0),
       signal_number_(0),
@@ -44,12 +50,53 @@ ExceptionSnapshotLinux::~ExceptionSnapshotLinux() {}
 
 #if defined(ARCH_CPU_X86_FAMILY)
 
+namespace {
+
+// Reads the XSAVE area that the kernel saved in a signal frame, beginning with
+// the fxsave area at fxsave_address, if there is one.
+template <typename Fxsave>
+void ReadXSaveState(const ProcessMemory* memory,
+                    LinuxVMAddress fxsave_address,
+                    const Fxsave& fxsave,
+                    ExtendedRegisterState* state) {
+  SignalXSaveSoftwareBytes sw_bytes;
+  static_assert(sizeof(sw_bytes) == sizeof(fxsave.available),
+                "software reserved bytes size mismatch");
+  memcpy(&sw_bytes, fxsave.available, sizeof(sw_bytes));
+
+  // Without XSAVE support in the handler’s process, the layout of the area
+  // can’t be known. The kernel uses the same layout for every process.
+  const XSaveLayout* layout = NativeXSaveLayout();
+  if (sw_bytes.magic1 != FP_XSTATE_MAGIC1 || !layout) {
+    return;
+  }
+
+  // Reject sizes larger than any XSAVE area the CPU could produce.
+  constexpr uint32_t kMaxXSaveSize = 64 * 1024;
+  if (sw_bytes.xstate_size < sizeof(fxsave) ||
+      sw_bytes.xstate_size > kMaxXSaveSize) {
+    LOG(WARNING) << "invalid xstate size " << sw_bytes.xstate_size;
+    return;
+  }
+
+  std::vector<uint8_t> xsave(sw_bytes.xstate_size);
+  if (!memory->Read(fxsave_address, xsave.size(), xsave.data())) {
+    LOG(WARNING) << "Couldn't read xsave";
+    return;
+  }
+  if (!state->InitializeFromXSave(xsave.data(), xsave.size(), *layout)) {
+    state->Reset(ExtendedRegisterState::Format::kNone, 0);
+  }
+}
+
+}  // namespace
+
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   UContext<ContextTraits32> ucontext;
-  if (!reader->Memory()->Read(context_address, sizeof(ucontext), &ucontext)) {
+  if (!memory->Read(context_address, sizeof(ucontext), &ucontext)) {
     LOG(ERROR) << "Couldn't read ucontext";
     return false;
   }
@@ -64,7 +111,7 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
   }
 
   SignalFloatContext32 fprs;
-  if (!reader->Memory()->Read(ucontext.mcontext.fpptr, sizeof(fprs), &fprs)) {
+  if (!memory->Read(ucontext.mcontext.fpptr, sizeof(fprs), &fprs)) {
     LOG(ERROR) << "Couldn't read float context";
     return false;
   }
@@ -72,13 +119,18 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
   if (fprs.magic == X86_FXSR_MAGIC) {
     InitializeCPUContextX86_NoFloatingPoint(ucontext.mcontext.gprs,
                                             context_.x86);
-    if (!reader->Memory()->Read(
+    if (!memory->Read(
             ucontext.mcontext.fpptr + offsetof(SignalFloatContext32, fxsave),
             sizeof(CPUContextX86::Fxsave),
             &context_.x86->fxsave)) {
       LOG(ERROR) << "Couldn't read fxsave";
       return false;
     }
+    ReadXSaveState(
+        memory,
+        ucontext.mcontext.fpptr + offsetof(SignalFloatContext32, fxsave),
+        context_.x86->fxsave,
+        &extended_registers_);
   } else if (fprs.magic == 0xffff) {
     InitializeCPUContextX86(ucontext.mcontext.gprs, fprs, context_.x86);
   } else {
@@ -91,10 +143,10 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
 
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   UContext<ContextTraits64> ucontext;
-  if (!reader->Memory()->Read(context_address, sizeof(ucontext), &ucontext)) {
+  if (!memory->Read(context_address, sizeof(ucontext), &ucontext)) {
     LOG(ERROR) << "Couldn't read ucontext";
     return false;
   }
@@ -109,12 +161,13 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
   }
 
   SignalFloatContext64 fprs;
-  if (!reader->Memory()->Read(ucontext.mcontext.fpptr, sizeof(fprs), &fprs)) {
+  if (!memory->Read(ucontext.mcontext.fpptr, sizeof(fprs), &fprs)) {
     LOG(ERROR) << "Couldn't read float context";
     return false;
   }
 
   InitializeCPUContextX86_64(ucontext.mcontext.gprs, fprs, context_.x86_64);
+  ReadXSaveState(memory, ucontext.mcontext.fpptr, fprs, &extended_registers_);
   return true;
 }
 
@@ -122,13 +175,12 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
 
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   context_.architecture = kCPUArchitectureARM;
   context_.arm = &context_union_.arm;
 
   CPUContextARM* dest_context = context_.arm;
-  const ProcessMemory* memory = reader->Memory();
 
   LinuxVMAddress gprs_address =
       context_address + offsetof(UContext<ContextTraits32>, mcontext32) +
@@ -197,15 +249,52 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
   } while (true);
 }
 
+namespace {
+
+// Reads the SVE registers from the SVE_MAGIC signal frame record at
+// record_address, if the record holds any.
+void ReadSVEState(const ProcessMemoryRange& range,
+                  LinuxVMAddress record_address,
+                  uint32_t record_size,
+                  ExtendedRegisterState* state) {
+  constexpr uint32_t kHeaderSize =
+      sizeof(CoprocessorContextHead) + sizeof(SignalSVEContext);
+  constexpr uint32_t kRegistersOffset = 16;
+  static_assert(kHeaderSize <= kRegistersOffset, "SVE header too large");
+  if (record_size <= kRegistersOffset) {
+    return;
+  }
+
+  SignalSVEContext sve;
+  if (!range.Read(record_address + sizeof(CoprocessorContextHead),
+                  sizeof(sve),
+                  &sve)) {
+    LOG(WARNING) << "Couldn't read sve context";
+    return;
+  }
+
+  std::vector<uint8_t> registers(record_size - kRegistersOffset);
+  if (!range.Read(record_address + kRegistersOffset,
+                  registers.size(),
+                  registers.data())) {
+    LOG(WARNING) << "Couldn't read sve registers";
+    return;
+  }
+  if (!state->InitializeFromSVE(sve.vl, registers.data(), registers.size())) {
+    state->Reset(ExtendedRegisterState::Format::kNone, 0);
+  }
+}
+
+}  // namespace
+
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   context_.architecture = kCPUArchitectureARM64;
   context_.arm64 = &context_union_.arm64;
 
   CPUContextARM64* dest_context = context_.arm64;
-  const ProcessMemory* memory = reader->Memory();
 
   LinuxVMAddress gprs_address =
       context_address + offsetof(UContext<ContextTraits64>, mcontext64) +
@@ -232,16 +321,21 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
     return false;
   }
 
+  bool have_fpsimd = false;
   do {
     CoprocessorContextHead head;
     if (!range.Read(reserved_address, sizeof(head), &head)) {
+      if (have_fpsimd) {
+        return true;
+      }
       LOG(ERROR) << "missing context terminator";
       return false;
     }
+    const LinuxVMAddress record_address = reserved_address;
     reserved_address += sizeof(head);
 
     switch (head.magic) {
-      case FPSIMD_MAGIC:
+      case FPSIMD_MAGIC: {
         if (head.size != sizeof(SignalFPSIMDContext) + sizeof(head)) {
           LOG(ERROR) << "unexpected fpsimd context size " << head.size;
           return false;
@@ -252,7 +346,18 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
           return false;
         }
         InitializeCPUContextARM64_OnlyFPSIMD(fpsimd, dest_context);
-        return true;
+        have_fpsimd = true;
+        reserved_address += sizeof(fpsimd);
+        continue;
+      }
+
+      case SVE_MAGIC:
+        // A record holding only the header means that the thread had no SVE
+        // state beyond its FPSIMD registers. Larger vector lengths may place
+        // the registers in an EXTRA_MAGIC record, which isn’t followed.
+        ReadSVEState(range, record_address, head.size, &extended_registers_);
+        reserved_address = record_address + head.size;
+        continue;
 
       case ESR_MAGIC:
       case EXTRA_MAGIC:
@@ -260,10 +365,18 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
         continue;
 
       case 0:
-        LOG(WARNING) << "fpsimd not found";
+        if (!have_fpsimd) {
+          LOG(WARNING) << "fpsimd not found";
+        }
         return true;
 
       default:
+        // Records that this code doesn’t understand may follow the FPSIMD
+        // record on newer kernels.
+        if (have_fpsimd && head.size >= sizeof(head)) {
+          reserved_address = record_address + head.size;
+          continue;
+        }
         LOG(ERROR) << "invalid magic number 0x" << std::hex << head.magic;
         return false;
     }
@@ -273,11 +386,9 @@ bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
 #elif defined(ARCH_CPU_MIPS_FAMILY)
 
 template <typename Traits>
-static bool ReadContext(ProcessReaderLinux* reader,
+static bool ReadContext(const ProcessMemory* memory,
                         LinuxVMAddress context_address,
                         typename Traits::CPUContext* dest_context) {
-  const ProcessMemory* memory = reader->Memory();
-
   LinuxVMAddress gregs_address = context_address +
                                  offsetof(UContext<Traits>, mcontext) +
                                  offsetof(typename Traits::MContext, gregs);
@@ -305,33 +416,31 @@ static bool ReadContext(ProcessReaderLinux* reader,
 
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits32>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   context_.architecture = kCPUArchitectureMIPSEL;
   context_.mipsel = &context_union_.mipsel;
 
   return internal::ReadContext<ContextTraits32>(
-      reader, context_address, context_.mipsel);
+      memory, context_address, context_.mipsel);
 }
 
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   context_.architecture = kCPUArchitectureMIPS64EL;
   context_.mips64 = &context_union_.mips64;
 
   return internal::ReadContext<ContextTraits64>(
-      reader, context_address, context_.mips64);
+      memory, context_address, context_.mips64);
 }
 
 #elif defined(ARCH_CPU_RISCV64)
 
-static bool ReadContext(ProcessReaderLinux* reader,
+static bool ReadContext(const ProcessMemory* memory,
                         LinuxVMAddress context_address,
                         typename ContextTraits64::CPUContext* dest_context) {
-  const ProcessMemory* memory = reader->Memory();
-
   LinuxVMAddress gregs_address = context_address +
                                  offsetof(UContext<ContextTraits64>, mcontext) +
                                  offsetof(MContext64, regs);
@@ -359,12 +468,12 @@ static bool ReadContext(ProcessReaderLinux* reader,
 
 template <>
 bool ExceptionSnapshotLinux::ReadContext<ContextTraits64>(
-    ProcessReaderLinux* reader,
+    const ProcessMemory* memory,
     LinuxVMAddress context_address) {
   context_.architecture = kCPUArchitectureRISCV64;
   context_.riscv64 = &context_union_.riscv64;
 
-  return internal::ReadContext(reader, context_address, context_.riscv64);
+  return internal::ReadContext(memory, context_address, context_.riscv64);
 }
 
 #endif  // ARCH_CPU_X86_FAMILY
@@ -374,7 +483,10 @@ bool ExceptionSnapshotLinux::Initialize(
     LinuxVMAddress siginfo_address,
     LinuxVMAddress context_address,
     pid_t thread_id,
-    uint32_t* gather_indirectly_referenced_memory_cap) {
+    uint32_t* gather_indirectly_referenced_memory_cap,
+    CaptureTimings* capture_timings,
+    const ProcessMemory* context_memory,
+    size_t indirect_memory_depth) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   thread_id_ = thread_id;
@@ -391,36 +503,52 @@ bool ExceptionSnapshotLinux::Initialize(
     LOG(WARNING) << "thread ID " << thread_id << " not found in process";
   }
 
+  if (!context_memory) {
+    context_memory = process_reader->Memory();
+  }
+
   if (process_reader->Is64Bit()) {
-    if (!ReadContext<ContextTraits64>(process_reader, context_address) ||
-        !ReadSiginfo<Traits64>(process_reader, siginfo_address)) {
+    if (!ReadContext<ContextTraits64>(context_memory, context_address) ||
+        !ReadSiginfo<Traits64>(context_memory, siginfo_address)) {
       return false;
     }
   } else {
 #if !defined(ARCH_CPU_RISCV64)
-    if (!ReadContext<ContextTraits32>(process_reader, context_address) ||
-        !ReadSiginfo<Traits32>(process_reader, siginfo_address)) {
+    if (!ReadContext<ContextTraits32>(context_memory, context_address) ||
+        !ReadSiginfo<Traits32>(context_memory, siginfo_address)) {
       return false;
     }
 #endif
   }
 
-  CaptureMemoryDelegateLinux capture_memory_delegate(
-      process_reader,
-      thread,
-      &extra_memory_,
-      gather_indirectly_referenced_memory_cap);
-  CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+  {
+    ScopedCapturePhase capture_phase(capture_timings,
+                                     CapturePhase::kIndirectMemory,
+                                     process_reader->Memory());
+    CaptureMemoryDelegateLinux capture_memory_delegate(
+        process_reader,
+        thread,
+        &extra_memory_,
+        gather_indirectly_referenced_memory_cap);
+    // JIT code is captured first, so that pointers followed from the context
+    // don't use up the budget before it.
+    if (gather_indirectly_referenced_memory_cap &&
+        *gather_indirectly_referenced_memory_cap > 0) {
+      CaptureMemory::JitCodeAroundContext(context_, &capture_memory_delegate);
+    }
+    CaptureMemory::PointedToByContextRecursively(
+        context_, indirect_memory_depth, &capture_memory_delegate);
+  }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
 template <typename Traits>
-bool ExceptionSnapshotLinux::ReadSiginfo(ProcessReaderLinux* reader,
+bool ExceptionSnapshotLinux::ReadSiginfo(const ProcessMemory* memory,
                                          LinuxVMAddress siginfo_address) {
   Siginfo<Traits> siginfo;
-  if (!reader->Memory()->Read(siginfo_address, sizeof(siginfo), &siginfo)) {
+  if (!memory->Read(siginfo_address, sizeof(siginfo), &siginfo)) {
     LOG(ERROR) << "Couldn't read siginfo";
     return false;
   }
@@ -540,5 +668,10 @@ std::vector<const MemorySnapshot*> ExceptionSnapshotLinux::ExtraMemory() const {
   return result;
 }
 
+const ExtendedRegisterState* ExceptionSnapshotLinux::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return &extended_registers_;
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_SNAPSHOT_LINUX_EXCEPTION_SNAPSHOT_LINUX_H_
 #define CRASHPAD_SNAPSHOT_LINUX_EXCEPTION_SNAPSHOT_LINUX_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/types.h>
 
@@ -27,7 +28,10 @@
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
 #include "util/linux/address_types.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/extended_register_state.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
 
 namespace crashpad {
 namespace internal {
@@ -53,6 +57,15 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
   //! \param[in] context_address The address in the target process' address
   //!     space of the ucontext_t passed to the signal handler.
   //! \param[in] thread_id The thread ID of the thread that received the signal.
+  //! \param[in] capture_timings If not `nullptr`, the time spent locating
+  //!     indirectly referenced memory is charged to
+  //!     CapturePhase::kIndirectMemory here.
+  //! \param[in] context_memory The memory to read the `siginfo_t` and
+  //!     `ucontext_t` from. Optional. If `nullptr`, they are read from \a
+  //!     process_reader's memory.
+  //! \param[in] indirect_memory_depth The number of levels of pointers to
+  //!     follow from the exception context when capturing indirectly
+  //!     referenced memory. See CaptureMemory::PointedToByContextRecursively().
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
@@ -60,7 +73,10 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
                   LinuxVMAddress siginfo_address,
                   LinuxVMAddress context_address,
                   pid_t thread_id,
-                  uint32_t* gather_indirectly_referenced_memory_cap);
+                  uint32_t* gather_indirectly_referenced_memory_cap,
+                  CaptureTimings* capture_timings,
+                  const ProcessMemory* context_memory = nullptr,
+                  size_t indirect_memory_depth = 1);
 
   // ExceptionSnapshot:
 
@@ -71,13 +87,14 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  virtual const ExtendedRegisterState* ExtendedRegisters() const override;
 
  private:
   template <typename Traits>
-  bool ReadSiginfo(ProcessReaderLinux* reader, LinuxVMAddress siginfo_address);
+  bool ReadSiginfo(const ProcessMemory* memory, LinuxVMAddress siginfo_address);
 
   template <typename Traits>
-  bool ReadContext(ProcessReaderLinux* reader, LinuxVMAddress context_address);
+  bool ReadContext(const ProcessMemory* memory, LinuxVMAddress context_address);
 
   union {
 #if defined(ARCH_CPU_X86_FAMILY)
@@ -96,6 +113,7 @@ class ExceptionSnapshotLinux final : public ExceptionSnapshot {
   CPUContext context_;
   std::vector<uint64_t> codes_;
   std::vector<std::unique_ptr<internal::MemorySnapshotGeneric>> extra_memory_;
+  ExtendedRegisterState extended_registers_;
   uint64_t thread_id_;
   uint64_t exception_address_;
   uint32_t signal_number_;
@@ -350,6 +350,7 @@ TEST(ExceptionSnapshotLinux, SelfBasic) {
                                    FromPointerCast<LinuxVMAddress>(&siginfo),
                                    FromPointerCast<LinuxVMAddress>(&context),
                                    gettid(),
+                                   nullptr,
                                    nullptr));
   EXPECT_EQ(exception.Exception(), static_cast<uint32_t>(siginfo.si_signo));
   EXPECT_EQ(exception.ExceptionInfo(), static_cast<uint32_t>(siginfo.si_code));
@@ -424,6 +425,7 @@ class RaiseTest {
                                      FromPointerCast<LinuxVMAddress>(siginfo),
                                      FromPointerCast<LinuxVMAddress>(context),
                                      gettid(),
+                                     nullptr,
                                      nullptr));
 
     EXPECT_EQ(exception.Exception(), static_cast<uint32_t>(kSigno));
@@ -496,6 +498,7 @@ class TimerTest {
                                      FromPointerCast<LinuxVMAddress>(siginfo),
                                      FromPointerCast<LinuxVMAddress>(context),
                                      gettid(),
+                                     nullptr,
                                      nullptr));
 
     EXPECT_EQ(exception.Exception(), static_cast<uint32_t>(kSigno));
@@ -0,0 +1,67 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/module_list_cache.h"
+
+namespace crashpad {
+
+ModuleListCache::ModuleListCache(size_t max_entries)
+    : lock_(), entries_(), max_entries_(max_entries), next_sequence_(0) {}
+
+ModuleListCache::~ModuleListCache() = default;
+
+bool ModuleListCache::Lookup(pid_t pid,
+                             uint64_t fingerprint,
+                             std::vector<Module>* modules) const {
+  base::AutoLock lock(lock_);
+  auto iter = entries_.find(pid);
+  if (iter == entries_.end() || iter->second.fingerprint != fingerprint) {
+    return false;
+  }
+  *modules = iter->second.modules;
+  return true;
+}
+
+void ModuleListCache::Insert(pid_t pid,
+                             uint64_t fingerprint,
+                             const std::vector<Module>& modules) {
+  base::AutoLock lock(lock_);
+  if (max_entries_ == 0) {
+    return;
+  }
+
+  auto iter = entries_.find(pid);
+  if (iter == entries_.end() && entries_.size() >= max_entries_) {
+    auto oldest = entries_.begin();
+    for (auto candidate = entries_.begin(); candidate != entries_.end();
+         ++candidate) {
+      if (candidate->second.sequence < oldest->second.sequence) {
+        oldest = candidate;
+      }
+    }
+    entries_.erase(oldest);
+  }
+
+  Entry& entry = entries_[pid];
+  entry.modules = modules;
+  entry.fingerprint = fingerprint;
+  entry.sequence = next_sequence_++;
+}
+
+size_t ModuleListCache::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,115 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_LINUX_MODULE_LIST_CACHE_H_
+#define CRASHPAD_SNAPSHOT_LINUX_MODULE_LIST_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "snapshot/module_snapshot.h"
+#include "util/misc/address_types.h"
+
+namespace crashpad {
+
+//! \brief Retains the module lists of processes across snapshots.
+//!
+//! Locating a process' modules means walking its loader's link map and
+//! searching its memory map for the mapping that holds each module's ELF
+//! header. A process that is dumped repeatedly, for example to sample a hang,
+//! usually has the same modules each time. This cache records where each
+//! module was found so that a later snapshot of the same process can go
+//! straight to the headers.
+//!
+//! Entries are keyed by process ID and validated by
+//! MemoryMap::FileMappingFingerprint(), so that an entry is only used while
+//! the process' file mappings, and therefore its modules, are unchanged.
+//!
+//! This class is thread-safe.
+class ModuleListCache {
+ public:
+  //! \brief A module as it was found in the process.
+  struct Module {
+    //! \brief The module's name. See ProcessReaderLinux::Module::name.
+    std::string name;
+
+    //! \brief The address of the module's ELF header.
+    VMAddress header_address;
+
+    //! \brief The module's type.
+    ModuleSnapshot::ModuleType type;
+  };
+
+  //! \brief The default value for \a max_entries in the constructor.
+  static constexpr size_t kDefaultMaxEntries = 64;
+
+  //! \param[in] max_entries The maximum number of processes to retain. Once
+  //!     full, adding a new process evicts the one that was added least
+  //!     recently.
+  explicit ModuleListCache(size_t max_entries = kDefaultMaxEntries);
+
+  ModuleListCache(const ModuleListCache&) = delete;
+  ModuleListCache& operator=(const ModuleListCache&) = delete;
+
+  ~ModuleListCache();
+
+  //! \brief Looks up the modules of a process.
+  //!
+  //! \param[in] pid The process ID.
+  //! \param[in] fingerprint The process' current
+  //!     MemoryMap::FileMappingFingerprint().
+  //! \param[out] modules The cached modules, valid if this method returns
+  //!     `true`.
+  //! \return `true` if the process was found in the cache with the same
+  //!     fingerprint.
+  bool Lookup(pid_t pid,
+              uint64_t fingerprint,
+              std::vector<Module>* modules) const;
+
+  //! \brief Adds the modules of a process to the cache, replacing any
+  //!     existing entry for it.
+  //!
+  //! \param[in] pid The process ID.
+  //! \param[in] fingerprint The MemoryMap::FileMappingFingerprint() of the
+  //!     process at the time \a modules were located.
+  //! \param[in] modules The modules to cache.
+  void Insert(pid_t pid,
+              uint64_t fingerprint,
+              const std::vector<Module>& modules);
+
+  //! \brief Returns the number of processes in the cache.
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::vector<Module> modules;
+    uint64_t fingerprint;
+    uint64_t sequence;
+  };
+
+  mutable base::Lock lock_;
+  std::map<pid_t, Entry> entries_;
+  size_t max_entries_;
+  uint64_t next_sequence_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_LINUX_MODULE_LIST_CACHE_H_
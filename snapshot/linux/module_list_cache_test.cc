@@ -0,0 +1,81 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/linux/module_list_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<ModuleListCache::Module> MakeModules(const std::string& name) {
+  std::vector<ModuleListCache::Module> modules;
+  modules.push_back(
+      {name, 0x1000, ModuleSnapshot::ModuleType::kModuleTypeExecutable});
+  modules.push_back({"libc.so.6",
+                     0x8000,
+                     ModuleSnapshot::ModuleType::kModuleTypeSharedLibrary});
+  return modules;
+}
+
+TEST(ModuleListCache, LookupAndInsert) {
+  ModuleListCache cache;
+  std::vector<ModuleListCache::Module> modules;
+  EXPECT_FALSE(cache.Lookup(100, 1, &modules));
+
+  cache.Insert(100, 1, MakeModules("exe"));
+  EXPECT_EQ(cache.size(), 1u);
+
+  ASSERT_TRUE(cache.Lookup(100, 1, &modules));
+  ASSERT_EQ(modules.size(), 2u);
+  EXPECT_EQ(modules[0].name, "exe");
+  EXPECT_EQ(modules[0].header_address, 0x1000u);
+  EXPECT_EQ(modules[0].type, ModuleSnapshot::ModuleType::kModuleTypeExecutable);
+  EXPECT_EQ(modules[1].name, "libc.so.6");
+
+  // Both the process ID and the fingerprint must match.
+  EXPECT_FALSE(cache.Lookup(101, 1, &modules));
+  EXPECT_FALSE(cache.Lookup(100, 2, &modules));
+
+  // Inserting an existing process replaces its entry.
+  cache.Insert(100, 2, MakeModules("new_exe"));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_FALSE(cache.Lookup(100, 1, &modules));
+  ASSERT_TRUE(cache.Lookup(100, 2, &modules));
+  EXPECT_EQ(modules[0].name, "new_exe");
+}
+
+TEST(ModuleListCache, MaxEntries) {
+  ModuleListCache cache(2);
+  std::vector<ModuleListCache::Module> modules;
+  cache.Insert(1, 1, MakeModules("a"));
+  cache.Insert(2, 1, MakeModules("b"));
+
+  // Replacing an entry makes it the most recently added.
+  cache.Insert(1, 2, MakeModules("a"));
+  cache.Insert(3, 1, MakeModules("c"));
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_TRUE(cache.Lookup(1, 2, &modules));
+  EXPECT_FALSE(cache.Lookup(2, 1, &modules));
+  EXPECT_TRUE(cache.Lookup(3, 1, &modules));
+
+  ModuleListCache disabled(0);
+  disabled.Insert(1, 1, MakeModules("a"));
+  EXPECT_EQ(disabled.size(), 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -17,18 +17,21 @@
 #include <elf.h>
 #include <errno.h>
 #include <sched.h>
+#include <stdio.h>
 #include <string.h>
 #include <sys/resource.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <utility>
 
+#include "base/check_op.h"
 #include "base/logging.h"
-#include "base/strings/stringprintf.h"
 #include "build/build_config.h"
 #include "snapshot/linux/debug_rendezvous.h"
 #include "util/linux/auxiliary_vector.h"
 #include "util/linux/proc_stat_reader.h"
+#include "util/thread/run_concurrently.h"
 
 #if BUILDFLAG(IS_ANDROID)
 #include <android/api-level.h>
@@ -47,42 +50,129 @@ bool ShouldMergeStackMappings(const MemoryMap::Mapping& stack_mapping,
           stack_mapping.name.empty() || adj_mapping.name.empty());
 }
 
+// Follows the chain of frame records beginning at frame_pointer, where each
+// record holds the caller's frame pointer followed by a return address. If
+// record_below_frame_pointer is true, each record ends at its frame pointer
+// rather than beginning there. Each record must lie within [stack_start,
+// stack_end), above the previous record, and hold a return address in
+// executable memory. Returns the address just past the outermost record if the
+// chain ends with a null frame pointer, or 0 if it has no records or can't be
+// followed to its end.
+template <typename Word>
+LinuxVMAddress FindFrameRecordsEnd(const ProcessMemory* memory,
+                                   const MemoryMap* memory_map,
+                                   LinuxVMAddress frame_pointer,
+                                   bool record_below_frame_pointer,
+                                   LinuxVMAddress stack_start,
+                                   LinuxVMAddress stack_end) {
+  struct FrameRecord {
+    Word frame_pointer;
+    Word return_address;
+  };
+
+  // Stops runaway walks through corrupt or cyclic-looking chains.
+  constexpr size_t kMaxFrames = 4096;
+
+  LinuxVMAddress records_end = 0;
+  for (size_t frame = 0; frame < kMaxFrames; ++frame) {
+    if (!frame_pointer) {
+      return records_end;
+    }
+
+    if (record_below_frame_pointer && frame_pointer < sizeof(FrameRecord)) {
+      return 0;
+    }
+    const LinuxVMAddress record_address =
+        record_below_frame_pointer ? frame_pointer - sizeof(FrameRecord)
+                                   : frame_pointer;
+    if (record_address % sizeof(Word) != 0 || record_address < stack_start ||
+        record_address >= stack_end ||
+        stack_end - record_address < sizeof(FrameRecord)) {
+      return 0;
+    }
+
+    FrameRecord record;
+    if (!memory->Read(record_address, sizeof(record), &record)) {
+      return 0;
+    }
+
+    const MemoryMap::Mapping* code_mapping =
+        memory_map->FindMapping(record.return_address);
+    if (!code_mapping || !code_mapping->executable) {
+      return 0;
+    }
+
+    records_end = record_address + sizeof(FrameRecord);
+    stack_start = records_end;
+    frame_pointer = record.frame_pointer;
+  }
+  return 0;
+}
+
 }  // namespace
 
 ProcessReaderLinux::Thread::Thread()
     : thread_info(),
+      extended_registers(),
       stack_region_address(0),
       stack_region_size(0),
       name(),
       tid(-1),
+      sched_policy(-1),
       static_priority(-1),
-      nice_value(-1) {}
+      nice_value(-1),
+      have_priorities(false),
+      scheduling_stats(),
+      have_scheduling_stats(false),
+      stat_contents() {}
 
 ProcessReaderLinux::Thread::~Thread() {}
 
+void ProcessReaderLinux::Thread::InitializeSchedulingStats(
+    const ProcTaskInfo& task) {
+  have_scheduling_stats = false;
+  if (stat_contents.empty()) {
+    return;
+  }
+
+  ProcStatReader stat;
+  timeval user_time;
+  timeval system_time;
+  if (!stat.InitializeWithContents(stat_contents) ||
+      !stat.UserCPUTime(&user_time) || !stat.SystemCPUTime(&system_time) ||
+      !stat.State(&scheduling_stats.state)) {
+    return;
+  }
+
+  int last_cpu;
+  scheduling_stats.last_cpu = stat.LastCPU(&last_cpu) ? last_cpu : -1;
+  scheduling_stats.user_time_us =
+      static_cast<uint64_t>(user_time.tv_sec) * 1000000 + user_time.tv_usec;
+  scheduling_stats.system_time_us =
+      static_cast<uint64_t>(system_time.tv_sec) * 1000000 +
+      system_time.tv_usec;
+  scheduling_stats.have_context_switches = task.have_context_switches;
+  scheduling_stats.voluntary_context_switches =
+      task.voluntary_context_switches;
+  scheduling_stats.involuntary_context_switches =
+      task.involuntary_context_switches;
+  have_scheduling_stats = true;
+}
+
 bool ProcessReaderLinux::Thread::InitializePtrace(
     PtraceConnection* connection) {
   if (!connection->GetThreadInfo(tid, &thread_info)) {
     return false;
   }
 
-  // From man proc(5):
-  //
-  // /proc/[pid]/comm (since Linux 2.6.33)
-  //
-  // Different threads in the same process may have different comm values,
-  // accessible via /proc/[pid]/task/[tid]/comm.
-  const std::string path = base::StringPrintf(
-      "/proc/%d/task/%d/comm", connection->GetProcessID(), tid);
-  if (connection->ReadFileContents(base::FilePath(path), &name)) {
-    if (!name.empty() && name.back() == '\n') {
-      // Remove the final newline character.
-      name.pop_back();
-    }
-  } else {
-    // Continue on without the thread name.
+  // The thread is still useful without its extended register state.
+  if (!connection->GetExtendedRegisterState(tid, &extended_registers)) {
+    extended_registers.Reset(ExtendedRegisterState::Format::kNone, 0);
   }
+  return true;
+}
 
+void ProcessReaderLinux::Thread::InitializePriorities() {
   // TODO(jperaza): Collect scheduling priorities via the broker when they can't
   // be collected directly.
   have_priorities = false;
@@ -93,14 +183,14 @@ bool ProcessReaderLinux::Thread::InitializePtrace(
   int res = sched_getscheduler(tid);
   if (res < 0) {
     PLOG(WARNING) << "sched_getscheduler";
-    return true;
+    return;
   }
   sched_policy = res;
 
   sched_param param;
   if (sched_getparam(tid, &param) != 0) {
     PLOG(WARNING) << "sched_getparam";
-    return true;
+    return;
   }
   static_priority = param.sched_priority;
 
@@ -108,12 +198,11 @@ bool ProcessReaderLinux::Thread::InitializePtrace(
   res = getpriority(PRIO_PROCESS, tid);
   if (res == -1 && errno) {
     PLOG(WARNING) << "getpriority";
-    return true;
+    return;
   }
   nice_value = res;
 
   have_priorities = true;
-  return true;
 }
 
 void ProcessReaderLinux::Thread::InitializeStack(ProcessReaderLinux* reader) {
@@ -135,6 +224,59 @@ void ProcessReaderLinux::Thread::InitializeStack(ProcessReaderLinux* reader) {
   InitializeStackFromSP(reader, stack_pointer);
 }
 
+void ProcessReaderLinux::Thread::TrimStack(ProcessReaderLinux* reader) {
+  if (!stack_region_size) {
+    return;
+  }
+
+  LinuxVMAddress frame_pointer;
+  bool record_below_frame_pointer = false;
+#if defined(ARCH_CPU_X86_FAMILY)
+  frame_pointer = reader->Is64Bit() ? thread_info.thread_context.t64.rbp
+                                    : thread_info.thread_context.t32.ebp;
+#elif defined(ARCH_CPU_ARM_FAMILY)
+  // 32-bit ARM code has no single frame record layout.
+  if (!reader->Is64Bit()) {
+    return;
+  }
+  frame_pointer = thread_info.thread_context.t64.regs[29];
+#elif defined(ARCH_CPU_RISCV64)
+  frame_pointer = thread_info.thread_context.t64.regs[7];
+  record_below_frame_pointer = true;
+#else
+  // Frame records aren't used consistently enough to be followed.
+  return;
+#endif
+  frame_pointer =
+      reader->connection_->Memory()->PointerToAddress(frame_pointer);
+
+  const LinuxVMAddress stack_end = stack_region_address + stack_region_size;
+  const LinuxVMAddress records_end =
+      reader->Is64Bit()
+          ? FindFrameRecordsEnd<uint64_t>(reader->Memory(),
+                                          reader->GetMemoryMap(),
+                                          frame_pointer,
+                                          record_below_frame_pointer,
+                                          stack_region_address,
+                                          stack_end)
+          : FindFrameRecordsEnd<uint32_t>(reader->Memory(),
+                                          reader->GetMemoryMap(),
+                                          frame_pointer,
+                                          record_below_frame_pointer,
+                                          stack_region_address,
+                                          stack_end);
+  if (!records_end) {
+    return;
+  }
+
+  // Keep some of the stack beyond the outermost frame record, which may hold
+  // that frame's arguments, or state saved by code that started the thread.
+  constexpr LinuxVMSize kTrimmedStackSlack = 512;
+  stack_region_size =
+      records_end + std::min(kTrimmedStackSlack, stack_end - records_end) -
+      stack_region_address;
+}
+
 void ProcessReaderLinux::Thread::InitializeStackFromSP(
     ProcessReaderLinux* reader,
     LinuxVMAddress stack_pointer) {
@@ -147,7 +289,7 @@ void ProcessReaderLinux::Thread::InitializeStackFromSP(
     return;
   }
   LinuxVMAddress stack_region_start =
-      reader->Memory()->PointerToAddress(stack_pointer);
+      reader->connection_->Memory()->PointerToAddress(stack_pointer);
 
   // We've hit what looks like a guard page; skip to the end and check for a
   // mapped stack region.
@@ -199,7 +341,7 @@ void ProcessReaderLinux::Thread::InitializeStackFromSP(
   // at the high-address end of the stack so we can try using that to shrink
   // the stack region.
   stack_region_size = stack_end - stack_region_address;
-  VMAddress tls_address = reader->Memory()->PointerToAddress(
+  VMAddress tls_address = reader->connection_->Memory()->PointerToAddress(
       thread_info.thread_specific_data_address);
   if (tid != reader->ProcessID() && tls_address > stack_region_address &&
       tls_address < stack_end) {
@@ -214,23 +356,60 @@ ProcessReaderLinux::Module::~Module() = default;
 
 ProcessReaderLinux::ProcessReaderLinux()
     : connection_(),
+      memory_(),
       process_info_(),
       memory_map_(),
+      pagemap_(),
       threads_(),
       modules_(),
       elf_readers_(),
+      elidable_module_ranges_(),
+      elf_image_cache_(nullptr),
+      module_list_cache_(nullptr),
+      thread_initialization_concurrency_(1),
+      stack_trimming_(false),
+      module_code_elision_(false),
+      module_identities_only_(false),
+      pagemap_initialization_attempted_(false),
+      pagemap_valid_(false),
+      pagemap_attached_(false),
       is_64_bit_(false),
       initialized_threads_(false),
       initialized_modules_(false),
+      initialized_elidable_module_ranges_(false),
       initialized_() {}
 
-ProcessReaderLinux::~ProcessReaderLinux() {}
+ProcessReaderLinux::~ProcessReaderLinux() {
+  // The connection may outlive this object, so it must not be left pointing
+  // at pagemap_.
+  if (pagemap_attached_) {
+    connection_->Memory()->SetPagemapReader(nullptr);
+  }
+}
 
 bool ProcessReaderLinux::Initialize(PtraceConnection* connection) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   DCHECK(connection);
   connection_ = connection;
 
+  if (!memory_.Initialize(connection_->Memory())) {
+    return false;
+  }
+
+  // These are all read while initializing or soon after, and connections that
+  // forward requests to a broker can read them together.
+  std::vector<base::FilePath> proc_files;
+  for (const char* name : {"status", "maps", "smaps", "auxv", "stat"}) {
+    char path[32];
+    snprintf(path,
+             sizeof(path),
+             "/proc/%d/%s",
+             connection_->GetProcessID(),
+             name);
+    proc_files.emplace_back(path);
+  }
+  connection_->PrefetchFileContents(proc_files);
+
   if (!process_info_.InitializeWithPtrace(connection_)) {
     return false;
   }
@@ -239,12 +418,42 @@ bool ProcessReaderLinux::Initialize(PtraceConnection* connection) {
     return false;
   }
 
+  // Without the flags, mappings the target excluded from core dumps can't be
+  // told apart, and are captured like any other.
+  memory_map_.ReadVmFlags();
+
   is_64_bit_ = process_info_.Is64Bit();
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
+void ProcessReaderLinux::SetSkipUnpopulatedMemory(bool enabled) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!enabled) {
+    if (pagemap_attached_) {
+      connection_->Memory()->SetPagemapReader(nullptr);
+      pagemap_attached_ = false;
+    }
+    return;
+  }
+
+  if (pagemap_attached_) {
+    return;
+  }
+
+  // A failure here leaves every page to be read as usual.
+  if (!pagemap_initialization_attempted_) {
+    pagemap_initialization_attempted_ = true;
+    pagemap_valid_ = pagemap_.Initialize(ProcessID(), &memory_map_);
+  }
+  if (!pagemap_valid_) {
+    return;
+  }
+  connection_->Memory()->SetPagemapReader(&pagemap_);
+  pagemap_attached_ = true;
+}
+
 bool ProcessReaderLinux::StartTime(timeval* start_time) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return process_info_.StartTime(start_time);
@@ -263,7 +472,9 @@ bool ProcessReaderLinux::CPUTimes(timeval* user_time,
 
   for (const Thread& thread : threads_) {
     ProcStatReader stat;
-    if (!stat.Initialize(connection_, thread.tid)) {
+    if (!(thread.stat_contents.empty()
+              ? stat.Initialize(connection_, thread.tid)
+              : stat.InitializeWithContents(thread.stat_contents))) {
       return false;
     }
 
@@ -302,6 +513,70 @@ const std::vector<ProcessReaderLinux::Module>& ProcessReaderLinux::Modules() {
   return modules_;
 }
 
+bool ProcessReaderLinux::IsElidableModuleRange(
+    const CheckedRange<uint64_t, uint64_t>& range) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!module_code_elision_ || range.size() == 0) {
+    return false;
+  }
+
+  const MemoryMap::Mapping* mapping = memory_map_.FindMapping(range.base());
+  if (!mapping || range.end() > mapping->range.End()) {
+    return false;
+  }
+
+  // Only code that the target can't have written without first changing the
+  // mapping's protection is assumed to match the module's file. Anonymous
+  // mappings have no file to match.
+  if (!mapping->readable || !mapping->executable || mapping->writable ||
+      mapping->inode == 0) {
+    return false;
+  }
+
+  if (!initialized_elidable_module_ranges_) {
+    InitializeElidableModuleRanges();
+  }
+
+  auto module_range = std::upper_bound(
+      elidable_module_ranges_.begin(),
+      elidable_module_ranges_.end(),
+      range.base(),
+      [](uint64_t address,
+         const CheckedRange<LinuxVMAddress, LinuxVMSize>& module_range) {
+        return address < module_range.base();
+      });
+  if (module_range == elidable_module_ranges_.begin()) {
+    return false;
+  }
+  --module_range;
+  return range.base() >= module_range->base() &&
+         range.end() <= module_range->end();
+}
+
+void ProcessReaderLinux::InitializeElidableModuleRanges() {
+  initialized_elidable_module_ranges_ = true;
+
+  for (const Module& module : Modules()) {
+    std::string build_id;
+    if (!module.elf_reader || !module.elf_reader->GetBuildID(&build_id) ||
+        build_id.empty()) {
+      continue;
+    }
+    CheckedRange<LinuxVMAddress, LinuxVMSize> module_range(
+        module.elf_reader->Address(), module.elf_reader->Size());
+    if (module_range.IsValid()) {
+      elidable_module_ranges_.push_back(module_range);
+    }
+  }
+
+  std::sort(elidable_module_ranges_.begin(),
+            elidable_module_ranges_.end(),
+            [](const CheckedRange<LinuxVMAddress, LinuxVMSize>& a,
+               const CheckedRange<LinuxVMAddress, LinuxVMSize>& b) {
+              return a.base() < b.base();
+            });
+}
+
 void ProcessReaderLinux::InitializeAbortMessage() {
 #if BUILDFLAG(IS_ANDROID)
   const MemoryMap::Mapping* mapping =
@@ -391,34 +666,83 @@ void ProcessReaderLinux::InitializeThreads() {
     return;
   }
 
+  std::vector<Thread> threads;
+
   Thread main_thread;
   main_thread.tid = pid;
   if (main_thread.InitializePtrace(connection_)) {
-    main_thread.InitializeStack(this);
-    threads_.push_back(main_thread);
+    threads.push_back(main_thread);
   } else {
     LOG(WARNING) << "Couldn't initialize main thread.";
   }
 
+  // Thread names and stat files are collected for every thread at once, rather
+  // than with a request per file from each thread.
   bool main_thread_found = false;
-  std::vector<pid_t> thread_ids;
-  bool result = connection_->Threads(&thread_ids);
+  std::vector<ProcTaskInfo> tasks;
+  bool result = connection_->ReadThreadDetails(&tasks);
   DCHECK(result);
-  for (pid_t tid : thread_ids) {
-    if (tid == pid) {
+
+  // The other threads are attached all at once, so that the time taken to
+  // stop them doesn't grow with each thread.
+  std::vector<pid_t> tids;
+  tids.reserve(tasks.size());
+  for (ProcTaskInfo& task : tasks) {
+    if (task.tid == pid) {
       DCHECK(!main_thread_found);
       main_thread_found = true;
+      if (!threads.empty() && threads[0].tid == pid) {
+        threads[0].name = std::move(task.name);
+        threads[0].stat_contents = std::move(task.stat);
+        threads[0].InitializeSchedulingStats(task);
+      }
+      continue;
+    }
+    tids.push_back(task.tid);
+  }
+  DCHECK(main_thread_found);
+
+  std::vector<bool> attached(tids.size(), false);
+  connection_->AttachThreads(tids, &attached);
+
+  size_t tid_index = 0;
+  for (ProcTaskInfo& task : tasks) {
+    if (task.tid == pid) {
       continue;
     }
+    DCHECK_EQ(task.tid, tids[tid_index]);
 
     Thread thread;
-    thread.tid = tid;
-    if (connection_->Attach(tid) && thread.InitializePtrace(connection_)) {
-      thread.InitializeStack(this);
-      threads_.push_back(thread);
+    thread.tid = task.tid;
+    if (attached[tid_index++] && thread.InitializePtrace(connection_)) {
+      thread.name = std::move(task.name);
+      thread.stat_contents = std::move(task.stat);
+      thread.InitializeSchedulingStats(task);
+      threads.push_back(std::move(thread));
     }
   }
-  DCHECK(main_thread_found);
+
+  InitializeThreadDetails(&threads);
+  threads_ = std::move(threads);
+}
+
+void ProcessReaderLinux::InitializeThreadDetails(std::vector<Thread>* threads) {
+  // Results are written in place, so the order of threads is unaffected.
+  // Trimming stacks reads memory, which must then be done on one thread unless
+  // the target's memory may be read concurrently.
+  const bool trim_stacks = stack_trimming_;
+  RunConcurrently(threads->size(),
+                  trim_stacks && !SupportsConcurrentMemoryReads()
+                      ? 1
+                      : thread_initialization_concurrency_,
+                  [this, threads, trim_stacks](size_t index) {
+                    Thread& thread = (*threads)[index];
+                    thread.InitializePriorities();
+                    thread.InitializeStack(this);
+                    if (trim_stacks) {
+                      thread.TrimStack(this);
+                    }
+                  });
 }
 
 void ProcessReaderLinux::InitializeModules() {
@@ -440,6 +764,18 @@ void ProcessReaderLinux::InitializeModules() {
     return;
   }
 
+  uint64_t fingerprint = 0;
+  if (module_list_cache_) {
+    fingerprint = memory_map_.FileMappingFingerprint();
+    std::vector<ModuleListCache::Module> cached_modules;
+    if (module_list_cache_->Lookup(
+            ProcessID(), fingerprint, &cached_modules) &&
+        InitializeModulesFromCache(range, cached_modules)) {
+      return;
+    }
+  }
+  std::vector<ModuleListCache::Module> found_modules;
+
   // The strategy used for identifying loaded modules depends on ELF files
   // conventionally loading their header and program headers into memory.
   // Locating the correct module could fail if the headers aren't mapped, are
@@ -485,6 +821,8 @@ void ProcessReaderLinux::InitializeModules() {
     return;
   }
 
+  exe_reader->SetCache(elf_image_cache_);
+
   Module exe = {};
   exe.name = !debug.Executable()->name.empty() ? debug.Executable()->name
                                                : exe_mapping->name;
@@ -492,6 +830,7 @@ void ProcessReaderLinux::InitializeModules() {
   exe.type = ModuleSnapshot::ModuleType::kModuleTypeExecutable;
 
   modules_.push_back(exe);
+  found_modules.push_back({exe.name, exe_mapping->range.Base(), exe.type});
   elf_readers_.push_back(std::move(exe_reader));
 
   LinuxVMAddress loader_base = 0;
@@ -545,9 +884,12 @@ void ProcessReaderLinux::InitializeModules() {
       }
     }
 
+    elf_reader->SetCache(elf_image_cache_);
+
     Module module = {};
     std::string soname;
-    if (elf_reader->SoName(&soname) && !soname.empty()) {
+    if (!module_identities_only_ && elf_reader->SoName(&soname) &&
+        !soname.empty()) {
       module.name = soname;
     } else {
       module.name = !entry.name.empty() ? entry.name : module_mapping->name;
@@ -557,8 +899,42 @@ void ProcessReaderLinux::InitializeModules() {
                       ? ModuleSnapshot::kModuleTypeDynamicLoader
                       : ModuleSnapshot::kModuleTypeSharedLibrary;
     modules_.push_back(module);
+    found_modules.push_back(
+        {module.name, module_mapping->range.Base(), module.type});
     elf_readers_.push_back(std::move(elf_reader));
   }
+
+  // Modules named without their DT_SONAME aren’t cached, so that later readers
+  // of the same process don’t name them differently.
+  if (module_list_cache_ && !module_identities_only_) {
+    module_list_cache_->Insert(ProcessID(), fingerprint, found_modules);
+  }
+}
+
+bool ProcessReaderLinux::InitializeModulesFromCache(
+    const ProcessMemoryRange& range,
+    const std::vector<ModuleListCache::Module>& cached_modules) {
+  DCHECK(modules_.empty());
+  for (const ModuleListCache::Module& cached_module : cached_modules) {
+    auto elf_reader = std::make_unique<ElfImageReader>();
+    if (!elf_reader->Initialize(
+            range, cached_module.header_address, /* verbose= */ false)) {
+      // The fingerprint matched but the image is no longer where it was.
+      // Locate every module again rather than produce a partial list.
+      modules_.clear();
+      elf_readers_.clear();
+      return false;
+    }
+    elf_reader->SetCache(elf_image_cache_);
+
+    Module module = {};
+    module.name = cached_module.name;
+    module.elf_reader = elf_reader.get();
+    module.type = cached_module.type;
+    modules_.push_back(module);
+    elf_readers_.push_back(std::move(elf_reader));
+  }
+  return true;
 }
 
 }  // namespace crashpad
@@ -22,15 +22,22 @@
 #include <string>
 #include <vector>
 
+#include "snapshot/elf/elf_image_cache.h"
 #include "snapshot/elf/elf_image_reader.h"
+#include "snapshot/linux/module_list_cache.h"
 #include "snapshot/module_snapshot.h"
+#include "snapshot/thread_snapshot.h"
 #include "util/linux/address_types.h"
 #include "util/linux/memory_map.h"
+#include "util/linux/pagemap_reader.h"
 #include "util/linux/ptrace_connection.h"
 #include "util/linux/thread_info.h"
+#include "util/misc/extended_register_state.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/numeric/checked_range.h"
 #include "util/posix/process_info.h"
 #include "util/process/process_memory.h"
+#include "util/process/process_memory_cached.h"
 
 namespace crashpad {
 
@@ -58,6 +65,11 @@ class ProcessReaderLinux {
                                LinuxVMAddress stack_pointer);
 
     ThreadInfo thread_info;
+
+    //! \brief Register state beyond what \a thread_info holds, such as AVX or
+    //!     SVE registers.
+    ExtendedRegisterState extended_registers;
+
     LinuxVMAddress stack_region_address;
     LinuxVMSize stack_region_size;
     std::string name;
@@ -70,11 +82,25 @@ class ProcessReaderLinux {
     //!     all valid.
     bool have_priorities;
 
+    //! \brief The thread's CPU usage and scheduling state, from the `stat` and
+    //!     `status` files read along with its name.
+    ThreadSchedulingStats scheduling_stats;
+
+    //! \brief `true` if `scheduling_stats` is valid.
+    bool have_scheduling_stats;
+
    private:
     friend class ProcessReaderLinux;
 
     bool InitializePtrace(PtraceConnection* connection);
+    void InitializePriorities();
+    void InitializeSchedulingStats(const ProcTaskInfo& task);
     void InitializeStack(ProcessReaderLinux* reader);
+    void TrimStack(ProcessReaderLinux* reader);
+
+    // The contents of the thread's stat file, read along with its name so that
+    // CPUTimes() doesn't need to read it again.
+    std::string stat_contents;
   };
 
   //! \brief Contains information about a module loaded into a process.
@@ -114,6 +140,128 @@ class ProcessReaderLinux {
   //! \return `true` on success. `false` on failure with a message logged.
   bool Initialize(PtraceConnection* connection);
 
+  //! \brief Sets the maximum number of threads that may be used to gather
+  //!     information about the target process' threads.
+  //!
+  //! Thread registers are always collected by the thread that called
+  //! Initialize(), because `ptrace` requests must be made from the thread that
+  //! attached to the target, and thread names are read along with the list of
+  //! threads. The remaining per-thread work, such as reading scheduling
+  //! information and locating stacks, is distributed
+  //! across as many as \a concurrency threads, including the calling thread.
+  //! Threads() returns threads in the same order regardless of the concurrency
+  //! used.
+  //!
+  //! The default concurrency is 1, which performs all work on the calling
+  //! thread. This method has no effect once Threads() has been called.
+  //!
+  //! \param[in] concurrency The maximum number of threads to use. Values less
+  //!     than 1 are treated as 1.
+  void SetThreadInitializationConcurrency(size_t concurrency) {
+    thread_initialization_concurrency_ = concurrency;
+  }
+
+  //! \brief Enables trimming each thread's stack to its live frames.
+  //!
+  //! By default, a thread's stack extends from its stack pointer to the end of
+  //! its stack mapping, most of which may belong to frames that have already
+  //! returned. When enabled, the chain of frame records is followed from each
+  //! thread's frame pointer, and if it ends cleanly, the stack is trimmed to
+  //! just past the outermost record. Stacks whose chains can't be followed to
+  //! their end are not trimmed. This is only useful for targets built with
+  //! frame pointers; a chain passing through code that uses the frame pointer
+  //! register for other purposes could end early and trim live frames.
+  //!
+  //! This method has no effect once Threads() has been called.
+  //!
+  //! \param[in] enabled Whether stacks should be trimmed.
+  void SetStackTrimming(bool enabled) { stack_trimming_ = enabled; }
+
+  //! \brief Enables eliding memory that lies in unmodified module code.
+  //!
+  //! Memory captured around the program counter and other pointer-like values
+  //! is often module code, identical in every report to the bytes in the
+  //! module's file. When enabled, IsElidableModuleRange() identifies such
+  //! ranges so that they can be left out of a snapshot. A module's base
+  //! address, size, and build ID are captured with the module, which is enough
+  //! for a consumer with access to the module's file to recover its code.
+  //!
+  //! \param[in] enabled Whether unmodified module code may be elided.
+  void SetModuleCodeElision(bool enabled) { module_code_elision_ = enabled; }
+
+  //! \brief Determines whether \a range may be left out of a snapshot because
+  //!     it is unmodified module code.
+  //!
+  //! A range is elidable if module code elision is enabled, it lies entirely
+  //! within a single file-backed mapping that is readable and executable but
+  //! not writable, and that mapping lies within a module with a build ID.
+  //! Writable mappings and anonymous executable mappings, such as JIT code,
+  //! are never elided.
+  //!
+  //! This method is not safe to call concurrently with itself.
+  //!
+  //! \param[in] range The range in the target process' address space.
+  //! \return `true` if \a range need not be captured.
+  bool IsElidableModuleRange(const CheckedRange<uint64_t, uint64_t>& range);
+
+  //! \brief Sets a cache of ELF image information to share with other
+  //!     readers.
+  //!
+  //! Each module's ElfImageReader consults \a cache. See
+  //! ElfImageReader::SetCache(). This has no effect once Modules() has been
+  //! called.
+  //!
+  //! \param[in] cache The cache to use, which must outlive this object, or
+  //!     `nullptr` to read every module from the target.
+  void SetElfImageCache(ElfImageCache* cache) { elf_image_cache_ = cache; }
+
+  //! \brief Sets a cache of module lists to share with later readers of the
+  //!     same process.
+  //!
+  //! When the target's file mappings are unchanged since its modules were
+  //! last located, Modules() reads each module's headers at its cached
+  //! address instead of searching the link map and memory map again. See
+  //! ModuleListCache. This has no effect once Modules() has been called.
+  //!
+  //! \param[in] cache The cache to use, which must outlive this object, or
+  //!     `nullptr` to always locate modules from scratch.
+  void SetModuleListCache(ModuleListCache* cache) {
+    module_list_cache_ = cache;
+  }
+
+  //! \brief Limits the reading of each module to what identifies it.
+  //!
+  //! Modules are located as usual, reading each one’s ELF header and program
+  //! header table, but shared libraries are named as the dynamic linker lists
+  //! them rather than by their `DT_SONAME`, so their dynamic arrays and string
+  //! tables aren’t read. Module lists located this way aren’t added to the
+  //! module list cache. This has no effect once Modules() has been called.
+  //!
+  //! \param[in] enabled Whether to read only module identities.
+  void SetModuleIdentitiesOnly(bool enabled) {
+    module_identities_only_ = enabled;
+  }
+
+  //! \brief Enables skipping pages of the target that have never been
+  //!     populated.
+  //!
+  //! When enabled, Memory() consults the target's `/proc/pid/pagemap` file,
+  //! reporting never-faulted pages of private anonymous mappings through
+  //! ProcessMemory::UnpopulatedRanges(). Such pages read as zeroes and need not
+  //! be read from the target at all. If the pagemap file can't be opened, such
+  //! as when the target is only accessible through a broker, no pages are
+  //! reported and every page is read as usual.
+  //!
+  //! This must be called after Initialize().
+  //!
+  //! \param[in] enabled Whether unpopulated pages should be skipped.
+  void SetSkipUnpopulatedMemory(bool enabled);
+
+  //! \brief Returns `true` if Memory() reports pages that have never been
+  //!     populated, which requires that SetSkipUnpopulatedMemory() enabled
+  //!     this and that the target's pagemap file could be opened.
+  bool SkipsUnpopulatedMemory() const { return pagemap_attached_; }
+
   //! \brief Return `true` if the target task is a 64-bit process.
   bool Is64Bit() const { return is_64_bit_; }
 
@@ -124,7 +272,16 @@ class ProcessReaderLinux {
   pid_t ParentProcessID() const { return process_info_.ParentProcessID(); }
 
   //! \brief Return a memory reader for the target process.
-  const ProcessMemoryLinux* Memory() const { return connection_->Memory(); }
+  //!
+  //! Reads are cached for the lifetime of this object, which assumes that the
+  //! target process is suspended while it is being read.
+  const ProcessMemoryCached* Memory() const { return &memory_; }
+
+  //! \brief Returns `true` if Memory() may be read from several threads at
+  //!     once.
+  bool SupportsConcurrentMemoryReads() const {
+    return connection_->Memory()->SupportsConcurrentReads();
+  }
 
   //! \brief Return a memory map of the target process.
   MemoryMap* GetMemoryMap() { return &memory_map_; }
@@ -163,21 +320,42 @@ class ProcessReaderLinux {
 
  private:
   void InitializeThreads();
+  void InitializeThreadDetails(std::vector<Thread>* threads);
   void InitializeModules();
+  bool InitializeModulesFromCache(
+      const ProcessMemoryRange& range,
+      const std::vector<ModuleListCache::Module>& cached_modules);
   void InitializeAbortMessage();
+  void InitializeElidableModuleRanges();
   template <bool Is64Bit>
   void ReadAbortMessage(const MemoryMap::Mapping* mapping);
 
   PtraceConnection* connection_;  // weak
+  ProcessMemoryCached memory_;
   ProcessInfo process_info_;
   MemoryMap memory_map_;
+  PagemapReader pagemap_;
   std::vector<Thread> threads_;
   std::vector<Module> modules_;
   std::string abort_message_;
   std::vector<std::unique_ptr<ElfImageReader>> elf_readers_;
+
+  // The address ranges of modules with build IDs, sorted by base address.
+  std::vector<CheckedRange<LinuxVMAddress, LinuxVMSize>>
+      elidable_module_ranges_;
+  ElfImageCache* elf_image_cache_;  // weak
+  ModuleListCache* module_list_cache_;  // weak
+  size_t thread_initialization_concurrency_;
+  bool stack_trimming_;
+  bool module_code_elision_;
+  bool module_identities_only_;
+  bool pagemap_initialization_attempted_;
+  bool pagemap_valid_;
+  bool pagemap_attached_;
   bool is_64_bit_;
   bool initialized_threads_;
   bool initialized_modules_;
+  bool initialized_elidable_module_ranges_;
   InitializationStateDcheck initialized_;
 };
 
@@ -52,6 +52,7 @@
 #include "util/misc/address_sanitizer.h"
 #include "util/misc/from_pointer_cast.h"
 #include "util/misc/memory_sanitizer.h"
+#include "util/posix/scoped_mmap.h"
 #include "util/synchronization/semaphore.h"
 
 #if BUILDFLAG(IS_ANDROID)
@@ -328,8 +329,15 @@ void ExpectThreads(const ThreadMap& thread_map,
 
 class ChildThreadTest : public Multiprocess {
  public:
-  ChildThreadTest(size_t stack_size = 0)
-      : Multiprocess(), stack_size_(stack_size) {}
+  ChildThreadTest(size_t stack_size = 0,
+                  size_t concurrency = 1,
+                  bool trim_stacks = false,
+                  bool attach_all_threads = false)
+      : Multiprocess(),
+        stack_size_(stack_size),
+        concurrency_(concurrency),
+        trim_stacks_(trim_stacks),
+        attach_all_threads_(attach_all_threads) {}
 
   ChildThreadTest(const ChildThreadTest&) = delete;
   ChildThreadTest& operator=(const ChildThreadTest&) = delete;
@@ -361,12 +369,19 @@ class ChildThreadTest : public Multiprocess {
 
     DirectPtraceConnection connection;
     ASSERT_TRUE(connection.Initialize(ChildPID()));
+    if (attach_all_threads_) {
+      ASSERT_TRUE(connection.AttachAllThreads());
+    }
 
     ProcessReaderLinux process_reader;
     ASSERT_TRUE(process_reader.Initialize(&connection));
+    process_reader.SetThreadInitializationConcurrency(concurrency_);
+    process_reader.SetStackTrimming(trim_stacks_);
     const std::vector<ProcessReaderLinux::Thread>& threads =
         process_reader.Threads();
     ExpectThreads(thread_map, thread_name_map, threads, &connection);
+    ASSERT_FALSE(threads.empty());
+    EXPECT_EQ(threads[0].tid, ChildPID());
   }
 
   void MultiprocessChild() override {
@@ -431,6 +446,9 @@ class ChildThreadTest : public Multiprocess {
 
   static constexpr size_t kThreadCount = 3;
   const size_t stack_size_;
+  const size_t concurrency_;
+  const bool trim_stacks_;
+  const bool attach_all_threads_;
 };
 
 TEST(ProcessReaderLinux, ChildWithThreads) {
@@ -438,6 +456,28 @@ TEST(ProcessReaderLinux, ChildWithThreads) {
   test.Run();
 }
 
+// Threads that were attached before the reader was initialized are still read.
+TEST(ProcessReaderLinux, ChildWithThreadsAttachedUpFront) {
+  ChildThreadTest test(/* stack_size= */ 0,
+                       /* concurrency= */ 1,
+                       /* trim_stacks= */ false,
+                       /* attach_all_threads= */ true);
+  test.Run();
+}
+
+TEST(ProcessReaderLinux, ChildWithThreadsConcurrentInitialization) {
+  ChildThreadTest test(/* stack_size= */ 0, /* concurrency= */ 3);
+  test.Run();
+}
+
+// Trimmed stacks must still contain every thread's live frames, which
+// ExpectThreads() checks by looking for the address of a local variable.
+TEST(ProcessReaderLinux, ChildWithThreadsTrimmedStacks) {
+  ChildThreadTest test(
+      /* stack_size= */ 0, /* concurrency= */ 3, /* trim_stacks= */ true);
+  test.Run();
+}
+
 TEST(ProcessReaderLinux, ChildThreadsWithSmallUserStacks) {
   ChildThreadTest test(PTHREAD_STACK_MIN);
   test.Run();
@@ -639,6 +679,223 @@ TEST(ProcessReaderLinux, SelfModules) {
 #endif  // !ADDRESS_SANITIZER && !MEMORY_SANITIZER
 }
 
+TEST(ProcessReaderLinux, SelfModulesCached) {
+  FakePtraceConnection connection;
+  connection.Initialize(getpid());
+
+  ModuleListCache cache;
+  std::vector<ModuleListCache::Module> cached_modules;
+  {
+    ProcessReaderLinux process_reader;
+    ASSERT_TRUE(process_reader.Initialize(&connection));
+    process_reader.SetModuleListCache(&cache);
+    ExpectModulesFromSelf(process_reader.Modules());
+    EXPECT_EQ(cache.size(), 1u);
+
+    ASSERT_TRUE(cache.Lookup(
+        getpid(),
+        process_reader.GetMemoryMap()->FileMappingFingerprint(),
+        &cached_modules));
+    ASSERT_EQ(cached_modules.size(), process_reader.Modules().size());
+    for (size_t index = 0; index < cached_modules.size(); ++index) {
+      EXPECT_EQ(cached_modules[index].name,
+                process_reader.Modules()[index].name);
+      EXPECT_EQ(cached_modules[index].type,
+                process_reader.Modules()[index].type);
+    }
+  }
+
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection));
+  process_reader.SetModuleListCache(&cache);
+
+  // Mark the cached executable so that it's evident that the second reader's
+  // module list came from the cache.
+  cached_modules[0].name = "cached_executable";
+  cache.Insert(getpid(),
+               process_reader.GetMemoryMap()->FileMappingFingerprint(),
+               cached_modules);
+
+  const std::vector<ProcessReaderLinux::Module>& modules =
+      process_reader.Modules();
+  ASSERT_EQ(modules.size(), cached_modules.size());
+  EXPECT_EQ(modules[0].name, "cached_executable");
+  for (size_t index = 0; index < modules.size(); ++index) {
+    ASSERT_TRUE(modules[index].elf_reader);
+    EXPECT_EQ(modules[index].type, cached_modules[index].type);
+  }
+
+  // A stale fingerprint is ignored.
+  ProcessReaderLinux uncached_reader;
+  ASSERT_TRUE(uncached_reader.Initialize(&connection));
+  ModuleListCache other_cache;
+  other_cache.Insert(getpid(), 0, cached_modules);
+  uncached_reader.SetModuleListCache(&other_cache);
+  ASSERT_FALSE(uncached_reader.Modules().empty());
+  EXPECT_NE(uncached_reader.Modules()[0].name, "cached_executable");
+}
+
+TEST(ProcessReaderLinux, SelfModuleIdentitiesOnly) {
+#if !defined(ADDRESS_SANITIZER) && !defined(MEMORY_SANITIZER)
+  const std::string module_name = "test_module.so";
+  const std::string module_soname = "test_module_soname";
+  ScopedModuleHandle empty_test_module(
+      LoadTestModule(module_name, module_soname));
+  ASSERT_TRUE(empty_test_module.valid());
+#endif  // !ADDRESS_SANITIZER && !MEMORY_SANITIZER
+
+  FakePtraceConnection connection;
+  connection.Initialize(getpid());
+
+  ProcessReaderLinux full_reader;
+  ASSERT_TRUE(full_reader.Initialize(&connection));
+
+  ModuleListCache cache;
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection));
+  process_reader.SetModuleListCache(&cache);
+  process_reader.SetModuleIdentitiesOnly(true);
+
+  const std::vector<ProcessReaderLinux::Module>& modules =
+      process_reader.Modules();
+  ExpectModulesFromSelf(modules);
+  EXPECT_EQ(cache.size(), 0u);
+
+  // The same modules are found, with the same identities.
+  const std::vector<ProcessReaderLinux::Module>& full_modules =
+      full_reader.Modules();
+  ASSERT_EQ(modules.size(), full_modules.size());
+  for (size_t index = 0; index < modules.size(); ++index) {
+    ASSERT_TRUE(modules[index].elf_reader);
+    ASSERT_TRUE(full_modules[index].elf_reader);
+    EXPECT_EQ(modules[index].type, full_modules[index].type);
+    EXPECT_EQ(modules[index].elf_reader->Address(),
+              full_modules[index].elf_reader->Address());
+    EXPECT_EQ(modules[index].elf_reader->Size(),
+              full_modules[index].elf_reader->Size());
+    std::string build_id;
+    std::string full_build_id;
+    EXPECT_EQ(modules[index].elf_reader->GetBuildID(&build_id),
+              full_modules[index].elf_reader->GetBuildID(&full_build_id));
+    EXPECT_EQ(build_id, full_build_id);
+  }
+
+#if !defined(ADDRESS_SANITIZER) && !defined(MEMORY_SANITIZER)
+  // The test module is named by its path rather than its DT_SONAME.
+  bool found_module = false;
+  for (const auto& module : modules) {
+    EXPECT_EQ(module.name.find(module_soname), std::string::npos);
+    if (module.name.find(module_name) != std::string::npos) {
+      found_module = true;
+    }
+  }
+  EXPECT_TRUE(found_module);
+#endif  // !ADDRESS_SANITIZER && !MEMORY_SANITIZER
+}
+
+TEST(ProcessReaderLinux, SelfModuleCodeElision) {
+  FakePtraceConnection connection;
+  connection.Initialize(getpid());
+
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection));
+
+  // Some code in the module containing dlopen(), which is file-backed and
+  // read-only.
+  const LinuxVMAddress code_address = FromPointerCast<LinuxVMAddress>(dlopen);
+  const MemoryMap::Mapping* code_mapping =
+      process_reader.GetMemoryMap()->FindMapping(code_address);
+  ASSERT_TRUE(code_mapping);
+  ASSERT_TRUE(code_mapping->executable);
+  const CheckedRange<uint64_t, uint64_t> code_range(
+      code_mapping->range.Base(), code_mapping->range.Size());
+
+  EXPECT_FALSE(process_reader.IsElidableModuleRange(code_range));
+
+  process_reader.SetModuleCodeElision(true);
+
+  std::string build_id;
+  for (const auto& module : process_reader.Modules()) {
+    if (module.elf_reader &&
+        CheckedRange<uint64_t, uint64_t>(module.elf_reader->Address(),
+                                         module.elf_reader->Size())
+            .ContainsValue(code_address)) {
+      if (!module.elf_reader->GetBuildID(&build_id)) {
+        build_id.clear();
+      }
+      break;
+    }
+  }
+  EXPECT_EQ(process_reader.IsElidableModuleRange(code_range),
+            !build_id.empty());
+
+  // Ranges that extend past the mapping, empty ranges, the stack, and data are
+  // never elided.
+  EXPECT_FALSE(process_reader.IsElidableModuleRange(
+      CheckedRange<uint64_t, uint64_t>(code_range.base(),
+                                       code_range.size() + 1)));
+  EXPECT_FALSE(process_reader.IsElidableModuleRange(
+      CheckedRange<uint64_t, uint64_t>(code_range.base(), 0)));
+
+  char stack_variable;
+  EXPECT_FALSE(process_reader.IsElidableModuleRange(
+      CheckedRange<uint64_t, uint64_t>(
+          FromPointerCast<LinuxVMAddress>(&stack_variable), 1)));
+
+  EXPECT_FALSE(process_reader.IsElidableModuleRange(
+      CheckedRange<uint64_t, uint64_t>(
+          FromPointerCast<LinuxVMAddress>(kTestMemory), sizeof(kTestMemory))));
+}
+
+TEST(ProcessReaderLinux, SelfSkipUnpopulatedMemory) {
+  // An untouched anonymous mapping, except for its first page.
+  const size_t page_size = getpagesize();
+  constexpr size_t kPages = 4;
+  ScopedMmap mapping;
+  ASSERT_TRUE(mapping.ResetMmap(nullptr,
+                                kPages * page_size,
+                                PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1,
+                                0));
+  mapping.addr_as<char*>()[0] = 'x';
+  const LinuxVMAddress address =
+      FromPointerCast<LinuxVMAddress>(mapping.addr());
+
+  FakePtraceConnection connection;
+  connection.Initialize(getpid());
+
+  ProcessReaderLinux process_reader;
+  ASSERT_TRUE(process_reader.Initialize(&connection));
+
+  std::vector<CheckedRange<VMAddress, VMSize>> ranges;
+  process_reader.Memory()->UnpopulatedRanges(
+      address, kPages * page_size, &ranges);
+  EXPECT_TRUE(ranges.empty());
+  EXPECT_FALSE(process_reader.SkipsUnpopulatedMemory());
+
+  process_reader.SetSkipUnpopulatedMemory(true);
+  ASSERT_TRUE(process_reader.SkipsUnpopulatedMemory());
+  process_reader.Memory()->UnpopulatedRanges(
+      address, kPages * page_size, &ranges);
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].base(), address + page_size);
+  EXPECT_EQ(ranges[0].size(), (kPages - 1) * page_size);
+
+  // Unpopulated pages still read as zeroes.
+  char buffer[2];
+  ASSERT_TRUE(process_reader.Memory()->Read(
+      address + page_size - 1, sizeof(buffer), buffer));
+  EXPECT_EQ(buffer[0], '\0');
+  EXPECT_EQ(buffer[1], '\0');
+
+  process_reader.SetSkipUnpopulatedMemory(false);
+  EXPECT_FALSE(process_reader.SkipsUnpopulatedMemory());
+  process_reader.Memory()->UnpopulatedRanges(
+      address, kPages * page_size, &ranges);
+  EXPECT_TRUE(ranges.empty());
+}
+
 class ChildModuleTest : public Multiprocess {
  public:
   ChildModuleTest() : Multiprocess(), module_soname_("test_module_soname") {}
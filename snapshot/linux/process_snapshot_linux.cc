@@ -14,39 +14,118 @@
 
 #include "snapshot/linux/process_snapshot_linux.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <set>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "util/linux/exception_information.h"
+#include "util/misc/clock.h"
+#include "util/misc/trace_event.h"
+#include "util/thread/run_concurrently.h"
 
 namespace crashpad {
 
-ProcessSnapshotLinux::ProcessSnapshotLinux() = default;
+namespace {
+
+constexpr char kCaptureSkippedKey[] = "crashpad_capture_skipped";
+
+}  // namespace
+
+ProcessSnapshotLinux::ProcessSnapshotLinux()
+    : ProcessSnapshot(),
+      capture_deadline_ns_(0),
+      capture_soft_deadline_ns_(0),
+      module_initialization_concurrency_(1),
+      indirect_memory_depth_(1),
+      max_thread_stacks_(std::numeric_limits<size_t>::max()),
+      indirect_memory_limit_(std::numeric_limits<uint32_t>::max()),
+      thread_filter_(),
+      modules_ready_callback_(),
+      module_identities_only_(false),
+      lightweight_(false),
+      lightweight_annotation_list_address_(0),
+      lightweight_since_generation_(0) {}
 
 ProcessSnapshotLinux::~ProcessSnapshotLinux() = default;
 
 bool ProcessSnapshotLinux::Initialize(PtraceConnection* connection) {
+  CRASHPAD_TRACE_EVENT("capture", "ProcessSnapshotLinux::Initialize");
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
+  UpdateCaptureSoftDeadline();
+
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
     PLOG(ERROR) << "gettimeofday";
     return false;
   }
 
-  if (!process_reader_.Initialize(connection) ||
-      !memory_range_.Initialize(process_reader_.Memory(),
-                                process_reader_.Is64Bit())) {
-    return false;
+  {
+    ScopedCapturePhase capture_phase(
+        &capture_timings_, CapturePhase::kMemoryMaps, connection->Memory());
+    if (!process_reader_.Initialize(connection) ||
+        !memory_range_.Initialize(process_reader_.Memory(),
+                                  process_reader_.Is64Bit())) {
+      return false;
+    }
   }
 
   client_id_.InitializeToZero();
   system_.Initialize(&process_reader_, &snapshot_time_);
 
-  InitializeModules();
-  GetCrashpadOptionsInternal((&options_));
+  {
+    ScopedCapturePhase capture_phase(
+        &capture_timings_, CapturePhase::kModules, process_reader_.Memory());
+    InitializeModules();
+    GetCrashpadOptionsInternal((&options_));
+  }
+  if (modules_ready_callback_) {
+    const uint64_t capture_deadline_ns = capture_deadline_ns_;
+    std::vector<const ModuleSnapshot*> modules;
+    modules.reserve(modules_.size());
+    for (const auto& module : modules_) {
+      modules.push_back(module.get());
+    }
+    modules_ready_callback_(this, modules);
+    modules_ready_callback_ = nullptr;
+    if (capture_deadline_ns_ != capture_deadline_ns) {
+      UpdateCaptureSoftDeadline();
+    }
+  }
+  if (lightweight_) {
+    ApplyLightweightCapture();
+  }
+  options_.indirectly_referenced_memory_cap = std::min(
+      options_.indirectly_referenced_memory_cap, indirect_memory_limit_);
   InitializeThreads();
-  InitializeAnnotations();
+  // A lightweight snapshot holds no memory besides the exception thread's
+  // stack.
+  if (!lightweight_) {
+    if (HaveCaptureTime()) {
+      InitializeExtraMemory();
+    } else {
+      RecordCaptureSkipped("extra_memory");
+    }
+  }
+  {
+    ScopedCapturePhase capture_phase(&capture_timings_,
+                                     CapturePhase::kAnnotations,
+                                     process_reader_.Memory());
+    InitializeAnnotations();
+  }
+
+  // Module annotations are read while the snapshot is written, so they are
+  // dropped here if there's no time left for them.
+  if (!HaveCaptureTime()) {
+    for (auto& module : modules_) {
+      module->DisableAnnotations();
+    }
+    RecordCaptureSkipped("module_annotations");
+  }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -68,13 +147,23 @@ pid_t ProcessSnapshotLinux::FindThreadWithStackAddress(
 
 bool ProcessSnapshotLinux::InitializeException(
     LinuxVMAddress exception_info_address,
-    pid_t exception_thread_id) {
+    pid_t exception_thread_id,
+    const SharedCrashContext* shared_context) {
+  CRASHPAD_TRACE_EVENT("capture", "ProcessSnapshotLinux::InitializeException");
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   DCHECK(!exception_);
 
+  const ProcessMemory* memory = process_reader_.Memory();
+  SharedCrashContextMemory shared_context_memory;
+  if (shared_context) {
+    if (!shared_context_memory.Initialize(memory, shared_context)) {
+      return false;
+    }
+    memory = &shared_context_memory;
+  }
+
   ExceptionInformation info;
-  if (!process_reader_.Memory()->Read(
-          exception_info_address, sizeof(info), &info)) {
+  if (!memory->Read(exception_info_address, sizeof(info), &info)) {
     LOG(ERROR) << "Couldn't read exception info";
     return false;
   }
@@ -87,13 +176,20 @@ bool ProcessSnapshotLinux::InitializeException(
       options_.gather_indirectly_referenced_memory == TriState::kEnabled
           ? &options_.indirectly_referenced_memory_cap
           : nullptr;
+  if (budget_remaining_pointer && !HaveCaptureTime()) {
+    budget_remaining_pointer = nullptr;
+    RecordCaptureSkipped("indirect_memory");
+  }
 
   exception_.reset(new internal::ExceptionSnapshotLinux());
   if (!exception_->Initialize(&process_reader_,
                               info.siginfo_address,
                               info.context_address,
                               info.thread_id,
-                              budget_remaining_pointer)) {
+                              budget_remaining_pointer,
+                              &capture_timings_,
+                              memory,
+                              std::max(indirect_memory_depth_, size_t{1}))) {
     exception_.reset();
     return false;
   }
@@ -101,6 +197,8 @@ bool ProcessSnapshotLinux::InitializeException(
   // The thread's existing snapshot will have captured the stack for the signal
   // handler. Replace it with a thread snapshot which captures the stack for the
   // exception context.
+  ScopedCapturePhase capture_phase(
+      &capture_timings_, CapturePhase::kThreads, process_reader_.Memory());
   for (const auto& reader_thread : process_reader_.Threads()) {
     if (reader_thread.tid == info.thread_id) {
       ProcessReaderLinux::Thread thread = reader_thread;
@@ -109,7 +207,8 @@ bool ProcessSnapshotLinux::InitializeException(
 
       auto exc_thread_snapshot =
           std::make_unique<internal::ThreadSnapshotLinux>();
-      if (!exc_thread_snapshot->Initialize(&process_reader_, thread, nullptr)) {
+      if (!exc_thread_snapshot->Initialize(
+              &process_reader_, thread, nullptr, nullptr)) {
         return false;
       }
 
@@ -117,6 +216,7 @@ bool ProcessSnapshotLinux::InitializeException(
         if (thread_snapshot->ThreadID() ==
             static_cast<uint64_t>(info.thread_id)) {
           thread_snapshot.reset(exc_thread_snapshot.release());
+          FilterThreads(info.thread_id);
           return true;
         }
       }
@@ -130,6 +230,46 @@ bool ProcessSnapshotLinux::InitializeException(
   return false;
 }
 
+void ProcessSnapshotLinux::FilterThreads(uint64_t exception_thread_id) {
+  if (!thread_filter_.IsEnabled()) {
+    return;
+  }
+
+  std::vector<const ThreadSnapshot*> threads;
+  threads.reserve(threads_.size());
+  for (const auto& thread : threads_) {
+    threads.push_back(thread.get());
+  }
+  const std::vector<bool> selected =
+      thread_filter_.Select(threads, exception_thread_id);
+
+  std::vector<std::unique_ptr<internal::ThreadSnapshotLinux>> kept;
+  for (size_t index = 0; index < threads_.size(); ++index) {
+    if (selected[index]) {
+      kept.push_back(std::move(threads_[index]));
+    }
+  }
+  if (kept.size() != threads_.size() && !lightweight_) {
+    RecordCaptureSkipped("threads");
+  }
+  threads_ = std::move(kept);
+}
+
+void ProcessSnapshotLinux::ApplyLightweightCapture() {
+  // The exception thread's stack is captured by InitializeException() on its
+  // own, so InitializeThreads() captures no stacks, and every other thread is
+  // dropped once the exception thread is known.
+  thread_filter_ = ThreadFilter();
+  thread_filter_.max_other_threads = 0;
+  options_.gather_indirectly_referenced_memory = TriState::kDisabled;
+  options_.indirectly_referenced_memory_cap = 0;
+
+  for (auto& module : modules_) {
+    module->SetChangedAnnotationsOnly(lightweight_annotation_list_address_,
+                                      lightweight_since_generation_);
+  }
+}
+
 void ProcessSnapshotLinux::GetCrashpadOptions(
     CrashpadInfoClientOptions* options) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
@@ -264,7 +404,11 @@ std::vector<HandleSnapshot> ProcessSnapshotLinux::Handles() const {
 
 std::vector<const MemorySnapshot*> ProcessSnapshotLinux::ExtraMemory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return std::vector<const MemorySnapshot*>();
+  std::vector<const MemorySnapshot*> extra_memory;
+  for (const auto& memory : extra_memory_) {
+    extra_memory.push_back(memory.get());
+  }
+  return extra_memory;
 }
 
 const ProcessMemory* ProcessSnapshotLinux::Memory() const {
@@ -272,37 +416,140 @@ const ProcessMemory* ProcessSnapshotLinux::Memory() const {
   return process_reader_.Memory();
 }
 
+const ProcessMemoryCached* ProcessSnapshotLinux::MemoryCache() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return process_reader_.Memory();
+}
+
 void ProcessSnapshotLinux::InitializeThreads() {
-  const std::vector<ProcessReaderLinux::Thread>& process_reader_threads =
-      process_reader_.Threads();
+  // Locating memory referenced by each thread is charged to
+  // CapturePhase::kIndirectMemory by ThreadSnapshotLinux, so only reading the
+  // threads is charged to CapturePhase::kThreads here.
+  const std::vector<ProcessReaderLinux::Thread>* process_reader_threads;
+  {
+    ScopedCapturePhase capture_phase(
+        &capture_timings_, CapturePhase::kThreads, process_reader_.Memory());
+    process_reader_threads = &process_reader_.Threads();
+  }
+  // The threads don't locate the memory their contexts refer to until the
+  // snapshot is written, after InitializeException() has taken what it needs
+  // from the shared budget.
   uint32_t* budget_remaining_pointer =
       options_.gather_indirectly_referenced_memory == TriState::kEnabled
           ? &options_.indirectly_referenced_memory_cap
           : nullptr;
+  const size_t depth = std::max(indirect_memory_depth_, size_t{1});
 
+  size_t thread_stacks = 0;
   for (const ProcessReaderLinux::Thread& process_reader_thread :
-       process_reader_threads) {
+       *process_reader_threads) {
+    // Past the capture deadline or the thread stack limit, keep each thread's
+    // context but none of the memory it refers to. The exception thread's
+    // stack is captured again in InitializeException() regardless.
+    ProcessReaderLinux::Thread reader_thread = process_reader_thread;
+    if (lightweight_) {
+      reader_thread.stack_region_size = 0;
+    }
+    if (reader_thread.stack_region_size &&
+        thread_stacks++ >= max_thread_stacks_) {
+      reader_thread.stack_region_size = 0;
+      RecordCaptureSkipped("thread_stacks");
+    }
+    if (!HaveCaptureTime()) {
+      if (reader_thread.stack_region_size) {
+        reader_thread.stack_region_size = 0;
+        RecordCaptureSkipped("thread_stacks");
+      }
+      if (budget_remaining_pointer) {
+        budget_remaining_pointer = nullptr;
+        RecordCaptureSkipped("indirect_memory");
+      }
+    }
+
     auto thread = std::make_unique<internal::ThreadSnapshotLinux>();
     if (thread->Initialize(&process_reader_,
-                           process_reader_thread,
-                           budget_remaining_pointer)) {
+                           reader_thread,
+                           budget_remaining_pointer,
+                           &capture_timings_,
+                           depth)) {
       threads_.push_back(std::move(thread));
     }
   }
 }
 
 void ProcessSnapshotLinux::InitializeModules() {
-  for (const ProcessReaderLinux::Module& reader_module :
-       process_reader_.Modules()) {
+  const std::vector<ProcessReaderLinux::Module>& reader_modules =
+      process_reader_.Modules();
+
+  std::vector<std::unique_ptr<internal::ModuleSnapshotElf>> modules;
+  modules.reserve(reader_modules.size());
+  for (const ProcessReaderLinux::Module& reader_module : reader_modules) {
     auto module =
         std::make_unique<internal::ModuleSnapshotElf>(reader_module.name,
                                                       reader_module.elf_reader,
                                                       reader_module.type,
                                                       &memory_range_,
                                                       process_reader_.Memory());
-    if (module->Initialize()) {
-      modules_.push_back(std::move(module));
+    modules.push_back(std::move(module));
+  }
+
+  // Each module has its own ElfImageReader, so modules may be initialized
+  // concurrently as long as the target's memory may be. Each result is written
+  // to its own element, so that modules_ keeps the process reader's order.
+  std::unique_ptr<bool[]> initialized(new bool[modules.size()]());
+  RunConcurrently(modules.size(),
+                  process_reader_.SupportsConcurrentMemoryReads()
+                      ? module_initialization_concurrency_
+                      : 1,
+                  [this, &modules, &initialized](size_t index) {
+                    initialized[index] =
+                        module_identities_only_
+                            ? modules[index]->InitializeIdentity()
+                            : modules[index]->Initialize();
+                  });
+
+  for (size_t index = 0; index < modules.size(); ++index) {
+    if (initialized[index]) {
+      modules_.push_back(std::move(modules[index]));
+    }
+  }
+}
+
+void ProcessSnapshotLinux::InitializeExtraMemory() {
+  // Ranges registered by the client may be stale, so only those lying
+  // entirely within readable mappings are captured. Mappings that the client
+  // excluded from core dumps are also left out.
+  crashpad::MemoryMap* memory_map = process_reader_.GetMemoryMap();
+  std::set<CheckedRange<uint64_t>> ranges;
+  for (const auto& module : modules_) {
+    std::set<CheckedRange<uint64_t>> module_ranges =
+        module->ExtraMemoryRanges();
+    ranges.insert(module_ranges.begin(), module_ranges.end());
+  }
+
+  for (const CheckedRange<uint64_t>& range : ranges) {
+    if (!range.size() || !range.IsValid()) {
+      continue;
+    }
+
+    bool readable = true;
+    for (LinuxVMAddress address = range.base(); address < range.end();) {
+      const crashpad::MemoryMap::Mapping* mapping =
+          memory_map->FindMapping(address);
+      if (!mapping || !mapping->readable || mapping->dont_dump) {
+        readable = false;
+        break;
+      }
+      address = mapping->range.End();
+    }
+    if (!readable) {
+      continue;
     }
+
+    extra_memory_.push_back(
+        std::make_unique<internal::MemorySnapshotGeneric>());
+    extra_memory_.back()->Initialize(
+        process_reader_.Memory(), range.base(), range.size());
   }
 }
 
@@ -315,4 +562,44 @@ void ProcessSnapshotLinux::InitializeAnnotations() {
 #endif
 }
 
+void ProcessSnapshotLinux::UpdateCaptureSoftDeadline() {
+  if (!capture_deadline_ns_) {
+    capture_soft_deadline_ns_ = 0;
+    return;
+  }
+
+  // Spend at most half of the remaining time gathering optional data, leaving
+  // the rest for writing out what has been captured.
+  const uint64_t now_ns = ClockMonotonicNanoseconds();
+  capture_soft_deadline_ns_ =
+      now_ns +
+      (capture_deadline_ns_ > now_ns ? (capture_deadline_ns_ - now_ns) / 2 : 0);
+}
+
+bool ProcessSnapshotLinux::HaveCaptureTime() const {
+  return !capture_deadline_ns_ ||
+         ClockMonotonicNanoseconds() < capture_soft_deadline_ns_;
+}
+
+void ProcessSnapshotLinux::RecordCaptureSkipped(const std::string& what) {
+  std::string& skipped = annotations_simple_map_[kCaptureSkippedKey];
+  if (skipped.empty()) {
+    skipped = what;
+    return;
+  }
+
+  size_t start = 0;
+  while (start <= skipped.size()) {
+    size_t end = skipped.find(',', start);
+    if (end == std::string::npos) {
+      end = skipped.size();
+    }
+    if (skipped.compare(start, end - start, what) == 0) {
+      return;
+    }
+    start = end + 1;
+  }
+  skipped += "," + what;
+}
+
 }  // namespace crashpad
@@ -15,30 +15,40 @@
 #ifndef CRASHPAD_SNAPSHOT_LINUX_PROCESS_SNAPSHOT_LINUX_H_
 #define CRASHPAD_SNAPSHOT_LINUX_PROCESS_SNAPSHOT_LINUX_H_
 
+#include <stdint.h>
 #include <sys/time.h>
 #include <sys/types.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "snapshot/crashpad_info_client_options.h"
+#include "snapshot/elf/elf_image_cache.h"
 #include "snapshot/elf/module_snapshot_elf.h"
 #include "snapshot/linux/exception_snapshot_linux.h"
+#include "snapshot/linux/module_list_cache.h"
 #include "snapshot/linux/process_reader_linux.h"
 #include "snapshot/linux/system_snapshot_linux.h"
 #include "snapshot/linux/thread_snapshot_linux.h"
 #include "snapshot/memory_map_region_snapshot.h"
+#include "snapshot/memory_snapshot_generic.h"
 #include "snapshot/module_snapshot.h"
 #include "snapshot/process_snapshot.h"
 #include "snapshot/system_snapshot.h"
+#include "snapshot/thread_filter.h"
 #include "snapshot/thread_snapshot.h"
 #include "snapshot/unloaded_module_snapshot.h"
 #include "util/linux/ptrace_connection.h"
+#include "util/linux/shared_crash_context.h"
+#include "util/misc/capture_timings.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/misc/uuid.h"
 #include "util/process/process_id.h"
+#include "util/process/process_memory_cached.h"
 #include "util/process/process_memory_range.h"
 
 namespace crashpad {
@@ -54,6 +64,233 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
 
   ~ProcessSnapshotLinux() override;
 
+  //! \brief Sets the maximum number of threads that may be used to gather
+  //!     information about the target process' threads.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessReaderLinux::SetThreadInitializationConcurrency().
+  void SetThreadInitializationConcurrency(size_t concurrency) {
+    process_reader_.SetThreadInitializationConcurrency(concurrency);
+  }
+
+  //! \brief Enables trimming thread stacks to their live frames.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessReaderLinux::SetStackTrimming(). The stack of the thread which
+  //! raised an exception is captured from the exception context in
+  //! InitializeException(), and is not trimmed.
+  void SetStackTrimming(bool enabled) {
+    process_reader_.SetStackTrimming(enabled);
+  }
+
+  //! \brief Enables leaving unmodified module code out of indirectly
+  //!     referenced memory.
+  //!
+  //! See ProcessReaderLinux::SetModuleCodeElision(). Elided ranges aren't
+  //! charged to the indirectly referenced memory budget. This must be called
+  //! before InitializeException() to affect the exception's memory.
+  void SetModuleCodeElision(bool enabled) {
+    process_reader_.SetModuleCodeElision(enabled);
+  }
+
+  //! \brief Sets the maximum number of threads that may be used to initialize
+  //!     module snapshots.
+  //!
+  //! Each module's ELF headers and CrashpadInfo are read from the target
+  //! process independently of the others, so this work may be distributed
+  //! across as many as \a concurrency threads, including the calling thread.
+  //! Modules() returns modules in the same order regardless of the
+  //! concurrency used. Reads made by every thread share the process reader's
+  //! memory cache. If the target's memory can't be read from several threads
+  //! at once, such as when it's read through a PtraceBroker, modules are
+  //! initialized on the calling thread.
+  //!
+  //! The default concurrency is 1. This must be called before Initialize() to
+  //! have any effect.
+  //!
+  //! \param[in] concurrency The maximum number of threads to use. Values less
+  //!     than 1 are treated as 1.
+  void SetModuleInitializationConcurrency(size_t concurrency) {
+    module_initialization_concurrency_ = concurrency;
+  }
+
+  //! \brief Sets the number of levels of pointers followed when capturing
+  //!     indirectly referenced memory.
+  //!
+  //! Indirectly referenced memory is only captured when enabled by the
+  //! client's CrashpadInfoClientOptions, and is limited to their
+  //! `indirectly_referenced_memory_cap`. With a depth of 1, the default, only
+  //! memory near pointer-like register values is captured. Greater depths also
+  //! follow pointer-like values found in that memory, breadth-first. See
+  //! CaptureMemory::PointedToByContextRecursively().
+  //!
+  //! With a depth greater than 1, the threads captured by Initialize() may
+  //! spend at most half of the budget, so that the rest is left for the
+  //! exception context captured by InitializeException().
+  //!
+  //! This must be called before Initialize() to have any effect.
+  //!
+  //! \param[in] depth The number of levels of pointers to follow. Values less
+  //!     than 1 are treated as 1.
+  void SetIndirectMemoryDepth(size_t depth) { indirect_memory_depth_ = depth; }
+
+  //! \brief Sets a cache of ELF image information shared across snapshots.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessReaderLinux::SetElfImageCache().
+  void SetElfImageCache(ElfImageCache* cache) {
+    process_reader_.SetElfImageCache(cache);
+  }
+
+  //! \brief Sets a cache of module lists shared across snapshots of the same
+  //!     process.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessReaderLinux::SetModuleListCache().
+  void SetModuleListCache(ModuleListCache* cache) {
+    process_reader_.SetModuleListCache(cache);
+  }
+
+  //! \brief Limits the snapshot’s modules to their identities.
+  //!
+  //! Each module is read only for its name, address, size, type, and build ID.
+  //! See ProcessReaderLinux::SetModuleIdentitiesOnly() and
+  //! ModuleSnapshotElf::InitializeIdentity(). No module’s CrashpadInfo
+  //! structure is read, so the snapshot has no module annotations, options,
+  //! extra memory, or user minidump streams. This is for captures that only
+  //! need the module list, such as those of processes that don’t use the
+  //! Crashpad client.
+  //!
+  //! This must be called before Initialize() to have any effect.
+  void SetModuleIdentitiesOnly(bool enabled) {
+    module_identities_only_ = enabled;
+    process_reader_.SetModuleIdentitiesOnly(enabled);
+  }
+
+  //! \brief Enables skipping pages of the target that have never been
+  //!     populated.
+  //!
+  //! This must be called after Initialize(). Memory snapshots obtained from
+  //! this object report such pages through MemorySnapshot::UnpopulatedRanges()
+  //! and don't read them from the target. See
+  //! ProcessReaderLinux::SetSkipUnpopulatedMemory().
+  void SetSkipUnpopulatedMemory(bool enabled) {
+    process_reader_.SetSkipUnpopulatedMemory(enabled);
+  }
+
+  //! \brief Returns `true` if memory snapshots obtained from this object skip
+  //!     pages that have never been populated. See SetSkipUnpopulatedMemory().
+  bool SkipsUnpopulatedMemory() const {
+    return process_reader_.SkipsUnpopulatedMemory();
+  }
+
+  //! \brief Sets a deadline by which the snapshot should be fully written.
+  //!
+  //! When a deadline is set, the module list and the exception thread are
+  //! always captured, but other threads' stacks, indirectly referenced memory,
+  //! and module annotations are omitted once less than half of the time
+  //! remaining at Initialize() is left, reserving the rest for writing the
+  //! snapshot. Anything omitted is listed in the `"crashpad_capture_skipped"`
+  //! process annotation.
+  //!
+  //! This must be called before Initialize() to have any effect.
+  //!
+  //! \param[in] deadline_ns A ClockMonotonicNanoseconds() value, or `0` for no
+  //!     deadline.
+  void SetCaptureDeadline(uint64_t deadline_ns) {
+    capture_deadline_ns_ = deadline_ns;
+  }
+
+  //! \brief Limits the number of threads whose stacks are captured.
+  //!
+  //! Threads beyond the first \a max_thread_stacks keep their context, but no
+  //! stack memory or memory referenced from it, and `"thread_stacks"` is
+  //! listed in the `"crashpad_capture_skipped"` process annotation. The
+  //! exception thread's stack is captured by InitializeException() regardless.
+  //!
+  //! This must be called before Initialize(), or from its
+  //! ModulesReadyCallback, to have any effect.
+  //!
+  //! \param[in] max_thread_stacks The maximum number of thread stacks to
+  //!     capture. The default is unlimited.
+  void SetMaxThreadStacks(size_t max_thread_stacks) {
+    max_thread_stacks_ = max_thread_stacks;
+  }
+
+  //! \brief Limits the client's `indirectly_referenced_memory_cap`.
+  //!
+  //! The lesser of \a limit and the cap requested in the client's
+  //! CrashpadInfoClientOptions is used. This does not enable capturing
+  //! indirectly referenced memory for clients that haven't asked for it.
+  //!
+  //! This must be called before Initialize(), or from its
+  //! ModulesReadyCallback, to have any effect.
+  //!
+  //! \param[in] limit The maximum number of bytes of indirectly referenced
+  //!     memory to capture.
+  void SetIndirectMemoryLimit(uint32_t limit) {
+    indirect_memory_limit_ = limit;
+  }
+
+  //! \brief Limits which threads are captured.
+  //!
+  //! Threads that \a filter doesn't select are dropped by
+  //! InitializeException(), once the exception thread is known, and
+  //! `"threads"` is listed in the `"crashpad_capture_skipped"` process
+  //! annotation. Snapshots for which InitializeException() isn't called keep
+  //! every thread.
+  //!
+  //! This must be called before InitializeException() to have any effect.
+  //!
+  //! \param[in] filter The threads to capture. The default keeps every thread.
+  void SetThreadFilter(const ThreadFilter& filter) { thread_filter_ = filter; }
+
+  //! \brief Limits the snapshot to the exception thread and the annotations
+  //!     that have changed since an earlier snapshot.
+  //!
+  //! Threads other than the exception thread are dropped by
+  //! InitializeException(), and no memory is captured besides the exception
+  //! thread's stack. Modules report only the annotation objects in the
+  //! AnnotationList at \a annotation_list_address that have been set since
+  //! \a since_generation. See ModuleSnapshotElf::SetChangedAnnotationsOnly().
+  //! This takes precedence over the settings of a ModulesReadyCallback.
+  //!
+  //! This must be called before Initialize() to have any effect.
+  //!
+  //! \param[in] annotation_list_address The address of the client's
+  //!     AnnotationList, or `0` to report no module annotations.
+  //! \param[in] since_generation A value returned by
+  //!     AnnotationList::generation().
+  void SetLightweightCapture(VMAddress annotation_list_address,
+                             uint32_t since_generation) {
+    lightweight_ = true;
+    lightweight_annotation_list_address_ = annotation_list_address;
+    lightweight_since_generation_ = since_generation;
+  }
+
+  //! \brief Returns `true` if SetLightweightCapture() limited this snapshot.
+  bool IsLightweightCapture() const { return lightweight_; }
+
+  //! \brief A function called by Initialize() once the target's modules have
+  //!     been read, before any of its threads are.
+  //!
+  //! The callback receives the snapshot being initialized and its modules, and
+  //! may call SetStackTrimming(), SetIndirectMemoryDepth(),
+  //! SetCaptureDeadline(), SetMaxThreadStacks(), SetIndirectMemoryLimit(), and
+  //! SetThreadFilter() to adjust the rest of the capture based on what the
+  //! modules show about the target.
+  using ModulesReadyCallback =
+      std::function<void(ProcessSnapshotLinux* snapshot,
+                         const std::vector<const ModuleSnapshot*>& modules)>;
+
+  //! \brief Sets a callback to be run by Initialize() after reading modules.
+  //!
+  //! The callback is released once it has run. This must be called before
+  //! Initialize() to have any effect.
+  void SetModulesReadyCallback(ModulesReadyCallback callback) {
+    modules_ready_callback_ = std::move(callback);
+  }
+
   //! \brief Initializes the object.
   //!
   //! \param[in] connection A connection to the process to snapshot.
@@ -62,6 +299,20 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   //!     an appropriate message logged.
   bool Initialize(PtraceConnection* connection);
 
+  //! \brief Returns the cost of each phase of capturing this snapshot.
+  //!
+  //! Initialize() and InitializeException() record their costs here. Callers
+  //! may add the cost of later phases, such as CapturePhase::kSanitization and
+  //! CapturePhase::kWrite.
+  CaptureTimings* Timings() { return &capture_timings_; }
+
+  //! \brief Returns the cache through which the target process' memory is
+  //!     read for the lifetime of this snapshot.
+  //!
+  //! Callers may use this to report the cache's hit rate once they have
+  //! finished reading from the snapshot.
+  const ProcessMemoryCached* MemoryCache() const;
+
   //! \brief Finds the thread whose stack contains \a stack_address.
   //!
   //! \param[in] stack_address A stack address to search for.
@@ -77,8 +328,13 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   //!     Optional. If -1, the exception thread will be identified by the
   //!     ExceptionInformation struct which contains the thread ID in the target
   //!     process' namespace.
+  //! \param[in] shared_context Memory describing the exception that the target
+  //!     process copied out ahead of time. Optional. If not `nullptr`, reads of
+  //!     the ExceptionInformation, `siginfo_t`, and `ucontext_t` are served
+  //!     from here where possible instead of from the target process.
   bool InitializeException(LinuxVMAddress exception_info,
-                           pid_t exception_thread_id = -1);
+                           pid_t exception_thread_id = -1,
+                           const SharedCrashContext* shared_context = nullptr);
 
   //! \brief Sets the value to be returned by ReportID().
   //!
@@ -137,8 +393,27 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
  private:
   void InitializeThreads();
   void InitializeModules();
+  void InitializeExtraMemory();
+
+  // Narrows the rest of the capture as SetLightweightCapture() describes, once
+  // modules have been read.
+  void ApplyLightweightCapture();
   void InitializeAnnotations();
 
+  // Sets capture_soft_deadline_ns_ from capture_deadline_ns_.
+  void UpdateCaptureSoftDeadline();
+
+  // Returns true if optional data should still be captured, given
+  // capture_soft_deadline_ns_.
+  bool HaveCaptureTime() const;
+
+  // Drops the threads that thread_filter_ doesn't select, on behalf of
+  // InitializeException().
+  void FilterThreads(uint64_t exception_thread_id);
+
+  // Adds what to the "crashpad_capture_skipped" process annotation.
+  void RecordCaptureSkipped(const std::string& what);
+
   // Initializes options_ on behalf of Initialize().
   void GetCrashpadOptionsInternal(CrashpadInfoClientOptions* options);
 
@@ -148,11 +423,25 @@ class ProcessSnapshotLinux final : public ProcessSnapshot {
   UUID client_id_;
   std::vector<std::unique_ptr<internal::ThreadSnapshotLinux>> threads_;
   std::vector<std::unique_ptr<internal::ModuleSnapshotElf>> modules_;
+  std::vector<std::unique_ptr<internal::MemorySnapshotGeneric>> extra_memory_;
   std::unique_ptr<internal::ExceptionSnapshotLinux> exception_;
   internal::SystemSnapshotLinux system_;
   ProcessReaderLinux process_reader_;
   ProcessMemoryRange memory_range_;
   CrashpadInfoClientOptions options_;
+  CaptureTimings capture_timings_;
+  uint64_t capture_deadline_ns_;
+  uint64_t capture_soft_deadline_ns_;
+  size_t module_initialization_concurrency_;
+  size_t indirect_memory_depth_;
+  size_t max_thread_stacks_;
+  uint32_t indirect_memory_limit_;
+  ThreadFilter thread_filter_;
+  ModulesReadyCallback modules_ready_callback_;
+  bool module_identities_only_;
+  bool lightweight_;
+  VMAddress lightweight_annotation_list_address_;
+  uint32_t lightweight_since_generation_;
   InitializationStateDcheck initialized_;
 };
 
@@ -188,6 +188,20 @@ struct SignalFloatContext32 {
 
 using SignalFloatContext64 = CPUContextX86_64::Fxsave;
 
+// The software reserved bytes at the end of an fxsave area in a signal frame,
+// describing the XSAVE area that begins with it when magic1 is
+// FP_XSTATE_MAGIC1.
+struct SignalXSaveSoftwareBytes {
+  uint32_t magic1;
+  uint32_t extended_size;
+  uint64_t xfeatures;
+  uint32_t xstate_size;
+  uint32_t padding[7];
+};
+static_assert(sizeof(SignalXSaveSoftwareBytes) ==
+                  sizeof(CPUContextX86_64::Fxsave::available),
+              "software reserved bytes size mismatch");
+
 struct ContextTraits32 : public Traits32 {
   using ThreadContext = SignalThreadContext32;
   using FloatContext = SignalFloatContext32;
@@ -230,6 +244,15 @@ struct SignalFPSIMDContext {
   uint128_struct vregs[32];
 };
 
+// Follows a CoprocessorContextHead with magic SVE_MAGIC. If the record is
+// larger than the two together, the SVE registers follow at the next 16-byte
+// boundary.
+struct SignalSVEContext {
+  uint16_t vl;
+  uint16_t flags;
+  uint16_t reserved[2];
+};
+
 struct SignalVFPContext {
   FloatContext::f32_t::vfp_t vfp;
   struct vfp_exc {
@@ -34,6 +34,10 @@
 #include "util/numeric/in_range_cast.h"
 #include "util/string/split_string.h"
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include "snapshot/x86/cpuid_reader.h"
+#endif  // ARCH_CPU_X86_FAMILY
+
 #if BUILDFLAG(IS_ANDROID)
 #include <sys/system_properties.h>
 #endif
@@ -135,57 +139,148 @@ bool ReadProperty(const char* property, std::string* value) {
 
 }  // namespace
 
-SystemSnapshotLinux::SystemSnapshotLinux()
-    : SystemSnapshot(),
-      os_version_full_(),
-      os_version_build_(),
-      process_reader_(nullptr),
-      snapshot_time_(nullptr),
-#if defined(ARCH_CPU_X86_FAMILY)
-      cpuid_(),
-#endif  // ARCH_CPU_X86_FAMILY
-      os_version_major_(-1),
-      os_version_minor_(-1),
-      os_version_bugfix_(-1),
-      target_cpu_(0),
-      cpu_count_(0),
-      initialized_() {
-}
+struct SystemSnapshotLinux::InvariantInfo {
+  InvariantInfo();
 
-SystemSnapshotLinux::~SystemSnapshotLinux() {}
+  InvariantInfo(const InvariantInfo&) = delete;
+  InvariantInfo& operator=(const InvariantInfo&) = delete;
 
-void SystemSnapshotLinux::Initialize(ProcessReaderLinux* process_reader,
-                                     const timeval* snapshot_time) {
-  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
-  process_reader_ = process_reader;
-  snapshot_time_ = snapshot_time;
+  ~InvariantInfo() = delete;
 
+  void ReadKernelVersion(const std::string& version_string);
+
+  std::string os_version_full;
+  std::string os_version_build;
+#if BUILDFLAG(IS_ANDROID)
+  std::string machine_description;
+#endif  // BUILDFLAG(IS_ANDROID)
+#if defined(ARCH_CPU_X86_FAMILY)
+  CpuidReader cpuid;
+#endif  // ARCH_CPU_X86_FAMILY
+  int os_version_major;
+  int os_version_minor;
+  int os_version_bugfix;
+};
+
+SystemSnapshotLinux::InvariantInfo::InvariantInfo()
+    : os_version_full(),
+      os_version_build(),
+#if BUILDFLAG(IS_ANDROID)
+      machine_description(),
+#endif  // BUILDFLAG(IS_ANDROID)
+#if defined(ARCH_CPU_X86_FAMILY)
+      cpuid(),
+#endif  // ARCH_CPU_X86_FAMILY
+      os_version_major(-1),
+      os_version_minor(-1),
+      os_version_bugfix(-1) {
 #if BUILDFLAG(IS_ANDROID)
   std::string build_string;
   if (ReadProperty("ro.build.fingerprint", &build_string)) {
-    os_version_build_ = build_string;
-    os_version_full_ = build_string;
+    os_version_build = build_string;
+    os_version_full = build_string;
+  }
+
+  std::string prop;
+  if (ReadProperty("ro.product.model", &prop)) {
+    machine_description += prop;
+  }
+  if (ReadProperty("ro.product.board", &prop)) {
+    if (!machine_description.empty()) {
+      machine_description.push_back(' ');
+    }
+    machine_description += prop;
   }
 #endif  // BUILDFLAG(IS_ANDROID)
 
   utsname uts;
   if (uname(&uts) != 0) {
     PLOG(WARNING) << "uname";
-  } else {
-    if (!os_version_full_.empty()) {
-      os_version_full_.push_back(' ');
-    }
-    os_version_full_ += base::StringPrintf(
-        "%s %s %s %s", uts.sysname, uts.release, uts.version, uts.machine);
+    return;
   }
+
+  if (!os_version_full.empty()) {
+    os_version_full.push_back(' ');
+  }
+  os_version_full += base::StringPrintf(
+      "%s %s %s %s", uts.sysname, uts.release, uts.version, uts.machine);
   ReadKernelVersion(uts.release);
 
-  if (!os_version_build_.empty()) {
-    os_version_build_.push_back(' ');
+  if (!os_version_build.empty()) {
+    os_version_build.push_back(' ');
   }
-  os_version_build_ += uts.version;
-  os_version_build_.push_back(' ');
-  os_version_build_ += uts.machine;
+  os_version_build += uts.version;
+  os_version_build.push_back(' ');
+  os_version_build += uts.machine;
+}
+
+void SystemSnapshotLinux::InvariantInfo::ReadKernelVersion(
+    const std::string& version_string) {
+  std::vector<std::string> versions = SplitString(version_string, '.');
+  if (versions.size() < 3) {
+    LOG(WARNING) << "format error";
+    return;
+  }
+
+  if (!base::StringToInt(base::StringPiece(versions[0]), &os_version_major)) {
+    LOG(WARNING) << "no kernel version";
+    return;
+  }
+  DCHECK_GE(os_version_major, 3);
+
+  if (!base::StringToInt(base::StringPiece(versions[1]), &os_version_minor)) {
+    LOG(WARNING) << "no major revision";
+    return;
+  }
+  DCHECK_GE(os_version_minor, 0);
+
+  size_t minor_rev_end = versions[2].find_first_not_of("0123456789");
+  if (minor_rev_end == std::string::npos) {
+    minor_rev_end = versions[2].size();
+  }
+  if (!base::StringToInt(base::StringPiece(versions[2].c_str(), minor_rev_end),
+                         &os_version_bugfix)) {
+    LOG(WARNING) << "no minor revision";
+    return;
+  }
+  DCHECK_GE(os_version_bugfix, 0);
+
+  if (!os_version_build.empty()) {
+    os_version_build.push_back(' ');
+  }
+  os_version_build += versions[2].substr(minor_rev_end);
+}
+
+// static
+const SystemSnapshotLinux::InvariantInfo&
+SystemSnapshotLinux::GetInvariantInfo() {
+  // The kernel, the CPU, and the Android build properties read here stay the
+  // same for as long as the handler runs, so they are read only once and then
+  // shared by all captures, including concurrent ones in multi-client mode.
+  // Volatile values like the online CPUs, CPU frequency, and time zone are
+  // still read for each snapshot.
+  static const InvariantInfo* const info = new InvariantInfo();
+  return *info;
+}
+
+SystemSnapshotLinux::SystemSnapshotLinux()
+    : SystemSnapshot(),
+      process_reader_(nullptr),
+      snapshot_time_(nullptr),
+      invariant_info_(nullptr),
+      target_cpu_(0),
+      cpu_count_(0),
+      initialized_() {
+}
+
+SystemSnapshotLinux::~SystemSnapshotLinux() {}
+
+void SystemSnapshotLinux::Initialize(ProcessReaderLinux* process_reader,
+                                     const timeval* snapshot_time) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  process_reader_ = process_reader;
+  snapshot_time_ = snapshot_time;
+  invariant_info_ = &GetInvariantInfo();
 
   if (!ReadCPUsOnline(&target_cpu_, &cpu_count_)) {
     target_cpu_ = 0;
@@ -216,7 +311,7 @@ CPUArchitecture SystemSnapshotLinux::GetCPUArchitecture() const {
 uint32_t SystemSnapshotLinux::CPURevision() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.Revision();
+  return invariant_info_->cpuid.Revision();
 #elif defined(ARCH_CPU_ARM_FAMILY)
   // TODO(jperaza): do this. https://crashpad.chromium.org/bug/30
   return 0;
@@ -239,7 +334,7 @@ uint8_t SystemSnapshotLinux::CPUCount() const {
 std::string SystemSnapshotLinux::CPUVendor() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.Vendor();
+  return invariant_info_->cpuid.Vendor();
 #elif defined(ARCH_CPU_ARM_FAMILY)
   // TODO(jperaza): do this. https://crashpad.chromium.org/bug/30
   return std::string();
@@ -274,7 +369,7 @@ void SystemSnapshotLinux::CPUFrequency(uint64_t* current_hz,
 uint32_t SystemSnapshotLinux::CPUX86Signature() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.Signature();
+  return invariant_info_->cpuid.Signature();
 #else
   NOTREACHED();
   return 0;
@@ -284,7 +379,7 @@ uint32_t SystemSnapshotLinux::CPUX86Signature() const {
 uint64_t SystemSnapshotLinux::CPUX86Features() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.Features();
+  return invariant_info_->cpuid.Features();
 #else
   NOTREACHED();
   return 0;
@@ -294,7 +389,7 @@ uint64_t SystemSnapshotLinux::CPUX86Features() const {
 uint64_t SystemSnapshotLinux::CPUX86ExtendedFeatures() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.ExtendedFeatures();
+  return invariant_info_->cpuid.ExtendedFeatures();
 #else
   NOTREACHED();
   return 0;
@@ -304,7 +399,7 @@ uint64_t SystemSnapshotLinux::CPUX86ExtendedFeatures() const {
 uint32_t SystemSnapshotLinux::CPUX86Leaf7Features() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.Leaf7Features();
+  return invariant_info_->cpuid.Leaf7Features();
 #else
   NOTREACHED();
   return 0;
@@ -314,7 +409,7 @@ uint32_t SystemSnapshotLinux::CPUX86Leaf7Features() const {
 bool SystemSnapshotLinux::CPUX86SupportsDAZ() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.SupportsDAZ();
+  return invariant_info_->cpuid.SupportsDAZ();
 #else
   NOTREACHED();
   return false;
@@ -341,32 +436,21 @@ void SystemSnapshotLinux::OSVersion(int* major,
                                     int* bugfix,
                                     std::string* build) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  *major = os_version_major_;
-  *minor = os_version_minor_;
-  *bugfix = os_version_bugfix_;
-  build->assign(os_version_build_);
+  *major = invariant_info_->os_version_major;
+  *minor = invariant_info_->os_version_minor;
+  *bugfix = invariant_info_->os_version_bugfix;
+  build->assign(invariant_info_->os_version_build);
 }
 
 std::string SystemSnapshotLinux::OSVersionFull() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return os_version_full_;
+  return invariant_info_->os_version_full;
 }
 
 std::string SystemSnapshotLinux::MachineDescription() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if BUILDFLAG(IS_ANDROID)
-  std::string description;
-  std::string prop;
-  if (ReadProperty("ro.product.model", &prop)) {
-    description += prop;
-  }
-  if (ReadProperty("ro.product.board", &prop)) {
-    if (!description.empty()) {
-      description.push_back(' ');
-    }
-    description += prop;
-  }
-  return description;
+  return invariant_info_->machine_description;
 #else
   return std::string();
 #endif  // BUILDFLAG(IS_ANDROID)
@@ -375,7 +459,7 @@ std::string SystemSnapshotLinux::MachineDescription() const {
 bool SystemSnapshotLinux::NXEnabled() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 #if defined(ARCH_CPU_X86_FAMILY)
-  return cpuid_.NXEnabled();
+  return invariant_info_->cpuid.NXEnabled();
 #elif defined(ARCH_CPU_ARM_FAMILY)
   // TODO(jperaza): do this. https://crashpad.chromium.org/bug/30
   return false;
@@ -404,41 +488,5 @@ void SystemSnapshotLinux::TimeZone(DaylightSavingTimeStatus* dst_status,
                      daylight_name);
 }
 
-void SystemSnapshotLinux::ReadKernelVersion(const std::string& version_string) {
-  std::vector<std::string> versions = SplitString(version_string, '.');
-  if (versions.size() < 3) {
-    LOG(WARNING) << "format error";
-    return;
-  }
-
-  if (!base::StringToInt(base::StringPiece(versions[0]), &os_version_major_)) {
-    LOG(WARNING) << "no kernel version";
-    return;
-  }
-  DCHECK_GE(os_version_major_, 3);
-
-  if (!base::StringToInt(base::StringPiece(versions[1]), &os_version_minor_)) {
-    LOG(WARNING) << "no major revision";
-    return;
-  }
-  DCHECK_GE(os_version_minor_, 0);
-
-  size_t minor_rev_end = versions[2].find_first_not_of("0123456789");
-  if (minor_rev_end == std::string::npos) {
-    minor_rev_end = versions[2].size();
-  }
-  if (!base::StringToInt(base::StringPiece(versions[2].c_str(), minor_rev_end),
-                         &os_version_bugfix_)) {
-    LOG(WARNING) << "no minor revision";
-    return;
-  }
-  DCHECK_GE(os_version_bugfix_, 0);
-
-  if (!os_version_build_.empty()) {
-    os_version_build_.push_back(' ');
-  }
-  os_version_build_ += versions[2].substr(minor_rev_end);
-}
-
 }  // namespace internal
 }  // namespace crashpad
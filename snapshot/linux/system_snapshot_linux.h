@@ -25,10 +25,6 @@
 #include "snapshot/system_snapshot.h"
 #include "util/misc/initialization_state_dcheck.h"
 
-#if defined(ARCH_CPU_X86_FAMILY)
-#include "snapshot/x86/cpuid_reader.h"
-#endif  // ARCH_CPU_X86_FAMILY
-
 namespace crashpad {
 namespace internal {
 
@@ -92,18 +88,19 @@ class SystemSnapshotLinux final : public SystemSnapshot {
   uint64_t AddressMask() const override { return 0; }
 
  private:
-  void ReadKernelVersion(const std::string& version_string);
+  //! \brief System information that can't change while the handler is
+  //!     running.
+  //!
+  //! This is collected by the first SystemSnapshotLinux to be initialized and
+  //! shared by every later one, so that captures don't each repeat `uname`,
+  //! `cpuid`, and Android system property lookups.
+  struct InvariantInfo;
+
+  static const InvariantInfo& GetInvariantInfo();
 
-  std::string os_version_full_;
-  std::string os_version_build_;
   ProcessReaderLinux* process_reader_;  // weak
   const timeval* snapshot_time_;  // weak
-#if defined(ARCH_CPU_X86_FAMILY)
-  CpuidReader cpuid_;
-#endif  // ARCH_CPU_X86_FAMILY
-  int os_version_major_;
-  int os_version_minor_;
-  int os_version_bugfix_;
+  const InvariantInfo* invariant_info_;  // weak
   uint32_t target_cpu_;
   uint8_t cpu_count_;
   InitializationStateDcheck initialized_;
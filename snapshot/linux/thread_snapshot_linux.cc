@@ -131,19 +131,28 @@ ThreadSnapshotLinux::ThreadSnapshotLinux()
     : ThreadSnapshot(),
       context_union_(),
       context_(),
+      thread_(),
       stack_(),
       thread_specific_data_address_(0),
       thread_name_(),
       thread_id_(-1),
       priority_(-1),
-      initialized_() {}
+      process_reader_(nullptr),
+      indirect_memory_budget_remaining_(nullptr),
+      capture_timings_(nullptr),
+      indirect_memory_depth_(1),
+      initialized_(),
+      pointed_to_memory_(),
+      pointed_to_memory_gathered_(false) {}
 
 ThreadSnapshotLinux::~ThreadSnapshotLinux() {}
 
 bool ThreadSnapshotLinux::Initialize(
     ProcessReaderLinux* process_reader,
     const ProcessReaderLinux::Thread& thread,
-    uint32_t* gather_indirectly_referenced_memory_bytes_remaining) {
+    uint32_t* gather_indirectly_referenced_memory_bytes_remaining,
+    CaptureTimings* capture_timings,
+    size_t indirect_memory_depth) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
 #if defined(ARCH_CPU_X86_FAMILY)
@@ -216,12 +225,15 @@ bool ThreadSnapshotLinux::Initialize(
                 thread.static_priority, thread.sched_policy, thread.nice_value)
           : -1;
 
-  CaptureMemoryDelegateLinux capture_memory_delegate(
-      process_reader,
-      &thread,
-      &pointed_to_memory_,
-      gather_indirectly_referenced_memory_bytes_remaining);
-  CaptureMemory::PointedToByContext(context_, &capture_memory_delegate);
+  // Everything needed to locate indirectly referenced memory is kept so that
+  // GatherPointedToMemory() can do it later, if it's needed at all.
+  thread_ = thread;
+  process_reader_ = process_reader;
+  indirect_memory_budget_remaining_ =
+      gather_indirectly_referenced_memory_bytes_remaining;
+  capture_timings_ = capture_timings;
+  indirect_memory_depth_ = indirect_memory_depth;
+  pointed_to_memory_gathered_ = !indirect_memory_budget_remaining_;
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
@@ -264,6 +276,10 @@ uint64_t ThreadSnapshotLinux::ThreadSpecificDataAddress() const {
 
 std::vector<const MemorySnapshot*> ThreadSnapshotLinux::ExtraMemory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!pointed_to_memory_gathered_) {
+    GatherPointedToMemory();
+  }
+
   std::vector<const MemorySnapshot*> result;
   result.reserve(pointed_to_memory_.size());
   for (const auto& pointed_to_memory : pointed_to_memory_) {
@@ -272,5 +288,36 @@ std::vector<const MemorySnapshot*> ThreadSnapshotLinux::ExtraMemory() const {
   return result;
 }
 
+const ExtendedRegisterState* ThreadSnapshotLinux::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return &thread_.extended_registers;
+}
+
+const ThreadSchedulingStats* ThreadSnapshotLinux::SchedulingStats() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return thread_.have_scheduling_stats ? &thread_.scheduling_stats : nullptr;
+}
+
+void ThreadSnapshotLinux::GatherPointedToMemory() const {
+  pointed_to_memory_gathered_ = true;
+
+  ScopedCapturePhase capture_phase(capture_timings_,
+                                   CapturePhase::kIndirectMemory,
+                                   process_reader_->Memory());
+  CaptureMemoryDelegateLinux capture_memory_delegate(
+      process_reader_,
+      &thread_,
+      &pointed_to_memory_,
+      indirect_memory_budget_remaining_);
+  // JIT code is captured first, so that pointers followed from the context
+  // don't use up the budget before it.
+  if (indirect_memory_budget_remaining_ &&
+      *indirect_memory_budget_remaining_ > 0) {
+    CaptureMemory::JitCodeAroundContext(context_, &capture_memory_delegate);
+  }
+  CaptureMemory::PointedToByContextRecursively(
+      context_, indirect_memory_depth_, &capture_memory_delegate);
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_SNAPSHOT_LINUX_THREAD_SNAPSHOT_LINUX_H_
 #define CRASHPAD_SNAPSHOT_LINUX_THREAD_SNAPSHOT_LINUX_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "build/build_config.h"
@@ -23,6 +24,7 @@
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/memory_snapshot_generic.h"
 #include "snapshot/thread_snapshot.h"
+#include "util/misc/capture_timings.h"
 #include "util/misc/initialization_state_dcheck.h"
 
 namespace crashpad {
@@ -44,13 +46,29 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   //!     the thread.
   //! \param[in] thread The thread within the ProcessReaderLinux for
   //!     which the snapshot should be created.
+  //! \param[in] gather_indirectly_referenced_memory_bytes_remaining If not
+  //!     `nullptr`, the budget shared with other snapshots for capturing
+  //!     memory referenced by the thread's context. This must outlive this
+  //!     object.
+  //! \param[in] capture_timings If not `nullptr`, the time spent locating
+  //!     indirectly referenced memory is charged to
+  //!     CapturePhase::kIndirectMemory here. This must outlive this object.
+  //! \param[in] indirect_memory_depth The number of levels of pointers to
+  //!     follow from the thread's context when capturing indirectly
+  //!     referenced memory. See CaptureMemory::PointedToByContextRecursively().
+  //!
+  //! Memory referenced by the thread's context is not located until
+  //! ExtraMemory() is first called, so consumers that never ask for it, such
+  //! as a sanitized snapshot that rejects the crash, don't pay for it.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     a message logged.
   bool Initialize(
       ProcessReaderLinux* process_reader,
       const ProcessReaderLinux::Thread& thread,
-      uint32_t* gather_indirectly_referenced_memory_bytes_remaining);
+      uint32_t* gather_indirectly_referenced_memory_bytes_remaining,
+      CaptureTimings* capture_timings,
+      size_t indirect_memory_depth = 1);
 
   // ThreadSnapshot:
 
@@ -62,8 +80,12 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
+  const ThreadSchedulingStats* SchedulingStats() const override;
 
  private:
+  void GatherPointedToMemory() const;
+
   union {
 #if defined(ARCH_CPU_X86_FAMILY)
     CPUContextX86 x86;
@@ -81,13 +103,20 @@ class ThreadSnapshotLinux final : public ThreadSnapshot {
 #endif  // ARCH_CPU_X86_FAMILY
   } context_union_;
   CPUContext context_;
+  ProcessReaderLinux::Thread thread_;
   MemorySnapshotGeneric stack_;
   LinuxVMAddress thread_specific_data_address_;
   std::string thread_name_;
   pid_t thread_id_;
   int priority_;
+  ProcessReaderLinux* process_reader_;  // weak
+  uint32_t* indirect_memory_budget_remaining_;  // weak
+  CaptureTimings* capture_timings_;  // weak
+  size_t indirect_memory_depth_;
   InitializationStateDcheck initialized_;
-  std::vector<std::unique_ptr<MemorySnapshotGeneric>> pointed_to_memory_;
+  mutable std::vector<std::unique_ptr<MemorySnapshotGeneric>>
+      pointed_to_memory_;
+  mutable bool pointed_to_memory_gathered_;
 };
 
 }  // namespace internal
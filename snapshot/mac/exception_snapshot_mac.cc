@@ -259,5 +259,10 @@ std::vector<const MemorySnapshot*> ExceptionSnapshotMac::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState* ExceptionSnapshotMac::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -80,6 +80,7 @@ class ExceptionSnapshotMac final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  virtual const ExtendedRegisterState* ExtendedRegisters() const override;
 
  private:
   union {
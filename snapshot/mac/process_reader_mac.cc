@@ -15,8 +15,10 @@
 #include "snapshot/mac/process_reader_mac.h"
 
 #include <Availability.h>
+#include <mach-o/dyld_images.h>
 #include <mach-o/loader.h>
 #include <mach/mach_vm.h>
+#include <string.h>
 
 #include <algorithm>
 #include <utility>
@@ -38,29 +40,26 @@ void MachTimeValueToTimeval(const time_value& mach, timeval* tv) {
   tv->tv_usec = mach.microseconds;
 }
 
-kern_return_t MachVMRegionRecurseDeepest(task_t task,
-                                         mach_vm_address_t* address,
-                                         mach_vm_size_t* size,
-                                         natural_t* depth,
-                                         vm_prot_t* protection,
-                                         unsigned int* user_tag) {
-  vm_region_submap_short_info_64 submap_info;
-  mach_msg_type_number_t count = VM_REGION_SUBMAP_SHORT_INFO_COUNT_64;
+kern_return_t MachVMRegionRecurseDeepest(
+    task_t task,
+    mach_vm_address_t* address,
+    mach_vm_size_t* size,
+    natural_t* depth,
+    vm_region_submap_short_info_64* submap_info) {
   while (true) {
+    mach_msg_type_number_t count = VM_REGION_SUBMAP_SHORT_INFO_COUNT_64;
     kern_return_t kr = mach_vm_region_recurse(
         task,
         address,
         size,
         depth,
-        reinterpret_cast<vm_region_recurse_info_t>(&submap_info),
+        reinterpret_cast<vm_region_recurse_info_t>(submap_info),
         &count);
     if (kr != KERN_SUCCESS) {
       return kr;
     }
 
-    if (!submap_info.is_submap) {
-      *protection = submap_info.protection;
-      *user_tag = submap_info.user_tag;
+    if (!submap_info->is_submap) {
       return KERN_SUCCESS;
     }
 
@@ -68,6 +67,30 @@ kern_return_t MachVMRegionRecurseDeepest(task_t task,
   }
 }
 
+kern_return_t MachVMRegionRecurseDeepest(task_t task,
+                                         mach_vm_address_t* address,
+                                         mach_vm_size_t* size,
+                                         natural_t* depth,
+                                         vm_prot_t* protection,
+                                         unsigned int* user_tag) {
+  vm_region_submap_short_info_64 submap_info;
+  kern_return_t kr =
+      MachVMRegionRecurseDeepest(task, address, size, depth, &submap_info);
+  if (kr == KERN_SUCCESS) {
+    *protection = submap_info.protection;
+    *user_tag = submap_info.user_tag;
+  }
+  return kr;
+}
+
+// Returns true if |submap_info| describes memory in a submap, such as the
+// shared region, that is readable and can never become writable.
+bool IsImmutableSubmapRegion(natural_t depth,
+                             const vm_region_submap_short_info_64& info) {
+  return depth > 0 && (info.protection & VM_PROT_READ) &&
+         !(info.max_protection & VM_PROT_WRITE);
+}
+
 }  // namespace
 
 namespace crashpad {
@@ -111,7 +134,7 @@ ProcessReaderMac::~ProcessReaderMac() {
   }
 }
 
-bool ProcessReaderMac::Initialize(task_t task) {
+bool ProcessReaderMac::Initialize(task_t task, size_t mapping_cache_size) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (!process_info_.InitializeWithTask(task)) {
@@ -121,6 +144,7 @@ bool ProcessReaderMac::Initialize(task_t task) {
   if (!process_memory_.Initialize(task)) {
     return false;
   }
+  process_memory_.SetMappingCacheSize(mapping_cache_size);
 
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT)
   is_64_bit_ = process_info_.Is64Bit();
@@ -445,6 +469,8 @@ void ProcessReaderMac::InitializeModules() {
     return;
   }
 
+  InitializeIdenticalSharedCache(all_image_infos);
+
   // Note that all_image_infos.infoArrayCount may be 0 if a crash occurred while
   // dyld was loading the executable. This can happen if a required dynamic
   // library was not found. Similarly, all_image_infos.infoArray may be nullptr
@@ -599,6 +625,80 @@ void ProcessReaderMac::InitializeModules() {
   }
 }
 
+void ProcessReaderMac::InitializeIdenticalSharedCache(
+    const process_types::dyld_all_image_infos& all_image_infos) {
+#if __MAC_OS_X_VERSION_MAX_ALLOWED >= __MAC_10_12
+  if (all_image_infos.version < 15 || !all_image_infos.sharedCacheBaseAddress) {
+    return;
+  }
+
+  task_dyld_info_data_t dyld_info;
+  mach_msg_type_number_t count = TASK_DYLD_INFO_COUNT;
+  kern_return_t kr = task_info(mach_task_self(),
+                               TASK_DYLD_INFO,
+                               reinterpret_cast<task_info_t>(&dyld_info),
+                               &count);
+  if (kr != KERN_SUCCESS) {
+    MACH_LOG(WARNING, kr) << "task_info";
+    return;
+  }
+
+  const dyld_all_image_infos* self_image_infos =
+      reinterpret_cast<const dyld_all_image_infos*>(
+          dyld_info.all_image_info_addr);
+  static_assert(sizeof(self_image_infos->sharedCacheUUID) ==
+                    sizeof(all_image_infos.sharedCacheUUID),
+                "sharedCacheUUID size");
+  if (!self_image_infos || self_image_infos->version < 15 ||
+      self_image_infos->sharedCacheBaseAddress !=
+          all_image_infos.sharedCacheBaseAddress ||
+      memcmp(self_image_infos->sharedCacheUUID,
+             all_image_infos.sharedCacheUUID,
+             sizeof(all_image_infos.sharedCacheUUID)) != 0) {
+    return;
+  }
+
+  // Walk the current task’s mapping of the shared cache, which lives in the
+  // shared region submap, and register the parts of it that are immutable in
+  // both tasks.
+  mach_vm_address_t address = all_image_infos.sharedCacheBaseAddress;
+  while (true) {
+    mach_vm_size_t size;
+    natural_t depth = 0;
+    vm_region_submap_short_info_64 info;
+    if (MachVMRegionRecurseDeepest(
+            mach_task_self(), &address, &size, &depth, &info) !=
+            KERN_SUCCESS ||
+        depth == 0) {
+      // This is past the end of the shared region.
+      break;
+    }
+
+    if (IsImmutableSubmapRegion(depth, info)) {
+      mach_vm_address_t target_address = address;
+      mach_vm_size_t target_size;
+      natural_t target_depth = 0;
+      vm_region_submap_short_info_64 target_info;
+      if (MachVMRegionRecurseDeepest(task_,
+                                     &target_address,
+                                     &target_size,
+                                     &target_depth,
+                                     &target_info) == KERN_SUCCESS &&
+          target_address <= address &&
+          IsImmutableSubmapRegion(target_depth, target_info)) {
+        mach_vm_address_t end =
+            std::min(address + size, target_address + target_size);
+        if (end > address) {
+          process_memory_.AddIdenticalLocalRange(address, end - address);
+        }
+      }
+    }
+
+    address += size;
+  }
+#endif  // __MAC_OS_X_VERSION_MAX_ALLOWED >= __MAC_10_12
+}
+
 mach_vm_address_t ProcessReaderMac::CalculateStackRegion(
     mach_vm_address_t stack_pointer,
     mach_vm_size_t* stack_region_size) {
@@ -43,6 +43,10 @@ namespace crashpad {
 
 class MachOImageReader;
 
+namespace process_types {
+struct dyld_all_image_infos;
+}  // namespace process_types
+
 //! \brief Accesses information about another process, identified by a Mach
 //!     task.
 class ProcessReaderMac {
@@ -122,11 +126,15 @@ class ProcessReaderMac {
   //!
   //! \param[in] task A send right to the target task’s task port. This object
   //!     does not take ownership of the send right.
+  //! \param[in] mapping_cache_size The number of recently mapped regions of
+  //!     the target task’s memory to keep for reuse. See
+  //!     ProcessMemoryMac::SetMappingCacheSize(). This should only be nonzero
+  //!     when \a task is suspended.
   //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
-  bool Initialize(task_t task);
+  bool Initialize(task_t task, size_t mapping_cache_size = 0);
 
   //! \return `true` if the target task is a 64-bit process.
 #if defined(CRASHPAD_MAC_32_BIT_SUPPORT) || DOXYGEN
@@ -194,6 +202,21 @@ class ProcessReaderMac {
   //! Modules().
   void InitializeModules();
 
+  //! \brief Allows the target task’s dyld shared cache to be read from the
+  //!     current task’s, when both tasks use the same one.
+  //!
+  //! A shared cache with the same UUID mapped at the same base address in both
+  //! tasks has identical read-only contents, which include the Mach-O headers,
+  //! load commands, and image paths of every image in it. The read-only
+  //! regions of the shared cache that are mapped identically in both tasks
+  //! are registered with ProcessMemoryMac::AddIdenticalLocalRange(), so that
+  //! reading these structures for the hundreds of images in the shared cache
+  //! doesn’t require mapping memory from the target task.
+  //!
+  //! \param[in] all_image_infos The target task’s `dyld_all_image_infos`.
+  void InitializeIdenticalSharedCache(
+      const process_types::dyld_all_image_infos& all_image_infos);
+
   //! \brief Calculates the base address and size of the region used as a
   //!     thread’s stack.
   //!
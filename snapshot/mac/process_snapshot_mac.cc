@@ -38,7 +38,7 @@ ProcessSnapshotMac::ProcessSnapshotMac()
 ProcessSnapshotMac::~ProcessSnapshotMac() {
 }
 
-bool ProcessSnapshotMac::Initialize(task_t task) {
+bool ProcessSnapshotMac::Initialize(task_t task, size_t mapping_cache_size) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   if (gettimeofday(&snapshot_time_, nullptr) != 0) {
@@ -46,7 +46,7 @@ bool ProcessSnapshotMac::Initialize(task_t task) {
     return false;
   }
 
-  if (!process_reader_.Initialize(task)) {
+  if (!process_reader_.Initialize(task, mapping_cache_size)) {
     return false;
   }
 
@@ -58,10 +58,14 @@ class ProcessSnapshotMac final : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] task The task to create a snapshot from.
+  //! \param[in] mapping_cache_size The number of recently mapped regions of
+  //!     \a task’s memory to keep for reuse while reading it. See
+  //!     ProcessMemoryMac::SetMappingCacheSize(). This should only be nonzero
+  //!     when \a task is suspended for the lifetime of this object.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
-  bool Initialize(task_t task);
+  bool Initialize(task_t task, size_t mapping_cache_size = 0);
 
   //! \brief Initializes the object’s exception.
   //!
@@ -133,5 +133,13 @@ std::vector<const MemorySnapshot*> ThreadSnapshotMac::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState* ThreadSnapshotMac::ExtendedRegisters() const {
+  return nullptr;
+}
+
+const ThreadSchedulingStats* ThreadSnapshotMac::SchedulingStats() const {
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
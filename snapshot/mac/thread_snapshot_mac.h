@@ -67,6 +67,8 @@ class ThreadSnapshotMac final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
+  const ThreadSchedulingStats* SchedulingStats() const override;
 
  private:
   union {
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 
+#include "base/check_op.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
@@ -79,8 +80,55 @@ bool DetermineMergedRangeImpl(bool log,
   return true;
 }
 
+// Divides the data provided by a single call to MemorySnapshotDelegateRead()
+// among calls to another delegate, on behalf of
+// MemorySnapshot::ReadInChunks().
+class ChunkingDelegate final : public MemorySnapshot::Delegate {
+ public:
+  ChunkingDelegate(MemorySnapshot::Delegate* delegate, size_t chunk_size)
+      : delegate_(delegate), chunk_size_(chunk_size) {}
+
+  ChunkingDelegate(const ChunkingDelegate&) = delete;
+  ChunkingDelegate& operator=(const ChunkingDelegate&) = delete;
+
+  ~ChunkingDelegate() override = default;
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    if (size == 0) {
+      return delegate_->MemorySnapshotDelegateRead(data, size);
+    }
+
+    char* data_c = static_cast<char*>(data);
+    while (size > 0) {
+      size_t chunk = std::min(size, chunk_size_);
+      if (!delegate_->MemorySnapshotDelegateRead(data_c, chunk)) {
+        return false;
+      }
+      data_c += chunk;
+      size -= chunk;
+    }
+    return true;
+  }
+
+ private:
+  MemorySnapshot::Delegate* delegate_;  // weak
+  size_t chunk_size_;
+};
+
 }  // namespace
 
+bool MemorySnapshot::ReadInChunks(Delegate* delegate, size_t chunk_size) const {
+  DCHECK_GT(chunk_size, 0u);
+  ChunkingDelegate chunking_delegate(delegate, chunk_size);
+  return Read(&chunking_delegate);
+}
+
+std::vector<CheckedRange<uint64_t, size_t>> MemorySnapshot::UnpopulatedRanges()
+    const {
+  return std::vector<CheckedRange<uint64_t, size_t>>();
+}
+
 bool LoggingDetermineMergedRange(const MemorySnapshot* a,
                                  const MemorySnapshot* b,
                                  CheckedRange<uint64_t, size_t>* merged) {
@@ -19,6 +19,7 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <vector>
 
 #include "util/numeric/checked_range.h"
 
@@ -75,6 +76,40 @@ class MemorySnapshot {
   //!     success and `false` on failure.
   virtual bool Read(Delegate* delegate) const = 0;
 
+  //! \brief Calls Delegate::MemorySnapshotDelegateRead() one or more times,
+  //!     providing it with the memory snapshot’s data in consecutive pieces.
+  //!
+  //! Each call to the delegate provides the data immediately following the
+  //! data provided by the previous call, and no call provides more than \a
+  //! chunk_size bytes. An empty snapshot results in a single call with a size
+  //! of `0`.
+  //!
+  //! The default implementation calls Read() and divides the data that it
+  //! provides, so it does not reduce the amount of memory used. Implementations
+  //! that load data lazily should override this method to hold no more than \a
+  //! chunk_size bytes of snapshot data at once.
+  //!
+  //! \param[in] delegate The delegate to receive the data.
+  //! \param[in] chunk_size The maximum size of the data provided to each call
+  //!     to the delegate. Must be greater than `0`.
+  //!
+  //! \return `false` on failure, including if a call to the delegate returned
+  //!     `false`, and `true` on success. On failure, the delegate may already
+  //!     have received some of the data.
+  virtual bool ReadInChunks(Delegate* delegate, size_t chunk_size) const;
+
+  //! \brief Returns the parts of the memory snapshot that the snapshot
+  //!     process never populated.
+  //!
+  //! These parts read as zeroes, and implementations that can determine them
+  //! avoid reading them from the snapshot process. The default implementation
+  //! reports none.
+  //!
+  //! \return Ranges within the memory snapshot, sorted by address and neither
+  //!     overlapping nor abutting one another.
+  virtual std::vector<CheckedRange<uint64_t, size_t>> UnpopulatedRanges()
+      const;
+
   //! \brief Creates a new MemorySnapshot based on merging this one with \a
   //!     other.
   //!
@@ -16,8 +16,14 @@
 #define CRASHPAD_SNAPSHOT_MEMORY_SNAPSHOT_GENERIC_H_
 
 #include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/check_op.h"
 #include "base/logging.h"
 #include "base/numerics/safe_math.h"
 #include "snapshot/memory_snapshot.h"
@@ -79,13 +85,56 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
       return delegate->MemorySnapshotDelegateRead(nullptr, size_);
     }
 
+    std::vector<CheckedRange<VMAddress, VMSize>> unpopulated;
+    process_memory_->UnpopulatedRanges(address_, size_, &unpopulated);
+
     std::unique_ptr<uint8_t[]> buffer(new uint8_t[size_]);
-    if (!process_memory_->Read(address_, size_, buffer.get())) {
+    if (!ReadPopulated(address_, size_, unpopulated, buffer.get())) {
       return false;
     }
     return delegate->MemorySnapshotDelegateRead(buffer.get(), size_);
   }
 
+  bool ReadInChunks(Delegate* delegate, size_t chunk_size) const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+    DCHECK_GT(chunk_size, 0u);
+
+    if (size_ <= chunk_size) {
+      return Read(delegate);
+    }
+
+    std::vector<CheckedRange<VMAddress, VMSize>> unpopulated;
+    process_memory_->UnpopulatedRanges(address_, size_, &unpopulated);
+
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[chunk_size]);
+    size_t offset = 0;
+    while (offset < size_) {
+      size_t read_size = std::min(chunk_size, size_ - offset);
+      if (!ReadPopulated(
+              address_ + offset, read_size, unpopulated, buffer.get()) ||
+          !delegate->MemorySnapshotDelegateRead(buffer.get(), read_size)) {
+        return false;
+      }
+      offset += read_size;
+    }
+    return true;
+  }
+
+  std::vector<CheckedRange<uint64_t, size_t>> UnpopulatedRanges()
+      const override {
+    INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+    std::vector<CheckedRange<VMAddress, VMSize>> unpopulated;
+    process_memory_->UnpopulatedRanges(address_, size_, &unpopulated);
+
+    std::vector<CheckedRange<uint64_t, size_t>> ranges;
+    ranges.reserve(unpopulated.size());
+    for (const auto& range : unpopulated) {
+      ranges.emplace_back(range.base(), static_cast<size_t>(range.size()));
+    }
+    return ranges;
+  }
+
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override {
     const MemorySnapshotGeneric* other_as_memory_snapshot_concrete =
@@ -104,6 +153,46 @@ class MemorySnapshotGeneric final : public MemorySnapshot {
   }
 
  private:
+  // Reads the size bytes at address into buffer, filling the parts of it that
+  // lie within unpopulated with zeroes instead of reading them. unpopulated
+  // must be sorted and must not overlap.
+  bool ReadPopulated(
+      VMAddress address,
+      size_t size,
+      const std::vector<CheckedRange<VMAddress, VMSize>>& unpopulated,
+      uint8_t* buffer) const {
+    if (unpopulated.empty()) {
+      return process_memory_->Read(address, size, buffer);
+    }
+
+    // The populated parts are read in a single batch.
+    std::vector<ProcessMemory::ReadRange> populated;
+    const VMAddress end = address + size;
+    VMAddress position = address;
+    for (const auto& range : unpopulated) {
+      if (range.end() <= position) {
+        continue;
+      }
+      if (range.base() >= end) {
+        break;
+      }
+      if (range.base() > position) {
+        populated.push_back({position,
+                             range.base() - position,
+                             buffer + (position - address)});
+      }
+      const VMAddress zero_end = std::min(range.end(), end);
+      const VMAddress zero_begin = std::max(range.base(), position);
+      memset(buffer + (zero_begin - address), 0, zero_end - zero_begin);
+      position = zero_end;
+    }
+    if (position < end) {
+      populated.push_back(
+          {position, end - position, buffer + (position - address)});
+    }
+    return populated.empty() || process_memory_->ReadBatch(populated, nullptr);
+  }
+
   template <class T>
   friend const MemorySnapshot* MergeWithOtherSnapshotImpl(
       const T* self,
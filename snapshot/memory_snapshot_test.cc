@@ -14,6 +14,9 @@
 
 #include "snapshot/memory_snapshot.h"
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "snapshot/test/test_memory_snapshot.h"
 
@@ -21,6 +24,60 @@ namespace crashpad {
 namespace test {
 namespace {
 
+class ChunkRecordingDelegate : public MemorySnapshot::Delegate {
+ public:
+  ChunkRecordingDelegate() = default;
+
+  ChunkRecordingDelegate(const ChunkRecordingDelegate&) = delete;
+  ChunkRecordingDelegate& operator=(const ChunkRecordingDelegate&) = delete;
+
+  ~ChunkRecordingDelegate() override = default;
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    chunk_sizes_.push_back(size);
+    if (size) {
+      data_.append(static_cast<const char*>(data), size);
+    }
+    return true;
+  }
+
+  const std::vector<size_t>& chunk_sizes() const { return chunk_sizes_; }
+  const std::string& data() const { return data_; }
+
+ private:
+  std::vector<size_t> chunk_sizes_;
+  std::string data_;
+};
+
+TEST(MemorySnapshot, ReadInChunks) {
+  TestMemorySnapshot snapshot;
+  snapshot.SetAddress(0x1000);
+  snapshot.SetSize(10);
+  snapshot.SetValue('m');
+
+  {
+    ChunkRecordingDelegate delegate;
+    ASSERT_TRUE(snapshot.ReadInChunks(&delegate, 4));
+    EXPECT_EQ(delegate.chunk_sizes(), std::vector<size_t>({4, 4, 2}));
+    EXPECT_EQ(delegate.data(), std::string(10, 'm'));
+  }
+
+  {
+    ChunkRecordingDelegate delegate;
+    ASSERT_TRUE(snapshot.ReadInChunks(&delegate, 10));
+    EXPECT_EQ(delegate.chunk_sizes(), std::vector<size_t>({10}));
+    EXPECT_EQ(delegate.data(), std::string(10, 'm'));
+  }
+
+  snapshot.SetSize(0);
+  {
+    ChunkRecordingDelegate delegate;
+    ASSERT_TRUE(snapshot.ReadInChunks(&delegate, 4));
+    EXPECT_EQ(delegate.chunk_sizes(), std::vector<size_t>({0}));
+    EXPECT_TRUE(delegate.data().empty());
+  }
+}
+
 TEST(DetermineMergedRange, NonOverlapping) {
   TestMemorySnapshot a;
   TestMemorySnapshot b;
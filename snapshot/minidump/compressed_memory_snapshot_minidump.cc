@@ -0,0 +1,291 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/compressed_memory_snapshot_minidump.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "third_party/zlib/zlib_crashpad.h"
+#include "util/misc/zlib.h"
+
+namespace crashpad {
+namespace internal {
+
+CompressedMemorySnapshotMinidump::CompressedMemorySnapshotMinidump()
+    : MemorySnapshot(),
+      blocks_(),
+      address_(0),
+      size_(0),
+      block_size_(0),
+      file_reader_(nullptr),
+      block_data_(),
+      compressed_data_(),
+      block_index_(std::numeric_limits<size_t>::max()),
+      initialized_() {}
+
+CompressedMemorySnapshotMinidump::~CompressedMemorySnapshotMinidump() {}
+
+bool CompressedMemorySnapshotMinidump::Initialize(
+    FileReaderInterface* file_reader,
+    RVA location) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  MinidumpCompressedMemoryRange range;
+  if (!file_reader->SeekSet(location) ||
+      !file_reader->ReadExactly(&range, sizeof(range))) {
+    return false;
+  }
+
+  if (range.data_size > std::numeric_limits<size_t>::max()) {
+    LOG(ERROR) << "compressed memory range size " << range.data_size
+               << " out of range";
+    return false;
+  }
+  if (range.block_size == 0 && range.data_size != 0) {
+    LOG(ERROR) << "compressed memory range has no block size";
+    return false;
+  }
+  if (range.block_size > MinidumpCompressedMemoryRange::kMaxBlockSize) {
+    LOG(ERROR) << "compressed memory block size " << range.block_size
+               << " out of range";
+    return false;
+  }
+
+  // With this many blocks, each block_size bytes but the last, the blocks’
+  // sizes sum to data_size.
+  const uint64_t expected_block_count =
+      range.data_size == 0
+          ? 0
+          : (range.data_size - 1) / range.block_size + 1;
+  if (range.block_count != expected_block_count) {
+    LOG(ERROR) << "compressed memory range block count mismatch";
+    return false;
+  }
+
+  // Check that the block index is present before allocating space for it.
+  const FileOffset file_size = file_reader->Seek(0, SEEK_END);
+  if (file_size < 0) {
+    return false;
+  }
+  const uint64_t blocks_size =
+      static_cast<uint64_t>(range.block_count) *
+      sizeof(MinidumpCompressedMemoryBlock);
+  if (range.blocks > static_cast<uint64_t>(file_size) ||
+      blocks_size > static_cast<uint64_t>(file_size) - range.blocks) {
+    LOG(ERROR) << "compressed memory blocks extend beyond end of file";
+    return false;
+  }
+
+  blocks_.resize(range.block_count);
+  if (!blocks_.empty() &&
+      (!file_reader->SeekSet(range.blocks) ||
+       !file_reader->ReadExactly(blocks_.data(), blocks_size))) {
+    return false;
+  }
+
+  // Check that the blocks are present and well-formed without reading them.
+  std::vector<std::pair<uint64_t, uint64_t>> block_extents;
+  block_extents.reserve(blocks_.size());
+  for (size_t index = 0; index < blocks_.size(); ++index) {
+    const MinidumpCompressedMemoryBlock& block = blocks_[index];
+    const uint64_t block_begin = block.data.Rva;
+    const uint64_t block_end = block_begin + block.data.DataSize;
+    if (block_end > static_cast<uint64_t>(file_size)) {
+      LOG(ERROR) << "compressed memory block extends beyond end of file";
+      return false;
+    }
+    switch (block.compression) {
+      case kMinidumpCompressedMemoryCompressionNone: {
+        const uint64_t block_offset =
+            static_cast<uint64_t>(index) * range.block_size;
+        if (block.data.DataSize != std::min<uint64_t>(
+                                       range.block_size,
+                                       range.data_size - block_offset)) {
+          LOG(ERROR) << "uncompressed memory block size mismatch";
+          return false;
+        }
+        break;
+      }
+      case kMinidumpCompressedMemoryCompressionZlib:
+        if (block.data.DataSize == 0 ||
+            block.data.DataSize > compressBound(range.block_size)) {
+          LOG(ERROR) << "compressed memory block size "
+                     << block.data.DataSize << " out of range";
+          return false;
+        }
+        break;
+      default:
+        LOG(ERROR) << "unknown memory block compression "
+                   << block.compression;
+        return false;
+    }
+    block_extents.emplace_back(block_begin, block_end);
+  }
+
+  // Blocks that share data would let a small file expand to far more memory
+  // than its size suggests.
+  std::sort(block_extents.begin(), block_extents.end());
+  for (size_t index = 1; index < block_extents.size(); ++index) {
+    if (block_extents[index].first < block_extents[index - 1].second) {
+      LOG(ERROR) << "compressed memory blocks overlap";
+      return false;
+    }
+  }
+
+  address_ = range.start_of_memory_range;
+  size_ = static_cast<size_t>(range.data_size);
+  block_size_ = range.block_size;
+  file_reader_ = file_reader;
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool CompressedMemorySnapshotMinidump::ReadRange(size_t offset,
+                                                 size_t size,
+                                                 void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_LE(offset, size_);
+  DCHECK_LE(size, size_ - offset);
+
+  uint8_t* buffer_c = static_cast<uint8_t*>(buffer);
+  while (size > 0) {
+    const std::vector<uint8_t>* block = Block(offset / block_size_);
+    if (!block) {
+      return false;
+    }
+    const size_t block_offset = offset % block_size_;
+    const size_t length = std::min(size, block->size() - block_offset);
+    memcpy(buffer_c, block->data() + block_offset, length);
+    buffer_c += length;
+    offset += length;
+    size -= length;
+  }
+  return true;
+}
+
+uint64_t CompressedMemorySnapshotMinidump::Address() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return address_;
+}
+
+size_t CompressedMemorySnapshotMinidump::Size() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return size_;
+}
+
+bool CompressedMemorySnapshotMinidump::Read(Delegate* delegate) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // The range’s size is taken from the file, so it is never held in memory at
+  // once.
+  return ReadInChunks(delegate, std::max<size_t>(block_size_, 1));
+}
+
+bool CompressedMemorySnapshotMinidump::ReadInChunks(Delegate* delegate,
+                                                    size_t chunk_size) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_GT(chunk_size, 0u);
+
+  if (blocks_.empty()) {
+    return delegate->MemorySnapshotDelegateRead(nullptr, 0);
+  }
+
+  for (size_t index = 0; index < blocks_.size(); ++index) {
+    const std::vector<uint8_t>* block = Block(index);
+    if (!block) {
+      return false;
+    }
+    // The delegate receives a pointer to non-const data, so it is given a
+    // copy of each chunk rather than the retained block.
+    for (size_t offset = 0; offset < block->size(); offset += chunk_size) {
+      const size_t length = std::min(chunk_size, block->size() - offset);
+      std::vector<uint8_t> chunk(block->begin() + offset,
+                                 block->begin() + offset + length);
+      if (!delegate->MemorySnapshotDelegateRead(chunk.data(), chunk.size())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+const MemorySnapshot* CompressedMemorySnapshotMinidump::MergeWithOtherSnapshot(
+    const MemorySnapshot* other) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Compressed ranges never overlap one another, and are never merged with
+  // the uncompressed ranges of the memory list.
+  LOG(ERROR) << "compressed memory snapshots can't be merged";
+  return nullptr;
+}
+
+const std::vector<uint8_t>* CompressedMemorySnapshotMinidump::Block(
+    size_t index) const {
+  DCHECK_LT(index, blocks_.size());
+
+  if (index == block_index_) {
+    return &block_data_;
+  }
+  block_index_ = std::numeric_limits<size_t>::max();
+
+  const MinidumpCompressedMemoryBlock& block = blocks_[index];
+  const size_t expected_size =
+      std::min(block_size_, size_ - index * block_size_);
+
+  if (!file_reader_->SeekSet(block.data.Rva)) {
+    return nullptr;
+  }
+
+  if (block.compression == kMinidumpCompressedMemoryCompressionNone) {
+    block_data_.resize(expected_size);
+    if (!file_reader_->ReadExactly(block_data_.data(), block_data_.size())) {
+      return nullptr;
+    }
+  } else {
+    compressed_data_.resize(block.data.DataSize);
+    if (!file_reader_->ReadExactly(compressed_data_.data(),
+                                   compressed_data_.size())) {
+      return nullptr;
+    }
+
+    block_data_.resize(expected_size);
+    uLongf decompressed_size = block_data_.size();
+    int zr = uncompress(block_data_.data(),
+                        &decompressed_size,
+                        compressed_data_.data(),
+                        compressed_data_.size());
+    if (zr != Z_OK) {
+      LOG(ERROR) << "uncompress: " << ZlibErrorString(zr);
+      return nullptr;
+    }
+    if (decompressed_size != expected_size) {
+      LOG(ERROR) << "compressed memory block size mismatch";
+      return nullptr;
+    }
+  }
+
+  block_index_ = index;
+  return &block_data_;
+}
+
+}  // namespace internal
+}  // namespace crashpad
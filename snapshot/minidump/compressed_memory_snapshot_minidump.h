@@ -0,0 +1,113 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MINIDUMP_COMPRESSED_MEMORY_SNAPSHOT_MINIDUMP_H_
+#define CRASHPAD_SNAPSHOT_MINIDUMP_COMPRESSED_MEMORY_SNAPSHOT_MINIDUMP_H_
+
+#include <windows.h>
+#include <dbghelp.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "snapshot/memory_snapshot.h"
+#include "util/file/file_reader.h"
+#include "util/misc/initialization_state_dcheck.h"
+
+namespace crashpad {
+namespace internal {
+
+//! \brief A MemorySnapshot based on a MinidumpCompressedMemoryRange in a
+//!     minidump file.
+//!
+//! Blocks are read from the file and decompressed only when the data that they
+//! hold is needed. The most recently decompressed block is retained, so that
+//! consecutive small reads within a block decompress it once. No more than a
+//! block is held in memory at once.
+//!
+//! This class is not thread-safe, because it shares its FileReaderInterface
+//! with other objects, and because of the retained block.
+class CompressedMemorySnapshotMinidump final : public MemorySnapshot {
+ public:
+  CompressedMemorySnapshotMinidump();
+
+  CompressedMemorySnapshotMinidump(const CompressedMemorySnapshotMinidump&) =
+      delete;
+  CompressedMemorySnapshotMinidump& operator=(
+      const CompressedMemorySnapshotMinidump&) = delete;
+
+  ~CompressedMemorySnapshotMinidump() override;
+
+  //! \brief Initializes the object.
+  //!
+  //! The block index is read and validated, but the blocks themselves are not
+  //! read until they are needed.
+  //!
+  //! \param[in] file_reader A file reader corresponding to a minidump file.
+  //!     The file reader must support seeking, and must outlive this object.
+  //! \param[in] location The location within the file of a
+  //!     MinidumpCompressedMemoryRange from which to initialize this object.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool Initialize(FileReaderInterface* file_reader, RVA location);
+
+  //! \brief Copies part of the range’s contents into \a buffer, decompressing
+  //!     only the blocks that hold it.
+  //!
+  //! \param[in] offset The offset into the range of the first byte to copy.
+  //! \param[in] size The number of bytes to copy. \a offset + \a size must not
+  //!     exceed Size().
+  //! \param[out] buffer The buffer to receive the data, at least \a size bytes
+  //!     long.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool ReadRange(size_t offset, size_t size, void* buffer) const;
+
+  // MemorySnapshot:
+  uint64_t Address() const override;
+  size_t Size() const override;
+
+  //! \copydoc MemorySnapshot::Read()
+  //!
+  //! Unlike most implementations, this provides the data one block at a time,
+  //! as ReadInChunks() does, so that the whole range is never held in memory.
+  bool Read(Delegate* delegate) const override;
+
+  bool ReadInChunks(Delegate* delegate, size_t chunk_size) const override;
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override;
+
+ private:
+  // Returns the decompressed contents of the block at index, retaining them in
+  // block_data_. Returns nullptr with a message logged on failure.
+  const std::vector<uint8_t>* Block(size_t index) const;
+
+  std::vector<MinidumpCompressedMemoryBlock> blocks_;
+  uint64_t address_;
+  size_t size_;
+  size_t block_size_;
+  FileReaderInterface* file_reader_;  // weak
+  mutable std::vector<uint8_t> block_data_;
+  mutable std::vector<uint8_t> compressed_data_;
+  mutable size_t block_index_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MINIDUMP_COMPRESSED_MEMORY_SNAPSHOT_MINIDUMP_H_
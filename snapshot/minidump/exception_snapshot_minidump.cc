@@ -107,5 +107,11 @@ std::vector<const MemorySnapshot*> ExceptionSnapshotMinidump::ExtraMemory()
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState*
+ExceptionSnapshotMinidump::ExtendedRegisters() const {
+  DCHECK(initialized_.is_valid());
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
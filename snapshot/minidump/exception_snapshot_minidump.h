@@ -61,6 +61,7 @@ class ExceptionSnapshotMinidump final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
 
   // Allow callers to explicitly check whether this exception snapshot has been
   // initialized.
@@ -14,8 +14,12 @@
 
 #include "snapshot/minidump/memory_snapshot_minidump.h"
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <memory>
 
+#include "base/logging.h"
 #include "base/numerics/safe_math.h"
 
 namespace crashpad {
@@ -24,6 +28,9 @@ namespace internal {
 MemorySnapshotMinidump::MemorySnapshotMinidump()
     : MemorySnapshot(),
       address_(0),
+      size_(0),
+      file_reader_(nullptr),
+      data_rva_(0),
       data_(),
       initialized_() {}
 
@@ -43,17 +50,23 @@ bool MemorySnapshotMinidump::Initialize(FileReaderInterface* file_reader,
     return false;
   }
 
-  address_ = descriptor.StartOfMemoryRange;
-  data_.resize(descriptor.Memory.DataSize);
-
-  if (!file_reader->SeekSet(descriptor.Memory.Rva)) {
+  // Check that the contents are present without reading them.
+  const FileOffset file_size = file_reader->Seek(0, SEEK_END);
+  if (file_size < 0) {
     return false;
   }
-
-  if (!file_reader->ReadExactly(data_.data(), data_.size())) {
+  if (static_cast<uint64_t>(descriptor.Memory.Rva) +
+          descriptor.Memory.DataSize >
+      static_cast<uint64_t>(file_size)) {
+    LOG(ERROR) << "memory descriptor extends beyond end of file";
     return false;
   }
 
+  address_ = descriptor.StartOfMemoryRange;
+  size_ = descriptor.Memory.DataSize;
+  file_reader_ = file_reader;
+  data_rva_ = descriptor.Memory.Rva;
+
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -65,13 +78,47 @@ uint64_t MemorySnapshotMinidump::Address() const {
 
 size_t MemorySnapshotMinidump::Size() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return data_.size();
+  return size_;
 }
 
 bool MemorySnapshotMinidump::Read(Delegate* delegate) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return delegate->MemorySnapshotDelegateRead(
-      const_cast<uint8_t*>(data_.data()), data_.size());
+
+  if (!file_reader_) {
+    return delegate->MemorySnapshotDelegateRead(
+        const_cast<uint8_t*>(data_.data()), data_.size());
+  }
+
+  std::vector<uint8_t> data;
+  if (!ReadData(&data)) {
+    return false;
+  }
+  return delegate->MemorySnapshotDelegateRead(data.data(), data.size());
+}
+
+bool MemorySnapshotMinidump::ReadInChunks(Delegate* delegate,
+                                          size_t chunk_size) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_GT(chunk_size, 0u);
+
+  if (!file_reader_ || size_ == 0) {
+    return MemorySnapshot::ReadInChunks(delegate, chunk_size);
+  }
+
+  // Read directly from the file a chunk at a time, so that no more than
+  // chunk_size bytes of the contents are held at once.
+  if (!file_reader_->SeekSet(data_rva_)) {
+    return false;
+  }
+  std::vector<uint8_t> chunk(std::min(chunk_size, size_));
+  for (size_t offset = 0; offset < size_; offset += chunk.size()) {
+    chunk.resize(std::min(chunk.size(), size_ - offset));
+    if (!file_reader_->ReadExactly(chunk.data(), chunk.size()) ||
+        !delegate->MemorySnapshotDelegateRead(chunk.data(), chunk.size())) {
+      return false;
+    }
+  }
+  return true;
 }
 
 const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
@@ -94,18 +141,37 @@ const MemorySnapshot* MemorySnapshotMinidump::MergeWithOtherSnapshot(
 
   auto result = std::make_unique<MemorySnapshotMinidump>();
   result->address_ = merged.base();
-  result->data_ = data_;
+  result->size_ = merged.size();
+  if (!ReadData(&result->data_)) {
+    return nullptr;
+  }
 
-  if (result->data_.size() == merged.size()) {
-    return result.release();
+  if (result->data_.size() != merged.size()) {
+    std::vector<uint8_t> other_data;
+    if (!other_cast->ReadData(&other_data)) {
+      return nullptr;
+    }
+    result->data_.resize(
+        base::checked_cast<size_t>(other_cast->address_ - address_));
+    result->data_.insert(
+        result->data_.end(), other_data.begin(), other_data.end());
   }
 
-  result->data_.resize(
-      base::checked_cast<size_t>(other_cast->address_ - address_));
-  result->data_.insert(result->data_.end(), other_cast->data_.begin(),
-                       other_cast->data_.end());
+  INITIALIZATION_STATE_SET_INITIALIZING(result->initialized_);
+  INITIALIZATION_STATE_SET_VALID(result->initialized_);
   return result.release();
 }
 
+bool MemorySnapshotMinidump::ReadData(std::vector<uint8_t>* data) const {
+  if (!file_reader_) {
+    *data = data_;
+    return true;
+  }
+
+  data->resize(size_);
+  return file_reader_->SeekSet(data_rva_) &&
+         file_reader_->ReadExactly(data->data(), data->size());
+}
+
 } // namespace internal
 } // namespace crashpad
@@ -37,8 +37,11 @@ class MemorySnapshotMinidump : public MemorySnapshot {
 
   //! \brief Initializes the object.
   //!
+  //! The memory’s contents are not read from the file until Read() is called,
+  //! so that they are only read if they are needed.
+  //!
   //! \param[in] file_reader A file reader corresponding to a minidump file.
-  //!     The file reader must support seeking.
+  //!     The file reader must support seeking, and must outlive this object.
   //! \param[in] location The location within the file where we will find a
   //!     MINIDUMP_MEMORY_DESCRIPTOR from which to initialize this object.
   //!
@@ -49,11 +52,23 @@ class MemorySnapshotMinidump : public MemorySnapshot {
   uint64_t Address() const override;
   size_t Size() const override;
   bool Read(Delegate* delegate) const override;
+  bool ReadInChunks(Delegate* delegate, size_t chunk_size) const override;
   const MemorySnapshot* MergeWithOtherSnapshot(
       const MemorySnapshot* other) const override;
 
  private:
+  // Obtains the memory’s contents, either from data_ or by reading them from
+  // file_reader_.
+  bool ReadData(std::vector<uint8_t>* data) const;
+
   uint64_t address_;
+  size_t size_;
+
+  // If file_reader_ is set, the contents are read from it at data_rva_.
+  // Otherwise, they are held in data_, as for the result of
+  // MergeWithOtherSnapshot().
+  FileReaderInterface* file_reader_;  // weak
+  RVA data_rva_;
   std::vector<uint8_t> data_;
   InitializationStateDcheck initialized_;
 };
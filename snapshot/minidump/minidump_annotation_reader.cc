@@ -16,7 +16,13 @@
 
 #include <stdint.h>
 
+#include <string>
+#include <vector>
+
 #include "base/logging.h"
+#include "client/annotation.h"
+#include "client/compressed_annotation.h"
+#include "client/seqlock_annotation.h"
 #include "minidump/minidump_extensions.h"
 #include "snapshot/minidump/minidump_string_reader.h"
 
@@ -108,6 +114,31 @@ bool ReadMinidumpAnnotationList(FileReaderInterface* file_reader,
       return false;
     }
 
+    // Compressed strings are presented as the strings they hold. One that
+    // can’t be decompressed is left as it is.
+    std::string decompressed;
+    if (annotation.type ==
+            static_cast<uint16_t>(Annotation::Type::kCompressedString) &&
+        DecompressAnnotationValue(
+            annotation.value.data(), annotation.value.size(), &decompressed)) {
+      annotation.type = static_cast<uint16_t>(Annotation::Type::kString);
+      annotation.value.assign(decompressed.begin(), decompressed.end());
+    }
+
+    // Seqlock strings are normally resolved when they’re captured, but readers
+    // that don’t know about them store the whole value. One that was copied
+    // mid-write is left as it is.
+    std::vector<uint8_t> string;
+    if (annotation.type ==
+            static_cast<uint16_t>(Annotation::Type::kSeqlockString) &&
+        ReadSeqlockAnnotationValue(annotation.value.data(),
+                                   annotation.value.size(),
+                                   nullptr,
+                                   &string)) {
+      annotation.type = static_cast<uint16_t>(Annotation::Type::kString);
+      annotation.value.swap(string);
+    }
+
     annotations.push_back(std::move(annotation));
   }
 
@@ -16,14 +16,222 @@
 
 #include <string.h>
 
-#include <iterator>
-
 #include "base/logging.h"
 #include "minidump/minidump_context.h"
 
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+// Each ConvertContext() overload converts one architecture’s minidump context
+// to its CPUContext equivalent. Register blocks laid out identically in both
+// structures are copied in bulk; size mismatches are caught at compile time.
+
+void ConvertContext(const MinidumpContextX86& src, CPUContextX86* dst) {
+  if (src.context_flags & kMinidumpContextX86Extended) {
+    dst->fxsave = src.fxsave;
+  } else if (src.context_flags & kMinidumpContextX86FloatingPoint) {
+    CPUContextX86::FsaveToFxsave(src.fsave, &dst->fxsave);
+  }
+
+  dst->eax = src.eax;
+  dst->ebx = src.ebx;
+  dst->ecx = src.ecx;
+  dst->edx = src.edx;
+  dst->edi = src.edi;
+  dst->esi = src.esi;
+  dst->ebp = src.ebp;
+  dst->esp = src.esp;
+  dst->eip = src.eip;
+  dst->eflags = src.eflags;
+  dst->cs = static_cast<uint16_t>(src.cs);
+  dst->ds = static_cast<uint16_t>(src.ds);
+  dst->es = static_cast<uint16_t>(src.es);
+  dst->fs = static_cast<uint16_t>(src.fs);
+  dst->gs = static_cast<uint16_t>(src.gs);
+  dst->ss = static_cast<uint16_t>(src.ss);
+  dst->dr0 = src.dr0;
+  dst->dr1 = src.dr1;
+  dst->dr2 = src.dr2;
+  dst->dr3 = src.dr3;
+  dst->dr6 = src.dr6;
+  dst->dr7 = src.dr7;
+
+  // Minidump passes no value for dr4/5. Our output context has space for
+  // them. According to spec they're obsolete, but when present read as
+  // aliases for dr6/7, so we'll do this.
+  dst->dr4 = src.dr6;
+  dst->dr5 = src.dr7;
+}
+
+void ConvertContext(const MinidumpContextAMD64& src, CPUContextX86_64* dst) {
+  dst->fxsave = src.fxsave;
+  dst->cs = src.cs;
+  dst->fs = src.fs;
+  dst->gs = src.gs;
+  dst->rflags = src.eflags;
+  dst->dr0 = src.dr0;
+  dst->dr1 = src.dr1;
+  dst->dr2 = src.dr2;
+  dst->dr3 = src.dr3;
+  dst->dr6 = src.dr6;
+  dst->dr7 = src.dr7;
+  dst->rax = src.rax;
+  dst->rcx = src.rcx;
+  dst->rdx = src.rdx;
+  dst->rbx = src.rbx;
+  dst->rsp = src.rsp;
+  dst->rbp = src.rbp;
+  dst->rsi = src.rsi;
+  dst->rdi = src.rdi;
+  dst->r8 = src.r8;
+  dst->r9 = src.r9;
+  dst->r10 = src.r10;
+  dst->r11 = src.r11;
+  dst->r12 = src.r12;
+  dst->r13 = src.r13;
+  dst->r14 = src.r14;
+  dst->r15 = src.r15;
+  dst->rip = src.rip;
+
+  // See comments on x86 above.
+  dst->dr4 = src.dr6;
+  dst->dr5 = src.dr7;
+}
+
+void ConvertContext(const MinidumpContextARM& src, CPUContextARM* dst) {
+  static_assert(sizeof(dst->regs) == sizeof(src.regs), "GPR size mismatch");
+  memcpy(dst->regs, src.regs, sizeof(src.regs));
+
+  dst->fp = src.fp;
+  dst->ip = src.ip;
+  dst->sp = src.sp;
+  dst->lr = src.lr;
+  dst->pc = src.pc;
+  dst->cpsr = src.cpsr;
+  dst->vfp_regs.fpscr = src.fpscr;
+
+  static_assert(sizeof(dst->vfp_regs.vfp) == sizeof(src.vfp),
+                "VFP size mismatch");
+  memcpy(dst->vfp_regs.vfp, src.vfp, sizeof(src.vfp));
+
+  dst->have_fpa_regs = false;
+  dst->have_vfp_regs = !!(src.context_flags & kMinidumpContextARMVFP);
+}
+
+void ConvertContext(const MinidumpContextARM64& src, CPUContextARM64* dst) {
+  // The minidump context carries fp and lr separately from x0-x28.
+  static_assert(sizeof(dst->regs) == sizeof(src.regs) + 2 * sizeof(src.fp),
+                "GPR size mismatch");
+  memcpy(dst->regs, src.regs, sizeof(src.regs));
+  dst->regs[29] = src.fp;
+  dst->regs[30] = src.lr;
+
+  static_assert(sizeof(dst->fpsimd) == sizeof(src.fpsimd),
+                "FPSIMD size mismatch");
+  memcpy(dst->fpsimd, src.fpsimd, sizeof(src.fpsimd));
+
+  dst->sp = src.sp;
+  dst->pc = src.pc;
+  dst->fpcr = src.fpcr;
+  dst->fpsr = src.fpsr;
+  dst->spsr = src.cpsr;
+}
+
+void ConvertContext(const MinidumpContextMIPS& src, CPUContextMIPS* dst) {
+  static_assert(sizeof(dst->regs) == sizeof(src.regs), "GPR size mismatch");
+  memcpy(dst->regs, src.regs, sizeof(src.regs));
+
+  dst->mdhi = static_cast<uint32_t>(src.mdhi);
+  dst->mdlo = static_cast<uint32_t>(src.mdlo);
+  dst->dsp_control = src.dsp_control;
+
+  static_assert(sizeof(dst->hi) == sizeof(src.hi) &&
+                    sizeof(dst->lo) == sizeof(src.lo),
+                "DSP accumulator size mismatch");
+  memcpy(dst->hi, src.hi, sizeof(src.hi));
+  memcpy(dst->lo, src.lo, sizeof(src.lo));
+
+  dst->cp0_epc = static_cast<uint32_t>(src.epc);
+  dst->cp0_badvaddr = static_cast<uint32_t>(src.badvaddr);
+  dst->cp0_status = src.status;
+  dst->cp0_cause = src.cause;
+  dst->fpcsr = src.fpcsr;
+  dst->fir = src.fir;
+
+  static_assert(sizeof(dst->fpregs) == sizeof(src.fpregs),
+                "FPR size mismatch");
+  memcpy(&dst->fpregs, &src.fpregs, sizeof(src.fpregs));
+}
+
+void ConvertContext(const MinidumpContextMIPS64& src, CPUContextMIPS64* dst) {
+  static_assert(sizeof(dst->regs) == sizeof(src.regs), "GPR size mismatch");
+  memcpy(dst->regs, src.regs, sizeof(src.regs));
+
+  dst->mdhi = src.mdhi;
+  dst->mdlo = src.mdlo;
+  dst->dsp_control = src.dsp_control;
+
+  static_assert(sizeof(dst->hi) == sizeof(src.hi) &&
+                    sizeof(dst->lo) == sizeof(src.lo),
+                "DSP accumulator size mismatch");
+  memcpy(dst->hi, src.hi, sizeof(src.hi));
+  memcpy(dst->lo, src.lo, sizeof(src.lo));
+
+  dst->cp0_epc = src.epc;
+  dst->cp0_badvaddr = src.badvaddr;
+  dst->cp0_status = src.status;
+  dst->cp0_cause = src.cause;
+  dst->fpcsr = src.fpcsr;
+  dst->fir = src.fir;
+
+  static_assert(sizeof(dst->fpregs) == sizeof(src.fpregs),
+                "FPR size mismatch");
+  memcpy(&dst->fpregs, &src.fpregs, sizeof(src.fpregs));
+}
+
+void ConvertContext(const MinidumpContextRISCV64& src,
+                    CPUContextRISCV64* dst) {
+  dst->pc = src.pc;
+
+  static_assert(sizeof(dst->regs) == sizeof(src.regs), "GPR size mismatch");
+  memcpy(dst->regs, src.regs, sizeof(src.regs));
+
+  static_assert(sizeof(dst->fpregs) == sizeof(src.fpregs),
+                "FPR size mismatch");
+  memcpy(dst->fpregs, src.fpregs, sizeof(src.fpregs));
+
+  dst->fcsr = src.fcsr;
+}
+
+// Validates |minidump_context| as a SourceContext carrying |required_flags|,
+// and converts it into a DestinationContext placed in |context_memory|.
+// Returns the converted context, or nullptr if |minidump_context| isn’t valid.
+template <typename DestinationContext, typename SourceContext>
+DestinationContext* ConvertContextInto(
+    uint32_t required_flags,
+    const std::vector<unsigned char>& minidump_context,
+    std::vector<unsigned char>* context_memory) {
+  if (minidump_context.size() < sizeof(SourceContext)) {
+    return nullptr;
+  }
+
+  const SourceContext* src =
+      reinterpret_cast<const SourceContext*>(minidump_context.data());
+  if (!(src->context_flags & required_flags)) {
+    return nullptr;
+  }
+
+  context_memory->assign(sizeof(DestinationContext), 0);
+  DestinationContext* dst =
+      reinterpret_cast<DestinationContext*>(context_memory->data());
+  ConvertContext(*src, dst);
+  return dst;
+}
+
+}  // namespace
+
 MinidumpContextConverter::MinidumpContextConverter() : initialized_() {
   context_.architecture = CPUArchitecture::kCPUArchitectureUnknown;
 }
@@ -42,260 +250,71 @@ bool MinidumpContextConverter::Initialize(
 
   context_.architecture = arch;
 
-  if (context_.architecture == CPUArchitecture::kCPUArchitectureX86) {
-    context_memory_.resize(sizeof(CPUContextX86));
-    context_.x86 = reinterpret_cast<CPUContextX86*>(context_memory_.data());
-    const MinidumpContextX86* src =
-        reinterpret_cast<const MinidumpContextX86*>(minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextX86)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextX86)) {
-      return false;
-    }
-
-    if (src->context_flags & kMinidumpContextX86Extended) {
-      context_.x86->fxsave = src->fxsave;
-    } else if (src->context_flags & kMinidumpContextX86FloatingPoint) {
-      CPUContextX86::FsaveToFxsave(src->fsave, &context_.x86->fxsave);
-    }
-
-    context_.x86->eax = src->eax;
-    context_.x86->ebx = src->ebx;
-    context_.x86->ecx = src->ecx;
-    context_.x86->edx = src->edx;
-    context_.x86->edi = src->edi;
-    context_.x86->esi = src->esi;
-    context_.x86->ebp = src->ebp;
-    context_.x86->esp = src->esp;
-    context_.x86->eip = src->eip;
-    context_.x86->eflags = src->eflags;
-    context_.x86->cs = static_cast<uint16_t>(src->cs);
-    context_.x86->ds = static_cast<uint16_t>(src->ds);
-    context_.x86->es = static_cast<uint16_t>(src->es);
-    context_.x86->fs = static_cast<uint16_t>(src->fs);
-    context_.x86->gs = static_cast<uint16_t>(src->gs);
-    context_.x86->ss = static_cast<uint16_t>(src->ss);
-    context_.x86->dr0 = src->dr0;
-    context_.x86->dr1 = src->dr1;
-    context_.x86->dr2 = src->dr2;
-    context_.x86->dr3 = src->dr3;
-    context_.x86->dr6 = src->dr6;
-    context_.x86->dr7 = src->dr7;
-
-    // Minidump passes no value for dr4/5. Our output context has space for
-    // them. According to spec they're obsolete, but when present read as
-    // aliases for dr6/7, so we'll do this.
-    context_.x86->dr4 = src->dr6;
-    context_.x86->dr5 = src->dr7;
-  } else if (context_.architecture == CPUArchitecture::kCPUArchitectureX86_64) {
-    context_memory_.resize(sizeof(CPUContextX86_64));
-    context_.x86_64 =
-        reinterpret_cast<CPUContextX86_64*>(context_memory_.data());
-    const MinidumpContextAMD64* src =
-        reinterpret_cast<const MinidumpContextAMD64*>(minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextAMD64)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextAMD64)) {
-      return false;
-    }
-
-    context_.x86_64->fxsave = src->fxsave;
-    context_.x86_64->cs = src->cs;
-    context_.x86_64->fs = src->fs;
-    context_.x86_64->gs = src->gs;
-    context_.x86_64->rflags = src->eflags;
-    context_.x86_64->dr0 = src->dr0;
-    context_.x86_64->dr1 = src->dr1;
-    context_.x86_64->dr2 = src->dr2;
-    context_.x86_64->dr3 = src->dr3;
-    context_.x86_64->dr6 = src->dr6;
-    context_.x86_64->dr7 = src->dr7;
-    context_.x86_64->rax = src->rax;
-    context_.x86_64->rcx = src->rcx;
-    context_.x86_64->rdx = src->rdx;
-    context_.x86_64->rbx = src->rbx;
-    context_.x86_64->rsp = src->rsp;
-    context_.x86_64->rbp = src->rbp;
-    context_.x86_64->rsi = src->rsi;
-    context_.x86_64->rdi = src->rdi;
-    context_.x86_64->r8 = src->r8;
-    context_.x86_64->r9 = src->r9;
-    context_.x86_64->r10 = src->r10;
-    context_.x86_64->r11 = src->r11;
-    context_.x86_64->r12 = src->r12;
-    context_.x86_64->r13 = src->r13;
-    context_.x86_64->r14 = src->r14;
-    context_.x86_64->r15 = src->r15;
-    context_.x86_64->rip = src->rip;
-
-    // See comments on x86 above.
-    context_.x86_64->dr4 = src->dr6;
-    context_.x86_64->dr5 = src->dr7;
-  } else if (context_.architecture == CPUArchitecture::kCPUArchitectureARM) {
-    context_memory_.resize(sizeof(CPUContextARM));
-    context_.arm = reinterpret_cast<CPUContextARM*>(context_memory_.data());
-    const MinidumpContextARM* src =
-        reinterpret_cast<const MinidumpContextARM*>(minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextARM)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextARM)) {
-      return false;
-    }
-
-    for (size_t i = 0; i < std::size(src->regs); i++) {
-      context_.arm->regs[i] = src->regs[i];
-    }
-
-    context_.arm->fp = src->fp;
-    context_.arm->ip = src->ip;
-    context_.arm->sp = src->sp;
-    context_.arm->lr = src->lr;
-    context_.arm->pc = src->pc;
-    context_.arm->cpsr = src->cpsr;
-    context_.arm->vfp_regs.fpscr = src->fpscr;
-
-    for (size_t i = 0; i < std::size(src->vfp); i++) {
-      context_.arm->vfp_regs.vfp[i] = src->vfp[i];
-    }
-
-    context_.arm->have_fpa_regs = false;
-    context_.arm->have_vfp_regs =
-        !!(src->context_flags & kMinidumpContextARMVFP);
-  } else if (context_.architecture == CPUArchitecture::kCPUArchitectureARM64) {
-    context_memory_.resize(sizeof(CPUContextARM64));
-    context_.arm64 = reinterpret_cast<CPUContextARM64*>(context_memory_.data());
-    const MinidumpContextARM64* src =
-        reinterpret_cast<const MinidumpContextARM64*>(minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextARM64)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextARM64)) {
-      return false;
-    }
-
-    for (size_t i = 0; i < std::size(src->regs); i++) {
-      context_.arm64->regs[i] = src->regs[i];
-    }
-
-    context_.arm64->regs[29] = src->fp;
-    context_.arm64->regs[30] = src->lr;
-
-    for (size_t i = 0; i < std::size(src->fpsimd); i++) {
-      context_.arm64->fpsimd[i] = src->fpsimd[i];
-    }
-
-    context_.arm64->sp = src->sp;
-    context_.arm64->pc = src->pc;
-    context_.arm64->fpcr = src->fpcr;
-    context_.arm64->fpsr = src->fpsr;
-    context_.arm64->spsr = src->cpsr;
-  } else if (context_.architecture == CPUArchitecture::kCPUArchitectureMIPSEL) {
-    context_memory_.resize(sizeof(CPUContextMIPS));
-    context_.mipsel = reinterpret_cast<CPUContextMIPS*>(context_memory_.data());
-    const MinidumpContextMIPS* src =
-        reinterpret_cast<const MinidumpContextMIPS*>(minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextMIPS)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextMIPS)) {
-      return false;
-    }
-
-    for (size_t i = 0; i < std::size(src->regs); i++) {
-      context_.mipsel->regs[i] = src->regs[i];
-    }
-
-    context_.mipsel->mdhi = static_cast<uint32_t>(src->mdhi);
-    context_.mipsel->mdlo = static_cast<uint32_t>(src->mdlo);
-    context_.mipsel->dsp_control = src->dsp_control;
-
-    for (size_t i = 0; i < std::size(src->hi); i++) {
-      context_.mipsel->hi[i] = src->hi[i];
-      context_.mipsel->lo[i] = src->lo[i];
-    }
-
-    context_.mipsel->cp0_epc = static_cast<uint32_t>(src->epc);
-    context_.mipsel->cp0_badvaddr = static_cast<uint32_t>(src->badvaddr);
-    context_.mipsel->cp0_status = src->status;
-    context_.mipsel->cp0_cause = src->cause;
-    context_.mipsel->fpcsr = src->fpcsr;
-    context_.mipsel->fir = src->fir;
-
-    memcpy(&context_.mipsel->fpregs, &src->fpregs, sizeof(src->fpregs));
-  } else if (context_.architecture ==
-             CPUArchitecture::kCPUArchitectureMIPS64EL) {
-    context_memory_.resize(sizeof(CPUContextMIPS64));
-    context_.mips64 =
-        reinterpret_cast<CPUContextMIPS64*>(context_memory_.data());
-    const MinidumpContextMIPS64* src =
-        reinterpret_cast<const MinidumpContextMIPS64*>(minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextMIPS64)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextMIPS64)) {
-      return false;
-    }
-
-    for (size_t i = 0; i < std::size(src->regs); i++) {
-      context_.mips64->regs[i] = src->regs[i];
-    }
-
-    context_.mips64->mdhi = src->mdhi;
-    context_.mips64->mdlo = src->mdlo;
-    context_.mips64->dsp_control = src->dsp_control;
-
-    for (size_t i = 0; i < std::size(src->hi); i++) {
-      context_.mips64->hi[i] = src->hi[i];
-      context_.mips64->lo[i] = src->lo[i];
-    }
-
-    context_.mips64->cp0_epc = src->epc;
-    context_.mips64->cp0_badvaddr = src->badvaddr;
-    context_.mips64->cp0_status = src->status;
-    context_.mips64->cp0_cause = src->cause;
-    context_.mips64->fpcsr = src->fpcsr;
-    context_.mips64->fir = src->fir;
-
-    memcpy(&context_.mips64->fpregs, &src->fpregs, sizeof(src->fpregs));
-  } else if (context_.architecture ==
-             CPUArchitecture::kCPUArchitectureRISCV64) {
-    context_memory_.resize(sizeof(CPUContextRISCV64));
-    context_.riscv64 =
-        reinterpret_cast<CPUContextRISCV64*>(context_memory_.data());
-    const MinidumpContextRISCV64* src =
-        reinterpret_cast<const MinidumpContextRISCV64*>(
-            minidump_context.data());
-    if (minidump_context.size() < sizeof(MinidumpContextRISCV64)) {
-      return false;
-    }
-
-    if (!(src->context_flags & kMinidumpContextRISCV64)) {
-      return false;
-    }
-
-    context_.riscv64->pc = src->pc;
-
-    static_assert(sizeof(context_.riscv64->regs) == sizeof(src->regs),
-                  "GPR size mismatch");
-    memcpy(&context_.riscv64->regs, &src->regs, sizeof(src->regs));
-
-    static_assert(sizeof(context_.riscv64->fpregs) == sizeof(src->fpregs),
-                  "FPR size mismatch");
-    memcpy(&context_.riscv64->fpregs, &src->fpregs, sizeof(src->fpregs));
-
-    context_.riscv64->fcsr = src->fcsr;
-  } else {
-    // Architecture is listed as "unknown".
-    DLOG(ERROR) << "Unknown architecture";
+  switch (context_.architecture) {
+    case CPUArchitecture::kCPUArchitectureX86:
+      context_.x86 = ConvertContextInto<CPUContextX86, MinidumpContextX86>(
+          kMinidumpContextX86, minidump_context, &context_memory_);
+      if (!context_.x86) {
+        return false;
+      }
+      break;
+
+    case CPUArchitecture::kCPUArchitectureX86_64:
+      context_.x86_64 =
+          ConvertContextInto<CPUContextX86_64, MinidumpContextAMD64>(
+              kMinidumpContextAMD64, minidump_context, &context_memory_);
+      if (!context_.x86_64) {
+        return false;
+      }
+      break;
+
+    case CPUArchitecture::kCPUArchitectureARM:
+      context_.arm = ConvertContextInto<CPUContextARM, MinidumpContextARM>(
+          kMinidumpContextARM, minidump_context, &context_memory_);
+      if (!context_.arm) {
+        return false;
+      }
+      break;
+
+    case CPUArchitecture::kCPUArchitectureARM64:
+      context_.arm64 =
+          ConvertContextInto<CPUContextARM64, MinidumpContextARM64>(
+              kMinidumpContextARM64, minidump_context, &context_memory_);
+      if (!context_.arm64) {
+        return false;
+      }
+      break;
+
+    case CPUArchitecture::kCPUArchitectureMIPSEL:
+      context_.mipsel = ConvertContextInto<CPUContextMIPS, MinidumpContextMIPS>(
+          kMinidumpContextMIPS, minidump_context, &context_memory_);
+      if (!context_.mipsel) {
+        return false;
+      }
+      break;
+
+    case CPUArchitecture::kCPUArchitectureMIPS64EL:
+      context_.mips64 =
+          ConvertContextInto<CPUContextMIPS64, MinidumpContextMIPS64>(
+              kMinidumpContextMIPS64, minidump_context, &context_memory_);
+      if (!context_.mips64) {
+        return false;
+      }
+      break;
+
+    case CPUArchitecture::kCPUArchitectureRISCV64:
+      context_.riscv64 =
+          ConvertContextInto<CPUContextRISCV64, MinidumpContextRISCV64>(
+              kMinidumpContextRISCV64, minidump_context, &context_memory_);
+      if (!context_.riscv64) {
+        return false;
+      }
+      break;
+
+    default:
+      // Architecture is listed as "unknown".
+      DLOG(ERROR) << "Unknown architecture";
+      break;
   }
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
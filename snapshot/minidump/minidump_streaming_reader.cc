@@ -0,0 +1,415 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/minidump_streaming_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+MinidumpStreamingReader::MinidumpStreamingReader(Delegate* delegate,
+                                                 size_t max_buffered_size)
+    : header_(),
+      pending_(),
+      retained_(),
+      memory_seen_(),
+      delegate_(delegate),
+      offset_(0),
+      buffered_size_(0),
+      max_buffered_size_(max_buffered_size),
+      pending_buffered_regions_(0),
+      retaining_(true),
+      failed_(false) {}
+
+MinidumpStreamingReader::~MinidumpStreamingReader() = default;
+
+bool MinidumpStreamingReader::AddData(const void* data, size_t size) {
+  if (failed_) {
+    return false;
+  }
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  if (offset_ < sizeof(header_)) {
+    const size_t header_size =
+        std::min(size, static_cast<size_t>(sizeof(header_) - offset_));
+    memcpy(reinterpret_cast<uint8_t*>(&header_) + offset_, bytes, header_size);
+    offset_ += header_size;
+    bytes += header_size;
+    size -= header_size;
+
+    if (offset_ == sizeof(header_) && !ParseHeader()) {
+      failed_ = true;
+      return false;
+    }
+  }
+
+  if (size == 0) {
+    return true;
+  }
+
+  if (retaining_) {
+    if (!Reserve(size)) {
+      failed_ = true;
+      return false;
+    }
+    retained_[offset_].assign(bytes, bytes + size);
+  }
+
+  // Advance past this data before delivering it, so that regions added by the
+  // Delegate are served the part of this data they need from retained_.
+  const uint64_t start = offset_;
+  offset_ += size;
+
+  std::vector<Region*> overlapping;
+  for (Region& region : pending_) {
+    if (region.start < offset_ && region.start + region.size > start) {
+      overlapping.push_back(&region);
+    }
+  }
+
+  for (Region* region : overlapping) {
+    const uint64_t begin = std::max(region->start, start);
+    const uint64_t end = std::min(region->start + region->size, offset_);
+    if (!Deliver(region,
+                 begin,
+                 bytes + (begin - start),
+                 static_cast<size_t>(end - begin))) {
+      failed_ = true;
+      return false;
+    }
+  }
+
+  pending_.remove_if([](const Region& region) { return region.complete; });
+  return true;
+}
+
+bool MinidumpStreamingReader::Finish() {
+  if (failed_) {
+    return false;
+  }
+
+  if (offset_ < sizeof(header_)) {
+    LOG(ERROR) << "minidump truncated in header";
+    failed_ = true;
+    return false;
+  }
+
+  if (!pending_.empty()) {
+    LOG(ERROR) << "minidump truncated at offset " << offset_ << ", "
+               << pending_.size() << " regions incomplete";
+    failed_ = true;
+    return false;
+  }
+
+  return true;
+}
+
+bool MinidumpStreamingReader::ReadAll(FileReaderInterface* reader) {
+  uint8_t buffer[64 * 1024];
+  FileOperationResult bytes_read;
+  while ((bytes_read = reader->Read(buffer, sizeof(buffer))) > 0) {
+    if (!AddData(buffer, static_cast<size_t>(bytes_read))) {
+      return false;
+    }
+  }
+  if (bytes_read < 0) {
+    return false;
+  }
+  return Finish();
+}
+
+bool MinidumpStreamingReader::RequestData(
+    const MINIDUMP_LOCATION_DESCRIPTOR& location,
+    uint64_t cookie) {
+  Region region = {};
+  region.kind = Region::Kind::kData;
+  region.start = location.Rva;
+  region.size = location.DataSize;
+  region.id = cookie;
+  if (!AddRegion(std::move(region))) {
+    failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool MinidumpStreamingReader::AddRegion(Region region) {
+  region.received = 0;
+  region.complete = false;
+
+  if (region.kind != Region::Kind::kMemory) {
+    if (!Reserve(region.size)) {
+      return false;
+    }
+    region.data.resize(static_cast<size_t>(region.size));
+    ++pending_buffered_regions_;
+  }
+
+  if (region.size == 0) {
+    return Complete(&region);
+  }
+
+  if (region.start < offset_ &&
+      !DeliverRetained(&region,
+                       std::min(region.start + region.size, offset_))) {
+    return false;
+  }
+
+  if (!region.complete) {
+    pending_.push_back(std::move(region));
+  }
+  return true;
+}
+
+bool MinidumpStreamingReader::DeliverRetained(Region* region, uint64_t end) {
+  while (region->start + region->received < end) {
+    const uint64_t offset = region->start + region->received;
+
+    auto it = retained_.upper_bound(offset);
+    if (it == retained_.begin() ||
+        offset >= (--it)->first + it->second.size()) {
+      LOG(ERROR) << "minidump offset " << offset << " no longer available";
+      return false;
+    }
+
+    const uint64_t available_end =
+        std::min(end, it->first + it->second.size());
+    if (!Deliver(region,
+                 offset,
+                 it->second.data() + (offset - it->first),
+                 static_cast<size_t>(available_end - offset))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MinidumpStreamingReader::Deliver(Region* region,
+                                      uint64_t offset,
+                                      const uint8_t* data,
+                                      size_t size) {
+  DCHECK_EQ(offset, region->start + region->received);
+  DCHECK_LE(region->received + size, region->size);
+
+  if (region->kind == Region::Kind::kMemory) {
+    if (!delegate_->MinidumpStreamingReaderMemory(
+            region->id + region->received, data, size)) {
+      return false;
+    }
+  } else {
+    memcpy(region->data.data() + region->received, data, size);
+  }
+
+  region->received += size;
+  if (region->received == region->size) {
+    return Complete(region);
+  }
+  return true;
+}
+
+bool MinidumpStreamingReader::Complete(Region* region) {
+  region->complete = true;
+
+  bool rv = true;
+  switch (region->kind) {
+    case Region::Kind::kMemory:
+      // Memory is not buffered, so there is nothing more to do.
+      return true;
+
+    case Region::Kind::kDirectory:
+      rv = ParseDirectory(region->data);
+      break;
+
+    case Region::Kind::kStream: {
+      const MinidumpStreamType stream_type =
+          static_cast<MinidumpStreamType>(region->id);
+      if (stream_type == kMinidumpStreamTypeThreadList) {
+        rv = ParseThreadList(region->data);
+      } else if (stream_type == kMinidumpStreamTypeMemoryList) {
+        rv = ParseMemoryList(region->data);
+      }
+      rv = rv &&
+           delegate_->MinidumpStreamingReaderStream(stream_type, region->data);
+      break;
+    }
+
+    case Region::Kind::kData:
+      rv = delegate_->MinidumpStreamingReaderData(region->id, region->data);
+      break;
+  }
+
+  buffered_size_ -= region->size;
+  region->data = std::vector<uint8_t>();
+  --pending_buffered_regions_;
+  MaybeReleaseRetained();
+  return rv;
+}
+
+bool MinidumpStreamingReader::ParseHeader() {
+  if (header_.Signature != MINIDUMP_SIGNATURE) {
+    LOG(ERROR) << "minidump signature mismatch";
+    return false;
+  }
+
+  if (header_.Version != MINIDUMP_VERSION) {
+    LOG(ERROR) << "minidump version mismatch";
+    return false;
+  }
+
+  Region region = {};
+  region.kind = Region::Kind::kDirectory;
+  region.start = header_.StreamDirectoryRva;
+  region.size = static_cast<uint64_t>(header_.NumberOfStreams) *
+                sizeof(MINIDUMP_DIRECTORY);
+  return AddRegion(std::move(region));
+}
+
+bool MinidumpStreamingReader::ParseDirectory(const std::vector<uint8_t>& data) {
+  std::vector<MINIDUMP_DIRECTORY> directory(header_.NumberOfStreams);
+  if (!directory.empty()) {
+    memcpy(directory.data(), data.data(), data.size());
+  }
+
+  std::set<uint32_t> stream_types;
+  for (const MINIDUMP_DIRECTORY& entry : directory) {
+    if (!stream_types.insert(entry.StreamType).second) {
+      LOG(ERROR) << "duplicate streams for type " << entry.StreamType;
+      return false;
+    }
+  }
+
+  for (const MINIDUMP_DIRECTORY& entry : directory) {
+    Region region = {};
+    region.kind = Region::Kind::kStream;
+    region.start = entry.Location.Rva;
+    region.size = entry.Location.DataSize;
+    region.id = entry.StreamType;
+    if (!AddRegion(std::move(region))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool MinidumpStreamingReader::ParseThreadList(
+    const std::vector<uint8_t>& data) {
+  uint32_t thread_count;
+  if (data.size() < sizeof(thread_count)) {
+    LOG(ERROR) << "thread_list size mismatch";
+    return false;
+  }
+  memcpy(&thread_count, data.data(), sizeof(thread_count));
+
+  if (sizeof(MINIDUMP_THREAD_LIST) +
+          static_cast<uint64_t>(thread_count) * sizeof(MINIDUMP_THREAD) !=
+      data.size()) {
+    LOG(ERROR) << "thread_list size mismatch";
+    return false;
+  }
+
+  for (uint32_t thread_index = 0; thread_index < thread_count;
+       ++thread_index) {
+    MINIDUMP_THREAD thread;
+    memcpy(&thread,
+           data.data() + sizeof(thread_count) +
+               thread_index * sizeof(MINIDUMP_THREAD),
+           sizeof(thread));
+    if (!AddMemory(thread.Stack)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool MinidumpStreamingReader::ParseMemoryList(
+    const std::vector<uint8_t>& data) {
+  uint32_t range_count;
+  if (data.size() < sizeof(range_count)) {
+    LOG(ERROR) << "memory_list size mismatch";
+    return false;
+  }
+  memcpy(&range_count, data.data(), sizeof(range_count));
+
+  if (sizeof(MINIDUMP_MEMORY_LIST) +
+          static_cast<uint64_t>(range_count) *
+              sizeof(MINIDUMP_MEMORY_DESCRIPTOR) !=
+      data.size()) {
+    LOG(ERROR) << "memory_list size mismatch";
+    return false;
+  }
+
+  for (uint32_t range_index = 0; range_index < range_count; ++range_index) {
+    MINIDUMP_MEMORY_DESCRIPTOR descriptor;
+    memcpy(&descriptor,
+           data.data() + sizeof(range_count) +
+               range_index * sizeof(MINIDUMP_MEMORY_DESCRIPTOR),
+           sizeof(descriptor));
+    if (!AddMemory(descriptor)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool MinidumpStreamingReader::AddMemory(
+    const MINIDUMP_MEMORY_DESCRIPTOR& descriptor) {
+  if (descriptor.Memory.DataSize == 0 ||
+      !memory_seen_
+           .insert(std::make_tuple(descriptor.Memory.Rva,
+                                   descriptor.Memory.DataSize,
+                                   descriptor.StartOfMemoryRange))
+           .second) {
+    return true;
+  }
+
+  Region region = {};
+  region.kind = Region::Kind::kMemory;
+  region.start = descriptor.Memory.Rva;
+  region.size = descriptor.Memory.DataSize;
+  region.id = descriptor.StartOfMemoryRange;
+  return AddRegion(std::move(region));
+}
+
+bool MinidumpStreamingReader::Reserve(uint64_t size) {
+  if (size > max_buffered_size_ - buffered_size_) {
+    LOG(ERROR) << "minidump buffering limit of " << max_buffered_size_
+               << " bytes exceeded";
+    return false;
+  }
+  buffered_size_ += size;
+  return true;
+}
+
+void MinidumpStreamingReader::MaybeReleaseRetained() {
+  if (!retaining_ || offset_ < sizeof(header_) ||
+      pending_buffered_regions_ != 0) {
+    return;
+  }
+
+  for (const auto& [offset, data] : retained_) {
+    buffered_size_ -= data.size();
+  }
+  retained_.clear();
+  retaining_ = false;
+}
+
+}  // namespace crashpad
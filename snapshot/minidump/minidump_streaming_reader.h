@@ -0,0 +1,217 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_STREAMING_READER_H_
+#define CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_STREAMING_READER_H_
+
+#include <windows.h>
+#include <dbghelp.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "minidump/minidump_extensions.h"
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief Reads a minidump from input that arrives in order and cannot be
+//!     revisited, such as a pipe or the body of an HTTP request.
+//!
+//! Unlike ProcessSnapshotMinidump, this class never seeks. Input is supplied
+//! with AddData() as it becomes available. The stream directory, each stream,
+//! and any data requested with RequestData() are buffered and handed to the
+//! Delegate once complete. The contents of memory ranges described by
+//! `MINIDUMP_THREAD_LIST` and `MINIDUMP_MEMORY_LIST` streams are not buffered
+//! but passed to the Delegate piece by piece as they arrive.
+//!
+//! A minidump need not be in stream order: a location may precede the
+//! descriptor that refers to it. To support this, input is retained for as long
+//! as any buffered region that might refer back to it is outstanding. The total
+//! of retained input and buffered regions is bounded by the limit given to the
+//! constructor, and exceeding it is an error.
+class MinidumpStreamingReader {
+ public:
+  //! \brief The interface that receives the contents of a minidump.
+  //!
+  //! Each method returns `true` to continue reading, or `false` to stop with
+  //! an error.
+  class Delegate {
+   public:
+    virtual ~Delegate() {}
+
+    //! \brief Called once for each stream in the minidump’s directory, when
+    //!     the stream’s contents have been read.
+    //!
+    //! \param[in] stream_type The stream’s type.
+    //! \param[in] data The stream’s contents, valid only for the duration of
+    //!     the call.
+    virtual bool MinidumpStreamingReaderStream(
+        MinidumpStreamType stream_type,
+        const std::vector<uint8_t>& data) = 0;
+
+    //! \brief Called when data requested with RequestData() has been read.
+    //!
+    //! \param[in] cookie The value passed to RequestData().
+    //! \param[in] data The requested data, valid only for the duration of the
+    //!     call.
+    virtual bool MinidumpStreamingReaderData(
+        uint64_t cookie,
+        const std::vector<uint8_t>& data) = 0;
+
+    //! \brief Called with a piece of the contents of a memory range.
+    //!
+    //! The pieces of a single range are delivered in order, possibly
+    //! interleaved with pieces of other ranges. A range referred to by more
+    //! than one descriptor, such as a thread’s stack also listed in the memory
+    //! list, is delivered once.
+    //!
+    //! \param[in] address The address of the first byte of \a data in the
+    //!     address space of the process the minidump describes.
+    //! \param[in] data The bytes, valid only for the duration of the call.
+    //! \param[in] size The number of bytes at \a data.
+    virtual bool MinidumpStreamingReaderMemory(uint64_t address,
+                                               const void* data,
+                                               size_t size) = 0;
+  };
+
+  //! \brief The default limit on the number of bytes buffered at once.
+  static constexpr size_t kDefaultMaxBufferedSize = 16 * 1024 * 1024;
+
+  //! \brief Constructs the reader.
+  //!
+  //! \param[in] delegate The object to receive the minidump’s contents.
+  //! \param[in] max_buffered_size The maximum number of bytes of streams,
+  //!     requested data, and retained input to hold at once.
+  explicit MinidumpStreamingReader(
+      Delegate* delegate,
+      size_t max_buffered_size = kDefaultMaxBufferedSize);
+
+  MinidumpStreamingReader(const MinidumpStreamingReader&) = delete;
+  MinidumpStreamingReader& operator=(const MinidumpStreamingReader&) = delete;
+
+  ~MinidumpStreamingReader();
+
+  //! \brief Supplies the next \a size bytes of the minidump.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged, or
+  //!     if a Delegate method returned `false`. Once this method has failed,
+  //!     all further calls fail.
+  bool AddData(const void* data, size_t size);
+
+  //! \brief Indicates that the end of the minidump has been reached.
+  //!
+  //! \return `true` if every buffered region and memory range was complete.
+  //!     `false` with a message logged if the input was truncated, or if a
+  //!     previous call to AddData() failed.
+  bool Finish();
+
+  //! \brief Reads all of the input from \a reader with AddData(), and then
+  //!     calls Finish().
+  //!
+  //! \a reader is read sequentially and is never asked to seek.
+  //!
+  //! \return The result of Finish(), or `false` if reading or AddData()
+  //!     failed.
+  bool ReadAll(FileReaderInterface* reader);
+
+  //! \brief Requests that the data at \a location be buffered and passed to
+  //!     Delegate::MinidumpStreamingReaderData().
+  //!
+  //! This may be called from a Delegate method to follow locations stored
+  //! within a stream, such as a thread’s context. If the data is already
+  //! available, the Delegate method may be called before this method returns.
+  //!
+  //! \param[in] location The location of the data within the minidump.
+  //! \param[in] cookie A value identifying the request to the Delegate.
+  //!
+  //! \return `true` on success. `false` with a message logged if \a location
+  //!     has already been passed and was not retained, or if it would exceed
+  //!     the buffering limit.
+  bool RequestData(const MINIDUMP_LOCATION_DESCRIPTOR& location,
+                   uint64_t cookie);
+
+ private:
+  struct Region {
+    enum class Kind {
+      kDirectory,
+      kStream,
+      kData,
+      kMemory,
+    };
+
+    Kind kind;
+    uint64_t start;
+    uint64_t size;
+    uint64_t received;
+
+    // The stream type, request cookie, or memory address, according to kind.
+    uint64_t id;
+
+    // The region’s contents, for every kind except kMemory.
+    std::vector<uint8_t> data;
+
+    bool complete;
+  };
+
+  // Adds a region to be read, delivering whatever part of it has already been
+  // passed from retained_.
+  bool AddRegion(Region region);
+
+  // Delivers the size bytes at data, which begin at offset in the input, to
+  // region. The bytes must lie within region and follow what it has already
+  // received.
+  bool Deliver(Region* region, uint64_t offset, const uint8_t* data,
+               size_t size);
+
+  // Called when all of region’s contents have been received.
+  bool Complete(Region* region);
+
+  // Delivers the part of region before end from retained_.
+  bool DeliverRetained(Region* region, uint64_t end);
+
+  bool ParseHeader();
+  bool ParseDirectory(const std::vector<uint8_t>& data);
+  bool ParseThreadList(const std::vector<uint8_t>& data);
+  bool ParseMemoryList(const std::vector<uint8_t>& data);
+  bool AddMemory(const MINIDUMP_MEMORY_DESCRIPTOR& descriptor);
+
+  // Reserves size more bytes against max_buffered_size_.
+  bool Reserve(uint64_t size);
+
+  // Discards retained_ once no outstanding buffered region could refer back to
+  // it.
+  void MaybeReleaseRetained();
+
+  MINIDUMP_HEADER header_;
+  std::list<Region> pending_;
+  std::map<uint64_t, std::vector<uint8_t>> retained_;
+  std::set<std::tuple<uint64_t, uint64_t, uint64_t>> memory_seen_;
+  Delegate* delegate_;  // weak
+  uint64_t offset_;
+  uint64_t buffered_size_;
+  size_t max_buffered_size_;
+  size_t pending_buffered_regions_;
+  bool retaining_;
+  bool failed_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MINIDUMP_MINIDUMP_STREAMING_READER_H_
@@ -0,0 +1,333 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/minidump_streaming_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint32_t kThreadID = 42;
+constexpr uint64_t kStackAddress = 0x7fff0000;
+constexpr uint64_t kExtraAddress = 0x40000000;
+constexpr uint32_t kCustomStreamType = 0x10000;
+
+enum Piece {
+  kDirectory = 0,
+  kThreadList,
+  kMemoryList,
+  kCustomStream,
+  kContext,
+  kStack,
+  kExtra,
+  kPieceCount,
+};
+
+// Builds a minidump with a thread list, a memory list, and a custom stream,
+// laying out its pieces after the header in the order given.
+std::string BuildMinidump(const std::vector<Piece>& order) {
+  const std::string custom_stream("abc");
+  const std::string context("context!");
+  const std::string stack(16, 's');
+  const std::string extra(8, 'm');
+
+  size_t sizes[kPieceCount];
+  sizes[kDirectory] = 3 * sizeof(MINIDUMP_DIRECTORY);
+  sizes[kThreadList] = sizeof(uint32_t) + sizeof(MINIDUMP_THREAD);
+  sizes[kMemoryList] =
+      sizeof(uint32_t) + 2 * sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
+  sizes[kCustomStream] = custom_stream.size();
+  sizes[kContext] = context.size();
+  sizes[kStack] = stack.size();
+  sizes[kExtra] = extra.size();
+
+  RVA rvas[kPieceCount];
+  RVA rva = sizeof(MINIDUMP_HEADER);
+  for (Piece piece : order) {
+    rvas[piece] = rva;
+    rva += static_cast<RVA>(sizes[piece]);
+  }
+  std::string minidump(rva, '\0');
+
+  MINIDUMP_HEADER header = {};
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 3;
+  header.StreamDirectoryRva = rvas[kDirectory];
+  memcpy(&minidump[0], &header, sizeof(header));
+
+  MINIDUMP_DIRECTORY directory[3] = {};
+  directory[0].StreamType = kMinidumpStreamTypeThreadList;
+  directory[0].Location.DataSize = static_cast<uint32_t>(sizes[kThreadList]);
+  directory[0].Location.Rva = rvas[kThreadList];
+  directory[1].StreamType = kMinidumpStreamTypeMemoryList;
+  directory[1].Location.DataSize = static_cast<uint32_t>(sizes[kMemoryList]);
+  directory[1].Location.Rva = rvas[kMemoryList];
+  directory[2].StreamType = kCustomStreamType;
+  directory[2].Location.DataSize = static_cast<uint32_t>(sizes[kCustomStream]);
+  directory[2].Location.Rva = rvas[kCustomStream];
+  memcpy(&minidump[rvas[kDirectory]], directory, sizeof(directory));
+
+  MINIDUMP_MEMORY_DESCRIPTOR stack_descriptor = {};
+  stack_descriptor.StartOfMemoryRange = kStackAddress;
+  stack_descriptor.Memory.DataSize = static_cast<uint32_t>(stack.size());
+  stack_descriptor.Memory.Rva = rvas[kStack];
+
+  const uint32_t thread_count = 1;
+  MINIDUMP_THREAD thread = {};
+  thread.ThreadId = kThreadID;
+  thread.Stack = stack_descriptor;
+  thread.ThreadContext.DataSize = static_cast<uint32_t>(context.size());
+  thread.ThreadContext.Rva = rvas[kContext];
+  memcpy(&minidump[rvas[kThreadList]], &thread_count, sizeof(thread_count));
+  memcpy(&minidump[rvas[kThreadList] + sizeof(thread_count)],
+         &thread,
+         sizeof(thread));
+
+  // The stack is listed again in the memory list, as Crashpad writes it.
+  const uint32_t range_count = 2;
+  MINIDUMP_MEMORY_DESCRIPTOR ranges[2] = {};
+  ranges[0].StartOfMemoryRange = kExtraAddress;
+  ranges[0].Memory.DataSize = static_cast<uint32_t>(extra.size());
+  ranges[0].Memory.Rva = rvas[kExtra];
+  ranges[1] = stack_descriptor;
+  memcpy(&minidump[rvas[kMemoryList]], &range_count, sizeof(range_count));
+  memcpy(&minidump[rvas[kMemoryList] + sizeof(range_count)],
+         ranges,
+         sizeof(ranges));
+
+  minidump.replace(rvas[kCustomStream], custom_stream.size(), custom_stream);
+  minidump.replace(rvas[kContext], context.size(), context);
+  minidump.replace(rvas[kStack], stack.size(), stack);
+  minidump.replace(rvas[kExtra], extra.size(), extra);
+  return minidump;
+}
+
+std::string StreamOrderMinidump() {
+  return BuildMinidump({kDirectory,
+                        kThreadList,
+                        kMemoryList,
+                        kCustomStream,
+                        kContext,
+                        kStack,
+                        kExtra});
+}
+
+std::string ReorderedMinidump() {
+  return BuildMinidump({kStack,
+                        kExtra,
+                        kContext,
+                        kCustomStream,
+                        kMemoryList,
+                        kThreadList,
+                        kDirectory});
+}
+
+class TestDelegate : public MinidumpStreamingReader::Delegate {
+ public:
+  TestDelegate() = default;
+
+  TestDelegate(const TestDelegate&) = delete;
+  TestDelegate& operator=(const TestDelegate&) = delete;
+
+  ~TestDelegate() override = default;
+
+  void set_reader(MinidumpStreamingReader* reader) { reader_ = reader; }
+
+  const std::map<uint32_t, std::string>& streams() const { return streams_; }
+  const std::map<uint64_t, std::string>& data() const { return data_; }
+  const std::map<uint64_t, std::string>& memory() const { return memory_; }
+
+  // MinidumpStreamingReader::Delegate:
+
+  bool MinidumpStreamingReaderStream(
+      MinidumpStreamType stream_type,
+      const std::vector<uint8_t>& data) override {
+    EXPECT_EQ(streams_.count(stream_type), 0u);
+    streams_[stream_type] = std::string(data.begin(), data.end());
+
+    // Follow each thread’s context, as a consumer of thread lists would.
+    if (stream_type == kMinidumpStreamTypeThreadList && reader_) {
+      MINIDUMP_THREAD thread;
+      memcpy(&thread, data.data() + sizeof(uint32_t), sizeof(thread));
+      EXPECT_TRUE(reader_->RequestData(thread.ThreadContext, thread.ThreadId));
+    }
+    return true;
+  }
+
+  bool MinidumpStreamingReaderData(uint64_t cookie,
+                                   const std::vector<uint8_t>& data) override {
+    EXPECT_EQ(data_.count(cookie), 0u);
+    data_[cookie] = std::string(data.begin(), data.end());
+    return true;
+  }
+
+  bool MinidumpStreamingReaderMemory(uint64_t address,
+                                     const void* data,
+                                     size_t size) override {
+    const char* data_c = static_cast<const char*>(data);
+    for (auto& [range_address, contents] : memory_) {
+      if (range_address + contents.size() == address) {
+        contents.append(data_c, size);
+        return true;
+      }
+    }
+    memory_[address] = std::string(data_c, size);
+    return true;
+  }
+
+ private:
+  std::map<uint32_t, std::string> streams_;
+  std::map<uint64_t, std::string> data_;
+  std::map<uint64_t, std::string> memory_;
+  MinidumpStreamingReader* reader_ = nullptr;
+};
+
+void ExpectContents(const TestDelegate& delegate) {
+  ASSERT_EQ(delegate.streams().size(), 3u);
+  EXPECT_EQ(delegate.streams().count(kMinidumpStreamTypeThreadList), 1u);
+  EXPECT_EQ(delegate.streams().count(kMinidumpStreamTypeMemoryList), 1u);
+  ASSERT_EQ(delegate.streams().count(kCustomStreamType), 1u);
+  EXPECT_EQ(delegate.streams().at(kCustomStreamType), "abc");
+
+  ASSERT_EQ(delegate.data().size(), 1u);
+  ASSERT_EQ(delegate.data().count(kThreadID), 1u);
+  EXPECT_EQ(delegate.data().at(kThreadID), "context!");
+
+  ASSERT_EQ(delegate.memory().size(), 2u);
+  ASSERT_EQ(delegate.memory().count(kStackAddress), 1u);
+  EXPECT_EQ(delegate.memory().at(kStackAddress), std::string(16, 's'));
+  ASSERT_EQ(delegate.memory().count(kExtraAddress), 1u);
+  EXPECT_EQ(delegate.memory().at(kExtraAddress), std::string(8, 'm'));
+}
+
+void ReadWhole(const std::string& minidump) {
+  TestDelegate delegate;
+  MinidumpStreamingReader reader(&delegate);
+  delegate.set_reader(&reader);
+  ASSERT_TRUE(reader.AddData(minidump.data(), minidump.size()));
+  ASSERT_TRUE(reader.Finish());
+  ExpectContents(delegate);
+}
+
+void ReadBytewise(const std::string& minidump) {
+  TestDelegate delegate;
+  MinidumpStreamingReader reader(&delegate);
+  delegate.set_reader(&reader);
+  for (char byte : minidump) {
+    ASSERT_TRUE(reader.AddData(&byte, 1));
+  }
+  ASSERT_TRUE(reader.Finish());
+  ExpectContents(delegate);
+}
+
+TEST(MinidumpStreamingReader, StreamOrder) {
+  ReadWhole(StreamOrderMinidump());
+}
+
+TEST(MinidumpStreamingReader, StreamOrderBytewise) {
+  ReadBytewise(StreamOrderMinidump());
+}
+
+TEST(MinidumpStreamingReader, Reordered) {
+  ReadWhole(ReorderedMinidump());
+}
+
+TEST(MinidumpStreamingReader, ReorderedBytewise) {
+  ReadBytewise(ReorderedMinidump());
+}
+
+TEST(MinidumpStreamingReader, BufferingLimit) {
+  const std::string minidump = ReorderedMinidump();
+
+  TestDelegate delegate;
+  MinidumpStreamingReader reader(&delegate, 64);
+  delegate.set_reader(&reader);
+  EXPECT_FALSE(reader.AddData(minidump.data(), minidump.size()));
+  EXPECT_FALSE(reader.Finish());
+}
+
+TEST(MinidumpStreamingReader, Truncated) {
+  const std::string minidump = StreamOrderMinidump();
+
+  TestDelegate delegate;
+  MinidumpStreamingReader reader(&delegate);
+  ASSERT_TRUE(reader.AddData(minidump.data(), minidump.size() - 1));
+  EXPECT_FALSE(reader.Finish());
+  EXPECT_EQ(delegate.memory().count(kExtraAddress), 1u);
+}
+
+TEST(MinidumpStreamingReader, BadSignature) {
+  std::string minidump = StreamOrderMinidump();
+  minidump[0] = 'X';
+
+  TestDelegate delegate;
+  MinidumpStreamingReader reader(&delegate);
+  EXPECT_FALSE(reader.AddData(minidump.data(), minidump.size()));
+  EXPECT_FALSE(reader.AddData(minidump.data(), 1));
+  EXPECT_TRUE(delegate.streams().empty());
+}
+
+// Reads from a StringFile, failing any attempt to seek.
+class NonSeekableReader : public FileReaderInterface {
+ public:
+  explicit NonSeekableReader(const std::string& contents) : string_file_() {
+    string_file_.SetString(contents);
+  }
+
+  NonSeekableReader(const NonSeekableReader&) = delete;
+  NonSeekableReader& operator=(const NonSeekableReader&) = delete;
+
+  ~NonSeekableReader() override = default;
+
+  // FileReaderInterface:
+
+  FileOperationResult Read(void* data, size_t size) override {
+    return string_file_.Read(data, std::min(size, static_cast<size_t>(7)));
+  }
+
+  // FileSeekerInterface:
+
+  FileOffset Seek(FileOffset offset, int whence) override {
+    ADD_FAILURE() << "unexpected seek";
+    return -1;
+  }
+
+ private:
+  StringFile string_file_;
+};
+
+TEST(MinidumpStreamingReader, ReadAll) {
+  NonSeekableReader file_reader(ReorderedMinidump());
+
+  TestDelegate delegate;
+  MinidumpStreamingReader reader(&delegate);
+  delegate.set_reader(&reader);
+  ASSERT_TRUE(reader.ReadAll(&file_reader));
+  ExpectContents(delegate);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
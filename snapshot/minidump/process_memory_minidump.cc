@@ -0,0 +1,190 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/process_memory_minidump.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "snapshot/minidump/compressed_memory_snapshot_minidump.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+class ReadToVector : public MemorySnapshot::Delegate {
+ public:
+  explicit ReadToVector(std::vector<uint8_t>* result) : result_(result) {}
+
+  ReadToVector(const ReadToVector&) = delete;
+  ReadToVector& operator=(const ReadToVector&) = delete;
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const uint8_t* data_c = static_cast<const uint8_t*>(data);
+    result_->assign(data_c, data_c + size);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t>* result_;  // weak
+};
+
+}  // namespace
+
+ProcessMemoryMinidump::ProcessMemoryMinidump()
+    : ProcessMemory(), ranges_(), contents_(), lock_(), initialized_() {}
+
+ProcessMemoryMinidump::~ProcessMemoryMinidump() = default;
+
+bool ProcessMemoryMinidump::Initialize(
+    const std::vector<const MemorySnapshot*>& snapshots) {
+  return Initialize(snapshots,
+                    std::vector<const CompressedMemorySnapshotMinidump*>());
+}
+
+bool ProcessMemoryMinidump::Initialize(
+    const std::vector<const MemorySnapshot*>& snapshots,
+    const std::vector<const CompressedMemorySnapshotMinidump*>&
+        compressed_snapshots) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  std::vector<Range> sorted;
+  sorted.reserve(snapshots.size() + compressed_snapshots.size());
+  auto add_range = [&sorted](
+                       const MemorySnapshot* snapshot,
+                       const CompressedMemorySnapshotMinidump* compressed) {
+    if (!snapshot || snapshot->Size() == 0) {
+      return;
+    }
+    if (snapshot->Size() >
+        std::numeric_limits<VMAddress>::max() - snapshot->Address()) {
+      LOG(WARNING) << "ignoring memory range wrapping address space at 0x"
+                   << std::hex << snapshot->Address();
+      return;
+    }
+    sorted.push_back(
+        {snapshot->Address(), snapshot->Size(), 0, snapshot, compressed});
+  };
+  for (const MemorySnapshot* snapshot : snapshots) {
+    add_range(snapshot, nullptr);
+  }
+  for (const CompressedMemorySnapshotMinidump* compressed :
+       compressed_snapshots) {
+    add_range(compressed, compressed);
+  }
+
+  // Order by base address, and put the largest of several ranges sharing a
+  // base address first so that the others are wholly covered by it.
+  std::sort(sorted.begin(), sorted.end(), [](const Range& a, const Range& b) {
+    return a.address != b.address ? a.address < b.address : a.size > b.size;
+  });
+
+  // Trim each range to the part not already covered by an earlier one, so that
+  // a lookup only needs to consider the last range starting at or below an
+  // address.
+  ranges_.clear();
+  ranges_.reserve(sorted.size());
+  VMAddress covered_end = 0;
+  for (const Range& range : sorted) {
+    const VMAddress end = range.address + range.size;
+    if (!ranges_.empty() && end <= covered_end) {
+      continue;
+    }
+    Range trimmed = range;
+    if (!ranges_.empty() && range.address < covered_end) {
+      trimmed.offset = covered_end - range.address;
+      trimmed.address = covered_end;
+      trimmed.size = end - covered_end;
+    }
+    ranges_.push_back(trimmed);
+    covered_end = end;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+ssize_t ProcessMemoryMinidump::ReadUpTo(VMAddress address,
+                                        size_t size,
+                                        void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  auto it = std::upper_bound(
+      ranges_.begin(),
+      ranges_.end(),
+      address,
+      [](VMAddress value, const Range& range) {
+        return value < range.address;
+      });
+  if (it == ranges_.begin()) {
+    return 0;
+  }
+  --it;
+
+  const VMSize range_offset = address - it->address;
+  if (range_offset >= it->size) {
+    return 0;
+  }
+
+  const size_t read_size =
+      static_cast<size_t>(std::min<VMSize>(size, it->size - range_offset));
+
+  base::AutoLock lock(lock_);
+  if (it->compressed) {
+    const size_t offset = static_cast<size_t>(it->offset + range_offset);
+    if (!it->compressed->ReadRange(offset, read_size, buffer)) {
+      return -1;
+    }
+    return base::checked_cast<ssize_t>(read_size);
+  }
+
+  const std::vector<uint8_t>* contents = Contents(it->snapshot);
+  if (!contents) {
+    return -1;
+  }
+
+  memcpy(buffer, contents->data() + it->offset + range_offset, read_size);
+  return base::checked_cast<ssize_t>(read_size);
+}
+
+const std::vector<uint8_t>* ProcessMemoryMinidump::Contents(
+    const MemorySnapshot* snapshot) const {
+  auto it = contents_.find(snapshot);
+  if (it != contents_.end()) {
+    return it->second.get();
+  }
+
+  auto contents = std::make_unique<std::vector<uint8_t>>();
+  ReadToVector delegate(contents.get());
+  if (!snapshot->Read(&delegate)) {
+    LOG(ERROR) << "failed to read memory at 0x" << std::hex
+               << snapshot->Address();
+    return nullptr;
+  }
+  if (contents->size() != snapshot->Size()) {
+    LOG(ERROR) << "memory size mismatch at 0x" << std::hex
+               << snapshot->Address();
+    return nullptr;
+  }
+
+  return contents_.emplace(snapshot, std::move(contents)).first->second.get();
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,123 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_MINIDUMP_PROCESS_MEMORY_MINIDUMP_H_
+#define CRASHPAD_SNAPSHOT_MINIDUMP_PROCESS_MEMORY_MINIDUMP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "snapshot/memory_snapshot.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace internal {
+
+class CompressedMemorySnapshotMinidump;
+
+//! \brief Reads the memory captured in a minidump by address.
+//!
+//! The memory ranges carried by a minidump are kept in an index sorted by
+//! address, so that each read is a binary search rather than a scan of every
+//! range. Because this class implements ProcessMemory, code written against a
+//! live process’ memory can run unchanged against a minidump.
+//!
+//! The contents of a range are read from its MemorySnapshot the first time
+//! they are needed and retained for the lifetime of this object. Compressed
+//! ranges are the exception: only the blocks covering each read are
+//! decompressed, and they are not retained beyond the next read.
+//!
+//! This class is thread-safe.
+class ProcessMemoryMinidump final : public ProcessMemory {
+ public:
+  ProcessMemoryMinidump();
+
+  ProcessMemoryMinidump(const ProcessMemoryMinidump&) = delete;
+  ProcessMemoryMinidump& operator=(const ProcessMemoryMinidump&) = delete;
+
+  ~ProcessMemoryMinidump();
+
+  //! \brief Initializes this object to read from \a snapshots.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! Where ranges overlap, the bytes of the range with the lowest base address
+  //! are used. Empty ranges, and ranges that wrap around the end of the
+  //! address space, are ignored.
+  //!
+  //! \param[in] snapshots The memory ranges to read from. These objects must
+  //!     outlive this object.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Initialize(const std::vector<const MemorySnapshot*>& snapshots);
+
+  //! \brief Initializes this object to read from \a snapshots and \a
+  //!     compressed_snapshots.
+  //!
+  //! This behaves as the single-argument form, with the ranges of \a
+  //! compressed_snapshots read through
+  //! CompressedMemorySnapshotMinidump::ReadRange() so that reading a few bytes
+  //! from a large range doesn’t require decompressing all of it.
+  //!
+  //! \param[in] snapshots The memory ranges to read from. These objects must
+  //!     outlive this object.
+  //! \param[in] compressed_snapshots Additional compressed memory ranges to
+  //!     read from. These objects must outlive this object, and must not be
+  //!     used by anything else while this object is in use.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Initialize(const std::vector<const MemorySnapshot*>& snapshots,
+                  const std::vector<const CompressedMemorySnapshotMinidump*>&
+                      compressed_snapshots);
+
+ private:
+  // A span of the address space served by a MemorySnapshot. The span begins
+  // offset bytes into the snapshot’s contents. Entries in ranges_ never
+  // overlap.
+  struct Range {
+    VMAddress address;
+    VMSize size;
+    VMSize offset;
+    const MemorySnapshot* snapshot;
+
+    // Set when snapshot is compressed, to read it with ReadRange().
+    const CompressedMemorySnapshotMinidump* compressed;
+  };
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+
+  // Returns the contents of snapshot, reading them on first use. Returns
+  // nullptr with a message logged on failure. lock_ must be held.
+  const std::vector<uint8_t>* Contents(const MemorySnapshot* snapshot) const;
+
+  std::vector<Range> ranges_;
+  mutable std::map<const MemorySnapshot*, std::unique_ptr<std::vector<uint8_t>>>
+      contents_;
+  mutable base::Lock lock_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_MINIDUMP_PROCESS_MEMORY_MINIDUMP_H_
@@ -0,0 +1,126 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/minidump/process_memory_minidump.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_memory_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+void InitializeSnapshot(TestMemorySnapshot* snapshot,
+                        VMAddress address,
+                        size_t size,
+                        char value) {
+  snapshot->SetAddress(address);
+  snapshot->SetSize(size);
+  snapshot->SetValue(value);
+}
+
+TEST(ProcessMemoryMinidump, ReadWithinAndAcrossRanges) {
+  TestMemorySnapshot low, high, separate;
+  InitializeSnapshot(&low, 0x1000, 0x10, 'a');
+  InitializeSnapshot(&high, 0x1010, 0x10, 'b');
+  InitializeSnapshot(&separate, 0x2000, 0x10, 'c');
+
+  // Out of order, to exercise sorting.
+  internal::ProcessMemoryMinidump memory;
+  ASSERT_TRUE(memory.Initialize({&separate, &high, &low}));
+
+  char buffer[0x20];
+  ASSERT_TRUE(memory.Read(0x1004, 4, buffer));
+  EXPECT_EQ(std::string(buffer, 4), "aaaa");
+
+  ASSERT_TRUE(memory.Read(0x100e, 4, buffer));
+  EXPECT_EQ(std::string(buffer, 4), "aabb");
+
+  ASSERT_TRUE(memory.Read(0x1000, 0x20, buffer));
+  EXPECT_EQ(std::string(buffer, 0x20),
+            std::string(0x10, 'a') + std::string(0x10, 'b'));
+
+  ASSERT_TRUE(memory.Read(0x200f, 1, buffer));
+  EXPECT_EQ(buffer[0], 'c');
+
+  EXPECT_EQ(memory.BytesRead(), 4u + 4u + 0x20u + 1u);
+}
+
+TEST(ProcessMemoryMinidump, ReadOutsideRanges) {
+  TestMemorySnapshot low, high;
+  InitializeSnapshot(&low, 0x1000, 0x10, 'a');
+  InitializeSnapshot(&high, 0x2000, 0x10, 'b');
+
+  internal::ProcessMemoryMinidump memory;
+  ASSERT_TRUE(memory.Initialize({&low, &high}));
+
+  char buffer[0x20];
+  EXPECT_FALSE(memory.Read(0xfff, 1, buffer));
+  EXPECT_FALSE(memory.Read(0x1010, 1, buffer));
+  EXPECT_FALSE(memory.Read(0x1008, 0x10, buffer));
+  EXPECT_FALSE(memory.Read(0x2010, 1, buffer));
+  EXPECT_TRUE(memory.Read(0x1000, 0, buffer));
+}
+
+TEST(ProcessMemoryMinidump, OverlappingRanges) {
+  TestMemorySnapshot outer, inner, overlapping, same_base;
+  InitializeSnapshot(&outer, 0x1000, 0x20, 'a');
+  InitializeSnapshot(&inner, 0x1008, 0x8, 'b');
+  InitializeSnapshot(&overlapping, 0x1018, 0x10, 'c');
+  InitializeSnapshot(&same_base, 0x1000, 0x10, 'd');
+
+  internal::ProcessMemoryMinidump memory;
+  ASSERT_TRUE(memory.Initialize({&overlapping, &inner, &same_base, &outer}));
+
+  char buffer[0x28];
+  ASSERT_TRUE(memory.Read(0x1000, sizeof(buffer), buffer));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)),
+            std::string(0x20, 'a') + std::string(0x8, 'c'));
+}
+
+TEST(ProcessMemoryMinidump, FailedSnapshotRead) {
+  TestMemorySnapshot good, bad;
+  InitializeSnapshot(&good, 0x1000, 0x10, 'a');
+  InitializeSnapshot(&bad, 0x2000, 0x10, 'b');
+  bad.SetShouldFailRead(true);
+
+  internal::ProcessMemoryMinidump memory;
+  ASSERT_TRUE(memory.Initialize({&good, &bad}));
+
+  char buffer[0x10];
+  EXPECT_TRUE(memory.Read(0x1000, sizeof(buffer), buffer));
+  EXPECT_FALSE(memory.Read(0x2000, sizeof(buffer), buffer));
+}
+
+TEST(ProcessMemoryMinidump, ReadCString) {
+  TestMemorySnapshot text, terminator;
+  InitializeSnapshot(&text, 0x1000, 0x8, 'x');
+  InitializeSnapshot(&terminator, 0x1008, 0x1, '\0');
+
+  internal::ProcessMemoryMinidump memory;
+  ASSERT_TRUE(memory.Initialize({&text, &terminator}));
+
+  std::string string;
+  ASSERT_TRUE(memory.ReadCString(0x1004, &string));
+  EXPECT_EQ(string, "xxxx");
+
+  EXPECT_FALSE(memory.ReadCStringSizeLimited(0x1000, 8, &string));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
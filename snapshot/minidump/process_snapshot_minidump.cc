@@ -14,6 +14,7 @@
 
 #include "snapshot/minidump/process_snapshot_minidump.h"
 
+#include <limits>
 #include <utility>
 
 #include "base/logging.h"
@@ -45,6 +46,55 @@ class MemoryMapRegionSnapshotMinidump : public MemoryMapRegionSnapshot {
 
 }  // namespace internal
 
+namespace {
+
+// Refuses reads once a limit on the number of bytes read has been reached, so
+// that a corrupt or hostile minidump can’t make VisitElements() read an
+// unbounded amount of data to decode a single element.
+class LimitedFileReader final : public FileReaderInterface {
+ public:
+  explicit LimitedFileReader(FileReaderInterface* file_reader)
+      : file_reader_(file_reader),
+        remaining_(std::numeric_limits<size_t>::max()),
+        limit_(std::numeric_limits<size_t>::max()) {}
+
+  LimitedFileReader(const LimitedFileReader&) = delete;
+  LimitedFileReader& operator=(const LimitedFileReader&) = delete;
+
+  ~LimitedFileReader() override {}
+
+  // Allows limit more bytes to be read.
+  void SetLimit(size_t limit) {
+    remaining_ = limit;
+    limit_ = limit;
+  }
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override {
+    if (size > remaining_) {
+      LOG(ERROR) << "element exceeds " << limit_ << " bytes";
+      return -1;
+    }
+    const FileOperationResult result = file_reader_->Read(data, size);
+    if (result > 0) {
+      remaining_ -= result;
+    }
+    return result;
+  }
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override {
+    return file_reader_->Seek(offset, whence);
+  }
+
+ private:
+  FileReaderInterface* file_reader_;  // weak
+  size_t remaining_;
+  size_t limit_;
+};
+
+}  // namespace
+
 ProcessSnapshotMinidump::ProcessSnapshotMinidump()
     : ProcessSnapshot(),
       header_(),
@@ -59,6 +109,7 @@ ProcessSnapshotMinidump::ProcessSnapshotMinidump()
       crashpad_info_(),
       system_snapshot_(),
       exception_snapshot_(),
+      memory_(),
       arch_(CPUArchitecture::kCPUArchitectureUnknown),
       annotations_simple_map_(),
       file_reader_(nullptr),
@@ -73,58 +124,120 @@ ProcessSnapshotMinidump::~ProcessSnapshotMinidump() {}
 bool ProcessSnapshotMinidump::Initialize(FileReaderInterface* file_reader) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  file_reader_ = file_reader;
-
-  if (!file_reader_->SeekSet(0)) {
+  if (!InitializeStreamDirectory(file_reader)) {
     return false;
   }
 
-  if (!file_reader_->ReadExactly(&header_, sizeof(header_))) {
+  if (!InitializeCrashpadInfo() || !InitializeMiscInfo() ||
+      !InitializeModules() || !InitializeSystemSnapshot() ||
+      !InitializeMemoryInfo() || !InitializeExtraMemory() ||
+      !InitializeCompressedMemory() || !InitializeThreads() ||
+      !InitializeCustomMinidumpStreams() || !InitializeExceptionSnapshot() ||
+      !InitializeMemory()) {
     return false;
   }
 
-  if (header_.Signature != MINIDUMP_SIGNATURE) {
-    LOG(ERROR) << "minidump signature mismatch";
-    return false;
-  }
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
 
-  if (header_.Version != MINIDUMP_VERSION) {
-    LOG(ERROR) << "minidump version mismatch";
-    return false;
-  }
+bool ProcessSnapshotMinidump::InitializeAnnotationsOnly(
+    FileReaderInterface* file_reader) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
-  if (!file_reader->SeekSet(header_.StreamDirectoryRva)) {
+  if (!InitializeStreamDirectory(file_reader) || !InitializeCrashpadInfo() ||
+      !InitializeModules()) {
     return false;
   }
 
-  stream_directory_.resize(header_.NumberOfStreams);
-  if (!stream_directory_.empty() &&
-      !file_reader_->ReadExactly(
-          &stream_directory_[0],
-          header_.NumberOfStreams * sizeof(stream_directory_[0]))) {
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcessSnapshotMinidump::InitializeForVisiting(
+    FileReaderInterface* file_reader) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!InitializeStreamDirectory(file_reader) || !InitializeCrashpadInfo() ||
+      !InitializeMiscInfo() || !InitializeSystemSnapshot() ||
+      !InitializeThreadNames() || !InitializeExceptionSnapshot() ||
+      !InitializeMemory()) {
     return false;
   }
 
-  for (const MINIDUMP_DIRECTORY& directory : stream_directory_) {
-    const MinidumpStreamType stream_type =
-        static_cast<MinidumpStreamType>(directory.StreamType);
-    if (stream_map_.find(stream_type) != stream_map_.end()) {
-      LOG(ERROR) << "duplicate streams for type " << directory.StreamType;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcessSnapshotMinidump::VisitElements(ElementVisitor* visitor,
+                                            uint32_t elements,
+                                            size_t max_element_size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // The limit is lifted while the visitor runs, so that it can read memory
+  // contents through the element, and restored for the next element. Reads
+  // made by the ReadX() methods ahead of the first element, such as list
+  // headers, count toward the first element.
+  LimitedFileReader file_reader(file_reader_);
+  auto visit = [&file_reader, max_element_size](const auto& element,
+                                                auto visit_element) {
+    file_reader.SetLimit(std::numeric_limits<size_t>::max());
+    const bool result = visit_element(element.get());
+    file_reader.SetLimit(max_element_size);
+    return result;
+  };
+
+  if (elements & kElementModules) {
+    file_reader.SetLimit(max_element_size);
+    if (!ReadModules(
+            &file_reader,
+            [visitor, &visit](
+                std::unique_ptr<internal::ModuleSnapshotMinidump> module) {
+              return visit(module, [visitor](const ModuleSnapshot* element) {
+                return visitor->VisitModule(element);
+              });
+            })) {
       return false;
     }
+  }
 
-    stream_map_[stream_type] = &directory.Location;
+  if (elements & kElementThreads) {
+    file_reader.SetLimit(max_element_size);
+    if (!ReadThreads(
+            &file_reader,
+            [visitor, &visit](
+                std::unique_ptr<internal::ThreadSnapshotMinidump> thread) {
+              return visit(thread, [visitor](const ThreadSnapshot* element) {
+                return visitor->VisitThread(element);
+              });
+            })) {
+      return false;
+    }
   }
 
-  if (!InitializeCrashpadInfo() || !InitializeMiscInfo() ||
-      !InitializeModules() || !InitializeSystemSnapshot() ||
-      !InitializeMemoryInfo() || !InitializeExtraMemory() ||
-      !InitializeThreads() || !InitializeCustomMinidumpStreams() ||
-      !InitializeExceptionSnapshot()) {
-    return false;
+  if (elements & kElementMemory) {
+    auto visit_memory = [visitor](const MemorySnapshot* element) {
+      return visitor->VisitMemory(element);
+    };
+    file_reader.SetLimit(max_element_size);
+    if (!ReadExtraMemory(
+            &file_reader,
+            [&visit, &visit_memory](
+                std::unique_ptr<internal::MemorySnapshotMinidump> memory) {
+              return visit(memory, visit_memory);
+            })) {
+      return false;
+    }
+    file_reader.SetLimit(max_element_size);
+    if (!ReadCompressedMemory(
+            &file_reader,
+            [&visit, &visit_memory](
+                std::unique_ptr<internal::CompressedMemorySnapshotMinidump>
+                    memory) { return visit(memory, visit_memory); })) {
+      return false;
+    }
   }
 
-  INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
@@ -240,12 +353,15 @@ std::vector<const MemorySnapshot*> ProcessSnapshotMinidump::ExtraMemory()
   for (const auto& chunk : extra_memory_) {
     chunks.push_back(chunk.get());
   }
+  for (const auto& chunk : compressed_memory_) {
+    chunks.push_back(chunk.get());
+  }
   return chunks;
 }
 
 const ProcessMemory* ProcessSnapshotMinidump::Memory() const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return nullptr;
+  return &memory_;
 }
 
 std::vector<const MinidumpStream*>
@@ -260,6 +376,54 @@ ProcessSnapshotMinidump::CustomMinidumpStreams() const {
   return result;
 }
 
+bool ProcessSnapshotMinidump::InitializeStreamDirectory(
+    FileReaderInterface* file_reader) {
+  file_reader_ = file_reader;
+
+  if (!file_reader_->SeekSet(0)) {
+    return false;
+  }
+
+  if (!file_reader_->ReadExactly(&header_, sizeof(header_))) {
+    return false;
+  }
+
+  if (header_.Signature != MINIDUMP_SIGNATURE) {
+    LOG(ERROR) << "minidump signature mismatch";
+    return false;
+  }
+
+  if (header_.Version != MINIDUMP_VERSION) {
+    LOG(ERROR) << "minidump version mismatch";
+    return false;
+  }
+
+  if (!file_reader_->SeekSet(header_.StreamDirectoryRva)) {
+    return false;
+  }
+
+  stream_directory_.resize(header_.NumberOfStreams);
+  if (!stream_directory_.empty() &&
+      !file_reader_->ReadExactly(
+          &stream_directory_[0],
+          header_.NumberOfStreams * sizeof(stream_directory_[0]))) {
+    return false;
+  }
+
+  for (const MINIDUMP_DIRECTORY& directory : stream_directory_) {
+    const MinidumpStreamType stream_type =
+        static_cast<MinidumpStreamType>(directory.StreamType);
+    if (stream_map_.find(stream_type) != stream_map_.end()) {
+      LOG(ERROR) << "duplicate streams for type " << directory.StreamType;
+      return false;
+    }
+
+    stream_map_[stream_type] = &directory.Location;
+  }
+
+  return true;
+}
+
 bool ProcessSnapshotMinidump::InitializeCrashpadInfo() {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeCrashpadInfo);
   if (stream_it == stream_map_.end()) {
@@ -368,6 +532,18 @@ bool ProcessSnapshotMinidump::InitializeMiscInfo() {
 }
 
 bool ProcessSnapshotMinidump::InitializeModules() {
+  return ReadModules(
+      file_reader_,
+      [this](std::unique_ptr<internal::ModuleSnapshotMinidump> module) {
+        modules_.push_back(std::move(module));
+        return true;
+      });
+}
+
+bool ProcessSnapshotMinidump::ReadModules(
+    FileReaderInterface* file_reader,
+    const std::function<
+        bool(std::unique_ptr<internal::ModuleSnapshotMinidump>)>& callback) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeModuleList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -383,12 +559,12 @@ bool ProcessSnapshotMinidump::InitializeModules() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
   uint32_t module_count;
-  if (!file_reader_->ReadExactly(&module_count, sizeof(module_count))) {
+  if (!file_reader->ReadExactly(&module_count, sizeof(module_count))) {
     return false;
   }
 
@@ -411,11 +587,13 @@ bool ProcessSnapshotMinidump::InitializeModules() {
 
     auto module = std::make_unique<internal::ModuleSnapshotMinidump>();
     if (!module->Initialize(
-            file_reader_, module_rva, module_crashpad_info_location)) {
+            file_reader, module_rva, module_crashpad_info_location)) {
       return false;
     }
 
-    modules_.push_back(std::move(module));
+    if (!callback(std::move(module))) {
+      return false;
+    }
   }
 
   return true;
@@ -536,6 +714,18 @@ bool ProcessSnapshotMinidump::InitializeMemoryInfo() {
 }
 
 bool ProcessSnapshotMinidump::InitializeExtraMemory() {
+  return ReadExtraMemory(
+      file_reader_,
+      [this](std::unique_ptr<internal::MemorySnapshotMinidump> memory) {
+        extra_memory_.push_back(std::move(memory));
+        return true;
+      });
+}
+
+bool ProcessSnapshotMinidump::ReadExtraMemory(
+    FileReaderInterface* file_reader,
+    const std::function<
+        bool(std::unique_ptr<internal::MemorySnapshotMinidump>)>& callback) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeMemoryList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -546,7 +736,7 @@ bool ProcessSnapshotMinidump::InitializeExtraMemory() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
@@ -558,19 +748,18 @@ bool ProcessSnapshotMinidump::InitializeExtraMemory() {
       sizeof(MINIDUMP_MEMORY_LIST) == 4,
       "MINIDUMP_MEMORY_LIST's only actual field should be an uint32_t");
   uint32_t num_ranges;
-  if (!file_reader_->ReadExactly(&num_ranges, sizeof(num_ranges))) {
+  if (!file_reader->ReadExactly(&num_ranges, sizeof(num_ranges))) {
     return false;
   }
 
   // We have to manually keep track of the locations of the entries in the
   // contiguous list of MINIDUMP_MEMORY_DESCRIPTORs, because the Initialize()
   // function jumps around the file to find the contents of each snapshot.
-  FileOffset location = file_reader_->SeekGet();
+  FileOffset location = file_reader->SeekGet();
   for (uint32_t i = 0; i < num_ranges; i++) {
-    extra_memory_.emplace_back(
-        std::make_unique<internal::MemorySnapshotMinidump>());
-    if (!extra_memory_.back()->Initialize(file_reader_,
-                                          static_cast<RVA>(location))) {
+    auto memory = std::make_unique<internal::MemorySnapshotMinidump>();
+    if (!memory->Initialize(file_reader, static_cast<RVA>(location)) ||
+        !callback(std::move(memory))) {
       return false;
     }
     location += sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
@@ -579,7 +768,80 @@ bool ProcessSnapshotMinidump::InitializeExtraMemory() {
   return true;
 }
 
+bool ProcessSnapshotMinidump::InitializeCompressedMemory() {
+  return ReadCompressedMemory(
+      file_reader_,
+      [this](
+          std::unique_ptr<internal::CompressedMemorySnapshotMinidump> memory) {
+        compressed_memory_.push_back(std::move(memory));
+        return true;
+      });
+}
+
+bool ProcessSnapshotMinidump::ReadCompressedMemory(
+    FileReaderInterface* file_reader,
+    const std::function<
+        bool(std::unique_ptr<internal::CompressedMemorySnapshotMinidump>)>&
+        callback) {
+  const auto& stream_it =
+      stream_map_.find(kMinidumpStreamTypeCrashpadCompressedMemoryList);
+  if (stream_it == stream_map_.end()) {
+    return true;
+  }
+
+  if (stream_it->second->DataSize < sizeof(MinidumpCompressedMemoryList)) {
+    LOG(ERROR) << "compressed_memory_list size mismatch";
+    return false;
+  }
+
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
+    return false;
+  }
+
+  uint32_t num_ranges;
+  if (!file_reader->ReadExactly(&num_ranges, sizeof(num_ranges))) {
+    return false;
+  }
+
+  if (stream_it->second->DataSize !=
+      sizeof(MinidumpCompressedMemoryList) +
+          static_cast<uint64_t>(num_ranges) *
+              sizeof(MinidumpCompressedMemoryRange)) {
+    LOG(ERROR) << "compressed_memory_list size mismatch";
+    return false;
+  }
+
+  RVA location = stream_it->second->Rva + sizeof(MinidumpCompressedMemoryList);
+  for (uint32_t i = 0; i < num_ranges; i++) {
+    auto memory =
+        std::make_unique<internal::CompressedMemorySnapshotMinidump>();
+    if (!memory->Initialize(file_reader, location) ||
+        !callback(std::move(memory))) {
+      return false;
+    }
+    location += sizeof(MinidumpCompressedMemoryRange);
+  }
+
+  return true;
+}
+
 bool ProcessSnapshotMinidump::InitializeThreads() {
+  if (!InitializeThreadNames()) {
+    return false;
+  }
+
+  return ReadThreads(
+      file_reader_,
+      [this](std::unique_ptr<internal::ThreadSnapshotMinidump> thread) {
+        threads_.push_back(std::move(thread));
+        return true;
+      });
+}
+
+bool ProcessSnapshotMinidump::ReadThreads(
+    FileReaderInterface* file_reader,
+    const std::function<
+        bool(std::unique_ptr<internal::ThreadSnapshotMinidump>)>& callback) {
   const auto& stream_it = stream_map_.find(kMinidumpStreamTypeThreadList);
   if (stream_it == stream_map_.end()) {
     return true;
@@ -590,12 +852,12 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
     return false;
   }
 
-  if (!file_reader_->SeekSet(stream_it->second->Rva)) {
+  if (!file_reader->SeekSet(stream_it->second->Rva)) {
     return false;
   }
 
   uint32_t thread_count;
-  if (!file_reader_->ReadExactly(&thread_count, sizeof(thread_count))) {
+  if (!file_reader->ReadExactly(&thread_count, sizeof(thread_count))) {
     return false;
   }
 
@@ -605,20 +867,15 @@ bool ProcessSnapshotMinidump::InitializeThreads() {
     return false;
   }
 
-  if (!InitializeThreadNames()) {
-    return false;
-  }
-
   for (uint32_t thread_index = 0; thread_index < thread_count; ++thread_index) {
     const RVA thread_rva = stream_it->second->Rva + sizeof(thread_count) +
                            thread_index * sizeof(MINIDUMP_THREAD);
 
     auto thread = std::make_unique<internal::ThreadSnapshotMinidump>();
-    if (!thread->Initialize(file_reader_, thread_rva, arch_, thread_names_)) {
+    if (!thread->Initialize(file_reader, thread_rva, arch_, thread_names_) ||
+        !callback(std::move(thread))) {
       return false;
     }
-
-    threads_.push_back(std::move(thread));
   }
 
   return true;
@@ -747,4 +1004,21 @@ bool ProcessSnapshotMinidump::InitializeExceptionSnapshot() {
   return true;
 }
 
+bool ProcessSnapshotMinidump::InitializeMemory() {
+  std::vector<const MemorySnapshot*> snapshots;
+  snapshots.reserve(threads_.size() + extra_memory_.size());
+  for (const auto& thread : threads_) {
+    snapshots.push_back(thread->Stack());
+  }
+  for (const auto& memory : extra_memory_) {
+    snapshots.push_back(memory.get());
+  }
+  std::vector<const internal::CompressedMemorySnapshotMinidump*> compressed;
+  compressed.reserve(compressed_memory_.size());
+  for (const auto& memory : compressed_memory_) {
+    compressed.push_back(memory.get());
+  }
+  return memory_.Initialize(snapshots, compressed);
+}
+
 }  // namespace crashpad
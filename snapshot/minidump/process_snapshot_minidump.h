@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <sys/time.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -28,9 +29,11 @@
 #include "minidump/minidump_extensions.h"
 #include "snapshot/exception_snapshot.h"
 #include "snapshot/memory_snapshot.h"
+#include "snapshot/minidump/compressed_memory_snapshot_minidump.h"
 #include "snapshot/minidump/exception_snapshot_minidump.h"
 #include "snapshot/minidump/minidump_stream.h"
 #include "snapshot/minidump/module_snapshot_minidump.h"
+#include "snapshot/minidump/process_memory_minidump.h"
 #include "snapshot/minidump/system_snapshot_minidump.h"
 #include "snapshot/minidump/thread_snapshot_minidump.h"
 #include "snapshot/module_snapshot.h"
@@ -52,6 +55,45 @@ class MemoryMapRegionSnapshotMinidump;
 //! \brief A ProcessSnapshot based on a minidump file.
 class ProcessSnapshotMinidump final : public ProcessSnapshot {
  public:
+  //! \brief Receives a minidump’s modules, threads, and memory one at a time
+  //!     from VisitElements().
+  //!
+  //! Each element is valid only for the duration of the call that receives it.
+  //! Each method returns `true` to continue visiting, or `false` to stop.
+  class ElementVisitor {
+   public:
+    virtual ~ElementVisitor() {}
+
+    //! \brief Called for each module in the `MINIDUMP_MODULE_LIST` stream.
+    virtual bool VisitModule(const ModuleSnapshot* module) { return true; }
+
+    //! \brief Called for each thread in the `MINIDUMP_THREAD_LIST` stream.
+    virtual bool VisitThread(const ThreadSnapshot* thread) { return true; }
+
+    //! \brief Called for each range in the `MINIDUMP_MEMORY_LIST` stream, and
+    //!     each compressed memory range.
+    virtual bool VisitMemory(const MemorySnapshot* memory) { return true; }
+  };
+
+  //! \brief The kinds of element that VisitElements() decodes.
+  enum ElementTypes : uint32_t {
+    //! \brief Modules, passed to ElementVisitor::VisitModule().
+    kElementModules = 1 << 0,
+
+    //! \brief Threads, passed to ElementVisitor::VisitThread().
+    kElementThreads = 1 << 1,
+
+    //! \brief Memory ranges, passed to ElementVisitor::VisitMemory().
+    kElementMemory = 1 << 2,
+
+    //! \brief All of the above.
+    kElementAll = kElementModules | kElementThreads | kElementMemory,
+  };
+
+  //! \brief The default limit on the number of bytes read to decode a single
+  //!     element in VisitElements().
+  static constexpr size_t kDefaultMaxElementSize = 16 * 1024 * 1024;
+
   ProcessSnapshotMinidump();
 
   ProcessSnapshotMinidump(const ProcessSnapshotMinidump&) = delete;
@@ -62,12 +104,72 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   //! \brief Initializes the object.
   //!
   //! \param[in] file_reader A file reader corresponding to a minidump file.
-  //!     The file reader must support seeking.
+  //!     The file reader must support seeking. Memory contents are read from
+  //!     it on demand, so it must outlive this object.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   bool Initialize(FileReaderInterface* file_reader);
 
+  //! \brief Initializes the object, interpreting only the streams that carry
+  //!     annotations.
+  //!
+  //! This is much cheaper than Initialize() for callers that only need a
+  //! minidump’s annotations, as it doesn’t decode threads, memory, or any
+  //! other streams. Only ReportID(), ClientID(), AnnotationsSimpleMap(), and
+  //! Modules() return meaningful values. Other methods return empty values,
+  //! except for System(), which must not be called.
+  //!
+  //! \param[in] file_reader A file reader corresponding to a minidump file.
+  //!     The file reader must support seeking.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeAnnotationsOnly(FileReaderInterface* file_reader);
+
+  //! \brief Initializes the object without decoding modules, threads, or
+  //!     memory, so that they can be visited with VisitElements().
+  //!
+  //! Everything that Initialize() decodes is available except for Threads(),
+  //! Modules(), MemoryMap(), ExtraMemory(), and CustomMinidumpStreams(), which
+  //! return empty values, and Memory(), which can’t read anything. The memory
+  //! held does not grow with the number of modules or memory ranges.
+  //!
+  //! \param[in] file_reader A file reader corresponding to a minidump file.
+  //!     The file reader must support seeking, and must outlive this object.
+  //!
+  //! \return `true` if the snapshot could be created, `false` otherwise with
+  //!     an appropriate message logged.
+  bool InitializeForVisiting(FileReaderInterface* file_reader);
+
+  //! \brief Decodes the minidump’s modules, then its threads, then its memory
+  //!     ranges, and passes each to \a visitor in turn.
+  //!
+  //! Unlike Modules(), Threads(), and ExtraMemory(), each element is decoded
+  //! only as it is visited and destroyed as soon as the visitor returns, so
+  //! the memory needed does not grow with the size of the minidump. Memory
+  //! contents are not read unless the visitor reads them.
+  //! MemorySnapshot::ReadInChunks() reads them without holding more than a
+  //! chunk at once.
+  //!
+  //! This may be called after any of the initialization methods, and any
+  //! number of times.
+  //!
+  //! \param[in] visitor The object to receive each element.
+  //! \param[in] elements The ElementTypes to decode, combined with bitwise
+  //!     OR. Other kinds of element are skipped without being decoded.
+  //! \param[in] max_element_size The maximum number of bytes that may be read
+  //!     from the minidump to decode any one element, excluding memory
+  //!     contents read by \a visitor. An element that would need more is an
+  //!     error.
+  //!
+  //! \return `true` if every element was visited. `false` if an element could
+  //!     not be decoded or was too large, with a message logged, or if \a
+  //!     visitor stopped.
+  bool VisitElements(ElementVisitor* visitor,
+                     uint32_t elements,
+                     size_t max_element_size);
+
   // ProcessSnapshot:
 
   crashpad::ProcessID ProcessID() const override;
@@ -100,6 +202,10 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   std::vector<const MinidumpStream*> CustomMinidumpStreams() const;
 
  private:
+  // Reads the minidump header and stream directory on behalf of Initialize()
+  // and InitializeAnnotationsOnly().
+  bool InitializeStreamDirectory(FileReaderInterface* file_reader);
+
   // Initializes data carried in a MinidumpCrashpadInfo stream on behalf of
   // Initialize().
   bool InitializeCrashpadInfo();
@@ -108,10 +214,27 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   // Initialize().
   bool InitializeModules();
 
+  // Decodes each module in a MINIDUMP_MODULE_LIST stream from file_reader and
+  // passes it to callback, on behalf of InitializeModules() and
+  // VisitElements(). Stops and returns false if callback does.
+  bool ReadModules(
+      FileReaderInterface* file_reader,
+      const std::function<
+          bool(std::unique_ptr<internal::ModuleSnapshotMinidump>)>& callback);
+
   // Initializes data carried in a MINIDUMP_THREAD_LIST stream on behalf of
   // Initialize().
   bool InitializeThreads();
 
+  // Decodes each thread in a MINIDUMP_THREAD_LIST stream from file_reader and
+  // passes it to callback, on behalf of InitializeThreads() and
+  // VisitElements(). InitializeThreadNames() and InitializeSystemSnapshot()
+  // must have been called. Stops and returns false if callback does.
+  bool ReadThreads(
+      FileReaderInterface* file_reader,
+      const std::function<
+          bool(std::unique_ptr<internal::ThreadSnapshotMinidump>)>& callback);
+
   // Initializes data carried in a MINIDUMP_THREAD_NAME_LIST stream on behalf of
   // Initialize().
   bool InitializeThreadNames();
@@ -124,6 +247,28 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   // Initialize().
   bool InitializeExtraMemory();
 
+  // Decodes each range in a MINIDUMP_MEMORY_LIST stream from file_reader and
+  // passes it to callback, on behalf of InitializeExtraMemory() and
+  // VisitElements(). Stops and returns false if callback does.
+  bool ReadExtraMemory(
+      FileReaderInterface* file_reader,
+      const std::function<
+          bool(std::unique_ptr<internal::MemorySnapshotMinidump>)>& callback);
+
+  // Initializes data carried in a MinidumpCompressedMemoryList stream on behalf
+  // of Initialize().
+  bool InitializeCompressedMemory();
+
+  // Decodes each range in a MinidumpCompressedMemoryList stream from
+  // file_reader and passes it to callback, on behalf of
+  // InitializeCompressedMemory() and VisitElements(). Stops and returns false
+  // if callback does.
+  bool ReadCompressedMemory(
+      FileReaderInterface* file_reader,
+      const std::function<bool(
+          std::unique_ptr<internal::CompressedMemorySnapshotMinidump>)>&
+          callback);
+
   // Initializes data carried in a MINIDUMP_SYSTEM_INFO stream on behalf of
   // Initialize().
   bool InitializeSystemSnapshot();
@@ -146,6 +291,11 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
   // Initialize().
   bool InitializeExceptionSnapshot();
 
+  // Indexes the thread stacks and extra memory ranges for Memory(), on behalf
+  // of Initialize(). Must be called after InitializeThreads(),
+  // InitializeExtraMemory(), and InitializeCompressedMemory().
+  bool InitializeMemory();
+
   MINIDUMP_HEADER header_;
   std::vector<MINIDUMP_DIRECTORY> stream_directory_;
   std::map<MinidumpStreamType, const MINIDUMP_LOCATION_DESCRIPTOR*> stream_map_;
@@ -157,10 +307,13 @@ class ProcessSnapshotMinidump final : public ProcessSnapshot {
       mem_regions_;
   std::vector<const MemoryMapRegionSnapshot*> mem_regions_exposed_;
   std::vector<std::unique_ptr<internal::MemorySnapshotMinidump>> extra_memory_;
+  std::vector<std::unique_ptr<internal::CompressedMemorySnapshotMinidump>>
+      compressed_memory_;
   std::vector<std::unique_ptr<MinidumpStream>> custom_streams_;
   MinidumpCrashpadInfo crashpad_info_;
   internal::SystemSnapshotMinidump system_snapshot_;
   internal::ExceptionSnapshotMinidump exception_snapshot_;
+  internal::ProcessMemoryMinidump memory_;
   CPUArchitecture arch_;
   std::map<std::string, std::string> annotations_simple_map_;
   std::string full_version_;
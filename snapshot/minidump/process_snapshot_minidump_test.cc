@@ -20,15 +20,20 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <string>
 
 #include "base/numerics/safe_math.h"
 #include "base/strings/utf_string_conversions.h"
+#include "client/annotation.h"
+#include "client/compressed_annotation.h"
 #include "gtest/gtest.h"
 #include "minidump/minidump_context.h"
 #include "snapshot/memory_map_region_snapshot.h"
 #include "snapshot/minidump/minidump_annotation_reader.h"
 #include "snapshot/module_snapshot.h"
+#include "third_party/zlib/zlib_crashpad.h"
 #include "util/file/string_file.h"
 #include "util/misc/pdb_structures.h"
 
@@ -47,6 +52,21 @@ class ReadToVector : public crashpad::MemorySnapshot::Delegate {
   }
 };
 
+class ReadToVectorInChunks : public crashpad::MemorySnapshot::Delegate {
+ public:
+  std::vector<uint8_t> result;
+  size_t calls = 0;
+  size_t largest_chunk = 0;
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    const uint8_t* data_u8 = static_cast<const uint8_t*>(data);
+    result.insert(result.end(), data_u8, data_u8 + size);
+    ++calls;
+    largest_chunk = std::max(largest_chunk, size);
+    return true;
+  }
+};
+
 MinidumpContextARM64 GetArm64MinidumpContext() {
   MinidumpContextARM64 minidump_context;
 
@@ -354,6 +374,54 @@ TEST(ProcessSnapshotMinidump, AnnotationsSimpleMap) {
   EXPECT_EQ(annotations_simple_map, dictionary);
 }
 
+TEST(ProcessSnapshotMinidump, InitializeAnnotationsOnly) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  MinidumpCrashpadInfo crashpad_info = {};
+  crashpad_info.version = MinidumpCrashpadInfo::kVersion;
+
+  std::map<std::string, std::string> dictionary;
+  dictionary["key"] = "value";
+  WriteMinidumpSimpleStringDictionary(
+      &crashpad_info.simple_annotations, &string_file, dictionary);
+
+  MINIDUMP_DIRECTORY directories[2] = {};
+  directories[0].StreamType = kMinidumpStreamTypeCrashpadInfo;
+  directories[0].Location.Rva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(&crashpad_info, sizeof(crashpad_info)));
+  directories[0].Location.DataSize = sizeof(crashpad_info);
+
+  // A thread list too short to hold its own count makes Initialize() fail, but
+  // isn’t interpreted by InitializeAnnotationsOnly().
+  directories[1].StreamType = kMinidumpStreamTypeThreadList;
+  directories[1].Location.Rva = static_cast<RVA>(string_file.SeekGet());
+  directories[1].Location.DataSize = 1;
+  EXPECT_TRUE(string_file.Write("", 1));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  EXPECT_TRUE(string_file.Write(directories, sizeof(directories)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = std::size(directories);
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  {
+    ProcessSnapshotMinidump process_snapshot;
+    EXPECT_FALSE(process_snapshot.Initialize(&string_file));
+  }
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeAnnotationsOnly(&string_file));
+  EXPECT_EQ(process_snapshot.AnnotationsSimpleMap(), dictionary);
+  EXPECT_TRUE(process_snapshot.Modules().empty());
+  EXPECT_TRUE(process_snapshot.Threads().empty());
+}
+
 TEST(ProcessSnapshotMinidump, AnnotationObjects) {
   StringFile string_file;
 
@@ -376,6 +444,48 @@ TEST(ProcessSnapshotMinidump, AnnotationObjects) {
   EXPECT_EQ(read_annotations, annotations);
 }
 
+TEST(ProcessSnapshotMinidump, CompressedAnnotationObjects) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header{};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  const std::string text(1000, 'z');
+  uint8_t compressed[64];
+  bool complete;
+  const size_t compressed_size = internal::CompressAnnotationValue(
+      text, compressed, sizeof(compressed), &complete);
+  ASSERT_TRUE(complete);
+
+  // A compressed string is read as the string it holds, and one that can’t be
+  // decompressed is read as it is.
+  std::vector<AnnotationSnapshot> annotations;
+  annotations.emplace_back(AnnotationSnapshot(
+      "compressed",
+      static_cast<uint16_t>(Annotation::Type::kCompressedString),
+      std::vector<uint8_t>(compressed, compressed + compressed_size)));
+  annotations.emplace_back(AnnotationSnapshot(
+      "corrupt",
+      static_cast<uint16_t>(Annotation::Type::kCompressedString),
+      {'b', 'a', 'd'}));
+
+  MINIDUMP_LOCATION_DESCRIPTOR location;
+  WriteMinidumpAnnotationList(&location, &string_file, annotations);
+
+  std::vector<AnnotationSnapshot> read_annotations;
+  EXPECT_TRUE(internal::ReadMinidumpAnnotationList(
+      &string_file, location, &read_annotations));
+
+  ASSERT_EQ(read_annotations.size(), 2u);
+  EXPECT_EQ(read_annotations[0].name, "compressed");
+  EXPECT_EQ(read_annotations[0].type,
+            static_cast<uint16_t>(Annotation::Type::kString));
+  EXPECT_EQ(std::string(read_annotations[0].value.begin(),
+                        read_annotations[0].value.end()),
+            text);
+  EXPECT_EQ(read_annotations[1], annotations[1]);
+}
+
 TEST(ProcessSnapshotMinidump, Modules) {
   StringFile string_file;
 
@@ -1383,6 +1493,384 @@ TEST(ProcessSnapshotMinidump, Stacks) {
   threads[0]->Stack()->Read(&delegate);
 
   EXPECT_EQ(delegate.result, minidump_stack);
+
+  // Contents are read from the file on demand, so reading again yields the
+  // same data.
+  ReadToVector second_delegate;
+  threads[0]->Stack()->Read(&second_delegate);
+
+  EXPECT_EQ(second_delegate.result, minidump_stack);
+
+  // Reading in chunks yields the same data, in pieces no larger than a chunk.
+  ReadToVectorInChunks chunked_delegate;
+  EXPECT_TRUE(threads[0]->Stack()->ReadInChunks(&chunked_delegate, 4));
+  EXPECT_EQ(chunked_delegate.result, minidump_stack);
+  EXPECT_EQ(chunked_delegate.calls, 4u);
+  EXPECT_EQ(chunked_delegate.largest_chunk, 4u);
+
+  // The stack is also reachable by address.
+  const ProcessMemory* memory = process_snapshot.Memory();
+  ASSERT_TRUE(memory);
+  std::vector<uint8_t> stack_by_address(minidump_stack.size());
+  ASSERT_TRUE(memory->Read(minidump_thread.Stack.StartOfMemoryRange,
+                           stack_by_address.size(),
+                           stack_by_address.data()));
+  EXPECT_EQ(stack_by_address, minidump_stack);
+
+  uint8_t byte;
+  EXPECT_FALSE(memory->Read(
+      minidump_thread.Stack.StartOfMemoryRange + minidump_stack.size(),
+      sizeof(byte),
+      &byte));
+}
+
+TEST(ProcessSnapshotMinidump, StackBeyondEndOfFile) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  MINIDUMP_THREAD minidump_thread = {};
+  uint32_t minidump_thread_count = 1;
+
+  minidump_thread.ThreadId = 42;
+  minidump_thread.Stack.StartOfMemoryRange = 0xbeefd00d;
+
+  std::vector<uint8_t> minidump_stack(16, 's');
+
+  // The descriptor claims more data than the file holds.
+  minidump_thread.Stack.Memory.DataSize =
+      base::checked_cast<uint32_t>(minidump_stack.size() * 1024);
+  minidump_thread.Stack.Memory.Rva = static_cast<RVA>(string_file.SeekGet());
+
+  EXPECT_TRUE(string_file.Write(minidump_stack.data(), minidump_stack.size()));
+
+  MINIDUMP_DIRECTORY minidump_thread_list_directory = {};
+  minidump_thread_list_directory.StreamType = kMinidumpStreamTypeThreadList;
+  minidump_thread_list_directory.Location.DataSize =
+      sizeof(MINIDUMP_THREAD_LIST) +
+      minidump_thread_count * sizeof(MINIDUMP_THREAD);
+  minidump_thread_list_directory.Location.Rva =
+      static_cast<RVA>(string_file.SeekGet());
+
+  EXPECT_TRUE(
+      string_file.Write(&minidump_thread_count, sizeof(minidump_thread_count)));
+  EXPECT_TRUE(string_file.Write(&minidump_thread, sizeof(minidump_thread)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(&minidump_thread_list_directory,
+                                sizeof(minidump_thread_list_directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  EXPECT_TRUE(string_file.SeekSet(0));
+  EXPECT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  ProcessSnapshotMinidump process_snapshot;
+  EXPECT_FALSE(process_snapshot.Initialize(&string_file));
+}
+
+// Ways that WriteCompressedMemoryMinidump() can make a malformed range.
+enum class CompressedMemoryCorruption {
+  kNone,
+
+  // The block size exceeds MinidumpCompressedMemoryRange::kMaxBlockSize.
+  kBlockSizeTooLarge,
+
+  // The range is consistent, but claims far more blocks than the file holds.
+  kBlocksBeyondEndOfFile,
+
+  // Both blocks’ data starts at the same place in the file.
+  kOverlappingBlocks,
+};
+
+// Writes a minidump with a MinidumpCompressedMemoryList stream holding a
+// single range of contents, divided into a zlib-compressed block of block_size
+// bytes followed by an uncompressed block holding the rest, which must be no
+// larger than block_size. The range’s block_count field is set to block_count.
+void WriteCompressedMemoryMinidump(
+    StringFile* string_file,
+    uint64_t address,
+    const std::string& contents,
+    uint32_t block_size,
+    uint32_t block_count,
+    CompressedMemoryCorruption corruption = CompressedMemoryCorruption::kNone) {
+  ASSERT_GT(contents.size(), block_size);
+  ASSERT_LE(contents.size(), 2 * block_size);
+
+  MINIDUMP_HEADER header = {};
+  ASSERT_TRUE(string_file->Write(&header, sizeof(header)));
+
+  MinidumpCompressedMemoryBlock blocks[2] = {};
+
+  std::string compressed(compressBound(block_size), '\0');
+  uLongf compressed_size = compressed.size();
+  ASSERT_EQ(compress2(reinterpret_cast<Bytef*>(&compressed[0]),
+                      &compressed_size,
+                      reinterpret_cast<const Bytef*>(contents.data()),
+                      block_size,
+                      Z_DEFAULT_COMPRESSION),
+            Z_OK);
+  blocks[0].compression = kMinidumpCompressedMemoryCompressionZlib;
+  blocks[0].data.DataSize = static_cast<uint32_t>(compressed_size);
+  blocks[0].data.Rva = static_cast<RVA>(string_file->SeekGet());
+  ASSERT_TRUE(string_file->Write(compressed.data(), compressed_size));
+
+  blocks[1].compression = kMinidumpCompressedMemoryCompressionNone;
+  blocks[1].data.DataSize =
+      base::checked_cast<uint32_t>(contents.size() - block_size);
+  blocks[1].data.Rva = static_cast<RVA>(string_file->SeekGet());
+  ASSERT_TRUE(string_file->Write(&contents[block_size],
+                                 contents.size() - block_size));
+
+  MinidumpCompressedMemoryRange range = {};
+  range.start_of_memory_range = address;
+  range.data_size = contents.size();
+  range.block_size = block_size;
+  range.block_count = block_count;
+  range.blocks = static_cast<RVA>(string_file->SeekGet());
+  switch (corruption) {
+    case CompressedMemoryCorruption::kNone:
+      break;
+    case CompressedMemoryCorruption::kBlockSizeTooLarge:
+      range.block_size = MinidumpCompressedMemoryRange::kMaxBlockSize + 1;
+      range.block_count = 1;
+      break;
+    case CompressedMemoryCorruption::kBlocksBeyondEndOfFile:
+      range.block_count = std::numeric_limits<uint32_t>::max();
+      range.data_size = static_cast<uint64_t>(range.block_count) * block_size;
+      break;
+    case CompressedMemoryCorruption::kOverlappingBlocks:
+      blocks[1].data.Rva = blocks[0].data.Rva;
+      break;
+  }
+  ASSERT_TRUE(string_file->Write(blocks, sizeof(blocks)));
+
+  MINIDUMP_DIRECTORY directory = {};
+  directory.StreamType = kMinidumpStreamTypeCrashpadCompressedMemoryList;
+  directory.Location.DataSize =
+      sizeof(MinidumpCompressedMemoryList) + sizeof(range);
+  directory.Location.Rva = static_cast<RVA>(string_file->SeekGet());
+  const uint32_t range_count = 1;
+  ASSERT_TRUE(string_file->Write(&range_count, sizeof(range_count)));
+  ASSERT_TRUE(string_file->Write(&range, sizeof(range)));
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file->SeekGet());
+  ASSERT_TRUE(string_file->Write(&directory, sizeof(directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  ASSERT_TRUE(string_file->SeekSet(0));
+  ASSERT_TRUE(string_file->Write(&header, sizeof(header)));
+}
+
+TEST(ProcessSnapshotMinidump, CompressedMemory) {
+  constexpr uint64_t kAddress = 0xfeed0000;
+  constexpr uint32_t kBlockSize = 16;
+  const std::string contents("0123456789abcdefghijklmnop");
+
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteCompressedMemoryMinidump(
+      &string_file, kAddress, contents, kBlockSize, 2));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.Initialize(&string_file));
+
+  std::vector<const MemorySnapshot*> extra_memory =
+      process_snapshot.ExtraMemory();
+  ASSERT_EQ(extra_memory.size(), 1u);
+  EXPECT_EQ(extra_memory[0]->Address(), kAddress);
+  ASSERT_EQ(extra_memory[0]->Size(), contents.size());
+
+  // The range is provided a block at a time.
+  ReadToVectorInChunks delegate;
+  ASSERT_TRUE(extra_memory[0]->Read(&delegate));
+  EXPECT_EQ(std::string(delegate.result.begin(), delegate.result.end()),
+            contents);
+  EXPECT_EQ(delegate.calls, 2u);
+  EXPECT_EQ(delegate.largest_chunk, kBlockSize);
+
+  // A read straddling a block boundary decompresses only the blocks covering
+  // it.
+  const ProcessMemory* memory = process_snapshot.Memory();
+  ASSERT_TRUE(memory);
+  std::string straddling(12, '\0');
+  ASSERT_TRUE(memory->Read(kAddress + 10, straddling.size(), &straddling[0]));
+  EXPECT_EQ(straddling, contents.substr(10, straddling.size()));
+
+  std::string tail(4, '\0');
+  ASSERT_TRUE(
+      memory->Read(kAddress + contents.size() - 4, tail.size(), &tail[0]));
+  EXPECT_EQ(tail, contents.substr(contents.size() - 4));
+
+  uint8_t byte;
+  EXPECT_FALSE(memory->Read(kAddress + contents.size(), sizeof(byte), &byte));
+}
+
+TEST(ProcessSnapshotMinidump, CompressedMemoryBlockCountMismatch) {
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(WriteCompressedMemoryMinidump(
+      &string_file, 0xfeed0000, "0123456789abcdefghijklmnop", 16, 3));
+
+  ProcessSnapshotMinidump process_snapshot;
+  EXPECT_FALSE(process_snapshot.Initialize(&string_file));
+}
+
+TEST(ProcessSnapshotMinidump, CompressedMemoryMalformed) {
+  for (CompressedMemoryCorruption corruption :
+       {CompressedMemoryCorruption::kBlockSizeTooLarge,
+        CompressedMemoryCorruption::kBlocksBeyondEndOfFile,
+        CompressedMemoryCorruption::kOverlappingBlocks}) {
+    SCOPED_TRACE(static_cast<int>(corruption));
+
+    StringFile string_file;
+    ASSERT_NO_FATAL_FAILURE(
+        WriteCompressedMemoryMinidump(&string_file,
+                                      0xfeed0000,
+                                      "0123456789abcdefghijklmnop",
+                                      16,
+                                      2,
+                                      corruption));
+
+    ProcessSnapshotMinidump process_snapshot;
+    EXPECT_FALSE(process_snapshot.Initialize(&string_file));
+  }
+}
+
+class CollectingElementVisitor final
+    : public ProcessSnapshotMinidump::ElementVisitor {
+ public:
+  CollectingElementVisitor() = default;
+
+  CollectingElementVisitor(const CollectingElementVisitor&) = delete;
+  CollectingElementVisitor& operator=(const CollectingElementVisitor&) = delete;
+
+  bool VisitThread(const ThreadSnapshot* thread) override {
+    thread_ids.push_back(thread->ThreadID());
+    ReadToVectorInChunks delegate;
+    EXPECT_TRUE(thread->Stack()->ReadInChunks(&delegate, 4));
+    stacks.push_back(
+        std::string(delegate.result.begin(), delegate.result.end()));
+    return thread_ids.size() != stop_after_threads;
+  }
+
+  bool VisitMemory(const MemorySnapshot* memory) override {
+    ReadToVectorInChunks delegate;
+    EXPECT_TRUE(memory->Read(&delegate));
+    memory_addresses.push_back(memory->Address());
+    memory_contents.push_back(
+        std::string(delegate.result.begin(), delegate.result.end()));
+    return true;
+  }
+
+  std::vector<uint64_t> thread_ids;
+  std::vector<std::string> stacks;
+  std::vector<uint64_t> memory_addresses;
+  std::vector<std::string> memory_contents;
+  size_t stop_after_threads = 0;
+};
+
+TEST(ProcessSnapshotMinidump, VisitThreads) {
+  StringFile string_file;
+
+  MINIDUMP_HEADER header = {};
+  ASSERT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  const std::string stack("0123456789abcde");
+  MINIDUMP_THREAD minidump_thread = {};
+  minidump_thread.ThreadId = 42;
+  minidump_thread.Stack.StartOfMemoryRange = 0xbeefd00d;
+  minidump_thread.Stack.Memory.DataSize =
+      base::checked_cast<uint32_t>(stack.size());
+  minidump_thread.Stack.Memory.Rva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(stack.data(), stack.size()));
+
+  const uint32_t minidump_thread_count = 3;
+  MINIDUMP_DIRECTORY directory = {};
+  directory.StreamType = kMinidumpStreamTypeThreadList;
+  directory.Location.DataSize = sizeof(MINIDUMP_THREAD_LIST) +
+                                minidump_thread_count * sizeof(MINIDUMP_THREAD);
+  directory.Location.Rva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(
+      string_file.Write(&minidump_thread_count, sizeof(minidump_thread_count)));
+  for (uint32_t index = 0; index < minidump_thread_count; ++index) {
+    ASSERT_TRUE(string_file.Write(&minidump_thread, sizeof(minidump_thread)));
+    minidump_thread.ThreadId++;
+  }
+
+  header.StreamDirectoryRva = static_cast<RVA>(string_file.SeekGet());
+  ASSERT_TRUE(string_file.Write(&directory, sizeof(directory)));
+
+  header.Signature = MINIDUMP_SIGNATURE;
+  header.Version = MINIDUMP_VERSION;
+  header.NumberOfStreams = 1;
+  ASSERT_TRUE(string_file.SeekSet(0));
+  ASSERT_TRUE(string_file.Write(&header, sizeof(header)));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeForVisiting(&string_file));
+  EXPECT_TRUE(process_snapshot.Threads().empty());
+
+  // Visiting only memory doesn’t decode threads.
+  CollectingElementVisitor memory_visitor;
+  EXPECT_TRUE(process_snapshot.VisitElements(
+      &memory_visitor,
+      ProcessSnapshotMinidump::kElementMemory,
+      ProcessSnapshotMinidump::kDefaultMaxElementSize));
+  EXPECT_TRUE(memory_visitor.thread_ids.empty());
+
+  // The limit doesn’t apply to stack contents, which are read by the visitor.
+  // Decoding a thread reads the MINIDUMP_THREAD and then its stack’s
+  // MINIDUMP_MEMORY_DESCRIPTOR again, and the list’s thread count is read on
+  // behalf of the first thread.
+  constexpr size_t kThreadSize = sizeof(minidump_thread_count) +
+                                 sizeof(minidump_thread) +
+                                 sizeof(MINIDUMP_MEMORY_DESCRIPTOR);
+  CollectingElementVisitor visitor;
+  EXPECT_TRUE(process_snapshot.VisitElements(
+      &visitor, ProcessSnapshotMinidump::kElementAll, kThreadSize));
+  EXPECT_EQ(visitor.thread_ids, (std::vector<uint64_t>{42, 43, 44}));
+  EXPECT_EQ(visitor.stacks, std::vector<std::string>(3, stack));
+
+  // The visitor can stop early.
+  CollectingElementVisitor stopping_visitor;
+  stopping_visitor.stop_after_threads = 2;
+  EXPECT_FALSE(process_snapshot.VisitElements(
+      &stopping_visitor,
+      ProcessSnapshotMinidump::kElementThreads,
+      ProcessSnapshotMinidump::kDefaultMaxElementSize));
+  EXPECT_EQ(stopping_visitor.thread_ids, (std::vector<uint64_t>{42, 43}));
+
+  // A thread that needs more than the limit to decode fails.
+  CollectingElementVisitor limited_visitor;
+  EXPECT_FALSE(process_snapshot.VisitElements(
+      &limited_visitor,
+      ProcessSnapshotMinidump::kElementThreads,
+      kThreadSize - 1));
+  EXPECT_TRUE(limited_visitor.thread_ids.empty());
+}
+
+TEST(ProcessSnapshotMinidump, VisitCompressedMemory) {
+  constexpr uint64_t kAddress = 0xfeed0000;
+  const std::string contents("0123456789abcdefghijklmnop");
+
+  StringFile string_file;
+  ASSERT_NO_FATAL_FAILURE(
+      WriteCompressedMemoryMinidump(&string_file, kAddress, contents, 16, 2));
+
+  ProcessSnapshotMinidump process_snapshot;
+  ASSERT_TRUE(process_snapshot.InitializeForVisiting(&string_file));
+  EXPECT_TRUE(process_snapshot.ExtraMemory().empty());
+
+  CollectingElementVisitor visitor;
+  EXPECT_TRUE(process_snapshot.VisitElements(
+      &visitor,
+      ProcessSnapshotMinidump::kElementAll,
+      ProcessSnapshotMinidump::kDefaultMaxElementSize));
+  EXPECT_EQ(visitor.memory_addresses, std::vector<uint64_t>{kAddress});
+  EXPECT_EQ(visitor.memory_contents, std::vector<std::string>{contents});
 }
 
 TEST(ProcessSnapshotMinidump, CustomMinidumpStreams) {
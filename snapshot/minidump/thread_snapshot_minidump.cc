@@ -123,5 +123,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotMinidump::ExtraMemory() const {
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState* ThreadSnapshotMinidump::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
+const ThreadSchedulingStats* ThreadSnapshotMinidump::SchedulingStats() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
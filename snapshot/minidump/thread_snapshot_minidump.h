@@ -66,6 +66,8 @@ class ThreadSnapshotMinidump : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
+  const ThreadSchedulingStats* SchedulingStats() const override;
 
  private:
   //! \brief Initializes the CPU Context
@@ -0,0 +1,94 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/annotation_allowlist.h"
+
+#include <algorithm>
+
+#include "base/strings/pattern.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+bool HasWildcard(const std::string& pattern, size_t length) {
+  return pattern.find_first_of("*?\\") < length;
+}
+
+bool StartsWith(const std::string& name, const std::string& prefix) {
+  return name.compare(0, prefix.size(), prefix) == 0;
+}
+
+}  // namespace
+
+AnnotationAllowlist::AnnotationAllowlist(
+    const std::vector<std::string>& patterns)
+    : names_(), prefixes_(), patterns_() {
+  for (const auto& pattern : patterns) {
+    if (!HasWildcard(pattern, pattern.size())) {
+      names_.push_back(pattern);
+    } else if (pattern.back() == '*' &&
+               !HasWildcard(pattern, pattern.size() - 1)) {
+      prefixes_.push_back(pattern.substr(0, pattern.size() - 1));
+    } else {
+      patterns_.push_back(pattern);
+    }
+  }
+
+  std::sort(names_.begin(), names_.end());
+  names_.erase(std::unique(names_.begin(), names_.end()), names_.end());
+
+  // A prefix sorts before every string that it's a prefix of, so after
+  // sorting, dropping each prefix that extends the last one kept leaves only
+  // the shortest.
+  std::sort(prefixes_.begin(), prefixes_.end());
+  auto kept = prefixes_.begin();
+  for (auto iter = prefixes_.begin(); iter != prefixes_.end(); ++iter) {
+    if (iter == kept || StartsWith(*iter, *kept)) {
+      continue;
+    }
+    if (++kept != iter) {
+      *kept = std::move(*iter);
+    }
+  }
+  if (!prefixes_.empty()) {
+    prefixes_.erase(kept + 1, prefixes_.end());
+  }
+}
+
+AnnotationAllowlist::~AnnotationAllowlist() = default;
+
+bool AnnotationAllowlist::IsAllowed(const std::string& name) const {
+  if (std::binary_search(names_.begin(), names_.end(), name)) {
+    return true;
+  }
+
+  // Since no prefix is a prefix of another, the only one that can be a prefix
+  // of name is the greatest that doesn't sort after it.
+  auto prefix = std::upper_bound(prefixes_.begin(), prefixes_.end(), name);
+  if (prefix != prefixes_.begin() && StartsWith(name, *--prefix)) {
+    return true;
+  }
+
+  for (const auto& pattern : patterns_) {
+    if (base::MatchPattern(name, pattern)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace internal
+}  // namespace crashpad
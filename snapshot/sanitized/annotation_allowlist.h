@@ -0,0 +1,59 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_SANITIZED_ANNOTATION_ALLOWLIST_H_
+#define CRASHPAD_SNAPSHOT_SANITIZED_ANNOTATION_ALLOWLIST_H_
+
+#include <string>
+#include <vector>
+
+namespace crashpad {
+namespace internal {
+
+//! \brief Decides whether annotations are allowed by a list of name patterns.
+//!
+//! Patterns are matched as they are by `base::MatchPattern()`. The list is
+//! sorted into exact names and prefixes, which the common patterns `"name"`
+//! and `"prefix*"` are, so that most names are checked with binary searches.
+//! Only patterns with other wildcards are matched one at a time.
+class AnnotationAllowlist {
+ public:
+  //! \brief Constructs this object.
+  //!
+  //! \param[in] patterns The names of allowed annotations, which may contain
+  //!     wildcards.
+  explicit AnnotationAllowlist(const std::vector<std::string>& patterns);
+
+  AnnotationAllowlist(const AnnotationAllowlist&) = delete;
+  AnnotationAllowlist& operator=(const AnnotationAllowlist&) = delete;
+
+  ~AnnotationAllowlist();
+
+  //! \brief Returns `true` if \a name matches any of the patterns.
+  bool IsAllowed(const std::string& name) const;
+
+ private:
+  // Sorted.
+  std::vector<std::string> names_;
+
+  // Sorted, and none is a prefix of another.
+  std::vector<std::string> prefixes_;
+
+  std::vector<std::string> patterns_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_SANITIZED_ANNOTATION_ALLOWLIST_H_
@@ -0,0 +1,74 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/annotation_allowlist.h"
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(AnnotationAllowlist, Empty) {
+  internal::AnnotationAllowlist allowlist({});
+  EXPECT_FALSE(allowlist.IsAllowed(""));
+  EXPECT_FALSE(allowlist.IsAllowed("name"));
+}
+
+TEST(AnnotationAllowlist, Names) {
+  internal::AnnotationAllowlist allowlist({"ptype", "channel", "ptype"});
+  EXPECT_TRUE(allowlist.IsAllowed("ptype"));
+  EXPECT_TRUE(allowlist.IsAllowed("channel"));
+  EXPECT_FALSE(allowlist.IsAllowed("ptyp"));
+  EXPECT_FALSE(allowlist.IsAllowed("ptypes"));
+  EXPECT_FALSE(allowlist.IsAllowed(""));
+}
+
+TEST(AnnotationAllowlist, Prefixes) {
+  internal::AnnotationAllowlist allowlist(
+      {"gpu-*", "gpu-driver-*", "switch-*", "num-*", "crash_key"});
+  EXPECT_TRUE(allowlist.IsAllowed("gpu-"));
+  EXPECT_TRUE(allowlist.IsAllowed("gpu-vendor"));
+  EXPECT_TRUE(allowlist.IsAllowed("gpu-driver-version"));
+  EXPECT_TRUE(allowlist.IsAllowed("switch-1"));
+  EXPECT_TRUE(allowlist.IsAllowed("num-switches"));
+  EXPECT_TRUE(allowlist.IsAllowed("crash_key"));
+  EXPECT_FALSE(allowlist.IsAllowed("gpu"));
+  EXPECT_FALSE(allowlist.IsAllowed("gpt-"));
+  EXPECT_FALSE(allowlist.IsAllowed("nu"));
+  EXPECT_FALSE(allowlist.IsAllowed("switch"));
+  EXPECT_FALSE(allowlist.IsAllowed("switcH-1"));
+  EXPECT_FALSE(allowlist.IsAllowed("crash_key_2"));
+  EXPECT_FALSE(allowlist.IsAllowed("zzz"));
+}
+
+TEST(AnnotationAllowlist, AllowAll) {
+  internal::AnnotationAllowlist allowlist({"name", "*", "prefix*"});
+  EXPECT_TRUE(allowlist.IsAllowed(""));
+  EXPECT_TRUE(allowlist.IsAllowed("anything"));
+}
+
+TEST(AnnotationAllowlist, Patterns) {
+  internal::AnnotationAllowlist allowlist({"*-count", "url-chunk-?", "a*b*"});
+  EXPECT_TRUE(allowlist.IsAllowed("tab-count"));
+  EXPECT_TRUE(allowlist.IsAllowed("url-chunk-1"));
+  EXPECT_TRUE(allowlist.IsAllowed("axxbyy"));
+  EXPECT_FALSE(allowlist.IsAllowed("tab-counts"));
+  EXPECT_FALSE(allowlist.IsAllowed("url-chunk-12"));
+  EXPECT_FALSE(allowlist.IsAllowed("axx"));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -16,6 +16,8 @@
 
 #include <string.h>
 
+#include "build/build_config.h"
+#include "snapshot/sanitized/sanitization_pipeline.h"
 #include "util/linux/pac_helper.h"
 
 namespace crashpad {
@@ -23,6 +25,16 @@ namespace internal {
 
 namespace {
 
+// StripPACBits() only changes addresses on ARM64. Elsewhere, avoid an
+// out-of-line call for every word sanitized.
+inline VMAddress StripWord(VMAddress word) {
+#if defined(ARCH_CPU_ARM64)
+  return StripPACBits(word);
+#else
+  return word;
+#endif
+}
+
 class MemorySanitizer : public MemorySnapshot::Delegate {
  public:
   MemorySanitizer(MemorySnapshot::Delegate* delegate,
@@ -59,14 +71,22 @@ class MemorySanitizer : public MemorySnapshot::Delegate {
         ((address_ + sizeof(Pointer) - 1) & ~(sizeof(Pointer) - 1)) - address_;
     memcpy(data, &defaced, aligned_offset);
 
-    // Sanitize words that aren't small and don't look like pointers.
+    // Sanitize words that aren't small and don't look like pointers. Most
+    // words that aren't small fall outside of the bounds of every allowed
+    // range, and are defaced without searching ranges_.
+    VMAddress lowest, highest;
+    if (!ranges_->Bounds(&lowest, &highest)) {
+      lowest = highest = 0;
+    }
+    const VMAddress span = highest - lowest;
+
     size_t word_count = (size - aligned_offset) / sizeof(Pointer);
     auto words =
         reinterpret_cast<Pointer*>(static_cast<char*>(data) + aligned_offset);
     for (size_t index = 0; index < word_count; ++index) {
-      auto word = StripPACBits(words[index]);
+      const VMAddress word = StripWord(words[index]);
       if (word > MemorySnapshotSanitized::kSmallWordMax &&
-          !ranges_->Contains(word)) {
+          (word - lowest > span || !ranges_->Contains(word))) {
         words[index] = defaced;
       }
     }
@@ -90,7 +110,11 @@ class MemorySanitizer : public MemorySnapshot::Delegate {
 MemorySnapshotSanitized::MemorySnapshotSanitized(const MemorySnapshot* snapshot,
                                                  RangeSet* ranges,
                                                  bool is_64_bit)
-    : snapshot_(snapshot), ranges_(ranges), is_64_bit_(is_64_bit) {}
+    : snapshot_(snapshot),
+      ranges_(ranges),
+      pipeline_(nullptr),
+      pipeline_index_(0),
+      is_64_bit_(is_64_bit) {}
 
 MemorySnapshotSanitized::~MemorySnapshotSanitized() = default;
 
@@ -103,6 +127,13 @@ size_t MemorySnapshotSanitized::Size() const {
 }
 
 bool MemorySnapshotSanitized::Read(Delegate* delegate) const {
+  if (pipeline_) {
+    return pipeline_->Read(pipeline_index_, delegate);
+  }
+  return ReadSanitized(delegate);
+}
+
+bool MemorySnapshotSanitized::ReadSanitized(Delegate* delegate) const {
   MemorySanitizer sanitizer(delegate, ranges_, Address(), is_64_bit_);
   return snapshot_->Read(&sanitizer);
 }
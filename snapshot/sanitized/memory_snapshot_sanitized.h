@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_SNAPSHOT_SANITIZED_MEMORY_SNAPSHOT_SANITIZED_H_
 #define CRASHPAD_SNAPSHOT_SANITIZED_MEMORY_SNAPSHOT_SANITIZED_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "snapshot/memory_snapshot.h"
@@ -23,6 +24,8 @@
 namespace crashpad {
 namespace internal {
 
+class SanitizationPipeline;
+
 //! \brief A MemorySnapshot which wraps and filters sensitive information from
 //!     another MemorySnapshot.
 //!
@@ -52,6 +55,21 @@ class MemorySnapshotSanitized final : public MemorySnapshot {
 
   ~MemorySnapshotSanitized() override;
 
+  //! \brief Has Read() obtain this memory from \a pipeline, which may have
+  //!     sanitized it ahead of time.
+  //!
+  //! \param[in] pipeline The pipeline, which must outlive any call to Read().
+  //! \param[in] index The index of this object among the snapshots given to
+  //!     \a pipeline.
+  void SetPipeline(SanitizationPipeline* pipeline, size_t index) {
+    pipeline_ = pipeline;
+    pipeline_index_ = index;
+  }
+
+  //! \brief Reads and sanitizes the wrapped memory, as Read() does without a
+  //!     pipeline.
+  bool ReadSanitized(Delegate* delegate) const;
+
   // MemorySnapshot:
 
   uint64_t Address() const override;
@@ -66,6 +84,8 @@ class MemorySnapshotSanitized final : public MemorySnapshot {
  private:
   const MemorySnapshot* snapshot_;
   RangeSet* ranges_;
+  SanitizationPipeline* pipeline_;  // weak
+  size_t pipeline_index_;
   bool is_64_bit_;
 };
 
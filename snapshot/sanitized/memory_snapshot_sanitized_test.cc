@@ -0,0 +1,201 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/memory_snapshot_sanitized.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <iterator>
+#include <vector>
+
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
+#include "gtest/gtest.h"
+#include "util/linux/pac_helper.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A MemorySnapshot of a copy of some data.
+class BufferMemorySnapshot : public MemorySnapshot {
+ public:
+  BufferMemorySnapshot(uint64_t address, const std::vector<uint8_t>& data)
+      : address_(address), data_(data) {}
+
+  BufferMemorySnapshot(const BufferMemorySnapshot&) = delete;
+  BufferMemorySnapshot& operator=(const BufferMemorySnapshot&) = delete;
+
+  ~BufferMemorySnapshot() override {}
+
+  // MemorySnapshot:
+  uint64_t Address() const override { return address_; }
+  size_t Size() const override { return data_.size(); }
+  bool Read(Delegate* delegate) const override {
+    // Offset the data within an aligned buffer to match the alignment of
+    // address_, as reading from a process would.
+    const size_t misalignment = address_ % sizeof(uint64_t);
+    std::vector<uint64_t> buffer(
+        (misalignment + data_.size()) / sizeof(uint64_t) + 1);
+    uint8_t* data = reinterpret_cast<uint8_t*>(buffer.data()) + misalignment;
+    memcpy(data, data_.data(), data_.size());
+    return delegate->MemorySnapshotDelegateRead(data, data_.size());
+  }
+  const MemorySnapshot* MergeWithOtherSnapshot(
+      const MemorySnapshot* other) const override {
+    return nullptr;
+  }
+
+ private:
+  uint64_t address_;
+  std::vector<uint8_t> data_;
+};
+
+class ReadToVector : public MemorySnapshot::Delegate {
+ public:
+  ReadToVector() : data_() {}
+
+  ReadToVector(const ReadToVector&) = delete;
+  ReadToVector& operator=(const ReadToVector&) = delete;
+
+  ~ReadToVector() override {}
+
+  const std::vector<uint8_t>& data() const { return data_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    data_.assign(static_cast<uint8_t*>(data),
+                 static_cast<uint8_t*>(data) + size);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+// Sanitizes data one word at a time, as a reference.
+template <typename Pointer>
+std::vector<uint8_t> ExpectedSanitized(uint64_t address,
+                                       const std::vector<uint8_t>& data,
+                                       const RangeSet& ranges) {
+  const Pointer defaced =
+      static_cast<Pointer>(internal::MemorySnapshotSanitized::kDefaced);
+  const uint8_t* defaced_bytes = reinterpret_cast<const uint8_t*>(&defaced);
+
+  // Bytes before the first aligned word and after the last one are replaced
+  // with the leading bytes of the defaced value.
+  const size_t leading = (sizeof(Pointer) - address % sizeof(Pointer)) %
+                         sizeof(Pointer);
+  std::vector<uint8_t> expected;
+  for (size_t offset = 0; offset < leading && offset < data.size(); ++offset) {
+    expected.push_back(defaced_bytes[offset]);
+  }
+
+  size_t offset = leading;
+  for (; offset + sizeof(Pointer) <= data.size(); offset += sizeof(Pointer)) {
+    Pointer word;
+    memcpy(&word, &data[offset], sizeof(word));
+    const VMAddress stripped = StripPACBits(word);
+    if (stripped > internal::MemorySnapshotSanitized::kSmallWordMax &&
+        !ranges.Contains(stripped)) {
+      word = defaced;
+    }
+    const uint8_t* word_bytes = reinterpret_cast<const uint8_t*>(&word);
+    expected.insert(expected.end(), word_bytes, word_bytes + sizeof(word));
+  }
+
+  for (size_t index = 0; offset + index < data.size(); ++index) {
+    expected.push_back(defaced_bytes[index]);
+  }
+  return expected;
+}
+
+template <typename Pointer>
+void TestSanitize(bool is_64_bit) {
+  RangeSet ranges;
+  ranges.Insert(0x10000, 0x1000);
+  ranges.Insert(0x30000, 0x1000);
+  ranges.Insert(0x50000, 0x1000);
+
+  // Words that are small, within an allowed range, between allowed ranges, or
+  // outside of every allowed range.
+  const Pointer values[] = {0,
+                            1,
+                            internal::MemorySnapshotSanitized::kSmallWordMax,
+                            internal::MemorySnapshotSanitized::kSmallWordMax +
+                                1,
+                            0xffff,
+                            0x10000,
+                            0x10fff,
+                            0x11000,
+                            0x20000,
+                            0x30800,
+                            0x50fff,
+                            0x51000,
+                            static_cast<Pointer>(-1)};
+
+  // Cover both full and partial blocks of words, with runs of words that all
+  // fall outside of the allowed ranges.
+  std::vector<Pointer> words;
+  for (size_t index = 0; index < 300; ++index) {
+    words.push_back(index % 50 < 40 ? static_cast<Pointer>(-1 - index)
+                                    : values[index % std::size(values)]);
+  }
+  std::vector<uint8_t> data(words.size() * sizeof(Pointer));
+  memcpy(data.data(), words.data(), data.size());
+
+  constexpr uint64_t kAddress = 0x7000;
+  for (size_t leading = 0; leading < sizeof(Pointer); ++leading) {
+    for (size_t trailing = 0; trailing < sizeof(Pointer); ++trailing) {
+      SCOPED_TRACE(base::StringPrintf(
+          "leading %" PRIuS ", trailing %" PRIuS, leading, trailing));
+      const std::vector<uint8_t> subrange(data.begin() + leading,
+                                          data.end() - trailing);
+      BufferMemorySnapshot snapshot(kAddress + leading, subrange);
+      internal::MemorySnapshotSanitized sanitized(
+          &snapshot, &ranges, is_64_bit);
+      ReadToVector reader;
+      ASSERT_TRUE(sanitized.Read(&reader));
+      EXPECT_EQ(reader.data(),
+                ExpectedSanitized<Pointer>(
+                    kAddress + leading, subrange, ranges));
+    }
+  }
+}
+
+TEST(MemorySnapshotSanitized, Sanitize64) {
+  TestSanitize<uint64_t>(true);
+}
+
+TEST(MemorySnapshotSanitized, Sanitize32) {
+  TestSanitize<uint32_t>(false);
+}
+
+TEST(MemorySnapshotSanitized, NoAllowedRanges) {
+  RangeSet ranges;
+  const uint64_t words[] = {0, 0x10000, 0x20000, 0x1000};
+  std::vector<uint8_t> data(sizeof(words));
+  memcpy(data.data(), words, sizeof(words));
+
+  BufferMemorySnapshot snapshot(0x7000, data);
+  internal::MemorySnapshotSanitized sanitized(&snapshot, &ranges, true);
+  ReadToVector reader;
+  ASSERT_TRUE(sanitized.Read(&reader));
+  EXPECT_EQ(reader.data(), ExpectedSanitized<uint64_t>(0x7000, data, ranges));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "snapshot/module_snapshot.h"
+#include "snapshot/sanitized/annotation_allowlist.h"
 
 namespace crashpad {
 namespace internal {
@@ -30,11 +31,11 @@ class ModuleSnapshotSanitized final : public ModuleSnapshot {
   //! \brief Constructs this object.
   //!
   //! \param[in] snapshot The ModuleSnapshot to sanitize.
-  //! \param[in] allowed_annotations A list of annotation names to allow to be
-  //!     returned by AnnotationsSimpleMap() or AnnotationObjects(). If
-  //!     `nullptr`, all annotations will be returned.
+  //! \param[in] allowed_annotations The annotations to allow to be returned
+  //!     by AnnotationsSimpleMap() or AnnotationObjects(). If `nullptr`, all
+  //!     annotations will be returned.
   ModuleSnapshotSanitized(const ModuleSnapshot* snapshot,
-                          const std::vector<std::string>* allowed_annotations);
+                          const AnnotationAllowlist* allowed_annotations);
 
   ModuleSnapshotSanitized(const ModuleSnapshotSanitized&) = delete;
   ModuleSnapshotSanitized& operator=(const ModuleSnapshotSanitized&) = delete;
@@ -67,7 +68,7 @@ class ModuleSnapshotSanitized final : public ModuleSnapshot {
 
  private:
   const ModuleSnapshot* snapshot_;
-  const std::vector<std::string>* allowed_annotations_;
+  const AnnotationAllowlist* allowed_annotations_;
 };
 
 }  // namespace internal
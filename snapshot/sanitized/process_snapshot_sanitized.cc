@@ -18,6 +18,7 @@
 
 #include "snapshot/cpu_context.h"
 #include "util/linux/pac_helper.h"
+#include "util/misc/trace_event.h"
 #include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
@@ -91,6 +92,7 @@ bool ProcessSnapshotSanitized::Initialize(
         allowed_memory_ranges,
     VMAddress target_module_address,
     bool sanitize_stacks) {
+  CRASHPAD_TRACE_EVENT("capture", "ProcessSnapshotSanitized::Initialize");
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   snapshot_ = snapshot;
   allowed_annotations_ = std::move(allowed_annotations);
@@ -142,23 +144,61 @@ bool ProcessSnapshotSanitized::Initialize(
   }
 
   if (allowed_annotations_) {
+    annotation_allowlist_ =
+        std::make_unique<internal::AnnotationAllowlist>(*allowed_annotations_);
     for (const auto module : snapshot_->Modules()) {
       modules_.emplace_back(std::make_unique<internal::ModuleSnapshotSanitized>(
-          module, allowed_annotations_.get()));
+          module, annotation_allowlist_.get()));
     }
   }
 
   if (sanitize_stacks_) {
-    for (const auto module : snapshot_->Modules()) {
-      address_ranges_.Insert(module->Address(), module->Size());
+    const std::vector<const ModuleSnapshot*> modules = snapshot_->Modules();
+    const std::vector<const ThreadSnapshot*> threads = snapshot_->Threads();
+    std::vector<RangeSet::Range> ranges;
+    ranges.reserve(modules.size() + threads.size());
+    for (const auto module : modules) {
+      ranges.push_back({module->Address(), module->Size()});
+    }
+    for (const auto thread : threads) {
+      ranges.push_back({thread->Stack()->Address(), thread->Stack()->Size()});
     }
+    address_ranges_.InsertMany(ranges);
 
-    for (const auto thread : snapshot_->Threads()) {
-      address_ranges_.Insert(thread->Stack()->Address(),
-                             thread->Stack()->Size());
+    for (const auto thread : threads) {
       threads_.emplace_back(std::make_unique<internal::ThreadSnapshotSanitized>(
           thread, &address_ranges_));
     }
+
+    if (pipeline_thread_count_ > 0 && !threads_.empty()) {
+      std::vector<const internal::MemorySnapshotSanitized*> stacks;
+      stacks.reserve(threads_.size());
+      for (const auto& thread : threads_) {
+        stacks.push_back(thread->SanitizedStack());
+      }
+      pipeline_ = std::make_unique<internal::SanitizationPipeline>(
+          std::move(stacks),
+          pipeline_thread_count_,
+          pipeline_max_buffered_bytes_);
+      for (size_t index = 0; index < threads_.size(); ++index) {
+        threads_[index]->SanitizedStack()->SetPipeline(pipeline_.get(), index);
+      }
+    }
+  }
+
+  // Extra memory, such as ranges that the client registered for capture, is
+  // only kept if it lies wholly within an allowed memory range.
+  if (allowed_memory_ranges) {
+    for (const MemorySnapshot* memory : snapshot_->ExtraMemory()) {
+      const VMAddress begin = memory->Address();
+      const VMAddress end = begin + memory->Size();
+      for (const auto& allowed_range : *allowed_memory_ranges) {
+        if (begin >= allowed_range.first && end <= allowed_range.second) {
+          extra_memory_.push_back(memory);
+          break;
+        }
+      }
+    }
   }
 
   process_memory_.Initialize(snapshot_->Memory(), allowed_memory_ranges.get());
@@ -265,7 +305,7 @@ std::vector<HandleSnapshot> ProcessSnapshotSanitized::Handles() const {
 std::vector<const MemorySnapshot*> ProcessSnapshotSanitized::ExtraMemory()
     const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  return snapshot_->ExtraMemory();
+  return extra_memory_;
 }
 
 const ProcessMemory* ProcessSnapshotSanitized::Memory() const {
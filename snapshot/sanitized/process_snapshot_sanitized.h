@@ -15,13 +15,17 @@
 #ifndef CRASHPAD_SNAPSHOT_SANITIZED_PROCESS_SNAPSHOT_SANITIZED_H_
 #define CRASHPAD_SNAPSHOT_SANITIZED_PROCESS_SNAPSHOT_SANITIZED_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "snapshot/exception_snapshot.h"
 #include "snapshot/process_snapshot.h"
+#include "snapshot/sanitized/annotation_allowlist.h"
 #include "snapshot/sanitized/module_snapshot_sanitized.h"
+#include "snapshot/sanitized/sanitization_pipeline.h"
 #include "snapshot/sanitized/thread_snapshot_sanitized.h"
 #include "snapshot/thread_snapshot.h"
 #include "snapshot/unloaded_module_snapshot.h"
@@ -44,6 +48,33 @@ class ProcessSnapshotSanitized final : public ProcessSnapshot {
 
   ~ProcessSnapshotSanitized() override;
 
+  //! \brief Sanitizes thread stacks ahead of their being read.
+  //!
+  //! By default, each thread’s stack is read from the wrapped snapshot and
+  //! sanitized when it is read from this object, so a thread writing a
+  //! minidump of this object reads, sanitizes, and writes each stack in turn.
+  //! When enabled, stacks are instead read and sanitized in the order of
+  //! Threads() by an internal::SanitizationPipeline as soon as Initialize()
+  //! returns, so that the work overlaps with writing. Only stacks are affected,
+  //! and only when Initialize() is called with `sanitize_stacks` `true`.
+  //!
+  //! The wrapped snapshot’s memory is read from several threads at once, so
+  //! this must only be enabled if that’s supported, as indicated by
+  //! ProcessMemoryLinux::SupportsConcurrentReads() for a ProcessSnapshotLinux.
+  //!
+  //! This must be called before Initialize() to have any effect.
+  //!
+  //! \param[in] thread_count The number of threads to sanitize on, or `0` to
+  //!     sanitize each stack when it’s read, which is the default.
+  //! \param[in] max_buffered_bytes The most bytes of sanitized stacks to hold
+  //!     before they are read, in addition to any single stack larger than
+  //!     this.
+  void SetSanitizationPipelining(size_t thread_count,
+                                 size_t max_buffered_bytes) {
+    pipeline_thread_count_ = thread_count;
+    pipeline_max_buffered_bytes_ = max_buffered_bytes;
+  }
+
   //! \brief Initializes this object.
   //!
   //! This method must be successfully called before calling any other method on
@@ -103,10 +134,21 @@ class ProcessSnapshotSanitized final : public ProcessSnapshot {
   // Only used when sanitize_stacks_ == true.
   std::vector<std::unique_ptr<internal::ThreadSnapshotSanitized>> threads_;
 
+  // Reads threads_’ stacks. Only used when pipeline_thread_count_ > 0. Declared
+  // after threads_, so that it stops before they’re destroyed.
+  std::unique_ptr<internal::SanitizationPipeline> pipeline_;
+  size_t pipeline_thread_count_ = 0;
+  size_t pipeline_max_buffered_bytes_ = 0;
+
+  // The parts of the snapshot's extra memory lying within allowed memory
+  // ranges.
+  std::vector<const MemorySnapshot*> extra_memory_;
+
   RangeSet address_ranges_;
   const ProcessSnapshot* snapshot_;
   ProcessMemorySanitized process_memory_;
   std::unique_ptr<const std::vector<std::string>> allowed_annotations_;
+  std::unique_ptr<internal::AnnotationAllowlist> annotation_allowlist_;
   bool sanitize_stacks_;
   InitializationStateDcheck initialized_;
 };
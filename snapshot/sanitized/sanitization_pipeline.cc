@@ -0,0 +1,160 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/sanitization_pipeline.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "snapshot/sanitized/memory_snapshot_sanitized.h"
+
+namespace crashpad {
+namespace internal {
+
+namespace {
+
+// Copies the sanitized contents of a snapshot into a buffer.
+class BufferingDelegate : public MemorySnapshot::Delegate {
+ public:
+  BufferingDelegate() : buffer_(), size_(0) {}
+
+  BufferingDelegate(const BufferingDelegate&) = delete;
+  BufferingDelegate& operator=(const BufferingDelegate&) = delete;
+
+  ~BufferingDelegate() = default;
+
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    buffer_.reset(new uint8_t[size]);
+    if (size > 0) {
+      memcpy(buffer_.get(), data, size);
+    }
+    size_ = size;
+    return true;
+  }
+
+  std::unique_ptr<uint8_t[]> TakeBuffer() { return std::move(buffer_); }
+  size_t size() const { return size_; }
+
+ private:
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t size_;
+};
+
+}  // namespace
+
+SanitizationPipeline::SanitizationPipeline(
+    std::vector<const MemorySnapshotSanitized*> snapshots,
+    size_t thread_count,
+    size_t max_buffered_bytes)
+    : lock_(),
+      condition_(),
+      entries_(),
+      next_entry_(0),
+      buffered_bytes_(0),
+      max_buffered_bytes_(max_buffered_bytes),
+      stopping_(false),
+      pool_(thread_count),
+      group_(&pool_) {
+  DCHECK_GT(thread_count, 0u);
+  entries_.reserve(snapshots.size());
+  for (const MemorySnapshotSanitized* snapshot : snapshots) {
+    entries_.push_back({snapshot, nullptr, 0, 0, State::kPending, false});
+  }
+  for (size_t index = 0; index < thread_count; ++index) {
+    group_.Post([this]() { SanitizeEntries(); });
+  }
+}
+
+SanitizationPipeline::~SanitizationPipeline() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  group_.Wait();
+}
+
+bool SanitizationPipeline::Read(size_t index,
+                                MemorySnapshot::Delegate* delegate) {
+  std::unique_lock<std::mutex> lock(lock_);
+  DCHECK_LT(index, entries_.size());
+  Entry& entry = entries_[index];
+  condition_.wait(lock,
+                  [&entry]() { return entry.state != State::kSanitizing; });
+
+  if (entry.state != State::kReady) {
+    // Claim the entry so that the pipeline skips it.
+    entry.state = State::kRead;
+    lock.unlock();
+    return entry.snapshot->ReadSanitized(delegate);
+  }
+
+  entry.state = State::kRead;
+  const std::unique_ptr<uint8_t[]> buffer = std::move(entry.buffer);
+  lock.unlock();
+  const bool rv = entry.success &&
+                  (!buffer ||
+                   delegate->MemorySnapshotDelegateRead(buffer.get(),
+                                                        entry.size));
+
+  // Release the space only once the buffer is no longer needed, so that no
+  // more than max_buffered_bytes_ is held.
+  lock.lock();
+  buffered_bytes_ -= entry.reserved;
+  condition_.notify_all();
+  return rv;
+}
+
+void SanitizationPipeline::SanitizeEntries() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    while (next_entry_ < entries_.size() &&
+           entries_[next_entry_].state != State::kPending) {
+      ++next_entry_;
+    }
+    if (stopping_ || next_entry_ == entries_.size()) {
+      return;
+    }
+
+    // Wait for space for the next entry, unless nothing is buffered, so that
+    // an entry larger than the limit is sanitized by itself.
+    Entry& entry = entries_[next_entry_];
+    const size_t size = entry.snapshot->Size();
+    if (buffered_bytes_ > 0 && buffered_bytes_ + size > max_buffered_bytes_) {
+      condition_.wait(lock);
+      continue;
+    }
+
+    ++next_entry_;
+    entry.state = State::kSanitizing;
+    entry.reserved = size;
+    buffered_bytes_ += size;
+    lock.unlock();
+
+    BufferingDelegate buffering_delegate;
+    const bool success = entry.snapshot->ReadSanitized(&buffering_delegate);
+
+    lock.lock();
+    entry.buffer = buffering_delegate.TakeBuffer();
+    entry.size = buffering_delegate.size();
+    entry.success = success;
+    entry.state = State::kReady;
+    condition_.notify_all();
+  }
+}
+
+}  // namespace internal
+}  // namespace crashpad
@@ -0,0 +1,118 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_SNAPSHOT_SANITIZED_SANITIZATION_PIPELINE_H_
+#define CRASHPAD_SNAPSHOT_SANITIZED_SANITIZATION_PIPELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "snapshot/memory_snapshot.h"
+#include "util/thread/thread_pool.h"
+
+namespace crashpad {
+namespace internal {
+
+class MemorySnapshotSanitized;
+
+//! \brief Sanitizes memory ahead of the thread that reads it.
+//!
+//! The pipeline’s threads read and sanitize each snapshot in turn, in the
+//! order given to the constructor, into buffers holding at most a bounded
+//! number of bytes in total. When a snapshot is then read, its buffered
+//! contents are provided without further work, so that reading and sanitizing
+//! the target’s memory overlap with writing it. A snapshot that is read before
+//! the pipeline has started on it is read and sanitized by the reading thread,
+//! as it would be without a pipeline, and is skipped by the pipeline.
+//!
+//! The snapshots’ memory is read from several threads at once, so the memory
+//! that they wrap must support concurrent reads.
+class SanitizationPipeline {
+ public:
+  //! \brief Starts sanitizing \a snapshots.
+  //!
+  //! \param[in] snapshots The snapshots to sanitize, in the order in which
+  //!     they are expected to be read. Each must outlive this object.
+  //! \param[in] thread_count The number of threads to sanitize on, which must
+  //!     be at least `1`.
+  //! \param[in] max_buffered_bytes The most bytes of sanitized memory to hold
+  //!     at once, in addition to that of any single snapshot larger than this.
+  SanitizationPipeline(std::vector<const MemorySnapshotSanitized*> snapshots,
+                       size_t thread_count,
+                       size_t max_buffered_bytes);
+
+  SanitizationPipeline(const SanitizationPipeline&) = delete;
+  SanitizationPipeline& operator=(const SanitizationPipeline&) = delete;
+
+  //! \brief Stops sanitizing, waiting for work in progress to finish.
+  ~SanitizationPipeline();
+
+  //! \brief Provides the sanitized contents of a snapshot to \a delegate.
+  //!
+  //! This waits if the pipeline is sanitizing the snapshot. The snapshot’s
+  //! buffer is released once it has been provided, so that the pipeline can
+  //! move on. Reading a snapshot more than once sanitizes it again.
+  //!
+  //! \param[in] index The index of the snapshot in the vector given to the
+  //!     constructor.
+  //! \param[in] delegate The delegate to provide the contents to.
+  //!
+  //! \return The result of MemorySnapshot::Read().
+  bool Read(size_t index, MemorySnapshot::Delegate* delegate);
+
+ private:
+  enum class State {
+    kPending,
+    kSanitizing,
+    kReady,
+    kRead,
+  };
+
+  struct Entry {
+    const MemorySnapshotSanitized* snapshot;  // weak
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t size;
+    size_t reserved;  // counted in buffered_bytes_ while the entry is held
+    State state;
+    bool success;
+  };
+
+  // Sanitizes entries until every entry has been started or the pipeline is
+  // stopping. Run by each of the pool’s threads.
+  void SanitizeEntries();
+
+  // Guards the fields below.
+  std::mutex lock_;
+  std::condition_variable condition_;
+  std::vector<Entry> entries_;
+  size_t next_entry_;
+  size_t buffered_bytes_;
+  const size_t max_buffered_bytes_;
+  bool stopping_;
+
+  // Declared last, so that the group is waited for before anything that its
+  // tasks use is destroyed.
+  ThreadPool pool_;
+  ThreadPool::TaskGroup group_;
+};
+
+}  // namespace internal
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_SANITIZED_SANITIZATION_PIPELINE_H_
@@ -0,0 +1,155 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "snapshot/sanitized/sanitization_pipeline.h"
+
+#include <stdint.h>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "snapshot/sanitized/memory_snapshot_sanitized.h"
+#include "snapshot/test/test_memory_snapshot.h"
+#include "util/misc/range_set.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class ReadToVector : public MemorySnapshot::Delegate {
+ public:
+  ReadToVector() : data_() {}
+
+  ReadToVector(const ReadToVector&) = delete;
+  ReadToVector& operator=(const ReadToVector&) = delete;
+
+  ~ReadToVector() override {}
+
+  const std::vector<uint8_t>& data() const { return data_; }
+
+  // MemorySnapshot::Delegate:
+  bool MemorySnapshotDelegateRead(void* data, size_t size) override {
+    data_.assign(static_cast<uint8_t*>(data),
+                 static_cast<uint8_t*>(data) + size);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+class SanitizationPipelineTest : public testing::Test {
+ protected:
+  // Adds a snapshot of size bytes of value, alternating between words that
+  // are defaced and words that are kept.
+  void AddSnapshot(size_t size, char value, bool should_fail = false) {
+    auto memory = std::make_unique<TestMemorySnapshot>();
+    memory->SetAddress(0x1000 * (memory_.size() + 1));
+    memory->SetSize(size);
+    memory->SetValue(value);
+    if (should_fail) {
+      memory->SetShouldFailRead(true);
+    }
+    sanitized_.push_back(std::make_unique<internal::MemorySnapshotSanitized>(
+        memory.get(), &ranges_, true));
+    memory_.push_back(std::move(memory));
+  }
+
+  std::unique_ptr<internal::SanitizationPipeline> StartPipeline(
+      size_t thread_count,
+      size_t max_buffered_bytes) {
+    std::vector<const internal::MemorySnapshotSanitized*> snapshots;
+    for (const auto& sanitized : sanitized_) {
+      snapshots.push_back(sanitized.get());
+    }
+    auto pipeline = std::make_unique<internal::SanitizationPipeline>(
+        std::move(snapshots), thread_count, max_buffered_bytes);
+    for (size_t index = 0; index < sanitized_.size(); ++index) {
+      sanitized_[index]->SetPipeline(pipeline.get(), index);
+    }
+    return pipeline;
+  }
+
+  // Checks that reading snapshot index through its pipeline provides what
+  // sanitizing it directly does.
+  void ExpectRead(size_t index) {
+    SCOPED_TRACE(index);
+    ReadToVector expected;
+    ASSERT_TRUE(sanitized_[index]->ReadSanitized(&expected));
+    ReadToVector actual;
+    ASSERT_TRUE(sanitized_[index]->Read(&actual));
+    EXPECT_EQ(actual.data(), expected.data());
+  }
+
+  RangeSet ranges_;
+  std::vector<std::unique_ptr<TestMemorySnapshot>> memory_;
+  std::vector<std::unique_ptr<internal::MemorySnapshotSanitized>> sanitized_;
+};
+
+TEST_F(SanitizationPipelineTest, ReadInOrder) {
+  static constexpr size_t kSizes[] = {8, 1, 100, 4096, 3, 10000, 64, 16};
+  for (size_t index = 0; index < std::size(kSizes); ++index) {
+    AddSnapshot(kSizes[index], index % 2 ? 'x' : '\0');
+  }
+
+  // The limit is smaller than some snapshots, which are then buffered alone.
+  auto pipeline = StartPipeline(2, 1024);
+  for (size_t index = 0; index < sanitized_.size(); ++index) {
+    ExpectRead(index);
+  }
+
+  // Reading again sanitizes again.
+  ExpectRead(3);
+}
+
+TEST_F(SanitizationPipelineTest, ReadOutOfOrder) {
+  for (size_t index = 0; index < 16; ++index) {
+    AddSnapshot(256 + index, 'x');
+  }
+
+  auto pipeline = StartPipeline(3, 512);
+  for (size_t index = sanitized_.size(); index > 0; --index) {
+    ExpectRead(index - 1);
+  }
+}
+
+TEST_F(SanitizationPipelineTest, ReadFailure) {
+  AddSnapshot(64, 'x');
+  AddSnapshot(64, 'x', true);
+  AddSnapshot(64, 'x');
+
+  auto pipeline = StartPipeline(1, 4096);
+  ExpectRead(0);
+  ReadToVector delegate;
+  EXPECT_FALSE(sanitized_[1]->Read(&delegate));
+  ExpectRead(2);
+}
+
+TEST_F(SanitizationPipelineTest, DestroyUnread) {
+  for (size_t index = 0; index < 8; ++index) {
+    AddSnapshot(1024, 'x');
+  }
+
+  // The pipeline stops while waiting for space, without the snapshots being
+  // read.
+  auto pipeline = StartPipeline(2, 2048);
+  ExpectRead(0);
+  pipeline.reset();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
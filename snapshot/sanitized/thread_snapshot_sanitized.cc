@@ -63,5 +63,14 @@ std::vector<const MemorySnapshot*> ThreadSnapshotSanitized::ExtraMemory()
   return std::vector<const MemorySnapshot*>();
 }
 
+const ExtendedRegisterState* ThreadSnapshotSanitized::ExtendedRegisters()
+    const {
+  return snapshot_->ExtendedRegisters();
+}
+
+const ThreadSchedulingStats* ThreadSnapshotSanitized::SchedulingStats() const {
+  return snapshot_->SchedulingStats();
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -41,6 +41,9 @@ class ThreadSnapshotSanitized final : public ThreadSnapshot {
 
   ~ThreadSnapshotSanitized() override;
 
+  //! \brief Returns the sanitized stack that Stack() returns.
+  MemorySnapshotSanitized* SanitizedStack() { return &stack_; }
+
   // ThreadSnapshot:
 
   const CPUContext* Context() const override;
@@ -51,6 +54,8 @@ class ThreadSnapshotSanitized final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
+  const ThreadSchedulingStats* SchedulingStats() const override;
 
  private:
   const ThreadSnapshot* snapshot_;
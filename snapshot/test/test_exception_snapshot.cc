@@ -63,5 +63,9 @@ std::vector<const MemorySnapshot*> TestExceptionSnapshot::ExtraMemory() const {
   return extra_memory;
 }
 
+const ExtendedRegisterState* TestExceptionSnapshot::ExtendedRegisters() const {
+  return extended_registers_.get();
+}
+
 }  // namespace test
 }  // namespace crashpad
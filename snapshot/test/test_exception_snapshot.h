@@ -23,6 +23,7 @@
 
 #include "snapshot/cpu_context.h"
 #include "snapshot/exception_snapshot.h"
+#include "util/misc/extended_register_state.h"
 
 namespace crashpad {
 namespace test {
@@ -66,6 +67,17 @@ class TestExceptionSnapshot final : public ExceptionSnapshot {
     extra_memory_.push_back(std::move(extra_memory));
   }
 
+  //! \brief Sets the extended register state to be returned by
+  //!     ExtendedRegisters().
+  //!
+  //! \param[in] extended_registers The state that ExtendedRegisters() will
+  //!     return. The TestExceptionSnapshot object takes ownership of \a
+  //!     extended_registers.
+  void SetExtendedRegisters(
+      std::unique_ptr<ExtendedRegisterState> extended_registers) {
+    extended_registers_ = std::move(extended_registers);
+  }
+
   // ExceptionSnapshot:
 
   const CPUContext* Context() const override;
@@ -75,6 +87,7 @@ class TestExceptionSnapshot final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
 
  private:
   union {
@@ -88,6 +101,7 @@ class TestExceptionSnapshot final : public ExceptionSnapshot {
   uint64_t exception_address_;
   std::vector<uint64_t> codes_;
   std::vector<std::unique_ptr<MemorySnapshot>> extra_memory_;
+  std::unique_ptr<ExtendedRegisterState> extended_registers_;
 };
 
 }  // namespace test
@@ -24,7 +24,9 @@ TestThreadSnapshot::TestThreadSnapshot()
       thread_id_(0),
       suspend_count_(0),
       priority_(0),
-      thread_specific_data_address_(0) {
+      thread_specific_data_address_(0),
+      scheduling_stats_(),
+      have_scheduling_stats_(false) {
   context_.x86 = &context_union_.x86;
 }
 
@@ -67,5 +69,13 @@ std::vector<const MemorySnapshot*> TestThreadSnapshot::ExtraMemory() const {
   return extra_memory;
 }
 
+const ExtendedRegisterState* TestThreadSnapshot::ExtendedRegisters() const {
+  return extended_registers_.get();
+}
+
+const ThreadSchedulingStats* TestThreadSnapshot::SchedulingStats() const {
+  return have_scheduling_stats_ ? &scheduling_stats_ : nullptr;
+}
+
 }  // namespace test
 }  // namespace crashpad
@@ -25,6 +25,7 @@
 #include "snapshot/cpu_context.h"
 #include "snapshot/memory_snapshot.h"
 #include "snapshot/thread_snapshot.h"
+#include "util/misc/extended_register_state.h"
 
 namespace crashpad {
 namespace test {
@@ -82,6 +83,24 @@ class TestThreadSnapshot final : public ThreadSnapshot {
     extra_memory_.push_back(std::move(extra_memory));
   }
 
+  //! \brief Sets the extended register state to be returned by
+  //!     ExtendedRegisters().
+  //!
+  //! \param[in] extended_registers The state that ExtendedRegisters() will
+  //!     return. The TestThreadSnapshot object takes ownership of \a
+  //!     extended_registers.
+  void SetExtendedRegisters(
+      std::unique_ptr<ExtendedRegisterState> extended_registers) {
+    extended_registers_ = std::move(extended_registers);
+  }
+
+  //! \brief Sets the scheduling statistics to be returned by
+  //!     SchedulingStats().
+  void SetSchedulingStats(const ThreadSchedulingStats& scheduling_stats) {
+    scheduling_stats_ = scheduling_stats;
+    have_scheduling_stats_ = true;
+  }
+
   // ThreadSnapshot:
 
   const CPUContext* Context() const override;
@@ -92,6 +111,8 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   int Priority() const override;
   uint64_t ThreadSpecificDataAddress() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
+  const ThreadSchedulingStats* SchedulingStats() const override;
 
  private:
   union {
@@ -106,6 +127,9 @@ class TestThreadSnapshot final : public ThreadSnapshot {
   int priority_;
   uint64_t thread_specific_data_address_;
   std::vector<std::unique_ptr<MemorySnapshot>> extra_memory_;
+  std::unique_ptr<ExtendedRegisterState> extended_registers_;
+  ThreadSchedulingStats scheduling_stats_;
+  bool have_scheduling_stats_;
 };
 
 }  // namespace test
@@ -0,0 +1,72 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "snapshot/thread_filter.h"
+
+#include "base/strings/pattern.h"
+
+namespace crashpad {
+
+ThreadFilter::ThreadFilter()
+    : max_other_threads(), name_patterns(), thread_ids() {}
+
+ThreadFilter::ThreadFilter(const ThreadFilter& other) = default;
+
+ThreadFilter& ThreadFilter::operator=(const ThreadFilter& other) = default;
+
+ThreadFilter::~ThreadFilter() = default;
+
+bool ThreadFilter::IsEnabled() const {
+  return max_other_threads || !name_patterns.empty() || !thread_ids.empty();
+}
+
+std::vector<bool> ThreadFilter::Select(
+    const std::vector<const ThreadSnapshot*>& threads,
+    uint64_t exception_thread_id) const {
+  if (!IsEnabled()) {
+    return std::vector<bool>(threads.size(), true);
+  }
+
+  std::vector<bool> selected(threads.size(), false);
+  size_t other_threads = 0;
+  const size_t max_others = max_other_threads.value_or(0);
+  for (size_t index = 0; index < threads.size(); ++index) {
+    const ThreadSnapshot* thread = threads[index];
+    const uint64_t thread_id = thread->ThreadID();
+    if (thread_id == exception_thread_id || thread_ids.count(thread_id)) {
+      selected[index] = true;
+      continue;
+    }
+
+    if (!name_patterns.empty()) {
+      const std::string name = thread->ThreadName();
+      for (const std::string& pattern : name_patterns) {
+        if (base::MatchPattern(name, pattern)) {
+          selected[index] = true;
+          break;
+        }
+      }
+      if (selected[index]) {
+        continue;
+      }
+    }
+
+    if (other_threads < max_others) {
+      ++other_threads;
+      selected[index] = true;
+    }
+  }
+  return selected;
+}
+
+}  // namespace crashpad
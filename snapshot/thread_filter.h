@@ -0,0 +1,72 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CRASHPAD_SNAPSHOT_THREAD_FILTER_H_
+#define CRASHPAD_SNAPSHOT_THREAD_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "snapshot/thread_snapshot.h"
+
+namespace crashpad {
+
+//! \brief Selects which of a process’ threads are captured.
+//!
+//! A filter with no selectors keeps every thread. Otherwise, the exception
+//! thread is always kept, along with any thread whose ID is in #thread_ids or
+//! whose name matches one of #name_patterns, and the first
+//! #max_other_threads of the remaining threads in the order that the process
+//! snapshot lists them. This keeps dumps of processes with thousands of
+//! threads to the few that matter, such as the main and garbage collector
+//! threads.
+struct ThreadFilter {
+  ThreadFilter();
+  ThreadFilter(const ThreadFilter& other);
+  ThreadFilter& operator=(const ThreadFilter& other);
+  ~ThreadFilter();
+
+  //! \brief Whether any selector is set, so that threads may be dropped.
+  bool IsEnabled() const;
+
+  //! \brief Decides which of \a threads are kept.
+  //!
+  //! \param[in] threads The threads of the process, in the order in which they
+  //!     will be captured.
+  //! \param[in] exception_thread_id The ID of the thread that raised the
+  //!     exception, which is always kept.
+  //! \return A vector the size of \a threads, with `true` for each thread that
+  //!     is kept.
+  std::vector<bool> Select(const std::vector<const ThreadSnapshot*>& threads,
+                           uint64_t exception_thread_id) const;
+
+  //! \brief The number of threads that are kept without otherwise being
+  //!     selected. If unset, none are.
+  std::optional<size_t> max_other_threads;
+
+  //! \brief Patterns, matched as they are by `base::MatchPattern()`, for the
+  //!     names of threads to keep.
+  std::vector<std::string> name_patterns;
+
+  //! \brief The IDs of threads to keep.
+  std::set<uint64_t> thread_ids;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_SNAPSHOT_THREAD_FILTER_H_
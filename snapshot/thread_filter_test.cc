@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "snapshot/thread_filter.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "snapshot/test/test_thread_snapshot.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class ThreadFilterTest : public testing::Test {
+ protected:
+  void AddThread(uint64_t thread_id, const std::string& name) {
+    auto thread = std::make_unique<TestThreadSnapshot>();
+    thread->SetThreadID(thread_id);
+    thread->SetThreadName(name);
+    threads_.push_back(thread.get());
+    storage_.push_back(std::move(thread));
+  }
+
+  const std::vector<const ThreadSnapshot*>& threads() const {
+    return threads_;
+  }
+
+ private:
+  std::vector<std::unique_ptr<TestThreadSnapshot>> storage_;
+  std::vector<const ThreadSnapshot*> threads_;
+};
+
+TEST_F(ThreadFilterTest, Disabled) {
+  AddThread(1, "main");
+  AddThread(2, "worker");
+
+  ThreadFilter filter;
+  EXPECT_FALSE(filter.IsEnabled());
+  EXPECT_EQ(filter.Select(threads(), 2), std::vector<bool>({true, true}));
+}
+
+TEST_F(ThreadFilterTest, MaxOtherThreads) {
+  AddThread(1, "main");
+  AddThread(2, "worker");
+  AddThread(3, "worker");
+  AddThread(4, "worker");
+
+  ThreadFilter filter;
+  filter.max_other_threads = 1;
+  EXPECT_TRUE(filter.IsEnabled());
+  EXPECT_EQ(filter.Select(threads(), 3),
+            std::vector<bool>({true, false, true, false}));
+
+  filter.max_other_threads = 0;
+  EXPECT_EQ(filter.Select(threads(), 3),
+            std::vector<bool>({false, false, true, false}));
+}
+
+TEST_F(ThreadFilterTest, NamesAndIDs) {
+  AddThread(1, "main");
+  AddThread(2, "GC Thread#0");
+  AddThread(3, "worker");
+  AddThread(4, "GC Thread#1");
+  AddThread(5, "worker");
+  AddThread(6, "worker");
+
+  ThreadFilter filter;
+  filter.name_patterns = {"main", "GC Thread*"};
+  filter.thread_ids = {6};
+  EXPECT_EQ(filter.Select(threads(), 5),
+            std::vector<bool>({true, true, false, true, true, true}));
+
+  // Threads kept by name or ID don't count against max_other_threads.
+  filter.max_other_threads = 1;
+  EXPECT_EQ(filter.Select(threads(), 5),
+            std::vector<bool>({true, true, true, true, true, true}));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -23,8 +23,40 @@
 namespace crashpad {
 
 struct CPUContext;
+class ExtendedRegisterState;
 class MemorySnapshot;
 
+//! \brief A thread’s CPU usage and scheduling state.
+struct ThreadSchedulingStats {
+  //! \brief The time the thread has spent executing in user mode, in
+  //!     microseconds.
+  uint64_t user_time_us;
+
+  //! \brief The time the thread has spent executing in system mode, in
+  //!     microseconds.
+  uint64_t system_time_us;
+
+  //! \brief The number of times the thread gave up its CPU voluntarily.
+  //!     Valid only if #have_context_switches is `true`.
+  uint64_t voluntary_context_switches;
+
+  //! \brief The number of times the thread was preempted. Valid only if
+  //!     #have_context_switches is `true`.
+  uint64_t involuntary_context_switches;
+
+  //! \brief The CPU that the thread last ran on, or `-1` if unknown.
+  int32_t last_cpu;
+
+  //! \brief The thread’s scheduling state, as a single character such as
+  //!     `'R'` for running or `'S'` for sleeping. The meanings of states are
+  //!     operating system-specific, and on Linux are those documented for
+  //!     <code>/proc/<i>pid</i>/stat</code> in `proc(5)`.
+  char state;
+
+  //! \brief `true` if the context switch counts are valid.
+  bool have_context_switches;
+};
+
 //! \brief An abstract interface to a snapshot representing a thread
 //!     (lightweight process) present in a snapshot process.
 class ThreadSnapshot {
@@ -77,6 +109,23 @@ class ThreadSnapshot {
   //!     are scoped to the lifetime of the ThreadSnapshot object that they
   //!     were obtained from.
   virtual std::vector<const MemorySnapshot*> ExtraMemory() const = 0;
+
+  //! \brief Returns the thread’s register state beyond what Context() holds,
+  //!     such as AVX or SVE registers, or `nullptr` if none was captured.
+  //!
+  //! Components of the state that were in their initial state are omitted, so
+  //! the returned object may be empty.
+  //!
+  //! The caller does not take ownership of this object, it is scoped to the
+  //! lifetime of the ThreadSnapshot object that it was obtained from.
+  virtual const ExtendedRegisterState* ExtendedRegisters() const = 0;
+
+  //! \brief Returns the thread’s CPU usage and scheduling state, or `nullptr`
+  //!     if it wasn’t captured.
+  //!
+  //! The caller does not take ownership of this object, it is scoped to the
+  //! lifetime of the ThreadSnapshot object that it was obtained from.
+  virtual const ThreadSchedulingStats* SchedulingStats() const = 0;
 };
 
 }  // namespace crashpad
@@ -48,15 +48,15 @@ std::vector<CheckedRange<uint64_t>> CaptureMemoryDelegateWin::GetReadableRanges(
   return process_reader_->GetProcessInfo().GetReadableRanges(range);
 }
 
-void CaptureMemoryDelegateWin::AddNewMemorySnapshot(
+bool CaptureMemoryDelegateWin::AddNewMemorySnapshot(
     const CheckedRange<uint64_t, uint64_t>& range) {
   // Don't bother storing this memory if it points back into the stack.
   if (stack_.ContainsRange(range))
-    return;
+    return false;
   if (range.size() == 0)
-    return;
+    return false;
   if (!budget_remaining_ || *budget_remaining_ == 0)
-    return;
+    return false;
   snapshots_->push_back(std::make_unique<internal::MemorySnapshotGeneric>());
   internal::MemorySnapshotGeneric* snapshot = snapshots_->back().get();
   snapshot->Initialize(process_reader_->Memory(), range.base(), range.size());
@@ -67,6 +67,13 @@ void CaptureMemoryDelegateWin::AddNewMemorySnapshot(
     temp -= range.size();
     *budget_remaining_ = base::saturated_cast<uint32_t>(temp);
   }
+  return true;
+}
+
+bool CaptureMemoryDelegateWin::IsAnonymousExecutable(uint64_t address) const {
+  // JIT code isn't captured on Windows, which doesn't use
+  // CaptureMemory::JitCodeAroundContext().
+  return false;
 }
 
 }  // namespace internal
@@ -54,8 +54,9 @@ class CaptureMemoryDelegateWin : public CaptureMemory::Delegate {
   bool ReadMemory(uint64_t at, uint64_t num_bytes, void* into) const override;
   std::vector<CheckedRange<uint64_t>> GetReadableRanges(
       const CheckedRange<uint64_t, uint64_t>& range) const override;
-  void AddNewMemorySnapshot(
+  bool AddNewMemorySnapshot(
       const CheckedRange<uint64_t, uint64_t>& range) override;
+  bool IsAnonymousExecutable(uint64_t address) const override;
 
  private:
   CheckedRange<uint64_t, uint64_t> stack_;
@@ -197,6 +197,11 @@ std::vector<const MemorySnapshot*> ExceptionSnapshotWin::ExtraMemory() const {
   return result;
 }
 
+const ExtendedRegisterState* ExceptionSnapshotWin::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
 template <class ExceptionRecordType,
           class ExceptionPointersType,
           class ContextType>
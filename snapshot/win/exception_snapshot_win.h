@@ -84,6 +84,7 @@ class ExceptionSnapshotWin final : public ExceptionSnapshot {
   uint64_t ExceptionAddress() const override;
   const std::vector<uint64_t>& Codes() const override;
   std::vector<const MemorySnapshot*> ExtraMemory() const override;
+  const ExtendedRegisterState* ExtendedRegisters() const override;
 
  private:
   template <class ExceptionRecordType,
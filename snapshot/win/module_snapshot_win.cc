@@ -289,26 +289,11 @@ const VS_FIXEDFILEINFO* ModuleSnapshotWin::VSFixedFileInfo() const {
 template <class Traits>
 void ModuleSnapshotWin::GetCrashpadExtraMemoryRanges(
     std::set<CheckedRange<uint64_t>>* ranges) const {
-  if (!crashpad_info_ || !crashpad_info_->ExtraMemoryRanges())
-    return;
-
-  std::vector<SimpleAddressRangeBag::Entry> simple_ranges(
-      SimpleAddressRangeBag::num_entries);
-  if (!process_reader_->Memory()->Read(
-          crashpad_info_->ExtraMemoryRanges(),
-          simple_ranges.size() * sizeof(simple_ranges[0]),
-          &simple_ranges[0])) {
-    LOG(WARNING) << "could not read simple address_ranges from "
-                 << base::WideToUTF8(name_);
+  if (!crashpad_info_)
     return;
-  }
 
-  for (const auto& entry : simple_ranges) {
-    if (entry.base != 0 || entry.size != 0) {
-      // Deduplication here is fine.
-      ranges->insert(CheckedRange<uint64_t>(entry.base, entry.size));
-    }
-  }
+  crashpad_info_->ReadExtraMemoryRanges(
+      process_reader_->Memory(), base::WideToUTF8(name_), ranges);
 }
 
 template <class Traits>
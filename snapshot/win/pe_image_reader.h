@@ -48,6 +48,10 @@ struct CrashpadInfo {
   typename Traits::Pointer simple_annotations;
   typename Traits::Pointer user_data_minidump_stream_head;
   typename Traits::Pointer annotations_list;
+  typename Traits::Pointer annotation_arena;
+  typename Traits::Pointer extra_memory_range_table;
+  uint32_t extra_memory_range_table_size;
+  uint32_t padding_2;
 };
 
 }  // namespace process_types
@@ -17,6 +17,7 @@
 #include <string.h>
 #include <winternl.h>
 
+#include <atomic>
 #include <memory>
 
 #include "base/check_op.h"
@@ -131,9 +132,35 @@ HANDLE OpenThread(
   return handle;
 }
 
+// Retrieves the current suspend count of a thread without suspending it. This
+// requires Windows 8.1 or later. Returns false, without logging, when the
+// information isn't available.
+bool QueryThreadSuspendCount(HANDLE thread_handle, ULONG* suspend_count) {
+  // Remember when the query isn't supported so that it's only attempted once
+  // on older systems, instead of once per thread.
+  static std::atomic<bool> unsupported(false);
+  if (unsupported.load(std::memory_order_relaxed))
+    return false;
+
+  NTSTATUS status = crashpad::NtQueryInformationThread(
+      thread_handle,
+      static_cast<THREADINFOCLASS>(ThreadSuspendCount),
+      suspend_count,
+      sizeof(*suspend_count),
+      nullptr);
+  if (status == STATUS_INVALID_INFO_CLASS) {
+    unsupported.store(true, std::memory_order_relaxed);
+    return false;
+  }
+  return NT_SUCCESS(status);
+}
+
 // It's necessary to suspend the thread to grab CONTEXT. SuspendThread has a
 // side-effect of returning the SuspendCount of the thread on success, so we
-// fill out these two pieces of semi-unrelated data in the same function.
+// fill out these two pieces of semi-unrelated data in the same function. When
+// the whole process has already been suspended, the thread is not suspended
+// again, and its suspend count is queried directly where possible, avoiding a
+// pair of system calls per thread.
 template <class Traits>
 bool FillThreadContextAndSuspendCount(HANDLE thread_handle,
                                       ProcessReaderWin::Thread* thread,
@@ -151,10 +178,19 @@ bool FillThreadContextAndSuspendCount(HANDLE thread_handle,
     DCHECK(!is_64_reading_32);
     thread->context.InitializeFromCurrentThread();
   } else {
-    DWORD previous_suspend_count = SuspendThread(thread_handle);
-    if (previous_suspend_count == static_cast<DWORD>(-1)) {
-      PLOG(ERROR) << "SuspendThread";
-      return false;
+    ULONG current_suspend_count;
+    const bool suspended_here =
+        suspension_state != ProcessSuspensionState::kSuspended ||
+        !QueryThreadSuspendCount(thread_handle, &current_suspend_count);
+    DWORD previous_suspend_count;
+    if (suspended_here) {
+      previous_suspend_count = SuspendThread(thread_handle);
+      if (previous_suspend_count == static_cast<DWORD>(-1)) {
+        PLOG(ERROR) << "SuspendThread";
+        return false;
+      }
+    } else {
+      previous_suspend_count = current_suspend_count;
     }
     if (previous_suspend_count <= 0 &&
         suspension_state == ProcessSuspensionState::kSuspended) {
@@ -188,7 +224,7 @@ bool FillThreadContextAndSuspendCount(HANDLE thread_handle,
     }
 #endif  // ARCH_CPU_64_BITS
 
-    if (!ResumeThread(thread_handle)) {
+    if (suspended_here && !ResumeThread(thread_handle)) {
       PLOG(ERROR) << "ResumeThread";
       return false;
     }
@@ -302,14 +338,15 @@ ProcessReaderWin::~ProcessReaderWin() {
 }
 
 bool ProcessReaderWin::Initialize(HANDLE process,
-                                  ProcessSuspensionState suspension_state) {
+                                  ProcessSuspensionState suspension_state,
+                                  HANDLE memory_process) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   process_ = process;
   suspension_state_ = suspension_state;
   if (!process_info_.Initialize(process))
     return false;
-  if (!process_memory_.Initialize(process))
+  if (!process_memory_.Initialize(memory_process ? memory_process : process))
     return false;
 
   INITIALIZATION_STATE_SET_VALID(initialized_);
@@ -25,6 +25,7 @@
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory_win.h"
 #include "util/win/address_types.h"
+#include "util/win/module_list_cache_win.h"
 #include "util/win/process_info.h"
 
 namespace crashpad {
@@ -96,6 +97,18 @@ class ProcessReaderWin {
 
   ~ProcessReaderWin();
 
+  //! \brief Sets a cache of module lists shared across readers of the same
+  //!     process.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessInfo::SetModuleListCache().
+  //!
+  //! \param[in] cache The cache to use, which must outlive this object, or
+  //!     `nullptr` to always read the loader's module list from scratch.
+  void SetModuleListCache(ModuleListCacheWin* cache) {
+    process_info_.SetModuleListCache(cache);
+  }
+
   //! \brief Initializes this object. This method must be called before any
   //!     other.
   //!
@@ -105,13 +118,21 @@ class ProcessReaderWin {
   //!     by the caller. Typically, this will be
   //!     ProcessSuspensionState::kSuspended, except for testing uses and where
   //!     the reader is reading itself.
+  //! \param[in] memory_process If not `nullptr`, a handle with
+  //!     `PROCESS_QUERY_INFORMATION` and `PROCESS_VM_READ` access to read
+  //!     \a process’ memory from through Memory(), such as a virtual address
+  //!     clone of \a process. Threads and other process information are still
+  //!     read from \a process.
   //!
   //! \return `true` on success, indicating that this object will respond
   //!     validly to further method calls. `false` on failure. On failure, no
   //!     further method calls should be made.
   //!
   //! \sa ScopedProcessSuspend
-  bool Initialize(HANDLE process, ProcessSuspensionState suspension_state);
+  //! \sa ScopedProcessVaClone
+  bool Initialize(HANDLE process,
+                  ProcessSuspensionState suspension_state,
+                  HANDLE memory_process = nullptr);
 
   //! \return `true` if the target task is a 64-bit process.
   bool Is64Bit() const { return process_info_.Is64Bit(); }
@@ -147,6 +168,13 @@ class ProcessReaderWin {
   //! \return A ProcessInfo object for the process being read.
   const ProcessInfo& GetProcessInfo() const;
 
+  //! \brief Limits the number of handles examined for the process being read.
+  //!
+  //! \sa ProcessInfo::SetMaxHandles()
+  void SetMaxHandles(size_t max_handles) {
+    process_info_.SetMaxHandles(max_handles);
+  }
+
   //! \brief Decrements the thread suspend counts for all thread ids other than
   //!     \a except_thread_id.
   //!
@@ -46,6 +46,8 @@ ProcessSnapshotWin::ProcessSnapshotWin()
       annotations_simple_map_(),
       snapshot_time_(),
       options_(),
+      minimal_capture_exception_codes_(),
+      minimal_capture_(false),
       initialized_() {}
 
 ProcessSnapshotWin::~ProcessSnapshotWin() {
@@ -55,27 +57,19 @@ bool ProcessSnapshotWin::Initialize(
     HANDLE process,
     ProcessSuspensionState suspension_state,
     WinVMAddress exception_information_address,
-    WinVMAddress debug_critical_section_address) {
+    WinVMAddress debug_critical_section_address,
+    HANDLE memory_process) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
 
   GetTimeOfDay(&snapshot_time_);
 
-  if (!process_reader_.Initialize(process, suspension_state))
+  if (!process_reader_.Initialize(process, suspension_state, memory_process))
     return false;
 
   client_id_.InitializeToZero();
   system_.Initialize(&process_reader_);
 
-  if (process_reader_.Is64Bit()) {
-    InitializePebData<process_types::internal::Traits64>(
-        debug_critical_section_address);
-  } else {
-    InitializePebData<process_types::internal::Traits32>(
-        debug_critical_section_address);
-  }
-
   InitializeModules();
-  InitializeUnloadedModules();
 
   GetCrashpadOptionsInternal(&options_);
   uint32_t* budget_remaining_pointer =
@@ -100,9 +94,32 @@ bool ProcessSnapshotWin::Initialize(
       exception_.reset();
       return false;
     }
+
+    minimal_capture_ = minimal_capture_exception_codes_.count(
+                           exception_->Exception()) != 0;
+  }
+
+  // A minimal capture keeps the exception thread, the modules, and the memory
+  // that the exception’s context refers to, which have all been captured by
+  // now, and skips everything that grows with the size of the process.
+  if (minimal_capture_) {
+    const uint64_t exception_thread_id = exception_->ThreadID();
+    InitializeThreads(nullptr, &exception_thread_id);
+    INITIALIZATION_STATE_SET_VALID(initialized_);
+    return true;
   }
 
-  InitializeThreads(budget_remaining_pointer);
+  if (process_reader_.Is64Bit()) {
+    InitializePebData<process_types::internal::Traits64>(
+        debug_critical_section_address);
+  } else {
+    InitializePebData<process_types::internal::Traits32>(
+        debug_critical_section_address);
+  }
+
+  InitializeUnloadedModules();
+
+  InitializeThreads(budget_remaining_pointer, nullptr);
 
   for (const MEMORY_BASIC_INFORMATION64& mbi :
        process_reader_.GetProcessInfo().MemoryInfo()) {
@@ -212,6 +229,9 @@ std::vector<const MemoryMapRegionSnapshot*> ProcessSnapshotWin::MemoryMap()
 
 std::vector<HandleSnapshot> ProcessSnapshotWin::Handles() const {
   std::vector<HandleSnapshot> result;
+  if (minimal_capture_) {
+    return result;
+  }
   for (const auto& handle : process_reader_.GetProcessInfo().Handles()) {
     HandleSnapshot snapshot;
     // This is probably not strictly correct, but these are not localized so we
@@ -242,11 +262,16 @@ const ProcessMemory* ProcessSnapshotWin::Memory() const {
   return process_reader_.Memory();
 }
 
-void ProcessSnapshotWin::InitializeThreads(uint32_t* budget_remaining_pointer) {
+void ProcessSnapshotWin::InitializeThreads(uint32_t* budget_remaining_pointer,
+                                           const uint64_t* only_thread_id) {
   const std::vector<ProcessReaderWin::Thread>& process_reader_threads =
       process_reader_.Threads();
   for (const ProcessReaderWin::Thread& process_reader_thread :
        process_reader_threads) {
+    if (only_thread_id && process_reader_thread.id != *only_thread_id) {
+      continue;
+    }
+
     auto thread = std::make_unique<internal::ThreadSnapshotWin>();
     if (thread->Initialize(&process_reader_,
                            process_reader_thread,
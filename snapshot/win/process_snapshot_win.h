@@ -22,6 +22,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -72,15 +73,30 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
   //!     process's address space of a `CRITICAL_SECTION` allocated with valid
   //!     `.DebugInfo`. Used as a starting point to walk the process's locks.
   //!     May be `0`.
+  //! \param[in] memory_process If not `nullptr`, a virtual address clone of
+  //!     \a process to read memory from, so that \a process can be resumed
+  //!     once this method returns while memory is still read from the clone
+  //!     as the snapshot is used.
   //!
   //! \return `true` if the snapshot could be created, `false` otherwise with
   //!     an appropriate message logged.
   //!
   //! \sa ScopedProcessSuspend
+  //! \sa ScopedProcessVaClone
   bool Initialize(HANDLE process,
                   ProcessSuspensionState suspension_state,
                   WinVMAddress exception_information_address,
-                  WinVMAddress debug_critical_section_address);
+                  WinVMAddress debug_critical_section_address,
+                  HANDLE memory_process = nullptr);
+
+  //! \brief Sets a cache of module lists shared across snapshots of the same
+  //!     process.
+  //!
+  //! This must be called before Initialize() to have any effect. See
+  //! ProcessReaderWin::SetModuleListCache().
+  void SetModuleListCache(ModuleListCacheWin* cache) {
+    process_reader_.SetModuleListCache(cache);
+  }
 
   //! \brief Sets the value to be returned by ReportID().
   //!
@@ -107,6 +123,35 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
     annotations_simple_map_ = annotations_simple_map;
   }
 
+  //! \brief Limits the number of handles returned by Handles().
+  //!
+  //! When the process has more than \a max_handles handles, an evenly spaced
+  //! sample of them is returned. A value of `0` returns no handles. This must
+  //! be called before Handles() to have any effect.
+  void SetMaxHandles(size_t max_handles) {
+    process_reader_.SetMaxHandles(max_handles);
+  }
+
+  //! \brief Sets the exception codes for which a minimal snapshot is taken.
+  //!
+  //! When the code of the exception being captured is in \a exception_codes,
+  //! Initialize() captures only the exception thread, the modules, and the
+  //! memory referenced by the exception’s context. Memory reachable from the
+  //! PEB, unloaded modules, the other threads, the memory map, handles, and
+  //! memory ranges registered by modules are left out. This keeps the capture
+  //! short for crashes whose report must be written within a deadline, such as
+  //! fail-fast and heap corruption exceptions forwarded by Windows Error
+  //! Reporting. This must be called before Initialize() to have any effect.
+  void SetMinimalCaptureExceptionCodes(
+      const std::set<uint32_t>& exception_codes) {
+    minimal_capture_exception_codes_ = exception_codes;
+  }
+
+  //! \brief Whether Initialize() took a minimal snapshot.
+  //!
+  //! \sa SetMinimalCaptureExceptionCodes()
+  bool IsMinimalCapture() const { return minimal_capture_; }
+
   //! \brief Returns options from CrashpadInfo structures found in modules in
   //!     the process.
   //!
@@ -136,8 +181,10 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
   const ProcessMemory* Memory() const override;
 
  private:
-  // Initializes threads_ on behalf of Initialize().
-  void InitializeThreads(uint32_t* indirectly_referenced_memory_cap);
+  // Initializes threads_ on behalf of Initialize(). If only_thread_id is set,
+  // only that thread is captured.
+  void InitializeThreads(uint32_t* indirectly_referenced_memory_cap,
+                         const uint64_t* only_thread_id);
 
   // Initializes modules_ on behalf of Initialize().
   void InitializeModules();
@@ -193,6 +240,8 @@ class ProcessSnapshotWin final : public ProcessSnapshot {
   std::map<std::string, std::string> annotations_simple_map_;
   timeval snapshot_time_;
   CrashpadInfoClientOptions options_;
+  std::set<uint32_t> minimal_capture_exception_codes_;
+  bool minimal_capture_;
   InitializationStateDcheck initialized_;
 };
 
@@ -196,5 +196,15 @@ std::vector<const MemorySnapshot*> ThreadSnapshotWin::ExtraMemory() const {
   return result;
 }
 
+const ExtendedRegisterState* ThreadSnapshotWin::ExtendedRegisters() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
+const ThreadSchedulingStats* ThreadSnapshotWin::SchedulingStats() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return nullptr;
+}
+
 }  // namespace internal
 }  // namespace crashpad
@@ -0,0 +1,531 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dlfcn.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_file.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "client/annotation.h"
+#include "client/annotation_list.h"
+#include "client/crashpad_info.h"
+#include "minidump/minidump_file_writer.h"
+#include "snapshot/linux/process_snapshot_linux.h"
+#include "snapshot/sanitized/process_snapshot_sanitized.h"
+#include "tools/tool_support.h"
+#include "util/file/chunked_memory_file.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/ptrace_connection_trace.h"
+#include "util/linux/recording_ptrace_connection.h"
+#include "util/linux/replay_ptrace_connection.h"
+#include "util/misc/capture_timings.h"
+#include "util/misc/clock.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace {
+
+// The indirectly referenced memory cap used with --indirect-memory.
+constexpr uint32_t kIndirectMemoryCap = 1024 * 1024;
+
+// The names that phases are reported with, indexed by CapturePhase.
+constexpr const char* kPhaseNames[] = {
+    "threads",
+    "modules",
+    "memory_maps",
+    "annotations",
+    "indirect_memory",
+    "sanitization",
+    "write",
+    "database",
+};
+static_assert(std::size(kPhaseNames) ==
+                  static_cast<size_t>(CapturePhase::kMaxValue),
+              "kPhaseNames must name every CapturePhase");
+
+struct Options {
+  std::vector<std::string> load_modules;
+  std::string record_trace;
+  std::string replay_trace;
+  size_t annotations;
+  size_t concurrency;
+  size_t iterations;
+  size_t mappings;
+  size_t threads;
+  pid_t pid;
+  bool indirect_memory;
+  bool module_identities_only;
+  bool sanitize;
+};
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the cost of capturing a synthetic target process, an existing\n"
+"process, or a recorded trace of a capture.\n"
+"\n"
+"      --annotations=COUNT   register COUNT annotations in the target\n"
+"      --concurrency=COUNT   snapshot threads and modules on COUNT threads\n"
+"      --indirect-memory     gather indirectly referenced memory\n"
+"      --iterations=COUNT    capture the target COUNT times, default 10\n"
+"      --load-module=PATH    load the shared library at PATH in the target\n"
+"      --mappings=COUNT      create COUNT additional mappings in the target\n"
+"      --module-identities-only\n"
+"                            read only the identity of each module\n"
+"      --pid=PID             capture the existing process PID\n"
+"      --record-trace=PATH   record the first capture to PATH\n"
+"      --replay-trace=PATH   capture the recorded trace at PATH\n"
+"      --sanitize            sanitize the snapshot before writing it\n"
+"      --threads=COUNT       start COUNT additional threads in the target\n"
+"      --help                display this help and exit\n"
+"      --version             output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+// A thread in the target process that waits until the benchmark is done.
+class IdleThread : public Thread {
+ public:
+  explicit IdleThread(int release_fd) : release_fd_(release_fd) {}
+
+  IdleThread(const IdleThread&) = delete;
+  IdleThread& operator=(const IdleThread&) = delete;
+
+  ~IdleThread() override {}
+
+ private:
+  // Thread:
+  void ThreadMain() override {
+    char c;
+    HANDLE_EINTR(read(release_fd_, &c, sizeof(c)));
+  }
+
+  int release_fd_;
+};
+
+// Runs in the forked target process. Sets up the state described by options,
+// signals readiness on ready_fd, and exits once release_fd reaches end-of-file.
+// Nothing allocated here is freed, because it must remain in place for as long
+// as the target is captured.
+[[noreturn]] void RunTarget(const Options& options,
+                            int ready_fd,
+                            int release_fd) {
+  for (const std::string& path : options.load_modules) {
+    if (!dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)) {
+      LOG(ERROR) << "dlopen " << path << ": " << dlerror();
+      _exit(EXIT_FAILURE);
+    }
+  }
+
+  const size_t page_size = getpagesize();
+  for (size_t index = 0; index < options.mappings; ++index) {
+    // Alternate protections so that adjacent mappings aren’t merged.
+    const int prot = index % 2 ? PROT_READ : PROT_READ | PROT_WRITE;
+    if (mmap(nullptr,
+             page_size,
+             prot,
+             MAP_PRIVATE | MAP_ANONYMOUS,
+             -1,
+             0) == MAP_FAILED) {
+      PLOG(ERROR) << "mmap";
+      _exit(EXIT_FAILURE);
+    }
+  }
+
+  AnnotationList::Register();
+  auto* names = new std::deque<std::string>();
+  for (size_t index = 0; index < options.annotations; ++index) {
+    names->push_back(base::StringPrintf("benchmark-%zu", index));
+    auto* annotation = new StringAnnotation<32>(names->back().c_str());
+    annotation->Set(base::StringPrintf("value-%zu", index).c_str());
+  }
+
+  if (options.indirect_memory) {
+    CrashpadInfo::GetCrashpadInfo()->set_gather_indirectly_referenced_memory(
+        TriState::kEnabled, kIndirectMemoryCap);
+  }
+
+  for (size_t index = 0; index < options.threads; ++index) {
+    (new IdleThread(release_fd))->Start();
+  }
+
+  // The benchmark is the target’s parent, which Yama permits to attach in its
+  // default mode, but not when ptrace_scope is stricter.
+  prctl(PR_SET_PTRACER, getppid(), 0, 0, 0);
+
+  const char ready = 0;
+  if (!LoggingWriteFile(ready_fd, &ready, sizeof(ready))) {
+    _exit(EXIT_FAILURE);
+  }
+
+  char c;
+  HANDLE_EINTR(read(release_fd, &c, sizeof(c)));
+  _exit(EXIT_SUCCESS);
+}
+
+void PrintPhase(size_t iteration,
+                const char* phase,
+                uint64_t duration_ns,
+                uint64_t bytes_read) {
+  printf("%zu,%s,%" PRIu64 ",%" PRIu64 "\n",
+         iteration,
+         phase,
+         duration_ns,
+         bytes_read);
+}
+
+// Captures through connection and writes a minidump to memory, printing the
+// cost of each phase. The capture started at start_ns, and connection was
+// ready at attached_ns.
+bool Capture(PtraceConnection* connection,
+             const Options& options,
+             size_t iteration,
+             uint64_t start_ns,
+             uint64_t attached_ns) {
+  ProcessSnapshotLinux process_snapshot;
+  process_snapshot.SetThreadInitializationConcurrency(options.concurrency);
+  process_snapshot.SetModuleInitializationConcurrency(options.concurrency);
+  process_snapshot.SetModuleIdentitiesOnly(options.module_identities_only);
+  if (!process_snapshot.Initialize(connection)) {
+    return false;
+  }
+
+  ProcessSnapshot* snapshot = &process_snapshot;
+  ProcessSnapshotSanitized sanitized_snapshot;
+  if (options.sanitize) {
+    // The thread writing the minidump counts toward --concurrency.
+    if (options.concurrency > 1 &&
+        connection->Memory()->SupportsConcurrentReads()) {
+      sanitized_snapshot.SetSanitizationPipelining(options.concurrency - 1,
+                                                   8 * 1024 * 1024);
+    }
+    ScopedCapturePhase capture_phase(process_snapshot.Timings(),
+                                     CapturePhase::kSanitization,
+                                     connection->Memory());
+    // Allowing no annotations and sanitizing stacks does the most work.
+    if (!sanitized_snapshot.Initialize(
+            &process_snapshot,
+            std::make_unique<std::vector<std::string>>(),
+            nullptr,
+            0,
+            true)) {
+      return false;
+    }
+    snapshot = &sanitized_snapshot;
+  }
+
+  ChunkedMemoryFile minidump_file;
+  {
+    ScopedCapturePhase capture_phase(process_snapshot.Timings(),
+                                     CapturePhase::kWrite,
+                                     process_snapshot.Memory());
+    MinidumpFileWriter minidump;
+    minidump.InitializeFromSnapshot(snapshot);
+    if (!minidump.WriteEverything(&minidump_file)) {
+      return false;
+    }
+  }
+  const uint64_t end_ns = ClockMonotonicNanoseconds();
+
+  PrintPhase(iteration, "attach", attached_ns - start_ns, 0);
+  const CaptureTimings& timings = *process_snapshot.Timings();
+  uint64_t bytes_read = 0;
+  for (size_t index = 0; index < std::size(kPhaseNames); ++index) {
+    const CaptureTimings::Phase& phase =
+        timings.Get(static_cast<CapturePhase>(index));
+    PrintPhase(
+        iteration, kPhaseNames[index], phase.duration_ns, phase.bytes_read);
+    bytes_read += phase.bytes_read;
+  }
+  PrintPhase(iteration, "total", end_ns - start_ns, bytes_read);
+  PrintPhase(iteration, "minidump_size", 0, minidump_file.size());
+  return true;
+}
+
+// Captures the process pid. If options.record_trace is set, the first
+// iteration is recorded to it.
+bool CaptureProcess(pid_t pid, const Options& options, size_t iteration) {
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+
+  DirectPtraceConnection connection;
+  if (!connection.Initialize(pid)) {
+    return false;
+  }
+  const uint64_t attached_ns = ClockMonotonicNanoseconds();
+
+  if (iteration != 0 || options.record_trace.empty()) {
+    return Capture(&connection, options, iteration, start_ns, attached_ns);
+  }
+
+  RecordingPtraceConnection recording(&connection);
+  if (!Capture(&recording, options, iteration, start_ns, attached_ns)) {
+    return false;
+  }
+  FileWriter writer;
+  const base::FilePath path(options.record_trace);
+  return writer.Open(path,
+                     FileWriteMode::kTruncateOrCreate,
+                     FilePermissions::kOwnerOnly) &&
+         recording.trace().Write(&writer);
+}
+
+// Captures the recorded trace.
+bool CaptureTrace(const PtraceConnectionTrace& trace,
+                  const Options& options,
+                  size_t iteration) {
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  ReplayPtraceConnection connection;
+  connection.Initialize(&trace);
+  const uint64_t attached_ns = ClockMonotonicNanoseconds();
+  return Capture(&connection, options, iteration, start_ns, attached_ns);
+}
+
+// Captures the process pid, or the recorded trace if options.replay_trace is
+// set, options.iterations times.
+bool CaptureIterations(pid_t pid, const Options& options) {
+  PtraceConnectionTrace trace;
+  if (!options.replay_trace.empty()) {
+    FileReader reader;
+    if (!reader.Open(base::FilePath(options.replay_trace)) ||
+        !trace.Read(&reader)) {
+      return false;
+    }
+  }
+
+  printf("iteration,phase,duration_ns,bytes\n");
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    if (!(options.replay_trace.empty()
+              ? CaptureProcess(pid, options, iteration)
+              : CaptureTrace(trace, options, iteration))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int CaptureBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionAnnotations,
+    kOptionConcurrency,
+    kOptionIndirectMemory,
+    kOptionIterations,
+    kOptionLoadModule,
+    kOptionMappings,
+    kOptionModuleIdentitiesOnly,
+    kOptionPID,
+    kOptionRecordTrace,
+    kOptionReplayTrace,
+    kOptionSanitize,
+    kOptionThreads,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  Options options = {};
+  options.concurrency = 1;
+  options.iterations = 10;
+
+  static constexpr option long_options[] = {
+      {"annotations", required_argument, nullptr, kOptionAnnotations},
+      {"concurrency", required_argument, nullptr, kOptionConcurrency},
+      {"indirect-memory", no_argument, nullptr, kOptionIndirectMemory},
+      {"iterations", required_argument, nullptr, kOptionIterations},
+      {"load-module", required_argument, nullptr, kOptionLoadModule},
+      {"mappings", required_argument, nullptr, kOptionMappings},
+      {"module-identities-only",
+       no_argument,
+       nullptr,
+       kOptionModuleIdentitiesOnly},
+      {"pid", required_argument, nullptr, kOptionPID},
+      {"record-trace", required_argument, nullptr, kOptionRecordTrace},
+      {"replay-trace", required_argument, nullptr, kOptionReplayTrace},
+      {"sanitize", no_argument, nullptr, kOptionSanitize},
+      {"threads", required_argument, nullptr, kOptionThreads},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionAnnotations:
+        if (!StringToNumber(optarg, &options.annotations)) {
+          ToolSupport::UsageHint(me, "--annotations requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionConcurrency:
+        if (!StringToNumber(optarg, &options.concurrency) ||
+            options.concurrency == 0) {
+          ToolSupport::UsageHint(me, "--concurrency requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionIndirectMemory:
+        options.indirect_memory = true;
+        break;
+      case kOptionIterations:
+        if (!StringToNumber(optarg, &options.iterations) ||
+            options.iterations == 0) {
+          ToolSupport::UsageHint(me, "--iterations requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionLoadModule:
+        options.load_modules.push_back(optarg);
+        break;
+      case kOptionMappings:
+        if (!StringToNumber(optarg, &options.mappings)) {
+          ToolSupport::UsageHint(me, "--mappings requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionModuleIdentitiesOnly:
+        options.module_identities_only = true;
+        break;
+      case kOptionPID:
+        if (!StringToNumber(optarg, &options.pid) || options.pid <= 0) {
+          ToolSupport::UsageHint(me, "--pid requires a PID");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionRecordTrace:
+        options.record_trace = optarg;
+        break;
+      case kOptionReplayTrace:
+        options.replay_trace = optarg;
+        break;
+      case kOptionSanitize:
+        options.sanitize = true;
+        break;
+      case kOptionThreads:
+        if (!StringToNumber(optarg, &options.threads)) {
+          ToolSupport::UsageHint(me, "--threads requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      case kOptionVersion:
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      default:
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  if (!options.replay_trace.empty() &&
+      (options.pid || !options.record_trace.empty())) {
+    ToolSupport::UsageHint(
+        me, "--replay-trace is incompatible with --pid and --record-trace");
+    return EXIT_FAILURE;
+  }
+
+  // Nothing needs to be started to capture an existing process or a trace.
+  if (options.pid || !options.replay_trace.empty()) {
+    return CaptureIterations(options.pid, options) ? EXIT_SUCCESS
+                                                   : EXIT_FAILURE;
+  }
+
+  int ready_pipe[2];
+  int release_pipe[2];
+  if (pipe(ready_pipe) != 0 || pipe(release_pipe) != 0) {
+    PLOG(ERROR) << "pipe";
+    return EXIT_FAILURE;
+  }
+  base::ScopedFD ready_read(ready_pipe[0]);
+  base::ScopedFD ready_write(ready_pipe[1]);
+  base::ScopedFD release_read(release_pipe[0]);
+  base::ScopedFD release_write(release_pipe[1]);
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(ERROR) << "fork";
+    return EXIT_FAILURE;
+  }
+  if (pid == 0) {
+    ready_read.reset();
+    release_write.reset();
+    RunTarget(options, ready_write.get(), release_read.get());
+  }
+  ready_write.reset();
+  release_read.reset();
+
+  bool success = true;
+  char ready;
+  if (!LoggingReadFileExactly(ready_read.get(), &ready, sizeof(ready))) {
+    LOG(ERROR) << "target failed to start";
+    success = false;
+  } else {
+    success = CaptureIterations(pid, options);
+  }
+
+  release_write.reset();
+  int status;
+  if (HANDLE_EINTR(waitpid(pid, &status, 0)) != pid) {
+    PLOG(ERROR) << "waitpid";
+    return EXIT_FAILURE;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::CaptureBenchmarkMain(argc, argv);
+}
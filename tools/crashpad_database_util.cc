@@ -14,6 +14,7 @@
 
 #include <errno.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,6 +31,7 @@
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "client/crash_report_database.h"
@@ -63,6 +65,18 @@ void Usage(const base::FilePath& me) {
 "      --set-last-upload-attempt-time=TIME\n"
 "                                  set the last-upload-attempt time to TIME\n"
 "      --new-report=PATH           submit a new report at PATH, or - for stdin\n"
+"      --select=STATE              select pending, completed, or all reports\n"
+"      --created-after=TIME        with --select, only reports created at or\n"
+"                                  after TIME\n"
+"      --created-before=TIME       with --select, only reports created before\n"
+"                                  TIME\n"
+"      --min-size=BYTES            with --select, only reports of at least\n"
+"                                  BYTES\n"
+"      --max-size=BYTES            with --select, only reports of at most\n"
+"                                  BYTES\n"
+"      --request-upload-selected   request upload of each selected report\n"
+"      --delete-selected           delete each selected report\n"
+"      --json                      show selected reports as JSON\n"
 "      --utc                       show and set UTC times instead of local\n"
 "      --help                      display this help and exit\n"
 "      --version                   output version information and exit\n",
@@ -71,12 +85,35 @@ void Usage(const base::FilePath& me) {
   ToolSupport::UsageTail(me);
 }
 
+// The set of reports chosen by --select.
+enum class Selection {
+  kNone = 0,
+  kPending,
+  kCompleted,
+  kAll,
+};
+
+// The operation applied to each report chosen by --select.
+enum class SelectionAction {
+  kNone = 0,
+  kRequestUpload,
+  kDelete,
+};
+
 struct Options {
   std::vector<UUID> show_reports;
   std::vector<base::FilePath> new_report_paths;
   const char* database;
   const char* set_last_upload_attempt_time_string;
+  const char* created_after_string;
+  const char* created_before_string;
   time_t set_last_upload_attempt_time;
+  time_t created_after;
+  time_t created_before;
+  uint64_t min_size;
+  uint64_t max_size;
+  Selection selection;
+  SelectionAction selection_action;
   bool create;
   bool show_client_id;
   bool show_uploads_enabled;
@@ -86,9 +123,19 @@ struct Options {
   bool show_all_report_info;
   bool set_uploads_enabled;
   bool has_set_uploads_enabled;
+  bool has_max_size;
+  bool json;
   bool utc;
 };
 
+// A report chosen by --select, along with the result of applying
+// Options::selection_action to it.
+struct SelectedReport {
+  CrashReportDatabase::Report report;
+  CrashReportDatabase::OperationStatus action_status;
+  bool pending;
+};
+
 // Converts |string| to |boolean|, returning true if a conversion could be
 // performed, and false without setting |boolean| if no conversion could be
 // performed. Various string representations of a boolean are recognized
@@ -222,10 +269,11 @@ std::string TimeToString(time_t out_time, bool utc) {
   return std::string(string);
 }
 
-// Shows information about a single |report|. |space_count| is the number of
-// spaces to print before each line that is printed. |utc| determines whether
-// times should be shown in UTC or the local time zone.
-void ShowReport(const CrashReportDatabase::Report& report,
+// Shows information about a single |report| in |database|. |space_count| is the
+// number of spaces to print before each line that is printed. |utc| determines
+// whether times should be shown in UTC or the local time zone.
+void ShowReport(CrashReportDatabase* database,
+                const CrashReportDatabase::Report& report,
                 size_t space_count,
                 bool utc) {
   std::string spaces(space_count, ' ');
@@ -246,14 +294,35 @@ void ShowReport(const CrashReportDatabase::Report& report,
          spaces.c_str(),
          TimeToString(report.last_upload_attempt_time, utc).c_str());
   printf("%sUpload attempts: %d\n", spaces.c_str(), report.upload_attempts);
+
+  // The summary is read instead of the minidump, so that listing many reports
+  // stays cheap.
+  CrashReportDatabase::ReportSummary summary;
+  if (database->GetReportSummary(report.uuid, &summary)) {
+    printf("%sProcess: %s\n", spaces.c_str(), summary.process_name.c_str());
+    printf("%sException code: 0x%" PRIx32 "\n",
+           spaces.c_str(),
+           summary.exception_code);
+    if (!summary.crashing_module.empty()) {
+      printf("%sCrashing module: %s+0x%" PRIx64 "\n",
+             spaces.c_str(),
+             summary.crashing_module.c_str(),
+             summary.crashing_module_offset);
+    }
+    printf("%sThreads: %" PRIu32 "\n", spaces.c_str(), summary.thread_count);
+    printf("%sReport size: %" PRIu64 "\n",
+           spaces.c_str(),
+           summary.report_size);
+  }
 }
 
-// Shows information about a vector of |reports|. |space_count| is the number of
-// spaces to print before each line that is printed. |options| will be consulted
-// to determine whether to show expanded information
+// Shows information about a vector of |reports| in |database|. |space_count| is
+// the number of spaces to print before each line that is printed. |options|
+// will be consulted to determine whether to show expanded information
 // (options.show_all_report_info) and what time zone to use when showing
 // expanded information (options.utc).
-void ShowReports(const std::vector<CrashReportDatabase::Report>& reports,
+void ShowReports(CrashReportDatabase* database,
+                 const std::vector<CrashReportDatabase::Report>& reports,
                  size_t space_count,
                  const Options& options) {
   std::string spaces(space_count, ' ');
@@ -262,9 +331,204 @@ void ShowReports(const std::vector<CrashReportDatabase::Report>& reports,
   for (const CrashReportDatabase::Report& report : reports) {
     printf("%s%s%s\n", spaces.c_str(), report.uuid.ToString().c_str(), colon);
     if (options.show_all_report_info) {
-      ShowReport(report, space_count + 2, options.utc);
+      ShowReport(database, report, space_count + 2, options.utc);
+    }
+  }
+}
+
+// Converts |status| to a short string suitable for machine consumption.
+const char* OperationStatusToString(
+    CrashReportDatabase::OperationStatus status) {
+  switch (status) {
+    case CrashReportDatabase::kNoError:
+      return "ok";
+    case CrashReportDatabase::kReportNotFound:
+      return "not found";
+    case CrashReportDatabase::kFileSystemError:
+      return "file system error";
+    case CrashReportDatabase::kDatabaseError:
+      return "database error";
+    case CrashReportDatabase::kBusyError:
+      return "busy";
+    case CrashReportDatabase::kCannotRequestUpload:
+      return "cannot request upload";
+  }
+  return "unknown error";
+}
+
+// Returns true if |report| passes each of the --select filters in |options|.
+bool ReportMatchesSelection(const CrashReportDatabase::Report& report,
+                            const Options& options) {
+  if (options.created_after_string &&
+      report.creation_time < options.created_after) {
+    return false;
+  }
+  if (options.created_before_string &&
+      report.creation_time >= options.created_before) {
+    return false;
+  }
+  if (report.total_size < options.min_size) {
+    return false;
+  }
+  if (options.has_max_size && report.total_size > options.max_size) {
+    return false;
+  }
+  return true;
+}
+
+// Collects the reports in |database| chosen by options.selection and its
+// filters into |selected|. Each of the pending and completed report sets is
+// scanned at most once, and no further per-report lookups are made, so this is
+// the cheapest way to inspect many reports. Returns false if either scan fails.
+bool SelectReports(CrashReportDatabase* database,
+                   const Options& options,
+                   std::vector<SelectedReport>* selected) {
+  selected->clear();
+
+  const auto add_reports =
+      [&options, selected](std::vector<CrashReportDatabase::Report>* reports,
+                           bool pending) {
+        for (CrashReportDatabase::Report& report : *reports) {
+          if (ReportMatchesSelection(report, options)) {
+            selected->push_back(
+                {std::move(report), CrashReportDatabase::kNoError, pending});
+          }
+        }
+      };
+
+  std::vector<CrashReportDatabase::Report> reports;
+  if (options.selection == Selection::kPending ||
+      options.selection == Selection::kAll) {
+    if (database->GetPendingReports(&reports) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+    add_reports(&reports, true);
+  }
+
+  if (options.selection == Selection::kCompleted ||
+      options.selection == Selection::kAll) {
+    reports.clear();
+    if (database->GetCompletedReports(&reports) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+    add_reports(&reports, false);
+  }
+
+  return true;
+}
+
+// Appends |value| to |json| as a JSON string. Bytes that aren’t ASCII are
+// copied as-is, so |value| should be UTF-8 for the result to be valid JSON.
+void AppendJSONString(const std::string& value, std::string* json) {
+  json->push_back('"');
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        json->append("\\\"");
+        break;
+      case '\\':
+        json->append("\\\\");
+        break;
+      case '\n':
+        json->append("\\n");
+        break;
+      case '\r':
+        json->append("\\r");
+        break;
+      case '\t':
+        json->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          json->append(base::StringPrintf("\\u%04x", c));
+        } else {
+          json->push_back(c);
+        }
+        break;
     }
   }
+  json->push_back('"');
+}
+
+// Shows |selected| from |database| as a single JSON object on one line. Times
+// are shown as numeric time_t values, with 0 meaning “never.” Each report with
+// a stored summary carries it. When |options| specifies a selection action,
+// each report carries that action’s result.
+void ShowSelectedReportsJSON(CrashReportDatabase* database,
+                             const std::vector<SelectedReport>& selected,
+                             const Options& options) {
+  const char* action = nullptr;
+  switch (options.selection_action) {
+    case SelectionAction::kNone:
+      break;
+    case SelectionAction::kRequestUpload:
+      action = "request_upload";
+      break;
+    case SelectionAction::kDelete:
+      action = "delete";
+      break;
+  }
+
+  std::string json("{\"reports\":[");
+  uint64_t total_size = 0;
+  for (size_t index = 0; index < selected.size(); ++index) {
+    const CrashReportDatabase::Report& report = selected[index].report;
+    total_size += report.total_size;
+    if (index != 0) {
+      json.push_back(',');
+    }
+    json.append("{\"uuid\":");
+    AppendJSONString(report.uuid.ToString(), &json);
+    json.append(",\"state\":");
+    AppendJSONString(selected[index].pending ? "pending" : "completed", &json);
+    json.append(",\"path\":");
+    AppendJSONString(
+        ToolSupport::FilePathToCommandLineArgument(report.file_path), &json);
+    json.append(",\"id\":");
+    AppendJSONString(report.id, &json);
+    json.append(base::StringPrintf(
+        ",\"creation_time\":%lld,\"uploaded\":%s"
+        ",\"last_upload_attempt_time\":%lld,\"upload_attempts\":%d"
+        ",\"upload_explicitly_requested\":%s,\"total_size\":%llu",
+        static_cast<long long>(report.creation_time),
+        BoolToString(report.uploaded).c_str(),
+        static_cast<long long>(report.last_upload_attempt_time),
+        report.upload_attempts,
+        BoolToString(report.upload_explicitly_requested).c_str(),
+        static_cast<unsigned long long>(report.total_size)));
+    CrashReportDatabase::ReportSummary summary;
+    if (database->GetReportSummary(report.uuid, &summary)) {
+      json.append(base::StringPrintf(
+          ",\"summary\":{\"exception_code\":%" PRIu32
+          ",\"crashing_module_offset\":%" PRIu64 ",\"thread_count\":%" PRIu32
+          ",\"report_size\":%" PRIu64,
+          summary.exception_code,
+          summary.crashing_module_offset,
+          summary.thread_count,
+          summary.report_size));
+      json.append(",\"crashing_module\":");
+      AppendJSONString(summary.crashing_module, &json);
+      json.append(",\"process_name\":");
+      AppendJSONString(summary.process_name, &json);
+      json.push_back('}');
+    }
+    if (action) {
+      json.append(",\"action\":");
+      AppendJSONString(action, &json);
+      json.append(",\"result\":");
+      AppendJSONString(OperationStatusToString(selected[index].action_status),
+                       &json);
+    }
+    json.push_back('}');
+  }
+  json.append(base::StringPrintf(
+      "],\"count\":%zu,\"total_size\":%llu}\n",
+      selected.size(),
+      static_cast<unsigned long long>(total_size)));
+
+  fwrite(json.data(), 1, json.size(), stdout);
 }
 
 int DatabaseUtilMain(int argc, char* argv[]) {
@@ -289,6 +553,14 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     kOptionSetUploadsEnabled,
     kOptionSetLastUploadAttemptTime,
     kOptionNewReport,
+    kOptionSelect,
+    kOptionCreatedAfter,
+    kOptionCreatedBefore,
+    kOptionMinSize,
+    kOptionMaxSize,
+    kOptionRequestUploadSelected,
+    kOptionDeleteSelected,
+    kOptionJSON,
     kOptionUTC,
 
     // Standard options.
@@ -321,6 +593,17 @@ int DatabaseUtilMain(int argc, char* argv[]) {
        nullptr,
        kOptionSetLastUploadAttemptTime},
       {"new-report", required_argument, nullptr, kOptionNewReport},
+      {"select", required_argument, nullptr, kOptionSelect},
+      {"created-after", required_argument, nullptr, kOptionCreatedAfter},
+      {"created-before", required_argument, nullptr, kOptionCreatedBefore},
+      {"min-size", required_argument, nullptr, kOptionMinSize},
+      {"max-size", required_argument, nullptr, kOptionMaxSize},
+      {"request-upload-selected",
+       no_argument,
+       nullptr,
+       kOptionRequestUploadSelected},
+      {"delete-selected", no_argument, nullptr, kOptionDeleteSelected},
+      {"json", no_argument, nullptr, kOptionJSON},
       {"utc", no_argument, nullptr, kOptionUTC},
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
@@ -390,6 +673,55 @@ int DatabaseUtilMain(int argc, char* argv[]) {
             ToolSupport::CommandLineArgumentToFilePathStringType(optarg)));
         break;
       }
+      case kOptionSelect: {
+        if (strcmp(optarg, "pending") == 0) {
+          options.selection = Selection::kPending;
+        } else if (strcmp(optarg, "completed") == 0) {
+          options.selection = Selection::kCompleted;
+        } else if (strcmp(optarg, "all") == 0) {
+          options.selection = Selection::kAll;
+        } else {
+          ToolSupport::UsageHint(
+              me, "--select requires pending, completed, or all");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionCreatedAfter: {
+        options.created_after_string = optarg;
+        break;
+      }
+      case kOptionCreatedBefore: {
+        options.created_before_string = optarg;
+        break;
+      }
+      case kOptionMinSize: {
+        if (!StringToNumber(optarg, &options.min_size)) {
+          ToolSupport::UsageHint(me, "--min-size requires BYTES");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionMaxSize: {
+        if (!StringToNumber(optarg, &options.max_size)) {
+          ToolSupport::UsageHint(me, "--max-size requires BYTES");
+          return EXIT_FAILURE;
+        }
+        options.has_max_size = true;
+        break;
+      }
+      case kOptionRequestUploadSelected: {
+        options.selection_action = SelectionAction::kRequestUpload;
+        break;
+      }
+      case kOptionDeleteSelected: {
+        options.selection_action = SelectionAction::kDelete;
+        break;
+      }
+      case kOptionJSON: {
+        options.json = true;
+        break;
+      }
       case kOptionUTC: {
         options.utc = true;
         break;
@@ -429,6 +761,29 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     }
   }
 
+  if (options.selection == Selection::kNone &&
+      (options.created_after_string || options.created_before_string ||
+       options.min_size || options.has_max_size ||
+       options.selection_action != SelectionAction::kNone || options.json)) {
+    ToolSupport::UsageHint(me, "--select is required with selection options");
+    return EXIT_FAILURE;
+  }
+
+  if (options.created_after_string &&
+      !StringToTime(
+          options.created_after_string, &options.created_after, options.utc)) {
+    ToolSupport::UsageHint(me, "--created-after requires a TIME");
+    return EXIT_FAILURE;
+  }
+
+  if (options.created_before_string &&
+      !StringToTime(options.created_before_string,
+                    &options.created_before,
+                    options.utc)) {
+    ToolSupport::UsageHint(me, "--created-before requires a TIME");
+    return EXIT_FAILURE;
+  }
+
   // --new-report is treated as a show operation because it produces output.
   const size_t show_operations = options.show_client_id +
                                  options.show_uploads_enabled +
@@ -436,10 +791,12 @@ int DatabaseUtilMain(int argc, char* argv[]) {
                                  options.show_pending_reports +
                                  options.show_completed_reports +
                                  options.show_reports.size() +
-                                 options.new_report_paths.size();
+                                 options.new_report_paths.size() +
+                                 (options.selection != Selection::kNone);
   const size_t set_operations =
       options.has_set_uploads_enabled +
-      (options.set_last_upload_attempt_time_string != nullptr);
+      (options.set_last_upload_attempt_time_string != nullptr) +
+      (options.selection_action != SelectionAction::kNone);
 
   if ((options.create ? 1 : 0) + show_operations + set_operations == 0) {
     ToolSupport::UsageHint(me, "nothing to do");
@@ -511,7 +868,10 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       printf("Pending reports:\n");
     }
 
-    ShowReports(pending_reports, show_operations > 1 ? 2 : 0, options);
+    ShowReports(database.get(),
+                pending_reports,
+                show_operations > 1 ? 2 : 0,
+                options);
   }
 
   if (options.show_completed_reports) {
@@ -525,7 +885,10 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       printf("Completed reports:\n");
     }
 
-    ShowReports(completed_reports, show_operations > 1 ? 2 : 0, options);
+    ShowReports(database.get(),
+                completed_reports,
+                show_operations > 1 ? 2 : 0,
+                options);
   }
 
   for (const UUID& uuid : options.show_reports) {
@@ -536,7 +899,8 @@ int DatabaseUtilMain(int argc, char* argv[]) {
       if (show_operations > 1) {
         printf("Report %s:\n", uuid.ToString().c_str());
       }
-      ShowReport(report, show_operations > 1 ? 2 : 0, options.utc);
+      ShowReport(
+          database.get(), report, show_operations > 1 ? 2 : 0, options.utc);
     } else if (status == CrashReportDatabase::kReportNotFound) {
       // If only asked to do one thing, a failure to find the single requested
       // report should result in a failure exit status.
@@ -551,6 +915,16 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     }
   }
 
+  // The selection is scanned with the other “show” operations, but shown after
+  // its action has been applied so that each action’s result can be reported
+  // alongside the report that it applied to. The report metadata shown is from
+  // the scan, before any action.
+  std::vector<SelectedReport> selected_reports;
+  if (options.selection != Selection::kNone &&
+      !SelectReports(database.get(), options, &selected_reports)) {
+    return EXIT_FAILURE;
+  }
+
   if (options.has_set_uploads_enabled &&
       !settings->SetUploadsEnabled(options.set_uploads_enabled)) {
     return EXIT_FAILURE;
@@ -562,6 +936,52 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
+  bool selection_action_failed = false;
+  for (SelectedReport& selected_report : selected_reports) {
+    switch (options.selection_action) {
+      case SelectionAction::kNone:
+        break;
+      case SelectionAction::kRequestUpload:
+        selected_report.action_status =
+            database->RequestUpload(selected_report.report.uuid);
+        break;
+      case SelectionAction::kDelete:
+        selected_report.action_status =
+            database->DeleteReport(selected_report.report.uuid);
+        break;
+    }
+    if (selected_report.action_status != CrashReportDatabase::kNoError) {
+      selection_action_failed = true;
+    }
+  }
+
+  if (options.selection != Selection::kNone) {
+    if (options.json) {
+      ShowSelectedReportsJSON(database.get(), selected_reports, options);
+    } else {
+      if (show_operations > 1) {
+        printf("Selected reports:\n");
+      }
+      const size_t space_count = show_operations > 1 ? 2 : 0;
+      std::vector<CrashReportDatabase::Report> reports;
+      reports.reserve(selected_reports.size());
+      for (const SelectedReport& selected_report : selected_reports) {
+        reports.push_back(selected_report.report);
+      }
+      ShowReports(database.get(), reports, space_count, options);
+    }
+
+    for (const SelectedReport& selected_report : selected_reports) {
+      if (selected_report.action_status != CrashReportDatabase::kNoError) {
+        fprintf(stderr,
+                "%" PRFilePath ": %s: %s\n",
+                me.value().c_str(),
+                selected_report.report.uuid.ToString().c_str(),
+                OperationStatusToString(selected_report.action_status));
+      }
+    }
+  }
+
   bool used_stdin = false;
   for (const base::FilePath& new_report_path : options.new_report_paths) {
     std::unique_ptr<FileReaderInterface> file_reader;
@@ -615,7 +1035,7 @@ int DatabaseUtilMain(int argc, char* argv[]) {
     printf("%s%s\n", prefix, uuid.ToString().c_str());
   }
 
-  return EXIT_SUCCESS;
+  return selection_action_failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 }  // namespace
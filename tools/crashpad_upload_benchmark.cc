@@ -0,0 +1,603 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_file.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "client/crash_report_database.h"
+#include "client/settings.h"
+#include "handler/crash_report_upload_thread.h"
+#include "test/scoped_temp_dir.h"
+#include "tools/tool_support.h"
+#include "util/file/file_io.h"
+#include "util/file/string_file.h"
+#include "util/misc/clock.h"
+#include "util/net/http_body.h"
+#include "util/net/http_headers.h"
+#include "util/net/http_multipart_builder.h"
+#include "util/net/http_transport.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/synchronization/semaphore.h"
+
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#include "third_party/cpp-httplib/cpp-httplib/httplib.h"
+
+namespace crashpad {
+namespace {
+
+// The header and response format used for batched uploads, as described at
+// CrashReportUploadThread::Options::max_reports_per_upload.
+constexpr char kBatchSizeHeader[] = "X-Crashpad-Batch-Size";
+
+// A server like http_transport_test_server, but one that keeps connections
+// alive and accepts any number of uploads, responding to each with the IDs of
+// the reports that it contains. It runs in a child process so that its CPU
+// time isn’t counted against the client. Any failure terminates the child, and
+// is noticed by the parent as failed uploads.
+[[noreturn]] void RunServer(FileHandle port_pipe) {
+  httplib::Server server;
+  if (!server.is_valid()) {
+    LOG(ERROR) << "server creation failed";
+    _exit(EXIT_FAILURE);
+  }
+
+  server.set_keep_alive_max_count(std::numeric_limits<size_t>::max());
+
+  std::atomic<uint64_t> next_report_id(0);
+  server.Post("/upload",
+              [&next_report_id](const httplib::Request& request,
+                                httplib::Response& response) {
+                unsigned int batch_size = 1;
+                if (request.has_header(kBatchSizeHeader) &&
+                    (!StringToNumber(request.get_header_value(kBatchSizeHeader),
+                                     &batch_size) ||
+                     batch_size == 0)) {
+                  response.status = 400;
+                  return;
+                }
+
+                std::string body;
+                for (unsigned int index = 0; index < batch_size; ++index) {
+                  body += base::StringPrintf("%016" PRIx64 "\n",
+                                             next_report_id++);
+                }
+                response.status = 200;
+                response.set_content(body, "text/plain");
+              });
+
+  const uint16_t port =
+      base::checked_cast<uint16_t>(server.bind_to_any_port("localhost"));
+  CheckedWriteFile(port_pipe, &port, sizeof(port));
+  CheckedCloseFile(port_pipe);
+
+  server.listen_after_bind();
+  _exit(EXIT_SUCCESS);
+}
+
+// A child process running RunServer(), which is killed on destruction.
+class ServerProcess {
+ public:
+  ServerProcess() : pid_(-1), port_(0) {}
+
+  ServerProcess(const ServerProcess&) = delete;
+  ServerProcess& operator=(const ServerProcess&) = delete;
+
+  ~ServerProcess() {
+    if (pid_ > 0) {
+      kill(pid_, SIGKILL);
+      HANDLE_EINTR(waitpid(pid_, nullptr, 0));
+    }
+  }
+
+  //! \brief Starts the server. This must be called while the calling process
+  //!     has only one thread.
+  bool Start() {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+      PLOG(ERROR) << "pipe";
+      return false;
+    }
+    base::ScopedFD read_pipe(pipe_fds[0]);
+    base::ScopedFD write_pipe(pipe_fds[1]);
+
+    pid_ = fork();
+    if (pid_ < 0) {
+      PLOG(ERROR) << "fork";
+      return false;
+    }
+    if (pid_ == 0) {
+      read_pipe.reset();
+      RunServer(write_pipe.release());
+    }
+
+    write_pipe.reset();
+    if (!LoggingReadFileExactly(read_pipe.get(), &port_, sizeof(port_))) {
+      return false;
+    }
+    return true;
+  }
+
+  std::string URL() const {
+    return base::StringPrintf("http://localhost:%u/upload", port_);
+  }
+
+ private:
+  pid_t pid_;
+  uint16_t port_;
+};
+
+// The options that apply to every measurement.
+struct BenchmarkOptions {
+  size_t reports;
+  size_t max_concurrent_uploads;
+  size_t max_reports_per_upload;
+  size_t gzip_threads;
+  bool new_connections;
+};
+
+// The cost of uploading a set of reports.
+struct Measurement {
+  uint64_t duration_ns;
+  uint64_t cpu_ns;
+};
+
+uint64_t ProcessCPUNanoseconds() {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    PLOG(ERROR) << "getrusage";
+    return 0;
+  }
+  auto timeval_ns = [](const timeval& tv) {
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000000 +
+           static_cast<uint64_t>(tv.tv_usec) * 1000;
+  };
+  return timeval_ns(usage.ru_utime) + timeval_ns(usage.ru_stime);
+}
+
+// Measures the wall and CPU time between construction and Finish().
+class ScopedMeasurement {
+ public:
+  ScopedMeasurement()
+      : start_ns_(ClockMonotonicNanoseconds()),
+        start_cpu_ns_(ProcessCPUNanoseconds()) {}
+
+  ScopedMeasurement(const ScopedMeasurement&) = delete;
+  ScopedMeasurement& operator=(const ScopedMeasurement&) = delete;
+
+  ~ScopedMeasurement() {}
+
+  Measurement Finish() const {
+    Measurement measurement;
+    measurement.duration_ns = ClockMonotonicNanoseconds() - start_ns_;
+    measurement.cpu_ns = ProcessCPUNanoseconds() - start_cpu_ns_;
+    return measurement;
+  }
+
+ private:
+  uint64_t start_ns_;
+  uint64_t start_cpu_ns_;
+};
+
+// Returns report contents of |size| bytes that compress about as well as a
+// typical minidump: runs of zeroes interleaved with pseudorandom data.
+std::string MakeReport(size_t size) {
+  std::string report(size, '\0');
+  uint64_t state = 0x9e3779b97f4a7c15;
+  for (size_t offset = 0; offset < size; ++offset) {
+    if ((offset / 64) % 2 == 0) {
+      state = state * 6364136223846793005 + 1442695040888963407;
+      report[offset] = static_cast<char>(state >> 56);
+    }
+  }
+  return report;
+}
+
+// Uploads |report| directly through an HTTPTransport, without a database.
+bool MeasureTransport(const std::string& url,
+                      const std::string& report,
+                      bool gzip,
+                      const BenchmarkOptions& options,
+                      Measurement* measurement) {
+  StringFile report_file;
+  report_file.SetString(report);
+
+  ScopedMeasurement scoped_measurement;
+  std::unique_ptr<HTTPTransport> http_transport;
+  for (size_t index = 0; index < options.reports; ++index) {
+    if (!report_file.SeekSet(0)) {
+      return false;
+    }
+
+    HTTPMultipartBuilder http_multipart_builder;
+    http_multipart_builder.SetGzipEnabled(gzip);
+    http_multipart_builder.SetGzipThreads(options.gzip_threads);
+    http_multipart_builder.SetFileAttachment("upload_file_minidump",
+                                             "benchmark.dmp",
+                                             &report_file,
+                                             "application/octet-stream");
+
+    if (!http_transport || options.new_connections) {
+      http_transport = HTTPTransport::Create();
+      if (!http_transport) {
+        return false;
+      }
+    } else {
+      http_transport->ResetRequest();
+    }
+
+    HTTPHeaders content_headers;
+    http_multipart_builder.PopulateContentHeaders(&content_headers);
+    for (const auto& content_header : content_headers) {
+      http_transport->SetHeader(content_header.first, content_header.second);
+    }
+    http_transport->SetBodyStream(http_multipart_builder.GetBodyStream());
+    http_transport->SetURL(url);
+
+    std::string response_body;
+    if (!http_transport->ExecuteSynchronously(&response_body)) {
+      LOG(ERROR) << "upload " << index << " failed";
+      return false;
+    }
+  }
+
+  *measurement = scoped_measurement.Finish();
+  return true;
+}
+
+// Uploads |report| from a database through a CrashReportUploadThread, as the
+// handler would.
+bool MeasureUploadThread(const std::string& url,
+                         const std::string& report,
+                         bool gzip,
+                         const BenchmarkOptions& options,
+                         Measurement* measurement) {
+  test::ScopedTempDir temp_dir;
+  std::unique_ptr<CrashReportDatabase> database =
+      CrashReportDatabase::Initialize(temp_dir.path());
+  if (!database) {
+    return false;
+  }
+  database->GetSettings()->SetUploadsEnabled(true);
+
+  for (size_t index = 0; index < options.reports; ++index) {
+    std::unique_ptr<CrashReportDatabase::NewReport> new_report;
+    if (database->PrepareNewCrashReport(&new_report) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+    if (!new_report->Writer()->Write(report.data(), report.size())) {
+      return false;
+    }
+    UUID uuid;
+    if (database->FinishedWritingCrashReport(std::move(new_report), &uuid) !=
+        CrashReportDatabase::kNoError) {
+      return false;
+    }
+  }
+
+  CrashReportUploadThread::Options upload_thread_options;
+  upload_thread_options.identify_client_via_url = false;
+  upload_thread_options.rate_limit = false;
+  upload_thread_options.upload_gzip = gzip;
+  upload_thread_options.upload_gzip_threads = options.gzip_threads;
+  upload_thread_options.watch_pending_reports = true;
+  upload_thread_options.max_concurrent_uploads = options.max_concurrent_uploads;
+  upload_thread_options.max_reports_per_upload = options.max_reports_per_upload;
+
+  // The initial pass over the database uploads every report, and is followed
+  // by the callback.
+  Semaphore pass_complete(0);
+  CrashReportUploadThread upload_thread(
+      database.get(),
+      url,
+      upload_thread_options,
+      [&pass_complete]() { pass_complete.Signal(); });
+
+  ScopedMeasurement scoped_measurement;
+  upload_thread.Start();
+  pass_complete.Wait();
+  *measurement = scoped_measurement.Finish();
+  upload_thread.Stop();
+
+  std::vector<CrashReportDatabase::Report> completed_reports;
+  if (database->GetCompletedReports(&completed_reports) !=
+      CrashReportDatabase::kNoError) {
+    return false;
+  }
+  size_t uploaded_reports = 0;
+  for (const CrashReportDatabase::Report& completed_report :
+       completed_reports) {
+    if (completed_report.uploaded) {
+      ++uploaded_reports;
+    }
+  }
+  if (uploaded_reports != options.reports) {
+    LOG(ERROR) << "uploaded " << uploaded_reports << " of " << options.reports
+               << " reports";
+    return false;
+  }
+
+  return true;
+}
+
+void PrintMeasurement(const char* mode,
+                      size_t report_size,
+                      bool gzip,
+                      const BenchmarkOptions& options,
+                      const Measurement& measurement) {
+  const double seconds = measurement.duration_ns / 1e9;
+  const double bytes = static_cast<double>(report_size) * options.reports;
+  printf("%s,%zu,%d,%zu,%" PRIu64 ",%.1f,%.0f,%.0f\n",
+         mode,
+         report_size,
+         gzip ? 1 : 0,
+         options.reports,
+         measurement.duration_ns,
+         options.reports / seconds,
+         bytes / seconds,
+         measurement.cpu_ns / (bytes / (1024 * 1024)));
+}
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]...\n"
+"Measure the throughput of uploading crash reports to a local server.\n"
+"\n"
+"      --gzip=MODE                   off, on, or both, default both\n"
+"      --gzip-threads=COUNT          compress each upload with COUNT threads\n"
+"      --max-concurrent-uploads=COUNT\n"
+"                                    upload COUNT reports at once from the\n"
+"                                    database\n"
+"      --max-reports-per-upload=COUNT\n"
+"                                    batch COUNT reports per upload from the\n"
+"                                    database\n"
+"      --mode=MODE                   transport, upload_thread, or both,\n"
+"                                    default both\n"
+"      --new-connections             create a new transport for each upload\n"
+"                                    in transport mode\n"
+"      --report-size=BYTES           upload reports of BYTES bytes, may be\n"
+"                                    given more than once\n"
+"      --reports=COUNT               upload COUNT reports per measurement,\n"
+"                                    default 50\n"
+"      --help                        display this help and exit\n"
+"      --version                     output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+// Parses a --gzip or --mode value of |off_name|, |on_name|, or "both".
+bool ParseChoice(const char* value,
+                 const char* off_name,
+                 const char* on_name,
+                 bool* off,
+                 bool* on) {
+  if (strcmp(value, "both") == 0) {
+    *off = true;
+    *on = true;
+  } else if (strcmp(value, off_name) == 0) {
+    *off = true;
+    *on = false;
+  } else if (strcmp(value, on_name) == 0) {
+    *off = false;
+    *on = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int CrashpadUploadBenchmarkMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionGzip,
+    kOptionGzipThreads,
+    kOptionMaxConcurrentUploads,
+    kOptionMaxReportsPerUpload,
+    kOptionMode,
+    kOptionNewConnections,
+    kOptionReportSize,
+    kOptionReports,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  BenchmarkOptions options = {};
+  options.reports = 50;
+  options.max_concurrent_uploads = 1;
+  options.max_reports_per_upload = 1;
+  options.gzip_threads = 1;
+  bool gzip_off = true;
+  bool gzip_on = true;
+  bool mode_transport = true;
+  bool mode_upload_thread = true;
+  std::vector<size_t> report_sizes;
+
+  static constexpr option long_options[] = {
+      {"gzip", required_argument, nullptr, kOptionGzip},
+      {"gzip-threads", required_argument, nullptr, kOptionGzipThreads},
+      {"max-concurrent-uploads",
+       required_argument,
+       nullptr,
+       kOptionMaxConcurrentUploads},
+      {"max-reports-per-upload",
+       required_argument,
+       nullptr,
+       kOptionMaxReportsPerUpload},
+      {"mode", required_argument, nullptr, kOptionMode},
+      {"new-connections", no_argument, nullptr, kOptionNewConnections},
+      {"report-size", required_argument, nullptr, kOptionReportSize},
+      {"reports", required_argument, nullptr, kOptionReports},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionGzip:
+        if (!ParseChoice(optarg, "off", "on", &gzip_off, &gzip_on)) {
+          ToolSupport::UsageHint(me, "--gzip requires off, on, or both");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionGzipThreads:
+        if (!StringToNumber(optarg, &options.gzip_threads) ||
+            options.gzip_threads == 0) {
+          ToolSupport::UsageHint(me, "--gzip-threads requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionMaxConcurrentUploads:
+        if (!StringToNumber(optarg, &options.max_concurrent_uploads) ||
+            options.max_concurrent_uploads == 0) {
+          ToolSupport::UsageHint(me,
+                                 "--max-concurrent-uploads requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionMaxReportsPerUpload:
+        if (!StringToNumber(optarg, &options.max_reports_per_upload) ||
+            options.max_reports_per_upload == 0) {
+          ToolSupport::UsageHint(me,
+                                 "--max-reports-per-upload requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionMode:
+        if (!ParseChoice(optarg,
+                         "transport",
+                         "upload_thread",
+                         &mode_transport,
+                         &mode_upload_thread)) {
+          ToolSupport::UsageHint(
+              me, "--mode requires transport, upload_thread, or both");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionNewConnections:
+        options.new_connections = true;
+        break;
+      case kOptionReportSize: {
+        size_t report_size;
+        if (!StringToNumber(optarg, &report_size) || report_size == 0) {
+          ToolSupport::UsageHint(me, "--report-size requires BYTES");
+          return EXIT_FAILURE;
+        }
+        report_sizes.push_back(report_size);
+        break;
+      }
+      case kOptionReports:
+        if (!StringToNumber(optarg, &options.reports) ||
+            options.reports == 0) {
+          ToolSupport::UsageHint(me, "--reports requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      case kOptionHelp:
+        Usage(me);
+        return EXIT_SUCCESS;
+      case kOptionVersion:
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      default:
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 0) {
+    ToolSupport::UsageHint(me, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  if (report_sizes.empty()) {
+    report_sizes = {16 * 1024, 256 * 1024, 1024 * 1024};
+  }
+
+  ServerProcess server;
+  if (!server.Start()) {
+    return EXIT_FAILURE;
+  }
+  const std::string url = server.URL();
+
+  printf("mode,report_size,gzip,reports,duration_ns,reports_per_sec,"
+         "bytes_per_sec,cpu_ns_per_mib\n");
+  for (size_t report_size : report_sizes) {
+    const std::string report = MakeReport(report_size);
+    for (bool gzip : {false, true}) {
+      if (!(gzip ? gzip_on : gzip_off)) {
+        continue;
+      }
+
+      Measurement measurement;
+      if (mode_transport) {
+        if (!MeasureTransport(url, report, gzip, options, &measurement)) {
+          return EXIT_FAILURE;
+        }
+        PrintMeasurement(
+            "transport", report_size, gzip, options, measurement);
+      }
+      if (mode_upload_thread) {
+        if (!MeasureUploadThread(url, report, gzip, options, &measurement)) {
+          return EXIT_FAILURE;
+        }
+        PrintMeasurement(
+            "upload_thread", report_size, gzip, options, measurement);
+      }
+      fflush(stdout);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::CrashpadUploadBenchmarkMain(argc, argv);
+}
@@ -13,12 +13,32 @@
 // limitations under the License.
 
 #include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "client/annotation.h"
-#include "util/file/file_reader.h"
 #include "snapshot/minidump/process_snapshot_minidump.h"
 #include "tools/tool_support.h"
+#include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/filesystem.h"
+#include "util/misc/uuid.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/thread/run_concurrently.h"
 
 namespace crashpad {
 namespace {
@@ -26,11 +46,21 @@ namespace {
 void Usage(const base::FilePath& me) {
   // clang-format off
   fprintf(stderr,
-"Usage: %" PRFilePath " [OPTION]... PATH\n"
+"Usage: %" PRFilePath " [OPTION]... --minidump=PATH\n"
+"       %" PRFilePath " [OPTION]... --batch [PATH]...\n"
 "Dump annotations from minidumps.\n"
 "\n"
+"      --batch                     dump each minidump PATH, and each .dmp\n"
+"                                  file in each directory PATH, as JSON\n"
+"                                  Lines\n"
+"      --file-list=FILE            in batch mode, also dump the minidumps\n"
+"                                  named one per line in FILE, or - for stdin\n"
+"      --jobs=COUNT                in batch mode, dump up to COUNT minidumps\n"
+"                                  at once, default the number of CPUs\n"
+"      --minidump=PATH             dump the minidump at PATH as text\n"
 "      --help                      display this help and exit\n"
 "      --version                   output version information and exit\n",
+          me.value().c_str(),
           me.value().c_str());
   // clang-format on
   ToolSupport::UsageTail(me);
@@ -38,8 +68,324 @@ void Usage(const base::FilePath& me) {
 
 struct Options {
   const char* minidump;
+  const char* file_list;
+  size_t jobs;
+  bool batch;
 };
 
+// Passes each module visited to a function, so that only one module of a
+// minidump is held in memory at a time.
+class ModuleVisitor final : public ProcessSnapshotMinidump::ElementVisitor {
+ public:
+  explicit ModuleVisitor(std::function<void(const ModuleSnapshot*)> function)
+      : function_(std::move(function)) {}
+
+  ModuleVisitor(const ModuleVisitor&) = delete;
+  ModuleVisitor& operator=(const ModuleVisitor&) = delete;
+
+  ~ModuleVisitor() override {}
+
+  // ProcessSnapshotMinidump::ElementVisitor:
+  bool VisitModule(const ModuleSnapshot* module) override {
+    function_(module);
+    return true;
+  }
+
+ private:
+  std::function<void(const ModuleSnapshot*)> function_;
+};
+
+bool VisitModules(ProcessSnapshotMinidump* snapshot,
+                  std::function<void(const ModuleSnapshot*)> function) {
+  ModuleVisitor visitor(std::move(function));
+  return snapshot->VisitElements(
+      &visitor,
+      ProcessSnapshotMinidump::kElementModules,
+      ProcessSnapshotMinidump::kDefaultMaxElementSize);
+}
+
+void PrintModule(const ModuleSnapshot* module) {
+  printf("Module: %s\n", module->Name().c_str());
+  printf("  Simple Annotations\n");
+  for (const auto& kv : module->AnnotationsSimpleMap()) {
+    printf("    simple_annotations[\"%s\"] = %s\n",
+           kv.first.c_str(), kv.second.c_str());
+  }
+
+  printf("  Vectored Annotations\n");
+  int index = 0;
+  for (const std::string& annotation : module->AnnotationsVector()) {
+    printf("    vectored_annotations[%d] = %s\n", index, annotation.c_str());
+    index++;
+  }
+
+  printf("  Annotation Objects\n");
+  for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
+    printf("    annotation_objects[\"%s\"] = ", annotation.name.c_str());
+    if (annotation.type != static_cast<uint16_t>(Annotation::Type::kString)) {
+
+      printf("<non-string value, not printing>\n");
+      continue;
+    }
+
+    std::string value(reinterpret_cast<const char*>(annotation.value.data()),
+                      annotation.value.size());
+
+    printf("%s\n", value.c_str());
+  }
+}
+
+int DumpMinidump(const base::FilePath& path) {
+  FileReader reader;
+  if (!reader.Open(path)) {
+    return EXIT_FAILURE;
+  }
+
+  ProcessSnapshotMinidump snapshot;
+  if (!snapshot.InitializeForVisiting(&reader)) {
+    return EXIT_FAILURE;
+  }
+
+  if (!VisitModules(&snapshot, PrintModule)) {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// Appends |value| to |json| as a JSON string. Bytes that aren’t ASCII are
+// copied as-is, so |value| should be UTF-8 for the result to be valid JSON.
+void AppendJSONString(const std::string& value, std::string* json) {
+  json->push_back('"');
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        json->append("\\\"");
+        break;
+      case '\\':
+        json->append("\\\\");
+        break;
+      case '\n':
+        json->append("\\n");
+        break;
+      case '\r':
+        json->append("\\r");
+        break;
+      case '\t':
+        json->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          json->append(base::StringPrintf("\\u%04x", c));
+        } else {
+          json->push_back(c);
+        }
+        break;
+    }
+  }
+  json->push_back('"');
+}
+
+void AppendJSONObject(const std::map<std::string, std::string>& map,
+                      std::string* json) {
+  json->push_back('{');
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    if (it != map.begin()) {
+      json->push_back(',');
+    }
+    AppendJSONString(it->first, json);
+    json->push_back(':');
+    AppendJSONString(it->second, json);
+  }
+  json->push_back('}');
+}
+
+void AppendJSONModule(const ModuleSnapshot* module, std::string* json) {
+  json->append("{\"name\":");
+  AppendJSONString(module->Name(), json);
+
+  json->append(",\"simple_annotations\":");
+  AppendJSONObject(module->AnnotationsSimpleMap(), json);
+
+  json->append(",\"vectored_annotations\":[");
+  const std::vector<std::string> vectored_annotations =
+      module->AnnotationsVector();
+  for (size_t index = 0; index < vectored_annotations.size(); ++index) {
+    if (index) {
+      json->push_back(',');
+    }
+    AppendJSONString(vectored_annotations[index], json);
+  }
+
+  // String values are given as "value". Other values are given as "hex".
+  json->append("],\"annotation_objects\":[");
+  const std::vector<AnnotationSnapshot> annotation_objects =
+      module->AnnotationObjects();
+  for (size_t index = 0; index < annotation_objects.size(); ++index) {
+    const AnnotationSnapshot& annotation = annotation_objects[index];
+    if (index) {
+      json->push_back(',');
+    }
+    json->append("{\"name\":");
+    AppendJSONString(annotation.name, json);
+    json->append(base::StringPrintf(",\"type\":%u,", annotation.type));
+    if (annotation.type == static_cast<uint16_t>(Annotation::Type::kString)) {
+      json->append("\"value\":");
+      AppendJSONString(
+          std::string(reinterpret_cast<const char*>(annotation.value.data()),
+                      annotation.value.size()),
+          json);
+    } else {
+      json->append("\"hex\":\"");
+      for (uint8_t byte : annotation.value) {
+        json->append(base::StringPrintf("%02x", byte));
+      }
+      json->push_back('"');
+    }
+    json->push_back('}');
+  }
+  json->append("]}");
+}
+
+// Sets |json| to a JSON Lines record of the annotations in the minidump at
+// |path|. If the minidump can’t be read, the record has an "error" member
+// instead, and this returns `false`.
+bool DumpMinidumpJSON(const base::FilePath& path, std::string* json_out) {
+  std::string& json = *json_out;
+  json = "{\"path\":";
+  AppendJSONString(ToolSupport::FilePathToCommandLineArgument(path), &json);
+
+  FileReader reader;
+  ProcessSnapshotMinidump snapshot;
+  if (!reader.Open(path)) {
+    json.append(",\"error\":\"open failed\"}\n");
+    return false;
+  }
+  if (!snapshot.InitializeForVisiting(&reader)) {
+    json.append(",\"error\":\"invalid minidump\"}\n");
+    return false;
+  }
+
+  UUID uuid;
+  snapshot.ReportID(&uuid);
+  json.append(",\"report_id\":");
+  AppendJSONString(uuid.ToString(), &json);
+  snapshot.ClientID(&uuid);
+  json.append(",\"client_id\":");
+  AppendJSONString(uuid.ToString(), &json);
+
+  json.append(",\"simple_annotations\":");
+  AppendJSONObject(snapshot.AnnotationsSimpleMap(), &json);
+
+  // Modules are visited one at a time. If one can’t be read, the record is
+  // replaced by one with an error, so that it isn’t left incomplete.
+  json.append(",\"modules\":[");
+  bool first_module = true;
+  if (!VisitModules(&snapshot,
+                    [&json, &first_module](const ModuleSnapshot* module) {
+                      if (!first_module) {
+                        json.push_back(',');
+                      }
+                      first_module = false;
+                      AppendJSONModule(module, &json);
+                    })) {
+    json = "{\"path\":";
+    AppendJSONString(ToolSupport::FilePathToCommandLineArgument(path), &json);
+    json.append(",\"error\":\"invalid minidump\"}\n");
+    return false;
+  }
+  json.append("]}\n");
+  return true;
+}
+
+// Adds |path| to |minidumps| if it names a file, or the .dmp files in it if it
+// names a directory.
+bool AddMinidumpPath(const base::FilePath& path,
+                     std::vector<base::FilePath>* minidumps) {
+  if (!IsDirectory(path, true)) {
+    minidumps->push_back(path);
+    return true;
+  }
+
+  DirectoryReader reader;
+  if (!reader.Open(path)) {
+    return false;
+  }
+  base::FilePath filename;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename)) ==
+         DirectoryReader::Result::kSuccess) {
+    static constexpr base::FilePath::CharType kExtension[] =
+        FILE_PATH_LITERAL(".dmp");
+    const base::FilePath::StringType& name = filename.value();
+    const size_t extension_length = std::size(kExtension) - 1;
+    const base::FilePath file_path(path.Append(filename));
+    if (name.size() > extension_length &&
+        name.compare(name.size() - extension_length,
+                     extension_length,
+                     kExtension) == 0 &&
+        IsRegularFile(file_path)) {
+      minidumps->push_back(file_path);
+    }
+  }
+  return result == DirectoryReader::Result::kNoMoreFiles;
+}
+
+// Adds the paths named one per line in |file_list| to |minidumps|.
+bool AddMinidumpsFromFileList(const char* file_list,
+                              std::vector<base::FilePath>* minidumps) {
+  std::string contents;
+  if (strcmp(file_list, "-") == 0) {
+    if (!LoggingReadToEOF(StdioFileHandle(StdioStream::kStandardInput),
+                          &contents)) {
+      return false;
+    }
+  } else {
+    if (!LoggingReadEntireFile(
+            base::FilePath(ToolSupport::CommandLineArgumentToFilePathStringType(
+                file_list)),
+            &contents)) {
+      return false;
+    }
+  }
+
+  size_t line_start = 0;
+  while (line_start < contents.size()) {
+    size_t line_end = contents.find('\n', line_start);
+    if (line_end == std::string::npos) {
+      line_end = contents.size();
+    }
+    std::string line = contents.substr(line_start, line_end - line_start);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (!line.empty()) {
+      minidumps->push_back(base::FilePath(
+          ToolSupport::CommandLineArgumentToFilePathStringType(line)));
+    }
+    line_start = line_end + 1;
+  }
+  return true;
+}
+
+int DumpMinidumpsJSON(const std::vector<base::FilePath>& minidumps,
+                      size_t jobs) {
+  // Records are written whole, in the order that they’re completed. A minidump
+  // that can’t be read doesn’t stop the others from being dumped.
+  base::Lock output_lock;
+  bool success = true;
+  RunConcurrently(minidumps.size(), jobs, [&](size_t index) {
+    std::string json;
+    const bool dumped = DumpMinidumpJSON(minidumps[index], &json);
+    base::AutoLock lock(output_lock);
+    if (fwrite(json.data(), 1, json.size(), stdout) != json.size() ||
+        !dumped) {
+      success = false;
+    }
+  });
+  return success && fflush(stdout) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
   const base::FilePath argv0(
       ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
@@ -48,6 +394,9 @@ int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
   enum OptionFlags {
     // Long options without short equivalents.
     kOptionLastChar = 255,
+    kOptionBatch,
+    kOptionFileList,
+    kOptionJobs,
     kOptionMinidump,
 
     // Standard options.
@@ -56,6 +405,9 @@ int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
   };
 
   static constexpr option long_options[] = {
+      {"batch", no_argument, nullptr, kOptionBatch},
+      {"file-list", required_argument, nullptr, kOptionFileList},
+      {"jobs", required_argument, nullptr, kOptionJobs},
       {"minidump", required_argument, nullptr, kOptionMinidump},
       {"help", no_argument, nullptr, kOptionHelp},
       {"version", no_argument, nullptr, kOptionVersion},
@@ -63,10 +415,26 @@ int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
   };
 
   Options options = {};
+  options.jobs = std::thread::hardware_concurrency();
 
   int opt;
   while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
     switch (opt) {
+      case kOptionBatch: {
+        options.batch = true;
+        break;
+      }
+      case kOptionFileList: {
+        options.file_list = optarg;
+        break;
+      }
+      case kOptionJobs: {
+        if (!StringToNumber(optarg, &options.jobs) || options.jobs == 0) {
+          ToolSupport::UsageHint(me, "--jobs requires a COUNT");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
       case kOptionMinidump: {
         options.minidump = optarg;
         break;
@@ -88,55 +456,40 @@ int DumpMinidumpAnnotationsMain(int argc, char* argv[]) {
   argc -= optind;
   argv += optind;
 
-  if (!options.minidump) {
-    ToolSupport::UsageHint(me, "--minidump is required");
-    return EXIT_FAILURE;
-  }
-
-  FileReader reader;
-  if (!reader.Open(base::FilePath(
-      ToolSupport::CommandLineArgumentToFilePathStringType(
-          options.minidump)))) {
-    return EXIT_FAILURE;
+  if (!options.batch) {
+    if (!options.minidump) {
+      ToolSupport::UsageHint(me, "--minidump is required");
+      return EXIT_FAILURE;
+    }
+    if (options.file_list || argc != 0) {
+      ToolSupport::UsageHint(me, "PATH and --file-list require --batch");
+      return EXIT_FAILURE;
+    }
+    return DumpMinidump(base::FilePath(
+        ToolSupport::CommandLineArgumentToFilePathStringType(
+            options.minidump)));
   }
 
-  ProcessSnapshotMinidump snapshot;
-  if (!snapshot.Initialize(&reader)) {
+  if (options.minidump) {
+    ToolSupport::UsageHint(me, "--minidump can't be used with --batch");
     return EXIT_FAILURE;
   }
 
-  for (const ModuleSnapshot* module : snapshot.Modules()) {
-    printf("Module: %s\n", module->Name().c_str());
-    printf("  Simple Annotations\n");
-    for (const auto& kv : module->AnnotationsSimpleMap()) {
-      printf("    simple_annotations[\"%s\"] = %s\n",
-             kv.first.c_str(), kv.second.c_str());
-    }
-
-    printf("  Vectored Annotations\n");
-    int index = 0;
-    for (const std::string& annotation : module->AnnotationsVector()) {
-      printf("    vectored_annotations[%d] = %s\n", index, annotation.c_str());
-      index++;
-    }
-
-    printf("  Annotation Objects\n");
-    for (const AnnotationSnapshot& annotation : module->AnnotationObjects()) {
-      printf("    annotation_objects[\"%s\"] = ", annotation.name.c_str());
-      if (annotation.type != static_cast<uint16_t>(Annotation::Type::kString)) {
-
-        printf("<non-string value, not printing>\n");
-        continue;
-      }
-
-      std::string value(reinterpret_cast<const char*>(annotation.value.data()),
-                        annotation.value.size());
-
-      printf("%s\n", value.c_str());
+  std::vector<base::FilePath> minidumps;
+  for (int index = 0; index < argc; ++index) {
+    if (!AddMinidumpPath(
+            base::FilePath(ToolSupport::CommandLineArgumentToFilePathStringType(
+                argv[index])),
+            &minidumps)) {
+      return EXIT_FAILURE;
     }
   }
+  if (options.file_list &&
+      !AddMinidumpsFromFileList(options.file_list, &minidumps)) {
+    return EXIT_FAILURE;
+  }
 
-  return EXIT_SUCCESS;
+  return DumpMinidumpsJSON(minidumps, options.jobs);
 }
 
 }  // namespace
@@ -0,0 +1,227 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "base/files/file_path.h"
+#include "build/build_config.h"
+#include "minidump/minidump_extensions.h"
+#include "minidump/minidump_repacker.h"
+#include "tools/tool_support.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/file/filesystem.h"
+#include "util/stdlib/string_number_conversion.h"
+
+namespace crashpad {
+namespace {
+
+void Usage(const base::FilePath& me) {
+  // clang-format off
+  fprintf(stderr,
+"Usage: %" PRFilePath " [OPTION]... INPUT OUTPUT\n"
+"Rewrite the minidump at INPUT to OUTPUT, smaller.\n"
+"\n"
+"      --compact-memory-info=BYTES keep memory info only within BYTES of\n"
+"                                  captured addresses, merging adjacent\n"
+"                                  regions\n"
+"      --compress-memory=BYTES     compress memory regions of at least BYTES\n"
+"      --compress-block-size=BYTES compress memory in blocks of BYTES\n"
+"      --crashing-thread-stack-only\n"
+"                                  keep the stack of the crashing thread only\n"
+"      --elide-zero-memory         omit memory pages containing only zeroes\n"
+"      --strip-extra-memory        omit memory other than thread stacks\n"
+"      --strip-memory-info         omit the memory info list stream\n"
+"      --strip-thread-names        omit the thread name list stream\n"
+"      --strip-user-streams        omit streams not defined by minidump or\n"
+"                                  Crashpad\n"
+"      --help                      display this help and exit\n"
+"      --version                   output version information and exit\n",
+          me.value().c_str());
+  // clang-format on
+  ToolSupport::UsageTail(me);
+}
+
+bool RepackMinidump(const base::FilePath& input_path,
+                    const base::FilePath& output_path,
+                    const MinidumpRepackOptions& options) {
+  FileReader file_reader;
+  if (!file_reader.Open(input_path)) {
+    return false;
+  }
+
+  FileWriter file_writer;
+  if (!file_writer.Open(output_path,
+                        FileWriteMode::kTruncateOrCreate,
+                        FilePermissions::kWorldReadable)) {
+    return false;
+  }
+
+  if (!RepackMinidump(&file_reader, &file_writer, options)) {
+    file_writer.Close();
+    LoggingRemoveFile(output_path);
+    return false;
+  }
+
+  return true;
+}
+
+int RepackMinidumpMain(int argc, char* argv[]) {
+  const base::FilePath argv0(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath me(argv0.BaseName());
+
+  enum OptionFlags {
+    // Long options without short equivalents.
+    kOptionLastChar = 255,
+    kOptionCompactMemoryInfo,
+    kOptionCompressMemory,
+    kOptionCompressBlockSize,
+    kOptionCrashingThreadStackOnly,
+    kOptionElideZeroMemory,
+    kOptionStripExtraMemory,
+    kOptionStripMemoryInfo,
+    kOptionStripThreadNames,
+    kOptionStripUserStreams,
+
+    // Standard options.
+    kOptionHelp = -2,
+    kOptionVersion = -3,
+  };
+
+  static constexpr option long_options[] = {
+      {"compact-memory-info",
+       required_argument,
+       nullptr,
+       kOptionCompactMemoryInfo},
+      {"compress-memory", required_argument, nullptr, kOptionCompressMemory},
+      {"compress-block-size",
+       required_argument,
+       nullptr,
+       kOptionCompressBlockSize},
+      {"crashing-thread-stack-only",
+       no_argument,
+       nullptr,
+       kOptionCrashingThreadStackOnly},
+      {"elide-zero-memory", no_argument, nullptr, kOptionElideZeroMemory},
+      {"strip-extra-memory", no_argument, nullptr, kOptionStripExtraMemory},
+      {"strip-memory-info", no_argument, nullptr, kOptionStripMemoryInfo},
+      {"strip-thread-names", no_argument, nullptr, kOptionStripThreadNames},
+      {"strip-user-streams", no_argument, nullptr, kOptionStripUserStreams},
+      {"help", no_argument, nullptr, kOptionHelp},
+      {"version", no_argument, nullptr, kOptionVersion},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  MinidumpRepackOptions options;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", long_options, nullptr)) != -1) {
+    switch (opt) {
+      case kOptionCompactMemoryInfo: {
+        if (!StringToNumber(optarg,
+                            &options.compact_memory_info_neighborhood)) {
+          ToolSupport::UsageHint(me, "--compact-memory-info requires BYTES");
+          return EXIT_FAILURE;
+        }
+        options.compact_memory_info = true;
+        break;
+      }
+      case kOptionCompressMemory: {
+        if (!StringToNumber(optarg, &options.compress_memory) ||
+            options.compress_memory == 0) {
+          ToolSupport::UsageHint(me, "--compress-memory requires BYTES");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionCompressBlockSize: {
+        if (!StringToNumber(optarg, &options.compress_block_size) ||
+            options.compress_block_size == 0 ||
+            options.compress_block_size >
+                MinidumpCompressedMemoryRange::kMaxBlockSize) {
+          ToolSupport::UsageHint(me, "--compress-block-size requires BYTES");
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case kOptionCrashingThreadStackOnly: {
+        options.crashing_thread_stack_only = true;
+        break;
+      }
+      case kOptionElideZeroMemory: {
+        options.elide_zero_memory = true;
+        break;
+      }
+      case kOptionStripExtraMemory: {
+        options.strip_extra_memory = true;
+        break;
+      }
+      case kOptionStripMemoryInfo: {
+        options.strip_memory_info = true;
+        break;
+      }
+      case kOptionStripThreadNames: {
+        options.strip_thread_names = true;
+        break;
+      }
+      case kOptionStripUserStreams: {
+        options.strip_user_streams = true;
+        break;
+      }
+      case kOptionHelp: {
+        Usage(me);
+        return EXIT_SUCCESS;
+      }
+      case kOptionVersion: {
+        ToolSupport::Version(me);
+        return EXIT_SUCCESS;
+      }
+      default: {
+        ToolSupport::UsageHint(me, nullptr);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  if (argc != 2) {
+    ToolSupport::UsageHint(me, "INPUT and OUTPUT are required");
+    return EXIT_FAILURE;
+  }
+
+  const base::FilePath input_path(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[0]));
+  const base::FilePath output_path(
+      ToolSupport::CommandLineArgumentToFilePathStringType(argv[1]));
+  return RepackMinidump(input_path, output_path, options) ? EXIT_SUCCESS
+                                                          : EXIT_FAILURE;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+#if BUILDFLAG(IS_POSIX)
+int main(int argc, char* argv[]) {
+  return crashpad::RepackMinidumpMain(argc, argv);
+}
+#elif BUILDFLAG(IS_WIN)
+int wmain(int argc, wchar_t* argv[]) {
+  return crashpad::ToolSupport::Wmain(argc, argv, crashpad::RepackMinidumpMain);
+}
+#endif  // BUILDFLAG(IS_POSIX)
@@ -0,0 +1,109 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_reader.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/numerics/safe_conversions.h"
+
+namespace crashpad {
+
+BufferedFileReader::BufferedFileReader(FileReaderInterface* file_reader,
+                                       size_t buffer_size)
+    : buffer_(buffer_size),
+      file_reader_(file_reader),
+      buffer_offset_(-1),
+      buffer_valid_(0),
+      buffer_position_(0) {
+  DCHECK_GT(buffer_size, 0u);
+}
+
+BufferedFileReader::~BufferedFileReader() {}
+
+FileOperationResult BufferedFileReader::Read(void* data, size_t size) {
+  base::checked_cast<FileOperationResult>(size);
+
+  if (buffer_position_ == buffer_valid_ && size > 0) {
+    const FileOffset underlying_offset =
+        buffer_offset_ < 0
+            ? -1
+            : buffer_offset_ + static_cast<FileOffset>(buffer_valid_);
+
+    if (size >= buffer_.size()) {
+      const FileOperationResult rv = file_reader_->Read(data, size);
+      if (rv < 0) {
+        return rv;
+      }
+      buffer_offset_ = underlying_offset < 0 ? -1 : underlying_offset + rv;
+      buffer_valid_ = 0;
+      buffer_position_ = 0;
+      return rv;
+    }
+
+    const FileOperationResult rv =
+        file_reader_->Read(buffer_.data(), buffer_.size());
+    if (rv < 0) {
+      return rv;
+    }
+    buffer_offset_ = underlying_offset;
+    buffer_valid_ = rv;
+    buffer_position_ = 0;
+  }
+
+  // A read extending past the buffered data is short rather than refilling the
+  // buffer. ReadExactly() will call back for the rest.
+  const size_t copy = std::min(size, buffer_valid_ - buffer_position_);
+  std::copy(buffer_.begin() + buffer_position_,
+            buffer_.begin() + buffer_position_ + copy,
+            static_cast<uint8_t*>(data));
+  buffer_position_ += copy;
+  return copy;
+}
+
+FileOffset BufferedFileReader::Seek(FileOffset offset, int whence) {
+  if (buffer_offset_ >= 0 && whence != SEEK_END) {
+    const FileOffset target =
+        whence == SEEK_SET
+            ? offset
+            : buffer_offset_ + static_cast<FileOffset>(buffer_position_) +
+                  offset;
+    if (target >= buffer_offset_ &&
+        target - buffer_offset_ <= static_cast<FileOffset>(buffer_valid_)) {
+      buffer_position_ = static_cast<size_t>(target - buffer_offset_);
+      return target;
+    }
+  }
+
+  // The underlying reader is ahead of this reader’s position by the unread
+  // buffered data.
+  if (whence == SEEK_CUR) {
+    offset -= static_cast<FileOffset>(buffer_valid_ - buffer_position_);
+  }
+
+  const FileOffset rv = file_reader_->Seek(offset, whence);
+  if (rv < 0) {
+    return rv;
+  }
+
+  buffer_offset_ = rv;
+  buffer_valid_ = 0;
+  buffer_position_ = 0;
+  return rv;
+}
+
+}  // namespace crashpad
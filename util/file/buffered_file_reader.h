@@ -0,0 +1,83 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_BUFFERED_FILE_READER_H_
+#define CRASHPAD_UTIL_FILE_BUFFERED_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/file/file_reader.h"
+
+namespace crashpad {
+
+//! \brief A file reader that reads ahead from another reader.
+//!
+//! Reads smaller than the buffer are satisfied from a buffer that is refilled
+//! from the underlying reader with a single read of the buffer’s size. Reads at
+//! least as large as the buffer pass through directly once the buffer is
+//! drained. Seeks that land within the buffered data are satisfied without
+//! seeking the underlying reader, and other seeks discard the buffer. This
+//! turns the many small reads made while parsing a minidump, such as the fixed
+//! size headers and descriptors of each stream, into few large reads.
+//!
+//! The position of the underlying reader is unspecified while this object is
+//! in use. It must not be read from or seeked directly until this object is no
+//! longer in use.
+class BufferedFileReader final : public FileReaderInterface {
+ public:
+  //! \brief The default size of the buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \param[in] file_reader The reader to read from.
+  //! \param[in] buffer_size The number of bytes to read ahead from
+  //!     \a file_reader.
+  explicit BufferedFileReader(FileReaderInterface* file_reader,
+                              size_t buffer_size = kDefaultBufferSize);
+
+  BufferedFileReader(const BufferedFileReader&) = delete;
+  BufferedFileReader& operator=(const BufferedFileReader&) = delete;
+
+  ~BufferedFileReader() override;
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileSeekerInterface:
+
+  //! \copydoc FileReaderInterface::Seek()
+  //!
+  //! Seeks relative to the end of the file always seek the underlying reader.
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  std::vector<uint8_t> buffer_;
+  FileReaderInterface* file_reader_;  // weak
+
+  // The offset in the file of buffer_[0], or -1 if not yet known. The
+  // underlying reader is positioned at buffer_offset_ + buffer_valid_.
+  FileOffset buffer_offset_;
+
+  // The number of bytes of buffer_ holding file data.
+  size_t buffer_valid_;
+
+  // The index in buffer_ of the next byte to be returned by Read().
+  size_t buffer_position_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_BUFFERED_FILE_READER_H_
@@ -0,0 +1,183 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/buffered_file_reader.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Reads from a StringFile, counting the reads and seeks made.
+class CountingFileReader : public FileReaderInterface {
+ public:
+  explicit CountingFileReader(const std::string& contents)
+      : string_file_(), reads_(0), seeks_(0) {
+    string_file_.SetString(contents);
+  }
+
+  CountingFileReader(const CountingFileReader&) = delete;
+  CountingFileReader& operator=(const CountingFileReader&) = delete;
+
+  ~CountingFileReader() override = default;
+
+  size_t reads() const { return reads_; }
+  size_t seeks() const { return seeks_; }
+
+  // FileReaderInterface:
+
+  FileOperationResult Read(void* data, size_t size) override {
+    ++reads_;
+    return string_file_.Read(data, size);
+  }
+
+  // FileSeekerInterface:
+
+  FileOffset Seek(FileOffset offset, int whence) override {
+    ++seeks_;
+    return string_file_.Seek(offset, whence);
+  }
+
+ private:
+  StringFile string_file_;
+  size_t reads_;
+  size_t seeks_;
+};
+
+std::string TestContents(size_t size) {
+  std::string contents(size, '\0');
+  for (size_t index = 0; index < size; ++index) {
+    contents[index] = static_cast<char>('a' + index % 26);
+  }
+  return contents;
+}
+
+TEST(BufferedFileReader, CombinesSmallReads) {
+  const std::string contents = TestContents(100);
+  CountingFileReader counting_reader(contents);
+  BufferedFileReader reader(&counting_reader, 64);
+
+  std::string read;
+  char data[5];
+  for (size_t index = 0; index < contents.size() / sizeof(data); ++index) {
+    ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+    read.append(data, sizeof(data));
+  }
+  EXPECT_EQ(read, contents);
+  EXPECT_EQ(counting_reader.reads(), 2u);
+
+  EXPECT_EQ(reader.Read(data, sizeof(data)), 0);
+  EXPECT_FALSE(reader.ReadExactly(data, sizeof(data)));
+}
+
+TEST(BufferedFileReader, ReadsAcrossBufferBoundary) {
+  const std::string contents = TestContents(100);
+  CountingFileReader counting_reader(contents);
+  BufferedFileReader reader(&counting_reader, 16);
+
+  char data[10];
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(0, 10));
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(10, 10));
+  EXPECT_EQ(counting_reader.reads(), 2u);
+}
+
+TEST(BufferedFileReader, LargeReadsPassThrough) {
+  const std::string contents = TestContents(100);
+  CountingFileReader counting_reader(contents);
+  BufferedFileReader reader(&counting_reader, 16);
+
+  char small[4];
+  ASSERT_TRUE(reader.ReadExactly(small, sizeof(small)));
+  EXPECT_EQ(std::string(small, sizeof(small)), contents.substr(0, 4));
+  EXPECT_EQ(counting_reader.reads(), 1u);
+
+  // The rest of the buffer is drained first, then the remainder passes
+  // through in a single read.
+  char large[40];
+  ASSERT_TRUE(reader.ReadExactly(large, sizeof(large)));
+  EXPECT_EQ(std::string(large, sizeof(large)), contents.substr(4, 40));
+  EXPECT_EQ(counting_reader.reads(), 2u);
+
+  ASSERT_TRUE(reader.ReadExactly(small, sizeof(small)));
+  EXPECT_EQ(std::string(small, sizeof(small)), contents.substr(44, 4));
+  EXPECT_EQ(counting_reader.reads(), 3u);
+}
+
+TEST(BufferedFileReader, SeekWithinBuffer) {
+  const std::string contents = TestContents(100);
+  CountingFileReader counting_reader(contents);
+  BufferedFileReader reader(&counting_reader, 32);
+
+  EXPECT_EQ(reader.SeekGet(), 0);
+  EXPECT_EQ(counting_reader.seeks(), 1u);
+
+  char data[4];
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(counting_reader.reads(), 1u);
+
+  ASSERT_TRUE(reader.SeekSet(20));
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(20, 4));
+
+  ASSERT_TRUE(reader.SeekSet(2));
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(2, 4));
+
+  EXPECT_EQ(reader.Seek(4, SEEK_CUR), 10);
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(10, 4));
+
+  EXPECT_EQ(reader.SeekGet(), 14);
+  EXPECT_EQ(counting_reader.reads(), 1u);
+  EXPECT_EQ(counting_reader.seeks(), 1u);
+}
+
+TEST(BufferedFileReader, SeekOutsideBuffer) {
+  const std::string contents = TestContents(100);
+  CountingFileReader counting_reader(contents);
+  BufferedFileReader reader(&counting_reader, 16);
+
+  char data[4];
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+
+  // With the position not yet known, a relative seek must account for the
+  // data buffered ahead of it.
+  EXPECT_EQ(reader.Seek(36, SEEK_CUR), 40);
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(40, 4));
+
+  ASSERT_TRUE(reader.SeekSet(70));
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(70, 4));
+
+  EXPECT_EQ(reader.Seek(-4, SEEK_END), 96);
+  ASSERT_TRUE(reader.ReadExactly(data, sizeof(data)));
+  EXPECT_EQ(std::string(data, sizeof(data)), contents.substr(96, 4));
+  EXPECT_EQ(reader.SeekGet(), 100);
+
+  EXPECT_EQ(counting_reader.reads(), 4u);
+  EXPECT_EQ(counting_reader.seeks(), 3u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
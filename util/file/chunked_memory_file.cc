@@ -0,0 +1,248 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/chunked_memory_file.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+ChunkedMemoryFile::ChunkedMemoryFile()
+    : chunks_(), capacity_(0), size_(0), offset_(0) {}
+
+ChunkedMemoryFile::~ChunkedMemoryFile() = default;
+
+std::string ChunkedMemoryFile::ToString() const {
+  std::string string;
+  string.reserve(size_);
+  for (const Chunk& chunk : chunks_) {
+    if (chunk.offset >= size_) {
+      break;
+    }
+    string.append(chunk.data.get(), std::min(chunk.size, size_ - chunk.offset));
+  }
+  return string;
+}
+
+bool ChunkedMemoryFile::WriteTo(FileWriterInterface* writer) const {
+  for (const Chunk& chunk : chunks_) {
+    if (chunk.offset >= size_) {
+      break;
+    }
+    if (!writer->Write(chunk.data.get(),
+                       std::min(chunk.size, size_ - chunk.offset))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ChunkedMemoryFile::Reset() {
+  chunks_.clear();
+  capacity_ = 0;
+  size_ = 0;
+  offset_ = 0;
+}
+
+FileOperationResult ChunkedMemoryFile::Read(void* data, size_t size) {
+  DCHECK(offset_.IsValid());
+
+  const size_t offset = offset_.ValueOrDie();
+  if (offset >= size_) {
+    return 0;
+  }
+
+  const size_t nread = std::min(size, size_ - offset);
+
+  base::CheckedNumeric<FileOperationResult> new_offset = offset_;
+  new_offset += nread;
+  if (!new_offset.IsValid()) {
+    LOG(ERROR) << "Read(): file too large";
+    return -1;
+  }
+
+  char* destination = reinterpret_cast<char*>(data);
+  size_t position = offset;
+  size_t remaining = nread;
+  while (remaining) {
+    size_t available;
+    const char* source = ChunkData(position, &available);
+    const size_t length = std::min(available, remaining);
+    memcpy(destination, source, length);
+    destination += length;
+    position += length;
+    remaining -= length;
+  }
+  offset_ = new_offset;
+
+  return nread;
+}
+
+bool ChunkedMemoryFile::Write(const void* data, size_t size) {
+  DCHECK(offset_.IsValid());
+
+  const size_t offset = offset_.ValueOrDie();
+
+  base::CheckedNumeric<FileOperationResult> new_offset = offset_;
+  new_offset += size;
+  if (!new_offset.IsValid()) {
+    LOG(ERROR) << "Write(): file too large";
+    return false;
+  }
+
+  const size_t end = offset + size;
+  Reserve(end);
+
+  // Writing past the end of the file leaves a hole, which reads as zeroes.
+  size_t position = size_;
+  while (position < offset) {
+    size_t available;
+    char* destination = ChunkData(position, &available);
+    const size_t length = std::min(available, offset - position);
+    memset(destination, 0, length);
+    position += length;
+  }
+
+  const char* source = reinterpret_cast<const char*>(data);
+  position = offset;
+  while (position < end) {
+    size_t available;
+    char* destination = ChunkData(position, &available);
+    const size_t length = std::min(available, end - position);
+    memcpy(destination, source, length);
+    source += length;
+    position += length;
+  }
+
+  size_ = std::max(size_, end);
+  offset_ = end;
+
+  return true;
+}
+
+bool ChunkedMemoryFile::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  DCHECK(offset_.IsValid());
+
+  if (iovecs->empty()) {
+    LOG(ERROR) << "WriteIoVec(): no iovecs";
+    return false;
+  }
+
+  // Avoid writing anything at all if it would cause an overflow.
+  base::CheckedNumeric<FileOperationResult> new_offset = offset_;
+  for (const WritableIoVec& iov : *iovecs) {
+    new_offset += iov.iov_len;
+    if (!new_offset.IsValid()) {
+      LOG(ERROR) << "WriteIoVec(): file too large";
+      return false;
+    }
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+
+#ifndef NDEBUG
+  // The interface says that |iovecs| is not sacred, so scramble it to make sure
+  // that nobody depends on it.
+  memset(&(*iovecs)[0], 0xa5, sizeof((*iovecs)[0]) * iovecs->size());
+#endif
+
+  return true;
+}
+
+FileOffset ChunkedMemoryFile::Seek(FileOffset offset, int whence) {
+  DCHECK(offset_.IsValid());
+
+  size_t base_offset;
+
+  switch (whence) {
+    case SEEK_SET:
+      base_offset = 0;
+      break;
+
+    case SEEK_CUR:
+      base_offset = offset_.ValueOrDie();
+      break;
+
+    case SEEK_END:
+      base_offset = size_;
+      break;
+
+    default:
+      LOG(ERROR) << "Seek(): invalid whence " << whence;
+      return -1;
+  }
+
+  FileOffset base_offset_fileoffset;
+  if (!AssignIfInRange(&base_offset_fileoffset, base_offset)) {
+    LOG(ERROR) << "Seek(): base_offset " << base_offset
+               << " invalid for FileOffset";
+    return -1;
+  }
+  base::CheckedNumeric<FileOffset> new_offset(base_offset_fileoffset);
+  new_offset += offset;
+  if (!new_offset.IsValid()) {
+    LOG(ERROR) << "Seek(): new_offset invalid";
+    return -1;
+  }
+  size_t new_offset_sizet;
+  if (!new_offset.AssignIfValid(&new_offset_sizet)) {
+    LOG(ERROR) << "Seek(): new_offset " << new_offset.ValueOrDie()
+               << " invalid for size_t";
+    return -1;
+  }
+
+  offset_ = new_offset_sizet;
+
+  return base::ValueOrDieForType<FileOffset>(offset_);
+}
+
+char* ChunkedMemoryFile::ChunkData(size_t offset, size_t* available) const {
+  DCHECK_LT(offset, capacity_);
+
+  // Find the last chunk starting at or before offset.
+  auto chunk = std::upper_bound(
+      chunks_.begin(),
+      chunks_.end(),
+      offset,
+      [](size_t offset, const Chunk& chunk) { return offset < chunk.offset; });
+  DCHECK(chunk != chunks_.begin());
+  --chunk;
+
+  const size_t chunk_offset = offset - chunk->offset;
+  *available = chunk->size - chunk_offset;
+  return chunk->data.get() + chunk_offset;
+}
+
+void ChunkedMemoryFile::Reserve(size_t capacity) {
+  while (capacity_ < capacity) {
+    const size_t chunk_size =
+        std::clamp(capacity_, kMinChunkSize, kMaxChunkSize);
+    chunks_.push_back({std::unique_ptr<char[]>(new char[chunk_size]),
+                       capacity_,
+                       chunk_size});
+    capacity_ += chunk_size;
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,116 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_CHUNKED_MEMORY_FILE_H_
+#define CRASHPAD_UTIL_FILE_CHUNKED_MEMORY_FILE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/numerics/safe_math.h"
+#include "util/file/file_io.h"
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief A file reader and writer backed by a list of buffers in memory.
+//!
+//! Like StringFile, this presents a virtual file in memory to code that
+//! expects to read or write files. Rather than keeping the contents in a
+//! single contiguous buffer, which must be reallocated and copied as the file
+//! grows, the contents are kept in chunks that are never moved once allocated.
+//! Appending to the file is amortized constant time, and a file of any size
+//! occupies little more memory than its contents. This suits large files
+//! built up in memory, such as minidumps and decompressed crash reports.
+//!
+//! Chunks start at kMinChunkSize bytes, and each new chunk is as large as the
+//! file’s capacity so far, up to kMaxChunkSize bytes.
+class ChunkedMemoryFile : public FileReaderInterface,
+                          public FileWriterInterface {
+ public:
+  //! \brief The size of the first chunk allocated.
+  static constexpr size_t kMinChunkSize = 4096;
+
+  //! \brief The size beyond which chunks don’t grow.
+  static constexpr size_t kMaxChunkSize = 1024 * 1024;
+
+  ChunkedMemoryFile();
+
+  ChunkedMemoryFile(const ChunkedMemoryFile&) = delete;
+  ChunkedMemoryFile& operator=(const ChunkedMemoryFile&) = delete;
+
+  ~ChunkedMemoryFile() override;
+
+  //! \brief Returns the size of the virtual file’s contents.
+  size_t size() const { return size_; }
+
+  //! \brief Returns a copy of the virtual file’s contents.
+  //!
+  //! This is intended for tests. Use WriteTo() to pass the contents on without
+  //! making a contiguous copy.
+  std::string ToString() const;
+
+  //! \brief Writes the virtual file’s contents to \a writer, one chunk at a
+  //!     time.
+  //!
+  //! The file position of this object is unchanged.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged.
+  bool WriteTo(FileWriterInterface* writer) const;
+
+  //! \brief Resets the virtual file’s contents to be empty, releasing its
+  //!     memory, and resets its file position to `0`.
+  void Reset();
+
+  // FileReaderInterface:
+  FileOperationResult Read(void* data, size_t size) override;
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  // FileSeekerInterface:
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    size_t offset;
+    size_t size;
+  };
+
+  // Returns the address of the byte at offset, which must be less than
+  // capacity_, and sets *available to the number of contiguous bytes from
+  // there to the end of its chunk.
+  char* ChunkData(size_t offset, size_t* available) const;
+
+  // Allocates chunks until capacity_ is at least capacity.
+  void Reserve(size_t capacity);
+
+  std::vector<Chunk> chunks_;
+  size_t capacity_;
+  size_t size_;
+
+  // Stored as a size_t to match size_, as in StringFile.
+  base::CheckedNumeric<size_t> offset_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_CHUNKED_MEMORY_FILE_H_
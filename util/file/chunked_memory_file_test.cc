@@ -0,0 +1,169 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/chunked_memory_file.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ChunkedMemoryFile, EmptyFile) {
+  ChunkedMemoryFile file;
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+  EXPECT_TRUE(file.Write("", 0));
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+
+  char c = '6';
+  EXPECT_EQ(file.Read(&c, 1), 0);
+  EXPECT_EQ(c, '6');
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+
+  EXPECT_TRUE(file.ToString().empty());
+}
+
+TEST(ChunkedMemoryFile, OneByteFile) {
+  ChunkedMemoryFile file;
+
+  EXPECT_TRUE(file.Write("a", 1));
+  EXPECT_EQ(file.size(), 1u);
+  EXPECT_EQ(file.ToString(), "a");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 1);
+  EXPECT_EQ(file.Seek(0, SEEK_SET), 0);
+  char c = '6';
+  EXPECT_EQ(file.Read(&c, 1), 1);
+  EXPECT_EQ(c, 'a');
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 1);
+  EXPECT_EQ(file.Read(&c, 1), 0);
+  EXPECT_EQ(c, 'a');
+
+  EXPECT_EQ(file.Seek(0, SEEK_SET), 0);
+  EXPECT_TRUE(file.Write("b", 1));
+  EXPECT_EQ(file.size(), 1u);
+  EXPECT_EQ(file.ToString(), "b");
+}
+
+TEST(ChunkedMemoryFile, SpansChunks) {
+  // Write enough, in pieces that don’t line up with chunk boundaries, for the
+  // file to grow through many chunks, including several of kMaxChunkSize.
+  std::string expected;
+  ChunkedMemoryFile file;
+  uint8_t value = 0;
+  while (expected.size() < 4 * ChunkedMemoryFile::kMaxChunkSize) {
+    std::string piece(1021, '\0');
+    for (char& c : piece) {
+      c = static_cast<char>(value++);
+    }
+    ASSERT_TRUE(file.Write(piece.data(), piece.size()));
+    expected.append(piece);
+  }
+  EXPECT_EQ(file.size(), expected.size());
+  EXPECT_EQ(file.Seek(0, SEEK_END),
+            static_cast<FileOffset>(expected.size()));
+  EXPECT_EQ(file.ToString(), expected);
+
+  // Read back across a chunk boundary.
+  const FileOffset boundary = ChunkedMemoryFile::kMinChunkSize * 3;
+  ASSERT_EQ(file.Seek(boundary - 10, SEEK_SET), boundary - 10);
+  char buf[20];
+  ASSERT_EQ(file.Read(buf, sizeof(buf)), 20);
+  EXPECT_EQ(memcmp(buf, &expected[boundary - 10], sizeof(buf)), 0);
+
+  // Overwrite across the same boundary.
+  ASSERT_EQ(file.Seek(boundary - 3, SEEK_SET), boundary - 3);
+  ASSERT_TRUE(file.Write("abcdef", 6));
+  expected.replace(boundary - 3, 6, "abcdef");
+  EXPECT_EQ(file.size(), expected.size());
+  EXPECT_EQ(file.ToString(), expected);
+
+  // A read past the end returns what’s left.
+  ASSERT_EQ(file.Seek(-5, SEEK_END),
+            static_cast<FileOffset>(expected.size() - 5));
+  ASSERT_EQ(file.Read(buf, sizeof(buf)), 5);
+  EXPECT_EQ(memcmp(buf, &expected[expected.size() - 5], 5), 0);
+
+  StringFile string_file;
+  EXPECT_TRUE(file.WriteTo(&string_file));
+  EXPECT_EQ(string_file.string(), expected);
+
+  file.Reset();
+  EXPECT_EQ(file.size(), 0u);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+  EXPECT_TRUE(file.ToString().empty());
+}
+
+TEST(ChunkedMemoryFile, WritePastEnd) {
+  ChunkedMemoryFile file;
+  ASSERT_TRUE(file.Write("abc", 3));
+
+  const FileOffset hole_end = ChunkedMemoryFile::kMinChunkSize + 100;
+  ASSERT_EQ(file.Seek(hole_end, SEEK_SET), hole_end);
+  EXPECT_EQ(file.size(), 3u);
+  ASSERT_TRUE(file.Write("xyz", 3));
+
+  std::string expected("abc");
+  expected.resize(hole_end);
+  expected.append("xyz");
+  EXPECT_EQ(file.size(), expected.size());
+  EXPECT_EQ(file.ToString(), expected);
+
+  // A zero-length write past the end extends the file, as with StringFile.
+  ASSERT_EQ(file.Seek(10, SEEK_END), hole_end + 13);
+  ASSERT_TRUE(file.Write("", 0));
+  expected.resize(expected.size() + 10);
+  EXPECT_EQ(file.ToString(), expected);
+}
+
+TEST(ChunkedMemoryFile, WriteIoVec) {
+  ChunkedMemoryFile file;
+  std::vector<WritableIoVec> iovecs;
+  WritableIoVec iov;
+  iov.iov_base = "";
+  iov.iov_len = 0;
+  iovecs.push_back(iov);
+  EXPECT_TRUE(file.WriteIoVec(&iovecs));
+  EXPECT_EQ(file.size(), 0u);
+
+  iovecs.clear();
+  iov.iov_base = "a";
+  iov.iov_len = 1;
+  iovecs.push_back(iov);
+  iov.iov_base = "bc";
+  iov.iov_len = 2;
+  iovecs.push_back(iov);
+  EXPECT_TRUE(file.WriteIoVec(&iovecs));
+  EXPECT_EQ(file.ToString(), "abc");
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 3);
+}
+
+TEST(ChunkedMemoryFile, BadSeek) {
+  ChunkedMemoryFile file;
+  EXPECT_LT(file.Seek(0, -37), 0);
+  EXPECT_LT(file.Seek(-1, SEEK_SET), 0);
+  EXPECT_EQ(file.Seek(0, SEEK_CUR), 0);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,29 +14,42 @@
 
 #include "util/file/delimited_file_reader.h"
 
+#include <string.h>
 #include <sys/types.h>
 
-#include <algorithm>
-#include <iterator>
-#include <limits>
-
 #include "base/check_op.h"
-#include "base/numerics/safe_conversions.h"
 
 namespace crashpad {
 
-DelimitedFileReader::DelimitedFileReader(FileReaderInterface* file_reader)
-    : file_reader_(file_reader), buf_pos_(0), buf_len_(0), eof_(false) {
-  static_assert(sizeof(buf_) <= std::numeric_limits<decltype(buf_pos_)>::max(),
-                "buf_pos_ must cover buf_");
-  static_assert(sizeof(buf_) <= std::numeric_limits<decltype(buf_len_)>::max(),
-                "buf_len_ must cover buf_");
+DelimitedFileReader::DelimitedFileReader(FileReaderInterface* file_reader,
+                                         size_t buffer_size)
+    : buf_(buffer_size),
+      file_reader_(file_reader),
+      buf_pos_(0),
+      buf_len_(0),
+      eof_(false) {
+  DCHECK_GT(buffer_size, 0u);
 }
 
 DelimitedFileReader::~DelimitedFileReader() {}
 
 DelimitedFileReader::Result DelimitedFileReader::GetDelim(char delimiter,
                                                           std::string* field) {
+  std::string_view view;
+  const Result result = GetDelimView(delimiter, &view);
+  if (result == Result::kSuccess) {
+    field->assign(view.data(), view.size());
+  }
+  return result;
+}
+
+DelimitedFileReader::Result DelimitedFileReader::GetLine(std::string* line) {
+  return GetDelim('\n', line);
+}
+
+DelimitedFileReader::Result DelimitedFileReader::GetDelimView(
+    char delimiter,
+    std::string_view* field) {
   if (eof_) {
     DCHECK_EQ(buf_pos_, buf_len_);
 
@@ -48,63 +61,67 @@ DelimitedFileReader::Result DelimitedFileReader::GetDelim(char delimiter,
     return Result::kEndOfFile;
   }
 
-  std::string local_field;
+  // The index into buf_ from which the delimiter hasn’t yet been searched for.
+  size_t scan_pos = buf_pos_;
   while (true) {
-    if (buf_pos_ == buf_len_) {
-      // buf_ is empty. Refill it.
-      FileOperationResult read_result = file_reader_->Read(buf_, sizeof(buf_));
-      if (read_result < 0) {
-        return Result::kError;
-      } else if (read_result == 0) {
-        if (!local_field.empty()) {
-          // The file ended with a field that wasn’t terminated by a delimiter
-          // character.
-          //
-          // This is EOF, but EOF can’t be returned because there’s a field that
-          // needs to be returned to the caller. Cache the detected EOF so it
-          // can be returned next time. This is done to support proper semantics
-          // for weird “files” like terminal input that can reach EOF and then
-          // “grow”, allowing subsequent reads past EOF to block while waiting
-          // for more data. Once EOF is detected by a read that returns 0, that
-          // EOF signal should propagate to the caller before attempting a new
-          // read. Here, it will be returned on the next call to this method
-          // without attempting to read more data.
-          eof_ = true;
-          field->swap(local_field);
-          return Result::kSuccess;
-        }
-        return Result::kEndOfFile;
-      }
+    DCHECK_LE(scan_pos, buf_len_);
+    const char* const found = static_cast<const char*>(
+        memchr(buf_.data() + scan_pos, delimiter, buf_len_ - scan_pos));
+    if (found) {
+      // A real delimiter character was found. Return the field including it.
+      const size_t field_end = found - buf_.data() + 1;
+      *field = std::string_view(buf_.data() + buf_pos_, field_end - buf_pos_);
+      buf_pos_ = field_end;
+      return Result::kSuccess;
+    }
 
-      DCHECK_LE(static_cast<size_t>(read_result), std::size(buf_));
-      DCHECK(
-          base::IsValueInRangeForNumericType<decltype(buf_len_)>(read_result));
-      buf_len_ = static_cast<decltype(buf_len_)>(read_result);
+    // The field continues past the data in buf_. Move what’s been seen of it
+    // to the front of buf_, growing buf_ if the field fills it, and read more.
+    if (buf_pos_ > 0) {
+      memmove(buf_.data(), buf_.data() + buf_pos_, buf_len_ - buf_pos_);
+      buf_len_ -= buf_pos_;
       buf_pos_ = 0;
     }
-
-    const char* const start = buf_ + buf_pos_;
-    const char* const end = buf_ + buf_len_;
-    const char* const found = std::find(start, end, delimiter);
-
-    local_field.append(start, found);
-    buf_pos_ = static_cast<decltype(buf_pos_)>(found - buf_);
-    DCHECK_LE(buf_pos_, buf_len_);
-
-    if (found != end) {
-      // A real delimiter character was found. Append it to the field being
-      // built and return it.
-      local_field.push_back(delimiter);
-      ++buf_pos_;
-      DCHECK_LE(buf_pos_, buf_len_);
-      field->swap(local_field);
-      return Result::kSuccess;
+    if (buf_len_ == buf_.size()) {
+      buf_.resize(buf_.size() * 2);
     }
+    scan_pos = buf_len_;
+
+    FileOperationResult read_result =
+        file_reader_->Read(buf_.data() + buf_len_, buf_.size() - buf_len_);
+    if (read_result < 0) {
+      return Result::kError;
+    } else if (read_result == 0) {
+      if (buf_len_ != buf_pos_) {
+        // The file ended with a field that wasn’t terminated by a delimiter
+        // character.
+        //
+        // This is EOF, but EOF can’t be returned because there’s a field that
+        // needs to be returned to the caller. Cache the detected EOF so it can
+        // be returned next time. This is done to support proper semantics for
+        // weird “files” like terminal input that can reach EOF and then
+        // “grow”, allowing subsequent reads past EOF to block while waiting for
+        // more data. Once EOF is detected by a read that returns 0, that EOF
+        // signal should propagate to the caller before attempting a new read.
+        // Here, it will be returned on the next call to this method without
+        // attempting to read more data.
+        eof_ = true;
+        *field =
+            std::string_view(buf_.data() + buf_pos_, buf_len_ - buf_pos_);
+        buf_pos_ = buf_len_;
+        return Result::kSuccess;
+      }
+      return Result::kEndOfFile;
+    }
+
+    DCHECK_LE(static_cast<size_t>(read_result), buf_.size() - buf_len_);
+    buf_len_ += static_cast<size_t>(read_result);
   }
 }
 
-DelimitedFileReader::Result DelimitedFileReader::GetLine(std::string* line) {
-  return GetDelim('\n', line);
+DelimitedFileReader::Result DelimitedFileReader::GetLineView(
+    std::string_view* line) {
+  return GetDelimView('\n', line);
 }
 
 }  // namespace crashpad
@@ -15,9 +15,11 @@
 #ifndef CRASHPAD_UTIL_FILE_DELIMITED_FILE_READER_H_
 #define CRASHPAD_UTIL_FILE_DELIMITED_FILE_READER_H_
 
-#include <stdint.h>
+#include <stddef.h>
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "util/file/file_reader.h"
 
@@ -29,8 +31,8 @@ namespace crashpad {
 //! characters. When the delimiter character is the newline character
 //! (<code>'\\n'</code>), the file is interpreted as a series of lines.
 //!
-//! It is safe to mix GetDelim() and GetLine() calls, if appropriate for the
-//! format being interpreted.
+//! It is safe to mix GetDelim(), GetLine(), and their view-returning variants,
+//! if appropriate for the format being interpreted.
 //!
 //! This is a replacement for the standard library’s `getdelim()` and
 //! `getline()` functions, adapted to work with FileReaderInterface objects
@@ -49,7 +51,14 @@ class DelimitedFileReader {
     kEndOfFile,
   };
 
-  explicit DelimitedFileReader(FileReaderInterface* file_reader);
+  //! \brief The default size of the buffer.
+  static constexpr size_t kDefaultBufferSize = 16 * 1024;
+
+  //! \param[in] file_reader The reader to read from.
+  //! \param[in] buffer_size The number of bytes to request from \a file_reader
+  //!     at once. The buffer grows to hold any field longer than this.
+  explicit DelimitedFileReader(FileReaderInterface* file_reader,
+                               size_t buffer_size = kDefaultBufferSize);
 
   DelimitedFileReader(const DelimitedFileReader&) = delete;
   DelimitedFileReader& operator=(const DelimitedFileReader&) = delete;
@@ -81,11 +90,23 @@ class DelimitedFileReader {
   //!     returned.
   Result GetLine(std::string* line);
 
+  //! \brief Reads a single field from the file without copying it.
+  //!
+  //! This behaves as GetDelim(), but \a field refers to this object’s buffer.
+  //! It remains valid only until the next call to any method of this object.
+  Result GetDelimView(char delimiter, std::string_view* field);
+
+  //! \brief Reads a single line from the file without copying it.
+  //!
+  //! This behaves as GetLine(), but \a line refers to this object’s buffer. It
+  //! remains valid only until the next call to any method of this object.
+  Result GetLineView(std::string_view* line);
+
  private:
-  char buf_[4096];
+  std::vector<char> buf_;
   FileReaderInterface* file_reader_;  // weak
-  uint16_t buf_pos_;  // Index into buf_ of the start of the next field.
-  uint16_t buf_len_;  // The size of buf_ that’s been filled.
+  size_t buf_pos_;  // Index into buf_ of the start of the next field.
+  size_t buf_len_;  // The size of buf_ that’s been filled.
   bool eof_;  // Caches the EOF signal when detected following a partial field.
 };
 
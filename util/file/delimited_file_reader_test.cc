@@ -15,6 +15,8 @@
 #include "util/file/delimited_file_reader.h"
 
 #include <iterator>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/format_macros.h"
@@ -212,7 +214,9 @@ TEST(DelimitedFileReader, LongOneLineFile) {
             DelimitedFileReader::Result::kEndOfFile);
 }
 
-void TestLongMultiLineFile(int base_length) {
+void TestLongMultiLineFile(int base_length,
+                           size_t buffer_size =
+                               DelimitedFileReader::kDefaultBufferSize) {
   std::vector<std::string> lines;
   std::string contents;
   for (size_t line_index = 0; line_index <= 'z' - 'a'; ++line_index) {
@@ -232,7 +236,7 @@ void TestLongMultiLineFile(int base_length) {
 
   StringFile string_file;
   string_file.SetString(contents);
-  DelimitedFileReader delimited_file_reader(&string_file);
+  DelimitedFileReader delimited_file_reader(&string_file, buffer_size);
 
   std::string line;
   for (size_t line_index = 0; line_index < lines.size(); ++line_index) {
@@ -257,6 +261,11 @@ TEST(DelimitedFileReader, ReallyLongMultiLineFile) {
   TestLongMultiLineFile(5000);
 }
 
+TEST(DelimitedFileReader, LongMultiLineFile_SmallBuffer) {
+  TestLongMultiLineFile(500, 1);
+  TestLongMultiLineFile(500, 7);
+}
+
 TEST(DelimitedFileReader, EmbeddedNUL) {
   static constexpr char kString[] = "embedded\0NUL\n";
   StringFile string_file;
@@ -312,7 +321,7 @@ TEST(DelimitedFileReader, EdgeCases) {
 
     StringFile string_file;
     string_file.SetString(line_0);
-    DelimitedFileReader delimited_file_reader(&string_file);
+    DelimitedFileReader delimited_file_reader(&string_file, 4096);
 
     std::string line;
     ASSERT_EQ(delimited_file_reader.GetLine(&line),
@@ -360,6 +369,34 @@ TEST(DelimitedFileReader, EdgeCases) {
   }
 }
 
+TEST(DelimitedFileReader, Views) {
+  StringFile string_file;
+  string_file.SetString("first line\nsecond,field\nlast");
+  DelimitedFileReader delimited_file_reader(&string_file, 8);
+
+  std::string_view view;
+  ASSERT_EQ(delimited_file_reader.GetLineView(&view),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(view, "first line\n");
+  ASSERT_EQ(delimited_file_reader.GetDelimView(',', &view),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(view, "second,");
+
+  std::string line;
+  ASSERT_EQ(delimited_file_reader.GetLine(&line),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(line, "field\n");
+  ASSERT_EQ(delimited_file_reader.GetLineView(&view),
+            DelimitedFileReader::Result::kSuccess);
+  EXPECT_EQ(view, "last");
+  EXPECT_EQ(delimited_file_reader.GetLineView(&view),
+            DelimitedFileReader::Result::kEndOfFile);
+
+  // The file is still at EOF.
+  EXPECT_EQ(delimited_file_reader.GetLineView(&view),
+            DelimitedFileReader::Result::kEndOfFile);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -15,6 +15,10 @@
 #ifndef CRASHPAD_UTIL_FILE_DIRECTORY_READER_H_
 #define CRASHPAD_UTIL_FILE_DIRECTORY_READER_H_
 
+#include <stddef.h>
+
+#include <vector>
+
 #include "base/files/file_path.h"
 #include "build/build_config.h"
 
@@ -46,6 +50,34 @@ class DirectoryReader {
     kNoMoreFiles,
   };
 
+  //! \brief The type of a directory entry, as recorded in the directory.
+  enum class FileType {
+    //! \brief The directory doesn’t record the type. The caller must examine
+    //!     the entry to learn it.
+    kUnknown,
+
+    //! \brief A regular file.
+    kFile,
+
+    //! \brief A directory.
+    kDirectory,
+
+    //! \brief A symbolic link. The type of its target is not known.
+    kSymbolicLink,
+
+    //! \brief Another type of file, such as a socket or device.
+    kOther,
+  };
+
+  //! \brief A directory entry returned by NextEntries().
+  struct Entry {
+    //! \brief The entry’s name, relative to the directory.
+    base::FilePath name;
+
+    //! \brief The entry’s type.
+    FileType type;
+  };
+
   DirectoryReader();
 
   DirectoryReader(const DirectoryReader&) = delete;
@@ -67,6 +99,33 @@ class DirectoryReader {
   //!     logged.
   Result NextFile(base::FilePath* filename);
 
+  //! \brief Advances the reader to the next file in the directory, also
+  //!     returning the file’s type.
+  //!
+  //! The type is taken from the directory itself, so learning it costs no more
+  //! than learning the name. Callers should only examine the file when \a
+  //! type is FileType::kUnknown, which some filesystems always report.
+  //!
+  //! \param[out] filename The filename of the next file.
+  //! \param[out] type The type of the next file.
+  //! \return a #Result value. \a filename and \a type are only valid when
+  //!     Result::kSuccess is returned. If Result::kError is returned, a
+  //!     message will be logged.
+  Result NextFile(base::FilePath* filename, FileType* type);
+
+  //! \brief Advances the reader past several files in the directory at once.
+  //!
+  //! \param[out] entries The next files in the directory, at most \a
+  //!     max_entries of them, replacing any previous contents.
+  //! \param[in] max_entries The largest number of entries to return. Must be
+  //!     greater than `0`.
+  //! \return Result::kSuccess if at least one entry is returned, even if the
+  //!     end of the directory was reached. Result::kNoMoreFiles if no entries
+  //!     remained. Result::kError, with a message logged, if an error
+  //!     occurred, in which case \a entries holds the entries read before
+  //!     it.
+  Result NextEntries(std::vector<Entry>* entries, size_t max_entries);
+
 #if BUILDFLAG(IS_POSIX) || DOXYGEN
   //! \brief Returns the file descriptor associated with this reader, logging a
   //!     message and returning -1 on error.
@@ -19,7 +19,9 @@
 #include <string.h>
 #include <sys/types.h>
 
-#include "base/check.h"
+#include <utility>
+
+#include "base/check_op.h"
 #include "base/logging.h"
 
 namespace crashpad {
@@ -46,7 +48,32 @@ bool DirectoryReader::Open(const base::FilePath& path) {
   return true;
 }
 
+namespace {
+
+DirectoryReader::FileType FileTypeFromDType(unsigned char d_type) {
+  switch (d_type) {
+    case DT_UNKNOWN:
+      return DirectoryReader::FileType::kUnknown;
+    case DT_REG:
+      return DirectoryReader::FileType::kFile;
+    case DT_DIR:
+      return DirectoryReader::FileType::kDirectory;
+    case DT_LNK:
+      return DirectoryReader::FileType::kSymbolicLink;
+    default:
+      return DirectoryReader::FileType::kOther;
+  }
+}
+
+}  // namespace
+
 DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename) {
+  FileType type;
+  return NextFile(filename, &type);
+}
+
+DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename,
+                                                  FileType* type) {
   DCHECK(dir_.is_valid());
 
   errno = 0;
@@ -61,13 +88,36 @@ DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename) {
   }
 
   if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-    return NextFile(filename);
+    return NextFile(filename, type);
   }
 
   *filename = base::FilePath(entry->d_name);
+  *type = FileTypeFromDType(entry->d_type);
   return Result::kSuccess;
 }
 
+DirectoryReader::Result DirectoryReader::NextEntries(
+    std::vector<Entry>* entries,
+    size_t max_entries) {
+  DCHECK_GT(max_entries, 0u);
+  entries->clear();
+
+  // readdir() already fetches entries from the kernel in large batches, so
+  // this only spares callers the per-entry calls.
+  Entry entry;
+  while (entries->size() < max_entries) {
+    const Result result = NextFile(&entry.name, &entry.type);
+    if (result == Result::kError) {
+      return result;
+    }
+    if (result == Result::kNoMoreFiles) {
+      break;
+    }
+    entries->push_back(std::move(entry));
+  }
+  return entries->empty() ? Result::kNoMoreFiles : Result::kSuccess;
+}
+
 int DirectoryReader::DirectoryFD() {
   DCHECK(dir_.is_valid());
   int rv = dirfd(dir_.get());
@@ -14,7 +14,11 @@
 
 #include "util/file/directory_reader.h"
 
+#include <iterator>
+#include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/strings/stringprintf.h"
@@ -151,6 +155,107 @@ TEST(DirectoryReader, FilesAndDirectories_SymbolicLinks) {
 
 #endif  // !BUILDFLAG(IS_FUCHSIA)
 
+void ExpectFileType(const std::map<base::FilePath, DirectoryReader::FileType>&
+                        types,
+                    const base::FilePath& filename,
+                    DirectoryReader::FileType expected) {
+  SCOPED_TRACE(
+      base::StringPrintf("Filename: %" PRFilePath, filename.value().c_str()));
+  const auto it = types.find(filename);
+  ASSERT_NE(it, types.end());
+
+  // Some filesystems don’t report types while reading directories.
+  if (it->second != DirectoryReader::FileType::kUnknown) {
+    EXPECT_EQ(it->second, expected);
+  }
+}
+
+TEST(DirectoryReader, FileTypes) {
+  ScopedTempDir temp_dir;
+
+  base::FilePath file(FILE_PATH_LITERAL("file"));
+  ASSERT_TRUE(CreateFile(temp_dir.path().Append(file)));
+
+  base::FilePath directory(FILE_PATH_LITERAL("directory"));
+  ASSERT_TRUE(LoggingCreateDirectory(temp_dir.path().Append(directory),
+                                     FilePermissions::kWorldReadable,
+                                     false));
+
+  base::FilePath link(FILE_PATH_LITERAL("link"));
+#if BUILDFLAG(IS_FUCHSIA)
+  constexpr bool symbolic_links = false;
+#else
+  const bool symbolic_links = CanCreateSymbolicLinks();
+#endif
+  if (symbolic_links) {
+    ASSERT_TRUE(CreateSymbolicLink(temp_dir.path().Append(file),
+                                   temp_dir.path().Append(link)));
+  }
+
+  std::map<base::FilePath, DirectoryReader::FileType> types;
+  DirectoryReader reader;
+  ASSERT_TRUE(reader.Open(temp_dir.path()));
+  DirectoryReader::Result result;
+  base::FilePath filename;
+  DirectoryReader::FileType type;
+  while ((result = reader.NextFile(&filename, &type)) ==
+         DirectoryReader::Result::kSuccess) {
+    EXPECT_TRUE(types.insert(std::make_pair(filename, type)).second);
+  }
+  EXPECT_EQ(result, DirectoryReader::Result::kNoMoreFiles);
+
+  EXPECT_EQ(types.size(), symbolic_links ? 3u : 2u);
+  ExpectFileType(types, file, DirectoryReader::FileType::kFile);
+  ExpectFileType(types, directory, DirectoryReader::FileType::kDirectory);
+  if (symbolic_links) {
+    ExpectFileType(types, link, DirectoryReader::FileType::kSymbolicLink);
+  }
+}
+
+TEST(DirectoryReader, NextEntries) {
+  ScopedTempDir temp_dir;
+  std::set<base::FilePath> expected_files;
+
+  static constexpr base::FilePath::CharType const* kFileNames[] = {
+      FILE_PATH_LITERAL("a"),
+      FILE_PATH_LITERAL("b"),
+      FILE_PATH_LITERAL("c"),
+      FILE_PATH_LITERAL("d"),
+      FILE_PATH_LITERAL("e"),
+      FILE_PATH_LITERAL("f"),
+      FILE_PATH_LITERAL("g"),
+  };
+  constexpr size_t kFileCount = std::size(kFileNames);
+  for (const auto* name : kFileNames) {
+    base::FilePath file(name);
+    ASSERT_TRUE(CreateFile(temp_dir.path().Append(file)));
+    EXPECT_TRUE(expected_files.insert(file).second);
+  }
+
+  std::set<base::FilePath> files;
+  DirectoryReader reader;
+  ASSERT_TRUE(reader.Open(temp_dir.path()));
+  constexpr size_t kBatchSize = 3;
+  std::vector<DirectoryReader::Entry> entries;
+  DirectoryReader::Result result;
+  size_t batches = 0;
+  while ((result = reader.NextEntries(&entries, kBatchSize)) ==
+         DirectoryReader::Result::kSuccess) {
+    ++batches;
+    EXPECT_GE(entries.size(), 1u);
+    EXPECT_LE(entries.size(), kBatchSize);
+    for (const auto& entry : entries) {
+      EXPECT_TRUE(files.insert(entry.name).second);
+    }
+  }
+  EXPECT_EQ(result, DirectoryReader::Result::kNoMoreFiles);
+  EXPECT_TRUE(entries.empty());
+  EXPECT_EQ(batches, (kFileCount + kBatchSize - 1) / kBatchSize);
+  EXPECT_EQ(reader.NextEntries(&entries, kBatchSize),
+            DirectoryReader::Result::kNoMoreFiles);
+  ExpectFiles(files, expected_files);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
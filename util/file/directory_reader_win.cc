@@ -16,7 +16,9 @@
 
 #include <string.h>
 
-#include "base/check.h"
+#include <utility>
+
+#include "base/check_op.h"
 #include "base/logging.h"
 
 namespace crashpad {
@@ -49,7 +51,31 @@ bool DirectoryReader::Open(const base::FilePath& path) {
   return true;
 }
 
+namespace {
+
+DirectoryReader::FileType FileTypeFromFindData(const WIN32_FIND_DATA& data) {
+  if ((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) &&
+      data.dwReserved0 == IO_REPARSE_TAG_SYMLINK) {
+    return DirectoryReader::FileType::kSymbolicLink;
+  }
+  if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+    return DirectoryReader::FileType::kDirectory;
+  }
+  if (data.dwFileAttributes & FILE_ATTRIBUTE_DEVICE) {
+    return DirectoryReader::FileType::kOther;
+  }
+  return DirectoryReader::FileType::kFile;
+}
+
+}  // namespace
+
 DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename) {
+  FileType type;
+  return NextFile(filename, &type);
+}
+
+DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename,
+                                                  FileType* type) {
   DCHECK(handle_.is_valid());
 
   if (!first_entry_) {
@@ -67,11 +93,35 @@ DirectoryReader::Result DirectoryReader::NextFile(base::FilePath* filename) {
 
   if (wcscmp(find_data_.cFileName, L".") == 0 ||
       wcscmp(find_data_.cFileName, L"..") == 0) {
-    return NextFile(filename);
+    return NextFile(filename, type);
   }
 
   *filename = base::FilePath(find_data_.cFileName);
+  *type = FileTypeFromFindData(find_data_);
   return Result::kSuccess;
 }
 
+DirectoryReader::Result DirectoryReader::NextEntries(
+    std::vector<Entry>* entries,
+    size_t max_entries) {
+  DCHECK_GT(max_entries, 0u);
+  entries->clear();
+
+  // Open() asks FindFirstFileEx() for FIND_FIRST_EX_LARGE_FETCH, so entries
+  // already arrive from the filesystem in large batches, and this only spares
+  // callers the per-entry calls.
+  Entry entry;
+  while (entries->size() < max_entries) {
+    const Result result = NextFile(&entry.name, &entry.type);
+    if (result == Result::kError) {
+      return result;
+    }
+    if (result == Result::kNoMoreFiles) {
+      break;
+    }
+    entries->push_back(std::move(entry));
+  }
+  return entries->empty() ? Result::kNoMoreFiles : Result::kSuccess;
+}
+
 }  // namespace crashpad
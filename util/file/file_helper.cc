@@ -14,6 +14,11 @@
 
 #include "util/file/file_helper.h"
 
+#include <memory>
+
+#include "util/stream/file_writer_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
+
 namespace crashpad {
 
 void CopyFileContent(FileReaderInterface* file_reader,
@@ -31,4 +36,26 @@ void CopyFileContent(FileReaderInterface* file_reader,
   } while (read_result > 0);
 }
 
+bool DecompressGzipFileContent(FileReaderInterface* file_reader,
+                               FileWriterInterface* file_writer) {
+  ZlibOutputStream decompressor(
+      ZlibOutputStream::Mode::kDecompress,
+      ZlibOutputStream::Format::kGzip,
+      std::make_unique<FileWriterOutputStream>(file_writer));
+
+  uint8_t buf[4096];
+  FileOperationResult read_result;
+  do {
+    read_result = file_reader->Read(buf, sizeof(buf));
+    if (read_result < 0 ||
+        (read_result > 0 && !decompressor.Write(buf, read_result))) {
+      // Flush to satisfy the streams’ expectations before they are destroyed.
+      decompressor.Flush();
+      return false;
+    }
+  } while (read_result > 0);
+
+  return decompressor.Flush();
+}
+
 }  // namespace crashpad
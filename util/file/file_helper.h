@@ -24,6 +24,16 @@ namespace crashpad {
 void CopyFileContent(FileReaderInterface* file_reader,
                      FileWriterInterface* file_writer);
 
+//! \brief Decompresses `gzip`-compressed file content from file_reader to
+//!     file_writer.
+//!
+//! Content consisting of several concatenated `gzip` members is accepted, and
+//! the decompressed members are written in sequence.
+//!
+//! \return `true` on success. `false` on failure, with a message logged.
+bool DecompressGzipFileContent(FileReaderInterface* file_reader,
+                               FileWriterInterface* file_writer);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_FILE_FILE_HELPER_H_
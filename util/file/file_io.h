@@ -311,6 +311,21 @@ bool LoggingReadFileExactly(FileHandle file, void* buffer, size_t size);
 //! \sa CheckedWriteFile
 bool LoggingWriteFile(FileHandle file, const void* buffer, size_t size);
 
+//! \brief Wraps `pwrite()` or `WriteFile()` with an `OVERLAPPED` offset,
+//!     writing exactly \a size bytes at \a offset.
+//!
+//! This may be called concurrently from multiple threads on the same \a file.
+//! On POSIX, the file’s current position is not used or changed. On Windows,
+//! the current position may change, and callers relying on it must reposition
+//! the file afterwards.
+//!
+//! \return `true` on success. `false` with a message logged on failure, or if
+//!     fewer than \a size bytes could be written.
+bool LoggingWriteFileAtOffset(FileHandle file,
+                              FileOffset offset,
+                              const void* buffer,
+                              size_t size);
+
 //! \brief Wraps ReadFile(), ensuring that exactly \a size bytes are read.
 //!
 //! If the underlying ReadFile() fails, or if fewer than \a size bytes were
@@ -433,6 +448,9 @@ FileHandle LoggingOpenFileForWrite(const base::FilePath& path,
 //!
 //! Unlike other file open operations, this function doesn't set `O_CLOEXEC`.
 //!
+//! A file opened with `memfd_create()` allows seals to be added, so that it can
+//! be passed to LoggingSealMemoryFile().
+//!
 //! \param name A name associated with the file. This name does not indicate any
 //!     exact path and may not be used at all, depending on the strategy used to
 //!     create the file. The name should not contain any '/' characters.
@@ -444,6 +462,19 @@ FileHandle LoggingOpenFileForWrite(const base::FilePath& path,
 //! \sa LoggingOpenFileForWrite
 //! \sa LoggingOpenFileForReadAndWrite
 FileHandle LoggingOpenMemoryFileForReadAndWrite(const base::FilePath& name);
+
+//! \brief Seals an in-memory file against further modification.
+//!
+//! After a successful call, the file's contents and size can no longer be
+//! changed by any process holding the file open, so a process it is passed to
+//! may read or map it directly without making a copy to guard against
+//! concurrent modification.
+//!
+//! \param file A file opened by LoggingOpenMemoryFileForReadAndWrite().
+//! \return `true` if the file was sealed. `false` if it was not, with a
+//!     message logged unless the file was created by a fallback that does not
+//!     support sealing.
+bool LoggingSealMemoryFile(FileHandle file);
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
 
 //! \brief Wraps OpenFileForReadAndWrite(), logging an error if the operation
@@ -513,6 +544,24 @@ bool LoggingUnlockFile(FileHandle file);
 //!     `-1` on failure.
 FileOffset LoggingSeekFile(FileHandle file, FileOffset offset, int whence);
 
+//! \brief Reserves storage for part of a file without changing its size.
+//!
+//! This wraps `fallocate()` with `FALLOC_FL_KEEP_SIZE` on Linux and Android,
+//! `fcntl()` with `F_PREALLOCATE` on Apple platforms, and
+//! `SetFileInformationByHandle()` with `FileAllocationInfo` on Windows. It is
+//! not supported on Fuchsia.
+//!
+//! \param[in] file The file to reserve storage for.
+//! \param[in] offset The offset of the first byte to reserve storage for.
+//! \param[in] length The number of bytes to reserve storage for.
+//!
+//! \return `true` on success. `false` if the platform or the file’s
+//!     filesystem does not support preallocation, or on failure with a message
+//!     logged.
+bool LoggingPreallocateFile(FileHandle file,
+                            FileOffset offset,
+                            FileOffset length);
+
 //! \brief Truncates the given \a file to zero bytes in length.
 //!
 //! \return `true` on success, or `false`, and a message will be logged.
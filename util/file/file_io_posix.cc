@@ -158,7 +158,8 @@ FileHandle LoggingOpenFileForWrite(const base::FilePath& path,
 FileHandle LoggingOpenMemoryFileForReadAndWrite(const base::FilePath& name) {
   DCHECK(name.value().find('/') == std::string::npos);
 
-  int result = HANDLE_EINTR(memfd_create(name.value().c_str(), 0));
+  int result =
+      HANDLE_EINTR(memfd_create(name.value().c_str(), MFD_ALLOW_SEALING));
   if (result >= 0 || errno != ENOSYS) {
     PLOG_IF(ERROR, result < 0) << "memfd_create";
     return result;
@@ -199,6 +200,19 @@ FileHandle LoggingOpenMemoryFileForReadAndWrite(const base::FilePath& name) {
   }
   return result;
 }
+
+bool LoggingSealMemoryFile(FileHandle file) {
+  if (HANDLE_EINTR(fcntl(file,
+                         F_ADD_SEALS,
+                         F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE |
+                             F_SEAL_SEAL)) != 0) {
+    // Files created by the O_TMPFILE and named file fallbacks don't support
+    // sealing.
+    PLOG_IF(ERROR, errno != EINVAL) << "fcntl";
+    return false;
+  }
+  return true;
+}
 #endif
 
 FileHandle LoggingOpenFileForReadAndWrite(const base::FilePath& path,
@@ -243,6 +257,81 @@ FileOffset LoggingSeekFile(FileHandle file, FileOffset offset, int whence) {
   return rv;
 }
 
+bool LoggingWriteFileAtOffset(FileHandle file,
+                              FileOffset offset,
+                              const void* buffer,
+                              size_t size) {
+  const char* buffer_c = static_cast<const char*>(buffer);
+  while (size > 0) {
+    const ssize_t written = HANDLE_EINTR(pwrite(
+        file,
+        buffer_c,
+        std::min(size,
+                 static_cast<size_t>(std::numeric_limits<ssize_t>::max())),
+        offset));
+    if (written < 0) {
+      PLOG(ERROR) << "pwrite";
+      return false;
+    }
+    if (written == 0) {
+      LOG(ERROR) << "pwrite: returned 0";
+      return false;
+    }
+    buffer_c += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+bool LoggingPreallocateFile(FileHandle file,
+                            FileOffset offset,
+                            FileOffset length) {
+  if (length <= 0) {
+    return true;
+  }
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (HANDLE_EINTR(fallocate(file, FALLOC_FL_KEEP_SIZE, offset, length)) !=
+      0) {
+    PLOG_IF(ERROR, errno != EOPNOTSUPP && errno != ENOSYS) << "fallocate";
+    return false;
+  }
+  return true;
+#elif BUILDFLAG(IS_APPLE)
+  // F_PREALLOCATE allocates relative to the end of the space already
+  // allocated, so only ask for what lies beyond it.
+  struct stat st;
+  if (fstat(file, &st) != 0) {
+    PLOG(ERROR) << "fstat";
+    return false;
+  }
+  const FileOffset allocated = static_cast<FileOffset>(st.st_blocks) * 512;
+  if (offset + length <= allocated) {
+    return true;
+  }
+
+  fstore_t store = {};
+  store.fst_flags = F_ALLOCATECONTIG | F_ALLOCATEALL;
+  store.fst_posmode = F_PEOFPOSMODE;
+  store.fst_offset = 0;
+  store.fst_length = offset + length - allocated;
+  if (fcntl(file, F_PREALLOCATE, &store) == 0) {
+    return true;
+  }
+
+  // Contiguous space may not be available, but fewer extents still help.
+  store.fst_flags = F_ALLOCATEALL;
+  if (fcntl(file, F_PREALLOCATE, &store) != 0) {
+    PLOG_IF(ERROR, errno != ENOTSUP) << "fcntl F_PREALLOCATE";
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool LoggingTruncateFile(FileHandle file) {
   if (HANDLE_EINTR(ftruncate(file, 0)) != 0) {
     PLOG(ERROR) << "ftruncate";
@@ -490,6 +490,26 @@ TEST(FileIO, LoggingOpenMemoryFileForReadAndWrite) {
   ASSERT_TRUE(LoggingReadFileExactly(handle.get(), buffer, sizeof(buffer)));
   EXPECT_EQ(memcmp(buffer, kTestData, sizeof(buffer)), 0);
 }
+
+TEST(FileIO, LoggingSealMemoryFile) {
+  ScopedFileHandle handle(
+      LoggingOpenMemoryFileForReadAndWrite(base::FilePath("memfile")));
+  ASSERT_TRUE(handle.is_valid());
+
+  static constexpr char kTestData[] = "somedata";
+  ASSERT_TRUE(LoggingWriteFile(handle.get(), kTestData, sizeof(kTestData)));
+
+  if (!LoggingSealMemoryFile(handle.get())) {
+    GTEST_SKIP() << "sealing not supported";
+  }
+
+  EXPECT_FALSE(WriteFile(handle.get(), kTestData, sizeof(kTestData)));
+
+  ASSERT_EQ(LoggingSeekFile(handle.get(), 0, SEEK_SET), 0);
+  char buffer[sizeof(kTestData)];
+  ASSERT_TRUE(LoggingReadFileExactly(handle.get(), buffer, sizeof(buffer)));
+  EXPECT_EQ(memcmp(buffer, kTestData, sizeof(buffer)), 0);
+}
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
 
 enum class ReadOrWrite : bool {
@@ -743,6 +763,28 @@ TEST(FileIO, FileSizeByHandle) {
   EXPECT_EQ(LoggingFileSizeByHandle(file_handle.get()), 9);
 }
 
+TEST(FileIO, PreallocateFile) {
+  ScopedTempDir temp_dir;
+  base::FilePath file_path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("preallocated"));
+
+  ScopedFileHandle file_handle(LoggingOpenFileForWrite(
+      file_path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_NE(file_handle.get(), kInvalidFileHandle);
+
+  EXPECT_TRUE(LoggingPreallocateFile(file_handle.get(), 0, 0));
+
+  // Preallocation may legitimately be unsupported, but either way, it must not
+  // change the file’s size or position.
+  LoggingPreallocateFile(file_handle.get(), 0, 1024 * 1024);
+  EXPECT_EQ(LoggingFileSizeByHandle(file_handle.get()), 0);
+  EXPECT_EQ(LoggingSeekFile(file_handle.get(), 0, SEEK_CUR), 0);
+
+  static constexpr char data[] = "zippyzap";
+  ASSERT_TRUE(LoggingWriteFile(file_handle.get(), &data, sizeof(data)));
+  EXPECT_EQ(LoggingFileSizeByHandle(file_handle.get()), 9);
+}
+
 FileHandle FileHandleForFILE(FILE* file) {
   int fd = fileno(file);
 #if BUILDFLAG(IS_POSIX)
@@ -245,6 +245,55 @@ FileOffset LoggingSeekFile(FileHandle file, FileOffset offset, int whence) {
   return new_offset.QuadPart;
 }
 
+bool LoggingWriteFileAtOffset(FileHandle file,
+                              FileOffset offset,
+                              const void* buffer,
+                              size_t size) {
+  const char* buffer_c = static_cast<const char*>(buffer);
+  while (size > 0) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    const DWORD write_size =
+        static_cast<DWORD>(std::min(size, kMaxReadWriteSize));
+    DWORD bytes_written;
+    if (!::WriteFile(file, buffer_c, write_size, &bytes_written, &overlapped)) {
+      PLOG(ERROR) << "WriteFile";
+      return false;
+    }
+    if (bytes_written == 0) {
+      LOG(ERROR) << "WriteFile: wrote 0";
+      return false;
+    }
+    buffer_c += bytes_written;
+    size -= bytes_written;
+    offset += bytes_written;
+  }
+  return true;
+}
+
+bool LoggingPreallocateFile(FileHandle file,
+                            FileOffset offset,
+                            FileOffset length) {
+  if (length <= 0) {
+    return true;
+  }
+
+  // The allocation size applies to the whole file and does not change its end,
+  // so reserve through the end of the requested range.
+  FILE_ALLOCATION_INFO allocation_info = {};
+  allocation_info.AllocationSize.QuadPart = offset + length;
+  if (!SetFileInformationByHandle(file,
+                                  FileAllocationInfo,
+                                  &allocation_info,
+                                  sizeof(allocation_info))) {
+    PLOG(ERROR) << "SetFileInformationByHandle";
+    return false;
+  }
+  return true;
+}
+
 bool LoggingTruncateFile(FileHandle file) {
   if (LoggingSeekFile(file, 0, SEEK_SET) != 0)
     return false;
@@ -139,6 +139,13 @@ class FileReader : public FileReaderInterface {
   //!     a Close().
   FileOffset Seek(FileOffset offset, int whence) override;
 
+  //! \brief Returns the handle of the open file, which remains owned by this
+  //!     object.
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  FileHandle file_handle() const { return file_.get(); }
+
  private:
   ScopedFileHandle file_;
   WeakFileHandleFileReader weak_file_handle_file_reader_;
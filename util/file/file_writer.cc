@@ -22,6 +22,7 @@
 
 #include "base/check_op.h"
 #include "base/logging.h"
+#include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
 #include "build/build_config.h"
 #include "util/misc/implicit_cast.h"
@@ -43,6 +44,13 @@ static_assert(offsetof(WritableIoVec, iov_len) == offsetof(iovec, iov_len),
               "WritableIoVec len offset");
 #endif  // BUILDFLAG(IS_POSIX)
 
+bool FileWriterInterface::WriteAtOffset(FileOffset offset,
+                                        const void* data,
+                                        size_t size) {
+  NOTREACHED();
+  return false;
+}
+
 WeakFileHandleFileWriter::WeakFileHandleFileWriter(FileHandle file_handle)
     : file_handle_(file_handle) {
 }
@@ -146,6 +154,27 @@ bool WeakFileHandleFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
   return true;
 }
 
+bool WeakFileHandleFileWriter::Preallocate(FileOffset size) {
+  DCHECK_NE(file_handle_, kInvalidFileHandle);
+
+  const FileOffset offset = LoggingSeekFile(file_handle_, 0, SEEK_CUR);
+  if (offset < 0) {
+    return false;
+  }
+  return LoggingPreallocateFile(file_handle_, offset, size);
+}
+
+bool WeakFileHandleFileWriter::SupportsWriteAtOffset() const {
+  return true;
+}
+
+bool WeakFileHandleFileWriter::WriteAtOffset(FileOffset offset,
+                                             const void* data,
+                                             size_t size) {
+  DCHECK_NE(file_handle_, kInvalidFileHandle);
+  return LoggingWriteFileAtOffset(file_handle_, offset, data, size);
+}
+
 FileOffset WeakFileHandleFileWriter::Seek(FileOffset offset, int whence) {
   DCHECK_NE(file_handle_, kInvalidFileHandle);
   return LoggingSeekFile(file_handle_, offset, whence);
@@ -183,7 +212,9 @@ bool FileWriter::OpenMemfd(const base::FilePath& path) {
   weak_file_handle_file_writer_.set_file_handle(file_.get());
   return true;
 }
+#endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
 int FileWriter::fd() {
   return file_.get();
 }
@@ -206,6 +237,22 @@ bool FileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
   return weak_file_handle_file_writer_.WriteIoVec(iovecs);
 }
 
+bool FileWriter::Preallocate(FileOffset size) {
+  DCHECK(file_.is_valid());
+  return weak_file_handle_file_writer_.Preallocate(size);
+}
+
+bool FileWriter::SupportsWriteAtOffset() const {
+  return true;
+}
+
+bool FileWriter::WriteAtOffset(FileOffset offset,
+                               const void* data,
+                               size_t size) {
+  DCHECK(file_.is_valid());
+  return weak_file_handle_file_writer_.WriteAtOffset(offset, data, size);
+}
+
 FileOffset FileWriter::Seek(FileOffset offset, int whence) {
   DCHECK(file_.is_valid());
   return weak_file_handle_file_writer_.Seek(offset, whence);
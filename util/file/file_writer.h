@@ -63,6 +63,37 @@ class FileWriterInterface : public virtual FileSeekerInterface {
   //!
   //! \note The contents of \a iovecs are undefined when this method returns.
   virtual bool WriteIoVec(std::vector<WritableIoVec>* iovecs) = 0;
+
+  //! \brief Reserves storage for \a size bytes beginning at the current
+  //!     position, in advance of writing them.
+  //!
+  //! This is a hint that may allow the underlying file to be laid out with
+  //! less fragmentation. It does not change the file’s size or the current
+  //! position. The default implementation does nothing.
+  //!
+  //! \return `true` if storage was reserved. `false` if this is not supported
+  //!     by the writer or the underlying file, or if it failed, with an error
+  //!     message logged.
+  virtual bool Preallocate(FileOffset size) { return false; }
+
+  //! \brief Whether WriteAtOffset() is supported.
+  //!
+  //! The default implementation returns `false`.
+  virtual bool SupportsWriteAtOffset() const { return false; }
+
+  //! \brief Writes \a size bytes at \a offset, independently of the current
+  //!     position.
+  //!
+  //! This may be called concurrently from multiple threads, but not
+  //! concurrently with any other method. Afterwards, the current position is
+  //! unspecified and must be set with Seek() before calling Write() or
+  //! WriteIoVec() again.
+  //!
+  //! This may only be called if SupportsWriteAtOffset() returns `true`.
+  //!
+  //! \return `true` if the operation succeeded, `false` if it failed, with an
+  //!     error message logged.
+  virtual bool WriteAtOffset(FileOffset offset, const void* data, size_t size);
 };
 
 //! \brief A file writer backed by a FileHandle.
@@ -92,6 +123,21 @@ class WeakFileHandleFileWriter : public FileWriterInterface {
   bool Write(const void* data, size_t size) override;
   bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
 
+  //! \copydoc FileWriterInterface::Preallocate()
+  //!
+  //! This wraps LoggingPreallocateFile().
+  bool Preallocate(FileOffset size) override;
+
+  //! \copydoc FileWriterInterface::SupportsWriteAtOffset()
+  //!
+  //! This returns `true`.
+  bool SupportsWriteAtOffset() const override;
+
+  //! \copydoc FileWriterInterface::WriteAtOffset()
+  //!
+  //! This wraps LoggingWriteFileAtOffset().
+  bool WriteAtOffset(FileOffset offset, const void* data, size_t size) override;
+
   // FileSeekerInterface:
 
   //! \copydoc FileWriterInterface::Seek()
@@ -146,10 +192,13 @@ class FileWriter : public FileWriterInterface {
   //! \note After a successful call, this method or Open() cannot be called
   //      again until after Close().
   bool OpenMemfd(const base::FilePath& path);
+#endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
   //! \brief Returns the underlying file descriptor.
   //!
-  //! \note This is used when this writes to a Memfd.
+  //! \note This is used when this writes to a Memfd, and to write to the file
+  //!     through `io_uring`.
   int fd();
 #endif
 
@@ -174,6 +223,21 @@ class FileWriter : public FileWriterInterface {
   //!     a Close().
   bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
 
+  //! \copydoc FileWriterInterface::Preallocate()
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  bool Preallocate(FileOffset size) override;
+
+  //! \copydoc FileWriterInterface::SupportsWriteAtOffset()
+  bool SupportsWriteAtOffset() const override;
+
+  //! \copydoc FileWriterInterface::WriteAtOffset()
+  //!
+  //! \note It is only valid to call this method between a successful Open() and
+  //!     a Close().
+  bool WriteAtOffset(FileOffset offset, const void* data, size_t size) override;
+
   // FileSeekerInterface:
 
   //! \copydoc FileWriterInterface::Seek()
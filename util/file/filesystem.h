@@ -69,6 +69,31 @@ bool LoggingCreateDirectory(const base::FilePath& path,
 bool MoveFileOrDirectory(const base::FilePath& source,
                          const base::FilePath& dest);
 
+//! \brief Creates a file with the contents of another, sharing the source’s
+//!     storage where possible, logging a message on failure.
+//!
+//! Where the filesystem supports it, \a dest is created as a copy-on-write
+//! clone of \a source, using `FICLONE` on Linux and `clonefile()` on Apple
+//! platforms. Otherwise, if \a allow_hard_link is `true`, \a dest is created as
+//! a hard link to \a source. If neither is possible, the contents of \a source
+//! are copied to \a dest.
+//!
+//! A hard link shares the file itself rather than a snapshot of its contents,
+//! so \a allow_hard_link should only be `true` if \a source will not be
+//! modified, and it will have \a source’s permissions rather than \a
+//! permissions.
+//!
+//! \param[in] source The path to the file to be cloned.
+//! \param[in] dest The path to the new file, which must not exist.
+//! \param[in] permissions The permissions to use for \a dest.
+//! \param[in] allow_hard_link Whether \a dest may be a hard link to \a source.
+//! \return `true` on success. `false` on failure with a message logged, in
+//!     which case \a dest has not been created.
+bool CloneOrCopyFile(const base::FilePath& source,
+                     const base::FilePath& dest,
+                     FilePermissions permissions,
+                     bool allow_hard_link);
+
 //! \brief Determines if a path refers to a regular file, logging a message on
 //!     failure.
 //!
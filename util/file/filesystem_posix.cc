@@ -20,12 +20,45 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <memory>
+
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "util/file/directory_reader.h"
 
+#if BUILDFLAG(IS_APPLE)
+#include <sys/clonefile.h>
+#elif BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+
+#if !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
 namespace crashpad {
 
+namespace {
+
+bool CopyFileContents(FileHandle source, FileHandle dest) {
+  constexpr size_t kBufferSize = 64 * 1024;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  FileOperationResult bytes_read;
+  while ((bytes_read = ReadFile(source, buffer.get(), kBufferSize)) > 0) {
+    if (!LoggingWriteFile(dest, buffer.get(), bytes_read)) {
+      return false;
+    }
+  }
+  if (bytes_read < 0) {
+    PLOG(ERROR) << "read";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 bool FileModificationTime(const base::FilePath& path, timespec* mtime) {
   struct stat st;
   if (lstat(path.value().c_str(), &st) != 0) {
@@ -74,6 +107,75 @@ bool MoveFileOrDirectory(const base::FilePath& source,
   return true;
 }
 
+bool CloneOrCopyFile(const base::FilePath& source,
+                     const base::FilePath& dest,
+                     FilePermissions permissions,
+                     bool allow_hard_link) {
+#if BUILDFLAG(IS_APPLE)
+  if (clonefile(source.value().c_str(), dest.value().c_str(), CLONE_NOFOLLOW) ==
+      0) {
+    // A clone takes on the source’s permissions.
+    if (chmod(dest.value().c_str(),
+              permissions == FilePermissions::kWorldReadable ? 0644 : 0600) !=
+        0) {
+      PLOG(ERROR) << "chmod " << dest.value();
+      LoggingRemoveFile(dest);
+      return false;
+    }
+    return true;
+  }
+  if (errno == EEXIST) {
+    PLOG(ERROR) << "clonefile " << dest.value();
+    return false;
+  }
+#endif  // BUILDFLAG(IS_APPLE)
+
+  ScopedFileHandle source_handle(LoggingOpenFileForRead(source));
+  if (!source_handle.is_valid()) {
+    return false;
+  }
+
+  ScopedFileHandle dest_handle;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  dest_handle.reset(LoggingOpenFileForWrite(
+      dest, FileWriteMode::kCreateOrFail, permissions));
+  if (!dest_handle.is_valid()) {
+    return false;
+  }
+  if (ioctl(dest_handle.get(), FICLONE, source_handle.get()) == 0) {
+    return true;
+  }
+  if (allow_hard_link) {
+    // The filesystem doesn’t support cloning. dest is still empty, so it can
+    // be replaced by a hard link.
+    dest_handle.reset();
+    if (!LoggingRemoveFile(dest)) {
+      return false;
+    }
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+  if (allow_hard_link &&
+      link(source.value().c_str(), dest.value().c_str()) == 0) {
+    return true;
+  }
+
+  if (!dest_handle.is_valid()) {
+    dest_handle.reset(LoggingOpenFileForWrite(
+        dest, FileWriteMode::kCreateOrFail, permissions));
+    if (!dest_handle.is_valid()) {
+      return false;
+    }
+  }
+  if (!CopyFileContents(source_handle.get(), dest_handle.get())) {
+    dest_handle.reset();
+    LoggingRemoveFile(dest);
+    return false;
+  }
+  return true;
+}
+
 bool IsRegularFile(const base::FilePath& path) {
   struct stat st;
   if (lstat(path.value().c_str(), &st) != 0) {
@@ -134,12 +236,17 @@ uint64_t GetDirectorySize(const base::FilePath& dirpath) {
     return 0;
   }
   base::FilePath filename;
+  DirectoryReader::FileType type;
   DirectoryReader::Result result;
   uint64_t size = 0;
-  while ((result = reader.NextFile(&filename)) ==
+  while ((result = reader.NextFile(&filename, &type)) ==
          DirectoryReader::Result::kSuccess) {
     const base::FilePath filepath(dirpath.Append(filename));
-    if (IsDirectory(filepath, /*allow_symlinks=*/false)) {
+    // The type reported by the reader saves a stat() per entry, falling back
+    // to one only when the filesystem doesn’t report it.
+    if (type == DirectoryReader::FileType::kDirectory ||
+        (type == DirectoryReader::FileType::kUnknown &&
+         IsDirectory(filepath, /*allow_symlinks=*/false))) {
       size += GetDirectorySize(filepath);
     } else {
       size += GetFileSize(filepath);
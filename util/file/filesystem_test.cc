@@ -286,6 +286,56 @@ TEST(Filesystem, MoveFileOrDirectory_SymbolicLinks) {
 
 #endif  // !BUILDFLAG(IS_FUCHSIA)
 
+TEST(Filesystem, CloneOrCopyFile) {
+  ScopedTempDir temp_dir;
+  const base::FilePath source(
+      temp_dir.path().Append(FILE_PATH_LITERAL("source")));
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(writer.Write(kTestFileContent, sizeof(kTestFileContent)));
+  }
+
+  const base::FilePath clone(
+      temp_dir.path().Append(FILE_PATH_LITERAL("clone")));
+  ASSERT_TRUE(
+      CloneOrCopyFile(source, clone, FilePermissions::kOwnerOnly, false));
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(clone, &contents));
+  EXPECT_EQ(contents, std::string(kTestFileContent, sizeof(kTestFileContent)));
+
+  // A clone or copy is independent of its source.
+  {
+    FileWriter writer;
+    ASSERT_TRUE(writer.Open(
+        source, FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+  }
+  ASSERT_TRUE(LoggingReadEntireFile(clone, &contents));
+  EXPECT_EQ(contents, std::string(kTestFileContent, sizeof(kTestFileContent)));
+
+  // The destination must not exist.
+  EXPECT_FALSE(
+      CloneOrCopyFile(source, clone, FilePermissions::kOwnerOnly, false));
+  ASSERT_TRUE(LoggingReadEntireFile(clone, &contents));
+  EXPECT_EQ(contents, std::string(kTestFileContent, sizeof(kTestFileContent)));
+
+  const base::FilePath linked(
+      temp_dir.path().Append(FILE_PATH_LITERAL("linked")));
+  ASSERT_TRUE(
+      CloneOrCopyFile(clone, linked, FilePermissions::kOwnerOnly, true));
+  ASSERT_TRUE(LoggingReadEntireFile(linked, &contents));
+  EXPECT_EQ(contents, std::string(kTestFileContent, sizeof(kTestFileContent)));
+
+  EXPECT_FALSE(CloneOrCopyFile(
+      temp_dir.path().Append(FILE_PATH_LITERAL("missing")),
+      temp_dir.path().Append(FILE_PATH_LITERAL("missing_clone")),
+      FilePermissions::kOwnerOnly,
+      false));
+  EXPECT_FALSE(
+      PathExists(temp_dir.path().Append(FILE_PATH_LITERAL("missing_clone"))));
+}
+
 TEST(Filesystem, IsRegularFile) {
   EXPECT_FALSE(IsRegularFile(base::FilePath()));
 
@@ -109,6 +109,23 @@ bool MoveFileOrDirectory(const base::FilePath& source,
   return true;
 }
 
+bool CloneOrCopyFile(const base::FilePath& source,
+                     const base::FilePath& dest,
+                     FilePermissions permissions,
+                     bool allow_hard_link) {
+  // Block cloning is only available on ReFS volumes, so a hard link is
+  // preferred when allowed. CopyFile() otherwise copies within the kernel.
+  if (allow_hard_link &&
+      CreateHardLink(dest.value().c_str(), source.value().c_str(), nullptr)) {
+    return true;
+  }
+  if (!CopyFile(source.value().c_str(), dest.value().c_str(), TRUE)) {
+    PLOG(ERROR) << "CopyFile " << source << ", " << dest;
+    return false;
+  }
+  return true;
+}
+
 bool IsRegularFile(const base::FilePath& path) {
   DWORD fileattr = GetFileAttributes(path.value().c_str());
   if (fileattr == INVALID_FILE_ATTRIBUTES) {
@@ -180,12 +197,17 @@ uint64_t GetDirectorySize(const base::FilePath& dirpath) {
     return 0;
   }
   base::FilePath filename;
+  DirectoryReader::FileType type;
   DirectoryReader::Result result;
   uint64_t size = 0;
-  while ((result = reader.NextFile(&filename)) ==
+  while ((result = reader.NextFile(&filename, &type)) ==
          DirectoryReader::Result::kSuccess) {
     const base::FilePath filepath(dirpath.Append(filename));
-    if (IsDirectory(filepath, /*allow_symlinks=*/false)) {
+    // The type reported by the reader saves a stat() per entry, falling back
+    // to one only when the filesystem doesn’t report it.
+    if (type == DirectoryReader::FileType::kDirectory ||
+        (type == DirectoryReader::FileType::kUnknown &&
+         IsDirectory(filepath, /*allow_symlinks=*/false))) {
       size += GetDirectorySize(filepath);
     } else {
       size += GetFileSize(filepath);
@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/write_combining_file_writer.h"
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+WriteCombiningFileWriter::WriteCombiningFileWriter(
+    FileWriterInterface* file_writer,
+    size_t buffer_size)
+    : buffer_(), file_writer_(file_writer), buffer_size_(buffer_size) {
+  buffer_.reserve(buffer_size_);
+}
+
+WriteCombiningFileWriter::~WriteCombiningFileWriter() {
+  DCHECK(buffer_.empty());
+}
+
+bool WriteCombiningFileWriter::Flush() {
+  if (buffer_.empty()) {
+    return true;
+  }
+
+  const bool rv = file_writer_->Write(buffer_.data(), buffer_.size());
+  buffer_.clear();
+  return rv;
+}
+
+bool WriteCombiningFileWriter::Write(const void* data, size_t size) {
+  if (size > buffer_size_ - buffer_.size() && !Flush()) {
+    return false;
+  }
+
+  if (size >= buffer_size_) {
+    return file_writer_->Write(data, size);
+  }
+
+  const uint8_t* data_c = static_cast<const uint8_t*>(data);
+  buffer_.insert(buffer_.end(), data_c, data_c + size);
+  return true;
+}
+
+bool WriteCombiningFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  if (iovecs->empty()) {
+    LOG(ERROR) << "WriteIoVec(): no iovecs";
+    return false;
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WriteCombiningFileWriter::Preallocate(FileOffset size) {
+  return Flush() && file_writer_->Preallocate(size);
+}
+
+bool WriteCombiningFileWriter::SupportsWriteAtOffset() const {
+  return file_writer_->SupportsWriteAtOffset();
+}
+
+bool WriteCombiningFileWriter::WriteAtOffset(FileOffset offset,
+                                             const void* data,
+                                             size_t size) {
+  DCHECK(buffer_.empty());
+  return file_writer_->WriteAtOffset(offset, data, size);
+}
+
+FileOffset WriteCombiningFileWriter::Seek(FileOffset offset, int whence) {
+  if (!Flush()) {
+    return -1;
+  }
+  return file_writer_->Seek(offset, whence);
+}
+
+}  // namespace crashpad
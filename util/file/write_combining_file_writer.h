@@ -0,0 +1,96 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_FILE_WRITE_COMBINING_FILE_WRITER_H_
+#define CRASHPAD_UTIL_FILE_WRITE_COMBINING_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/file/file_writer.h"
+
+namespace crashpad {
+
+//! \brief A file writer that combines small writes into larger ones.
+//!
+//! Writes are copied into a buffer that is passed to the underlying writer in
+//! a single write when it fills, when Seek() is called, and when Flush() is
+//! called. Writes at least as large as the buffer are passed through directly
+//! after flushing the buffer. This turns the many small writes made while
+//! writing a minidump, such as padding and the fixed-size structures of each
+//! thread, module, and memory descriptor, into few large writes, which matters
+//! when each write is expensive, as on a network filesystem.
+//!
+//! Flush() must be called after the last write and before this object is
+//! destroyed.
+class WriteCombiningFileWriter final : public FileWriterInterface {
+ public:
+  //! \brief The default size of the buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \param[in] file_writer The writer to write to.
+  //! \param[in] buffer_size The number of bytes to accumulate before writing
+  //!     to \a file_writer.
+  explicit WriteCombiningFileWriter(FileWriterInterface* file_writer,
+                                    size_t buffer_size = kDefaultBufferSize);
+
+  WriteCombiningFileWriter(const WriteCombiningFileWriter&) = delete;
+  WriteCombiningFileWriter& operator=(const WriteCombiningFileWriter&) =
+      delete;
+
+  ~WriteCombiningFileWriter() override;
+
+  //! \brief Writes any buffered data to the underlying writer.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Flush();
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  //! \copydoc FileWriterInterface::Preallocate()
+  //!
+  //! Buffered data is flushed before preallocating.
+  bool Preallocate(FileOffset size) override;
+
+  //! \copydoc FileWriterInterface::SupportsWriteAtOffset()
+  //!
+  //! This is supported if it is supported by the underlying writer.
+  bool SupportsWriteAtOffset() const override;
+
+  //! \copydoc FileWriterInterface::WriteAtOffset()
+  //!
+  //! Writes at an offset are not buffered. Flush() must be called before the
+  //! first of them.
+  bool WriteAtOffset(FileOffset offset, const void* data, size_t size) override;
+
+  // FileSeekerInterface:
+
+  //! \copydoc FileWriterInterface::Seek()
+  //!
+  //! Buffered data is flushed before seeking.
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  std::vector<uint8_t> buffer_;
+  FileWriterInterface* file_writer_;  // weak
+  size_t buffer_size_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_FILE_WRITE_COMBINING_FILE_WRITER_H_
@@ -0,0 +1,141 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file/write_combining_file_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Writes to a StringFile, counting the writes made.
+class CountingFileWriter : public FileWriterInterface {
+ public:
+  CountingFileWriter() : string_file_(), writes_(0) {}
+
+  CountingFileWriter(const CountingFileWriter&) = delete;
+  CountingFileWriter& operator=(const CountingFileWriter&) = delete;
+
+  ~CountingFileWriter() override = default;
+
+  const std::string& string() const { return string_file_.string(); }
+  size_t writes() const { return writes_; }
+
+  // FileWriterInterface:
+
+  bool Write(const void* data, size_t size) override {
+    ++writes_;
+    return string_file_.Write(data, size);
+  }
+
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override {
+    ++writes_;
+    return string_file_.WriteIoVec(iovecs);
+  }
+
+  // FileSeekerInterface:
+
+  FileOffset Seek(FileOffset offset, int whence) override {
+    return string_file_.Seek(offset, whence);
+  }
+
+ private:
+  StringFile string_file_;
+  size_t writes_;
+};
+
+TEST(WriteCombiningFileWriter, CombinesSmallWrites) {
+  CountingFileWriter counting_writer;
+  WriteCombiningFileWriter writer(&counting_writer, 8);
+
+  EXPECT_TRUE(writer.Write("abc", 3));
+  EXPECT_TRUE(writer.Write("def", 3));
+  EXPECT_EQ(counting_writer.writes(), 0u);
+
+  // This doesn’t fit, so the first two writes are flushed together.
+  EXPECT_TRUE(writer.Write("ghi", 3));
+  EXPECT_EQ(counting_writer.writes(), 1u);
+  EXPECT_EQ(counting_writer.string(), "abcdef");
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(counting_writer.writes(), 2u);
+  EXPECT_EQ(counting_writer.string(), "abcdefghi");
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(counting_writer.writes(), 2u);
+}
+
+TEST(WriteCombiningFileWriter, LargeWritesPassThrough) {
+  CountingFileWriter counting_writer;
+  WriteCombiningFileWriter writer(&counting_writer, 8);
+
+  EXPECT_TRUE(writer.Write("ab", 2));
+  EXPECT_TRUE(writer.Write("0123456789", 10));
+  EXPECT_EQ(counting_writer.writes(), 2u);
+  EXPECT_EQ(counting_writer.string(), "ab0123456789");
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(counting_writer.writes(), 2u);
+}
+
+TEST(WriteCombiningFileWriter, WriteIoVec) {
+  CountingFileWriter counting_writer;
+  WriteCombiningFileWriter writer(&counting_writer);
+
+  std::vector<WritableIoVec> iovecs(3);
+  iovecs[0].iov_base = "one";
+  iovecs[0].iov_len = 3;
+  iovecs[1].iov_base = "two";
+  iovecs[1].iov_len = 3;
+  iovecs[2].iov_base = "three";
+  iovecs[2].iov_len = 5;
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+
+  iovecs.resize(1);
+  iovecs[0].iov_base = "four";
+  iovecs[0].iov_len = 4;
+  EXPECT_TRUE(writer.WriteIoVec(&iovecs));
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(counting_writer.writes(), 1u);
+  EXPECT_EQ(counting_writer.string(), "onetwothreefour");
+
+  iovecs.clear();
+  EXPECT_FALSE(writer.WriteIoVec(&iovecs));
+}
+
+TEST(WriteCombiningFileWriter, SeekFlushes) {
+  CountingFileWriter counting_writer;
+  WriteCombiningFileWriter writer(&counting_writer);
+
+  EXPECT_TRUE(writer.Write("abcdef", 6));
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), 6);
+  EXPECT_EQ(counting_writer.string(), "abcdef");
+
+  EXPECT_EQ(writer.Seek(2, SEEK_SET), 2);
+  EXPECT_TRUE(writer.Write("XY", 2));
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(counting_writer.string(), "abXYef");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -14,10 +14,13 @@
 
 #include "util/ios/ios_intermediate_dump_data.h"
 
+#include <string.h>
+
 namespace crashpad {
 namespace internal {
 
-IOSIntermediateDumpData::IOSIntermediateDumpData() : data_() {}
+IOSIntermediateDumpData::IOSIntermediateDumpData()
+    : data_(nullptr), size_(0) {}
 
 IOSIntermediateDumpData::~IOSIntermediateDumpData() {}
 
@@ -26,13 +29,13 @@ IOSIntermediateDumpObject::Type IOSIntermediateDumpData::GetType() const {
 }
 
 std::string IOSIntermediateDumpData::GetString() const {
-  return std::string(reinterpret_cast<const char*>(data_.data()), data_.size());
+  return std::string(reinterpret_cast<const char*>(data_), size_);
 }
 
 bool IOSIntermediateDumpData::GetValueInternal(void* value,
                                                size_t value_size) const {
-  if (value_size == data_.size()) {
-    memcpy(value, data_.data(), data_.size());
+  if (value_size == size_) {
+    memcpy(value, data_, size_);
     return true;
   }
   return false;
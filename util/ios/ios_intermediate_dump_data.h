@@ -15,15 +15,18 @@
 #ifndef CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_DATA_H_
 #define CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_DATA_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
-#include <vector>
 
 #include "util/ios/ios_intermediate_dump_object.h"
 
 namespace crashpad {
 namespace internal {
 
-//! \brief A data object, consisting of a std::vector<uint8_t>.
+//! \brief A data object, referring to a range of bytes owned by the
+//!     IOSIntermediateDumpReader that produced it.
 class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
  public:
   IOSIntermediateDumpData();
@@ -33,11 +36,13 @@ class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
 
   ~IOSIntermediateDumpData() override;
 
-  //! \brief Constructs a new data object which owns a std::vector<uint8_t>.
+  //! \brief Constructs a new data object which refers to, but does not own,
+  //!     \a size bytes at \a data.
   //!
-  //! \param[in] data An array of uint8_t.
-  //! \param[in] length The length of \a data.
-  IOSIntermediateDumpData(std::vector<uint8_t> data) : data_(std::move(data)) {}
+  //! \param[in] data An array of uint8_t, which must outlive this object.
+  //! \param[in] size The length of \a data.
+  IOSIntermediateDumpData(const uint8_t* data, size_t size)
+      : data_(data), size_(size) {}
 
   // IOSIntermediateDumpObject:
   Type GetType() const override;
@@ -45,7 +50,7 @@ class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
   //! \brief Returns data as a string.
   std::string GetString() const;
 
-  //! \brief Copies the data into \a value if sizeof(T) matches data_.size().
+  //! \brief Copies the data into \a value if sizeof(T) matches size().
   //!
   //! \param[out] value The data to populate.
   //!
@@ -55,12 +60,17 @@ class IOSIntermediateDumpData : public IOSIntermediateDumpObject {
     return GetValueInternal(reinterpret_cast<void*>(value), sizeof(*value));
   }
 
-  const std::vector<uint8_t>& bytes() const { return data_; }
+  //! \brief Returns a pointer to the data, which is not necessarily aligned.
+  const uint8_t* data() const { return data_; }
+
+  //! \brief Returns the length of the data, in bytes.
+  size_t size() const { return size_; }
 
  private:
   bool GetValueInternal(void* value, size_t value_size) const;
 
-  std::vector<uint8_t> data_;
+  const uint8_t* data_;
+  size_t size_;
 };
 
 }  // namespace internal
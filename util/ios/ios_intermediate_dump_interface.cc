@@ -19,6 +19,10 @@
 namespace crashpad {
 namespace internal {
 
+FileHandle IOSIntermediateDumpInterface::MappableFileHandle() const {
+  return kInvalidFileHandle;
+}
+
 bool IOSIntermediateDumpFilePath::Initialize(const base::FilePath& path) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
   ScopedRemoveFile file_remover(path);
@@ -41,6 +45,11 @@ FileOffset IOSIntermediateDumpFilePath::Size() const {
   return LoggingFileSizeByHandle(handle_.get());
 }
 
+FileHandle IOSIntermediateDumpFilePath::MappableFileHandle() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return handle_.get();
+}
+
 IOSIntermediateDumpByteArray::IOSIntermediateDumpByteArray(const void* data,
                                                            size_t size) {
   string_file_ = std::make_unique<StringFile>();
@@ -29,6 +29,11 @@ class IOSIntermediateDumpInterface {
  public:
   virtual FileReaderInterface* FileReader() const = 0;
   virtual FileOffset Size() const = 0;
+
+  //! \brief Returns a handle to a file that may be memory-mapped in place of
+  //!     reading through FileReader(), or kInvalidFileHandle if the dump is
+  //!     not backed by a mappable file.
+  virtual FileHandle MappableFileHandle() const;
 };
 
 //! \brief An intermediate dump backed by a FilePath. FilePath is unlinked
@@ -41,6 +46,7 @@ class IOSIntermediateDumpFilePath : public IOSIntermediateDumpInterface {
   // IOSIntermediateDumpInterface:
   FileReaderInterface* FileReader() const override;
   FileOffset Size() const override;
+  FileHandle MappableFileHandle() const override;
 
  private:
   ScopedFileHandle handle_;
@@ -14,6 +14,8 @@
 
 #include "util/ios/ios_intermediate_dump_map.h"
 
+#include <algorithm>
+
 #include "util/ios/ios_intermediate_dump_data.h"
 #include "util/ios/ios_intermediate_dump_list.h"
 #include "util/ios/ios_intermediate_dump_object.h"
@@ -23,6 +25,15 @@ using crashpad::internal::IntermediateDumpKey;
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+template <typename Entry>
+bool EntryKeyLess(const Entry& entry, IntermediateDumpKey key) {
+  return entry.first < key;
+}
+
+}  // namespace
+
 IOSIntermediateDumpMap::IOSIntermediateDumpMap() : map_() {}
 
 IOSIntermediateDumpMap::~IOSIntermediateDumpMap() {}
@@ -33,34 +44,53 @@ IOSIntermediateDumpMap::Type IOSIntermediateDumpMap::GetType() const {
 
 const IOSIntermediateDumpData* IOSIntermediateDumpMap::GetAsData(
     const IntermediateDumpKey& key) const {
-  auto object_it = map_.find(key);
-  if (object_it != map_.end()) {
-    IOSIntermediateDumpObject* object = object_it->second.get();
-    if (object->GetType() == Type::kData)
-      return static_cast<IOSIntermediateDumpData*>(object);
-  }
+  const IOSIntermediateDumpObject* object = Find(key);
+  if (object && object->GetType() == Type::kData)
+    return static_cast<const IOSIntermediateDumpData*>(object);
   return nullptr;
 }
 
 const IOSIntermediateDumpList* IOSIntermediateDumpMap::GetAsList(
     const IntermediateDumpKey& key) const {
-  auto object_it = map_.find(key);
-  if (object_it != map_.end()) {
-    IOSIntermediateDumpObject* object = object_it->second.get();
-    if (object->GetType() == Type::kList)
-      return static_cast<IOSIntermediateDumpList*>(object);
-  }
+  const IOSIntermediateDumpObject* object = Find(key);
+  if (object && object->GetType() == Type::kList)
+    return static_cast<const IOSIntermediateDumpList*>(object);
   return nullptr;
 }
 
 const IOSIntermediateDumpMap* IOSIntermediateDumpMap::GetAsMap(
     const IntermediateDumpKey& key) const {
-  auto object_it = map_.find(key);
-  if (object_it != map_.end()) {
-    IOSIntermediateDumpObject* object = object_it->second.get();
-    if (object->GetType() == Type::kMap)
-      return static_cast<IOSIntermediateDumpMap*>(object);
+  const IOSIntermediateDumpObject* object = Find(key);
+  if (object && object->GetType() == Type::kMap)
+    return static_cast<const IOSIntermediateDumpMap*>(object);
+  return nullptr;
+}
+
+bool IOSIntermediateDumpMap::Insert(
+    IntermediateDumpKey key,
+    std::unique_ptr<IOSIntermediateDumpObject> object) {
+  // Writers emit most keys in increasing order, so check the end first.
+  if (map_.empty() || map_.back().first < key) {
+    map_.emplace_back(key, std::move(object));
+    return false;
   }
+
+  auto it = std::lower_bound(
+      map_.begin(), map_.end(), key, EntryKeyLess<Entry>);
+  if (it != map_.end() && it->first == key) {
+    it->second = std::move(object);
+    return true;
+  }
+  map_.emplace(it, key, std::move(object));
+  return false;
+}
+
+const IOSIntermediateDumpObject* IOSIntermediateDumpMap::Find(
+    IntermediateDumpKey key) const {
+  auto it = std::lower_bound(
+      map_.begin(), map_.end(), key, EntryKeyLess<Entry>);
+  if (it != map_.end() && it->first == key)
+    return it->second.get();
   return nullptr;
 }
 
@@ -15,8 +15,9 @@
 #ifndef CRASHPAD_UTIL_IOS_PACK_IOS_MAP_H_
 #define CRASHPAD_UTIL_IOS_PACK_IOS_MAP_H_
 
-#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "util/ios/ios_intermediate_dump_format.h"
 #include "util/ios/ios_intermediate_dump_object.h"
@@ -29,7 +30,9 @@ class IOSIntermediateDumpData;
 
 //! \brief A map object containing a IntermediateDump Key-Object pair.
 //!
-//! Also provides an element access helper.
+//! Also provides an element access helper. Entries are kept in a flat vector
+//! sorted by key, which is cheaper to build and search than a node-based map
+//! for the small number of keys an intermediate dump map typically holds.
 class IOSIntermediateDumpMap : public IOSIntermediateDumpObject {
  public:
   IOSIntermediateDumpMap();
@@ -61,8 +64,20 @@ class IOSIntermediateDumpMap : public IOSIntermediateDumpObject {
 
  private:
   friend class IOSIntermediateDumpReader;
-  std::map<IntermediateDumpKey, std::unique_ptr<IOSIntermediateDumpObject>>
-      map_;
+
+  using Entry = std::pair<IntermediateDumpKey,
+                          std::unique_ptr<IOSIntermediateDumpObject>>;
+
+  //! \brief Inserts \a object at \a key, replacing any existing object.
+  //!
+  //! \return `true` if an object was already present at \a key.
+  bool Insert(IntermediateDumpKey key,
+              std::unique_ptr<IOSIntermediateDumpObject> object);
+
+  //! \brief Returns the object at \a key, or `nullptr` if there is none.
+  const IOSIntermediateDumpObject* Find(IntermediateDumpKey key) const;
+
+  std::vector<Entry> map_;
 };
 
 }  // namespace internal
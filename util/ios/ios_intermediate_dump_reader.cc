@@ -14,11 +14,15 @@
 
 #include "util/ios/ios_intermediate_dump_reader.h"
 
+#include <string.h>
+#include <sys/mman.h>
+
 #include <memory>
 #include <stack>
 #include <vector>
 
 #include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
 #include "util/file/filesystem.h"
 #include "util/ios/ios_intermediate_dump_data.h"
 #include "util/ios/ios_intermediate_dump_format.h"
@@ -29,6 +33,46 @@
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+// A bounds-checked read position within the contents of an intermediate dump.
+class DumpCursor {
+ public:
+  DumpCursor(const uint8_t* contents, size_t size)
+      : contents_(contents), size_(size), offset_(0) {}
+
+  DumpCursor(const DumpCursor&) = delete;
+  DumpCursor& operator=(const DumpCursor&) = delete;
+
+  // Copies sizeof(T) bytes into value, which need not be aligned in the dump.
+  template <typename T>
+  bool Read(T* value) {
+    const uint8_t* bytes;
+    if (!Advance(sizeof(*value), &bytes))
+      return false;
+    memcpy(value, bytes, sizeof(*value));
+    return true;
+  }
+
+  // Returns a pointer to the next length bytes without copying them.
+  bool Advance(size_t length, const uint8_t** bytes) {
+    if (length > size_ - offset_)
+      return false;
+    *bytes = contents_ + offset_;
+    offset_ += length;
+    return true;
+  }
+
+  size_t offset() const { return offset_; }
+
+ private:
+  const uint8_t* contents_;
+  size_t size_;
+  size_t offset_;
+};
+
+}  // namespace
+
 IOSIntermediateDumpReaderInitializeResult IOSIntermediateDumpReader::Initialize(
     const IOSIntermediateDumpInterface& dump_interface) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
@@ -41,7 +85,10 @@ IOSIntermediateDumpReaderInitializeResult IOSIntermediateDumpReader::Initialize(
 
   IOSIntermediateDumpReaderInitializeResult result =
       IOSIntermediateDumpReaderInitializeResult::kSuccess;
-  if (!Parse(dump_interface.FileReader(), size)) {
+  const uint8_t* contents;
+  if (!base::IsValueInRangeForNumericType<size_t>(size) ||
+      !Load(dump_interface, static_cast<size_t>(size), &contents) ||
+      !Parse(contents, static_cast<size_t>(size))) {
     LOG(ERROR) << "Intermediate dump parsing failed";
     result = IOSIntermediateDumpReaderInitializeResult::kIncomplete;
   }
@@ -55,21 +102,42 @@ const IOSIntermediateDumpMap* IOSIntermediateDumpReader::RootMap() {
   return &intermediate_dump_;
 }
 
-bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
-                                      FileOffset file_size) {
+bool IOSIntermediateDumpReader::Load(
+    const IOSIntermediateDumpInterface& dump_interface,
+    size_t size,
+    const uint8_t** contents) {
+  FileHandle handle = dump_interface.MappableFileHandle();
+  if (handle != kInvalidFileHandle &&
+      mapping_.ResetMmap(nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0)) {
+    *contents = mapping_.addr_as<const uint8_t*>();
+    return true;
+  }
+
+  // Fall back to reading the whole dump in one pass.
+  buffer_.resize(size);
+  if (!dump_interface.FileReader()->ReadExactly(buffer_.data(), size)) {
+    buffer_.clear();
+    return false;
+  }
+  *contents = buffer_.data();
+  return true;
+}
+
+bool IOSIntermediateDumpReader::Parse(const uint8_t* contents, size_t size) {
+  DumpCursor cursor(contents, size);
   std::stack<IOSIntermediateDumpObject*> stack;
   stack.push(&intermediate_dump_);
   using Command = IOSIntermediateDumpWriter::CommandType;
   using Type = IOSIntermediateDumpObject::Type;
 
   Command command;
-  if (!reader->ReadExactly(&command, sizeof(Command)) ||
+  if (!cursor.Read(&command) ||
       command != Command::kRootMapStart) {
     LOG(ERROR) << "Unexpected start to root map.";
     return false;
   }
 
-  while (reader->ReadExactly(&command, sizeof(Command))) {
+  while (cursor.Read(&command)) {
     constexpr int kMaxStackDepth = 10;
     if (stack.size() > kMaxStackDepth) {
       LOG(ERROR) << "Unexpected depth of intermediate dump data.";
@@ -85,11 +153,11 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           const auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
           stack.push(new_map.get());
           IntermediateDumpKey key;
-          if (!reader->ReadExactly(&key, sizeof(key)))
+          if (!cursor.Read(&key))
             return false;
           if (key == IntermediateDumpKey::kInvalid)
             return false;
-          parent_map->map_[key] = std::move(new_map);
+          parent_map->Insert(key, std::move(new_map));
         } else if (parent->GetType() == Type::kList) {
           const auto parent_list =
               static_cast<IOSIntermediateDumpList*>(parent);
@@ -109,14 +177,14 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
         }
 
         IntermediateDumpKey key;
-        if (!reader->ReadExactly(&key, sizeof(key)))
+        if (!cursor.Read(&key))
           return false;
         if (key == IntermediateDumpKey::kInvalid)
           return false;
 
         auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
         stack.push(new_list.get());
-        parent_map->map_[key] = std::move(new_list);
+        parent_map->Insert(key, std::move(new_list));
         break;
       }
       case Command::kMapEnd:
@@ -148,13 +216,13 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
         IntermediateDumpKey key;
-        if (!reader->ReadExactly(&key, sizeof(key)))
+        if (!cursor.Read(&key))
           return false;
         if (key == IntermediateDumpKey::kInvalid)
           return false;
 
         size_t value_length;
-        if (!reader->ReadExactly(&value_length, sizeof(value_length))) {
+        if (!cursor.Read(&value_length)) {
           return false;
         }
 
@@ -165,16 +233,16 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
 
-        std::vector<uint8_t> data(value_length);
-        if (!reader->ReadExactly(data.data(), value_length)) {
+        const uint8_t* data;
+        if (!cursor.Advance(value_length, &data)) {
           return false;
         }
         auto parent_map = static_cast<IOSIntermediateDumpMap*>(parent);
-        if (parent_map->map_.find(key) != parent_map->map_.end()) {
+        if (parent_map->Insert(key,
+                               std::make_unique<IOSIntermediateDumpData>(
+                                   data, value_length))) {
           LOG(ERROR) << "Inserting duplicate key";
         }
-        parent_map->map_[key] =
-            std::make_unique<IOSIntermediateDumpData>(std::move(data));
         break;
       }
       case Command::kRootMapEnd: {
@@ -183,7 +251,7 @@ bool IOSIntermediateDumpReader::Parse(FileReaderInterface* reader,
           return false;
         }
 
-        if (reader->Seek(0, SEEK_CUR) != file_size) {
+        if (cursor.offset() != size) {
           LOG(ERROR) << "Root map ended before end of file.";
           return false;
         }
@@ -15,9 +15,15 @@
 #ifndef CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_READER_H_
 #define CRASHPAD_UTIL_IOS_IOS_INTERMEDIATE_DUMP_READER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
 #include "util/ios/ios_intermediate_dump_interface.h"
 #include "util/ios/ios_intermediate_dump_map.h"
 #include "util/misc/initialization_state_dcheck.h"
+#include "util/posix/scoped_mmap.h"
 
 namespace crashpad {
 namespace internal {
@@ -52,6 +58,12 @@ class IOSIntermediateDumpReader {
   //! same format used by IOSIntermediateDumpWriter, resulting in an
   //! IOSIntermediateDumpMap
   //!
+  //! When \a dump_interface is backed by a file, the file is memory-mapped and
+  //! data objects in the resulting map refer directly to the mapping.
+  //! Otherwise, the dump is read into memory owned by this object in a single
+  //! pass. Either way, data objects remain valid for the lifetime of this
+  //! object.
+  //!
   //! \param[in] dump_interface An interface corresponding to an intermediate
   //!     dump file.
   //!
@@ -66,7 +78,13 @@ class IOSIntermediateDumpReader {
   const IOSIntermediateDumpMap* RootMap();
 
  private:
-  bool Parse(FileReaderInterface* reader, FileOffset file_size);
+  bool Load(const IOSIntermediateDumpInterface& dump_interface,
+            size_t size,
+            const uint8_t** contents);
+  bool Parse(const uint8_t* contents, size_t size);
+
+  ScopedMmap mapping_;
+  std::vector<uint8_t> buffer_;
   IOSIntermediateDumpMap intermediate_dump_;
   InitializationStateDcheck initialized_;
 };
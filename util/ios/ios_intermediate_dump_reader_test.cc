@@ -248,11 +248,10 @@ TEST_F(IOSIntermediateDumpReaderTest, ReadValidData) {
     EXPECT_EQ(data->GetString(), "random_data");
 
     // Load as bytes.
-    auto bytes = data->bytes();
-    vm_size_t data_size = bytes.size();
+    vm_size_t data_size = data->size();
     EXPECT_EQ(data_size, 11UL);
 
-    const char* data_bytes = reinterpret_cast<const char*>(bytes.data());
+    const char* data_bytes = reinterpret_cast<const char*>(data->data());
     EXPECT_EQ(std::string(data_bytes, data_size), "random_data");
   }
 
@@ -260,6 +259,43 @@ TEST_F(IOSIntermediateDumpReaderTest, ReadValidData) {
   EXPECT_EQ(system_info, nullptr);
 }
 
+TEST_F(IOSIntermediateDumpReaderTest, ReadUnorderedAndDuplicateKeys) {
+  internal::IOSIntermediateDumpReader reader;
+  {
+    IOSIntermediateDumpWriter::ScopedRootMap scopedRoot(writer_.get());
+    IOSIntermediateDumpWriter::ScopedMap map(writer_.get(), Key::kProcessInfo);
+    uint32_t value = 3;
+    EXPECT_TRUE(writer_->AddProperty(Key::kStartTime, &value));
+    value = 2;
+    EXPECT_TRUE(writer_->AddProperty(Key::kPID, &value));
+    value = 1;
+    EXPECT_TRUE(writer_->AddProperty(Key::kParentPID, &value));
+    value = 4;
+    EXPECT_TRUE(writer_->AddProperty(Key::kPID, &value));
+  }
+
+  EXPECT_TRUE(writer_->Close());
+  EXPECT_EQ(reader.Initialize(dump_interface()), Result::kSuccess);
+
+  const auto process_info = reader.RootMap()->GetAsMap(Key::kProcessInfo);
+  ASSERT_NE(process_info, nullptr);
+  EXPECT_EQ(process_info->GetAsMap(Key::kPID), nullptr);
+  EXPECT_EQ(process_info->GetAsData(Key::kVersion), nullptr);
+
+  uint32_t value;
+  ASSERT_NE(process_info->GetAsData(Key::kParentPID), nullptr);
+  EXPECT_TRUE(process_info->GetAsData(Key::kParentPID)->GetValue(&value));
+  EXPECT_EQ(value, 1u);
+  ASSERT_NE(process_info->GetAsData(Key::kStartTime), nullptr);
+  EXPECT_TRUE(process_info->GetAsData(Key::kStartTime)->GetValue(&value));
+  EXPECT_EQ(value, 3u);
+
+  // The last value written for a duplicated key wins.
+  ASSERT_NE(process_info->GetAsData(Key::kPID), nullptr);
+  EXPECT_TRUE(process_info->GetAsData(Key::kPID)->GetValue(&value));
+  EXPECT_EQ(value, 4u);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -17,6 +17,7 @@
 #include <fcntl.h>
 #include <mach/mach.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -47,6 +48,41 @@ bool RawLoggingWriteFile(int fd, const void* data, size_t size) {
   return true;
 }
 
+// Like RawLoggingWriteFile, but gathers its data from two buffers with
+// writev().
+bool RawLoggingWriteFileVector(int fd,
+                               const void* data1,
+                               size_t size1,
+                               const void* data2,
+                               size_t size2) {
+  iovec iov[2];
+  iov[0].iov_base = const_cast<void*>(data1);
+  iov[0].iov_len = size1;
+  iov[1].iov_base = const_cast<void*>(data2);
+  iov[1].iov_len = size2;
+  iovec* next = &iov[0];
+  int count = 2;
+  while (count > 0) {
+    ssize_t bytes_written = HANDLE_EINTR(writev(fd, next, count));
+    if (bytes_written < 0 || bytes_written == 0) {
+      CRASHPAD_RAW_LOG_ERROR(bytes_written, "RawLoggingWriteFileVector");
+      return false;
+    }
+    // Skip what was written, which may end partway through an iovec.
+    size_t remaining = bytes_written;
+    while (count > 0 && remaining >= next->iov_len) {
+      remaining -= next->iov_len;
+      ++next;
+      --count;
+    }
+    if (count > 0) {
+      next->iov_base = static_cast<char*>(next->iov_base) + remaining;
+      next->iov_len -= remaining;
+    }
+  }
+  return true;
+}
+
 // Similar to LoggingCloseFile but with CRASHPAD_RAW_LOG.
 bool RawLoggingCloseFile(int fd) {
   int rv = IGNORE_EINTR(close(fd));
@@ -60,7 +96,15 @@ IOSIntermediateDumpWriter::~IOSIntermediateDumpWriter() {
   CHECK_EQ(fd_, -1) << "Call Close() before this object is destroyed.";
 }
 
-bool IOSIntermediateDumpWriter::Open(const base::FilePath& path) {
+bool IOSIntermediateDumpWriter::Open(const base::FilePath& path,
+                                     size_t buffer_size) {
+  DCHECK_GT(buffer_size, 0u);
+  if (buffer_size != buffer_size_) {
+    buffer_.reset(new char[buffer_size]);
+    buffer_size_ = buffer_size;
+  }
+  buffer_occupied_ = 0;
+
   // Set data protection class D (No protection). A file with this type of
   // protection can be read from or written to at any time.
   // See:
@@ -151,8 +195,10 @@ bool IOSIntermediateDumpWriter::ReadCStringInternal(const char* value,
 bool IOSIntermediateDumpWriter::AddPropertyInternal(IntermediateDumpKey key,
                                                     const char* value,
                                                     size_t value_length) {
+  // Property values are written as they are at the time of the call, and may
+  // be large, so they bypass any ScopedVMReadBatch.
   ScopedVMRead<char> vmread;
-  if (!vmread.Read(value, value_length))
+  if (!vmread.ReadDirect(value, value_length))
     return false;
   return Property(key, vmread.get(), value_length);
 }
@@ -207,51 +253,45 @@ bool IOSIntermediateDumpWriter::Property(IntermediateDumpKey key,
 bool IOSIntermediateDumpWriter::FlushWriteBuffer() {
   size_t size = buffer_occupied_;
   buffer_occupied_ = 0;
-  return RawLoggingWriteFile(fd_, buffer_, size);
+  return RawLoggingWriteFile(fd_, buffer_.get(), size);
 }
 
 bool IOSIntermediateDumpWriter::BufferedWrite(const void* data,
                                               size_t data_size) {
   const char* data_char = static_cast<const char*>(data);
-  // If `buffer_` is occupied, fill it up first, and flush if full.
-  if (buffer_occupied_ > 0) {
-    size_t data_size_to_copy =
-        std::min(kBufferSize - buffer_occupied_, data_size);
-    memcpy(buffer_ + buffer_occupied_, data_char, data_size_to_copy);
-    buffer_occupied_ += data_size_to_copy;
-    data_char += data_size_to_copy;
-    data_size -= data_size_to_copy;
-
-    if (buffer_occupied_ == kBufferSize) {
-      if (!FlushWriteBuffer()) {
-        return false;
-      }
-    }
-  }
+  DCHECK_LT(buffer_occupied_, buffer_size_);
 
-  // Either `data_size` is big enough that it could fill `buffer_`, trigger
-  // a FlushWriteBuffer, and reset `buffer_occuppied_` to zero, or there is no
-  // data left to process.
-  DCHECK(buffer_occupied_ == 0 || data_size == 0);
-
-  // Write the rest of the `data` in an increment of kBufferSize.
-  if (data_size >= kBufferSize) {
-    DCHECK_EQ(buffer_occupied_, 0u);
-    size_t data_size_to_write = data_size - (data_size % kBufferSize);
-    if (!RawLoggingWriteFile(fd_, data_char, data_size_to_write)) {
-      return false;
-    }
-    data_char += data_size_to_write;
-    data_size -= data_size_to_write;
+  // If `data` fits without filling `buffer_`, just append it.
+  if (data_size < buffer_size_ - buffer_occupied_) {
+    memcpy(buffer_.get() + buffer_occupied_, data_char, data_size);
+    buffer_occupied_ += data_size;
+    return true;
   }
 
-  // If there's any `data` left, put it in `buffer_`.
-  if (data_size > 0) {
-    DCHECK_EQ(buffer_occupied_, 0u);
-    memcpy(buffer_, data_char, data_size);
-    buffer_occupied_ = data_size;
+  // Otherwise write out `buffer_` and as much of `data` as keeps the write a
+  // multiple of `buffer_size_` in a single call. `data` is written directly
+  // from where it lies, which for large properties is the vm_read region.
+  size_t total_size = buffer_occupied_ + data_size;
+  size_t data_size_to_write =
+      total_size - (total_size % buffer_size_) - buffer_occupied_;
+  bool written = buffer_occupied_ > 0
+                     ? RawLoggingWriteFileVector(fd_,
+                                                 buffer_.get(),
+                                                 buffer_occupied_,
+                                                 data_char,
+                                                 data_size_to_write)
+                     : RawLoggingWriteFile(fd_, data_char, data_size_to_write);
+  buffer_occupied_ = 0;
+  if (!written) {
+    return false;
   }
+  data_char += data_size_to_write;
+  data_size -= data_size_to_write;
 
+  // If there's any `data` left, put it in `buffer_`.
+  DCHECK_LT(data_size, buffer_size_);
+  memcpy(buffer_.get(), data_char, data_size);
+  buffer_occupied_ = data_size;
   return true;
 }
 
@@ -17,6 +17,8 @@
 
 #include <sys/types.h>
 
+#include <memory>
+
 #include "base/files/file_path.h"
 #include "util/ios/ios_intermediate_dump_format.h"
 
@@ -41,7 +43,8 @@ namespace internal {
 //! Note: All methods are `RUNS-DURING-CRASH`.
 class IOSIntermediateDumpWriter final {
  public:
-  IOSIntermediateDumpWriter() : buffer_occupied_(0), fd_(-1) {}
+  IOSIntermediateDumpWriter()
+      : buffer_(), buffer_size_(0), buffer_occupied_(0), fd_(-1) {}
 
   IOSIntermediateDumpWriter(const IOSIntermediateDumpWriter&) = delete;
   IOSIntermediateDumpWriter& operator=(const IOSIntermediateDumpWriter&) =
@@ -74,15 +77,24 @@ class IOSIntermediateDumpWriter final {
     kRootMapEnd = 0x07,
   };
 
+  //! \brief The default size of the write buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
   //! \brief Open and lock an intermediate dump file. This is the only method
   //!     in the writer class that is generally run outside of a crash.
   //!
   //! The client must invoke `Close()` before this object is destroyed.
   //!
+  //! The write buffer is allocated here, so that nothing needs to be allocated
+  //! while writing the dump during a crash.
+  //!
   //! \param[in] path The path to the intermediate dump.
+  //! \param[in] buffer_size The size of the write buffer. All writes to the
+  //!     file other than the final flush are a multiple of this size.
   //!
   //! \return On success, returns `true`, otherwise returns `false`.
-  bool Open(const base::FilePath& path);
+  bool Open(const base::FilePath& path,
+            size_t buffer_size = kDefaultBufferSize);
 
   //! \brief Completes writing the intermediate dump file and releases the
   //!     file handle.
@@ -231,19 +243,20 @@ class IOSIntermediateDumpWriter final {
 
   //! \return `true` if able to write \a data up to \a size. The \a data might
   //!     not be written to fd_  until `buffer_` is full or the writer is
-  //!     closed. All writes will be 4096 bytes (the size of your kBufferSize)
-  //!     except for the final flush, which might be partial.
+  //!     closed. All writes will be a multiple of `buffer_size_` except for
+  //!     the final flush, which might be partial. When \a data would fill
+  //!     `buffer_`, the buffered data and as much of \a data as keeps the
+  //!     write a multiple of `buffer_size_` are written together with a single
+  //!     `writev()`, without first copying \a data into `buffer_`.
   bool BufferedWrite(const void* data, size_t size);
 
   //! \return `true` if able to write `buffer_` up to `buffer_occupied_`.
   bool FlushWriteBuffer();
 
-  //! \brief The maximum size of the write buffer.
-  static constexpr size_t kBufferSize = 4096;
-
-  //! \brief The write data buffer and amount of that buffer occupied with data
-  //!   to be written.
-  char buffer_[kBufferSize];
+  //! \brief The write data buffer, its size, and amount of that buffer
+  //!   occupied with data to be written.
+  std::unique_ptr<char[]> buffer_;
+  size_t buffer_size_;
   size_t buffer_occupied_;
 
   int fd_;
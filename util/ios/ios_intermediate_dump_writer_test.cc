@@ -183,6 +183,25 @@ TEST_F(IOSIntermediateDumpWriterTest, MissingPropertyString) {
   ASSERT_EQ(contents, result);
 }
 
+TEST_F(IOSIntermediateDumpWriterTest, PropertyLargerThanBuffer) {
+  // Use a small buffer so that the property spans several buffers' worth of
+  // data, and is partly written directly and partly buffered.
+  constexpr size_t kBufferSize = 16;
+  EXPECT_TRUE(writer_->Open(path(), kBufferSize));
+  std::string value(100, 'v');
+  EXPECT_TRUE(writer_->AddPropertyBytes(
+      Key::kVersion, value.data(), value.length()));
+  EXPECT_TRUE(writer_->AddProperty(Key::kVersion, "version", 7));
+  EXPECT_TRUE(writer_->Close());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path(), &contents));
+  std::string result("\5\1\0\x64\0\0\0\0\0\0\0", 11);
+  result.append(value);
+  result.append("\5\1\0\a\0\0\0\0\0\0\0version", 18);
+  ASSERT_EQ(contents, result);
+}
+
 TEST_F(IOSIntermediateDumpWriterTest, BadProperty) {
   EXPECT_TRUE(writer_->Open(path()));
   ASSERT_FALSE(writer_->AddProperty(Key::kVersion, "version", -1));
@@ -14,26 +14,208 @@
 
 #include "util/ios/scoped_vm_read.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "util/ios/raw_logging.h"
 
 namespace crashpad {
 namespace internal {
 
+namespace {
+
+std::atomic<ScopedVMReadBatch*> g_active_batch;
+
+// Computes the page-aligned range spanning |length| bytes at |address|.
+// Returns false if the range overflows.
+bool PageRange(vm_address_t address,
+               size_t length,
+               vm_address_t* page_start,
+               vm_size_t* page_size) {
+  *page_start = trunc_page(address);
+  *page_size = round_page(address - *page_start + length);
+  return *page_size >= length;
+}
+
+}  // namespace
+
+ScopedVMReadBatch::ScopedVMReadBatch()
+    : regions_(), thread_(pthread_self()), clock_(0), active_(false) {
+  ScopedVMReadBatch* expected = nullptr;
+  active_ = g_active_batch.compare_exchange_strong(expected, this);
+}
+
+ScopedVMReadBatch::~ScopedVMReadBatch() {
+  if (!active_) {
+    return;
+  }
+  g_active_batch.store(nullptr);
+  for (Region& region : regions_) {
+    if (region.local) {
+      if (region.users) {
+        CRASHPAD_RAW_LOG("ScopedVMReadBatch destroyed while in use");
+      }
+      Discard(&region);
+    }
+  }
+}
+
+// static
+ScopedVMReadBatch* ScopedVMReadBatch::Current() {
+  ScopedVMReadBatch* batch = g_active_batch.load();
+  if (batch && pthread_equal(batch->thread_, pthread_self())) {
+    return batch;
+  }
+  return nullptr;
+}
+
+ScopedVMReadBatch::Region* ScopedVMReadBatch::Acquire(vm_address_t address,
+                                                      size_t length) {
+  ++clock_;
+  for (Region& region : regions_) {
+    if (region.local && address >= region.source &&
+        address - region.source <= region.size &&
+        length <= region.size - (address - region.source)) {
+      ++region.users;
+      region.last_used = clock_;
+      return &region;
+    }
+  }
+
+  vm_address_t start;
+  vm_size_t size;
+  if (!PageRange(address, length, &start, &size) ||
+      size > kMaximumRegionSize) {
+    return nullptr;
+  }
+  vm_address_t end = start + size;
+
+  // Fold in an idle region that overlaps or abuts the request, so that one
+  // read covers both. Otherwise use an unused slot or the least recently used
+  // idle region.
+  Region* slot = nullptr;
+  for (Region& region : regions_) {
+    if (region.local && !region.users && region.source <= end &&
+        start <= region.source + region.size) {
+      vm_address_t merged_start = std::min(start, region.source);
+      vm_address_t merged_end = std::max(end, region.source + region.size);
+      if (merged_end - merged_start <= kMaximumRegionSize) {
+        start = merged_start;
+        end = merged_end;
+        slot = &region;
+        break;
+      }
+    }
+  }
+  if (!slot) {
+    for (Region& region : regions_) {
+      if (!region.local) {
+        slot = &region;
+        break;
+      }
+      if (!region.users && (!slot || region.last_used < slot->last_used)) {
+        slot = &region;
+      }
+    }
+  }
+  if (!slot) {
+    return nullptr;
+  }
+  if (slot->local) {
+    Discard(slot);
+  }
+
+  // Read ahead of the request when the following pages are readable, falling
+  // back to just the requested pages.
+  kern_return_t kr = KERN_FAILURE;
+  if (end - start < kReadAheadSize && start + kReadAheadSize > start) {
+    kr = vm_read(mach_task_self(),
+                 start,
+                 kReadAheadSize,
+                 &slot->local,
+                 &slot->local_size);
+    if (kr == KERN_SUCCESS) {
+      end = start + kReadAheadSize;
+    }
+  }
+  if (kr != KERN_SUCCESS) {
+    kr = vm_read(mach_task_self(),
+                 start,
+                 end - start,
+                 &slot->local,
+                 &slot->local_size);
+  }
+  if (kr != KERN_SUCCESS) {
+    slot->local = 0;
+    return nullptr;
+  }
+
+  slot->source = start;
+  slot->size = end - start;
+  slot->users = 1;
+  slot->last_used = clock_;
+  return slot;
+}
+
+void ScopedVMReadBatch::Release(Region* region) {
+  if (region->users) {
+    --region->users;
+  }
+}
+
+void ScopedVMReadBatch::Discard(Region* region) {
+  kern_return_t kr =
+      vm_deallocate(mach_task_self(), region->local, region->local_size);
+  if (kr != KERN_SUCCESS) {
+    CRASHPAD_RAW_LOG_ERROR(kr, "vm_deallocate");
+  }
+  region->local = 0;
+  region->local_size = 0;
+  region->source = 0;
+  region->size = 0;
+  region->users = 0;
+}
+
 ScopedVMReadInternal::ScopedVMReadInternal()
-    : data_(0), region_start_(0), region_size_(0) {}
+    : data_(0),
+      region_start_(0),
+      region_size_(0),
+      batch_(nullptr),
+      batch_region_(nullptr) {}
 
 ScopedVMReadInternal::~ScopedVMReadInternal() {
   Reset();
 }
 
 bool ScopedVMReadInternal::Read(const void* data, const size_t data_length) {
+  ScopedVMReadBatch* batch = ScopedVMReadBatch::Current();
+  if (!batch) {
+    return ReadDirect(data, data_length);
+  }
+
+  Reset();
+  vm_address_t data_address = reinterpret_cast<vm_address_t>(data);
+  ScopedVMReadBatch::Region* region = batch->Acquire(data_address, data_length);
+  if (!region) {
+    return ReadDirect(data, data_length);
+  }
+  batch_ = batch;
+  batch_region_ = region;
+  data_ = region->local + (data_address - region->source);
+  return true;
+}
+
+bool ScopedVMReadInternal::ReadDirect(const void* data,
+                                      const size_t data_length) {
   Reset();
 
   vm_address_t data_address = reinterpret_cast<vm_address_t>(data);
-  vm_address_t page_region_address = trunc_page(data_address);
-  vm_size_t page_region_size =
-      round_page(data_address - page_region_address + data_length);
-  if (page_region_size < data_length) {
+  vm_address_t page_region_address;
+  vm_size_t page_region_size;
+  if (!PageRange(data_address,
+                 data_length,
+                 &page_region_address,
+                 &page_region_size)) {
     CRASHPAD_RAW_LOG("ScopedVMRead data_length overflow");
     return false;
   }
@@ -53,6 +235,12 @@ bool ScopedVMReadInternal::Read(const void* data, const size_t data_length) {
 }
 
 void ScopedVMReadInternal::Reset() {
+  if (batch_region_) {
+    batch_->Release(batch_region_);
+    batch_ = nullptr;
+    batch_region_ = nullptr;
+    data_ = 0;
+  }
   if (!region_start_) {
     return;
   }
@@ -16,11 +16,91 @@
 #define CRASHPAD_UTIL_IOS_SCOPED_VM_READ_H_
 
 #include <mach/mach.h>
-
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
 
 namespace crashpad {
 namespace internal {
 
+//! \brief Batches the `vm_read()` calls made by ScopedVMRead on the thread
+//!     that creates it.
+//!
+//! While an object of this class is alive, ScopedVMRead::Read() calls made on
+//! the creating thread are served from a small, fixed set of page-spanning
+//! regions. Each miss reads ahead of the requested range and folds in any
+//! idle region it overlaps or abuts, so that neighboring objects, such as
+//! consecutive structures or linked-list nodes that share pages, are served
+//! without further `vm_read()` or `vm_deallocate()` calls.
+//!
+//! Reads served from a batch reflect memory as of the `vm_read()` that filled
+//! the region, which suits capturing a point-in-time snapshot. Reads that must
+//! observe memory at the time of the call, or that are too large to be worth
+//! caching, use ScopedVMRead::ReadDirect().
+//!
+//! Only one batch may be active at a time. A batch created while another is
+//! active does nothing. Every ScopedVMRead that reads through a batch must
+//! be destroyed or reset before the batch is.
+//!
+//! Note: RUNS-DURING-CRASH.
+class ScopedVMReadBatch {
+ public:
+  ScopedVMReadBatch();
+
+  ScopedVMReadBatch(const ScopedVMReadBatch&) = delete;
+  ScopedVMReadBatch& operator=(const ScopedVMReadBatch&) = delete;
+
+  ~ScopedVMReadBatch();
+
+ private:
+  friend class ScopedVMReadInternal;
+
+  struct Region {
+    // The address and size of the range read in this task.
+    vm_address_t source;
+    vm_size_t size;
+
+    // The region returned by vm_read(), or 0 if this slot is unused.
+    vm_address_t local;
+    mach_msg_type_number_t local_size;
+
+    // The number of ScopedVMReads currently referring to this region.
+    uint32_t users;
+
+    // The value of clock_ when this region was last used.
+    uint32_t last_used;
+  };
+
+  //! \brief Returns the active batch if it was created on the calling thread,
+  //!     otherwise `nullptr`.
+  static ScopedVMReadBatch* Current();
+
+  //! \brief Returns a region covering \a length bytes at \a address, reading
+  //!     one if necessary, and adds a user to it. Returns `nullptr` if the
+  //!     request can't be served from the batch.
+  Region* Acquire(vm_address_t address, size_t length);
+
+  //! \brief Removes a user from \a region.
+  void Release(Region* region);
+
+  //! \brief Deallocates the memory of \a region and marks it unused.
+  void Discard(Region* region);
+
+  //! \brief The number of regions that may be held at once.
+  static constexpr size_t kRegionCount = 32;
+
+  //! \brief The minimum size of each read, to serve nearby objects.
+  static constexpr vm_size_t kReadAheadSize = 64 * 1024;
+
+  //! \brief Requests larger than this are not batched.
+  static constexpr vm_size_t kMaximumRegionSize = 256 * 1024;
+
+  Region regions_[kRegionCount];
+  pthread_t thread_;
+  uint32_t clock_;
+  bool active_;
+};
+
 //! \brief Non-templated internal class to be used by ScopedVMRead.
 //!
 //! Note: RUNS-DURING-CRASH.
@@ -43,6 +123,10 @@ class ScopedVMReadInternal {
   //!   on failure
   bool Read(const void* data, size_t data_length);
 
+  //! \brief Like Read(), but always calls `vm_read()`, bypassing any active
+  //!     ScopedVMReadBatch.
+  bool ReadDirect(const void* data, size_t data_length);
+
   vm_address_t data() const { return data_; }
 
  private:
@@ -58,6 +142,10 @@ class ScopedVMReadInternal {
 
   // The size of the region returned by vm_read().
   mach_msg_type_number_t region_size_;
+
+  // The batch and region serving data_, if it was read through a batch.
+  ScopedVMReadBatch* batch_;
+  ScopedVMReadBatch::Region* batch_region_;
 };
 
 //! \brief A scoped wrapper for calls to `vm_read` and `vm_deallocate`.  Allows
@@ -95,6 +183,19 @@ class ScopedVMRead {
     return Read(reinterpret_cast<T*>(address), count);
   }
 
+  //! \brief Like Read(), but always calls `vm_read()`, bypassing any active
+  //!     ScopedVMReadBatch, so that the data reflects memory at the time of
+  //!     the call.
+  //!
+  //! \param[in] data Memory to be read by vm_read.
+  //! \param[in] count Length of \a data.
+  //!
+  //! \return `true` if all \a data was read. Returns false on failure.
+  bool ReadDirect(const void* data, size_t count = 1) {
+    size_t data_length = count * sizeof(T);
+    return internal_.ReadDirect(data, data_length);
+  }
+
   //! \brief Returns the pointer to memory safe to read during the in-process
   //!   crash handler.
   T* operator->() const { return get(); }
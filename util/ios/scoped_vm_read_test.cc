@@ -84,6 +84,70 @@ TEST(ScopedVMReadTest, MissingMiddleVM) {
   ASSERT_TRUE(vmread_missing_middle.Read(region, page_size));
 }
 
+TEST(ScopedVMReadTest, Batch) {
+  internal::ScopedVMReadBatch batch;
+
+  timeval times[4];
+  for (timeval& time : times) {
+    EXPECT_TRUE(gettimeofday(&time, nullptr) == 0);
+  }
+
+  // Nearby objects are both served while in use at once.
+  internal::ScopedVMRead<timeval> vmread_first;
+  internal::ScopedVMRead<timeval> vmread_last;
+  ASSERT_TRUE(vmread_first.Read(&times[0]));
+  ASSERT_TRUE(vmread_last.Read(&times[3]));
+  EXPECT_EQ(vmread_first->tv_sec, times[0].tv_sec);
+  EXPECT_EQ(vmread_first->tv_usec, times[0].tv_usec);
+  EXPECT_EQ(vmread_last->tv_sec, times[3].tv_sec);
+  EXPECT_EQ(vmread_last->tv_usec, times[3].tv_usec);
+
+  // Unreadable memory still fails.
+  internal::ScopedVMRead<char> vmread_bad;
+  EXPECT_FALSE(vmread_bad.Read(reinterpret_cast<void*>(0x1000), 100));
+  vm_address_t invalid_address = 1;
+  EXPECT_FALSE(vmread_bad.Read(&invalid_address, -1));
+
+  // ReadDirect() reflects memory at the time of the call.
+  times[0].tv_sec = 1234;
+  internal::ScopedVMRead<timeval> vmread_direct;
+  ASSERT_TRUE(vmread_direct.ReadDirect(&times[0]));
+  EXPECT_EQ(vmread_direct->tv_sec, 1234);
+}
+
+TEST(ScopedVMReadTest, BatchMissingMiddleVM) {
+  char* region;
+  vm_size_t page_size = getpagesize();
+  vm_size_t region_size = page_size * 3;
+  kern_return_t kr = vm_allocate(mach_task_self(),
+                                 reinterpret_cast<vm_address_t*>(&region),
+                                 region_size,
+                                 VM_FLAGS_ANYWHERE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_allocate");
+
+  base::apple::ScopedMachVM vm_owner(reinterpret_cast<vm_address_t>(region),
+                                     region_size);
+  memset(region, 'a', region_size);
+
+  internal::ScopedVMReadBatch batch;
+  internal::ScopedVMRead<char> vmread_missing_middle;
+  ASSERT_TRUE(vmread_missing_middle.Read(region, region_size));
+
+  // Dealloc middle page.
+  kr = vm_deallocate(mach_task_self(),
+                     reinterpret_cast<vm_address_t>(region + page_size),
+                     page_size);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_deallocate");
+
+  // The batch continues to serve the memory as it was when it was read.
+  ASSERT_TRUE(vmread_missing_middle.Read(region, region_size));
+  EXPECT_EQ(vmread_missing_middle.get()[page_size], 'a');
+
+  // A direct read observes the missing page.
+  EXPECT_FALSE(vmread_missing_middle.ReadDirect(region, region_size));
+  ASSERT_TRUE(vmread_missing_middle.ReadDirect(region, page_size));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,112 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/cpu_affinity.h"
+
+#include <errno.h>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
+
+namespace crashpad {
+
+namespace {
+
+// Larger than any kernel’s NR_CPUS, to keep a mistyped range from allocating
+// an enormous set.
+constexpr int kMaxCPU = 65535;
+
+bool ParseCPU(const std::string& string, int* cpu) {
+  // StringToNumber() accepts a sign, which isn’t valid here.
+  if (string.empty() || string[0] < '0' || string[0] > '9') {
+    return false;
+  }
+  return StringToNumber(string, cpu) && *cpu <= kMaxCPU;
+}
+
+}  // namespace
+
+bool ParseCPUList(const std::string& list, std::vector<int>* cpus) {
+  std::vector<int> parsed;
+  for (const std::string& item : SplitString(list, ',')) {
+    std::string first_string, last_string;
+    int first, last;
+    if (SplitStringFirst(item, '-', &first_string, &last_string)) {
+      if (!ParseCPU(first_string, &first) || !ParseCPU(last_string, &last) ||
+          last < first) {
+        return false;
+      }
+    } else if (ParseCPU(item, &first)) {
+      last = first;
+    } else {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      parsed.push_back(cpu);
+    }
+  }
+  if (parsed.empty()) {
+    return false;
+  }
+
+  std::sort(parsed.begin(), parsed.end());
+  parsed.erase(std::unique(parsed.begin(), parsed.end()), parsed.end());
+  cpus->swap(parsed);
+  return true;
+}
+
+bool SetCurrentThreadCPUAffinity(const std::vector<int>& cpus) {
+  DCHECK(!cpus.empty());
+
+  // Size the set for the largest CPU number, which may be beyond
+  // CPU_SETSIZE.
+  const int cpu_count = *std::max_element(cpus.begin(), cpus.end()) + 1;
+  cpu_set_t* set = CPU_ALLOC(cpu_count);
+  if (!set) {
+    LOG(ERROR) << "CPU_ALLOC";
+    return false;
+  }
+  const size_t set_size = CPU_ALLOC_SIZE(cpu_count);
+  CPU_ZERO_S(set_size, set);
+  for (int cpu : cpus) {
+    CPU_SET_S(cpu, set_size, set);
+  }
+  // A pid of 0 names the calling thread, not the whole process.
+  const int rv = sched_setaffinity(0, set_size, set);
+  CPU_FREE(set);
+  if (rv != 0) {
+    PLOG(ERROR) << "sched_setaffinity";
+    return false;
+  }
+
+  // C libraries don’t provide a wrapper for set_mempolicy(). MPOL_LOCAL
+  // allocates from the node of the CPU that the allocating thread is running
+  // on.
+  if (syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0) != 0 &&
+      errno != ENOSYS) {
+    PLOG(ERROR) << "set_mempolicy";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace crashpad
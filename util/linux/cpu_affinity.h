@@ -0,0 +1,53 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_CPU_AFFINITY_H_
+#define CRASHPAD_UTIL_LINUX_CPU_AFFINITY_H_
+
+#include <string>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief Parses a list of CPU numbers.
+//!
+//! The list has the format used by `taskset --cpu-list` and by files like
+//! `/sys/devices/system/node/node0/cpulist`: comma-separated CPU numbers and
+//! inclusive ranges of them, such as `0-3,8,10-11`.
+//!
+//! \param[in] list The list to parse.
+//! \param[out] cpus The CPU numbers in \a list, sorted and without duplicates.
+//!
+//! \return `true` on success. `false` if \a list is empty or malformed, in
+//!     which case \a cpus is unchanged.
+bool ParseCPUList(const std::string& list, std::vector<int>* cpus);
+
+//! \brief Restricts the calling thread to \a cpus and has it allocate memory
+//!     from the NUMA node that it runs on.
+//!
+//! Threads created by the calling thread afterwards inherit both settings.
+//! When \a cpus all belong to one node, the memory that the thread and its
+//! descendants allocate comes from that node. A memory policy already
+//! inherited from the process’ parent, such as one set with `numactl
+//! --interleave`, is replaced. On kernels built without NUMA support, only the
+//! CPU affinity is set.
+//!
+//! \param[in] cpus The CPU numbers to run on, which must not be empty.
+//!
+//! \return `true` on success. `false` on failure, with a message logged.
+bool SetCurrentThreadCPUAffinity(const std::vector<int>& cpus);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_CPU_AFFINITY_H_
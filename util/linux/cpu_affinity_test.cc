@@ -0,0 +1,83 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/cpu_affinity.h"
+
+#include <sched.h>
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(CPUAffinity, ParseCPUList) {
+  std::vector<int> cpus;
+  ASSERT_TRUE(ParseCPUList("3", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int>{3}));
+  ASSERT_TRUE(ParseCPUList("0-3,8,10-11", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  ASSERT_TRUE(ParseCPUList("6,2-4,3,6-6", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int>{2, 3, 4, 6}));
+
+  static constexpr const char* kInvalid[] = {
+      "", ",", "1,", ",1", "a", "-1", "+1", "1-", "-", "3-2", "1-2-3",
+      " 1", "1 ", "65536", "0-65536",
+  };
+  for (const char* list : kInvalid) {
+    SCOPED_TRACE(list);
+    cpus = {7};
+    EXPECT_FALSE(ParseCPUList(list, &cpus));
+    EXPECT_EQ(cpus, (std::vector<int>{7}));
+  }
+}
+
+TEST(CPUAffinity, SetCurrentThreadCPUAffinity) {
+  cpu_set_t allowed;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed)) {
+    ++cpu;
+  }
+
+  // Use another thread so that the test’s own thread isn’t restricted.
+  std::thread thread([cpu]() {
+    ASSERT_TRUE(SetCurrentThreadCPUAffinity({cpu}));
+    cpu_set_t set;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+    EXPECT_EQ(CPU_COUNT(&set), 1);
+    EXPECT_TRUE(CPU_ISSET(cpu, &set));
+    EXPECT_EQ(sched_getcpu(), cpu);
+
+    // Threads created afterwards inherit the affinity.
+    std::thread child([cpu]() {
+      cpu_set_t child_set;
+      ASSERT_EQ(sched_getaffinity(0, sizeof(child_set), &child_set), 0);
+      EXPECT_EQ(CPU_COUNT(&child_set), 1);
+      EXPECT_TRUE(CPU_ISSET(cpu, &child_set));
+    });
+    child.join();
+  });
+  thread.join();
+
+  cpu_set_t set;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+  EXPECT_TRUE(CPU_EQUAL(&set, &allowed));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -16,6 +16,7 @@
 
 #include <utility>
 
+#include "base/check_op.h"
 #include "util/file/file_io.h"
 #include "util/linux/proc_task_reader.h"
 
@@ -24,6 +25,7 @@ namespace crashpad {
 DirectPtraceConnection::DirectPtraceConnection()
     : PtraceConnection(),
       attachments_(),
+      attached_threads_(),
       memory_(),
       pid_(-1),
       ptracer_(/* can_log= */ true),
@@ -43,20 +45,86 @@ bool DirectPtraceConnection::Initialize(pid_t pid) {
   return true;
 }
 
+bool DirectPtraceConnection::AttachAllThreads() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Threads can still be started until every thread is stopped, so read the
+  // thread list until it has no threads that haven't already been tried.
+  std::set<pid_t> tried_threads(attached_threads_);
+  while (true) {
+    std::vector<pid_t> thread_ids;
+    if (!ReadThreadIDs(pid_, &thread_ids)) {
+      return false;
+    }
+
+    std::vector<pid_t> new_thread_ids;
+    for (pid_t tid : thread_ids) {
+      if (tried_threads.insert(tid).second) {
+        new_thread_ids.push_back(tid);
+      }
+    }
+    if (new_thread_ids.empty()) {
+      return true;
+    }
+
+    // A thread may exit before it can be attached, and is left out.
+    std::vector<bool> results(new_thread_ids.size(), false);
+    AttachThreads(new_thread_ids, &results);
+  }
+}
+
 pid_t DirectPtraceConnection::GetProcessID() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return pid_;
 }
 
 bool DirectPtraceConnection::Attach(pid_t tid) {
+  if (attached_threads_.count(tid)) {
+    return true;
+  }
+
   std::unique_ptr<ScopedPtraceAttach> attach(new ScopedPtraceAttach);
   if (!attach->ResetAttach(tid)) {
     return false;
   }
   attachments_.push_back(std::move(attach));
+  attached_threads_.insert(tid);
   return true;
 }
 
+void DirectPtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                           std::vector<bool>* results) {
+  DCHECK_EQ(results->size(), tids.size());
+
+  // Threads that are already attached can't be seized again.
+  std::vector<pid_t> new_tids;
+  std::vector<size_t> new_tid_indices;
+  for (size_t index = 0; index < tids.size(); ++index) {
+    if (attached_threads_.count(tids[index])) {
+      (*results)[index] = true;
+    } else {
+      new_tids.push_back(tids[index]);
+      new_tid_indices.push_back(index);
+    }
+  }
+  if (new_tids.empty()) {
+    return;
+  }
+
+  std::unique_ptr<bool[]> attached(new bool[new_tids.size()]);
+  PtraceSeizeThreads(new_tids.data(), new_tids.size(), attached.get());
+  for (size_t index = 0; index < new_tids.size(); ++index) {
+    if (!attached[index]) {
+      continue;
+    }
+    auto attach = std::make_unique<ScopedPtraceAttach>();
+    attach->ResetAttached(new_tids[index]);
+    attachments_.push_back(std::move(attach));
+    attached_threads_.insert(new_tids[index]);
+    (*results)[new_tid_indices[index]] = true;
+  }
+}
+
 bool DirectPtraceConnection::Is64Bit() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return ptracer_.Is64Bit();
@@ -67,6 +135,13 @@ bool DirectPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
   return ptracer_.GetThreadInfo(tid, info);
 }
 
+bool DirectPtraceConnection::GetExtendedRegisterState(
+    pid_t tid,
+    ExtendedRegisterState* state) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return ptracer_.GetExtendedRegisterState(tid, state);
+}
+
 bool DirectPtraceConnection::ReadFileContents(const base::FilePath& path,
                                               std::string* contents) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
@@ -86,6 +161,12 @@ bool DirectPtraceConnection::Threads(std::vector<pid_t>* threads) {
   return ReadThreadIDs(pid_, threads);
 }
 
+bool DirectPtraceConnection::ReadThreadDetails(
+    std::vector<ProcTaskInfo>* tasks) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return ReadTaskInfo(pid_, tasks);
+}
+
 ssize_t DirectPtraceConnection::ReadUpTo(VMAddress address,
                                          size_t size,
                                          void* buffer) {
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "util/linux/ptrace_connection.h"
@@ -50,20 +51,37 @@ class DirectPtraceConnection : public PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   bool Initialize(pid_t pid);
 
+  //! \brief Attaches every thread of the process now, rather than as each is
+  //!     passed to Attach() or AttachThreads().
+  //!
+  //! Threads started while this runs are also attached. Later calls to
+  //! Attach() and AttachThreads() succeed for threads that are already
+  //! attached without attaching them again.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged. Any
+  //!     threads that were attached remain attached.
+  bool AttachAllThreads();
+
   // PtraceConnection:
 
   pid_t GetProcessID() override;
   bool Attach(pid_t tid) override;
+  void AttachThreads(const std::vector<pid_t>& tids,
+                     std::vector<bool>* results) override;
   bool Is64Bit() override;
   bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetExtendedRegisterState(pid_t tid,
+                                ExtendedRegisterState* state) override;
   bool ReadFileContents(const base::FilePath& path,
                         std::string* contents) override;
   ProcessMemoryLinux* Memory() override;
   bool Threads(std::vector<pid_t>* threads) override;
+  bool ReadThreadDetails(std::vector<ProcTaskInfo>* tasks) override;
   ssize_t ReadUpTo(VMAddress, size_t size, void* buffer) override;
 
  private:
   std::vector<std::unique_ptr<ScopedPtraceAttach>> attachments_;
+  std::set<pid_t> attached_threads_;
   std::unique_ptr<ProcessMemoryLinux> memory_;
   pid_t pid_;
   Ptracer ptracer_;
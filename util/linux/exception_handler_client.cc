@@ -15,8 +15,11 @@
 #include "util/linux/exception_handler_client.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <stdlib.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -62,10 +65,99 @@ class ScopedSigprocmaskRestore {
   bool mask_is_set_;
 };
 
+// A copy of this process made for the handler to capture in its place. The
+// copy waits until this object is destroyed, and then exits.
+class ScopedForkSnapshot {
+ public:
+  ScopedForkSnapshot()
+      : old_sigchld_action_(),
+        release_fd_(),
+        pid_(-1),
+        restore_sigchld_action_(false) {}
+
+  ScopedForkSnapshot(const ScopedForkSnapshot&) = delete;
+  ScopedForkSnapshot& operator=(const ScopedForkSnapshot&) = delete;
+
+  ~ScopedForkSnapshot() {
+    if (pid_ > 0) {
+      release_fd_.reset();
+
+      // The application may have reaped the copy itself.
+      pid_t child = HANDLE_EINTR(waitpid(pid_, nullptr, 0));
+      if (child < 0) {
+        DPLOG_IF(ERROR, errno != ECHILD) << "waitpid";
+      } else {
+        DCHECK_EQ(child, pid_);
+      }
+    }
+
+    if (restore_sigchld_action_ &&
+        sigaction(SIGCHLD, &old_sigchld_action_, nullptr) != 0) {
+      DPLOG(ERROR) << "sigaction";
+    }
+  }
+
+  // Creates the copy, allowing tracer to trace it. Returns the copy's process
+  // ID, or -1 on failure.
+  //
+  // The handler has stopped every other thread, and any of them may hold locks
+  // that fork() takes or that pthread_atfork() handlers need, so the copy is
+  // made with a raw clone() system call and makes only raw system calls.
+  pid_t Fork(pid_t tracer) {
+    DCHECK_LT(pid_, 0);
+
+    int pipe_fds[2];
+    if (pipe2(pipe_fds, O_CLOEXEC) != 0) {
+      return -1;
+    }
+    ScopedFileHandle wait_fd(pipe_fds[0]);
+    release_fd_.reset(pipe_fds[1]);
+
+    // The copy must be reaped here, not by a SIGCHLD handler that the
+    // application may have installed.
+    struct sigaction default_action = {};
+    sigemptyset(&default_action.sa_mask);
+    default_action.sa_handler = SIG_DFL;
+    restore_sigchld_action_ =
+        sigaction(SIGCHLD, &default_action, &old_sigchld_action_) == 0;
+
+    pid_t pid = syscall(SYS_clone, SIGCHLD, 0, 0, 0, 0);
+    if (pid < 0) {
+      release_fd_.reset();
+      return -1;
+    }
+
+    if (pid == 0) {
+      syscall(SYS_close, pipe_fds[1]);
+      if (tracer > 0) {
+        syscall(SYS_prctl, PR_SET_PTRACER, tracer, 0, 0, 0);
+      }
+
+      // Returns at end-of-file, once the original process has closed the
+      // other end of the pipe.
+      char c;
+      while (syscall(SYS_read, pipe_fds[0], &c, sizeof(c)) < 0 &&
+             errno == EINTR) {
+      }
+      syscall(SYS_exit_group, EXIT_SUCCESS);
+    }
+
+    pid_ = pid;
+    return pid;
+  }
+
+ private:
+  struct sigaction old_sigchld_action_;
+  ScopedFileHandle release_fd_;
+  pid_t pid_;
+  bool restore_sigchld_action_;
+};
+
 }  // namespace
 
 ExceptionHandlerClient::ExceptionHandlerClient(int sock, bool multiple_clients)
-    : server_sock_(sock),
+    : shared_context_(nullptr),
+      server_sock_(sock),
       ptracer_(-1),
       can_set_ptracer_(true),
       multiple_clients_(multiple_clients) {}
@@ -120,6 +212,11 @@ void ExceptionHandlerClient::SetCanSetPtracer(bool can_set_ptracer) {
   can_set_ptracer_ = can_set_ptracer;
 }
 
+void ExceptionHandlerClient::SetSharedCrashContext(
+    const SharedCrashContext* shared_context) {
+  shared_context_ = shared_context;
+}
+
 int ExceptionHandlerClient::SignalCrashDump(
     const ExceptionHandlerProtocol::ClientInformation& info,
     VMAddress stack_pointer) {
@@ -153,11 +250,17 @@ int ExceptionHandlerClient::SendCrashDumpRequest(
       ExceptionHandlerProtocol::ClientToServerMessage::kTypeCrashDumpRequest;
   message.requesting_thread_stack_address = stack_pointer;
   message.client_info = info;
+  if (shared_context_) {
+    int handle = shared_context_->Handle();
+    return UnixCredentialSocket::SendMsg(
+        server_sock_, &message, sizeof(message), &handle, 1);
+  }
   return UnixCredentialSocket::SendMsg(server_sock_, &message, sizeof(message));
 }
 
 int ExceptionHandlerClient::WaitForCrashDumpComplete() {
   ExceptionHandlerProtocol::ServerToClientMessage message;
+  ScopedForkSnapshot fork_snapshot;
 
   // If the server hangs up, ReadFileExactly will return false without setting
   // errno.
@@ -208,6 +311,23 @@ int ExceptionHandlerClient::WaitForCrashDumpComplete() {
         continue;
       }
 
+      case ExceptionHandlerProtocol::ServerToClientMessage::
+          kTypePrepareForkSnapshot: {
+        pid_t tid = sys_gettid();
+        if (!WriteFile(server_sock_, &tid, sizeof(tid))) {
+          return errno;
+        }
+        continue;
+      }
+
+      case ExceptionHandlerProtocol::ServerToClientMessage::kTypeForkSnapshot: {
+        pid_t pid = fork_snapshot.Fork(message.pid);
+        if (!WriteFile(server_sock_, &pid, sizeof(pid))) {
+          return errno;
+        }
+        continue;
+      }
+
       case ExceptionHandlerProtocol::ServerToClientMessage::kTypeCredentials:
         DCHECK(false);
         continue;
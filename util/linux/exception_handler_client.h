@@ -19,6 +19,7 @@
 #include <sys/types.h>
 
 #include "util/linux/exception_handler_protocol.h"
+#include "util/linux/shared_crash_context.h"
 
 namespace crashpad {
 
@@ -68,6 +69,13 @@ class ExceptionHandlerClient {
   //! \param[in] can_set_ptracer Whether SetPtracer should be enabled.
   void SetCanSetPtracer(bool can_set_ptracer);
 
+  //! \brief Sets a SharedCrashContext to send to the handler with crash dump
+  //!     requests.
+  //!
+  //! \param[in] shared_context The context, which must remain valid for the
+  //!     lifetime of this object, or `nullptr` to send none.
+  void SetSharedCrashContext(const SharedCrashContext* shared_context);
+
  private:
   int SendCrashDumpRequest(
       const ExceptionHandlerProtocol::ClientInformation& info,
@@ -76,6 +84,7 @@ class ExceptionHandlerClient {
                       VMAddress stack_pointer);
   int WaitForCrashDumpComplete();
 
+  const SharedCrashContext* shared_context_;  // weak
   int server_sock_;
   pid_t ptracer_;
   bool can_set_ptracer_;
@@ -20,12 +20,16 @@ namespace crashpad {
 
 ExceptionHandlerProtocol::ClientInformation::ClientInformation()
     : exception_information_address(0),
-      sanitization_information_address(0)
+      sanitization_information_address(0),
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
-      ,
-      crash_loop_before_time(0)
+      crash_loop_before_time(0),
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
-{
+      fork_snapshot(kBoolFalse),
+      capture_process_group(kBoolFalse),
+      tenant(0),
+      lightweight(kBoolFalse),
+      annotation_generation(0),
+      annotation_list_address(0) {
 }
 
 ExceptionHandlerProtocol::ClientToServerMessage::ClientToServerMessage()
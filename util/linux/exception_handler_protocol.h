@@ -57,6 +57,51 @@ class ExceptionHandlerProtocol {
     //!     `/sbin/crash_reporter`.
     uint64_t crash_loop_before_time;
 #endif
+
+    //! \brief Requests that the handler capture the client from a copy of
+    //!     itself made by `fork()`, so that the client only pauses while the
+    //!     copy is made.
+    //!
+    //! This is only honored for a client on a private connection, when the
+    //! handler can `ptrace` the client directly. The client must handle
+    //! kTypePrepareForkSnapshot and kTypeForkSnapshot while waiting for the
+    //! dump to complete.
+    Bool fork_snapshot;
+
+    //! \brief Requests that the handler capture the other processes in the
+    //!     client's process group along with the client, in one coordinated
+    //!     pass.
+    //!
+    //! Every process is stopped before any is captured, and each gets its own
+    //! report, linked to the others by a shared `"crashpad_process_group"`
+    //! process annotation. Only processes running as the client's user are
+    //! captured. This is only honored when the handler can `ptrace` the client
+    //! directly, and takes precedence over #fork_snapshot.
+    Bool capture_process_group;
+
+    //! \brief The tenant of a handler hosting several crash report databases
+    //!     that the client’s reports belong to.
+    //!
+    //! Tenant `0` is the handler’s default tenant. A handler hosting a single
+    //! database, or none with the requested index, uses its default tenant.
+    uint32_t tenant;
+
+    //! \brief Requests that the handler capture only the requesting thread
+    //!     and the client's annotations that have changed since
+    //!     #annotation_generation, leaving out other threads and memory.
+    //!
+    //! See ProcessSnapshotLinux::SetLightweightCapture().
+    Bool lightweight;
+
+    //! \brief For a #lightweight request, the generation of the AnnotationList
+    //!     at #annotation_list_address since which changed annotations are
+    //!     captured.
+    uint32_t annotation_generation;
+
+    //! \brief For a #lightweight request, the address in the client's address
+    //!     space of the AnnotationList whose changed annotations are captured,
+    //!     or 0 if there is no such list.
+    VMAddress annotation_list_address;
   };
 
   //! \brief The signal used to indicate a crash dump is complete.
@@ -114,12 +159,23 @@ class ExceptionHandlerProtocol {
 
       //! \brief Indicicates that the handler was unable to produce a crash
       //!     dump.
-      kTypeCrashDumpFailed
+      kTypeCrashDumpFailed,
+
+      //! \brief Indicates that the client should respond with the thread ID
+      //!     of the thread waiting for the crash dump, which will be left
+      //!     running while the handler stops the client's other threads.
+      kTypePrepareForkSnapshot,
+
+      //! \brief Indicates that the client should `fork` a copy of itself
+      //!     that waits until the crash dump is complete, and respond with the
+      //!     copy's process ID, or -1 on failure.
+      kTypeForkSnapshot
     };
 
     Type type;
 
-    //! \brief The handler's process ID. Valid for kTypeSetPtracer.
+    //! \brief The handler's process ID. Valid for kTypeSetPtracer and
+    //!     kTypeForkSnapshot.
     pid_t pid;
   };
 
@@ -0,0 +1,266 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/fork_snapshot_connection.h"
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <memory>
+#include <set>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "util/file/file_io.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/linux/proc_stat_reader.h"
+#include "util/linux/proc_task_reader.h"
+#include "util/linux/ptracer.h"
+#include "util/linux/scoped_ptrace_attach.h"
+
+namespace crashpad {
+
+namespace {
+
+bool SendMessageToClient(
+    int client_sock,
+    ExceptionHandlerProtocol::ServerToClientMessage::Type type) {
+  ExceptionHandlerProtocol::ServerToClientMessage message = {};
+  message.type = type;
+  message.pid = getpid();
+  return LoggingWriteFile(client_sock, &message, sizeof(message));
+}
+
+// The client's other threads stay stopped while it makes the copy, so a client
+// that doesn't reply in this time is captured directly instead.
+constexpr int kForkSnapshotTimeoutMilliseconds = 1000;
+
+bool ReadSnapshotProcessID(int client_sock, pid_t* snapshot_pid) {
+  pollfd client_poll = {};
+  client_poll.fd = client_sock;
+  client_poll.events = POLLIN;
+  int result =
+      HANDLE_EINTR(poll(&client_poll, 1, kForkSnapshotTimeoutMilliseconds));
+  if (result < 0) {
+    PLOG(ERROR) << "poll";
+    return false;
+  }
+  if (result == 0) {
+    LOG(ERROR) << "timed out waiting for the client to fork a snapshot";
+    return false;
+  }
+  return LoggingReadFileExactly(
+      client_sock, snapshot_pid, sizeof(*snapshot_pid));
+}
+
+// The client chooses which process ID to send, so only a child of the client
+// may be traced in its place.
+bool IsChildOf(pid_t child, pid_t parent) {
+  std::string contents;
+  if (!LoggingReadEntireFile(
+          base::FilePath(base::StringPrintf("/proc/%d/stat", child)),
+          &contents)) {
+    return false;
+  }
+
+  ProcStatReader stat;
+  pid_t ppid;
+  if (!stat.InitializeWithContents(contents) || !stat.ParentProcessID(&ppid)) {
+    return false;
+  }
+  if (ppid != parent) {
+    LOG(ERROR) << "snapshot " << child << " is not a child of " << parent;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+ForkSnapshotConnection::ForkSnapshotConnection()
+    : PtraceConnection(),
+      threads_(),
+      snapshot_(),
+      maps_path_(),
+      snapshot_maps_path_(),
+      pid_(-1),
+      initialized_() {}
+
+ForkSnapshotConnection::~ForkSnapshotConnection() {}
+
+bool ForkSnapshotConnection::Initialize(int client_sock, pid_t pid) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  if (!SendMessageToClient(client_sock,
+                           ExceptionHandlerProtocol::ServerToClientMessage::
+                               kTypePrepareForkSnapshot)) {
+    return false;
+  }
+  pid_t requesting_thread_id;
+  if (!LoggingReadFileExactly(
+          client_sock, &requesting_thread_id, sizeof(requesting_thread_id))) {
+    return false;
+  }
+
+  // Stop every thread but the one that will make the copy. Threads can still
+  // be started until every other thread is stopped, so read the thread list
+  // until it has no threads that haven't already been seen.
+  Ptracer ptracer(/* can_log= */ true);
+  bool ptracer_initialized = false;
+  std::vector<std::unique_ptr<ScopedPtraceAttach>> attachments;
+  std::set<pid_t> seen_threads;
+  seen_threads.insert(requesting_thread_id);
+  bool found_new_thread = true;
+  while (found_new_thread) {
+    found_new_thread = false;
+
+    std::vector<pid_t> thread_ids;
+    if (!ReadThreadIDs(pid, &thread_ids)) {
+      return false;
+    }
+
+    for (pid_t tid : thread_ids) {
+      if (!seen_threads.insert(tid).second) {
+        continue;
+      }
+      found_new_thread = true;
+
+      // A thread may exit before it can be attached, and is left out.
+      auto attachment = std::make_unique<ScopedPtraceAttach>();
+      if (!attachment->ResetAttach(tid)) {
+        continue;
+      }
+      if (!ptracer_initialized) {
+        if (!ptracer.Initialize(tid)) {
+          return false;
+        }
+        ptracer_initialized = true;
+      }
+
+      ThreadInfo info;
+      if (!ptracer.GetThreadInfo(tid, &info)) {
+        continue;
+      }
+      threads_[tid] = info;
+      attachments.push_back(std::move(attachment));
+    }
+  }
+
+  if (!SendMessageToClient(
+          client_sock,
+          ExceptionHandlerProtocol::ServerToClientMessage::kTypeForkSnapshot)) {
+    return false;
+  }
+  pid_t snapshot_pid;
+  if (!ReadSnapshotProcessID(client_sock, &snapshot_pid)) {
+    return false;
+  }
+  if (snapshot_pid <= 0) {
+    LOG(ERROR) << "client failed to fork a snapshot";
+    return false;
+  }
+  if (!IsChildOf(snapshot_pid, pid)) {
+    return false;
+  }
+
+  // The copy's only thread is the requesting thread, as it was when the copy
+  // was made.
+  if (!snapshot_.Initialize(snapshot_pid) ||
+      !snapshot_.GetThreadInfo(snapshot_pid,
+                               &threads_[requesting_thread_id])) {
+    return false;
+  }
+
+  maps_path_ = base::StringPrintf("/proc/%d/maps", pid);
+  snapshot_maps_path_ = base::StringPrintf("/proc/%d/maps", snapshot_pid);
+  pid_ = pid;
+
+  // Returning destroys attachments, allowing the process to continue.
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+pid_t ForkSnapshotConnection::SnapshotProcessID() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return snapshot_.GetProcessID();
+}
+
+pid_t ForkSnapshotConnection::GetProcessID() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return pid_;
+}
+
+bool ForkSnapshotConnection::Attach(pid_t tid) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (threads_.find(tid) == threads_.end()) {
+    LOG(ERROR) << "thread " << tid << " not captured";
+    return false;
+  }
+  return true;
+}
+
+bool ForkSnapshotConnection::Is64Bit() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return snapshot_.Is64Bit();
+}
+
+bool ForkSnapshotConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto iterator = threads_.find(tid);
+  if (iterator == threads_.end()) {
+    LOG(ERROR) << "thread " << tid << " not captured";
+    return false;
+  }
+  *info = iterator->second;
+  return true;
+}
+
+bool ForkSnapshotConnection::ReadFileContents(const base::FilePath& path,
+                                              std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // The memory map must describe the copy that memory is read from. Other
+  // files describe the process and its threads, which only exist in the
+  // original process.
+  if (path.value() == maps_path_) {
+    return snapshot_.ReadFileContents(base::FilePath(snapshot_maps_path_),
+                                      contents);
+  }
+  return LoggingReadEntireFile(path, contents);
+}
+
+ProcessMemoryLinux* ForkSnapshotConnection::Memory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return snapshot_.Memory();
+}
+
+bool ForkSnapshotConnection::Threads(std::vector<pid_t>* threads) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  threads->clear();
+  for (const auto& thread : threads_) {
+    threads->push_back(thread.first);
+  }
+  return true;
+}
+
+ssize_t ForkSnapshotConnection::ReadUpTo(VMAddress address,
+                                         size_t size,
+                                         void* buffer) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return snapshot_.ReadUpTo(address, size, buffer);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_FORK_SNAPSHOT_CONNECTION_H_
+#define CRASHPAD_UTIL_LINUX_FORK_SNAPSHOT_CONNECTION_H_
+
+#include <sys/types.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "util/linux/direct_ptrace_connection.h"
+#include "util/linux/ptrace_connection.h"
+#include "util/linux/thread_info.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory_linux.h"
+
+namespace crashpad {
+
+//! \brief Manages a `ptrace` connection to a process whose memory is read from
+//!     a copy of the process made by `fork()`.
+//!
+//! The process's threads are stopped only while their registers are collected
+//! and the copy is made. The copy is made by the thread that requested the
+//! crash dump, and its address space is identical to the process's at that
+//! time. Memory and the memory map are then read from the copy while the
+//! process continues to run.
+//!
+//! This connection requires a private connection to an ExceptionHandlerClient
+//! that is waiting for a crash dump to complete. The copy exits once the client
+//! is told that the crash dump is complete.
+class ForkSnapshotConnection : public PtraceConnection {
+ public:
+  ForkSnapshotConnection();
+
+  ForkSnapshotConnection(const ForkSnapshotConnection&) = delete;
+  ForkSnapshotConnection& operator=(const ForkSnapshotConnection&) = delete;
+
+  ~ForkSnapshotConnection();
+
+  //! \brief Initializes this connection for the process whose process ID is
+  //!     \a pid.
+  //!
+  //! The copy must be a child of the process, and is only waited for briefly,
+  //! because the process's other threads are stopped until it is made. On
+  //! failure, the process is no longer stopped and may be captured directly.
+  //!
+  //! \param[in] client_sock A socket connected to an ExceptionHandlerClient in
+  //!     the process, which is waiting for its crash dump request to complete.
+  //! \param[in] pid The process ID of the process to connect to.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize(int client_sock, pid_t pid);
+
+  //! \brief Returns the process ID of the copy that memory is read from.
+  pid_t SnapshotProcessID();
+
+  // PtraceConnection:
+
+  pid_t GetProcessID() override;
+  bool Attach(pid_t tid) override;
+  bool Is64Bit() override;
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool ReadFileContents(const base::FilePath& path,
+                        std::string* contents) override;
+  ProcessMemoryLinux* Memory() override;
+  bool Threads(std::vector<pid_t>* threads) override;
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+
+ private:
+  std::map<pid_t, ThreadInfo> threads_;
+  DirectPtraceConnection snapshot_;
+  std::string maps_path_;
+  std::string snapshot_maps_path_;
+  pid_t pid_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_FORK_SNAPSHOT_CONNECTION_H_
@@ -0,0 +1,259 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/fork_snapshot_connection.h"
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/multiprocess.h"
+#include "util/file/file_io.h"
+#include "util/linux/exception_handler_client.h"
+#include "util/linux/exception_handler_protocol.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kInitialValue = 0x0123456789abcdef;
+constexpr uint64_t kChangedValue = 0xfedcba9876543210;
+
+void SigchldHandler(int sig) {}
+
+// Changes *value when told to by the parent, after the copy has been made.
+class ChangeValueThread : public Thread {
+ public:
+  ChangeValueThread(volatile uint64_t* value, FileHandle read, FileHandle write)
+      : Thread(), value_(value), read_(read), write_(write) {}
+
+  ChangeValueThread(const ChangeValueThread&) = delete;
+  ChangeValueThread& operator=(const ChangeValueThread&) = delete;
+
+  ~ChangeValueThread() override = default;
+
+ private:
+  void ThreadMain() override {
+    pid_t tid = syscall(SYS_gettid);
+    CheckedWriteFile(write_, &tid, sizeof(tid));
+
+    char c;
+    CheckedReadFileExactly(read_, &c, sizeof(c));
+    *value_ = kChangedValue;
+    CheckedWriteFile(write_, &c, sizeof(c));
+  }
+
+  volatile uint64_t* value_;
+  FileHandle read_;
+  FileHandle write_;
+};
+
+class ForkSnapshotTest : public Multiprocess {
+ public:
+  ForkSnapshotTest()
+      : Multiprocess(), value_(kInitialValue), server_sock_(), client_sock_() {}
+
+  ForkSnapshotTest(const ForkSnapshotTest&) = delete;
+  ForkSnapshotTest& operator=(const ForkSnapshotTest&) = delete;
+
+  ~ForkSnapshotTest() = default;
+
+ private:
+  void PreFork() override {
+    ASSERT_NO_FATAL_FAILURE(Multiprocess::PreFork());
+
+    int socks[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+    server_sock_.reset(socks[0]);
+    client_sock_.reset(socks[1]);
+  }
+
+  void MultiprocessParent() override {
+    client_sock_.reset();
+
+    pid_t other_thread_id;
+    ASSERT_TRUE(LoggingReadFileExactly(
+        ReadPipeHandle(), &other_thread_id, sizeof(other_thread_id)));
+
+    ExceptionHandlerProtocol::ClientToServerMessage message;
+    ASSERT_TRUE(
+        LoggingReadFileExactly(server_sock_.get(), &message, sizeof(message)));
+    EXPECT_EQ(message.type,
+              ExceptionHandlerProtocol::ClientToServerMessage::
+                  kTypeCrashDumpRequest);
+    EXPECT_EQ(message.client_info.fork_snapshot,
+              ExceptionHandlerProtocol::kBoolTrue);
+
+    {
+      ForkSnapshotConnection connection;
+      ASSERT_TRUE(connection.Initialize(server_sock_.get(), ChildPID()));
+      EXPECT_EQ(connection.GetProcessID(), ChildPID());
+      EXPECT_NE(connection.SnapshotProcessID(), ChildPID());
+
+      std::vector<pid_t> threads;
+      ASSERT_TRUE(connection.Threads(&threads));
+      EXPECT_EQ(threads.size(), 2u);
+      for (pid_t tid : {ChildPID(), other_thread_id}) {
+        EXPECT_NE(std::find(threads.begin(), threads.end(), tid),
+                  threads.end());
+        EXPECT_TRUE(connection.Attach(tid));
+        ThreadInfo info;
+        EXPECT_TRUE(connection.GetThreadInfo(tid, &info));
+      }
+
+      // The process continues to run, but the copy keeps the memory it had
+      // when it was made.
+      char c = 0;
+      ASSERT_TRUE(LoggingWriteFile(WritePipeHandle(), &c, sizeof(c)));
+      ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &c, sizeof(c)));
+
+      uint64_t value;
+      ASSERT_TRUE(connection.Memory()->Read(
+          FromPointerCast<VMAddress>(&value_), sizeof(value), &value));
+      EXPECT_EQ(value, kInitialValue);
+    }
+
+    ExceptionHandlerProtocol::ServerToClientMessage complete = {};
+    complete.type =
+        ExceptionHandlerProtocol::ServerToClientMessage::kTypeCrashDumpComplete;
+    ASSERT_TRUE(
+        LoggingWriteFile(server_sock_.get(), &complete, sizeof(complete)));
+  }
+
+  void MultiprocessChild() override {
+    server_sock_.reset();
+
+    ChangeValueThread thread(&value_, ReadPipeHandle(), WritePipeHandle());
+    thread.Start();
+
+    // The application's SIGCHLD handler is restored once the copy is reaped.
+    struct sigaction action = {};
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = SigchldHandler;
+    ASSERT_EQ(sigaction(SIGCHLD, &action, nullptr), 0);
+
+    ExceptionHandlerProtocol::ClientInformation info;
+    info.fork_snapshot = ExceptionHandlerProtocol::kBoolTrue;
+    ExceptionHandlerClient client(client_sock_.get(), false);
+    EXPECT_EQ(client.RequestCrashDump(info), 0);
+
+    ASSERT_EQ(sigaction(SIGCHLD, nullptr, &action), 0);
+    EXPECT_EQ(action.sa_handler, SigchldHandler);
+
+    thread.Join();
+    EXPECT_EQ(value_, kChangedValue);
+  }
+
+  volatile uint64_t value_;
+  ScopedFileHandle server_sock_;
+  ScopedFileHandle client_sock_;
+};
+
+TEST(ForkSnapshotConnection, CapturesCopy) {
+  ForkSnapshotTest test;
+  test.Run();
+}
+
+// Speaks the client's side of the protocol, replying to the request for a copy
+// with a process that isn't its child, or not at all.
+class BadClientTest : public Multiprocess {
+ public:
+  explicit BadClientTest(bool reply)
+      : Multiprocess(), reply_(reply), server_sock_(), client_sock_() {}
+
+  BadClientTest(const BadClientTest&) = delete;
+  BadClientTest& operator=(const BadClientTest&) = delete;
+
+  ~BadClientTest() = default;
+
+ private:
+  void PreFork() override {
+    ASSERT_NO_FATAL_FAILURE(Multiprocess::PreFork());
+
+    int socks[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+    server_sock_.reset(socks[0]);
+    client_sock_.reset(socks[1]);
+  }
+
+  void MultiprocessParent() override {
+    client_sock_.reset();
+
+    {
+      ForkSnapshotConnection connection;
+      EXPECT_FALSE(connection.Initialize(server_sock_.get(), ChildPID()));
+    }
+
+    ExceptionHandlerProtocol::ServerToClientMessage complete = {};
+    complete.type =
+        ExceptionHandlerProtocol::ServerToClientMessage::kTypeCrashDumpComplete;
+    ASSERT_TRUE(
+        LoggingWriteFile(server_sock_.get(), &complete, sizeof(complete)));
+  }
+
+  void MultiprocessChild() override {
+    server_sock_.reset();
+
+    ExceptionHandlerProtocol::ServerToClientMessage message;
+    ASSERT_TRUE(
+        LoggingReadFileExactly(client_sock_.get(), &message, sizeof(message)));
+    ASSERT_EQ(message.type,
+              ExceptionHandlerProtocol::ServerToClientMessage::
+                  kTypePrepareForkSnapshot);
+    pid_t tid = syscall(SYS_gettid);
+    ASSERT_TRUE(LoggingWriteFile(client_sock_.get(), &tid, sizeof(tid)));
+
+    ASSERT_TRUE(
+        LoggingReadFileExactly(client_sock_.get(), &message, sizeof(message)));
+    ASSERT_EQ(
+        message.type,
+        ExceptionHandlerProtocol::ServerToClientMessage::kTypeForkSnapshot);
+    if (reply_) {
+      pid_t not_a_child = getppid();
+      ASSERT_TRUE(LoggingWriteFile(
+          client_sock_.get(), &not_a_child, sizeof(not_a_child)));
+    }
+
+    ASSERT_TRUE(
+        LoggingReadFileExactly(client_sock_.get(), &message, sizeof(message)));
+    EXPECT_EQ(message.type,
+              ExceptionHandlerProtocol::ServerToClientMessage::
+                  kTypeCrashDumpComplete);
+  }
+
+  bool reply_;
+  ScopedFileHandle server_sock_;
+  ScopedFileHandle client_sock_;
+};
+
+TEST(ForkSnapshotConnection, RejectsNonChild) {
+  BadClientTest test(true);
+  test.Run();
+}
+
+TEST(ForkSnapshotConnection, TimesOut) {
+  BadClientTest test(false);
+  test.Run();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
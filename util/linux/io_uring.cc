@@ -0,0 +1,272 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/io_uring.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace {
+
+// Use the system calls directly, as C libraries don’t provide wrappers.
+int IoUringSetup(uint32_t entries, io_uring_params* params) {
+  return syscall(__NR_io_uring_setup, entries, params);
+}
+
+int IoUringEnter(int fd,
+                 uint32_t to_submit,
+                 uint32_t min_complete,
+                 uint32_t flags) {
+  return syscall(
+      __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int IoUringRegister(int fd, uint32_t opcode, void* arg, uint32_t nr_args) {
+  return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+// Returns true if the kernel supports all of the operations this class uses.
+// IORING_OP_READ and IORING_OP_WRITE were added at the same time as
+// IORING_REGISTER_PROBE, so a failure to probe means they're unavailable.
+bool SupportsReadAndWrite(int ring_fd) {
+  constexpr uint32_t kProbeOps = IORING_OP_WRITE + 1;
+  const size_t probe_size =
+      sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op);
+  std::unique_ptr<uint8_t[]> probe_buffer(new uint8_t[probe_size]());
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_buffer.get());
+  if (IoUringRegister(ring_fd, IORING_REGISTER_PROBE, probe, kProbeOps) != 0) {
+    return false;
+  }
+
+  for (uint32_t op : {IORING_OP_READ, IORING_OP_WRITE}) {
+    if (op >= probe->ops_len ||
+        !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+T* RingPointer(const ScopedMmap& mapping, uint32_t offset) {
+  return reinterpret_cast<T*>(mapping.addr_as<char*>() + offset);
+}
+
+}  // namespace
+
+IoUring::IoUring()
+    : rings_(),
+      sqes_mapping_(),
+      ring_fd_(),
+      sq_head_(nullptr),
+      sq_tail_(nullptr),
+      sq_array_(nullptr),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cqes_(nullptr),
+      sqes_(nullptr),
+      sq_entries_(0),
+      sq_mask_(0),
+      cq_mask_(0),
+      unsubmitted_(0),
+      outstanding_(0),
+      initialized_() {}
+
+IoUring::~IoUring() {
+  DCHECK_EQ(outstanding_, 0u);
+}
+
+bool IoUring::Initialize(uint32_t entries) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_.reset(IoUringSetup(entries, &params));
+  if (!ring_fd_.is_valid()) {
+    // ENOSYS: the kernel predates io_uring. EPERM: it has been disabled with
+    // the kernel.io_uring_disabled sysctl, or by seccomp.
+    PLOG_IF(WARNING, errno != ENOSYS && errno != EPERM) << "io_uring_setup";
+    return false;
+  }
+
+  // Kernels new enough to support IORING_OP_READ and IORING_OP_WRITE map both
+  // rings with a single mapping.
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !SupportsReadAndWrite(ring_fd_.get())) {
+    return false;
+  }
+
+  const size_t rings_size =
+      std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+               params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  if (!rings_.ResetMmap(nullptr,
+                        rings_size,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE,
+                        ring_fd_.get(),
+                        IORING_OFF_SQ_RING) ||
+      !sqes_mapping_.ResetMmap(nullptr,
+                               params.sq_entries * sizeof(io_uring_sqe),
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE,
+                               ring_fd_.get(),
+                               IORING_OFF_SQES)) {
+    return false;
+  }
+
+  sq_head_ = RingPointer<uint32_t>(rings_, params.sq_off.head);
+  sq_tail_ = RingPointer<uint32_t>(rings_, params.sq_off.tail);
+  sq_array_ = RingPointer<uint32_t>(rings_, params.sq_off.array);
+  sq_mask_ = *RingPointer<uint32_t>(rings_, params.sq_off.ring_mask);
+  cq_head_ = RingPointer<uint32_t>(rings_, params.cq_off.head);
+  cq_tail_ = RingPointer<uint32_t>(rings_, params.cq_off.tail);
+  cqes_ = RingPointer<io_uring_cqe>(rings_, params.cq_off.cqes);
+  cq_mask_ = *RingPointer<uint32_t>(rings_, params.cq_off.ring_mask);
+  sqes_ = sqes_mapping_.addr_as<io_uring_sqe*>();
+
+  // The completion queue is at least as large as the submission queue, so
+  // limiting the outstanding operations to the submission queue’s size ensures
+  // that completions are never dropped.
+  DCHECK_GE(params.cq_entries, params.sq_entries);
+  sq_entries_ = params.sq_entries;
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool IoUring::QueueRead(int fd,
+                        void* buffer,
+                        uint32_t size,
+                        uint64_t offset,
+                        uint64_t user_data) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  io_uring_sqe* sqe = NextSubmissionEntry();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uintptr_t>(buffer);
+  sqe->len = size;
+  sqe->off = offset;
+  sqe->user_data = user_data;
+  CommitSubmissionEntry();
+  return true;
+}
+
+bool IoUring::QueueWrite(int fd,
+                         const void* buffer,
+                         uint32_t size,
+                         uint64_t offset,
+                         uint64_t user_data) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  io_uring_sqe* sqe = NextSubmissionEntry();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_WRITE;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uintptr_t>(buffer);
+  sqe->len = size;
+  sqe->off = offset;
+  sqe->user_data = user_data;
+  CommitSubmissionEntry();
+  return true;
+}
+
+bool IoUring::Submit() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return unsubmitted_ == 0 || Enter(0);
+}
+
+bool IoUring::WaitForCompletion(Completion* completion) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (outstanding_ == 0) {
+    return false;
+  }
+
+  // Only this object advances the completion queue’s head, but the kernel
+  // advances its tail, and the entry it points to must be read after the
+  // tail.
+  const uint32_t head = *cq_head_;
+  while (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    if (!Enter(1)) {
+      return false;
+    }
+  }
+
+  const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+  completion->user_data = cqe.user_data;
+  completion->result = cqe.res;
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  --outstanding_;
+  return true;
+}
+
+io_uring_sqe* IoUring::NextSubmissionEntry() {
+  if (outstanding_ >= sq_entries_) {
+    return nullptr;
+  }
+
+  // Entries the kernel has consumed are free once the head has moved past
+  // them. With no more than sq_entries_ outstanding operations, the one at
+  // the tail is always free.
+  const uint32_t tail = *sq_tail_;
+  DCHECK_LT(tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE), sq_entries_);
+  io_uring_sqe* sqe = &sqes_[tail & sq_mask_];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+void IoUring::CommitSubmissionEntry() {
+  const uint32_t tail = *sq_tail_;
+  sq_array_[tail & sq_mask_] = tail & sq_mask_;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  ++unsubmitted_;
+  ++outstanding_;
+}
+
+bool IoUring::Enter(uint32_t min_complete) {
+  const uint32_t flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+  for (;;) {
+    int rv = IoUringEnter(ring_fd_.get(), unsubmitted_, min_complete, flags);
+    if (rv >= 0) {
+      DCHECK_LE(static_cast<uint32_t>(rv), unsubmitted_);
+      unsubmitted_ -= rv;
+      if (unsubmitted_ == 0 || min_complete) {
+        return true;
+      }
+      continue;
+    }
+
+    if (errno != EINTR) {
+      PLOG(ERROR) << "io_uring_enter";
+      return false;
+    }
+  }
+}
+
+}  // namespace crashpad
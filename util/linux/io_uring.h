@@ -0,0 +1,163 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_IO_URING_H_
+#define CRASHPAD_UTIL_LINUX_IO_URING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/files/scoped_file.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/posix/scoped_mmap.h"
+
+struct io_uring_cqe;
+struct io_uring_sqe;
+
+namespace crashpad {
+
+//! \brief Queues positional reads and writes to be performed asynchronously
+//!     by the kernel through an `io_uring` instance.
+//!
+//! Operations are queued with QueueRead() and QueueWrite(), passed to the
+//! kernel with Submit(), and their results collected with
+//! WaitForCompletion(). Many operations may be outstanding at once, so that
+//! the kernel can perform them while the caller does other work, and so that
+//! several need only one system call.
+//!
+//! `io_uring` may be unavailable, because the kernel predates it, because it
+//! has been disabled, or because it is forbidden by a sandbox. Initialize()
+//! reports this, and callers must then fall back to performing their I/O
+//! synchronously.
+//!
+//! This class is not thread-safe.
+class IoUring {
+ public:
+  //! \brief The result of a completed operation.
+  struct Completion {
+    //! \brief The value passed to QueueRead() or QueueWrite() for the
+    //!     operation.
+    uint64_t user_data;
+
+    //! \brief The number of bytes transferred, or a negated `errno` value.
+    int32_t result;
+  };
+
+  IoUring();
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  //! \brief Destroys this object.
+  //!
+  //! All outstanding operations must have been collected by
+  //! WaitForCompletion() first, as the kernel may otherwise access their
+  //! buffers after they have been released.
+  ~IoUring();
+
+  //! \brief Initializes this object.
+  //!
+  //! \param[in] entries The number of operations that may be outstanding at
+  //!     once. The kernel may round this up.
+  //!
+  //! \return `true` on success. `false` if `io_uring` or the read and write
+  //!     operations it needs are unavailable, with a message logged only if
+  //!     the failure was unexpected.
+  bool Initialize(uint32_t entries);
+
+  //! \brief Returns the number of operations that may be outstanding at once.
+  uint32_t Capacity() const { return sq_entries_; }
+
+  //! \brief Returns the number of operations that have been queued but not
+  //!     yet collected by WaitForCompletion().
+  uint32_t Outstanding() const { return outstanding_; }
+
+  //! \brief Queues a read of \a size bytes from \a fd at \a offset into
+  //!     \a buffer.
+  //!
+  //! \a buffer must remain valid until the operation has completed.
+  //!
+  //! \return `true` on success. `false` if Capacity() operations are already
+  //!     outstanding.
+  bool QueueRead(int fd,
+                 void* buffer,
+                 uint32_t size,
+                 uint64_t offset,
+                 uint64_t user_data);
+
+  //! \brief Queues a write of \a size bytes from \a buffer to \a fd at
+  //!     \a offset.
+  //!
+  //! \a buffer must remain valid and unmodified until the operation has
+  //! completed.
+  //!
+  //! \return `true` on success. `false` if Capacity() operations are already
+  //!     outstanding.
+  bool QueueWrite(int fd,
+                  const void* buffer,
+                  uint32_t size,
+                  uint64_t offset,
+                  uint64_t user_data);
+
+  //! \brief Passes all queued operations to the kernel without waiting for
+  //!     any of them to complete.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Submit();
+
+  //! \brief Submits any queued operations and waits for an outstanding
+  //!     operation to complete.
+  //!
+  //! Operations may complete in any order.
+  //!
+  //! \param[out] completion The result of the completed operation.
+  //!
+  //! \return `true` on success. `false` if no operations are outstanding, or
+  //!     on failure with a message logged.
+  bool WaitForCompletion(Completion* completion);
+
+ private:
+  // Returns the next free submission queue entry, cleared, or nullptr if the
+  // submission queue is full.
+  io_uring_sqe* NextSubmissionEntry();
+
+  // Makes the entry returned by the last NextSubmissionEntry() call visible to
+  // the kernel.
+  void CommitSubmissionEntry();
+
+  // Calls io_uring_enter(), submitting all queued operations and waiting for
+  // min_complete of them to complete.
+  bool Enter(uint32_t min_complete);
+
+  ScopedMmap rings_;
+  ScopedMmap sqes_mapping_;
+  base::ScopedFD ring_fd_;
+  uint32_t* sq_head_;  // weak, in rings_
+  uint32_t* sq_tail_;  // weak, in rings_
+  uint32_t* sq_array_;  // weak, in rings_
+  uint32_t* cq_head_;  // weak, in rings_
+  uint32_t* cq_tail_;  // weak, in rings_
+  io_uring_cqe* cqes_;  // weak, in rings_
+  io_uring_sqe* sqes_;  // weak, in sqes_mapping_
+  uint32_t sq_entries_;
+  uint32_t sq_mask_;
+  uint32_t cq_mask_;
+  uint32_t unsubmitted_;
+  uint32_t outstanding_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_IO_URING_H_
@@ -0,0 +1,212 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/io_uring_file_writer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+IoUringFileWriter::IoUringFileWriter(int fd,
+                                     size_t buffer_size,
+                                     size_t buffer_count)
+    : io_uring_(),
+      buffers_(buffer_count),
+      free_buffers_(),
+      current_buffer_(nullptr),
+      position_(0),
+      buffer_size_(buffer_size),
+      fd_(fd),
+      failed_(false) {
+  DCHECK_GT(buffer_size_, 0u);
+  DCHECK_LE(buffer_size_, std::numeric_limits<uint32_t>::max());
+  DCHECK_GT(buffers_.size(), 0u);
+}
+
+IoUringFileWriter::~IoUringFileWriter() {
+  DCHECK(!current_buffer_);
+  DCHECK_EQ(io_uring_.Outstanding(), 0u);
+}
+
+bool IoUringFileWriter::Initialize() {
+  position_ = LoggingSeekFile(fd_, 0, SEEK_CUR);
+  if (position_ < 0 || !io_uring_.Initialize(buffers_.size())) {
+    return false;
+  }
+  DCHECK_GE(io_uring_.Capacity(), buffers_.size());
+
+  free_buffers_.reserve(buffers_.size());
+  for (size_t index = 0; index < buffers_.size(); ++index) {
+    buffers_[index].data.reset(new uint8_t[buffer_size_]);
+    free_buffers_.push_back(index);
+  }
+  return true;
+}
+
+bool IoUringFileWriter::Flush() {
+  const bool rv = CompleteAllWrites();
+  return LoggingSeekFile(fd_, position_, SEEK_SET) == position_ && rv;
+}
+
+bool IoUringFileWriter::Write(const void* data, size_t size) {
+  // The failure was logged when it was found.
+  if (failed_) {
+    return false;
+  }
+
+  const uint8_t* data_c = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    if (!current_buffer_) {
+      while (free_buffers_.empty()) {
+        if (!CompleteWrite() || failed_) {
+          return false;
+        }
+      }
+      current_buffer_ = &buffers_[free_buffers_.back()];
+      free_buffers_.pop_back();
+      current_buffer_->offset = position_;
+      current_buffer_->size = 0;
+    }
+
+    const size_t chunk = std::min(size, buffer_size_ - current_buffer_->size);
+    memcpy(current_buffer_->data.get() + current_buffer_->size, data_c, chunk);
+    current_buffer_->size += chunk;
+    position_ += chunk;
+    data_c += chunk;
+    size -= chunk;
+
+    if (current_buffer_->size == buffer_size_ && !QueueCurrentBuffer()) {
+      return false;
+    }
+  }
+  return !failed_;
+}
+
+bool IoUringFileWriter::WriteIoVec(std::vector<WritableIoVec>* iovecs) {
+  if (iovecs->empty()) {
+    LOG(ERROR) << "WriteIoVec(): no iovecs";
+    return false;
+  }
+
+  for (const WritableIoVec& iov : *iovecs) {
+    if (!Write(iov.iov_base, iov.iov_len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IoUringFileWriter::Preallocate(FileOffset size) {
+  return CompleteAllWrites() && LoggingPreallocateFile(fd_, position_, size);
+}
+
+bool IoUringFileWriter::SupportsWriteAtOffset() const {
+  return true;
+}
+
+bool IoUringFileWriter::WriteAtOffset(FileOffset offset,
+                                      const void* data,
+                                      size_t size) {
+  DCHECK(!current_buffer_);
+  DCHECK_EQ(io_uring_.Outstanding(), 0u);
+  return LoggingWriteFileAtOffset(fd_, offset, data, size);
+}
+
+FileOffset IoUringFileWriter::Seek(FileOffset offset, int whence) {
+  if (!CompleteAllWrites()) {
+    return -1;
+  }
+
+  // The file descriptor’s position isn’t kept up to date while writing.
+  if (whence == SEEK_CUR) {
+    offset += position_;
+    whence = SEEK_SET;
+  }
+  const FileOffset new_position = LoggingSeekFile(fd_, offset, whence);
+  if (new_position >= 0) {
+    position_ = new_position;
+  }
+  return new_position;
+}
+
+bool IoUringFileWriter::QueueCurrentBuffer() {
+  if (!current_buffer_) {
+    return true;
+  }
+
+  // There are never more outstanding writes than buffers, and the ring was
+  // sized to hold them all, so this can’t fail.
+  const bool queued =
+      io_uring_.QueueWrite(fd_,
+                           current_buffer_->data.get(),
+                           static_cast<uint32_t>(current_buffer_->size),
+                           current_buffer_->offset,
+                           current_buffer_ - buffers_.data());
+  DCHECK(queued);
+  current_buffer_ = nullptr;
+
+  if (!io_uring_.Submit()) {
+    failed_ = true;
+  }
+  return !failed_;
+}
+
+bool IoUringFileWriter::CompleteWrite() {
+  IoUring::Completion completion;
+  if (!io_uring_.WaitForCompletion(&completion)) {
+    failed_ = true;
+    return false;
+  }
+
+  DCHECK_LT(completion.user_data, buffers_.size());
+  const Buffer& buffer = buffers_[completion.user_data];
+  free_buffers_.push_back(completion.user_data);
+
+  if (completion.result < 0) {
+    errno = -completion.result;
+    PLOG(ERROR) << "io_uring write";
+    failed_ = true;
+  } else if (static_cast<size_t>(completion.result) < buffer.size) {
+    // Finish a short write synchronously. Regular files only write short when
+    // they’ve run out of space, so this most likely fails and logs why.
+    const size_t written = completion.result;
+    if (!LoggingWriteFileAtOffset(fd_,
+                                  buffer.offset + written,
+                                  buffer.data.get() + written,
+                                  buffer.size - written)) {
+      failed_ = true;
+    }
+  }
+  return true;
+}
+
+bool IoUringFileWriter::CompleteAllWrites() {
+  QueueCurrentBuffer();
+  while (io_uring_.Outstanding() > 0) {
+    if (!CompleteWrite()) {
+      break;
+    }
+  }
+  return !failed_;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,140 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_IO_URING_FILE_WRITER_H_
+#define CRASHPAD_UTIL_LINUX_IO_URING_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "util/file/file_writer.h"
+#include "util/linux/io_uring.h"
+
+namespace crashpad {
+
+//! \brief A file writer that writes to a file descriptor asynchronously
+//!     through `io_uring`.
+//!
+//! Written data is copied into one of a small number of buffers. Each buffer
+//! is queued to be written at its position in the file when it fills, and
+//! Write() returns without waiting for it, so that the caller can produce more
+//! data, such as by reading another process’ memory, while the kernel writes
+//! what came before. Write() only waits when every buffer is in use.
+//!
+//! Failed writes are reported by the next call to Write(), Flush(), Seek(), or
+//! Preallocate().
+//!
+//! Flush() must be called after the last write and before this object is
+//! destroyed.
+class IoUringFileWriter final : public FileWriterInterface {
+ public:
+  //! \brief The default size of each buffer.
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  //! \brief The default number of buffers, which is the number of writes that
+  //!     may be outstanding at once.
+  static constexpr size_t kDefaultBufferCount = 8;
+
+  //! \param[in] fd The file descriptor to write to, which must refer to a file
+  //!     that supports positional writes and must remain open until Flush()
+  //!     has been called.
+  //! \param[in] buffer_size The size of each buffer.
+  //! \param[in] buffer_count The number of buffers.
+  explicit IoUringFileWriter(int fd,
+                             size_t buffer_size = kDefaultBufferSize,
+                             size_t buffer_count = kDefaultBufferCount);
+
+  IoUringFileWriter(const IoUringFileWriter&) = delete;
+  IoUringFileWriter& operator=(const IoUringFileWriter&) = delete;
+
+  ~IoUringFileWriter() override;
+
+  //! \brief Initializes this object, starting at the file’s current position.
+  //!
+  //! \return `true` on success. `false` if `io_uring` is unavailable or the
+  //!     file’s position can’t be determined, in which case the file must be
+  //!     written by other means.
+  bool Initialize();
+
+  //! \brief Writes any buffered data and waits for all outstanding writes to
+  //!     complete.
+  //!
+  //! Afterwards, the file descriptor’s position is where the next Write() would
+  //! have written.
+  //!
+  //! \return `true` if all writes made through this object succeeded, `false`
+  //!     otherwise, with a message logged.
+  bool Flush();
+
+  // FileWriterInterface:
+  bool Write(const void* data, size_t size) override;
+  bool WriteIoVec(std::vector<WritableIoVec>* iovecs) override;
+
+  //! \copydoc FileWriterInterface::Preallocate()
+  //!
+  //! Outstanding writes are completed before preallocating.
+  bool Preallocate(FileOffset size) override;
+
+  //! \copydoc FileWriterInterface::SupportsWriteAtOffset()
+  //!
+  //! This returns `true`.
+  bool SupportsWriteAtOffset() const override;
+
+  //! \copydoc FileWriterInterface::WriteAtOffset()
+  //!
+  //! Writes at an offset are made synchronously, with
+  //! LoggingWriteFileAtOffset(). Flush() must be called before the first of
+  //! them.
+  bool WriteAtOffset(FileOffset offset, const void* data, size_t size) override;
+
+  // FileSeekerInterface:
+
+  //! \copydoc FileWriterInterface::Seek()
+  //!
+  //! Outstanding writes are completed before seeking.
+  FileOffset Seek(FileOffset offset, int whence) override;
+
+ private:
+  struct Buffer {
+    std::unique_ptr<uint8_t[]> data;
+    FileOffset offset;
+    size_t size;
+  };
+
+  // Queues the partially-filled buffer, if any, to be written.
+  bool QueueCurrentBuffer();
+
+  // Waits for one outstanding write and returns its buffer to free_buffers_.
+  // Returns false if waiting failed. A failed write sets failed_.
+  bool CompleteWrite();
+
+  // Queues any partially-filled buffer and waits for all outstanding writes.
+  bool CompleteAllWrites();
+
+  IoUring io_uring_;
+  std::vector<Buffer> buffers_;
+  std::vector<size_t> free_buffers_;
+  Buffer* current_buffer_;  // weak, in buffers_, or nullptr
+  FileOffset position_;
+  size_t buffer_size_;
+  int fd_;  // weak
+  bool failed_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_IO_URING_FILE_WRITER_H_
@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/io_uring_file_writer.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+class IoUringFileWriterTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = temp_dir_.path().Append("file");
+    file_.reset(LoggingOpenFileForReadAndWrite(path_,
+                                               FileWriteMode::kCreateOrFail,
+                                               FilePermissions::kOwnerOnly));
+    ASSERT_TRUE(file_.is_valid());
+  }
+
+  std::string Contents() {
+    std::string contents;
+    EXPECT_TRUE(LoggingReadEntireFile(path_, &contents));
+    return contents;
+  }
+
+  const base::FilePath& path() const { return path_; }
+  int fd() const { return file_.get(); }
+
+ private:
+  ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  ScopedFileHandle file_;
+};
+
+TEST_F(IoUringFileWriterTest, Write) {
+  // Start past the beginning of the file, to check that the writer picks up
+  // the file’s position.
+  ASSERT_TRUE(LoggingWriteFile(fd(), "head", 4));
+
+  IoUringFileWriter writer(fd(), 8, 2);
+  if (!writer.Initialize()) {
+    GTEST_SKIP();
+  }
+
+  std::string expected("head");
+  for (size_t size = 0; size < 40; ++size) {
+    const std::string data(size, static_cast<char>('a' + size % 26));
+    ASSERT_TRUE(writer.Write(data.data(), data.size()));
+    expected += data;
+  }
+  EXPECT_EQ(writer.Seek(0, SEEK_CUR), FileOffset(expected.size()));
+
+  ASSERT_TRUE(writer.Flush());
+  EXPECT_EQ(LoggingSeekFile(fd(), 0, SEEK_CUR), FileOffset(expected.size()));
+  EXPECT_EQ(Contents(), expected);
+}
+
+TEST_F(IoUringFileWriterTest, Seek) {
+  IoUringFileWriter writer(fd(), 4, 2);
+  if (!writer.Initialize()) {
+    GTEST_SKIP();
+  }
+
+  ASSERT_TRUE(writer.Write("0123456789", 10));
+  EXPECT_EQ(writer.Seek(2, SEEK_SET), 2);
+  ASSERT_TRUE(writer.Write("ab", 2));
+  EXPECT_EQ(writer.Seek(1, SEEK_CUR), 5);
+  ASSERT_TRUE(writer.Write("c", 1));
+  EXPECT_EQ(writer.Seek(0, SEEK_END), 10);
+  ASSERT_TRUE(writer.Write("de", 2));
+
+  ASSERT_TRUE(writer.Flush());
+  EXPECT_EQ(Contents(), "01ab4c6789de");
+}
+
+TEST_F(IoUringFileWriterTest, WriteAtOffset) {
+  IoUringFileWriter writer(fd());
+  if (!writer.Initialize()) {
+    GTEST_SKIP();
+  }
+  EXPECT_TRUE(writer.SupportsWriteAtOffset());
+
+  ASSERT_TRUE(writer.Write("abcdef", 6));
+  ASSERT_TRUE(writer.Flush());
+  ASSERT_TRUE(writer.WriteAtOffset(3, "XYZ", 3));
+  EXPECT_EQ(Contents(), "abcXYZ");
+}
+
+TEST_F(IoUringFileWriterTest, WriteFailure) {
+  // Writes to a descriptor opened only for reading fail, and the failure is
+  // reported when it’s found.
+  ScopedFileHandle read_only(LoggingOpenFileForRead(path()));
+  ASSERT_TRUE(read_only.is_valid());
+
+  IoUringFileWriter writer(read_only.get(), 4, 1);
+  if (!writer.Initialize()) {
+    GTEST_SKIP();
+  }
+
+  // The first buffer is queued without waiting, so its failure is only found
+  // when the buffer is needed again.
+  EXPECT_TRUE(writer.Write("abcd", 4));
+  EXPECT_FALSE(writer.Write("efgh", 4));
+  EXPECT_FALSE(writer.Write("ijkl", 4));
+  EXPECT_FALSE(writer.Flush());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,112 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/io_uring.h"
+
+#include <errno.h>
+
+#include <set>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(IoUring, WriteAndRead) {
+  IoUring io_uring;
+  if (!io_uring.Initialize(4)) {
+    GTEST_SKIP();
+  }
+  ASSERT_GE(io_uring.Capacity(), 4u);
+
+  ScopedTempDir temp_dir;
+  ScopedFileHandle file(
+      LoggingOpenFileForReadAndWrite(temp_dir.path().Append("file"),
+                                     FileWriteMode::kCreateOrFail,
+                                     FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(file.is_valid());
+
+  // Writes may complete in any order, and each lands at its own offset.
+  static constexpr char kFirst[] = "first";
+  static constexpr char kSecond[] = "second";
+  ASSERT_TRUE(io_uring.QueueWrite(file.get(), kSecond, 6, 5, 2));
+  ASSERT_TRUE(io_uring.QueueWrite(file.get(), kFirst, 5, 0, 1));
+  EXPECT_EQ(io_uring.Outstanding(), 2u);
+  ASSERT_TRUE(io_uring.Submit());
+
+  std::set<uint64_t> completed;
+  IoUring::Completion completion;
+  while (io_uring.Outstanding() > 0) {
+    ASSERT_TRUE(io_uring.WaitForCompletion(&completion));
+    EXPECT_EQ(completion.result, completion.user_data == 1 ? 5 : 6);
+    completed.insert(completion.user_data);
+  }
+  EXPECT_EQ(completed, (std::set<uint64_t>{1, 2}));
+  EXPECT_FALSE(io_uring.WaitForCompletion(&completion));
+
+  // Reads are submitted by WaitForCompletion() if Submit() wasn’t called.
+  char buffer[16] = {};
+  ASSERT_TRUE(io_uring.QueueRead(file.get(), buffer, sizeof(buffer), 2, 3));
+  ASSERT_TRUE(io_uring.WaitForCompletion(&completion));
+  EXPECT_EQ(completion.user_data, 3u);
+  ASSERT_EQ(completion.result, 9);
+  EXPECT_EQ(std::string(buffer, completion.result), "rstsecond");
+
+  // A failed operation reports its error.
+  ASSERT_TRUE(io_uring.QueueRead(-1, buffer, sizeof(buffer), 0, 4));
+  ASSERT_TRUE(io_uring.WaitForCompletion(&completion));
+  EXPECT_EQ(completion.user_data, 4u);
+  EXPECT_EQ(completion.result, -EBADF);
+}
+
+TEST(IoUring, Full) {
+  IoUring io_uring;
+  if (!io_uring.Initialize(2)) {
+    GTEST_SKIP();
+  }
+
+  ScopedTempDir temp_dir;
+  ScopedFileHandle file(
+      LoggingOpenFileForReadAndWrite(temp_dir.path().Append("file"),
+                                     FileWriteMode::kCreateOrFail,
+                                     FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(file.is_valid());
+
+  static constexpr char kData[] = "x";
+  for (uint32_t index = 0; index < io_uring.Capacity(); ++index) {
+    ASSERT_TRUE(io_uring.QueueWrite(file.get(), kData, 1, index, index));
+  }
+  EXPECT_FALSE(io_uring.QueueWrite(file.get(), kData, 1, 0, 0));
+
+  // Collecting a completion makes room for another operation.
+  IoUring::Completion completion;
+  ASSERT_TRUE(io_uring.WaitForCompletion(&completion));
+  EXPECT_EQ(completion.result, 1);
+  EXPECT_TRUE(io_uring.QueueWrite(file.get(), kData, 1, 0, 0));
+
+  while (io_uring.Outstanding() > 0) {
+    ASSERT_TRUE(io_uring.WaitForCompletion(&completion));
+    EXPECT_EQ(completion.result, 1);
+  }
+  EXPECT_EQ(LoggingSeekFile(file.get(), 0, SEEK_END),
+            FileOffset{io_uring.Capacity()});
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
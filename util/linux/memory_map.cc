@@ -18,25 +18,23 @@
 #include <string.h>
 #include <sys/sysmacros.h>
 
+#include <algorithm>
+#include <limits>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
 #include "base/bit_cast.h"
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "build/build_config.h"
-#include "util/file/delimited_file_reader.h"
 #include "util/file/file_io.h"
-#include "util/file/string_file.h"
-#include "util/stdlib/string_number_conversion.h"
 
 namespace crashpad {
 
 namespace {
 
-template <typename Type>
-bool HexStringToNumber(const std::string& string, Type* number) {
-  return StringToNumber("0x" + string, number);
-}
-
 // The result from parsing a line from the maps file.
 enum class ParseResult {
   // A line was successfully parsed.
@@ -53,32 +51,104 @@ enum class ParseResult {
   kError
 };
 
-// Reads a line from a maps file being read by maps_file_reader and extends
-// mappings with a new MemoryMap::Mapping describing the line.
-ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
-                          std::vector<MemoryMap::Mapping>* mappings) {
-  std::string field;
-  LinuxVMAddress start_address;
-  switch (maps_file_reader->GetDelim('-', &field)) {
-    case DelimitedFileReader::Result::kError:
-      return ParseResult::kError;
-    case DelimitedFileReader::Result::kEndOfFile:
-      return ParseResult::kEndOfFile;
-    case DelimitedFileReader::Result::kSuccess:
-      field.pop_back();
-      if (!HexStringToNumber(field, &start_address)) {
-        LOG(ERROR) << "format error";
-        return ParseResult::kError;
+// Lexes fields from the contents of a maps file in place, without copying them
+// into temporary strings.
+class MapsFileLexer {
+ public:
+  MapsFileLexer(std::string_view contents)
+      : cursor_(contents.data()), end_(contents.data() + contents.size()) {}
+
+  MapsFileLexer(const MapsFileLexer&) = delete;
+  MapsFileLexer& operator=(const MapsFileLexer&) = delete;
+
+  bool AtEnd() const { return cursor_ == end_; }
+
+  // Reads the field up to the next delimiter, and consumes the delimiter. The
+  // field is not terminated and remains valid as long as the file contents.
+  bool Field(char delimiter, const char** field, size_t* size) {
+    const char* found = static_cast<const char*>(
+        memchr(cursor_, delimiter, end_ - cursor_));
+    if (!found) {
+      return false;
+    }
+    *field = cursor_;
+    *size = found - cursor_;
+    cursor_ = found + 1;
+    return true;
+  }
+
+  // Reads a number with the given base up to the next delimiter, and consumes
+  // the delimiter. The field must contain only digits and must be at least
+  // min_digits long. Signs are not accepted.
+  template <typename Type>
+  bool NumberField(char delimiter,
+                   unsigned int base,
+                   size_t min_digits,
+                   Type* number) {
+    static_assert(std::is_integral<Type>::value, "Type must be integral");
+    const char* field;
+    size_t size;
+    if (!Field(delimiter, &field, &size) || size == 0 || size < min_digits) {
+      return false;
+    }
+
+    Type value = 0;
+    for (size_t index = 0; index < size; ++index) {
+      unsigned int digit;
+      const char c = field[index];
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return false;
       }
-      if (!mappings->empty() && start_address < mappings->back().range.End()) {
-        return ParseResult::kRetry;
+      if (digit >= base ||
+          value > (std::numeric_limits<Type>::max() - digit) / base) {
+        return false;
       }
+      value = value * base + digit;
+    }
+    *number = value;
+    return true;
+  }
+
+  template <typename Type>
+  bool HexField(char delimiter, Type* number, size_t min_digits = 1) {
+    return NumberField(delimiter, 16, min_digits, number);
+  }
+
+  template <typename Type>
+  bool DecimalField(char delimiter, Type* number) {
+    return NumberField(delimiter, 10, 1, number);
+  }
+
+ private:
+  const char* cursor_;
+  const char* end_;
+};
+
+// Reads a line from a maps file being read by lexer and extends mappings with a
+// new MemoryMap::Mapping describing the line.
+ParseResult ParseMapsLine(MapsFileLexer* lexer,
+                          std::vector<MemoryMap::Mapping>* mappings) {
+  if (lexer->AtEnd()) {
+    return ParseResult::kEndOfFile;
+  }
+
+  LinuxVMAddress start_address;
+  if (!lexer->HexField('-', &start_address)) {
+    LOG(ERROR) << "format error";
+    return ParseResult::kError;
+  }
+  if (!mappings->empty() && start_address < mappings->back().range.End()) {
+    return ParseResult::kRetry;
   }
 
   LinuxVMAddress end_address;
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !HexStringToNumber(field, &end_address))) {
+  if (!lexer->HexField(' ', &end_address)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
@@ -86,11 +156,13 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
+
+  const char* field;
+  size_t size;
+
   // Skip zero-length mappings.
   if (end_address == start_address) {
-    std::string rest_of_line;
-    if (maps_file_reader->GetLine(&rest_of_line) !=
-        DelimitedFileReader::Result::kSuccess) {
+    if (!lexer->Field('\n', &field, &size)) {
       LOG(ERROR) << "format error";
       return ParseResult::kError;
     }
@@ -107,9 +179,7 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
   MemoryMap::Mapping mapping;
   mapping.range.SetRange(is_64_bit, start_address, end_address - start_address);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size() != 4)) {
+  if (!lexer->Field(' ', &field, &size) || size != 4) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
@@ -130,60 +200,108 @@ ParseResult ParseMapsLine(DelimitedFileReader* maps_file_reader,
   SET_FIELD(field[3], &mapping.shareable, "sS", "p");
 #undef SET_FIELD
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !HexStringToNumber(field, &mapping.offset))) {
+  if (!lexer->HexField(' ', &mapping.offset)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
 
   uint32_t major;
-  if (maps_file_reader->GetDelim(':', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size()) < 2 ||
-      !HexStringToNumber(field, &major)) {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-
   uint32_t minor;
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), field.size()) < 2 ||
-      !HexStringToNumber(field, &minor)) {
+  if (!lexer->HexField(':', &major, 2) || !lexer->HexField(' ', &minor, 2)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
-
   mapping.device = makedev(major, minor);
 
-  if (maps_file_reader->GetDelim(' ', &field) !=
-          DelimitedFileReader::Result::kSuccess ||
-      (field.pop_back(), !StringToNumber(field, &mapping.inode))) {
+  if (!lexer->DecimalField(' ', &mapping.inode)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
 
-  if (maps_file_reader->GetDelim('\n', &field) !=
-      DelimitedFileReader::Result::kSuccess) {
+  if (!lexer->Field('\n', &field, &size)) {
     LOG(ERROR) << "format error";
     return ParseResult::kError;
   }
-  if (field.back() != '\n') {
-    LOG(ERROR) << "format error";
-    return ParseResult::kError;
-  }
-  field.pop_back();
 
   mappings->push_back(mapping);
 
-  size_t path_start = field.find_first_not_of(' ');
-  if (path_start != std::string::npos) {
-    mappings->back().name = field.substr(path_start);
+  size_t path_start = 0;
+  while (path_start < size && field[path_start] == ' ') {
+    ++path_start;
+  }
+  if (path_start < size) {
+    mappings->back().name.assign(field + path_start, size - path_start);
   }
   return ParseResult::kSuccess;
 }
 
+// Sets dont_dump for each of mappings, sorted by base address, that appears
+// with the "dd" flag in the contents of a smaps file. Each mapping in a smaps
+// file begins with a line in the format of the maps file and is followed by
+// lines of the form "Name: value", of which "VmFlags" lists two-letter flags.
+void ParseSmapsVmFlags(const std::string& contents,
+                       std::vector<MemoryMap::Mapping>* mappings) {
+  MemoryMap::Mapping* mapping = nullptr;
+  std::string_view remaining(contents);
+  while (!remaining.empty()) {
+    const size_t line_end = remaining.find('\n');
+    const std::string_view line = remaining.substr(0, line_end);
+    remaining.remove_prefix(
+        line_end == std::string_view::npos ? remaining.size() : line_end + 1);
+
+    const size_t colon = line.find(':');
+    const size_t space = line.find(' ');
+    if (colon == std::string_view::npos || space < colon) {
+      // A new mapping, identified by its address range.
+      mapping = nullptr;
+      MapsFileLexer lexer(line);
+      LinuxVMAddress start;
+      LinuxVMAddress end;
+      if (!lexer.HexField('-', &start) || !lexer.HexField(' ', &end)) {
+        continue;
+      }
+      auto found = std::lower_bound(
+          mappings->begin(),
+          mappings->end(),
+          start,
+          [](const MemoryMap::Mapping& mapping, LinuxVMAddress address) {
+            return mapping.range.Base() < address;
+          });
+      if (found != mappings->end() && found->range.Base() == start &&
+          found->range.End() == end) {
+        mapping = &*found;
+      }
+      continue;
+    }
+
+    if (!mapping || line.substr(0, colon) != "VmFlags") {
+      continue;
+    }
+    std::string_view flags = line.substr(colon + 1);
+    while (!flags.empty()) {
+      const size_t flag_end = flags.find(' ');
+      if (flags.substr(0, flag_end) == "dd") {
+        mapping->dont_dump = true;
+        break;
+      }
+      flags.remove_prefix(
+          flag_end == std::string_view::npos ? flags.size() : flag_end + 1);
+    }
+  }
+}
+
+// Appends mapping's range to ranges, coalescing it with the last range if they
+// abut.
+template <typename Range>
+void AppendRange(std::vector<Range>* ranges,
+                 const MemoryMap::Mapping& mapping) {
+  if (!ranges->empty() && ranges->back().end == mapping.range.Base()) {
+    ranges->back().end = mapping.range.End();
+  } else {
+    ranges->push_back({mapping.range.Base(), mapping.range.End()});
+  }
+}
+
 class SparseReverseIterator : public MemoryMap::Iterator {
  public:
   SparseReverseIterator(const std::vector<const MemoryMap::Mapping*>& mappings)
@@ -228,12 +346,6 @@ class FullReverseIterator : public MemoryMap::Iterator {
   std::vector<MemoryMap::Mapping>::const_reverse_iterator rend_;
 };
 
-// Faster than a CheckedRange, for temporary values.
-struct FastRange {
-  VMAddress base;
-  VMSize size;
-};
-
 }  // namespace
 
 MemoryMap::Mapping::Mapping()
@@ -245,9 +357,16 @@ MemoryMap::Mapping::Mapping()
       readable(false),
       writable(false),
       executable(false),
-      shareable(false) {}
+      shareable(false),
+      dont_dump(false) {}
 
-MemoryMap::MemoryMap() : mappings_(), connection_(nullptr), initialized_() {}
+MemoryMap::MemoryMap()
+    : mappings_(),
+      first_mapping_with_name_(),
+      readable_ranges_(),
+      dumpable_ranges_(),
+      connection_(nullptr),
+      initialized_() {}
 
 MemoryMap::~MemoryMap() {}
 
@@ -269,11 +388,13 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
   // or missed entirely. The kernel reads entries from this file into a page
   // sized buffer, so maps files larger than a page require multiple reads.
   // Attempt to reduce the time between reads by reading the entire file into a
-  // StringFile before attempting to parse it. If ParseMapsLine detects
-  // duplicate, overlapping, or out-of-order entries, it will trigger restarting
-  // the read up to |attempts| times.
+  // buffer before attempting to parse it, and parse the buffer in place. If
+  // ParseMapsLine detects duplicate, overlapping, or out-of-order entries, it
+  // will trigger restarting the read up to |attempts| times.
   int attempts = 3;
   do {
+    mappings_.clear();
+
     std::string contents;
     char path[32];
     snprintf(path, sizeof(path), "/proc/%d/maps", connection_->GetProcessID());
@@ -281,15 +402,20 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
       return false;
     }
 
-    StringFile maps_file;
-    maps_file.SetString(contents);
-    DelimitedFileReader maps_file_reader(&maps_file);
+    // A retry must read the file again, not contents held by the connection.
+    connection_->DiscardFileContents(base::FilePath(path));
+
+    // Each mapping is described by one line, so this avoids growing the vector
+    // while parsing.
+    mappings_.reserve(std::count(contents.begin(), contents.end(), '\n'));
 
+    MapsFileLexer lexer(contents);
     ParseResult result;
-    while ((result = ParseMapsLine(&maps_file_reader, &mappings_)) ==
+    while ((result = ParseMapsLine(&lexer, &mappings_)) ==
            ParseResult::kSuccess) {
     }
     if (result == ParseResult::kEndOfFile) {
+      BuildIndex();
       INITIALIZATION_STATE_SET_VALID(initialized_);
       return true;
     }
@@ -304,75 +430,115 @@ bool MemoryMap::Initialize(PtraceConnection* connection) {
   return false;
 }
 
+bool MemoryMap::ReadVmFlags() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  std::string contents;
+  char path[32];
+  snprintf(path, sizeof(path), "/proc/%d/smaps", connection_->GetProcessID());
+  if (!connection_->ReadFileContents(base::FilePath(path), &contents)) {
+    return false;
+  }
+
+  ParseSmapsVmFlags(contents, &mappings_);
+  BuildIndex();
+  return true;
+}
+
 const MemoryMap::Mapping* MemoryMap::FindMapping(LinuxVMAddress address) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   address = connection_->Memory()->PointerToAddress(address);
 
-  for (const auto& mapping : mappings_) {
-    if (mapping.range.Base() <= address && mapping.range.End() > address) {
-      return &mapping;
-    }
+  // Find the last mapping starting at or below address.
+  auto mapping = std::upper_bound(
+      mappings_.begin(),
+      mappings_.end(),
+      address,
+      [](LinuxVMAddress address, const Mapping& mapping) {
+        return address < mapping.range.Base();
+      });
+  if (mapping == mappings_.begin()) {
+    return nullptr;
   }
-  return nullptr;
+  --mapping;
+  return mapping->range.End() > address ? &*mapping : nullptr;
 }
 
 const MemoryMap::Mapping* MemoryMap::FindMappingWithName(
     const std::string& name) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
-  for (const auto& mapping : mappings_) {
-    if (mapping.name == name) {
-      return &mapping;
+  auto iter = first_mapping_with_name_.find(name);
+  return iter == first_mapping_with_name_.end() ? nullptr
+                                                : &mappings_[iter->second];
+}
+
+uint64_t MemoryMap::FileMappingFingerprint() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // 64-bit FNV-1a over the fields that identify each file mapping.
+  uint64_t hash = 0xcbf29ce484222325;
+  auto mix = [&hash](const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t index = 0; index < size; ++index) {
+      hash = (hash ^ bytes[index]) * 0x100000001b3;
     }
+  };
+
+  for (const Mapping& mapping : mappings_) {
+    if (mapping.inode == 0) {
+      continue;
+    }
+    const uint64_t fields[] = {
+        mapping.range.Base(),
+        mapping.range.Size(),
+        static_cast<uint64_t>(mapping.offset),
+        static_cast<uint64_t>(mapping.device),
+        static_cast<uint64_t>(mapping.inode),
+        (mapping.readable ? 1u : 0u) | (mapping.writable ? 2u : 0u) |
+            (mapping.executable ? 4u : 0u) | (mapping.shareable ? 8u : 0u)};
+    mix(fields, sizeof(fields));
+    mix(mapping.name.data(), mapping.name.size());
   }
-  return nullptr;
+  return hash;
 }
 
 std::vector<CheckedRange<VMAddress>> MemoryMap::GetReadableRanges(
     const CheckedRange<VMAddress, VMSize>& range) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return IntersectRanges(readable_ranges_, range);
+}
+
+std::vector<CheckedRange<VMAddress>> MemoryMap::GetDumpableRanges(
+    const CheckedRange<VMAddress, VMSize>& range) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return IntersectRanges(dumpable_ranges_, range);
+}
+
+// static
+std::vector<CheckedRange<VMAddress>> MemoryMap::IntersectRanges(
+    const std::vector<ReadableRange>& ranges,
+    const CheckedRange<VMAddress, VMSize>& range) {
   using Range = CheckedRange<VMAddress, VMSize>;
 
   VMAddress range_base = range.base();
   VMAddress range_end = range.end();
-  std::vector<FastRange> overlapping;
-
-  // Find all readable ranges overlapping the target range, maintaining order.
-  for (const auto& mapping : mappings_) {
-    if (!mapping.readable)
-      continue;
-    if (mapping.range.End() < range_base)
-      continue;
-    if (mapping.range.Base() >= range_end)
-      continue;
-    // Special case: the "[vvar]" region is marked readable, but we can't
-    // access it.
-    if (mapping.inode == 0 && mapping.name == "[vvar]")
-      continue;
-    overlapping.push_back({mapping.range.Base(), mapping.range.Size()});
-  }
-  if (overlapping.empty())
-    return std::vector<Range>();
 
-  // For the first and last, trim to the boundary of the incoming range.
-  FastRange& front = overlapping.front();
-  VMAddress original_front_base = front.base;
-  front.base = std::max(front.base, range_base);
-  front.size = (original_front_base + front.size) - front.base;
-  FastRange& back = overlapping.back();
-  VMAddress back_end = back.base + back.size;
-  back.size = std::min(range_end, back_end) - back.base;
+  // Find the first readable range ending above the target range's base, and
+  // trim each overlapping range to the boundary of the target range.
+  auto readable = std::upper_bound(
+      ranges.begin(),
+      ranges.end(),
+      range_base,
+      [](VMAddress address, const ReadableRange& readable) {
+        return address < readable.end;
+      });
 
-  // Coalesce, and convert to return type.
   std::vector<Range> result;
-  result.push_back({overlapping[0].base, overlapping[0].size});
-  DCHECK(result.back().IsValid());
-  for (size_t i = 1; i < overlapping.size(); ++i) {
-    if (result.back().end() == overlapping[i].base) {
-      result.back().SetRange(result.back().base(),
-                             result.back().size() + overlapping[i].size);
-    } else {
-      result.push_back({overlapping[i].base, overlapping[i].size});
-    }
+  for (; readable != ranges.end() && readable->base < range_end; ++readable) {
+    VMAddress base = std::max(readable->base, range_base);
+    VMAddress end = std::min(readable->end, range_end);
+    result.push_back({base, end - base});
     DCHECK(result.back().IsValid());
   }
 
@@ -388,11 +554,10 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
   // If the mapping is anonymous, as is for the VDSO, there is no mapped file to
   // find the start of, so just return the input mapping.
   if (mapping.device == 0 && mapping.inode == 0) {
-    for (const auto& candidate : mappings_) {
-      if (mapping.Equals(candidate)) {
-        possible_starts.push_back(&candidate);
-        return std::make_unique<SparseReverseIterator>(possible_starts);
-      }
+    const size_t index = IndexOf(mapping);
+    if (index < mappings_.size()) {
+      possible_starts.push_back(&mappings_[index]);
+      return std::make_unique<SparseReverseIterator>(possible_starts);
     }
 
     LOG(ERROR) << "mapping not found";
@@ -430,35 +595,101 @@ std::unique_ptr<MemoryMap::Iterator> MemoryMap::FindFilePossibleMmapStarts(
   }
 #endif  // BUILDFLAG(IS_ANDROID)
 
-  for (const auto& candidate : mappings_) {
-    if (candidate.device == mapping.device &&
-        candidate.inode == mapping.inode
+  const size_t mapping_index = IndexOf(mapping);
+  if (mapping_index == mappings_.size()) {
+    LOG(ERROR) << "mapping not found";
+    return std::make_unique<SparseReverseIterator>();
+  }
+
+  // The candidates are the mappings of the same file at or below mapping,
+  // which are adjacent in mappings_by_file_.
+  const FileMapping key = {mapping.device, mapping.inode, mapping_index};
+  auto first = std::lower_bound(mappings_by_file_.begin(),
+                                mappings_by_file_.end(),
+                                FileMapping{mapping.device, mapping.inode, 0},
+                                FileMappingLess);
+  auto end = std::upper_bound(
+      first, mappings_by_file_.end(), key, FileMappingLess);
+  for (auto file_mapping = first; file_mapping != end; ++file_mapping) {
+    const Mapping& candidate = mappings_[file_mapping->index];
 #if !BUILDFLAG(IS_ANDROID)
-        // Libraries on Android may be mapped from zipfiles (APKs), in which
-        // case the offset is not 0.
-        && candidate.offset == 0
-#endif  // !BUILDFLAG(IS_ANDROID)
-    ) {
-      possible_starts.push_back(&candidate);
-    }
-    if (mapping.Equals(candidate)) {
-      return std::make_unique<SparseReverseIterator>(possible_starts);
+    // Libraries on Android may be mapped from zipfiles (APKs), in which case
+    // the offset is not 0.
+    if (candidate.offset != 0) {
+      continue;
     }
+#endif  // !BUILDFLAG(IS_ANDROID)
+    possible_starts.push_back(&candidate);
   }
-
-  LOG(ERROR) << "mapping not found";
-  return std::make_unique<SparseReverseIterator>();
+  return std::make_unique<SparseReverseIterator>(possible_starts);
 }
 
 std::unique_ptr<MemoryMap::Iterator> MemoryMap::ReverseIteratorFrom(
     const Mapping& target) const {
-  for (auto riter = mappings_.crbegin(); riter != mappings_.rend(); ++riter) {
-    if (riter->Equals(target)) {
-      return std::make_unique<FullReverseIterator>(riter, mappings_.rend());
-    }
+  const size_t index = IndexOf(target);
+  if (index < mappings_.size()) {
+    return std::make_unique<FullReverseIterator>(
+        mappings_.crbegin() + (mappings_.size() - 1 - index), mappings_.rend());
   }
   return std::make_unique<FullReverseIterator>(mappings_.rend(),
                                                mappings_.rend());
 }
 
+void MemoryMap::BuildIndex() {
+  first_mapping_with_name_.clear();
+  mappings_by_file_.clear();
+  readable_ranges_.clear();
+  dumpable_ranges_.clear();
+
+  for (size_t index = 0; index < mappings_.size(); ++index) {
+    const Mapping& mapping = mappings_[index];
+
+    // Mappings are visited in increasing address order, so the first one
+    // inserted for each name has the lowest base address.
+    first_mapping_with_name_.emplace(mapping.name, index);
+
+    if (mapping.device != 0 || mapping.inode != 0) {
+      mappings_by_file_.push_back({mapping.device, mapping.inode, index});
+    }
+
+    if (!mapping.readable) {
+      continue;
+    }
+    // Special case: the "[vvar]" region is marked readable, but we can't
+    // access it.
+    if (mapping.inode == 0 && mapping.name == "[vvar]") {
+      continue;
+    }
+    AppendRange(&readable_ranges_, mapping);
+    if (!mapping.dont_dump) {
+      AppendRange(&dumpable_ranges_, mapping);
+    }
+  }
+
+  std::sort(
+      mappings_by_file_.begin(), mappings_by_file_.end(), FileMappingLess);
+}
+
+// static
+bool MemoryMap::FileMappingLess(const FileMapping& lhs,
+                                const FileMapping& rhs) {
+  return std::tie(lhs.device, lhs.inode, lhs.index) <
+         std::tie(rhs.device, rhs.inode, rhs.index);
+}
+
+size_t MemoryMap::IndexOf(const Mapping& mapping) const {
+  // Mappings don't overlap, so at most one can start at mapping's base.
+  auto candidate = std::lower_bound(
+      mappings_.begin(),
+      mappings_.end(),
+      mapping.range.Base(),
+      [](const Mapping& candidate, LinuxVMAddress address) {
+        return candidate.range.Base() < address;
+      });
+  if (candidate != mappings_.end() && candidate->Equals(mapping)) {
+    return candidate - mappings_.begin();
+  }
+  return mappings_.size();
+}
+
 }  // namespace crashpad
@@ -15,10 +15,13 @@
 #ifndef CRASHPAD_UTIL_LINUX_MEMORY_MAP_H_
 #define CRASHPAD_UTIL_LINUX_MEMORY_MAP_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "util/linux/address_types.h"
@@ -34,6 +37,9 @@ namespace crashpad {
 //! target process is not stopped, mappings may be invalid after the return from
 //! Initialize(), and even mappings existing at the time Initialize() was called
 //! may not be found.
+//!
+//! Lookups by address, by name, and by mapped file are indexed when the map is
+//! initialized, so they remain cheap for processes with very many mappings.
 class MemoryMap {
  public:
   //! \brief Information about a mapped region of memory.
@@ -50,6 +56,13 @@ class MemoryMap {
     bool writable;
     bool executable;
     bool shareable;
+
+    //! \brief Whether the process excluded this mapping from core dumps, such
+    //!     as with `madvise(MADV_DONTDUMP)`.
+    //!
+    //! This is taken from the `dd` flag in the mapping's `VmFlags` in
+    //! `/proc/pid/smaps`, and is only set once ReadVmFlags() has succeeded.
+    bool dont_dump;
   };
 
   MemoryMap();
@@ -66,6 +79,16 @@ class MemoryMap {
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(PtraceConnection* connection);
 
+  //! \brief Reads the flags of each mapping from `/proc/pid/smaps`, setting
+  //!     Mapping::dont_dump.
+  //!
+  //! The smaps file is much more expensive for the kernel to produce than the
+  //! maps file that Initialize() reads, so this is done separately. Mappings
+  //! that have changed since Initialize() was called are left unflagged.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool ReadVmFlags();
+
   //! \return The Mapping containing \a address or `nullptr` if no match is
   //!     found. The caller does not take ownership of this object. It is scoped
   //!     to the lifetime of the MemoryMap object that it was obtained from.
@@ -87,6 +110,19 @@ class MemoryMap {
   std::vector<CheckedRange<uint64_t>> GetReadableRanges(
       const CheckedRange<LinuxVMAddress, LinuxVMSize>& range) const;
 
+  //! \brief Like GetReadableRanges(), but also excludes the portions of \a
+  //!     range in mappings that the process excluded from core dumps.
+  //!
+  //! Such mappings are only known once ReadVmFlags() has succeeded. See
+  //! Mapping::dont_dump.
+  //!
+  //! \param[in] range The range being identified.
+  //!
+  //! \return A vector of ranges corresponding to the portion of \a range that
+  //!     is readable and may be dumped based on the memory map.
+  std::vector<CheckedRange<uint64_t>> GetDumpableRanges(
+      const CheckedRange<LinuxVMAddress, LinuxVMSize>& range) const;
+
   //! \brief An abstract base class for iterating over ordered sets of mappings
   //!   in a MemoryMap.
   class Iterator {
@@ -137,8 +173,62 @@ class MemoryMap {
   //!     mapping to the start of the MemoryMap.
   std::unique_ptr<Iterator> ReverseIteratorFrom(const Mapping& mapping) const;
 
+  //! \brief Returns a hash of the file-backed mappings.
+  //!
+  //! The value changes whenever a mapping of a file is added, removed, moved,
+  //! or has its protection changed, so it can be compared across
+  //! MemoryMap objects for the same process to tell whether the set of loaded
+  //! modules may have changed. Anonymous mappings, such as heap and thread
+  //! stacks, do not contribute.
+  uint64_t FileMappingFingerprint() const;
+
  private:
+  // A maximal run of contiguous readable mappings, as [base, end).
+  struct ReadableRange {
+    LinuxVMAddress base;
+    LinuxVMAddress end;
+  };
+
+  // A file-backed mapping's place in mappings_by_file_.
+  struct FileMapping {
+    dev_t device;
+    ino_t inode;
+    size_t index;
+  };
+
+  // Orders FileMapping values by device, inode, and index.
+  static bool FileMappingLess(const FileMapping& lhs, const FileMapping& rhs);
+
+  // Returns the parts of range that lie within ranges.
+  static std::vector<CheckedRange<uint64_t>> IntersectRanges(
+      const std::vector<ReadableRange>& ranges,
+      const CheckedRange<LinuxVMAddress, LinuxVMSize>& range);
+
+  // Builds first_mapping_with_name_, mappings_by_file_, readable_ranges_, and
+  // dumpable_ranges_ from mappings_.
+  void BuildIndex();
+
+  // Returns the index in mappings_ of the mapping that Equals() mapping, or
+  // mappings_.size() if there is none.
+  size_t IndexOf(const Mapping& mapping) const;
+
+  // Sorted by base address, with no overlaps.
   std::vector<Mapping> mappings_;
+
+  // Maps each name to the index of the lowest mapping with that name. The keys
+  // refer to the names stored in mappings_.
+  std::unordered_map<std::string_view, size_t> first_mapping_with_name_;
+
+  // The mappings that aren't anonymous, sorted by device, inode, and index in
+  // mappings_, so that each file's mappings are adjacent and in address order.
+  std::vector<FileMapping> mappings_by_file_;
+
+  // Sorted and coalesced, excluding mappings that can't be read.
+  std::vector<ReadableRange> readable_ranges_;
+
+  // Like readable_ranges_, also excluding mappings flagged dont_dump.
+  std::vector<ReadableRange> dumpable_ranges_;
+
   PtraceConnection* connection_;
   InitializationStateDcheck initialized_;
 };
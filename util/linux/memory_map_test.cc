@@ -121,6 +121,163 @@ TEST(MemoryMap, SelfBasic) {
   EXPECT_TRUE(mapping->shareable);
 }
 
+TEST(MemoryMap, SelfFileMappingFingerprint) {
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  MemoryMap initial_map;
+  ASSERT_TRUE(initial_map.Initialize(&connection));
+  const uint64_t initial_fingerprint = initial_map.FileMappingFingerprint();
+
+  // Anonymous mappings don't contribute.
+  ScopedMmap anonymous_mapping;
+  ASSERT_TRUE(anonymous_mapping.ResetMmap(nullptr,
+                                          getpagesize(),
+                                          PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANON,
+                                          -1,
+                                          0));
+  MemoryMap anonymous_map;
+  ASSERT_TRUE(anonymous_map.Initialize(&connection));
+  EXPECT_EQ(anonymous_map.FileMappingFingerprint(), initial_fingerprint);
+
+  ScopedTempDir temp_dir;
+  base::FilePath path = temp_dir.path().Append("crashpad_test_file");
+  ScopedFileHandle handle(
+      LoggingOpenFileForReadAndWrite(path,
+                                     FileWriteMode::kCreateOrFail,
+                                     FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(handle.is_valid());
+  ASSERT_EQ(ftruncate(handle.get(), getpagesize()), 0)
+      << ErrnoMessage("ftruncate");
+
+  ScopedMmap file_mapping;
+  ASSERT_TRUE(file_mapping.ResetMmap(
+      nullptr, getpagesize(), PROT_READ, MAP_SHARED, handle.get(), 0));
+  MemoryMap file_map;
+  ASSERT_TRUE(file_map.Initialize(&connection));
+  EXPECT_NE(file_map.FileMappingFingerprint(), initial_fingerprint);
+}
+
+TEST(MemoryMap, SelfReadableRanges) {
+  const size_t page_size = getpagesize();
+  ScopedMmap mmapping;
+  ASSERT_TRUE(mmapping.ResetMmap(nullptr,
+                                 page_size * 3,
+                                 PROT_READ,
+                                 MAP_PRIVATE | MAP_ANON,
+                                 -1,
+                                 0));
+  ASSERT_EQ(mprotect(mmapping.addr_as<char*>() + page_size,
+                     page_size,
+                     PROT_NONE),
+            0)
+      << ErrnoMessage("mprotect");
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  MemoryMap map;
+  ASSERT_TRUE(map.Initialize(&connection));
+
+  const auto base = mmapping.addr_as<VMAddress>();
+  const MemoryMap::Mapping* mapping = map.FindMapping(base + page_size);
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(mapping->range.Base(), base + page_size);
+  EXPECT_EQ(mapping->range.End(), base + page_size * 2);
+  EXPECT_FALSE(mapping->readable);
+
+  mapping = map.FindMapping(base + page_size - 1);
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(mapping->range.End(), base + page_size);
+  EXPECT_TRUE(mapping->readable);
+
+  mapping = map.FindMapping(base + page_size * 2);
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(mapping->range.Base(), base + page_size * 2);
+  EXPECT_TRUE(mapping->readable);
+
+  // Neighboring mappings may also be readable, so the results are trimmed to
+  // the requested range.
+  std::vector<CheckedRange<VMAddress>> ranges = map.GetReadableRanges(
+      CheckedRange<VMAddress, VMSize>(base, page_size * 3));
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0].base(), base);
+  EXPECT_EQ(ranges[0].size(), page_size);
+  EXPECT_EQ(ranges[1].base(), base + page_size * 2);
+  EXPECT_EQ(ranges[1].size(), page_size);
+
+  ranges = map.GetReadableRanges(
+      CheckedRange<VMAddress, VMSize>(base + page_size, page_size));
+  EXPECT_TRUE(ranges.empty());
+
+  ranges = map.GetReadableRanges(
+      CheckedRange<VMAddress, VMSize>(base + page_size / 2, page_size * 2));
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0].base(), base + page_size / 2);
+  EXPECT_EQ(ranges[0].size(), page_size / 2);
+  EXPECT_EQ(ranges[1].base(), base + page_size * 2);
+  EXPECT_EQ(ranges[1].size(), page_size / 2);
+}
+
+TEST(MemoryMap, SelfDontDump) {
+  const size_t page_size = getpagesize();
+  ScopedMmap mmapping;
+  ASSERT_TRUE(mmapping.ResetMmap(nullptr,
+                                 page_size * 3,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANON,
+                                 -1,
+                                 0));
+  ASSERT_EQ(madvise(mmapping.addr_as<char*>() + page_size,
+                    page_size,
+                    MADV_DONTDUMP),
+            0)
+      << ErrnoMessage("madvise");
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+
+  MemoryMap map;
+  ASSERT_TRUE(map.Initialize(&connection));
+
+  const auto base = mmapping.addr_as<VMAddress>();
+  const CheckedRange<VMAddress, VMSize> range(base, page_size * 3);
+  const MemoryMap::Mapping* mapping = map.FindMapping(base + page_size);
+  ASSERT_TRUE(mapping);
+  EXPECT_FALSE(mapping->dont_dump);
+
+  // Until the flags are read, every readable range may be dumped.
+  std::vector<CheckedRange<VMAddress>> ranges = map.GetDumpableRanges(range);
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].base(), base);
+  EXPECT_EQ(ranges[0].size(), page_size * 3);
+
+  ASSERT_TRUE(map.ReadVmFlags());
+  mapping = map.FindMapping(base + page_size);
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(mapping->range.Base(), base + page_size);
+  EXPECT_EQ(mapping->range.End(), base + page_size * 2);
+  EXPECT_TRUE(mapping->dont_dump);
+  EXPECT_TRUE(mapping->readable);
+
+  mapping = map.FindMapping(base);
+  ASSERT_TRUE(mapping);
+  EXPECT_FALSE(mapping->dont_dump);
+
+  ranges = map.GetDumpableRanges(range);
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0].base(), base);
+  EXPECT_EQ(ranges[0].size(), page_size);
+  EXPECT_EQ(ranges[1].base(), base + page_size * 2);
+  EXPECT_EQ(ranges[1].size(), page_size);
+
+  // The excluded mapping is still readable.
+  ranges = map.GetReadableRanges(range);
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].size(), page_size * 3);
+}
+
 void InitializeFile(const base::FilePath& path,
                     size_t size,
                     ScopedFileHandle* handle) {
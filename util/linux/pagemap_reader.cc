@@ -0,0 +1,151 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/pagemap_reader.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+
+namespace crashpad {
+
+namespace {
+
+// Bits of a /proc/pid/pagemap entry. See the kernel's
+// Documentation/admin-guide/mm/pagemap.rst.
+constexpr uint64_t kPagemapPresent = uint64_t{1} << 63;
+constexpr uint64_t kPagemapSwapped = uint64_t{1} << 62;
+
+// The number of pagemap entries read at once.
+constexpr size_t kEntriesPerRead = 512;
+
+// Returns whether a page of mapping that has never been populated reads as
+// zeroes. That's only known for private anonymous mappings. Named anonymous
+// mappings, such as "[anon:...]", and the heap and main thread stack qualify,
+// but other special mappings such as "[vdso]" don't.
+bool MappingIsPrivateAnonymous(const MemoryMap::Mapping& mapping) {
+  if (mapping.shareable || mapping.inode != 0 || !mapping.readable) {
+    return false;
+  }
+  const std::string& name = mapping.name;
+  return name.empty() || name == "[heap]" || name == "[stack]" ||
+         name.compare(0, 6, "[anon:") == 0;
+}
+
+}  // namespace
+
+PagemapReader::PagemapReader()
+    : pagemap_fd_(), memory_map_(nullptr), page_size_(0), initialized_() {}
+
+PagemapReader::~PagemapReader() {}
+
+bool PagemapReader::Initialize(pid_t pid, const MemoryMap* memory_map) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  char path[32];
+  snprintf(path, std::size(path), "/proc/%d/pagemap", pid);
+  pagemap_fd_.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  if (!pagemap_fd_.is_valid()) {
+    PLOG(WARNING) << "open " << path;
+    return false;
+  }
+
+  memory_map_ = memory_map;
+  page_size_ = static_cast<LinuxVMSize>(getpagesize());
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+void PagemapReader::UnpopulatedRanges(
+    LinuxVMAddress address,
+    LinuxVMSize size,
+    std::vector<CheckedRange<LinuxVMAddress, LinuxVMSize>>* ranges) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  ranges->clear();
+
+  // Only whole pages within the region are reported.
+  const LinuxVMAddress end =
+      address + size >= address ? address + size : ~LinuxVMAddress{0};
+  LinuxVMAddress position = (address + page_size_ - 1) & ~(page_size_ - 1);
+  const LinuxVMAddress aligned_end = end & ~(page_size_ - 1);
+  if (position < address) {
+    return;
+  }
+
+  while (position < aligned_end) {
+    const MemoryMap::Mapping* mapping = memory_map_->FindMapping(position);
+    if (!mapping) {
+      // The rest of the region can't be read anyway.
+      return;
+    }
+
+    const LinuxVMAddress piece_end =
+        std::min(aligned_end, mapping->range.End());
+    if (MappingIsPrivateAnonymous(*mapping) &&
+        !AppendUnpopulatedPages(position, piece_end, ranges)) {
+      ranges->clear();
+      return;
+    }
+    position = piece_end;
+  }
+}
+
+bool PagemapReader::AppendUnpopulatedPages(
+    LinuxVMAddress begin,
+    LinuxVMAddress end,
+    std::vector<CheckedRange<LinuxVMAddress, LinuxVMSize>>* ranges) const {
+  uint64_t entries[kEntriesPerRead];
+  LinuxVMAddress page = begin;
+  while (page < end) {
+    const size_t count = static_cast<size_t>(
+        std::min<LinuxVMSize>(kEntriesPerRead, (end - page) / page_size_));
+    const off64_t offset =
+        static_cast<off64_t>(page / page_size_ * sizeof(entries[0]));
+    const ssize_t bytes_read = HANDLE_EINTR(pread64(
+        pagemap_fd_.get(), entries, count * sizeof(entries[0]), offset));
+    if (bytes_read < 0) {
+      PLOG(WARNING) << "pread64";
+      return false;
+    }
+    const size_t entries_read =
+        static_cast<size_t>(bytes_read) / sizeof(entries[0]);
+    if (entries_read == 0) {
+      LOG(WARNING) << "unexpected end of pagemap";
+      return false;
+    }
+
+    for (size_t index = 0; index < entries_read; ++index, page += page_size_) {
+      if (entries[index] & (kPagemapPresent | kPagemapSwapped)) {
+        continue;
+      }
+      if (!ranges->empty() && ranges->back().end() == page) {
+        ranges->back().SetRange(ranges->back().base(),
+                                ranges->back().size() + page_size_);
+      } else {
+        ranges->emplace_back(page, page_size_);
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,89 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_PAGEMAP_READER_H_
+#define CRASHPAD_UTIL_LINUX_PAGEMAP_READER_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <vector>
+
+#include "base/files/scoped_file.h"
+#include "util/linux/address_types.h"
+#include "util/linux/memory_map.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/numeric/checked_range.h"
+
+namespace crashpad {
+
+//! \brief Determines which pages of another process have never been
+//!     populated by reading its `/proc/pid/pagemap` file.
+//!
+//! Only pages of private anonymous mappings, such as the heap, thread stacks,
+//! and reserved arenas, are reported. A page of such a mapping that is neither
+//! present nor swapped out has never been written to, and reads as zeroes.
+//! Other pages that aren't present, such as those of file mappings, may still
+//! hold data elsewhere, and are never reported.
+//!
+//! This class is thread-safe once initialized.
+class PagemapReader {
+ public:
+  PagemapReader();
+
+  PagemapReader(const PagemapReader&) = delete;
+  PagemapReader& operator=(const PagemapReader&) = delete;
+
+  ~PagemapReader();
+
+  //! \brief Initializes this object.
+  //!
+  //! \param[in] pid The process ID of the process to examine.
+  //! \param[in] memory_map The memory map of the process, which must outlive
+  //!     this object.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize(pid_t pid, const MemoryMap* memory_map);
+
+  //! \brief Determines which pages of a memory region have never been
+  //!     populated.
+  //!
+  //! \param[in] address The address of the memory region to examine.
+  //! \param[in] size The size of the memory region to examine.
+  //! \param[out] ranges Page-aligned ranges within the region that have never
+  //!     been populated, sorted by address and neither overlapping nor
+  //!     abutting one another. Empty if none are known, including if
+  //!     `/proc/pid/pagemap` can't be read.
+  void UnpopulatedRanges(
+      LinuxVMAddress address,
+      LinuxVMSize size,
+      std::vector<CheckedRange<LinuxVMAddress, LinuxVMSize>>* ranges) const;
+
+ private:
+  // Appends the never-populated pages in [begin, end) to ranges. begin and end
+  // must be page-aligned and lie within a single mapping. Returns false if
+  // pagemap_fd_ can't be read.
+  bool AppendUnpopulatedPages(
+      LinuxVMAddress begin,
+      LinuxVMAddress end,
+      std::vector<CheckedRange<LinuxVMAddress, LinuxVMSize>>* ranges) const;
+
+  base::ScopedFD pagemap_fd_;
+  const MemoryMap* memory_map_;  // weak
+  LinuxVMSize page_size_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_PAGEMAP_READER_H_
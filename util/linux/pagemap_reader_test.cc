@@ -0,0 +1,107 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/pagemap_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#include "gtest/gtest.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/posix/scoped_mmap.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+using Range = CheckedRange<LinuxVMAddress, LinuxVMSize>;
+
+TEST(PagemapReader, UnpopulatedAnonymousPages) {
+  const size_t page_size = getpagesize();
+  constexpr size_t kPages = 16;
+  ScopedMmap mapping;
+  ASSERT_TRUE(mapping.ResetMmap(nullptr,
+                                kPages * page_size,
+                                PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1,
+                                0));
+  char* const pages = mapping.addr_as<char*>();
+  pages[3 * page_size] = 1;
+  pages[10 * page_size + 1] = 1;
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+  MemoryMap memory_map;
+  ASSERT_TRUE(memory_map.Initialize(&connection));
+
+  PagemapReader pagemap;
+  ASSERT_TRUE(pagemap.Initialize(getpid(), &memory_map));
+
+  const LinuxVMAddress base = FromPointerCast<LinuxVMAddress>(pages);
+  std::vector<Range> ranges;
+  pagemap.UnpopulatedRanges(base, kPages * page_size, &ranges);
+  ASSERT_EQ(ranges.size(), 3u);
+  EXPECT_EQ(ranges[0].base(), base);
+  EXPECT_EQ(ranges[0].size(), 3 * page_size);
+  EXPECT_EQ(ranges[1].base(), base + 4 * page_size);
+  EXPECT_EQ(ranges[1].size(), 6 * page_size);
+  EXPECT_EQ(ranges[2].base(), base + 11 * page_size);
+  EXPECT_EQ(ranges[2].size(), 5 * page_size);
+
+  // Only whole pages within the region are reported.
+  pagemap.UnpopulatedRanges(
+      base + page_size / 2, 3 * page_size + page_size / 2, &ranges);
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].base(), base + page_size);
+  EXPECT_EQ(ranges[0].size(), 2 * page_size);
+
+  // A populated page alone yields nothing.
+  pagemap.UnpopulatedRanges(base + 3 * page_size, page_size, &ranges);
+  EXPECT_TRUE(ranges.empty());
+}
+
+TEST(PagemapReader, FileMappingsNotReported) {
+  base::ScopedFD fd(
+      HANDLE_EINTR(open("/proc/self/exe", O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  ASSERT_TRUE(fd.is_valid());
+
+  // The page is never touched, so it isn't present, but its contents are in
+  // the file.
+  const size_t page_size = getpagesize();
+  ScopedMmap mapping;
+  ASSERT_TRUE(mapping.ResetMmap(
+      nullptr, page_size, PROT_READ, MAP_PRIVATE, fd.get(), 0));
+
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(getpid()));
+  MemoryMap memory_map;
+  ASSERT_TRUE(memory_map.Initialize(&connection));
+
+  PagemapReader pagemap;
+  ASSERT_TRUE(pagemap.Initialize(getpid(), &memory_map));
+
+  std::vector<Range> ranges;
+  pagemap.UnpopulatedRanges(
+      FromPointerCast<LinuxVMAddress>(mapping.addr()), page_size, &ranges);
+  EXPECT_TRUE(ranges.empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
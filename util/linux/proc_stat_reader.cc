@@ -50,10 +50,28 @@ bool ProcStatReader::Initialize(PtraceConnection* connection, pid_t tid) {
 
   char path[32];
   snprintf(path, std::size(path), "/proc/%d/stat", tid);
-  if (!connection->ReadFileContents(base::FilePath(path), &contents_)) {
+  if (!connection->ReadFileContents(base::FilePath(path), &contents_) ||
+      !ParseContents()) {
     return false;
   }
 
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcStatReader::InitializeWithContents(const std::string& contents) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  contents_ = contents;
+  if (!ParseContents()) {
+    return false;
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool ProcStatReader::ParseContents() {
   // The first column is process ID and the second column is the executable name
   // in parentheses. This class only cares about columns after the second, so
   // find the start of the third here and save it for later.
@@ -72,7 +90,6 @@ bool ProcStatReader::Initialize(PtraceConnection* connection, pid_t tid) {
     return false;
   }
 
-  INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
 
@@ -99,6 +116,48 @@ bool ProcStatReader::StartTime(const timeval& boot_time,
   return true;
 }
 
+bool ProcStatReader::State(char* state) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const char* state_ptr;
+  if (!FindColumn(2, &state_ptr)) {
+    return false;
+  }
+
+  *state = *state_ptr;
+  return true;
+}
+
+bool ProcStatReader::ParentProcessID(pid_t* ppid) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const char* ppid_ptr;
+  if (!FindColumn(3, &ppid_ptr)) {
+    return false;
+  }
+
+  if (!AdvancePastNumber<pid_t>(&ppid_ptr, ppid)) {
+    LOG(ERROR) << "format error";
+    return false;
+  }
+  return true;
+}
+
+bool ProcStatReader::LastCPU(int* cpu) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  const char* cpu_ptr;
+  if (!FindColumn(38, &cpu_ptr)) {
+    return false;
+  }
+
+  if (!AdvancePastNumber<int>(&cpu_ptr, cpu)) {
+    LOG(ERROR) << "format error";
+    return false;
+  }
+  return true;
+}
+
 bool ProcStatReader::FindColumn(int col_index, const char** column) const {
   size_t position = third_column_position_;
   for (int index = 2; index < col_index; ++index) {
@@ -45,6 +45,15 @@ class ProcStatReader {
   //! \param[in] tid The thread ID to read the stat file for.
   bool Initialize(PtraceConnection* connection, pid_t tid);
 
+  //! \brief Initializes the reader with the contents of a stat file which have
+  //!     already been read, such as ProcTaskInfo::stat.
+  //!
+  //! This method or Initialize() must be successfully called before calling
+  //! any other.
+  //!
+  //! \param[in] contents The contents of the stat file.
+  bool InitializeWithContents(const std::string& contents);
+
   //! \brief Determines the time the thread has spent executing in user mode.
   //!
   //! \param[out] user_time The time spent executing in user mode.
@@ -70,7 +79,33 @@ class ProcStatReader {
   //!     a message logged.
   bool StartTime(const timeval& boot_time, timeval* start_time) const;
 
+  //! \brief Determines the target thread’s scheduling state.
+  //!
+  //! \param[out] state The state, as the single character that `proc(5)`
+  //!     documents, such as `'R'` for running or `'S'` for sleeping.
+  //!
+  //! \return `true` on success, with \a state set. Otherwise, `false` with a
+  //!     message logged.
+  bool State(char* state) const;
+
+  //! \brief Determines the process ID of the target thread’s parent process.
+  //!
+  //! \param[out] ppid The parent process ID.
+  //!
+  //! \return `true` on success, with \a ppid set. Otherwise, `false` with a
+  //!     message logged.
+  bool ParentProcessID(pid_t* ppid) const;
+
+  //! \brief Determines the CPU that the target thread last ran on.
+  //!
+  //! \param[out] cpu The CPU number.
+  //!
+  //! \return `true` on success, with \a cpu set. Otherwise, `false` with a
+  //!     message logged.
+  bool LastCPU(int* cpu) const;
+
  private:
+  bool ParseContents();
   bool FindColumn(int index, const char** column) const;
   bool ReadTimeAtIndex(int index, timeval* time_val) const;
 
@@ -18,6 +18,9 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <string>
+
+#include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
 #include "test/linux/fake_ptrace_connection.h"
 #include "util/misc/time.h"
@@ -55,6 +58,57 @@ TEST(ProcStatReader, Basic) {
   timeval system_time;
   ASSERT_TRUE(stat.SystemCPUTime(&system_time));
   EXPECT_LE(system_time.tv_sec, elapsed_sec);
+
+  pid_t ppid;
+  ASSERT_TRUE(stat.ParentProcessID(&ppid));
+  EXPECT_EQ(ppid, getppid());
+}
+
+TEST(ProcStatReader, Contents) {
+  const long ticks_per_s = sysconf(_SC_CLK_TCK);
+  ASSERT_GT(ticks_per_s, 0);
+
+  // The executable name may itself contain parentheses and spaces.
+  const std::string contents = base::StringPrintf(
+      "1234 (a) (b) S 1 2 3 4 5 6 7 8 9 10 %ld %ld 0 0 20 0 1 0 %ld 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 6 0\n",
+      ticks_per_s * 3,
+      ticks_per_s * 5,
+      ticks_per_s * 7);
+
+  ProcStatReader stat;
+  ASSERT_TRUE(stat.InitializeWithContents(contents));
+
+  timeval user_time;
+  ASSERT_TRUE(stat.UserCPUTime(&user_time));
+  EXPECT_EQ(user_time.tv_sec, 3);
+  EXPECT_EQ(user_time.tv_usec, 0);
+
+  timeval system_time;
+  ASSERT_TRUE(stat.SystemCPUTime(&system_time));
+  EXPECT_EQ(system_time.tv_sec, 5);
+  EXPECT_EQ(system_time.tv_usec, 0);
+
+  timeval boot_time = {};
+  timeval start_time;
+  ASSERT_TRUE(stat.StartTime(boot_time, &start_time));
+  EXPECT_EQ(start_time.tv_sec, 7);
+  EXPECT_EQ(start_time.tv_usec, 0);
+
+  char state;
+  ASSERT_TRUE(stat.State(&state));
+  EXPECT_EQ(state, 'S');
+
+  pid_t ppid;
+  ASSERT_TRUE(stat.ParentProcessID(&ppid));
+  EXPECT_EQ(ppid, 1);
+
+  int cpu;
+  ASSERT_TRUE(stat.LastCPU(&cpu));
+  EXPECT_EQ(cpu, 6);
+
+  ProcStatReader bad_stat;
+  EXPECT_FALSE(bad_stat.InitializeWithContents("1234 (a"));
 }
 
 pid_t gettid() {
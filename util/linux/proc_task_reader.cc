@@ -14,19 +14,91 @@
 
 #include "util/linux/proc_task_reader.h"
 
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <iterator>
+#include <utility>
 
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
 #include "util/file/directory_reader.h"
+#include "util/file/file_io.h"
 #include "util/misc/as_underlying_type.h"
 
 namespace crashpad {
 
+namespace {
+
+// Reads the file at path, relative to dir_fd, into contents, using buffer for
+// each read. Returns false without logging if the file couldn't be read, which
+// is expected for threads that exit while their files are being read.
+bool ReadTaskFile(int dir_fd,
+                  const char* path,
+                  char* buffer,
+                  size_t buffer_size,
+                  std::string* contents) {
+  contents->clear();
+  ScopedFileHandle handle(
+      HANDLE_EINTR(openat(dir_fd, path, O_RDONLY | O_CLOEXEC | O_NOCTTY)));
+  if (!handle.is_valid()) {
+    return false;
+  }
+
+  FileOperationResult bytes_read;
+  while ((bytes_read = ReadFile(handle.get(), buffer, buffer_size)) > 0) {
+    contents->append(buffer, bytes_read);
+  }
+  if (bytes_read < 0) {
+    contents->clear();
+    return false;
+  }
+  return true;
+}
+
+// Parses the number following key, which must begin a line in status.
+bool ParseStatusValue(const std::string& status,
+                      const char* key,
+                      uint64_t* value) {
+  size_t position = status.find(key);
+  while (position != std::string::npos && position != 0 &&
+         status[position - 1] != '\n') {
+    position = status.find(key, position + 1);
+  }
+  if (position == std::string::npos) {
+    return false;
+  }
+
+  position += strlen(key);
+  while (position < status.size() &&
+         (status[position] == ' ' || status[position] == '\t')) {
+    ++position;
+  }
+  const size_t end = status.find('\n', position);
+  return base::StringToUint64(
+      base::StringPiece(status).substr(
+          position, end == std::string::npos ? end : end - position),
+      value);
+}
+
+}  // namespace
+
+bool ParseTaskContextSwitches(const std::string& status, ProcTaskInfo* task) {
+  task->have_context_switches =
+      ParseStatusValue(status,
+                       "voluntary_ctxt_switches:",
+                       &task->voluntary_context_switches) &&
+      ParseStatusValue(status,
+                       "nonvoluntary_ctxt_switches:",
+                       &task->involuntary_context_switches);
+  return task->have_context_switches;
+}
+
 bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids) {
   DCHECK(tids->empty());
 
@@ -58,4 +130,59 @@ bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids) {
   return true;
 }
 
+bool ReadTaskInfo(pid_t pid, std::vector<ProcTaskInfo>* tasks) {
+  DCHECK(tasks->empty());
+
+  char path[32];
+  snprintf(path, std::size(path), "/proc/%d/task", pid);
+  DirectoryReader reader;
+  if (!reader.Open(base::FilePath(path))) {
+    return false;
+  }
+
+  // Every file is read into the same buffer, and opened relative to the task
+  // directory so that the kernel doesn't resolve the full path for each one.
+  char buffer[4096];
+  std::string status;
+  std::vector<ProcTaskInfo> local_tasks;
+  base::FilePath tid_str;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&tid_str)) ==
+         DirectoryReader::Result::kSuccess) {
+    ProcTaskInfo task;
+    if (!base::StringToInt(tid_str.value(), &task.tid)) {
+      LOG(ERROR) << "format error";
+      continue;
+    }
+
+    snprintf(path, std::size(path), "%d/comm", task.tid);
+    if (ReadTaskFile(reader.DirectoryFD(),
+                     path,
+                     buffer,
+                     sizeof(buffer),
+                     &task.name) &&
+        !task.name.empty() && task.name.back() == '\n') {
+      task.name.pop_back();
+    }
+
+    snprintf(path, std::size(path), "%d/stat", task.tid);
+    ReadTaskFile(
+        reader.DirectoryFD(), path, buffer, sizeof(buffer), &task.stat);
+
+    snprintf(path, std::size(path), "%d/status", task.tid);
+    if (ReadTaskFile(
+            reader.DirectoryFD(), path, buffer, sizeof(buffer), &status)) {
+      ParseTaskContextSwitches(status, &task);
+    }
+
+    local_tasks.push_back(std::move(task));
+  }
+  DCHECK_EQ(AsUnderlyingType(result),
+            AsUnderlyingType(DirectoryReader::Result::kNoMoreFiles));
+  DCHECK(!local_tasks.empty());
+
+  tasks->swap(local_tasks);
+  return true;
+}
+
 }  // namespace crashpad
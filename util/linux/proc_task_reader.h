@@ -15,8 +15,10 @@
 #ifndef CRASHPAD_UTIL_LINUX_PROC_TASK_READER_H_
 #define CRASHPAD_UTIL_LINUX_PROC_TASK_READER_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
+#include <string>
 #include <vector>
 
 namespace crashpad {
@@ -30,6 +32,59 @@ namespace crashpad {
 //!     are logged, but won't cause this function to return `false`.
 bool ReadThreadIDs(pid_t pid, std::vector<pid_t>* tids);
 
+//! \brief Information about a thread, read from
+//!     <code>/proc/<i>pid</i>/task/<i>tid</i></code>.
+struct ProcTaskInfo {
+  //! \brief The thread ID.
+  pid_t tid;
+
+  //! \brief The thread's name, read from `comm`, without its trailing newline.
+  //!     Empty if the name could not be read.
+  std::string name;
+
+  //! \brief The contents of the thread's `stat` file, suitable for
+  //!     ProcStatReader::InitializeWithContents(). Empty if the file could not
+  //!     be read.
+  std::string stat;
+
+  //! \brief The number of times the thread gave up its CPU voluntarily, read
+  //!     from `status`. Valid only if #have_context_switches is `true`.
+  uint64_t voluntary_context_switches = 0;
+
+  //! \brief The number of times the thread was preempted, read from `status`.
+  //!     Valid only if #have_context_switches is `true`.
+  uint64_t involuntary_context_switches = 0;
+
+  //! \brief `true` if the context switch counts were read.
+  bool have_context_switches = false;
+};
+
+//! \brief Parses the context switch counts from the contents of a thread's
+//!     `status` file.
+//!
+//! \param[in] status The contents of the thread's `status` file.
+//! \param[out] task The ProcTaskInfo whose context switch counts and
+//!     ProcTaskInfo::have_context_switches are set.
+//! \return `true` if both counts were found. Otherwise, `false`, with
+//!     ProcTaskInfo::have_context_switches set to `false`.
+bool ParseTaskContextSwitches(const std::string& status, ProcTaskInfo* task);
+
+//! \brief Enumerates the threads of a process along with their names, `stat`
+//!     files, and context switch counts in a single pass over
+//!     <code>/proc/<i>pid</i>/task</code>.
+//!
+//! This is equivalent to calling ReadThreadIDs() and then reading `comm`,
+//! `stat`, and `status` for each thread, but opens each thread's files
+//! relative to the task directory and reads them into a single reused buffer.
+//!
+//! \param[in] pid The process ID for which to read thread information.
+//! \param[out] tasks Information about each thread. A thread which exits
+//!     during the walk may be present with an empty ProcTaskInfo::name and
+//!     ProcTaskInfo::stat, and without context switch counts.
+//! \return `true` if the task directory was successfully read. Format errors
+//!     are logged, but won't cause this function to return `false`.
+bool ReadTaskInfo(pid_t pid, std::vector<ProcTaskInfo>* tasks);
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_LINUX_PROC_TASK_READER_H_
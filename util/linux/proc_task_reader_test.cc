@@ -14,10 +14,16 @@
 
 #include "util/linux/proc_task_reader.h"
 
+#include <sys/prctl.h>
+
+#include <string>
+
+#include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "gtest/gtest.h"
 #include "test/multiprocess_exec.h"
 #include "third_party/lss/lss.h"
+#include "util/linux/proc_stat_reader.h"
 #include "util/synchronization/semaphore.h"
 #include "util/thread/thread.h"
 
@@ -36,7 +42,8 @@ bool FindThreadID(pid_t tid, const std::vector<pid_t>& threads) {
 
 class ScopedBlockingThread : public Thread {
  public:
-  ScopedBlockingThread() : tid_sem_(0), join_sem_(0), tid_(-1) {}
+  explicit ScopedBlockingThread(const char* name = nullptr)
+      : tid_sem_(0), join_sem_(0), name_(name), tid_(-1) {}
 
   ~ScopedBlockingThread() {
     join_sem_.Signal();
@@ -50,6 +57,9 @@ class ScopedBlockingThread : public Thread {
 
  private:
   void ThreadMain() override {
+    if (name_) {
+      PCHECK(prctl(PR_SET_NAME, name_, 0, 0, 0) == 0) << "prctl";
+    }
     tid_ = sys_gettid();
     tid_sem_.Signal();
     join_sem_.Wait();
@@ -57,6 +67,7 @@ class ScopedBlockingThread : public Thread {
 
   Semaphore tid_sem_;
   Semaphore join_sem_;
+  const char* name_;
   pid_t tid_;
 };
 
@@ -88,6 +99,66 @@ TEST(ProcTaskReader, BadPID) {
 
   tids.clear();
   EXPECT_FALSE(ReadThreadIDs(0, &tids));
+
+  std::vector<ProcTaskInfo> tasks;
+  EXPECT_FALSE(ReadTaskInfo(-1, &tasks));
+}
+
+TEST(ProcTaskReader, TaskInfoSelf) {
+  static constexpr char kThreadName[] = "TaskInfoThread";
+  ScopedBlockingThread thread(kThreadName);
+  thread.Start();
+  pid_t thread_tid = thread.ThreadID();
+
+  std::vector<ProcTaskInfo> tasks;
+  ASSERT_TRUE(ReadTaskInfo(getpid(), &tasks));
+
+  bool found_main_thread = false;
+  bool found_thread = false;
+  for (const ProcTaskInfo& task : tasks) {
+    SCOPED_TRACE(base::StringPrintf("tid %d", task.tid));
+    EXPECT_FALSE(task.name.empty());
+    EXPECT_EQ(task.name.find('\n'), std::string::npos);
+
+    ProcStatReader stat;
+    EXPECT_TRUE(stat.InitializeWithContents(task.stat));
+    EXPECT_EQ(task.stat.substr(0, task.stat.find(' ')),
+              base::StringPrintf("%d", task.tid));
+    EXPECT_TRUE(task.have_context_switches);
+
+    if (task.tid == getpid()) {
+      found_main_thread = true;
+    } else if (task.tid == thread_tid) {
+      found_thread = true;
+      EXPECT_EQ(task.name, kThreadName);
+    }
+  }
+  EXPECT_TRUE(found_main_thread);
+  EXPECT_TRUE(found_thread);
+}
+
+TEST(ProcTaskReader, ParseTaskContextSwitches) {
+  static constexpr char kStatus[] =
+      "Name:\tthread\n"
+      "State:\tS (sleeping)\n"
+      "voluntary_ctxt_switches:\t12\n"
+      "nonvoluntary_ctxt_switches:\t3\n";
+  ProcTaskInfo task;
+  ASSERT_TRUE(ParseTaskContextSwitches(kStatus, &task));
+  EXPECT_TRUE(task.have_context_switches);
+  EXPECT_EQ(task.voluntary_context_switches, 12u);
+  EXPECT_EQ(task.involuntary_context_switches, 3u);
+
+  // voluntary_ctxt_switches must begin a line, and not be found as the end of
+  // nonvoluntary_ctxt_switches.
+  EXPECT_FALSE(ParseTaskContextSwitches(
+      "Name:\tthread\nnonvoluntary_ctxt_switches:\t3\n", &task));
+  EXPECT_FALSE(task.have_context_switches);
+
+  EXPECT_FALSE(ParseTaskContextSwitches(
+      "voluntary_ctxt_switches:\tmany\nnonvoluntary_ctxt_switches:\t3\n",
+      &task));
+  EXPECT_FALSE(ParseTaskContextSwitches("", &task));
 }
 
 CRASHPAD_CHILD_TEST_MAIN(ProcTaskTestChild) {
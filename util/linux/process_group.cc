@@ -0,0 +1,85 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/process_group.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/check.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "util/file/directory_reader.h"
+
+namespace crashpad {
+
+bool ReadProcessGroupMembers(pid_t pid,
+                             uid_t uid,
+                             std::vector<pid_t>* members) {
+  DCHECK(members->empty());
+
+  const pid_t pgid = getpgid(pid);
+  if (pgid < 0) {
+    PLOG(ERROR) << "getpgid";
+    return false;
+  }
+
+  DirectoryReader reader;
+  if (!reader.Open(base::FilePath("/proc"))) {
+    return false;
+  }
+
+  const pid_t self = getpid();
+  std::vector<pid_t> local_members;
+  base::FilePath filename;
+  DirectoryReader::FileType type;
+  DirectoryReader::Result result;
+  while ((result = reader.NextFile(&filename, &type)) ==
+         DirectoryReader::Result::kSuccess) {
+    if (type != DirectoryReader::FileType::kDirectory &&
+        type != DirectoryReader::FileType::kUnknown) {
+      continue;
+    }
+    pid_t member;
+    if (!base::StringToInt(filename.value(), &member) || member == pid ||
+        member == self) {
+      continue;
+    }
+
+    // Processes may exit at any time during the walk, so failures here aren't
+    // errors.
+    if (getpgid(member) != pgid) {
+      continue;
+    }
+    struct stat st;
+    if (fstatat(reader.DirectoryFD(), filename.value().c_str(), &st, 0) != 0 ||
+        st.st_uid != uid) {
+      continue;
+    }
+
+    local_members.push_back(member);
+  }
+  if (result != DirectoryReader::Result::kNoMoreFiles) {
+    return false;
+  }
+
+  std::sort(local_members.begin(), local_members.end());
+  members->swap(local_members);
+  return true;
+}
+
+}  // namespace crashpad
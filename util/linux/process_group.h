@@ -0,0 +1,40 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_PROCESS_GROUP_H_
+#define CRASHPAD_UTIL_LINUX_PROCESS_GROUP_H_
+
+#include <sys/types.h>
+
+#include <vector>
+
+namespace crashpad {
+
+//! \brief Enumerates the other processes in a process's process group by
+//!     reading `/proc`.
+//!
+//! Only processes running as \a uid are included. The calling process is never
+//! included, so that a handler sharing its client's process group doesn't try
+//! to capture itself.
+//!
+//! \param[in] pid The process whose process group should be enumerated.
+//! \param[in] uid The user ID that included processes must run as.
+//! \param[out] members The process IDs of the other processes in the process
+//!     group of \a pid, in ascending order.
+//! \return `true` on success. `false` on failure with a message logged.
+bool ReadProcessGroupMembers(pid_t pid, uid_t uid, std::vector<pid_t>* members);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_PROCESS_GROUP_H_
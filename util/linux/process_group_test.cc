@@ -0,0 +1,98 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/process_group.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/multiprocess.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+bool Contains(const std::vector<pid_t>& members, pid_t pid) {
+  return std::find(members.begin(), members.end(), pid) != members.end();
+}
+
+class ProcessGroupTest : public Multiprocess {
+ public:
+  explicit ProcessGroupTest(bool own_group)
+      : Multiprocess(), own_group_(own_group) {}
+
+  ProcessGroupTest(const ProcessGroupTest&) = delete;
+  ProcessGroupTest& operator=(const ProcessGroupTest&) = delete;
+
+  ~ProcessGroupTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    char c;
+    CheckedReadFileExactly(ReadPipeHandle(), &c, sizeof(c));
+
+    std::vector<pid_t> members;
+    ASSERT_TRUE(ReadProcessGroupMembers(getpid(), getuid(), &members));
+    EXPECT_FALSE(Contains(members, getpid()));
+    EXPECT_EQ(Contains(members, ChildPID()), !own_group_);
+    EXPECT_TRUE(std::is_sorted(members.begin(), members.end()));
+
+    // The calling process is never a member, even of a group it's in.
+    members.clear();
+    ASSERT_TRUE(ReadProcessGroupMembers(ChildPID(), getuid(), &members));
+    EXPECT_FALSE(Contains(members, getpid()));
+    EXPECT_FALSE(Contains(members, ChildPID()));
+
+    // Only processes running as the given user are members.
+    members.clear();
+    ASSERT_TRUE(ReadProcessGroupMembers(getpid(), getuid() + 1, &members));
+    EXPECT_FALSE(Contains(members, ChildPID()));
+  }
+
+  void MultiprocessChild() override {
+    if (own_group_) {
+      ASSERT_EQ(setpgid(0, 0), 0) << ErrnoMessage("setpgid");
+    }
+
+    char c = '\0';
+    CheckedWriteFile(WritePipeHandle(), &c, sizeof(c));
+
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+
+  bool own_group_;
+};
+
+TEST(ProcessGroup, SameGroup) {
+  ProcessGroupTest test(false);
+  test.Run();
+}
+
+TEST(ProcessGroup, OwnGroup) {
+  ProcessGroupTest test(true);
+  test.Run();
+}
+
+TEST(ProcessGroup, BadPID) {
+  std::vector<pid_t> members;
+  EXPECT_FALSE(ReadProcessGroupMembers(-1, getuid(), &members));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
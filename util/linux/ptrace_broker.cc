@@ -16,6 +16,7 @@
 
 #include <fcntl.h>
 #include <limits.h>
+#include <stddef.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <syscall.h>
@@ -55,6 +56,31 @@ size_t FormatPID(char* buffer, pid_t pid) {
   return length;
 }
 
+struct Dirent64 {
+  ino64_t d_ino;
+  off64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+// Returns the thread ID named by a task directory entry, or 0 if the entry
+// doesn't name a thread.
+pid_t ParseTaskName(const char* name, size_t length) {
+  if (length == 0 || length > 9) {
+    return 0;
+  }
+
+  pid_t tid = 0;
+  for (size_t index = 0; index < length; ++index) {
+    if (name[index] < '0' || name[index] > '9') {
+      return 0;
+    }
+    tid = tid * 10 + (name[index] - '0');
+  }
+  return tid;
+}
+
 }  // namespace
 
 class PtraceBroker::AttachmentsArray {
@@ -89,6 +115,23 @@ class PtraceBroker::AttachmentsArray {
     return true;
   }
 
+  // Attaches to the threads in tids with PtraceSeizeThreads(). Threads beyond
+  // the remaining capacity of this array are not attached.
+  void AttachThreads(const pid_t* tids, size_t count, bool* attached) {
+    const size_t capacity = allocation_.len() / sizeof(pid_t) - attach_count_;
+    const size_t attach_count = std::min(count, capacity);
+    for (size_t index = attach_count; index < count; ++index) {
+      attached[index] = false;
+    }
+
+    PtraceSeizeThreads(tids, attach_count, attached, false);
+    for (size_t index = 0; index < attach_count; ++index) {
+      if (attached[index]) {
+        *AllocateAttachment() = tids[index];
+      }
+    }
+  }
+
  private:
   pid_t* AllocateAttachment() {
     if (attach_count_ >= (allocation_.len() / sizeof(pid_t))) {
@@ -229,6 +272,14 @@ int PtraceBroker::RunImpl(AttachmentsArray* attachments) {
         continue;
       }
 
+      case Request::kTypeReadMemoryVector: {
+        int result = SendMemoryVector(request.tid, request.iovs.count);
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
       case Request::kTypeListDirectory: {
         ScopedFileHandle handle;
         int result = ReceiveAndOpenFilePath(request.path.path_length,
@@ -249,6 +300,31 @@ int PtraceBroker::RunImpl(AttachmentsArray* attachments) {
         continue;
       }
 
+      case Request::kTypeReadThreadDetails: {
+        int result = SendThreadDetails(request.tid);
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
+      case Request::kTypeAttachThreads: {
+        int result =
+            ReceiveAndAttachThreads(attachments, request.tids.count);
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
+      case Request::kTypeReadFiles: {
+        int result = SendFilesContents(request.files.length);
+        if (result != 0) {
+          return result;
+        }
+        continue;
+      }
+
       case Request::kTypeExit:
         return 0;
     }
@@ -361,6 +437,25 @@ int PtraceBroker::SendMemory(pid_t pid, VMAddress address, VMSize size) {
   return 0;
 }
 
+int PtraceBroker::SendMemoryVector(pid_t pid, VMSize count) {
+  if (count > kMaxReadMemoryRanges) {
+    return EINVAL;
+  }
+
+  ReadMemoryRange ranges[kMaxReadMemoryRanges];
+  if (!ReadFileExactly(sock_, ranges, sizeof(ranges[0]) * count)) {
+    return errno;
+  }
+
+  for (size_t index = 0; index < count; ++index) {
+    int result = SendMemory(pid, ranges[index].base, ranges[index].size);
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
 #if defined(MEMORY_SANITIZER)
 // MSan doesn't intercept syscall() and doesn't see that buffer is initialized.
 __attribute__((no_sanitize("memory")))
@@ -389,6 +484,169 @@ int PtraceBroker::SendDirectory(FileHandle handle) {
   return 0;
 }
 
+#if defined(MEMORY_SANITIZER)
+// MSan doesn't intercept syscall() and doesn't see that buffer is initialized.
+__attribute__((no_sanitize("memory")))
+#endif  // defined(MEMORY_SANITIZER)
+int PtraceBroker::ReceiveAndAttachThreads(AttachmentsArray* attachments,
+                                          VMSize count) {
+  if (count > kMaxAttachThreads) {
+    return EINVAL;
+  }
+
+  pid_t tids[kMaxAttachThreads];
+  if (!ReadFileExactly(sock_, tids, sizeof(tids[0]) * count)) {
+    return errno;
+  }
+
+  bool attached[kMaxAttachThreads];
+  attachments->AttachThreads(tids, count, attached);
+
+  ExceptionHandlerProtocol::Bool results[kMaxAttachThreads];
+  for (size_t index = 0; index < count; ++index) {
+    results[index] = attached[index] ? ExceptionHandlerProtocol::kBoolTrue
+                                     : ExceptionHandlerProtocol::kBoolFalse;
+  }
+  return WriteFile(sock_, results, sizeof(results[0]) * count) ? 0 : errno;
+}
+
+int PtraceBroker::SendThreadDetails(pid_t pid) {
+  if (pid <= 0) {
+    return SendOpenResult(kOpenResultAccessDenied);
+  }
+
+  static constexpr char kProc[] = "/proc/";
+  static constexpr char kTask[] = "/task";
+  char path[32];
+  size_t length = strlen(kProc);
+  memcpy(path, kProc, length);
+  length += FormatPID(path + length, pid);
+  DCHECK_LT(length + strlen(kTask), sizeof(path));
+  // Include the trailing NUL.
+  memcpy(path + length, kTask, strlen(kTask) + 1);
+
+  if (strncmp(path, file_root_, strlen(file_root_)) != 0) {
+    return SendOpenResult(kOpenResultAccessDenied);
+  }
+
+  ScopedFileHandle task_directory(HANDLE_EINTR(
+      open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_DIRECTORY)));
+  if (!task_directory.is_valid()) {
+    return SendOpenResult(static_cast<OpenResult>(errno));
+  }
+
+  int result = SendOpenResult(kOpenResultSuccess);
+  if (result != 0) {
+    return result;
+  }
+
+  char buffer[4096];
+  int rv;
+  while ((rv = syscall(
+              SYS_getdents64, task_directory.get(), buffer, sizeof(buffer))) >
+         0) {
+    size_t offset = 0;
+    while (offset + offsetof(Dirent64, d_name) < static_cast<size_t>(rv)) {
+      auto dirent = reinterpret_cast<Dirent64*>(buffer + offset);
+      if (dirent->d_reclen == 0 ||
+          offset + dirent->d_reclen > static_cast<size_t>(rv)) {
+        return SendReadError(static_cast<ReadError>(EINVAL));
+      }
+      offset += dirent->d_reclen;
+
+      const size_t name_length = strnlen(
+          dirent->d_name, dirent->d_reclen - offsetof(Dirent64, d_name));
+      int32_t tid = ParseTaskName(dirent->d_name, name_length);
+      if (tid <= 0) {
+        continue;
+      }
+
+      if (!WriteFile(sock_, &tid, sizeof(tid))) {
+        return errno;
+      }
+
+      if ((result = SendTaskFile(task_directory.get(),
+                                 dirent->d_name,
+                                 name_length,
+                                 "/comm")) != 0 ||
+          (result = SendTaskFile(task_directory.get(),
+                                 dirent->d_name,
+                                 name_length,
+                                 "/stat")) != 0 ||
+          (result = SendTaskFile(task_directory.get(),
+                                 dirent->d_name,
+                                 name_length,
+                                 "/status")) != 0) {
+        return result;
+      }
+    }
+  }
+
+  if (rv < 0) {
+    return SendReadError(static_cast<ReadError>(errno));
+  }
+
+  int32_t end = 0;
+  return WriteFile(sock_, &end, sizeof(end)) ? 0 : errno;
+}
+
+int PtraceBroker::SendTaskFile(FileHandle task_directory,
+                               const char* tid,
+                               size_t tid_length,
+                               const char* name) {
+  char path[32];
+  DCHECK_LT(tid_length + strlen(name), sizeof(path));
+  memcpy(path, tid, tid_length);
+  // Include the trailing NUL.
+  memcpy(path + tid_length, name, strlen(name) + 1);
+
+  ScopedFileHandle handle(HANDLE_EINTR(
+      openat(task_directory, path, O_RDONLY | O_CLOEXEC | O_NOCTTY)));
+  if (!handle.is_valid()) {
+    // The thread may have exited since the directory was read.
+    int32_t end = 0;
+    return WriteFile(sock_, &end, sizeof(end)) ? 0 : errno;
+  }
+
+  return SendFileContents(handle.get());
+}
+
+int PtraceBroker::SendFilesContents(VMSize length) {
+  if (length > kMaxReadFilesLength) {
+    return EINVAL;
+  }
+
+  char paths[kMaxReadFilesLength];
+  if (!ReadFileExactly(sock_, paths, length)) {
+    return errno;
+  }
+  if (length > 0 && paths[length - 1] != '\0') {
+    return EINVAL;
+  }
+
+  size_t offset = 0;
+  while (offset < length) {
+    const char* path = paths + offset;
+    offset += strlen(path) + 1;
+
+    ScopedFileHandle handle;
+    int result = OpenFilePath(path, /* is_directory= */ false, &handle);
+    if (result != 0) {
+      return result;
+    }
+
+    if (!handle.is_valid()) {
+      continue;
+    }
+
+    result = SendFileContents(handle.get());
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
 int PtraceBroker::ReceiveAndOpenFilePath(VMSize path_length,
                                          bool is_directory,
                                          ScopedFileHandle* handle) {
@@ -403,6 +661,12 @@ int PtraceBroker::ReceiveAndOpenFilePath(VMSize path_length,
   }
   path[path_length] = '\0';
 
+  return OpenFilePath(path, is_directory, handle);
+}
+
+int PtraceBroker::OpenFilePath(const char* path,
+                               bool is_directory,
+                               ScopedFileHandle* handle) {
   if (strncmp(path, file_root_, strlen(file_root_)) != 0) {
     return SendOpenResult(kOpenResultAccessDenied);
   }
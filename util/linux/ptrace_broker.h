@@ -85,11 +85,50 @@ class PtraceBroker {
 
       //! \brief Causes the broker to return from Run(), detaching all attached
       //!     threads. Does not respond.
-      kTypeExit
+      kTypeExit,
+
+      //! \brief Reads several memory regions from the attached process. The
+      //!     request is followed by #iovs.count ReadMemoryRange structures.
+      //!     Once all of them have been received, the data for each region is
+      //!     returned in order, in the same series of messages used to respond
+      //!     to kTypeReadMemory. The data for a region ends when its full size
+      //!     has been sent, or with a message indicating end-of-file or an
+      //!     error. Regions of size 0 receive no messages.
+      kTypeReadMemoryVector,
+
+      //! \brief Reads the thread IDs, names, and `stat` files of every thread
+      //!     of the process with the process ID in #tid, in a single pass over
+      //!     its task directory. The first message is an OpenResult,
+      //!     indicating whether the task directory could be opened. If the
+      //!     OpenResult is kOpenResultSuccess, each subsequent message begins
+      //!     with an int32_t thread ID, 0 after the last thread, or -1 for
+      //!     errors, followed by a ReadError. Each thread ID is followed by the
+      //!     contents of the thread's `comm`, `stat`, and then `status` files,
+      //!     each sent as the messages following a kOpenResultSuccess in
+      //!     response to kTypeReadFile. Files which can't be opened are sent as
+      //!     empty.
+      kTypeReadThreadDetails,
+
+      //! \brief `ptrace`-attaches several threads at once with
+      //!     PtraceSeizeThreads(). The request is followed by #tids.count
+      //!     thread IDs, as `pid_t`. Once all of them have been received, the
+      //!     broker responds with #tids.count ExceptionHandlerProtocol::Bool
+      //!     values, in order, each kBoolTrue if the corresponding thread was
+      //!     attached, otherwise kBoolFalse.
+      kTypeAttachThreads,
+
+      //! \brief Reads the contents of several files. The request is followed
+      //!     by #files.length bytes holding the file paths, each terminated
+      //!     by a `NUL`. The length must not exceed kMaxReadFilesLength. Once
+      //!     all of the paths have been received, each file is returned in
+      //!     order in the same series of messages used to respond to
+      //!     kTypeReadFile.
+      kTypeReadFiles,
     } type;
 
     //! \brief The thread ID associated with this request. Valid for kTypeAttach,
-    //!     kTypeGetThreadInfo, and kTypeReadMemory.
+    //!     kTypeGetThreadInfo, kTypeReadMemory, kTypeReadMemoryVector, and
+    //!     kTypeReadThreadDetails.
     pid_t tid;
 
     union {
@@ -103,6 +142,30 @@ class PtraceBroker {
         VMSize size;
       } iov;
 
+      //! \brief Specifies the memory regions to read for a
+      //!     kTypeReadMemoryVector request.
+      struct {
+        //! \brief The number of ReadMemoryRange structures following the
+        //!     request. This must not exceed kMaxReadMemoryRanges.
+        VMSize count;
+      } iovs;
+
+      //! \brief Specifies the threads to attach for a kTypeAttachThreads
+      //!     request.
+      struct {
+        //! \brief The number of thread IDs following the request. This must
+        //!     not exceed kMaxAttachThreads.
+        VMSize count;
+      } tids;
+
+      //! \brief Specifies the file paths to read for a kTypeReadFiles
+      //!     request.
+      struct {
+        //! \brief The number of bytes of paths following the request,
+        //!     including their `NUL`-terminators.
+        VMSize length;
+      } files;
+
       //! \brief Specifies the file path to read for a kTypeReadFile request.
       struct {
         //! \brief The number of bytes in #path. The path should not include a
@@ -115,6 +178,31 @@ class PtraceBroker {
     };
   };
 
+  //! \brief A memory region sent following a Request with type
+  //!     kTypeReadMemoryVector.
+  struct ReadMemoryRange {
+    //! \brief The base address of the memory region.
+    VMAddress base;
+
+    //! \brief The size of the memory region.
+    VMSize size;
+  };
+
+  //! \brief The maximum number of memory regions that may be requested by a
+  //!     single kTypeReadMemoryVector request.
+  //!
+  //! The broker receives every region before sending any data, so that a
+  //! client may write the entire request before reading any of the responses.
+  static constexpr size_t kMaxReadMemoryRanges = 128;
+
+  //! \brief The maximum number of threads that may be attached by a single
+  //!     kTypeAttachThreads request.
+  static constexpr size_t kMaxAttachThreads = 128;
+
+  //! \brief The maximum number of bytes of paths that may follow a single
+  //!     kTypeReadFiles request.
+  static constexpr size_t kMaxReadFilesLength = 4096;
+
   //! \brief A result used in operations that accept paths.
   //!
   //! Positive values of this enum are reserved for sending errno values.
@@ -201,9 +289,20 @@ class PtraceBroker {
   int SendDirectory(FileHandle handle);
   void TryOpeningMemFile();
   int SendMemory(pid_t pid, VMAddress address, VMSize size);
+  int SendMemoryVector(pid_t pid, VMSize count);
+  int SendThreadDetails(pid_t pid);
+  int ReceiveAndAttachThreads(AttachmentsArray* attachments, VMSize count);
+  int SendTaskFile(FileHandle task_directory,
+                   const char* tid,
+                   size_t tid_length,
+                   const char* name);
+  int SendFilesContents(VMSize length);
   int ReceiveAndOpenFilePath(VMSize path_length,
                              bool is_directory,
                              ScopedFileHandle* handle);
+  int OpenFilePath(const char* path,
+                   bool is_directory,
+                   ScopedFileHandle* handle);
 
   char file_root_buffer_[32];
   Ptracer ptracer_;
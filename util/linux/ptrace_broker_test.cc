@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include <utility>
+#include <vector>
 
 #include "build/build_config.h"
 #include "gtest/gtest.h"
@@ -173,6 +174,16 @@ class SameBitnessTest : public Multiprocess {
       EXPECT_EQ(threads[1], ChildPID());
     }
 
+    std::vector<ProcTaskInfo> tasks;
+    ASSERT_TRUE(client.ReadThreadDetails(&tasks));
+    ASSERT_EQ(tasks.size(), 2u);
+    for (const ProcTaskInfo& task : tasks) {
+      EXPECT_TRUE(task.tid == ChildPID() || task.tid == child2_tid);
+      EXPECT_FALSE(task.name.empty());
+      EXPECT_FALSE(task.stat.empty());
+      EXPECT_TRUE(task.have_context_switches);
+    }
+
     EXPECT_TRUE(client.Attach(child2_tid));
     EXPECT_EQ(client.Is64Bit(), am_64_bit);
 
@@ -205,6 +216,24 @@ class SameBitnessTest : public Multiprocess {
                               &unmapped),
               -1);
 
+    std::vector<ProcessMemory::ReadRange> ranges;
+    char batch_buffer[3];
+    ranges.push_back({mapping_.addr_as<VMAddress>(),
+                      sizeof(batch_buffer[0]),
+                      &batch_buffer[0]});
+    ranges.push_back({mapping_.addr_as<VMAddress>() + mapping_.len(),
+                      sizeof(batch_buffer[1]),
+                      &batch_buffer[1]});
+    ranges.push_back({mapping_.addr_as<VMAddress>(), 0, nullptr});
+    ranges.push_back({mapping_.addr_as<VMAddress>() + mapping_.len() - 1,
+                      sizeof(batch_buffer[2]),
+                      &batch_buffer[2]});
+    std::vector<bool> results;
+    EXPECT_FALSE(client.Memory()->ReadBatch(ranges, &results));
+    EXPECT_EQ(results, std::vector<bool>({true, false, true, true}));
+    EXPECT_EQ(batch_buffer[0], expected_buffer[0]);
+    EXPECT_EQ(batch_buffer[2], expected_buffer[mapping_.len() - 1]);
+
     std::string file_root = file_dir.value() + '/';
     broker.SetFileRoot(file_root.c_str());
 
@@ -216,6 +245,30 @@ class SameBitnessTest : public Multiprocess {
     base::FilePath test_file2(temp_dir2.path().Append("test_file2"));
     ASSERT_TRUE(CreateFile(test_file2));
     EXPECT_FALSE(client.ReadFileContents(test_file2, &file_contents));
+
+    // Files read together are held until they're discarded. Files that can't
+    // be read don't prevent the others from being read.
+    base::FilePath test_file3(file_dir.Append("test_file3"));
+    ASSERT_NO_FATAL_FAILURE(WriteTestFile(test_file3, "before"));
+    client.PrefetchFileContents({test_file2, test_file3});
+    ASSERT_NO_FATAL_FAILURE(WriteTestFile(test_file3, "after"));
+    ASSERT_TRUE(client.ReadFileContents(test_file3, &file_contents));
+    EXPECT_EQ(file_contents, "before");
+    client.DiscardFileContents(test_file3);
+    ASSERT_TRUE(client.ReadFileContents(test_file3, &file_contents));
+    EXPECT_EQ(file_contents, "after");
+    EXPECT_FALSE(client.ReadFileContents(test_file2, &file_contents));
+  }
+
+  static void WriteTestFile(const base::FilePath& path,
+                            const std::string& contents) {
+    ScopedFileHandle handle(
+        LoggingOpenFileForWrite(path,
+                                FileWriteMode::kTruncateOrCreate,
+                                FilePermissions::kWorldReadable));
+    ASSERT_TRUE(handle.is_valid());
+    ASSERT_TRUE(
+        LoggingWriteFile(handle.get(), contents.data(), contents.size()));
   }
 
   void MultiprocessParent() override {
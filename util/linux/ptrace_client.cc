@@ -18,14 +18,17 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <iterator>
 #include <string>
+#include <utility>
 
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
 #include "util/file/file_io.h"
 #include "util/linux/ptrace_broker.h"
+#include "util/numeric/safe_assignment.h"
 #include "util/process/process_memory_linux.h"
 
 namespace crashpad {
@@ -126,14 +129,132 @@ void ReadDentsAsThreadIDs(char* buffer,
   DCHECK_EQ(size, 0u);
 }
 
+// Receives the data sent by the broker in response to a request to read \a size
+// bytes of memory. Returns the number of bytes received or -1 on failure with a
+// message logged. \a stream_valid is set to `false` if the socket can no longer
+// be used, and `true` otherwise.
+ssize_t ReceiveMemory(int sock, char* buffer, size_t size, bool* stream_valid) {
+  *stream_valid = false;
+  ssize_t total_read = 0;
+  while (size > 0) {
+    int32_t bytes_read;
+    if (!LoggingReadFileExactly(sock, &bytes_read, sizeof(bytes_read))) {
+      return -1;
+    }
+
+    if (bytes_read < 0) {
+      *stream_valid = ReceiveAndLogReadError(sock, "PtraceBroker ReadMemory");
+      return -1;
+    }
+
+    if (bytes_read == 0) {
+      *stream_valid = true;
+      return total_read;
+    }
+
+    if (static_cast<size_t>(bytes_read) > size) {
+      LOG(ERROR) << "invalid size " << bytes_read;
+      return -1;
+    }
+
+    if (!LoggingReadFileExactly(sock, buffer, bytes_read)) {
+      return -1;
+    }
+
+    size -= bytes_read;
+    buffer += bytes_read;
+    total_read += bytes_read;
+  }
+
+  *stream_valid = true;
+  return total_read;
+}
+
+// Receives the contents of a file sent by the broker following a successful
+// OpenResult. Returns `true` with contents set on success, or `false` with a
+// message logged. \a stream_valid is set to `false` if the socket can no longer
+// be used, and `true` otherwise.
+bool ReceiveFileContents(int sock,
+                         const char* operation,
+                         std::string* contents,
+                         bool* stream_valid) {
+  *stream_valid = false;
+  std::string local_contents;
+  int32_t read_result;
+  do {
+    if (!LoggingReadFileExactly(sock, &read_result, sizeof(read_result))) {
+      return false;
+    }
+
+    if (read_result < 0) {
+      *stream_valid = ReceiveAndLogReadError(sock, operation);
+      return false;
+    }
+
+    if (read_result > 0) {
+      size_t old_length = local_contents.size();
+      local_contents.resize(old_length + read_result);
+      if (!LoggingReadFileExactly(
+              sock, &local_contents[old_length], read_result)) {
+        return false;
+      }
+    }
+  } while (read_result > 0);
+
+  *stream_valid = true;
+  contents->swap(local_contents);
+  return true;
+}
+
+// Receives an OpenResult sent by the broker. Returns `true` if the file was
+// opened, or `false` with a message logged. \a stream_valid is set to `false`
+// if the socket can no longer be used, and `true` otherwise.
+bool ReceiveOpenResultImpl(int sock, bool* stream_valid) {
+  *stream_valid = false;
+  PtraceBroker::OpenResult result;
+  if (!LoggingReadFileExactly(sock, &result, sizeof(result))) {
+    return false;
+  }
+
+  switch (result) {
+    case PtraceBroker::kOpenResultAccessDenied:
+      *stream_valid = true;
+      LOG(ERROR) << "Broker Open: access denied";
+      return false;
+
+    case PtraceBroker::kOpenResultTooLong:
+      *stream_valid = true;
+      LOG(ERROR) << "Broker Open: path too long";
+      return false;
+
+    case PtraceBroker::kOpenResultSuccess:
+      *stream_valid = true;
+      return true;
+
+    default:
+      if (result < 0) {
+        LOG(ERROR) << "Broker Open: invalid result " << result;
+        DCHECK(false);
+      } else {
+        *stream_valid = true;
+        errno = result;
+        PLOG(ERROR) << "Broker Open";
+      }
+      return false;
+  }
+}
+
 }  // namespace
 
 PtraceClient::PtraceClient()
     : PtraceConnection(),
+      file_contents_(),
+      threads_(),
       memory_(),
       sock_(kInvalidFileHandle),
       pid_(-1),
       is_64_bit_(false),
+      threads_valid_(false),
       initialized_() {}
 
 PtraceClient::~PtraceClient() {
@@ -181,6 +302,40 @@ bool PtraceClient::Attach(pid_t tid) {
   return AttachImpl(sock_, tid);
 }
 
+void PtraceClient::AttachThreads(const std::vector<pid_t>& tids,
+                                 std::vector<bool>* results) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_EQ(results->size(), tids.size());
+
+  // The broker stops every thread in a request before waiting for any of
+  // them, and answers for all of them at once.
+  size_t next_index = 0;
+  while (next_index < tids.size()) {
+    const size_t count =
+        std::min(tids.size() - next_index, PtraceBroker::kMaxAttachThreads);
+
+    PtraceBroker::Request request = {};
+    request.type = PtraceBroker::Request::kTypeAttachThreads;
+    request.tids.count = count;
+    if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
+        !LoggingWriteFile(
+            sock_, &tids[next_index], sizeof(tids[0]) * count)) {
+      return;
+    }
+
+    ExceptionHandlerProtocol::Bool attached[PtraceBroker::kMaxAttachThreads];
+    if (!LoggingReadFileExactly(
+            sock_, attached, sizeof(attached[0]) * count)) {
+      return;
+    }
+    for (size_t index = 0; index < count; ++index) {
+      (*results)[next_index + index] =
+          attached[index] == ExceptionHandlerProtocol::kBoolTrue;
+    }
+    next_index += count;
+  }
+}
+
 bool PtraceClient::Is64Bit() {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   return is_64_bit_;
@@ -214,6 +369,12 @@ bool PtraceClient::ReadFileContents(const base::FilePath& path,
                                     std::string* contents) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
+  const auto it = file_contents_.find(path.value());
+  if (it != file_contents_.end()) {
+    *contents = it->second;
+    return true;
+  }
+
   PtraceBroker::Request request = {};
   request.type = PtraceBroker::Request::kTypeReadFile;
   request.path.path_length = path.value().size();
@@ -223,30 +384,53 @@ bool PtraceClient::ReadFileContents(const base::FilePath& path,
     return false;
   }
 
-  std::string local_contents;
-  int32_t read_result;
-  do {
-    if (!LoggingReadFileExactly(sock_, &read_result, sizeof(read_result))) {
-      return false;
-    }
+  bool stream_valid;
+  if (!ReceiveFileContents(
+          sock_, "ReadFileContents", contents, &stream_valid)) {
+    return false;
+  }
 
-    if (read_result < 0) {
-      ReceiveAndLogReadError(sock_, "ReadFileContents");
-      return false;
+  file_contents_[path.value()] = *contents;
+  return true;
+}
+
+void PtraceClient::PrefetchFileContents(
+    const std::vector<base::FilePath>& paths) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // As many paths are sent with each request as will fit.
+  std::vector<const std::string*> batch_paths;
+  std::string request_paths;
+  for (const base::FilePath& path : paths) {
+    const std::string& value = path.value();
+    if (file_contents_.find(value) != file_contents_.end()) {
+      continue;
+    }
+    if (value.empty() || value.size() >= PtraceBroker::kMaxReadFilesLength ||
+        value.find('\0') != std::string::npos) {
+      continue;
     }
 
-    if (read_result > 0) {
-      size_t old_length = local_contents.size();
-      local_contents.resize(old_length + read_result);
-      if (!LoggingReadFileExactly(
-              sock_, &local_contents[old_length], read_result)) {
-        return false;
+    if (request_paths.size() + value.size() + 1 >
+        PtraceBroker::kMaxReadFilesLength) {
+      if (!ReadFilesContents(batch_paths, request_paths)) {
+        return;
       }
+      batch_paths.clear();
+      request_paths.clear();
     }
-  } while (read_result > 0);
+    batch_paths.push_back(&value);
+    request_paths.append(value.c_str(), value.size() + 1);
+  }
 
-  contents->swap(local_contents);
-  return true;
+  if (!batch_paths.empty()) {
+    ReadFilesContents(batch_paths, request_paths);
+  }
+}
+
+void PtraceClient::DiscardFileContents(const base::FilePath& path) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  file_contents_.erase(path.value());
 }
 
 ProcessMemoryLinux* PtraceClient::Memory() {
@@ -261,6 +445,11 @@ bool PtraceClient::Threads(std::vector<pid_t>* threads) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
   DCHECK(threads->empty());
 
+  if (threads_valid_) {
+    *threads = threads_;
+    return true;
+  }
+
   // If the broker is unable to read thread IDs, fall-back to just the main
   // thread's ID.
   threads->push_back(pid_);
@@ -298,89 +487,204 @@ bool PtraceClient::Threads(std::vector<pid_t>* threads) {
     }
   } while (read_result > 0);
 
+  threads_ = local_threads;
+  threads_valid_ = true;
   threads->swap(local_threads);
   return true;
 }
 
-ssize_t PtraceClient::ReadUpTo(VMAddress address, size_t size, void* buffer) {
+bool PtraceClient::ReadThreadDetails(std::vector<ProcTaskInfo>* tasks) {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
-  char* buffer_c = reinterpret_cast<char*>(buffer);
+  DCHECK(tasks->empty());
 
+  // The broker walks the task directory and sends every thread's files in
+  // response to this one request.
   PtraceBroker::Request request = {};
-  request.type = PtraceBroker::Request::kTypeReadMemory;
+  request.type = PtraceBroker::Request::kTypeReadThreadDetails;
   request.tid = pid_;
-  request.iov.base = address;
-  request.iov.size = size;
 
-  if (!LoggingWriteFile(sock_, &request, sizeof(request))) {
+  if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
+      !ReceiveOpenResult()) {
     return false;
   }
 
-  ssize_t total_read = 0;
-  while (size > 0) {
-    int32_t bytes_read;
-    if (!LoggingReadFileExactly(sock_, &bytes_read, sizeof(bytes_read))) {
-      return -1;
+  std::vector<ProcTaskInfo> local_tasks;
+  std::string status;
+  while (true) {
+    int32_t tid;
+    if (!LoggingReadFileExactly(sock_, &tid, sizeof(tid))) {
+      return false;
     }
 
-    if (bytes_read < 0) {
-      ReceiveAndLogReadError(sock_, "PtraceBroker ReadMemory");
-      return -1;
+    if (tid == 0) {
+      break;
     }
 
-    if (bytes_read == 0) {
-      return total_read;
+    if (tid < 0) {
+      ReceiveAndLogReadError(sock_, "ReadThreadDetails");
+      tasks->swap(local_tasks);
+      return false;
     }
 
-    if (static_cast<size_t>(bytes_read) > size) {
-      LOG(ERROR) << "invalid size " << bytes_read;
-      return -1;
+    ProcTaskInfo task;
+    task.tid = tid;
+    bool stream_valid;
+    if (ReceiveFileContents(
+            sock_, "ReadThreadDetails comm", &task.name, &stream_valid)) {
+      if (!task.name.empty() && task.name.back() == '\n') {
+        task.name.pop_back();
+      }
+    } else if (!stream_valid) {
+      return false;
     }
 
-    if (!LoggingReadFileExactly(sock_, buffer_c, bytes_read)) {
-      return -1;
+    if (!ReceiveFileContents(
+            sock_, "ReadThreadDetails stat", &task.stat, &stream_valid) &&
+        !stream_valid) {
+      return false;
     }
 
-    size -= bytes_read;
-    buffer_c += bytes_read;
-    total_read += bytes_read;
+    if (ReceiveFileContents(
+            sock_, "ReadThreadDetails status", &status, &stream_valid)) {
+      ParseTaskContextSwitches(status, &task);
+    } else if (!stream_valid) {
+      return false;
+    }
+
+    local_tasks.push_back(std::move(task));
   }
 
-  return total_read;
+  tasks->swap(local_tasks);
+  return true;
 }
 
-bool PtraceClient::SendFilePath(const char* path, size_t length) {
-  if (!LoggingWriteFile(sock_, path, length)) {
+ssize_t PtraceClient::ReadUpTo(VMAddress address, size_t size, void* buffer) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  PtraceBroker::Request request = {};
+  request.type = PtraceBroker::Request::kTypeReadMemory;
+  request.tid = pid_;
+  request.iov.base = address;
+  request.iov.size = size;
+
+  if (!LoggingWriteFile(sock_, &request, sizeof(request))) {
     return false;
   }
 
-  PtraceBroker::OpenResult result;
-  if (!LoggingReadFileExactly(sock_, &result, sizeof(result))) {
-    return false;
+  bool stream_valid;
+  return ReceiveMemory(
+      sock_, reinterpret_cast<char*>(buffer), size, &stream_valid);
+}
+
+void PtraceClient::ReadMemoryBatch(
+    const std::vector<ProcessMemory::ReadRange>& ranges,
+    std::vector<bool>* results) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_EQ(results->size(), ranges.size());
+
+  // The request and all of its regions are sent before any data is received,
+  // and the broker streams the data for every region back without waiting,
+  // avoiding a round trip per region.
+  PtraceBroker::ReadMemoryRange
+      batch_ranges[PtraceBroker::kMaxReadMemoryRanges];
+  size_t batch_indices[PtraceBroker::kMaxReadMemoryRanges];
+
+  size_t next_index = 0;
+  while (next_index < ranges.size()) {
+    size_t count = 0;
+    for (; next_index < ranges.size() &&
+           count < PtraceBroker::kMaxReadMemoryRanges;
+         ++next_index) {
+      const ProcessMemory::ReadRange& range = ranges[next_index];
+      if (range.size == 0) {
+        (*results)[next_index] = true;
+        continue;
+      }
+      size_t size;
+      if (!AssignIfInRange(&size, range.size)) {
+        LOG(ERROR) << "size " << range.size << " out of bounds for size_t";
+        continue;
+      }
+      batch_ranges[count].base = range.address;
+      batch_ranges[count].size = range.size;
+      batch_indices[count] = next_index;
+      ++count;
+    }
+
+    if (count == 0) {
+      return;
+    }
+
+    PtraceBroker::Request request = {};
+    request.type = PtraceBroker::Request::kTypeReadMemoryVector;
+    request.tid = pid_;
+    request.iovs.count = count;
+    if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
+        !LoggingWriteFile(
+            sock_, batch_ranges, sizeof(batch_ranges[0]) * count)) {
+      return;
+    }
+
+    for (size_t index = 0; index < count; ++index) {
+      const ProcessMemory::ReadRange& range = ranges[batch_indices[index]];
+      size_t size = static_cast<size_t>(range.size);
+      bool stream_valid;
+      ssize_t bytes_read = ReceiveMemory(
+          sock_, static_cast<char*>(range.buffer), size, &stream_valid);
+      if (!stream_valid) {
+        return;
+      }
+      if (bytes_read >= 0 && static_cast<size_t>(bytes_read) < size) {
+        LOG(ERROR) << "short read";
+      }
+      (*results)[batch_indices[index]] =
+          bytes_read >= 0 && static_cast<size_t>(bytes_read) == size;
+    }
   }
+}
 
-  switch (result) {
-    case PtraceBroker::kOpenResultAccessDenied:
-      LOG(ERROR) << "Broker Open: access denied";
-      return false;
+bool PtraceClient::ReadFilesContents(
+    const std::vector<const std::string*>& paths,
+    const std::string& request_paths) {
+  DCHECK_LE(request_paths.size(), PtraceBroker::kMaxReadFilesLength);
 
-    case PtraceBroker::kOpenResultTooLong:
-      LOG(ERROR) << "Broker Open: path too long";
-      return false;
+  PtraceBroker::Request request = {};
+  request.type = PtraceBroker::Request::kTypeReadFiles;
+  request.files.length = request_paths.size();
+  if (!LoggingWriteFile(sock_, &request, sizeof(request)) ||
+      !LoggingWriteFile(sock_, request_paths.data(), request_paths.size())) {
+    return false;
+  }
 
-    case PtraceBroker::kOpenResultSuccess:
-      return true;
+  for (const std::string* path : paths) {
+    bool stream_valid;
+    if (!ReceiveOpenResultImpl(sock_, &stream_valid)) {
+      if (!stream_valid) {
+        return false;
+      }
+      continue;
+    }
 
-    default:
-      if (result < 0) {
-        LOG(ERROR) << "Broker Open: invalid result " << result;
-        DCHECK(false);
-      } else {
-        errno = result;
-        PLOG(ERROR) << "Broker Open";
+    std::string contents;
+    if (!ReceiveFileContents(
+            sock_, "PrefetchFileContents", &contents, &stream_valid)) {
+      if (!stream_valid) {
+        return false;
       }
-      return false;
+      continue;
+    }
+    file_contents_[*path].swap(contents);
   }
+  return true;
+}
+
+bool PtraceClient::SendFilePath(const char* path, size_t length) {
+  return LoggingWriteFile(sock_, path, length) && ReceiveOpenResult();
+}
+
+bool PtraceClient::ReceiveOpenResult() {
+  bool stream_valid;
+  return ReceiveOpenResultImpl(sock_, &stream_valid);
 }
 
 }  // namespace crashpad
@@ -17,7 +17,10 @@
 
 #include <sys/types.h>
 
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "util/linux/ptrace_connection.h"
 #include "util/misc/address_types.h"
@@ -31,6 +34,10 @@ namespace crashpad {
 //! This class forms the client half of the connection and is typically used
 //! when the current process does not have `ptrace` capabilities on the target
 //! process. It should be created with a socket connected to a PtraceBroker.
+//!
+//! Each request is a round trip to the broker, so file contents and the list
+//! of threads are held once read, and are reused for the lifetime of this
+//! object, which is expected to be the capture of a single snapshot.
 class PtraceClient : public PtraceConnection {
  public:
   PtraceClient();
@@ -56,21 +63,37 @@ class PtraceClient : public PtraceConnection {
 
   pid_t GetProcessID() override;
   bool Attach(pid_t tid) override;
+  void AttachThreads(const std::vector<pid_t>& tids,
+                     std::vector<bool>* results) override;
   bool Is64Bit() override;
   bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
   bool ReadFileContents(const base::FilePath& path,
                         std::string* contents) override;
+  void PrefetchFileContents(const std::vector<base::FilePath>& paths) override;
+  void DiscardFileContents(const base::FilePath& path) override;
   ProcessMemoryLinux* Memory() override;
   bool Threads(std::vector<pid_t>* threads) override;
+  bool ReadThreadDetails(std::vector<ProcTaskInfo>* tasks) override;
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+  void ReadMemoryBatch(const std::vector<ProcessMemory::ReadRange>& ranges,
+                       std::vector<bool>* results) override;
 
  private:
   bool SendFilePath(const char* path, size_t length);
+  bool ReceiveOpenResult();
+  bool ReadFilesContents(const std::vector<const std::string*>& paths,
+                         const std::string& request_paths);
 
+  // The contents of files read from the broker, keyed by path. The target
+  // process is stopped while it's being captured, so files are read at most
+  // once unless discarded by DiscardFileContents().
+  std::map<std::string, std::string> file_contents_;
+  std::vector<pid_t> threads_;
   std::unique_ptr<ProcessMemoryLinux> memory_;
   int sock_;
   pid_t pid_;
   bool is_64_bit_;
+  bool threads_valid_;
   InitializationStateDcheck initialized_;
 };
 
@@ -0,0 +1,118 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection.h"
+
+#include <stdio.h>
+
+#include <iterator>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "util/numeric/safe_assignment.h"
+
+namespace crashpad {
+
+void PtraceConnection::AttachThreads(const std::vector<pid_t>& tids,
+                                     std::vector<bool>* results) {
+  DCHECK_EQ(results->size(), tids.size());
+
+  for (size_t index = 0; index < tids.size(); ++index) {
+    (*results)[index] = Attach(tids[index]);
+  }
+}
+
+bool PtraceConnection::GetExtendedRegisterState(pid_t tid,
+                                                ExtendedRegisterState* state) {
+  state->Reset(ExtendedRegisterState::Format::kNone, 0);
+  return true;
+}
+
+void PtraceConnection::PrefetchFileContents(
+    const std::vector<base::FilePath>& paths) {}
+
+void PtraceConnection::DiscardFileContents(const base::FilePath& path) {}
+
+bool PtraceConnection::ReadThreadDetails(std::vector<ProcTaskInfo>* tasks) {
+  DCHECK(tasks->empty());
+
+  std::vector<pid_t> threads;
+  bool result = Threads(&threads);
+
+  const pid_t pid = GetProcessID();
+  tasks->resize(threads.size());
+  for (size_t index = 0; index < threads.size(); ++index) {
+    ProcTaskInfo& task = (*tasks)[index];
+    task.tid = threads[index];
+
+    char path[64];
+    snprintf(path, std::size(path), "/proc/%d/task/%d/comm", pid, task.tid);
+    if (ReadFileContents(base::FilePath(path), &task.name)) {
+      if (!task.name.empty() && task.name.back() == '\n') {
+        task.name.pop_back();
+      }
+    } else {
+      task.name.clear();
+    }
+
+    snprintf(path, std::size(path), "/proc/%d/task/%d/stat", pid, task.tid);
+    if (!ReadFileContents(base::FilePath(path), &task.stat)) {
+      task.stat.clear();
+    }
+
+    snprintf(
+        path, std::size(path), "/proc/%d/task/%d/status", pid, task.tid);
+    std::string status;
+    if (ReadFileContents(base::FilePath(path), &status)) {
+      ParseTaskContextSwitches(status, &task);
+    }
+  }
+  return result;
+}
+
+void PtraceConnection::ReadMemoryBatch(
+    const std::vector<ProcessMemory::ReadRange>& ranges,
+    std::vector<bool>* results) {
+  DCHECK_EQ(results->size(), ranges.size());
+
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    const ProcessMemory::ReadRange& range = ranges[index];
+
+    size_t size;
+    if (!AssignIfInRange(&size, range.size)) {
+      LOG(ERROR) << "size " << range.size << " out of bounds for size_t";
+      continue;
+    }
+
+    VMAddress address = range.address;
+    char* buffer = static_cast<char*>(range.buffer);
+    while (size > 0) {
+      ssize_t bytes_read = ReadUpTo(address, size, buffer);
+      if (bytes_read < 0) {
+        break;
+      }
+      if (bytes_read == 0) {
+        LOG(ERROR) << "short read";
+        break;
+      }
+      DCHECK_LE(static_cast<size_t>(bytes_read), size);
+      size -= bytes_read;
+      address += bytes_read;
+      buffer += bytes_read;
+    }
+    (*results)[index] = size == 0;
+  }
+}
+
+}  // namespace crashpad
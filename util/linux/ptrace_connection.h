@@ -21,7 +21,9 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "util/linux/proc_task_reader.h"
 #include "util/linux/thread_info.h"
+#include "util/misc/extended_register_state.h"
 #include "util/process/process_memory_linux.h"
 
 namespace crashpad {
@@ -41,6 +43,20 @@ class PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   virtual bool Attach(pid_t tid) = 0;
 
+  //! \brief Adds several threads to this connection at once.
+  //!
+  //! The default implementation calls Attach() for each thread in turn, so
+  //! that each thread is stopped only after the previous one. Connections
+  //! able to stop every thread before waiting for any of them should override
+  //! this, so that stopping a process doesn't take longer with each thread.
+  //!
+  //! \param[in] tids The thread IDs of the threads to attach.
+  //! \param[out] results A vector the same size as \a tids, with every
+  //!     element initially `false`. Elements are set to `true` for each
+  //!     thread attached.
+  virtual void AttachThreads(const std::vector<pid_t>& tids,
+                             std::vector<bool>* results);
+
   //! \brief Returns `true` if connected to a 64-bit process.
   virtual bool Is64Bit() = 0;
 
@@ -51,6 +67,20 @@ class PtraceConnection {
   //! \return `true` on success. `false` on failure with a message logged.
   virtual bool GetThreadInfo(pid_t tid, ThreadInfo* info) = 0;
 
+  //! \brief Retrieves the extended register state of a target thread, such as
+  //!     its AVX or SVE registers.
+  //!
+  //! The default implementation reports that no extended register state is
+  //! available. Connections able to collect it should override this.
+  //!
+  //! \param[in] tid The thread ID of the target thread.
+  //! \param[out] state The thread’s extended register state. Its format is
+  //!     ExtendedRegisterState::Format::kNone if the connection, CPU, or
+  //!     kernel doesn’t support collecting any.
+  //! \return `true` on success. `false` on failure with a message logged.
+  virtual bool GetExtendedRegisterState(pid_t tid,
+                                        ExtendedRegisterState* state);
+
   //! \brief Reads the entire contents of a file.
   //!
   //! \param[in] path The path of the file to read.
@@ -60,6 +90,26 @@ class PtraceConnection {
   virtual bool ReadFileContents(const base::FilePath& path,
                                 std::string* contents) = 0;
 
+  //! \brief Indicates that several files are about to be read with
+  //!     ReadFileContents().
+  //!
+  //! The default implementation does nothing. Connections for which each read
+  //! is expensive, such as those that forward requests to another process,
+  //! may override this to read all of the files at once and hold their
+  //! contents until they're requested.
+  //!
+  //! \param[in] paths The paths of the files to be read.
+  virtual void PrefetchFileContents(const std::vector<base::FilePath>& paths);
+
+  //! \brief Discards any contents of \a path held by this connection, so that
+  //!     the next call to ReadFileContents() for it reads the file again.
+  //!
+  //! Callers that read a file again because it may have changed must call
+  //! this first. The default implementation does nothing.
+  //!
+  //! \param[in] path The path of the file.
+  virtual void DiscardFileContents(const base::FilePath& path);
+
   //! \brief Returns a memory reader for the connected process.
   //!
   //! The caller does not take ownership of the reader. The reader is valid for
@@ -74,6 +124,22 @@ class PtraceConnection {
   //!     thread IDs.
   virtual bool Threads(std::vector<pid_t>* threads) = 0;
 
+  //! \brief Determines the threads in the connected process along with their
+  //!     names and `stat` files.
+  //!
+  //! The default implementation calls Threads() and then reads each thread's
+  //! files with ReadFileContents(). Connections which can read the files of
+  //! every thread at once should override this, so that the cost of
+  //! collecting threads doesn't grow with a round trip per file.
+  //!
+  //! \param[out] tasks Information about each thread. ProcTaskInfo::name and
+  //!     ProcTaskInfo::stat are empty, and context switch counts are absent,
+  //!     for threads whose files couldn't be read.
+  //! \return `true` on success, `false` on failure with a message logged. If
+  //!     this method returns `false`, \a tasks may contain a partial list of
+  //!     threads.
+  virtual bool ReadThreadDetails(std::vector<ProcTaskInfo>* tasks);
+
   //! \brief Copies memory from the connected process into a caller-provided
   //!     buffer in the current process, up to a maximum number of bytes.
   //!
@@ -87,6 +153,23 @@ class PtraceConnection {
   //! \return the number of bytes copied, 0 if there is no more data to read, or
   //!     -1 on failure with a message logged.
   virtual ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) = 0;
+
+  //! \brief Copies several memory regions from the connected process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! The default implementation reads each region in turn with ReadUpTo().
+  //! Connections for which each read is expensive, such as those that forward
+  //! requests to another process, should override this to service all of the
+  //! regions at once.
+  //!
+  //! \param[in] ranges The memory regions to copy.
+  //! \param[out] results A vector the same size as \a ranges, with every
+  //!     element initially `false`. Elements are set to `true` for each region
+  //!     copied in full. Messages are logged for regions that could not be
+  //!     copied.
+  virtual void ReadMemoryBatch(
+      const std::vector<ProcessMemory::ReadRange>& ranges,
+      std::vector<bool>* results);
 };
 
 }  // namespace crashpad
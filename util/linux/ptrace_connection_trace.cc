@@ -0,0 +1,458 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection_trace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x52545043;  // 'CPTR'
+constexpr uint32_t kVersion = 1;
+
+// Record payloads are read in chunks of at most this size, so that a record
+// whose size was corrupted is found to be truncated before that much memory is
+// allocated for it.
+constexpr size_t kMaxPayloadChunkSize = 1024 * 1024;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t thread_info_size;
+  int32_t process_id;
+  uint32_t is_64_bit;
+  uint32_t threads_valid;
+};
+
+enum class RecordType : uint32_t {
+  // An array of int32_t thread IDs.
+  kAttachedThreads = 1,
+
+  // An array of int32_t thread IDs.
+  kThreads,
+
+  // A ThreadInfoRecord.
+  kThreadInfo,
+
+  // An ExtendedRegisterStateRecord, followed by the state's encoded data.
+  kExtendedRegisterState,
+
+  // A uint32_t path size, the path, and the file's contents.
+  kFile,
+
+  // A uint64_t address, followed by the memory at that address.
+  kMemory,
+};
+
+struct RecordHeader {
+  RecordType type;
+  uint32_t reserved;
+  uint64_t size;
+};
+
+struct ThreadInfoRecord {
+  int32_t tid;
+  uint32_t reserved;
+  uint64_t thread_specific_data_address;
+  ThreadContext thread_context;
+  FloatContext float_context;
+};
+
+struct ExtendedRegisterStateRecord {
+  int32_t tid;
+  ExtendedRegisterState::Format format;
+  uint32_t vector_length;
+  uint32_t reserved;
+};
+
+// Records are serialized without padding, so fields are copied in and out of
+// them rather than accessed in place.
+bool WriteRecord(FileWriterInterface* writer,
+                 RecordType type,
+                 const void* prefix,
+                 size_t prefix_size,
+                 const void* data,
+                 size_t data_size) {
+  RecordHeader header = {};
+  header.type = type;
+  header.size = prefix_size + data_size;
+  return writer->Write(&header, sizeof(header)) &&
+         (prefix_size == 0 || writer->Write(prefix, prefix_size)) &&
+         (data_size == 0 || writer->Write(data, data_size));
+}
+
+bool WriteThreadIDs(FileWriterInterface* writer,
+                    RecordType type,
+                    const std::vector<pid_t>& tids) {
+  const std::vector<int32_t> values(tids.begin(), tids.end());
+  return WriteRecord(writer,
+                     type,
+                     nullptr,
+                     0,
+                     values.data(),
+                     values.size() * sizeof(values[0]));
+}
+
+bool ReadThreadIDs(const std::string& payload, std::vector<pid_t>* tids) {
+  if (payload.size() % sizeof(int32_t) != 0) {
+    return false;
+  }
+  tids->resize(payload.size() / sizeof(int32_t));
+  for (size_t index = 0; index < tids->size(); ++index) {
+    int32_t tid;
+    memcpy(&tid, &payload[index * sizeof(tid)], sizeof(tid));
+    (*tids)[index] = tid;
+  }
+  return true;
+}
+
+// ThreadContext and FloatContext aren’t trivially copyable, so the record is
+// decoded field by field, and each context into the member of its union that
+// matches the traced process’s bitness.
+bool ReadThreadInfo(const std::string& payload,
+                    bool is_64_bit,
+                    std::map<pid_t, ThreadInfo>* thread_infos) {
+  if (payload.size() != sizeof(ThreadInfoRecord)) {
+    return false;
+  }
+  const char* data = payload.data();
+
+  int32_t tid;
+  memcpy(&tid, data + offsetof(ThreadInfoRecord, tid), sizeof(tid));
+  ThreadInfo& info = (*thread_infos)[tid];
+
+  uint64_t thread_specific_data_address;
+  memcpy(&thread_specific_data_address,
+         data + offsetof(ThreadInfoRecord, thread_specific_data_address),
+         sizeof(thread_specific_data_address));
+  info.thread_specific_data_address = thread_specific_data_address;
+
+  const char* thread_context =
+      data + offsetof(ThreadInfoRecord, thread_context);
+  const char* float_context = data + offsetof(ThreadInfoRecord, float_context);
+  if (is_64_bit) {
+    memcpy(&info.thread_context.t64,
+           thread_context,
+           sizeof(info.thread_context.t64));
+    memcpy(&info.float_context.f64,
+           float_context,
+           sizeof(info.float_context.f64));
+  } else {
+    memcpy(&info.thread_context.t32,
+           thread_context,
+           sizeof(info.thread_context.t32));
+    memcpy(&info.float_context.f32,
+           float_context,
+           sizeof(info.float_context.f32));
+  }
+  return true;
+}
+
+bool DecodeExtendedRegisterState(const ExtendedRegisterStateRecord& record,
+                                 const char* data,
+                                 size_t size,
+                                 ExtendedRegisterState* state) {
+  state->Reset(record.format, record.vector_length);
+  size_t offset = 0;
+  while (offset < size) {
+    ExtendedRegisterState::Component component;
+    if (size - offset < sizeof(component)) {
+      return false;
+    }
+    memcpy(&component, data + offset, sizeof(component));
+    offset += sizeof(component);
+    if (component.size > size - offset) {
+      return false;
+    }
+    state->AddComponent(component.id, data + offset, component.size);
+    const size_t padded_size = (size_t{component.size} + 7) & ~size_t{7};
+    offset += std::min(padded_size, size - offset);
+  }
+  return true;
+}
+
+}  // namespace
+
+PtraceConnectionTrace::PtraceConnectionTrace()
+    : process_id(-1),
+      is_64_bit(false),
+      attached_threads(),
+      threads_valid(false),
+      threads(),
+      thread_infos(),
+      extended_register_states(),
+      files(),
+      memory() {}
+
+PtraceConnectionTrace::~PtraceConnectionTrace() = default;
+
+void PtraceConnectionTrace::AddMemory(VMAddress address,
+                                      const void* data,
+                                      size_t size) {
+  if (size == 0 || address > std::numeric_limits<VMAddress>::max() - size) {
+    return;
+  }
+  VMAddress start = address;
+  VMAddress end = address + size;
+
+  // Absorb every range that overlaps or abuts the new one. Bytes already
+  // recorded are replaced by the new ones, which were read more recently.
+  auto first = memory.upper_bound(start);
+  if (first != memory.begin()) {
+    auto previous = std::prev(first);
+    if (previous->first + previous->second.size() >= start) {
+      first = previous;
+    }
+  }
+  auto last = first;
+  for (; last != memory.end() && last->first <= end; ++last) {
+    start = std::min(start, last->first);
+    end = std::max(end, last->first + last->second.size());
+  }
+
+  std::string merged(end - start, '\0');
+  for (auto it = first; it != last; ++it) {
+    memcpy(&merged[it->first - start], it->second.data(), it->second.size());
+  }
+  memcpy(&merged[address - start], data, size);
+  memory.erase(first, last);
+  memory.emplace(start, std::move(merged));
+}
+
+size_t PtraceConnectionTrace::ReadMemory(VMAddress address,
+                                         size_t size,
+                                         void* buffer) const {
+  auto it = memory.upper_bound(address);
+  if (it == memory.begin()) {
+    return 0;
+  }
+  --it;
+  const VMAddress offset = address - it->first;
+  if (offset >= it->second.size()) {
+    return 0;
+  }
+  const size_t available =
+      std::min(size, static_cast<size_t>(it->second.size() - offset));
+  memcpy(buffer, it->second.data() + offset, available);
+  return available;
+}
+
+bool PtraceConnectionTrace::Write(FileWriterInterface* writer) const {
+  Header header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.thread_info_size = sizeof(ThreadInfoRecord);
+  header.process_id = process_id;
+  header.is_64_bit = is_64_bit;
+  header.threads_valid = threads_valid;
+  if (!writer->Write(&header, sizeof(header)) ||
+      !WriteThreadIDs(writer, RecordType::kAttachedThreads, attached_threads) ||
+      !WriteThreadIDs(writer, RecordType::kThreads, threads)) {
+    return false;
+  }
+
+  for (const auto& [tid, info] : thread_infos) {
+    ThreadInfoRecord record = {};
+    record.tid = tid;
+    record.thread_specific_data_address = info.thread_specific_data_address;
+    record.thread_context = info.thread_context;
+    record.float_context = info.float_context;
+    if (!WriteRecord(writer,
+                     RecordType::kThreadInfo,
+                     &record,
+                     sizeof(record),
+                     nullptr,
+                     0)) {
+      return false;
+    }
+  }
+
+  for (const auto& [tid, state] : extended_register_states) {
+    ExtendedRegisterStateRecord record = {};
+    record.tid = tid;
+    record.format = state.format();
+    record.vector_length = state.vector_length();
+    if (!WriteRecord(writer,
+                     RecordType::kExtendedRegisterState,
+                     &record,
+                     sizeof(record),
+                     state.data().data(),
+                     state.data().size())) {
+      return false;
+    }
+  }
+
+  for (const auto& [path, reads] : files) {
+    std::string prefix(sizeof(uint32_t), '\0');
+    const uint32_t path_size = static_cast<uint32_t>(path.size());
+    memcpy(&prefix[0], &path_size, sizeof(path_size));
+    prefix += path;
+    for (const std::string& contents : reads) {
+      if (!WriteRecord(writer,
+                       RecordType::kFile,
+                       prefix.data(),
+                       prefix.size(),
+                       contents.data(),
+                       contents.size())) {
+        return false;
+      }
+    }
+  }
+
+  for (const auto& [address, data] : memory) {
+    const uint64_t address_64 = address;
+    if (!WriteRecord(writer,
+                     RecordType::kMemory,
+                     &address_64,
+                     sizeof(address_64),
+                     data.data(),
+                     data.size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PtraceConnectionTrace::Read(FileReaderInterface* reader) {
+  Header header;
+  if (!reader->ReadExactly(&header, sizeof(header))) {
+    return false;
+  }
+  if (header.magic != kMagic || header.version != kVersion) {
+    LOG(ERROR) << "not a trace";
+    return false;
+  }
+  if (header.thread_info_size != sizeof(ThreadInfoRecord)) {
+    LOG(ERROR) << "trace recorded for another architecture";
+    return false;
+  }
+
+  process_id = header.process_id;
+  is_64_bit = header.is_64_bit != 0;
+  threads_valid = header.threads_valid != 0;
+  attached_threads.clear();
+  threads.clear();
+  thread_infos.clear();
+  extended_register_states.clear();
+  files.clear();
+  memory.clear();
+
+  while (true) {
+    RecordHeader record_header;
+    const FileOperationResult bytes_read =
+        reader->Read(&record_header, sizeof(record_header));
+    if (bytes_read == 0) {
+      return true;
+    }
+    if (bytes_read < 0 ||
+        (static_cast<size_t>(bytes_read) < sizeof(record_header) &&
+         !reader->ReadExactly(reinterpret_cast<char*>(&record_header) +
+                                  bytes_read,
+                              sizeof(record_header) - bytes_read))) {
+      return false;
+    }
+    if (record_header.size > std::numeric_limits<size_t>::max()) {
+      LOG(ERROR) << "record too large";
+      return false;
+    }
+
+    std::string payload;
+    size_t remaining = static_cast<size_t>(record_header.size);
+    while (remaining > 0) {
+      const size_t chunk_size = std::min(remaining, kMaxPayloadChunkSize);
+      const size_t offset = payload.size();
+      payload.resize(offset + chunk_size);
+      if (!reader->ReadExactly(&payload[offset], chunk_size)) {
+        return false;
+      }
+      remaining -= chunk_size;
+    }
+
+    bool valid = true;
+    switch (record_header.type) {
+      case RecordType::kAttachedThreads:
+        valid = ReadThreadIDs(payload, &attached_threads);
+        break;
+
+      case RecordType::kThreads:
+        valid = ReadThreadIDs(payload, &threads);
+        break;
+
+      case RecordType::kThreadInfo:
+        valid = ReadThreadInfo(payload, is_64_bit, &thread_infos);
+        break;
+
+      case RecordType::kExtendedRegisterState: {
+        ExtendedRegisterStateRecord record;
+        valid = payload.size() >= sizeof(record);
+        if (valid) {
+          memcpy(&record, payload.data(), sizeof(record));
+          valid = DecodeExtendedRegisterState(
+              record,
+              payload.data() + sizeof(record),
+              payload.size() - sizeof(record),
+              &extended_register_states[record.tid]);
+        }
+        break;
+      }
+
+      case RecordType::kFile: {
+        uint32_t path_size;
+        valid = payload.size() >= sizeof(path_size);
+        if (valid) {
+          memcpy(&path_size, payload.data(), sizeof(path_size));
+          valid = path_size <= payload.size() - sizeof(path_size);
+        }
+        if (valid) {
+          files[payload.substr(sizeof(path_size), path_size)].push_back(
+              payload.substr(sizeof(path_size) + path_size));
+        }
+        break;
+      }
+
+      case RecordType::kMemory: {
+        uint64_t address;
+        valid = payload.size() >= sizeof(address);
+        if (valid) {
+          memcpy(&address, payload.data(), sizeof(address));
+          AddMemory(address,
+                    payload.data() + sizeof(address),
+                    payload.size() - sizeof(address));
+        }
+        break;
+      }
+
+      default:
+        // Records added by later versions are skipped.
+        break;
+    }
+    if (!valid) {
+      LOG(ERROR) << "malformed trace record";
+      return false;
+    }
+  }
+}
+
+}  // namespace crashpad
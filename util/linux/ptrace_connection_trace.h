@@ -0,0 +1,105 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_PTRACE_CONNECTION_TRACE_H_
+#define CRASHPAD_UTIL_LINUX_PTRACE_CONNECTION_TRACE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "util/file/file_reader.h"
+#include "util/file/file_writer.h"
+#include "util/linux/thread_info.h"
+#include "util/misc/address_types.h"
+#include "util/misc/extended_register_state.h"
+
+namespace crashpad {
+
+//! \brief The results of the requests made of a PtraceConnection, recorded by
+//!     RecordingPtraceConnection and served by ReplayPtraceConnection.
+//!
+//! Only successful requests are recorded. A request with no recorded result is
+//! treated as having failed.
+//!
+//! A trace can only be replayed by a build for the same architecture as the
+//! one that recorded it, because thread contexts are stored in their native
+//! layout.
+struct PtraceConnectionTrace {
+  PtraceConnectionTrace();
+
+  PtraceConnectionTrace(const PtraceConnectionTrace&) = delete;
+  PtraceConnectionTrace& operator=(const PtraceConnectionTrace&) = delete;
+
+  ~PtraceConnectionTrace();
+
+  //! \brief Stores the bytes read from \a address, merging them with any
+  //!     memory already recorded.
+  void AddMemory(VMAddress address, const void* data, size_t size);
+
+  //! \brief Copies recorded memory starting at \a address into \a buffer, up
+  //!     to \a size bytes.
+  //!
+  //! \return The number of bytes copied, which is less than \a size if the
+  //!     recorded memory ends before then, and 0 if \a address wasn't
+  //!     recorded.
+  size_t ReadMemory(VMAddress address, size_t size, void* buffer) const;
+
+  //! \brief Writes this trace to \a writer.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Write(FileWriterInterface* writer) const;
+
+  //! \brief Replaces this trace with one read from \a reader.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged, if
+  //!     the trace is malformed or was recorded for another architecture.
+  bool Read(FileReaderInterface* reader);
+
+  //! \brief The process ID of the connected process.
+  pid_t process_id;
+
+  //! \brief Whether the connected process is 64-bit.
+  bool is_64_bit;
+
+  //! \brief The threads that were successfully attached.
+  std::vector<pid_t> attached_threads;
+
+  //! \brief Whether PtraceConnection::Threads() succeeded.
+  bool threads_valid;
+
+  //! \brief The thread IDs returned by the last call to
+  //!     PtraceConnection::Threads().
+  std::vector<pid_t> threads;
+
+  //! \brief The thread information retrieved for each thread.
+  std::map<pid_t, ThreadInfo> thread_infos;
+
+  //! \brief The extended register state retrieved for each thread.
+  std::map<pid_t, ExtendedRegisterState> extended_register_states;
+
+  //! \brief The contents of each file read, in the order they were read.
+  std::map<std::string, std::vector<std::string>> files;
+
+  //! \brief The memory read, as ranges keyed by their start addresses. Ranges
+  //!     neither overlap nor abut one another.
+  std::map<VMAddress, std::string> memory;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_PTRACE_CONNECTION_TRACE_H_
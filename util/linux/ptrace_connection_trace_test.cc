@@ -0,0 +1,154 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/ptrace_connection_trace.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/file/string_file.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::string ReadTraceMemory(const PtraceConnectionTrace& trace,
+                            VMAddress address,
+                            size_t size) {
+  std::string buffer(size, '\0');
+  buffer.resize(trace.ReadMemory(address, size, &buffer[0]));
+  return buffer;
+}
+
+TEST(PtraceConnectionTrace, Memory) {
+  PtraceConnectionTrace trace;
+  trace.AddMemory(0x1000, "abcd", 4);
+  trace.AddMemory(0x1010, "wxyz", 4);
+  EXPECT_EQ(trace.memory.size(), 2u);
+  EXPECT_EQ(ReadTraceMemory(trace, 0x1000, 8), "abcd");
+  EXPECT_EQ(ReadTraceMemory(trace, 0x1002, 1), "c");
+  EXPECT_EQ(ReadTraceMemory(trace, 0x1004, 4), "");
+  EXPECT_EQ(ReadTraceMemory(trace, 0xfff, 4), "");
+
+  // Abutting ranges are merged.
+  trace.AddMemory(0x1004, "efgh", 4);
+  EXPECT_EQ(trace.memory.size(), 2u);
+  EXPECT_EQ(ReadTraceMemory(trace, 0x1000, 16), "abcdefgh");
+
+  // A range spanning others replaces them, keeping the bytes it doesn't
+  // cover.
+  trace.AddMemory(0x1006, "GHIJKLMNOPQR", 12);
+  ASSERT_EQ(trace.memory.size(), 1u);
+  EXPECT_EQ(trace.memory.begin()->first, 0x1000u);
+  EXPECT_EQ(ReadTraceMemory(trace, 0x1000, 32), "abcdefGHIJKLMNOPQRyz");
+
+  // A range within another overwrites it.
+  trace.AddMemory(0x1001, "B", 1);
+  ASSERT_EQ(trace.memory.size(), 1u);
+  EXPECT_EQ(ReadTraceMemory(trace, 0x1000, 4), "aBcd");
+}
+
+TEST(PtraceConnectionTrace, WriteAndRead) {
+  PtraceConnectionTrace trace;
+  trace.process_id = 1234;
+  trace.is_64_bit = true;
+  trace.attached_threads = {1234, 1235};
+  trace.threads_valid = true;
+  trace.threads = {1234, 1235, 1236};
+  ThreadInfo& info = trace.thread_infos[1235];
+  info.thread_specific_data_address = 0x5678;
+  memset(&info.thread_context.t64, 0x11, sizeof(info.thread_context.t64));
+  memset(&info.float_context.f64, 0x22, sizeof(info.float_context.f64));
+  static constexpr uint8_t kRegisters[] = {1, 2, 3, 4, 5};
+  ExtendedRegisterState& state = trace.extended_register_states[1234];
+  state.Reset(ExtendedRegisterState::Format::kARM64SVE, 16);
+  state.AddComponent(ExtendedRegisterState::kSVEComponentP,
+                     kRegisters,
+                     sizeof(kRegisters));
+  state.AddComponent(ExtendedRegisterState::kSVEComponentFFR,
+                     kRegisters,
+                     sizeof(kRegisters) - 1);
+  trace.files["/proc/1234/maps"] = {"first", "second"};
+  trace.files["/proc/1234/auxv"] = {std::string("\0\1", 2)};
+  trace.AddMemory(0x1000, "abcd", 4);
+  trace.AddMemory(0x2000, "efgh", 4);
+
+  StringFile file;
+  ASSERT_TRUE(trace.Write(&file));
+  ASSERT_EQ(file.Seek(0, SEEK_SET), 0);
+
+  PtraceConnectionTrace read;
+  ASSERT_TRUE(read.Read(&file));
+  EXPECT_EQ(read.process_id, 1234);
+  EXPECT_TRUE(read.is_64_bit);
+  EXPECT_EQ(read.attached_threads, trace.attached_threads);
+  EXPECT_TRUE(read.threads_valid);
+  EXPECT_EQ(read.threads, trace.threads);
+  ASSERT_EQ(read.thread_infos.size(), 1u);
+  const ThreadInfo& read_info = read.thread_infos[1235];
+  EXPECT_EQ(read_info.thread_specific_data_address, 0x5678u);
+  EXPECT_EQ(memcmp(&read_info.thread_context.t64,
+                   &info.thread_context.t64,
+                   sizeof(info.thread_context.t64)),
+            0);
+  EXPECT_EQ(memcmp(&read_info.float_context.f64,
+                   &info.float_context.f64,
+                   sizeof(info.float_context.f64)),
+            0);
+  ASSERT_EQ(read.extended_register_states.size(), 1u);
+  EXPECT_EQ(read.extended_register_states[1234].format(), state.format());
+  EXPECT_EQ(read.extended_register_states[1234].vector_length(),
+            state.vector_length());
+  EXPECT_EQ(read.extended_register_states[1234].data(), state.data());
+  EXPECT_EQ(read.files, trace.files);
+  EXPECT_EQ(read.memory, trace.memory);
+
+  // Truncated traces are rejected.
+  const std::string contents = file.string();
+  for (size_t size : {size_t{0}, size_t{8}, contents.size() - 1}) {
+    SCOPED_TRACE(size);
+    file.SetString(contents.substr(0, size));
+    EXPECT_FALSE(read.Read(&file));
+  }
+}
+
+TEST(PtraceConnectionTrace, CorruptRecordSize) {
+  PtraceConnectionTrace trace;
+  StringFile file;
+  ASSERT_TRUE(trace.Write(&file));
+
+  // A record claiming to be far larger than the trace is rejected as
+  // truncated, without allocating its claimed size.
+  std::string contents = file.string();
+  struct {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t size;
+  } record_header = {2, 0, uint64_t{1} << 60};
+  contents.append(reinterpret_cast<const char*>(&record_header),
+                  sizeof(record_header));
+  contents.append("abcd");
+  file.SetString(contents);
+  ASSERT_EQ(file.Seek(0, SEEK_SET), 0);
+
+  PtraceConnectionTrace read;
+  EXPECT_FALSE(read.Read(&file));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -20,6 +20,9 @@
 #include <sys/ptrace.h>
 #include <sys/uio.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "build/build_config.h"
@@ -484,6 +487,110 @@ bool GetGeneralPurposeRegisters64(pid_t tid,
   return true;
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+
+bool GetXSaveState(pid_t tid, ExtendedRegisterState* state, bool can_log) {
+  const XSaveLayout* layout = NativeXSaveLayout();
+  if (!layout) {
+    state->Reset(ExtendedRegisterState::Format::kNone, 0);
+    return true;
+  }
+
+  // The legacy region and XSAVE header are followed by the components.
+  size_t xsave_size = 576;
+  for (const XSaveComponentLayout& component : *layout) {
+    if (component.size != 0) {
+      xsave_size = std::max(
+          xsave_size, static_cast<size_t>(component.offset) + component.size);
+    }
+  }
+
+  std::vector<uint8_t> xsave(xsave_size);
+  iovec iov;
+  iov.iov_base = xsave.data();
+  iov.iov_len = xsave.size();
+  if (ptrace(PTRACE_GETREGSET,
+             tid,
+             reinterpret_cast<void*>(NT_X86_XSTATE),
+             &iov) != 0) {
+    PLOG_IF(ERROR, can_log) << "ptrace";
+    return false;
+  }
+  return state->InitializeFromXSave(xsave.data(), iov.iov_len, *layout);
+}
+
+#elif defined(ARCH_CPU_ARM64)
+
+#if !defined(NT_ARM_SVE)
+#define NT_ARM_SVE 0x405
+#endif
+
+// user_sve_header from <asm/ptrace.h>, which isn’t available in older headers.
+struct SVEHeader {
+  uint32_t size;
+  uint32_t max_size;
+  uint16_t vl;
+  uint16_t max_vl;
+  uint16_t flags;
+  uint16_t reserved;
+};
+
+// SVE_PT_REGS_MASK and SVE_PT_REGS_SVE. When the registers aren’t in the SVE
+// format, the thread has no SVE state beyond what the FPSIMD registers hold.
+constexpr uint16_t kSVERegsMask = 1;
+constexpr uint16_t kSVERegsSVE = 1;
+
+bool GetSVEState(pid_t tid, ExtendedRegisterState* state, bool can_log) {
+  state->Reset(ExtendedRegisterState::Format::kNone, 0);
+
+  SVEHeader header;
+  iovec iov;
+  iov.iov_base = &header;
+  iov.iov_len = sizeof(header);
+  if (ptrace(
+          PTRACE_GETREGSET, tid, reinterpret_cast<void*>(NT_ARM_SVE), &iov) !=
+      0) {
+    switch (errno) {
+      case EINVAL:
+      case ENODEV:
+        // The CPU or kernel doesn’t support SVE.
+        return true;
+      default:
+        PLOG_IF(ERROR, can_log) << "ptrace";
+        return false;
+    }
+  }
+  if (iov.iov_len < sizeof(header) ||
+      (header.flags & kSVERegsMask) != kSVERegsSVE) {
+    return true;
+  }
+  if (header.size < sizeof(header)) {
+    LOG_IF(ERROR, can_log) << "Unexpected SVE size " << header.size;
+    return false;
+  }
+
+  std::vector<uint8_t> sve(header.size);
+  iov.iov_base = sve.data();
+  iov.iov_len = sve.size();
+  if (ptrace(
+          PTRACE_GETREGSET, tid, reinterpret_cast<void*>(NT_ARM_SVE), &iov) !=
+      0) {
+    PLOG_IF(ERROR, can_log) << "ptrace";
+    return false;
+  }
+  if (iov.iov_len < sizeof(header)) {
+    LOG_IF(ERROR, can_log) << "Unexpected SVE size " << iov.iov_len;
+    return false;
+  }
+
+  // The vector length may have changed between the two requests.
+  memcpy(&header, sve.data(), sizeof(header));
+  return state->InitializeFromSVE(
+      header.vl, sve.data() + sizeof(header), iov.iov_len - sizeof(header));
+}
+
+#endif  // ARCH_CPU_X86_FAMILY
+
 }  // namespace
 
 Ptracer::Ptracer(bool can_log)
@@ -546,6 +653,24 @@ bool Ptracer::GetThreadInfo(pid_t tid, ThreadInfo* info) {
 #endif
 }
 
+bool Ptracer::GetExtendedRegisterState(pid_t tid,
+                                       ExtendedRegisterState* state) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  return GetXSaveState(tid, state, can_log_);
+#elif defined(ARCH_CPU_ARM64)
+  if (is_64_bit_) {
+    return GetSVEState(tid, state, can_log_);
+  }
+  state->Reset(ExtendedRegisterState::Format::kNone, 0);
+  return true;
+#else
+  state->Reset(ExtendedRegisterState::Format::kNone, 0);
+  return true;
+#endif  // ARCH_CPU_X86_FAMILY
+}
+
 ssize_t Ptracer::ReadUpTo(pid_t pid,
                           LinuxVMAddress address,
                           size_t size,
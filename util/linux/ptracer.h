@@ -19,6 +19,7 @@
 
 #include "util/linux/address_types.h"
 #include "util/linux/thread_info.h"
+#include "util/misc/extended_register_state.h"
 #include "util/misc/initialization_state_dcheck.h"
 
 namespace crashpad {
@@ -73,6 +74,20 @@ class Ptracer {
   //!     enabled.
   bool GetThreadInfo(pid_t tid, ThreadInfo* info);
 
+  //! \brief Uses `ptrace` to collect the extended register state of the thread
+  //!     with thread ID \a tid.
+  //!
+  //! The target thread should be attached before calling this method.
+  //! \see ScopedPtraceAttach
+  //!
+  //! \param[in] tid The thread ID of the thread to collect state for.
+  //! \param[out] state The thread’s extended register state. Its format is
+  //!     ExtendedRegisterState::Format::kNone if the CPU or kernel doesn’t
+  //!     support any.
+  //! \return `true` on success. `false` on failure with a message logged, if
+  //!     enabled.
+  bool GetExtendedRegisterState(pid_t tid, ExtendedRegisterState* state);
+
   //! \brief Uses `ptrace` to read memory from the process with process ID \a
   //!     pid, up to a maximum number of bytes.
   //!
@@ -61,6 +61,16 @@ class SameBitnessTest : public Multiprocess {
 #endif  // ARCH_CPU_X86_64
 
     EXPECT_EQ(thread_info.thread_specific_data_address, expected_tls);
+
+    ExtendedRegisterState extended_registers;
+    ASSERT_TRUE(
+        ptracer.GetExtendedRegisterState(ChildPID(), &extended_registers));
+#if defined(ARCH_CPU_X86_FAMILY)
+    if (NativeXSaveLayout()) {
+      EXPECT_EQ(extended_registers.format(),
+                ExtendedRegisterState::Format::kX86XSave);
+    }
+#endif  // ARCH_CPU_X86_FAMILY
   }
 
   void MultiprocessChild() override {
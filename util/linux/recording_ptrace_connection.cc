@@ -0,0 +1,139 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/recording_ptrace_connection.h"
+
+#include <algorithm>
+
+#include "base/check_op.h"
+
+namespace crashpad {
+
+RecordingPtraceConnection::RecordingPtraceConnection(
+    PtraceConnection* connection)
+    : PtraceConnection(), trace_(), memory_(), connection_(connection) {
+  trace_.process_id = connection_->GetProcessID();
+  trace_.is_64_bit = connection_->Is64Bit();
+}
+
+RecordingPtraceConnection::~RecordingPtraceConnection() {}
+
+pid_t RecordingPtraceConnection::GetProcessID() {
+  return trace_.process_id;
+}
+
+bool RecordingPtraceConnection::Attach(pid_t tid) {
+  if (!connection_->Attach(tid)) {
+    return false;
+  }
+  if (std::find(trace_.attached_threads.begin(),
+                trace_.attached_threads.end(),
+                tid) == trace_.attached_threads.end()) {
+    trace_.attached_threads.push_back(tid);
+  }
+  return true;
+}
+
+bool RecordingPtraceConnection::Is64Bit() {
+  return trace_.is_64_bit;
+}
+
+bool RecordingPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+  if (!connection_->GetThreadInfo(tid, info)) {
+    trace_.thread_infos.erase(tid);
+    return false;
+  }
+  trace_.thread_infos[tid] = *info;
+  return true;
+}
+
+bool RecordingPtraceConnection::GetExtendedRegisterState(
+    pid_t tid,
+    ExtendedRegisterState* state) {
+  if (!connection_->GetExtendedRegisterState(tid, state)) {
+    trace_.extended_register_states.erase(tid);
+    return false;
+  }
+  trace_.extended_register_states[tid] = *state;
+  return true;
+}
+
+bool RecordingPtraceConnection::ReadFileContents(const base::FilePath& path,
+                                                 std::string* contents) {
+  if (!connection_->ReadFileContents(path, contents)) {
+    return false;
+  }
+  trace_.files[path.value()].push_back(*contents);
+  return true;
+}
+
+void RecordingPtraceConnection::PrefetchFileContents(
+    const std::vector<base::FilePath>& paths) {
+  connection_->PrefetchFileContents(paths);
+}
+
+void RecordingPtraceConnection::DiscardFileContents(
+    const base::FilePath& path) {
+  connection_->DiscardFileContents(path);
+}
+
+ProcessMemoryLinux* RecordingPtraceConnection::Memory() {
+  // Every read must reach ReadUpTo() or ReadMemoryBatch() to be recorded.
+  if (!memory_) {
+    memory_ = std::make_unique<ProcessMemoryLinux>(
+        this, ProcessMemoryLinux::Access::kConnectionOnly);
+  }
+  return memory_.get();
+}
+
+bool RecordingPtraceConnection::Threads(std::vector<pid_t>* threads) {
+  trace_.threads_valid = connection_->Threads(threads);
+  trace_.threads = *threads;
+  return trace_.threads_valid;
+}
+
+ssize_t RecordingPtraceConnection::ReadUpTo(VMAddress address,
+                                            size_t size,
+                                            void* buffer) {
+  // Reading through the wrapped connection's memory reader is faster than its
+  // ReadUpTo(), but only reports whether the whole region could be read.
+  ProcessMemory::ReadRange range = {address, size, buffer};
+  std::vector<bool> results;
+  ssize_t bytes_read;
+  if (connection_->Memory()->ReadBatch({range}, &results)) {
+    bytes_read = size;
+  } else {
+    bytes_read = connection_->ReadUpTo(address, size, buffer);
+  }
+  if (bytes_read > 0) {
+    trace_.AddMemory(address, buffer, bytes_read);
+  }
+  return bytes_read;
+}
+
+void RecordingPtraceConnection::ReadMemoryBatch(
+    const std::vector<ProcessMemory::ReadRange>& ranges,
+    std::vector<bool>* results) {
+  DCHECK_EQ(results->size(), ranges.size());
+  connection_->Memory()->ReadBatch(ranges, results);
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    if ((*results)[index]) {
+      trace_.AddMemory(ranges[index].address,
+                       ranges[index].buffer,
+                       static_cast<size_t>(ranges[index].size));
+    }
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,82 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_RECORDING_PTRACE_CONNECTION_H_
+#define CRASHPAD_UTIL_LINUX_RECORDING_PTRACE_CONNECTION_H_
+
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/linux/ptrace_connection.h"
+#include "util/linux/ptrace_connection_trace.h"
+#include "util/process/process_memory_linux.h"
+
+namespace crashpad {
+
+//! \brief A PtraceConnection that forwards each request to another connection
+//!     and records its result in a PtraceConnectionTrace.
+//!
+//! A capture made through this connection can be repeated without the target
+//! process by a ReplayPtraceConnection serving the trace. Memory is read
+//! through the wrapped connection's ProcessMemoryLinux, one request at a time.
+//!
+//! Some information is collected directly rather than through a connection, and
+//! isn't recorded. This includes <code>/proc/<i>pid</i>/pagemap</code>, which
+//! is only read when skipping unpopulated memory, and threads' scheduling
+//! parameters.
+class RecordingPtraceConnection : public PtraceConnection {
+ public:
+  //! \param[in] connection The connection to forward requests to, which must
+  //!     outlive this object.
+  explicit RecordingPtraceConnection(PtraceConnection* connection);
+
+  RecordingPtraceConnection(const RecordingPtraceConnection&) = delete;
+  RecordingPtraceConnection& operator=(const RecordingPtraceConnection&) =
+      delete;
+
+  ~RecordingPtraceConnection();
+
+  //! \brief Returns the requests recorded so far.
+  const PtraceConnectionTrace& trace() const { return trace_; }
+
+  // PtraceConnection:
+
+  pid_t GetProcessID() override;
+  bool Attach(pid_t tid) override;
+  bool Is64Bit() override;
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetExtendedRegisterState(pid_t tid,
+                                ExtendedRegisterState* state) override;
+  bool ReadFileContents(const base::FilePath& path,
+                        std::string* contents) override;
+  void PrefetchFileContents(const std::vector<base::FilePath>& paths) override;
+  void DiscardFileContents(const base::FilePath& path) override;
+  ProcessMemoryLinux* Memory() override;
+  bool Threads(std::vector<pid_t>* threads) override;
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+  void ReadMemoryBatch(const std::vector<ProcessMemory::ReadRange>& ranges,
+                       std::vector<bool>* results) override;
+
+ private:
+  PtraceConnectionTrace trace_;
+  std::unique_ptr<ProcessMemoryLinux> memory_;
+  PtraceConnection* connection_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_RECORDING_PTRACE_CONNECTION_H_
@@ -0,0 +1,148 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/replay_ptrace_connection.h"
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+ReplayPtraceConnection::ReplayPtraceConnection()
+    : PtraceConnection(),
+      file_reads_(),
+      memory_(),
+      trace_(nullptr),
+      initialized_() {}
+
+ReplayPtraceConnection::~ReplayPtraceConnection() {}
+
+void ReplayPtraceConnection::Initialize(const PtraceConnectionTrace* trace) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  trace_ = trace;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+}
+
+pid_t ReplayPtraceConnection::GetProcessID() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return trace_->process_id;
+}
+
+bool ReplayPtraceConnection::Attach(pid_t tid) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (std::find(trace_->attached_threads.begin(),
+                trace_->attached_threads.end(),
+                tid) == trace_->attached_threads.end()) {
+    LOG(ERROR) << "thread " << tid << " not attached in trace";
+    return false;
+  }
+  return true;
+}
+
+bool ReplayPtraceConnection::Is64Bit() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  return trace_->is_64_bit;
+}
+
+bool ReplayPtraceConnection::GetThreadInfo(pid_t tid, ThreadInfo* info) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = trace_->thread_infos.find(tid);
+  if (it == trace_->thread_infos.end()) {
+    LOG(ERROR) << "no thread info for " << tid << " in trace";
+    return false;
+  }
+  *info = it->second;
+  return true;
+}
+
+bool ReplayPtraceConnection::GetExtendedRegisterState(
+    pid_t tid,
+    ExtendedRegisterState* state) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = trace_->extended_register_states.find(tid);
+  if (it == trace_->extended_register_states.end()) {
+    LOG(ERROR) << "no extended register state for " << tid << " in trace";
+    return false;
+  }
+  *state = it->second;
+  return true;
+}
+
+bool ReplayPtraceConnection::ReadFileContents(const base::FilePath& path,
+                                              std::string* contents) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  auto it = trace_->files.find(path.value());
+  if (it == trace_->files.end() || it->second.empty()) {
+    LOG(ERROR) << path.value() << " not in trace";
+    return false;
+  }
+  size_t& reads = file_reads_[path.value()];
+  *contents = it->second[std::min(reads, it->second.size() - 1)];
+  ++reads;
+  return true;
+}
+
+ProcessMemoryLinux* ReplayPtraceConnection::Memory() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  // The recorded process ID may belong to an unrelated process on this
+  // system, which must not be read.
+  if (!memory_) {
+    memory_ = std::make_unique<ProcessMemoryLinux>(
+        this, ProcessMemoryLinux::Access::kConnectionOnly);
+  }
+  return memory_.get();
+}
+
+bool ReplayPtraceConnection::Threads(std::vector<pid_t>* threads) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  *threads = trace_->threads;
+  return trace_->threads_valid;
+}
+
+ssize_t ReplayPtraceConnection::ReadUpTo(VMAddress address,
+                                         size_t size,
+                                         void* buffer) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (size == 0) {
+    return 0;
+  }
+  const size_t bytes_read = trace_->ReadMemory(address, size, buffer);
+  if (bytes_read == 0) {
+    LOG(ERROR) << "memory at 0x" << std::hex << address << " not in trace";
+    return -1;
+  }
+  return bytes_read;
+}
+
+void ReplayPtraceConnection::ReadMemoryBatch(
+    const std::vector<ProcessMemory::ReadRange>& ranges,
+    std::vector<bool>* results) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_EQ(results->size(), ranges.size());
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    const ProcessMemory::ReadRange& range = ranges[index];
+    if (trace_->ReadMemory(range.address,
+                           static_cast<size_t>(range.size),
+                           range.buffer) == range.size) {
+      (*results)[index] = true;
+    } else {
+      LOG(ERROR) << "memory at 0x" << std::hex << range.address
+                 << " not in trace";
+    }
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,81 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_REPLAY_PTRACE_CONNECTION_H_
+#define CRASHPAD_UTIL_LINUX_REPLAY_PTRACE_CONNECTION_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/linux/ptrace_connection.h"
+#include "util/linux/ptrace_connection_trace.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory_linux.h"
+
+namespace crashpad {
+
+//! \brief A PtraceConnection that serves the results recorded in a
+//!     PtraceConnectionTrace, without connecting to any process.
+//!
+//! This allows a capture recorded by RecordingPtraceConnection to be repeated
+//! deterministically, such as to benchmark or profile snapshot and minidump
+//! code. Requests that weren't recorded fail with a message logged. Each file
+//! that was read several times while recording returns its recorded contents
+//! in turn, and then continues to return the last of them.
+class ReplayPtraceConnection : public PtraceConnection {
+ public:
+  ReplayPtraceConnection();
+
+  ReplayPtraceConnection(const ReplayPtraceConnection&) = delete;
+  ReplayPtraceConnection& operator=(const ReplayPtraceConnection&) = delete;
+
+  ~ReplayPtraceConnection();
+
+  //! \brief Initializes this connection to serve \a trace.
+  //!
+  //! \param[in] trace The recorded requests, which must outlive this object.
+  void Initialize(const PtraceConnectionTrace* trace);
+
+  // PtraceConnection:
+
+  pid_t GetProcessID() override;
+  bool Attach(pid_t tid) override;
+  bool Is64Bit() override;
+  bool GetThreadInfo(pid_t tid, ThreadInfo* info) override;
+  bool GetExtendedRegisterState(pid_t tid,
+                                ExtendedRegisterState* state) override;
+  bool ReadFileContents(const base::FilePath& path,
+                        std::string* contents) override;
+  ProcessMemoryLinux* Memory() override;
+  bool Threads(std::vector<pid_t>* threads) override;
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) override;
+  void ReadMemoryBatch(const std::vector<ProcessMemory::ReadRange>& ranges,
+                       std::vector<bool>* results) override;
+
+ private:
+  // The number of times each file has been read.
+  std::map<std::string, size_t> file_reads_;
+  std::unique_ptr<ProcessMemoryLinux> memory_;
+  const PtraceConnectionTrace* trace_;  // weak
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_REPLAY_PTRACE_CONNECTION_H_
@@ -0,0 +1,130 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/replay_ptrace_connection.h"
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/file/string_file.h"
+#include "util/linux/recording_ptrace_connection.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+bool WriteContents(const base::FilePath& path, const std::string& contents) {
+  ScopedFileHandle file(LoggingOpenFileForWrite(
+      path, FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+  return file.is_valid() &&
+         LoggingWriteFile(file.get(), contents.data(), contents.size());
+}
+
+TEST(ReplayPtraceConnection, RecordAndReplay) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path = temp_dir.path().Append("file");
+
+  static constexpr char kString[] = "a string to read";
+  static constexpr char kFirst[] = "first range";
+  static constexpr char kSecond[] = "second range";
+
+  StringFile trace_file;
+  {
+    FakePtraceConnection connection;
+    ASSERT_TRUE(connection.Initialize(getpid()));
+    RecordingPtraceConnection recording(&connection);
+    EXPECT_EQ(recording.GetProcessID(), getpid());
+
+    ThreadInfo info;
+    ASSERT_TRUE(recording.GetThreadInfo(getpid(), &info));
+
+    ASSERT_TRUE(WriteContents(path, "one"));
+    std::string contents;
+    ASSERT_TRUE(recording.ReadFileContents(path, &contents));
+    ASSERT_TRUE(WriteContents(path, "two"));
+    ASSERT_TRUE(recording.ReadFileContents(path, &contents));
+    EXPECT_EQ(contents, "two");
+
+    std::string string;
+    ASSERT_TRUE(recording.Memory()->ReadCStringSizeLimited(
+        FromPointerCast<VMAddress>(kString), sizeof(kString), &string));
+    EXPECT_EQ(string, kString);
+
+    char first[sizeof(kFirst)];
+    char second[sizeof(kSecond)];
+    std::vector<ProcessMemory::ReadRange> ranges = {
+        {FromPointerCast<VMAddress>(kFirst), sizeof(first), first},
+        {FromPointerCast<VMAddress>(kSecond), sizeof(second), second},
+    };
+    ASSERT_TRUE(recording.Memory()->ReadBatch(ranges, nullptr));
+
+    ASSERT_TRUE(recording.trace().Write(&trace_file));
+  }
+
+  ASSERT_EQ(trace_file.Seek(0, SEEK_SET), 0);
+  PtraceConnectionTrace trace;
+  ASSERT_TRUE(trace.Read(&trace_file));
+
+  ReplayPtraceConnection replay;
+  replay.Initialize(&trace);
+  EXPECT_EQ(replay.GetProcessID(), getpid());
+  EXPECT_EQ(replay.Is64Bit(), sizeof(void*) == 8);
+
+  ThreadInfo info;
+  EXPECT_TRUE(replay.GetThreadInfo(getpid(), &info));
+  EXPECT_FALSE(replay.GetThreadInfo(getpid() + 1, &info));
+
+  // Files are served in the order they were read, and then repeat.
+  std::string contents;
+  ASSERT_TRUE(replay.ReadFileContents(path, &contents));
+  EXPECT_EQ(contents, "one");
+  ASSERT_TRUE(replay.ReadFileContents(path, &contents));
+  EXPECT_EQ(contents, "two");
+  ASSERT_TRUE(replay.ReadFileContents(path, &contents));
+  EXPECT_EQ(contents, "two");
+  EXPECT_FALSE(
+      replay.ReadFileContents(temp_dir.path().Append("other"), &contents));
+
+  std::string string;
+  ASSERT_TRUE(replay.Memory()->ReadCStringSizeLimited(
+      FromPointerCast<VMAddress>(kString), sizeof(kString), &string));
+  EXPECT_EQ(string, kString);
+
+  char first[sizeof(kFirst)] = {};
+  char second[sizeof(kSecond)] = {};
+  std::vector<ProcessMemory::ReadRange> ranges = {
+      {FromPointerCast<VMAddress>(kFirst), sizeof(first), first},
+      {FromPointerCast<VMAddress>(kSecond), sizeof(second), second},
+  };
+  ASSERT_TRUE(replay.Memory()->ReadBatch(ranges, nullptr));
+  EXPECT_STREQ(first, kFirst);
+  EXPECT_STREQ(second, kSecond);
+
+  // Memory that wasn't read while recording can't be read.
+  static constexpr char kUnread[] = "unread";
+  char unread[sizeof(kUnread)];
+  EXPECT_FALSE(replay.Memory()->Read(
+      FromPointerCast<VMAddress>(kUnread), sizeof(unread), unread));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
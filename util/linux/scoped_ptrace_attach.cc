@@ -14,6 +14,7 @@
 
 #include "util/linux/scoped_ptrace_attach.h"
 
+#include <errno.h>
 #include <sys/ptrace.h>
 #include <sys/wait.h>
 
@@ -40,6 +41,65 @@ bool PtraceAttach(pid_t pid, bool can_log) {
   return true;
 }
 
+size_t PtraceSeizeThreads(const pid_t* tids,
+                          size_t count,
+                          bool* attached,
+                          bool can_log) {
+  // Seize and interrupt every thread before waiting for any of them, so that
+  // the threads stop concurrently. attached tracks which threads have been
+  // seized until the waits confirm that they've stopped.
+  size_t seized_end = 0;
+  for (; seized_end < count; ++seized_end) {
+    const pid_t tid = tids[seized_end];
+    attached[seized_end] = false;
+    if (ptrace(PTRACE_SEIZE, tid, nullptr, nullptr) != 0) {
+      // Kernels that predate PTRACE_SEIZE return EIO. The remaining threads
+      // are attached below.
+      if (errno == EIO) {
+        break;
+      }
+      PLOG_IF(ERROR, can_log && errno != ESRCH) << "ptrace";
+      continue;
+    }
+
+    if (ptrace(PTRACE_INTERRUPT, tid, nullptr, nullptr) != 0) {
+      PLOG_IF(ERROR, can_log && errno != ESRCH) << "ptrace";
+      PtraceDetach(tid, false);
+      continue;
+    }
+    attached[seized_end] = true;
+  }
+
+  size_t attached_count = 0;
+  for (size_t index = 0; index < seized_end; ++index) {
+    if (!attached[index]) {
+      continue;
+    }
+
+    int status;
+    if (HANDLE_EINTR(waitpid(tids[index], &status, __WALL)) < 0) {
+      PLOG_IF(ERROR, can_log) << "waitpid";
+      PtraceDetach(tids[index], false);
+      attached[index] = false;
+      continue;
+    }
+    if (!WIFSTOPPED(status)) {
+      // The thread exited before it stopped, leaving nothing to detach.
+      attached[index] = false;
+      continue;
+    }
+    ++attached_count;
+  }
+
+  for (size_t index = seized_end; index < count; ++index) {
+    attached[index] = PtraceAttach(tids[index], can_log);
+    if (attached[index]) {
+      ++attached_count;
+    }
+  }
+  return attached_count;
+}
+
 bool PtraceDetach(pid_t pid, bool can_log) {
   if (pid >= 0 && ptrace(PTRACE_DETACH, pid, nullptr, nullptr) != 0) {
     PLOG_IF(ERROR, can_log) << "ptrace";
@@ -74,4 +134,9 @@ bool ScopedPtraceAttach::ResetAttach(pid_t pid) {
   return true;
 }
 
+void ScopedPtraceAttach::ResetAttached(pid_t pid) {
+  Reset();
+  pid_ = pid;
+}
+
 }  // namespace crashpad
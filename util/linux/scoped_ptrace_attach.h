@@ -15,9 +15,9 @@
 #ifndef CRASHPAD_UTIL_LINUX_SCOPED_PTRACE_ATTACH_H_
 #define CRASHPAD_UTIL_LINUX_SCOPED_PTRACE_ATTACH_H_
 
+#include <stddef.h>
 #include <sys/types.h>
 
-
 namespace crashpad {
 
 //! \brief Attaches to the process with process ID \a pid and blocks until the
@@ -29,6 +29,30 @@ namespace crashpad {
 //!     can_log is `true`.
 bool PtraceAttach(pid_t pid, bool can_log = true);
 
+//! \brief Attaches to several threads at once and blocks until all of them
+//!     have stopped.
+//!
+//! Every thread is attached with `PTRACE_SEIZE` and then stopped with
+//! `PTRACE_INTERRUPT` before any of them is waited for, so the threads stop
+//! concurrently rather than one after another. If `PTRACE_SEIZE` isn't
+//! supported, as before Linux 3.4, a thread is attached with PtraceAttach()
+//! instead. Attached threads are detached with PtraceDetach().
+//!
+//! This function doesn't allocate memory, so that it may be used by a
+//! PtraceBroker.
+//!
+//! \param[in] tids The thread IDs of the threads to attach to.
+//! \param[in] count The number of elements in \a tids.
+//! \param[out] attached An array of \a count elements. Each element is set
+//!     to `true` if the corresponding thread was attached and is stopped, or
+//!     `false` if it wasn't attached, such as because it had exited.
+//! \param can_log Whether this function may log messages on failure.
+//! \return The number of threads attached.
+size_t PtraceSeizeThreads(const pid_t* tids,
+                          size_t count,
+                          bool* attached,
+                          bool can_log = true);
+
 //! \brief Detaches the process  with process ID \a pid. The process must
 //!     already be ptrace attached.
 //!
@@ -62,6 +86,11 @@ class ScopedPtraceAttach {
   //! \return `true` on success. `false` on failure, with a message logged.
   bool ResetAttach(pid_t pid);
 
+  //! \brief Detaches from any previously attached process and takes
+  //!     ownership of an existing attachment to the process with process ID
+  //!     \a pid, such as one made by PtraceSeizeThreads().
+  void ResetAttached(pid_t pid);
+
  private:
   pid_t pid_;
 };
@@ -18,6 +18,9 @@
 #include <sys/ptrace.h>
 #include <unistd.h>
 
+#include <iterator>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "test/errors.h"
 #include "test/multiprocess.h"
@@ -94,6 +97,55 @@ TEST(ScopedPtraceAttach, AttachChild) {
   test.Run();
 }
 
+class SeizeChildThreadsTest : public AttachTest {
+ public:
+  SeizeChildThreadsTest() : AttachTest() {}
+
+  SeizeChildThreadsTest(const SeizeChildThreadsTest&) = delete;
+  SeizeChildThreadsTest& operator=(const SeizeChildThreadsTest&) = delete;
+
+  ~SeizeChildThreadsTest() {}
+
+ private:
+  void MultiprocessParent() override {
+    // Wait for the child to set the parent as its ptracer.
+    char c;
+    CheckedReadFileExactly(ReadPipeHandle(), &c, sizeof(c));
+
+    pid_t pid = ChildPID();
+
+    // The second thread ID doesn't exist, and isn't attached.
+    const pid_t tids[] = {pid, std::numeric_limits<pid_t>::max()};
+    bool attached[std::size(tids)];
+    EXPECT_EQ(PtraceSeizeThreads(tids, std::size(tids), attached), 1u);
+    ASSERT_TRUE(attached[0]);
+    EXPECT_FALSE(attached[1]);
+
+    ScopedPtraceAttach attachment;
+    attachment.ResetAttached(pid);
+    EXPECT_EQ(ptrace(PTRACE_PEEKDATA, pid, &kWord, nullptr), kWord)
+        << ErrnoMessage("ptrace");
+    attachment.Reset();
+
+    ASSERT_EQ(ptrace(PTRACE_PEEKDATA, pid, &kWord, nullptr), -1);
+    EXPECT_EQ(errno, ESRCH) << ErrnoMessage("ptrace");
+  }
+
+  void MultiprocessChild() override {
+    ScopedPrSetPtracer set_ptracer(getppid(), /* may_log= */ true);
+
+    char c = '\0';
+    CheckedWriteFile(WritePipeHandle(), &c, sizeof(c));
+
+    CheckedReadFileAtEOF(ReadPipeHandle());
+  }
+};
+
+TEST(ScopedPtraceAttach, SeizeChildThreads) {
+  SeizeChildThreadsTest test;
+  test.Run();
+}
+
 class AttachToParentResetTest : public AttachTest {
  public:
   AttachToParentResetTest() : AttachTest() {}
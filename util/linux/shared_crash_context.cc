@@ -0,0 +1,265 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/shared_crash_context.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "util/misc/from_pointer_cast.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x43505343;  // 'CPSC'
+
+// The seals that a region must carry for the handler to read it. Once sealed
+// against writing and shrinking, its contents can neither change while they’re
+// read nor be cut short.
+constexpr int kRequiredSeals = F_SEAL_SHRINK | F_SEAL_WRITE;
+
+}  // namespace
+
+SharedCrashContext::SharedCrashContext()
+    : ranges_(),
+      data_(nullptr),
+      mapping_(/*can_log=*/false),
+      copy_(),
+      handle_() {}
+
+SharedCrashContext::~SharedCrashContext() = default;
+
+bool SharedCrashContext::Initialize() {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  ScopedFileHandle handle(LoggingOpenMemoryFileForReadAndWrite(
+      base::FilePath("crashpad_crash_context")));
+  if (!handle.is_valid()) {
+    return false;
+  }
+
+  if (fcntl(handle.get(), F_SETFD, FD_CLOEXEC) != 0) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+
+  if (HANDLE_EINTR(ftruncate(handle.get(), kSize)) != 0) {
+    PLOG(ERROR) << "ftruncate";
+    return false;
+  }
+
+  // Files created by the fallbacks in LoggingOpenMemoryFileForReadAndWrite()
+  // can’t be sealed, and so would never be accepted by the handler.
+  if (HANDLE_EINTR(
+          fcntl(handle.get(), F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW)) != 0) {
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+
+  // mapping_ doesn’t log, so that Seal() may be called from a signal handler.
+  if (!mapping_.ResetMmap(nullptr,
+                          kSize,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED,
+                          handle.get(),
+                          0)) {
+    PLOG(ERROR) << "mmap";
+    return false;
+  }
+
+  handle_ = std::move(handle);
+  data_ = mapping_.addr_as<uint8_t*>();
+  header()->magic = kMagic;
+  header()->range_count = 0;
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+bool SharedCrashContext::InitializeFromHandle(int handle) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+
+  // The handle comes from the client, so nothing is read from it until it’s
+  // known to be a sealed memory file of the expected size.
+  struct stat st;
+  if (fstat(handle, &st) != 0) {
+    PLOG(ERROR) << "fstat";
+    return false;
+  }
+  if (!S_ISREG(st.st_mode)) {
+    LOG(ERROR) << "not a regular file";
+    return false;
+  }
+  const int seals = HANDLE_EINTR(fcntl(handle, F_GET_SEALS));
+  if (seals < 0) {
+    // Files that don’t support sealing fail with EINVAL.
+    PLOG(ERROR) << "fcntl";
+    return false;
+  }
+  if ((seals & kRequiredSeals) != kRequiredSeals) {
+    LOG(ERROR) << "not sealed";
+    return false;
+  }
+  if (st.st_size != static_cast<off_t>(kSize)) {
+    LOG(ERROR) << "bad size " << st.st_size;
+    return false;
+  }
+
+  copy_.reset(new uint8_t[kSize]);
+  ssize_t bytes_read = HANDLE_EINTR(pread(handle, copy_.get(), kSize, 0));
+  if (bytes_read < 0) {
+    PLOG(ERROR) << "pread";
+    return false;
+  }
+  if (static_cast<size_t>(bytes_read) != kSize) {
+    LOG(ERROR) << "short read";
+    return false;
+  }
+  data_ = copy_.get();
+
+  const Header* context_header = header();
+  if (context_header->magic != kMagic) {
+    LOG(ERROR) << "bad magic";
+    return false;
+  }
+  if (context_header->range_count > kMaxRanges) {
+    LOG(ERROR) << "bad range count " << context_header->range_count;
+    return false;
+  }
+
+  for (size_t index = 0; index < context_header->range_count; ++index) {
+    const Range& range = context_header->ranges[index];
+    if (range.offset < sizeof(Header) || range.offset > kSize ||
+        range.size > kSize - range.offset) {
+      LOG(ERROR) << "bad range";
+      return false;
+    }
+    ranges_.push_back(range);
+  }
+
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+int SharedCrashContext::Handle() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK(handle_.is_valid());
+  return handle_.get();
+}
+
+void SharedCrashContext::Reset() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (data_) {
+    header()->range_count = 0;
+  }
+}
+
+bool SharedCrashContext::AddRange(const void* address, size_t size) {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  if (!data_) {
+    return false;
+  }
+
+  Header* context_header = header();
+  const uint32_t count = context_header->range_count;
+  if (count >= kMaxRanges) {
+    return false;
+  }
+
+  size_t offset = sizeof(Header);
+  if (count > 0) {
+    const Range& last = context_header->ranges[count - 1];
+    offset = last.offset + last.size;
+  }
+  if (size > kSize - offset) {
+    return false;
+  }
+
+  memcpy(data_ + offset, address, size);
+  Range& range = context_header->ranges[count];
+  range.address = FromPointerCast<uint64_t>(address);
+  range.offset = static_cast<uint32_t>(offset);
+  range.size = static_cast<uint32_t>(size);
+  context_header->range_count = count + 1;
+  return true;
+}
+
+bool SharedCrashContext::Seal() {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK(handle_.is_valid());
+
+  // Writing can’t be sealed while a writable shared mapping exists.
+  if (data_) {
+    data_ = nullptr;
+    if (!mapping_.Reset()) {
+      return false;
+    }
+  }
+  return HANDLE_EINTR(fcntl(handle_.get(), F_ADD_SEALS, F_SEAL_WRITE)) == 0;
+}
+
+size_t SharedCrashContext::Read(VMAddress address,
+                                size_t size,
+                                void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  for (const Range& range : ranges_) {
+    if (address >= range.address && address - range.address < range.size) {
+      const size_t offset = static_cast<size_t>(address - range.address);
+      const size_t count = std::min(size, range.size - offset);
+      memcpy(buffer, data_ + range.offset + offset, count);
+      return count;
+    }
+  }
+  return 0;
+}
+
+SharedCrashContextMemory::SharedCrashContextMemory()
+    : ProcessMemory(), memory_(nullptr), context_(nullptr) {}
+
+SharedCrashContextMemory::~SharedCrashContextMemory() = default;
+
+bool SharedCrashContextMemory::Initialize(const ProcessMemory* memory,
+                                          const SharedCrashContext* context) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  memory_ = memory;
+  context_ = context;
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+ssize_t SharedCrashContextMemory::ReadUpTo(VMAddress address,
+                                           size_t size,
+                                           void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  size_t bytes_read = context_->Read(address, size, buffer);
+  if (bytes_read > 0) {
+    return bytes_read;
+  }
+  return memory_->ReadUpTo(address, size, buffer);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,187 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_LINUX_SHARED_CRASH_CONTEXT_H_
+#define CRASHPAD_UTIL_LINUX_SHARED_CRASH_CONTEXT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <vector>
+
+#include "util/file/file_io.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/posix/scoped_mmap.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+
+//! \brief A region of memory shared by a client with its handler, into which
+//!     the client copies the memory describing a crash before requesting a
+//!     dump.
+//!
+//! The client creates the region ahead of time with Initialize(). When it
+//! crashes, its signal handler copies the ExceptionInformation, `siginfo_t`,
+//! and `ucontext_t` into the region with AddRange(), seals it with Seal(), and
+//! sends Handle() along with its crash dump request. The handler reads the
+//! entire region with a single read in InitializeFromHandle(), and
+//! SharedCrashContextMemory then serves reads of the copied memory from it
+//! instead of from the client.
+//!
+//! A sealed region can’t be used again, so a client that continues running
+//! after a dump must create a new one for the next.
+class SharedCrashContext {
+ public:
+  //! \brief The size of the region.
+  static constexpr size_t kSize = 16 * 1024;
+
+  //! \brief The maximum number of ranges that may be copied into the region.
+  static constexpr size_t kMaxRanges = 8;
+
+  SharedCrashContext();
+
+  SharedCrashContext(const SharedCrashContext&) = delete;
+  SharedCrashContext& operator=(const SharedCrashContext&) = delete;
+
+  ~SharedCrashContext();
+
+  //! \brief Creates the region in a client.
+  //!
+  //! The region is a memory file sealed against changes to its size. This fails
+  //! where memory files can’t be sealed.
+  //!
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize();
+
+  //! \brief Reads the region from a handle received from a client.
+  //!
+  //! \a handle must refer to a memory file of #kSize bytes, sealed against
+  //! writing and shrinking as Seal() leaves it. Anything else is rejected
+  //! before it’s read, so that a client can’t make the handler wait on a pipe
+  //! or a file served by FUSE, or read a file of unexpected size. The contents
+  //! of the region are copied.
+  //!
+  //! \param[in] handle The client's handle to the region.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool InitializeFromHandle(int handle);
+
+  //! \brief Returns the handle to the region, to be sent to the handler.
+  //!
+  //! This method is only valid for objects initialized with Initialize().
+  int Handle() const;
+
+  //! \brief Discards all ranges copied into the region.
+  //!
+  //! This method is only valid for objects initialized with Initialize(). It
+  //! is async-signal-safe. It has no effect once Seal() has been called.
+  void Reset();
+
+  //! \brief Copies memory from this process into the region.
+  //!
+  //! This method is only valid for objects initialized with Initialize(). It
+  //! is async-signal-safe.
+  //!
+  //! \param[in] address The address of the memory to copy.
+  //! \param[in] size The number of bytes to copy.
+  //! \return `true` on success. `false` if the region has no room for the
+  //!     range, or Seal() has been called.
+  bool AddRange(const void* address, size_t size);
+
+  //! \brief Makes the region read-only, as InitializeFromHandle() requires.
+  //!
+  //! The region is unmapped from this process and sealed against writing, so
+  //! it can’t be changed again. This method is only valid for objects
+  //! initialized with Initialize(). It is async-signal-safe.
+  //!
+  //! \return `true` on success. `false` on failure, in which case the region
+  //!     can’t be used.
+  bool Seal();
+
+  //! \brief Copies memory out of the region.
+  //!
+  //! \param[in] address The address in the client of the memory to read.
+  //! \param[in] size The maximum number of bytes to read.
+  //! \param[out] buffer The buffer to copy the memory into.
+  //! \return The number of bytes copied, which may be less than \a size if
+  //!     \a address is near the end of a range, or `0` if \a address isn't in
+  //!     any range in the region.
+  size_t Read(VMAddress address, size_t size, void* buffer) const;
+
+ private:
+#pragma pack(push, 1)
+  struct Range {
+    uint64_t address;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  struct Header {
+    uint32_t magic;
+    uint32_t range_count;
+    Range ranges[kMaxRanges];
+  };
+#pragma pack(pop)
+
+  Header* header() const { return reinterpret_cast<Header*>(data_); }
+
+  // Ranges validated by InitializeFromHandle().
+  std::vector<Range> ranges_;
+
+  // In a client, this is the shared mapping, or nullptr once it has been
+  // sealed. In the handler, it is a copy.
+  uint8_t* data_;
+  ScopedMmap mapping_;
+  std::unique_ptr<uint8_t[]> copy_;
+  ScopedFileHandle handle_;
+  InitializationStateDcheck initialized_;
+};
+
+//! \brief Access to the memory of a client which serves reads of memory copied
+//!     into a SharedCrashContext from it, and all others from an underlying
+//!     ProcessMemory.
+class SharedCrashContextMemory final : public ProcessMemory {
+ public:
+  SharedCrashContextMemory();
+
+  SharedCrashContextMemory(const SharedCrashContextMemory&) = delete;
+  SharedCrashContextMemory& operator=(const SharedCrashContextMemory&) = delete;
+
+  ~SharedCrashContextMemory();
+
+  //! \brief Initializes this object.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] memory The memory object to read memory not in \a context
+  //!     from.
+  //! \param[in] context A SharedCrashContext received from the client.
+  //! \return `true` on success. `false` on failure with a message logged.
+  bool Initialize(const ProcessMemory* memory,
+                  const SharedCrashContext* context);
+
+ private:
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+
+  const ProcessMemory* memory_;  // weak
+  const SharedCrashContext* context_;  // weak
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_LINUX_SHARED_CRASH_CONTEXT_H_
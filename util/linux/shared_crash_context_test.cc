@@ -0,0 +1,177 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/linux/shared_crash_context.h"
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <iterator>
+#include <memory>
+
+#include "base/files/file_path.h"
+#include "gtest/gtest.h"
+#include "test/errors.h"
+#include "test/linux/fake_ptrace_connection.h"
+#include "test/process_type.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory_linux.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(SharedCrashContext, ReadsCopiedMemory) {
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+
+  uint32_t values[8];
+  for (size_t index = 0; index < std::size(values); ++index) {
+    values[index] = static_cast<uint32_t>(index);
+  }
+  uint64_t other = 1;
+
+  SharedCrashContext client_context;
+  ASSERT_TRUE(client_context.Initialize());
+  ASSERT_TRUE(client_context.AddRange(values, sizeof(values[0]) * 4));
+  ASSERT_TRUE(client_context.AddRange(&other, sizeof(other)));
+  ASSERT_TRUE(client_context.Seal());
+
+  // Changes made after the copies are not seen through the region.
+  for (size_t index = 0; index < std::size(values); ++index) {
+    values[index] += 100;
+  }
+  other = 2;
+
+  SharedCrashContext handler_context;
+  ASSERT_TRUE(handler_context.InitializeFromHandle(client_context.Handle()));
+
+  SharedCrashContextMemory context_memory;
+  ASSERT_TRUE(context_memory.Initialize(&memory, &handler_context));
+
+  uint32_t read_values[8];
+  ASSERT_TRUE(context_memory.Read(
+      FromPointerCast<VMAddress>(values), sizeof(read_values), read_values));
+  for (size_t index = 0; index < std::size(read_values); ++index) {
+    EXPECT_EQ(read_values[index], index < 4 ? index : index + 100);
+  }
+
+  uint64_t read_other;
+  ASSERT_TRUE(context_memory.Read(
+      FromPointerCast<VMAddress>(&other), sizeof(read_other), &read_other));
+  EXPECT_EQ(read_other, 1u);
+
+  // A sealed region can’t be changed.
+  EXPECT_FALSE(client_context.AddRange(&other, sizeof(other)));
+  client_context.Reset();
+  SharedCrashContext reread_context;
+  ASSERT_TRUE(reread_context.InitializeFromHandle(client_context.Handle()));
+  EXPECT_EQ(reread_context.Read(
+                FromPointerCast<VMAddress>(&other), sizeof(read_other),
+                &read_other),
+            sizeof(read_other));
+
+  SharedCrashContext empty_client_context;
+  ASSERT_TRUE(empty_client_context.Initialize());
+  ASSERT_TRUE(empty_client_context.AddRange(&other, sizeof(other)));
+  empty_client_context.Reset();
+  ASSERT_TRUE(empty_client_context.Seal());
+  SharedCrashContext empty_context;
+  ASSERT_TRUE(
+      empty_context.InitializeFromHandle(empty_client_context.Handle()));
+  EXPECT_EQ(empty_context.Read(
+                FromPointerCast<VMAddress>(&other), sizeof(read_other),
+                &read_other),
+            0u);
+}
+
+TEST(SharedCrashContext, RejectsRangesThatDontFit) {
+  SharedCrashContext context;
+  ASSERT_TRUE(context.Initialize());
+
+  auto large = std::make_unique<uint8_t[]>(SharedCrashContext::kSize);
+  EXPECT_FALSE(context.AddRange(large.get(), SharedCrashContext::kSize));
+
+  uint8_t value = 0;
+  for (size_t index = 0; index < SharedCrashContext::kMaxRanges; ++index) {
+    EXPECT_TRUE(context.AddRange(&value, sizeof(value)));
+  }
+  EXPECT_FALSE(context.AddRange(&value, sizeof(value)));
+}
+
+TEST(SharedCrashContext, RejectsBadHandle) {
+  ScopedFileHandle handle(LoggingOpenMemoryFileForReadAndWrite(
+      base::FilePath("crashpad_test")));
+  ASSERT_TRUE(handle.is_valid());
+
+  auto zeroes = std::make_unique<uint8_t[]>(SharedCrashContext::kSize);
+  ASSERT_TRUE(LoggingWriteFile(
+      handle.get(), zeroes.get(), SharedCrashContext::kSize));
+  ASSERT_TRUE(LoggingSealMemoryFile(handle.get()));
+  SharedCrashContext no_magic;
+  EXPECT_FALSE(no_magic.InitializeFromHandle(handle.get()));
+}
+
+TEST(SharedCrashContext, RejectsUnsealedHandle) {
+  // The region is otherwise valid, but could still be changed by the client.
+  SharedCrashContext client_context;
+  ASSERT_TRUE(client_context.Initialize());
+  uint64_t value = 1;
+  ASSERT_TRUE(client_context.AddRange(&value, sizeof(value)));
+
+  SharedCrashContext context;
+  EXPECT_FALSE(context.InitializeFromHandle(client_context.Handle()));
+}
+
+TEST(SharedCrashContext, RejectsHandleOfWrongSize) {
+  ScopedFileHandle handle(LoggingOpenMemoryFileForReadAndWrite(
+      base::FilePath("crashpad_test")));
+  ASSERT_TRUE(handle.is_valid());
+
+  auto zeroes = std::make_unique<uint8_t[]>(SharedCrashContext::kSize * 2);
+  ASSERT_TRUE(LoggingWriteFile(
+      handle.get(), zeroes.get(), SharedCrashContext::kSize * 2));
+  ASSERT_TRUE(LoggingSealMemoryFile(handle.get()));
+  SharedCrashContext context;
+  EXPECT_FALSE(context.InitializeFromHandle(handle.get()));
+}
+
+TEST(SharedCrashContext, RejectsHandleThatIsntMemoryFile) {
+  // Reading from a pipe could block the handler.
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0) << ErrnoMessage("pipe");
+  ScopedFileHandle read_pipe(pipe_fds[0]);
+  ScopedFileHandle write_pipe(pipe_fds[1]);
+  SharedCrashContext from_pipe;
+  EXPECT_FALSE(from_pipe.InitializeFromHandle(read_pipe.get()));
+
+  // A regular file can’t be sealed, so its size could change while it’s read.
+  ScopedTempDir temp_dir;
+  const base::FilePath path = temp_dir.path().Append("context");
+  ScopedFileHandle file(LoggingOpenFileForReadAndWrite(
+      path, FileWriteMode::kCreateOrFail, FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(file.is_valid());
+  auto zeroes = std::make_unique<uint8_t[]>(SharedCrashContext::kSize);
+  ASSERT_TRUE(
+      LoggingWriteFile(file.get(), zeroes.get(), SharedCrashContext::kSize));
+  SharedCrashContext from_file;
+  EXPECT_FALSE(from_file.InitializeFromHandle(file.get()));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
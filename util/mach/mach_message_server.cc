@@ -164,11 +164,17 @@ mach_msg_return_t MachMessageServer::Run(Interface* interface,
   do {
     retry = false;
 
+    // Once a request has been handled, kDrain only takes requests that are
+    // already queued.
+    const bool draining = persistent == kDrain && received_any_request;
+    const MachMessageDeadline receive_deadline =
+        draining ? kMachMessageDeadlineNonblocking : deadline;
+
     kr = MachMessageAllocateReceive(&request,
                                     options,
                                     request_size,
                                     receive_port,
-                                    deadline,
+                                    receive_deadline,
                                     MACH_PORT_NULL,
                                     !received_any_request);
     if (kr == MACH_RCV_TOO_LARGE) {
@@ -196,7 +202,7 @@ mach_msg_return_t MachMessageServer::Run(Interface* interface,
                                           options & ~MACH_RCV_LARGE,
                                           this_request_size,
                                           receive_port,
-                                          deadline,
+                                          receive_deadline,
                                           MACH_PORT_NULL,
                                           !received_any_request);
 
@@ -206,6 +212,10 @@ mach_msg_return_t MachMessageServer::Run(Interface* interface,
     }
 
     if (kr != MACH_MSG_SUCCESS) {
+      if (draining && kr == MACH_RCV_TIMED_OUT) {
+        // The queue is empty.
+        return MACH_MSG_SUCCESS;
+      }
       return kr;
     }
 
@@ -274,7 +284,7 @@ mach_msg_return_t MachMessageServer::Run(Interface* interface,
         return kr;
       }
     }
-  } while (persistent == kPersistent || retry);
+  } while (persistent != kOneShot || retry);
 
   return kr;
 }
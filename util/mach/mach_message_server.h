@@ -96,6 +96,16 @@ class MachMessageServer {
     //! \brief Run in a loop, potentially handling multiple request-reply
     //!     transactions.
     kPersistent,
+
+    //! \brief Handle a single request-reply transaction, then handle any
+    //!     further requests that are already queued without waiting for more,
+    //!     and then return.
+    //!
+    //! This suits callers that would otherwise call Run() with #kOneShot in a
+    //! loop in order to reevaluate a condition between messages. A burst of
+    //! queued requests is handled in one call, reusing the same request and
+    //! reply buffers, instead of allocating new buffers for each request.
+    kDrain,
   };
 
   //! \brief Determines how to handle the reception of messages larger than the
@@ -151,18 +161,22 @@ class MachMessageServer {
   //! \param[in] options Options suitable for mach_msg. For the defaults, use
   //!     `MACH_MSG_OPTION_NONE`. `MACH_RCV_LARGE` when specified here is
   //!     ignored. Set \a receive_large to #kReceiveLargeResize instead.
-  //! \param[in] persistent Chooses between one-shot and persistent operation.
+  //! \param[in] persistent Chooses between one-shot, persistent, and draining
+  //!     operation.
   //! \param[in] receive_large Determines the behavior upon encountering a
   //!     message larger than the receive buffer’s size.
   //! \param[in] timeout_ms The maximum duration that this entire function will
   //!     run, in milliseconds. This may be #kMachMessageTimeoutNonblocking or
   //!     #kMachMessageTimeoutWaitIndefinitely. When \a persistent is
   //!     #kPersistent, the timeout applies to the overall duration of this
-  //!     function, not to any individual `mach_msg()` call.
+  //!     function, not to any individual `mach_msg()` call. When \a persistent
+  //!     is #kDrain, the timeout applies to waiting for the first request.
   //!
-  //! \return On success, `MACH_MSG_SUCCESS` (when \a persistent is #kOneShot)
-  //!     or `MACH_RCV_TIMED_OUT` (when \a persistent is #kOneShot and \a
-  //!     timeout_ms is not #kMachMessageTimeoutWaitIndefinitely). This function
+  //! \return On success, `MACH_MSG_SUCCESS` (when \a persistent is #kOneShot
+  //!     or #kDrain) or `MACH_RCV_TIMED_OUT` (when \a persistent is #kOneShot
+  //!     or #kDrain and no request arrived, or when \a persistent is
+  //!     #kPersistent and \a timeout_ms is not
+  //!     #kMachMessageTimeoutWaitIndefinitely). This function
   //!     has no successful return value when \a persistent is #kPersistent and
   //!     \a timeout_ms is #kMachMessageTimeoutWaitIndefinitely. On failure,
   //!     returns a value identifying the nature of the error. A request
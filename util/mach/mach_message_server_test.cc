@@ -706,6 +706,28 @@ TEST(MachMessageServer, PersistentNonblockingFourMessages) {
   test_mach_message_server.Test();
 }
 
+TEST(MachMessageServer, DrainFourMessages) {
+  // The client sends several messages to the server and then signals the server
+  // that it’s safe to start waiting for them. The server waits for the first in
+  // draining mode, then handles the rest because they’re already queued, and
+  // returns success once the queue is empty. See
+  // PersistentNonblockingFourMessages for the considerations that apply to the
+  // queue length.
+  constexpr size_t kTransactionCount = 4;
+  static_assert(kTransactionCount <= MACH_PORT_QLIMIT_DEFAULT,
+                "must not exceed queue limit");
+
+  TestMachMessageServer::Options options;
+  options.parent_wait_for_child_pipe = true;
+  options.server_persistent = MachMessageServer::kDrain;
+  options.expect_server_transaction_count = kTransactionCount;
+  options.child_wait_for_parent_pipe_early = true;
+  options.client_send_request_count = kTransactionCount;
+  options.child_send_all_requests_before_receiving_any_replies = true;
+  TestMachMessageServer test_mach_message_server(options);
+  test_mach_message_server.Test();
+}
+
 TEST(MachMessageServer, ReturnCodeInvalidArgument) {
   // This tests that the mig_reply_error_t::RetCode field is properly returned
   // to the client.
@@ -0,0 +1,250 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/capture_timings.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <iterator>
+
+#include "base/check.h"
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "util/misc/clock.h"
+#include "util/misc/metrics.h"
+#include "util/misc/trace_event.h"
+#include "util/process/process_memory.h"
+
+#if BUILDFLAG(IS_POSIX)
+#include <time.h>
+
+#include "util/misc/time.h"
+#endif  // BUILDFLAG(IS_POSIX)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "base/files/file_path.h"
+#include "util/file/file_io.h"
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define CRASHPAD_HAVE_MALLINFO2 1
+#endif
+
+namespace crashpad {
+
+namespace {
+
+constexpr const char* kCapturePhaseNames[] = {
+    "Threads",
+    "Modules",
+    "MemoryMaps",
+    "Annotations",
+    "IndirectMemory",
+    "Sanitization",
+    "Write",
+    "Database",
+};
+static_assert(std::size(kCapturePhaseNames) ==
+                  static_cast<size_t>(CapturePhase::kMaxValue),
+              "kCapturePhaseNames size");
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Reads the calling thread's I/O accounting. The read() that does so isn't
+// counted in the values it returns. Returns false if the kernel doesn't
+// provide them.
+bool ReadThreadIOCounts(uint64_t* syscalls, uint64_t* bytes_written) {
+  ScopedFileHandle handle(
+      OpenFileForRead(base::FilePath("/proc/thread-self/io")));
+  if (!handle.is_valid()) {
+    return false;
+  }
+  char buffer[512];
+  const FileOperationResult size =
+      ReadFile(handle.get(), buffer, sizeof(buffer) - 1);
+  if (size <= 0) {
+    return false;
+  }
+  buffer[size] = '\0';
+
+  unsigned long long rchar, wchar, syscr, syscw;
+  if (sscanf(buffer,
+             "rchar: %llu\nwchar: %llu\nsyscr: %llu\nsyscw: %llu",
+             &rchar,
+             &wchar,
+             &syscr,
+             &syscw) != 4) {
+    return false;
+  }
+  *syscalls = syscr + syscw;
+  *bytes_written = wchar;
+  return true;
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+// Sets the fields of |usage| that are only recorded when profiling to the
+// calling thread's totals so far, or the process' for the heap. Fields that
+// can't be measured are left unchanged.
+void SampleResourceUsage(CaptureTimings::Phase* usage) {
+#if BUILDFLAG(IS_POSIX)
+  timespec cpu_time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) == 0) {
+    usage->cpu_time_ns = cpu_time.tv_sec * kNanosecondsPerSecond +
+                         cpu_time.tv_nsec;
+  }
+#endif  // BUILDFLAG(IS_POSIX)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  ReadThreadIOCounts(&usage->syscalls, &usage->bytes_written);
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
+#if defined(CRASHPAD_HAVE_MALLINFO2)
+  // Large allocations are mapped separately from the heap's arenas.
+  const struct mallinfo2 info = mallinfo2();
+  usage->heap_bytes = static_cast<int64_t>(info.uordblks + info.hblkhd);
+#endif  // CRASHPAD_HAVE_MALLINFO2
+}
+
+void AppendField(const char* name, uint64_t value, std::string* json) {
+  base::StringAppendF(json, "\"%s\":%" PRIu64, name, value);
+}
+
+}  // namespace
+
+const char* CapturePhaseName(CapturePhase phase) {
+  DCHECK(phase < CapturePhase::kMaxValue);
+  return kCapturePhaseNames[static_cast<int32_t>(phase)];
+}
+
+CaptureTimings::CaptureTimings() : phases_(), profiling_(false) {}
+
+CaptureTimings::~CaptureTimings() = default;
+
+void CaptureTimings::Add(CapturePhase phase,
+                         uint64_t duration_ns,
+                         uint64_t bytes_read) {
+  DCHECK(phase < CapturePhase::kMaxValue);
+  Phase& entry = phases_[static_cast<int32_t>(phase)];
+  entry.duration_ns += duration_ns;
+  entry.bytes_read += bytes_read;
+}
+
+void CaptureTimings::Add(CapturePhase phase, const Phase& cost) {
+  DCHECK(phase < CapturePhase::kMaxValue);
+  Phase& entry = phases_[static_cast<int32_t>(phase)];
+  entry.duration_ns += cost.duration_ns;
+  entry.bytes_read += cost.bytes_read;
+  entry.cpu_time_ns += cost.cpu_time_ns;
+  entry.syscalls += cost.syscalls;
+  entry.bytes_written += cost.bytes_written;
+  entry.heap_bytes += cost.heap_bytes;
+}
+
+void CaptureTimings::Add(const CaptureTimings& other) {
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CapturePhase::kMaxValue);
+       ++index) {
+    Add(static_cast<CapturePhase>(index), other.phases_[index]);
+  }
+}
+
+const CaptureTimings::Phase& CaptureTimings::Get(CapturePhase phase) const {
+  DCHECK(phase < CapturePhase::kMaxValue);
+  return phases_[static_cast<int32_t>(phase)];
+}
+
+void CaptureTimings::ReportMetrics() const {
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CapturePhase::kMaxValue);
+       ++index) {
+    Metrics::CapturePhaseCompleted(static_cast<CapturePhase>(index),
+                                   phases_[index].duration_ns,
+                                   phases_[index].bytes_read);
+  }
+}
+
+std::string CaptureTimings::ToJSON() const {
+  std::string json("{");
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CapturePhase::kMaxValue);
+       ++index) {
+    if (index != 0) {
+      json.push_back(',');
+    }
+    const Phase& phase = phases_[index];
+    base::StringAppendF(&json,
+                        "\"%s\":{",
+                        CapturePhaseName(static_cast<CapturePhase>(index)));
+    AppendField("duration_ns", phase.duration_ns, &json);
+    json.push_back(',');
+    AppendField("cpu_time_ns", phase.cpu_time_ns, &json);
+    json.push_back(',');
+    AppendField("bytes_read", phase.bytes_read, &json);
+    json.push_back(',');
+    AppendField("bytes_written", phase.bytes_written, &json);
+    json.push_back(',');
+    AppendField("syscalls", phase.syscalls, &json);
+    base::StringAppendF(
+        &json, ",\"heap_bytes\":%" PRId64 "}", phase.heap_bytes);
+  }
+  json.push_back('}');
+  return json;
+}
+
+ScopedCapturePhase::ScopedCapturePhase(CaptureTimings* timings,
+                                       CapturePhase phase,
+                                       const ProcessMemory* memory)
+    : timings_(timings),
+      memory_(memory),
+      start_ns_(timings ? ClockMonotonicNanoseconds() : 0),
+      start_bytes_read_(timings && memory ? memory->BytesRead() : 0),
+      start_usage_(),
+      phase_(phase) {
+  if (timings_ && timings_->profiling()) {
+    SampleResourceUsage(&start_usage_);
+  }
+}
+
+ScopedCapturePhase::~ScopedCapturePhase() {
+  if (!timings_) {
+    return;
+  }
+  const uint64_t duration_ns = ClockMonotonicNanoseconds() - start_ns_;
+  CaptureTimings::Phase cost = {};
+  cost.duration_ns = duration_ns;
+  cost.bytes_read = memory_ ? memory_->BytesRead() - start_bytes_read_ : 0;
+  if (timings_->profiling()) {
+    CaptureTimings::Phase end_usage = start_usage_;
+    SampleResourceUsage(&end_usage);
+    cost.cpu_time_ns = end_usage.cpu_time_ns - start_usage_.cpu_time_ns;
+    // The read() that sampled start_usage_ is counted in the difference.
+    cost.syscalls = end_usage.syscalls > start_usage_.syscalls
+                        ? end_usage.syscalls - start_usage_.syscalls - 1
+                        : 0;
+    cost.bytes_written = end_usage.bytes_written - start_usage_.bytes_written;
+    cost.heap_bytes = end_usage.heap_bytes - start_usage_.heap_bytes;
+  }
+  timings_->Add(phase_, cost);
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS)
+  TraceLog::Get()->AddCompleteEvent(
+      "capture", CapturePhaseName(phase_), start_ns_, duration_ns);
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS
+}
+
+}  // namespace crashpad
@@ -0,0 +1,186 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_CAPTURE_TIMINGS_H_
+#define CRASHPAD_UTIL_MISC_CAPTURE_TIMINGS_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace crashpad {
+
+class ProcessMemory;
+
+//! \brief The phases of capturing a crash report whose cost is tracked by
+//!     CaptureTimings.
+//!
+//! \note These are used as metrics enumeration values and are stored in
+//!     minidump files, so new values should always be added at the end, before
+//!     CapturePhase::kMaxValue.
+enum class CapturePhase : int32_t {
+  //! \brief Reading the target process' threads and their contexts.
+  kThreads = 0,
+
+  //! \brief Reading the target process' modules and their CrashpadInfo.
+  kModules = 1,
+
+  //! \brief Reading the target process' memory map.
+  kMemoryMaps = 2,
+
+  //! \brief Reading process-level annotations from the target process.
+  kAnnotations = 3,
+
+  //! \brief Locating memory referenced by thread and exception contexts.
+  kIndirectMemory = 4,
+
+  //! \brief Preparing a sanitized view of the snapshot.
+  kSanitization = 5,
+
+  //! \brief Writing the minidump, including reading any memory it contains
+  //!     from the target process.
+  //!
+  //! Some snapshots defer locating memory referenced by thread contexts until
+  //! the minidump is written. That time is charged to both this phase and
+  //! CapturePhase::kIndirectMemory.
+  kWrite = 6,
+
+  //! \brief Creating the report in the crash report database, storing its
+  //!     metadata, and committing it.
+  kDatabase = 7,
+
+  //! \brief The number of values in this enumeration; not a valid value.
+  kMaxValue
+};
+
+//! \brief Returns the name of \a phase, such as `"Threads"` for
+//!     CapturePhase::kThreads.
+const char* CapturePhaseName(CapturePhase phase);
+
+//! \brief Accumulates the wall time spent and the number of bytes read from the
+//!     target process in each CapturePhase.
+//!
+//! When profiling is enabled with SetProfiling(), the resources used by the
+//! thread running each phase are accumulated too. Work that a phase hands to
+//! other threads isn't included.
+class CaptureTimings {
+ public:
+  //! \brief The cost of a single CapturePhase.
+  struct Phase {
+    //! \brief The wall time spent in the phase, in nanoseconds.
+    uint64_t duration_ns;
+
+    //! \brief The number of bytes read from the target process.
+    uint64_t bytes_read;
+
+    //! \brief The CPU time used in the phase, in nanoseconds. Only recorded
+    //!     when profiling on POSIX systems.
+    uint64_t cpu_time_ns;
+
+    //! \brief The number of `read()`- and `write()`-family system calls made
+    //!     in the phase, including those that read the target process. Only
+    //!     recorded when profiling on Linux, Chrome OS, and Android kernels
+    //!     with task I/O accounting.
+    uint64_t syscalls;
+
+    //! \brief The number of bytes passed to `write()`-family system calls in
+    //!     the phase. Writes queued with io_uring aren't counted. Recorded
+    //!     under the same conditions as #syscalls.
+    uint64_t bytes_written;
+
+    //! \brief The growth of the process' heap in the phase, in bytes, which
+    //!     is negative if the heap shrank. This covers every thread in the
+    //!     process, so it can include other threads' allocations. Only
+    //!     recorded when profiling with glibc.
+    int64_t heap_bytes;
+  };
+
+  CaptureTimings();
+
+  CaptureTimings(const CaptureTimings&) = delete;
+  CaptureTimings& operator=(const CaptureTimings&) = delete;
+
+  ~CaptureTimings();
+
+  //! \brief Sets whether ScopedCapturePhase records the resources, beyond
+  //!     wall time and bytes read, used in each phase. Measuring them costs
+  //!     several system calls per phase, so this is disabled by default.
+  void SetProfiling(bool enabled) { profiling_ = enabled; }
+
+  //! \brief Returns whether profiling is enabled. See SetProfiling().
+  bool profiling() const { return profiling_; }
+
+  //! \brief Adds \a duration_ns and \a bytes_read to the cost of \a phase.
+  void Add(CapturePhase phase, uint64_t duration_ns, uint64_t bytes_read);
+
+  //! \brief Adds each field of \a cost to the cost of \a phase.
+  void Add(CapturePhase phase, const Phase& cost);
+
+  //! \brief Adds the cost of each phase in \a other to the cost of the same
+  //!     phase in this object.
+  void Add(const CaptureTimings& other);
+
+  //! \brief Returns the accumulated cost of \a phase.
+  const Phase& Get(CapturePhase phase) const;
+
+  //! \brief Reports the cost of each phase through
+  //!     Metrics::CapturePhaseCompleted().
+  void ReportMetrics() const;
+
+  //! \brief Returns the cost of each phase as a JSON object, mapping each
+  //!     CapturePhaseName() to an object holding each field of its Phase.
+  std::string ToJSON() const;
+
+ private:
+  Phase phases_[static_cast<int32_t>(CapturePhase::kMaxValue)];
+  bool profiling_;
+};
+
+//! \brief Charges the time between construction and destruction, and the bytes
+//!     read from a ProcessMemory in that time, to a CapturePhase.
+//!
+//! When \a timings is profiling, see CaptureTimings::SetProfiling(), the
+//! other resources used by the calling thread in that time are charged too.
+//!
+//! When trace events are enabled, this also records a trace event in the
+//! `"capture"` category named by CapturePhaseName().
+class ScopedCapturePhase {
+ public:
+  //! \param[in] timings The object to charge the cost to. If `nullptr`, this
+  //!     object does nothing.
+  //! \param[in] phase The phase to charge the cost to.
+  //! \param[in] memory The memory of the target process, used to count the
+  //!     bytes read. May be `nullptr` if the phase doesn't read the target
+  //!     process' memory.
+  ScopedCapturePhase(CaptureTimings* timings,
+                     CapturePhase phase,
+                     const ProcessMemory* memory);
+
+  ScopedCapturePhase(const ScopedCapturePhase&) = delete;
+  ScopedCapturePhase& operator=(const ScopedCapturePhase&) = delete;
+
+  ~ScopedCapturePhase();
+
+ private:
+  CaptureTimings* timings_;  // weak
+  const ProcessMemory* memory_;  // weak
+  uint64_t start_ns_;
+  uint64_t start_bytes_read_;
+  CaptureTimings::Phase start_usage_;
+  CapturePhase phase_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_CAPTURE_TIMINGS_H_
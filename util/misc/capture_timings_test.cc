@@ -0,0 +1,215 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/capture_timings.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+
+#include "build/build_config.h"
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+#include "util/misc/address_sanitizer.h"
+#include "util/misc/clock.h"
+#include "util/misc/from_pointer_cast.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// Reads from the current process' address space.
+class SelfProcessMemory final : public ProcessMemory {
+ public:
+  SelfProcessMemory() = default;
+
+  SelfProcessMemory(const SelfProcessMemory&) = delete;
+  SelfProcessMemory& operator=(const SelfProcessMemory&) = delete;
+
+  ~SelfProcessMemory() override = default;
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    memcpy(buffer, reinterpret_cast<const void*>(address), size);
+    return size;
+  }
+};
+
+TEST(CaptureTimings, Add) {
+  CaptureTimings timings;
+  for (int32_t index = 0;
+       index < static_cast<int32_t>(CapturePhase::kMaxValue);
+       ++index) {
+    const CaptureTimings::Phase& phase =
+        timings.Get(static_cast<CapturePhase>(index));
+    EXPECT_EQ(phase.duration_ns, 0u);
+    EXPECT_EQ(phase.bytes_read, 0u);
+  }
+
+  timings.Add(CapturePhase::kModules, 10, 100);
+  timings.Add(CapturePhase::kModules, 5, 50);
+  timings.Add(CapturePhase::kWrite, 1, 2);
+
+  EXPECT_EQ(timings.Get(CapturePhase::kModules).duration_ns, 15u);
+  EXPECT_EQ(timings.Get(CapturePhase::kModules).bytes_read, 150u);
+  EXPECT_EQ(timings.Get(CapturePhase::kWrite).duration_ns, 1u);
+  EXPECT_EQ(timings.Get(CapturePhase::kWrite).bytes_read, 2u);
+  EXPECT_EQ(timings.Get(CapturePhase::kThreads).duration_ns, 0u);
+  EXPECT_EQ(timings.Get(CapturePhase::kThreads).bytes_read, 0u);
+}
+
+TEST(CaptureTimings, ScopedCapturePhase) {
+  SelfProcessMemory memory;
+  char source[32] = "capture timings";
+  char destination[sizeof(source)];
+
+  CaptureTimings timings;
+  {
+    ScopedCapturePhase phase(&timings, CapturePhase::kThreads, &memory);
+    ASSERT_TRUE(memory.Read(
+        FromPointerCast<VMAddress>(source), sizeof(source), destination));
+#if !BUILDFLAG(IS_WIN)  // No SleepNanoseconds implemented on Windows.
+    SleepNanoseconds(1);
+#endif  // !BUILDFLAG(IS_WIN)
+  }
+  EXPECT_EQ(memcmp(source, destination, sizeof(source)), 0);
+
+  const CaptureTimings::Phase& threads = timings.Get(CapturePhase::kThreads);
+  EXPECT_EQ(threads.bytes_read, sizeof(source));
+#if !BUILDFLAG(IS_WIN)
+  EXPECT_GT(threads.duration_ns, 0u);
+#endif  // !BUILDFLAG(IS_WIN)
+
+  // Reads outside of the phase aren't charged to it.
+  ASSERT_TRUE(memory.Read(
+      FromPointerCast<VMAddress>(source), sizeof(source), destination));
+  EXPECT_EQ(timings.Get(CapturePhase::kThreads).bytes_read, sizeof(source));
+
+  // A phase without a CaptureTimings does nothing.
+  ScopedCapturePhase ignored(nullptr, CapturePhase::kThreads, &memory);
+}
+
+TEST(CaptureTimings, AddTimings) {
+  CaptureTimings first;
+  first.Add(CapturePhase::kModules, 10, 100);
+  CaptureTimings::Phase cost = {};
+  cost.duration_ns = 1;
+  cost.cpu_time_ns = 2;
+  cost.syscalls = 3;
+  cost.bytes_written = 4;
+  cost.heap_bytes = -5;
+  first.Add(CapturePhase::kDatabase, cost);
+
+  CaptureTimings second;
+  second.Add(CapturePhase::kModules, 5, 50);
+  second.Add(first);
+
+  EXPECT_EQ(second.Get(CapturePhase::kModules).duration_ns, 15u);
+  EXPECT_EQ(second.Get(CapturePhase::kModules).bytes_read, 150u);
+  const CaptureTimings::Phase& database = second.Get(CapturePhase::kDatabase);
+  EXPECT_EQ(database.duration_ns, 1u);
+  EXPECT_EQ(database.bytes_read, 0u);
+  EXPECT_EQ(database.cpu_time_ns, 2u);
+  EXPECT_EQ(database.syscalls, 3u);
+  EXPECT_EQ(database.bytes_written, 4u);
+  EXPECT_EQ(database.heap_bytes, -5);
+}
+
+TEST(CaptureTimings, ToJSON) {
+  CaptureTimings timings;
+  CaptureTimings::Phase cost = {};
+  cost.duration_ns = 1;
+  cost.cpu_time_ns = 2;
+  cost.bytes_read = 3;
+  cost.bytes_written = 4;
+  cost.syscalls = 5;
+  cost.heap_bytes = -6;
+  timings.Add(CapturePhase::kWrite, cost);
+
+  const std::string json = timings.ToJSON();
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(json.back(), '}');
+  EXPECT_NE(json.find("\"Threads\":{\"duration_ns\":0,"), std::string::npos);
+  EXPECT_NE(json.find("\"Write\":{\"duration_ns\":1,\"cpu_time_ns\":2,"
+                      "\"bytes_read\":3,\"bytes_written\":4,\"syscalls\":5,"
+                      "\"heap_bytes\":-6}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"Database\":{"), std::string::npos);
+}
+
+TEST(CaptureTimings, Profiling) {
+  CaptureTimings timings;
+  EXPECT_FALSE(timings.profiling());
+
+  // Without profiling, only the wall time and bytes read are recorded.
+  {
+    ScopedCapturePhase phase(&timings, CapturePhase::kThreads, nullptr);
+    std::unique_ptr<char[]> allocation(new char[1024 * 1024]);
+    memset(allocation.get(), 1, 1024 * 1024);
+  }
+  EXPECT_EQ(timings.Get(CapturePhase::kThreads).cpu_time_ns, 0u);
+  EXPECT_EQ(timings.Get(CapturePhase::kThreads).heap_bytes, 0);
+
+  ScopedTempDir temp_dir;
+  ScopedFileHandle file(
+      LoggingOpenFileForWrite(temp_dir.path().Append("file"),
+                              FileWriteMode::kCreateOrFail,
+                              FilePermissions::kOwnerOnly));
+  ASSERT_TRUE(file.is_valid());
+
+  timings.SetProfiling(true);
+  EXPECT_TRUE(timings.profiling());
+  static constexpr char kData[] = "capture timings";
+  std::unique_ptr<char[]> allocation;
+  {
+    ScopedCapturePhase phase(&timings, CapturePhase::kDatabase, nullptr);
+    ASSERT_TRUE(LoggingWriteFile(file.get(), kData, sizeof(kData)));
+    ASSERT_TRUE(LoggingWriteFile(file.get(), kData, sizeof(kData)));
+    allocation.reset(new char[1024 * 1024]);
+    memset(allocation.get(), 1, 1024 * 1024);
+
+    // Spin until some CPU time is used.
+    const uint64_t start_ns = ClockMonotonicNanoseconds();
+    while (ClockMonotonicNanoseconds() - start_ns < 10000000) {
+    }
+  }
+
+  const CaptureTimings::Phase& database = timings.Get(CapturePhase::kDatabase);
+#if BUILDFLAG(IS_POSIX)
+  EXPECT_GT(database.cpu_time_ns, 0u);
+#endif  // BUILDFLAG(IS_POSIX)
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Task I/O accounting is optional, but when present it counts the two
+  // writes. Sanitizer runtimes may make system calls of their own.
+  if (database.syscalls != 0) {
+    EXPECT_GE(database.syscalls, 2u);
+    EXPECT_GE(database.bytes_written, 2 * sizeof(kData));
+  }
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+  // AddressSanitizer replaces the heap that glibc reports on.
+#if defined(__GLIBC__) && !defined(ADDRESS_SANITIZER) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  EXPECT_GE(database.heap_bytes, 1024 * 1024);
+#endif
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
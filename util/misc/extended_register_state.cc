@@ -0,0 +1,243 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/extended_register_state.h"
+
+#include <string.h>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+#if BUILDFLAG(IS_WIN) && defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+#include <intrin.h>
+#endif  // BUILDFLAG(IS_WIN) && ARCH_CPU_X86_FAMILY
+
+namespace crashpad {
+
+namespace {
+
+// The legacy region of an XSAVE area, holding x87 and SSE state, is followed by
+// the XSAVE header, which begins with XSTATE_BV.
+constexpr size_t kXSaveLegacyRegionSize = 512;
+constexpr size_t kXSaveHeaderSize = 64;
+
+// Components 0 and 1 are stored in the legacy region.
+constexpr uint32_t kXSaveFirstExtendedComponent = 2;
+
+constexpr size_t kComponentAlignment = 8;
+
+bool IsAllZero(const uint8_t* data, size_t size) {
+  for (size_t index = 0; index < size; ++index) {
+    if (data[index] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+void Cpuid(uint32_t cpuinfo[4], uint32_t leaf, uint32_t subleaf) {
+#if BUILDFLAG(IS_WIN)
+  __cpuidex(reinterpret_cast<int*>(cpuinfo), leaf, subleaf);
+#else
+  asm("cpuid"
+      : "=a"(cpuinfo[0]), "=b"(cpuinfo[1]), "=c"(cpuinfo[2]), "=d"(cpuinfo[3])
+      : "a"(leaf), "c"(subleaf));
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+uint64_t Xgetbv() {
+#if BUILDFLAG(IS_WIN)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  asm("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+bool GetNativeXSaveLayout(XSaveLayout* layout) {
+  uint32_t cpuinfo[4];
+  Cpuid(cpuinfo, 0, 0);
+  if (cpuinfo[0] < 0xd) {
+    return false;
+  }
+
+  // CPUID.1:ECX.OSXSAVE[bit 27] indicates that the operating system has
+  // enabled XSAVE, and that XGETBV may be used to read XCR0.
+  Cpuid(cpuinfo, 1, 0);
+  if (!(cpuinfo[2] & (1 << 27))) {
+    return false;
+  }
+
+  // XCR0 holds the components enabled for user mode.
+  const uint64_t xcr0 = Xgetbv();
+  for (uint32_t component = kXSaveFirstExtendedComponent;
+       component < layout->size();
+       ++component) {
+    if (!(xcr0 & (UINT64_C(1) << component))) {
+      continue;
+    }
+    Cpuid(cpuinfo, 0xd, component);
+    (*layout)[component].size = cpuinfo[0];
+    (*layout)[component].offset = cpuinfo[1];
+  }
+  return true;
+}
+
+#endif  // ARCH_CPU_X86_FAMILY
+
+}  // namespace
+
+#if defined(ARCH_CPU_X86_FAMILY)
+const XSaveLayout* NativeXSaveLayout() {
+  static const XSaveLayout* const layout = []() -> const XSaveLayout* {
+    XSaveLayout* native_layout = new XSaveLayout();
+    if (!GetNativeXSaveLayout(native_layout)) {
+      delete native_layout;
+      return nullptr;
+    }
+    return native_layout;
+  }();
+  return layout;
+}
+#endif  // ARCH_CPU_X86_FAMILY
+
+ExtendedRegisterState::ExtendedRegisterState()
+    : data_(), format_(Format::kNone), vector_length_(0) {}
+
+ExtendedRegisterState::ExtendedRegisterState(const ExtendedRegisterState&) =
+    default;
+
+ExtendedRegisterState& ExtendedRegisterState::operator=(
+    const ExtendedRegisterState&) = default;
+
+ExtendedRegisterState::~ExtendedRegisterState() = default;
+
+void ExtendedRegisterState::Reset(Format format, uint32_t vector_length) {
+  data_.clear();
+  format_ = format;
+  vector_length_ = vector_length;
+}
+
+void ExtendedRegisterState::AddComponent(uint32_t id,
+                                         const void* data,
+                                         size_t size) {
+  const uint8_t* data_c = static_cast<const uint8_t*>(data);
+  if (IsAllZero(data_c, size)) {
+    return;
+  }
+
+  Component component;
+  component.id = id;
+  component.size = static_cast<uint32_t>(size);
+  DCHECK_EQ(component.size, size);
+
+  const size_t offset = data_.size();
+  const size_t padded_size =
+      (size + kComponentAlignment - 1) & ~(kComponentAlignment - 1);
+  data_.resize(offset + sizeof(component) + padded_size);
+  memcpy(&data_[offset], &component, sizeof(component));
+  memcpy(&data_[offset + sizeof(component)], data_c, size);
+}
+
+bool ExtendedRegisterState::GetComponent(uint32_t id,
+                                         const uint8_t** data,
+                                         uint32_t* size) const {
+  size_t offset = 0;
+  while (data_.size() - offset >= sizeof(Component)) {
+    Component component;
+    memcpy(&component, &data_[offset], sizeof(component));
+    offset += sizeof(component);
+    if (component.size > data_.size() - offset) {
+      return false;
+    }
+    if (component.id == id) {
+      *data = &data_[offset];
+      *size = component.size;
+      return true;
+    }
+    const size_t padded_size =
+        (static_cast<size_t>(component.size) + kComponentAlignment - 1) &
+        ~(kComponentAlignment - 1);
+    if (padded_size > data_.size() - offset) {
+      return false;
+    }
+    offset += padded_size;
+  }
+  return false;
+}
+
+bool ExtendedRegisterState::InitializeFromXSave(const void* xsave,
+                                                size_t size,
+                                                const XSaveLayout& layout) {
+  Reset(Format::kX86XSave, 0);
+
+  if (size < kXSaveLegacyRegionSize + kXSaveHeaderSize) {
+    LOG(ERROR) << "xsave area too small " << size;
+    return false;
+  }
+
+  const uint8_t* xsave_c = static_cast<const uint8_t*>(xsave);
+  uint64_t xstate_bv;
+  memcpy(&xstate_bv, xsave_c + kXSaveLegacyRegionSize, sizeof(xstate_bv));
+
+  // A clear XSTATE_BV bit means that the component is in its initial state,
+  // and its contents in the XSAVE area may be stale.
+  for (uint32_t component = kXSaveFirstExtendedComponent;
+       component < layout.size();
+       ++component) {
+    const XSaveComponentLayout& component_layout = layout[component];
+    if (!(xstate_bv & (UINT64_C(1) << component)) ||
+        component_layout.size == 0 || component_layout.offset > size ||
+        component_layout.size > size - component_layout.offset) {
+      continue;
+    }
+    AddComponent(component,
+                 xsave_c + component_layout.offset,
+                 component_layout.size);
+  }
+  return true;
+}
+
+bool ExtendedRegisterState::InitializeFromSVE(uint32_t vector_length,
+                                              const void* registers,
+                                              size_t size) {
+  Reset(Format::kARM64SVE, vector_length);
+
+  // The architecture allows vector lengths of 128 to 2048 bits, in multiples
+  // of 128 bits.
+  if (vector_length == 0 || vector_length % 16 != 0 || vector_length > 256) {
+    LOG(ERROR) << "invalid SVE vector length " << vector_length;
+    return false;
+  }
+
+  const size_t z_size = 32 * vector_length;
+  const size_t p_size = 16 * (vector_length / 8);
+  const size_t ffr_size = vector_length / 8;
+  if (size < z_size + p_size + ffr_size) {
+    LOG(ERROR) << "SVE registers too small " << size;
+    return false;
+  }
+
+  const uint8_t* registers_c = static_cast<const uint8_t*>(registers);
+  AddComponent(kSVEComponentZ, registers_c, z_size);
+  AddComponent(kSVEComponentP, registers_c + z_size, p_size);
+  AddComponent(kSVEComponentFFR, registers_c + z_size + p_size, ffr_size);
+  return true;
+}
+
+}  // namespace crashpad
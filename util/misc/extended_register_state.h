@@ -0,0 +1,174 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_EXTENDED_REGISTER_STATE_H_
+#define CRASHPAD_UTIL_MISC_EXTENDED_REGISTER_STATE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "build/build_config.h"
+
+namespace crashpad {
+
+//! \brief The location of an XSAVE state component within the standard
+//!     (non-compacted) format of an XSAVE area.
+struct XSaveComponentLayout {
+  //! \brief The offset of the component from the start of the XSAVE area.
+  uint32_t offset;
+
+  //! \brief The size of the component, or `0` if it isn’t supported.
+  uint32_t size;
+};
+
+//! \brief The layout of each XSAVE state component that can be saved in user
+//!     mode, indexed by state component number.
+using XSaveLayout = std::array<XSaveComponentLayout, 32>;
+
+#if defined(ARCH_CPU_X86_FAMILY) || DOXYGEN
+//! \brief Returns the layout of the XSAVE area used by the current CPU, or
+//!     `nullptr` if the CPU or operating system doesn’t support `XSAVE`.
+//!
+//! The layout is determined by `CPUID` the first time this is called, and the
+//! same object is returned by every call.
+const XSaveLayout* NativeXSaveLayout();
+#endif  // ARCH_CPU_X86_FAMILY || DOXYGEN
+
+//! \brief A thread’s register state beyond what CPUContext carries, in a
+//!     compact encoding that omits components in their initial state.
+//!
+//! The encoding, data(), is a sequence of components in increasing order of
+//! Component::id. Each is a Component header followed by Component::size bytes
+//! of register data, padded with zeroes to a multiple of 8 bytes. Components
+//! whose registers all hold zero, which is the initial state of every
+//! component encoded here, are not present.
+class ExtendedRegisterState {
+ public:
+  //! \brief The architecture-specific register state that the components
+  //!     hold.
+  enum class Format : uint32_t {
+    //! \brief No extended register state was captured.
+    kNone = 0,
+
+    //! \brief x86 XSAVE state components.
+    //!
+    //! Component::id is the XSAVE state component number, such as `2` for the
+    //! upper halves of the AVX `ymm` registers, or `5` through `7` for AVX-512
+    //! state. Each component’s data is laid out as it is in the standard format
+    //! of an XSAVE area. Components `0` and `1`, the x87 and SSE state, are
+    //! carried in CPUContextX86::fxsave and CPUContextX86_64::fxsave instead,
+    //! and are never present.
+    kX86XSave = 1,
+
+    //! \brief ARM64 Scalable Vector Extension registers.
+    //!
+    //! Component::id is an SVEComponent value. vector_length() is the size of
+    //! each `z` register, in bytes. When this state is present, the low 128
+    //! bits of each `z` register supersede CPUContextARM64::fpsimd.
+    kARM64SVE = 2,
+  };
+
+  //! \brief The components of ExtendedRegisterState::Format::kARM64SVE state.
+  enum SVEComponent : uint32_t {
+    //! \brief The 32 `z` registers, each vector_length() bytes.
+    kSVEComponentZ = 0,
+
+    //! \brief The 16 `p` registers, each `vector_length() / 8` bytes.
+    kSVEComponentP = 1,
+
+    //! \brief The `ffr` register, `vector_length() / 8` bytes.
+    kSVEComponentFFR = 2,
+  };
+
+  //! \brief The header preceding each component in data().
+  struct Component {
+    //! \brief Identifies the component, with a meaning given by format().
+    uint32_t id;
+
+    //! \brief The size of the component’s register data, in bytes, not
+    //!     including any padding.
+    uint32_t size;
+  };
+
+  ExtendedRegisterState();
+  ExtendedRegisterState(const ExtendedRegisterState&);
+  ExtendedRegisterState& operator=(const ExtendedRegisterState&);
+  ~ExtendedRegisterState();
+
+  //! \brief Discards any components and sets the format and vector length.
+  void Reset(Format format, uint32_t vector_length);
+
+  //! \brief Appends a component, unless all of its register data is zero.
+  //!
+  //! Components must be added in increasing order of \a id.
+  void AddComponent(uint32_t id, const void* data, size_t size);
+
+  //! \brief Locates a component in data().
+  //!
+  //! \param[in] id The component to locate.
+  //! \param[out] data The component’s register data.
+  //! \param[out] size The size of \a data, in bytes.
+  //! \return `true` if the component is present, `false` if it is absent
+  //!     because it was in its initial state, or if data() is malformed.
+  bool GetComponent(uint32_t id, const uint8_t** data, uint32_t* size) const;
+
+  //! \brief Encodes XSAVE state.
+  //!
+  //! \param[in] xsave An XSAVE area in the standard format, as returned by
+  //!     `PTRACE_GETREGSET` with `NT_X86_XSTATE` or as found in a signal frame.
+  //! \param[in] size The size of \a xsave, in bytes.
+  //! \param[in] layout The layout of \a xsave.
+  //! \return `true` on success. `false` if \a xsave is too small to hold an
+  //!     XSAVE header, with a message logged.
+  bool InitializeFromXSave(const void* xsave,
+                           size_t size,
+                           const XSaveLayout& layout);
+
+  //! \brief Encodes SVE state.
+  //!
+  //! \param[in] vector_length The SVE vector length, in bytes.
+  //! \param[in] registers The `z`, `p`, and `ffr` registers, laid out as they
+  //!     are following `user_sve_header` for `PTRACE_GETREGSET` with
+  //!     `NT_ARM_SVE`, or following `sve_context` in a signal frame.
+  //! \param[in] size The size of \a registers, in bytes.
+  //! \return `true` on success. `false` if \a vector_length is invalid or \a
+  //!     registers is too small to hold it, with a message logged.
+  bool InitializeFromSVE(uint32_t vector_length,
+                         const void* registers,
+                         size_t size);
+
+  //! \brief The architecture-specific register state held by the components.
+  Format format() const { return format_; }
+
+  //! \brief The vector length, in bytes, for formats that have one, or `0`.
+  uint32_t vector_length() const { return vector_length_; }
+
+  //! \brief The encoded components.
+  const std::vector<uint8_t>& data() const { return data_; }
+
+  //! \brief `true` if no component is present.
+  bool empty() const { return data_.empty(); }
+
+ private:
+  std::vector<uint8_t> data_;
+  Format format_;
+  uint32_t vector_length_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_EXTENDED_REGISTER_STATE_H_
@@ -0,0 +1,178 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/extended_register_state.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+// A layout with AVX, the AVX-512 opmask registers, and PKRU, at the offsets
+// Intel processors use.
+XSaveLayout TestXSaveLayout() {
+  XSaveLayout layout = {};
+  layout[2] = {576, 256};
+  layout[5] = {1088, 64};
+  layout[9] = {2688, 8};
+  return layout;
+}
+
+void SetXStateBV(std::vector<uint8_t>* xsave, uint64_t xstate_bv) {
+  memcpy(&(*xsave)[512], &xstate_bv, sizeof(xstate_bv));
+}
+
+TEST(ExtendedRegisterState, Empty) {
+  ExtendedRegisterState state;
+  EXPECT_EQ(state.format(), ExtendedRegisterState::Format::kNone);
+  EXPECT_EQ(state.vector_length(), 0u);
+  EXPECT_TRUE(state.empty());
+
+  const uint8_t* data;
+  uint32_t size;
+  EXPECT_FALSE(state.GetComponent(0, &data, &size));
+}
+
+TEST(ExtendedRegisterState, AddComponent) {
+  ExtendedRegisterState state;
+  state.Reset(ExtendedRegisterState::Format::kX86XSave, 0);
+
+  static constexpr uint8_t kZeroes[16] = {};
+  static constexpr uint8_t kFirst[] = {1, 2, 3};
+  static constexpr uint8_t kSecond[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4};
+  state.AddComponent(1, kZeroes, sizeof(kZeroes));
+  state.AddComponent(2, kFirst, sizeof(kFirst));
+  state.AddComponent(3, kSecond, sizeof(kSecond));
+
+  // The component holding only zeroes is omitted, and each component is
+  // padded to a multiple of 8 bytes.
+  EXPECT_EQ(state.data().size(),
+            2 * sizeof(ExtendedRegisterState::Component) + 8 + 16);
+
+  const uint8_t* data;
+  uint32_t size;
+  EXPECT_FALSE(state.GetComponent(1, &data, &size));
+  ASSERT_TRUE(state.GetComponent(2, &data, &size));
+  ASSERT_EQ(size, sizeof(kFirst));
+  EXPECT_EQ(memcmp(data, kFirst, size), 0);
+  ASSERT_TRUE(state.GetComponent(3, &data, &size));
+  ASSERT_EQ(size, sizeof(kSecond));
+  EXPECT_EQ(memcmp(data, kSecond, size), 0);
+  EXPECT_FALSE(state.GetComponent(4, &data, &size));
+
+  state.Reset(ExtendedRegisterState::Format::kNone, 0);
+  EXPECT_TRUE(state.empty());
+}
+
+TEST(ExtendedRegisterState, XSave) {
+  const XSaveLayout layout = TestXSaveLayout();
+  std::vector<uint8_t> xsave(2696);
+
+  // AVX state is present, and PKRU is marked as modified but holds zero.
+  memset(&xsave[576], 0xa5, 256);
+  // The opmask registers hold stale data, but are in their initial state.
+  memset(&xsave[1088], 0x5a, 64);
+  SetXStateBV(&xsave, (1 << 0) | (1 << 1) | (1 << 2) | (1 << 9));
+
+  ExtendedRegisterState state;
+  ASSERT_TRUE(state.InitializeFromXSave(xsave.data(), xsave.size(), layout));
+  EXPECT_EQ(state.format(), ExtendedRegisterState::Format::kX86XSave);
+
+  const uint8_t* data;
+  uint32_t size;
+  ASSERT_TRUE(state.GetComponent(2, &data, &size));
+  ASSERT_EQ(size, 256u);
+  EXPECT_EQ(memcmp(data, &xsave[576], size), 0);
+  EXPECT_FALSE(state.GetComponent(5, &data, &size));
+  EXPECT_FALSE(state.GetComponent(9, &data, &size));
+  EXPECT_EQ(state.data().size(),
+            sizeof(ExtendedRegisterState::Component) + 256);
+
+  // Components that don’t fit in the XSAVE area are skipped.
+  SetXStateBV(&xsave, (1 << 2) | (1 << 5) | (1 << 9));
+  xsave[2688] = 1;
+  ASSERT_TRUE(state.InitializeFromXSave(xsave.data(), 2000, layout));
+  EXPECT_TRUE(state.GetComponent(2, &data, &size));
+  EXPECT_TRUE(state.GetComponent(5, &data, &size));
+  EXPECT_FALSE(state.GetComponent(9, &data, &size));
+
+  // Everything is in its initial state.
+  SetXStateBV(&xsave, 0);
+  ASSERT_TRUE(state.InitializeFromXSave(xsave.data(), xsave.size(), layout));
+  EXPECT_TRUE(state.empty());
+
+  EXPECT_FALSE(state.InitializeFromXSave(xsave.data(), 575, layout));
+}
+
+TEST(ExtendedRegisterState, SVE) {
+  constexpr uint32_t kVectorLength = 32;
+  constexpr size_t kZSize = 32 * kVectorLength;
+  constexpr size_t kPSize = 16 * kVectorLength / 8;
+  constexpr size_t kFFRSize = kVectorLength / 8;
+  std::vector<uint8_t> registers(kZSize + kPSize + kFFRSize);
+  for (size_t index = 0; index < kZSize; ++index) {
+    registers[index] = static_cast<uint8_t>(index);
+  }
+  registers[kZSize + kPSize] = 0xff;
+
+  ExtendedRegisterState state;
+  ASSERT_TRUE(state.InitializeFromSVE(
+      kVectorLength, registers.data(), registers.size()));
+  EXPECT_EQ(state.format(), ExtendedRegisterState::Format::kARM64SVE);
+  EXPECT_EQ(state.vector_length(), kVectorLength);
+
+  const uint8_t* data;
+  uint32_t size;
+  ASSERT_TRUE(
+      state.GetComponent(ExtendedRegisterState::kSVEComponentZ, &data, &size));
+  ASSERT_EQ(size, kZSize);
+  EXPECT_EQ(memcmp(data, registers.data(), size), 0);
+  EXPECT_FALSE(
+      state.GetComponent(ExtendedRegisterState::kSVEComponentP, &data, &size));
+  ASSERT_TRUE(state.GetComponent(
+      ExtendedRegisterState::kSVEComponentFFR, &data, &size));
+  ASSERT_EQ(size, kFFRSize);
+  EXPECT_EQ(data[0], 0xff);
+
+  EXPECT_FALSE(state.InitializeFromSVE(
+      kVectorLength, registers.data(), registers.size() - 1));
+  EXPECT_FALSE(state.InitializeFromSVE(24, registers.data(), registers.size()));
+  EXPECT_FALSE(state.InitializeFromSVE(0, registers.data(), registers.size()));
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+TEST(ExtendedRegisterState, NativeXSaveLayout) {
+  const XSaveLayout* layout = NativeXSaveLayout();
+  if (!layout) {
+    GTEST_SKIP();
+  }
+  EXPECT_EQ(NativeXSaveLayout(), layout);
+
+  // Every extended component lies beyond the legacy region and XSAVE header.
+  for (const XSaveComponentLayout& component : *layout) {
+    if (component.size != 0) {
+      EXPECT_GE(component.offset, 576u);
+    }
+  }
+}
+#endif  // ARCH_CPU_X86_FAMILY
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
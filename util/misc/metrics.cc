@@ -18,6 +18,8 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/numerics/safe_conversions.h"
 #include "build/build_config.h"
+#include "util/misc/clock.h"
+#include "util/misc/statistics.h"
 
 #if BUILDFLAG(IS_APPLE)
 #define METRICS_OS_NAME "Mac"
@@ -56,16 +58,137 @@ void ExceptionProcessing(ExceptionProcessingState state) {
                             ExceptionProcessingState::kMaxValue);
 }
 
+// The times at which the exception being handled on this thread was
+// encountered and began to be captured, or 0. A handler captures each exception
+// on a single thread, so these pair the start of a capture with its end even
+// while other threads capture other exceptions.
+thread_local uint64_t exception_encountered_ns;
+thread_local uint64_t exception_capture_started_ns;
+
+void CaptureIntervalCompleted(Metrics::CaptureInterval interval,
+                              uint64_t duration_ns) {
+  Statistics::Get()->CaptureIntervalCompleted(interval, duration_ns);
+
+  const uint32_t duration_ms =
+      base::saturated_cast<uint32_t>(duration_ns / 1000000);
+  switch (interval) {
+    case Metrics::CaptureInterval::kStartDelay:
+      UMA_HISTOGRAM_CUSTOM_COUNTS(
+          "Crashpad.ExceptionCapture.StartDelay." METRICS_OS_NAME,
+          duration_ms,
+          1,
+          60000,
+          50);
+      break;
+    case Metrics::CaptureInterval::kCapture:
+      UMA_HISTOGRAM_CUSTOM_COUNTS(
+          "Crashpad.ExceptionCapture.Duration." METRICS_OS_NAME,
+          duration_ms,
+          1,
+          60000,
+          50);
+      break;
+    case Metrics::CaptureInterval::kWrite:
+      UMA_HISTOGRAM_CUSTOM_COUNTS(
+          "Crashpad.ExceptionCapture.WriteDuration." METRICS_OS_NAME,
+          duration_ms,
+          1,
+          60000,
+          50);
+      break;
+    case Metrics::CaptureInterval::kMaxValue:
+      break;
+  }
+}
+
 }  // namespace
 
+// static
+void Metrics::CapturePhaseCompleted(CapturePhase phase,
+                                    uint64_t duration_ns,
+                                    uint64_t bytes_read) {
+  Statistics::Get()->CapturePhaseCompleted(phase, duration_ns, bytes_read);
+
+  const uint32_t duration_ms =
+      base::saturated_cast<uint32_t>(duration_ns / 1000000);
+  const uint32_t kilobytes_read =
+      base::saturated_cast<uint32_t>(bytes_read / 1024);
+
+  // Each histogram macro invocation must use a constant name.
+#define CAPTURE_PHASE_HISTOGRAMS(name)                         \
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.CapturePhase." name    \
+                              ".Duration",                     \
+                              duration_ms,                     \
+                              1,                               \
+                              60000,                           \
+                              50);                             \
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.CapturePhase." name    \
+                              ".KBRead",                       \
+                              kilobytes_read,                  \
+                              1,                               \
+                              1024 * 1024,                     \
+                              50)
+
+  switch (phase) {
+    case CapturePhase::kThreads:
+      CAPTURE_PHASE_HISTOGRAMS("Threads");
+      break;
+    case CapturePhase::kModules:
+      CAPTURE_PHASE_HISTOGRAMS("Modules");
+      break;
+    case CapturePhase::kMemoryMaps:
+      CAPTURE_PHASE_HISTOGRAMS("MemoryMaps");
+      break;
+    case CapturePhase::kAnnotations:
+      CAPTURE_PHASE_HISTOGRAMS("Annotations");
+      break;
+    case CapturePhase::kIndirectMemory:
+      CAPTURE_PHASE_HISTOGRAMS("IndirectMemory");
+      break;
+    case CapturePhase::kSanitization:
+      CAPTURE_PHASE_HISTOGRAMS("Sanitization");
+      break;
+    case CapturePhase::kWrite:
+      CAPTURE_PHASE_HISTOGRAMS("Write");
+      break;
+    case CapturePhase::kDatabase:
+      CAPTURE_PHASE_HISTOGRAMS("Database");
+      break;
+    case CapturePhase::kMaxValue:
+      break;
+  }
+
+#undef CAPTURE_PHASE_HISTOGRAMS
+}
+
+// static
+void Metrics::ProcessMemoryCacheUsage(uint64_t hits, uint64_t misses) {
+  const uint64_t reads = hits + misses;
+  if (reads == 0) {
+    return;
+  }
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.ProcessMemoryCache.HitRate",
+                              base::saturated_cast<int>(hits * 100 / reads),
+                              1,
+                              100,
+                              101);
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.ProcessMemoryCache.Misses",
+                              base::saturated_cast<int>(misses),
+                              1,
+                              1024 * 1024,
+                              50);
+}
+
 // static
 void Metrics::CrashReportPending(PendingReportReason reason) {
+  Statistics::Get()->CrashReportPending(reason);
   UMA_HISTOGRAM_ENUMERATION(
       "Crashpad.CrashReportPending", reason, PendingReportReason::kMaxValue);
 }
 
 // static
 void Metrics::CrashReportSize(FileOffset size) {
+  Statistics::Get()->CrashReportSize(size);
   UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.CrashReportSize",
                               base::saturated_cast<uint32_t>(size),
                               0,
@@ -75,9 +198,41 @@ void Metrics::CrashReportSize(FileOffset size) {
 
 // static
 void Metrics::CrashUploadAttempted(bool successful) {
+  Statistics::Get()->CrashUploadAttempted(successful);
   UMA_HISTOGRAM_BOOLEAN("Crashpad.CrashUpload.AttemptSuccessful", successful);
 }
 
+// static
+void Metrics::CrashUploadCompleted(uint64_t duration_ns, uint64_t bytes) {
+  Statistics::Get()->CrashUploadCompleted(duration_ns, bytes);
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Crashpad.CrashUpload.Duration",
+      base::saturated_cast<uint32_t>(duration_ns / 1000000),
+      1,
+      10 * 60 * 1000,
+      50);
+}
+
+// static
+void Metrics::CrashUploadLatency(uint64_t seconds) {
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Crashpad.CrashUpload.TimeToUpload." METRICS_OS_NAME,
+      base::saturated_cast<uint32_t>(seconds),
+      1,
+      30 * 24 * 60 * 60,
+      50);
+}
+
+// static
+void Metrics::CrashReportsPruned(size_t count) {
+  Statistics::Get()->CrashReportsPruned(count);
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Crashpad.CrashReportsPruned",
+                              base::saturated_cast<uint32_t>(count),
+                              1,
+                              1000,
+                              50);
+}
+
 #if BUILDFLAG(IS_APPLE)
 // static
 void Metrics::CrashUploadErrorCode(int error_code) {
@@ -87,15 +242,40 @@ void Metrics::CrashUploadErrorCode(int error_code) {
 
 // static
 void Metrics::CrashUploadSkipped(CrashSkippedReason reason) {
+  Statistics::Get()->CrashUploadSkipped(reason);
   UMA_HISTOGRAM_ENUMERATION(
       "Crashpad.CrashUpload.Skipped", reason, CrashSkippedReason::kMaxValue);
 }
 
 // static
 void Metrics::ExceptionCaptureResult(CaptureResult result) {
+  Statistics::Get()->ExceptionCaptureResult(result);
   ExceptionProcessing(ExceptionProcessingState::kFinished);
   UMA_HISTOGRAM_ENUMERATION(
       "Crashpad.ExceptionCaptureResult", result, CaptureResult::kMaxValue);
+
+  if (result == CaptureResult::kSuccess && exception_capture_started_ns) {
+    CaptureIntervalCompleted(
+        CaptureInterval::kCapture,
+        ClockMonotonicNanoseconds() - exception_capture_started_ns);
+  }
+  exception_encountered_ns = 0;
+  exception_capture_started_ns = 0;
+}
+
+// static
+void Metrics::ExceptionCaptureStarted() {
+  exception_capture_started_ns = ClockMonotonicNanoseconds();
+  if (exception_encountered_ns) {
+    CaptureIntervalCompleted(
+        CaptureInterval::kStartDelay,
+        exception_capture_started_ns - exception_encountered_ns);
+  }
+}
+
+// static
+void Metrics::MinidumpWriteCompleted(uint64_t duration_ns) {
+  CaptureIntervalCompleted(CaptureInterval::kWrite, duration_ns);
 }
 
 // static
@@ -106,7 +286,10 @@ void Metrics::ExceptionCode(uint32_t exception_code) {
 
 // static
 void Metrics::ExceptionEncountered() {
+  Statistics::Get()->ExceptionEncountered();
   ExceptionProcessing(ExceptionProcessingState::kStarted);
+  exception_encountered_ns = ClockMonotonicNanoseconds();
+  exception_capture_started_ns = 0;
 }
 
 // static
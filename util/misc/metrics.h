@@ -19,6 +19,7 @@
 
 #include "build/build_config.h"
 #include "util/file/file_io.h"
+#include "util/misc/capture_timings.h"
 
 #if BUILDFLAG(IS_IOS)
 #include "util/ios/ios_intermediate_dump_format.h"
@@ -38,6 +39,17 @@ class Metrics {
   Metrics(const Metrics&) = delete;
   Metrics& operator=(const Metrics&) = delete;
 
+  //! \brief Reports the wall time spent and the bytes read from the target
+  //!     process in one phase of capturing a crash report.
+  static void CapturePhaseCompleted(CapturePhase phase,
+                                    uint64_t duration_ns,
+                                    uint64_t bytes_read);
+
+  //! \brief Reports how many reads of the target process' memory during one
+  //!     capture were serviced by a ProcessMemoryCached, and how many had to
+  //!     be fetched from the target process.
+  static void ProcessMemoryCacheUsage(uint64_t hits, uint64_t misses);
+
   //! \brief Values for CrashReportPending().
   //!
   //! \note These are used as metrics enumeration values, so new values should
@@ -63,6 +75,18 @@ class Metrics {
   //! \brief Reports on a crash upload attempt, and if it succeeded.
   static void CrashUploadAttempted(bool successful);
 
+  //! \brief Reports the wall time spent on a successful upload request, and
+  //!     the total size in bytes of the reports that it uploaded.
+  static void CrashUploadCompleted(uint64_t duration_ns, uint64_t bytes);
+
+  //! \brief Reports the time between the creation of a crash report and its
+  //!     successful upload, in seconds.
+  static void CrashUploadLatency(uint64_t seconds);
+
+  //! \brief Reports the number of reports removed from the database by a pass
+  //!     of pruning.
+  static void CrashReportsPruned(size_t count);
+
 #if BUILDFLAG(IS_APPLE) || DOXYGEN
   //! \brief Records error codes from
   //!     `+[NSURLConnection sendSynchronousRequest:returningResponse:error:]`.
@@ -99,6 +123,10 @@ class Metrics {
     //!     server, but the upload can be retried later.
     kUploadFailedButCanRetry = 6,
 
+    //! \brief A report with the same crash signature was uploaded too
+    //!     recently, so this one was skipped as a duplicate.
+    kDuplicateSignature = 7,
+
     //! \brief The number of values in this enumeration; not a valid value.
     kMaxValue
   };
@@ -160,14 +188,54 @@ class Metrics {
     //! \brief Failure to open a memfd caused this crash dump to be skipped.
     kOpenMemfdFailed = 12,
 
+    //! \brief An attempt to `ptrace` the target and capture it from a copy
+    //!     made by `fork()` failed, and so did capturing it directly.
+    //!
+    //! This value is only used on Linux/Android.
+    kForkSnapshotFailed = 13,
+
     //! \brief The number of values in this enumeration; not a valid value.
     kMaxValue
   };
 
   //! \brief Reports on the outcome of capturing a report in the exception
   //!     handler. Should be called on all capture completion paths.
+  //!
+  //! On success, this also reports the CaptureInterval::kCapture latency of
+  //! the capture.
   static void ExceptionCaptureResult(CaptureResult result);
 
+  //! \brief The intervals of handling an exception whose latency is reported.
+  //!
+  //! \note These are used as metrics enumeration values, so new values should
+  //!     always be added at the end, before CaptureInterval::kMaxValue.
+  enum class CaptureInterval : int32_t {
+    //! \brief From ExceptionEncountered() to ExceptionCaptureStarted(), which
+    //!     includes waiting for the resources to capture and attaching to the
+    //!     target process.
+    kStartDelay = 0,
+
+    //! \brief From ExceptionCaptureStarted() to a successful
+    //!     ExceptionCaptureResult().
+    kCapture = 1,
+
+    //! \brief Writing the minidump, as reported by MinidumpWriteCompleted().
+    kWrite = 2,
+
+    //! \brief The number of values in this enumeration; not a valid value.
+    kMaxValue
+  };
+
+  //! \brief The exception handler began snapshotting the target process of an
+  //!     exception reported by ExceptionEncountered() on the same thread.
+  //!
+  //! Reports the CaptureInterval::kStartDelay latency.
+  static void ExceptionCaptureStarted();
+
+  //! \brief Reports the wall time spent writing a minidump, the
+  //!     CaptureInterval::kWrite latency.
+  static void MinidumpWriteCompleted(uint64_t duration_ns);
+
   //! \brief The exception code for an exception was retrieved.
   //!
   //! These values are OS-specific, and correspond to
@@ -175,6 +243,10 @@ class Metrics {
   static void ExceptionCode(uint32_t exception_code);
 
   //! \brief The exception handler server started capturing an exception.
+  //!
+  //! The handler must report the rest of the capture, through
+  //! ExceptionCaptureStarted() and ExceptionCaptureResult(), on the same
+  //! thread.
   static void ExceptionEncountered();
 
   //! \brief An important event in a handler process’ lifetime.
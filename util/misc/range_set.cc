@@ -15,9 +15,20 @@
 #include "util/misc/range_set.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace crashpad {
 
+namespace {
+
+// Returns true if an interval ending at last may be merged with one starting at
+// base, because they overlap or are adjacent.
+bool CanMerge(VMAddress last, VMAddress base) {
+  return last == std::numeric_limits<VMAddress>::max() || last + 1 >= base;
+}
+
+}  // namespace
+
 RangeSet::RangeSet() = default;
 
 RangeSet::~RangeSet() = default;
@@ -27,29 +38,125 @@ void RangeSet::Insert(VMAddress base, VMSize size) {
     return;
   }
 
-  VMAddress last = base + size - 1;
+  Interval inserted = {base, base + size - 1};
 
-  auto overlapping_range = ranges_.lower_bound(base);
-#define OVERLAPPING_RANGES_BASE overlapping_range->second
-#define OVERLAPPING_RANGES_LAST overlapping_range->first
-  while (overlapping_range != ranges_.end() &&
-         OVERLAPPING_RANGES_BASE <= last) {
-    base = std::min(base, OVERLAPPING_RANGES_BASE);
-    last = std::max(last, OVERLAPPING_RANGES_LAST);
-    auto tmp = overlapping_range;
-    ++overlapping_range;
-    ranges_.erase(tmp);
+  // Find the intervals that overlap or are adjacent to the new one, and replace
+  // them all with their union.
+  auto first = ranges_.begin() + (FirstEndingAtOrAfter(base ? base - 1 : 0) -
+                                  ranges_.cbegin());
+  auto end = first;
+  while (end != ranges_.end() && CanMerge(inserted.last, end->base)) {
+    inserted.base = std::min(inserted.base, end->base);
+    inserted.last = std::max(inserted.last, end->last);
+    ++end;
   }
-#undef OVERLAPPING_RANGES_BASE
-#undef OVERLAPPING_RANGES_LAST
 
-  ranges_[last] = base;
+  if (first == end) {
+    ranges_.insert(first, inserted);
+    return;
+  }
+  *first = inserted;
+  ranges_.erase(first + 1, end);
+}
+
+void RangeSet::InsertMany(const std::vector<Range>& ranges) {
+  const size_t old_size = ranges_.size();
+  ranges_.reserve(old_size + ranges.size());
+  for (const Range& range : ranges) {
+    if (range.size) {
+      ranges_.push_back({range.base, range.base + range.size - 1});
+    }
+  }
+
+  auto by_base = [](const Interval& lhs, const Interval& rhs) {
+    return lhs.base < rhs.base;
+  };
+  std::sort(ranges_.begin() + old_size, ranges_.end(), by_base);
+  std::inplace_merge(
+      ranges_.begin(), ranges_.begin() + old_size, ranges_.end(), by_base);
+
+  // Sweep once, coalescing each interval into the last one kept if possible.
+  auto kept = ranges_.begin();
+  for (auto iter = ranges_.begin(); iter != ranges_.end(); ++iter) {
+    if (iter == kept) {
+      continue;
+    }
+    if (CanMerge(kept->last, iter->base)) {
+      kept->last = std::max(kept->last, iter->last);
+    } else {
+      *++kept = *iter;
+    }
+  }
+  if (!ranges_.empty()) {
+    ranges_.erase(kept + 1, ranges_.end());
+  }
 }
 
 bool RangeSet::Contains(VMAddress address) const {
-  auto range_above_address = ranges_.lower_bound(address);
-  return range_above_address != ranges_.end() &&
-         range_above_address->second <= address;
+  auto range = FirstEndingAtOrAfter(address);
+  return range != ranges_.end() && range->base <= address;
+}
+
+bool RangeSet::Overlaps(VMAddress base, VMSize size) const {
+  if (!size) {
+    return false;
+  }
+  auto range = FirstEndingAtOrAfter(base);
+  return range != ranges_.end() && range->base <= base + size - 1;
+}
+
+bool RangeSet::Covers(VMAddress base, VMSize size) const {
+  if (!size) {
+    return false;
+  }
+  // Adjacent intervals are merged, so a covered range lies in one interval.
+  auto range = FirstEndingAtOrAfter(base + size - 1);
+  return range != ranges_.end() && range->base <= base;
+}
+
+std::vector<RangeSet::Range> RangeSet::Intersect(VMAddress base,
+                                                 VMSize size) const {
+  std::vector<Range> intersection;
+  if (!size) {
+    return intersection;
+  }
+
+  const VMAddress last = base + size - 1;
+  for (auto range = FirstEndingAtOrAfter(base);
+       range != ranges_.end() && range->base <= last;
+       ++range) {
+    const VMAddress intersection_base = std::max(base, range->base);
+    const VMAddress intersection_last = std::min(last, range->last);
+    intersection.push_back(
+        {intersection_base, intersection_last - intersection_base + 1});
+  }
+  return intersection;
+}
+
+bool RangeSet::Bounds(VMAddress* lowest, VMAddress* highest) const {
+  if (ranges_.empty()) {
+    return false;
+  }
+  *lowest = ranges_.front().base;
+  *highest = ranges_.back().last;
+  return true;
+}
+
+std::vector<RangeSet::Interval>::const_iterator RangeSet::FirstEndingAtOrAfter(
+    VMAddress address) const {
+  // A lower bound search whose steps select rather than branch, so that its
+  // cost doesn't depend on predicting the address being searched for.
+  if (ranges_.empty()) {
+    return ranges_.end();
+  }
+  size_t first = 0;
+  size_t count = ranges_.size();
+  while (count > 1) {
+    const size_t half = count / 2;
+    first = ranges_[first + half - 1].last < address ? first + half : first;
+    count -= half;
+  }
+  return ranges_.begin() + first + (ranges_[first].last < address ? 1 : 0);
 }
 
 }  // namespace crashpad
@@ -15,15 +15,27 @@
 #ifndef CRASHPAD_UTIL_MISC_RANGE_SET_H_
 #define CRASHPAD_UTIL_MISC_RANGE_SET_H_
 
-#include <map>
+#include <vector>
 
 #include "util/misc/address_types.h"
 
 namespace crashpad {
 
 //! \brief A set of VMAddress ranges.
+//!
+//! Ranges are kept coalesced in a sorted vector, so that lookups are binary
+//! searches over contiguous memory.
 class RangeSet {
  public:
+  //! \brief A range of addresses.
+  struct Range {
+    //! \brief The low address of the range.
+    VMAddress base;
+
+    //! \brief The size of the range.
+    VMSize size;
+  };
+
   RangeSet();
 
   RangeSet(const RangeSet&) = delete;
@@ -37,14 +49,56 @@ class RangeSet {
   //! \param[in] size The size of the range.
   void Insert(VMAddress base, VMSize size);
 
+  //! \brief Inserts many ranges into the set.
+  //!
+  //! This is equivalent to calling Insert() for each element of \a ranges, but
+  //! sorts and coalesces them in a single pass.
+  //!
+  //! \param[in] ranges The ranges to insert. Ranges of size `0` are ignored.
+  void InsertMany(const std::vector<Range>& ranges);
+
   //! \brief Returns `true` if \a address falls within a range in this set.
   bool Contains(VMAddress address) const;
 
+  //! \brief Returns `true` if any address in the range starting at \a base
+  //!     and of size \a size falls within a range in this set.
+  bool Overlaps(VMAddress base, VMSize size) const;
+
+  //! \brief Returns `true` if every address in the range starting at
+  //!     \a base and of size \a size falls within a range in this set.
+  //!
+  //! This is equivalent to testing whether Intersect() returns the whole
+  //! range, without building its result. A range of size `0` is not covered.
+  bool Covers(VMAddress base, VMSize size) const;
+
+  //! \brief Returns the parts of the range starting at \a base and of size
+  //!     \a size that are in this set, in ascending order.
+  std::vector<Range> Intersect(VMAddress base, VMSize size) const;
+
+  //! \brief Returns the lowest and highest addresses in the set.
+  //!
+  //! Every address for which Contains() returns `true` lies within these
+  //! bounds, so callers testing many addresses may reject those outside of
+  //! them without searching the set.
+  //!
+  //! \param[out] lowest The lowest address in the set.
+  //! \param[out] highest The highest address in the set, inclusive.
+  //! \return `true` on success, or `false` if the set is empty.
+  bool Bounds(VMAddress* lowest, VMAddress* highest) const;
+
  private:
-  // Keys are the highest address in the range. Values are the base address of
-  // the range. Overlapping ranges are merged on insertion. Adjacent ranges may
-  // be merged.
-  std::map<VMAddress, VMAddress> ranges_;
+  struct Interval {
+    VMAddress base;
+    VMAddress last;
+  };
+
+  // Returns the first interval whose last address is not less than address.
+  std::vector<Interval>::const_iterator FirstEndingAtOrAfter(
+      VMAddress address) const;
+
+  // Sorted by base address. Overlapping and adjacent intervals are merged on
+  // insertion, so intervals never overlap.
+  std::vector<Interval> ranges_;
 };
 
 }  // namespace crashpad
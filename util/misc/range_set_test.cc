@@ -16,7 +16,9 @@
 
 #include <sys/types.h>
 
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include "base/format_macros.h"
 #include "base/strings/stringprintf.h"
@@ -111,6 +113,142 @@ TEST(RangeSet, LargeOverlappingRanges) {
   EXPECT_TRUE(ranges.Contains(addr + kBufferSize - 1));
 }
 
+TEST(RangeSet, AdjacentRanges) {
+  RangeSet ranges;
+  ranges.Insert(10, 10);
+  ranges.Insert(30, 10);
+  ranges.Insert(20, 10);
+
+  std::vector<RangeSet::Range> intersection = ranges.Intersect(0, 100);
+  ASSERT_EQ(intersection.size(), 1u);
+  EXPECT_EQ(intersection[0].base, 10u);
+  EXPECT_EQ(intersection[0].size, 30u);
+}
+
+TEST(RangeSet, RangeAtEndOfAddressSpace) {
+  constexpr VMAddress kMax = std::numeric_limits<VMAddress>::max();
+  RangeSet ranges;
+  ranges.Insert(kMax - 9, 10);
+  ranges.Insert(kMax - 19, 10);
+  EXPECT_TRUE(ranges.Contains(kMax));
+  EXPECT_TRUE(ranges.Contains(kMax - 19));
+  EXPECT_FALSE(ranges.Contains(kMax - 20));
+  EXPECT_EQ(ranges.Intersect(kMax - 29, 30).size(), 1u);
+}
+
+TEST(RangeSet, InsertMany) {
+  RangeSet ranges;
+  ranges.Insert(100, 10);
+  ranges.InsertMany({{50, 10}, {0, 0}, {105, 10}, {10, 5}, {55, 10}, {200, 1}});
+
+  EXPECT_TRUE(ranges.Contains(10));
+  EXPECT_TRUE(ranges.Contains(14));
+  EXPECT_FALSE(ranges.Contains(15));
+  EXPECT_TRUE(ranges.Contains(50));
+  EXPECT_TRUE(ranges.Contains(64));
+  EXPECT_FALSE(ranges.Contains(65));
+  EXPECT_TRUE(ranges.Contains(100));
+  EXPECT_TRUE(ranges.Contains(114));
+  EXPECT_FALSE(ranges.Contains(115));
+  EXPECT_TRUE(ranges.Contains(200));
+  EXPECT_FALSE(ranges.Contains(0));
+
+  std::vector<RangeSet::Range> intersection = ranges.Intersect(0, 1000);
+  ASSERT_EQ(intersection.size(), 4u);
+  EXPECT_EQ(intersection[0].base, 10u);
+  EXPECT_EQ(intersection[0].size, 5u);
+  EXPECT_EQ(intersection[1].base, 50u);
+  EXPECT_EQ(intersection[1].size, 15u);
+  EXPECT_EQ(intersection[2].base, 100u);
+  EXPECT_EQ(intersection[2].size, 15u);
+  EXPECT_EQ(intersection[3].base, 200u);
+  EXPECT_EQ(intersection[3].size, 1u);
+
+  // Inserting the same ranges one at a time produces the same set.
+  RangeSet one_at_a_time;
+  one_at_a_time.Insert(100, 10);
+  one_at_a_time.Insert(50, 10);
+  one_at_a_time.Insert(105, 10);
+  one_at_a_time.Insert(10, 5);
+  one_at_a_time.Insert(55, 10);
+  one_at_a_time.Insert(200, 1);
+  std::vector<RangeSet::Range> expected = one_at_a_time.Intersect(0, 1000);
+  ASSERT_EQ(expected.size(), intersection.size());
+  for (size_t index = 0; index < expected.size(); ++index) {
+    EXPECT_EQ(expected[index].base, intersection[index].base);
+    EXPECT_EQ(expected[index].size, intersection[index].size);
+  }
+}
+
+TEST(RangeSet, OverlapsAndIntersect) {
+  RangeSet ranges;
+  ranges.Insert(10, 10);
+  ranges.Insert(40, 10);
+
+  EXPECT_FALSE(ranges.Overlaps(0, 10));
+  EXPECT_TRUE(ranges.Overlaps(0, 11));
+  EXPECT_TRUE(ranges.Overlaps(19, 1));
+  EXPECT_FALSE(ranges.Overlaps(20, 20));
+  EXPECT_TRUE(ranges.Overlaps(0, 100));
+  EXPECT_FALSE(ranges.Overlaps(15, 0));
+
+  EXPECT_TRUE(ranges.Intersect(20, 20).empty());
+  EXPECT_TRUE(ranges.Intersect(15, 0).empty());
+
+  std::vector<RangeSet::Range> intersection = ranges.Intersect(15, 30);
+  ASSERT_EQ(intersection.size(), 2u);
+  EXPECT_EQ(intersection[0].base, 15u);
+  EXPECT_EQ(intersection[0].size, 5u);
+  EXPECT_EQ(intersection[1].base, 40u);
+  EXPECT_EQ(intersection[1].size, 5u);
+
+  intersection = ranges.Intersect(12, 2);
+  ASSERT_EQ(intersection.size(), 1u);
+  EXPECT_EQ(intersection[0].base, 12u);
+  EXPECT_EQ(intersection[0].size, 2u);
+}
+
+TEST(RangeSet, Covers) {
+  RangeSet ranges;
+  ranges.Insert(10, 10);
+  ranges.Insert(40, 10);
+  ranges.Insert(50, 10);
+
+  EXPECT_TRUE(ranges.Covers(10, 10));
+  EXPECT_TRUE(ranges.Covers(12, 2));
+  EXPECT_FALSE(ranges.Covers(9, 2));
+  EXPECT_FALSE(ranges.Covers(19, 2));
+  EXPECT_FALSE(ranges.Covers(15, 30));
+  EXPECT_FALSE(ranges.Covers(25, 5));
+  EXPECT_FALSE(ranges.Covers(12, 0));
+
+  // Adjacent ranges were merged, so a range spanning both is covered.
+  EXPECT_TRUE(ranges.Covers(45, 10));
+  EXPECT_TRUE(ranges.Covers(40, 20));
+  EXPECT_FALSE(ranges.Covers(40, 21));
+}
+
+TEST(RangeSet, Bounds) {
+  RangeSet ranges;
+  VMAddress lowest, highest;
+  EXPECT_FALSE(ranges.Bounds(&lowest, &highest));
+
+  ranges.Insert(40, 10);
+  ASSERT_TRUE(ranges.Bounds(&lowest, &highest));
+  EXPECT_EQ(lowest, 40u);
+  EXPECT_EQ(highest, 49u);
+
+  ranges.Insert(10, 10);
+  ASSERT_TRUE(ranges.Bounds(&lowest, &highest));
+  EXPECT_EQ(lowest, 10u);
+  EXPECT_EQ(highest, 49u);
+
+  ranges.Insert(std::numeric_limits<VMAddress>::max() - 9, 10);
+  ASSERT_TRUE(ranges.Bounds(&lowest, &highest));
+  EXPECT_EQ(lowest, 10u);
+  EXPECT_EQ(highest, std::numeric_limits<VMAddress>::max());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
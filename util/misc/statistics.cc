@@ -0,0 +1,391 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/statistics.h"
+
+#include <inttypes.h>
+
+#include <iterator>
+
+#include "base/check_op.h"
+#include "base/strings/stringprintf.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr const char* kCaptureResultNames[] = {
+    "Success",
+    "UnexpectedExceptionBehavior",
+    "FailedDueToSuspendSelf",
+    "SnapshotFailed",
+    "ExceptionInitializationFailed",
+    "PrepareNewCrashReportFailed",
+    "MinidumpWriteFailed",
+    "FinishedWritingCrashReportFailed",
+    "DirectPtraceFailed",
+    "BrokeredPtraceFailed",
+    "SanitizationInitializationFailed",
+    "SkippedDueToSanitization",
+    "OpenMemfdFailed",
+    "ForkSnapshotFailed",
+};
+static_assert(std::size(kCaptureResultNames) ==
+                  static_cast<size_t>(Metrics::CaptureResult::kMaxValue),
+              "kCaptureResultNames size");
+
+constexpr const char* kCaptureIntervalNames[] = {
+    "StartDelay",
+    "Capture",
+    "Write",
+};
+static_assert(std::size(kCaptureIntervalNames) ==
+                  static_cast<size_t>(Metrics::CaptureInterval::kMaxValue),
+              "kCaptureIntervalNames size");
+
+constexpr const char* kPendingReportReasonNames[] = {
+    "NewlyCreated",
+    "UserInitiated",
+};
+static_assert(std::size(kPendingReportReasonNames) ==
+                  static_cast<size_t>(Metrics::PendingReportReason::kMaxValue),
+              "kPendingReportReasonNames size");
+
+constexpr const char* kCrashSkippedReasonNames[] = {
+    "UploadsDisabled",
+    "UploadThrottled",
+    "UnexpectedTime",
+    "DatabaseError",
+    "UploadFailed",
+    "PrepareForUploadFailed",
+    "UploadFailedButCanRetry",
+    "DuplicateSignature",
+};
+static_assert(std::size(kCrashSkippedReasonNames) ==
+                  static_cast<size_t>(Metrics::CrashSkippedReason::kMaxValue),
+              "kCrashSkippedReasonNames size");
+
+void AppendCount(const char* name, uint64_t value, std::string* json) {
+  base::StringAppendF(json, "\"%s\":%" PRIu64, name, value);
+}
+
+// Appends an object mapping each name in |names| to its nonzero count in
+// |counts|.
+template <size_t N>
+void AppendCounts(const char* const (&names)[N],
+                  const std::atomic<uint64_t> (&counts)[N],
+                  std::string* json) {
+  json->push_back('{');
+  bool first = true;
+  for (size_t index = 0; index < N; ++index) {
+    const uint64_t count = counts[index].load(std::memory_order_relaxed);
+    if (count == 0) {
+      continue;
+    }
+    if (!first) {
+      json->push_back(',');
+    }
+    first = false;
+    AppendCount(names[index], count, json);
+  }
+  json->push_back('}');
+}
+
+template <typename T, size_t N>
+void ResetCounts(std::atomic<T> (&counts)[N]) {
+  for (std::atomic<T>& count : counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+template <typename Enum, size_t N>
+void Increment(Enum value, std::atomic<uint64_t> (&counts)[N]) {
+  const size_t index = static_cast<size_t>(value);
+  if (index < N) {
+    counts[index].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+Statistics::DurationHistogram::DurationHistogram() : buckets_(), total_ms_(0) {}
+
+Statistics::DurationHistogram::~DurationHistogram() = default;
+
+void Statistics::DurationHistogram::Add(uint64_t duration_ns) {
+  buckets_[BucketForDuration(duration_ns)].fetch_add(1,
+                                                     std::memory_order_relaxed);
+  total_ms_.fetch_add(duration_ns / 1000000, std::memory_order_relaxed);
+}
+
+uint64_t Statistics::DurationHistogram::count() const {
+  uint64_t count = 0;
+  for (const std::atomic<uint64_t>& bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t Statistics::DurationHistogram::total_ms() const {
+  return total_ms_.load(std::memory_order_relaxed);
+}
+
+uint64_t Statistics::DurationHistogram::bucket(size_t index) const {
+  DCHECK_LT(index, kBucketCount);
+  return buckets_[index].load(std::memory_order_relaxed);
+}
+
+// static
+size_t Statistics::DurationHistogram::BucketForDuration(uint64_t duration_ns) {
+  uint64_t duration_ms = duration_ns / 1000000;
+  size_t index = 0;
+  while (duration_ms != 0 && index < kBucketCount - 1) {
+    duration_ms >>= 1;
+    ++index;
+  }
+  return index;
+}
+
+void Statistics::DurationHistogram::AppendJSON(std::string* json) const {
+  json->push_back('{');
+  AppendCount("count", count(), json);
+  json->push_back(',');
+  AppendCount("total_ms", total_ms(), json);
+  json->append(",\"buckets\":[");
+  for (size_t index = 0; index < kBucketCount; ++index) {
+    if (index != 0) {
+      json->push_back(',');
+    }
+    base::StringAppendF(json, "%" PRIu64, bucket(index));
+  }
+  json->append("]}");
+}
+
+void Statistics::DurationHistogram::Reset() {
+  ResetCounts(buckets_);
+  total_ms_.store(0, std::memory_order_relaxed);
+}
+
+// static
+Statistics* Statistics::Get() {
+  static Statistics* const instance = new Statistics();
+  return instance;
+}
+
+Statistics::Statistics()
+    : capture_phase_durations_(),
+      capture_phase_bytes_read_(),
+      capture_interval_durations_(),
+      capture_results_(),
+      reports_pending_(),
+      upload_skips_(),
+      upload_durations_(),
+      exceptions_encountered_(0),
+      reports_written_(0),
+      bytes_written_(0),
+      uploads_succeeded_(0),
+      uploads_failed_(0),
+      bytes_uploaded_(0),
+      prune_runs_(0),
+      reports_pruned_(0) {}
+
+Statistics::~Statistics() = default;
+
+void Statistics::CapturePhaseCompleted(CapturePhase phase,
+                                       uint64_t duration_ns,
+                                       uint64_t bytes_read) {
+  const size_t index = static_cast<size_t>(phase);
+  if (index >= std::size(capture_phase_durations_)) {
+    return;
+  }
+  capture_phase_durations_[index].Add(duration_ns);
+  capture_phase_bytes_read_[index].fetch_add(bytes_read,
+                                             std::memory_order_relaxed);
+}
+
+void Statistics::CaptureIntervalCompleted(Metrics::CaptureInterval interval,
+                                          uint64_t duration_ns) {
+  const size_t index = static_cast<size_t>(interval);
+  if (index < std::size(capture_interval_durations_)) {
+    capture_interval_durations_[index].Add(duration_ns);
+  }
+}
+
+void Statistics::CrashReportPending(Metrics::PendingReportReason reason) {
+  Increment(reason, reports_pending_);
+}
+
+void Statistics::CrashReportSize(FileOffset size) {
+  reports_written_.fetch_add(1, std::memory_order_relaxed);
+  if (size > 0) {
+    bytes_written_.fetch_add(size, std::memory_order_relaxed);
+  }
+}
+
+void Statistics::CrashUploadAttempted(bool successful) {
+  (successful ? uploads_succeeded_ : uploads_failed_)
+      .fetch_add(1, std::memory_order_relaxed);
+}
+
+void Statistics::CrashUploadCompleted(uint64_t duration_ns, uint64_t bytes) {
+  upload_durations_.Add(duration_ns);
+  bytes_uploaded_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Statistics::CrashUploadSkipped(Metrics::CrashSkippedReason reason) {
+  Increment(reason, upload_skips_);
+}
+
+void Statistics::CrashReportsPruned(size_t count) {
+  prune_runs_.fetch_add(1, std::memory_order_relaxed);
+  reports_pruned_.fetch_add(count, std::memory_order_relaxed);
+}
+
+void Statistics::ExceptionCaptureResult(Metrics::CaptureResult result) {
+  Increment(result, capture_results_);
+}
+
+void Statistics::ExceptionEncountered() {
+  exceptions_encountered_.fetch_add(1, std::memory_order_relaxed);
+}
+
+const Statistics::DurationHistogram& Statistics::capture_phase_durations(
+    CapturePhase phase) const {
+  DCHECK_LT(static_cast<size_t>(phase), std::size(capture_phase_durations_));
+  return capture_phase_durations_[static_cast<size_t>(phase)];
+}
+
+const Statistics::DurationHistogram& Statistics::capture_interval_durations(
+    Metrics::CaptureInterval interval) const {
+  DCHECK_LT(static_cast<size_t>(interval),
+            std::size(capture_interval_durations_));
+  return capture_interval_durations_[static_cast<size_t>(interval)];
+}
+
+uint64_t Statistics::exceptions_encountered() const {
+  return exceptions_encountered_.load(std::memory_order_relaxed);
+}
+
+uint64_t Statistics::capture_results(Metrics::CaptureResult result) const {
+  DCHECK_LT(static_cast<size_t>(result), std::size(capture_results_));
+  return capture_results_[static_cast<size_t>(result)].load(
+      std::memory_order_relaxed);
+}
+
+uint64_t Statistics::uploads_succeeded() const {
+  return uploads_succeeded_.load(std::memory_order_relaxed);
+}
+
+uint64_t Statistics::uploads_failed() const {
+  return uploads_failed_.load(std::memory_order_relaxed);
+}
+
+uint64_t Statistics::bytes_uploaded() const {
+  return bytes_uploaded_.load(std::memory_order_relaxed);
+}
+
+uint64_t Statistics::uploads_skipped(Metrics::CrashSkippedReason reason) const {
+  DCHECK_LT(static_cast<size_t>(reason), std::size(upload_skips_));
+  return upload_skips_[static_cast<size_t>(reason)].load(
+      std::memory_order_relaxed);
+}
+
+uint64_t Statistics::reports_pruned() const {
+  return reports_pruned_.load(std::memory_order_relaxed);
+}
+
+std::string Statistics::ToJSON() const {
+  std::string json("{\"exceptions\":{");
+  AppendCount("encountered", exceptions_encountered(), &json);
+
+  json.append("},\"captures\":{\"results\":");
+  AppendCounts(kCaptureResultNames, capture_results_, &json);
+  json.append(",\"phases\":{");
+  for (size_t index = 0; index < std::size(capture_phase_durations_);
+       ++index) {
+    if (index != 0) {
+      json.push_back(',');
+    }
+    base::StringAppendF(&json,
+                        "\"%s\":{",
+                        CapturePhaseName(static_cast<CapturePhase>(index)));
+    AppendCount("bytes_read",
+                capture_phase_bytes_read_[index].load(
+                    std::memory_order_relaxed),
+                &json);
+    json.append(",\"duration_ms\":");
+    capture_phase_durations_[index].AppendJSON(&json);
+    json.push_back('}');
+  }
+  json.append("},\"latency_ms\":{");
+  for (size_t index = 0; index < std::size(capture_interval_durations_);
+       ++index) {
+    if (index != 0) {
+      json.push_back(',');
+    }
+    base::StringAppendF(&json, "\"%s\":", kCaptureIntervalNames[index]);
+    capture_interval_durations_[index].AppendJSON(&json);
+  }
+
+  json.append("}},\"reports\":{");
+  AppendCount(
+      "written", reports_written_.load(std::memory_order_relaxed), &json);
+  json.push_back(',');
+  AppendCount(
+      "bytes_written", bytes_written_.load(std::memory_order_relaxed), &json);
+  json.append(",\"pending\":");
+  AppendCounts(kPendingReportReasonNames, reports_pending_, &json);
+
+  json.append("},\"uploads\":{");
+  AppendCount("succeeded", uploads_succeeded(), &json);
+  json.push_back(',');
+  AppendCount("failed", uploads_failed(), &json);
+  json.push_back(',');
+  AppendCount("bytes", bytes_uploaded(), &json);
+  json.append(",\"duration_ms\":");
+  upload_durations_.AppendJSON(&json);
+  json.append(",\"skipped\":");
+  AppendCounts(kCrashSkippedReasonNames, upload_skips_, &json);
+
+  json.append("},\"pruning\":{");
+  AppendCount("runs", prune_runs_.load(std::memory_order_relaxed), &json);
+  json.push_back(',');
+  AppendCount("reports_pruned", reports_pruned(), &json);
+  json.append("}}");
+  return json;
+}
+
+void Statistics::Reset() {
+  for (DurationHistogram& histogram : capture_phase_durations_) {
+    histogram.Reset();
+  }
+  ResetCounts(capture_phase_bytes_read_);
+  for (DurationHistogram& histogram : capture_interval_durations_) {
+    histogram.Reset();
+  }
+  ResetCounts(capture_results_);
+  ResetCounts(reports_pending_);
+  ResetCounts(upload_skips_);
+  upload_durations_.Reset();
+  exceptions_encountered_.store(0, std::memory_order_relaxed);
+  reports_written_.store(0, std::memory_order_relaxed);
+  bytes_written_.store(0, std::memory_order_relaxed);
+  uploads_succeeded_.store(0, std::memory_order_relaxed);
+  uploads_failed_.store(0, std::memory_order_relaxed);
+  bytes_uploaded_.store(0, std::memory_order_relaxed);
+  prune_runs_.store(0, std::memory_order_relaxed);
+  reports_pruned_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace crashpad
@@ -0,0 +1,180 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_STATISTICS_H_
+#define CRASHPAD_UTIL_MISC_STATISTICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "util/misc/capture_timings.h"
+#include "util/misc/metrics.h"
+
+namespace crashpad {
+
+//! \brief Process-wide counters and histograms of the events reported through
+//!     Metrics.
+//!
+//! Unlike Metrics, which only reaches a metrics system when built against
+//! Chromium's base, these are kept in every build, so that a process such as
+//! the handler can report on itself. Each Metrics function records its event
+//! here before passing it on.
+//!
+//! Every method may be called from any thread.
+class Statistics {
+ public:
+  //! \brief A histogram of durations, in buckets whose bounds, in
+  //!     milliseconds, are successive powers of two.
+  class DurationHistogram {
+   public:
+    //! \brief The number of buckets. Bucket `0` counts durations shorter than
+    //!     1 millisecond. Bucket `n` counts durations of at least `2^(n-1)`
+    //!     and less than `2^n` milliseconds, except for the last, which also
+    //!     counts every longer duration.
+    static constexpr size_t kBucketCount = 18;
+
+    DurationHistogram();
+
+    DurationHistogram(const DurationHistogram&) = delete;
+    DurationHistogram& operator=(const DurationHistogram&) = delete;
+
+    ~DurationHistogram();
+
+    //! \brief Counts a duration of \a duration_ns nanoseconds.
+    void Add(uint64_t duration_ns);
+
+    //! \brief Returns the number of durations counted.
+    uint64_t count() const;
+
+    //! \brief Returns the sum of the durations counted, in milliseconds.
+    uint64_t total_ms() const;
+
+    //! \brief Returns the number of durations counted in bucket \a index.
+    uint64_t bucket(size_t index) const;
+
+    //! \brief Returns the index of the bucket that counts \a duration_ns.
+    static size_t BucketForDuration(uint64_t duration_ns);
+
+    //! \brief Appends this histogram to \a json as a JSON object.
+    void AppendJSON(std::string* json) const;
+
+    //! \brief Resets every count to zero.
+    void Reset();
+
+   private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> total_ms_;
+  };
+
+  //! \brief Returns the process-wide instance.
+  static Statistics* Get();
+
+  Statistics(const Statistics&) = delete;
+  Statistics& operator=(const Statistics&) = delete;
+
+  //! \name Recording
+  //!
+  //! These are called by the Metrics functions of the same names.
+  //! \{
+  void CapturePhaseCompleted(CapturePhase phase,
+                             uint64_t duration_ns,
+                             uint64_t bytes_read);
+  void CrashReportPending(Metrics::PendingReportReason reason);
+  void CrashReportSize(FileOffset size);
+  void CrashUploadAttempted(bool successful);
+  void CrashUploadCompleted(uint64_t duration_ns, uint64_t bytes);
+  void CrashUploadSkipped(Metrics::CrashSkippedReason reason);
+  void CrashReportsPruned(size_t count);
+  void ExceptionCaptureResult(Metrics::CaptureResult result);
+  void ExceptionEncountered();
+  //! \}
+
+  //! \brief Counts a \a duration_ns nanosecond \a interval of a capture.
+  //!
+  //! This is called by the Metrics functions that report capture latency.
+  void CaptureIntervalCompleted(Metrics::CaptureInterval interval,
+                                uint64_t duration_ns);
+
+  //! \brief Returns the histogram of the durations of \a phase.
+  const DurationHistogram& capture_phase_durations(CapturePhase phase) const;
+
+  //! \brief Returns the histogram of the durations of \a interval.
+  const DurationHistogram& capture_interval_durations(
+      Metrics::CaptureInterval interval) const;
+
+  //! \brief Returns the number of exceptions encountered.
+  uint64_t exceptions_encountered() const;
+
+  //! \brief Returns the number of captures that ended with \a result.
+  uint64_t capture_results(Metrics::CaptureResult result) const;
+
+  //! \brief Returns the number of upload attempts that succeeded.
+  uint64_t uploads_succeeded() const;
+
+  //! \brief Returns the number of upload attempts that failed.
+  uint64_t uploads_failed() const;
+
+  //! \brief Returns the number of bytes of reports uploaded.
+  uint64_t bytes_uploaded() const;
+
+  //! \brief Returns the number of reports skipped for \a reason.
+  uint64_t uploads_skipped(Metrics::CrashSkippedReason reason) const;
+
+  //! \brief Returns the number of reports removed by pruning.
+  uint64_t reports_pruned() const;
+
+  //! \brief Returns every statistic as a JSON object.
+  //!
+  //! The object has members `"exceptions"`, `"captures"`, `"reports"`,
+  //! `"uploads"`, and `"pruning"`. Counts kept for each value of an
+  //! enumeration are given as objects mapping the value's name to its count.
+  //! Only nonzero counts are included in those objects.
+  std::string ToJSON() const;
+
+  //! \brief Resets every statistic to zero.
+  void Reset();
+
+ private:
+  Statistics();
+  ~Statistics();
+
+  DurationHistogram
+      capture_phase_durations_[static_cast<size_t>(CapturePhase::kMaxValue)];
+  std::atomic<uint64_t>
+      capture_phase_bytes_read_[static_cast<size_t>(CapturePhase::kMaxValue)];
+  DurationHistogram capture_interval_durations_[static_cast<size_t>(
+      Metrics::CaptureInterval::kMaxValue)];
+  std::atomic<uint64_t> capture_results_[static_cast<size_t>(
+      Metrics::CaptureResult::kMaxValue)];
+  std::atomic<uint64_t> reports_pending_[static_cast<size_t>(
+      Metrics::PendingReportReason::kMaxValue)];
+  std::atomic<uint64_t> upload_skips_[static_cast<size_t>(
+      Metrics::CrashSkippedReason::kMaxValue)];
+  DurationHistogram upload_durations_;
+  std::atomic<uint64_t> exceptions_encountered_;
+  std::atomic<uint64_t> reports_written_;
+  std::atomic<uint64_t> bytes_written_;
+  std::atomic<uint64_t> uploads_succeeded_;
+  std::atomic<uint64_t> uploads_failed_;
+  std::atomic<uint64_t> bytes_uploaded_;
+  std::atomic<uint64_t> prune_runs_;
+  std::atomic<uint64_t> reports_pruned_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_STATISTICS_H_
@@ -0,0 +1,169 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/statistics.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kNanosecondsPerMillisecond = 1000000;
+
+TEST(Statistics, BucketForDuration) {
+  using Histogram = Statistics::DurationHistogram;
+  EXPECT_EQ(Histogram::BucketForDuration(0), 0u);
+  EXPECT_EQ(Histogram::BucketForDuration(kNanosecondsPerMillisecond - 1), 0u);
+  EXPECT_EQ(Histogram::BucketForDuration(kNanosecondsPerMillisecond), 1u);
+  EXPECT_EQ(Histogram::BucketForDuration(2 * kNanosecondsPerMillisecond), 2u);
+  EXPECT_EQ(Histogram::BucketForDuration(3 * kNanosecondsPerMillisecond), 2u);
+  EXPECT_EQ(Histogram::BucketForDuration(4 * kNanosecondsPerMillisecond), 3u);
+  EXPECT_EQ(Histogram::BucketForDuration(uint64_t{1} << 62),
+            Histogram::kBucketCount - 1);
+}
+
+TEST(Statistics, DurationHistogram) {
+  Statistics::DurationHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0u);
+
+  histogram.Add(500);
+  histogram.Add(3 * kNanosecondsPerMillisecond);
+  histogram.Add(3 * kNanosecondsPerMillisecond + 1);
+  EXPECT_EQ(histogram.count(), 3u);
+  EXPECT_EQ(histogram.total_ms(), 6u);
+  EXPECT_EQ(histogram.bucket(0), 1u);
+  EXPECT_EQ(histogram.bucket(1), 0u);
+  EXPECT_EQ(histogram.bucket(2), 2u);
+
+  std::string json;
+  histogram.AppendJSON(&json);
+  EXPECT_EQ(json,
+            "{\"count\":3,\"total_ms\":6,"
+            "\"buckets\":[1,0,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]}");
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.total_ms(), 0u);
+}
+
+TEST(Statistics, RecordedThroughMetrics) {
+  Statistics* const statistics = Statistics::Get();
+  statistics->Reset();
+
+  Metrics::ExceptionEncountered();
+  Metrics::CapturePhaseCompleted(
+      CapturePhase::kWrite, 5 * kNanosecondsPerMillisecond, 4096);
+  Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSuccess);
+  Metrics::ExceptionEncountered();
+  Metrics::ExceptionCaptureResult(
+      Metrics::CaptureResult::kDirectPtraceFailed);
+  Metrics::CrashReportPending(Metrics::PendingReportReason::kNewlyCreated);
+  Metrics::CrashReportSize(1000);
+  Metrics::CrashUploadAttempted(true);
+  Metrics::CrashUploadCompleted(20 * kNanosecondsPerMillisecond, 1000);
+  Metrics::CrashUploadAttempted(false);
+  Metrics::CrashUploadSkipped(Metrics::CrashSkippedReason::kUploadThrottled);
+  Metrics::CrashReportsPruned(3);
+
+  EXPECT_EQ(statistics->exceptions_encountered(), 2u);
+  EXPECT_EQ(statistics->capture_results(Metrics::CaptureResult::kSuccess), 1u);
+  EXPECT_EQ(
+      statistics->capture_results(Metrics::CaptureResult::kDirectPtraceFailed),
+      1u);
+  EXPECT_EQ(
+      statistics->capture_phase_durations(CapturePhase::kWrite).total_ms(), 5u);
+  EXPECT_EQ(
+      statistics->capture_phase_durations(CapturePhase::kThreads).count(), 0u);
+  EXPECT_EQ(statistics->uploads_succeeded(), 1u);
+  EXPECT_EQ(statistics->uploads_failed(), 1u);
+  EXPECT_EQ(statistics->bytes_uploaded(), 1000u);
+  EXPECT_EQ(statistics->uploads_skipped(
+                Metrics::CrashSkippedReason::kUploadThrottled),
+            1u);
+  EXPECT_EQ(statistics->reports_pruned(), 3u);
+
+  const std::string json = statistics->ToJSON();
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(json.back(), '}');
+  EXPECT_NE(json.find("\"exceptions\":{\"encountered\":2}"), std::string::npos);
+  EXPECT_NE(json.find("\"results\":{\"Success\":1,\"DirectPtraceFailed\":1}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"Write\":{\"bytes_read\":4096,\"duration_ms\":{"
+                      "\"count\":1,\"total_ms\":5,"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"reports\":{\"written\":1,\"bytes_written\":1000,"
+                      "\"pending\":{\"NewlyCreated\":1}}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"uploads\":{\"succeeded\":1,\"failed\":1,"
+                      "\"bytes\":1000,"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"skipped\":{\"UploadThrottled\":1}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"pruning\":{\"runs\":1,\"reports_pruned\":3}"),
+            std::string::npos);
+
+  statistics->Reset();
+  EXPECT_EQ(statistics->exceptions_encountered(), 0u);
+  EXPECT_EQ(statistics->reports_pruned(), 0u);
+}
+
+TEST(Statistics, CaptureLatency) {
+  Statistics* const statistics = Statistics::Get();
+  statistics->Reset();
+
+  Metrics::ExceptionEncountered();
+  Metrics::ExceptionCaptureStarted();
+  Metrics::MinidumpWriteCompleted(5 * kNanosecondsPerMillisecond);
+  Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSuccess);
+
+  // A failed capture has no capture latency.
+  Metrics::ExceptionEncountered();
+  Metrics::ExceptionCaptureStarted();
+  Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSnapshotFailed);
+
+  // A capture that didn't report its start has neither a start delay nor a
+  // capture latency.
+  Metrics::ExceptionEncountered();
+  Metrics::ExceptionCaptureResult(Metrics::CaptureResult::kSuccess);
+
+  EXPECT_EQ(statistics
+                ->capture_interval_durations(
+                    Metrics::CaptureInterval::kStartDelay)
+                .count(),
+            2u);
+  EXPECT_EQ(
+      statistics
+          ->capture_interval_durations(Metrics::CaptureInterval::kCapture)
+          .count(),
+      1u);
+  const Statistics::DurationHistogram& write =
+      statistics->capture_interval_durations(Metrics::CaptureInterval::kWrite);
+  EXPECT_EQ(write.count(), 1u);
+  EXPECT_EQ(write.total_ms(), 5u);
+
+  const std::string json = statistics->ToJSON();
+  EXPECT_NE(json.find("\"latency_ms\":{\"StartDelay\":{\"count\":2,"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"Write\":{\"count\":1,\"total_ms\":5,"),
+            std::string::npos);
+
+  statistics->Reset();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
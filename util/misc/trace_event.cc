@@ -0,0 +1,158 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/trace_event.h"
+
+#include <inttypes.h>
+
+#include "base/strings/stringprintf.h"
+#include "build/build_config.h"
+#include "util/file/file_io.h"
+#include "util/misc/clock.h"
+
+#if BUILDFLAG(IS_WIN)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif  // BUILDFLAG(IS_WIN)
+
+namespace crashpad {
+
+namespace {
+
+// Returns a small number identifying the calling thread, assigned in the order
+// in which threads first record an event. This is independent of the
+// platform's thread IDs, which may not fit in the trace format's integers.
+uint32_t CurrentTraceThreadID() {
+  static std::atomic<uint32_t> next_thread_id(1);
+  thread_local uint32_t thread_id = 0;
+  if (thread_id == 0) {
+    thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  }
+  return thread_id;
+}
+
+uint64_t CurrentProcessID() {
+#if BUILDFLAG(IS_WIN)
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+// Appends |ns| in microseconds, the unit of the trace format's timestamps.
+void AppendMicroseconds(uint64_t ns, std::string* json) {
+  base::StringAppendF(json,
+                      "%" PRIu64 ".%03u",
+                      ns / 1000,
+                      static_cast<unsigned int>(ns % 1000));
+}
+
+}  // namespace
+
+// static
+TraceLog* TraceLog::Get() {
+  static TraceLog* const instance = new TraceLog();
+  return instance;
+}
+
+TraceLog::TraceLog()
+    : enabled_(false), lock_(), path_(), events_(), dropped_events_(0) {}
+
+void TraceLog::Start(const base::FilePath& path) {
+  std::lock_guard<std::mutex> lock(lock_);
+  path_ = path;
+  events_.clear();
+  dropped_events_ = 0;
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+bool TraceLog::Stop() {
+  if (!enabled_.exchange(false, std::memory_order_relaxed)) {
+    return false;
+  }
+
+  const std::string json = ToJSON();
+  base::FilePath path;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    path = path_;
+  }
+
+  ScopedFileHandle handle(LoggingOpenFileForWrite(
+      path, FileWriteMode::kTruncateOrCreate, FilePermissions::kOwnerOnly));
+  return handle.is_valid() &&
+         LoggingWriteFile(handle.get(), json.data(), json.size());
+}
+
+void TraceLog::AddCompleteEvent(const char* category,
+                                const char* name,
+                                uint64_t start_ns,
+                                uint64_t duration_ns) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  const uint32_t thread_id = CurrentTraceThreadID();
+  std::lock_guard<std::mutex> lock(lock_);
+  if (events_.size() >= kMaxEvents) {
+    ++dropped_events_;
+    return;
+  }
+  events_.push_back({category, name, start_ns, duration_ns, thread_id});
+}
+
+std::string TraceLog::ToJSON() const {
+  const uint64_t pid = CurrentProcessID();
+
+  std::lock_guard<std::mutex> lock(lock_);
+  std::string json("{\"traceEvents\":[");
+  for (size_t index = 0; index < events_.size(); ++index) {
+    const Event& event = events_[index];
+    if (index != 0) {
+      json.push_back(',');
+    }
+    base::StringAppendF(&json,
+                        "\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                        "\"pid\":%" PRIu64 ",\"tid\":%u,\"ts\":",
+                        event.name,
+                        event.category,
+                        pid,
+                        event.thread_id);
+    AppendMicroseconds(event.start_ns, &json);
+    json.append(",\"dur\":");
+    AppendMicroseconds(event.duration_ns, &json);
+    json.push_back('}');
+  }
+  base::StringAppendF(&json,
+                      "],\n\"displayTimeUnit\":\"ms\","
+                      "\"otherData\":{\"dropped_events\":%" PRIu64 "}}\n",
+                      dropped_events_);
+  return json;
+}
+
+ScopedTraceEvent::ScopedTraceEvent(const char* category, const char* name)
+    : category_(category),
+      name_(name),
+      start_ns_(TraceLog::Get()->IsEnabled() ? ClockMonotonicNanoseconds()
+                                             : 0) {}
+
+ScopedTraceEvent::~ScopedTraceEvent() {
+  if (start_ns_ != 0) {
+    TraceLog::Get()->AddCompleteEvent(
+        category_, name_, start_ns_, ClockMonotonicNanoseconds() - start_ns_);
+  }
+}
+
+}  // namespace crashpad
@@ -0,0 +1,143 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_TRACE_EVENT_H_
+#define CRASHPAD_UTIL_MISC_TRACE_EVENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+namespace crashpad {
+
+//! \brief Records trace events in memory and writes them to a file in the
+//!     Chrome JSON trace event format, which can be viewed as a flame chart
+//!     in Perfetto or `chrome://tracing`.
+//!
+//! Events are normally recorded by CRASHPAD_TRACE_EVENT(), which expands to
+//! nothing unless Crashpad is built with the `crashpad_enable_trace_events` GN
+//! argument. Recording does nothing until Start() is called.
+//!
+//! Every method may be called from any thread.
+class TraceLog {
+ public:
+  //! \brief The maximum number of events kept. Events recorded after this
+  //!     many have been kept are counted but discarded.
+  static constexpr size_t kMaxEvents = 100000;
+
+  //! \brief Returns the process-wide TraceLog.
+  static TraceLog* Get();
+
+  TraceLog(const TraceLog&) = delete;
+  TraceLog& operator=(const TraceLog&) = delete;
+
+  //! \brief Discards any events recorded, and begins recording events to be
+  //!     written to \a path by Stop().
+  void Start(const base::FilePath& path);
+
+  //! \brief Stops recording events and writes those recorded to the path
+  //!     given to Start().
+  //!
+  //! \return `true` on success. `false` on failure with a message logged, or
+  //!     if recording was not started.
+  bool Stop();
+
+  //! \return `true` if events are being recorded.
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  //! \brief Records an event that began at \a start_ns, as given by
+  //!     ClockMonotonicNanoseconds(), and lasted \a duration_ns nanoseconds,
+  //!     on the calling thread.
+  //!
+  //! \param[in] category The event’s category. This must be a string literal.
+  //! \param[in] name The event’s name. This must be a string literal.
+  //! \param[in] start_ns The time at which the event began.
+  //! \param[in] duration_ns The duration of the event.
+  void AddCompleteEvent(const char* category,
+                        const char* name,
+                        uint64_t start_ns,
+                        uint64_t duration_ns);
+
+  //! \brief Returns the events recorded, as a Chrome JSON trace.
+  std::string ToJSON() const;
+
+ private:
+  struct Event {
+    const char* category;
+    const char* name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t thread_id;
+  };
+
+  TraceLog();
+  ~TraceLog() = delete;
+
+  std::atomic<bool> enabled_;
+  mutable std::mutex lock_;
+  base::FilePath path_;  // Guarded by lock_.
+  std::vector<Event> events_;  // Guarded by lock_.
+  uint64_t dropped_events_;  // Guarded by lock_.
+};
+
+//! \brief Records a trace event spanning the lifetime of this object, if the
+//!     TraceLog is recording.
+//!
+//! This is normally used through CRASHPAD_TRACE_EVENT().
+class ScopedTraceEvent {
+ public:
+  //! \param[in] category The event’s category. This must be a string literal.
+  //! \param[in] name The event’s name. This must be a string literal.
+  ScopedTraceEvent(const char* category, const char* name);
+
+  ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+  ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+  ~ScopedTraceEvent();
+
+ private:
+  const char* category_;
+  const char* name_;
+  uint64_t start_ns_;  // 0 if the TraceLog was not recording.
+};
+
+}  // namespace crashpad
+
+#define CRASHPAD_TRACE_EVENT_CONCAT_INNER(a, b) a##b
+#define CRASHPAD_TRACE_EVENT_CONCAT(a, b) CRASHPAD_TRACE_EVENT_CONCAT_INNER(a, b)
+
+#if defined(CRASHPAD_ENABLE_TRACE_EVENTS) || DOXYGEN
+
+//! \brief Records a trace event named \a name in category \a category, both
+//!     string literals, spanning the rest of the enclosing scope.
+//!
+//! This expands to nothing unless Crashpad is built with the
+//! `crashpad_enable_trace_events` GN argument.
+#define CRASHPAD_TRACE_EVENT(category, name) \
+  ::crashpad::ScopedTraceEvent CRASHPAD_TRACE_EVENT_CONCAT( \
+      crashpad_trace_event_, __LINE__)(category, name)
+
+#else
+
+#define CRASHPAD_TRACE_EVENT(category, name) static_cast<void>(0)
+
+#endif  // CRASHPAD_ENABLE_TRACE_EVENTS || DOXYGEN
+
+#endif  // CRASHPAD_UTIL_MISC_TRACE_EVENT_H_
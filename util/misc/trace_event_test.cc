@@ -0,0 +1,78 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/trace_event.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/scoped_temp_dir.h"
+#include "util/file/file_io.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(TraceEvent, NotRecording) {
+  TraceLog* const trace_log = TraceLog::Get();
+  ASSERT_FALSE(trace_log->IsEnabled());
+  EXPECT_FALSE(trace_log->Stop());
+
+  { ScopedTraceEvent event("test", "NotRecording"); }
+  EXPECT_EQ(trace_log->ToJSON().find("NotRecording"), std::string::npos);
+}
+
+TEST(TraceEvent, Record) {
+  ScopedTempDir temp_dir;
+  const base::FilePath path =
+      temp_dir.path().Append(FILE_PATH_LITERAL("trace.json"));
+
+  TraceLog* const trace_log = TraceLog::Get();
+  trace_log->Start(path);
+  EXPECT_TRUE(trace_log->IsEnabled());
+
+  {
+    ScopedTraceEvent outer("test", "Outer");
+    { ScopedTraceEvent inner("test", "Inner"); }
+  }
+  trace_log->AddCompleteEvent("test", "Explicit", 1234567, 2001);
+
+  ASSERT_TRUE(trace_log->Stop());
+  EXPECT_FALSE(trace_log->IsEnabled());
+
+  std::string contents;
+  ASSERT_TRUE(LoggingReadEntireFile(path, &contents));
+  EXPECT_EQ(contents.compare(0, 15, "{\"traceEvents\":"), 0);
+  EXPECT_EQ(contents.back(), '\n');
+
+  // Inner ends first, so it is recorded before Outer.
+  const size_t inner = contents.find("\"name\":\"Inner\",\"cat\":\"test\"");
+  const size_t outer = contents.find("\"name\":\"Outer\",\"cat\":\"test\"");
+  ASSERT_NE(inner, std::string::npos);
+  ASSERT_NE(outer, std::string::npos);
+  EXPECT_LT(inner, outer);
+
+  EXPECT_NE(contents.find("\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(contents.find("\"ts\":1234.567,\"dur\":2.001}"), std::string::npos);
+  EXPECT_NE(contents.find("\"dropped_events\":0"), std::string::npos);
+
+  // Starting again discards the events already recorded.
+  trace_log->Start(path);
+  EXPECT_EQ(trace_log->ToJSON().find("Outer"), std::string::npos);
+  ASSERT_TRUE(trace_log->Stop());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,147 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/xxhash64.h"
+
+#include <string.h>
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 0x9e3779b185ebca87;
+constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4f;
+constexpr uint64_t kPrime3 = 0x165667b19e3779f9;
+constexpr uint64_t kPrime4 = 0x85ebca77c2b2ae63;
+constexpr uint64_t kPrime5 = 0x27d4eb2f165667c5;
+
+constexpr uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// XXH64 is defined in terms of little-endian reads. All platforms that
+// Crashpad supports are little-endian.
+uint64_t Read64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint32_t Read32(const uint8_t* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t Round(uint64_t accumulator, uint64_t input) {
+  accumulator += input * kPrime2;
+  accumulator = RotateLeft(accumulator, 31);
+  return accumulator * kPrime1;
+}
+
+uint64_t MergeRound(uint64_t accumulator, uint64_t value) {
+  accumulator ^= Round(0, value);
+  return accumulator * kPrime1 + kPrime4;
+}
+
+}  // namespace
+
+XXHash64::XXHash64(uint64_t seed)
+    : accumulators_{seed + kPrime1 + kPrime2, seed + kPrime2, seed,
+                    seed - kPrime1},
+      seed_(seed),
+      total_size_(0),
+      buffer_(),
+      buffer_size_(0) {}
+
+XXHash64::~XXHash64() = default;
+
+void XXHash64::Update(const void* data, size_t size) {
+  const uint8_t* input = static_cast<const uint8_t*>(data);
+  total_size_ += size;
+
+  if (buffer_size_ + size < sizeof(buffer_)) {
+    memcpy(buffer_ + buffer_size_, input, size);
+    buffer_size_ += size;
+    return;
+  }
+
+  if (buffer_size_) {
+    const size_t fill = sizeof(buffer_) - buffer_size_;
+    memcpy(buffer_ + buffer_size_, input, fill);
+    for (size_t lane = 0; lane < 4; ++lane) {
+      accumulators_[lane] =
+          Round(accumulators_[lane], Read64(buffer_ + lane * 8));
+    }
+    input += fill;
+    size -= fill;
+    buffer_size_ = 0;
+  }
+
+  while (size >= sizeof(buffer_)) {
+    for (size_t lane = 0; lane < 4; ++lane) {
+      accumulators_[lane] =
+          Round(accumulators_[lane], Read64(input + lane * 8));
+    }
+    input += sizeof(buffer_);
+    size -= sizeof(buffer_);
+  }
+
+  memcpy(buffer_, input, size);
+  buffer_size_ = size;
+}
+
+uint64_t XXHash64::Digest() const {
+  uint64_t hash;
+  if (total_size_ >= sizeof(buffer_)) {
+    hash = RotateLeft(accumulators_[0], 1) + RotateLeft(accumulators_[1], 7) +
+           RotateLeft(accumulators_[2], 12) + RotateLeft(accumulators_[3], 18);
+    for (uint64_t accumulator : accumulators_) {
+      hash = MergeRound(hash, accumulator);
+    }
+  } else {
+    hash = seed_ + kPrime5;
+  }
+  hash += total_size_;
+
+  const uint8_t* input = buffer_;
+  size_t size = buffer_size_;
+  while (size >= 8) {
+    hash ^= Round(0, Read64(input));
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+    input += 8;
+    size -= 8;
+  }
+  if (size >= 4) {
+    hash ^= Read32(input) * kPrime1;
+    hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+    input += 4;
+    size -= 4;
+  }
+  while (size > 0) {
+    hash ^= *input * kPrime5;
+    hash = RotateLeft(hash, 11) * kPrime1;
+    ++input;
+    --size;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+}  // namespace crashpad
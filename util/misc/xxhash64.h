@@ -0,0 +1,59 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_MISC_XXHASH64_H_
+#define CRASHPAD_UTIL_MISC_XXHASH64_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace crashpad {
+
+//! \brief Computes the 64-bit xxHash (XXH64) of data supplied incrementally.
+//!
+//! XXH64 is a fast non-cryptographic hash. It is suitable for detecting
+//! corruption and identifying duplicate content, but not for authentication.
+class XXHash64 {
+ public:
+  //! \param[in] seed The seed for the hash. The canonical digest uses `0`.
+  explicit XXHash64(uint64_t seed = 0);
+
+  XXHash64(const XXHash64&) = delete;
+  XXHash64& operator=(const XXHash64&) = delete;
+
+  ~XXHash64();
+
+  //! \brief Adds \a size bytes at \a data to the hashed content.
+  void Update(const void* data, size_t size);
+
+  //! \brief Returns the digest of all of the content passed to Update().
+  //!
+  //! This does not alter the state of the object, so more content may be
+  //! added afterwards.
+  uint64_t Digest() const;
+
+  //! \brief The total number of bytes passed to Update().
+  uint64_t size() const { return total_size_; }
+
+ private:
+  uint64_t accumulators_[4];
+  uint64_t seed_;
+  uint64_t total_size_;
+  uint8_t buffer_[32];
+  size_t buffer_size_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_MISC_XXHASH64_H_
@@ -0,0 +1,73 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/misc/xxhash64.h"
+
+#include <algorithm>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+uint64_t HashString(const std::string& string, uint64_t seed = 0) {
+  XXHash64 hash(seed);
+  hash.Update(string.data(), string.size());
+  return hash.Digest();
+}
+
+TEST(XXHash64, KnownValues) {
+  EXPECT_EQ(HashString(std::string()), 0xef46db3751d8e999u);
+  EXPECT_EQ(HashString("a"), 0xd24ec4f1a98c6e5bu);
+  EXPECT_EQ(HashString("abc"), 0x44bc2cf5ad770999u);
+  EXPECT_EQ(HashString("Nobody inspects the spammish repetition"),
+            0xfbcea83c8a378bf1u);
+}
+
+TEST(XXHash64, Incremental) {
+  std::string data;
+  for (size_t index = 0; index < 1000; ++index) {
+    data.push_back(static_cast<char>(index * 7));
+  }
+  const uint64_t expected = HashString(data, 1);
+
+  // Feed the data in pieces of every size up to a few times the block size,
+  // so that each path through Update() is exercised.
+  for (size_t piece_size = 1; piece_size <= 100; ++piece_size) {
+    SCOPED_TRACE(piece_size);
+    XXHash64 hash(1);
+    for (size_t offset = 0; offset < data.size(); offset += piece_size) {
+      hash.Update(data.data() + offset,
+                  std::min(piece_size, data.size() - offset));
+    }
+    EXPECT_EQ(hash.size(), data.size());
+    EXPECT_EQ(hash.Digest(), expected);
+  }
+}
+
+TEST(XXHash64, DigestDoesNotChangeState) {
+  XXHash64 hash;
+  hash.Update("abc", 3);
+  const uint64_t digest = hash.Digest();
+  EXPECT_EQ(hash.Digest(), digest);
+  hash.Update("def", 3);
+  EXPECT_EQ(hash.Digest(), HashString("abcdef"));
+  EXPECT_NE(hash.Digest(), digest);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,423 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/hpack.h"
+
+#include <iterator>
+
+#include "base/check_op.h"
+#include "base/logging.h"
+
+namespace crashpad {
+
+namespace {
+
+// RFC 7541 Appendix A. Index 1 is the first entry.
+constexpr struct {
+  const char* name;
+  const char* value;
+} kStaticTable[] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+constexpr size_t kStaticTableSize = std::size(kStaticTable);
+
+// The length in bits of the Huffman code for each symbol, from RFC 7541
+// Appendix B. Symbol 256 is EOS. The code is canonical: codes of each length
+// are consecutive in symbol order, and follow those of the next shorter
+// length, so the codes themselves needn’t be listed.
+constexpr uint8_t kHuffmanCodeLengths[] = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6,  10, 10, 12, 13, 6,  8,  11, 10, 10, 8,  11, 8,  6,  6,  6,
+    5,  5,  5,  6,  6,  6,  6,  6,  6,  6,  7,  8,  15, 6,  12, 10,
+    13, 6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+    7,  7,  7,  7,  7,  7,  7,  7,  8,  7,  8,  13, 19, 13, 14, 6,
+    15, 5,  6,  5,  6,  5,  6,  6,  6,  5,  7,  7,  6,  6,  6,  5,
+    6,  7,  6,  5,  5,  6,  7,  7,  7,  7,  7,  15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+    30,
+};
+constexpr uint16_t kHuffmanEOS = 256;
+constexpr size_t kHuffmanMaxCodeLength = 30;
+
+// The overhead counted for each field in the size of the dynamic table and of
+// a header list (RFC 7541 §4.1).
+constexpr size_t kFieldOverhead = 32;
+
+// The largest header list accepted, as the sum of the size of each field
+// including kFieldOverhead.
+constexpr size_t kMaxHeaderListSize = 64 * 1024;
+
+// The tables used to decode the canonical Huffman code.
+struct HuffmanDecodingTables {
+  HuffmanDecodingTables() : symbols(), count(), first_code(), first_index() {
+    uint16_t index = 0;
+    for (size_t length = 1; length <= kHuffmanMaxCodeLength; ++length) {
+      for (uint16_t symbol = 0; symbol < std::size(kHuffmanCodeLengths);
+           ++symbol) {
+        if (kHuffmanCodeLengths[symbol] == length) {
+          symbols[index++] = symbol;
+          ++count[length];
+        }
+      }
+    }
+    DCHECK_EQ(index, std::size(kHuffmanCodeLengths));
+
+    uint32_t code = 0;
+    index = 0;
+    for (size_t length = 1; length <= kHuffmanMaxCodeLength; ++length) {
+      first_code[length] = code;
+      first_index[length] = index;
+      code = (code + count[length]) << 1;
+      index += count[length];
+    }
+  }
+
+  // Symbols in the order of their codes.
+  uint16_t symbols[std::size(kHuffmanCodeLengths)];
+
+  // For each code length, the number of codes, the first code, and the index
+  // in symbols of the first code’s symbol.
+  uint16_t count[kHuffmanMaxCodeLength + 1];
+  uint32_t first_code[kHuffmanMaxCodeLength + 1];
+  uint16_t first_index[kHuffmanMaxCodeLength + 1];
+};
+
+bool HuffmanDecode(const uint8_t* data, size_t size, std::string* decoded) {
+  static const HuffmanDecodingTables* tables = new HuffmanDecodingTables();
+
+  decoded->clear();
+  uint32_t code = 0;
+  size_t length = 0;
+  for (size_t index = 0; index < size; ++index) {
+    for (int bit = 7; bit >= 0; --bit) {
+      code = (code << 1) | ((data[index] >> bit) & 1);
+      if (++length > kHuffmanMaxCodeLength) {
+        LOG(ERROR) << "invalid Huffman code";
+        return false;
+      }
+
+      const uint32_t offset = code - tables->first_code[length];
+      if (code >= tables->first_code[length] &&
+          offset < tables->count[length]) {
+        const uint16_t symbol =
+            tables->symbols[tables->first_index[length] + offset];
+        if (symbol == kHuffmanEOS) {
+          LOG(ERROR) << "Huffman EOS in string";
+          return false;
+        }
+        decoded->push_back(static_cast<char>(symbol));
+        code = 0;
+        length = 0;
+      }
+    }
+  }
+
+  // The string is padded with up to 7 bits of the EOS code, which is all ones
+  // (RFC 7541 §5.2).
+  if (length > 7 || code != (1u << length) - 1) {
+    LOG(ERROR) << "invalid Huffman padding";
+    return false;
+  }
+  return true;
+}
+
+void EncodeInteger(uint8_t first_byte,
+                   int prefix_bits,
+                   uint64_t value,
+                   std::string* block) {
+  const uint8_t prefix_max = static_cast<uint8_t>((1 << prefix_bits) - 1);
+  if (value < prefix_max) {
+    block->push_back(static_cast<char>(first_byte | value));
+    return;
+  }
+
+  block->push_back(static_cast<char>(first_byte | prefix_max));
+  value -= prefix_max;
+  while (value >= 0x80) {
+    block->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  block->push_back(static_cast<char>(value));
+}
+
+void EncodeString(const std::string& string, std::string* block) {
+  EncodeInteger(0, 7, string.size(), block);
+  block->append(string);
+}
+
+// Reads the representations in a header block, consuming what it reads.
+class BlockReader {
+ public:
+  BlockReader(const uint8_t* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  BlockReader(const BlockReader&) = delete;
+  BlockReader& operator=(const BlockReader&) = delete;
+
+  bool AtEnd() const { return data_ == end_; }
+  uint8_t Peek() const { return *data_; }
+
+  bool ReadInteger(int prefix_bits, uint64_t* value) {
+    if (AtEnd()) {
+      LOG(ERROR) << "truncated integer";
+      return false;
+    }
+    const uint8_t prefix_max = static_cast<uint8_t>((1 << prefix_bits) - 1);
+    *value = *data_++ & prefix_max;
+    if (*value < prefix_max) {
+      return true;
+    }
+
+    // Nothing this decoder accepts is larger than 32 bits, so reject larger
+    // values before they can overflow.
+    for (int shift = 0; shift <= 28; shift += 7) {
+      if (AtEnd()) {
+        LOG(ERROR) << "truncated integer";
+        return false;
+      }
+      const uint8_t byte = *data_++;
+      *value += static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    LOG(ERROR) << "integer too large";
+    return false;
+  }
+
+  bool ReadString(std::string* string) {
+    if (AtEnd()) {
+      LOG(ERROR) << "truncated string";
+      return false;
+    }
+    const bool huffman = (*data_ & 0x80) != 0;
+    uint64_t length;
+    if (!ReadInteger(7, &length)) {
+      return false;
+    }
+    if (length > static_cast<uint64_t>(end_ - data_)) {
+      LOG(ERROR) << "truncated string";
+      return false;
+    }
+
+    const uint8_t* bytes = data_;
+    data_ += length;
+    if (huffman) {
+      return HuffmanDecode(bytes, length, string);
+    }
+    string->assign(reinterpret_cast<const char*>(bytes), length);
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  const uint8_t* const end_;
+};
+
+}  // namespace
+
+void HPACKEncode(const HPACKHeaderList& headers, std::string* block) {
+  for (const auto& field : headers) {
+    size_t name_index = 0;
+    size_t field_index = 0;
+    for (size_t index = 0; index < kStaticTableSize; ++index) {
+      if (field.first == kStaticTable[index].name) {
+        if (!name_index) {
+          name_index = index + 1;
+        }
+        if (field.second == kStaticTable[index].value) {
+          field_index = index + 1;
+          break;
+        }
+      }
+    }
+
+    if (field_index) {
+      // Indexed header field (RFC 7541 §6.1).
+      EncodeInteger(0x80, 7, field_index, block);
+      continue;
+    }
+
+    // Literal header field without indexing (RFC 7541 §6.2.2).
+    EncodeInteger(0, 4, name_index, block);
+    if (!name_index) {
+      EncodeString(field.first, block);
+    }
+    EncodeString(field.second, block);
+  }
+}
+
+HPACKDecoder::HPACKDecoder()
+    : dynamic_table_(), table_size_(0), max_table_size_(kMaxTableSize) {}
+
+HPACKDecoder::~HPACKDecoder() = default;
+
+bool HPACKDecoder::Decode(const uint8_t* block,
+                          size_t size,
+                          HPACKHeaderList* headers) {
+  headers->clear();
+  size_t list_size = 0;
+  BlockReader reader(block, size);
+  while (!reader.AtEnd()) {
+    const uint8_t first_byte = reader.Peek();
+    uint64_t index;
+    std::pair<std::string, std::string> field;
+
+    if (first_byte & 0x80) {
+      // Indexed header field (RFC 7541 §6.1).
+      if (!reader.ReadInteger(7, &index) || !GetField(index, &field)) {
+        return false;
+      }
+    } else if ((first_byte & 0xe0) == 0x20) {
+      // Dynamic table size update (RFC 7541 §6.3), which may only appear
+      // before the first field in a block.
+      if (!reader.ReadInteger(5, &index)) {
+        return false;
+      }
+      if (!headers->empty() || index > kMaxTableSize) {
+        LOG(ERROR) << "invalid dynamic table size update";
+        return false;
+      }
+      max_table_size_ = index;
+      EvictFields();
+      continue;
+    } else {
+      // Literal header field with incremental indexing (RFC 7541 §6.2.1),
+      // without indexing (§6.2.2), or never indexed (§6.2.3).
+      const bool add_to_table = (first_byte & 0xc0) == 0x40;
+      if (!reader.ReadInteger(add_to_table ? 6 : 4, &index)) {
+        return false;
+      }
+      if (index ? !GetField(index, &field) : !reader.ReadString(&field.first)) {
+        return false;
+      }
+      if (!reader.ReadString(&field.second)) {
+        return false;
+      }
+      if (add_to_table) {
+        AddField(field);
+      }
+    }
+
+    list_size += field.first.size() + field.second.size() + kFieldOverhead;
+    if (list_size > kMaxHeaderListSize) {
+      LOG(ERROR) << "header list too large";
+      return false;
+    }
+    headers->push_back(std::move(field));
+  }
+  return true;
+}
+
+bool HPACKDecoder::GetField(uint64_t index,
+                            std::pair<std::string, std::string>* field) const {
+  if (index >= 1 && index <= kStaticTableSize) {
+    field->first = kStaticTable[index - 1].name;
+    field->second = kStaticTable[index - 1].value;
+    return true;
+  }
+  if (index > kStaticTableSize &&
+      index - kStaticTableSize <= dynamic_table_.size()) {
+    *field = dynamic_table_[index - kStaticTableSize - 1];
+    return true;
+  }
+  LOG(ERROR) << "invalid header table index " << index;
+  return false;
+}
+
+void HPACKDecoder::AddField(std::pair<std::string, std::string> field) {
+  // A field larger than the table empties it, and isn’t added (RFC 7541 §4.4).
+  table_size_ += field.first.size() + field.second.size() + kFieldOverhead;
+  dynamic_table_.push_front(std::move(field));
+  EvictFields();
+}
+
+void HPACKDecoder::EvictFields() {
+  while (table_size_ > max_table_size_) {
+    DCHECK(!dynamic_table_.empty());
+    const auto& field = dynamic_table_.back();
+    table_size_ -= field.first.size() + field.second.size() + kFieldOverhead;
+    dynamic_table_.pop_back();
+  }
+}
+
+}  // namespace crashpad
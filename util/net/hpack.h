@@ -0,0 +1,96 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HPACK_H_
+#define CRASHPAD_UTIL_NET_HPACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief A list of HTTP/2 header fields, in order.
+//!
+//! Names are lowercase, and pseudo-header fields such as `:status` precede all
+//! others.
+using HPACKHeaderList = std::vector<std::pair<std::string, std::string>>;
+
+//! \brief Encodes \a headers as an HPACK (RFC 7541) header block, appending it
+//!     to \a block.
+//!
+//! Fields whose name and value, or just name, appear in the static table are
+//! encoded with a reference to it. No field is added to the dynamic table, so
+//! the encoding doesn’t depend on earlier header blocks or on the table size
+//! that the peer allows. Strings are not Huffman-encoded.
+void HPACKEncode(const HPACKHeaderList& headers, std::string* block);
+
+//! \brief Decodes the HPACK (RFC 7541) header blocks received on an HTTP/2
+//!     connection.
+//!
+//! The decoder maintains the dynamic table across header blocks, so a single
+//! object must be used to decode every header block received on a connection,
+//! in the order they arrive.
+class HPACKDecoder {
+ public:
+  //! \brief The largest dynamic table that the peer may use, which is the
+  //!     initial value of `SETTINGS_HEADER_TABLE_SIZE`.
+  static constexpr size_t kMaxTableSize = 4096;
+
+  HPACKDecoder();
+
+  HPACKDecoder(const HPACKDecoder&) = delete;
+  HPACKDecoder& operator=(const HPACKDecoder&) = delete;
+
+  ~HPACKDecoder();
+
+  //! \brief Decodes a complete header block.
+  //!
+  //! \param[in] block The header block.
+  //! \param[in] size The size of \a block.
+  //! \param[out] headers The decoded header fields.
+  //!
+  //! \return `true` on success. `false` if the header block is malformed, with
+  //!     a message logged. This is a connection error of type
+  //!     `COMPRESSION_ERROR`, after which this object must not be used.
+  bool Decode(const uint8_t* block, size_t size, HPACKHeaderList* headers);
+
+  //! \brief The size of the dynamic table, as defined by RFC 7541 §4.1.
+  size_t TableSize() const { return table_size_; }
+
+ private:
+  // Sets field to the field at index in the static or dynamic table. Returns
+  // false if there is none, with a message logged.
+  bool GetField(uint64_t index,
+                std::pair<std::string, std::string>* field) const;
+
+  // Adds field to the dynamic table, evicting older fields to make room.
+  void AddField(std::pair<std::string, std::string> field);
+
+  // Evicts the oldest fields until the table is no larger than
+  // max_table_size_.
+  void EvictFields();
+
+  std::deque<std::pair<std::string, std::string>> dynamic_table_;
+  size_t table_size_;
+  size_t max_table_size_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HPACK_H_
@@ -0,0 +1,209 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/hpack.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<uint8_t> FromHex(const char* hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t index = 0; hex[index] && hex[index + 1]; index += 2) {
+    bytes.push_back(
+        static_cast<uint8_t>(std::stoi(std::string(hex + index, 2), 0, 16)));
+  }
+  return bytes;
+}
+
+bool Decode(HPACKDecoder* decoder, const char* hex, HPACKHeaderList* headers) {
+  const std::vector<uint8_t> block = FromHex(hex);
+  return decoder->Decode(block.data(), block.size(), headers);
+}
+
+// The request examples of RFC 7541 Appendix C.3 (without Huffman coding) and
+// C.4 (with Huffman coding) decode to the same header lists.
+void TestRequestExamples(const char* const blocks[3]) {
+  HPACKDecoder decoder;
+  HPACKHeaderList headers;
+
+  ASSERT_TRUE(Decode(&decoder, blocks[0], &headers));
+  EXPECT_EQ(headers,
+            (HPACKHeaderList{{":method", "GET"},
+                             {":scheme", "http"},
+                             {":path", "/"},
+                             {":authority", "www.example.com"}}));
+  EXPECT_EQ(decoder.TableSize(), 57u);
+
+  ASSERT_TRUE(Decode(&decoder, blocks[1], &headers));
+  EXPECT_EQ(headers,
+            (HPACKHeaderList{{":method", "GET"},
+                             {":scheme", "http"},
+                             {":path", "/"},
+                             {":authority", "www.example.com"},
+                             {"cache-control", "no-cache"}}));
+  EXPECT_EQ(decoder.TableSize(), 110u);
+
+  ASSERT_TRUE(Decode(&decoder, blocks[2], &headers));
+  EXPECT_EQ(headers,
+            (HPACKHeaderList{{":method", "GET"},
+                             {":scheme", "https"},
+                             {":path", "/index.html"},
+                             {":authority", "www.example.com"},
+                             {"custom-key", "custom-value"}}));
+  EXPECT_EQ(decoder.TableSize(), 164u);
+}
+
+TEST(HPACKDecoder, RequestExamples) {
+  static constexpr const char* kBlocks[] = {
+      "828684410f7777772e6578616d706c652e636f6d",
+      "828684be58086e6f2d6361636865",
+      "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565",
+  };
+  TestRequestExamples(kBlocks);
+}
+
+TEST(HPACKDecoder, RequestExamplesHuffman) {
+  static constexpr const char* kBlocks[] = {
+      "828684418cf1e3c2e5f23a6ba0ab90f4ff",
+      "828684be5886a8eb10649cbf",
+      "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf",
+  };
+  TestRequestExamples(kBlocks);
+}
+
+TEST(HPACKDecoder, ResponseExamplesWithEviction) {
+  // RFC 7541 Appendix C.5, which assumes a 256-byte dynamic table. The first
+  // block is preceded by a dynamic table size update to establish that size.
+  HPACKDecoder decoder;
+  HPACKHeaderList headers;
+
+  ASSERT_TRUE(Decode(&decoder,
+                     "3fe101"
+                     "4803333032580770726976617465611d4d6f6e2c203231204f637420"
+                     "323031332032303a31333a323120474d546e1768747470733a2f2f77"
+                     "77772e6578616d706c652e636f6d",
+                     &headers));
+  EXPECT_EQ(headers,
+            (HPACKHeaderList{{":status", "302"},
+                             {"cache-control", "private"},
+                             {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                             {"location", "https://www.example.com"}}));
+  EXPECT_EQ(decoder.TableSize(), 222u);
+
+  // Adding “:status: 307” evicts “:status: 302”.
+  ASSERT_TRUE(Decode(&decoder, "4803333037c1c0bf", &headers));
+  EXPECT_EQ(headers,
+            (HPACKHeaderList{{":status", "307"},
+                             {"cache-control", "private"},
+                             {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                             {"location", "https://www.example.com"}}));
+  EXPECT_EQ(decoder.TableSize(), 222u);
+
+  ASSERT_TRUE(Decode(&decoder,
+                     "88c1611d4d6f6e2c203231204f637420323031332032303a31333a32"
+                     "3220474d54c05a04677a69707738666f6f3d4153444a4b48514b425a"
+                     "584f5157454f50495541585157454f49553b206d61782d6167653d33"
+                     "3630303b2076657273696f6e3d31",
+                     &headers));
+  EXPECT_EQ(headers,
+            (HPACKHeaderList{
+                {":status", "200"},
+                {"cache-control", "private"},
+                {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                {"location", "https://www.example.com"},
+                {"content-encoding", "gzip"},
+                {"set-cookie",
+                 "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}}));
+  EXPECT_EQ(decoder.TableSize(), 215u);
+}
+
+TEST(HPACKDecoder, Malformed) {
+  HPACKHeaderList headers;
+  {
+    // Index 0 is never valid.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "80", &headers));
+  }
+  {
+    // Index 62 is past the static table, and the dynamic table is empty.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "be", &headers));
+  }
+  {
+    // The string is longer than the block.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "4105616263", &headers));
+  }
+  {
+    // Huffman padding must be all ones, here it’s “a” followed by zeroes.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "418118", &headers));
+  }
+  {
+    // Huffman padding may be no longer than 7 bits.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "41821fff", &headers));
+  }
+  {
+    // A dynamic table size update larger than the maximum.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "3fe21f", &headers));
+  }
+  {
+    // A dynamic table size update after a field.
+    HPACKDecoder decoder;
+    EXPECT_FALSE(Decode(&decoder, "8220", &headers));
+  }
+}
+
+TEST(HPACKEncode, RoundTrip) {
+  const HPACKHeaderList kHeaders = {
+      {":method", "POST"},
+      {":scheme", "https"},
+      {":authority", "crash.example.com"},
+      {":path", "/upload?product=Test"},
+      {"content-type", "multipart/form-data; boundary=abc"},
+      {"x-custom", std::string(200, 'x')},
+  };
+
+  std::string block;
+  HPACKEncode(kHeaders, &block);
+
+  // Fields whose name and value are in the static table are indexed.
+  ASSERT_GE(block.size(), 2u);
+  EXPECT_EQ(static_cast<uint8_t>(block[0]), 0x83);
+  EXPECT_EQ(static_cast<uint8_t>(block[1]), 0x87);
+
+  // The same block decodes the same way repeatedly, as the encoder doesn’t
+  // use the dynamic table.
+  HPACKDecoder decoder;
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    HPACKHeaderList headers;
+    ASSERT_TRUE(decoder.Decode(reinterpret_cast<const uint8_t*>(block.data()),
+                               block.size(),
+                               &headers));
+    EXPECT_EQ(headers, kHeaders);
+    EXPECT_EQ(decoder.TableSize(), 0u);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -0,0 +1,752 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A testing https server that speaks HTTP/2, for the HTTPTransport tests that
+// exercise HTTP/2 negotiation, flow control, and retries.
+//
+// Usage: http2_transport_test_server cert.pem key.pem mode
+//
+// When invoked, this server will write a short integer to stdout, indicating on
+// which port the server is listening on the loopback interface. It will then
+// accept any number of connections and respond to every POST request made on
+// them with status 200 and a body of the request body’s size in decimal,
+// followed by "\r\n". Request bodies are consumed as they arrive, and their
+// flow control credit is returned straight away.
+//
+// When stdin reaches end-of-file, the server will write a record of each
+// request that it responded to, in the order it responded, and then terminate.
+// Each record is a line of the form
+//   <protocol> <connection> <stream> <body size>\n
+// followed by the request body. protocol is the protocol selected with ALPN,
+// "h2" or "http/1.1", or "none" if the client didn’t offer ALPN. connection is
+// the connection’s number, counting from 1 in the order they were accepted.
+// stream is the HTTP/2 stream identifier, or 0 for HTTP/1.1.
+//
+// mode is one of:
+//   h2: HTTP/2 is selected, and the initial stream window is 16kB.
+//   http1.1: HTTP/1.1 is selected, and requests must have a Content-Length.
+//   goaway: As h2, but the initial stream window is empty, and each request is
+//       granted a window when its headers arrive, except for the first. That
+//       one is answered with a GOAWAY that excludes its stream, so it’s known
+//       that none of its body was sent.
+//   refuse: As goaway, but the first request is refused with REFUSED_STREAM,
+//       and the connection remains open.
+//
+// The server exits with a nonzero status if a client violates the protocol or
+// the flow control windows.
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/scoped_file.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/scoped_generic.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "util/file/file_io.h"
+#include "util/net/hpack.h"
+
+#include <openssl/ssl.h>
+
+namespace crashpad {
+namespace {
+
+enum class Mode {
+  kHTTP2,
+  kHTTP1,
+  kGoAway,
+  kRefuse,
+};
+
+constexpr char kPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+constexpr size_t kFrameHeaderSize = 9;
+constexpr size_t kMaxFrameSize = 16384;
+constexpr int64_t kDefaultWindowSize = 65535;
+constexpr int64_t kStreamWindowSize = 16384;
+
+constexpr uint8_t kFrameData = 0x0;
+constexpr uint8_t kFrameHeaders = 0x1;
+constexpr uint8_t kFrameRSTStream = 0x3;
+constexpr uint8_t kFrameSettings = 0x4;
+constexpr uint8_t kFramePing = 0x6;
+constexpr uint8_t kFrameGoAway = 0x7;
+constexpr uint8_t kFrameWindowUpdate = 0x8;
+constexpr uint8_t kFrameContinuation = 0x9;
+
+constexpr uint8_t kFlagEndStream = 0x1;
+constexpr uint8_t kFlagAck = 0x1;
+constexpr uint8_t kFlagEndHeaders = 0x4;
+constexpr uint8_t kFlagPadded = 0x8;
+constexpr uint8_t kFlagPriority = 0x20;
+
+constexpr uint16_t kSettingsInitialWindowSize = 0x4;
+
+constexpr uint32_t kErrorNone = 0x0;
+constexpr uint32_t kErrorRefusedStream = 0x7;
+
+struct ScopedSSLCTXTraits {
+  static SSL_CTX* InvalidValue() { return nullptr; }
+  static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
+};
+using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
+
+struct ScopedSSLTraits {
+  static SSL* InvalidValue() { return nullptr; }
+  static void Free(SSL* ssl) { SSL_free(ssl); }
+};
+using ScopedSSL = base::ScopedGeneric<SSL*, ScopedSSLTraits>;
+
+// A request that was responded to.
+struct Request {
+  std::string protocol;
+  int connection;
+  uint32_t stream_id;
+  std::string body;
+};
+
+uint32_t ReadUint32(const uint8_t* data) {
+  return (uint32_t{data[0]} << 24) | (uint32_t{data[1]} << 16) |
+         (uint32_t{data[2]} << 8) | data[3];
+}
+
+void AppendUint32(uint32_t value, std::string* data) {
+  data->push_back(static_cast<char>(value >> 24));
+  data->push_back(static_cast<char>(value >> 16));
+  data->push_back(static_cast<char>(value >> 8));
+  data->push_back(static_cast<char>(value));
+}
+
+// Selects the protocol named by arg, a std::string, if the client offers it.
+int SelectProtocol(SSL* ssl,
+                   const uint8_t** out,
+                   uint8_t* out_length,
+                   const uint8_t* in,
+                   unsigned int in_length,
+                   void* arg) {
+  const std::string* protocol = static_cast<const std::string*>(arg);
+  unsigned int offset = 0;
+  while (offset < in_length) {
+    const unsigned int length = in[offset];
+    if (length > in_length - offset - 1) {
+      break;
+    }
+    if (length == protocol->size() &&
+        memcmp(in + offset + 1, protocol->data(), length) == 0) {
+      *out = in + offset + 1;
+      *out_length = static_cast<uint8_t>(length);
+      return SSL_TLSEXT_ERR_OK;
+    }
+    offset += 1 + length;
+  }
+  return SSL_TLSEXT_ERR_ALERT_FATAL;
+}
+
+// A connection accepted from a client, served one frame, or one HTTP/1.1
+// request, at a time as data arrives. The socket is left blocking, so reads are
+// only made after poll() finds that data is available, and writes, which are
+// all small, complete before returning.
+class Connection {
+ public:
+  Connection(int number, base::ScopedFD sock, Mode mode, bool* rejected)
+      : sock_(std::move(sock)),
+        ssl_(),
+        decoder_(),
+        streams_(),
+        input_(),
+        header_block_(),
+        protocol_(),
+        number_(number),
+        mode_(mode),
+        rejected_(rejected),
+        receive_window_(kDefaultWindowSize),
+        continuation_stream_id_(0),
+        continuation_end_stream_(false),
+        last_stream_id_(0),
+        http2_(false),
+        preface_received_(false),
+        going_away_(false) {}
+
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  ~Connection() = default;
+
+  int fd() const { return sock_.get(); }
+
+  // Completes the TLS handshake and, for HTTP/2, sends the server’s connection
+  // preface. Returns false on failure, with a message logged.
+  bool Initialize(SSL_CTX* ctx) {
+    ssl_.reset(SSL_new(ctx));
+    if (!ssl_.is_valid() || !SSL_set_fd(ssl_.get(), sock_.get())) {
+      LOG(ERROR) << "SSL_new";
+      return false;
+    }
+    if (SSL_accept(ssl_.get()) <= 0) {
+      LOG(ERROR) << "SSL_accept";
+      return false;
+    }
+
+    const uint8_t* protocol;
+    unsigned int protocol_length;
+    SSL_get0_alpn_selected(ssl_.get(), &protocol, &protocol_length);
+    protocol_ = protocol_length > 0
+                    ? std::string(reinterpret_cast<const char*>(protocol),
+                                  protocol_length)
+                    : "none";
+    http2_ = protocol_ == "h2";
+    if (!http2_) {
+      if (mode_ != Mode::kHTTP1) {
+        LOG(ERROR) << "HTTP/2 not negotiated";
+        return false;
+      }
+      return true;
+    }
+
+    std::string settings;
+    settings.push_back(0);
+    settings.push_back(kSettingsInitialWindowSize);
+    AppendUint32(InitialStreamWindowSize(), &settings);
+    return WriteFrame(kFrameSettings, 0, 0, settings);
+  }
+
+  // Whether data that has already been read from the socket is waiting to be
+  // processed.
+  bool HasBufferedData() const { return SSL_pending(ssl_.get()) > 0; }
+
+  // Reads the data that’s available and processes it, adding requests that are
+  // responded to to requests. Returns false once the connection should be
+  // closed, with error set to true if that’s because the client violated the
+  // protocol.
+  bool Service(std::vector<Request>* requests, bool* error) {
+    *error = false;
+    char buffer[kMaxFrameSize];
+    const int rv = SSL_read(ssl_.get(), buffer, sizeof(buffer));
+    if (rv <= 0) {
+      // The client closed the connection.
+      return false;
+    }
+    input_.append(buffer, rv);
+
+    if (!(http2_ ? ProcessFrames(requests) : ProcessHTTP1(requests))) {
+      *error = true;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  struct Stream {
+    std::string body;
+    int64_t receive_window;
+  };
+
+  int64_t InitialStreamWindowSize() const {
+    return mode_ == Mode::kGoAway || mode_ == Mode::kRefuse
+               ? 0
+               : kStreamWindowSize;
+  }
+
+  bool ProcessHTTP1(std::vector<Request>* requests) {
+    for (;;) {
+      const size_t headers_end = input_.find("\r\n\r\n");
+      if (headers_end == std::string::npos) {
+        return true;
+      }
+
+      size_t content_length = 0;
+      bool have_content_length = false;
+      size_t line_start = input_.find("\r\n") + 2;
+      while (line_start < headers_end + 2) {
+        const size_t line_end = input_.find("\r\n", line_start);
+        const std::string line =
+            input_.substr(line_start, line_end - line_start);
+        static constexpr char kContentLength[] = "content-length:";
+        if (strncasecmp(line.c_str(), kContentLength, strlen(kContentLength)) ==
+            0) {
+          std::string value = line.substr(strlen(kContentLength));
+          value.erase(0, value.find_first_not_of(' '));
+          have_content_length = base::StringToSizeT(value, &content_length);
+        }
+        line_start = line_end + 2;
+      }
+      if (!have_content_length) {
+        LOG(ERROR) << "Content-Length missing";
+        return false;
+      }
+
+      const size_t body_start = headers_end + 4;
+      if (input_.size() - body_start < content_length) {
+        return true;
+      }
+
+      Request request = {
+          protocol_, number_, 0, input_.substr(body_start, content_length)};
+      input_.erase(0, body_start + content_length);
+      const std::string body =
+          base::StringPrintf("%zu\r\n", request.body.size());
+      requests->push_back(std::move(request));
+      if (!Write(base::StringPrintf("HTTP/1.1 200 OK\r\n"
+                                    "Content-Type: text/plain\r\n"
+                                    "Content-Length: %zu\r\n"
+                                    "\r\n",
+                                    body.size()) +
+                 body)) {
+        return false;
+      }
+    }
+  }
+
+  bool ProcessFrames(std::vector<Request>* requests) {
+    if (!preface_received_) {
+      if (input_.size() < strlen(kPreface)) {
+        return true;
+      }
+      if (input_.compare(0, strlen(kPreface), kPreface) != 0) {
+        LOG(ERROR) << "HTTP/2 client preface missing";
+        return false;
+      }
+      input_.erase(0, strlen(kPreface));
+      preface_received_ = true;
+    }
+
+    size_t offset = 0;
+    while (input_.size() - offset >= kFrameHeaderSize) {
+      const uint8_t* header =
+          reinterpret_cast<const uint8_t*>(input_.data() + offset);
+      const size_t length = ReadUint32(header) >> 8;
+      if (length > kMaxFrameSize) {
+        LOG(ERROR) << "HTTP/2 frame too large";
+        return false;
+      }
+      if (input_.size() - offset - kFrameHeaderSize < length) {
+        break;
+      }
+      if (!ProcessFrame(header[3],
+                        header[4],
+                        ReadUint32(header + 5) & 0x7fffffff,
+                        header + kFrameHeaderSize,
+                        length,
+                        requests)) {
+        return false;
+      }
+      offset += kFrameHeaderSize + length;
+    }
+    input_.erase(0, offset);
+    return true;
+  }
+
+  bool ProcessFrame(uint8_t type,
+                    uint8_t flags,
+                    uint32_t stream_id,
+                    const uint8_t* payload,
+                    size_t length,
+                    std::vector<Request>* requests) {
+    if (continuation_stream_id_ != 0 &&
+        (type != kFrameContinuation || stream_id != continuation_stream_id_)) {
+      LOG(ERROR) << "HTTP/2 CONTINUATION expected";
+      return false;
+    }
+
+    switch (type) {
+      case kFrameData:
+      case kFrameHeaders: {
+        if (stream_id == 0) {
+          LOG(ERROR) << "HTTP/2 frame on stream 0";
+          return false;
+        }
+        size_t skip = 0;
+        size_t padding = 0;
+        if (flags & kFlagPadded) {
+          skip = 1;
+          padding = length > 0 ? payload[0] : 0;
+        }
+        if (type == kFrameHeaders && (flags & kFlagPriority)) {
+          skip += 5;
+        }
+        if (skip + padding > length) {
+          LOG(ERROR) << "HTTP/2 padding too large";
+          return false;
+        }
+
+        if (type == kFrameData) {
+          return ProcessData(stream_id,
+                             flags,
+                             payload + skip,
+                             length - skip - padding,
+                             length,
+                             requests);
+        }
+        header_block_.assign(reinterpret_cast<const char*>(payload + skip),
+                             length - skip - padding);
+        continuation_end_stream_ = (flags & kFlagEndStream) != 0;
+        break;
+      }
+
+      case kFrameContinuation:
+        if (continuation_stream_id_ == 0) {
+          LOG(ERROR) << "HTTP/2 CONTINUATION unexpected";
+          return false;
+        }
+        header_block_.append(reinterpret_cast<const char*>(payload), length);
+        break;
+
+      case kFrameRSTStream:
+        streams_.erase(stream_id);
+        return true;
+
+      case kFrameSettings:
+        if (stream_id != 0 || length % 6 != 0) {
+          LOG(ERROR) << "HTTP/2 SETTINGS invalid";
+          return false;
+        }
+        return (flags & kFlagAck) ||
+               WriteFrame(kFrameSettings, kFlagAck, 0, std::string());
+
+      case kFramePing:
+        return (flags & kFlagAck) ||
+               WriteFrame(kFramePing,
+                          kFlagAck,
+                          0,
+                          std::string(reinterpret_cast<const char*>(payload),
+                                      length));
+
+      default:
+        // The client’s WINDOW_UPDATE frames are of no interest, because every
+        // response fits in the initial windows.
+        return true;
+    }
+
+    if (!(flags & kFlagEndHeaders)) {
+      continuation_stream_id_ = stream_id;
+      return true;
+    }
+    continuation_stream_id_ = 0;
+    return ProcessHeaderBlock(stream_id, continuation_end_stream_, requests);
+  }
+
+  bool ProcessHeaderBlock(uint32_t stream_id,
+                          bool end_stream,
+                          std::vector<Request>* requests) {
+    HPACKHeaderList headers;
+    if (!decoder_.Decode(reinterpret_cast<const uint8_t*>(header_block_.data()),
+                         header_block_.size(),
+                         &headers)) {
+      return false;
+    }
+
+    // Streams that the client opens after GOAWAY are ignored.
+    if (going_away_ && stream_id > last_stream_id_) {
+      return true;
+    }
+    if (stream_id <= last_stream_id_ || streams_.count(stream_id)) {
+      LOG(ERROR) << "HTTP/2 stream identifier reused";
+      return false;
+    }
+    if (headers.empty() || headers[0] != std::make_pair(std::string(":method"),
+                                                        std::string("POST"))) {
+      LOG(ERROR) << "HTTP/2 request method unexpected";
+      return false;
+    }
+
+    // The first request isn’t granted a window, so the client can’t have sent
+    // any of its body when it learns that the request won’t be processed.
+    if ((mode_ == Mode::kGoAway || mode_ == Mode::kRefuse) && !*rejected_) {
+      *rejected_ = true;
+      std::string payload;
+      if (mode_ == Mode::kGoAway) {
+        going_away_ = true;
+        AppendUint32(last_stream_id_, &payload);
+        AppendUint32(kErrorNone, &payload);
+        return WriteFrame(kFrameGoAway, 0, 0, payload);
+      }
+      last_stream_id_ = stream_id;
+      AppendUint32(kErrorRefusedStream, &payload);
+      return WriteFrame(kFrameRSTStream, 0, stream_id, payload);
+    }
+    last_stream_id_ = stream_id;
+
+    streams_[stream_id] = {std::string(), InitialStreamWindowSize()};
+    if (end_stream) {
+      return Respond(stream_id, requests);
+    }
+    if (InitialStreamWindowSize() == 0) {
+      streams_[stream_id].receive_window = kStreamWindowSize;
+      std::string increment;
+      AppendUint32(kStreamWindowSize, &increment);
+      return WriteFrame(kFrameWindowUpdate, 0, stream_id, increment);
+    }
+    return true;
+  }
+
+  // frame_length includes any padding, which counts against the flow control
+  // windows.
+  bool ProcessData(uint32_t stream_id,
+                   uint8_t flags,
+                   const uint8_t* payload,
+                   size_t length,
+                   size_t frame_length,
+                   std::vector<Request>* requests) {
+    receive_window_ -= frame_length;
+    if (receive_window_ < 0) {
+      LOG(ERROR) << "HTTP/2 connection window exceeded";
+      return false;
+    }
+    if (frame_length > 0) {
+      std::string increment;
+      AppendUint32(static_cast<uint32_t>(frame_length), &increment);
+      if (!WriteFrame(kFrameWindowUpdate, 0, 0, increment)) {
+        return false;
+      }
+      receive_window_ += frame_length;
+    }
+
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+      // An ignored or refused stream.
+      return true;
+    }
+    Stream& stream = it->second;
+    stream.receive_window -= frame_length;
+    if (stream.receive_window < 0) {
+      LOG(ERROR) << "HTTP/2 stream window exceeded";
+      return false;
+    }
+    stream.body.append(reinterpret_cast<const char*>(payload), length);
+
+    if (flags & kFlagEndStream) {
+      return Respond(stream_id, requests);
+    }
+    if (frame_length > 0) {
+      std::string increment;
+      AppendUint32(static_cast<uint32_t>(frame_length), &increment);
+      if (!WriteFrame(kFrameWindowUpdate, 0, stream_id, increment)) {
+        return false;
+      }
+      stream.receive_window += frame_length;
+    }
+    return true;
+  }
+
+  bool Respond(uint32_t stream_id, std::vector<Request>* requests) {
+    auto it = streams_.find(stream_id);
+    Request request = {
+        protocol_, number_, stream_id, std::move(it->second.body)};
+    streams_.erase(it);
+    const std::string body = base::StringPrintf("%zu\r\n", request.body.size());
+    requests->push_back(std::move(request));
+
+    std::string header_block;
+    HPACKEncode({{":status", "200"},
+                 {"content-type", "text/plain"},
+                 {"content-length", base::NumberToString(body.size())}},
+                &header_block);
+    return WriteFrame(
+               kFrameHeaders, kFlagEndHeaders, stream_id, header_block) &&
+           WriteFrame(kFrameData, kFlagEndStream, stream_id, body);
+  }
+
+  bool WriteFrame(uint8_t type,
+                  uint8_t flags,
+                  uint32_t stream_id,
+                  const std::string& payload) {
+    std::string frame;
+    AppendUint32(static_cast<uint32_t>(payload.size() << 8) | type, &frame);
+    frame.push_back(static_cast<char>(flags));
+    AppendUint32(stream_id, &frame);
+    frame.append(payload);
+    return Write(frame);
+  }
+
+  bool Write(const std::string& data) {
+    if (SSL_write(ssl_.get(), data.data(), base::checked_cast<int>(data.size()))
+        <= 0) {
+      LOG(ERROR) << "SSL_write";
+      return false;
+    }
+    return true;
+  }
+
+  // ssl_ refers to sock_, so it’s declared after sock_ in order to be destroyed
+  // first.
+  base::ScopedFD sock_;
+  ScopedSSL ssl_;
+  HPACKDecoder decoder_;
+  std::map<uint32_t, Stream> streams_;
+  std::string input_;
+  std::string header_block_;
+  std::string protocol_;
+  int number_;
+  Mode mode_;
+  bool* rejected_;  // weak
+  int64_t receive_window_;
+  uint32_t continuation_stream_id_;
+  bool continuation_end_stream_;
+  uint32_t last_stream_id_;
+  bool http2_;
+  bool preface_received_;
+  bool going_away_;
+};
+
+int HTTP2TransportTestServerMain(int argc, char* argv[]) {
+  static constexpr struct {
+    const char* name;
+    Mode mode;
+  } kModes[] = {
+      {"h2", Mode::kHTTP2},
+      {"http1.1", Mode::kHTTP1},
+      {"goaway", Mode::kGoAway},
+      {"refuse", Mode::kRefuse},
+  };
+  const auto* mode = argc == 4 ? std::find_if(std::begin(kModes),
+                                              std::end(kModes),
+                                              [argv](const auto& candidate) {
+                                                return strcmp(candidate.name,
+                                                              argv[3]) == 0;
+                                              })
+                               : std::end(kModes);
+  if (mode == std::end(kModes)) {
+    LOG(ERROR) << "usage: http2_transport_test_server cert.pem key.pem "
+                  "h2|http1.1|goaway|refuse";
+    return 1;
+  }
+
+  ScopedSSLCTX ctx(SSL_CTX_new(TLS_server_method()));
+  if (!ctx.is_valid() ||
+      SSL_CTX_use_certificate_chain_file(ctx.get(), argv[1]) != 1 ||
+      SSL_CTX_use_PrivateKey_file(ctx.get(), argv[2], SSL_FILETYPE_PEM) != 1) {
+    LOG(ERROR) << "SSL_CTX";
+    return 1;
+  }
+  std::string protocol(mode->mode == Mode::kHTTP1 ? "http/1.1" : "h2");
+  SSL_CTX_set_alpn_select_cb(ctx.get(), SelectProtocol, &protocol);
+
+  base::ScopedFD listen_sock(socket(AF_INET, SOCK_STREAM, 0));
+  if (!listen_sock.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return 1;
+  }
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  if (bind(listen_sock.get(),
+           reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listen_sock.get(), SOMAXCONN) != 0 ||
+      getsockname(listen_sock.get(),
+                  reinterpret_cast<sockaddr*>(&address),
+                  &address_length) != 0) {
+    PLOG(ERROR) << "bind";
+    return 1;
+  }
+
+  const uint16_t port = ntohs(address.sin_port);
+  CheckedWriteFile(
+      StdioFileHandle(StdioStream::kStandardOutput), &port, sizeof(port));
+
+  std::vector<std::unique_ptr<Connection>> connections;
+  std::vector<Request> requests;
+  int connection_count = 0;
+  bool rejected = false;
+  bool ok = true;
+  for (;;) {
+    std::vector<pollfd> pollfds = {
+        {StdioFileHandle(StdioStream::kStandardInput), POLLIN, 0},
+        {listen_sock.get(), POLLIN, 0}};
+    bool buffered = false;
+    for (const auto& connection : connections) {
+      pollfds.push_back({connection->fd(), POLLIN, 0});
+      buffered |= connection->HasBufferedData();
+    }
+    if (HANDLE_EINTR(poll(pollfds.data(), pollfds.size(), buffered ? 0 : -1)) <
+        0) {
+      PLOG(ERROR) << "poll";
+      return 1;
+    }
+
+    if (pollfds[0].revents) {
+      char byte;
+      if (ReadFile(
+              StdioFileHandle(StdioStream::kStandardInput), &byte, 1) <= 0) {
+        break;
+      }
+    }
+
+    // Connections are serviced in reverse so that closing one doesn’t disturb
+    // the correspondence between the rest and pollfds.
+    for (size_t index = connections.size(); index > 0; --index) {
+      Connection* connection = connections[index - 1].get();
+      if (!pollfds[index + 1].revents && !connection->HasBufferedData()) {
+        continue;
+      }
+      bool error;
+      if (!connection->Service(&requests, &error)) {
+        ok &= !error;
+        connections.erase(connections.begin() + index - 1);
+      }
+    }
+
+    if (pollfds[1].revents) {
+      base::ScopedFD sock(
+          HANDLE_EINTR(accept(listen_sock.get(), nullptr, nullptr)));
+      if (!sock.is_valid()) {
+        PLOG(ERROR) << "accept";
+        return 1;
+      }
+      auto connection = std::make_unique<Connection>(
+          ++connection_count, std::move(sock), mode->mode, &rejected);
+      if (connection->Initialize(ctx.get())) {
+        connections.push_back(std::move(connection));
+      } else {
+        ok = false;
+      }
+    }
+  }
+
+  std::string report;
+  for (const Request& request : requests) {
+    report += base::StringPrintf("%s %d %u %zu\n",
+                                 request.protocol.c_str(),
+                                 request.connection,
+                                 request.stream_id,
+                                 request.body.size());
+    report += request.body;
+  }
+  LoggingWriteFile(StdioFileHandle(StdioStream::kStandardOutput),
+                   report.data(),
+                   report.size());
+
+  return ok ? 0 : 1;
+}
+
+}  // namespace
+}  // namespace crashpad
+
+int main(int argc, char* argv[]) {
+  return crashpad::HTTP2TransportTestServerMain(argc, argv);
+}
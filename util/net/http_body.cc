@@ -14,16 +14,30 @@
 
 #include "util/net/http_body.h"
 
+#include <stdio.h>
 #include <string.h>
 
 #include <algorithm>
 #include <limits>
 
 #include "base/check.h"
+#include "base/notreached.h"
+#include "base/numerics/safe_conversions.h"
 #include "util/misc/implicit_cast.h"
 
 namespace crashpad {
 
+FileOperationResult HTTPBodyStream::GetFileRegion(FileHandle* file,
+                                                  FileOffset* offset,
+                                                  size_t max_len) {
+  return 0;
+}
+
+bool HTTPBodyStream::ConsumeFileRegion(size_t size) {
+  NOTREACHED();
+  return false;
+}
+
 StringHTTPBodyStream::StringHTTPBodyStream(const std::string& string)
     : HTTPBodyStream(), string_(string), bytes_read_() {
 }
@@ -47,7 +61,11 @@ FileOperationResult StringHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
 }
 
 FileReaderHTTPBodyStream::FileReaderHTTPBodyStream(FileReaderInterface* reader)
-    : HTTPBodyStream(), reader_(reader), reached_eof_(false) {
+    : FileReaderHTTPBodyStream(reader, kInvalidFileHandle) {}
+
+FileReaderHTTPBodyStream::FileReaderHTTPBodyStream(FileReaderInterface* reader,
+                                                   FileHandle file)
+    : HTTPBodyStream(), reader_(reader), file_(file), reached_eof_(false) {
   DCHECK(reader_);
 }
 
@@ -66,6 +84,40 @@ FileOperationResult FileReaderHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return rv;
 }
 
+FileOperationResult FileReaderHTTPBodyStream::GetFileRegion(FileHandle* file,
+                                                            FileOffset* offset,
+                                                            size_t max_len) {
+  if (reached_eof_ || file_ == kInvalidFileHandle) {
+    return 0;
+  }
+
+  // reader_ reads from file_, so its position is the offset in file_ of the
+  // stream’s next byte.
+  const FileOffset position = reader_->SeekGet();
+  if (position < 0) {
+    return -1;
+  }
+  const FileOffset size = LoggingFileSizeByHandle(file_);
+  if (size < 0) {
+    return -1;
+  }
+  if (size <= position) {
+    // Leave it to GetBytesBuffer() to find the end of the file.
+    return 0;
+  }
+
+  *file = file_;
+  *offset = position;
+  return std::min(
+      std::min(implicit_cast<uint64_t>(size - position),
+               implicit_cast<uint64_t>(max_len)),
+      implicit_cast<uint64_t>(std::numeric_limits<FileOperationResult>::max()));
+}
+
+bool FileReaderHTTPBodyStream::ConsumeFileRegion(size_t size) {
+  return reader_->Seek(base::checked_cast<FileOffset>(size), SEEK_CUR) >= 0;
+}
+
 CompositeHTTPBodyStream::CompositeHTTPBodyStream(
     const CompositeHTTPBodyStream::PartsList& parts)
     : HTTPBodyStream(), parts_(parts), current_part_(parts_.begin()) {
@@ -100,4 +152,20 @@ FileOperationResult CompositeHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
   return bytes_copied;
 }
 
+FileOperationResult CompositeHTTPBodyStream::GetFileRegion(FileHandle* file,
+                                                           FileOffset* offset,
+                                                           size_t max_len) {
+  // Only the current part is considered. If it has no region, GetBytesBuffer()
+  // advances through the parts.
+  if (current_part_ == parts_.end()) {
+    return 0;
+  }
+  return (*current_part_)->GetFileRegion(file, offset, max_len);
+}
+
+bool CompositeHTTPBodyStream::ConsumeFileRegion(size_t size) {
+  DCHECK(current_part_ != parts_.end());
+  return (*current_part_)->ConsumeFileRegion(size);
+}
+
 }  // namespace crashpad
@@ -44,6 +44,36 @@ class HTTPBodyStream {
   virtual FileOperationResult GetBytesBuffer(uint8_t* buffer,
                                              size_t max_len) = 0;
 
+  //! \brief Obtains the file that holds the stream’s next bytes, if any, so
+  //!     that they can be sent without being copied into a buffer.
+  //!
+  //! A transport able to send directly from a file, for example with
+  //! `sendfile()`, may call this before GetBytesBuffer(). If a region is
+  //! returned, the transport sends some or all of it from the file and then
+  //! calls ConsumeFileRegion(). Otherwise, the transport obtains the next
+  //! bytes from GetBytesBuffer().
+  //!
+  //! The default implementation never returns a region.
+  //!
+  //! \param[out] file The file holding the next bytes. This remains owned by
+  //!     the stream.
+  //! \param[out] offset The offset of the next byte in \a file.
+  //! \param[in] max_len The maximum size of the region to return.
+  //!
+  //! \return On success, a positive number indicating the size of the region
+  //!     at \a offset in \a file, at most \a max_len. `0` if the next bytes
+  //!     aren’t available from a file or the stream has no more data. On
+  //!     failure, a negative number.
+  virtual FileOperationResult GetFileRegion(FileHandle* file,
+                                            FileOffset* offset,
+                                            size_t max_len);
+
+  //! \brief Advances the stream past \a size bytes of the region returned by
+  //!     GetFileRegion() after they have been sent from the file.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  virtual bool ConsumeFileRegion(size_t size);
+
  protected:
   HTTPBodyStream() {}
 };
@@ -80,6 +110,16 @@ class FileReaderHTTPBodyStream : public HTTPBodyStream {
   //!     will read.
   explicit FileReaderHTTPBodyStream(FileReaderInterface* reader);
 
+  //! \brief Creates a stream for reading from a FileReaderInterface that
+  //!     reads from \a file, allowing the stream’s contents to be sent from
+  //!     \a file by a transport that uses GetFileRegion().
+  //!
+  //! \param[in] reader A FileReaderInterface from which this HTTPBodyStream
+  //!     will read.
+  //! \param[in] file The file that \a reader reads from, or
+  //!     kInvalidFileHandle. The caller retains ownership of \a file.
+  FileReaderHTTPBodyStream(FileReaderInterface* reader, FileHandle file);
+
   FileReaderHTTPBodyStream(const FileReaderHTTPBodyStream&) = delete;
   FileReaderHTTPBodyStream& operator=(const FileReaderHTTPBodyStream&) = delete;
 
@@ -87,9 +127,14 @@ class FileReaderHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  FileOperationResult GetFileRegion(FileHandle* file,
+                                    FileOffset* offset,
+                                    size_t max_len) override;
+  bool ConsumeFileRegion(size_t size) override;
 
  private:
   FileReaderInterface* reader_;  // weak
+  FileHandle file_;  // weak
   bool reached_eof_;
 };
 
@@ -114,6 +159,10 @@ class CompositeHTTPBodyStream : public HTTPBodyStream {
 
   // HTTPBodyStream:
   FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+  FileOperationResult GetFileRegion(FileHandle* file,
+                                    FileOffset* offset,
+                                    size_t max_len) override;
+  bool ConsumeFileRegion(size_t size) override;
 
  private:
   PartsList parts_;
@@ -14,20 +14,107 @@
 
 #include "util/net/http_body_gzip.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 #include "third_party/zlib/zlib_crashpad.h"
 #include "util/misc/zlib.h"
+#include "util/thread/run_concurrently.h"
 
 namespace crashpad {
 
-GzipHTTPBodyStream::GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source)
+namespace {
+
+// The default values for zlib’s internal MAX_WBITS and DEF_MEM_LEVEL. These are
+// the values that deflateInit() would use, but they’re not exported from zlib.
+constexpr int kZlibMaxWindowBits = 15;
+constexpr int kZlibDefaultMemoryLevel = 8;
+
+// The amount of input compressed by each thread at a time in parallel mode,
+// and the amount of the preceding input used to prime it, which is the size of
+// deflate’s window. These match pigz’s defaults.
+constexpr size_t kParallelBlockSize = 128 * 1024;
+constexpr size_t kDictionarySize = 32 * 1024;
+
+void AppendUint32LE(uint32_t value, std::string* data) {
+  for (size_t byte = 0; byte < sizeof(value); ++byte) {
+    data->push_back(static_cast<char>(value >> (byte * 8)));
+  }
+}
+
+// Compresses block as a raw deflate stream, primed with dictionary. Unless
+// final is true, the output ends with a sync flush instead of a final block, so
+// that the next block’s output can follow it within the same deflate stream.
+bool DeflateBlock(const std::string& block,
+                  const std::string& dictionary,
+                  bool final,
+                  std::string* output) {
+  z_stream stream = {};
+  int zr = deflateInit2(&stream,
+                        Z_DEFAULT_COMPRESSION,
+                        Z_DEFLATED,
+                        -kZlibMaxWindowBits,
+                        kZlibDefaultMemoryLevel,
+                        Z_DEFAULT_STRATEGY);
+  if (zr != Z_OK) {
+    LOG(ERROR) << "deflateInit2: " << ZlibErrorString(zr);
+    return false;
+  }
+
+  if (!dictionary.empty()) {
+    zr = deflateSetDictionary(
+        &stream,
+        reinterpret_cast<const Bytef*>(dictionary.data()),
+        base::checked_cast<uInt>(dictionary.size()));
+    if (zr != Z_OK) {
+      LOG(ERROR) << "deflateSetDictionary: " << ZlibErrorString(zr);
+      deflateEnd(&stream);
+      return false;
+    }
+  }
+
+  // Leave room for the sync flush’s empty stored block as well.
+  output->resize(deflateBound(&stream, block.size()) + 8);
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(block.data()));
+  stream.avail_in = base::checked_cast<uInt>(block.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+  stream.avail_out = base::checked_cast<uInt>(output->size());
+
+  zr = deflate(&stream, final ? Z_FINISH : Z_SYNC_FLUSH);
+  const bool success = final ? zr == Z_STREAM_END
+                             : zr == Z_OK && stream.avail_in == 0 &&
+                                   stream.avail_out > 0;
+  if (!success) {
+    LOG(ERROR) << "deflate: " << ZlibErrorString(zr);
+  }
+  output->resize(output->size() - stream.avail_out);
+
+  // Unless the stream was finished, deflateEnd() reports that output was
+  // discarded, which is expected here.
+  deflateEnd(&stream);
+  return success;
+}
+
+}  // namespace
+
+GzipHTTPBodyStream::GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                                       size_t threads)
     : input_(),
       source_(std::move(source)),
       z_stream_(new z_stream()),
+      threads_(threads),
+      output_(),
+      output_offset_(0),
+      dictionary_(),
+      crc_(0),
+      input_size_(0),
       state_(State::kUninitialized) {}
 
 GzipHTTPBodyStream::~GzipHTTPBodyStream() {
@@ -42,6 +129,10 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
     return -1;
   }
 
+  if (threads_ > 1) {
+    return GetBytesBufferParallel(buffer, max_len);
+  }
+
   if (state_ == State::kFinished) {
     return 0;
   }
@@ -51,13 +142,7 @@ FileOperationResult GzipHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
     z_stream_->zfree = Z_NULL;
     z_stream_->opaque = Z_NULL;
 
-    // The default values for zlib’s internal MAX_WBITS and DEF_MEM_LEVEL. These
-    // are the values that deflateInit() would use, but they’re not exported
-    // from zlib. deflateInit2() is used instead of deflateInit() to get the
-    // gzip wrapper.
-    constexpr int kZlibMaxWindowBits = 15;
-    constexpr int kZlibDefaultMemoryLevel = 8;
-
+    // deflateInit2() is used instead of deflateInit() to get the gzip wrapper.
     int zr = deflateInit2(z_stream_.get(),
                           Z_DEFAULT_COMPRESSION,
                           Z_DEFLATED,
@@ -124,4 +209,110 @@ void GzipHTTPBodyStream::Done(State state) {
   }
 }
 
+FileOperationResult GzipHTTPBodyStream::GetBytesBufferParallel(
+    uint8_t* buffer,
+    size_t max_len) {
+  size_t bytes_copied = 0;
+  while (bytes_copied < max_len) {
+    if (output_offset_ == output_.size()) {
+      if (state_ == State::kFinished) {
+        break;
+      }
+      output_.clear();
+      output_offset_ = 0;
+      if (!CompressBlocks()) {
+        state_ = State::kError;
+        return -1;
+      }
+      continue;
+    }
+
+    const size_t bytes =
+        std::min(max_len - bytes_copied, output_.size() - output_offset_);
+    memcpy(buffer + bytes_copied, &output_[output_offset_], bytes);
+    output_offset_ += bytes;
+    bytes_copied += bytes;
+  }
+
+  return base::checked_cast<FileOperationResult>(bytes_copied);
+}
+
+bool GzipHTTPBodyStream::CompressBlocks() {
+  if (state_ == State::kUninitialized) {
+    // A gzip header (RFC 1952 §2.3) with no modification time, no optional
+    // fields, and an unknown operating system.
+    static constexpr char kGzipHeader[] = {
+        '\x1f', '\x8b', Z_DEFLATED, 0, 0, 0, 0, 0, 0, '\xff'};
+    output_.append(kGzipHeader, sizeof(kGzipHeader));
+    crc_ = crc32(0, Z_NULL, 0);
+    state_ = State::kOperating;
+  }
+
+  // The source can only be read from one thread, so read the blocks first.
+  std::vector<std::string> blocks;
+  while (blocks.size() < threads_ && state_ == State::kOperating) {
+    std::string block(kParallelBlockSize, '\0');
+    size_t block_size = 0;
+    while (block_size < block.size()) {
+      const FileOperationResult bytes = source_->GetBytesBuffer(
+          reinterpret_cast<uint8_t*>(&block[block_size]),
+          block.size() - block_size);
+      if (bytes < 0) {
+        return false;
+      }
+      if (bytes == 0) {
+        state_ = State::kInputEOF;
+        break;
+      }
+      block_size += bytes;
+    }
+    block.resize(block_size);
+
+    crc_ = crc32(crc_,
+                 reinterpret_cast<const Bytef*>(block.data()),
+                 base::checked_cast<uInt>(block.size()));
+    input_size_ += static_cast<uint32_t>(block.size());
+    blocks.push_back(std::move(block));
+  }
+
+  // Each block is primed with the end of the block before it.
+  std::vector<std::string> dictionaries(blocks.size());
+  dictionaries[0] = std::move(dictionary_);
+  for (size_t index = 1; index < blocks.size(); ++index) {
+    const std::string& previous = blocks[index - 1];
+    dictionaries[index] = previous.substr(
+        previous.size() - std::min(previous.size(), kDictionarySize));
+  }
+  const std::string& last = blocks.back();
+  dictionary_ =
+      last.substr(last.size() - std::min(last.size(), kDictionarySize));
+
+  std::vector<std::string> compressed(blocks.size());
+  std::unique_ptr<bool[]> succeeded(new bool[blocks.size()]);
+  const bool finished_input = state_ == State::kInputEOF;
+  RunConcurrently(blocks.size(), threads_, [&](size_t index) {
+    succeeded[index] =
+        DeflateBlock(blocks[index],
+                     dictionaries[index],
+                     finished_input && index == blocks.size() - 1,
+                     &compressed[index]);
+  });
+
+  for (size_t index = 0; index < blocks.size(); ++index) {
+    if (!succeeded[index]) {
+      return false;
+    }
+    output_.append(compressed[index]);
+  }
+
+  if (finished_input) {
+    // The gzip trailer (RFC 1952 §2.3.1): the CRC-32 and size, modulo 2^32, of
+    // the uncompressed data.
+    AppendUint32LE(crc_, &output_);
+    AppendUint32LE(input_size_, &output_);
+    state_ = State::kFinished;
+  }
+  return true;
+}
+
 }  // namespace crashpad
@@ -15,10 +15,12 @@
 #ifndef CRASHPAD_UTIL_NET_HTTP_BODY_GZIP_H_
 #define CRASHPAD_UTIL_NET_HTTP_BODY_GZIP_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/types.h>
 
 #include <memory>
+#include <string>
 
 #include "util/file/file_io.h"
 #include "util/net/http_body.h"
@@ -33,7 +35,15 @@ namespace crashpad {
 //!     HTTPBodyStream.
 class GzipHTTPBodyStream : public HTTPBodyStream {
  public:
-  explicit GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source);
+  //! \param[in] source The stream to compress.
+  //! \param[in] threads The number of threads to compress with, including the
+  //!     calling thread. When this is greater than `1`, \a source is divided
+  //!     into independent blocks, as pigz does, which are compressed
+  //!     concurrently and joined into a single `gzip` member. Each block is
+  //!     primed with the end of the one before it, so that little compression
+  //!     is lost.
+  explicit GzipHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                              size_t threads = 1);
 
   GzipHTTPBodyStream(const GzipHTTPBodyStream&) = delete;
   GzipHTTPBodyStream& operator=(const GzipHTTPBodyStream&) = delete;
@@ -56,9 +66,27 @@ class GzipHTTPBodyStream : public HTTPBodyStream {
   // logs a message and transitions state_ to State::kError.
   void Done(State state);
 
+  // Implements GetBytesBuffer() when threads_ is greater than 1.
+  FileOperationResult GetBytesBufferParallel(uint8_t* buffer, size_t max_len);
+
+  // Reads up to threads_ blocks from source_ and appends their compressed
+  // form to output_. Returns false on failure with a message logged.
+  bool CompressBlocks();
+
   uint8_t input_[4096];
   std::unique_ptr<HTTPBodyStream> source_;
   std::unique_ptr<z_stream> z_stream_;
+  size_t threads_;
+
+  // Used when threads_ is greater than 1. output_ holds compressed data not yet
+  // returned, from output_offset_ on. dictionary_ holds the end of the last
+  // block compressed, to prime the next one.
+  std::string output_;
+  size_t output_offset_;
+  std::string dictionary_;
+  uint32_t crc_;
+  uint32_t input_size_;
+
   State state_;
 };
 
@@ -78,10 +78,10 @@ void GzipInflate(const std::string& compressed,
                        buf_size - zlib.avail_out);
 }
 
-void TestGzipDeflateInflate(const std::string& string) {
+void TestGzipDeflateInflate(const std::string& string, size_t threads = 1) {
   std::unique_ptr<HTTPBodyStream> string_stream(
       new StringHTTPBodyStream(string));
-  GzipHTTPBodyStream gzip_stream(std::move(string_stream));
+  GzipHTTPBodyStream gzip_stream(std::move(string_stream), threads);
 
   // The minimum size of a gzip wrapper per RFC 1952: a 10-byte header and an
   // 8-byte trailer.
@@ -94,6 +94,12 @@ void TestGzipDeflateInflate(const std::string& string) {
   size_t buf_size =
       string.size() + kGzipHeaderSize +
       (string.empty() ? 2 : (((string.size() + 16383) / 16384) * 5));
+
+  // In parallel mode, each 128kB block can additionally end a stored block
+  // early and ends with an empty stored block, for up to 10 more bytes.
+  if (threads > 1) {
+    buf_size += ((string.size() + 131071) / 131072) * 10;
+  }
   std::unique_ptr<uint8_t[]> buf(new uint8_t[buf_size]);
   FileOperationResult compressed_bytes =
       gzip_stream.GetBytesBuffer(buf.get(), buf_size);
@@ -119,7 +125,7 @@ void TestGzipDeflateInflate(const std::string& string) {
 
   // In block mode, compression should be identical.
   string_stream.reset(new StringHTTPBodyStream(string));
-  GzipHTTPBodyStream block_gzip_stream(std::move(string_stream));
+  GzipHTTPBodyStream block_gzip_stream(std::move(string_stream), threads);
   uint8_t block_buf[4096];
   std::string block_compressed;
   FileOperationResult block_compressed_bytes;
@@ -175,6 +181,35 @@ TEST(GzipHTTPBodyStream, ManyBytes_Random) {
   TestGzipDeflateInflate(base::RandBytesAsString(kManyBytes));
 }
 
+TEST(GzipHTTPBodyStream, Parallel_Empty) {
+  TestGzipDeflateInflate(std::string(), 4);
+}
+
+TEST(GzipHTTPBodyStream, Parallel_OneByte) {
+  TestGzipDeflateInflate(std::string("Z"), 4);
+}
+
+TEST(GzipHTTPBodyStream, Parallel_ManyBytes_NUL) {
+  TestGzipDeflateInflate(std::string(kManyBytes, '\0'), 4);
+}
+
+TEST(GzipHTTPBodyStream, Parallel_ManyBytes_Deterministic) {
+  // With two threads, the blocks are compressed in more than one batch.
+  TestGzipDeflateInflate(MakeString(kManyBytes), 2);
+  TestGzipDeflateInflate(MakeString(kManyBytes), 4);
+}
+
+TEST(GzipHTTPBodyStream, Parallel_ManyBytes_Random) {
+  TestGzipDeflateInflate(base::RandBytesAsString(kManyBytes), 2);
+  TestGzipDeflateInflate(base::RandBytesAsString(kManyBytes), 4);
+}
+
+TEST(GzipHTTPBodyStream, Parallel_BlockMultiple) {
+  // The input ends at the end of a batch of blocks, so the final block is
+  // empty.
+  TestGzipDeflateInflate(MakeString(4 * 128 * 1024), 2);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,120 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_rate_limited.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "util/misc/clock.h"
+
+namespace crashpad {
+
+namespace {
+
+constexpr uint64_t kNanosecondsPerSecond = 1000000000;
+
+}  // namespace
+
+ByteRateLimiter::ByteRateLimiter(uint64_t bytes_per_second)
+    : lock_(),
+      bytes_per_second_(bytes_per_second),
+      available_bytes_(bytes_per_second),
+      last_refill_ns_(ClockMonotonicNanoseconds()) {
+  DCHECK_GT(bytes_per_second_, 0u);
+}
+
+ByteRateLimiter::~ByteRateLimiter() = default;
+
+size_t ByteRateLimiter::Acquire(size_t max_bytes) {
+  DCHECK_GT(max_bytes, 0u);
+
+  while (true) {
+    uint64_t wait_ns;
+    {
+      base::AutoLock lock(lock_);
+      Refill(ClockMonotonicNanoseconds());
+      if (available_bytes_ > 0) {
+        const size_t bytes = static_cast<size_t>(
+            std::min(available_bytes_, static_cast<uint64_t>(max_bytes)));
+        available_bytes_ -= bytes;
+        return bytes;
+      }
+
+      // Wait for a worthwhile number of bytes to accrue, rather than for just
+      // one, so that the caller isn’t woken for every byte at low rates.
+      const uint64_t wanted_bytes = std::min(
+          static_cast<uint64_t>(max_bytes),
+          std::max(bytes_per_second_ / 100, static_cast<uint64_t>(1)));
+      wait_ns = (wanted_bytes * kNanosecondsPerSecond + bytes_per_second_ - 1) /
+                bytes_per_second_;
+    }
+    SleepNanoseconds(wait_ns);
+  }
+}
+
+void ByteRateLimiter::Release(size_t bytes) {
+  base::AutoLock lock(lock_);
+  available_bytes_ = std::min(available_bytes_ + bytes, bytes_per_second_);
+}
+
+void ByteRateLimiter::Refill(uint64_t now_ns) {
+  if (now_ns <= last_refill_ns_) {
+    return;
+  }
+
+  const uint64_t elapsed_ns = now_ns - last_refill_ns_;
+  if (elapsed_ns >= kNanosecondsPerSecond) {
+    available_bytes_ = bytes_per_second_;
+    last_refill_ns_ = now_ns;
+    return;
+  }
+
+  // Only whole bytes are added. The time that accrued a partial byte is kept
+  // by advancing last_refill_ns_ only by the time that accrued whole bytes.
+  const uint64_t accrued_bytes =
+      elapsed_ns * bytes_per_second_ / kNanosecondsPerSecond;
+  if (accrued_bytes == 0) {
+    return;
+  }
+  available_bytes_ =
+      std::min(available_bytes_ + accrued_bytes, bytes_per_second_);
+  last_refill_ns_ +=
+      accrued_bytes * kNanosecondsPerSecond / bytes_per_second_;
+}
+
+RateLimitedHTTPBodyStream::RateLimitedHTTPBodyStream(
+    std::unique_ptr<HTTPBodyStream> source,
+    ByteRateLimiter* limiter)
+    : source_(std::move(source)), limiter_(limiter) {}
+
+RateLimitedHTTPBodyStream::~RateLimitedHTTPBodyStream() = default;
+
+FileOperationResult RateLimitedHTTPBodyStream::GetBytesBuffer(uint8_t* buffer,
+                                                              size_t max_len) {
+  if (max_len == 0) {
+    return source_->GetBytesBuffer(buffer, max_len);
+  }
+
+  const size_t bytes = limiter_->Acquire(max_len);
+  const FileOperationResult rv = source_->GetBytesBuffer(buffer, bytes);
+  const size_t used = rv > 0 ? static_cast<size_t>(rv) : 0;
+  if (used < bytes) {
+    limiter_->Release(bytes - used);
+  }
+  return rv;
+}
+
+}  // namespace crashpad
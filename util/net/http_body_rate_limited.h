@@ -0,0 +1,97 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_NET_HTTP_BODY_RATE_LIMITED_H_
+#define CRASHPAD_UTIL_NET_HTTP_BODY_RATE_LIMITED_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+
+#include "base/synchronization/lock.h"
+#include "util/file/file_io.h"
+#include "util/net/http_body.h"
+
+namespace crashpad {
+
+//! \brief A token bucket limiting the rate at which bytes may be transferred.
+//!
+//! The bucket holds up to one second’s worth of bytes, and refills at the
+//! configured rate. A single object may be shared by several
+//! RateLimitedHTTPBodyStream objects, on any number of threads, to limit their
+//! combined rate.
+class ByteRateLimiter {
+ public:
+  //! \param[in] bytes_per_second The rate to limit transfers to. This must not
+  //!     be `0`.
+  explicit ByteRateLimiter(uint64_t bytes_per_second);
+
+  ByteRateLimiter(const ByteRateLimiter&) = delete;
+  ByteRateLimiter& operator=(const ByteRateLimiter&) = delete;
+
+  ~ByteRateLimiter();
+
+  //! \brief Waits until at least one byte may be transferred.
+  //!
+  //! \param[in] max_bytes The most bytes that the caller intends to transfer.
+  //!     This must not be `0`.
+  //!
+  //! \return The number of bytes, between `1` and \a max_bytes, that the
+  //!     caller may now transfer.
+  size_t Acquire(size_t max_bytes);
+
+  //! \brief Returns bytes obtained from Acquire() that were not transferred.
+  //!
+  //! \param[in] bytes The number of bytes to return.
+  void Release(size_t bytes);
+
+ private:
+  // Adds the bytes accrued since last_refill_ns_ to available_bytes_. lock_
+  // must be held.
+  void Refill(uint64_t now_ns);
+
+  base::Lock lock_;
+  const uint64_t bytes_per_second_;
+  uint64_t available_bytes_;
+  uint64_t last_refill_ns_;
+};
+
+//! \brief An implementation of HTTPBodyStream that limits the rate at which
+//!     another HTTPBodyStream is read with a ByteRateLimiter.
+class RateLimitedHTTPBodyStream : public HTTPBodyStream {
+ public:
+  //! \param[in] source The stream to read from.
+  //! \param[in] limiter The limiter to obtain bytes from. This object does not
+  //!     take ownership of \a limiter, which must outlive it.
+  RateLimitedHTTPBodyStream(std::unique_ptr<HTTPBodyStream> source,
+                            ByteRateLimiter* limiter);
+
+  RateLimitedHTTPBodyStream(const RateLimitedHTTPBodyStream&) = delete;
+  RateLimitedHTTPBodyStream& operator=(const RateLimitedHTTPBodyStream&) =
+      delete;
+
+  ~RateLimitedHTTPBodyStream() override;
+
+  // HTTPBodyStream:
+  FileOperationResult GetBytesBuffer(uint8_t* buffer, size_t max_len) override;
+
+ private:
+  std::unique_ptr<HTTPBodyStream> source_;
+  ByteRateLimiter* limiter_;  // weak
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_NET_HTTP_BODY_RATE_LIMITED_H_
@@ -0,0 +1,86 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/net/http_body_rate_limited.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/net/http_body.h"
+#include "util/net/http_body_test_util.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr uint64_t kNanosecondsPerSecond = 1000000000;
+
+TEST(ByteRateLimiter, AcquireAndRelease) {
+  ByteRateLimiter limiter(100);
+
+  // The bucket begins full.
+  EXPECT_EQ(limiter.Acquire(60), 60u);
+  EXPECT_EQ(limiter.Acquire(60), 40u);
+
+  limiter.Release(10);
+  EXPECT_EQ(limiter.Acquire(60), 10u);
+
+  // Once the bucket is empty, a byte can only be obtained after some time.
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  EXPECT_GE(limiter.Acquire(1), 1u);
+  EXPECT_GE(ClockMonotonicNanoseconds() - start_ns,
+            kNanosecondsPerSecond / 100 / 2);
+}
+
+TEST(RateLimitedHTTPBodyStream, ContentsUnchanged) {
+  const std::string contents(100000, 'x');
+  ByteRateLimiter limiter(1024 * 1024 * 1024);
+  RateLimitedHTTPBodyStream stream(
+      std::make_unique<StringHTTPBodyStream>(contents), &limiter);
+  EXPECT_EQ(ReadStreamToString(&stream, 4096), contents);
+}
+
+TEST(RateLimitedHTTPBodyStream, LimitsRate) {
+  // With a bucket of 8 KiB, reading 16 KiB must wait for at least 8 KiB to
+  // accrue, which takes a second.
+  constexpr size_t kBytesPerSecond = 8 * 1024;
+  const std::string contents(2 * kBytesPerSecond, 'x');
+  ByteRateLimiter limiter(kBytesPerSecond);
+
+  const uint64_t start_ns = ClockMonotonicNanoseconds();
+  std::string read;
+  {
+    RateLimitedHTTPBodyStream stream(
+        std::make_unique<StringHTTPBodyStream>(contents.substr(0, 1024)),
+        &limiter);
+    read += ReadStreamToString(&stream, 512);
+  }
+  {
+    RateLimitedHTTPBodyStream stream(
+        std::make_unique<StringHTTPBodyStream>(contents.substr(1024)),
+        &limiter);
+    read += ReadStreamToString(&stream, 4096);
+  }
+  EXPECT_EQ(read, contents);
+
+  // Allow for some imprecision in the clock, but not much.
+  EXPECT_GE(ClockMonotonicNanoseconds() - start_ns,
+            kNanosecondsPerSecond * 9 / 10);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -148,6 +148,47 @@ TEST(FileReaderHTTPBodyStream, ReadBinaryFile) {
   ExpectBufferSet(buf, '!', sizeof(buf));
 }
 
+TEST(FileReaderHTTPBodyStream, FileRegion) {
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+
+  {
+    // Without the file, no region is available, but the stream is readable.
+    FileReaderHTTPBodyStream stream(&reader);
+    FileHandle file;
+    FileOffset offset;
+    EXPECT_EQ(stream.GetFileRegion(&file, &offset, 32), 0);
+    uint8_t buf[5];
+    EXPECT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 5);
+    EXPECT_EQ(memcmp(buf, "This ", sizeof(buf)), 0);
+  }
+
+  FileReaderHTTPBodyStream stream(&reader, reader.file_handle());
+  FileHandle file;
+  FileOffset offset;
+  ASSERT_EQ(stream.GetFileRegion(&file, &offset, 3), 3);
+  EXPECT_EQ(file, reader.file_handle());
+  EXPECT_EQ(offset, 5);
+  ASSERT_TRUE(stream.ConsumeFileRegion(3));
+
+  // Reading continues after the consumed region.
+  uint8_t buf[3];
+  EXPECT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 3);
+  EXPECT_EQ(memcmp(buf, "a t", sizeof(buf)), 0);
+
+  // The region extends to the end of the file.
+  ASSERT_EQ(stream.GetFileRegion(&file, &offset, 32), 5);
+  EXPECT_EQ(offset, 11);
+  ASSERT_TRUE(stream.ConsumeFileRegion(5));
+
+  EXPECT_EQ(stream.GetFileRegion(&file, &offset, 32), 0);
+  EXPECT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 0);
+  EXPECT_EQ(stream.GetFileRegion(&file, &offset, 32), 0);
+}
+
 TEST(CompositeHTTPBodyStream, TwoEmptyStrings) {
   std::vector<HTTPBodyStream*> parts;
   parts.push_back(new StringHTTPBodyStream(std::string()));
@@ -207,6 +248,41 @@ TEST_P(CompositeHTTPBodyStreamBufferSize, StringsAndFile) {
   EXPECT_EQ(actual_string, expected_string);
 }
 
+TEST(CompositeHTTPBodyStream, FileRegion) {
+  std::string string1("Hello! ");
+  std::string string2(" Goodbye :)");
+
+  std::vector<HTTPBodyStream*> parts;
+  parts.push_back(new StringHTTPBodyStream(string1));
+  base::FilePath path = TestPaths::TestDataRoot().Append(
+      FILE_PATH_LITERAL("util/net/testdata/ascii_http_body.txt"));
+
+  FileReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  parts.push_back(new FileReaderHTTPBodyStream(&reader, reader.file_handle()));
+  parts.push_back(new StringHTTPBodyStream(string2));
+
+  CompositeHTTPBodyStream stream(parts);
+
+  // The string part has no region.
+  FileHandle file;
+  FileOffset offset;
+  EXPECT_EQ(stream.GetFileRegion(&file, &offset, 32), 0);
+
+  uint8_t buf[10];
+  ASSERT_EQ(stream.GetBytesBuffer(buf, sizeof(buf)), 10);
+  EXPECT_EQ(memcmp(buf, "Hello! Thi", sizeof(buf)), 0);
+
+  // The remainder of the file part is available as a region.
+  ASSERT_EQ(stream.GetFileRegion(&file, &offset, 32), 13);
+  EXPECT_EQ(file, reader.file_handle());
+  EXPECT_EQ(offset, 3);
+  ASSERT_TRUE(stream.ConsumeFileRegion(13));
+
+  EXPECT_EQ(stream.GetFileRegion(&file, &offset, 32), 0);
+  EXPECT_EQ(ReadStreamToString(&stream, 4), string2);
+}
+
 INSTANTIATE_TEST_SUITE_P(VariableBufferSize,
                          CompositeHTTPBodyStreamBufferSize,
                          testing::Values(1, 2, 9, 16, 31, 128, 1024));
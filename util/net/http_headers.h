@@ -32,6 +32,9 @@ constexpr char kContentLength[] = "Content-Length";
 //! \brief The header name `"Content-Encoding"`.
 constexpr char kContentEncoding[] = "Content-Encoding";
 
+//! \brief The header name `"Content-Range"`.
+constexpr char kContentRange[] = "Content-Range";
+
 }  // namespace crashpad
 
 #endif  // CRASHPAD_UTIL_NET_HTTP_HEADERS_H_
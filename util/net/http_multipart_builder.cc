@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "base/check.h"
+#include "base/logging.h"
 #include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
 #include "util/net/http_body.h"
@@ -58,6 +59,22 @@ std::string GenerateBoundaryString() {
   return boundary_string;
 }
 
+// Returns whether |boundary| could have been produced by
+// GenerateBoundaryString().
+bool IsValidBoundaryString(const std::string& boundary) {
+  if (boundary.empty() || boundary.size() > 70) {
+    return false;
+  }
+  for (char character : boundary) {
+    if (!(character >= 'a' && character <= 'z') &&
+        !(character >= 'A' && character <= 'Z') &&
+        !(character >= '0' && character <= '9') && character != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Escapes the specified name to be suitable for the name field of a
 // form-data part.
 std::string EncodeMIMEField(const std::string& name) {
@@ -116,6 +133,7 @@ HTTPMultipartBuilder::HTTPMultipartBuilder()
     : boundary_(GenerateBoundaryString()),
       form_data_(),
       file_attachments_(),
+      gzip_threads_(1),
       gzip_enabled_(false) {}
 
 HTTPMultipartBuilder::~HTTPMultipartBuilder() {
@@ -125,6 +143,20 @@ void HTTPMultipartBuilder::SetGzipEnabled(bool gzip_enabled) {
   gzip_enabled_ = gzip_enabled;
 }
 
+void HTTPMultipartBuilder::SetGzipThreads(size_t threads) {
+  DCHECK_GT(threads, 0u);
+  gzip_threads_ = threads;
+}
+
+bool HTTPMultipartBuilder::SetBoundary(const std::string& boundary) {
+  if (!IsValidBoundaryString(boundary)) {
+    LOG(ERROR) << "invalid multipart boundary";
+    return false;
+  }
+  boundary_ = boundary;
+  return true;
+}
+
 void HTTPMultipartBuilder::SetFormData(const std::string& key,
                                        const std::string& value) {
   EraseKey(key);
@@ -136,28 +168,56 @@ void HTTPMultipartBuilder::SetFileAttachment(
     const std::string& upload_file_name,
     FileReaderInterface* reader,
     const std::string& content_type) {
-  EraseKey(upload_file_name);
+  SetFileAttachmentInternal(
+      key, upload_file_name, reader, kInvalidFileHandle, content_type, false);
+}
 
-  FileAttachment attachment;
-  attachment.filename = EncodeMIMEField(upload_file_name);
-  attachment.reader = reader;
+void HTTPMultipartBuilder::SetFileAttachment(
+    const std::string& key,
+    const std::string& upload_file_name,
+    FileReader* reader,
+    const std::string& content_type) {
+  SetFileAttachmentInternal(key,
+                            upload_file_name,
+                            reader,
+                            reader->file_handle(),
+                            content_type,
+                            false);
+}
 
-  if (content_type.empty()) {
-    attachment.content_type = "application/octet-stream";
-  } else {
-    AssertSafeMIMEType(content_type);
-    attachment.content_type = content_type;
-  }
+void HTTPMultipartBuilder::SetGzipFileAttachment(
+    const std::string& key,
+    const std::string& upload_file_name,
+    FileReaderInterface* reader,
+    const std::string& content_type) {
+  SetFileAttachmentInternal(
+      key, upload_file_name, reader, kInvalidFileHandle, content_type, true);
+}
 
-  file_attachments_[key] = attachment;
+void HTTPMultipartBuilder::SetGzipFileAttachment(
+    const std::string& key,
+    const std::string& upload_file_name,
+    FileReader* reader,
+    const std::string& content_type) {
+  SetFileAttachmentInternal(key,
+                            upload_file_name,
+                            reader,
+                            reader->file_handle(),
+                            content_type,
+                            true);
 }
 
 std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
-  // The objects inserted into this vector will be owned by the returned
+  // The objects inserted into these vectors will be owned by the returned
   // CompositeHTTPBodyStream. Take care to not early-return without deleting
   // this memory.
   std::vector<HTTPBodyStream*> streams;
 
+  // Completed gzip members, used only when a gzip-compressed attachment is
+  // present. Each such attachment ends the member in progress in |streams| and
+  // is then placed into the body stream as its own member.
+  std::vector<HTTPBodyStream*> gzip_members;
+
   for (const auto& pair : form_data_) {
     std::string field = GetFormDataBoundary(boundary_, pair.first);
     field += kBoundaryCRLF;
@@ -175,7 +235,17 @@ std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
         attachment.content_type.c_str(), kBoundaryCRLF);
 
     streams.push_back(new StringHTTPBodyStream(header));
-    streams.push_back(new FileReaderHTTPBodyStream(attachment.reader));
+    if (attachment.gzip_compressed) {
+      CHECK(gzip_enabled_);
+      gzip_members.push_back(new GzipHTTPBodyStream(
+          std::make_unique<CompositeHTTPBodyStream>(streams), gzip_threads_));
+      streams.clear();
+      gzip_members.push_back(
+          new FileReaderHTTPBodyStream(attachment.reader, attachment.file));
+    } else {
+      streams.push_back(
+          new FileReaderHTTPBodyStream(attachment.reader, attachment.file));
+    }
     streams.push_back(new StringHTTPBodyStream(kCRLF));
   }
 
@@ -185,8 +255,14 @@ std::unique_ptr<HTTPBodyStream> HTTPMultipartBuilder::GetBodyStream() {
   auto composite =
       std::unique_ptr<HTTPBodyStream>(new CompositeHTTPBodyStream(streams));
   if (gzip_enabled_) {
+    auto gzip = std::unique_ptr<HTTPBodyStream>(
+        new GzipHTTPBodyStream(std::move(composite), gzip_threads_));
+    if (gzip_members.empty()) {
+      return gzip;
+    }
+    gzip_members.push_back(gzip.release());
     return std::unique_ptr<HTTPBodyStream>(
-        new GzipHTTPBodyStream(std::move(composite)));
+        new CompositeHTTPBodyStream(gzip_members));
   }
   return composite;
 }
@@ -202,6 +278,31 @@ void HTTPMultipartBuilder::PopulateContentHeaders(
   }
 }
 
+void HTTPMultipartBuilder::SetFileAttachmentInternal(
+    const std::string& key,
+    const std::string& upload_file_name,
+    FileReaderInterface* reader,
+    FileHandle file,
+    const std::string& content_type,
+    bool gzip_compressed) {
+  EraseKey(upload_file_name);
+
+  FileAttachment attachment;
+  attachment.filename = EncodeMIMEField(upload_file_name);
+  attachment.reader = reader;
+  attachment.file = file;
+  attachment.gzip_compressed = gzip_compressed;
+
+  if (content_type.empty()) {
+    attachment.content_type = "application/octet-stream";
+  } else {
+    AssertSafeMIMEType(content_type);
+    attachment.content_type = content_type;
+  }
+
+  file_attachments_[key] = attachment;
+}
+
 void HTTPMultipartBuilder::EraseKey(const std::string& key) {
   auto data_it = form_data_.find(key);
   if (data_it != form_data_.end())
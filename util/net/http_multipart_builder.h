@@ -15,6 +15,8 @@
 #ifndef CRASHPAD_UTIL_NET_HTTP_MULTIPART_BUILDER_H_
 #define CRASHPAD_UTIL_NET_HTTP_MULTIPART_BUILDER_H_
 
+#include <stddef.h>
+
 #include <map>
 #include <memory>
 #include <string>
@@ -46,6 +48,31 @@ class HTTPMultipartBuilder {
   //! PopulateContentHeaders() will contain `Content-Encoding: gzip`.
   void SetGzipEnabled(bool gzip_enabled);
 
+  //! \brief Sets the number of threads used for `gzip` compression.
+  //!
+  //! \param[in] threads The number of worker threads that compress the body
+  //!     stream returned by GetBodyStream(). The default, `1`, compresses on
+  //!     the calling thread. See GzipHTTPBodyStream.
+  //!
+  //! This has no effect unless `gzip` compression is enabled with
+  //! SetGzipEnabled().
+  void SetGzipThreads(size_t threads);
+
+  //! \brief Replaces the randomly-generated multipart boundary.
+  //!
+  //! This allows a message to be built again identically to one built
+  //! previously, by passing the value that boundary() returned for it.
+  //!
+  //! \param[in] boundary The boundary to use. This must consist of 1 to 70
+  //!     alphanumeric or `-` characters.
+  //!
+  //! \return `true` on success. `false` if \a boundary is not acceptable, with
+  //!     an error logged, in which case the boundary is not changed.
+  bool SetBoundary(const std::string& boundary);
+
+  //! \brief Returns the multipart boundary.
+  const std::string& boundary() const { return boundary_; }
+
   //! \brief Sets a `Content-Disposition: form-data` key-value pair.
   //!
   //! \param[in] key The key of the form data, specified as the `name` in the
@@ -71,6 +98,55 @@ class HTTPMultipartBuilder {
                          FileReaderInterface* reader,
                          const std::string& content_type);
 
+  //! \brief Specifies the contents read from \a reader to be uploaded as
+  //!     multipart data, as the overload taking a FileReaderInterface does.
+  //!
+  //! The contents may also be sent directly from \a reader’s file by a
+  //! transport that uses HTTPBodyStream::GetFileRegion().
+  void SetFileAttachment(const std::string& key,
+                         const std::string& upload_file_name,
+                         FileReader* reader,
+                         const std::string& content_type);
+
+  //! \brief Specifies `gzip`-compressed contents read from \a reader to be
+  //!     uploaded as multipart data, available at `name` of \a
+  //!     upload_file_name.
+  //!
+  //! This behaves like SetFileAttachment(), except that \a reader supplies the
+  //! attachment’s contents already compressed as one or more `gzip` members.
+  //! They are placed into the body stream as-is, between `gzip` members
+  //! holding the surrounding parts of the multipart message, so that the body
+  //! decompresses to the same message that SetFileAttachment() would produce
+  //! for the uncompressed contents, without compressing them a second time.
+  //!
+  //! \note `gzip` compression must be enabled with SetGzipEnabled() before
+  //!     GetBodyStream() is called.
+  //!
+  //! \param[in] key The key of the form data, specified as the `name` in the
+  //!     multipart message. Any data previously set on this class with this
+  //!     key will be overwritten.
+  //! \param[in] upload_file_name The `filename` to specify for this multipart
+  //!     data attachment.
+  //! \param[in] reader A FileReaderInterface from which to read the
+  //!     `gzip`-compressed content to upload.
+  //! \param[in] content_type The `Content-Type` to specify for the attachment.
+  //!     If this is empty, `"application/octet-stream"` will be used.
+  void SetGzipFileAttachment(const std::string& key,
+                             const std::string& upload_file_name,
+                             FileReaderInterface* reader,
+                             const std::string& content_type);
+
+  //! \brief Specifies `gzip`-compressed contents read from \a reader to be
+  //!     uploaded as multipart data, as the overload taking a
+  //!     FileReaderInterface does.
+  //!
+  //! The contents may also be sent directly from \a reader’s file by a
+  //! transport that uses HTTPBodyStream::GetFileRegion().
+  void SetGzipFileAttachment(const std::string& key,
+                             const std::string& upload_file_name,
+                             FileReader* reader,
+                             const std::string& content_type);
+
   //! \brief Generates the HTTPBodyStream for the data currently supplied to
   //!     the builder.
   //!
@@ -88,8 +164,19 @@ class HTTPMultipartBuilder {
     std::string filename;
     std::string content_type;
     FileReaderInterface* reader;
+    FileHandle file;
+    bool gzip_compressed;
   };
 
+  // Records a file attachment for SetFileAttachment() and
+  // SetGzipFileAttachment().
+  void SetFileAttachmentInternal(const std::string& key,
+                                 const std::string& upload_file_name,
+                                 FileReaderInterface* reader,
+                                 FileHandle file,
+                                 const std::string& content_type,
+                                 bool gzip_compressed);
+
   // Removes elements from both data maps at the specified |key|, to ensure
   // uniqueness across the entire HTTP body.
   void EraseKey(const std::string& key);
@@ -97,6 +184,7 @@ class HTTPMultipartBuilder {
   std::string boundary_;
   std::map<std::string, std::string> form_data_;
   std::map<std::string, FileAttachment> file_attachments_;
+  size_t gzip_threads_;
   bool gzip_enabled_;
 };
 
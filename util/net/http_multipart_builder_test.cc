@@ -14,15 +14,22 @@
 
 #include "util/net/http_multipart_builder.h"
 
+#include <string.h>
 #include <sys/types.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "test/gtest_death.h"
 #include "test/test_paths.h"
+#include "util/file/string_file.h"
 #include "util/net/http_body.h"
 #include "util/net/http_body_test_util.h"
+#include "util/stream/file_writer_output_stream.h"
+#include "util/stream/test_output_stream.h"
+#include "util/stream/zlib_output_stream.h"
 
 namespace crashpad {
 namespace test {
@@ -278,6 +285,94 @@ TEST(HTTPMultipartBuilder, SharedFormDataAndAttachmentKeyNamespace) {
   EXPECT_EQ(lines_it, lines.end());
 }
 
+TEST(HTTPMultipartBuilder, GzipFileAttachment) {
+  static constexpr char kFileContents[] = "This is a test.\n";
+
+  StringFile compressed_file;
+  {
+    ZlibOutputStream compressor(
+        ZlibOutputStream::Mode::kCompress,
+        ZlibOutputStream::Format::kGzip,
+        std::make_unique<FileWriterOutputStream>(&compressed_file));
+    ASSERT_TRUE(
+        compressor.Write(reinterpret_cast<const uint8_t*>(kFileContents),
+                         strlen(kFileContents)));
+    ASSERT_TRUE(compressor.Flush());
+  }
+  ASSERT_TRUE(compressed_file.SeekSet(0));
+
+  HTTPMultipartBuilder builder;
+  builder.SetGzipEnabled(true);
+
+  static constexpr char kKey[] = "key";
+  static constexpr char kValue[] = "value";
+  builder.SetFormData(kKey, kValue);
+  builder.SetGzipFileAttachment(
+      "minidump", "minidump.dmp", &compressed_file, "");
+
+  std::unique_ptr<HTTPBodyStream> body(builder.GetBodyStream());
+  ASSERT_TRUE(body.get());
+  std::string compressed_contents = ReadStreamToString(body.get());
+
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZlibOutputStream decompressor(ZlibOutputStream::Mode::kDecompress,
+                                ZlibOutputStream::Format::kGzip,
+                                std::move(test_output_stream));
+  ASSERT_TRUE(decompressor.Write(
+      reinterpret_cast<const uint8_t*>(compressed_contents.data()),
+      compressed_contents.size()));
+  ASSERT_TRUE(decompressor.Flush());
+
+  const std::vector<uint8_t>& decompressed =
+      test_output_stream_weak->all_data();
+  auto lines =
+      SplitCRLF(std::string(decompressed.begin(), decompressed.end()));
+  ASSERT_EQ(lines.size(), 10u);
+  auto lines_it = lines.begin();
+
+  const std::string& boundary = *lines_it++;
+  EXPECT_GE(boundary.length(), 1u);
+  EXPECT_LE(boundary.length(), 70u);
+
+  EXPECT_EQ(*lines_it++, "Content-Disposition: form-data; name=\"key\"");
+  EXPECT_EQ(*lines_it++, "");
+  EXPECT_EQ(*lines_it++, kValue);
+
+  EXPECT_EQ(*lines_it++, boundary);
+  EXPECT_EQ(*lines_it++,
+            "Content-Disposition: form-data; "
+            "name=\"minidump\"; filename=\"minidump.dmp\"");
+  EXPECT_EQ(*lines_it++, "Content-Type: application/octet-stream");
+  EXPECT_EQ(*lines_it++, "");
+  EXPECT_EQ(*lines_it++, kFileContents);
+
+  EXPECT_EQ(*lines_it++, boundary + "--");
+
+  EXPECT_EQ(lines_it, lines.end());
+}
+
+TEST(HTTPMultipartBuilder, SetBoundary) {
+  HTTPMultipartBuilder builder;
+  builder.SetFormData("key", "value");
+
+  HTTPMultipartBuilder rebuilder;
+  rebuilder.SetFormData("key", "value");
+  EXPECT_NE(rebuilder.boundary(), builder.boundary());
+  ASSERT_TRUE(rebuilder.SetBoundary(builder.boundary()));
+  EXPECT_EQ(rebuilder.boundary(), builder.boundary());
+
+  std::unique_ptr<HTTPBodyStream> body(builder.GetBodyStream());
+  std::unique_ptr<HTTPBodyStream> rebody(rebuilder.GetBodyStream());
+  EXPECT_EQ(ReadStreamToString(rebody.get()), ReadStreamToString(body.get()));
+
+  const std::string boundary = builder.boundary();
+  EXPECT_FALSE(builder.SetBoundary(""));
+  EXPECT_FALSE(builder.SetBoundary("bound\r\nary"));
+  EXPECT_FALSE(builder.SetBoundary(std::string(71, 'a')));
+  EXPECT_EQ(builder.boundary(), boundary);
+}
+
 TEST(HTTPMultipartBuilderDeathTest, AssertUnsafeMIMEType) {
   HTTPMultipartBuilder builder;
   FileReader reader;
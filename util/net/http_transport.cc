@@ -56,4 +56,13 @@ void HTTPTransport::SetRootCACertificatePath(const base::FilePath& cert) {
   root_ca_certificate_path_ = cert;
 }
 
+void HTTPTransport::ResetRequest() {
+  headers_.clear();
+  body_stream_.reset();
+}
+
+bool HTTPTransport::Prewarm() {
+  return false;
+}
+
 }  // namespace crashpad
@@ -29,6 +29,11 @@ class HTTPBodyStream;
 //!     method, headers, and body. This class can only issue a synchronous
 //!     HTTP request.
 //!
+//! A single object may be used to execute several requests in sequence by
+//! calling ResetRequest() between them. Implementations keep connections to
+//! the server alive between requests where possible, so that consecutive
+//! requests to the same server avoid the cost of connection and TLS setup.
+//!
 //! This class cannot be instantiated directly. A concrete subclass must be
 //! instantiated instead, which provides an implementation to execute the
 //! request that is appropriate for the host operating system.
@@ -84,6 +89,32 @@ class HTTPTransport {
   //!     cert to be used for TLS connections.
   void SetRootCACertificatePath(const base::FilePath& cert);
 
+  //! \brief Prepares this object to execute another request.
+  //!
+  //! All headers and the body stream are discarded. The URL, method, timeout,
+  //! and root CA certificate path are retained, and may be changed with the
+  //! appropriate setters. Any connection held open by a previous call to
+  //! ExecuteSynchronously() is retained and will be reused if the next request
+  //! is made to the same server.
+  void ResetRequest();
+
+  //! \brief Resolves the address of the server named by the URL and opens a
+  //!     connection to it, without making a request.
+  //!
+  //! This allows the connection and TLS setup to be done ahead of time, such
+  //! as while the request body is being prepared, so that the next call to
+  //! ExecuteSynchronously() finds the connection ready if it is made to the
+  //! same server. The URL, timeout, and root CA certificate path must be set
+  //! before calling this method.
+  //!
+  //! The default implementation does nothing. Implementations that can’t open
+  //! a connection independently of a request leave this as is.
+  //!
+  //! \return `true` if a connection to the server is ready. `false` if none
+  //!     could be opened, in which case ExecuteSynchronously() will connect as
+  //!     usual.
+  virtual bool Prewarm();
+
   //! \brief Performs the HTTP request with the configured parameters and waits
   //!     for the execution to complete.
   //!
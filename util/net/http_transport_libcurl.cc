@@ -31,7 +31,9 @@
 #include "build/build_config.h"
 #include "package.h"
 #include "util/misc/no_cfi_icall.h"
+#include "util/misc/trace_event.h"
 #include "util/net/http_body.h"
+#include "util/net/url.h"
 #include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
@@ -57,6 +59,10 @@ class Libcurl {
 
   static CURL* CurlEasyInit() { return Get()->curl_easy_init_(); }
 
+  static void CurlEasyReset(CURL* curl) {
+    return Get()->curl_easy_reset_(curl);
+  }
+
   static CURLcode CurlEasyPerform(CURL* curl) {
     return Get()->curl_easy_perform_(curl);
   }
@@ -135,6 +141,7 @@ class Libcurl {
     LINK_OR_RETURN_FALSE(curl_easy_cleanup);
     LINK_OR_RETURN_FALSE(curl_easy_init);
     LINK_OR_RETURN_FALSE(curl_easy_perform);
+    LINK_OR_RETURN_FALSE(curl_easy_reset);
     LINK_OR_RETURN_FALSE(curl_easy_strerror);
     LINK_OR_RETURN_FALSE(curl_easy_getinfo);
     LINK_OR_RETURN_FALSE(curl_easy_setopt);
@@ -151,6 +158,7 @@ class Libcurl {
   NoCfiIcall<decltype(curl_easy_cleanup)*> curl_easy_cleanup_;
   NoCfiIcall<decltype(curl_easy_init)*> curl_easy_init_;
   NoCfiIcall<decltype(curl_easy_perform)*> curl_easy_perform_;
+  NoCfiIcall<decltype(curl_easy_reset)*> curl_easy_reset_;
   NoCfiIcall<decltype(curl_easy_strerror)*> curl_easy_strerror_;
   NoCfiIcall<decltype(curl_easy_getinfo)*> curl_easy_getinfo_;
   NoCfiIcall<decltype(curl_easy_setopt)*> curl_easy_setopt_;
@@ -338,13 +346,21 @@ class HTTPTransportLibcurl final : public HTTPTransport {
                                   size_t size,
                                   size_t nitems,
                                   void* userdata);
+
+  // The easy handle is kept across requests so that libcurl’s connection
+  // cache, DNS cache, and TLS session cache, all of which belong to the
+  // handle, are available to subsequent requests.
+  ScopedCURL curl_;
+  std::string user_agent_;
 };
 
-HTTPTransportLibcurl::HTTPTransportLibcurl() : HTTPTransport() {}
+HTTPTransportLibcurl::HTTPTransportLibcurl()
+    : HTTPTransport(), curl_(), user_agent_() {}
 
 HTTPTransportLibcurl::~HTTPTransportLibcurl() {}
 
 bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
+  CRASHPAD_TRACE_EVENT("net", "HTTPTransportLibcurl::ExecuteSynchronously");
   DCHECK(body_stream());
 
   response_body->clear();
@@ -359,13 +375,24 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
     return false;
   }
 
-  CurlSList curl_headers;
-  ScopedCURL curl(Libcurl::CurlEasyInit());
-  if (!curl.get()) {
-    LOG(ERROR) << "curl_easy_init";
-    return false;
+  if (curl_.is_valid()) {
+    // Return all options to their defaults so that nothing from the previous
+    // request carries over, while retaining the handle’s live connections.
+    Libcurl::CurlEasyReset(curl_.get());
+  } else {
+    curl_.reset(Libcurl::CurlEasyInit());
+    if (!curl_.is_valid()) {
+      LOG(ERROR) << "curl_easy_init";
+      return false;
+    }
   }
 
+  if (user_agent_.empty()) {
+    user_agent_ = UserAgent();
+  }
+
+  CurlSList curl_headers;
+
 // These macros wrap the repetitive “try something, log an error and return
 // false on failure” pattern. Macros are convenient because the log messages
 // will point to the correct line number, which can help pinpoint a problem when
@@ -387,20 +414,33 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
     }                                      \
   } while (false)
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_USERAGENT, UserAgent().c_str());
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_USERAGENT, user_agent_.c_str());
 
   // Accept and automatically decode any encoding that libcurl understands.
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_ACCEPT_ENCODING, "");
-
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_URL, url().c_str());
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_ACCEPT_ENCODING, "");
+
+  static constexpr char kHttpUnix[] = "http+unix://";
+  std::string scheme, socket_path, port, resource;
+  if (url().compare(0, strlen(kHttpUnix), kHttpUnix) == 0 &&
+      CrackURL(url(), &scheme, &socket_path, &port, &resource)) {
+    // libcurl doesn’t understand the http+unix scheme, but can send an http
+    // request over a Unix domain socket.
+    TRY_CURL_EASY_SETOPT(
+        curl_.get(), CURLOPT_UNIX_SOCKET_PATH, socket_path.c_str());
+    const std::string http_url = "http://localhost" + resource;
+    TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_URL, http_url.c_str());
+  } else {
+    TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_URL, url().c_str());
+  }
 
   if (!root_ca_certificate_path().empty()) {
-    TRY_CURL_EASY_SETOPT(
-        curl.get(), CURLOPT_CAINFO, root_ca_certificate_path().value().c_str());
+    TRY_CURL_EASY_SETOPT(curl_.get(),
+                         CURLOPT_CAINFO,
+                         root_ca_certificate_path().value().c_str());
   }
 
   constexpr int kMillisecondsPerSecond = 1E3;
-  TRY_CURL_EASY_SETOPT(curl.get(),
+  TRY_CURL_EASY_SETOPT(curl_.get(),
                        CURLOPT_TIMEOUT_MS,
                        static_cast<long>(timeout() * kMillisecondsPerSecond));
 
@@ -422,7 +462,7 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
   }
 
   if (method() == "POST") {
-    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_POST, 1l);
+    TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_POST, 1l);
 
     // By default when sending a POST request, libcurl includes an “Expect:
     // 100-continue” header field. Althogh this header is specified in HTTP/1.1
@@ -445,19 +485,19 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
         return false;
       }
       TRY_CURL_EASY_SETOPT(
-          curl.get(), CURLOPT_POSTFIELDSIZE_LARGE, content_length_curl);
+          curl_.get(), CURLOPT_POSTFIELDSIZE_LARGE, content_length_curl);
     }
   } else if (method() != "GET") {
     // Untested.
-    TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_CUSTOMREQUEST, method().c_str());
+    TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_CUSTOMREQUEST, method().c_str());
   }
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_HTTPHEADER, curl_headers.get());
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_HTTPHEADER, curl_headers.get());
 
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_READFUNCTION, ReadRequestBody);
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_READDATA, this);
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_WRITEFUNCTION, WriteResponseBody);
-  TRY_CURL_EASY_SETOPT(curl.get(), CURLOPT_WRITEDATA, response_body);
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_READFUNCTION, ReadRequestBody);
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_READDATA, this);
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_WRITEFUNCTION, WriteResponseBody);
+  TRY_CURL_EASY_SETOPT(curl_.get(), CURLOPT_WRITEDATA, response_body);
 
 #undef TRY_CURL_EASY_SETOPT
 #undef TRY_CURL_SLIST_APPEND
@@ -467,7 +507,7 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
   ScopedClearString clear_response_body(response_body);
 
   // Do it.
-  CURLcode curl_err = Libcurl::CurlEasyPerform(curl.get());
+  CURLcode curl_err = Libcurl::CurlEasyPerform(curl_.get());
   if (curl_err != CURLE_OK) {
     LOG(ERROR) << CurlErrorMessage(curl_err, "curl_easy_perform");
     return false;
@@ -475,7 +515,7 @@ bool HTTPTransportLibcurl::ExecuteSynchronously(std::string* response_body) {
 
   long status;
   curl_err =
-      Libcurl::CurlEasyGetInfo(curl.get(), CURLINFO_RESPONSE_CODE, &status);
+      Libcurl::CurlEasyGetInfo(curl_.get(), CURLINFO_RESPONSE_CODE, &status);
   if (curl_err != CURLE_OK) {
     LOG(ERROR) << CurlErrorMessage(curl_err, "curl_easy_getinfo");
     return false;
@@ -26,6 +26,7 @@
 #include "util/file/file_io.h"
 #include "util/misc/implicit_cast.h"
 #include "util/misc/metrics.h"
+#include "util/misc/trace_event.h"
 #include "util/net/http_body.h"
 
 // An implementation of NSInputStream that reads from a
@@ -218,6 +219,7 @@ HTTPTransportMac::~HTTPTransportMac() {
 }
 
 bool HTTPTransportMac::ExecuteSynchronously(std::string* response_body) {
+  CRASHPAD_TRACE_EVENT("net", "HTTPTransportMac::ExecuteSynchronously");
   DCHECK(body_stream());
 
   @autoreleasepool {
@@ -12,13 +12,31 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <poll.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/logging.h"
@@ -27,14 +45,21 @@
 #include "base/scoped_generic.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "build/build_config.h"
 #include "util/file/file_io.h"
+#include "util/misc/trace_event.h"
+#include "util/net/hpack.h"
 #include "util/net/http_body.h"
 #include "util/net/http_transport.h"
 #include "util/net/url.h"
 #include "util/stdlib/string_number_conversion.h"
 #include "util/string/split_string.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/sendfile.h>
+#endif
+
 #if defined(CRASHPAD_USE_BORINGSSL)
 #include <openssl/ssl.h>
 #endif
@@ -44,18 +69,7 @@ namespace crashpad {
 namespace {
 
 constexpr const char kCRLFTerminator[] = "\r\n";
-
-class HTTPTransportSocket final : public HTTPTransport {
- public:
-  HTTPTransportSocket() = default;
-
-  HTTPTransportSocket(const HTTPTransportSocket&) = delete;
-  HTTPTransportSocket& operator=(const HTTPTransportSocket&) = delete;
-
-  ~HTTPTransportSocket() override = default;
-
-  bool ExecuteSynchronously(std::string* response_body) override;
-};
+constexpr const char kConnection[] = "Connection";
 
 struct ScopedAddrinfoTraits {
   static addrinfo* InvalidValue() { return nullptr; }
@@ -70,6 +84,24 @@ class Stream {
   virtual bool LoggingWrite(const void* data, size_t size) = 0;
   virtual bool LoggingRead(void* data, size_t size) = 0;
   virtual bool LoggingReadToEOF(std::string* contents) = 0;
+
+  // Whether LoggingSendFile() may be able to send data from a file.
+  virtual bool CanSendFile() const { return false; }
+
+  // Sends up to size bytes at offset in file without copying them through a
+  // buffer. Returns the number of bytes sent, 0 if the data can’t be sent from
+  // the file, or -1 on failure with a message logged.
+  virtual FileOperationResult LoggingSendFile(FileHandle file,
+                                              FileOffset offset,
+                                              size_t size) {
+    return 0;
+  }
+
+  // Processes what an idle connection’s socket, which must be non-blocking,
+  // has received that’s meant for the stream itself rather than for the
+  // caller. Returns true if nothing else was received, and the server hasn’t
+  // closed the connection.
+  virtual bool ReadIdleControlData() { return false; }
 };
 
 class FdStream : public Stream {
@@ -91,62 +123,204 @@ class FdStream : public Stream {
     return crashpad::LoggingReadToEOF(fd_, result);
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  bool CanSendFile() const override { return true; }
+
+  FileOperationResult LoggingSendFile(FileHandle file,
+                                      FileOffset offset,
+                                      size_t size) override {
+    off_t file_offset = offset;
+    const ssize_t rv = HANDLE_EINTR(sendfile(fd_, file, &file_offset, size));
+    if (rv < 0) {
+      if (errno == EINVAL || errno == ENOSYS) {
+        // The file doesn’t support sendfile(), so the caller must copy it.
+        return 0;
+      }
+      PLOG(ERROR) << "sendfile";
+      return -1;
+    }
+    return rv;
+  }
+#endif
+
  private:
   int fd_;
 };
 
 #if defined(CRASHPAD_USE_BORINGSSL)
-class SSLStream : public Stream {
+struct ScopedSSLCTXTraits {
+  static SSL_CTX* InvalidValue() { return nullptr; }
+  static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
+};
+using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
+
+struct ScopedSSLSessionTraits {
+  static SSL_SESSION* InvalidValue() { return nullptr; }
+  static void Free(SSL_SESSION* session) { SSL_SESSION_free(session); }
+};
+using ScopedSSLSession =
+    base::ScopedGeneric<SSL_SESSION*, ScopedSSLSessionTraits>;
+
+// Creating an SSL_CTX is expensive, mostly because of loading the certificate
+// store, so a context is kept for the life of the process for each root
+// certificate path. The sessions established with each server are also kept,
+// so that a later connection to the same server can resume a session instead
+// of performing a full handshake.
+class SSLContextCache {
  public:
-  SSLStream() = default;
+  SSLContextCache(const SSLContextCache&) = delete;
+  SSLContextCache& operator=(const SSLContextCache&) = delete;
 
-  SSLStream(const SSLStream&) = delete;
-  SSLStream& operator=(const SSLStream&) = delete;
+  static SSLContextCache* Get() {
+    static SSLContextCache* instance = new SSLContextCache();
+    return instance;
+  }
 
-  bool Initialize(const base::FilePath& root_cert_path,
-                  int sock,
-                  const std::string& hostname) {
+  // Returns the context for connections verified against root_cert_path, or
+  // nullptr with a message logged. The context is owned by the cache.
+  SSL_CTX* GetContext(const base::FilePath& root_cert_path) {
+    base::AutoLock lock(lock_);
+    auto it = contexts_.find(root_cert_path.value());
+    if (it != contexts_.end()) {
+      return it->second.get();
+    }
+
+    ScopedSSLCTX ctx(CreateContext(root_cert_path));
+    if (!ctx.is_valid()) {
+      return nullptr;
+    }
+    SSL_CTX* ctx_raw = ctx.get();
+    contexts_[root_cert_path.value()] = std::move(ctx);
+    return ctx_raw;
+  }
+
+  // Associates ssl with session_key, which identifies the server and the
+  // context, so that a session that ssl establishes is kept under that key.
+  // session_key must outlive ssl.
+  void SetSessionKey(SSL* ssl, std::string* session_key) {
+    SSL_set_ex_data(ssl, session_key_index_, session_key);
+  }
+
+  // Returns the session kept under session_key to resume, if any. TLS 1.3
+  // sessions are removed so that each is used at most once, as TLS 1.3
+  // recommends for session tickets, and a resumed connection supplies a new
+  // one. Earlier sessions may be resumed repeatedly.
+  ScopedSSLSession SessionToResume(const std::string& session_key) {
+    base::AutoLock lock(lock_);
+    auto it = sessions_.find(session_key);
+    if (it == sessions_.end()) {
+      return ScopedSSLSession();
+    }
+    if (SSL_SESSION_get_protocol_version(it->second.get()) >=
+        TLS1_3_VERSION) {
+      ScopedSSLSession session = std::move(it->second);
+      sessions_.erase(it);
+      return session;
+    }
+    SSL_SESSION_up_ref(it->second.get());
+    return ScopedSSLSession(it->second.get());
+  }
+
+ private:
+  SSLContextCache()
+      : lock_(),
+        contexts_(),
+        sessions_(),
+        session_key_index_(
+            SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr)) {}
+  ~SSLContextCache() = delete;
+
+  static SSL_CTX* CreateContext(const base::FilePath& root_cert_path) {
     SSL_library_init();
 
-    ctx_.reset(SSL_CTX_new(TLS_method()));
-    if (!ctx_.is_valid()) {
+    ScopedSSLCTX ctx(SSL_CTX_new(TLS_method()));
+    if (!ctx.is_valid()) {
       LOG(ERROR) << "SSL_CTX_new";
-      return false;
+      return nullptr;
     }
 
-    if (SSL_CTX_set_min_proto_version(ctx_.get(), TLS1_2_VERSION) <= 0) {
+    if (SSL_CTX_set_min_proto_version(ctx.get(), TLS1_2_VERSION) <= 0) {
       LOG(ERROR) << "SSL_CTX_set_min_proto_version";
-      return false;
+      return nullptr;
     }
 
-    SSL_CTX_set_verify(ctx_.get(), SSL_VERIFY_PEER, nullptr);
-    SSL_CTX_set_verify_depth(ctx_.get(), 5);
+    SSL_CTX_set_verify(ctx.get(), SSL_VERIFY_PEER, nullptr);
+    SSL_CTX_set_verify_depth(ctx.get(), 5);
 
     if (!root_cert_path.empty()) {
       if (SSL_CTX_load_verify_locations(
-              ctx_.get(), root_cert_path.value().c_str(), nullptr) <= 0) {
+              ctx.get(), root_cert_path.value().c_str(), nullptr) <= 0) {
         LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
+        return nullptr;
       }
     } else {
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
       if (SSL_CTX_load_verify_locations(
-              ctx_.get(), nullptr, "/etc/ssl/certs") <= 0) {
+              ctx.get(), nullptr, "/etc/ssl/certs") <= 0) {
         LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
+        return nullptr;
       }
 #elif BUILDFLAG(IS_FUCHSIA)
       if (SSL_CTX_load_verify_locations(
-              ctx_.get(), "/config/ssl/cert.pem", nullptr) <= 0) {
+              ctx.get(), "/config/ssl/cert.pem", nullptr) <= 0) {
         LOG(ERROR) << "SSL_CTX_load_verify_locations";
-        return false;
+        return nullptr;
       }
 #else
 #error cert store location
 #endif
     }
 
-    ssl_.reset(SSL_new(ctx_.get()));
+    // Sessions are kept by NewSession() rather than by the context, because
+    // the context’s own cache isn’t used by clients.
+    SSL_CTX_set_session_cache_mode(
+        ctx.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx.get(), NewSession);
+
+    return ctx.release();
+  }
+
+  // Called when a connection establishes a session, which may happen after
+  // the handshake when the server sends a TLS 1.3 session ticket. Returning 1
+  // takes ownership of session.
+  static int NewSession(SSL* ssl, SSL_SESSION* session) {
+    SSLContextCache* cache = Get();
+    const std::string* session_key = static_cast<const std::string*>(
+        SSL_get_ex_data(ssl, cache->session_key_index_));
+    if (!session_key) {
+      return 0;
+    }
+
+    base::AutoLock lock(cache->lock_);
+    cache->sessions_[*session_key] = ScopedSSLSession(session);
+    return 1;
+  }
+
+  base::Lock lock_;
+  std::map<base::FilePath::StringType, ScopedSSLCTX> contexts_;
+  std::map<std::string, ScopedSSLSession> sessions_;
+  const int session_key_index_;
+};
+
+class SSLStream : public Stream {
+ public:
+  SSLStream() = default;
+
+  SSLStream(const SSLStream&) = delete;
+  SSLStream& operator=(const SSLStream&) = delete;
+
+  bool Initialize(const base::FilePath& root_cert_path,
+                  int sock,
+                  const std::string& hostname,
+                  const std::string& port,
+                  bool offer_http2) {
+    SSLContextCache* cache = SSLContextCache::Get();
+    SSL_CTX* ctx = cache->GetContext(root_cert_path);
+    if (!ctx) {
+      return false;
+    }
+
+    ssl_.reset(SSL_new(ctx));
     if (!ssl_.is_valid()) {
       LOG(ERROR) << "SSL_new";
       return false;
@@ -166,6 +340,30 @@ class SSLStream : public Stream {
       return false;
     }
 
+    // Offer HTTP/2 ahead of HTTP/1.1 with ALPN (RFC 7301). A server that
+    // doesn’t support ALPN carries on with HTTP/1.1.
+    if (offer_http2) {
+      static constexpr uint8_t kProtocols[] = {
+          2, 'h', '2', 8, 'h', 't', 't', 'p', '/', '1', '.', '1'};
+      if (SSL_set_alpn_protos(ssl_.get(), kProtocols, sizeof(kProtocols)) !=
+          0) {
+        LOG(ERROR) << "SSL_set_alpn_protos";
+        return false;
+      }
+    }
+
+    // A session is only resumed with the server that it was established with,
+    // and under the same root certificates that verified that server.
+    session_key_ = root_cert_path.value();
+    session_key_.append(1, '\0');
+    session_key_.append(hostname + ":" + port);
+    cache->SetSessionKey(ssl_.get(), &session_key_);
+    ScopedSSLSession session = cache->SessionToResume(session_key_);
+    if (session.is_valid() && !SSL_set_session(ssl_.get(), session.get())) {
+      // Fall back to a full handshake.
+      LOG(WARNING) << "SSL_set_session";
+    }
+
     if (SSL_connect(ssl_.get()) <= 0) {
       LOG(ERROR) << "SSL_connect";
       return false;
@@ -174,12 +372,82 @@ class SSLStream : public Stream {
     return true;
   }
 
+  // Whether the server selected HTTP/2 during the handshake.
+  bool NegotiatedHTTP2() const {
+    const uint8_t* protocol;
+    unsigned int protocol_length;
+    SSL_get0_alpn_selected(ssl_.get(), &protocol, &protocol_length);
+    return protocol_length == 2 && memcmp(protocol, "h2", 2) == 0;
+  }
+
+  // The following are for use once the socket has been made non-blocking.
+
+  // Reads up to size bytes that can be read without waiting. Returns the
+  // number of bytes read, 0 if none can be, or -1 on failure or if the server
+  // closed the connection, with a message logged.
+  FileOperationResult LoggingReadAvailable(void* data, size_t size) {
+    const int rv =
+        SSL_read(ssl_.get(), data, base::saturated_cast<int>(size));
+    if (rv > 0) {
+      return rv;
+    }
+    const int error = SSL_get_error(ssl_.get(), rv);
+    if (error == SSL_ERROR_WANT_READ) {
+      return 0;
+    }
+    LOG(ERROR) << "SSL_read";
+    return -1;
+  }
+
+  // Writes all size bytes, or none if the socket’s buffer is full, in which
+  // case the call must be repeated with the same arguments once the socket is
+  // writable. Returns the number of bytes written, 0 if none were, or -1 on
+  // failure with a message logged.
+  FileOperationResult LoggingWriteAvailable(const void* data, size_t size) {
+    const int rv =
+        SSL_write(ssl_.get(), data, base::checked_cast<int>(size));
+    if (rv > 0) {
+      return rv;
+    }
+    const int error = SSL_get_error(ssl_.get(), rv);
+    if (error == SSL_ERROR_WANT_WRITE) {
+      return 0;
+    }
+    LOG(ERROR) << "SSL_write";
+    return -1;
+  }
+
+  // Whether data that has already been read from the socket is waiting to be
+  // returned by LoggingReadAvailable().
+  bool HasBufferedData() const { return SSL_pending(ssl_.get()) > 0; }
+
+  bool ReadIdleControlData() override {
+    // TLS 1.3 servers may send session tickets after the handshake, which make
+    // the socket readable without there being any data to read.
+    char byte;
+    const int rv = SSL_peek(ssl_.get(), &byte, 1);
+    return rv <= 0 && SSL_get_error(ssl_.get(), rv) == SSL_ERROR_WANT_READ;
+  }
+
   bool LoggingWrite(const void* data, size_t size) override {
     return SSL_write(ssl_.get(), data, size) != 0;
   }
 
   bool LoggingRead(void* data, size_t size) override {
-    return SSL_read(ssl_.get(), data, size) != 0;
+    // SSL_read() may return less than requested, so loop until the request is
+    // satisfied. Leaving unread data would desynchronize a connection that’s
+    // kept alive for another request.
+    char* data_c = static_cast<char*>(data);
+    while (size > 0) {
+      int rv = SSL_read(ssl_.get(), data_c, base::saturated_cast<int>(size));
+      if (rv <= 0) {
+        LOG(ERROR) << "SSL_read";
+        return false;
+      }
+      data_c += rv;
+      size -= rv;
+    }
+    return true;
   }
 
   bool LoggingReadToEOF(std::string* contents) override {
@@ -199,12 +467,6 @@ class SSLStream : public Stream {
   }
 
  private:
-  struct ScopedSSLCTXTraits {
-    static SSL_CTX* InvalidValue() { return nullptr; }
-    static void Free(SSL_CTX* ctx) { SSL_CTX_free(ctx); }
-  };
-  using ScopedSSLCTX = base::ScopedGeneric<SSL_CTX*, ScopedSSLCTXTraits>;
-
   struct ScopedSSLTraits {
     static SSL* InvalidValue() { return nullptr; }
     static void Free(SSL* ssl) {
@@ -214,7 +476,9 @@ class SSLStream : public Stream {
   };
   using ScopedSSL = base::ScopedGeneric<SSL*, ScopedSSLTraits>;
 
-  ScopedSSLCTX ctx_;
+  // session_key_ is referenced by ssl_, so it’s declared before ssl_ in order
+  // to be destroyed after it.
+  std::string session_key_;
   ScopedSSL ssl_;
 };
 #endif
@@ -287,6 +551,50 @@ class ScopedSetNonblocking {
   int sock_;
 };
 
+// Connects sock to address, giving up if the connection can’t be established
+// promptly.
+bool ConnectSocket(int sock, const sockaddr* address, socklen_t address_len) {
+  // Set socket to non-blocking to avoid hanging for a long time if the
+  // network is down.
+  ScopedSetNonblocking nonblocking(sock);
+
+  if (HANDLE_EINTR(connect(sock, address, address_len)) < 0) {
+    if (errno != EINPROGRESS) {
+      PLOG(ERROR) << "connect";
+      return false;
+    }
+    return WaitUntilSocketIsReady(sock);
+  }
+
+  return true;
+}
+
+// Connects to the Unix domain socket at socket_path, for a URL using the
+// http+unix scheme. This allows reports to be handed to a local agent that
+// uploads on behalf of many handlers.
+base::ScopedFD CreateUnixSocket(const std::string& socket_path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    LOG(ERROR) << "socket path too long";
+    return base::ScopedFD();
+  }
+  memcpy(address.sun_path, socket_path.data(), socket_path.size());
+
+  base::ScopedFD result(socket(AF_UNIX, SOCK_STREAM, 0));
+  if (!result.is_valid()) {
+    PLOG(ERROR) << "socket";
+    return base::ScopedFD();
+  }
+
+  if (!ConnectSocket(result.get(),
+                     reinterpret_cast<const sockaddr*>(&address),
+                     sizeof(address))) {
+    return base::ScopedFD();
+  }
+  return result;
+}
+
 base::ScopedFD CreateSocket(const std::string& hostname,
                             const std::string& port) {
   addrinfo hints = {};
@@ -309,26 +617,87 @@ base::ScopedFD CreateSocket(const std::string& hostname,
       continue;
     }
 
-    {
-      // Set socket to non-blocking to avoid hanging for a long time if the
-      // network is down.
-      ScopedSetNonblocking nonblocking(result.get());
+    if (!ConnectSocket(result.get(), ap->ai_addr, ap->ai_addrlen)) {
+      return base::ScopedFD();
+    }
+    return result;
+  }
 
-      if (HANDLE_EINTR(connect(result.get(), ap->ai_addr, ap->ai_addrlen)) <
-          0) {
-        if (errno != EINPROGRESS) {
-          PLOG(ERROR) << "connect";
-        } else if (WaitUntilSocketIsReady(result.get())) {
-          return result;
-        }
-        return base::ScopedFD();
-      }
+  return base::ScopedFD();
+}
+
+// Returns true if a connection kept alive after a previous request can no
+// longer be used. Nothing but stream's own control data should be readable
+// from an idle connection, so anything else indicates that the server has
+// closed it or sent something unexpected.
+bool IdleConnectionIsUnusable(Stream* stream, int sock) {
+  pollfd pollfds;
+  pollfds.fd = sock;
+  pollfds.events = POLLIN;
+  int ret = HANDLE_EINTR(poll(&pollfds, 1, 0));
+  if (ret < 0) {
+    PLOG(ERROR) << "poll";
+    return true;
+  }
+  if (ret == 0) {
+    return false;
+  }
+  ScopedSetNonblocking nonblocking(sock);
+  return !stream->ReadIdleControlData();
+}
 
-      return result;
+// Sends size bytes of body_stream from the region at offset in file that
+// HTTPBodyStream::GetFileRegion() returned, as a single chunk if chunked is
+// true. Whatever can’t be sent from the file is copied through a buffer
+// instead, in which case *send_files is set to false so that later regions are
+// copied from the start.
+bool WriteFileRegion(Stream* stream,
+                     HTTPBodyStream* body_stream,
+                     bool chunked,
+                     FileHandle file,
+                     FileOffset offset,
+                     size_t size,
+                     bool* send_files) {
+  if (chunked) {
+    const std::string chunk_size = base::StringPrintf("%zx\r\n", size);
+    if (!stream->LoggingWrite(chunk_size.data(), chunk_size.size())) {
+      return false;
     }
   }
 
-  return base::ScopedFD();
+  size_t sent = 0;
+  while (sent < size) {
+    const FileOperationResult rv =
+        stream->LoggingSendFile(file, offset + sent, size - sent);
+    if (rv < 0) {
+      return false;
+    }
+    if (rv == 0) {
+      break;
+    }
+    sent += rv;
+  }
+  if (sent > 0 && !body_stream->ConsumeFileRegion(sent)) {
+    return false;
+  }
+
+  while (sent < size) {
+    *send_files = false;
+    uint8_t buffer[32 * 1024];
+    const FileOperationResult rv = body_stream->GetBytesBuffer(
+        buffer, std::min(sizeof(buffer), size - sent));
+    if (rv <= 0) {
+      LOG_IF(ERROR, rv == 0) << "body stream ended before file region";
+      return false;
+    }
+    if (!stream->LoggingWrite(buffer, rv)) {
+      return false;
+    }
+    sent += rv;
+  }
+
+  return !chunked ||
+         stream->LoggingWrite(kCRLFTerminator, strlen(kCRLFTerminator));
 }
 
 bool WriteRequest(Stream* stream,
@@ -343,6 +712,7 @@ bool WriteRequest(Stream* stream,
 
   // Write headers, and determine if Content-Length has been specified.
   bool chunked = true;
+  bool connection = false;
   size_t content_length = 0;
   for (const auto& header : headers) {
     std::string header_str = base::StringPrintf(
@@ -350,12 +720,26 @@ bool WriteRequest(Stream* stream,
     if (header.first == kContentLength) {
       chunked = !base::StringToSizeT(header.second, &content_length);
       DCHECK(!chunked);
+    } else if (strcasecmp(header.first.c_str(), kConnection) == 0) {
+      connection = true;
     }
 
     if (!stream->LoggingWrite(header_str.data(), header_str.size()))
       return false;
   }
 
+  // HTTP/1.0 connections are closed after each response unless the client asks
+  // for the connection to be kept alive (RFC 7230 §A.1.2). Ask, so that the
+  // connection can be reused for a subsequent request.
+  if (!connection) {
+    static constexpr const char kConnectionKeepAlive[] =
+        "Connection: keep-alive\r\n";
+    if (!stream->LoggingWrite(kConnectionKeepAlive,
+                              strlen(kConnectionKeepAlive))) {
+      return false;
+    }
+  }
+
   // If no Content-Length, then encode as chunked, so add that header too.
   if (chunked) {
     static constexpr const char kTransferEncodingChunked[] =
@@ -370,8 +754,36 @@ bool WriteRequest(Stream* stream,
     return false;
   }
 
+  // Parts of the body held in files are sent from them directly when the
+  // stream allows it, avoiding copying them through buf below. Each region is
+  // sent as a separate chunk, so its size is limited to keep chunks moderate.
+  constexpr size_t kMaxFileRegionSize = 16 * 1024 * 1024;
+  bool send_files = stream->CanSendFile();
+
   FileOperationResult data_bytes;
   do {
+    if (send_files) {
+      FileHandle file;
+      FileOffset file_offset;
+      data_bytes =
+          body_stream->GetFileRegion(&file, &file_offset, kMaxFileRegionSize);
+      if (data_bytes < 0) {
+        return false;
+      }
+      if (data_bytes > 0) {
+        if (!WriteFileRegion(stream,
+                             body_stream,
+                             chunked,
+                             file,
+                             file_offset,
+                             data_bytes,
+                             &send_files)) {
+          return false;
+        }
+        continue;
+      }
+    }
+
     constexpr size_t kCRLFSize = std::size(kCRLFTerminator) - 1;
     struct __attribute__((packed)) {
       char size[8];
@@ -510,8 +922,14 @@ bool ReadContentChunked(Stream* stream, std::string* body) {
   return false;
 }
 
-bool ReadResponse(Stream* stream, std::string* response_body) {
+// keep_alive is set to true when the server has agreed to keep the connection
+// alive and the response body’s extent is known, so that the connection can be
+// used for another request.
+bool ReadResponse(Stream* stream,
+                  std::string* response_body,
+                  bool* keep_alive) {
   response_body->clear();
+  *keep_alive = false;
 
   if (!ReadResponseLine(stream)) {
     return false;
@@ -523,17 +941,27 @@ bool ReadResponse(Stream* stream, std::string* response_body) {
   }
 
   auto it = response_headers.find("Content-Length");
-  size_t len = 0;
   if (it != response_headers.end()) {
+    size_t len;
     if (!base::StringToSizeT(it->second, &len)) {
       LOG(ERROR) << "invalid Content-Length";
       return false;
     }
-  }
 
-  if (len) {
-    response_body->resize(len, 0);
-    return stream->LoggingRead(&(*response_body)[0], len);
+    if (len) {
+      response_body->resize(len, 0);
+      if (!stream->LoggingRead(&(*response_body)[0], len)) {
+        return false;
+      }
+    }
+
+    for (const auto& header : response_headers) {
+      if (strcasecmp(header.first.c_str(), kConnection) == 0) {
+        *keep_alive = strcasecmp(header.second.c_str(), "keep-alive") == 0;
+        break;
+      }
+    }
+    return true;
   }
 
   it = response_headers.find("Transfer-Encoding");
@@ -546,50 +974,1256 @@ bool ReadResponse(Stream* stream, std::string* response_body) {
                  : stream->LoggingReadToEOF(response_body);
 }
 
-bool HTTPTransportSocket::ExecuteSynchronously(std::string* response_body) {
-  std::string scheme, hostname, port, resource;
-  if (!CrackURL(url(), &scheme, &hostname, &port, &resource)) {
+#if defined(CRASHPAD_USE_BORINGSSL)
+// Makes fd non-blocking for the rest of its life.
+bool SetNonblocking(int fd) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    PLOG(ERROR) << "fcntl";
     return false;
   }
+  return true;
+}
 
-#if !defined(CRASHPAD_USE_BORINGSSL)
-  CHECK(scheme == "http") << "Got " << scheme << " for scheme in '" << url()
-                          << "'";
-#endif
+// An HTTP/2 (RFC 9113) connection, negotiated with ALPN, over which requests
+// made by any number of threads at once are multiplexed, each on its own
+// stream. Request bodies are sent in turn, a frame at a time, within the flow
+// control windows that the server grants.
+//
+// No thread is dedicated to the connection. Instead, one of the threads waiting
+// for a request to complete drives the connection on behalf of all of them
+// until its own request completes, when another waiting thread takes over.
+class HTTP2Connection {
+ public:
+  enum class Result {
+    // The server responded with a status in the range 200-203.
+    kSuccess,
 
-  base::ScopedFD sock(CreateSocket(hostname, port));
-  if (!sock.is_valid()) {
-    return false;
-  }
+    // The request failed, or the server responded with another status.
+    kFailure,
 
-#if defined(CRASHPAD_USE_BORINGSSL)
-  std::unique_ptr<Stream> stream;
-  if (scheme == "https") {
-    auto ssl_stream = std::make_unique<SSLStream>();
-    if (!ssl_stream->Initialize(
-            root_ca_certificate_path(), sock.get(), hostname)) {
-      LOG(ERROR) << "SSLStream Initialize";
+    // The request failed before any of its body was sent, and without the
+    // server having processed it, so it can be made again on another
+    // connection.
+    kRetry,
+  };
+
+  struct Request {
+    // The HPACK-encoded request header fields, and the body to send.
+    std::string header_block;
+    HTTPBodyStream* body_stream;
+
+    // Set by the connection. response_body is only set on success.
+    std::string response_body;
+    Result result;
+    bool done;
+  };
+
+  // sock is connected to the server, and stream has negotiated HTTP/2 on it.
+  // timeout_ms governs how long the connection waits for the server.
+  HTTP2Connection(base::ScopedFD sock,
+                  std::unique_ptr<SSLStream> stream,
+                  int timeout_ms)
+      : lock_(),
+        request_done_(),
+        pending_(),
+        driving_(false),
+        closed_(false),
+        going_away_(false),
+        peer_max_concurrent_streams_(std::numeric_limits<uint32_t>::max()),
+        wake_read_(),
+        wake_write_(),
+        sock_(std::move(sock)),
+        stream_(std::move(stream)),
+        decoder_(),
+        streams_(),
+        read_buffer_(),
+        header_block_(),
+        continuation_stream_id_(0),
+        continuation_end_stream_(false),
+        next_stream_id_(1),
+        last_sent_stream_id_(0),
+        send_window_(kDefaultWindowSize),
+        peer_initial_window_size_(kDefaultWindowSize),
+        peer_max_frame_size_(kDefaultMaxFrameSize),
+        timeout_ms_(timeout_ms),
+        settings_received_(false) {}
+
+  HTTP2Connection(const HTTP2Connection&) = delete;
+  HTTP2Connection& operator=(const HTTP2Connection&) = delete;
+
+  ~HTTP2Connection() = default;
+
+  // Sends the connection preface and exchanges settings with the server.
+  // Returns false on failure, with a message logged.
+  bool Initialize() {
+    int wake_fds[2];
+    if (pipe(wake_fds) != 0) {
+      PLOG(ERROR) << "pipe";
       return false;
     }
-    stream = std::move(ssl_stream);
-  } else {
-    stream = std::make_unique<FdStream>(sock.get());
+    wake_read_.reset(wake_fds[0]);
+    wake_write_.reset(wake_fds[1]);
+    if (!SetNonblocking(wake_read_.get()) ||
+        !SetNonblocking(wake_write_.get()) || !SetNonblocking(sock_.get())) {
+      return false;
+    }
+
+    // Frames are written whole, and small ones such as acknowledgments
+    // shouldn’t wait behind unacknowledged data.
+    const int nodelay = 1;
+    if (setsockopt(sock_.get(),
+                   IPPROTO_TCP,
+                   TCP_NODELAY,
+                   &nodelay,
+                   sizeof(nodelay)) != 0) {
+      PLOG(WARNING) << "setsockopt";
+    }
+
+    // Server push is disabled, because the requests made here have no use for
+    // pushed responses. The other settings keep their initial values.
+    static constexpr char kPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    static constexpr uint8_t kSettings[] = {0, kSettingsEnablePush, 0, 0, 0, 0};
+    if (!Write(kPreface, strlen(kPreface)) ||
+        !WriteFrame(kFrameSettings, 0, 0, kSettings, sizeof(kSettings))) {
+      return false;
+    }
+
+    // The server’s connection preface is a SETTINGS frame, which is waited for
+    // here to learn the server’s limits, and so that it’s acknowledged
+    // promptly even if the connection is kept for later use.
+    while (!settings_received_) {
+      if (!WaitForSocket(POLLIN) || !ReadFrames()) {
+        return false;
+      }
+    }
+    return true;
   }
-#else  // CRASHPAD_USE_BORINGSSL
-  std::unique_ptr<Stream> stream(std::make_unique<FdStream>(sock.get()));
-#endif  // CRASHPAD_USE_BORINGSSL
 
-  if (!WriteRequest(
-          stream.get(), method(), resource, headers(), body_stream())) {
-    return false;
+  // Whether a new request may be made on this connection. A connection that
+  // fails or that the server is closing becomes unusable, and doesn’t become
+  // usable again.
+  bool IsUsable() {
+    std::lock_guard<std::mutex> lock(lock_);
+    return !closed_ && !going_away_;
   }
 
-  if (!ReadResponse(stream.get(), response_body)) {
-    return false;
+  // Makes request, returning once it has completed.
+  void Execute(Request* request) {
+    CRASHPAD_TRACE_EVENT("net", "HTTP2Connection::Execute");
+    request->response_body.clear();
+    request->done = false;
+
+    std::unique_lock<std::mutex> lock(lock_);
+    if (closed_ || going_away_) {
+      request->result = Result::kRetry;
+      request->done = true;
+      return;
+    }
+
+    pending_.push_back(request);
+    if (driving_) {
+      Wake();
+    }
+
+    while (!request->done) {
+      if (driving_) {
+        request_done_.wait(lock);
+        continue;
+      }
+
+      driving_ = true;
+      lock.unlock();
+      Drive(request);
+      lock.lock();
+      driving_ = false;
+      request_done_.notify_all();
+    }
   }
 
-  return true;
-}
+ private:
+  static constexpr int64_t kDefaultWindowSize = 65535;
+  static constexpr int64_t kMaxWindowSize = 0x7fffffff;
+  static constexpr size_t kDefaultMaxFrameSize = 16384;
+  static constexpr size_t kMaxFrameSize = 0xffffff;
+  static constexpr size_t kFrameHeaderSize = 9;
+  static constexpr uint32_t kMaxStreamID = 0x7fffffff;
+
+  static constexpr uint8_t kFrameData = 0x0;
+  static constexpr uint8_t kFrameHeaders = 0x1;
+  static constexpr uint8_t kFrameRSTStream = 0x3;
+  static constexpr uint8_t kFrameSettings = 0x4;
+  static constexpr uint8_t kFramePushPromise = 0x5;
+  static constexpr uint8_t kFramePing = 0x6;
+  static constexpr uint8_t kFrameGoAway = 0x7;
+  static constexpr uint8_t kFrameWindowUpdate = 0x8;
+  static constexpr uint8_t kFrameContinuation = 0x9;
+
+  static constexpr uint8_t kFlagEndStream = 0x1;
+  static constexpr uint8_t kFlagAck = 0x1;
+  static constexpr uint8_t kFlagEndHeaders = 0x4;
+  static constexpr uint8_t kFlagPadded = 0x8;
+  static constexpr uint8_t kFlagPriority = 0x20;
+
+  static constexpr uint16_t kSettingsEnablePush = 0x2;
+  static constexpr uint16_t kSettingsMaxConcurrentStreams = 0x3;
+  static constexpr uint16_t kSettingsInitialWindowSize = 0x4;
+  static constexpr uint16_t kSettingsMaxFrameSize = 0x5;
+
+  static constexpr uint32_t kErrorRefusedStream = 0x7;
+  static constexpr uint32_t kErrorCancel = 0x8;
+
+  struct ActiveStream {
+    Request* request;
+    int64_t send_window;
+    unsigned int status;
+    bool headers_received;
+    bool body_started;
+    bool end_stream_sent;
+  };
+
+  using StreamMap = std::map<uint32_t, ActiveStream>;
+
+  static uint32_t ReadUint32(const uint8_t* data) {
+    return (uint32_t{data[0]} << 24) | (uint32_t{data[1]} << 16) |
+           (uint32_t{data[2]} << 8) | data[3];
+  }
+
+  static void AppendUint32(uint32_t value, std::string* data) {
+    data->push_back(static_cast<char>(value >> 24));
+    data->push_back(static_cast<char>(value >> 16));
+    data->push_back(static_cast<char>(value >> 8));
+    data->push_back(static_cast<char>(value));
+  }
+
+  // Makes a thread that’s driving the connection and waiting for the server
+  // notice a new request.
+  void Wake() {
+    static constexpr char kByte = 0;
+    std::ignore = HANDLE_EINTR(write(wake_write_.get(), &kByte, 1));
+  }
+
+  // Sends and receives on behalf of every request until request is done.
+  void Drive(Request* request) {
+    for (;;) {
+      std::vector<Request*> starting;
+      std::deque<Request*> refused;
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (request->done) {
+          return;
+        }
+        if (going_away_) {
+          refused.swap(pending_);
+        }
+        while (!pending_.empty() && streams_.size() + starting.size() <
+                                        peer_max_concurrent_streams_) {
+          starting.push_back(pending_.front());
+          pending_.pop_front();
+        }
+      }
+
+      // Requests that the connection can no longer take are made again on
+      // another.
+      for (Request* refused_request : refused) {
+        Complete(refused_request, Result::kRetry);
+      }
+
+      bool ok = true;
+      for (size_t index = 0; index < starting.size(); ++index) {
+        if (!StartStream(starting[index])) {
+          std::lock_guard<std::mutex> lock(lock_);
+          pending_.insert(pending_.begin(),
+                          starting.begin() + index + 1,
+                          starting.end());
+          ok = false;
+          break;
+        }
+      }
+
+      bool sent = false;
+      if (!ok || !ReadFrames() || !SendData(&sent)) {
+        Fail();
+        continue;
+      }
+
+      // Wait for the server, or for another request, when there’s nothing else
+      // to do.
+      if (!sent && !stream_->HasBufferedData() && !CanProceed(request)) {
+        pollfd pollfds[2] = {{sock_.get(), POLLIN, 0},
+                             {wake_read_.get(), POLLIN, 0}};
+        const int rv = HANDLE_EINTR(poll(pollfds, 2, timeout_ms_));
+        if (rv < 0) {
+          PLOG(ERROR) << "poll";
+          Fail();
+        } else if (rv == 0) {
+          LOG(ERROR) << "HTTP/2 server timed out";
+          Fail();
+        } else if (pollfds[1].revents) {
+          char buffer[64];
+          while (HANDLE_EINTR(read(wake_read_.get(), buffer, sizeof(buffer))) >
+                 0) {
+          }
+        }
+      }
+    }
+  }
+
+  // Whether request is done, or a pending request can be started or refused,
+  // without waiting.
+  bool CanProceed(Request* request) {
+    std::lock_guard<std::mutex> lock(lock_);
+    return request->done ||
+           (!pending_.empty() &&
+            (going_away_ || streams_.size() < peer_max_concurrent_streams_));
+  }
+
+  // Opens a stream for request and sends its header block.
+  bool StartStream(Request* request) {
+    if (next_stream_id_ > kMaxStreamID) {
+      // Stream identifiers can’t be reused, so another connection is needed.
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        going_away_ = true;
+      }
+      Complete(request, Result::kRetry);
+      return true;
+    }
+    const uint32_t stream_id = next_stream_id_;
+    next_stream_id_ += 2;
+    streams_[stream_id] = {
+        request, peer_initial_window_size_, 0, false, false, false};
+
+    // A header block larger than a frame continues in CONTINUATION frames.
+    const std::string& block = request->header_block;
+    size_t offset = 0;
+    do {
+      const size_t size = std::min(block.size() - offset, peer_max_frame_size_);
+      const bool end = offset + size == block.size();
+      if (!WriteFrame(offset == 0 ? kFrameHeaders : kFrameContinuation,
+                      end ? kFlagEndHeaders : 0,
+                      stream_id,
+                      block.data() + offset,
+                      size)) {
+        return false;
+      }
+      offset += size;
+    } while (offset < block.size());
+    return true;
+  }
+
+  // Sends a DATA frame for the next stream, in turn, that has data to send and
+  // room for it in the flow control windows. sent is set to true if a frame was
+  // sent.
+  bool SendData(bool* sent) {
+    *sent = false;
+    auto it = streams_.upper_bound(last_sent_stream_id_);
+    for (size_t index = 0; index < streams_.size(); ++index, ++it) {
+      if (it == streams_.end()) {
+        it = streams_.begin();
+      }
+      ActiveStream& stream = it->second;
+      const int64_t window = std::min(send_window_, stream.send_window);
+      if (stream.end_stream_sent || window <= 0) {
+        continue;
+      }
+
+      // DATA frames are kept to the smallest maximum frame size, which is also
+      // the largest TLS record.
+      std::string payload(
+          static_cast<size_t>(std::min<int64_t>(window, kDefaultMaxFrameSize)),
+          '\0');
+      stream.body_started = true;
+      const FileOperationResult rv =
+          stream.request->body_stream->GetBytesBuffer(
+              reinterpret_cast<uint8_t*>(&payload[0]), payload.size());
+      if (rv < 0) {
+        const uint32_t stream_id = it->first;
+        CompleteStream(it, Result::kFailure);
+        return ResetStream(stream_id, kErrorCancel);
+      }
+      payload.resize(rv);
+
+      last_sent_stream_id_ = it->first;
+      send_window_ -= rv;
+      stream.send_window -= rv;
+      stream.end_stream_sent = rv == 0;
+      *sent = true;
+      return WriteFrame(kFrameData,
+                        rv == 0 ? kFlagEndStream : 0,
+                        it->first,
+                        payload.data(),
+                        payload.size());
+    }
+    return true;
+  }
+
+  // Reads and processes every complete frame that has arrived.
+  bool ReadFrames() {
+    for (;;) {
+      char buffer[16 * 1024];
+      const FileOperationResult rv =
+          stream_->LoggingReadAvailable(buffer, sizeof(buffer));
+      if (rv < 0) {
+        return false;
+      }
+      if (rv == 0) {
+        break;
+      }
+      read_buffer_.append(buffer, rv);
+    }
+
+    size_t offset = 0;
+    while (read_buffer_.size() - offset >= kFrameHeaderSize) {
+      const uint8_t* header =
+          reinterpret_cast<const uint8_t*>(read_buffer_.data() + offset);
+      const size_t length = ReadUint32(header) >> 8;
+      if (length > kDefaultMaxFrameSize) {
+        LOG(ERROR) << "HTTP/2 frame too large";
+        return false;
+      }
+      if (read_buffer_.size() - offset - kFrameHeaderSize < length) {
+        break;
+      }
+      if (!ProcessFrame(header[3],
+                        header[4],
+                        ReadUint32(header + 5) & kMaxStreamID,
+                        header + kFrameHeaderSize,
+                        length)) {
+        return false;
+      }
+      offset += kFrameHeaderSize + length;
+    }
+    read_buffer_.erase(0, offset);
+    return true;
+  }
+
+  bool ProcessFrame(uint8_t type,
+                    uint8_t flags,
+                    uint32_t stream_id,
+                    const uint8_t* payload,
+                    size_t length) {
+    if (!settings_received_ && type != kFrameSettings) {
+      LOG(ERROR) << "HTTP/2 server preface missing";
+      return false;
+    }
+    if (continuation_stream_id_ != 0 &&
+        (type != kFrameContinuation || stream_id != continuation_stream_id_)) {
+      LOG(ERROR) << "HTTP/2 CONTINUATION expected";
+      return false;
+    }
+
+    switch (type) {
+      case kFrameData:
+      case kFrameHeaders: {
+        if (stream_id == 0) {
+          LOG(ERROR) << "HTTP/2 frame on stream 0";
+          return false;
+        }
+        if (type == kFrameData &&
+            !SendWindowUpdates(stream_id, flags, length)) {
+          return false;
+        }
+
+        size_t skip = 0;
+        size_t padding = 0;
+        if (flags & kFlagPadded) {
+          skip = 1;
+          padding = length > 0 ? payload[0] : 0;
+        }
+        if (type == kFrameHeaders && (flags & kFlagPriority)) {
+          skip += 5;
+        }
+        if (skip + padding > length) {
+          LOG(ERROR) << "HTTP/2 padding too large";
+          return false;
+        }
+        payload += skip;
+        length -= skip + padding;
+
+        if (type == kFrameData) {
+          return ProcessData(stream_id, flags, payload, length);
+        }
+        header_block_.assign(reinterpret_cast<const char*>(payload), length);
+        continuation_end_stream_ = (flags & kFlagEndStream) != 0;
+        break;
+      }
+
+      case kFrameContinuation:
+        if (continuation_stream_id_ == 0) {
+          LOG(ERROR) << "HTTP/2 CONTINUATION unexpected";
+          return false;
+        }
+        header_block_.append(reinterpret_cast<const char*>(payload), length);
+        break;
+
+      case kFrameRSTStream:
+        if (length != 4 || stream_id == 0) {
+          LOG(ERROR) << "HTTP/2 RST_STREAM invalid";
+          return false;
+        }
+        ProcessReset(stream_id, ReadUint32(payload));
+        return true;
+
+      case kFrameSettings:
+        return ProcessSettings(flags, stream_id, payload, length);
+
+      case kFramePushPromise:
+        LOG(ERROR) << "HTTP/2 PUSH_PROMISE unexpected";
+        return false;
+
+      case kFramePing:
+        if (length != 8 || stream_id != 0) {
+          LOG(ERROR) << "HTTP/2 PING invalid";
+          return false;
+        }
+        return (flags & kFlagAck) ||
+               WriteFrame(kFramePing, kFlagAck, 0, payload, length);
+
+      case kFrameGoAway:
+        if (length < 8 || stream_id != 0) {
+          LOG(ERROR) << "HTTP/2 GOAWAY invalid";
+          return false;
+        }
+        ProcessGoAway(ReadUint32(payload) & kMaxStreamID,
+                      ReadUint32(payload + 4));
+        return true;
+
+      case kFrameWindowUpdate:
+        if (length != 4) {
+          LOG(ERROR) << "HTTP/2 WINDOW_UPDATE invalid";
+          return false;
+        }
+        return ProcessWindowUpdate(stream_id, ReadUint32(payload) & 0x7fffffff);
+
+      default:
+        // PRIORITY frames carry nothing of use here, and frames of unknown
+        // types must be ignored.
+        return true;
+    }
+
+    // The rest of the header block may follow in CONTINUATION frames.
+    if (!(flags & kFlagEndHeaders)) {
+      continuation_stream_id_ = stream_id;
+      return true;
+    }
+    continuation_stream_id_ = 0;
+    return ProcessHeaderBlock(stream_id, continuation_end_stream_);
+  }
+
+  bool ProcessHeaderBlock(uint32_t stream_id, bool end_stream) {
+    // Every header block is decoded, even those for streams that are no
+    // longer open, to keep the decoder’s dynamic table in step with the
+    // server’s.
+    HPACKHeaderList headers;
+    if (!decoder_.Decode(reinterpret_cast<const uint8_t*>(header_block_.data()),
+                         header_block_.size(),
+                         &headers)) {
+      return false;
+    }
+
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+      return true;
+    }
+    ActiveStream& stream = it->second;
+
+    if (!stream.headers_received) {
+      unsigned int status = 0;
+      if (headers.empty() || headers[0].first != ":status" ||
+          !base::StringToUint(headers[0].second, &status)) {
+        LOG(ERROR) << "HTTP/2 response status missing";
+        CompleteStream(it, Result::kFailure);
+        return ResetStream(stream_id, kErrorCancel);
+      }
+
+      // Informational responses precede the final response.
+      if (status >= 100 && status < 200 && !end_stream) {
+        return true;
+      }
+      stream.status = status;
+      stream.headers_received = true;
+    }
+
+    return !end_stream || CompleteStreamAtEnd(it);
+  }
+
+  bool ProcessData(uint32_t stream_id,
+                   uint8_t flags,
+                   const uint8_t* payload,
+                   size_t length) {
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+      return true;
+    }
+    if (!it->second.headers_received) {
+      LOG(ERROR) << "HTTP/2 DATA before HEADERS";
+      return false;
+    }
+    it->second.request->response_body.append(
+        reinterpret_cast<const char*>(payload), length);
+    return !(flags & kFlagEndStream) || CompleteStreamAtEnd(it);
+  }
+
+  // Returns the flow control credit for a received DATA frame’s payload to the
+  // server straight away. Responses are small, and are buffered in full
+  // regardless.
+  bool SendWindowUpdates(uint32_t stream_id, uint8_t flags, size_t length) {
+    if (length == 0) {
+      return true;
+    }
+    std::string increment;
+    AppendUint32(static_cast<uint32_t>(length), &increment);
+    if (!WriteFrame(
+            kFrameWindowUpdate, 0, 0, increment.data(), increment.size())) {
+      return false;
+    }
+    return (flags & kFlagEndStream) || !streams_.count(stream_id) ||
+           WriteFrame(kFrameWindowUpdate,
+                      0,
+                      stream_id,
+                      increment.data(),
+                      increment.size());
+  }
+
+  void ProcessReset(uint32_t stream_id, uint32_t error_code) {
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+      return;
+    }
+    LOG(ERROR) << "HTTP/2 stream reset, error " << error_code;
+    CompleteStream(it,
+                   error_code == kErrorRefusedStream && !it->second.body_started
+                       ? Result::kRetry
+                       : Result::kFailure);
+  }
+
+  bool ProcessSettings(uint8_t flags,
+                       uint32_t stream_id,
+                       const uint8_t* payload,
+                       size_t length) {
+    if (stream_id != 0 || length % 6 != 0 ||
+        ((flags & kFlagAck) && length != 0)) {
+      LOG(ERROR) << "HTTP/2 SETTINGS invalid";
+      return false;
+    }
+    if (flags & kFlagAck) {
+      return true;
+    }
+
+    for (size_t offset = 0; offset < length; offset += 6) {
+      const uint16_t identifier = (payload[offset] << 8) | payload[offset + 1];
+      const uint32_t value = ReadUint32(payload + offset + 2);
+      switch (identifier) {
+        case kSettingsMaxConcurrentStreams:
+          peer_max_concurrent_streams_ = value;
+          break;
+
+        case kSettingsInitialWindowSize: {
+          if (value > kMaxWindowSize) {
+            LOG(ERROR) << "HTTP/2 initial window size too large";
+            return false;
+          }
+          // The change applies to the windows of open streams too.
+          const int64_t delta = int64_t{value} - peer_initial_window_size_;
+          for (auto& stream : streams_) {
+            stream.second.send_window += delta;
+            if (stream.second.send_window > kMaxWindowSize) {
+              LOG(ERROR) << "HTTP/2 window too large";
+              return false;
+            }
+          }
+          peer_initial_window_size_ = value;
+          break;
+        }
+
+        case kSettingsMaxFrameSize:
+          if (value < kDefaultMaxFrameSize || value > kMaxFrameSize) {
+            LOG(ERROR) << "HTTP/2 maximum frame size invalid";
+            return false;
+          }
+          peer_max_frame_size_ = value;
+          break;
+
+        default:
+          // The encoder doesn’t use the dynamic table, so the server’s header
+          // table size doesn’t matter.
+          break;
+      }
+    }
+
+    settings_received_ = true;
+    return WriteFrame(kFrameSettings, kFlagAck, 0, nullptr, 0);
+  }
+
+  void ProcessGoAway(uint32_t last_stream_id, uint32_t error_code) {
+    LOG_IF(ERROR, error_code != 0) << "HTTP/2 GOAWAY, error " << error_code;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      going_away_ = true;
+    }
+
+    // Streams after the last one that the server will process weren’t
+    // processed at all. Earlier streams continue.
+    auto it = streams_.upper_bound(last_stream_id);
+    while (it != streams_.end()) {
+      auto next = std::next(it);
+      CompleteStream(
+          it, it->second.body_started ? Result::kFailure : Result::kRetry);
+      it = next;
+    }
+  }
+
+  bool ProcessWindowUpdate(uint32_t stream_id, uint32_t increment) {
+    if (stream_id == 0) {
+      if (increment == 0 || send_window_ + increment > kMaxWindowSize) {
+        LOG(ERROR) << "HTTP/2 WINDOW_UPDATE invalid";
+        return false;
+      }
+      send_window_ += increment;
+      return true;
+    }
+
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+      return true;
+    }
+    if (increment == 0 || it->second.send_window + increment > kMaxWindowSize) {
+      LOG(ERROR) << "HTTP/2 WINDOW_UPDATE invalid";
+      CompleteStream(it, Result::kFailure);
+      return ResetStream(stream_id, kErrorCancel);
+    }
+    it->second.send_window += increment;
+    return true;
+  }
+
+  // Completes a stream whose response has ended. If the server responded
+  // before the whole request body was sent, the rest isn’t sent.
+  bool CompleteStreamAtEnd(StreamMap::iterator it) {
+    const uint32_t stream_id = it->first;
+    const bool end_stream_sent = it->second.end_stream_sent;
+    const unsigned int status = it->second.status;
+    CompleteStream(it,
+                   status >= 200 && status <= 203 ? Result::kSuccess
+                                                  : Result::kFailure);
+    return end_stream_sent || ResetStream(stream_id, kErrorCancel);
+  }
+
+  void CompleteStream(StreamMap::iterator it, Result result) {
+    Request* request = it->second.request;
+    streams_.erase(it);
+    Complete(request, result);
+  }
+
+  void Complete(Request* request, Result result) {
+    if (result != Result::kSuccess) {
+      request->response_body.clear();
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    request->result = result;
+    request->done = true;
+    request_done_.notify_all();
+  }
+
+  // Fails every request after a connection error, and closes the connection.
+  void Fail() {
+    while (!streams_.empty()) {
+      CompleteStream(streams_.begin(),
+                     streams_.begin()->second.body_started ? Result::kFailure
+                                                           : Result::kRetry);
+    }
+
+    std::deque<Request*> pending;
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      closed_ = true;
+      pending.swap(pending_);
+    }
+    for (Request* request : pending) {
+      Complete(request, Result::kRetry);
+    }
+  }
+
+  bool ResetStream(uint32_t stream_id, uint32_t error_code) {
+    std::string payload;
+    AppendUint32(error_code, &payload);
+    return WriteFrame(
+        kFrameRSTStream, 0, stream_id, payload.data(), payload.size());
+  }
+
+  bool WriteFrame(uint8_t type,
+                  uint8_t flags,
+                  uint32_t stream_id,
+                  const void* payload,
+                  size_t length) {
+    DCHECK_LE(length, kMaxFrameSize);
+    std::string frame;
+    frame.reserve(kFrameHeaderSize + length);
+    AppendUint32(static_cast<uint32_t>(length << 8) | type, &frame);
+    frame.push_back(static_cast<char>(flags));
+    AppendUint32(stream_id, &frame);
+    frame.append(static_cast<const char*>(payload), length);
+    return Write(frame.data(), frame.size());
+  }
+
+  bool Write(const void* data, size_t size) {
+    for (;;) {
+      const FileOperationResult rv = stream_->LoggingWriteAvailable(data, size);
+      if (rv != 0) {
+        return rv > 0;
+      }
+      if (!WaitForSocket(POLLOUT)) {
+        return false;
+      }
+    }
+  }
+
+  // Waits for the socket to become ready for events, giving up after the
+  // timeout.
+  bool WaitForSocket(short events) {
+    if (events == POLLIN && stream_->HasBufferedData()) {
+      return true;
+    }
+    pollfd pollfds = {sock_.get(), events, 0};
+    const int rv = HANDLE_EINTR(poll(&pollfds, 1, timeout_ms_));
+    if (rv < 0) {
+      PLOG(ERROR) << "poll";
+      return false;
+    }
+    if (rv == 0) {
+      LOG(ERROR) << "HTTP/2 server timed out";
+      return false;
+    }
+    return true;
+  }
+
+  // Shared by every thread making a request on the connection.
+  std::mutex lock_;
+  std::condition_variable request_done_;
+  std::deque<Request*> pending_;
+  bool driving_;
+  bool closed_;
+  bool going_away_;
+
+  // Only used by the thread driving the connection. stream_ refers to sock_, so
+  // it’s declared after sock_ in order to be destroyed first.
+  uint32_t peer_max_concurrent_streams_;
+  base::ScopedFD wake_read_;
+  base::ScopedFD wake_write_;
+  base::ScopedFD sock_;
+  std::unique_ptr<SSLStream> stream_;
+  HPACKDecoder decoder_;
+  StreamMap streams_;
+  std::string read_buffer_;
+  std::string header_block_;
+  uint32_t continuation_stream_id_;
+  bool continuation_end_stream_;
+  uint32_t next_stream_id_;
+  uint32_t last_sent_stream_id_;
+  int64_t send_window_;
+  int64_t peer_initial_window_size_;
+  size_t peer_max_frame_size_;
+  int timeout_ms_;
+  bool settings_received_;
+};
+
+// HTTP/2 connections are shared by every transport in the process, so that
+// concurrent requests to a server, such as uploads made by several threads,
+// are multiplexed over a single connection. Servers that selected HTTP/1.1 are
+// remembered so that later requests to them use HTTP/1.1 without offering
+// HTTP/2 again.
+class HTTP2ConnectionPool {
+ public:
+  HTTP2ConnectionPool(const HTTP2ConnectionPool&) = delete;
+  HTTP2ConnectionPool& operator=(const HTTP2ConnectionPool&) = delete;
+
+  static HTTP2ConnectionPool* Get() {
+    static HTTP2ConnectionPool* instance = new HTTP2ConnectionPool();
+    return instance;
+  }
+
+  // Finds a usable connection to the server identified by key, which also
+  // identifies the root certificates that verified it. Returns false if the
+  // server is known to use HTTP/1.1. Otherwise, returns true with connection
+  // set to the connection, or to nullptr if the caller must open a connection
+  // and then call FinishConnecting(). While another thread is opening a
+  // connection to the server, this waits for it to finish.
+  bool GetConnection(const std::string& key,
+                     std::shared_ptr<HTTP2Connection>* connection) {
+    connection->reset();
+    std::unique_lock<std::mutex> lock(lock_);
+    for (;;) {
+      if (http1_servers_.count(key)) {
+        return false;
+      }
+      auto it = connections_.find(key);
+      if (it != connections_.end()) {
+        if (it->second->IsUsable()) {
+          *connection = it->second;
+          return true;
+        }
+        connections_.erase(it);
+      }
+      if (!connecting_.count(key)) {
+        break;
+      }
+      connected_.wait(lock);
+    }
+    connecting_.insert(key);
+    return true;
+  }
+
+  // Records the connection opened after GetConnection() returned none, or
+  // nullptr if none was opened, in which case http1 is true if the server
+  // selected HTTP/1.1.
+  void FinishConnecting(const std::string& key,
+                        std::shared_ptr<HTTP2Connection> connection,
+                        bool http1) {
+    std::lock_guard<std::mutex> lock(lock_);
+    connecting_.erase(key);
+    if (connection) {
+      connections_[key] = std::move(connection);
+    } else if (http1) {
+      http1_servers_.insert(key);
+    }
+    connected_.notify_all();
+  }
+
+ private:
+  HTTP2ConnectionPool()
+      : lock_(),
+        connected_(),
+        connections_(),
+        connecting_(),
+        http1_servers_() {}
+  ~HTTP2ConnectionPool() = delete;
+
+  std::mutex lock_;
+  std::condition_variable connected_;
+  std::map<std::string, std::shared_ptr<HTTP2Connection>> connections_;
+  std::set<std::string> connecting_;
+  std::set<std::string> http1_servers_;
+};
+#endif  // CRASHPAD_USE_BORINGSSL
+
+class HTTPTransportSocket final : public HTTPTransport {
+ public:
+  HTTPTransportSocket() = default;
+
+  HTTPTransportSocket(const HTTPTransportSocket&) = delete;
+  HTTPTransportSocket& operator=(const HTTPTransportSocket&) = delete;
+
+  ~HTTPTransportSocket() override = default;
+
+  bool Prewarm() override;
+  bool ExecuteSynchronously(std::string* response_body) override;
+
+ private:
+  // Cracks url(), returning false if its scheme isn’t supported.
+  bool CrackSupportedURL(std::string* scheme,
+                         std::string* hostname,
+                         std::string* port,
+                         std::string* resource);
+
+  // Returns true if the connection kept alive from a previous request or
+  // opened by Prewarm() can be used for a request to the given server.
+  bool HasUsableConnection(const std::string& scheme,
+                           const std::string& hostname,
+                           const std::string& port);
+
+  // Opens a new connection, replacing any existing connection. For https,
+  // HTTP/2 is offered if offer_http2 is true.
+  bool Connect(const std::string& scheme,
+               const std::string& hostname,
+               const std::string& port,
+               bool offer_http2);
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  // Finds or opens an HTTP/2 connection to the https server. Returns false if
+  // no connection could be opened. Otherwise, returns true with connection set
+  // to the HTTP/2 connection, or to nullptr if the server uses HTTP/1.1, in
+  // which case any connection that was opened to it is left in stream_.
+  bool GetHTTP2Connection(const std::string& hostname,
+                          const std::string& port,
+                          std::shared_ptr<HTTP2Connection>* connection);
+
+  // Makes the request on an HTTP/2 connection. retry is set to true if the
+  // request failed before any of it was sent, so that it may be made again on
+  // another connection.
+  bool ExecuteHTTP2(HTTP2Connection* connection,
+                    const std::string& hostname,
+                    const std::string& port,
+                    const std::string& resource,
+                    std::string* response_body,
+                    bool* retry);
+#endif  // CRASHPAD_USE_BORINGSSL
+
+  // Closes the connection kept alive from a previous request, if any.
+  void CloseConnection();
+
+  // The connection used for the most recent request, retained if the server
+  // agreed to keep it alive. stream_ may refer to sock_, so it’s declared
+  // after sock_ in order to be destroyed first.
+  std::string connection_scheme_;
+  std::string connection_hostname_;
+  std::string connection_port_;
+  base::ScopedFD sock_;
+  std::unique_ptr<Stream> stream_;
+};
+
+bool HTTPTransportSocket::Prewarm() {
+  CRASHPAD_TRACE_EVENT("net", "HTTPTransportSocket::Prewarm");
+  std::string scheme, hostname, port, resource;
+  if (!CrackSupportedURL(&scheme, &hostname, &port, &resource)) {
+    return false;
+  }
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  if (scheme == "https" && !HasUsableConnection(scheme, hostname, port)) {
+    // An HTTP/2 connection is kept by the pool, and an HTTP/1.1 connection in
+    // stream_.
+    std::shared_ptr<HTTP2Connection> connection;
+    if (!GetHTTP2Connection(hostname, port, &connection)) {
+      return false;
+    }
+    if (connection || stream_) {
+      return true;
+    }
+  }
+#endif  // CRASHPAD_USE_BORINGSSL
+
+  return HasUsableConnection(scheme, hostname, port) ||
+         Connect(scheme, hostname, port, false);
+}
+
+bool HTTPTransportSocket::ExecuteSynchronously(std::string* response_body) {
+  CRASHPAD_TRACE_EVENT("net", "HTTPTransportSocket::ExecuteSynchronously");
+  std::string scheme, hostname, port, resource;
+  if (!CrackSupportedURL(&scheme, &hostname, &port, &resource)) {
+    return false;
+  }
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  // An HTTP/1.1 connection that’s already open is used in preference to
+  // HTTP/2. A request that fails on an HTTP/2 connection before any of it was
+  // sent, such as on one that the server had closed while it was idle, is
+  // retried once on a new connection.
+  if (scheme == "https" && !HasUsableConnection(scheme, hostname, port)) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      std::shared_ptr<HTTP2Connection> connection;
+      if (!GetHTTP2Connection(hostname, port, &connection)) {
+        return false;
+      }
+      if (!connection) {
+        break;
+      }
+
+      bool retry;
+      if (ExecuteHTTP2(connection.get(),
+                       hostname,
+                       port,
+                       resource,
+                       response_body,
+                       &retry)) {
+        return true;
+      }
+      if (!retry) {
+        return false;
+      }
+    }
+  }
+#endif  // CRASHPAD_USE_BORINGSSL
+
+  if (!HasUsableConnection(scheme, hostname, port) &&
+      !Connect(scheme, hostname, port, false)) {
+    return false;
+  }
+
+  bool keep_alive;
+  if (!WriteRequest(
+          stream_.get(), method(), resource, headers(), body_stream()) ||
+      !ReadResponse(stream_.get(), response_body, &keep_alive)) {
+    CloseConnection();
+    return false;
+  }
+
+  if (!keep_alive) {
+    CloseConnection();
+  }
+
+  return true;
+}
+
+bool HTTPTransportSocket::CrackSupportedURL(std::string* scheme,
+                                            std::string* hostname,
+                                            std::string* port,
+                                            std::string* resource) {
+  if (!CrackURL(url(), scheme, hostname, port, resource)) {
+    return false;
+  }
+
+#if !defined(CRASHPAD_USE_BORINGSSL)
+  CHECK(*scheme == "http" || *scheme == "http+unix")
+      << "Got " << *scheme << " for scheme in '" << url() << "'";
+#endif
+
+  return true;
+}
+
+bool HTTPTransportSocket::HasUsableConnection(const std::string& scheme,
+                                              const std::string& hostname,
+                                              const std::string& port) {
+  if (stream_ &&
+      (scheme != connection_scheme_ || hostname != connection_hostname_ ||
+       port != connection_port_ ||
+       IdleConnectionIsUnusable(stream_.get(), sock_.get()))) {
+    CloseConnection();
+  }
+  return stream_ != nullptr;
+}
+
+bool HTTPTransportSocket::Connect(const std::string& scheme,
+                                  const std::string& hostname,
+                                  const std::string& port,
+                                  bool offer_http2) {
+  CloseConnection();
+
+  base::ScopedFD sock(scheme == "http+unix" ? CreateUnixSocket(hostname)
+                                            : CreateSocket(hostname, port));
+  if (!sock.is_valid()) {
+    return false;
+  }
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+  std::unique_ptr<Stream> stream;
+  if (scheme == "https") {
+    auto ssl_stream = std::make_unique<SSLStream>();
+    if (!ssl_stream->Initialize(root_ca_certificate_path(),
+                                sock.get(),
+                                hostname,
+                                port,
+                                offer_http2)) {
+      LOG(ERROR) << "SSLStream Initialize";
+      return false;
+    }
+    stream = std::move(ssl_stream);
+  } else {
+    stream = std::make_unique<FdStream>(sock.get());
+  }
+#else  // CRASHPAD_USE_BORINGSSL
+  std::unique_ptr<Stream> stream(std::make_unique<FdStream>(sock.get()));
+#endif  // CRASHPAD_USE_BORINGSSL
+
+  connection_scheme_ = scheme;
+  connection_hostname_ = hostname;
+  connection_port_ = port;
+  sock_ = std::move(sock);
+  stream_ = std::move(stream);
+  return true;
+}
+
+void HTTPTransportSocket::CloseConnection() {
+  stream_.reset();
+  sock_.reset();
+  connection_scheme_.clear();
+  connection_hostname_.clear();
+  connection_port_.clear();
+}
+
+#if defined(CRASHPAD_USE_BORINGSSL)
+bool HTTPTransportSocket::GetHTTP2Connection(
+    const std::string& hostname,
+    const std::string& port,
+    std::shared_ptr<HTTP2Connection>* connection) {
+  HTTP2ConnectionPool* pool = HTTP2ConnectionPool::Get();
+  std::string key = root_ca_certificate_path().value();
+  key.append(1, '\0');
+  key.append(hostname + ":" + port);
+  if (!pool->GetConnection(key, connection)) {
+    return true;
+  }
+  if (*connection) {
+    return true;
+  }
+
+  if (!Connect("https", hostname, port, true)) {
+    pool->FinishConnecting(key, nullptr, false);
+    return false;
+  }
+
+  // stream_ is an SSLStream for https.
+  if (!static_cast<SSLStream*>(stream_.get())->NegotiatedHTTP2()) {
+    pool->FinishConnecting(key, nullptr, true);
+    return true;
+  }
+
+  std::unique_ptr<SSLStream> stream(static_cast<SSLStream*>(stream_.release()));
+  base::ScopedFD sock(std::move(sock_));
+  CloseConnection();
+  auto new_connection = std::make_shared<HTTP2Connection>(
+      std::move(sock),
+      std::move(stream),
+      base::saturated_cast<int>(timeout() * 1000));
+  if (!new_connection->Initialize()) {
+    pool->FinishConnecting(key, nullptr, false);
+    return false;
+  }
+  pool->FinishConnecting(key, new_connection, false);
+  *connection = std::move(new_connection);
+  return true;
+}
+
+bool HTTPTransportSocket::ExecuteHTTP2(HTTP2Connection* connection,
+                                       const std::string& hostname,
+                                       const std::string& port,
+                                       const std::string& resource,
+                                       std::string* response_body,
+                                       bool* retry) {
+  *retry = false;
+
+  HPACKHeaderList headers = {
+      {":method", method()},
+      {":scheme", "https"},
+      {":authority", port == "443" ? hostname : hostname + ":" + port},
+      {":path", resource},
+  };
+  for (const auto& header : this->headers()) {
+    // Field names are lowercase in HTTP/2, and connection-specific fields are
+    // not permitted (RFC 9113 §8.2).
+    std::string name(header.first);
+    for (char& c : name) {
+      if (c >= 'A' && c <= 'Z') {
+        c += 'a' - 'A';
+      }
+    }
+    if (name == "connection" || name == "host" || name == "keep-alive" ||
+        name == "proxy-connection" || name == "transfer-encoding" ||
+        name == "upgrade") {
+      continue;
+    }
+    headers.emplace_back(std::move(name), header.second);
+  }
+
+  HTTP2Connection::Request request;
+  HPACKEncode(headers, &request.header_block);
+  request.body_stream = body_stream();
+  connection->Execute(&request);
+
+  switch (request.result) {
+    case HTTP2Connection::Result::kSuccess:
+      if (response_body) {
+        *response_body = std::move(request.response_body);
+      }
+      return true;
+    case HTTP2Connection::Result::kFailure:
+      return false;
+    case HTTP2Connection::Result::kRetry:
+      *retry = true;
+      return false;
+  }
+  return false;
+}
+#endif  // CRASHPAD_USE_BORINGSSL
 
 }  // namespace
 
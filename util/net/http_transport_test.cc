@@ -36,6 +36,8 @@
 #include "util/net/http_body.h"
 #include "util/net/http_headers.h"
 #include "util/net/http_multipart_builder.h"
+#include "util/stdlib/string_number_conversion.h"
+#include "util/string/split_string.h"
 
 namespace crashpad {
 namespace test {
@@ -66,6 +68,8 @@ class HTTPTransportTestFixture : public MultiprocessExec {
         body_stream_(std::move(body_stream)),
         response_code_(http_response_code),
         request_validator_(request_validator),
+        transport_(nullptr),
+        prewarm_(false),
         cert_(),
         scheme_and_host_() {
     base::FilePath server_path = TestPaths::Executable().DirName().Append(
@@ -95,6 +99,14 @@ class HTTPTransportTestFixture : public MultiprocessExec {
 
   const HTTPHeaders& headers() { return headers_; }
 
+  // Executes the request with transport, which remains owned by the caller,
+  // instead of a newly-created transport.
+  void SetTransport(HTTPTransport* transport) { transport_ = transport; }
+
+  // Calls HTTPTransport::Prewarm() after setting the URL and before setting the
+  // headers and body.
+  void SetPrewarm(bool prewarm) { prewarm_ = prewarm; }
+
  private:
   void MultiprocessParent() override {
     // Use Logging*File() instead of Checked*File() so that the test can fail
@@ -120,7 +132,14 @@ class HTTPTransportTestFixture : public MultiprocessExec {
         WritePipeHandle(), random_string.c_str(), random_string.size()));
 
     // Now execute the HTTP request.
-    std::unique_ptr<HTTPTransport> transport(HTTPTransport::Create());
+    std::unique_ptr<HTTPTransport> owned_transport;
+    HTTPTransport* transport = transport_;
+    if (transport) {
+      transport->ResetRequest();
+    } else {
+      owned_transport = HTTPTransport::Create();
+      transport = owned_transport.get();
+    }
     transport->SetMethod("POST");
 
     if (!cert_.empty()) {
@@ -128,6 +147,11 @@ class HTTPTransportTestFixture : public MultiprocessExec {
     }
     transport->SetURL(
         base::StringPrintf("%s:%d/upload", scheme_and_host_.c_str(), port));
+    if (prewarm_) {
+      // Not every implementation can open a connection ahead of the request,
+      // but the request must succeed either way.
+      transport->Prewarm();
+    }
     for (const auto& pair : headers_) {
       transport->SetHeader(pair.first, pair.second);
     }
@@ -161,6 +185,8 @@ class HTTPTransportTestFixture : public MultiprocessExec {
   std::unique_ptr<HTTPBodyStream> body_stream_;
   uint16_t response_code_;
   RequestValidator request_validator_;
+  HTTPTransport* transport_;  // weak
+  bool prewarm_;
   base::FilePath cert_;
   std::string scheme_and_host_;
 };
@@ -323,6 +349,56 @@ TEST_P(HTTPTransport, UnchunkedPlainText) {
   test.Run();
 }
 
+TEST_P(HTTPTransport, ReusedTransport) {
+  // A transport used for one request must be usable for another, with nothing
+  // from the first request carrying over to the second.
+  std::unique_ptr<crashpad::HTTPTransport> transport(
+      crashpad::HTTPTransport::Create());
+  ASSERT_TRUE(transport);
+
+  {
+    std::unique_ptr<HTTPBodyStream> body_stream(
+        new StringHTTPBodyStream(kTextBody));
+
+    HTTPHeaders headers;
+    headers[kContentType] = kTextPlain;
+    headers[kContentLength] = base::StringPrintf("%" PRIuS, strlen(kTextBody));
+
+    HTTPTransportTestFixture test(
+        GetParam(), headers, std::move(body_stream), 200, &UnchunkedPlainText);
+    test.SetTransport(transport.get());
+    test.Run();
+  }
+
+  {
+    HTTPMultipartBuilder builder;
+    builder.SetFormData("key1", "test");
+    builder.SetFormData("key2", "--abcdefg123");
+
+    HTTPHeaders headers;
+    builder.PopulateContentHeaders(&headers);
+
+    HTTPTransportTestFixture test(
+        GetParam(), headers, builder.GetBodyStream(), 200, &ValidFormData);
+    test.SetTransport(transport.get());
+    test.Run();
+  }
+}
+
+TEST_P(HTTPTransport, PrewarmedTransport) {
+  std::unique_ptr<HTTPBodyStream> body_stream(
+      new StringHTTPBodyStream(kTextBody));
+
+  HTTPHeaders headers;
+  headers[kContentType] = kTextPlain;
+  headers[kContentLength] = base::StringPrintf("%" PRIuS, strlen(kTextBody));
+
+  HTTPTransportTestFixture test(
+      GetParam(), headers, std::move(body_stream), 200, &UnchunkedPlainText);
+  test.SetPrewarm(true);
+  test.Run();
+}
+
 void RunUpload33k(const std::string& scheme, bool has_content_length) {
   // On macOS, NSMutableURLRequest winds up calling into a CFReadStream’s Read()
   // callback with a 32kB buffer. Make sure that it’s able to get everything
@@ -385,6 +461,192 @@ INSTANTIATE_TEST_SUITE_P(HTTPTransport,
                          });
 #endif
 
+#if defined(CRASHPAD_HTTP_TRANSPORT_SOCKET) && \
+    defined(CRASHPAD_USE_BORINGSSL) && !BUILDFLAG(IS_FUCHSIA)
+// HTTPTransportSocket negotiates HTTP/2 for https. These tests make requests to
+// http2_transport_test_server, and check what the server received.
+class HTTP2TransportTestFixture : public MultiprocessExec {
+ public:
+  // A request as the server received it.
+  struct ServerRequest {
+    std::string protocol;
+    int connection;
+    unsigned int stream_id;
+    std::string body;
+  };
+
+  // Runs the server in mode, and makes a request with a body of each size in
+  // body_sizes in turn, each with a new transport, as upload workers do.
+  HTTP2TransportTestFixture(const std::string& mode,
+                            const std::vector<size_t>& body_sizes)
+      : MultiprocessExec(),
+        body_sizes_(body_sizes),
+        cert_(TestPaths::TestDataRoot().Append(FILE_PATH_LITERAL(
+            "util/net/testdata/crashpad_util_test_cert.pem"))),
+        requests_() {
+    std::vector<std::string> args;
+    args.push_back(cert_.value());
+    args.push_back(TestPaths::TestDataRoot()
+                       .Append(FILE_PATH_LITERAL(
+                           "util/net/testdata/crashpad_util_test_key.pem"))
+                       .value());
+    args.push_back(mode);
+    SetChildCommand(TestPaths::Executable().DirName().Append(
+                        FILE_PATH_LITERAL("http2_transport_test_server")),
+                    &args);
+  }
+
+  // The requests that the server received, in the order that it responded to
+  // them. Valid after Run().
+  const std::vector<ServerRequest>& requests() const { return requests_; }
+
+ private:
+  void MultiprocessParent() override {
+    uint16_t port;
+    ASSERT_TRUE(LoggingReadFileExactly(ReadPipeHandle(), &port, sizeof(port)));
+
+    std::vector<std::string> bodies;
+    for (size_t index = 0; index < body_sizes_.size(); ++index) {
+      std::string body(body_sizes_[index], '\0');
+      for (size_t offset = 0; offset < body.size(); ++offset) {
+        body[offset] = static_cast<char>('a' + (index + offset) % 26);
+      }
+
+      std::unique_ptr<crashpad::HTTPTransport> transport(
+          crashpad::HTTPTransport::Create());
+      ASSERT_TRUE(transport);
+      transport->SetMethod("POST");
+      transport->SetRootCACertificatePath(cert_);
+      transport->SetURL(
+          base::StringPrintf("https://localhost:%d/upload", port));
+      transport->SetHeader(kContentType, "application/octet-stream");
+      transport->SetHeader(kContentLength,
+                           base::StringPrintf("%" PRIuS, body.size()));
+      transport->SetBodyStream(std::make_unique<StringHTTPBodyStream>(body));
+
+      std::string response_body;
+      EXPECT_TRUE(transport->ExecuteSynchronously(&response_body));
+      EXPECT_EQ(response_body,
+                base::StringPrintf("%" PRIuS "\r\n", body.size()));
+      bodies.push_back(std::move(body));
+    }
+
+    // The server reports what it received once its stdin is closed.
+    CloseWritePipe();
+
+    std::string report;
+    char buf[4096];
+    FileOperationResult bytes_read;
+    while ((bytes_read = ReadFile(ReadPipeHandle(), buf, sizeof(buf))) != 0) {
+      ASSERT_GE(bytes_read, 0);
+      report.append(buf, bytes_read);
+    }
+
+    size_t offset = 0;
+    while (offset < report.size()) {
+      const size_t line_end = report.find('\n', offset);
+      ASSERT_NE(line_end, std::string::npos);
+      const std::vector<std::string> fields =
+          SplitString(report.substr(offset, line_end - offset), ' ');
+      ASSERT_EQ(fields.size(), 4u);
+
+      ServerRequest request;
+      request.protocol = fields[0];
+      size_t body_size;
+      ASSERT_TRUE(StringToNumber(fields[1], &request.connection));
+      ASSERT_TRUE(StringToNumber(fields[2], &request.stream_id));
+      ASSERT_TRUE(StringToNumber(fields[3], &body_size));
+      offset = line_end + 1;
+      ASSERT_LE(body_size, report.size() - offset);
+      request.body = report.substr(offset, body_size);
+      offset += body_size;
+      requests_.push_back(std::move(request));
+    }
+
+    ASSERT_EQ(requests_.size(), bodies.size());
+    for (size_t index = 0; index < bodies.size(); ++index) {
+      EXPECT_EQ(requests_[index].body, bodies[index]) << "index " << index;
+    }
+  }
+
+  std::vector<size_t> body_sizes_;
+  base::FilePath cert_;
+  std::vector<ServerRequest> requests_;
+};
+
+TEST(HTTP2Transport, ALPNFallback) {
+  // The server selects HTTP/1.1, so the first request is made with HTTP/1.1,
+  // and later requests to the server don’t offer HTTP/2 again.
+  HTTP2TransportTestFixture test("http1.1", {100, 200});
+  test.Run();
+
+  const auto& requests = test.requests();
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_EQ(requests[0].protocol, "http/1.1");
+  EXPECT_EQ(requests[0].stream_id, 0u);
+  EXPECT_EQ(requests[1].protocol, "none");
+  EXPECT_EQ(requests[1].stream_id, 0u);
+}
+
+TEST(HTTP2Transport, LargeBody) {
+  // The body is larger than both the connection’s initial window and the
+  // stream’s, so it can only be sent as the server returns flow control credit
+  // with WINDOW_UPDATE frames.
+  HTTP2TransportTestFixture test("h2", {300 * 1024 + 1});
+  test.Run();
+
+  const auto& requests = test.requests();
+  ASSERT_EQ(requests.size(), 1u);
+  EXPECT_EQ(requests[0].protocol, "h2");
+  EXPECT_EQ(requests[0].connection, 1);
+  EXPECT_EQ(requests[0].stream_id, 1u);
+}
+
+TEST(HTTP2Transport, ConnectionReuse) {
+  // Each request is made with its own transport, but they all share one
+  // connection, each on a new stream.
+  HTTP2TransportTestFixture test("h2", {10, 40 * 1024, 0, 30});
+  test.Run();
+
+  const auto& requests = test.requests();
+  ASSERT_EQ(requests.size(), 4u);
+  for (size_t index = 0; index < requests.size(); ++index) {
+    EXPECT_EQ(requests[index].protocol, "h2");
+    EXPECT_EQ(requests[index].connection, 1);
+    EXPECT_EQ(requests[index].stream_id, index * 2 + 1);
+  }
+}
+
+TEST(HTTP2Transport, RetryAfterGoAway) {
+  // The server answers the first request with a GOAWAY that excludes its
+  // stream, so it’s made again on a new connection, which is then used for the
+  // next request too.
+  HTTP2TransportTestFixture test("goaway", {100, 200});
+  test.Run();
+
+  const auto& requests = test.requests();
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_EQ(requests[0].connection, 2);
+  EXPECT_EQ(requests[0].stream_id, 1u);
+  EXPECT_EQ(requests[1].connection, 2);
+  EXPECT_EQ(requests[1].stream_id, 3u);
+}
+
+TEST(HTTP2Transport, RetryAfterRefusedStream) {
+  // The server refuses the first stream, so the request is made again on a new
+  // stream. The connection remains usable.
+  HTTP2TransportTestFixture test("refuse", {100, 200});
+  test.Run();
+
+  const auto& requests = test.requests();
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_EQ(requests[0].connection, 1);
+  EXPECT_EQ(requests[0].stream_id, 3u);
+  EXPECT_EQ(requests[1].connection, 1);
+  EXPECT_EQ(requests[1].stream_id, 5u);
+}
+#endif  // CRASHPAD_HTTP_TRANSPORT_SOCKET
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
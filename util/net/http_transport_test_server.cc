@@ -21,6 +21,20 @@
 // form the response body in a successful response (one with code 200). The
 // server will process one HTTP request, deliver the prearranged response to the
 // client, and write the entire request to stdout. It will then terminate.
+//
+// With --requests=COUNT as its first argument, the server reads COUNT response
+// codes and bodies, each as above, before processing COUNT requests in turn,
+// responding to each with the next of them. It writes every request to stdout,
+// in the order that it processed them, before terminating. In this mode, the
+// server also stops early if stdin is closed, so that a client making too few
+// requests doesn’t leave it waiting forever.
+
+#include <string.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -28,6 +42,7 @@
 #include "build/build_config.h"
 #include "tools/tool_support.h"
 #include "util/file/file_io.h"
+#include "util/stdlib/string_number_conversion.h"
 
 #if COMPILER_MSVC
 #pragma warning(push)
@@ -49,6 +64,21 @@ namespace crashpad {
 namespace {
 
 int HttpTransportTestServerMain(int argc, char* argv[]) {
+  unsigned int request_count = 1;
+  bool stop_at_eof = false;
+  static constexpr char kRequestsPrefix[] = "--requests=";
+  if (argc > 1 &&
+      strncmp(argv[1], kRequestsPrefix, strlen(kRequestsPrefix)) == 0) {
+    stop_at_eof = true;
+    if (!StringToNumber(argv[1] + strlen(kRequestsPrefix), &request_count) ||
+        request_count == 0) {
+      LOG(ERROR) << "invalid request count " << argv[1];
+      return 1;
+    }
+    --argc;
+    ++argv;
+  }
+
   std::unique_ptr<httplib::Server> server;
   if (argc == 1) {
     server.reset(new httplib::Server);
@@ -57,7 +87,8 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
     server.reset(new httplib::SSLServer(argv[1], argv[2]));
 #endif
   } else {
-    LOG(ERROR) << "usage: http_transport_test_server [cert.pem key.pem]";
+    LOG(ERROR) << "usage: http_transport_test_server [--requests=COUNT] "
+                  "[cert.pem key.pem]";
     return 1;
   }
 
@@ -69,17 +100,32 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
 
   server->set_keep_alive_max_count(1);
 
-  uint16_t response_code;
-  char response[16];
+  struct Response {
+    uint16_t code;
+    char body[16];
+  };
+  std::vector<Response> responses(request_count);
+  size_t request_index = 0;
+
+  // Requests may be processed on separate threads.
+  std::mutex lock;
+  bool stopped = false;
 
   std::string to_stdout;
 
   server->Post("/upload",
-               [&response, &response_code, &server, &to_stdout](
-                   const httplib::Request& req, httplib::Response& res) {
-                 res.status = response_code;
-                 if (response_code == 200) {
-                   res.set_content(std::string(response, 16) + "\r\n",
+               [&responses, &request_index, &lock, &stopped, &server,
+                &to_stdout](const httplib::Request& req,
+                            httplib::Response& res) {
+                 std::lock_guard<std::mutex> guard(lock);
+                 if (request_index == responses.size()) {
+                   res.status = 500;
+                   return;
+                 }
+                 const Response& response = responses[request_index];
+                 res.status = response.code;
+                 if (response.code == 200) {
+                   res.set_content(std::string(response.body, 16) + "\r\n",
                                    "text/plain");
                  } else {
                    res.set_content("error", "text/plain");
@@ -93,7 +139,10 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
                  to_stdout += "\r\n";
                  to_stdout += req.body;
 
-                 server->stop();
+                 if (++request_index == responses.size() && !stopped) {
+                   stopped = true;
+                   server->stop();
+                 }
                });
 
   uint16_t port =
@@ -102,16 +151,38 @@ int HttpTransportTestServerMain(int argc, char* argv[]) {
   CheckedWriteFile(
       StdioFileHandle(StdioStream::kStandardOutput), &port, sizeof(port));
 
-  CheckedReadFileExactly(StdioFileHandle(StdioStream::kStandardInput),
-                         &response_code,
-                         sizeof(response_code));
+  for (Response& response : responses) {
+    CheckedReadFileExactly(StdioFileHandle(StdioStream::kStandardInput),
+                           &response.code,
+                           sizeof(response.code));
+
+    CheckedReadFileExactly(StdioFileHandle(StdioStream::kStandardInput),
+                           &response.body,
+                           sizeof(response.body));
+  }
 
-  CheckedReadFileExactly(StdioFileHandle(StdioStream::kStandardInput),
-                         &response,
-                         sizeof(response));
+  std::thread stdin_watcher;
+  if (stop_at_eof) {
+    stdin_watcher = std::thread([&lock, &stopped, &server]() {
+      char c;
+      while (ReadFile(StdioFileHandle(StdioStream::kStandardInput),
+                      &c,
+                      sizeof(c)) > 0) {
+      }
+      std::lock_guard<std::mutex> guard(lock);
+      if (!stopped) {
+        stopped = true;
+        server->stop();
+      }
+    });
+  }
 
   server->listen_after_bind();
 
+  if (stdin_watcher.joinable()) {
+    stdin_watcher.join();
+  }
+
   LoggingWriteFile(StdioFileHandle(StdioStream::kStandardOutput),
                    to_stdout.data(),
                    to_stdout.size());
@@ -34,6 +34,7 @@
 #include "build/build_config.h"
 #include "package.h"
 #include "util/file/file_io.h"
+#include "util/misc/trace_event.h"
 #include "util/net/http_body.h"
 #include "util/numeric/safe_assignment.h"
 #include "util/win/module_version.h"
@@ -140,27 +141,44 @@ class HTTPTransportWin final : public HTTPTransport {
   ~HTTPTransportWin() override;
 
   bool ExecuteSynchronously(std::string* response_body) override;
+
+ private:
+  // WinHTTP pools connections within a session, so the session is kept across
+  // requests, allowing connections to be reused. The connection handle is kept
+  // as well for as long as requests are made to the same server.
+  ScopedHINTERNET session_;
+  ScopedHINTERNET connect_;
+  std::wstring connect_host_name_;
+  INTERNET_PORT connect_port_;
 };
 
-HTTPTransportWin::HTTPTransportWin() : HTTPTransport() {
+HTTPTransportWin::HTTPTransportWin()
+    : HTTPTransport(),
+      session_(),
+      connect_(),
+      connect_host_name_(),
+      connect_port_(0) {
 }
 
 HTTPTransportWin::~HTTPTransportWin() {
 }
 
 bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
-  ScopedHINTERNET session(WinHttpOpen(base::UTF8ToWide(UserAgent()).c_str(),
-                                      WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                      WINHTTP_NO_PROXY_NAME,
-                                      WINHTTP_NO_PROXY_BYPASS,
-                                      0));
-  if (!session.get()) {
-    LOG(ERROR) << WinHttpMessage("WinHttpOpen");
-    return false;
+  CRASHPAD_TRACE_EVENT("net", "HTTPTransportWin::ExecuteSynchronously");
+  if (!session_.get()) {
+    session_.reset(WinHttpOpen(base::UTF8ToWide(UserAgent()).c_str(),
+                               WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                               WINHTTP_NO_PROXY_NAME,
+                               WINHTTP_NO_PROXY_BYPASS,
+                               0));
+    if (!session_.get()) {
+      LOG(ERROR) << WinHttpMessage("WinHttpOpen");
+      return false;
+    }
   }
 
   int timeout_in_ms = static_cast<int>(timeout() * 1000);
-  if (!WinHttpSetTimeouts(session.get(),
+  if (!WinHttpSetTimeouts(session_.get(),
                           timeout_in_ms,
                           timeout_in_ms,
                           timeout_in_ms,
@@ -200,15 +218,20 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
   std::wstring request_target(
       url_path.append(extra_info.substr(0, extra_info.find(L'#'))));
 
-  ScopedHINTERNET connect(WinHttpConnect(
-      session.get(), host_name.c_str(), url_components.nPort, 0));
-  if (!connect.get()) {
-    LOG(ERROR) << WinHttpMessage("WinHttpConnect");
-    return false;
+  if (!connect_.get() || host_name != connect_host_name_ ||
+      url_components.nPort != connect_port_) {
+    connect_.reset(WinHttpConnect(
+        session_.get(), host_name.c_str(), url_components.nPort, 0));
+    if (!connect_.get()) {
+      LOG(ERROR) << WinHttpMessage("WinHttpConnect");
+      return false;
+    }
+    connect_host_name_ = host_name;
+    connect_port_ = url_components.nPort;
   }
 
   ScopedHINTERNET request(WinHttpOpenRequest(
-      connect.get(),
+      connect_.get(),
       base::UTF8ToWide(method()).c_str(),
       request_target.c_str(),
       nullptr,
@@ -388,23 +411,27 @@ bool HTTPTransportWin::ExecuteSynchronously(std::string* response_body) {
 
   if (response_body) {
     response_body->clear();
+  }
 
-    // There isn’t any reason to call WinHttpQueryDataAvailable(), because it
-    // returns the number of bytes available to be read without blocking at the
-    // time of the call, not the number of bytes until end-of-file. This method,
-    // which executes synchronously, is only concerned with reading until EOF.
-    DWORD bytes_read = 0;
-    do {
-      char read_buffer[4096];
-      if (!WinHttpReadData(
-              request.get(), read_buffer, sizeof(read_buffer), &bytes_read)) {
-        LOG(ERROR) << WinHttpMessage("WinHttpReadData");
-        return false;
-      }
+  // There isn’t any reason to call WinHttpQueryDataAvailable(), because it
+  // returns the number of bytes available to be read without blocking at the
+  // time of the call, not the number of bytes until end-of-file. This method,
+  // which executes synchronously, is only concerned with reading until EOF.
+  // The response body is read even when it isn’t wanted, because WinHTTP can
+  // only return the connection to its pool once the response is complete.
+  DWORD bytes_read = 0;
+  do {
+    char read_buffer[4096];
+    if (!WinHttpReadData(
+            request.get(), read_buffer, sizeof(read_buffer), &bytes_read)) {
+      LOG(ERROR) << WinHttpMessage("WinHttpReadData");
+      return false;
+    }
 
+    if (response_body) {
       response_body->append(read_buffer, bytes_read);
-    } while (bytes_read > 0);
-  }
+    }
+  } while (bytes_read > 0);
 
   return true;
 }
@@ -21,6 +21,45 @@
 
 namespace crashpad {
 
+namespace {
+
+int HexDigitValue(char digit) {
+  if (digit >= '0' && digit <= '9')
+    return digit - '0';
+  if (digit >= 'a' && digit <= 'f')
+    return digit - 'a' + 10;
+  if (digit >= 'A' && digit <= 'F')
+    return digit - 'A' + 10;
+  return -1;
+}
+
+// Reverses percent-encoding, as produced by URLEncode(). Returns false if
+// |encoded| contains a malformed escape sequence.
+bool URLDecode(const std::string& encoded, std::string* decoded) {
+  std::string result;
+  result.reserve(encoded.length());
+  for (size_t index = 0; index < encoded.length(); ++index) {
+    if (encoded[index] != '%') {
+      result += encoded[index];
+      continue;
+    }
+    if (index + 2 >= encoded.length()) {
+      return false;
+    }
+    int high = HexDigitValue(encoded[index + 1]);
+    int low = HexDigitValue(encoded[index + 2]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    result += static_cast<char>(high << 4 | low);
+    index += 2;
+  }
+  decoded->swap(result);
+  return true;
+}
+
+}  // namespace
+
 std::string URLEncode(const std::string& url) {
   const char kSafeCharacters[] = "-_.~";
   std::string encoded;
@@ -53,6 +92,7 @@ bool CrackURL(const std::string& url,
   size_t host_start;
   static constexpr const char kHttp[] = "http://";
   static constexpr const char kHttps[] = "https://";
+  static constexpr const char kHttpUnix[] = "http+unix://";
   if (url.compare(0, strlen(kHttp), kHttp) == 0) {
     result_scheme = "http";
     result_port = "80";
@@ -61,8 +101,11 @@ bool CrackURL(const std::string& url,
     result_scheme = "https";
     result_port = "443";
     host_start = strlen(kHttps);
+  } else if (url.compare(0, strlen(kHttpUnix), kHttpUnix) == 0) {
+    result_scheme = "http+unix";
+    host_start = strlen(kHttpUnix);
   } else {
-    LOG(ERROR) << "expecting http or https";
+    LOG(ERROR) << "expecting http, https, or http+unix";
     return false;
   }
 
@@ -73,10 +116,26 @@ bool CrackURL(const std::string& url,
     return false;
   }
 
-  scheme->swap(result_scheme);
-  port->swap(result_port);
   std::string host_and_possible_port =
       url.substr(host_start, resource_start - host_start);
+  if (result_scheme == "http+unix") {
+    // The host is the percent-encoded path to the socket, which may contain
+    // characters such as ':' that are not otherwise special to it.
+    std::string socket_path;
+    if (!URLDecode(host_and_possible_port, &socket_path) ||
+        socket_path.empty()) {
+      LOG(ERROR) << "invalid socket path";
+      return false;
+    }
+    scheme->swap(result_scheme);
+    host->swap(socket_path);
+    port->clear();
+    *rest = url.substr(resource_start);
+    return true;
+  }
+
+  scheme->swap(result_scheme);
+  port->swap(result_port);
   size_t colon = host_and_possible_port.find(':');
   if (colon == std::string::npos) {
     *host = host_and_possible_port;
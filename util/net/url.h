@@ -31,10 +31,15 @@ std::string URLEncode(const std::string& url);
 //! This is not a general function, and works only on the limited style of URLs
 //! that are expected to be used by HTTPTransport::SetURL().
 //!
+//! A URL with the `http+unix` scheme, such as
+//! `http+unix://%2Frun%2Fcrash-agent.sock/upload`, names a Unix domain socket
+//! to send HTTP requests over. Its host component is the percent-encoded path
+//! to the socket.
+//!
 //! \param[in] url The URL to crack.
-//! \param[out] scheme The request scheme, either http or https.
-//! \param[out] host The hostname.
-//! \param[out] port The port.
+//! \param[out] scheme The request scheme, either http, https, or http+unix.
+//! \param[out] host The hostname, or for http+unix, the decoded socket path.
+//! \param[out] port The port, or for http+unix, an empty string.
 //! \param[out] rest The remainder of the URL (both resource and URL params).
 //! \return `true` on success in which case all output parameters will be filled
 //!     out, or `false` on failure, in which case the output parameters will be
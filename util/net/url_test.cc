@@ -127,6 +127,32 @@ TEST(CrackURL, WithURLParams) {
   EXPECT_EQ(rest, "/things?blah=stuff:3");
 }
 
+TEST(CrackURL, UnixSocket) {
+  std::string scheme, host, port, rest;
+
+  ASSERT_TRUE(CrackURL("http+unix://%2Frun%2Fcrash-agent.sock/upload?a=b:c",
+                       &scheme,
+                       &host,
+                       &port,
+                       &rest));
+  EXPECT_EQ(scheme, "http+unix");
+  EXPECT_EQ(host, "/run/crash-agent.sock");
+  EXPECT_EQ(port, "");
+  EXPECT_EQ(rest, "/upload?a=b:c");
+
+  ASSERT_TRUE(CrackURL(
+      "http+unix://relative%3a1.sock/", &scheme, &host, &port, &rest));
+  EXPECT_EQ(host, "relative:1.sock");
+  EXPECT_EQ(port, "");
+  EXPECT_EQ(rest, "/");
+
+  EXPECT_FALSE(CrackURL("http+unix:///upload", &scheme, &host, &port, &rest));
+  EXPECT_FALSE(
+      CrackURL("http+unix://%2Frun%2/upload", &scheme, &host, &port, &rest));
+  EXPECT_FALSE(
+      CrackURL("http+unix://%2Frun%zz/upload", &scheme, &host, &port, &rest));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
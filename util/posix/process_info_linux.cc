@@ -16,6 +16,10 @@
 
 #include <stdio.h>
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "base/check.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
@@ -275,16 +279,16 @@ bool ProcessInfo::Arguments(std::vector<std::string>* argv) const {
   DelimitedFileReader cmdline_file_field_reader(&cmdline_file);
 
   std::vector<std::string> local_argv;
-  std::string argument;
+  std::string_view argument;
   DelimitedFileReader::Result result;
-  while ((result = cmdline_file_field_reader.GetDelim('\0', &argument)) ==
+  while ((result = cmdline_file_field_reader.GetDelimView('\0', &argument)) ==
          DelimitedFileReader::Result::kSuccess) {
     if (argument.back() != '\0') {
       LOG(ERROR) << "format error";
       return false;
     }
-    argument.pop_back();
-    local_argv.push_back(argument);
+    argument.remove_suffix(1);
+    local_argv.emplace_back(argument);
   }
   if (result != DelimitedFileReader::Result::kEndOfFile) {
     return false;
@@ -25,6 +25,16 @@
 namespace crashpad {
 
 bool ProcessMemory::Read(VMAddress address, VMSize size, void* buffer) const {
+  if (!ReadUncounted(address, size, buffer)) {
+    return false;
+  }
+  CountBytesRead(size);
+  return true;
+}
+
+bool ProcessMemory::ReadUncounted(VMAddress address,
+                                  VMSize size,
+                                  void* buffer) const {
   size_t local_size;
   if (!AssignIfInRange(&local_size, size)) {
     LOG(ERROR) << "size " << size << " out of bounds for size_t";
@@ -49,6 +59,51 @@ bool ProcessMemory::Read(VMAddress address, VMSize size, void* buffer) const {
   return true;
 }
 
+bool ProcessMemory::ReadBatch(const std::vector<ReadRange>& ranges,
+                              std::vector<bool>* results) const {
+  std::vector<bool> local_results;
+  if (!results) {
+    results = &local_results;
+  }
+  results->assign(ranges.size(), false);
+
+  ReadBatchInternal(ranges, results);
+
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    if ((*results)[index]) {
+      CountBytesRead(ranges[index].size);
+    }
+  }
+
+  return std::find(results->begin(), results->end(), false) == results->end();
+}
+
+void ProcessMemory::ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                                      std::vector<bool>* results) const {
+  DCHECK_EQ(results->size(), ranges.size());
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    const ReadRange& range = ranges[index];
+    (*results)[index] =
+        ReadUncounted(range.address, range.size, range.buffer);
+  }
+}
+
+void ProcessMemory::UnpopulatedRanges(
+    VMAddress address,
+    VMSize size,
+    std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const {
+  ranges->clear();
+  if (size == 0) {
+    return;
+  }
+  UnpopulatedRangesInternal(address, size, ranges);
+}
+
+void ProcessMemory::UnpopulatedRangesInternal(
+    VMAddress address,
+    VMSize size,
+    std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const {}
+
 bool ProcessMemory::ReadCStringInternal(VMAddress address,
                                         bool has_size,
                                         VMSize size,
@@ -77,6 +132,7 @@ bool ProcessMemory::ReadCStringInternal(VMAddress address,
     if (bytes_read == 0) {
       break;
     }
+    CountBytesRead(bytes_read);
 
     char* nul = static_cast<char*>(memchr(buffer, '\0', bytes_read));
     if (nul != nullptr) {
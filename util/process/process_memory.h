@@ -15,12 +15,16 @@
 #ifndef CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_H_
 #define CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include "build/build_config.h"
 #include "util/misc/address_types.h"
+#include "util/numeric/checked_range.h"
 
 #if BUILDFLAG(IS_WIN)
 #include <basetsd.h>
@@ -48,6 +52,55 @@ class ProcessMemory {
   //!     failure, with a message logged.
   bool Read(VMAddress address, VMSize size, void* buffer) const;
 
+  //! \brief A memory region to be copied by ReadBatch().
+  struct ReadRange {
+    //! \brief The address, in the target process' address space, of the
+    //!     memory region to copy.
+    VMAddress address;
+
+    //! \brief The size, in bytes, of the memory region to copy.
+    VMSize size;
+
+    //! \brief The buffer into which the contents of the region will be
+    //!     copied. This must be at least #size bytes.
+    void* buffer;
+  };
+
+  //! \brief Copies several memory regions from the target process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! This is equivalent to calling Read() for each element of \a ranges, but
+  //! implementations may be able to service all of the regions with fewer
+  //! system calls.
+  //!
+  //! \param[in] ranges The memory regions to copy.
+  //! \param[out] results Resized to the size of \a ranges. Each element is set
+  //!     to `true` if the corresponding region was copied in full, and `false`
+  //!     otherwise. May be `nullptr` if only the aggregate result is needed.
+  //!
+  //! \return `true` if every region was copied successfully. `false` if any
+  //!     region could not be copied, with a message logged.
+  bool ReadBatch(const std::vector<ReadRange>& ranges,
+                 std::vector<bool>* results) const;
+
+  //! \brief Determines which pages of a memory region the target process has
+  //!     never populated.
+  //!
+  //! Such pages read as zeroes, so callers may avoid reading them. Not every
+  //! implementation can determine this, and those that can may only do so for
+  //! some pages, so a page that isn't reported may still read as zeroes.
+  //!
+  //! \param[in] address The address, in the target process' address space, of
+  //!     the memory region to examine.
+  //! \param[in] size The size, in bytes, of the memory region to examine.
+  //! \param[out] ranges Page-aligned ranges within the region that have never
+  //!     been populated, sorted by address and neither overlapping nor
+  //!     abutting one another. Empty if none are known.
+  void UnpopulatedRanges(
+      VMAddress address,
+      VMSize size,
+      std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -84,12 +137,29 @@ class ProcessMemory {
     return ReadCStringInternal(address, true, size, string);
   }
 
+  //! \brief Returns the total number of bytes successfully copied from the
+  //!     target process by this object.
+  uint64_t BytesRead() const {
+    return bytes_read_.load(std::memory_order_relaxed);
+  }
+
   virtual ~ProcessMemory() = default;
 
  protected:
-  ProcessMemory() = default;
+  ProcessMemory() : bytes_read_(0) {}
+
+  //! \brief Behaves like Read(), but doesn't contribute to BytesRead().
+  //!
+  //! ReadBatch() accounts for the regions it copies, so implementations of
+  //! ReadBatchInternal() must use this instead of Read().
+  bool ReadUncounted(VMAddress address, VMSize size, void* buffer) const;
 
  private:
+  // Adds size to bytes_read_.
+  void CountBytesRead(uint64_t size) const {
+    bytes_read_.fetch_add(size, std::memory_order_relaxed);
+  }
+
   //! \brief Copies memory from the target process into a caller-provided buffer
   //!     in the current process, up to a maximum number of bytes.
   //!
@@ -106,6 +176,29 @@ class ProcessMemory {
                            size_t size,
                            void* buffer) const = 0;
 
+  //! \brief Copies several memory regions from the target process.
+  //!
+  //! This is called by ReadBatch(). The default implementation calls Read()
+  //! once for each region. Implementations that can read several regions with
+  //! a single system call should override it.
+  //!
+  //! \param[in] ranges The memory regions to copy.
+  //! \param[out] results A vector the same size as \a ranges, with every
+  //!     element initially `false`. Implementations set elements to `true` for
+  //!     each region copied in full.
+  virtual void ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                                 std::vector<bool>* results) const;
+
+  //! \brief Determines which pages of a memory region the target process has
+  //!     never populated.
+  //!
+  //! This is called by UnpopulatedRanges() with a region of nonzero size and
+  //! an empty \a ranges. The default implementation reports none.
+  virtual void UnpopulatedRangesInternal(
+      VMAddress address,
+      VMSize size,
+      std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
@@ -127,8 +220,13 @@ class ProcessMemory {
                                    VMSize size,
                                    std::string* string) const;
 
-  // Allow ProcessMemorySanitized to call ReadUpTo.
+  mutable std::atomic<uint64_t> bytes_read_;
+
+  // Allow ProcessMemorySanitized and SharedCrashContextMemory to call
+  // ReadUpTo, and ProcessMemoryCached to call ReadUpTo and ReadBatchInternal.
+  friend class ProcessMemoryCached;
   friend class ProcessMemorySanitized;
+  friend class SharedCrashContextMemory;
 };
 
 }  // namespace crashpad
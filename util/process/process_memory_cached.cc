@@ -0,0 +1,165 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/process_memory_cached.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "base/logging.h"
+#include "util/misc/metrics.h"
+
+namespace crashpad {
+
+ProcessMemoryCached::ProcessMemoryCached()
+    : ProcessMemory(),
+      blocks_(),
+      index_(),
+      lock_(),
+      hits_(0),
+      misses_(0),
+      memory_(nullptr),
+      max_blocks_(0) {}
+
+ProcessMemoryCached::~ProcessMemoryCached() {}
+
+bool ProcessMemoryCached::Initialize(const ProcessMemory* memory,
+                                     size_t max_blocks) {
+  INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
+  memory_ = memory;
+  max_blocks_ = max_blocks;
+  index_.reserve(max_blocks_);
+  INITIALIZATION_STATE_SET_VALID(initialized_);
+  return true;
+}
+
+uint64_t ProcessMemoryCached::Hits() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(lock_);
+  return hits_;
+}
+
+uint64_t ProcessMemoryCached::Misses() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(lock_);
+  return misses_;
+}
+
+void ProcessMemoryCached::ReportMetrics() const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  base::AutoLock lock(lock_);
+  Metrics::ProcessMemoryCacheUsage(hits_, misses_);
+}
+
+ssize_t ProcessMemoryCached::ReadUpTo(VMAddress address,
+                                      size_t size,
+                                      void* buffer) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  if (max_blocks_ == 0 || size == 0 ||
+      size > kMaxCachedReadBlocks * kBlockSize ||
+      address > std::numeric_limits<VMAddress>::max() - size) {
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+
+  const VMAddress block_address = address & ~VMAddress{kBlockSize - 1};
+  const size_t offset = static_cast<size_t>(address - block_address);
+
+  {
+    base::AutoLock lock(lock_);
+    auto it = index_.find(block_address);
+    if (it != index_.end()) {
+      ++hits_;
+      blocks_.splice(blocks_.begin(), blocks_, it->second);
+      const size_t count = std::min(size, kBlockSize - offset);
+      memcpy(buffer, it->second->data.get() + offset, count);
+      return count;
+    }
+    ++misses_;
+  }
+
+  // Fetch every block spanned by the read at once. The lock isn't held while
+  // reading from the target process so that other threads can continue to be
+  // serviced from the cache.
+  const size_t fetch_blocks = (offset + size + kBlockSize - 1) / kBlockSize;
+  std::vector<uint8_t> fetched(fetch_blocks * kBlockSize);
+  const ssize_t fetched_size =
+      memory_->ReadUpTo(block_address, fetched.size(), fetched.data());
+  if (fetched_size < 0) {
+    return -1;
+  }
+
+  // Only whole blocks are cached. If the first block couldn't be read in full,
+  // the part of it requested may still be readable.
+  const size_t fetched_blocks = static_cast<size_t>(fetched_size) / kBlockSize;
+  if (fetched_blocks == 0) {
+    return memory_->ReadUpTo(address, size, buffer);
+  }
+
+  {
+    base::AutoLock lock(lock_);
+    for (size_t index = 0; index < fetched_blocks; ++index) {
+      InsertBlock(block_address + index * kBlockSize,
+                  fetched.data() + index * kBlockSize);
+    }
+  }
+
+  const size_t count = std::min(size, fetched_blocks * kBlockSize - offset);
+  memcpy(buffer, fetched.data() + offset, count);
+  return count;
+}
+
+void ProcessMemoryCached::ReadBatchInternal(
+    const std::vector<ReadRange>& ranges,
+    std::vector<bool>* results) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+
+  // Batched reads are used for large regions such as thread stacks, which
+  // would only displace more useful blocks from the cache.
+  memory_->ReadBatchInternal(ranges, results);
+}
+
+void ProcessMemoryCached::UnpopulatedRangesInternal(
+    VMAddress address,
+    VMSize size,
+    std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  memory_->UnpopulatedRangesInternal(address, size, ranges);
+}
+
+void ProcessMemoryCached::InsertBlock(VMAddress address,
+                                      const uint8_t* data) const {
+  auto it = index_.find(address);
+  if (it != index_.end()) {
+    // Another thread fetched this block while the lock wasn't held.
+    blocks_.splice(blocks_.begin(), blocks_, it->second);
+    return;
+  }
+
+  if (blocks_.size() < max_blocks_) {
+    blocks_.push_front(Block{address, std::make_unique<uint8_t[]>(kBlockSize)});
+  } else {
+    // Reuse the least recently used block's storage.
+    index_.erase(blocks_.back().address);
+    blocks_.splice(blocks_.begin(), blocks_, std::prev(blocks_.end()));
+    blocks_.front().address = address;
+  }
+  memcpy(blocks_.front().data.get(), data, kBlockSize);
+  index_[address] = blocks_.begin();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,126 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_CACHED_H_
+#define CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_CACHED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/misc/address_types.h"
+#include "util/misc/initialization_state_dcheck.h"
+#include "util/process/process_memory.h"
+
+namespace crashpad {
+
+//! \brief Cached access to the memory of another process.
+//!
+//! Reads are serviced from a bounded, least-recently-used cache of
+//! page-aligned blocks. On a miss, all of the blocks spanned by a read are
+//! fetched from the underlying ProcessMemory with a single read. This makes
+//! the many small, nearby reads made while taking a snapshot (ELF headers,
+//! dynamic arrays, string tables, link maps, annotation lists) cost one access
+//! to the target process per block instead of one per read.
+//!
+//! The cache never observes changes made to the target process' memory after a
+//! block has been fetched, so an object of this class should only be used
+//! while the target process is suspended, such as for the duration of a single
+//! capture.
+//!
+//! This class is thread-safe.
+class ProcessMemoryCached final : public ProcessMemory {
+ public:
+  //! \brief The size and alignment of the blocks that are cached.
+  static constexpr size_t kBlockSize = 4096;
+
+  //! \brief The default maximum number of blocks cached.
+  static constexpr size_t kDefaultMaxBlocks = 1024;
+
+  //! \brief Reads larger than this many blocks bypass the cache.
+  static constexpr size_t kMaxCachedReadBlocks = 4;
+
+  ProcessMemoryCached();
+
+  ProcessMemoryCached(const ProcessMemoryCached&) = delete;
+  ProcessMemoryCached& operator=(const ProcessMemoryCached&) = delete;
+
+  ~ProcessMemoryCached();
+
+  //! \brief Initializes this object to read memory from the underlying
+  //!     \a memory object.
+  //!
+  //! This method must be called successfully prior to calling any other method
+  //! in this class.
+  //!
+  //! \param[in] memory The memory object to read memory from.
+  //! \param[in] max_blocks The maximum number of blocks to cache. If `0`, all
+  //!     reads are passed directly to \a memory.
+  //!
+  //! \return `true` on success, `false` on failure with a message logged.
+  bool Initialize(const ProcessMemory* memory,
+                  size_t max_blocks = kDefaultMaxBlocks);
+
+  //! \brief Returns the number of reads serviced from the cache.
+  uint64_t Hits() const;
+
+  //! \brief Returns the number of reads that required fetching from the
+  //!     underlying ProcessMemory.
+  //!
+  //! Reads that bypass the cache because of their size are not counted.
+  uint64_t Misses() const;
+
+  //! \brief Reports the cache's hit rate through
+  //!     Metrics::ProcessMemoryCacheUsage().
+  void ReportMetrics() const;
+
+ private:
+  struct Block {
+    VMAddress address;
+    std::unique_ptr<uint8_t[]> data;
+  };
+
+  ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  void ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                         std::vector<bool>* results) const override;
+  void UnpopulatedRangesInternal(
+      VMAddress address,
+      VMSize size,
+      std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const override;
+
+  // Inserts the block at address, copied from data, as the most recently used
+  // block, evicting the least recently used block if the cache is full.
+  // lock_ must be held.
+  void InsertBlock(VMAddress address, const uint8_t* data) const;
+
+  // The most recently used block is at the front.
+  mutable std::list<Block> blocks_;
+  mutable std::unordered_map<VMAddress, std::list<Block>::iterator> index_;
+  mutable base::Lock lock_;
+  mutable uint64_t hits_;
+  mutable uint64_t misses_;
+  const ProcessMemory* memory_;  // weak
+  size_t max_blocks_;
+  InitializationStateDcheck initialized_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_PROCESS_PROCESS_MEMORY_CACHED_H_
@@ -0,0 +1,225 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/process/process_memory_cached.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+constexpr VMAddress kBase = 0x10000;
+constexpr size_t kBlockSize = ProcessMemoryCached::kBlockSize;
+
+// Serves reads from a local buffer mapped at kBase, counting the number of
+// reads made.
+class FakeProcessMemory : public ProcessMemory {
+ public:
+  explicit FakeProcessMemory(size_t size) : data_(size), reads_(0) {
+    for (size_t index = 0; index < data_.size(); ++index) {
+      data_[index] = static_cast<uint8_t>(index * 7 + index / kBlockSize);
+    }
+  }
+
+  FakeProcessMemory(const FakeProcessMemory&) = delete;
+  FakeProcessMemory& operator=(const FakeProcessMemory&) = delete;
+
+  ~FakeProcessMemory() override = default;
+
+  const uint8_t* Data(VMAddress address) const {
+    return data_.data() + (address - kBase);
+  }
+
+  void Write(VMAddress address, const char* string) {
+    memcpy(data_.data() + (address - kBase), string, strlen(string) + 1);
+  }
+
+  size_t reads() const { return reads_; }
+
+ private:
+  ssize_t ReadUpTo(VMAddress address,
+                   size_t size,
+                   void* buffer) const override {
+    ++reads_;
+    if (address < kBase || address >= kBase + data_.size()) {
+      return -1;
+    }
+    size_t count = std::min(size, data_.size() - (address - kBase));
+    memcpy(buffer, Data(address), count);
+    return count;
+  }
+
+  std::vector<uint8_t> data_;
+  mutable size_t reads_;
+};
+
+TEST(ProcessMemoryCached, ReadsAreCached) {
+  FakeProcessMemory memory(8 * kBlockSize);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory));
+
+  uint8_t buffer[64];
+  ASSERT_TRUE(cached.Read(kBase + 16, sizeof(buffer), buffer));
+  EXPECT_EQ(memcmp(buffer, memory.Data(kBase + 16), sizeof(buffer)), 0);
+  EXPECT_EQ(memory.reads(), 1u);
+  EXPECT_EQ(cached.Hits(), 0u);
+  EXPECT_EQ(cached.Misses(), 1u);
+
+  // Other reads from the same block don't read from the target process.
+  ASSERT_TRUE(cached.Read(kBase + 1000, sizeof(buffer), buffer));
+  EXPECT_EQ(memcmp(buffer, memory.Data(kBase + 1000), sizeof(buffer)), 0);
+  ASSERT_TRUE(cached.Read(kBase, 1, buffer));
+  EXPECT_EQ(buffer[0], *memory.Data(kBase));
+  EXPECT_EQ(memory.reads(), 1u);
+  EXPECT_EQ(cached.Hits(), 2u);
+  EXPECT_EQ(cached.Misses(), 1u);
+
+  EXPECT_EQ(cached.BytesRead(), 2 * sizeof(buffer) + 1);
+}
+
+TEST(ProcessMemoryCached, SpanningReadFetchesBlocksTogether) {
+  FakeProcessMemory memory(8 * kBlockSize);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory));
+
+  // A read spanning three blocks is serviced by one read from the target
+  // process.
+  std::vector<uint8_t> buffer(2 * kBlockSize);
+  const VMAddress address = kBase + kBlockSize + kBlockSize / 2;
+  ASSERT_TRUE(cached.Read(address, buffer.size(), buffer.data()));
+  EXPECT_EQ(memcmp(buffer.data(), memory.Data(address), buffer.size()), 0);
+  EXPECT_EQ(memory.reads(), 1u);
+
+  // All three blocks are now cached.
+  uint8_t byte;
+  ASSERT_TRUE(cached.Read(kBase + kBlockSize, 1, &byte));
+  ASSERT_TRUE(cached.Read(kBase + 3 * kBlockSize + kBlockSize - 1, 1, &byte));
+  EXPECT_EQ(byte, *memory.Data(kBase + 4 * kBlockSize - 1));
+  EXPECT_EQ(memory.reads(), 1u);
+}
+
+TEST(ProcessMemoryCached, LeastRecentlyUsedBlocksAreEvicted) {
+  FakeProcessMemory memory(8 * kBlockSize);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory, 2));
+
+  uint8_t byte;
+  ASSERT_TRUE(cached.Read(kBase, 1, &byte));
+  ASSERT_TRUE(cached.Read(kBase + kBlockSize, 1, &byte));
+  ASSERT_TRUE(cached.Read(kBase, 1, &byte));
+  EXPECT_EQ(memory.reads(), 2u);
+
+  // The second block is the least recently used, so it's evicted to make room
+  // for the third.
+  ASSERT_TRUE(cached.Read(kBase + 2 * kBlockSize, 1, &byte));
+  EXPECT_EQ(memory.reads(), 3u);
+  ASSERT_TRUE(cached.Read(kBase, 1, &byte));
+  EXPECT_EQ(memory.reads(), 3u);
+  ASSERT_TRUE(cached.Read(kBase + kBlockSize, 1, &byte));
+  EXPECT_EQ(byte, *memory.Data(kBase + kBlockSize));
+  EXPECT_EQ(memory.reads(), 4u);
+}
+
+TEST(ProcessMemoryCached, LargeReadsBypassCache) {
+  FakeProcessMemory memory(16 * kBlockSize);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory));
+
+  std::vector<uint8_t> buffer(
+      (ProcessMemoryCached::kMaxCachedReadBlocks + 1) * kBlockSize);
+  ASSERT_TRUE(cached.Read(kBase, buffer.size(), buffer.data()));
+  EXPECT_EQ(memcmp(buffer.data(), memory.Data(kBase), buffer.size()), 0);
+  EXPECT_EQ(cached.Hits(), 0u);
+  EXPECT_EQ(cached.Misses(), 0u);
+
+  uint8_t byte;
+  ASSERT_TRUE(cached.Read(kBase, 1, &byte));
+  EXPECT_EQ(cached.Misses(), 1u);
+}
+
+TEST(ProcessMemoryCached, PartiallyReadableRange) {
+  FakeProcessMemory memory(2 * kBlockSize + kBlockSize / 2);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory));
+
+  // The last block isn't entirely readable, so it isn't cached, but the
+  // readable part of it can still be read.
+  uint8_t buffer[32];
+  const VMAddress address = kBase + 2 * kBlockSize + 16;
+  ASSERT_TRUE(cached.Read(address, sizeof(buffer), buffer));
+  EXPECT_EQ(memcmp(buffer, memory.Data(address), sizeof(buffer)), 0);
+
+  std::vector<uint8_t> large(kBlockSize);
+  EXPECT_FALSE(cached.Read(kBase + 2 * kBlockSize, large.size(), large.data()));
+  EXPECT_FALSE(cached.Read(kBase - 1, 2, buffer));
+}
+
+TEST(ProcessMemoryCached, ReadCString) {
+  FakeProcessMemory memory(4 * kBlockSize);
+  const VMAddress address = kBase + kBlockSize - 3;
+  memory.Write(address, "spans blocks");
+
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory));
+
+  std::string string;
+  ASSERT_TRUE(cached.ReadCString(address, &string));
+  EXPECT_EQ(string, "spans blocks");
+  ASSERT_TRUE(cached.ReadCStringSizeLimited(address, 13, &string));
+  EXPECT_EQ(string, "spans blocks");
+  EXPECT_FALSE(cached.ReadCStringSizeLimited(address, 12, &string));
+}
+
+TEST(ProcessMemoryCached, ReadBatch) {
+  FakeProcessMemory memory(4 * kBlockSize);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory));
+
+  uint8_t first[16];
+  uint8_t second[16];
+  std::vector<ProcessMemory::ReadRange> ranges = {
+      {kBase + 8, sizeof(first), first},
+      {kBase + 3 * kBlockSize, sizeof(second), second},
+  };
+  std::vector<bool> results;
+  ASSERT_TRUE(cached.ReadBatch(ranges, &results));
+  EXPECT_EQ(results, std::vector<bool>({true, true}));
+  EXPECT_EQ(memcmp(first, memory.Data(kBase + 8), sizeof(first)), 0);
+  EXPECT_EQ(memcmp(second, memory.Data(kBase + 3 * kBlockSize), sizeof(second)),
+            0);
+  EXPECT_EQ(cached.BytesRead(), sizeof(first) + sizeof(second));
+}
+
+TEST(ProcessMemoryCached, Disabled) {
+  FakeProcessMemory memory(4 * kBlockSize);
+  ProcessMemoryCached cached;
+  ASSERT_TRUE(cached.Initialize(&memory, 0));
+
+  uint8_t byte;
+  ASSERT_TRUE(cached.Read(kBase, 1, &byte));
+  ASSERT_TRUE(cached.Read(kBase, 1, &byte));
+  EXPECT_EQ(memory.reads(), 2u);
+  EXPECT_EQ(cached.Misses(), 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
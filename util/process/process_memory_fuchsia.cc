@@ -14,7 +14,11 @@
 
 #include "util/process/process_memory_fuchsia.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/fuchsia/fuchsia_logging.h"
@@ -22,6 +26,16 @@
 
 namespace crashpad {
 
+namespace {
+
+// Ranges separated by no more than this many bytes are read with a single
+// zx_process_read_memory() call by ReadBatchInternal(), as long as the combined
+// read doesn't exceed kMaxCoalescedReadSize.
+constexpr VMSize kMaxCoalescedGap = 4096;
+constexpr VMSize kMaxCoalescedReadSize = 64 * 1024;
+
+}  // namespace
+
 ProcessMemoryFuchsia::ProcessMemoryFuchsia()
     : ProcessMemory(), process_(), initialized_() {}
 
@@ -55,4 +69,85 @@ ssize_t ProcessMemoryFuchsia::ReadUpTo(VMAddress address,
   return actual;
 }
 
+void ProcessMemoryFuchsia::ReadBatchInternal(
+    const std::vector<ReadRange>& ranges,
+    std::vector<bool>* results) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_EQ(results->size(), ranges.size());
+
+  std::vector<size_t> order;
+  order.reserve(ranges.size());
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    if (ranges[index].size == 0) {
+      (*results)[index] = true;
+    } else {
+      order.push_back(index);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&ranges](size_t a, size_t b) {
+    return ranges[a].address < ranges[b].address;
+  });
+
+  std::vector<uint8_t> scratch;
+  size_t next = 0;
+  while (next < order.size()) {
+    const ReadRange& first = ranges[order[next]];
+    const VMAddress group_begin = first.address;
+    if (first.size > kMaxCoalescedReadSize ||
+        first.size > std::numeric_limits<VMAddress>::max() - group_begin) {
+      (*results)[order[next]] =
+          ReadUncounted(first.address, first.size, first.buffer);
+      ++next;
+      continue;
+    }
+
+    VMAddress group_end = group_begin + first.size;
+    size_t group_last = next + 1;
+    for (; group_last < order.size(); ++group_last) {
+      const ReadRange& range = ranges[order[group_last]];
+      if (range.address > group_end &&
+          range.address - group_end > kMaxCoalescedGap) {
+        break;
+      }
+      const VMSize offset = range.address - group_begin;
+      if (offset >= kMaxCoalescedReadSize ||
+          range.size > kMaxCoalescedReadSize - offset) {
+        break;
+      }
+      group_end = std::max(group_end, range.address + range.size);
+    }
+
+    if (group_last - next == 1) {
+      (*results)[order[next]] =
+          ReadUncounted(first.address, first.size, first.buffer);
+      ++next;
+      continue;
+    }
+
+    // A read that reaches unmapped memory stops short. Ranges wholly within
+    // the portion that was read are copied from it, and the rest are read on
+    // their own, so that only those that really can't be read fail.
+    const size_t group_size = static_cast<size_t>(group_end - group_begin);
+    scratch.resize(group_size);
+    size_t actual;
+    if (process_->read_memory(
+            group_begin, scratch.data(), group_size, &actual) != ZX_OK) {
+      actual = 0;
+    }
+    for (size_t order_index = next; order_index < group_last; ++order_index) {
+      const ReadRange& range = ranges[order[order_index]];
+      const size_t offset = static_cast<size_t>(range.address - group_begin);
+      const size_t size = static_cast<size_t>(range.size);
+      if (offset + size <= actual) {
+        memcpy(range.buffer, &scratch[offset], size);
+        (*results)[order[order_index]] = true;
+      } else {
+        (*results)[order[order_index]] =
+            ReadUncounted(range.address, range.size, range.buffer);
+      }
+    }
+    next = group_last;
+  }
+}
+
 }  // namespace crashpad
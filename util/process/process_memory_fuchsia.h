@@ -18,6 +18,7 @@
 #include <lib/zx/process.h>
 
 #include <string>
+#include <vector>
 
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -51,6 +52,12 @@ class ProcessMemoryFuchsia final : public ProcessMemory {
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  // Sorts ranges by address and coalesces neighbors into a single
+  // zx_process_read_memory() call, reading any range not covered by a short
+  // coalesced read individually.
+  void ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                         std::vector<bool>* results) const override;
+
   zx::unowned_process process_;
   InitializationStateDcheck initialized_;
 };
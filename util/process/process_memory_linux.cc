@@ -14,9 +14,13 @@
 
 #include "util/process/process_memory_linux.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -27,22 +31,64 @@
 #include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
 #include "util/file/filesystem.h"
+#include "util/linux/io_uring.h"
+#include "util/linux/pagemap_reader.h"
 #include "util/linux/ptrace_connection.h"
+#include "util/numeric/safe_assignment.h"
 
 namespace crashpad {
 
+namespace {
+
+// The kernel rejects process_vm_readv() calls with more than this many iovecs
+// on either side.
+constexpr size_t kMaxIovecs = IOV_MAX;
+
+// The number of reads that may be outstanding at once through io_uring.
+constexpr uint32_t kIoUringEntries = 64;
+
+ssize_t ProcessVMReadv(pid_t pid,
+                       const iovec* local_iov,
+                       const iovec* remote_iov,
+                       size_t iovcnt) {
+  // Use the system call directly, as older C libraries, including Bionic
+  // before API level 23, don’t provide a wrapper.
+  return syscall(
+      SYS_process_vm_readv, pid, local_iov, iovcnt, remote_iov, iovcnt, 0);
+}
+
+}  // namespace
+
 ProcessMemoryLinux::ProcessMemoryLinux(PtraceConnection* connection)
-    : ProcessMemory(), mem_fd_(), ignore_top_byte_(false) {
+    : ProcessMemoryLinux(connection, Access::kDirectIfPossible) {}
+
+ProcessMemoryLinux::ProcessMemoryLinux(PtraceConnection* connection,
+                                       Access access)
+    : ProcessMemory(),
+      connection_(connection),
+      pagemap_reader_(nullptr),
+      mem_fd_(),
+      pid_(connection->GetProcessID()),
+      ignore_top_byte_(false),
+      use_process_vm_readv_(false),
+      io_uring_lock_(),
+      io_uring_(),
+      io_uring_unavailable_(false) {
 #if defined(ARCH_CPU_ARM_FAMILY)
   if (connection->Is64Bit()) {
     ignore_top_byte_ = true;
   }
 #endif  // ARCH_CPU_ARM_FAMILY
 
-  char path[32];
-  snprintf(path, sizeof(path), "/proc/%d/mem", connection->GetProcessID());
-  mem_fd_.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  if (access == Access::kDirectIfPossible) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/mem", connection->GetProcessID());
+    mem_fd_.reset(HANDLE_EINTR(open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC)));
+  }
   if (mem_fd_.is_valid()) {
+    // process_vm_readv() is subject to the same access check as opening
+    // /proc/pid/mem, so only attempt it when that succeeded.
+    use_process_vm_readv_ = true;
     read_up_to_ = [this](VMAddress address, size_t size, void* buffer) {
       ssize_t bytes_read =
           HANDLE_EINTR(pread64(mem_fd_.get(), buffer, size, address));
@@ -74,4 +120,205 @@ ssize_t ProcessMemoryLinux::ReadUpTo(VMAddress address,
   return read_up_to_(PointerToAddress(address), size, buffer);
 }
 
+void ProcessMemoryLinux::ReadBatchInternal(
+    const std::vector<ReadRange>& ranges,
+    std::vector<bool>* results) const {
+  DCHECK_EQ(results->size(), ranges.size());
+
+  if (!mem_fd_.is_valid()) {
+    std::vector<ReadRange> connection_ranges(ranges);
+    for (ReadRange& range : connection_ranges) {
+      range.address = PointerToAddress(range.address);
+    }
+    connection_->ReadMemoryBatch(connection_ranges, results);
+    return;
+  }
+
+  std::vector<iovec> local_iov;
+  std::vector<iovec> remote_iov;
+  std::vector<size_t> iov_indices;
+  local_iov.reserve(std::min(ranges.size(), kMaxIovecs));
+  remote_iov.reserve(std::min(ranges.size(), kMaxIovecs));
+  iov_indices.reserve(std::min(ranges.size(), kMaxIovecs));
+
+  size_t next_index = 0;
+  while (next_index < ranges.size()) {
+    if (!use_process_vm_readv_) {
+      if (ReadBatchWithIoUring(ranges, next_index, results)) {
+        return;
+      }
+      for (; next_index < ranges.size(); ++next_index) {
+        const ReadRange& range = ranges[next_index];
+        (*results)[next_index] =
+            ReadUncounted(range.address, range.size, range.buffer);
+      }
+      return;
+    }
+
+    // Gather as many ranges as a single process_vm_readv() call will accept.
+    // The total transfer size must be representable as a ssize_t.
+    local_iov.clear();
+    remote_iov.clear();
+    iov_indices.clear();
+    size_t total_size = 0;
+    for (; next_index < ranges.size() && iov_indices.size() < kMaxIovecs;
+         ++next_index) {
+      const ReadRange& range = ranges[next_index];
+      if (range.size == 0) {
+        (*results)[next_index] = true;
+        continue;
+      }
+
+      size_t size;
+      if (!AssignIfInRange(&size, range.size) ||
+          size > size_t{std::numeric_limits<ssize_t>::max()} - total_size) {
+        if (iov_indices.empty()) {
+          // Let ReadUncounted() handle and report the oversized range.
+          (*results)[next_index] =
+              ReadUncounted(range.address, range.size, range.buffer);
+          continue;
+        }
+        break;
+      }
+
+      local_iov.push_back({range.buffer, size});
+      remote_iov.push_back(
+          {reinterpret_cast<void*>(PointerToAddress(range.address)), size});
+      iov_indices.push_back(next_index);
+      total_size += size;
+    }
+
+    if (iov_indices.empty()) {
+      continue;
+    }
+
+    ssize_t bytes_read = ProcessVMReadv(
+        pid_, local_iov.data(), remote_iov.data(), iov_indices.size());
+    if (bytes_read < 0) {
+      if (errno != EFAULT) {
+        // The system call isn’t available or isn’t permitted. Re-read the
+        // current set of ranges, and all that follow, individually.
+        PLOG_IF(WARNING, errno != ENOSYS) << "process_vm_readv";
+        use_process_vm_readv_ = false;
+        next_index = iov_indices.front();
+        continue;
+      }
+      bytes_read = 0;
+    }
+
+    // Transfers are made page by page, and stop at the first page that can’t
+    // be read, which may be partway through a remote iovec. The byte count
+    // then includes the part of that iovec that was read. Every range covered
+    // fully by the byte count was read completely. The first range that
+    // wasn’t is read on its own, so that only it is reported as failing, and
+    // the remaining ranges are retried in the next batch.
+    size_t remaining = bytes_read;
+    size_t iov_index = 0;
+    for (; iov_index < iov_indices.size(); ++iov_index) {
+      if (remaining < remote_iov[iov_index].iov_len) {
+        break;
+      }
+      remaining -= remote_iov[iov_index].iov_len;
+      (*results)[iov_indices[iov_index]] = true;
+    }
+
+    if (iov_index < iov_indices.size()) {
+      const size_t failed_index = iov_indices[iov_index];
+      const ReadRange& range = ranges[failed_index];
+      (*results)[failed_index] =
+          ReadUncounted(range.address, range.size, range.buffer);
+      next_index = failed_index + 1;
+    }
+  }
+}
+
+bool ProcessMemoryLinux::ReadBatchWithIoUring(
+    const std::vector<ReadRange>& ranges,
+    size_t first_index,
+    std::vector<bool>* results) const {
+  if (!io_uring_lock_.Try()) {
+    return false;
+  }
+  const bool rv = ReadBatchWithIoUringLocked(ranges, first_index, results);
+  io_uring_lock_.Release();
+  return rv;
+}
+
+bool ProcessMemoryLinux::ReadBatchWithIoUringLocked(
+    const std::vector<ReadRange>& ranges,
+    size_t first_index,
+    std::vector<bool>* results) const {
+  io_uring_lock_.AssertAcquired();
+  if (io_uring_unavailable_) {
+    return false;
+  }
+  if (!io_uring_) {
+    auto io_uring = std::make_unique<IoUring>();
+    if (!io_uring->Initialize(kIoUringEntries)) {
+      io_uring_unavailable_ = true;
+      return false;
+    }
+    io_uring_ = std::move(io_uring);
+  }
+
+  // A range that can’t be read fully in one operation, because it’s too large
+  // or because the read came up short, is handed to ReadUncounted(), which
+  // reads the rest or reports the failure.
+  auto complete_read = [this, &ranges, results](
+                           const IoUring::Completion& completion) {
+    const ReadRange& range = ranges[completion.user_data];
+    (*results)[completion.user_data] =
+        (completion.result >= 0 &&
+         static_cast<VMSize>(completion.result) == range.size) ||
+        ReadUncounted(range.address, range.size, range.buffer);
+  };
+
+  for (size_t index = first_index; index < ranges.size(); ++index) {
+    const ReadRange& range = ranges[index];
+    if (range.size == 0) {
+      (*results)[index] = true;
+      continue;
+    }
+    if (range.size > std::numeric_limits<uint32_t>::max()) {
+      (*results)[index] =
+          ReadUncounted(range.address, range.size, range.buffer);
+      continue;
+    }
+
+    IoUring::Completion completion;
+    while (!io_uring_->QueueRead(mem_fd_.get(),
+                                 range.buffer,
+                                 static_cast<uint32_t>(range.size),
+                                 PointerToAddress(range.address),
+                                 index)) {
+      if (!io_uring_->WaitForCompletion(&completion)) {
+        // The kernel may still write to the buffers of outstanding reads, so
+        // it isn’t safe to return.
+        LOG(FATAL) << "io_uring reads can't be completed";
+      }
+      complete_read(completion);
+    }
+  }
+
+  IoUring::Completion completion;
+  while (io_uring_->Outstanding() > 0) {
+    if (!io_uring_->WaitForCompletion(&completion)) {
+      LOG(FATAL) << "io_uring reads can't be completed";
+    }
+    complete_read(completion);
+  }
+  return true;
+}
+
+void ProcessMemoryLinux::UnpopulatedRangesInternal(
+    VMAddress address,
+    VMSize size,
+    std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const {
+  // Tagged addresses are left alone, as the ranges reported must lie within
+  // the region as it was addressed.
+  if (pagemap_reader_ && PointerToAddress(address) == address) {
+    pagemap_reader_->UnpopulatedRanges(address, size, ranges);
+  }
+}
+
 }  // namespace crashpad
@@ -17,21 +17,41 @@
 
 #include <sys/types.h>
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/files/scoped_file.h"
+#include "base/synchronization/lock.h"
 #include "util/misc/address_types.h"
 #include "util/process/process_memory.h"
 
 namespace crashpad {
 
+class IoUring;
+class PagemapReader;
 class PtraceConnection;
 
 //! \brief Accesses the memory of another Linux process.
 class ProcessMemoryLinux final : public ProcessMemory {
  public:
+  //! \brief How memory is read.
+  enum class Access {
+    //! \brief Memory is read directly from <code>/proc/<i>pid</i>/mem</code>
+    //!     if it can be opened, and through the PtraceConnection otherwise.
+    kDirectIfPossible,
+
+    //! \brief Memory is always read through the PtraceConnection.
+    //!
+    //! This is for connections that don't read from a live process with the
+    //! connection's process ID, or that must observe every read.
+    kConnectionOnly,
+  };
+
   explicit ProcessMemoryLinux(PtraceConnection* connection);
+  ProcessMemoryLinux(PtraceConnection* connection, Access access);
 
   ProcessMemoryLinux(const ProcessMemoryLinux&) = delete;
   ProcessMemoryLinux& operator=(const ProcessMemoryLinux&) = delete;
@@ -42,12 +62,61 @@ class ProcessMemoryLinux final : public ProcessMemory {
   //!     tags removed.
   VMAddress PointerToAddress(VMAddress address) const;
 
+  //! \brief Returns `true` if this object may be read from several threads at
+  //!     once.
+  //!
+  //! Reads are made directly from `/proc/pid/mem` when it could be opened.
+  //! Otherwise, they are forwarded to the PtraceConnection, which may only
+  //! service one request at a time.
+  bool SupportsConcurrentReads() const { return mem_fd_.is_valid(); }
+
+  //! \brief Sets the PagemapReader used to determine which pages have never
+  //!     been populated, for UnpopulatedRanges().
+  //!
+  //! \param[in] pagemap_reader A PagemapReader for the same process, which
+  //!     must remain valid until this is called again, or `nullptr` to report
+  //!     no unpopulated pages, as is the default.
+  void SetPagemapReader(const PagemapReader* pagemap_reader) {
+    pagemap_reader_ = pagemap_reader;
+  }
+
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
+  void ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                         std::vector<bool>* results) const override;
+  void UnpopulatedRangesInternal(
+      VMAddress address,
+      VMSize size,
+      std::vector<CheckedRange<VMAddress, VMSize>>* ranges) const override;
+
+  // Reads ranges[first_index] and all that follow from mem_fd_, queueing many
+  // reads at once through io_uring_. Returns false without reading anything if
+  // io_uring is unavailable, or is in use by another thread.
+  bool ReadBatchWithIoUring(const std::vector<ReadRange>& ranges,
+                            size_t first_index,
+                            std::vector<bool>* results) const;
+  bool ReadBatchWithIoUringLocked(const std::vector<ReadRange>& ranges,
+                                  size_t first_index,
+                                  std::vector<bool>* results) const;
 
   std::function<ssize_t(VMAddress, size_t, void*)> read_up_to_;
+  PtraceConnection* connection_;  // weak
+  const PagemapReader* pagemap_reader_;  // weak
   base::ScopedFD mem_fd_;
+  pid_t pid_;
   bool ignore_top_byte_;
+
+  // Cleared if process_vm_readv() is unavailable or not permitted, after which
+  // batched reads fall back to reading each range individually. This may be
+  // cleared by a read on any thread.
+  mutable std::atomic<bool> use_process_vm_readv_;
+
+  // Created by the first batched read that can’t use process_vm_readv(), and
+  // used by one thread at a time. io_uring_unavailable_ is set if io_uring_
+  // couldn’t be initialized.
+  mutable base::Lock io_uring_lock_;
+  mutable std::unique_ptr<IoUring> io_uring_;
+  mutable bool io_uring_unavailable_;
 };
 
 }  // namespace crashpad
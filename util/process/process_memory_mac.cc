@@ -18,6 +18,8 @@
 #include <string.h>
 
 #include <algorithm>
+#include <iterator>
+#include <utility>
 
 #include "base/apple/mach_logging.h"
 #include "base/check_op.h"
@@ -48,14 +50,16 @@ bool ProcessMemoryMac::MappedMemory::ReadCString(size_t offset,
   return true;
 }
 
-ProcessMemoryMac::MappedMemory::MappedMemory(vm_address_t vm_address,
-                                             size_t vm_size,
-                                             size_t user_offset,
-                                             size_t user_size)
-    : vm_(vm_address, vm_size),
-      data_(reinterpret_cast<const void*>(vm_address + user_offset)),
+ProcessMemoryMac::MappedMemory::MappedMemory(
+    std::shared_ptr<const Mapping> mapping,
+    size_t user_offset,
+    size_t user_size)
+    : mapping_(std::move(mapping)),
+      data_(reinterpret_cast<const void*>(
+          (mapping_ ? mapping_->vm.address() : 0) + user_offset)),
       user_size_(user_size) {
-  vm_address_t vm_end = vm_address + vm_size;
+  vm_address_t vm_address = mapping_ ? mapping_->vm.address() : 0;
+  vm_address_t vm_end = vm_address + (mapping_ ? mapping_->size : 0);
   vm_address_t user_address = reinterpret_cast<vm_address_t>(data_);
   vm_address_t user_end = user_address + user_size;
   DCHECK_GE(user_address, vm_address);
@@ -64,7 +68,22 @@ ProcessMemoryMac::MappedMemory::MappedMemory(vm_address_t vm_address,
   DCHECK_LE(user_end, vm_end);
 }
 
-ProcessMemoryMac::ProcessMemoryMac() : task_(TASK_NULL), initialized_() {}
+ProcessMemoryMac::MappedMemory::MappedMemory(const void* data,
+                                             size_t user_size)
+    : mapping_(), data_(data), user_size_(user_size) {}
+
+ProcessMemoryMac::Mapping::Mapping(vm_address_t vm_address,
+                                   mach_vm_size_t vm_size,
+                                   mach_vm_address_t source_address)
+    : vm(vm_address, vm_size), source_address(source_address), size(vm_size) {}
+
+ProcessMemoryMac::ProcessMemoryMac()
+    : local_ranges_(),
+      mapping_cache_(),
+      mapping_cache_lock_(),
+      mapping_cache_size_(0),
+      task_(TASK_NULL),
+      initialized_() {}
 
 bool ProcessMemoryMac::Initialize(task_t task) {
   INITIALIZATION_STATE_SET_INITIALIZING(initialized_);
@@ -73,27 +92,154 @@ bool ProcessMemoryMac::Initialize(task_t task) {
   return true;
 }
 
+void ProcessMemoryMac::SetMappingCacheSize(size_t max_mappings) {
+  base::AutoLock lock(mapping_cache_lock_);
+  mapping_cache_size_ = max_mappings;
+  if (mapping_cache_.size() > max_mappings) {
+    mapping_cache_.erase(
+        mapping_cache_.begin(),
+        mapping_cache_.begin() + (mapping_cache_.size() - max_mappings));
+  }
+}
+
+void ProcessMemoryMac::AddIdenticalLocalRange(mach_vm_address_t address,
+                                              mach_vm_size_t size) {
+  if (size == 0 || address + size < address) {
+    return;
+  }
+
+  // Merge the new range with any that it overlaps or abuts.
+  mach_vm_address_t end = address + size;
+  auto it = std::lower_bound(
+      local_ranges_.begin(),
+      local_ranges_.end(),
+      address,
+      [](const std::pair<mach_vm_address_t, mach_vm_size_t>& range,
+         mach_vm_address_t address) {
+        return range.first + range.second < address;
+      });
+  auto merge_end = it;
+  while (merge_end != local_ranges_.end() && merge_end->first <= end) {
+    address = std::min(address, merge_end->first);
+    end = std::max(end, merge_end->first + merge_end->second);
+    ++merge_end;
+  }
+  it = local_ranges_.erase(it, merge_end);
+  local_ranges_.insert(it, std::make_pair(address, end - address));
+}
+
 std::unique_ptr<ProcessMemoryMac::MappedMemory> ProcessMemoryMac::ReadMapped(
     mach_vm_address_t address,
     size_t size) const {
   INITIALIZATION_STATE_DCHECK_VALID(initialized_);
 
   if (size == 0) {
-    return std::unique_ptr<MappedMemory>(new MappedMemory(0, 0, 0, 0));
+    return std::unique_ptr<MappedMemory>(new MappedMemory(nullptr, 0, 0));
+  }
+
+  const void* local = FindIdenticalLocal(address, size);
+  if (local) {
+    return std::unique_ptr<MappedMemory>(new MappedMemory(local, size));
+  }
+
+  std::shared_ptr<const Mapping> mapping = FindCachedMapping(address, size);
+  if (!mapping) {
+    mach_vm_address_t region_address = mach_vm_trunc_page(address);
+    mach_vm_size_t region_size =
+        mach_vm_round_page(address - region_address + size);
+    mapping = Map(region_address, region_size);
+    if (!mapping) {
+      return std::unique_ptr<MappedMemory>();
+    }
+  }
+
+  size_t user_offset = address - mapping->source_address;
+  return std::unique_ptr<MappedMemory>(
+      new MappedMemory(std::move(mapping), user_offset, size));
+}
+
+const void* ProcessMemoryMac::FindIdenticalLocal(mach_vm_address_t address,
+                                                 size_t size) const {
+  if (local_ranges_.empty()) {
+    return nullptr;
+  }
+
+  // Find the last range beginning at or before |address|.
+  auto it = std::upper_bound(
+      local_ranges_.begin(),
+      local_ranges_.end(),
+      address,
+      [](mach_vm_address_t address,
+         const std::pair<mach_vm_address_t, mach_vm_size_t>& range) {
+        return address < range.first;
+      });
+  if (it == local_ranges_.begin()) {
+    return nullptr;
+  }
+  --it;
+
+  mach_vm_size_t offset = address - it->first;
+  if (offset > it->second || size > it->second - offset) {
+    return nullptr;
   }
+  return reinterpret_cast<const void*>(static_cast<uintptr_t>(address));
+}
 
-  mach_vm_address_t region_address = mach_vm_trunc_page(address);
-  mach_vm_size_t region_size =
-      mach_vm_round_page(address - region_address + size);
+std::shared_ptr<const ProcessMemoryMac::Mapping>
+ProcessMemoryMac::FindCachedMapping(mach_vm_address_t address,
+                                    size_t size) const {
+  base::AutoLock lock(mapping_cache_lock_);
+  for (auto it = mapping_cache_.rbegin(); it != mapping_cache_.rend(); ++it) {
+    const Mapping& mapping = **it;
+    if (address >= mapping.source_address &&
+        address - mapping.source_address <= mapping.size &&
+        size <= mapping.size - (address - mapping.source_address)) {
+      std::shared_ptr<const Mapping> found = *it;
+      mapping_cache_.erase(std::next(it).base());
+      mapping_cache_.push_back(found);
+      return found;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const ProcessMemoryMac::Mapping> ProcessMemoryMac::Map(
+    mach_vm_address_t region_address,
+    mach_vm_size_t region_size) const {
+  size_t max_mappings;
+  {
+    base::AutoLock lock(mapping_cache_lock_);
+    max_mappings = mapping_cache_size_;
+  }
 
   vm_offset_t region;
   mach_msg_type_number_t region_count;
-  kern_return_t kr =
-      mach_vm_read(task_, region_address, region_size, &region, &region_count);
+  kern_return_t kr;
+
+  // When caching, map ahead of the request so that neighboring requests, such
+  // as successive load commands or structures, share the mapping. This is
+  // allowed to fail quietly when the following memory isn’t readable.
+  constexpr mach_vm_size_t kReadAheadSize = 64 * 1024;
+  if (max_mappings && region_size < kReadAheadSize &&
+      region_address + kReadAheadSize > region_address) {
+    kr = mach_vm_read(
+        task_, region_address, kReadAheadSize, &region, &region_count);
+    if (kr == KERN_SUCCESS) {
+      if (region_count == kReadAheadSize) {
+        return AddToCache(std::make_shared<const Mapping>(
+                              region, kReadAheadSize, region_address),
+                          max_mappings);
+      }
+      if (region_count)
+        vm_deallocate(mach_task_self(), region, region_count);
+    }
+  }
+
+  kr = mach_vm_read(task_, region_address, region_size, &region, &region_count);
   if (kr != KERN_SUCCESS) {
     MACH_LOG(WARNING, kr) << base::StringPrintf(
         "mach_vm_read(0x%llx, 0x%llx)", region_address, region_size);
-    return std::unique_ptr<MappedMemory>();
+    return nullptr;
   }
   if (region_count != region_size) {
     LOG(ERROR) << base::StringPrintf(
@@ -102,11 +248,26 @@ std::unique_ptr<ProcessMemoryMac::MappedMemory> ProcessMemoryMac::ReadMapped(
         region_size);
     if (region_count)
       vm_deallocate(mach_task_self(), region, region_count);
-    return std::unique_ptr<MappedMemory>();
+    return nullptr;
   }
 
-  return std::unique_ptr<MappedMemory>(
-      new MappedMemory(region, region_size, address - region_address, size));
+  return AddToCache(
+      std::make_shared<const Mapping>(region, region_size, region_address),
+      max_mappings);
+}
+
+std::shared_ptr<const ProcessMemoryMac::Mapping> ProcessMemoryMac::AddToCache(
+    std::shared_ptr<const Mapping> mapping,
+    size_t max_mappings) const {
+  if (!max_mappings) {
+    return mapping;
+  }
+  base::AutoLock lock(mapping_cache_lock_);
+  if (mapping_cache_.size() >= max_mappings) {
+    mapping_cache_.erase(mapping_cache_.begin());
+  }
+  mapping_cache_.push_back(mapping);
+  return mapping;
 }
 
 ssize_t ProcessMemoryMac::ReadUpTo(VMAddress address,
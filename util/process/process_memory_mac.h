@@ -20,8 +20,11 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/apple/scoped_mach_vm.h"
+#include "base/synchronization/lock.h"
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
@@ -30,10 +33,15 @@ namespace crashpad {
 
 //! \brief Accesses the memory of another Mach task.
 class ProcessMemoryMac : public ProcessMemory {
+ private:
+  struct Mapping;
+
  public:
   //! \brief A memory region mapped from another Mach task.
   //!
-  //! The mapping is maintained until this object is destroyed.
+  //! The mapping is maintained until this object is destroyed. When the
+  //! ProcessMemoryMac that created it has a mapping cache, the mapping may be
+  //! shared with other MappedMemory objects and with the cache.
   class MappedMemory {
    public:
     MappedMemory(const MappedMemory&) = delete;
@@ -63,26 +71,29 @@ class ProcessMemoryMac : public ProcessMemory {
     bool ReadCString(size_t offset, std::string* string) const;
 
    private:
-    //! \brief Creates an object that owns a memory region mapped from another
-    //!     Mach task.
+    //! \brief Creates an object that shares a memory region mapped from
+    //!     another Mach task.
     //!
-    //! \param[in] vm_address The address in this process’ address space where
-    //!     the mapping begins. This must be page-aligned.
-    //! \param[in] vm_size The total size of the mapping that begins at \a
-    //!     vm_address. This must be page-aligned.
+    //! \param[in] mapping The mapping, or `nullptr` if \a user_size is `0`.
     //! \param[in] user_offset The offset into the mapped region where the data
     //!     requested by the user begins. This accounts for the fact that a
     //!     mapping must be page-aligned but the user data may not be. This
-    //!     parameter must be equal to or less than \a vm_size.
+    //!     parameter must be equal to or less than the size of \a mapping.
     //! \param[in] user_size The size of the data requested by the user. This
     //!     parameter can be used to compute the end address of user data, which
     //!     must be within the mapped region.
-    MappedMemory(vm_address_t vm_address,
-                 size_t vm_size,
+    MappedMemory(std::shared_ptr<const Mapping> mapping,
                  size_t user_offset,
                  size_t user_size);
 
-    base::apple::ScopedMachVM vm_;
+    //! \brief Creates an object that refers to memory in the current task
+    //!     that is identical to the target task’s memory.
+    //!
+    //! \param[in] data The data requested by the user.
+    //! \param[in] user_size The size of the data requested by the user.
+    MappedMemory(const void* data, size_t user_size);
+
+    std::shared_ptr<const Mapping> mapping_;
     const void* data_;
     size_t user_size_;
 
@@ -109,6 +120,34 @@ class ProcessMemoryMac : public ProcessMemory {
   //! \return `true` on success, `false` on failure with a message logged.
   bool Initialize(task_t task);
 
+  //! \brief Keeps up to \a max_mappings recently mapped regions alive, and
+  //!     answers Read() and ReadMapped() requests that fall within them
+  //!     without mapping memory again.
+  //!
+  //! Requests served from the cache see the target task’s memory as it was
+  //! when the region was mapped, so this is only appropriate when the target
+  //! task is suspended, such as while capturing a snapshot of it. Misses also
+  //! map a little beyond the requested range when that memory is readable, so
+  //! that nearby requests can be served from the same mapping.
+  //!
+  //! \param[in] max_mappings The maximum number of mappings to keep. `0`, the
+  //!     default, disables the cache and releases any cached mappings.
+  void SetMappingCacheSize(size_t max_mappings);
+
+  //! \brief Declares that the target task’s memory at [\a address, \a address
+  //!     + \a size) is mapped at the same addresses in the current task, with
+  //!     identical contents that can’t change.
+  //!
+  //! This is the case for the read-only portions of a dyld shared cache that
+  //! both tasks use. Read() and ReadMapped() requests that fall entirely
+  //! within such a range are answered from the current task’s memory, without
+  //! mapping anything from the target task. The caller is responsible for
+  //! establishing that the contents are identical.
+  //!
+  //! \param[in] address The base address of the range.
+  //! \param[in] size The size of the range.
+  void AddIdenticalLocalRange(mach_vm_address_t address, mach_vm_size_t size);
+
   //! \brief Maps memory from the target task into the current task.
   //!
   //! This interface is an alternative to Read() that does not require the
@@ -126,8 +165,48 @@ class ProcessMemoryMac : public ProcessMemory {
                                            size_t size) const;
 
  private:
+  //! \brief A region of the target task’s memory, mapped into this task.
+  struct Mapping {
+    Mapping(vm_address_t vm_address,
+            mach_vm_size_t vm_size,
+            mach_vm_address_t source_address);
+
+    base::apple::ScopedMachVM vm;
+    mach_vm_address_t source_address;
+    mach_vm_size_t size;
+  };
+
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  //! \brief Returns a cached mapping containing \a size bytes at \a address,
+  //!     or `nullptr`.
+  std::shared_ptr<const Mapping> FindCachedMapping(mach_vm_address_t address,
+                                                   size_t size) const;
+
+  //! \brief Maps the page-aligned region at \a region_address, reading ahead
+  //!     when caching, and adds it to the cache.
+  std::shared_ptr<const Mapping> Map(mach_vm_address_t region_address,
+                                     mach_vm_size_t region_size) const;
+
+  //! \brief Adds \a mapping to the cache, evicting the least recently used
+  //!     mapping if the cache holds \a max_mappings already. Returns \a
+  //!     mapping.
+  std::shared_ptr<const Mapping> AddToCache(
+      std::shared_ptr<const Mapping> mapping,
+      size_t max_mappings) const;
+
+  //! \brief Returns a pointer to \a size bytes at \a address in the current
+  //!     task if they fall within a range from AddIdenticalLocalRange(), or
+  //!     `nullptr`.
+  const void* FindIdenticalLocal(mach_vm_address_t address, size_t size) const;
+
+  // Sorted by base address, and not overlapping.
+  std::vector<std::pair<mach_vm_address_t, mach_vm_size_t>> local_ranges_;
+
+  // Most recently used last.
+  mutable std::vector<std::shared_ptr<const Mapping>> mapping_cache_;
+  mutable base::Lock mapping_cache_lock_;
+  size_t mapping_cache_size_;
   task_t task_;  // weak
   InitializationStateDcheck initialized_;
 };
@@ -276,6 +276,93 @@ TEST(ProcessMemoryMac, MappedMemoryDeallocates) {
   EXPECT_FALSE(IsAddressMapped(mapped_last_address));
 }
 
+TEST(ProcessMemoryMac, MappedMemoryCached) {
+  vm_address_t address = 0;
+  const vm_size_t kSize = 4 * PAGE_SIZE;
+  kern_return_t kr =
+      vm_allocate(mach_task_self(), &address, kSize, VM_FLAGS_ANYWHERE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_allocate");
+  base::apple::ScopedMachVM vm_owner(address, mach_vm_round_page(kSize));
+
+  char* region = reinterpret_cast<char*>(address);
+  for (size_t index = 0; index < kSize; ++index) {
+    region[index] = (index % 256) ^ ((index >> 8) % 256);
+  }
+
+  ProcessMemoryMac memory;
+  ASSERT_TRUE(memory.Initialize(mach_task_self()));
+  memory.SetMappingCacheSize(4);
+
+  // A read contained in an earlier mapping is served from that mapping.
+  std::unique_ptr<ProcessMemoryMac::MappedMemory> mapped;
+  ASSERT_TRUE((mapped = memory.ReadMapped(address, kSize)));
+  EXPECT_EQ(memcmp(region, mapped->data(), kSize), 0);
+  const char* mapped_data = reinterpret_cast<const char*>(mapped->data());
+
+  std::unique_ptr<ProcessMemoryMac::MappedMemory> mapped_again;
+  ASSERT_TRUE(
+      (mapped_again = memory.ReadMapped(address + PAGE_SIZE + 1, PAGE_SIZE)));
+  EXPECT_EQ(memcmp(region + PAGE_SIZE + 1, mapped_again->data(), PAGE_SIZE),
+            0);
+  EXPECT_EQ(mapped_again->data(), mapped_data + PAGE_SIZE + 1);
+
+  // The cache keeps the mapping alive after the MappedMemory objects are gone.
+  vm_address_t mapped_address = reinterpret_cast<vm_address_t>(mapped_data);
+  mapped.reset();
+  mapped_again.reset();
+  EXPECT_TRUE(IsAddressMapped(mapped_address));
+
+  std::string result(kSize, '\0');
+  ASSERT_TRUE(memory.Read(address + 2, kSize - 2, &result[0]));
+  EXPECT_EQ(memcmp(region + 2, &result[0], kSize - 2), 0);
+
+  // Disabling the cache releases its mappings.
+  memory.SetMappingCacheSize(0);
+  EXPECT_FALSE(IsAddressMapped(mapped_address));
+
+  // Reads into memory that isn’t readable still fail with the cache enabled.
+  memory.SetMappingCacheSize(4);
+  kr = vm_protect(
+      mach_task_self(), address + PAGE_SIZE, PAGE_SIZE, FALSE, VM_PROT_NONE);
+  ASSERT_EQ(kr, KERN_SUCCESS) << MachErrorMessage(kr, "vm_protect");
+  EXPECT_FALSE((mapped = memory.ReadMapped(address, 2 * PAGE_SIZE)));
+  EXPECT_FALSE((mapped = memory.ReadMapped(address + PAGE_SIZE, 1)));
+  ASSERT_TRUE((mapped = memory.ReadMapped(address, PAGE_SIZE)));
+  EXPECT_EQ(memcmp(region, mapped->data(), PAGE_SIZE), 0);
+  ASSERT_TRUE((mapped = memory.ReadMapped(address + 1, PAGE_SIZE - 1)));
+  EXPECT_EQ(memcmp(region + 1, mapped->data(), PAGE_SIZE - 1), 0);
+}
+
+TEST(ProcessMemoryMac, IdenticalLocalRange) {
+  ProcessMemoryMac memory;
+  ASSERT_TRUE(memory.Initialize(mach_task_self()));
+
+  static constexpr char kTestBuffer[] = "identical local memory";
+  const mach_vm_address_t kTestAddress =
+      FromPointerCast<mach_vm_address_t>(&kTestBuffer);
+
+  // Register the buffer in two abutting pieces, which are merged.
+  memory.AddIdenticalLocalRange(kTestAddress, 4);
+  memory.AddIdenticalLocalRange(kTestAddress + 4, sizeof(kTestBuffer) - 4);
+
+  // Reads within the range refer directly to the current task’s memory.
+  std::unique_ptr<ProcessMemoryMac::MappedMemory> mapped;
+  ASSERT_TRUE((mapped = memory.ReadMapped(kTestAddress, sizeof(kTestBuffer))));
+  EXPECT_EQ(mapped->data(), kTestBuffer);
+  ASSERT_TRUE((mapped = memory.ReadMapped(kTestAddress + 2, 6)));
+  EXPECT_EQ(mapped->data(), &kTestBuffer[2]);
+
+  std::string string;
+  ASSERT_TRUE(memory.ReadCString(kTestAddress, &string));
+  EXPECT_EQ(string, kTestBuffer);
+
+  // Reads extending past the range are mapped as usual.
+  ASSERT_TRUE(
+      (mapped = memory.ReadMapped(kTestAddress, sizeof(kTestBuffer) + 1)));
+  EXPECT_NE(mapped->data(), kTestBuffer);
+  EXPECT_EQ(memcmp(mapped->data(), kTestBuffer, sizeof(kTestBuffer)), 0);
+}
+
 TEST(ProcessMemoryMac, MappedMemoryReadCString) {
   // This tests the behavior of ProcessMemoryMac::MappedMemory::ReadCString().
   ProcessMemoryMac memory;
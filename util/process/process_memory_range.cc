@@ -78,6 +78,41 @@ bool ProcessMemoryRange::Read(VMAddress address,
   return memory_->Read(address, size, buffer);
 }
 
+bool ProcessMemoryRange::ReadBatch(
+    const std::vector<ProcessMemory::ReadRange>& ranges,
+    std::vector<bool>* results) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  std::vector<bool> local_results;
+  if (!results) {
+    results = &local_results;
+  }
+  results->assign(ranges.size(), false);
+
+  std::vector<ProcessMemory::ReadRange> contained_ranges;
+  std::vector<size_t> contained_indices;
+  contained_ranges.reserve(ranges.size());
+  contained_indices.reserve(ranges.size());
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    const ProcessMemory::ReadRange& range = ranges[index];
+    CheckedVMAddressRange read_range(
+        range_.Is64Bit(), range.address, range.size);
+    if (!read_range.IsValid() || !range_.ContainsRange(read_range)) {
+      LOG(ERROR) << "read out of range";
+      continue;
+    }
+    contained_ranges.push_back(range);
+    contained_indices.push_back(index);
+  }
+
+  std::vector<bool> contained_results;
+  memory_->ReadBatch(contained_ranges, &contained_results);
+  for (size_t index = 0; index < contained_indices.size(); ++index) {
+    (*results)[contained_indices[index]] = contained_results[index];
+  }
+
+  return std::find(results->begin(), results->end(), false) == results->end();
+}
+
 bool ProcessMemoryRange::ReadCStringSizeLimited(VMAddress address,
                                                 VMSize size,
                                                 std::string* string) const {
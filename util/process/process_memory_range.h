@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <string>
+#include <vector>
 
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
@@ -102,6 +103,22 @@ class ProcessMemoryRange {
   //!     failure, with a message logged.
   bool Read(VMAddress address, VMSize size, void* buffer) const;
 
+  //! \brief Copies several memory regions from the target process into
+  //!     caller-provided buffers in the current process.
+  //!
+  //! Regions that are not entirely within the range are not copied. The rest
+  //! are copied with a single call to ProcessMemory::ReadBatch().
+  //!
+  //! \param[in] ranges The memory regions to copy.
+  //! \param[out] results Resized to the size of \a ranges. Each element is set
+  //!     to `true` if the corresponding region was copied in full, and `false`
+  //!     otherwise. May be `nullptr` if only the aggregate result is needed.
+  //!
+  //! \return `true` if every region was copied successfully. `false` if any
+  //!     region could not be copied, with a message logged.
+  bool ReadBatch(const std::vector<ProcessMemory::ReadRange>& ranges,
+                 std::vector<bool>* results) const;
+
   //! \brief Reads a `NUL`-terminated C string from the target process into a
   //!     string in the current process.
   //!
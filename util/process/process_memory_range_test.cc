@@ -16,6 +16,7 @@
 
 #include <iterator>
 #include <limits>
+#include <vector>
 
 #include "build/build_config.h"
 #include "gtest/gtest.h"
@@ -96,6 +97,48 @@ TEST(ProcessMemoryRange, Basic) {
   EXPECT_FALSE(range2.RestrictRange(string1_addr - 1, 1));
 }
 
+TEST(ProcessMemoryRange, ReadBatch) {
+#if defined(ARCH_CPU_64_BITS)
+  constexpr bool is_64_bit = true;
+#else
+  constexpr bool is_64_bit = false;
+#endif  // ARCH_CPU_64_BITS
+
+#if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  FakePtraceConnection connection;
+  ASSERT_TRUE(connection.Initialize(GetSelfProcess()));
+  ProcessMemoryLinux memory(&connection);
+#else
+  ProcessMemoryNative memory;
+  ASSERT_TRUE(memory.Initialize(GetSelfProcess()));
+#endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_LINUX) ||
+        // BUILDFLAG(IS_CHROMEOS)
+
+  auto string1_addr = FromPointerCast<VMAddress>(kTestObject.string1);
+  auto string2_addr = FromPointerCast<VMAddress>(kTestObject.string2);
+
+  ProcessMemoryRange range;
+  ASSERT_TRUE(range.Initialize(&memory, is_64_bit));
+  ASSERT_TRUE(
+      range.RestrictRange(string1_addr, std::size(kTestObject.string1)));
+
+  // Regions outside of the range aren't read, but don't prevent the rest from
+  // being read.
+  char string1[std::size(kTestObject.string1)] = {};
+  char string2[std::size(kTestObject.string2)] = {};
+  std::vector<ProcessMemory::ReadRange> ranges;
+  ranges.push_back({string2_addr, sizeof(string2), string2});
+  ranges.push_back({string1_addr, sizeof(string1), string1});
+  std::vector<bool> results;
+  EXPECT_FALSE(range.ReadBatch(ranges, &results));
+  EXPECT_EQ(results, std::vector<bool>({false, true}));
+  EXPECT_STREQ(string1, kTestObject.string1);
+  EXPECT_STREQ(string2, "");
+
+  ranges.erase(ranges.begin());
+  EXPECT_TRUE(range.ReadBatch(ranges, nullptr));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
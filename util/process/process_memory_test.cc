@@ -17,6 +17,7 @@
 #include <string.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/memory/page_size.h"
 #include "build/build_config.h"
@@ -168,6 +169,7 @@ class ReadTest : public MultiprocessAdaptor {
         // BUILDFLAG(IS_CHROMEOS)
 
     std::unique_ptr<char[]> result(new char[region_size]);
+    uint64_t bytes_read;
 
     // Ensure that the entire region can be read.
     ASSERT_TRUE(memory.Read(address, region_size, result.get()));
@@ -208,11 +210,54 @@ class ReadTest : public MultiprocessAdaptor {
       EXPECT_EQ(result[i], static_cast<char>((i + page_size) % 256));
     }
 
-    // Ensure that reading exactly a single byte works.
+    // Ensure that reading exactly a single byte works, and is counted.
     result[1] = 'J';
+    bytes_read = memory.BytesRead();
     ASSERT_TRUE(memory.Read(address + 2, 1, result.get()));
+    EXPECT_EQ(memory.BytesRead(), bytes_read + 1);
     EXPECT_EQ(result[0], 2);
     EXPECT_EQ(result[1], 'J');
+
+    // Ensure that a batch of reads, including an empty one, works.
+    memset(result.get(), '\0', region_size);
+    std::vector<ProcessMemory::ReadRange> ranges;
+    ranges.push_back({address + page_size, page_size, result.get()});
+    ranges.push_back({address + 1, 3, result.get() + page_size});
+    ranges.push_back({address, 0, nullptr});
+    ranges.push_back({address + 7, 1, result.get() + page_size + 3});
+    std::vector<bool> results;
+    bytes_read = memory.BytesRead();
+    ASSERT_TRUE(memory.ReadBatch(ranges, &results));
+    EXPECT_EQ(results, std::vector<bool>(ranges.size(), true));
+    EXPECT_EQ(memory.BytesRead(), bytes_read + page_size + 4);
+    for (size_t i = 0; i < page_size; ++i) {
+      EXPECT_EQ(result[i], static_cast<char>((i + page_size) % 256));
+    }
+    EXPECT_EQ(result[page_size], 1);
+    EXPECT_EQ(result[page_size + 1], 2);
+    EXPECT_EQ(result[page_size + 2], 3);
+    EXPECT_EQ(result[page_size + 3], 7);
+
+    // Ensure that a batch of many small, unordered and overlapping reads, as
+    // implementations may coalesce, works.
+    memset(result.get(), '\0', region_size);
+    ranges.clear();
+    for (size_t i = 0; i < 64; ++i) {
+      size_t offset = ((63 - i) * 37) % (region_size - 8);
+      ranges.push_back({address + offset, 8, result.get() + i * 8});
+    }
+    ASSERT_TRUE(memory.ReadBatch(ranges, &results));
+    EXPECT_EQ(results, std::vector<bool>(ranges.size(), true));
+    for (size_t i = 0; i < 64; ++i) {
+      size_t offset = ((63 - i) * 37) % (region_size - 8);
+      for (size_t j = 0; j < 8; ++j) {
+        EXPECT_EQ(result[i * 8 + j], static_cast<char>((offset + j) % 256));
+      }
+    }
+
+    ASSERT_TRUE(memory.ReadBatch(std::vector<ProcessMemory::ReadRange>(),
+                                 &results));
+    EXPECT_TRUE(results.empty());
   }
 };
 
@@ -445,6 +490,20 @@ class ReadUnmappedTest : public MultiprocessAdaptor {
         memory.Read(page_addr1, base::GetPageSize() * 2, result.get()));
     EXPECT_FALSE(memory.Read(page_addr2, base::GetPageSize(), result.get()));
     EXPECT_FALSE(memory.Read(page_addr2 - 1, 2, result.get()));
+
+    // Failing regions in a batch must not prevent the regions that follow them
+    // from being read.
+    std::vector<ProcessMemory::ReadRange> ranges;
+    ranges.push_back({page_addr1, 1, result.get()});
+    ranges.push_back({page_addr2, 1, result.get() + 1});
+    ranges.push_back({page_addr2 - 1, 2, result.get() + 2});
+    ranges.push_back({page_addr1 + 3, 1, result.get() + 4});
+    std::vector<bool> results;
+    EXPECT_FALSE(memory.ReadBatch(ranges, &results));
+    EXPECT_EQ(results, std::vector<bool>({true, false, false, true}));
+    EXPECT_EQ(result[0], 0);
+    EXPECT_EQ(result[4], 3);
+    EXPECT_FALSE(memory.ReadBatch(ranges, nullptr));
   }
 };
 
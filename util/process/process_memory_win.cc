@@ -16,8 +16,11 @@
 
 #include <windows.h>
 
+#include <string.h>
+
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/logging.h"
@@ -27,6 +30,16 @@
 
 namespace crashpad {
 
+namespace {
+
+// Ranges separated by no more than this many bytes are read with a single
+// ReadProcessMemory() call by ReadBatchInternal(), as long as the combined read
+// stays within one readable span and doesn't exceed kMaxCoalescedReadSize.
+constexpr VMSize kMaxCoalescedGap = 4096;
+constexpr VMSize kMaxCoalescedReadSize = 64 * 1024;
+
+}  // namespace
+
 ProcessMemoryWin::ProcessMemoryWin()
     : ProcessMemory(), handle_(), process_info_(), initialized_() {}
 
@@ -76,6 +89,106 @@ ssize_t ProcessMemoryWin::ReadUpTo(VMAddress address,
   return -1;
 }
 
+void ProcessMemoryWin::ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                                         std::vector<bool>* results) const {
+  INITIALIZATION_STATE_DCHECK_VALID(initialized_);
+  DCHECK_EQ(results->size(), ranges.size());
+
+  std::vector<size_t> order;
+  order.reserve(ranges.size());
+  for (size_t index = 0; index < ranges.size(); ++index) {
+    if (ranges[index].size == 0) {
+      (*results)[index] = true;
+    } else {
+      order.push_back(index);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&ranges](size_t a, size_t b) {
+    return ranges[a].address < ranges[b].address;
+  });
+
+  std::vector<char> scratch;
+  size_t next = 0;
+  while (next < order.size()) {
+    const ReadRange& first = ranges[order[next]];
+    const VMAddress group_begin = first.address;
+    const VMSize available =
+        std::numeric_limits<VMAddress>::max() - group_begin;
+    if (first.size > std::min(available, kMaxCoalescedReadSize)) {
+      (*results)[order[next]] =
+          ReadUncounted(first.address, first.size, first.buffer);
+      ++next;
+      continue;
+    }
+
+    // Find the end of the readable span that begins at the first range, as
+    // recorded in the memory map. Ranges that don't fit entirely within it
+    // are read on their own, so that partial reads are reported correctly.
+    const auto readable = process_info_.GetReadableRanges(
+        CheckedRange<WinVMAddress, WinVMSize>(
+            group_begin, std::min(available, kMaxCoalescedReadSize)));
+    VMAddress group_end = group_begin + first.size;
+    if (readable.empty() || readable.front().base() != group_begin ||
+        readable.front().end() < group_end) {
+      (*results)[order[next]] =
+          ReadUncounted(first.address, first.size, first.buffer);
+      ++next;
+      continue;
+    }
+    const VMAddress span_end = readable.front().end();
+
+    size_t group_last = next + 1;
+    for (; group_last < order.size(); ++group_last) {
+      const ReadRange& range = ranges[order[group_last]];
+      if (range.address > group_end &&
+          range.address - group_end > kMaxCoalescedGap) {
+        break;
+      }
+      if (range.address >= span_end ||
+          range.size > span_end - range.address) {
+        break;
+      }
+      group_end = std::max(group_end, range.address + range.size);
+    }
+
+    if (group_last - next == 1) {
+      (*results)[order[next]] =
+          ReadUncounted(first.address, first.size, first.buffer);
+      ++next;
+      continue;
+    }
+
+    const size_t group_size = static_cast<size_t>(group_end - group_begin);
+    scratch.resize(group_size);
+    SIZE_T size_out = 0;
+    if (ReadProcessMemory(handle_,
+                          reinterpret_cast<void*>(group_begin),
+                          scratch.data(),
+                          group_size,
+                          &size_out) &&
+        size_out == group_size) {
+      for (size_t order_index = next; order_index < group_last;
+           ++order_index) {
+        const ReadRange& range = ranges[order[order_index]];
+        memcpy(range.buffer,
+               &scratch[static_cast<size_t>(range.address - group_begin)],
+               static_cast<size_t>(range.size));
+        (*results)[order[order_index]] = true;
+      }
+    } else {
+      // The memory map may be out of date. Read each range individually so
+      // that only those that really can't be read are reported as failing.
+      for (size_t order_index = next; order_index < group_last;
+           ++order_index) {
+        const ReadRange& range = ranges[order[order_index]];
+        (*results)[order[order_index]] =
+            ReadUncounted(range.address, range.size, range.buffer);
+      }
+    }
+    next = group_last;
+  }
+}
+
 size_t ProcessMemoryWin::ReadAvailableMemory(VMAddress address,
                                              size_t size,
                                              void* buffer) const {
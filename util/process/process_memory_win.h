@@ -17,6 +17,8 @@
 
 #include <windows.h>
 
+#include <vector>
+
 #include "util/misc/address_types.h"
 #include "util/misc/initialization_state_dcheck.h"
 #include "util/process/process_memory.h"
@@ -57,6 +59,12 @@ class ProcessMemoryWin final : public ProcessMemory {
  private:
   ssize_t ReadUpTo(VMAddress address, size_t size, void* buffer) const override;
 
+  // Sorts ranges by address and coalesces neighbors that lie within a single
+  // readable span of process_info_'s memory map into one ReadProcessMemory()
+  // call, falling back to reading ranges individually on failure.
+  void ReadBatchInternal(const std::vector<ReadRange>& ranges,
+                         std::vector<bool>* results) const override;
+
   HANDLE handle_;
   ProcessInfo process_info_;
   InitializationStateDcheck initialized_;
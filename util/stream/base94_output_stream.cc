@@ -14,11 +14,13 @@
 
 #include "util/stream/base94_output_stream.h"
 
-#include <algorithm>
+#include <string.h>
+
+#include <iterator>
 
 #include "base/check.h"
 #include "base/logging.h"
-#include "base/numerics/safe_conversions.h"
+#include "build/build_config.h"
 
 namespace crashpad {
 
@@ -30,17 +32,37 @@ namespace {
 // bit is 1, the 14-bit number doesn’t exceed the max value.
 constexpr uint16_t kMaxValueOf14BitEncoding = (94 * 94 - 1) & 0x1FFF;
 
-constexpr size_t kMaxBuffer = 4096;
+// The value of a symbol in kDecodeTable that isn’t a base94 digit.
+constexpr uint8_t kInvalidDigit = 94;
 
-inline uint8_t EncodeByte(uint8_t byte) {
-  DCHECK(byte < 94);
-  return (byte >= 94u) ? 0xff : (byte + '!');
-}
+// Maps every value that two base94 symbols can encode to its symbols, least
+// significant first, so that encoding a block is a single lookup.
+struct EncodeTable {
+  constexpr EncodeTable() : symbols() {
+    for (size_t value = 0; value < std::size(symbols); ++value) {
+      symbols[value][0] = static_cast<uint8_t>('!' + value % 94);
+      symbols[value][1] = static_cast<uint8_t>('!' + value / 94);
+    }
+  }
 
-inline uint8_t DecodeByte(uint8_t byte) {
-  DCHECK(byte >= '!' && byte <= '~');
-  return std::min(static_cast<uint8_t>(byte - '!'), static_cast<uint8_t>(94));
-}
+  uint8_t symbols[94 * 94][2];
+};
+
+// Maps every byte to its base94 digit, or kInvalidDigit.
+struct DecodeTable {
+  constexpr DecodeTable() : digits() {
+    for (size_t byte = 0; byte < std::size(digits); ++byte) {
+      digits[byte] = byte >= '!' && byte <= '~'
+                         ? static_cast<uint8_t>(byte - '!')
+                         : kInvalidDigit;
+    }
+  }
+
+  uint8_t digits[256];
+};
+
+constexpr EncodeTable kEncodeTable;
+constexpr DecodeTable kDecodeTable;
 
 }  // namespace
 
@@ -49,13 +71,12 @@ Base94OutputStream::Base94OutputStream(
     std::unique_ptr<OutputStreamInterface> output_stream)
     : mode_(mode),
       output_stream_(std::move(output_stream)),
+      buffer_size_(0),
       bit_buf_(0),
       bit_count_(0),
       symbol_buffer_(0),
       flush_needed_(false),
-      flushed_(false) {
-  buffer_.reserve(kMaxBuffer);
-}
+      flushed_(false) {}
 
 Base94OutputStream::~Base94OutputStream() {
   DCHECK(!flush_needed_);
@@ -78,59 +99,69 @@ bool Base94OutputStream::Flush() {
 }
 
 bool Base94OutputStream::Encode(const uint8_t* data, size_t size) {
-  const uint8_t* cur = data;
-  while (size--) {
-    bit_buf_ |= *(cur++) << bit_count_;
-    bit_count_ += 8;
-    if (bit_count_ < 14)
-      continue;
+  const uint8_t* const end = data + size;
+  while (data != end) {
+    // Each refill leaves at most 64 bits, which is at most four blocks of two
+    // symbols each.
+    if (buffer_size_ > std::size(buffer_) - 8 && !WriteOutputStream())
+      return false;
 
-    uint16_t block;
-    // Check if 13-bit or 14-bit data should be encoded.
-    if ((bit_buf_ & 0x1FFF) > kMaxValueOf14BitEncoding) {
-      block = bit_buf_ & 0x1FFF;
-      bit_buf_ >>= 13;
-      bit_count_ -= 13;
-    } else {
-      block = bit_buf_ & 0x3FFF;
-      bit_buf_ >>= 14;
-      bit_count_ -= 14;
+    // Load as many bytes as fit, then extract every complete block. Testing
+    // for blocks only once at least 14 bits are available results in the same
+    // blocks as testing after each byte.
+#if defined(ARCH_CPU_LITTLE_ENDIAN)
+    if (end - data >= 8) {
+      // Load eight bytes at once, keeping only the whole bytes that fit above
+      // the bits already present.
+      uint64_t word;
+      memcpy(&word, data, sizeof(word));
+      bit_buf_ |= word << bit_count_;
+      data += (63 - bit_count_) / 8;
+      bit_count_ |= 56;
+    }
+#endif  // ARCH_CPU_LITTLE_ENDIAN
+    while (bit_count_ <= 56 && data != end) {
+      bit_buf_ |= static_cast<uint64_t>(*data++) << bit_count_;
+      bit_count_ += 8;
+    }
+    while (bit_count_ >= 14) {
+      // Check if 13-bit or 14-bit data should be encoded.
+      const size_t block_bits =
+          (bit_buf_ & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+      const size_t block = bit_buf_ & ((1u << block_bits) - 1);
+      bit_buf_ >>= block_bits;
+      bit_count_ -= block_bits;
+      memcpy(&buffer_[buffer_size_], kEncodeTable.symbols[block], 2);
+      buffer_size_ += 2;
     }
-    buffer_.push_back(EncodeByte(block % 94));
-    buffer_.push_back(EncodeByte(base::saturated_cast<uint8_t>(block / 94)));
-
-    if (buffer_.size() > kMaxBuffer - 2 && !WriteOutputStream())
-      return false;
   }
   return WriteOutputStream();
 }
 
 bool Base94OutputStream::Decode(const uint8_t* data, size_t size) {
-  const uint8_t* cur = data;
-  while (size--) {
-    if (DecodeByte(*cur) == 94) {
+  const uint8_t* const end = data + size;
+  while (data != end) {
+    const uint8_t digit = kDecodeTable.digits[*data];
+    if (digit == kInvalidDigit) {
       LOG(ERROR) << "Decode: invalid input";
       return false;
     }
     if (symbol_buffer_ == 0) {
-      symbol_buffer_ = *cur;
-      cur++;
+      symbol_buffer_ = *data++;
       continue;
     }
-    uint16_t v = DecodeByte(symbol_buffer_) + DecodeByte(*cur) * 94;
-    cur++;
+    ++data;
+    const uint32_t v = kDecodeTable.digits[symbol_buffer_] + digit * 94;
     symbol_buffer_ = 0;
-    bit_buf_ |= v << bit_count_;
+    bit_buf_ |= static_cast<uint64_t>(v) << bit_count_;
     bit_count_ += (v & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
     while (bit_count_ > 7) {
-      buffer_.push_back(bit_buf_ & 0xff);
+      buffer_[buffer_size_++] = bit_buf_ & 0xff;
       bit_buf_ >>= 8;
       bit_count_ -= 8;
     }
-    if (buffer_.size() > kMaxBuffer - 2) {
-      if (!WriteOutputStream())
-        return false;
-    }
+    if (buffer_size_ > std::size(buffer_) - 2 && !WriteOutputStream())
+      return false;
   }
   return WriteOutputStream();
 }
@@ -139,9 +170,10 @@ bool Base94OutputStream::FinishEncoding() {
   if (bit_count_ == 0)
     return true;
   // Up to 13 bits data is left over.
-  buffer_.push_back(EncodeByte(bit_buf_ % 94));
+  const uint8_t* symbols = kEncodeTable.symbols[bit_buf_];
+  buffer_[buffer_size_++] = symbols[0];
   if (bit_buf_ > 93 || bit_count_ > 8)
-    buffer_.push_back(EncodeByte(base::saturated_cast<uint8_t>(bit_buf_ / 94)));
+    buffer_[buffer_size_++] = symbols[1];
   bit_count_ = 0;
   bit_buf_ = 0;
   return WriteOutputStream();
@@ -154,8 +186,9 @@ bool Base94OutputStream::FinishDecoding() {
     DCHECK(!bit_buf_);
     return true;
   }
-  bit_buf_ |= DecodeByte(symbol_buffer_) << bit_count_;
-  buffer_.push_back(bit_buf_ & 0xff);
+  bit_buf_ |= static_cast<uint64_t>(kDecodeTable.digits[symbol_buffer_])
+              << bit_count_;
+  buffer_[buffer_size_++] = bit_buf_ & 0xff;
   bit_buf_ >>= 8;
   // The remaining bits are either encode padding or zeros from bit shift.
   DCHECK(!bit_buf_);
@@ -163,11 +196,11 @@ bool Base94OutputStream::FinishDecoding() {
 }
 
 bool Base94OutputStream::WriteOutputStream() {
-  if (buffer_.empty())
+  if (buffer_size_ == 0)
     return true;
 
-  bool result = output_stream_->Write(buffer_.data(), buffer_.size());
-  buffer_.clear();
+  bool result = output_stream_->Write(buffer_, buffer_size_);
+  buffer_size_ = 0;
   return result;
 }
 
@@ -45,6 +45,34 @@ std::string DumpInput(const uint8_t* input, size_t size) {
   return s.str();
 }
 
+// Encodes |input| one byte at a time, as a straightforward implementation of
+// the encoding described by Base94OutputStream, to check the optimized encoder.
+std::string ReferenceEncode(const std::vector<uint8_t>& input) {
+  constexpr uint32_t kMaxValueOf14BitEncoding = (94 * 94 - 1) & 0x1FFF;
+  std::string output;
+  uint32_t bit_buf = 0;
+  size_t bit_count = 0;
+  for (uint8_t byte : input) {
+    bit_buf |= byte << bit_count;
+    bit_count += 8;
+    if (bit_count < 14)
+      continue;
+    const size_t block_bits =
+        (bit_buf & 0x1FFF) > kMaxValueOf14BitEncoding ? 13 : 14;
+    const uint32_t block = bit_buf & ((1u << block_bits) - 1);
+    bit_buf >>= block_bits;
+    bit_count -= block_bits;
+    output.push_back('!' + block % 94);
+    output.push_back('!' + block / 94);
+  }
+  if (bit_count > 0) {
+    output.push_back('!' + bit_buf % 94);
+    if (bit_buf > 93 || bit_count > 8)
+      output.push_back('!' + bit_buf / 94);
+  }
+  return output;
+}
+
 class Base94OutputStreamTest : public testing::Test {
  public:
   Base94OutputStreamTest() {}
@@ -252,6 +280,51 @@ TEST_F(Base94OutputStreamTest, WriteDeterministicLongDataMultipleTimes) {
             0);
 }
 
+TEST(Base94OutputStreamReference, MatchesReferenceEncoding) {
+  for (size_t length : {1u, 2u, 7u, 8u, 9u, 63u, 4093u, 4096u, 40961u}) {
+    SCOPED_TRACE(base::StringPrintf("length %zu", length));
+    std::vector<uint8_t> input(length);
+    base::RandBytes(input.data(), input.size());
+    const std::string expected = ReferenceEncode(input);
+
+    // Write in pieces of varying sizes so that encoding crosses Write() calls
+    // at arbitrary points.
+    auto output_stream = std::make_unique<TestOutputStream>();
+    TestOutputStream* output_stream_weak = output_stream.get();
+    Base94OutputStream encoder(Base94OutputStream::Mode::kEncode,
+                               std::move(output_stream));
+    size_t index = 0;
+    while (index < input.size()) {
+      size_t write_length = std::min(
+          static_cast<size_t>(base::RandInt(0, 17)), input.size() - index);
+      ASSERT_TRUE(encoder.Write(input.data() + index, write_length));
+      index += write_length;
+    }
+    ASSERT_TRUE(encoder.Flush());
+
+    const std::vector<uint8_t>& encoded = output_stream_weak->all_data();
+    EXPECT_EQ(std::string(encoded.begin(), encoded.end()), expected);
+
+    output_stream = std::make_unique<TestOutputStream>();
+    output_stream_weak = output_stream.get();
+    Base94OutputStream decoder(Base94OutputStream::Mode::kDecode,
+                               std::move(output_stream));
+    ASSERT_TRUE(decoder.Write(reinterpret_cast<const uint8_t*>(expected.data()),
+                              expected.size()));
+    ASSERT_TRUE(decoder.Flush());
+    EXPECT_EQ(output_stream_weak->all_data(), input);
+  }
+}
+
+TEST(Base94OutputStreamReference, DecodeInvalidInput) {
+  static constexpr char kInvalid[] = "!! !";
+  Base94OutputStream decoder(Base94OutputStream::Mode::kDecode,
+                             std::make_unique<TestOutputStream>());
+  EXPECT_FALSE(decoder.Write(reinterpret_cast<const uint8_t*>(kInvalid),
+                             strlen(kInvalid)));
+  decoder.Flush();
+}
+
 TEST_F(Base94OutputStreamTest, NoWriteOrFlush) {
   EXPECT_EQ(round_trip_test_output_stream().write_count(), 0u);
   EXPECT_EQ(round_trip_test_output_stream().flush_count(), 0u);
@@ -0,0 +1,39 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stream/hashing_output_stream.h"
+
+#include <utility>
+
+namespace crashpad {
+
+HashingOutputStream::HashingOutputStream(
+    std::unique_ptr<OutputStreamInterface> output_stream)
+    : output_stream_(std::move(output_stream)), hash_() {}
+
+HashingOutputStream::~HashingOutputStream() = default;
+
+bool HashingOutputStream::Write(const uint8_t* data, size_t size) {
+  if (!output_stream_->Write(data, size)) {
+    return false;
+  }
+  hash_.Update(data, size);
+  return true;
+}
+
+bool HashingOutputStream::Flush() {
+  return output_stream_->Flush();
+}
+
+}  // namespace crashpad
@@ -0,0 +1,63 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_STREAM_HASHING_OUTPUT_STREAM_H_
+#define CRASHPAD_UTIL_STREAM_HASHING_OUTPUT_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "util/misc/xxhash64.h"
+#include "util/stream/output_stream_interface.h"
+
+namespace crashpad {
+
+//! \brief Passes data through to another OutputStreamInterface, computing its
+//!     XXH64 digest and size along the way.
+//!
+//! This allows a digest of content to be obtained as it is written, without
+//! reading it back afterwards.
+class HashingOutputStream : public OutputStreamInterface {
+ public:
+  //! \param[in] output_stream The output_stream that this object writes to.
+  explicit HashingOutputStream(
+      std::unique_ptr<OutputStreamInterface> output_stream);
+
+  HashingOutputStream(const HashingOutputStream&) = delete;
+  HashingOutputStream& operator=(const HashingOutputStream&) = delete;
+
+  ~HashingOutputStream() override;
+
+  // OutputStreamInterface:
+  bool Write(const uint8_t* data, size_t size) override;
+  bool Flush() override;
+
+  //! \brief The XXH64 digest of the data successfully written to the
+  //!     downstream OutputStreamInterface.
+  uint64_t digest() const { return hash_.Digest(); }
+
+  //! \brief The number of bytes successfully written to the downstream
+  //!     OutputStreamInterface.
+  uint64_t size() const { return hash_.size(); }
+
+ private:
+  std::unique_ptr<OutputStreamInterface> output_stream_;
+  XXHash64 hash_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_STREAM_HASHING_OUTPUT_STREAM_H_
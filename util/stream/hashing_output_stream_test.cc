@@ -0,0 +1,52 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/stream/hashing_output_stream.h"
+
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/stream/test_output_stream.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(HashingOutputStream, PassesThroughAndHashes) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output = test_output_stream.get();
+  HashingOutputStream hashing_stream(std::move(test_output_stream));
+
+  EXPECT_EQ(hashing_stream.size(), 0u);
+  EXPECT_EQ(hashing_stream.digest(), 0xef46db3751d8e999u);
+
+  static constexpr uint8_t kData[] = {'a', 'b', 'c'};
+  ASSERT_TRUE(hashing_stream.Write(kData, 1));
+  ASSERT_TRUE(hashing_stream.Write(kData + 1, 2));
+  ASSERT_TRUE(hashing_stream.Flush());
+
+  EXPECT_EQ(test_output->write_count(), 2u);
+  EXPECT_EQ(test_output->flush_count(), 1u);
+  EXPECT_EQ(test_output->all_data(),
+            std::vector<uint8_t>(std::begin(kData), std::end(kData)));
+  EXPECT_EQ(hashing_stream.size(), 3u);
+  EXPECT_EQ(hashing_stream.digest(), 0x44bc2cf5ad770999u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
@@ -18,18 +18,60 @@
 
 #include "base/check.h"
 #include "base/logging.h"
+#include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
 #include "util/misc/zlib.h"
 
 namespace crashpad {
 
+namespace {
+
+int ZlibStrategy(ZlibOutputStream::Strategy strategy) {
+  switch (strategy) {
+    case ZlibOutputStream::Strategy::kDefault:
+      return Z_DEFAULT_STRATEGY;
+    case ZlibOutputStream::Strategy::kFiltered:
+      return Z_FILTERED;
+    case ZlibOutputStream::Strategy::kHuffmanOnly:
+      return Z_HUFFMAN_ONLY;
+    case ZlibOutputStream::Strategy::kRLE:
+      return Z_RLE;
+  }
+  NOTREACHED();
+  return Z_DEFAULT_STRATEGY;
+}
+
+}  // namespace
+
+ZlibOutputStream::ZlibOutputStream(
+    Mode mode,
+    std::unique_ptr<OutputStreamInterface> output_stream)
+    : ZlibOutputStream(mode, Format::kZlib, std::move(output_stream)) {}
+
+ZlibOutputStream::ZlibOutputStream(
+    Mode mode,
+    Format format,
+    std::unique_ptr<OutputStreamInterface> output_stream)
+    : ZlibOutputStream(mode,
+                       format,
+                       kDefaultCompressionLevel,
+                       Strategy::kDefault,
+                       std::move(output_stream)) {}
+
 ZlibOutputStream::ZlibOutputStream(
     Mode mode,
+    Format format,
+    int compression_level,
+    Strategy strategy,
     std::unique_ptr<OutputStreamInterface> output_stream)
     : output_stream_(std::move(output_stream)),
       mode_(mode),
+      format_(format),
+      compression_level_(compression_level),
+      strategy_(strategy),
       initialized_(),
-      flush_needed_(false) {}
+      flush_needed_(false),
+      stream_end_(false) {}
 
 ZlibOutputStream::~ZlibOutputStream() {
   if (!initialized_.is_valid())
@@ -52,16 +94,32 @@ bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
     zlib_stream_.zfree = Z_NULL;
     zlib_stream_.opaque = Z_NULL;
 
+    // The default values for zlib’s internal MAX_WBITS and DEF_MEM_LEVEL. These
+    // are the values that inflateInit() and deflateInit() would use, but
+    // they’re not exported from zlib. inflateInit2() and deflateInit2() are
+    // used to be able to select the wrapper.
+    constexpr int kZlibMaxWindowBits = 15;
+    constexpr int kZlibDefaultMemoryLevel = 8;
+
+    const int window_bits =
+        format_ == Format::kGzip
+            ? ZlibWindowBitsWithGzipWrapper(kZlibMaxWindowBits)
+            : kZlibMaxWindowBits;
     if (mode_ == Mode::kDecompress) {
-      int result = inflateInit(&zlib_stream_);
+      int result = inflateInit2(&zlib_stream_, window_bits);
       if (result != Z_OK) {
-        LOG(ERROR) << "inflateInit: " << ZlibErrorString(result);
+        LOG(ERROR) << "inflateInit2: " << ZlibErrorString(result);
         return false;
       }
     } else if (mode_ == Mode::kCompress) {
-      int result = deflateInit(&zlib_stream_, Z_BEST_COMPRESSION);
+      int result = deflateInit2(&zlib_stream_,
+                                compression_level_,
+                                Z_DEFLATED,
+                                window_bits,
+                                kZlibDefaultMemoryLevel,
+                                ZlibStrategy(strategy_));
       if (result != Z_OK) {
-        LOG(ERROR) << "deflateInit: " << ZlibErrorString(result);
+        LOG(ERROR) << "deflateInit2: " << ZlibErrorString(result);
         return false;
       }
     }
@@ -83,9 +141,20 @@ bool ZlibOutputStream::Write(const uint8_t* data, size_t size) {
         return false;
       }
     } else if (mode_ == Mode::kDecompress) {
+      if (stream_end_ && format_ == Format::kGzip) {
+        // Another gzip member follows the one that just ended.
+        int result = inflateReset(&zlib_stream_);
+        if (result != Z_OK) {
+          LOG(ERROR) << "inflateReset: " << ZlibErrorString(result);
+          return false;
+        }
+        stream_end_ = false;
+      }
+
       int result = inflate(&zlib_stream_, Z_NO_FLUSH);
       if (result == Z_STREAM_END) {
-        if (zlib_stream_.avail_in > 0) {
+        stream_end_ = true;
+        if (zlib_stream_.avail_in > 0 && format_ != Format::kGzip) {
           LOG(ERROR) << "inflate: unconsumed input";
           return false;
         }
@@ -115,6 +184,12 @@ bool ZlibOutputStream::Flush() {
         }
       } else if (mode_ == Mode::kDecompress) {
         result = inflate(&zlib_stream_, Z_FINISH);
+        if (result == Z_BUF_ERROR && zlib_stream_.avail_out > 0) {
+          // There was room for output, so no progress was possible because
+          // the compressed data ended prematurely.
+          LOG(ERROR) << "inflate: unexpected end of input";
+          return false;
+        }
         if (result != Z_STREAM_END && result != Z_BUF_ERROR && result != Z_OK) {
           LOG(ERROR) << "inflate: " << zlib_stream_.msg;
           return false;
@@ -37,6 +37,37 @@ class ZlibOutputStream : public OutputStreamInterface {
     kDecompress = true
   };
 
+  //! \brief The wrapper around the compressed data.
+  enum class Format : bool {
+    //! \brief Compressed data uses the zlib wrapper (RFC 1950).
+    kZlib = false,
+    //! \brief Compressed data uses the `gzip` wrapper (RFC 1952).
+    //!
+    //! When decompressing, a stream consisting of several concatenated `gzip`
+    //! members is accepted, and the decompressed members are written in
+    //! sequence.
+    kGzip = true
+  };
+
+  //! \brief The deflate strategy used when compressing.
+  //!
+  //! These correspond to zlib’s strategies. Strategies other than #kDefault
+  //! trade compression ratio for speed on particular kinds of data.
+  enum class Strategy {
+    //! \brief The strategy suitable for most data, `Z_DEFAULT_STRATEGY`.
+    kDefault,
+    //! \brief Favors Huffman coding over string matching, `Z_FILTERED`.
+    kFiltered,
+    //! \brief Uses Huffman coding only, with no string matching,
+    //!     `Z_HUFFMAN_ONLY`.
+    kHuffmanOnly,
+    //! \brief Limits string matching to runs of a single byte, `Z_RLE`.
+    kRLE,
+  };
+
+  //! \brief The compression level used by constructors that don’t take one.
+  static constexpr int kDefaultCompressionLevel = Z_BEST_COMPRESSION;
+
   //! \param[in] mode The work mode of this object.
   //! \param[in] output_stream The output_stream that this object writes to.
   //!
@@ -56,6 +87,29 @@ class ZlibOutputStream : public OutputStreamInterface {
   ZlibOutputStream(Mode mode,
                    std::unique_ptr<OutputStreamInterface> output_stream);
 
+  //! \param[in] mode The work mode of this object.
+  //! \param[in] format The wrapper around the compressed data.
+  //! \param[in] output_stream The output_stream that this object writes to.
+  ZlibOutputStream(Mode mode,
+                   Format format,
+                   std::unique_ptr<OutputStreamInterface> output_stream);
+
+  //! \param[in] mode The work mode of this object.
+  //! \param[in] format The wrapper around the compressed data.
+  //! \param[in] compression_level The zlib compression level, from
+  //!     `Z_BEST_SPEED` (`1`) to `Z_BEST_COMPRESSION` (`9`), or
+  //!     `Z_DEFAULT_COMPRESSION`. Data that must be produced quickly, such as
+  //!     a minidump emitted while handling a crash, should use a low level.
+  //!     This is ignored when \a mode is Mode::kDecompress.
+  //! \param[in] strategy The deflate strategy. This is ignored when \a mode is
+  //!     Mode::kDecompress.
+  //! \param[in] output_stream The output_stream that this object writes to.
+  ZlibOutputStream(Mode mode,
+                   Format format,
+                   int compression_level,
+                   Strategy strategy,
+                   std::unique_ptr<OutputStreamInterface> output_stream);
+
   ZlibOutputStream(const ZlibOutputStream&) = delete;
   ZlibOutputStream& operator=(const ZlibOutputStream&) = delete;
 
@@ -74,8 +128,12 @@ class ZlibOutputStream : public OutputStreamInterface {
   z_stream zlib_stream_;
   std::unique_ptr<OutputStreamInterface> output_stream_;
   Mode mode_;
+  Format format_;
+  int compression_level_;
+  Strategy strategy_;
   InitializationState initialized_;  // protects zlib_stream_
   bool flush_needed_;
+  bool stream_end_;
 };
 
 }  // namespace crashpad
@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <string>
+#include <vector>
 
 #include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
@@ -182,6 +184,126 @@ TEST_F(ZlibOutputStreamTest, WriteEmptyData) {
   EXPECT_TRUE(test_output_stream().all_data().empty());
 }
 
+TEST(ZlibOutputStreamLevel, LevelsAndStrategies) {
+  std::string input;
+  for (size_t index = 0; index < kLongDataLength; ++index) {
+    input.append(base::StringPrintf("%zu ", index % 97));
+  }
+
+  static constexpr ZlibOutputStream::Strategy kStrategies[] = {
+      ZlibOutputStream::Strategy::kDefault,
+      ZlibOutputStream::Strategy::kFiltered,
+      ZlibOutputStream::Strategy::kHuffmanOnly,
+      ZlibOutputStream::Strategy::kRLE,
+  };
+
+  size_t fastest_size = 0;
+  size_t best_size = 0;
+  for (int level : {Z_BEST_SPEED, Z_DEFAULT_COMPRESSION, Z_BEST_COMPRESSION}) {
+    for (ZlibOutputStream::Strategy strategy : kStrategies) {
+      SCOPED_TRACE(base::StringPrintf(
+          "level %d, strategy %d", level, static_cast<int>(strategy)));
+
+      auto test_output_stream = std::make_unique<TestOutputStream>();
+      TestOutputStream* test_output_stream_weak = test_output_stream.get();
+      ZlibOutputStream compressor(ZlibOutputStream::Mode::kCompress,
+                                  ZlibOutputStream::Format::kGzip,
+                                  level,
+                                  strategy,
+                                  std::move(test_output_stream));
+      ASSERT_TRUE(compressor.Write(
+          reinterpret_cast<const uint8_t*>(input.data()), input.size()));
+      ASSERT_TRUE(compressor.Flush());
+
+      const std::vector<uint8_t>& compressed =
+          test_output_stream_weak->all_data();
+      EXPECT_LT(compressed.size(), input.size());
+      if (strategy == ZlibOutputStream::Strategy::kDefault) {
+        if (level == Z_BEST_SPEED) {
+          fastest_size = compressed.size();
+        } else if (level == Z_BEST_COMPRESSION) {
+          best_size = compressed.size();
+        }
+      }
+
+      test_output_stream = std::make_unique<TestOutputStream>();
+      test_output_stream_weak = test_output_stream.get();
+      ZlibOutputStream decompressor(ZlibOutputStream::Mode::kDecompress,
+                                    ZlibOutputStream::Format::kGzip,
+                                    std::move(test_output_stream));
+      ASSERT_TRUE(decompressor.Write(compressed.data(), compressed.size()));
+      ASSERT_TRUE(decompressor.Flush());
+
+      const std::vector<uint8_t>& decompressed =
+          test_output_stream_weak->all_data();
+      EXPECT_EQ(std::string(decompressed.begin(), decompressed.end()), input);
+    }
+  }
+  EXPECT_LE(best_size, fastest_size);
+}
+
+TEST(ZlibOutputStreamGzip, ConcatenatedMembers) {
+  static constexpr char kFirst[] = "first gzip member";
+  static constexpr char kSecond[] = "and the second";
+
+  std::vector<uint8_t> compressed;
+  for (const char* data : {kFirst, kSecond}) {
+    auto test_output_stream = std::make_unique<TestOutputStream>();
+    TestOutputStream* test_output_stream_weak = test_output_stream.get();
+    ZlibOutputStream compressor(ZlibOutputStream::Mode::kCompress,
+                                ZlibOutputStream::Format::kGzip,
+                                std::move(test_output_stream));
+    ASSERT_TRUE(compressor.Write(reinterpret_cast<const uint8_t*>(data),
+                                 strlen(data)));
+    ASSERT_TRUE(compressor.Flush());
+
+    const std::vector<uint8_t>& member = test_output_stream_weak->all_data();
+    ASSERT_GE(member.size(), 2u);
+    EXPECT_EQ(member[0], 0x1f);
+    EXPECT_EQ(member[1], 0x8b);
+    compressed.insert(compressed.end(), member.begin(), member.end());
+  }
+
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZlibOutputStream decompressor(ZlibOutputStream::Mode::kDecompress,
+                                ZlibOutputStream::Format::kGzip,
+                                std::move(test_output_stream));
+  ASSERT_TRUE(decompressor.Write(compressed.data(), compressed.size()));
+  ASSERT_TRUE(decompressor.Flush());
+
+  const std::string expected = std::string(kFirst) + kSecond;
+  const std::vector<uint8_t>& decompressed =
+      test_output_stream_weak->all_data();
+  EXPECT_EQ(std::string(decompressed.begin(), decompressed.end()), expected);
+}
+
+TEST(ZlibOutputStreamGzip, TruncatedInput) {
+  auto test_output_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* test_output_stream_weak = test_output_stream.get();
+  ZlibOutputStream compressor(ZlibOutputStream::Mode::kCompress,
+                              ZlibOutputStream::Format::kGzip,
+                              std::move(test_output_stream));
+  const std::vector<uint8_t> input(kLongDataLength, 'z');
+  ASSERT_TRUE(compressor.Write(input.data(), input.size()));
+  ASSERT_TRUE(compressor.Flush());
+
+  const std::vector<uint8_t>& compressed = test_output_stream_weak->all_data();
+  ASSERT_GT(compressed.size(), 8u);
+
+  auto decompressed_stream = std::make_unique<TestOutputStream>();
+  TestOutputStream* decompressed_stream_weak = decompressed_stream.get();
+  ZlibOutputStream decompressor(ZlibOutputStream::Mode::kDecompress,
+                                ZlibOutputStream::Format::kGzip,
+                                std::move(decompressed_stream));
+  ASSERT_TRUE(decompressor.Write(compressed.data(), compressed.size() - 8));
+  EXPECT_FALSE(decompressor.Flush());
+
+  // The failed Flush() doesn't reach the downstream stream, which must be
+  // flushed before it is destroyed.
+  EXPECT_TRUE(decompressed_stream_weak->Flush());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -0,0 +1,81 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/run_concurrently.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+namespace {
+
+// Runs a function on its own thread on behalf of RunConcurrently().
+class ConcurrentWorker final : public Thread {
+ public:
+  explicit ConcurrentWorker(const std::function<void()>* function)
+      : Thread(), function_(function) {}
+
+  ConcurrentWorker(const ConcurrentWorker&) = delete;
+  ConcurrentWorker& operator=(const ConcurrentWorker&) = delete;
+
+  ~ConcurrentWorker() override = default;
+
+ private:
+  void ThreadMain() override { (*function_)(); }
+
+  const std::function<void()>* function_;  // weak
+};
+
+}  // namespace
+
+void RunConcurrently(size_t count,
+                     size_t concurrency,
+                     const std::function<void(size_t)>& function) {
+  const size_t worker_count =
+      std::min(std::max(concurrency, size_t{1}), count);
+  if (worker_count <= 1) {
+    for (size_t index = 0; index < count; ++index) {
+      function(index);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next_index(0);
+  const std::function<void()> work = [count, &function, &next_index]() {
+    size_t index;
+    while ((index = next_index.fetch_add(1)) < count) {
+      function(index);
+    }
+  };
+
+  std::vector<std::unique_ptr<ConcurrentWorker>> workers;
+  workers.reserve(worker_count - 1);
+  for (size_t index = 0; index < worker_count - 1; ++index) {
+    workers.push_back(std::make_unique<ConcurrentWorker>(&work));
+    workers.back()->Start();
+  }
+
+  work();
+
+  for (auto& worker : workers) {
+    worker->Join();
+  }
+}
+
+}  // namespace crashpad
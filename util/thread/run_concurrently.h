@@ -0,0 +1,45 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_THREAD_RUN_CONCURRENTLY_H_
+#define CRASHPAD_UTIL_THREAD_RUN_CONCURRENTLY_H_
+
+#include <stddef.h>
+
+#include <functional>
+
+namespace crashpad {
+
+//! \brief Calls a function once for each index in a range, distributing the
+//!     calls across several threads.
+//!
+//! Each thread, including the calling thread, repeatedly claims the lowest
+//! index not yet claimed until none remain, so work is balanced even when some
+//! calls take much longer than others. Calls for different indices may run at
+//! the same time, so \a function must be safe to call concurrently. This
+//! function returns once every call has returned.
+//!
+//! \param[in] count The number of indices. \a function is called for each
+//!     index in `[0, count)`.
+//! \param[in] concurrency The maximum number of threads to use, including the
+//!     calling thread. Values less than 1 are treated as 1, in which case every
+//!     call is made on the calling thread, in order.
+//! \param[in] function The function to call with each index.
+void RunConcurrently(size_t count,
+                     size_t concurrency,
+                     const std::function<void(size_t)>& function);
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_THREAD_RUN_CONCURRENTLY_H_
@@ -0,0 +1,67 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/run_concurrently.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(RunConcurrently, Serial) {
+  std::vector<size_t> indices;
+  RunConcurrently(5, 1, [&indices](size_t index) { indices.push_back(index); });
+  EXPECT_EQ(indices, std::vector<size_t>({0, 1, 2, 3, 4}));
+
+  indices.clear();
+  RunConcurrently(3, 0, [&indices](size_t index) { indices.push_back(index); });
+  EXPECT_EQ(indices, std::vector<size_t>({0, 1, 2}));
+
+  RunConcurrently(0, 4, [](size_t index) { ADD_FAILURE(); });
+}
+
+TEST(RunConcurrently, EachIndexOnce) {
+  static constexpr size_t kCount = 100;
+  std::atomic<int> calls[kCount] = {};
+  RunConcurrently(kCount, 8, [&calls](size_t index) {
+    ASSERT_LT(index, kCount);
+    calls[index].fetch_add(1);
+  });
+  for (size_t index = 0; index < kCount; ++index) {
+    EXPECT_EQ(calls[index].load(), 1) << "index " << index;
+  }
+}
+
+TEST(RunConcurrently, Concurrent) {
+  // Each call waits for the other to start, which can only happen if they run
+  // at the same time.
+  Semaphore started[2] = {Semaphore(0), Semaphore(0)};
+  std::atomic<int> timed_out(0);
+  RunConcurrently(2, 2, [&started, &timed_out](size_t index) {
+    started[index].Signal();
+    if (!started[1 - index].TimedWait(5.0)) {
+      timed_out.fetch_add(1);
+    }
+  });
+  EXPECT_EQ(timed_out.load(), 0);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
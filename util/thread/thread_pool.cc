@@ -0,0 +1,245 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_pool.h"
+
+#include <utility>
+
+#include "util/misc/clock.h"
+#include "util/thread/thread.h"
+
+namespace crashpad {
+
+namespace {
+
+// Identifies the pool and queue of the calling thread, if it is one of a
+// pool’s threads.
+struct CurrentWorker {
+  const void* pool;
+  size_t index;
+};
+
+thread_local CurrentWorker current_worker = {nullptr, 0};
+
+}  // namespace
+
+class ThreadPool::Worker final : public Thread {
+ public:
+  Worker(ThreadPool* pool, size_t index)
+      : Thread(), pool_(pool), index_(index) {}
+
+  Worker(const Worker&) = delete;
+  Worker& operator=(const Worker&) = delete;
+
+  ~Worker() override = default;
+
+ private:
+  void ThreadMain() override { pool_->WorkerMain(index_); }
+
+  ThreadPool* pool_;  // weak
+  size_t index_;
+};
+
+ThreadPool::TaskGroup::TaskGroup(ThreadPool* pool)
+    : pool_(pool),
+      deadline_ns_(0),
+      canceled_(false),
+      pending_(0),
+      skipped_(false) {}
+
+ThreadPool::TaskGroup::~TaskGroup() {
+  Wait();
+}
+
+void ThreadPool::TaskGroup::SetDeadline(uint64_t deadline_ns) {
+  deadline_ns_.store(deadline_ns);
+}
+
+void ThreadPool::TaskGroup::Post(std::function<void()> task) {
+  if (IsCanceled()) {
+    std::lock_guard<std::mutex> guard(pool_->lock_);
+    skipped_ = true;
+    return;
+  }
+
+  if (pool_->workers_.empty()) {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(pool_->lock_);
+    ++pending_;
+  }
+  pool_->Enqueue({std::move(task), this});
+}
+
+void ThreadPool::TaskGroup::Cancel() {
+  canceled_.store(true);
+}
+
+bool ThreadPool::TaskGroup::IsCanceled() const {
+  if (canceled_.load()) {
+    return true;
+  }
+  const uint64_t deadline_ns = deadline_ns_.load();
+  return deadline_ns && ClockMonotonicNanoseconds() >= deadline_ns;
+}
+
+bool ThreadPool::TaskGroup::Wait() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(pool_->lock_);
+      pool_->condition_.wait(
+          lock, [this]() { return pending_ == 0 || pool_->queued_ > 0; });
+      if (pending_ == 0) {
+        // This thread may have been woken in place of one that would have run
+        // a newly queued task, so pass the wakeup on.
+        if (pool_->queued_ > 0) {
+          pool_->condition_.notify_one();
+        }
+        return !skipped_;
+      }
+    }
+
+    // Help with queued tasks rather than waiting idly. They may not belong to
+    // this group, but this group’s tasks may be waiting on them.
+    Task task;
+    if (pool_->TakeTask(&task)) {
+      pool_->RunTask(&task);
+    }
+  }
+}
+
+ThreadPool::ThreadPool(size_t thread_count)
+    : queues_(),
+      workers_(),
+      next_queue_(0),
+      lock_(),
+      condition_(),
+      queued_(0),
+      stopping_(false) {
+  queues_.reserve(thread_count);
+  workers_.reserve(thread_count);
+  for (size_t index = 0; index < thread_count; ++index) {
+    queues_.push_back(std::make_unique<Queue>());
+    workers_.push_back(std::make_unique<Worker>(this, index));
+  }
+  for (auto& worker : workers_) {
+    worker->Start();
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_) {
+    worker->Join();
+  }
+}
+
+void ThreadPool::Enqueue(Task task) {
+  const size_t index = current_worker.pool == this
+                           ? current_worker.index
+                           : next_queue_.fetch_add(1) % queues_.size();
+  {
+    std::lock_guard<std::mutex> guard(queues_[index]->lock);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    ++queued_;
+  }
+  condition_.notify_one();
+}
+
+bool ThreadPool::TakeTask(Task* task) {
+  const bool is_worker = current_worker.pool == this;
+  const size_t own_index = is_worker ? current_worker.index : 0;
+
+  bool found = false;
+  if (is_worker) {
+    Queue* queue = queues_[own_index].get();
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (!queue->tasks.empty()) {
+      *task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+      found = true;
+    }
+  }
+
+  // Steal the oldest task from the first other queue that has one.
+  for (size_t offset = is_worker ? 1 : 0;
+       !found && offset < queues_.size();
+       ++offset) {
+    Queue* queue = queues_[(own_index + offset) % queues_.size()].get();
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (!queue->tasks.empty()) {
+      *task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+      found = true;
+    }
+  }
+
+  if (found) {
+    std::lock_guard<std::mutex> guard(lock_);
+    --queued_;
+  }
+  return found;
+}
+
+void ThreadPool::RunTask(Task* task) {
+  TaskGroup* group = task->group;
+  const bool skip = group->IsCanceled();
+  if (!skip) {
+    task->function();
+  }
+
+  // Release anything the task holds before its group can be seen to finish.
+  task->function = nullptr;
+
+  std::lock_guard<std::mutex> guard(lock_);
+  if (skip) {
+    group->skipped_ = true;
+  }
+  if (--group->pending_ == 0) {
+    condition_.notify_all();
+  }
+}
+
+void ThreadPool::WorkerMain(size_t index) {
+  current_worker = {this, index};
+  while (true) {
+    Task task;
+    if (TakeTask(&task)) {
+      RunTask(&task);
+      continue;
+    }
+
+    // Queued tasks are run before stopping.
+    std::unique_lock<std::mutex> lock(lock_);
+    if (queued_ == 0) {
+      if (stopping_) {
+        break;
+      }
+      condition_.wait(lock, [this]() { return queued_ > 0 || stopping_; });
+    }
+  }
+  current_worker = {nullptr, 0};
+}
+
+}  // namespace crashpad
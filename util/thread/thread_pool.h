@@ -0,0 +1,162 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_THREAD_THREAD_POOL_H_
+#define CRASHPAD_UTIL_THREAD_THREAD_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace crashpad {
+
+//! \brief A fixed-size pool of threads that run tasks posted to task groups.
+//!
+//! Each thread has its own queue of tasks. Tasks posted from one of the pool’s
+//! threads are added to that thread’s queue, and a thread takes the task it
+//! posted most recently from its own queue, so related work stays on one
+//! thread. Threads with nothing left to do take the oldest tasks from other
+//! threads’ queues. Tasks posted from other threads are given to the pool’s
+//! threads in turn.
+//!
+//! A pool created with no threads runs in inline mode: each task runs on the
+//! thread that posts it, before TaskGroup::Post() returns. This suits
+//! constrained environments, and makes the order of execution predictable.
+//!
+//! This object may be used from several threads at once. It must outlive every
+//! TaskGroup that uses it.
+class ThreadPool {
+ public:
+  //! \brief A set of tasks that can be waited for, canceled, and given a
+  //!     deadline together.
+  //!
+  //! A task that has not started when its group is canceled or its group’s
+  //! deadline passes is skipped. A task that has started runs to completion,
+  //! but may check IsCanceled() to return early.
+  //!
+  //! This object may be used from several threads at once. The destructor
+  //! calls Wait().
+  class TaskGroup {
+   public:
+    //! \param[in] pool The pool that runs this group’s tasks.
+    explicit TaskGroup(ThreadPool* pool);
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup();
+
+    //! \brief Skips tasks that have not started by \a deadline_ns.
+    //!
+    //! \param[in] deadline_ns A ClockMonotonicNanoseconds() value, or `0` for
+    //!     no deadline, which is the default.
+    void SetDeadline(uint64_t deadline_ns);
+
+    //! \brief Queues \a task to run on the pool.
+    //!
+    //! Tasks may post further tasks to their own or other groups. If the
+    //! group has been canceled or its deadline has passed, \a task is skipped.
+    void Post(std::function<void()> task);
+
+    //! \brief Skips every task in the group that has not started.
+    void Cancel();
+
+    //! \brief Returns `true` if Cancel() has been called or the deadline has
+    //!     passed.
+    bool IsCanceled() const;
+
+    //! \brief Waits for every task posted to the group to run or be skipped.
+    //!
+    //! While waiting, the calling thread runs queued tasks, so a task may wait
+    //! for a group of tasks that it posted without tying up a thread.
+    //!
+    //! \return `true` if every task posted so far ran. `false` if any was
+    //!     skipped.
+    bool Wait();
+
+   private:
+    friend class ThreadPool;
+
+    ThreadPool* pool_;  // weak
+    std::atomic<uint64_t> deadline_ns_;
+    std::atomic<bool> canceled_;
+
+    // Guarded by pool_->lock_.
+    size_t pending_;
+    bool skipped_;
+  };
+
+  //! \param[in] thread_count The number of threads to run tasks on. If `0`,
+  //!     the pool runs in inline mode.
+  explicit ThreadPool(size_t thread_count);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  //! \brief Runs any tasks still queued and stops the pool’s threads.
+  ~ThreadPool();
+
+  //! \brief Returns the number of threads that run tasks, which is `0` in
+  //!     inline mode.
+  size_t thread_count() const { return workers_.size(); }
+
+ private:
+  class Worker;
+
+  struct Task {
+    std::function<void()> function;
+    TaskGroup* group;  // weak
+  };
+
+  // A queue of tasks, taken from the back by its owner and stolen from the
+  // front by others.
+  struct Queue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  void Enqueue(Task task);
+
+  // Takes a task, preferring the queue of the calling thread if that is one of
+  // this pool’s threads. Returns false if every queue is empty.
+  bool TakeTask(Task* task);
+
+  // Runs task, or skips it if its group has been canceled, and accounts for it
+  // in its group.
+  void RunTask(Task* task);
+
+  // Runs tasks until the pool stops. Called by each Worker.
+  void WorkerMain(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_queue_;
+
+  // Guards the fields below and each TaskGroup’s pending_ and skipped_.
+  std::mutex lock_;
+  std::condition_variable condition_;
+  size_t queued_;
+  bool stopping_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_THREAD_THREAD_POOL_H_
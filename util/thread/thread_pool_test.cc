@@ -0,0 +1,129 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread/thread_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/misc/clock.h"
+#include "util/misc/time.h"
+#include "util/synchronization/semaphore.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+TEST(ThreadPool, Inline) {
+  ThreadPool pool(0);
+  EXPECT_EQ(pool.thread_count(), 0u);
+
+  std::vector<int> order;
+  ThreadPool::TaskGroup group(&pool);
+  for (int index = 0; index < 3; ++index) {
+    group.Post([&order, index]() { order.push_back(index); });
+    EXPECT_EQ(order.size(), static_cast<size_t>(index + 1));
+  }
+  EXPECT_TRUE(group.Wait());
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2}));
+
+  group.Cancel();
+  group.Post([]() { ADD_FAILURE(); });
+  EXPECT_FALSE(group.Wait());
+}
+
+TEST(ThreadPool, EachTaskOnce) {
+  static constexpr size_t kCount = 200;
+  std::atomic<int> calls[kCount] = {};
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.thread_count(), 4u);
+  ThreadPool::TaskGroup group(&pool);
+  for (size_t index = 0; index < kCount; ++index) {
+    group.Post([&calls, index]() { calls[index].fetch_add(1); });
+  }
+  EXPECT_TRUE(group.Wait());
+  for (size_t index = 0; index < kCount; ++index) {
+    EXPECT_EQ(calls[index].load(), 1) << "index " << index;
+  }
+}
+
+TEST(ThreadPool, NestedGroups) {
+  // Each task waits for tasks that it posts. With a single thread, this only
+  // completes because waiting threads run queued tasks.
+  ThreadPool pool(1);
+  std::atomic<int> leaves(0);
+  ThreadPool::TaskGroup outer(&pool);
+  for (int index = 0; index < 4; ++index) {
+    outer.Post([&pool, &leaves]() {
+      ThreadPool::TaskGroup inner(&pool);
+      for (int leaf = 0; leaf < 4; ++leaf) {
+        inner.Post([&leaves]() { leaves.fetch_add(1); });
+      }
+      EXPECT_TRUE(inner.Wait());
+    });
+  }
+  EXPECT_TRUE(outer.Wait());
+  EXPECT_EQ(leaves.load(), 16);
+}
+
+TEST(ThreadPool, Cancel) {
+  ThreadPool pool(1);
+  Semaphore started(0);
+  Semaphore release(0);
+  std::atomic<int> ran(0);
+
+  ThreadPool::TaskGroup blocker(&pool);
+  blocker.Post([&started, &release]() {
+    started.Signal();
+    release.Wait();
+  });
+  started.Wait();
+
+  // The pool’s only thread is busy, so these tasks are still queued when the
+  // group is canceled.
+  ThreadPool::TaskGroup group(&pool);
+  for (int index = 0; index < 3; ++index) {
+    group.Post([&ran]() { ran.fetch_add(1); });
+  }
+  group.Cancel();
+  EXPECT_TRUE(group.IsCanceled());
+  release.Signal();
+
+  EXPECT_FALSE(group.Wait());
+  EXPECT_EQ(ran.load(), 0);
+  EXPECT_TRUE(blocker.Wait());
+}
+
+TEST(ThreadPool, Deadline) {
+  ThreadPool pool(2);
+  ThreadPool::TaskGroup group(&pool);
+  EXPECT_FALSE(group.IsCanceled());
+
+  std::atomic<int> ran(0);
+  group.SetDeadline(ClockMonotonicNanoseconds() + 60 * kNanosecondsPerSecond);
+  group.Post([&ran]() { ran.fetch_add(1); });
+  EXPECT_TRUE(group.Wait());
+  EXPECT_EQ(ran.load(), 1);
+
+  group.SetDeadline(ClockMonotonicNanoseconds() - 1);
+  EXPECT_TRUE(group.IsCanceled());
+  group.Post([&ran]() { ran.fetch_add(1); });
+  EXPECT_FALSE(group.Wait());
+  EXPECT_EQ(ran.load(), 1);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
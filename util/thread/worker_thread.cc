@@ -14,11 +14,33 @@
 
 #include "util/thread/worker_thread.h"
 
-#include "base/check.h"
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "util/misc/clock.h"
 #include "util/thread/thread.h"
 
 namespace crashpad {
 
+namespace {
+
+// Returns |delay| in seconds, extended so that a wait of that length starting
+// now ends at a multiple of |alignment| seconds on the monotonic clock.
+double AlignDelay(double delay, double alignment) {
+  if (alignment <= 0 || delay == WorkerThread::kIndefiniteWait) {
+    return delay;
+  }
+
+  constexpr double kNanosecondsPerSecond = 1E9;
+  const double now = ClockMonotonicNanoseconds() / kNanosecondsPerSecond;
+  return ceil((now + delay) / alignment) * alignment - now;
+}
+
+}  // namespace
+
 namespace internal {
 
 class WorkerThreadImpl final : public Thread {
@@ -34,9 +56,12 @@ class WorkerThreadImpl final : public Thread {
       semaphore_.TimedWait(initial_work_delay_);
 
     while (self_->running_ || self_->do_work_now_) {
+      self_->work_result_ = WorkerThread::WorkResult::kDidWork;
       self_->delegate_->DoWork(self_);
       self_->do_work_now_ = false;
-      semaphore_.TimedWait(self_->work_interval_);
+      self_->UpdateWorkInterval();
+      semaphore_.TimedWait(
+          AlignDelay(self_->work_interval_, self_->wakeup_alignment_));
     }
   }
 
@@ -56,20 +81,51 @@ class WorkerThreadImpl final : public Thread {
 WorkerThread::WorkerThread(double work_interval,
                            WorkerThread::Delegate* delegate)
     : work_interval_(work_interval),
+      minimum_interval_(work_interval),
+      maximum_interval_(work_interval),
+      wakeup_alignment_(0),
       delegate_(delegate),
       impl_(),
+      work_result_(WorkResult::kDidWork),
       running_(false),
-      do_work_now_(false) {}
+      adaptive_(false),
+      do_work_now_(false),
+      reset_interval_(false) {}
 
 WorkerThread::~WorkerThread() {
   DCHECK(!running_);
 }
 
+void WorkerThread::SetAdaptiveInterval(double minimum_interval,
+                                       double maximum_interval) {
+  DCHECK(!running_);
+  DCHECK_GT(minimum_interval, 0);
+  DCHECK_GE(maximum_interval, minimum_interval);
+
+  adaptive_ = true;
+  minimum_interval_ = minimum_interval;
+  maximum_interval_ = maximum_interval;
+  work_interval_ = minimum_interval;
+}
+
+void WorkerThread::SetWakeupAlignment(double alignment) {
+  DCHECK(!running_);
+  DCHECK_GE(alignment, 0);
+
+  wakeup_alignment_ = alignment;
+}
+
+void WorkerThread::SetWorkResult(WorkResult result) {
+  work_result_ = result;
+}
+
 void WorkerThread::Start(double initial_work_delay) {
   DCHECK(!impl_);
   DCHECK(!running_);
 
   running_ = true;
+  work_interval_ = minimum_interval_;
+  reset_interval_ = false;
   impl_.reset(new internal::WorkerThreadImpl(this, initial_work_delay));
   impl_->Start();
 }
@@ -91,7 +147,22 @@ void WorkerThread::Stop() {
 void WorkerThread::DoWorkNow() {
   DCHECK(running_);
   do_work_now_ = true;
+  reset_interval_ = true;
   impl_->SignalSemaphore();
 }
 
+void WorkerThread::UpdateWorkInterval() {
+  if (!adaptive_) {
+    return;
+  }
+
+  // Work that was queued while the delegate ran is picked up promptly, even if
+  // this call found nothing to do.
+  if (reset_interval_.exchange(false) || work_result_ == WorkResult::kDidWork) {
+    work_interval_ = minimum_interval_;
+  } else {
+    work_interval_ = std::min(work_interval_ * 2, maximum_interval_);
+  }
+}
+
 }  // namespace crashpad
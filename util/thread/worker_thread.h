@@ -28,6 +28,12 @@ class WorkerThreadImpl;
 
 //! \brief A WorkerThread executes its Delegate's DoWork method repeatedly on a
 //!     dedicated thread at a set time interval.
+//!
+//! By default, the interval is fixed. With SetAdaptiveInterval(), the interval
+//! instead adapts to the results that the delegate reports with
+//! SetWorkResult(), shortening while there is work to do and backing off
+//! while there isn’t. With SetWakeupAlignment(), wakeups are aligned so that
+//! worker threads sharing an alignment wake together.
 class WorkerThread {
  public:
   //! \brief An interface for doing work on a WorkerThread.
@@ -41,9 +47,36 @@ class WorkerThread {
     virtual ~Delegate() {}
   };
 
+  //! \brief The outcome of a call to Delegate::DoWork(), reported with
+  //!     SetWorkResult().
+  enum class WorkResult {
+    //! \brief Work was done, and more may be waiting.
+    //!
+    //! With an adaptive interval, the next call follows the minimum interval.
+    //! This is the result assumed when the delegate reports none.
+    kDidWork,
+
+    //! \brief There was no work to do.
+    //!
+    //! With an adaptive interval, the interval doubles, up to its maximum.
+    kIdle,
+
+    //! \brief Work failed, and should be retried later.
+    //!
+    //! With an adaptive interval, the interval doubles, up to its maximum.
+    kFailed,
+  };
+
   //! \brief A delay or interval argument that causes an indefinite wait.
   static constexpr double kIndefiniteWait = Semaphore::kIndefiniteWait;
 
+  //! \brief A wakeup alignment, in seconds, suitable for SetWakeupAlignment().
+  //!
+  //! Worker threads that use the same alignment wake at the same times, so
+  //! using this value for every worker thread in a process lets their
+  //! wakeups coalesce.
+  static constexpr double kDefaultWakeupAlignment = 60;
+
   //! \brief Creates a new WorkerThread that is not yet running.
   //!
   //! \param[in] work_interval The time interval in seconds at which the \a
@@ -59,6 +92,42 @@ class WorkerThread {
 
   ~WorkerThread();
 
+  //! \brief Schedules work adaptively rather than at a fixed interval.
+  //!
+  //! The interval starts at \a minimum_interval. After each call to
+  //! Delegate::DoWork(), it is reset to \a minimum_interval if the delegate
+  //! reported WorkResult::kDidWork, and doubled, up to \a maximum_interval,
+  //! otherwise. DoWorkNow() also resets it to \a minimum_interval. The \a
+  //! work_interval given to the constructor is not used.
+  //!
+  //! This may not be called if the thread is_running().
+  //!
+  //! \param[in] minimum_interval The shortest interval in seconds, which must
+  //!     be greater than `0`.
+  //! \param[in] maximum_interval The longest interval in seconds, which must be
+  //!     at least \a minimum_interval. This may be #kIndefiniteWait.
+  void SetAdaptiveInterval(double minimum_interval, double maximum_interval);
+
+  //! \brief Aligns the times at which the worker thread wakes to do work.
+  //!
+  //! When set, each wait for an interval is extended so that it ends at the
+  //! next multiple of \a alignment seconds on the monotonic clock. Worker
+  //! threads with the same alignment, including those in other processes,
+  //! then wake together rather than separately. Waits that end early because
+  //! of DoWorkNow() or Stop() are unaffected.
+  //!
+  //! This may not be called if the thread is_running().
+  //!
+  //! \param[in] alignment The alignment in seconds, or `0` for none.
+  //!     #kDefaultWakeupAlignment is a reasonable choice.
+  void SetWakeupAlignment(double alignment);
+
+  //! \brief Reports the outcome of the current call to Delegate::DoWork().
+  //!
+  //! This may only be called from within Delegate::DoWork(). It is only
+  //! consulted with an adaptive interval.
+  void SetWorkResult(WorkResult result);
+
   //! \brief Starts the worker thread.
   //!
   //! This may not be called if the thread is_running().
@@ -89,14 +158,30 @@ class WorkerThread {
   //! \return `true` if the thread is running, `false` if it is not.
   bool is_running() const { return running_; }
 
+  //! \return The interval in seconds that the thread will wait after the
+  //!     current call to Delegate::DoWork(), before any wakeup alignment. With
+  //!     an adaptive interval, this reflects the results reported for previous
+  //!     calls. This may only be called from within Delegate::DoWork().
+  double work_interval() const { return work_interval_; }
+
  private:
   friend class internal::WorkerThreadImpl;
 
+  // Updates work_interval_ from work_result_ on behalf of
+  // internal::WorkerThreadImpl after a call to Delegate::DoWork().
+  void UpdateWorkInterval();
+
   double work_interval_;
+  double minimum_interval_;
+  double maximum_interval_;
+  double wakeup_alignment_;
   Delegate* delegate_;  // weak
   std::unique_ptr<internal::WorkerThreadImpl> impl_;
+  WorkResult work_result_;
   bool running_;
+  bool adaptive_;
   std::atomic_bool do_work_now_;
+  std::atomic_bool reset_interval_;
 };
 
 }  // namespace crashpad
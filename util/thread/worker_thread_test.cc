@@ -14,6 +14,8 @@
 
 #include "util/thread/worker_thread.h"
 
+#include <vector>
+
 #include "build/build_config.h"
 #include "gtest/gtest.h"
 #include "util/misc/clock.h"
@@ -159,6 +161,100 @@ TEST(WorkerThread, DoWorkNowAtStart) {
   EXPECT_FALSE(thread.is_running());
 }
 
+// Reports a scripted sequence of results, and records the interval that the
+// thread has waited before each call.
+class AdaptiveWorkDelegate : public WorkerThread::Delegate {
+ public:
+  explicit AdaptiveWorkDelegate(
+      const std::vector<WorkerThread::WorkResult>& results)
+      : results_(results) {}
+
+  AdaptiveWorkDelegate(const AdaptiveWorkDelegate&) = delete;
+  AdaptiveWorkDelegate& operator=(const AdaptiveWorkDelegate&) = delete;
+
+  ~AdaptiveWorkDelegate() {}
+
+  void DoWork(const WorkerThread* thread) override {
+    if (intervals_.size() == results_.size()) {
+      return;
+    }
+    intervals_.push_back(thread->work_interval());
+    thread_->SetWorkResult(results_[intervals_.size() - 1]);
+    if (intervals_.size() == results_.size()) {
+      semaphore_.Signal();
+    }
+  }
+
+  void set_thread(WorkerThread* thread) { thread_ = thread; }
+
+  void WaitForResults() { semaphore_.Wait(); }
+
+  const std::vector<double>& intervals() const { return intervals_; }
+
+ private:
+  Semaphore semaphore_{0};
+  std::vector<WorkerThread::WorkResult> results_;
+  std::vector<double> intervals_;
+  WorkerThread* thread_ = nullptr;  // weak
+};
+
+TEST(WorkerThread, AdaptiveInterval) {
+  AdaptiveWorkDelegate delegate({WorkerThread::WorkResult::kIdle,
+                                 WorkerThread::WorkResult::kFailed,
+                                 WorkerThread::WorkResult::kIdle,
+                                 WorkerThread::WorkResult::kDidWork,
+                                 WorkerThread::WorkResult::kIdle,
+                                 WorkerThread::WorkResult::kIdle});
+  WorkerThread thread(100, &delegate);
+  delegate.set_thread(&thread);
+  thread.SetAdaptiveInterval(0.001, 0.004);
+
+  thread.Start(0);
+  delegate.WaitForResults();
+  thread.Stop();
+
+  // Each call sees the interval that followed the previous call’s result:
+  // idle and failed results back off up to the maximum, and doing work resets
+  // to the minimum.
+  const std::vector<double> expected = {
+      0.001, 0.002, 0.004, 0.004, 0.001, 0.002};
+  EXPECT_EQ(delegate.intervals(), expected);
+}
+
+TEST(WorkerThread, AdaptiveIntervalDoWorkNow) {
+  AdaptiveWorkDelegate delegate({WorkerThread::WorkResult::kIdle,
+                                 WorkerThread::WorkResult::kIdle});
+  WorkerThread thread(100, &delegate);
+  delegate.set_thread(&thread);
+  thread.SetAdaptiveInterval(100, WorkerThread::kIndefiniteWait);
+
+  uint64_t start = ClockMonotonicNanoseconds();
+
+  thread.Start(100);
+  thread.DoWorkNow();
+  thread.DoWorkNow();
+  delegate.WaitForResults();
+  thread.Stop();
+
+  // DoWorkNow() runs the delegate without waiting, and resets the interval to
+  // the minimum even though the delegate found nothing to do.
+  const std::vector<double> expected = {100, 100};
+  EXPECT_EQ(delegate.intervals(), expected);
+  EXPECT_GE(100 * kNanosecondsPerSecond, ClockMonotonicNanoseconds() - start);
+}
+
+TEST(WorkerThread, WakeupAlignment) {
+  WorkDelegate delegate;
+  WorkerThread thread(0.01, &delegate);
+  thread.SetWakeupAlignment(0.05);
+
+  delegate.SetDesiredWorkCount(3);
+  thread.Start(0);
+  delegate.WaitForWorkCount();
+  thread.Stop();
+  EXPECT_GE(delegate.work_count(), 3);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace crashpad
@@ -18,7 +18,9 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <condition_variable>
 #include <iterator>
+#include <mutex>
 #include <utility>
 
 #include "base/check.h"
@@ -63,6 +65,84 @@ HANDLE DuplicateEvent(HANDLE process, HANDLE event) {
 
 namespace internal {
 
+//! \brief Decides when dump requests may be passed to the delegate.
+//!
+//! This object is shared by all clients and is accessed from threadpool
+//! threads, so all of its state is guarded by its own lock.
+class CaptureAdmission {
+ public:
+  CaptureAdmission()
+      : mutex_(),
+        condition_(),
+        max_captures_(0),
+        active_captures_(0),
+        waiting_crash_captures_(0) {}
+
+  CaptureAdmission(const CaptureAdmission&) = delete;
+  CaptureAdmission& operator=(const CaptureAdmission&) = delete;
+
+  ~CaptureAdmission() = default;
+
+  void SetMaxCaptures(size_t max_captures) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      max_captures_ = max_captures;
+    }
+    condition_.notify_all();
+  }
+
+  //! \brief Waits until a crash dump may be captured.
+  //!
+  //! Crash dumps are never rejected. Each call must be balanced by a call to
+  //! Release().
+  void AcquireForCrash() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiting_crash_captures_;
+    condition_.wait(lock, [this] { return HasCapacity(); });
+    --waiting_crash_captures_;
+    ++active_captures_;
+  }
+
+  //! \brief Waits until a non-crash dump may be captured, behind any crash
+  //!     dumps.
+  //!
+  //! \return `true` if the dump may be captured, in which case the call must
+  //!     be balanced by a call to Release(). `false` if the dump was rejected
+  //!     because crash dumps are waiting to be captured.
+  bool AcquireForNonCrash() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (max_captures_ != 0 && waiting_crash_captures_ != 0) {
+      return false;
+    }
+    condition_.wait(lock, [this] {
+      return HasCapacity() && waiting_crash_captures_ == 0;
+    });
+    ++active_captures_;
+    return true;
+  }
+
+  void Release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      DCHECK_GT(active_captures_, 0u);
+      --active_captures_;
+    }
+    condition_.notify_all();
+  }
+
+ private:
+  // mutex_ must be held.
+  bool HasCapacity() const {
+    return max_captures_ == 0 || active_captures_ < max_captures_;
+  }
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  size_t max_captures_;
+  size_t active_captures_;
+  size_t waiting_crash_captures_;
+};
+
 //! \brief Context information for the named pipe handler threads.
 class PipeServiceContext {
  public:
@@ -71,12 +151,14 @@ class PipeServiceContext {
                      ExceptionHandlerServer::Delegate* delegate,
                      base::Lock* clients_lock,
                      std::set<internal::ClientData*>* clients,
+                     CaptureAdmission* capture_admission,
                      uint64_t shutdown_token)
       : port_(port),
         pipe_(pipe),
         delegate_(delegate),
         clients_lock_(clients_lock),
         clients_(clients),
+        capture_admission_(capture_admission),
         shutdown_token_(shutdown_token) {}
 
   PipeServiceContext(const PipeServiceContext&) = delete;
@@ -87,6 +169,7 @@ class PipeServiceContext {
   ExceptionHandlerServer::Delegate* delegate() const { return delegate_; }
   base::Lock* clients_lock() const { return clients_lock_; }
   std::set<internal::ClientData*>* clients() const { return clients_; }
+  CaptureAdmission* capture_admission() const { return capture_admission_; }
   uint64_t shutdown_token() const { return shutdown_token_; }
 
  private:
@@ -95,6 +178,7 @@ class PipeServiceContext {
   ExceptionHandlerServer::Delegate* delegate_;  // weak
   base::Lock* clients_lock_;  // weak
   std::set<internal::ClientData*>* clients_;  // weak
+  CaptureAdmission* capture_admission_;  // weak
   uint64_t shutdown_token_;
 };
 
@@ -107,6 +191,7 @@ class ClientData {
  public:
   ClientData(HANDLE port,
              ExceptionHandlerServer::Delegate* delegate,
+             CaptureAdmission* capture_admission,
              ScopedKernelHANDLE process,
              ScopedKernelHANDLE crash_dump_requested_event,
              ScopedKernelHANDLE non_crash_dump_requested_event,
@@ -123,6 +208,7 @@ class ClientData {
         lock_(),
         port_(port),
         delegate_(delegate),
+        capture_admission_(capture_admission),
         crash_dump_requested_event_(std::move(crash_dump_requested_event)),
         non_crash_dump_requested_event_(
             std::move(non_crash_dump_requested_event)),
@@ -152,6 +238,7 @@ class ClientData {
   base::Lock* lock() { return &lock_; }
   HANDLE port() const { return port_; }
   ExceptionHandlerServer::Delegate* delegate() const { return delegate_; }
+  CaptureAdmission* capture_admission() const { return capture_admission_; }
   HANDLE crash_dump_requested_event() const {
     return crash_dump_requested_event_.get();
   }
@@ -182,7 +269,7 @@ class ClientData {
                                      crash_dump_request_callback,
                                      this,
                                      INFINITE,
-                                     WT_EXECUTEDEFAULT)) {
+                                     WT_EXECUTELONGFUNCTION)) {
       LOG(ERROR) << "RegisterWaitForSingleObject crash dump requested";
     }
 
@@ -191,7 +278,7 @@ class ClientData {
                                      non_crash_dump_request_callback,
                                      this,
                                      INFINITE,
-                                     WT_EXECUTEDEFAULT)) {
+                                     WT_EXECUTELONGFUNCTION)) {
       LOG(ERROR) << "RegisterWaitForSingleObject non-crash dump requested";
     }
 
@@ -228,6 +315,7 @@ class ClientData {
   // Access to these fields must be guarded by lock_.
   HANDLE port_;  // weak
   ExceptionHandlerServer::Delegate* delegate_;  // weak
+  CaptureAdmission* capture_admission_;  // weak
   ScopedKernelHANDLE crash_dump_requested_event_;
   ScopedKernelHANDLE non_crash_dump_requested_event_;
   ScopedKernelHANDLE non_crash_dump_completed_event_;
@@ -248,12 +336,18 @@ ExceptionHandlerServer::ExceptionHandlerServer(bool persistent)
       first_pipe_instance_(),
       clients_lock_(),
       clients_(),
+      capture_admission_(std::make_unique<internal::CaptureAdmission>()),
       persistent_(persistent) {
 }
 
 ExceptionHandlerServer::~ExceptionHandlerServer() {
 }
 
+void ExceptionHandlerServer::SetMaxConcurrentDumps(
+    size_t max_concurrent_dumps) {
+  capture_admission_->SetMaxCaptures(max_concurrent_dumps);
+}
+
 void ExceptionHandlerServer::SetPipeName(const std::wstring& pipe_name) {
   DCHECK(pipe_name_.empty());
   DCHECK(!pipe_name.empty());
@@ -290,6 +384,7 @@ void ExceptionHandlerServer::InitializeWithInheritedDataForInitialClient(
     internal::ClientData* client = new internal::ClientData(
         port_.get(),
         delegate,
+        capture_admission_.get(),
         ScopedKernelHANDLE(initial_client_data.client_process()),
         ScopedKernelHANDLE(initial_client_data.request_crash_dump()),
         ScopedKernelHANDLE(initial_client_data.request_non_crash_dump()),
@@ -325,6 +420,7 @@ void ExceptionHandlerServer::Run(Delegate* delegate) {
                                          delegate,
                                          &clients_lock_,
                                          &clients_,
+                                         capture_admission_.get(),
                                          shutdown_token);
     thread_handles[i].reset(
         CreateThread(nullptr, 0, &PipeServiceProc, context, 0, nullptr));
@@ -480,6 +576,7 @@ bool ExceptionHandlerServer::ServiceClientConnection(
     client = new internal::ClientData(
         service_context.port(),
         service_context.delegate(),
+        service_context.capture_admission(),
         ScopedKernelHANDLE(client_process),
         ScopedKernelHANDLE(
             CreateEvent(nullptr, false /* auto reset */, false, nullptr)),
@@ -542,10 +639,12 @@ void __stdcall ExceptionHandlerServer::OnCrashDumpEvent(void* ctx, BOOLEAN) {
   base::AutoLock lock(*client->lock());
 
   // Capture the exception.
+  client->capture_admission()->AcquireForCrash();
   unsigned int exit_code = client->delegate()->ExceptionHandlerServerException(
       client->process(),
       client->crash_exception_information_address(),
       client->debug_critical_section_address());
+  client->capture_admission()->Release();
 
   SafeTerminateProcess(client->process(), exit_code);
 }
@@ -556,11 +655,17 @@ void __stdcall ExceptionHandlerServer::OnNonCrashDumpEvent(void* ctx, BOOLEAN) {
   internal::ClientData* client = reinterpret_cast<internal::ClientData*>(ctx);
   base::AutoLock lock(*client->lock());
 
-  // Capture the exception.
-  client->delegate()->ExceptionHandlerServerException(
-      client->process(),
-      client->non_crash_exception_information_address(),
-      client->debug_critical_section_address());
+  // Capture the exception, unless crashes are waiting to be captured. The
+  // client is released either way.
+  if (client->capture_admission()->AcquireForNonCrash()) {
+    client->delegate()->ExceptionHandlerServerException(
+        client->process(),
+        client->non_crash_exception_information_address(),
+        client->debug_critical_section_address());
+    client->capture_admission()->Release();
+  } else {
+    LOG(WARNING) << "non-crash dump rejected, handler saturated";
+  }
 
   bool result = !!SetEvent(client->non_crash_dump_completed_event());
   PLOG_IF(ERROR, !result) << "SetEvent";
@@ -15,6 +15,7 @@
 #ifndef CRASHPAD_UTIL_WIN_EXCEPTION_HANDLER_SERVER_H_
 #define CRASHPAD_UTIL_WIN_EXCEPTION_HANDLER_SERVER_H_
 
+#include <memory>
 #include <set>
 #include <string>
 
@@ -27,6 +28,7 @@
 namespace crashpad {
 
 namespace internal {
+class CaptureAdmission;
 class PipeServiceContext;
 class ClientData;
 }  // namespace internal
@@ -103,6 +105,24 @@ class ExceptionHandlerServer {
       const InitialClientData& initial_client_data,
       Delegate* delegate);
 
+  //! \brief Limits the number of dump requests passed to the delegate at once.
+  //!
+  //! By default, every dump request is passed to the delegate as soon as it
+  //! arrives, so that clients that crash together are captured in parallel,
+  //! limited only by the system thread pool. When \a max_concurrent_dumps is
+  //! nonzero, at most that many requests are handled at a time, and the rest
+  //! wait for a capture to finish. Crash dump requests are admitted ahead of
+  //! waiting non-crash dump requests, and a non-crash dump request that
+  //! arrives while crash dump requests are waiting is rejected immediately,
+  //! without a dump being taken, so that its client is not held up. Requests
+  //! from a single client are always handled one at a time.
+  //!
+  //! This method may be called before or during Run().
+  //!
+  //! \param[in] max_concurrent_dumps The maximum number of dump requests to
+  //!     handle at once, or `0` for no limit.
+  void SetMaxConcurrentDumps(size_t max_concurrent_dumps);
+
   //! \brief Runs the exception-handling server.
   //!
   //! \param[in] delegate The interface to which the exceptions are delegated
@@ -132,6 +152,8 @@ class ExceptionHandlerServer {
   base::Lock clients_lock_;
   std::set<internal::ClientData*> clients_;
 
+  std::unique_ptr<internal::CaptureAdmission> capture_admission_;
+
   bool persistent_;
 };
 
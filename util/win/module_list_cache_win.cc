@@ -0,0 +1,69 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/module_list_cache_win.h"
+
+namespace crashpad {
+
+ModuleListCacheWin::ModuleListCacheWin(size_t max_entries)
+    : lock_(), entries_(), max_entries_(max_entries), next_sequence_(0) {}
+
+ModuleListCacheWin::~ModuleListCacheWin() = default;
+
+bool ModuleListCacheWin::Lookup(
+    ProcessID process_id,
+    uint64_t fingerprint,
+    std::vector<ProcessInfo::Module>* modules) const {
+  base::AutoLock lock(lock_);
+  auto iter = entries_.find(process_id);
+  if (iter == entries_.end() || iter->second.fingerprint != fingerprint) {
+    return false;
+  }
+  *modules = iter->second.modules;
+  return true;
+}
+
+void ModuleListCacheWin::Insert(
+    ProcessID process_id,
+    uint64_t fingerprint,
+    const std::vector<ProcessInfo::Module>& modules) {
+  base::AutoLock lock(lock_);
+  if (max_entries_ == 0) {
+    return;
+  }
+
+  auto iter = entries_.find(process_id);
+  if (iter == entries_.end() && entries_.size() >= max_entries_) {
+    auto oldest = entries_.begin();
+    for (auto candidate = entries_.begin(); candidate != entries_.end();
+         ++candidate) {
+      if (candidate->second.sequence < oldest->second.sequence) {
+        oldest = candidate;
+      }
+    }
+    entries_.erase(oldest);
+  }
+
+  Entry& entry = entries_[process_id];
+  entry.modules = modules;
+  entry.fingerprint = fingerprint;
+  entry.sequence = next_sequence_++;
+}
+
+size_t ModuleListCacheWin::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace crashpad
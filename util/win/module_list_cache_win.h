@@ -0,0 +1,102 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_WIN_MODULE_LIST_CACHE_WIN_H_
+#define CRASHPAD_UTIL_WIN_MODULE_LIST_CACHE_WIN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "util/process/process_id.h"
+#include "util/win/process_info.h"
+
+namespace crashpad {
+
+//! \brief Retains the module lists of processes across ProcessInfo objects.
+//!
+//! ProcessInfo locates a process’ modules by walking the loader’s list in the
+//! Process Environment Block, reading an `LDR_DATA_TABLE_ENTRY` and a name for
+//! each module. A process that is dumped repeatedly, for example to sample a
+//! hang, usually has the same modules each time, and a process with hundreds of
+//! modules makes the walk a significant part of each capture. This cache lets a
+//! later ProcessInfo for the same process reuse the list.
+//!
+//! Entries are keyed by process ID and validated by a fingerprint that
+//! ProcessInfo computes from the process’ creation time, the ends of the
+//! loader’s list, and the base and size of every image mapped into the
+//! process, so that an entry is only used while the same modules are loaded
+//! at the same addresses.
+//!
+//! This class is thread-safe.
+class ModuleListCacheWin {
+ public:
+  //! \brief The default value for \a max_entries in the constructor.
+  static constexpr size_t kDefaultMaxEntries = 64;
+
+  //! \param[in] max_entries The maximum number of processes to retain. Once
+  //!     full, adding a new process evicts the one that was added least
+  //!     recently.
+  explicit ModuleListCacheWin(size_t max_entries = kDefaultMaxEntries);
+
+  ModuleListCacheWin(const ModuleListCacheWin&) = delete;
+  ModuleListCacheWin& operator=(const ModuleListCacheWin&) = delete;
+
+  ~ModuleListCacheWin();
+
+  //! \brief Looks up the modules of a process.
+  //!
+  //! \param[in] process_id The process ID.
+  //! \param[in] fingerprint The process’ current module fingerprint.
+  //! \param[out] modules The cached modules, valid if this method returns
+  //!     `true`.
+  //! \return `true` if the process was found in the cache with the same
+  //!     fingerprint.
+  bool Lookup(ProcessID process_id,
+              uint64_t fingerprint,
+              std::vector<ProcessInfo::Module>* modules) const;
+
+  //! \brief Adds the modules of a process to the cache, replacing any
+  //!     existing entry for it.
+  //!
+  //! \param[in] process_id The process ID.
+  //! \param[in] fingerprint The process’ module fingerprint at the time
+  //!     \a modules were read.
+  //! \param[in] modules The modules to cache.
+  void Insert(ProcessID process_id,
+              uint64_t fingerprint,
+              const std::vector<ProcessInfo::Module>& modules);
+
+  //! \brief Returns the number of processes in the cache.
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::vector<ProcessInfo::Module> modules;
+    uint64_t fingerprint;
+    uint64_t sequence;
+  };
+
+  mutable base::Lock lock_;
+  std::map<ProcessID, Entry> entries_;
+  size_t max_entries_;
+  uint64_t next_sequence_;
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_WIN_MODULE_LIST_CACHE_WIN_H_
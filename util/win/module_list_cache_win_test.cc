@@ -0,0 +1,87 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/module_list_cache_win.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace crashpad {
+namespace test {
+namespace {
+
+std::vector<ProcessInfo::Module> MakeModules(const std::wstring& name) {
+  std::vector<ProcessInfo::Module> modules(2);
+  modules[0].name = name;
+  modules[0].dll_base = 0x400000;
+  modules[0].size = 0x10000;
+  modules[0].timestamp = 1;
+  modules[1].name = L"C:\\Windows\\System32\\ntdll.dll";
+  modules[1].dll_base = 0x7ff000000000;
+  modules[1].size = 0x200000;
+  modules[1].timestamp = 2;
+  return modules;
+}
+
+TEST(ModuleListCacheWin, LookupAndInsert) {
+  ModuleListCacheWin cache;
+  std::vector<ProcessInfo::Module> modules;
+  EXPECT_FALSE(cache.Lookup(100, 1, &modules));
+
+  cache.Insert(100, 1, MakeModules(L"exe.exe"));
+  EXPECT_EQ(cache.size(), 1u);
+
+  ASSERT_TRUE(cache.Lookup(100, 1, &modules));
+  ASSERT_EQ(modules.size(), 2u);
+  EXPECT_EQ(modules[0].name, L"exe.exe");
+  EXPECT_EQ(modules[0].dll_base, 0x400000u);
+  EXPECT_EQ(modules[0].size, 0x10000u);
+  EXPECT_EQ(modules[0].timestamp, 1);
+  EXPECT_EQ(modules[1].name, L"C:\\Windows\\System32\\ntdll.dll");
+
+  // Both the process ID and the fingerprint must match.
+  EXPECT_FALSE(cache.Lookup(101, 1, &modules));
+  EXPECT_FALSE(cache.Lookup(100, 2, &modules));
+
+  // Inserting an existing process replaces its entry.
+  cache.Insert(100, 2, MakeModules(L"new_exe.exe"));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_FALSE(cache.Lookup(100, 1, &modules));
+  ASSERT_TRUE(cache.Lookup(100, 2, &modules));
+  EXPECT_EQ(modules[0].name, L"new_exe.exe");
+}
+
+TEST(ModuleListCacheWin, MaxEntries) {
+  ModuleListCacheWin cache(2);
+  std::vector<ProcessInfo::Module> modules;
+  cache.Insert(1, 1, MakeModules(L"a.exe"));
+  cache.Insert(2, 1, MakeModules(L"b.exe"));
+
+  // Replacing an entry makes it the most recently added.
+  cache.Insert(1, 2, MakeModules(L"a.exe"));
+  cache.Insert(3, 1, MakeModules(L"c.exe"));
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_TRUE(cache.Lookup(1, 2, &modules));
+  EXPECT_FALSE(cache.Lookup(2, 1, &modules));
+  EXPECT_TRUE(cache.Lookup(3, 1, &modules));
+
+  ModuleListCacheWin disabled(0);
+  disabled.Insert(1, 1, MakeModules(L"a.exe"));
+  EXPECT_EQ(disabled.size(), 0u);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace crashpad
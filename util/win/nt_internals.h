@@ -22,6 +22,7 @@
 
 // Copied from ntstatus.h because um/winnt.h conflicts with general inclusion of
 // ntstatus.h.
+#define STATUS_INVALID_INFO_CLASS ((NTSTATUS)0xC0000003L)
 #define STATUS_INFO_LENGTH_MISMATCH ((NTSTATUS)0xC0000004L)
 #define STATUS_BUFFER_TOO_SMALL ((NTSTATUS)0xC0000023L)
 #define STATUS_PROCESS_IS_TERMINATING ((NTSTATUS)0xC000010AL)
@@ -46,11 +47,14 @@ NtCreateThreadEx(PHANDLE thread_handle,
                  PVOID /*PPS_ATTRIBUTE_LIST*/ attribute_list);
 
 // winternal.h defines THREADINFOCLASS, but not all members.
-enum { ThreadBasicInformation = 0 };
+enum { ThreadBasicInformation = 0, ThreadSuspendCount = 35 };
 
 // winternal.h defines SYSTEM_INFORMATION_CLASS, but not all members.
 enum { SystemExtendedHandleInformation = 64 };
 
+// winternal.h defines PROCESSINFOCLASS, but not all members.
+enum { ProcessHandleInformation = 51 };
+
 NTSTATUS NtQuerySystemInformation(
     SYSTEM_INFORMATION_CLASS system_information_class,
     PVOID system_information,
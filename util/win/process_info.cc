@@ -15,6 +15,7 @@
 #include "util/win/process_info.h"
 
 #include <stddef.h>
+#include <string.h>
 #include <winternl.h>
 
 #include <algorithm>
@@ -22,6 +23,8 @@
 #include <memory>
 #include <new>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/logging.h"
@@ -30,9 +33,11 @@
 #include "base/strings/stringprintf.h"
 #include "build/build_config.h"
 #include "util/misc/from_pointer_cast.h"
+#include "util/misc/xxhash64.h"
 #include "util/numeric/safe_assignment.h"
 #include "util/win/get_function.h"
 #include "util/win/handle.h"
+#include "util/win/module_list_cache_win.h"
 #include "util/win/nt_internals.h"
 #include "util/win/ntstatus_logging.h"
 #include "util/win/process_structs.h"
@@ -126,6 +131,200 @@ bool ReadStruct(HANDLE process, WinVMAddress at, T* into) {
   return true;
 }
 
+// Reads from the target process through blocks of up to kPrefetchBlockSize
+// bytes, each within a readable span of the process' memory map, keeping the
+// most recent blocks to satisfy later reads. The loader allocates its
+// LDR_DATA_TABLE_ENTRY structures and their name strings from the process
+// heap, mostly close together, so most of the loader's list is found in blocks
+// that have already been read. This replaces a ReadProcessMemory() call for
+// each entry and each name with one for each block.
+class PrefetchingReader {
+ public:
+  PrefetchingReader(
+      HANDLE process,
+      const ProcessInfo::MemoryBasicInformation64Vector& memory_info)
+      : blocks_(),
+        process_(process),
+        memory_info_(memory_info),
+        next_block_(0) {}
+
+  PrefetchingReader(const PrefetchingReader&) = delete;
+  PrefetchingReader& operator=(const PrefetchingReader&) = delete;
+
+  ~PrefetchingReader() = default;
+
+  // Reads size bytes at address into buffer. Returns false on failure, with a
+  // message logged.
+  bool Read(WinVMAddress address, size_t size, void* buffer) {
+    if (size == 0) {
+      return true;
+    }
+    const Block* block = nullptr;
+    for (const Block& candidate : blocks_) {
+      if (address >= candidate.base &&
+          address - candidate.base < candidate.data.size() &&
+          size <= candidate.data.size() - (address - candidate.base)) {
+        block = &candidate;
+        break;
+      }
+    }
+    if (!block && size <= kPrefetchBlockSize) {
+      block = ReadBlock(address, size);
+    }
+    if (block) {
+      memcpy(buffer,
+             &block->data[static_cast<size_t>(address - block->base)],
+             size);
+      return true;
+    }
+
+    // The memory map may be out of date, or what's being read may not fit in
+    // a block, so read it alone.
+    SIZE_T bytes_read;
+    if (!ReadProcessMemory(process_,
+                           reinterpret_cast<const void*>(address),
+                           buffer,
+                           size,
+                           &bytes_read)) {
+      PLOG(ERROR) << "ReadProcessMemory";
+      return false;
+    }
+    if (bytes_read != size) {
+      LOG(ERROR) << "ReadProcessMemory incorrect size";
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  // The same limits that ProcessMemoryWin uses to combine reads.
+  static constexpr WinVMSize kPrefetchBlockSize = 64 * 1024;
+  static constexpr WinVMAddress kPrefetchBlockAlignment = 4096;
+  static constexpr size_t kMaxBlocks = 8;
+
+  struct Block {
+    WinVMAddress base;
+    std::vector<char> data;
+  };
+
+  // Reads and returns a block holding the size bytes at address, starting at
+  // the page that holds address and extending as far as kPrefetchBlockSize
+  // allows within the readable span. Some earlier entries are often within
+  // the page, but most lie beyond it. The block replaces the oldest. Returns
+  // nullptr if the memory map doesn't show the bytes as readable, or if the
+  // block can't be read.
+  const Block* ReadBlock(WinVMAddress address, size_t size) {
+    const WinVMAddress block_begin = address & ~(kPrefetchBlockAlignment - 1);
+    const WinVMSize block_size =
+        std::min(kPrefetchBlockSize,
+                 std::numeric_limits<WinVMAddress>::max() - block_begin);
+    const auto readable = GetReadableRangesOfMemoryMap(
+        CheckedRange<WinVMAddress, WinVMSize>(block_begin, block_size),
+        memory_info_);
+    for (const auto& range : readable) {
+      if (address < range.base() || address >= range.end()) {
+        continue;
+      }
+      if (size > range.end() - address) {
+        return nullptr;
+      }
+
+      Block block;
+      block.base = range.base();
+      block.data.resize(static_cast<size_t>(range.size()));
+      SIZE_T bytes_read;
+      if (!ReadProcessMemory(process_,
+                             reinterpret_cast<const void*>(block.base),
+                             block.data.data(),
+                             block.data.size(),
+                             &bytes_read) ||
+          bytes_read != block.data.size()) {
+        return nullptr;
+      }
+
+      if (blocks_.size() < kMaxBlocks) {
+        blocks_.push_back(std::move(block));
+        return &blocks_.back();
+      }
+      Block* replaced = &blocks_[next_block_];
+      *replaced = std::move(block);
+      next_block_ = (next_block_ + 1) % kMaxBlocks;
+      return replaced;
+    }
+    return nullptr;
+  }
+
+  std::vector<Block> blocks_;
+  HANDLE process_;
+  const ProcessInfo::MemoryBasicInformation64Vector& memory_info_;
+  size_t next_block_;
+};
+
+template <class T>
+bool ReadStruct(PrefetchingReader* reader, WinVMAddress at, T* into) {
+  return reader->Read(at, sizeof(T), into);
+}
+
+template <class T>
+bool ReadUnicodeString(PrefetchingReader* reader,
+                       const process_types::UNICODE_STRING<T>& us,
+                       std::wstring* result) {
+  DCHECK_EQ(us.Length % sizeof(wchar_t), 0u);
+  result->resize(us.Length / sizeof(wchar_t));
+  return reader->Read(us.Buffer, us.Length, result->data());
+}
+
+// Computes the fingerprint that validates a process' entry in a
+// ModuleListCacheWin. It covers the process' creation time, so that a reused
+// process ID doesn't match, the ends of the loader's list, and the base and
+// size of each image allocation, which change when a module is loaded or
+// unloaded. Returns false if the creation time can't be determined.
+bool ModuleListFingerprint(
+    HANDLE process,
+    WinVMAddress list_flink,
+    WinVMAddress list_blink,
+    const ProcessInfo::MemoryBasicInformation64Vector& memory_info,
+    uint64_t* fingerprint) {
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetProcessTimes(
+          process, &creation_time, &exit_time, &kernel_time, &user_time)) {
+    PLOG(ERROR) << "GetProcessTimes";
+    return false;
+  }
+
+  XXHash64 hash;
+  hash.Update(&creation_time, sizeof(creation_time));
+  hash.Update(&list_flink, sizeof(list_flink));
+  hash.Update(&list_blink, sizeof(list_blink));
+
+  // An image's regions are adjacent in the memory map. Their sizes are
+  // summed, so that changing the protection of part of an image, which splits
+  // its regions, doesn't change the fingerprint.
+  WinVMAddress allocation_base = 0;
+  WinVMSize allocation_size = 0;
+  for (const MEMORY_BASIC_INFORMATION64& region : memory_info) {
+    if (region.Type != MEM_IMAGE) {
+      continue;
+    }
+    if (region.AllocationBase != allocation_base) {
+      if (allocation_size != 0) {
+        hash.Update(&allocation_base, sizeof(allocation_base));
+        hash.Update(&allocation_size, sizeof(allocation_size));
+      }
+      allocation_base = region.AllocationBase;
+      allocation_size = 0;
+    }
+    allocation_size += region.RegionSize;
+  }
+  if (allocation_size != 0) {
+    hash.Update(&allocation_base, sizeof(allocation_base));
+    hash.Update(&allocation_size, sizeof(allocation_size));
+  }
+
+  *fingerprint = hash.Digest();
+  return true;
+}
+
 bool RegionIsAccessible(const MEMORY_BASIC_INFORMATION64& memory_info) {
   return memory_info.State == MEM_COMMIT &&
          (memory_info.Protect & PAGE_NOACCESS) == 0 &&
@@ -178,6 +377,153 @@ std::unique_ptr<uint8_t[]> QueryObject(
   return buffer;
 }
 
+// A handle in the target process, as reported by the kernel before it is
+// examined further.
+struct HandleEntry {
+  HANDLE handle_value;
+  uint32_t attributes;
+  uint32_t granted_access;
+  uint32_t pointer_count;
+  uint32_t handle_count;
+
+  // Whether pointer_count and handle_count were reported.
+  bool has_counts;
+};
+
+// Lists the handles of process alone with ProcessHandleInformation. This is
+// only supported on Windows 8 and later, and is much cheaper than listing
+// every handle in the system. If unsupported is true, the query isn’t made,
+// and the result is as though the kernel didn’t support it.
+bool EnumerateProcessHandles(HANDLE process,
+                             bool unsupported,
+                             std::vector<HandleEntry>* entries) {
+  ULONG buffer_size = 64 * 1024;
+  NTSTATUS status;
+  ULONG returned_length = 0;
+  UniqueMallocPtr buffer;
+  for (int tries = 0; tries < 5; ++tries) {
+    buffer.reset();
+    buffer = UncheckedAllocate(buffer_size);
+    if (!buffer) {
+      LOG(ERROR) << "UncheckedAllocate";
+      return false;
+    }
+
+    status = unsupported
+                 ? STATUS_INVALID_INFO_CLASS
+                 : crashpad::NtQueryInformationProcess(
+                       process,
+                       static_cast<PROCESSINFOCLASS>(ProcessHandleInformation),
+                       buffer.get(),
+                       buffer_size,
+                       &returned_length);
+    if (NT_SUCCESS(status) || status != STATUS_INFO_LENGTH_MISMATCH)
+      break;
+
+    // The process may open more handles before the next attempt, so leave
+    // some room beyond the size that was reported.
+    buffer_size = std::max(buffer_size * 2, returned_length + 4096);
+  }
+
+  if (!NT_SUCCESS(status)) {
+    // STATUS_INVALID_INFO_CLASS is expected before Windows 8, where the
+    // caller falls back to the system-wide list.
+    if (status != STATUS_INVALID_INFO_CLASS) {
+      NTSTATUS_LOG(WARNING, status)
+          << "NtQueryInformationProcess ProcessHandleInformation";
+    }
+    return false;
+  }
+
+  const auto& process_handle_information =
+      *reinterpret_cast<process_types::PROCESS_HANDLE_SNAPSHOT_INFORMATION*>(
+          buffer.get());
+
+  DCHECK_LE(
+      offsetof(process_types::PROCESS_HANDLE_SNAPSHOT_INFORMATION, Handles) +
+          process_handle_information.NumberOfHandles *
+              sizeof(process_handle_information.Handles[0]),
+      returned_length);
+
+  entries->clear();
+  entries->reserve(process_handle_information.NumberOfHandles);
+  for (size_t i = 0; i < process_handle_information.NumberOfHandles; ++i) {
+    const auto& handle = process_handle_information.Handles[i];
+    HandleEntry entry;
+    entry.handle_value = handle.HandleValue;
+    entry.attributes = handle.HandleAttributes;
+    entry.granted_access = handle.GrantedAccess;
+    entry.pointer_count = static_cast<uint32_t>(handle.PointerCount);
+    entry.handle_count = static_cast<uint32_t>(handle.HandleCount);
+    entry.has_counts = true;
+    entries->push_back(entry);
+  }
+  return true;
+}
+
+// Lists the handles of the process with ID process_id by listing every handle
+// in the system with SystemExtendedHandleInformation.
+bool EnumerateSystemHandles(crashpad::ProcessID process_id,
+                            std::vector<HandleEntry>* entries) {
+  ULONG buffer_size = 2 * 1024 * 1024;
+  // Typically if the buffer were too small, STATUS_INFO_LENGTH_MISMATCH would
+  // return the correct size in the final argument, but it does not for
+  // SystemExtendedHandleInformation, so we loop and attempt larger sizes.
+  NTSTATUS status;
+  ULONG returned_length;
+  UniqueMallocPtr buffer;
+  for (int tries = 0; tries < 5; ++tries) {
+    buffer.reset();
+    buffer = UncheckedAllocate(buffer_size);
+    if (!buffer) {
+      LOG(ERROR) << "UncheckedAllocate";
+      return false;
+    }
+
+    status = crashpad::NtQuerySystemInformation(
+        static_cast<SYSTEM_INFORMATION_CLASS>(SystemExtendedHandleInformation),
+        buffer.get(),
+        buffer_size,
+        &returned_length);
+    if (NT_SUCCESS(status) || status != STATUS_INFO_LENGTH_MISMATCH)
+      break;
+
+    buffer_size *= 2;
+  }
+
+  if (!NT_SUCCESS(status)) {
+    NTSTATUS_LOG(ERROR, status)
+        << "NtQuerySystemInformation SystemExtendedHandleInformation";
+    return false;
+  }
+
+  const auto& system_handle_information_ex =
+      *reinterpret_cast<process_types::SYSTEM_HANDLE_INFORMATION_EX*>(
+          buffer.get());
+
+  DCHECK_LE(offsetof(process_types::SYSTEM_HANDLE_INFORMATION_EX, Handles) +
+                system_handle_information_ex.NumberOfHandles *
+                    sizeof(system_handle_information_ex.Handles[0]),
+            returned_length);
+
+  entries->clear();
+  for (size_t i = 0; i < system_handle_information_ex.NumberOfHandles; ++i) {
+    const auto& handle = system_handle_information_ex.Handles[i];
+    if (handle.UniqueProcessId != process_id)
+      continue;
+
+    HandleEntry entry;
+    entry.handle_value = handle.HandleValue;
+    entry.attributes = handle.HandleAttributes;
+    entry.granted_access = handle.GrantedAccess;
+    entry.pointer_count = 0;
+    entry.handle_count = 0;
+    entry.has_counts = false;
+    entries->push_back(entry);
+  }
+  return true;
+}
+
 }  // namespace
 
 template <class Traits>
@@ -269,21 +615,38 @@ bool ReadProcessData(HANDLE process,
   if (!ReadStruct(process, peb.Ldr, &peb_ldr_data))
     return false;
 
+  typename Traits::Pointer last = peb_ldr_data.InLoadOrderModuleList.Blink;
+  ModuleListCacheWin* cache = process_info->module_list_cache_;
+  uint64_t fingerprint = 0;
+  if (cache && !ModuleListFingerprint(process,
+                                      peb_ldr_data.InLoadOrderModuleList.Flink,
+                                      last,
+                                      process_info->memory_info_,
+                                      &fingerprint)) {
+    cache = nullptr;
+  }
+  if (cache && cache->Lookup(process_info->process_id_,
+                             fingerprint,
+                             &process_info->modules_)) {
+    return true;
+  }
+
   process_types::LDR_DATA_TABLE_ENTRY<Traits> ldr_data_table_entry;
   ProcessInfo::Module module;
+  PrefetchingReader reader(process, process_info->memory_info_);
+  bool complete = false;
 
   // Walk the PEB LDR structure (doubly-linked list) to get the list of loaded
   // modules. We use this method rather than EnumProcessModules to get the
   // modules in load order rather than memory order. Notably, this includes the
   // main executable as the first element.
-  typename Traits::Pointer last = peb_ldr_data.InLoadOrderModuleList.Blink;
   for (typename Traits::Pointer cur = peb_ldr_data.InLoadOrderModuleList.Flink;;
        cur = ldr_data_table_entry.InLoadOrderLinks.Flink) {
     // |cur| is the pointer to the LIST_ENTRY embedded in the
     // LDR_DATA_TABLE_ENTRY, in the target process's address space. So we need
     // to read from the target, and also offset back to the beginning of the
     // structure.
-    if (!ReadStruct(process,
+    if (!ReadStruct(&reader,
                     static_cast<WinVMAddress>(cur) -
                         offsetof(process_types::LDR_DATA_TABLE_ENTRY<Traits>,
                                  InLoadOrderLinks),
@@ -292,15 +655,24 @@ bool ReadProcessData(HANDLE process,
     }
     // TODO(scottmg): Capture Checksum, etc. too?
     if (!ReadUnicodeString(
-            process, ldr_data_table_entry.FullDllName, &module.name)) {
+            &reader, ldr_data_table_entry.FullDllName, &module.name)) {
       module.name = L"???";
     }
     module.dll_base = ldr_data_table_entry.DllBase;
     module.size = ldr_data_table_entry.SizeOfImage;
     module.timestamp = ldr_data_table_entry.TimeDateStamp;
     process_info->modules_.push_back(module);
-    if (cur == last)
+    if (cur == last) {
+      complete = true;
       break;
+    }
+  }
+
+  // A list that couldn't be read in full is not cached, so that the next
+  // snapshot tries again.
+  if (cache && complete) {
+    cache->Insert(
+        process_info->process_id_, fingerprint, process_info->modules_);
   }
 
   return true;
@@ -346,63 +718,49 @@ bool ReadMemoryInfo(HANDLE process, bool is_64_bit, ProcessInfo* process_info) {
 
 std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
     HANDLE process) const {
-  ULONG buffer_size = 2 * 1024 * 1024;
-  // Typically if the buffer were too small, STATUS_INFO_LENGTH_MISMATCH would
-  // return the correct size in the final argument, but it does not for
-  // SystemExtendedHandleInformation, so we loop and attempt larger sizes.
-  NTSTATUS status;
-  ULONG returned_length;
-  UniqueMallocPtr buffer;
-  for (int tries = 0; tries < 5; ++tries) {
-    buffer.reset();
-    buffer = UncheckedAllocate(buffer_size);
-    if (!buffer) {
-      LOG(ERROR) << "UncheckedAllocate";
-      return std::vector<Handle>();
-    }
-
-    status = crashpad::NtQuerySystemInformation(
-        static_cast<SYSTEM_INFORMATION_CLASS>(SystemExtendedHandleInformation),
-        buffer.get(),
-        buffer_size,
-        &returned_length);
-    if (NT_SUCCESS(status) || status != STATUS_INFO_LENGTH_MISMATCH)
-      break;
-
-    buffer_size *= 2;
+  if (max_handles_ == 0) {
+    return std::vector<Handle>();
   }
 
-  if (!NT_SUCCESS(status)) {
-    NTSTATUS_LOG(ERROR, status)
-        << "NtQuerySystemInformation SystemExtendedHandleInformation";
+  std::vector<HandleEntry> entries;
+  if (!EnumerateProcessHandles(
+          process, process_handle_information_disabled_, &entries) &&
+      !EnumerateSystemHandles(process_id_, &entries)) {
     return std::vector<Handle>();
   }
 
-  const auto& system_handle_information_ex =
-      *reinterpret_cast<process_types::SYSTEM_HANDLE_INFORMATION_EX*>(
-          buffer.get());
-
-  DCHECK_LE(offsetof(process_types::SYSTEM_HANDLE_INFORMATION_EX, Handles) +
-                system_handle_information_ex.NumberOfHandles *
-                    sizeof(system_handle_information_ex.Handles[0]),
-            returned_length);
+  // When there are more handles than requested, take an evenly spaced sample
+  // so that the types of handles the process holds are still represented.
+  // Examining each handle below is what's expensive, so sample before that.
+  // The index is computed in 64 bits, because the product can exceed a 32-bit
+  // size_t for a process with hundreds of thousands of handles.
+  if (entries.size() > max_handles_) {
+    std::vector<HandleEntry> sampled;
+    sampled.reserve(max_handles_);
+    for (size_t i = 0; i < max_handles_; ++i) {
+      sampled.push_back(entries[static_cast<size_t>(
+          uint64_t{i} * entries.size() / max_handles_)]);
+    }
+    entries.swap(sampled);
+  }
 
   std::vector<Handle> handles;
+  handles.reserve(entries.size());
 
-  for (size_t i = 0; i < system_handle_information_ex.NumberOfHandles; ++i) {
-    const auto& handle = system_handle_information_ex.Handles[i];
-    if (handle.UniqueProcessId != process_id_)
-      continue;
-
+  for (const HandleEntry& entry : entries) {
     Handle result_handle;
-    result_handle.handle = HandleToInt(handle.HandleValue);
-    result_handle.attributes = handle.HandleAttributes;
-    result_handle.granted_access = handle.GrantedAccess;
+    result_handle.handle = HandleToInt(entry.handle_value);
+    result_handle.attributes = entry.attributes;
+    result_handle.granted_access = entry.granted_access;
+    if (entry.has_counts) {
+      result_handle.pointer_count = entry.pointer_count;
+      result_handle.handle_count = entry.handle_count;
+    }
 
     // TODO(scottmg): Could special case for self.
     HANDLE dup_handle;
     if (DuplicateHandle(process,
-                        handle.HandleValue,
+                        entry.handle_value,
                         GetCurrentProcess(),
                         &dup_handle,
                         0,
@@ -413,10 +771,14 @@ std::vector<ProcessInfo::Handle> ProcessInfo::BuildHandleVector(
       // information, but include the information that we do have already.
       ScopedKernelHANDLE scoped_dup_handle(dup_handle);
 
+      // The per-process query already reported the counts, as seen before this
+      // process duplicated the handle.
       std::unique_ptr<uint8_t[]> object_basic_information_buffer =
-          QueryObject(dup_handle,
-                      ObjectBasicInformation,
-                      sizeof(PUBLIC_OBJECT_BASIC_INFORMATION));
+          entry.has_counts
+              ? nullptr
+              : QueryObject(dup_handle,
+                            ObjectBasicInformation,
+                            sizeof(PUBLIC_OBJECT_BASIC_INFORMATION));
       if (object_basic_information_buffer) {
         PUBLIC_OBJECT_BASIC_INFORMATION* object_basic_information =
             reinterpret_cast<PUBLIC_OBJECT_BASIC_INFORMATION*>(
@@ -491,6 +853,9 @@ ProcessInfo::ProcessInfo()
       modules_(),
       memory_info_(),
       handles_(),
+      max_handles_(std::numeric_limits<size_t>::max()),
+      process_handle_information_disabled_(false),
+      module_list_cache_(nullptr),
       is_64_bit_(false),
       is_wow64_(false),
       initialized_() {
@@ -544,6 +909,13 @@ bool ProcessInfo::Initialize(HANDLE process) {
     return false;
   }
 
+  // The memory map is read first so that ReadProcessData() can use it to read
+  // the loader's list in larger blocks.
+  if (!ReadMemoryInfo(process, is_64_bit_, this)) {
+    LOG(ERROR) << "ReadMemoryInfo failed";
+    return false;
+  }
+
   result = is_64_bit_ ? ReadProcessData<process_types::internal::Traits64>(
                             process, peb_address_, this)
                       : ReadProcessData<process_types::internal::Traits32>(
@@ -553,11 +925,6 @@ bool ProcessInfo::Initialize(HANDLE process) {
     return false;
   }
 
-  if (!ReadMemoryInfo(process, is_64_bit_, this)) {
-    LOG(ERROR) << "ReadMemoryInfo failed";
-    return false;
-  }
-
   INITIALIZATION_STATE_SET_VALID(initialized_);
   return true;
 }
@@ -654,19 +1021,36 @@ std::vector<CheckedRange<WinVMAddress, WinVMSize>> GetReadableRangesOfMemoryMap(
 
   // Find all the ranges that overlap the target range, maintaining their order.
   ProcessInfo::MemoryBasicInformation64Vector overlapping;
-  const size_t size = memory_info.size();
+  if (memory_info.empty())
+    return std::vector<Range>();
 
-  // This loop is written in an ugly fashion to make Debug performance
-  // reasonable.
+  // memory_info is sorted by BaseAddress and its regions don't overlap, as
+  // produced by walking the address space with VirtualQueryEx(), so binary
+  // search for the last region starting at or below range_base and scan
+  // forward from there only while regions still start below range_end. This
+  // keeps lookups cheap in processes whose maps contain many thousands of
+  // regions. This loop is written in an ugly fashion to make Debug
+  // performance reasonable.
   const MEMORY_BASIC_INFORMATION64* begin = &memory_info[0];
-  for (size_t i = 0; i < size; ++i) {
-    const MEMORY_BASIC_INFORMATION64& mi = *(begin + i);
+  const MEMORY_BASIC_INFORMATION64* end = begin + memory_info.size();
+  const MEMORY_BASIC_INFORMATION64* it =
+      std::upper_bound(begin,
+                       end,
+                       range_base,
+                       [](WinVMAddress address,
+                          const MEMORY_BASIC_INFORMATION64& mi) {
+                         return address < mi.BaseAddress;
+                       });
+  if (it != begin)
+    --it;
+  for (; it != end && it->BaseAddress < range_end; ++it) {
+    const MEMORY_BASIC_INFORMATION64& mi = *it;
     static_assert(std::is_same<decltype(mi.BaseAddress), WinVMAddress>::value,
                   "expected range address to be WinVMAddress");
     static_assert(std::is_same<decltype(mi.RegionSize), WinVMSize>::value,
                   "expected range size to be WinVMSize");
     WinVMAddress mi_end = mi.BaseAddress + mi.RegionSize;
-    if (range_base < mi_end && mi.BaseAddress < range_end)
+    if (range_base < mi_end)
       overlapping.push_back(mi);
   }
   if (overlapping.empty())
@@ -29,6 +29,8 @@
 
 namespace crashpad {
 
+class ModuleListCacheWin;
+
 //! \brief Gathers information about a process given its `HANDLE`. This consists
 //!     primarily of information stored in the Process Environment Block.
 class ProcessInfo {
@@ -92,6 +94,19 @@ class ProcessInfo {
 
   ~ProcessInfo();
 
+  //! \brief Allows Initialize() to reuse the modules found by an earlier
+  //!     ProcessInfo for the same process, and to record the modules that it
+  //!     finds for later use.
+  //!
+  //! This must be called before Initialize() to have any effect.
+  //!
+  //! \param[in] cache The cache, which must outlive this object, or `nullptr`
+  //!     to read the modules from the process every time, which is the
+  //!     default.
+  void SetModuleListCache(ModuleListCacheWin* cache) {
+    module_list_cache_ = cache;
+  }
+
   //! \brief Initializes this object with information about the given
   //!     \a process.
   //!
@@ -155,7 +170,29 @@ class ProcessInfo {
   bool LoggingRangeIsFullyReadable(
       const CheckedRange<WinVMAddress, WinVMSize>& range) const;
 
+  //! \brief Limits the number of handles that Handles() examines.
+  //!
+  //! Examining each handle requires duplicating it into this process, which is
+  //! slow for processes holding very many handles. When the target process has
+  //! more than \a max_handles handles, an evenly spaced sample of them is
+  //! examined instead. A value of `0` skips handle enumeration entirely.
+  //!
+  //! This must be called before the first call to Handles() to have any
+  //! effect. By default, every handle is examined.
+  void SetMaxHandles(size_t max_handles) { max_handles_ = max_handles; }
+
+  //! \brief Makes Handles() behave as though the kernel doesn’t support
+  //!     `ProcessHandleInformation`, as before Windows 8, so that it lists
+  //!     every handle in the system. For testing.
+  void DisableProcessHandleInformationForTesting() {
+    process_handle_information_disabled_ = true;
+  }
+
   //! \brief Retrieves information about open handles in the target process.
+  //!
+  //! On Windows 8 and later, only the handles of the target process are
+  //! queried. On earlier versions, every handle in the system is listed and
+  //! filtered by process.
   const std::vector<Handle>& Handles() const;
 
  private:
@@ -202,6 +239,10 @@ class ProcessInfo {
   // See https://crashpad.chromium.org/bug/9.
   mutable std::vector<Handle> handles_;
 
+  size_t max_handles_;
+  bool process_handle_information_disabled_;
+  ModuleListCacheWin* module_list_cache_;  // weak
+
   bool is_64_bit_;
   bool is_wow64_;
   InitializationStateDcheck initialized_;
@@ -211,6 +252,11 @@ class ProcessInfo {
 //!     target process, returns a vector of ranges, representing the readable
 //!     portions of the original range.
 //!
+//! \a memory_info must be sorted by `BaseAddress` and contain no overlapping
+//! regions, as ProcessInfo::MemoryInfo() is. Overlapping regions are located
+//! by binary search, so the cost of a lookup grows with the number of regions
+//! that overlap \a range rather than with the size of the whole map.
+//!
 //! This is a free function for testing, but prefer
 //! ProcessInfo::GetReadableRanges().
 std::vector<CheckedRange<WinVMAddress, WinVMSize>> GetReadableRangesOfMemoryMap(
@@ -37,6 +37,7 @@
 #include "util/win/command_line.h"
 #include "util/win/get_function.h"
 #include "util/win/handle.h"
+#include "util/win/module_list_cache_win.h"
 #include "util/win/scoped_handle.h"
 #include "util/win/scoped_registry_key.h"
 
@@ -196,6 +197,42 @@ void TestOtherProcess(TestPaths::Architecture architecture) {
   VerifyAddressInInCodePage(process_info, code_address);
 }
 
+TEST(ProcessInfo, ModuleListCache) {
+  ModuleListCacheWin cache;
+
+  ProcessInfo first;
+  first.SetModuleListCache(&cache);
+  ASSERT_TRUE(first.Initialize(GetCurrentProcess()));
+  EXPECT_EQ(cache.size(), 1u);
+  std::vector<ProcessInfo::Module> first_modules;
+  ASSERT_TRUE(first.Modules(&first_modules));
+
+  // A second ProcessInfo for the same unchanged process uses the cached list,
+  // which must match what a walk of the loader’s list finds.
+  ProcessInfo second;
+  second.SetModuleListCache(&cache);
+  ASSERT_TRUE(second.Initialize(GetCurrentProcess()));
+  EXPECT_EQ(cache.size(), 1u);
+  std::vector<ProcessInfo::Module> second_modules;
+  ASSERT_TRUE(second.Modules(&second_modules));
+
+  ProcessInfo uncached;
+  ASSERT_TRUE(uncached.Initialize(GetCurrentProcess()));
+  std::vector<ProcessInfo::Module> uncached_modules;
+  ASSERT_TRUE(uncached.Modules(&uncached_modules));
+
+  ASSERT_EQ(second_modules.size(), uncached_modules.size());
+  ASSERT_EQ(first_modules.size(), uncached_modules.size());
+  for (size_t index = 0; index < uncached_modules.size(); ++index) {
+    EXPECT_EQ(second_modules[index].name, uncached_modules[index].name);
+    EXPECT_EQ(second_modules[index].dll_base, uncached_modules[index].dll_base);
+    EXPECT_EQ(second_modules[index].size, uncached_modules[index].size);
+    EXPECT_EQ(second_modules[index].timestamp,
+              uncached_modules[index].timestamp);
+    EXPECT_EQ(first_modules[index].name, uncached_modules[index].name);
+  }
+}
+
 TEST(ProcessInfo, OtherProcess) {
   TestOtherProcess(TestPaths::Architecture::kDefault);
 }
@@ -457,6 +494,50 @@ TEST(ProcessInfo, RequestedAfterMap) {
   EXPECT_EQ(result[0].size(), 5u);
 }
 
+TEST(ProcessInfo, RequestedInsideLargeMap) {
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+  MEMORY_BASIC_INFORMATION64 mbi = {0};
+
+  // Alternate committed and reserved regions of 10 bytes each, so that only a
+  // few regions in the middle of a large map overlap the requested range.
+  for (WinVMAddress address = 0; address < 10000; address += 10) {
+    mbi.BaseAddress = address;
+    mbi.RegionSize = 10;
+    mbi.State = (address / 10) % 2 == 0 ? MEM_COMMIT : MEM_RESERVE;
+    memory_info.push_back(mbi);
+  }
+
+  std::vector<CheckedRange<WinVMAddress, WinVMSize>> result =
+      GetReadableRangesOfMemoryMap(
+          CheckedRange<WinVMAddress, WinVMSize>(5005, 30), memory_info);
+
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result[0].base(), 5005u);
+  EXPECT_EQ(result[0].size(), 5u);
+  EXPECT_EQ(result[1].base(), 5020u);
+  EXPECT_EQ(result[1].size(), 10u);
+
+  result = GetReadableRangesOfMemoryMap(
+      CheckedRange<WinVMAddress, WinVMSize>(9980, 10), memory_info);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0].base(), 9980u);
+  EXPECT_EQ(result[0].size(), 10u);
+
+  result = GetReadableRangesOfMemoryMap(
+      CheckedRange<WinVMAddress, WinVMSize>(10000, 10), memory_info);
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(ProcessInfo, AccessibleRangesEmptyMap) {
+  ProcessInfo::MemoryBasicInformation64Vector memory_info;
+
+  std::vector<CheckedRange<WinVMAddress, WinVMSize>> result =
+      GetReadableRangesOfMemoryMap(CheckedRange<WinVMAddress, WinVMSize>(2, 4),
+                                   memory_info);
+
+  EXPECT_TRUE(result.empty());
+}
+
 TEST(ProcessInfo, ReadableRanges) {
   SYSTEM_INFO system_info;
   GetSystemInfo(&system_info);
@@ -529,7 +610,7 @@ TEST(ProcessInfo, ReadableRanges) {
                                  &bytes_read));
 }
 
-TEST(ProcessInfo, Handles) {
+void TestHandles(bool process_handle_information_disabled) {
   ScopedTempDir temp_dir;
 
   ScopedFileHandle file(LoggingOpenFileForWrite(
@@ -572,6 +653,9 @@ TEST(ProcessInfo, Handles) {
 
   ProcessInfo info;
   info.Initialize(GetCurrentProcess());
+  if (process_handle_information_disabled) {
+    info.DisableProcessHandleInformationForTesting();
+  }
   bool found_file_handle = false;
   bool found_inherited_file_handle = false;
   bool found_key_handle = false;
@@ -632,6 +716,35 @@ TEST(ProcessInfo, Handles) {
   EXPECT_TRUE(found_mapping_handle);
 }
 
+TEST(ProcessInfo, Handles) {
+  TestHandles(false);
+}
+
+TEST(ProcessInfo, HandlesWithoutProcessHandleInformation) {
+  // Handles are found by listing every handle in the system, as before Windows
+  // 8, where ProcessHandleInformation fails with STATUS_INVALID_INFO_CLASS.
+  TestHandles(true);
+}
+
+TEST(ProcessInfo, MaxHandles) {
+  ProcessInfo all_info;
+  ASSERT_TRUE(all_info.Initialize(GetCurrentProcess()));
+  const size_t handle_count = all_info.Handles().size();
+  ASSERT_GT(handle_count, 2u);
+
+  ProcessInfo none_info;
+  ASSERT_TRUE(none_info.Initialize(GetCurrentProcess()));
+  none_info.SetMaxHandles(0);
+  EXPECT_TRUE(none_info.Handles().empty());
+
+  ProcessInfo sampled_info;
+  ASSERT_TRUE(sampled_info.Initialize(GetCurrentProcess()));
+  sampled_info.SetMaxHandles(2);
+  const std::vector<ProcessInfo::Handle>& sampled = sampled_info.Handles();
+  ASSERT_EQ(sampled.size(), 2u);
+  EXPECT_NE(sampled[0].handle, sampled[1].handle);
+}
+
 TEST(ProcessInfo, OutOfRangeCheck) {
   constexpr size_t kAllocationSize = 12345;
   std::unique_ptr<char[]> safe_memory(new char[kAllocationSize]);
@@ -0,0 +1,92 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/win/scoped_process_va_clone.h"
+
+#include "base/logging.h"
+#include "util/win/get_function.h"
+
+namespace crashpad {
+
+namespace {
+
+// PssCaptureSnapshot() and its companions are only present in Windows 8.1 and
+// later.
+struct PssFunctions {
+  decltype(PssCaptureSnapshot)* capture_snapshot;
+  decltype(PssQuerySnapshot)* query_snapshot;
+  decltype(PssFreeSnapshot)* free_snapshot;
+};
+
+const PssFunctions& GetPssFunctions() {
+  static const PssFunctions functions = {
+      GET_FUNCTION(L"kernel32.dll", ::PssCaptureSnapshot),
+      GET_FUNCTION(L"kernel32.dll", ::PssQuerySnapshot),
+      GET_FUNCTION(L"kernel32.dll", ::PssFreeSnapshot),
+  };
+  return functions;
+}
+
+}  // namespace
+
+ScopedProcessVaClone::ScopedProcessVaClone()
+    : snapshot_(nullptr), clone_(nullptr) {}
+
+ScopedProcessVaClone::~ScopedProcessVaClone() {
+  if (snapshot_) {
+    DWORD error =
+        GetPssFunctions().free_snapshot(GetCurrentProcess(), snapshot_);
+    if (error != ERROR_SUCCESS) {
+      SetLastError(error);
+      PLOG(ERROR) << "PssFreeSnapshot";
+    }
+  }
+}
+
+bool ScopedProcessVaClone::Initialize(HANDLE process) {
+  DCHECK(!snapshot_);
+
+  const PssFunctions& functions = GetPssFunctions();
+  if (!functions.capture_snapshot || !functions.query_snapshot ||
+      !functions.free_snapshot) {
+    LOG(ERROR) << "PssCaptureSnapshot unavailable";
+    return false;
+  }
+
+  HPSS snapshot;
+  DWORD error = functions.capture_snapshot(
+      process, PSS_CAPTURE_VA_CLONE, 0, &snapshot);
+  if (error != ERROR_SUCCESS) {
+    SetLastError(error);
+    PLOG(ERROR) << "PssCaptureSnapshot";
+    return false;
+  }
+  snapshot_ = snapshot;
+
+  PSS_VA_CLONE_INFORMATION va_clone_information;
+  error = functions.query_snapshot(snapshot_,
+                                   PSS_QUERY_VA_CLONE_INFORMATION,
+                                   &va_clone_information,
+                                   sizeof(va_clone_information));
+  if (error != ERROR_SUCCESS) {
+    SetLastError(error);
+    PLOG(ERROR) << "PssQuerySnapshot";
+    return false;
+  }
+
+  clone_ = va_clone_information.VaCloneHandle;
+  return true;
+}
+
+}  // namespace crashpad
@@ -0,0 +1,64 @@
+// Copyright 2026 The Crashpad Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CRASHPAD_UTIL_WIN_SCOPED_PROCESS_VA_CLONE_H_
+#define CRASHPAD_UTIL_WIN_SCOPED_PROCESS_VA_CLONE_H_
+
+#include <windows.h>
+#include <processsnapshot.h>
+
+namespace crashpad {
+
+//! \brief Manages a virtual address clone of another process, captured with
+//!     `PssCaptureSnapshot()`.
+//!
+//! The clone is a copy-on-write view of the other process’ address space as it
+//! was when captured. It can be read through handle() with
+//! `ReadProcessMemory()` and `VirtualQueryEx()` in the same way as the original
+//! process, which is free to resume running or to terminate in the meantime.
+//! The clone is released when this object is destroyed.
+class ScopedProcessVaClone {
+ public:
+  ScopedProcessVaClone();
+
+  ScopedProcessVaClone(const ScopedProcessVaClone&) = delete;
+  ScopedProcessVaClone& operator=(const ScopedProcessVaClone&) = delete;
+
+  ~ScopedProcessVaClone();
+
+  //! \brief Captures a clone of \a process.
+  //!
+  //! \a process should be suspended, so that the clone is consistent with the
+  //! state of its threads.
+  //!
+  //! \param[in] process The process to clone. This object does not take
+  //!     ownership of this handle, which must have `PROCESS_ALL_ACCESS`.
+  //!
+  //! \return `true` on success. `false` on failure, with a message logged,
+  //!     which happens when `PssCaptureSnapshot()` is unavailable, before
+  //!     Windows 8.1.
+  bool Initialize(HANDLE process);
+
+  //! \brief Returns a handle to the clone, which can be read from like the
+  //!     original process, or `nullptr` if Initialize() did not succeed.
+  HANDLE handle() const { return clone_; }
+
+ private:
+  HPSS snapshot_;
+  HANDLE clone_;  // Owned by snapshot_.
+};
+
+}  // namespace crashpad
+
+#endif  // CRASHPAD_UTIL_WIN_SCOPED_PROCESS_VA_CLONE_H_